@@ -0,0 +1,38 @@
+struct Meshlet
+{
+	vec3 centre;
+	float radius;
+	vec3 coneAxis;
+	float coneCutoff;
+	uint vertexOffset;
+	uint vertexCount;
+	uint triangleOffset;
+	uint triangleCount;
+};
+
+// Tests a meshlet of a instance against the frustum, and against the cone of directions all of its triangles face away from.
+bool meshletVisible(Meshlet meshlet, mat4 transform, vec3 cameraPos, vec4 frustum[6])
+{
+	vec3 scales = vec3(length(transform[0].xyz), length(transform[1].xyz), length(transform[2].xyz));
+	float scale = max(scales.x, max(scales.y, scales.z));
+	vec3 centre = (transform * vec4(meshlet.centre, 1.0f)).xyz;
+	float radius = meshlet.radius * scale;
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (dot(frustum[i].xyz, centre) + frustum[i].w <= -radius)
+		{
+			return false;
+		}
+	}
+
+	// A non uniform scale bends the normals away from the cone, so the cone is only tested on uniformly scaled instances.
+	if (meshlet.coneCutoff >= 1.0f || scale - min(scales.x, min(scales.y, scales.z)) > 0.01f * scale)
+	{
+		return true;
+	}
+
+	vec3 axis = normalize(mat3(transform) * meshlet.coneAxis);
+	vec3 direction = centre - cameraPos;
+	return dot(direction, axis) < meshlet.coneCutoff * length(direction) + radius * (1.0f + meshlet.coneCutoff);
+}
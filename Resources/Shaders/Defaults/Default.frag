@@ -1,20 +1,90 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
+#if BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+#if INSTANCED
+struct Instance
+{
+	mat4 transform;
+	mat4 previousTransform;
+
+	vec4 baseDiffuse;
+	float metallic;
+	float roughness;
+	float ignoreFog;
+	float ignoreLighting;
+	uint material;
+	float lodFade;
+	float animationFrame;
+	uint animationNext;
+
+	vec3 positionScale;
+	uint entityIndex;
+	vec3 positionOffset;
+	uint entityGeneration;
+};
 
+layout(binding = 1) buffer BufferInstances
+{
+	Instance instances[];
+} bufferInstances;
+#elif !BINDLESS
 layout(binding = 1) uniform UniformObject
 {
 #if ANIMATED
 	mat4 jointTransforms[MAX_JOINTS];
 #endif
 	mat4 transform;
+	mat4 previousTransform;
 
 	vec4 baseDiffuse;
 	float metallic;
 	float roughness;
 	float ignoreFog;
 	float ignoreLighting;
+
+	vec3 positionScale;
+	uint entityIndex;
+	vec3 positionOffset;
+	uint entityGeneration;
+#if BAKED
+	float animationFrame;
+	uint animationNext;
+#endif
 } object;
+#endif
+
+#if BINDLESS
+struct Material
+{
+	vec4 baseDiffuse;
+	float metallic;
+	float roughness;
+	float ignoreFog;
+	float ignoreLighting;
+	int imageDiffuse;
+	int imageMaterial;
+	int imageNormal;
+};
+
+layout(set = 1, binding = 0) uniform sampler2D images[];
+
+layout(set = 1, binding = 1) readonly buffer BufferMaterials
+{
+	Material materials[];
+} bufferMaterials;
+#endif
+
+#if !INSTANCED
+layout(push_constant) uniform PushObject
+{
+	uint material;
+	float lodFade;
+} pushObject;
+#endif
 
 #if DIFFUSE_MAPPING
 layout(binding = 2) uniform sampler2D samplerDiffuse;
@@ -29,25 +99,20 @@ layout(binding = 4) uniform sampler2D samplerNormal;
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
+#if INSTANCED
+layout(location = 3) flat in int inInstance;
+#endif
+layout(location = 4) in vec4 inCurrentPosition;
+layout(location = 5) in vec4 inPreviousPosition;
+#if defined(ENTITY_ID) && !INSTANCED
+layout(location = 6) flat in uvec2 inEntity;
+#endif
 
-layout(location = 0) out vec4 outPosition;
-layout(location = 1) out vec4 outDiffuse;
-layout(location = 2) out vec4 outNormal;
-layout(location = 3) out vec4 outMaterial;
+#include "Shaders/Deferred/Packing.glsl"
+#include "Shaders/Deferred/GBuffer.glsl"
 
-void main()
+void ApplyMaterial(vec4 textureMaterial, inout vec3 material, inout float glowing)
 {
-	vec4 diffuse = object.baseDiffuse;
-	vec3 normal = normalize(inNormal);
-	vec3 material = vec3(object.metallic, object.roughness, 0.0f);
-	float glowing = 0.0f;
-
-#if DIFFUSE_MAPPING
-	diffuse = texture(samplerDiffuse, inUV);
-#endif
-
-#if MATERIAL_MAPPING
-	vec4 textureMaterial = texture(samplerMaterial, inUV);
 	material.x *= textureMaterial.r;
 	material.y *= textureMaterial.g;
 
@@ -55,10 +120,11 @@ void main()
 	{
 		glowing = 1.0f;
 	}
-#endif
+}
 
-#if NORMAL_MAPPING
-	vec3 tangentNormal = texture(samplerNormal, inUV).rgb * 2.0f - 1.0f;
+vec3 PerturbNormal(vec3 textureNormal)
+{
+	vec3 tangentNormal = textureNormal * 2.0f - 1.0f;
 	
 	vec3 q1 = dFdx(inPosition);
 	vec3 q2 = dFdy(inPosition);
@@ -70,13 +136,90 @@ void main()
 	vec3 B = -normalize(cross(N, T));
 	mat3 TBN = mat3(T, B, N);
 
-	normal = TBN * tangentNormal;
+	return TBN * tangentNormal;
+}
+
+// Ordered dither thresholds, so the two levels drawn during a fade discard complementary pixels.
+const float BAYER[16] = float[](
+	0.0f, 8.0f, 2.0f, 10.0f,
+	12.0f, 4.0f, 14.0f, 6.0f,
+	3.0f, 11.0f, 1.0f, 9.0f,
+	15.0f, 7.0f, 13.0f, 5.0f
+);
+
+void main()
+{
+#if INSTANCED
+	float lodFade = bufferInstances.instances[inInstance].lodFade;
+#else
+	float lodFade = pushObject.lodFade;
+#endif
+
+	if (lodFade != 0.0f)
+	{
+		ivec2 pixel = ivec2(gl_FragCoord.xy) % 4;
+		float threshold = (BAYER[pixel.y * 4 + pixel.x] + 0.5f) / 16.0f;
+
+		if (lodFade > 0.0f ? threshold < lodFade : threshold >= -lodFade)
+		{
+			discard;
+		}
+	}
+
+#if BINDLESS
+#if INSTANCED
+	Material object = bufferMaterials.materials[bufferInstances.instances[inInstance].material];
+#else
+	Material object = bufferMaterials.materials[pushObject.material];
+#endif
+#elif INSTANCED
+	Instance object = bufferInstances.instances[inInstance];
+#endif
+
+	vec4 diffuse = object.baseDiffuse;
+	vec3 normal = normalize(inNormal);
+	vec3 material = vec3(object.metallic, object.roughness, 0.0f);
+	float glowing = 0.0f;
+
+#if BINDLESS
+	if (object.imageDiffuse >= 0)
+	{
+		diffuse = texture(images[nonuniformEXT(object.imageDiffuse)], inUV);
+	}
+
+	if (object.imageMaterial >= 0)
+	{
+		ApplyMaterial(texture(images[nonuniformEXT(object.imageMaterial)], inUV), material, glowing);
+	}
+
+	if (object.imageNormal >= 0)
+	{
+		normal = PerturbNormal(texture(images[nonuniformEXT(object.imageNormal)], inUV).rgb);
+	}
+#else
+#if DIFFUSE_MAPPING
+	diffuse = texture(samplerDiffuse, inUV);
+#endif
+
+#if MATERIAL_MAPPING
+	ApplyMaterial(texture(samplerMaterial, inUV), material, glowing);
+#endif
+
+#if NORMAL_MAPPING
+	normal = PerturbNormal(texture(samplerNormal, inUV).rgb);
+#endif
 #endif
 
 	material.z = (1.0f / 3.0f) * (object.ignoreFog + (2.0f * min(object.ignoreLighting + glowing, 1.0f)));
 
-	outPosition = vec4(inPosition, 1.0f);
-	outDiffuse = diffuse;
-	outNormal = vec4(normalize(normal), 1.0f);
-	outMaterial = vec4(material, 1.0f);
+	storeGBuffer(inPosition, diffuse, normalize(normal), material,
+		0.5f * (inCurrentPosition.xy / inCurrentPosition.w - inPreviousPosition.xy / inPreviousPosition.w));
+
+#if defined(ENTITY_ID)
+#if INSTANCED
+	storeEntity(uvec2(bufferInstances.instances[inInstance].entityIndex, bufferInstances.instances[inInstance].entityGeneration));
+#else
+	storeEntity(inEntity);
+#endif
+#endif
 }
@@ -1,32 +1,100 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
+#if defined(MULTIVIEW)
+#extension GL_EXT_multiview : require
+#define VIEW_COUNT MULTIVIEW
+#define VIEW gl_ViewIndex
+#else
+#define VIEW_COUNT 1
+#define VIEW 0
+#endif
 
 layout(binding = 0) uniform UniformScene
 {
-	mat4 projection;
-	mat4 view;
+	mat4 projection[VIEW_COUNT];
+	mat4 view[VIEW_COUNT];
 	vec3 cameraPos;
+	mat4 previousProjection[VIEW_COUNT];
+	mat4 previousView[VIEW_COUNT];
+	vec2 jitter;
 } scene;
 
+#if INSTANCED
+struct Instance
+{
+	mat4 transform;
+	mat4 previousTransform;
+
+	vec4 baseDiffuse;
+	float metallic;
+	float roughness;
+	float ignoreFog;
+	float ignoreLighting;
+	uint material;
+	float lodFade;
+	float animationFrame;
+	uint animationNext;
+
+	vec3 positionScale;
+	uint entityIndex;
+	vec3 positionOffset;
+	uint entityGeneration;
+};
+
+layout(binding = 1) buffer BufferInstances
+{
+	Instance instances[];
+} bufferInstances;
+
+layout(binding = 5) readonly buffer BufferVisible
+{
+	uint visible[];
+} bufferVisible;
+#else
 layout(binding = 1) uniform UniformObject
 {
 #if ANIMATED
 	mat4 jointTransforms[MAX_JOINTS];
 #endif
 	mat4 transform;
+	mat4 previousTransform;
 
 	vec4 baseDiffuse;
 	float metallic;
 	float roughness;
 	float ignoreFog;
 	float ignoreLighting;
+
+	vec3 positionScale;
+	uint entityIndex;
+	vec3 positionOffset;
+	uint entityGeneration;
+#if BAKED
+	float animationFrame;
+	uint animationNext;
+#endif
 } object;
+#endif
 
+#if BAKED
+layout(binding = 6) readonly buffer BufferAnimation
+{
+	uint jointCount;
+	mat4 joints[];
+} bufferAnimation;
+#endif
+
+#if QUANTIZED
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec2 inNormal;
+#else
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
-#if ANIMATED
+#endif
+#if ANIMATED || BAKED
 layout(location = 3) in ivec3 inJointIds;
 layout(location = 4) in vec3 inWeights;
 #endif
@@ -34,14 +102,50 @@ layout(location = 4) in vec3 inWeights;
 layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec2 outUV;
 layout(location = 2) out vec3 outNormal;
+#if INSTANCED
+layout(location = 3) flat out int outInstance;
+#endif
+layout(location = 4) out vec4 outCurrentPosition;
+layout(location = 5) out vec4 outPreviousPosition;
+#if defined(ENTITY_ID) && !INSTANCED
+layout(location = 6) flat out uvec2 outEntity;
+#endif
 
+// Invariant so the depth matches the depth pre-pass in Depth.vert exactly.
 out gl_PerVertex
 {
-	vec4 gl_Position;
+	invariant vec4 gl_Position;
 };
 
+#if QUANTIZED
+// Unfolds a octahedral normal, the lower half of the sphere was folded over the upper half.
+vec3 DecodeNormal(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+	return normalize(normal);
+}
+#endif
+
+#if BAKED
+// Blends a joint between the baked frame and the next frame, the fraction of the frame is how far it has blended.
+mat4 BakedJoint(int joint, float frame, uint next)
+{
+	uint jointCount = bufferAnimation.jointCount;
+	mat4 from = bufferAnimation.joints[uint(frame) * jointCount + joint];
+	mat4 to = bufferAnimation.joints[next * jointCount + joint];
+	return from * (1.0f - fract(frame)) + to * fract(frame);
+}
+#endif
+
 void main()
 {
+#if INSTANCED
+	int instance = int(bufferVisible.visible[gl_InstanceIndex]);
+#endif
+
 #if ANIMATED
 	vec4 position = vec4(0.0f);
 	vec4 normal = vec4(0.0f);
@@ -55,17 +159,60 @@ void main()
 		vec4 worldNormal = jointTransform * vec4(inNormal, 0.0f);
 		normal += worldNormal * inWeights[i];
 	}
+#elif BAKED
+#if INSTANCED
+	float animationFrame = bufferInstances.instances[instance].animationFrame;
+	uint animationNext = bufferInstances.instances[instance].animationNext;
+#else
+	float animationFrame = object.animationFrame;
+	uint animationNext = object.animationNext;
+#endif
+	vec4 position = vec4(0.0f);
+	vec4 normal = vec4(0.0f);
+
+	for (int i = 0; i < MAX_WEIGHTS; i++)
+	{
+		mat4 jointTransform = BakedJoint(inJointIds[i], animationFrame, animationNext);
+		position += jointTransform * vec4(inPosition, 1.0f) * inWeights[i];
+		normal += jointTransform * vec4(inNormal, 0.0f) * inWeights[i];
+	}
+#elif QUANTIZED
+#if INSTANCED
+	vec3 positionScale = bufferInstances.instances[instance].positionScale;
+	vec3 positionOffset = bufferInstances.instances[instance].positionOffset;
+#else
+	vec3 positionScale = object.positionScale;
+	vec3 positionOffset = object.positionOffset;
+#endif
+	vec4 position = vec4(positionOffset.xyz + inPosition.xyz * positionScale.xyz, 1.0f);
+	vec4 normal = vec4(DecodeNormal(inNormal), 0.0f);
 #else
 	vec4 position = vec4(inPosition, 1.0f);
 	vec4 normal = vec4(inNormal, 0.0f);
 #endif
 
-	vec4 worldPosition = object.transform * position;
-    mat3 normalMatrix = transpose(inverse(mat3(object.transform)));
+#if INSTANCED
+	mat4 transform = bufferInstances.instances[instance].transform;
+	mat4 previousTransform = bufferInstances.instances[instance].previousTransform;
+	outInstance = instance;
+#else
+	mat4 transform = object.transform;
+	mat4 previousTransform = object.previousTransform;
+#endif
+
+	vec4 worldPosition = transform * position;
+    mat3 normalMatrix = transpose(inverse(mat3(transform)));
+
+	gl_Position = scene.projection[VIEW] * scene.view[VIEW] * worldPosition;
 
-	gl_Position = scene.projection * scene.view * worldPosition;
+	// Motion vectors are measured without the jitter, so still geometry has no motion.
+	outCurrentPosition = gl_Position - vec4(scene.jitter * gl_Position.w, 0.0f, 0.0f);
+	outPreviousPosition = scene.previousProjection[VIEW] * scene.previousView[VIEW] * previousTransform * position;
 
 	outPosition = worldPosition.xyz;
 	outUV = inUV;
 	outNormal = normalMatrix * normalize(normal.xyz);
+#if defined(ENTITY_ID) && !INSTANCED
+	outEntity = uvec2(object.entityIndex, object.entityGeneration);
+#endif
 }
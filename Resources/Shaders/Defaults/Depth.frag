@@ -0,0 +1,67 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#if INSTANCED
+struct Instance
+{
+	mat4 transform;
+	mat4 previousTransform;
+
+	vec4 baseDiffuse;
+	float metallic;
+	float roughness;
+	float ignoreFog;
+	float ignoreLighting;
+	uint material;
+	float lodFade;
+	float animationFrame;
+	uint animationNext;
+
+	vec4 positionScale;
+	vec4 positionOffset;
+};
+
+layout(binding = 1) buffer BufferInstances
+{
+	Instance instances[];
+} bufferInstances;
+
+layout(location = 3) flat in int inInstance;
+#else
+layout(push_constant) uniform PushObject
+{
+	mat4 transform;
+	vec4 positionScale;
+	vec4 positionOffset;
+	float lodFade;
+} object;
+#endif
+
+// The same thresholds as Default.frag, a fading level only lays down depth for the pixels it shades.
+const float BAYER[16] = float[](
+	0.0f, 8.0f, 2.0f, 10.0f,
+	12.0f, 4.0f, 14.0f, 6.0f,
+	3.0f, 11.0f, 1.0f, 9.0f,
+	15.0f, 7.0f, 13.0f, 5.0f
+);
+
+void main()
+{
+#if INSTANCED
+	float lodFade = bufferInstances.instances[inInstance].lodFade;
+#else
+	float lodFade = object.lodFade;
+#endif
+
+	if (lodFade != 0.0f)
+	{
+		ivec2 pixel = ivec2(gl_FragCoord.xy) % 4;
+		float threshold = (BAYER[pixel.y * 4 + pixel.x] + 0.5f) / 16.0f;
+
+		if (lodFade > 0.0f ? threshold < lodFade : threshold >= -lodFade)
+		{
+			discard;
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#if defined(MULTIVIEW)
+#extension GL_EXT_multiview : require
+#define VIEW_COUNT MULTIVIEW
+#define VIEW gl_ViewIndex
+#else
+#define VIEW_COUNT 1
+#define VIEW 0
+#endif
+
+layout(binding = 0) uniform UniformScene
+{
+	mat4 projection[VIEW_COUNT];
+	mat4 view[VIEW_COUNT];
+} scene;
+
+#if INSTANCED
+struct Instance
+{
+	mat4 transform;
+	mat4 previousTransform;
+
+	vec4 baseDiffuse;
+	float metallic;
+	float roughness;
+	float ignoreFog;
+	float ignoreLighting;
+	uint material;
+	float lodFade;
+	float animationFrame;
+	uint animationNext;
+
+	vec4 positionScale;
+	vec4 positionOffset;
+};
+
+layout(binding = 1) buffer BufferInstances
+{
+	Instance instances[];
+} bufferInstances;
+
+layout(binding = 5) readonly buffer BufferVisible
+{
+	uint visible[];
+} bufferVisible;
+#else
+layout(push_constant) uniform PushObject
+{
+	mat4 transform;
+	vec4 positionScale;
+	vec4 positionOffset;
+	float lodFade;
+} object;
+#endif
+
+#if QUANTIZED
+layout(location = 0) in vec4 inPosition;
+#else
+layout(location = 0) in vec3 inPosition;
+#endif
+
+#if INSTANCED
+layout(location = 3) flat out int outInstance;
+#endif
+
+// The position is found the same way as in Default.vert, so the depth the materials test for equality is exactly the depth written here.
+out gl_PerVertex
+{
+	invariant vec4 gl_Position;
+};
+
+void main()
+{
+#if INSTANCED
+	int instance = int(bufferVisible.visible[gl_InstanceIndex]);
+	mat4 transform = bufferInstances.instances[instance].transform;
+	outInstance = instance;
+#else
+	mat4 transform = object.transform;
+#endif
+
+#if QUANTIZED
+#if INSTANCED
+	vec4 positionScale = bufferInstances.instances[instance].positionScale;
+	vec4 positionOffset = bufferInstances.instances[instance].positionOffset;
+#else
+	vec4 positionScale = object.positionScale;
+	vec4 positionOffset = object.positionOffset;
+#endif
+	vec4 position = vec4(positionOffset.xyz + inPosition.xyz * positionScale.xyz, 1.0f);
+#else
+	vec4 position = vec4(inPosition, 1.0f);
+#endif
+
+	vec4 worldPosition = transform * position;
+	gl_Position = scene.projection[VIEW] * scene.view[VIEW] * worldPosition;
+}
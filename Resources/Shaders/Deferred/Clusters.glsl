@@ -0,0 +1,26 @@
+// The view frustum is split into CLUSTERS_X by CLUSTERS_Y screen tiles and CLUSTERS_Z exponential depth slices.
+const uint CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+struct Light
+{
+	vec4 colour;
+	vec3 position;
+	float radius;
+};
+
+uint clusterIndex(uvec3 cluster)
+{
+	return cluster.x + CLUSTERS_X * (cluster.y + CLUSTERS_Y * cluster.z);
+}
+
+// Slices grow with depth so each cluster covers a similar screen and depth ratio.
+float sliceDepth(uint slice, float nearPlane, float farPlane)
+{
+	return nearPlane * pow(farPlane / nearPlane, float(slice) / float(CLUSTERS_Z));
+}
+
+uint depthSlice(float depth, float nearPlane, float farPlane)
+{
+	float slice = log(max(depth, nearPlane) / nearPlane) / log(farPlane / nearPlane) * float(CLUSTERS_Z);
+	return min(uint(slice), CLUSTERS_Z - 1u);
+}
@@ -1,40 +1,82 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
+#if defined(MULTIVIEW)
+#extension GL_EXT_multiview : require
+#define VIEW_COUNT MULTIVIEW
+#define VIEW gl_ViewIndex
+// Multiview G-buffers have a layer for each view.
+#define GBUFFER_SAMPLER sampler2DArray
+#define GBUFFER_UV vec3(inUV, gl_ViewIndex)
+#else
+#define VIEW_COUNT 1
+#define VIEW 0
+#define GBUFFER_SAMPLER sampler2D
+#define GBUFFER_UV inUV
+#endif
+#if defined(RAY_QUERY)
+#extension GL_EXT_ray_query : require
+#endif
 
 layout(binding = 0) uniform UniformScene
 {
-	mat4 view;
+	mat4 view[VIEW_COUNT];
 	mat4 shadowSpace;
+	mat4 invViewProjection[VIEW_COUNT];
 	vec3 cameraPosition;
 
-	int lightsCount;
+	float nearPlane;
+	float farPlane;
 
 	vec4 fogColour;
 	float fogDensity;
 	float fogGradient;
+#if defined(RAY_QUERY)
+	int rayShadows;
+#endif
 } scene;
 
-struct Light
-{
-	vec4 colour;
-	vec3 position;
-	float radius;
-};
+#include "Shaders/Deferred/Clusters.glsl"
+#include "Shaders/Deferred/Packing.glsl"
 
-layout(binding = 1) buffer BufferLights
+layout(binding = 1) readonly buffer BufferLights
 {
 	Light lights[];
 } bufferLights;
 
+layout(binding = 10) readonly buffer BufferClusters
+{
+	uint lightCounts[CLUSTER_COUNT];
+	uint lightIndices[];
+} bufferClusters;
+
 //layout(binding = 2) uniform sampler2D samplerShadows;
-layout(binding = 3) uniform sampler2D samplerPosition;
-layout(binding = 4) uniform sampler2D samplerDiffuse;
-layout(binding = 5) uniform sampler2D samplerNormal;
-layout(binding = 6) uniform sampler2D samplerMaterial;
+#if defined(COMPACT_GBUFFER)
+layout(binding = 3) uniform GBUFFER_SAMPLER samplerDepth;
+#if defined(INPUT_ATTACHMENTS)
+layout(input_attachment_index = 0, binding = 4) uniform subpassInput inputDiffuse;
+layout(input_attachment_index = 1, binding = 5) uniform subpassInput inputNormal;
+#else
+layout(binding = 4) uniform GBUFFER_SAMPLER samplerDiffuse;
+layout(binding = 5) uniform GBUFFER_SAMPLER samplerNormal;
+#endif
+#elif defined(INPUT_ATTACHMENTS)
+layout(input_attachment_index = 0, binding = 3) uniform subpassInput inputPosition;
+layout(input_attachment_index = 1, binding = 4) uniform subpassInput inputDiffuse;
+layout(input_attachment_index = 2, binding = 5) uniform subpassInput inputNormal;
+layout(input_attachment_index = 3, binding = 6) uniform subpassInput inputMaterial;
+#else
+layout(binding = 3) uniform GBUFFER_SAMPLER samplerPosition;
+layout(binding = 4) uniform GBUFFER_SAMPLER samplerDiffuse;
+layout(binding = 5) uniform GBUFFER_SAMPLER samplerNormal;
+layout(binding = 6) uniform GBUFFER_SAMPLER samplerMaterial;
+#endif
 layout(binding = 7) uniform sampler2D samplerBRDF;
 layout(binding = 8) uniform samplerCube samplerIrradiance;
 layout(binding = 9) uniform samplerCube samplerPrefiltered;
+#if defined(RAY_QUERY)
+layout(binding = 11) uniform accelerationStructureEXT sceneStructure;
+#endif
 
 layout(location = 0) in vec2 inUV;
 
@@ -124,6 +166,23 @@ vec3 specularContribution(vec3 diffuse, vec3 L, vec3 V, vec3 N, vec3 F0, float m
 	return colour;
 }
 
+#if defined(RAY_QUERY)
+// Traces a ray from the surface towards a light, the first hit is enough to know the light is blocked.
+float rayShadowFactor(vec3 worldPosition, vec3 N, vec3 L, float Dl)
+{
+	// The origin is pushed off the surface so the ray does not hit the triangle it starts on.
+	const float bias = 0.02f;
+	rayQueryEXT rayQuery;
+	rayQueryInitializeEXT(rayQuery, sceneStructure, gl_RayFlagsOpaqueEXT | gl_RayFlagsTerminateOnFirstHitEXT, 0xFF, worldPosition + N * bias, 0.0f, L, max(Dl - bias, 0.0f));
+
+	while (rayQueryProceedEXT(rayQuery))
+	{
+	}
+
+	return rayQueryGetIntersectionTypeEXT(rayQuery, true) == gl_RayQueryCommittedIntersectionNoneEXT ? 1.0f : 0.0f;
+}
+#endif
+
 /*float shadowFactor(vec4 shadowCoords)
 {
 	vec3 ndc = shadowCoords.xyz /= shadowCoords.w;
@@ -145,12 +204,31 @@ vec3 specularContribution(vec3 diffuse, vec3 L, vec3 V, vec3 N, vec3 F0, float m
 
 void main()
 {
-	vec3 worldPosition = texture(samplerPosition, inUV).rgb;
-	vec4 screenPosition = scene.view * vec4(worldPosition, 1.0f);
-
-	vec4 diffuse = texture(samplerDiffuse, inUV);
-	vec3 normal = texture(samplerNormal, inUV).rgb;
-	vec3 material = texture(samplerMaterial, inUV).rgb;
+#if defined(COMPACT_GBUFFER)
+#if defined(INPUT_ATTACHMENTS)
+	vec4 diffuse = subpassLoad(inputDiffuse);
+	vec4 packed = subpassLoad(inputNormal);
+#else
+	vec4 diffuse = texture(samplerDiffuse, GBUFFER_UV);
+	vec4 packed = texture(samplerNormal, GBUFFER_UV);
+#endif
+	vec3 worldPosition = reconstructPosition(inUV, texture(samplerDepth, GBUFFER_UV).r, scene.invViewProjection[VIEW]);
+	vec3 normal = unpackNormal(packed);
+	vec3 material = vec3(packed.b, diffuse.a, round(packed.a * 3.0f) / 3.0f);
+	diffuse.a = 1.0f;
+#elif defined(INPUT_ATTACHMENTS)
+	vec3 worldPosition = subpassLoad(inputPosition).rgb;
+	vec4 diffuse = subpassLoad(inputDiffuse);
+	vec3 normal = subpassLoad(inputNormal).rgb;
+	vec3 material = subpassLoad(inputMaterial).rgb;
+#else
+	vec3 worldPosition = texture(samplerPosition, GBUFFER_UV).rgb;
+	vec4 diffuse = texture(samplerDiffuse, GBUFFER_UV);
+	vec3 normal = texture(samplerNormal, GBUFFER_UV).rgb;
+	vec3 material = texture(samplerMaterial, GBUFFER_UV).rgb;
+#endif
+
+	vec4 screenPosition = scene.view[VIEW] * vec4(worldPosition, 1.0f);
 
 	float metallic = material.r;
 	float roughness = material.g;
@@ -167,13 +245,26 @@ void main()
 		F0 = mix(F0, diffuse.rgb, metallic);
 		vec3 Lo = vec3(0.0f);
 
-		for (int i = 0; i < scene.lightsCount; i++)
+		// Only the lights binned into this pixels cluster can reach it.
+		uvec2 tile = min(uvec2(inUV * vec2(CLUSTERS_X, CLUSTERS_Y)), uvec2(CLUSTERS_X - 1u, CLUSTERS_Y - 1u));
+		uint cluster = clusterIndex(uvec3(tile, depthSlice(abs(screenPosition.z), scene.nearPlane, scene.farPlane)));
+		uint lightsCount = bufferClusters.lightCounts[cluster];
+
+		for (uint i = 0; i < lightsCount; i++)
 		{
-			Light light = bufferLights.lights[i];
+			Light light = bufferLights.lights[bufferClusters.lightIndices[cluster * MAX_CLUSTER_LIGHTS + i]];
 			vec3 L = light.position - worldPosition;
 			float Dl = length(L);
 			L /= Dl;
-			Lo += attenuation(Dl, light.radius) * light.colour.rgb * specularContribution(diffuse.rgb, L, V, N, F0, metallic, roughness);
+			float lightAttenuation = attenuation(Dl, light.radius);
+#if defined(RAY_QUERY)
+			// Rays are only traced to lights with a radius that can light the surface.
+			if (scene.rayShadows != 0 && light.radius > 0.0f && lightAttenuation > 0.0f && dot(N, L) > 0.0f)
+			{
+				lightAttenuation *= rayShadowFactor(worldPosition, N, L, Dl);
+			}
+#endif
+			Lo += lightAttenuation * light.colour.rgb * specularContribution(diffuse.rgb, L, V, N, F0, metallic, roughness);
 		}
 	
 		vec2 brdf = texture(samplerBRDF, vec2(max(dot(N, V), 0.0f), roughness)).rg;
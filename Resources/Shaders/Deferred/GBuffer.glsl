@@ -0,0 +1,43 @@
+// Declares the G-buffer outputs of a material, include after Shaders/Deferred/Packing.glsl and write them with storeGBuffer.
+#if defined(COMPACT_GBUFFER)
+layout(location = 0) out vec4 outDiffuse;
+layout(location = 1) out vec4 outNormal;
+layout(location = 2) out vec2 outVelocity;
+#else
+layout(location = 0) out vec4 outPosition;
+layout(location = 1) out vec4 outDiffuse;
+layout(location = 2) out vec4 outNormal;
+layout(location = 3) out vec4 outMaterial;
+layout(location = 4) out vec2 outVelocity;
+#endif
+#if defined(ENTITY_ID)
+layout(location = ENTITY_ID) out uvec2 outEntityId;
+#endif
+
+void storeGBuffer(vec3 position, vec4 diffuse, vec3 normal, vec3 material, vec2 velocity)
+{
+#if defined(COMPACT_GBUFFER)
+	// The position is reconstructed from depth. Roughness moves to the diffuse alpha, metallic and the flags share the normal target, surfaces without a normal are stored as unlit.
+	bool lit = normal != vec3(0.0f);
+	outDiffuse = vec4(diffuse.rgb, material.g);
+	outNormal = vec4(lit ? encodeNormal(normal) : vec2(0.5f), material.r, lit ? material.b : 1.0f);
+	outVelocity = velocity;
+#else
+	outPosition = vec4(position, 1.0f);
+	outDiffuse = diffuse;
+	outNormal = vec4(normal, 1.0f);
+	outMaterial = vec4(material, 1.0f);
+	outVelocity = velocity;
+#endif
+#if defined(ENTITY_ID)
+	outEntityId = uvec2(0);
+#endif
+}
+
+// Writes the slot index and generation of the entity drawn, call after storeGBuffer. Materials that do not call it are stored as no entity.
+void storeEntity(uvec2 entity)
+{
+#if defined(ENTITY_ID)
+	outEntityId = entity;
+#endif
+}
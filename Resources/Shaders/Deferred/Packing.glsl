@@ -0,0 +1,40 @@
+// Packing shared by the shaders that write and read the compact G-buffer.
+
+vec2 signNotZero(vec2 v)
+{
+	return vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+// Octahedral encoding folds the unit sphere onto a square, so a normal fits in two unsigned channels.
+vec2 encodeNormal(vec3 normal)
+{
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+	vec2 encoded = normal.z >= 0.0f ? normal.xy : (1.0f - abs(normal.yx)) * signNotZero(normal.xy);
+	return encoded * 0.5f + 0.5f;
+}
+
+vec3 decodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0f - 1.0f;
+	vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+
+	if (normal.z < 0.0f)
+	{
+		normal.xy = (1.0f - abs(normal.yx)) * signNotZero(normal.xy);
+	}
+
+	return normalize(normal);
+}
+
+// The compact normal target holds the encoded normal, metallic, and the material flags in its two bit alpha. Unlit surfaces such as the skybox are read without a normal.
+vec3 unpackNormal(vec4 packed)
+{
+	return round(packed.a * 3.0f) == 3.0f ? vec3(0.0f) : decodeNormal(packed.rg);
+}
+
+// Positions are reconstructed from the depth of a pixel and the inverse of the view projection it was drawn with.
+vec3 reconstructPosition(vec2 uv, float depth, mat4 invViewProjection)
+{
+	vec4 position = invViewProjection * vec4(uv * 2.0f - 1.0f, depth, 1.0f);
+	return position.xyz / position.w;
+}
@@ -14,6 +14,7 @@ layout(binding = 1) uniform UniformObject
 	vec4 borderColour;
 	vec2 borderSizes;
 	vec2 edgeData;
+	int msdf;
 } object;
 
 layout(binding = 2) uniform sampler2D samplerColour;
@@ -22,11 +23,18 @@ layout(location = 0) in vec2 inUV;
 
 layout(location = 0) out vec4 outColour;
 
+float median(vec3 v)
+{
+	return max(min(v.r, v.g), min(max(v.r, v.g), v.b));
+}
+
 void main() 
 {
-	float distance = texture(samplerColour, inUV).a;
+	// Generated atlases keep corners sharp in the median of the colour channels, borders use the true distance in alpha so they stay rounded.
+	vec4 field = texture(samplerColour, inUV);
+	float distance = object.msdf != 0 ? median(field.rgb) : field.a;
 	float alpha = smoothstep((1.0f - object.edgeData.x) - object.edgeData.y, 1.0f - object.edgeData.x, distance);
-	float outlineAlpha = smoothstep((1.0f - object.borderSizes.x) - object.borderSizes.y, 1.0f - object.borderSizes.x, distance);
+	float outlineAlpha = smoothstep((1.0f - object.borderSizes.x) - object.borderSizes.y, 1.0f - object.borderSizes.x, field.a);
 	float overallAlpha = alpha + (1.0f - alpha) * outlineAlpha;
 	vec3 overallColour = mix(object.borderColour.rgb, object.colour.rgb, alpha / overallAlpha);
 
@@ -20,6 +20,7 @@ layout(binding = 1) uniform UniformObject
 	vec4 borderColour;
 	vec2 borderSizes;
 	vec2 edgeData;
+	int msdf;
 } object;
 
 layout(location = 0) in vec3 inPosition;
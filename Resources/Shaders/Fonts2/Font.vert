@@ -13,6 +13,11 @@ struct Glyph
     uvec4 cellInfo;
 };
 
+layout(binding = 3) uniform UniformScene
+{
+	vec2 extent;
+} scene;
+
 layout(binding = 0) buffer BufferGlyph
 {
 	Glyph glyphs[];
@@ -22,6 +27,7 @@ layout(location = 0) in vec4 inRect;
 layout(location = 1) in uint inGlyphIndex;
 layout(location = 2) in float inSharpness;
 layout(location = 3) in vec4 inColour;
+layout(location = 4) in vec2 inPosition;
 
 layout(location = 0) out vec2 outGlyphPos;
 layout(location = 1) out uvec4 outCellInfo;
@@ -56,7 +62,8 @@ void main()
     cellCoord[2] = vec2(0.0f, gi.cellInfo.w);
     cellCoord[3] = vec2(gi.cellInfo.z, gi.cellInfo.w);
 
-    gl_Position = vec4(pos[gl_VertexIndex], 0.0f, 1.0f);
+    // Rects are in pixels from the text position, which is from 0 to 1 across the screen.
+    gl_Position = vec4(2.0f * inPosition - 1.0f + 2.0f * pos[gl_VertexIndex] / scene.extent, 0.0f, 1.0f);
     outGlyphPos = glyphPos[gl_VertexIndex];
     outCellInfo = gi.cellInfo;
     outSharpness = inSharpness;
@@ -3,10 +3,19 @@
 #extension GL_ARB_shading_language_420pack : enable
 
 layout(location = 0) in vec4 inColour;
+#if defined(ENTITY_ID)
+layout(location = 1) flat in uvec2 inEntity;
+#endif
 
 layout(location = 0) out vec4 outColour;
+#if defined(ENTITY_ID)
+layout(location = ENTITY_ID) out uvec2 outEntityId;
+#endif
 
 void main()
 {
 	outColour = inColour;
+#if defined(ENTITY_ID)
+	outEntityId = inEntity;
+#endif
 }
@@ -12,8 +12,14 @@ layout(location = 0) in vec3 inPosition;
 
 layout(location = 3) in mat4 inModelMatrix;
 layout(location = 7) in vec4 inColour;
+#if defined(ENTITY_ID)
+layout(location = 8) in uvec2 inEntity;
+#endif
 
 layout(location = 0) out vec4 outColour;
+#if defined(ENTITY_ID)
+layout(location = 1) flat out uvec2 outEntity;
+#endif
 
 out gl_PerVertex
 {
@@ -27,4 +33,7 @@ void main()
 	gl_Position = scene.projection * scene.view * worldPosition;
 
 	outColour = inColour;
+#if defined(ENTITY_ID)
+	outEntity = inEntity;
+#endif
 }
@@ -0,0 +1,66 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(binding = 0) uniform UniformScene
+{
+	mat4 projection;
+	mat4 view;
+	float aspectRatio;
+} scene;
+
+layout(binding = 2) uniform sampler2D samplerColour;
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) flat in vec4 inColourOffset;
+layout(location = 2) flat in vec4 inNinePatches;
+layout(location = 3) flat in float inAlpha;
+layout(location = 4) flat in float inScreenRatio;
+
+layout(location = 0) out vec4 outColour;
+
+float map(float value, float originalMin, float originalMax, float newMin, float newMax)
+{
+	return (value - originalMin) / (originalMax - originalMin) * (newMax - newMin) + newMin;
+}
+
+float processAxis(float coord, float textureBorder, float windowBorder)
+{
+	if (coord < windowBorder)
+	{
+		return map(coord, 0.0f, windowBorder, 0.0f, textureBorder);
+	}
+
+	if (coord < 1.0f - windowBorder)
+	{
+		return map(coord, windowBorder, 1.0f - windowBorder, textureBorder, 1.0f - textureBorder);
+	}
+
+	return map(coord, 1.0f - windowBorder, 1.0f, 1.0f - textureBorder, 1.0f);
+}
+
+void main() 
+{
+	if (inNinePatches != vec4(0.0f))
+	{
+		vec2 newUV = vec2(
+		    processAxis(inUV.x, inNinePatches.x, inNinePatches.x / inScreenRatio / scene.aspectRatio),
+		    processAxis(inUV.y, inNinePatches.y, inNinePatches.y)
+		);
+
+		outColour = texture(samplerColour, newUV);
+	}
+	else
+	{
+		outColour = texture(samplerColour, inUV);
+	}
+
+	outColour *= inColourOffset;
+	outColour.a *= inAlpha;
+
+	if (outColour.a < 0.05f)
+	{
+		outColour = vec4(0.0f);
+		discard;
+	}
+}
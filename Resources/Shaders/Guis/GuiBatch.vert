@@ -0,0 +1,62 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(binding = 0) uniform UniformScene
+{
+	mat4 projection;
+	mat4 view;
+	float aspectRatio;
+} scene;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 3) in mat4 inModelMatrix;
+layout(location = 7) in vec4 inScreenOffset;
+layout(location = 8) in vec4 inColourOffset;
+layout(location = 9) in vec4 inNinePatches;
+layout(location = 10) in vec4 inAtlas;
+layout(location = 11) in vec4 inParameters;
+
+layout(location = 0) out vec2 outUV;
+layout(location = 1) flat out vec4 outColourOffset;
+layout(location = 2) flat out vec4 outNinePatches;
+layout(location = 3) flat out float outAlpha;
+layout(location = 4) flat out float outScreenRatio;
+
+out gl_PerVertex 
+{
+	vec4 gl_Position;
+};
+
+#include "Shaders/Billboard.glsl"
+const vec3 rotation = vec3(3.14159f, 0.0f, 0.0f);
+
+void main()
+{
+	float atlasRows = inParameters.x;
+	float depth = inParameters.y;
+	int modelMode = int(inParameters.w);
+	vec4 position = vec4((inPosition.xy * inScreenOffset.xy) + inScreenOffset.zw, 0.0f, 1.0f);
+
+	if (modelMode != 0)
+	{
+		mat4 modelMatrix = modelMatrix(inModelMatrix, scene.view, modelMode == 2, rotation);
+		vec4 worldPosition = modelMatrix * position;
+		gl_Position = scene.projection * scene.view * worldPosition;
+	}
+	else
+	{
+		gl_Position = position;
+		gl_Position.z = 0.5f;
+	}
+
+	gl_Position.z -= depth;
+
+	outUV = inAtlas.zw * ((inUV.xy / atlasRows) + inAtlas.xy);
+	outColourOffset = inColourOffset;
+	outNinePatches = inNinePatches;
+	outAlpha = inParameters.z;
+	outScreenRatio = inScreenOffset.x / inScreenOffset.y;
+}
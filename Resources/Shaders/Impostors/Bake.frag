@@ -0,0 +1,37 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(push_constant) uniform PushObject
+{
+	vec4 centre;
+	vec4 right;
+	vec4 up;
+	vec4 forward;
+	vec4 positionScale;
+	vec4 positionOffset;
+	vec4 baseDiffuse;
+} object;
+
+#if DIFFUSE_MAPPING
+layout(binding = 0) uniform sampler2D samplerDiffuse;
+#endif
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec3 inNormal;
+
+layout(location = 0) out vec4 outDiffuse;
+layout(location = 1) out vec4 outNormal;
+
+void main()
+{
+	vec4 diffuse = object.baseDiffuse;
+
+#if DIFFUSE_MAPPING
+	diffuse = texture(samplerDiffuse, inUV);
+#endif
+
+	// The alpha of the frame is coverage, the normal is stored relative to the frame.
+	outDiffuse = vec4(diffuse.rgb, 1.0f);
+	outNormal = vec4(normalize(inNormal) * 0.5f + 0.5f, 1.0f);
+}
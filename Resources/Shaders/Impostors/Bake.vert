@@ -0,0 +1,63 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(push_constant) uniform PushObject
+{
+	vec4 centre;
+	vec4 right;
+	vec4 up;
+	vec4 forward;
+	vec4 positionScale;
+	vec4 positionOffset;
+	vec4 baseDiffuse;
+} object;
+
+#if QUANTIZED
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec2 inNormal;
+#else
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec3 inNormal;
+#endif
+
+layout(location = 0) out vec2 outUV;
+layout(location = 1) out vec3 outNormal;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+#if QUANTIZED
+// Unfolds a octahedral normal, the lower half of the sphere was folded over the upper half.
+vec3 DecodeNormal(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+	return normalize(normal);
+}
+#endif
+
+void main()
+{
+#if QUANTIZED
+	vec3 position = object.positionOffset.xyz + inPosition.xyz * object.positionScale.xyz;
+	vec3 normal = DecodeNormal(inNormal);
+#else
+	vec3 position = inPosition;
+	vec3 normal = inNormal;
+#endif
+
+	// Orthographic view looking back along the frame direction, the bounding sphere fills the frame.
+	vec3 local = position - object.centre.xyz;
+	float radius = object.centre.w;
+	gl_Position = vec4(dot(local, object.right.xyz) / radius, -dot(local, object.up.xyz) / radius, 0.5f - 0.5f * dot(local, object.forward.xyz) / radius, 1.0f);
+
+	outUV = inUV;
+	outNormal = vec3(dot(normal, object.right.xyz), dot(normal, object.up.xyz), dot(normal, object.forward.xyz));
+}
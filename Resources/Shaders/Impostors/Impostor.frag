@@ -0,0 +1,31 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(binding = 1) uniform sampler2D samplerDiffuse;
+layout(binding = 2) uniform sampler2D samplerNormal;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in mat3 inFrame;
+layout(location = 5) in vec4 inCurrentPosition;
+layout(location = 6) in vec4 inPreviousPosition;
+
+#include "Shaders/Deferred/Packing.glsl"
+#include "Shaders/Deferred/GBuffer.glsl"
+
+void main()
+{
+	vec4 diffuse = texture(samplerDiffuse, inUV);
+
+	if (diffuse.a < 0.5f)
+	{
+		discard;
+	}
+
+	// Frame normals are turned back into world space by the basis the frame was baked with.
+	vec3 normal = inFrame * (texture(samplerNormal, inUV).xyz * 2.0f - 1.0f);
+
+	storeGBuffer(inPosition, vec4(diffuse.rgb, 1.0f), normalize(normal), vec3(0.0f, 1.0f, 0.0f),
+		0.5f * (inCurrentPosition.xy / inCurrentPosition.w - inPreviousPosition.xy / inPreviousPosition.w));
+}
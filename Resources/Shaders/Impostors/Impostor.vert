@@ -0,0 +1,55 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#if defined(MULTIVIEW)
+#extension GL_EXT_multiview : require
+#define VIEW_COUNT MULTIVIEW
+#define VIEW gl_ViewIndex
+#else
+#define VIEW_COUNT 1
+#define VIEW 0
+#endif
+
+layout(binding = 0) uniform UniformScene
+{
+	mat4 projection[VIEW_COUNT];
+	mat4 view[VIEW_COUNT];
+	vec3 cameraPos;
+	mat4 previousProjection[VIEW_COUNT];
+	mat4 previousView[VIEW_COUNT];
+	vec2 jitter;
+} scene;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 3) in vec4 inCentre;
+layout(location = 4) in vec4 inRight;
+layout(location = 5) in vec4 inUp;
+layout(location = 6) in vec4 inForward;
+layout(location = 7) in vec4 inFrame;
+
+layout(location = 0) out vec3 outPosition;
+layout(location = 1) out vec2 outUV;
+layout(location = 2) out mat3 outFrame;
+layout(location = 5) out vec4 outCurrentPosition;
+layout(location = 6) out vec4 outPreviousPosition;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+void main()
+{
+	// The quad stands at the centre of the model facing the frame direction, impostors do not move so they reproject with the previous camera.
+	vec4 worldPosition = vec4(inCentre.xyz + inRight.xyz * inPosition.x + inUp.xyz * inPosition.y, 1.0f);
+
+	gl_Position = scene.projection[VIEW] * scene.view[VIEW] * worldPosition;
+
+	outPosition = worldPosition.xyz;
+	outUV = inFrame.xy + vec2(inPosition.x * 0.5f + 0.5f, 0.5f - inPosition.y * 0.5f) * inFrame.zw;
+	outFrame = mat3(normalize(inRight.xyz), normalize(inUp.xyz), normalize(inForward.xyz));
+	outCurrentPosition = gl_Position;
+	outPreviousPosition = scene.previousProjection[VIEW] * scene.previousView[VIEW] * worldPosition;
+}
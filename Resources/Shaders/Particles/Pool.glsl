@@ -0,0 +1,56 @@
+struct Particle
+{
+	vec4 position; // xyz position, w rotation in degrees.
+	vec4 velocity; // xyz velocity, w gravity effect.
+	vec4 life; // x elapsed time, y life length, z stage cycles, w scale.
+	vec4 state; // x transparency, y squared distance to the camera.
+};
+
+struct DrawCommand
+{
+	uint indexCount;
+	uint instanceCount;
+	uint firstIndex;
+	int vertexOffset;
+	uint firstInstance;
+};
+
+const uint INVALID_PARTICLE = 0xFFFFFFFFu;
+const float FADE_TIME = 1.0f;
+
+layout(binding = 0) uniform UniformParticles
+{
+	vec3 cameraPosition;
+	float delta;
+	uint capacity;
+	uint emitCount;
+	uint currentOffset;
+	uint nextOffset;
+	uint indexCount;
+	uint firstIndex;
+	int vertexOffset;
+	uint reset;
+} particles;
+
+layout(binding = 1) buffer BufferParticles
+{
+	Particle particles[];
+} bufferParticles;
+
+layout(binding = 2) buffer BufferAlive
+{
+	uint alive[];
+} bufferAlive;
+
+layout(binding = 3) buffer BufferDead
+{
+	uint dead[];
+} bufferDead;
+
+// The draw command counts the particles alive after the simulation, the current count is moved out of it before emitting.
+layout(binding = 4) buffer BufferCounters
+{
+	DrawCommand draw;
+	uint aliveCount;
+	uint deadCount;
+} bufferCounters;
@@ -0,0 +1,80 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+struct Particle
+{
+	vec4 position;
+	vec4 velocity;
+	vec4 life;
+	vec4 state;
+};
+
+layout(set = 0, binding = 0) uniform UniformScene
+{
+	mat4 projection;
+	mat4 view;
+} scene;
+
+layout(set = 0, binding = 2) uniform UniformType
+{
+	vec4 colourOffset;
+	float numberOfRows;
+	uint aliveOffset;
+} type;
+
+layout(set = 0, binding = 3) readonly buffer BufferParticles
+{
+	Particle particles[];
+} bufferParticles;
+
+layout(set = 0, binding = 4) readonly buffer BufferAlive
+{
+	uint alive[];
+} bufferAlive;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 0) out vec2 outCoords1;
+layout(location = 1) out vec2 outCoords2;
+layout(location = 2) out vec4 outColourOffset;
+layout(location = 3) out float outBlendFactor;
+layout(location = 4) out float outTransparency;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+vec2 imageOffset(int index)
+{
+	int rows = int(type.numberOfRows);
+	return vec2(index % rows, index / rows) / type.numberOfRows;
+}
+
+void main()
+{
+	Particle particle = bufferParticles.particles[bufferAlive.alive[type.aliveOffset + gl_InstanceIndex]];
+
+	// Faces the quad towards the camera by using the inverse of the views rotation.
+	float rotation = radians(particle.position.w);
+	vec2 corner = mat2(cos(rotation), sin(rotation), -sin(rotation), cos(rotation)) * inPosition.xy;
+	vec3 worldPosition = particle.position.xyz + transpose(mat3(scene.view)) * (vec3(corner, inPosition.z) * particle.life.w);
+
+	gl_Position = scene.projection * scene.view * vec4(worldPosition, 1.0f);
+
+	// Blends between the two atlas stages of the particles lifetime.
+	int stageCount = int(type.numberOfRows * type.numberOfRows);
+	float atlasProgression = particle.life.z * particle.life.x / particle.life.y * stageCount;
+	int index1 = int(floor(atlasProgression));
+	int index2 = index1 < stageCount - 1 ? index1 + 1 : index1;
+
+	vec2 uv = inUV / type.numberOfRows;
+
+	outColourOffset = type.colourOffset;
+	outCoords1 = uv + imageOffset(index1);
+	outCoords2 = uv + imageOffset(index2);
+	outBlendFactor = fract(atlasProgression);
+	outTransparency = particle.state.x;
+}
@@ -0,0 +1,85 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(push_constant) uniform PushScene
+{
+	float innerRadius;
+	float outerRadius;
+	float opacity;
+	float strength;
+	float factor;
+} scene;
+
+layout(binding = 0, rgba8) uniform writeonly image2D writeColour;
+
+layout(binding = 1) uniform sampler2D samplerColour;
+
+layout(location = 0) in vec2 inUV;
+
+// Filled in by the filter chain with the links to apply.
+#ifndef CHAIN
+#define CHAIN
+#endif
+
+const float gamma = 2.0f;
+const float inverseGamma = 1.0f / gamma;
+
+vec3 uncharted2(vec3 hdr)
+{
+	float A = 0.15f;
+	float B = 0.50f;
+	float C = 0.10f;
+	float D = 0.20f;
+	float E = 0.02f;
+	float F = 0.30f;
+	return ((hdr * (A * hdr + C * B) + D * E) / (hdr * (A * hdr + B) + D * F)) - E / F;
+}
+
+vec4 Tone(vec4 colour)
+{
+	return vec4(pow(uncharted2(colour.rgb), vec3(inverseGamma)), 1.0f);
+}
+
+vec4 Vignette(vec4 colour)
+{
+	vec4 vignette = colour;
+	vignette.rgb *= 1.0f - smoothstep(scene.innerRadius, scene.outerRadius, length(inUV - 0.5f));
+	return mix(colour, vignette, scene.opacity);
+}
+
+vec4 Grain(vec4 colour)
+{
+	float x = (inUV.x + 4.0f) * (inUV.y + 4.0f) * 10.0f;
+	return colour + vec4(mod((mod(x, 13.0f) + 1.0f) * (mod(x, 123.0f) + 1.0f), 0.01f) - 0.005f) * scene.strength;
+}
+
+vec4 Sepia(vec4 colour)
+{
+	float grey = dot(colour.rgb, vec3(0.299f, 0.587f, 0.114f));
+	return vec4(grey * vec3(1.2f, 1.0f, 0.8f), 1.0f);
+}
+
+vec4 Grey(vec4 colour)
+{
+	float grey = dot(colour.rgb, vec3(0.299f, 0.587f, 0.114f));
+	return vec4(grey, grey, grey, 1.0f);
+}
+
+vec4 Darken(vec4 colour)
+{
+	return vec4(colour.rgb * scene.factor, colour.a);
+}
+
+vec4 Negative(vec4 colour)
+{
+	return vec4(1.0f - colour.rgb, 1.0f);
+}
+
+void main() 
+{
+	vec4 colour = texture(samplerColour, inUV);
+	CHAIN
+	
+	imageStore(writeColour, ivec2(inUV * imageSize(writeColour)), colour);
+}
@@ -1,6 +1,9 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
+#if defined(SHADING_RATE)
+#extension GL_EXT_fragment_shading_rate : require
+#endif
 
 layout(push_constant) uniform PushScene
 {
@@ -22,6 +25,8 @@ layout(binding = 3) uniform sampler2D samplerBlured;
 
 layout(location = 0) in vec2 inUV;
 
+#include "Shaders/Post/ShadingRate.glsl"
+
 float linearDepth(float depth)
 {
 	float z = depth * 2.0f - 1.0f;
@@ -42,5 +47,5 @@ void main()
 	vec4 colour = vec4(mix(textureBlured, textureColour, nearVisibility), 1.0f);
 	colour.rgb = mix(textureBlured, colour.rgb, farVisibility);
 
-	imageStore(writeColour, ivec2(inUV * imageSize(writeColour)), colour);
+	storeFragment(colour);
 }
@@ -1,6 +1,9 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
+#if defined(SHADING_RATE)
+#extension GL_EXT_fragment_shading_rate : require
+#endif
 
 layout(push_constant) uniform PushScene
 {
@@ -16,6 +19,8 @@ layout(binding = 2) uniform sampler2D samplerMaterial;
 
 layout(location = 0) in vec2 inUV;
 
+#include "Shaders/Post/ShadingRate.glsl"
+
 bool insideScreen(vec2 test) 
 {
 	return test.x >= 0.0f && test.x <= 1.0f && test.y >= 0.0f && test.y <= 1.0f;
@@ -26,7 +31,12 @@ void main()
 	vec2 sun2 = vec2(scene.sunPosition.x, scene.sunPosition.y);
 	vec2 sunCoord = (sun2 + 1.0f) / 2.0f;
 
+#if defined(COMPACT_GBUFFER)
+	// The compact G-buffer keeps metallic in the normal target.
+	float metallic = texture(samplerMaterial, sunCoord).b;
+#else
 	float metallic = texture(samplerMaterial, sunCoord).r;
+#endif
 	bool process = scene.sunPosition.z >= 0.0f && (metallic > 0.4f || !insideScreen(sunCoord));
 
 	vec2 uv = (inUV - 0.5f) * (scene.displaySize.x / scene.displaySize.y);
@@ -69,5 +79,5 @@ void main()
 
 	vec4 colour = texture(samplerColour, inUV) + vec4(flare, 0.0f);
 
-	imageStore(writeColour, ivec2(inUV * imageSize(writeColour)), colour);
+	storeFragment(colour);
 }
@@ -0,0 +1,21 @@
+// Stores the colour of this fragment to writeColour at inUV, both declared by the including shader.
+// Pipelines created with shading rates define SHADING_RATE, a coarse fragment then covers a block of pixels that are all stored with its colour.
+void storeFragment(vec4 colour)
+{
+#if defined(SHADING_RATE)
+	ivec2 size = ivec2(1 << ((gl_ShadingRateEXT >> 2) & 3), 1 << (gl_ShadingRateEXT & 3));
+#else
+	ivec2 size = ivec2(1);
+#endif
+
+	// The fragments coordinate is the centre of the block it covers.
+	ivec2 origin = ivec2(inUV * imageSize(writeColour) - 0.5f * vec2(size - 1));
+
+	for (int y = 0; y < size.y; y++)
+	{
+		for (int x = 0; x < size.x; x++)
+		{
+			imageStore(writeColour, origin + ivec2(x, y), colour);
+		}
+	}
+}
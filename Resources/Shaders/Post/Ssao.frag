@@ -4,37 +4,79 @@
 
 layout(binding = 0) uniform UniformScene
 {
-	vec3 kernel[SSAO_KERNEL_SIZE];
+	vec4 kernel[SSAO_KERNEL_SIZE];
 
 	mat4 projection;
 	mat4 view;
+	mat4 previousViewProjection;
+	mat4 invViewProjection;
 	vec3 cameraPosition;
+	vec2 noiseOffset;
+	float blend;
 } scene;
 
-layout(binding = 0, rgba8) uniform writeonly image2D writeColour;
+layout(binding = 1, rgba16f) uniform writeonly image2D writeOcclusion;
 
-layout(binding = 1) uniform sampler2D samplerPosition;
-layout(binding = 2) uniform sampler2D samplerNormal;
-layout(binding = 3) uniform sampler2D samplerNoise;
+#if defined(COMPACT_GBUFFER)
+layout(binding = 2) uniform sampler2D samplerDepth;
+#else
+layout(binding = 2) uniform sampler2D samplerPosition;
+#endif
+layout(binding = 3) uniform sampler2D samplerNormal;
+layout(binding = 4) uniform sampler2D samplerNoise;
+layout(binding = 5) uniform sampler2D samplerHistory;
 
 layout(location = 0) in vec2 inUV;
 
+#include "Shaders/Deferred/Packing.glsl"
+
+vec3 gbufferPosition(vec2 uv)
+{
+#if defined(COMPACT_GBUFFER)
+	return reconstructPosition(uv, texture(samplerDepth, uv).r, scene.invViewProjection);
+#else
+	return texture(samplerPosition, uv).rgb;
+#endif
+}
+
+vec3 gbufferNormal(vec2 uv)
+{
+#if defined(COMPACT_GBUFFER)
+	return unpackNormal(texture(samplerNormal, uv));
+#else
+	return texture(samplerNormal, uv).rgb;
+#endif
+}
+
+// How far the depth of the history may be from the reprojected depth, relative to that depth, before it is rejected.
+const float historyTolerance = 0.05f;
+
 void main() 
 {
+	ivec2 writeCoord = ivec2(inUV * imageSize(writeOcclusion));
+
 	// Get G-Buffer values.
-	vec3 worldPosition = texture(samplerPosition, inUV).rgb;
+	vec3 worldPosition = gbufferPosition(inUV);
+	vec3 worldNormal = gbufferNormal(inUV);
 
-	vec3 normal = texture(samplerNormal, inUV).rgb;
+	vec3 position = (scene.view * vec4(worldPosition, 1.0f)).xyz;
 
-	// Get a random vector using a noise lookup.
-	ivec2 texDim = textureSize(samplerPosition, 0);
+	// Surfaces without a normal, such as the skybox, are never occluded.
+	if (dot(worldNormal, worldNormal) == 0.0f)
+	{
+		imageStore(writeOcclusion, writeCoord, vec4(1.0f, -position.z, 0.0f, 1.0f));
+		return;
+	}
+
+	vec3 normal = normalize(mat3(scene.view) * worldNormal);
+
+	// Get a random vector using a noise lookup, the noise tiles over the pixels being written.
 	ivec2 noiseDim = textureSize(samplerNoise, 0);
-	vec2 noiseUv = vec2(float(texDim.x) / float(noiseDim.x), float(texDim.y) / (noiseDim.y)) * inUV;
-	vec3 randomVec = texture(samplerNoise, noiseUv).rgb * 2.0f - 1.0f;
+	vec3 randomVec = texelFetch(samplerNoise, ivec2(mod(vec2(writeCoord) + scene.noiseOffset, vec2(noiseDim))), 0).rgb;
 
 	// Create TBN matrix.
 	vec3 tangent = normalize(randomVec - normal * dot(randomVec, normal));
-	vec3 bitangent = cross(tangent, normal);
+	vec3 bitangent = cross(normal, tangent);
 	mat3 TBN = mat3(tangent, bitangent, normal);
 
 	// Calculate occlusion value.
@@ -42,27 +84,44 @@ void main()
 
 	for (int i = 0; i < SSAO_KERNEL_SIZE; i++)
 	{
-		vec3 samplePos = TBN * scene.kernel[i];
-		samplePos = samplePos * SSAO_RADIUS + worldPosition;
+		vec3 samplePos = TBN * scene.kernel[i].xyz;
+		samplePos = samplePos * SSAO_RADIUS + position;
 
-		// project
-		vec4 offset = vec4(samplePos, 1.0f);
-		offset = scene.projection * offset;
-		offset.xyz /= offset.w;
-		offset.xyz = offset.xyz * 0.5f + 0.5f;
+		// Project the sample into the G-Buffer.
+		vec4 offset = scene.projection * vec4(samplePos, 1.0f);
+		offset.xy /= offset.w;
+		offset.xy = offset.xy * 0.5f + 0.5f;
 
 		// Sample depth.
-		float sampleDepth = -length(scene.cameraPosition - texture(samplerPosition, offset.xy).rgb);
-		
+		float sampleDepth = (scene.view * vec4(gbufferPosition(offset.xy), 1.0f)).z;
+
 #ifdef RANGE_CHECK
 		// Range check.
-		float rangeCheck = smoothstep(0.0f, 1.0f, SSAO_RADIUS / abs(worldPosition.z - sampleDepth));
-		occlusion += (sampleDepth >= samplePos.z ? 1.0f : 0.0f) * rangeCheck;
+		float rangeCheck = smoothstep(0.0f, 1.0f, SSAO_RADIUS / abs(position.z - sampleDepth));
+#else
+		float rangeCheck = 1.0f;
 #endif
+		occlusion += (sampleDepth >= samplePos.z + 0.025f ? 1.0f : 0.0f) * rangeCheck;
 	}
 
 	occlusion = 1.0f - (occlusion / float(SSAO_KERNEL_SIZE));
-	vec4 colour = vec4(texture(samplerNoise, inUV).rgb, 1.0f); // occlusion, occlusion, occlusion
-	
-	imageStore(writeColour, ivec2(inUV * imageSize(writeColour)), colour);
+
+	// Blends with the occlusion this surface had last frame, found by reprojecting through the previous camera.
+	if (scene.blend < 1.0f)
+	{
+		vec4 previous = scene.previousViewProjection * vec4(worldPosition, 1.0f);
+		vec2 previousUV = previous.xy / previous.w * 0.5f + 0.5f;
+
+		if (previous.w > 0.0f && all(greaterThanEqual(previousUV, vec2(0.0f))) && all(lessThanEqual(previousUV, vec2(1.0f))))
+		{
+			vec2 history = texture(samplerHistory, previousUV).rg;
+
+			if (abs(history.g - previous.w) < historyTolerance * previous.w)
+			{
+				occlusion = mix(history.r, occlusion, scene.blend);
+			}
+		}
+	}
+
+	imageStore(writeOcclusion, writeCoord, vec4(occlusion, -position.z, 0.0f, 1.0f));
 }
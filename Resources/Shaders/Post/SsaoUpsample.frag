@@ -0,0 +1,97 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#if defined(SHADING_RATE)
+#extension GL_EXT_fragment_shading_rate : require
+#endif
+
+layout(push_constant) uniform PushScene
+{
+	mat4 view;
+	mat4 invViewProjection;
+} scene;
+
+layout(binding = 0, rgba8) uniform writeonly image2D writeColour;
+
+layout(binding = 1) uniform sampler2D samplerColour;
+layout(binding = 2) uniform sampler2D samplerOcclusion;
+#if defined(COMPACT_GBUFFER)
+layout(binding = 3) uniform sampler2D samplerDepth;
+#else
+layout(binding = 3) uniform sampler2D samplerPosition;
+#endif
+layout(binding = 4) uniform sampler2D samplerNormal;
+
+layout(location = 0) in vec2 inUV;
+
+#include "Shaders/Post/ShadingRate.glsl"
+
+#include "Shaders/Deferred/Packing.glsl"
+
+vec3 gbufferPosition(vec2 uv)
+{
+#if defined(COMPACT_GBUFFER)
+	return reconstructPosition(uv, texture(samplerDepth, uv).r, scene.invViewProjection);
+#else
+	return texture(samplerPosition, uv).rgb;
+#endif
+}
+
+vec3 gbufferNormal(vec2 uv)
+{
+#if defined(COMPACT_GBUFFER)
+	return unpackNormal(texture(samplerNormal, uv));
+#else
+	return texture(samplerNormal, uv).rgb;
+#endif
+}
+
+// How sharply texels across a normal edge are rejected.
+const float normalPower = 8.0f;
+
+void main() 
+{
+	vec3 worldNormal = gbufferNormal(inUV);
+	float depth = -(scene.view * vec4(gbufferPosition(inUV), 1.0f)).z;
+
+	// The four occlusion texels around this pixel are weighted bilinearly, then by how closely their depth and normal match this pixel.
+	ivec2 occlusionSize = textureSize(samplerOcclusion, 0);
+	vec2 occlusionPos = inUV * vec2(occlusionSize) - 0.5f;
+	ivec2 base = ivec2(floor(occlusionPos));
+	vec2 f = fract(occlusionPos);
+
+	float occlusion = 0.0f;
+	float totalWeight = 0.0f;
+	float fallback = 1.0f;
+	float fallbackWeight = -1.0f;
+
+	for (int y = 0; y <= 1; y++)
+	{
+		for (int x = 0; x <= 1; x++)
+		{
+			ivec2 coord = clamp(base + ivec2(x, y), ivec2(0), occlusionSize - 1);
+			vec2 texel = texelFetch(samplerOcclusion, coord, 0).rg;
+			vec3 texelNormal = gbufferNormal((vec2(coord) + 0.5f) / vec2(occlusionSize));
+
+			float bilinear = (x == 1 ? f.x : 1.0f - f.x) * (y == 1 ? f.y : 1.0f - f.y);
+			float depthWeight = 1.0f / (0.001f + abs(texel.g - depth) / max(depth, 0.001f));
+			float normalWeight = pow(max(dot(texelNormal, worldNormal), 0.0f), normalPower);
+			float weight = bilinear * depthWeight * normalWeight;
+
+			occlusion += texel.r * weight;
+			totalWeight += weight;
+
+			// When every texel is rejected the one at the closest depth is used.
+			if (depthWeight > fallbackWeight)
+			{
+				fallback = texel.r;
+				fallbackWeight = depthWeight;
+			}
+		}
+	}
+
+	occlusion = dot(worldNormal, worldNormal) == 0.0f ? 1.0f : totalWeight > 0.0001f ? occlusion / totalWeight : fallback;
+	vec4 colour = vec4(texture(samplerColour, inUV).rgb * occlusion, 1.0f);
+
+	storeFragment(colour);
+}
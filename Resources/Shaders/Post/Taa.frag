@@ -0,0 +1,60 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(push_constant) uniform PushScene
+{
+	float blend;
+} scene;
+
+layout(binding = 0, rgba8) uniform writeonly image2D writeColour;
+
+layout(binding = 1) uniform sampler2D samplerColour;
+layout(binding = 2) uniform sampler2D samplerVelocity;
+layout(binding = 3) uniform sampler2D samplerHistory;
+
+layout(binding = 4, rgba16f) uniform writeonly image2D writeHistory;
+
+layout(location = 0) in vec2 inUV;
+
+// How many standard deviations of the neighbourhood a history colour may be from its mean.
+const float clipGamma = 1.25f;
+
+void main() 
+{
+	vec2 texelSize = 1.0f / vec2(textureSize(samplerColour, 0));
+	vec3 current = texture(samplerColour, inUV).rgb;
+
+	// The mean and variance of the 3x3 neighbourhood bound the colours the history may have.
+	vec3 moment1 = vec3(0.0f);
+	vec3 moment2 = vec3(0.0f);
+
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			vec3 neighbour = texture(samplerColour, inUV + vec2(x, y) * texelSize).rgb;
+			moment1 += neighbour;
+			moment2 += neighbour * neighbour;
+		}
+	}
+
+	moment1 /= 9.0f;
+	moment2 /= 9.0f;
+	vec3 deviation = sqrt(max(moment2 - moment1 * moment1, 0.0f));
+	vec3 minColour = moment1 - clipGamma * deviation;
+	vec3 maxColour = moment1 + clipGamma * deviation;
+
+	vec2 historyUV = inUV - texture(samplerVelocity, inUV).xy;
+	vec3 result = current;
+
+	// Pixels that were off screen last frame, or a history that was just created, start from the current frame.
+	if (scene.blend < 1.0f && all(greaterThanEqual(historyUV, vec2(0.0f))) && all(lessThanEqual(historyUV, vec2(1.0f))))
+	{
+		vec3 history = clamp(texture(samplerHistory, historyUV).rgb, minColour, maxColour);
+		result = mix(history, current, scene.blend);
+	}
+
+	imageStore(writeColour, ivec2(inUV * imageSize(writeColour)), vec4(result, 1.0f));
+	imageStore(writeHistory, ivec2(inUV * imageSize(writeHistory)), vec4(result, 1.0f));
+}
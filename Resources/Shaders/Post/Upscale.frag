@@ -0,0 +1,55 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(push_constant) uniform PushScene
+{
+	float sharpness;
+} scene;
+
+layout(binding = 0) uniform sampler2D samplerColour;
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 outColour;
+
+// Catmull-Rom filtering with 9 bilinear taps, the weights of each pair of inner texels are merged into one tap.
+vec4 sampleCatmullRom(vec2 uv)
+{
+	vec2 size = vec2(textureSize(samplerColour, 0));
+	vec2 samplePosition = uv * size;
+	vec2 texPos1 = floor(samplePosition - 0.5f) + 0.5f;
+	vec2 f = samplePosition - texPos1;
+
+	vec2 w0 = f * (-0.5f + f * (1.0f - 0.5f * f));
+	vec2 w1 = 1.0f + f * f * (-2.5f + 1.5f * f);
+	vec2 w2 = f * (0.5f + f * (2.0f - 1.5f * f));
+	vec2 w3 = f * f * (-0.5f + 0.5f * f);
+
+	vec2 w12 = w1 + w2;
+	vec2 offset12 = w2 / w12;
+
+	vec2 texPos0 = (texPos1 - 1.0f) / size;
+	vec2 texPos3 = (texPos1 + 2.0f) / size;
+	vec2 texPos12 = (texPos1 + offset12) / size;
+
+	vec4 result = vec4(0.0f);
+	result += texture(samplerColour, vec2(texPos0.x, texPos0.y)) * w0.x * w0.y;
+	result += texture(samplerColour, vec2(texPos12.x, texPos0.y)) * w12.x * w0.y;
+	result += texture(samplerColour, vec2(texPos3.x, texPos0.y)) * w3.x * w0.y;
+	result += texture(samplerColour, vec2(texPos0.x, texPos12.y)) * w0.x * w12.y;
+	result += texture(samplerColour, vec2(texPos12.x, texPos12.y)) * w12.x * w12.y;
+	result += texture(samplerColour, vec2(texPos3.x, texPos12.y)) * w3.x * w12.y;
+	result += texture(samplerColour, vec2(texPos0.x, texPos3.y)) * w0.x * w3.y;
+	result += texture(samplerColour, vec2(texPos12.x, texPos3.y)) * w12.x * w3.y;
+	result += texture(samplerColour, vec2(texPos3.x, texPos3.y)) * w3.x * w3.y;
+	return max(result, vec4(0.0f));
+}
+
+void main() 
+{
+	vec4 bicubic = sampleCatmullRom(inUV);
+	vec4 bilinear = texture(samplerColour, inUV);
+
+	outColour = clamp(bicubic + (bicubic - bilinear) * scene.sharpness, 0.0f, 1.0f);
+}
@@ -15,11 +15,11 @@ layout(binding = 2) uniform samplerCube samplerColour;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inUVW;
+layout(location = 2) in vec4 inCurrentPosition;
+layout(location = 3) in vec4 inPreviousPosition;
 
-layout(location = 0) out vec4 outPosition;
-layout(location = 1) out vec4 outDiffuse;
-layout(location = 2) out vec4 outNormal;
-layout(location = 3) out vec4 outMaterial;
+#include "Shaders/Deferred/Packing.glsl"
+#include "Shaders/Deferred/GBuffer.glsl"
 
 void main() 
 {
@@ -29,8 +29,6 @@ void main()
 	float fadeFactor = 1.0f - smoothstep(object.fogLimits.x, object.fogLimits.y, inPosition.y);
 	colour = mix(colour, object.fogColour.rgb, fadeFactor);
 	
-	outPosition = vec4(inPosition, 1.0f);
-	outDiffuse = vec4(colour, 1.0f);
-	outNormal = vec4(0.0f);
-	outMaterial = vec4(0.0f);
+	storeGBuffer(inPosition, vec4(colour, 1.0f), vec3(0.0f), vec3(0.0f),
+		0.5f * (inCurrentPosition.xy / inCurrentPosition.w - inPreviousPosition.xy / inPreviousPosition.w));
 }
\ No newline at end of file
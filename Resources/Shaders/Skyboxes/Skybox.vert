@@ -7,6 +7,9 @@ layout(binding = 0) uniform UniformScene
 	mat4 projection;
 	mat4 view;
 	vec3 cameraPos;
+	mat4 previousProjection;
+	mat4 previousView;
+	vec2 jitter;
 } scene;
 
 layout(binding = 1) uniform UniformObject 
@@ -22,6 +25,8 @@ layout(location = 0) in vec3 inPosition;
 
 layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec3 outUVW;
+layout(location = 2) out vec4 outCurrentPosition;
+layout(location = 3) out vec4 outPreviousPosition;
 
 out gl_PerVertex 
 {
@@ -39,6 +44,14 @@ void main()
 	
 	gl_Position = scene.projection * viewStatic * worldPosition;
 
+	mat4 previousViewStatic = mat4(scene.previousView);
+	previousViewStatic[3][0] = 0.0f;
+	previousViewStatic[3][1] = 0.0f;
+	previousViewStatic[3][2] = 0.0f;
+
+	outCurrentPosition = gl_Position - vec4(scene.jitter * gl_Position.w, 0.0f, 0.0f);
+	outPreviousPosition = scene.previousProjection * previousViewStatic * worldPosition;
+
 	outPosition = worldPosition.xyz;
 	outUVW = inPosition;
 }
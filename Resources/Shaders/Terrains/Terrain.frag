@@ -2,32 +2,36 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
-layout(binding = 1) uniform UniformObject
-{
-	mat4 transform;
-} object;
-
-layout(binding = 2) uniform sampler2D samplerR;
-layout(binding = 3) uniform sampler2D samplerG;
+#if defined(VIRTUAL_TEXTURE)
+#define VIRTUAL_BINDING 4
+#include "Shaders/VirtualTexture.glsl"
+#else
+layout(binding = 4) uniform sampler2D samplerR;
+layout(binding = 5) uniform sampler2D samplerG;
+#endif
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec4 inCurrentPosition;
+layout(location = 4) in vec4 inPreviousPosition;
+layout(location = 5) in vec2 inTerrainUV;
 
-layout(location = 0) out vec4 outPosition;
-layout(location = 1) out vec4 outDiffuse;
-layout(location = 2) out vec4 outNormal;
-layout(location = 3) out vec4 outMaterial;
+#include "Shaders/Deferred/Packing.glsl"
+#include "Shaders/Deferred/GBuffer.glsl"
 
 void main()
 {
-//	vec4 diffuse = vec4(0.0f, 0.0f, 0.0f, 1.0f);
-//	diffuse.rgb += inTexture.r * texture(samplerR, inUV).rgb;
-//	diffuse.rgb += inTexture.g * texture(samplerG, inUV).rgb;
-	vec4 diffuse = texture(samplerR, inUV);
-	
-	outPosition = vec4(inPosition, 1.0f);
-	outDiffuse = diffuse;
-	outNormal = vec4(normalize(inNormal), 1.0f);
-	outMaterial = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	vec3 normal = normalize(inNormal);
+
+#if defined(VIRTUAL_TEXTURE)
+	// The virtual texture covers the whole terrain once.
+	vec4 diffuse = sampleVirtual(inTerrainUV);
+#else
+	// Flat ground is drawn with the first image, and blends into the second on steep slopes.
+	float slope = smoothstep(0.7f, 0.9f, normal.y);
+	vec4 diffuse = mix(texture(samplerG, inUV), texture(samplerR, inUV), slope);
+#endif
+
+	storeGBuffer(inPosition, diffuse, normal, vec3(0.0f), 0.5f * (inCurrentPosition.xy / inCurrentPosition.w - inPreviousPosition.xy / inPreviousPosition.w));
 }
@@ -2,18 +2,39 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
+struct Chunk
+{
+	vec2 offset;
+	float size;
+	uint lod;
+	vec2 morph;
+	vec2 padding;
+};
+
 layout(binding = 0) uniform UniformScene
 {
 	mat4 projection;
 	mat4 view;
 	vec3 cameraPos;
+	mat4 previousProjection;
+	mat4 previousView;
+	vec2 jitter;
 } scene;
 
 layout(binding = 1) uniform UniformObject
 {
-	mat4 transform;
+	vec3 position;
+	float sideLength;
+	int heightmapSize;
 } object;
 
+layout(binding = 2) buffer readonly BufferChunks
+{
+	Chunk chunks[];
+} bufferChunks;
+
+layout(binding = 3) uniform sampler2D samplerHeight;
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
@@ -21,20 +42,61 @@ layout(location = 2) in vec3 inNormal;
 layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec2 outUV;
 layout(location = 2) out vec3 outNormal;
+layout(location = 3) out vec4 outCurrentPosition;
+layout(location = 4) out vec4 outPreviousPosition;
+layout(location = 5) out vec2 outTerrainUV;
 
 out gl_PerVertex
 {
 	vec4 gl_Position;
 };
 
+const float RESOLUTION = float(PATCH_RESOLUTION);
+
+// Float images are not always filterable, so heights are fetched and interpolated here.
+float GetHeight(vec2 position)
+{
+	vec2 texel = clamp(position / object.sideLength + 0.5f, 0.0f, 1.0f) * float(object.heightmapSize - 1);
+	ivec2 base = min(ivec2(floor(texel)), ivec2(object.heightmapSize - 2));
+	vec2 factor = texel - vec2(base);
+
+	float h00 = texelFetch(samplerHeight, base, 0).r;
+	float h10 = texelFetch(samplerHeight, base + ivec2(1, 0), 0).r;
+	float h01 = texelFetch(samplerHeight, base + ivec2(0, 1), 0).r;
+	float h11 = texelFetch(samplerHeight, base + ivec2(1, 1), 0).r;
+	return mix(mix(h00, h10, factor.x), mix(h01, h11, factor.x), factor.y);
+}
+
 void main()
 {
-	vec4 worldPosition = object.transform * vec4(inPosition, 1.0f);
-    mat3 normalMatrix = transpose(inverse(mat3(object.transform)));
+	Chunk chunk = bufferChunks.chunks[gl_InstanceIndex];
+
+	// Vertices morph onto the grid of the next coarser level by the end of their levels range, so they meet the coarser chunks next to them.
+	vec2 grid = inPosition.xz;
+	vec2 local = chunk.offset + grid * chunk.size;
+	float cameraDistance = length(vec3(local.x, GetHeight(local), local.y) + object.position - scene.cameraPos);
+	float morph = clamp((cameraDistance - chunk.morph.x) / (chunk.morph.y - chunk.morph.x), 0.0f, 1.0f);
+	grid -= fract(grid * RESOLUTION * 0.5f) * 2.0f / RESOLUTION * morph;
+	local = chunk.offset + grid * chunk.size;
+
+	vec4 worldPosition = vec4(vec3(local.x, GetHeight(local), local.y) + object.position, 1.0f);
+
+	// Normals are taken from the heights either side of the vertex, one quad of this chunk apart.
+	float spacing = chunk.size / RESOLUTION;
+	float heightL = GetHeight(local - vec2(spacing, 0.0f));
+	float heightR = GetHeight(local + vec2(spacing, 0.0f));
+	float heightD = GetHeight(local - vec2(0.0f, spacing));
+	float heightU = GetHeight(local + vec2(0.0f, spacing));
+	vec3 normal = normalize(vec3(heightL - heightR, 2.0f * spacing, heightD - heightU));
 
 	gl_Position = scene.projection * scene.view * worldPosition;
-	
+
+	// Terrain does not move, only the camera adds motion.
+	outCurrentPosition = gl_Position - vec4(scene.jitter * gl_Position.w, 0.0f, 0.0f);
+	outPreviousPosition = scene.previousProjection * scene.previousView * worldPosition;
+
 	outPosition = worldPosition.xyz;
-	outUV = inUV;
-	outNormal = normalMatrix * normalize(inNormal);
+	outUV = local * 0.08f;
+	outTerrainUV = local / object.sideLength + 0.5f;
+	outNormal = normal;
 }
@@ -0,0 +1,68 @@
+// Samples a texture streamed by acid::VirtualTexture, the including shader defines VIRTUAL_BINDING as the first of the four bindings it uses.
+layout(binding = VIRTUAL_BINDING) uniform UniformVirtual
+{
+	uint pagesPerSide;
+	uint levelCount;
+	float pageSize;
+	float pageBorder;
+	float cacheTexels;
+} virtualTexture;
+
+layout(binding = VIRTUAL_BINDING + 1) readonly buffer BufferPageTable
+{
+	uint entries[];
+} bufferPageTable;
+
+layout(binding = VIRTUAL_BINDING + 2) writeonly buffer BufferFeedback
+{
+	uint pages[];
+} bufferFeedback;
+
+layout(binding = VIRTUAL_BINDING + 3) uniform sampler2D samplerPages;
+
+// Each level has a quarter of the pages of the level before it.
+uint virtualLevelOffset(uint level)
+{
+	uint pages = virtualTexture.pagesPerSide;
+	uint levelPages = pages >> level;
+	return 4u * (pages * pages - levelPages * levelPages) / 3u;
+}
+
+vec4 sampleVirtual(vec2 uv)
+{
+	uv = clamp(uv, 0.0f, 1.0f);
+
+	// The level is chosen from how many texels of the finest level a pixel covers.
+	vec2 texels = uv * float(virtualTexture.pagesPerSide) * virtualTexture.pageSize;
+	vec2 dx = dFdx(texels);
+	vec2 dy = dFdy(texels);
+	float lod = 0.5f * log2(max(dot(dx, dx), dot(dy, dy)));
+	uint level = uint(clamp(floor(lod), 0.0f, float(virtualTexture.levelCount - 1u)));
+
+	// One pixel in each two by two block records the page it wanted, which is enough to find every page drawn without every pixel writing.
+	if ((uint(gl_FragCoord.x) & 1u) == 0u && (uint(gl_FragCoord.y) & 1u) == 0u)
+	{
+		uint pages = virtualTexture.pagesPerSide >> level;
+		uvec2 page = min(uvec2(uv * float(pages)), uvec2(pages - 1u));
+		bufferFeedback.pages[virtualLevelOffset(level) + page.y * pages + page.x] = 1u;
+	}
+
+	// Pages that are not resident fall back to the closest coarser level that is.
+	for (uint i = level; i < virtualTexture.levelCount; i++)
+	{
+		uint pages = virtualTexture.pagesPerSide >> i;
+		vec2 pageUv = uv * float(pages);
+		uvec2 page = min(uvec2(pageUv), uvec2(pages - 1u));
+		uint entry = bufferPageTable.entries[virtualLevelOffset(i) + page.y * pages + page.x];
+
+		if (entry != 0u)
+		{
+			vec2 slot = vec2(float(entry & 0xFFFFu), float((entry >> 16u) & 0x7FFFu));
+			vec2 texel = slot * (virtualTexture.pageSize + 2.0f * virtualTexture.pageBorder) + virtualTexture.pageBorder + (pageUv - vec2(page)) * virtualTexture.pageSize;
+			return textureLod(samplerPages, texel / virtualTexture.cacheTexels, 0.0f);
+		}
+	}
+
+	// Nothing is drawn from the texture until its coarsest page is resident.
+	return vec4(0.5f, 0.5f, 0.5f, 1.0f);
+}
@@ -2,19 +2,28 @@
 
 #include "Animations/Animation/Animation.hpp"
 #include "Animations/Animation/AnimationLoader.hpp"
+#include "Animations/Animation/CompressedAnimation.hpp"
 #include "Animations/Animator.hpp"
+#include "Animations/BakedAnimation.hpp"
 #include "Animations/Geometry/GeometryLoader.hpp"
 #include "Animations/Geometry/VertexAnimated.hpp"
 #include "Animations/Joint/Joint.hpp"
 #include "Animations/Joint/JointTransform.hpp"
 #include "Animations/Keyframe/Keyframe.hpp"
 #include "Animations/MeshAnimated.hpp"
+#include "Animations/MeshBaked.hpp"
 #include "Animations/Skeleton/SkeletonLoader.hpp"
 #include "Animations/Skin/SkinLoader.hpp"
 #include "Animations/Skin/VertexWeights.hpp"
 #include "Audio/Audio.hpp"
+#include "Audio/AudioEffects.hpp"
+#include "Audio/ReverbZone.hpp"
 #include "Audio/Sound.hpp"
+#include "Audio/SoundCache.hpp"
 #include "Audio/SoundBuffer.hpp"
+#include "Audio/SoundStream.hpp"
+#include "Audio/VoicePool.hpp"
+#include "Devices/InputEvent.hpp"
 #include "Devices/Instance.hpp"
 #include "Devices/Joysticks.hpp"
 #include "Devices/Keyboard.hpp"
@@ -30,14 +39,21 @@
 #include "Emitters/EmitterPoint.hpp"
 #include "Emitters/EmitterSphere.hpp"
 #include "Engine/Engine.hpp"
+#include "Engine/FrameAllocator.hpp"
 #include "Engine/Game.hpp"
 #include "Engine/Log.hpp"
+#include "Engine/MemoryTracker.hpp"
 #include "Engine/Module.hpp"
 #include "Engine/ModuleHolder.hpp"
+#include "Engine/Profiler.hpp"
+#include "Files/AsyncReader.hpp"
 #include "Files/File.hpp"
 #include "Files/Files.hpp"
 #include "Files/FileSystem.hpp"
+#include "Files/FileView.hpp"
 #include "Files/FileWatcher.hpp"
+#include "Files/Pack.hpp"
+#include "Fonts/FontAtlas.hpp"
 #include "Fonts/FontMetafile.hpp"
 #include "Fonts/FontType.hpp"
 #include "Fonts/Geometry.hpp"
@@ -51,11 +67,13 @@
 #include "Gizmos/SubrenderGizmos.hpp"
 #include "Guis/Gui.hpp"
 #include "Guis/SubrenderGuis.hpp"
+#include "Helpers/AtomicRingBuffer.hpp"
 #include "Helpers/ConstExpr.hpp"
 #include "Helpers/Delegate.hpp"
 #include "Helpers/EnumClass.hpp"
 #include "Helpers/Future.hpp"
 #include "Helpers/NonCopyable.hpp"
+#include "Helpers/RadixSort.hpp"
 #include "Helpers/Reference.hpp"
 #include "Helpers/RingBuffer.hpp"
 #include "Helpers/String.hpp"
@@ -74,6 +92,7 @@
 #include "Inputs/InputDelay.hpp"
 #include "Lights/Fog.hpp"
 #include "Lights/Light.hpp"
+#include "Lights/LightSelection.hpp"
 #include "Materials/Material.hpp"
 #include "Materials/MaterialDefault.hpp"
 #include "Materials/PipelineMaterial.hpp"
@@ -99,11 +118,18 @@
 #include "Maths/Visual/DriverLinear.hpp"
 #include "Maths/Visual/DriverSinwave.hpp"
 #include "Maths/Visual/DriverSlide.hpp"
+#include "Maths/Visual/Tweens.hpp"
+#include "Meshes/DepthPyramid.hpp"
+#include "Meshes/ImpostorType.hpp"
 #include "Meshes/Mesh.hpp"
 #include "Meshes/MeshRender.hpp"
+#include "Meshes/SubrenderDepth.hpp"
+#include "Meshes/SubrenderImpostors.hpp"
 #include "Meshes/SubrenderMeshes.hpp"
+#include "Models/Gltf/GltfFile.hpp"
 #include "Models/Gltf/ModelGltf.hpp"
 #include "Models/Model.hpp"
+#include "Models/ModelOptimizer.hpp"
 #include "Models/ModelRegister.hpp"
 #include "Models/Obj/ModelObj.hpp"
 #include "Models/Shapes/MeshPattern.hpp"
@@ -114,22 +140,34 @@
 #include "Models/Shapes/ModelRectangle.hpp"
 #include "Models/Shapes/ModelSphere.hpp"
 #include "Models/VertexDefault.hpp"
+#include "Models/VertexQuantized.hpp"
 #include "Network/Ftp/Ftp.hpp"
 #include "Network/Ftp/FtpDataChannel.hpp"
 #include "Network/Ftp/FtpResponse.hpp"
 #include "Network/Ftp/FtpResponseDirectory.hpp"
 #include "Network/Ftp/FtpResponseListing.hpp"
+#include "Network/Ftp/FtpTransferPool.hpp"
 #include "Network/Http/Http.hpp"
 #include "Network/Http/HttpRequest.hpp"
 #include "Network/Http/HttpResponse.hpp"
+#include "Network/HostResolver.hpp"
 #include "Network/IpAddress.hpp"
+#include "Network/Lz4.hpp"
 #include "Network/Packet.hpp"
+#include "Network/Replication/EntityState.hpp"
+#include "Network/Replication/Replicated.hpp"
+#include "Network/Replication/ReplicationClient.hpp"
+#include "Network/Replication/ReplicationServer.hpp"
 #include "Network/Socket.hpp"
+#include "Network/SocketPoller.hpp"
 #include "Network/SocketSelector.hpp"
 #include "Network/Tcp/TcpListener.hpp"
 #include "Network/Tcp/TcpSocket.hpp"
+#include "Network/Udp/UdpConnection.hpp"
 #include "Network/Udp/UdpSocket.hpp"
 #include "Particles/Particle.hpp"
+#include "Particles/ParticleList.hpp"
+#include "Particles/ParticlePool.hpp"
 #include "Particles/Particles.hpp"
 #include "Particles/ParticleSystem.hpp"
 #include "Particles/ParticleType.hpp"
@@ -142,14 +180,19 @@
 #include "Physics/Colliders/ColliderCylinder.hpp"
 #include "Physics/Colliders/ColliderHeightfield.hpp"
 #include "Physics/Colliders/ColliderSphere.hpp"
+#include "Physics/Colliders/ColliderShape.hpp"
+#include "Physics/Colliders/HullShape.hpp"
 #include "Physics/CollisionObject.hpp"
 #include "Physics/Force.hpp"
 #include "Physics/Frustum.hpp"
+#include "Physics/FrustumCuller.hpp"
 #include "Physics/KinematicCharacter.hpp"
 #include "Physics/Ray.hpp"
 #include "Physics/Rigidbody.hpp"
+#include "Plugins/Plugins.hpp"
 #include "Post/Deferred/SubrenderDeferred.hpp"
 #include "Post/Filters/FilterBlur.hpp"
+#include "Post/Filters/FilterChain.hpp"
 #include "Post/Filters/FilterCrt.hpp"
 #include "Post/Filters/FilterDarken.hpp"
 #include "Post/Filters/FilterDefault.hpp"
@@ -163,61 +206,99 @@
 #include "Post/Filters/FilterPixel.hpp"
 #include "Post/Filters/FilterSepia.hpp"
 #include "Post/Filters/FilterSsao.hpp"
+#include "Post/Filters/FilterTaa.hpp"
 #include "Post/Filters/FilterTiltshift.hpp"
 #include "Post/Filters/FilterTone.hpp"
+#include "Post/Filters/FilterUpscale.hpp"
 #include "Post/Filters/FilterVignette.hpp"
 #include "Post/Filters/FilterWobble.hpp"
+#include "Post/Pipelines/BlurPyramid.hpp"
 #include "Post/Pipelines/PipelineBlur.hpp"
+#include "Post/Pipelines/PipelineShadingRate.hpp"
 #include "Post/PostFilter.hpp"
 #include "Post/PostPipeline.hpp"
+#include "Graphics/Buffers/AccelerationStructure.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Buffers/GeometryHeap.hpp"
+#include "Graphics/Buffers/IndirectBuffer.hpp"
 #include "Graphics/Buffers/InstanceBuffer.hpp"
 #include "Graphics/Buffers/PushHandler.hpp"
 #include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/StorageHandler.hpp"
 #include "Graphics/Buffers/UniformBuffer.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Buffers/UniformRing.hpp"
 #include "Graphics/Commands/CommandBuffer.hpp"
 #include "Graphics/Commands/CommandPool.hpp"
+#include "Graphics/Commands/TimelineSemaphore.hpp"
+#include "Graphics/Commands/TimestampQueries.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
+#include "Graphics/Descriptors/BindlessDescriptors.hpp"
 #include "Graphics/Descriptors/Descriptor.hpp"
+#include "Graphics/Descriptors/DescriptorAllocator.hpp"
 #include "Graphics/Descriptors/DescriptorSet.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Images/Image.hpp"
 #include "Graphics/Images/Image2d.hpp"
 #include "Graphics/Images/ImageCube.hpp"
 #include "Graphics/Images/ImageDepth.hpp"
+#include "Graphics/Images/ImageKtx.hpp"
+#include "Graphics/Images/ImageReadback.hpp"
+#include "Graphics/Images/ImageStreamer.hpp"
+#include "Graphics/Images/MipmapGenerator.hpp"
+#include "Graphics/Images/SamplerCache.hpp"
+#include "Graphics/Images/VirtualTexture.hpp"
+#include "Graphics/Memory/MemoryAllocator.hpp"
 #include "Graphics/Pipelines/Pipeline.hpp"
 #include "Graphics/Pipelines/PipelineCompute.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 #include "Graphics/Pipelines/Shader.hpp"
+#include "Graphics/Pipelines/ShaderReloader.hpp"
+#include "Graphics/Pipelines/UniformId.hpp"
 #include "Graphics/Subrender.hpp"
+#include "Graphics/DynamicResolution.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Graphics/Renderer.hpp"
 #include "Graphics/SubrenderHolder.hpp"
 #include "Graphics/Renderpass/Framebuffers.hpp"
+#include "Graphics/Renderpass/RenderGraph.hpp"
 #include "Graphics/Renderpass/Renderpass.hpp"
 #include "Graphics/Renderpass/Swapchain.hpp"
 #include "Graphics/RenderStage.hpp"
 #include "Resources/Resource.hpp"
+#include "Resources/ResourceRequest.hpp"
 #include "Resources/Resources.hpp"
 #include "Scenes/Camera.hpp"
 #include "Scenes/Component.hpp"
 #include "Scenes/ComponentRegister.hpp"
 #include "Scenes/Entity.hpp"
+#include "Scenes/EntityHandle.hpp"
+#include "Scenes/EntityPicker.hpp"
 #include "Scenes/EntityPrefab.hpp"
 #include "Scenes/Scene.hpp"
 #include "Scenes/ScenePhysics.hpp"
 #include "Scenes/Scenes.hpp"
+#include "Scenes/SceneStreamer.hpp"
 #include "Scenes/SceneStructure.hpp"
+#include "Serialized/Binary/Binary.hpp"
 #include "Serialized/Json/Json.hpp"
 #include "Serialized/Metadata.hpp"
+#include "Serialized/MetadataArena.hpp"
+#include "Serialized/MetadataWriter.hpp"
 #include "Serialized/Xml/Xml.hpp"
 #include "Serialized/Yaml/Yaml.hpp"
 #include "Shadows/SubrenderShadows.hpp"
+#include "Shadows/ShadowAccelerationStructure.hpp"
+#include "Shadows/ShadowAtlas.hpp"
 #include "Shadows/ShadowBox.hpp"
 #include "Shadows/ShadowRender.hpp"
 #include "Shadows/Shadows.hpp"
 #include "Skyboxes/MaterialSkybox.hpp"
+#include "Terrains/Heightmap.hpp"
+#include "Terrains/SubrenderTerrains.hpp"
+#include "Terrains/Terrain.hpp"
+#include "Telemetry/Histogram.hpp"
+#include "Telemetry/Telemetry.hpp"
 #include "Uis/Inputs/UiColourWheel.hpp"
 #include "Uis/Inputs/UiInputBoolean.hpp"
 #include "Uis/Inputs/UiInputButton.hpp"
@@ -227,6 +308,8 @@
 #include "Uis/Inputs/UiInputSlider.hpp"
 #include "Uis/Inputs/UiInputText.hpp"
 #include "Uis/UiBound.hpp"
+#include "Uis/UiGrid.hpp"
+#include "Uis/UiList.hpp"
 #include "Uis/UiObject.hpp"
 #include "Uis/UiPanel.hpp"
 #include "Uis/Uis.hpp"
@@ -1,5 +1,7 @@
 #include "Animation.hpp"
 
+#include "Engine/Log.hpp"
+
 namespace acid
 {
 Animation::Animation(const Time &length, std::vector<Keyframe> keyframes) :
@@ -7,4 +9,23 @@ Animation::Animation(const Time &length, std::vector<Keyframe> keyframes) :
 	m_keyframes(std::move(keyframes))
 {
 }
+
+bool Animation::Compress(const float &positionError, const float &rotationError)
+{
+	if (m_compressed != nullptr)
+	{
+		return true;
+	}
+
+	if (m_keyframes.empty() || m_keyframes.size() > CompressedAnimation::MaxKeyframes)
+	{
+		Log::Warning("Animation with %i keyframes cannot be compressed\n", m_keyframes.size());
+		return false;
+	}
+
+	m_compressed = std::make_unique<CompressedAnimation>(m_keyframes, positionError, rotationError);
+	m_keyframes.clear();
+	m_keyframes.shrink_to_fit();
+	return true;
+}
 }
@@ -2,12 +2,14 @@
 
 #include "Maths/Time.hpp"
 #include "Animations/Keyframe/Keyframe.hpp"
+#include "CompressedAnimation.hpp"
 
 namespace acid
 {
 /**
  * @brief Class that represents an animation that can be carried out by an animated entity.
  * It contains the length of the animation in seconds, and a list of {@link Keyframe}s.
+ * Once compressed the keyframes are released and the animation is sampled from its {@link CompressedAnimation}.
  **/
 class ACID_EXPORT Animation
 {
@@ -31,8 +33,24 @@ public:
 	 **/
 	const std::vector<Keyframe> &GetKeyframes() const { return m_keyframes; }
 
+	/**
+	 * Compresses the keyframes into tracks per joint, then releases the keyframes.
+	 * Animations with more than {@link CompressedAnimation#MaxKeyframes} keyframes are left uncompressed.
+	 * @param positionError The largest distance a sampled position may be from the keyframes.
+	 * @param rotationError The largest angle in radians a sampled rotation may be from the keyframes.
+	 * @return If the animation was compressed.
+	 **/
+	bool Compress(const float &positionError = 0.001f, const float &rotationError = 0.001f);
+
+	/**
+	 * Gets the compressed tracks of the animation.
+	 * @return The compressed tracks, or nullptr if the animation has not been compressed.
+	 **/
+	const CompressedAnimation *GetCompressed() const { return m_compressed.get(); }
+
 private:
 	Time m_length;
 	std::vector<Keyframe> m_keyframes;
+	std::unique_ptr<CompressedAnimation> m_compressed;
 };
 }
@@ -0,0 +1,306 @@
+#include "CompressedAnimation.hpp"
+
+#include "Animations/Joint/JointTransform.hpp"
+
+namespace acid
+{
+// Keyframes a removed run of keys can span, so fitting a track stays linear in its keyframe count.
+static const uint32_t MaxSegmentFrames = 256;
+// The smallest three components of a unit quaternion are within one over root two.
+static const float Sqrt2 = 1.41421356f;
+
+CompressedAnimation::CompressedAnimation(const std::vector<Keyframe> &keyframes, const float &positionError, const float &rotationError)
+{
+	m_times.reserve(keyframes.size());
+
+	for (const auto &keyframe : keyframes)
+	{
+		m_times.emplace_back(keyframe.GetTimeStamp().AsSeconds());
+
+		for (const auto &[jointName, transform] : keyframe.GetPose())
+		{
+			if (std::find(m_jointNames.begin(), m_jointNames.end(), jointName) == m_jointNames.end())
+			{
+				m_jointNames.emplace_back(jointName);
+			}
+		}
+	}
+
+	std::vector<Vector3f> positions(keyframes.size());
+	std::vector<Quaternion> rotations(keyframes.size());
+	std::vector<QuantizedKey> quantized(keyframes.size());
+
+	for (const auto &jointName : m_jointNames)
+	{
+		// Keyframes missing the joint hold the transform of the keyframe before them, or the first keyframe that has it.
+		std::optional<JointTransform> last;
+
+		for (const auto &keyframe : keyframes)
+		{
+			if (auto it = keyframe.GetPose().find(jointName); it != keyframe.GetPose().end())
+			{
+				last = it->second;
+				break;
+			}
+		}
+
+		for (std::size_t i = 0; i < keyframes.size(); i++)
+		{
+			if (auto it = keyframes[i].GetPose().find(jointName); it != keyframes[i].GetPose().end())
+			{
+				last = it->second;
+			}
+
+			positions[i] = last->GetPosition();
+			rotations[i] = last->GetRotation().Normalize();
+		}
+
+		Track track;
+		track.m_positionMin = positions[0];
+		auto positionMax = positions[0];
+
+		for (const auto &position : positions)
+		{
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				track.m_positionMin[j] = std::min(track.m_positionMin[j], position[j]);
+				positionMax[j] = std::max(positionMax[j], position[j]);
+			}
+		}
+
+		track.m_positionExtent = positionMax - track.m_positionMin;
+
+		for (std::size_t i = 0; i < positions.size(); i++)
+		{
+			quantized[i] = QuantizePosition(positions[i], track.m_positionMin, track.m_positionExtent);
+		}
+
+		FitChannel(positions, quantized, positionError, [&track](const QuantizedKey &key)
+		{
+			return DecodePosition(key, track.m_positionMin, track.m_positionExtent);
+		}, [](const Vector3f &a, const Vector3f &b, const float &progression)
+		{
+			return JointTransform::Interpolate(a, b, progression);
+		}, [](const Vector3f &a, const Vector3f &b)
+		{
+			return a.Distance(b);
+		}, track.m_positions, m_positionKeys, m_positionKeyFrames);
+
+		for (std::size_t i = 0; i < rotations.size(); i++)
+		{
+			quantized[i] = QuantizeRotation(rotations[i]);
+		}
+
+		FitChannel(rotations, quantized, rotationError, &CompressedAnimation::DecodeRotation, [](const Quaternion &a, const Quaternion &b, const float &progression)
+		{
+			return a.Slerp(b, progression);
+		}, [](const Quaternion &a, const Quaternion &b)
+		{
+			// A quaternion and its negation are the same rotation, the angle is measured from the chord as acos loses precision near one.
+			auto sign = a.Dot(b) < 0.0f ? -1.0f : 1.0f;
+			auto difference = Quaternion(a.m_x - b.m_x * sign, a.m_y - b.m_y * sign, a.m_z - b.m_z * sign, a.m_w - b.m_w * sign).Length();
+			auto sum = Quaternion(a.m_x + b.m_x * sign, a.m_y + b.m_y * sign, a.m_z + b.m_z * sign, a.m_w + b.m_w * sign).Length();
+			return 4.0f * std::atan2(difference, sum);
+		}, track.m_rotations, m_rotationKeys, m_rotationKeyFrames);
+
+		m_tracks.emplace_back(track);
+	}
+}
+
+std::optional<uint32_t> CompressedAnimation::FindTrack(const std::string &jointName) const
+{
+	auto it = std::find(m_jointNames.begin(), m_jointNames.end(), jointName);
+
+	if (it == m_jointNames.end())
+	{
+		return std::nullopt;
+	}
+
+	return static_cast<uint32_t>(it - m_jointNames.begin());
+}
+
+void CompressedAnimation::Sample(const uint32_t &track, const Time &time, Vector3f &position, Quaternion &rotation) const
+{
+	const auto &samples = m_tracks[track];
+	auto seconds = time.AsSeconds();
+
+	auto [previousPosition, nextPosition, positionProgression] = FindKeys(samples.m_positions, m_positionKeyFrames, seconds);
+	position = JointTransform::Interpolate(DecodePosition(m_positionKeys[previousPosition], samples.m_positionMin, samples.m_positionExtent),
+		DecodePosition(m_positionKeys[nextPosition], samples.m_positionMin, samples.m_positionExtent), positionProgression);
+
+	auto [previousRotation, nextRotation, rotationProgression] = FindKeys(samples.m_rotations, m_rotationKeyFrames, seconds);
+	rotation = DecodeRotation(m_rotationKeys[previousRotation]).Slerp(DecodeRotation(m_rotationKeys[nextRotation]), rotationProgression);
+}
+
+std::size_t CompressedAnimation::GetSize() const
+{
+	return sizeof(float) * m_times.size() + sizeof(Track) * m_tracks.size() + (sizeof(QuantizedKey) + sizeof(uint16_t)) * GetKeyCount();
+}
+
+template<typename T, typename Decode, typename Interpolate, typename Measure>
+void CompressedAnimation::FitChannel(const std::vector<T> &values, const std::vector<QuantizedKey> &quantized, const float &error, const Decode &decode,
+	const Interpolate &interpolate, const Measure &measure, Channel &channel, std::vector<QuantizedKey> &keys, std::vector<uint16_t> &keyFrames) const
+{
+	auto frameCount = static_cast<uint32_t>(values.size());
+	channel.m_firstKey = static_cast<uint32_t>(keys.size());
+	channel.m_keyCount = 0;
+
+	auto addKey = [&](const uint32_t &frame)
+	{
+		keys.emplace_back(quantized[frame]);
+		keyFrames.emplace_back(static_cast<uint16_t>(frame));
+		channel.m_keyCount++;
+	};
+
+	// Tests if the keyframes between two keys are rebuilt within the error by interpolating the keys.
+	auto fits = [&](const uint32_t &start, const uint32_t &end)
+	{
+		auto startValue = decode(quantized[start]);
+		auto endValue = decode(quantized[end]);
+		auto totalTime = m_times[end] - m_times[start];
+
+		for (auto frame = start + 1; frame < end; frame++)
+		{
+			auto progression = totalTime > 0.0f ? (m_times[frame] - m_times[start]) / totalTime : 0.0f;
+
+			if (measure(interpolate(startValue, endValue, progression), values[frame]) > error)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	addKey(0);
+
+	if (frameCount == 1)
+	{
+		return;
+	}
+
+	// A channel that stays within the error of its first key keeps only that key.
+	auto constant = decode(quantized[0]);
+
+	if (std::all_of(values.begin(), values.end(), [&](const T &value) { return measure(constant, value) <= error; }))
+	{
+		return;
+	}
+
+	uint32_t start = 0;
+
+	while (start < frameCount - 1)
+	{
+		auto end = start + 1;
+
+		while (end + 1 < frameCount && end + 1 - start <= MaxSegmentFrames && fits(start, end + 1))
+		{
+			end++;
+		}
+
+		addKey(end);
+		start = end;
+	}
+}
+
+std::tuple<uint32_t, uint32_t, float> CompressedAnimation::FindKeys(const Channel &channel, const std::vector<uint16_t> &keyFrames, const float &time) const
+{
+	auto first = keyFrames.begin() + channel.m_firstKey;
+	auto last = first + channel.m_keyCount;
+
+	// The first key is the previous key until the time passes the second key.
+	auto next = std::upper_bound(first + 1, last, time, [this](const float &value, const uint16_t &frame)
+	{
+		return value < m_times[frame];
+	});
+
+	auto previousKey = static_cast<uint32_t>(next - keyFrames.begin()) - 1;
+	auto nextKey = next == last ? previousKey : previousKey + 1;
+
+	auto previousTime = m_times[keyFrames[previousKey]];
+	auto totalTime = m_times[keyFrames[nextKey]] - previousTime;
+	auto progression = totalTime > 0.0f ? std::clamp((time - previousTime) / totalTime, 0.0f, 1.0f) : 0.0f;
+	return { previousKey, nextKey, progression };
+}
+
+CompressedAnimation::QuantizedKey CompressedAnimation::QuantizeRotation(const Quaternion &rotation)
+{
+	// The largest component is dropped and rebuilt from the others.
+	uint32_t largest = 0;
+
+	for (uint32_t i = 1; i < 4; i++)
+	{
+		if (std::abs(rotation[i]) > std::abs(rotation[largest]))
+		{
+			largest = i;
+		}
+	}
+
+	// The dropped component is kept positive, negating a quaternion does not change its rotation.
+	auto sign = rotation[largest] < 0.0f ? -1.0f : 1.0f;
+	QuantizedKey key = {};
+
+	for (uint32_t i = 0, j = 0; i < 4; i++)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+
+		auto value = std::clamp(rotation[i] * sign * Sqrt2 * 0.5f + 0.5f, 0.0f, 1.0f);
+		key[j++] = static_cast<uint16_t>(std::round(value * 32767.0f));
+	}
+
+	// The index of the dropped component is kept in the top bits of the first two components.
+	key[0] |= static_cast<uint16_t>((largest & 1) << 15);
+	key[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+	return key;
+}
+
+Quaternion CompressedAnimation::DecodeRotation(const QuantizedKey &key)
+{
+	auto largest = static_cast<uint32_t>((key[0] >> 15) | ((key[1] >> 15) << 1));
+	Quaternion rotation;
+	float sum = 0.0f;
+
+	for (uint32_t i = 0, j = 0; i < 4; i++)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+
+		auto value = (static_cast<float>(key[j++] & 0x7fff) / 32767.0f - 0.5f) * 2.0f / Sqrt2;
+		rotation[i] = value;
+		sum += value * value;
+	}
+
+	rotation[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+	return rotation;
+}
+
+CompressedAnimation::QuantizedKey CompressedAnimation::QuantizePosition(const Vector3f &position, const Vector3f &min, const Vector3f &extent)
+{
+	QuantizedKey key = {};
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		auto value = extent[i] > 0.0f ? std::clamp((position[i] - min[i]) / extent[i], 0.0f, 1.0f) : 0.0f;
+		key[i] = static_cast<uint16_t>(std::round(value * 65535.0f));
+	}
+
+	return key;
+}
+
+Vector3f CompressedAnimation::DecodePosition(const QuantizedKey &key, const Vector3f &min, const Vector3f &extent)
+{
+	Vector3f position;
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		position[i] = min[i] + extent[i] * (static_cast<float>(key[i]) / 65535.0f);
+	}
+
+	return position;
+}
+}
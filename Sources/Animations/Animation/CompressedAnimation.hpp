@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Maths/Time.hpp"
+#include "Animations/Keyframe/Keyframe.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that represents the keyframes of an animation compressed into a track per joint, and samples them without decompressing.
+ * Keys that can be rebuilt by interpolating the keys around them within the error bounds are removed, so a track that never moves keeps a single key.
+ * Rotations are quantized to their smallest three components and positions to the bounds of their track, both into 16 bits per component.
+ **/
+class ACID_EXPORT CompressedAnimation
+{
+public:
+	/// The most keyframes a animation can have to be compressed, key frames are stored as 16 bit indices.
+	static constexpr std::size_t MaxKeyframes = 65536;
+
+	/**
+	 * Compresses the keyframes of an animation.
+	 * @param keyframes All the keyframes for the animation, ordered by time of appearance in the animation.
+	 * @param positionError The largest distance a sampled position may be from the original keyframes.
+	 * @param rotationError The largest angle in radians a sampled rotation may be from the original keyframes.
+	 **/
+	CompressedAnimation(const std::vector<Keyframe> &keyframes, const float &positionError, const float &rotationError);
+
+	/**
+	 * Finds the track animating a joint.
+	 * @param jointName The name of the joint.
+	 * @return The index of the track, or nullopt if the animation does not move the joint.
+	 **/
+	std::optional<uint32_t> FindTrack(const std::string &jointName) const;
+
+	/**
+	 * Samples the transform of a track, interpolating between the keys around the time.
+	 * @param track The index of the track.
+	 * @param time The time into the animation.
+	 * @param position The sampled local-space position.
+	 * @param rotation The sampled local-space rotation.
+	 **/
+	void Sample(const uint32_t &track, const Time &time, Vector3f &position, Quaternion &rotation) const;
+
+	const std::vector<std::string> &GetJointNames() const { return m_jointNames; }
+
+	/**
+	 * Gets the number of keys kept across every track.
+	 * @return The number of kept keys.
+	 **/
+	std::size_t GetKeyCount() const { return m_positionKeys.size() + m_rotationKeys.size(); }
+
+	/**
+	 * Gets the size of the compressed keys and tracks in bytes.
+	 * @return The compressed size.
+	 **/
+	std::size_t GetSize() const;
+
+private:
+	using QuantizedKey = std::array<uint16_t, 3>;
+
+	/**
+	 * @brief The keys of one channel of a joint, the keys are stored in order from the first key.
+	 **/
+	class Channel
+	{
+	public:
+		uint32_t m_firstKey = 0;
+		uint32_t m_keyCount = 0;
+	};
+
+	class Track
+	{
+	public:
+		Channel m_positions;
+		Channel m_rotations;
+		/// The positions of the track are quantized between the minimum and the minimum plus the extent.
+		Vector3f m_positionMin;
+		Vector3f m_positionExtent;
+	};
+
+	/**
+	 * Removes the keys of a channel that interpolating the kept keys rebuilds within the error bound.
+	 * The keys are quantized before fitting, so the error bound includes the quantization error.
+	 * @tparam T The value type of the channel.
+	 * @param values The original value at each keyframe.
+	 * @param quantized The quantized value at each keyframe.
+	 * @param error The largest error allowed, returned by the error function.
+	 * @param decode Rebuilds a value from a quantized key.
+	 * @param interpolate Interpolates between two values.
+	 * @param measure Measures the error between two values.
+	 * @param channel The channel to write the kept keys into.
+	 * @param keys The keys of every channel.
+	 * @param keyFrames The keyframe of each key of every channel.
+	 **/
+	template<typename T, typename Decode, typename Interpolate, typename Measure>
+	void FitChannel(const std::vector<T> &values, const std::vector<QuantizedKey> &quantized, const float &error, const Decode &decode,
+		const Interpolate &interpolate, const Measure &measure, Channel &channel, std::vector<QuantizedKey> &keys, std::vector<uint16_t> &keyFrames) const;
+
+	/**
+	 * Finds the keys of a channel around a time.
+	 * @param channel The channel.
+	 * @param keyFrames The keyframe of each key.
+	 * @param time The time in seconds.
+	 * @return The indices of the previous and next keys, and how far between them the time is.
+	 **/
+	std::tuple<uint32_t, uint32_t, float> FindKeys(const Channel &channel, const std::vector<uint16_t> &keyFrames, const float &time) const;
+
+	static QuantizedKey QuantizeRotation(const Quaternion &rotation);
+	static Quaternion DecodeRotation(const QuantizedKey &key);
+
+	static QuantizedKey QuantizePosition(const Vector3f &position, const Vector3f &min, const Vector3f &extent);
+	static Vector3f DecodePosition(const QuantizedKey &key, const Vector3f &min, const Vector3f &extent);
+
+	std::vector<float> m_times;
+	std::vector<std::string> m_jointNames;
+	std::vector<Track> m_tracks;
+
+	std::vector<QuantizedKey> m_positionKeys;
+	std::vector<uint16_t> m_positionKeyFrames;
+	std::vector<QuantizedKey> m_rotationKeys;
+	std::vector<uint16_t> m_rotationKeyFrames;
+};
+}
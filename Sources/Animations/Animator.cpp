@@ -5,101 +5,400 @@
 namespace acid
 {
 Animator::Animator(Joint *rootJoint) :
-	m_rootJoint(rootJoint),
-	m_animationTime(Time::Zero),
-	m_currentAnimation(nullptr)
+	m_rootJoint(rootJoint)
 {
+	AddJoints(m_rootJoint, -1);
+	m_bindPose.Resize(m_joints.size());
+
+	for (std::size_t i = 0; i < m_joints.size(); i++)
+	{
+		auto transform = JointTransform(m_joints[i].m_joint->GetLocalBindTransform());
+		m_bindPose.m_positions[i] = transform.GetPosition();
+		m_bindPose.m_rotations[i] = transform.GetRotation();
+	}
+
+	for (auto &pose : m_poses)
+	{
+		pose.Resize(m_joints.size());
+	}
+
+	m_poseTransforms.resize(m_joints.size());
+}
+
+void Animator::Update(std::vector<Matrix4> &jointMatrices)
+{
+	Update(Engine::Get()->GetDelta(), jointMatrices);
 }
 
-void Animator::Update()
+void Animator::Update(const Time &delta, std::vector<Matrix4> &jointMatrices)
 {
-	if (m_currentAnimation == nullptr)
+	if (m_layers.empty())
 	{
 		return;
 	}
 
-	IncreaseAnimationTime();
-	auto currentPose = CalculateCurrentAnimationPose();
-	ApplyPoseToJoints(currentPose, *m_rootJoint, Matrix4::Identity);
+	auto &pose = m_poses[0];
+	auto &layerPose = m_poses[1];
+	std::copy(m_bindPose.m_positions.begin(), m_bindPose.m_positions.end(), pose.m_positions.begin());
+	std::copy(m_bindPose.m_rotations.begin(), m_bindPose.m_rotations.end(), pose.m_rotations.begin());
+
+	for (auto &layer : m_layers)
+	{
+		layer.m_current.IncreaseTime(delta);
+		layer.m_previous.IncreaseTime(delta);
+		layer.m_fadeElapsed += delta;
+
+		if (layer.m_current.m_animation == nullptr && (layer.m_previous.m_animation == nullptr || layer.m_fadeElapsed >= layer.m_fadeTime))
+		{
+			continue;
+		}
+
+		EvaluateLayer(layer, layerPose);
+		BlendLayer(layer, layerPose, pose);
+	}
+
+	ApplyPose(pose, jointMatrices);
 }
 
-void Animator::IncreaseAnimationTime()
+const Animation *Animator::GetCurrentAnimation(const uint32_t &layer) const
 {
-	m_animationTime += Engine::Get()->GetDelta();
+	return layer < m_layers.size() ? m_layers[layer].m_current.m_animation : nullptr;
+}
+
+Time Animator::GetAnimationTime(const uint32_t &layer) const
+{
+	return layer < m_layers.size() ? m_layers[layer].m_current.m_time : Time::Zero;
+}
+
+void Animator::SetAnimationTime(const Time &animationTime, const uint32_t &layer)
+{
+	GetLayer(layer).m_current.m_time = animationTime;
+}
+
+void Animator::DoAnimation(Animation *animation, const Time &fadeTime, const uint32_t &layer)
+{
+	auto &target = GetLayer(layer);
+
+	// The previous clips tracks are swapped out rather than freed, so their storage is reused by the next crossfade.
+	std::swap(target.m_previous, target.m_current);
+	target.m_fadeTime = fadeTime;
+	target.m_fadeElapsed = Time::Zero;
+	ResolveClip(target.m_current, animation);
+
+	if (fadeTime <= Time::Zero || target.m_previous.m_animation == nullptr)
+	{
+		target.m_previous.m_animation = nullptr;
+	}
+}
+
+void Animator::SetLayer(const uint32_t &layer, const BlendMode &blendMode, const float &weight, std::vector<float> mask)
+{
+	auto &target = GetLayer(layer);
+	target.m_blendMode = blendMode;
+	target.m_weight = weight;
+	target.m_mask.clear();
+
+	if (mask.empty())
+	{
+		return;
+	}
+
+	// Stored in flattened joint order, joints past the end of the mask are left out of the layer.
+	target.m_mask.resize(m_joints.size());
 
-	if (m_animationTime > m_currentAnimation->GetLength())
+	for (std::size_t i = 0; i < m_joints.size(); i++)
 	{
-		m_animationTime = m_animationTime % m_currentAnimation->GetLength();
+		auto index = m_joints[i].m_joint->GetIndex();
+		target.m_mask[i] = index < mask.size() ? mask[index] : 0.0f;
 	}
 }
 
-std::map<std::string, Matrix4> Animator::CalculateCurrentAnimationPose()
+void Animator::SetLayerWeight(const uint32_t &layer, const float &weight)
 {
-	auto frames = GetPreviousAndNextFrames();
-	float progression = CalculateProgression(frames[0], frames[1]);
-	return InterpolatePoses(frames[0], frames[1], progression);
+	GetLayer(layer).m_weight = weight;
 }
 
-std::array<Keyframe, 2> Animator::GetPreviousAndNextFrames() const
+void Animator::Pose::Resize(const std::size_t &jointCount)
 {
-	auto allFrames = m_currentAnimation->GetKeyframes();
-	Keyframe previousFrame = allFrames[0];
-	Keyframe nextFrame = allFrames[0];
+	m_positions.resize(jointCount);
+	m_rotations.resize(jointCount);
+}
+
+void Animator::Clip::IncreaseTime(const Time &delta)
+{
+	if (m_animation == nullptr)
+	{
+		return;
+	}
 
-	for (uint32_t i = 1; i < allFrames.size(); i++)
+	m_time += delta;
+
+	if (m_time > m_animation->GetLength())
 	{
-		nextFrame = allFrames[i];
+		m_time = m_time % m_animation->GetLength();
+	}
+}
+
+std::array<uint32_t, 2> Animator::Clip::GetPreviousAndNextFrames()
+{
+	// Frames skipped by the cursor in one update before it gives up and searches, a large delta or a fast animation may skip many.
+	static const uint32_t MaxCursorSteps = 4;
 
-		if (nextFrame.GetTimeStamp() > m_animationTime)
+	const auto &allFrames = m_animation->GetKeyframes();
+	auto lastFrame = static_cast<uint32_t>(allFrames.size() - 1);
+	auto found = m_frameCursor <= lastFrame && (m_frameCursor == 0 || allFrames[m_frameCursor].GetTimeStamp() <= m_time);
+
+	for (uint32_t step = 0; found && m_frameCursor < lastFrame && allFrames[m_frameCursor + 1].GetTimeStamp() <= m_time; step++)
+	{
+		if (step == MaxCursorSteps)
 		{
+			found = false;
 			break;
 		}
 
-		previousFrame = allFrames[i];
+		m_frameCursor++;
+	}
+
+	if (!found)
+	{
+		// The first frame is the previous frame until the animation passes the second frame.
+		auto next = std::upper_bound(allFrames.begin() + 1, allFrames.end(), m_time, [](const Time &time, const Keyframe &keyframe)
+		{
+			return time < keyframe.GetTimeStamp();
+		});
+		m_frameCursor = static_cast<uint32_t>(next - allFrames.begin()) - 1;
 	}
 
-	return { previousFrame, nextFrame };
+	return { m_frameCursor, std::min(m_frameCursor + 1, lastFrame) };
 }
 
-float Animator::CalculateProgression(const Keyframe &previousFrame, const Keyframe &nextFrame) const
+float Animator::Clip::CalculateProgression(const Keyframe &previousFrame, const Keyframe &nextFrame) const
 {
 	Time totalTime = nextFrame.GetTimeStamp() - previousFrame.GetTimeStamp();
-	Time currentTime = m_animationTime - previousFrame.GetTimeStamp();
+
+	if (totalTime == Time::Zero)
+	{
+		return 0.0f;
+	}
+
+	Time currentTime = m_time - previousFrame.GetTimeStamp();
 	return currentTime / totalTime;
 }
 
-std::map<std::string, Matrix4> Animator::InterpolatePoses(const Keyframe &previousFrame, const Keyframe &nextFrame, const float &progression) const
+void Animator::Clip::Sample(const std::size_t &jointCount, const bool &additive, Pose &pose)
+{
+	if (auto compressed = m_animation->GetCompressed())
+	{
+		for (std::size_t i = 0; i < jointCount; i++)
+		{
+			if (m_tracks[i] != -1)
+			{
+				compressed->Sample(static_cast<uint32_t>(m_tracks[i]), m_time, pose.m_positions[i], pose.m_rotations[i]);
+			}
+			else
+			{
+				pose.m_positions[i] = m_trackPositions[i];
+				pose.m_rotations[i] = m_trackRotations[i];
+			}
+		}
+	}
+	else
+	{
+		auto frames = GetPreviousAndNextFrames();
+		const auto &keyframes = m_animation->GetKeyframes();
+		float progression = CalculateProgression(keyframes[frames[0]], keyframes[frames[1]]);
+
+		auto previousPositions = &m_trackPositions[frames[0] * jointCount];
+		auto nextPositions = &m_trackPositions[frames[1] * jointCount];
+		Quaternion::Slerp(&m_trackRotations[frames[0] * jointCount], &m_trackRotations[frames[1] * jointCount], progression, pose.m_rotations.data(), jointCount);
+
+		for (std::size_t i = 0; i < jointCount; i++)
+		{
+			pose.m_positions[i] = JointTransform::Interpolate(previousPositions[i], nextPositions[i], progression);
+		}
+	}
+
+	if (additive)
+	{
+		// Additive clips are stored as full poses, their first keyframe is the reference the difference is taken from.
+		for (std::size_t i = 0; i < jointCount; i++)
+		{
+			const auto &reference = m_trackRotations[i];
+			pose.m_positions[i] -= m_trackPositions[i];
+			pose.m_rotations[i] = Quaternion(-reference.m_x, -reference.m_y, -reference.m_z, reference.m_w) * pose.m_rotations[i];
+		}
+	}
+}
+
+void Animator::AddJoints(Joint *joint, const int32_t &parent)
+{
+	auto index = static_cast<int32_t>(m_joints.size());
+	m_joints.emplace_back(JointNode{joint, parent});
+
+	for (const auto &child : joint->GetChildren())
+	{
+		AddJoints(child.get(), index);
+	}
+}
+
+void Animator::ResolveClip(Clip &clip, Animation *animation) const
 {
-	auto currentPose = std::map<std::string, Matrix4>();
+	clip.m_animation = animation;
+	clip.m_time = Time::Zero;
+	clip.m_frameCursor = 0;
+	clip.m_trackPositions.clear();
+	clip.m_trackRotations.clear();
+	clip.m_tracks.clear();
+
+	if (auto compressed = animation != nullptr ? animation->GetCompressed() : nullptr)
+	{
+		clip.m_trackPositions.reserve(m_joints.size());
+		clip.m_trackRotations.reserve(m_joints.size());
+		clip.m_tracks.reserve(m_joints.size());
+
+		for (const auto &node : m_joints)
+		{
+			auto track = compressed->FindTrack(node.m_joint->GetName());
+			auto transform = JointTransform(node.m_joint->GetLocalBindTransform());
+			auto position = transform.GetPosition();
+			auto rotation = transform.GetRotation();
+
+			if (track)
+			{
+				compressed->Sample(*track, Time::Zero, position, rotation);
+			}
+
+			clip.m_trackPositions.emplace_back(position);
+			clip.m_trackRotations.emplace_back(rotation);
+			clip.m_tracks.emplace_back(track ? static_cast<int32_t>(*track) : -1);
+		}
+
+		return;
+	}
+
+	if (animation == nullptr || animation->GetKeyframes().empty())
+	{
+		clip.m_animation = nullptr;
+		return;
+	}
+
+	clip.m_trackPositions.reserve(animation->GetKeyframes().size() * m_joints.size());
+	clip.m_trackRotations.reserve(animation->GetKeyframes().size() * m_joints.size());
 
-	for (const auto &[name, joint] : previousFrame.GetPose())
+	for (const auto &keyframe : animation->GetKeyframes())
 	{
-		JointTransform previousTransform = previousFrame.GetPose().find(name)->second;
-		JointTransform nextTransform = nextFrame.GetPose().find(name)->second;
-		JointTransform currentTransform = JointTransform::Interpolate(previousTransform, nextTransform, progression);
-		currentPose.emplace(name, currentTransform.GetLocalTransform());
+		for (const auto &node : m_joints)
+		{
+			auto it = keyframe.GetPose().find(node.m_joint->GetName());
+
+			// Joints the animation does not move keep their bind pose.
+			auto transform = it != keyframe.GetPose().end() ? it->second : JointTransform(node.m_joint->GetLocalBindTransform());
+			clip.m_trackPositions.emplace_back(transform.GetPosition());
+			clip.m_trackRotations.emplace_back(transform.GetRotation());
+		}
 	}
+}
 
-	return currentPose;
+Animator::Layer &Animator::GetLayer(const uint32_t &layer)
+{
+	if (layer >= m_layers.size())
+	{
+		m_layers.resize(layer + 1);
+	}
+
+	return m_layers[layer];
 }
 
-void Animator::ApplyPoseToJoints(const std::map<std::string, Matrix4> &currentPose, Joint &joint, const Matrix4 &parentTransform)
+void Animator::EvaluateLayer(Layer &layer, Pose &pose)
 {
-	Matrix4 currentLocalTransform = currentPose.find(joint.GetName())->second;
-	Matrix4 currentTransform = parentTransform * currentLocalTransform;
+	auto jointCount = m_joints.size();
+	auto additive = layer.m_blendMode == BlendMode::Additive && &layer != &m_layers[0];
+	auto fading = layer.m_previous.m_animation != nullptr && layer.m_fadeElapsed < layer.m_fadeTime;
+
+	if (layer.m_current.m_animation != nullptr)
+	{
+		layer.m_current.Sample(jointCount, additive, pose);
+	}
+	else
+	{
+		// Fading out to nothing, the target is the bind pose or no difference at all.
+		for (std::size_t i = 0; i < jointCount; i++)
+		{
+			pose.m_positions[i] = additive ? Vector3f::Zero : m_bindPose.m_positions[i];
+			pose.m_rotations[i] = additive ? Quaternion() : m_bindPose.m_rotations[i];
+		}
+	}
+
+	if (!fading)
+	{
+		layer.m_previous.m_animation = nullptr;
+		return;
+	}
+
+	auto &fadePose = m_poses[2];
+	layer.m_previous.Sample(jointCount, additive, fadePose);
+	auto progression = layer.m_fadeElapsed / layer.m_fadeTime;
+
+	Quaternion::Slerp(fadePose.m_rotations.data(), pose.m_rotations.data(), progression, pose.m_rotations.data(), jointCount);
 
-	for (const auto &childJoint : joint.GetChildren())
+	for (std::size_t i = 0; i < jointCount; i++)
 	{
-		ApplyPoseToJoints(currentPose, *childJoint, currentTransform);
+		pose.m_positions[i] = JointTransform::Interpolate(fadePose.m_positions[i], pose.m_positions[i], progression);
 	}
+}
+
+void Animator::BlendLayer(const Layer &layer, const Pose &layerPose, Pose &pose) const
+{
+	auto jointCount = m_joints.size();
+	auto additive = layer.m_blendMode == BlendMode::Additive && &layer != &m_layers[0];
+
+	for (std::size_t i = 0; i < jointCount; i++)
+	{
+		auto weight = layer.m_mask.empty() ? layer.m_weight : layer.m_weight * layer.m_mask[i];
+
+		if (weight <= 0.0f)
+		{
+			continue;
+		}
 
-	currentTransform = currentTransform * joint.GetInverseBindTransform();
-	joint.SetAnimatedTransform(currentTransform);
+		if (additive)
+		{
+			pose.m_positions[i] += layerPose.m_positions[i] * weight;
+			pose.m_rotations[i] = pose.m_rotations[i] * (weight >= 1.0f ? layerPose.m_rotations[i] : Quaternion().Slerp(layerPose.m_rotations[i], weight));
+		}
+		else if (weight >= 1.0f)
+		{
+			pose.m_positions[i] = layerPose.m_positions[i];
+			pose.m_rotations[i] = layerPose.m_rotations[i];
+		}
+		else
+		{
+			pose.m_positions[i] = JointTransform::Interpolate(pose.m_positions[i], layerPose.m_positions[i], weight);
+			pose.m_rotations[i] = pose.m_rotations[i].Slerp(layerPose.m_rotations[i], weight);
+		}
+	}
 }
 
-void Animator::DoAnimation(Animation *animation)
+void Animator::ApplyPose(const Pose &pose, std::vector<Matrix4> &jointMatrices)
 {
-	m_animationTime = Time::Zero;
-	m_currentAnimation = animation;
+	// Parents come before their children, so their model-space transform is already known.
+	for (std::size_t i = 0; i < m_joints.size(); i++)
+	{
+		const auto &node = m_joints[i];
+		m_poseTransforms[i] = JointTransform(pose.m_positions[i], pose.m_rotations[i]).GetLocalTransform();
+
+		if (node.m_parent != -1)
+		{
+			m_poseTransforms[i] = m_poseTransforms[node.m_parent] * m_poseTransforms[i];
+		}
+
+		auto animatedTransform = m_poseTransforms[i] * node.m_joint->GetInverseBindTransform();
+		node.m_joint->SetAnimatedTransform(animatedTransform);
+
+		if (node.m_joint->GetIndex() < jointMatrices.size())
+		{
+			jointMatrices[node.m_joint->GetIndex()] = animatedTransform;
+		}
+	}
 }
 }
@@ -13,14 +13,23 @@ namespace acid
  * along with a reference to the currently playing animation for the corresponding entity.
  *
  * An Animator instance needs to be updated every frame, in order for it to keep updating the animation pose of the associated entity.
- * The currently playing animation can be changed at any time using {@link Animator#DoAnimation}.
+ * The currently playing animation can be changed at any time using {@link Animator#DoAnimation}, optionally crossfading from the last animation.
  * The Animator will keep looping the current animation until a new animation is chosen.
  * The Animator calculates the desired current animation pose by interpolating between the previous and next keyframes of the animation
  * (based on the current animation time). The Animator then updates the transforms all of the joints each frame to match the current desired animation pose.
+ *
+ * Animations play on layers, evaluated in order from layer zero. Each layer above the base layer either overrides the pose below it, or adds its
+ * difference from its first keyframe onto it, weighted by the layer weight and a optional per joint mask.
+ * Poses are evaluated into buffers owned by the animator, so updates do not allocate once every layer has played.
  **/
 class ACID_EXPORT Animator
 {
 public:
+	enum class BlendMode
+	{
+		Override, Additive
+	};
+
 	/**
 	 * Creates a new animator.
 	 * @param rootJoint The root joint of the joint hierarchy which makes up the "skeleton" of the entity.
@@ -28,102 +37,194 @@ public:
 	explicit Animator(Joint *rootJoint);
 
 	/**
-	 * This method should be called each frame to update the animation currently being played. This increases the animation time (and loops it back to zero if necessary),
+	 * This method should be called each frame to update the animations currently being played. This increases the animation times (and loops them back to zero if necessary),
 	 * finds the pose that the entity should be in at that time of the animation, and then applied that pose to all the entity's joints.
+	 * This only touches the animator and its joints, so animators can be updated in parallel.
+	 * @param jointMatrices The joint matrices uploaded to the vertex shader, indexed by {@link Joint#GetIndex}. Joints with a index past the end are not written.
 	 **/
-	void Update();
+	void Update(std::vector<Matrix4> &jointMatrices);
 
 	/**
-	 * Increases the current animation time which allows the animation to progress. If the current animation has reached the end then the timer is reset, causing the animation to loop.
+	 * Updates the animations by a given time instead of the frame delta, such as to sample a animation at fixed steps when baking it.
+	 * @param delta The time to increase the animations by.
+	 * @param jointMatrices The joint matrices to write into, indexed by {@link Joint#GetIndex}.
 	 **/
-	void IncreaseAnimationTime();
+	void Update(const Time &delta, std::vector<Matrix4> &jointMatrices);
 
 	/**
-	 * This method returns the current animation pose of the entity. It returns
-	 * the desired local-space transforms for all the joints in a map, indexed
-	 * by the name of the joint that they correspond to.
-	 *
-	 * The pose is calculated based on the previous and next keyframes in the
-	 * current animation. Each keyframe provides the desired pose at a certain
-	 * time in the animation, so the animated pose for the current time can be
-	 * calculated by interpolating between the previous and next keyframe.
-	 *
-	 * This method first finds the previous and next keyframe, calculates how far
-	 * between the two the current animation is, and then calculated the pose
-	 * for the current animation time by interpolating between the transforms at
-	 * those keyframes.
-	 *
-	 * @return The current pose as a map of the desired local-space transforms for all the joints.
-	 * The transforms are indexed by the name ID of the joint that they should be applied to. </returns>
+	 * Gets the animation playing on a layer.
+	 * @param layer The layer.
+	 * @return The animation, or nullptr if the layer is not playing.
 	 **/
-	std::map<std::string, Matrix4> CalculateCurrentAnimationPose();
+	const Animation *GetCurrentAnimation(const uint32_t &layer = 0) const;
 
 	/**
-	 * Finds the previous keyframe in the animation and the next keyframe in the animation, and returns them in an array of length 2.
-	 * If there is no  previous frame (perhaps current animation time is 0.5 and the first keyframe is at time 1.5)
-	 * then the next keyframe is used as both the previous and next keyframe. The reverse happens if there is no next keyframe.
-	 * @return The previous and next keyframes, in an array which therefore will always have a length of 2.
+	 * Gets the time into the animation playing on a layer.
+	 * @param layer The layer.
+	 * @return The animation time.
 	 **/
-	std::array<Keyframe, 2> GetPreviousAndNextFrames() const;
+	Time GetAnimationTime(const uint32_t &layer = 0) const;
 
 	/**
-	 * Calculates how far between the previous and next keyframe the current animation time is, and returns it as a value between 0 and 1.
-	 * @param previousFrame The previous keyframe in the animation.
-	 * @param nextFrame The next keyframe in the animation.
-	 * </param>
-	 * @return A number between 0 and 1 indicating how far between the two keyframes the current animation time is.
+	 * Seeks the animation playing on a layer to a time.
+	 * @param animationTime The new animation time, this should be within the length of the animation.
+	 * @param layer The layer.
 	 **/
-	float CalculateProgression(const Keyframe &previousFrame, const Keyframe &nextFrame) const;
+	void SetAnimationTime(const Time &animationTime, const uint32_t &layer = 0);
 
 	/**
-	 * Calculates all the local-space joint transforms for the desired current pose by interpolating between
-	 * the transforms at the previous and next keyframes.
-	 * @param previousFrame The previous keyframe in the animation.
-	 * @param nextFrame The next keyframe in the animation.
-	 * @param progression A number between 0 and 1 indicating how far between the previous and next keyframes the current animation time is.
-	 * </param>
-	 * @return The local-space transforms for all the joints for the desired current pose.
-	 * They are returned in a map, indexed by the name of the joint to which they should be applied. </returns>
+	 * Indicates that the entity should carry out the given animation. Resets the animation time so that the new animation starts from the beginning.
+	 * The keyframes of the animation are resolved into joint order here, so updates never look a joint up by name.
+	 * @param animation The new animation to carry out, or nullptr to stop the layer.
+	 * @param fadeTime The time to crossfade from the last animation of the layer, zero switches at once.
+	 * @param layer The layer to play the animation on.
 	 **/
-	std::map<std::string, Matrix4> InterpolatePoses(const Keyframe &previousFrame, const Keyframe &nextFrame, const float &progression) const;
+	void DoAnimation(Animation *animation, const Time &fadeTime = Time::Zero, const uint32_t &layer = 0);
 
 	/**
-	 * This method applies the current pose to a given joint, and all of its descendants.
-	 * It does this by getting the desired local-transform for the
-	 * current joint, before applying it to the joint. Before applying the
-	 * transformations it needs to be converted from local-space to model-space
-	 * (so that they are relative to the model's origin, rather than relative to
-	 * the parent joint). This can be done by multiplying the local-transform of
-	 * the joint with the model-space transform of the parent joint.
-	 *
-	 * The same thing is then done to all the child joints.
-	 *
-	 * Finally the inverse of the joint's bind transform is multiplied with the
-	 * model-space transform of the joint. This basically "subtracts" the
-	 * joint's original bind (no animation applied) transform from the desired
-	 * pose transform. The result of this is then the transform required to move
-	 * the joint from its original model-space transform to it's desired
-	 * model-space posed transform. This is the transform that needs to be
-	 * loaded up to the vertex shader and used to transform the vertices into
-	 * the current pose.
-	 * @param currentPose A map of the local-space transforms for all the joints for the desired pose. The map is indexed by the name of the joint which the transform corresponds to.
-	 * @param joint The current joint which the pose should be applied to.
-	 * @param parentTransform The desired model-space transform of the parent joint for the pose.
+	 * Sets how a layer is blended onto the layers below it, the base layer always overrides the bind pose.
+	 * @param layer The layer.
+	 * @param blendMode If the layer overrides or adds onto the pose below it.
+	 * @param weight The weight of the layer, between 0 and 1.
+	 * @param mask A weight between 0 and 1 for each joint, indexed by {@link Joint#GetIndex}. Empty applies the layer to every joint.
 	 **/
-	static void ApplyPoseToJoints(const std::map<std::string, Matrix4> &currentPose, Joint &joint, const Matrix4 &parentTransform);
-
-	const Animation *GetCurrentAnimation() const { return m_currentAnimation; }
+	void SetLayer(const uint32_t &layer, const BlendMode &blendMode, const float &weight, std::vector<float> mask = {});
 
 	/**
-	 * Indicates that the entity should carry out the given animation. Resets the animation time so that the new animation starts from the beginning.
-	 * @param animation The new animation to carry out.
+	 * Sets the weight of a layer, this can be changed every frame to fade a layer in and out.
+	 * @param layer The layer.
+	 * @param weight The weight of the layer, between 0 and 1.
 	 **/
-	void DoAnimation(Animation *animation);
+	void SetLayerWeight(const uint32_t &layer, const float &weight);
 
 private:
+	class JointNode
+	{
+	public:
+		Joint *m_joint;
+		int32_t m_parent;
+	};
+
+	/**
+	 * @brief The local-space transforms of every joint, in flattened joint order.
+	 **/
+	class Pose
+	{
+	public:
+		void Resize(const std::size_t &jointCount);
+
+		std::vector<Vector3f> m_positions;
+		std::vector<Quaternion> m_rotations;
+	};
+
+	/**
+	 * @brief A animation being played, with its keyframes resolved into flattened joint order.
+	 **/
+	class Clip
+	{
+	public:
+		/**
+		 * Increases the clip time, looping it back to zero at the end of the animation.
+		 * @param delta The time to increase by.
+		 **/
+		void IncreaseTime(const Time &delta);
+
+		/**
+		 * Finds the previous and next keyframe for the clip time.
+		 * The previous keyframe is cached, and is advanced from the last update while time moves forward. Loops and seeks fall back to a binary search.
+		 * If there is no previous frame then the next keyframe is used as both the previous and next keyframe. The reverse happens if there is no next keyframe.
+		 * @return The indices of the previous and next keyframes.
+		 **/
+		std::array<uint32_t, 2> GetPreviousAndNextFrames();
+
+		/**
+		 * Calculates how far between the previous and next keyframe the clip time is.
+		 * @param previousFrame The previous keyframe in the animation.
+		 * @param nextFrame The next keyframe in the animation.
+		 * @return A number between 0 and 1 indicating how far between the two keyframes the clip time is.
+		 **/
+		float CalculateProgression(const Keyframe &previousFrame, const Keyframe &nextFrame) const;
+
+		/**
+		 * Interpolates the pose at the clip time.
+		 * @param jointCount The number of flattened joints.
+		 * @param additive If the difference from the first keyframe is written instead of the pose.
+		 * @param pose The pose to write into.
+		 **/
+		void Sample(const std::size_t &jointCount, const bool &additive, Pose &pose);
+
+		Animation *m_animation = nullptr;
+		Time m_time;
+		uint32_t m_frameCursor = 0;
+
+		// The keyframe transforms in joint order, one row of joint count transforms per keyframe.
+		// Compressed animations keep only the first row, the transform of joints without a track and the additive reference.
+		std::vector<Vector3f> m_trackPositions;
+		std::vector<Quaternion> m_trackRotations;
+		// The compressed track of each joint, -1 for joints the animation does not move.
+		std::vector<int32_t> m_tracks;
+	};
+
+	class Layer
+	{
+	public:
+		Clip m_current;
+		Clip m_previous;
+		Time m_fadeTime;
+		Time m_fadeElapsed;
+
+		BlendMode m_blendMode = BlendMode::Override;
+		float m_weight = 1.0f;
+		std::vector<float> m_mask;
+	};
+
+	/**
+	 * Flattens the joint hierarchy so every joint comes after its parent.
+	 * @param joint The joint to add along with its descendants.
+	 * @param parent The index of the parent in the flattened joints, or -1 for the root.
+	 **/
+	void AddJoints(Joint *joint, const int32_t &parent);
+
+	/**
+	 * Resolves the keyframes of a animation into the tracks of a clip, or a compressed animation into the track of each joint.
+	 * @param clip The clip.
+	 * @param animation The animation.
+	 **/
+	void ResolveClip(Clip &clip, Animation *animation) const;
+
+	Layer &GetLayer(const uint32_t &layer);
+
+	/**
+	 * Samples a layer, crossfading from its previous clip.
+	 * @param layer The layer.
+	 * @param pose The pose to write into.
+	 **/
+	void EvaluateLayer(Layer &layer, Pose &pose);
+
+	/**
+	 * Blends a layers pose onto the pose of the layers below it.
+	 * @param layer The layer.
+	 * @param layerPose The pose of the layer.
+	 * @param pose The pose of the layers below, the result is written here.
+	 **/
+	void BlendLayer(const Layer &layer, const Pose &layerPose, Pose &pose) const;
+
+	/**
+	 * Converts the local-space pose into model-space by walking the flattened joints parent first,
+	 * then multiplies each joint with its inverse bind transform. This "subtracts" the joint's original bind (no animation applied) transform,
+	 * leaving the transform that moves the vertices into the current pose.
+	 * @param pose The local-space pose.
+	 * @param jointMatrices The joint matrices to write into.
+	 **/
+	void ApplyPose(const Pose &pose, std::vector<Matrix4> &jointMatrices);
+
 	Joint *m_rootJoint;
+	std::vector<JointNode> m_joints;
+	std::vector<Layer> m_layers;
+	Pose m_bindPose;
 
-	Time m_animationTime;
-	Animation *m_currentAnimation;
+	// Pose buffers reused every update, the result, a layer sample and a crossfade sample.
+	std::array<Pose, 3> m_poses;
+	std::vector<Matrix4> m_poseTransforms;
 };
 }
@@ -0,0 +1,193 @@
+#include "BakedAnimation.hpp"
+
+#include "Files/File.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Maths/Maths.hpp"
+#include "Resources/Resources.hpp"
+#include "Serialized/Xml/Xml.hpp"
+#include "Skeleton/SkeletonLoader.hpp"
+#include "Animator.hpp"
+#include "MeshAnimated.hpp"
+
+namespace acid
+{
+std::shared_ptr<BakedAnimation> BakedAnimation::Create(const Metadata &metadata)
+{
+	return Resources::Get()->FindOrLoad<BakedAnimation>(metadata, [&]()
+	{
+		auto result = std::make_shared<BakedAnimation>("", std::vector<std::string>(), 30.0f, false);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
+}
+
+std::shared_ptr<BakedAnimation> BakedAnimation::Create(const std::string &filename, const std::vector<std::string> &clipFilenames, const float &frameRate)
+{
+	auto temp = BakedAnimation(filename, clipFilenames, frameRate, false);
+	Metadata metadata = Metadata();
+	metadata << temp;
+	return Create(metadata);
+}
+
+BakedAnimation::BakedAnimation(std::string filename, std::vector<std::string> clipFilenames, const float &frameRate, const bool &load) :
+	m_filename(std::move(filename)),
+	m_clipFilenames(std::move(clipFilenames)),
+	m_frameRate(frameRate),
+	m_model(nullptr),
+	m_jointCount(0),
+	m_buffer(nullptr)
+{
+	if (load)
+	{
+		BakedAnimation::Load();
+	}
+}
+
+void BakedAnimation::Load()
+{
+	if (m_filename.empty())
+	{
+		return;
+	}
+
+#if defined(ACID_VERBOSE)
+	auto debugStart = Engine::GetTime();
+#endif
+
+	File file = File(m_filename, new Xml("COLLADA"));
+	file.Read();
+
+	// Because in Blender z is up, but Acid is y up. A correction must be applied to positions and normals.
+	auto correction = Matrix4::Identity.Rotate(-90.0f * Maths::DegToRad, Vector3f::Right);
+
+	auto skinLoader = SkinLoader(file.GetMetadata()->FindChild("library_controllers"), MeshAnimated::MaxWeights);
+	auto skeletonLoader = SkeletonLoader(file.GetMetadata()->FindChild("library_visual_scenes"), skinLoader.GetJointOrder(), correction);
+	auto geometryLoader = GeometryLoader(file.GetMetadata()->FindChild("library_geometries"), skinLoader.GetVertexWeights(), correction);
+
+	m_model = std::make_shared<Model>(geometryLoader.GetVertices(), geometryLoader.GetIndices());
+	m_jointCount = static_cast<uint32_t>(skinLoader.GetJointOrder().size());
+
+	std::unique_ptr<Joint> headJoint(MeshAnimated::CreateJoints(*skeletonLoader.GetHeadJoint()));
+	headJoint->CalculateInverseBindTransform(Matrix4::Identity);
+	Animator animator(headJoint.get());
+
+	// Clips are loaded from the model file first, then from each clip file.
+	std::vector<std::unique_ptr<Animation>> animations;
+
+	auto loadAnimation = [&](const Metadata &metadata, const std::string &filename)
+	{
+		auto libraryAnimations = metadata.FindChild("library_animations");
+		auto libraryVisualScenes = metadata.FindChild("library_visual_scenes");
+
+		if (libraryAnimations == nullptr || libraryVisualScenes == nullptr)
+		{
+			Log::Error("Baked animation file has no animation: '%s'\n", filename.c_str());
+			return;
+		}
+
+		auto animationLoader = AnimationLoader(libraryAnimations, libraryVisualScenes, correction);
+		animations.emplace_back(std::make_unique<Animation>(animationLoader.GetLengthSeconds(), animationLoader.GetKeyframes()));
+	};
+
+	loadAnimation(*file.GetMetadata(), m_filename);
+
+	for (const auto &clipFilename : m_clipFilenames)
+	{
+		File clipFile = File(clipFilename, new Xml("COLLADA"));
+		clipFile.Read();
+		loadAnimation(*clipFile.GetMetadata(), clipFilename);
+	}
+
+	// Each clip is sampled at even steps over its length, so the last frame blends back into the first as it loops.
+	m_clips.clear();
+	uint32_t frameCount = 0;
+
+	for (const auto &animation : animations)
+	{
+		Clip clip = {};
+		clip.m_firstFrame = frameCount;
+		clip.m_frameCount = std::max(static_cast<uint32_t>(std::round(animation->GetLength().AsSeconds() * m_frameRate)), 1u);
+		clip.m_length = animation->GetLength();
+		frameCount += clip.m_frameCount;
+		m_clips.emplace_back(clip);
+	}
+
+	if (frameCount == 0 || m_jointCount == 0)
+	{
+		m_buffer = nullptr;
+		return;
+	}
+
+	// The joint count is padded to the alignment of the matrices that follow it.
+	static const std::size_t HeaderSize = sizeof(Vector4f);
+	std::vector<uint8_t> data(HeaderSize + sizeof(Matrix4) * m_jointCount * frameCount);
+	std::memcpy(data.data(), &m_jointCount, sizeof(uint32_t));
+
+	std::vector<Matrix4> jointMatrices(m_jointCount);
+
+	for (uint32_t i = 0; i < m_clips.size(); i++)
+	{
+		auto &clip = m_clips[i];
+		animator.DoAnimation(animations[i].get());
+
+		for (uint32_t frame = 0; frame < clip.m_frameCount; frame++)
+		{
+			animator.SetAnimationTime(clip.m_length * (static_cast<float>(frame) / static_cast<float>(clip.m_frameCount)));
+			animator.Update(Time::Zero, jointMatrices);
+			std::memcpy(data.data() + HeaderSize + sizeof(Matrix4) * m_jointCount * (clip.m_firstFrame + frame), jointMatrices.data(), sizeof(Matrix4) * m_jointCount);
+		}
+	}
+
+	// Only read by shaders, so the matrices are uploaded into device local memory.
+	m_buffer = std::make_unique<StorageBuffer>(data.size(), nullptr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+	Graphics::Get()->GetUploadContext()->Record(data.data(), data.size(), [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+	{
+		VkBufferCopy copyRegion = {};
+		copyRegion.size = data.size();
+		vkCmdCopyBuffer(commandBuffer, bufferStaging.GetBuffer(), m_buffer->GetBuffer(), 1, &copyRegion);
+	});
+
+#if defined(ACID_VERBOSE)
+	auto debugEnd = Engine::GetTime();
+	Log::Out("Baked animation '%s' with %i frames in %.3fms\n", m_filename.c_str(), frameCount, (debugEnd - debugStart).AsMilliseconds<float>());
+#endif
+}
+
+std::pair<float, uint32_t> BakedAnimation::GetFrames(const uint32_t &clip, const Time &time) const
+{
+	if (clip >= m_clips.size())
+	{
+		return { 0.0f, 0 };
+	}
+
+	auto &baked = m_clips[clip];
+	auto length = baked.m_length.AsSeconds();
+	auto position = length > 0.0f ? std::fmod(time.AsSeconds() / length, 1.0f) * static_cast<float>(baked.m_frameCount) : 0.0f;
+
+	if (position < 0.0f)
+	{
+		position += static_cast<float>(baked.m_frameCount);
+	}
+
+	auto frame = std::min(static_cast<uint32_t>(position), baked.m_frameCount - 1);
+	return { static_cast<float>(baked.m_firstFrame) + position, baked.m_firstFrame + (frame + 1) % baked.m_frameCount };
+}
+
+const Metadata &operator>>(const Metadata &metadata, BakedAnimation &animation)
+{
+	metadata.GetChild("Filename", animation.m_filename);
+	metadata.GetChild("Clip Filenames", animation.m_clipFilenames);
+	metadata.GetChild("Frame Rate", animation.m_frameRate);
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const BakedAnimation &animation)
+{
+	metadata.SetChild("Filename", animation.m_filename);
+	metadata.SetChild("Clip Filenames", animation.m_clipFilenames);
+	metadata.SetChild("Frame Rate", animation.m_frameRate);
+	return metadata;
+}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Graphics/Buffers/StorageBuffer.hpp"
+#include "Models/Model.hpp"
+#include "Resources/Resource.hpp"
+
+namespace acid
+{
+/**
+ * @brief Resource that holds the animations of a skinned model baked into joint matrices at a fixed frame rate, so meshes drawn from it need no animator.
+ * Every frame of every clip is one row of joint matrices in a storage buffer, instanced vertex shaders blend the two frames a instance is between.
+ * The first clip is the animation in the model file, further clips are read from files with the same skeleton.
+ **/
+class ACID_EXPORT BakedAnimation :
+	public Resource
+{
+public:
+	/**
+	 * @brief A baked animation, its frames are rows in the buffer from the first frame.
+	 **/
+	class Clip
+	{
+	public:
+		uint32_t m_firstFrame;
+		uint32_t m_frameCount;
+		Time m_length;
+	};
+
+	/**
+	 * Creates a new baked animation, or finds one with the same values.
+	 * @param metadata The metadata to decode values from.
+	 * @return The baked animation with the requested values.
+	 **/
+	static std::shared_ptr<BakedAnimation> Create(const Metadata &metadata);
+
+	/**
+	 * Creates a new baked animation, or finds one with the same values.
+	 * @param filename The COLLADA file of the skinned model.
+	 * @param clipFilenames COLLADA files with more animations of the same skeleton.
+	 * @param frameRate The frames baked per second of animation.
+	 * @return The baked animation with the requested values.
+	 **/
+	static std::shared_ptr<BakedAnimation> Create(const std::string &filename, const std::vector<std::string> &clipFilenames = {}, const float &frameRate = 30.0f);
+
+	/**
+	 * Creates a new baked animation.
+	 * @param filename The COLLADA file of the skinned model.
+	 * @param clipFilenames COLLADA files with more animations of the same skeleton.
+	 * @param frameRate The frames baked per second of animation.
+	 * @param load If this resource will be loaded immediately, otherwise {@link BakedAnimation#Load} can be called later.
+	 **/
+	explicit BakedAnimation(std::string filename, std::vector<std::string> clipFilenames = {}, const float &frameRate = 30.0f, const bool &load = true);
+
+	void Load() override;
+
+	std::size_t GetGpuSize() const override { return m_buffer != nullptr ? static_cast<std::size_t>(m_buffer->GetSize()) : 0; }
+
+	const std::string &GetFilename() const { return m_filename; }
+
+	const std::shared_ptr<Model> &GetModel() const { return m_model; }
+
+	const std::vector<Clip> &GetClips() const { return m_clips; }
+
+	const float &GetFrameRate() const { return m_frameRate; }
+
+	const uint32_t &GetJointCount() const { return m_jointCount; }
+
+	/**
+	 * Gets the buffer of baked joint matrices, it starts with the joint count padded to a row of 16 bytes.
+	 * @return The joint matrices buffer, nullptr if nothing was baked.
+	 **/
+	const StorageBuffer *GetBuffer() const { return m_buffer.get(); }
+
+	/**
+	 * Finds the baked frames a clip is between at a time, the time loops over the length of the clip.
+	 * @param clip The index of the clip.
+	 * @param time The time into the clip.
+	 * @return The frame blended from with the progression to the next frame in its fraction, and the frame blended to.
+	 **/
+	std::pair<float, uint32_t> GetFrames(const uint32_t &clip, const Time &time) const;
+
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, BakedAnimation &animation);
+
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const BakedAnimation &animation);
+
+private:
+	std::string m_filename;
+	std::vector<std::string> m_clipFilenames;
+	float m_frameRate;
+
+	std::shared_ptr<Model> m_model;
+	std::vector<Clip> m_clips;
+	uint32_t m_jointCount;
+	std::unique_ptr<StorageBuffer> m_buffer;
+};
+}
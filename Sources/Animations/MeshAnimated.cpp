@@ -1,5 +1,6 @@
 #include "MeshAnimated.hpp"
 
+#include "Engine/Engine.hpp"
 #include "Maths/Maths.hpp"
 #include "Files/File.hpp"
 #include "Serialized/Xml/Xml.hpp"
@@ -20,24 +21,39 @@ MeshAnimated::MeshAnimated(std::string filename) :
 	Load();
 }
 
+MeshAnimated::~MeshAnimated()
+{
+	Engine::Get()->GetThreadPool().Wait(m_updating);
+}
+
 void MeshAnimated::Update()
 {
 	if (m_animator != nullptr)
 	{
-		m_animator->Update();
+		Engine::Get()->GetThreadPool().Wait(m_updating);
+		Engine::Get()->GetThreadPool().Dispatch([this]()
+		{
+			m_animator->Update(m_jointMatrices);
+		}, &m_updating);
 	}
+}
 
-	if (m_headJoint != nullptr)
-	{
-		m_jointMatrices.clear();
-		m_jointMatrices.resize(MaxJoints);
-		AddJointsToArray(*m_headJoint, m_jointMatrices);
-		//m_jointMatrices.shrink_to_fit();
-	}
+Animator *MeshAnimated::GetAnimator() const
+{
+	Engine::Get()->GetThreadPool().Wait(m_updating);
+	return m_animator.get();
+}
+
+const std::vector<Matrix4> &MeshAnimated::GetJointTransforms() const
+{
+	Engine::Get()->GetThreadPool().Wait(m_updating);
+	return m_jointMatrices;
 }
 
 void MeshAnimated::Load()
 {
+	Engine::Get()->GetThreadPool().Wait(m_updating);
+
 	if (m_filename.empty())
 	{
 		return;
@@ -57,10 +73,12 @@ void MeshAnimated::Load()
 	m_headJoint.reset(CreateJoints(*skeletonLoader.GetHeadJoint()));
 	m_headJoint->CalculateInverseBindTransform(Matrix4::Identity);
 	m_animator = std::make_unique<Animator>(m_headJoint.get());
+	m_jointMatrices.resize(MaxJoints);
 
 	auto animationLoader = AnimationLoader(file.GetMetadata()->FindChild("library_animations"), file.GetMetadata()->FindChild("library_visual_scenes"), correction);
 
 	m_animation = std::make_unique<Animation>(animationLoader.GetLengthSeconds(), animationLoader.GetKeyframes());
+	m_animation->Compress();
 	m_animator->DoAnimation(m_animation.get());
 }
 
@@ -76,19 +94,6 @@ Joint *MeshAnimated::CreateJoints(const JointData &data)
 	return joint;
 }
 
-void MeshAnimated::AddJointsToArray(const Joint &headJoint, std::vector<Matrix4> &jointMatrices)
-{
-	if (headJoint.GetIndex() < jointMatrices.size())
-	{
-		jointMatrices[headJoint.GetIndex()] = headJoint.GetAnimatedTransform();
-	}
-
-	for (const auto &childJoint : headJoint.GetChildren())
-	{
-		AddJointsToArray(*childJoint, jointMatrices);
-	}
-}
-
 const Metadata &operator>>(const Metadata &metadata, MeshAnimated &meshAnimated)
 {
 	metadata.GetChild("Model", meshAnimated.m_filename);
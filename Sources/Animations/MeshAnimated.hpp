@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Helpers/ThreadPool.hpp"
 #include "Maths/Matrix4.hpp"
 #include "Meshes/Mesh.hpp"
 #include "Animation/AnimationLoader.hpp"
@@ -19,6 +20,8 @@ class ACID_EXPORT MeshAnimated :
 public:
 	explicit MeshAnimated(std::string filename = "");
 
+	~MeshAnimated();
+
 	void Update() override;
 
 	void Load(); // override
@@ -29,7 +32,17 @@ public:
 
 	void SetModel(const std::shared_ptr<Model> &model) override { m_model = model; }
 
-	const std::vector<Matrix4> &GetJointTransforms() const { return m_jointMatrices; }
+	/**
+	 * Gets the animator, waiting for a update started this frame to finish first.
+	 * @return The animator.
+	 **/
+	Animator *GetAnimator() const;
+
+	/**
+	 * Gets the joint matrices, waiting for a update started this frame to finish first.
+	 * @return The joint matrices.
+	 **/
+	const std::vector<Matrix4> &GetJointTransforms() const;
 
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, MeshAnimated &meshAnimated);
 
@@ -38,11 +51,14 @@ public:
 	static const uint32_t MaxJoints;
 	static const uint32_t MaxWeights;
 
-private:
+	/**
+	 * Creates the joint hierarchy loaded from a skeleton.
+	 * @param data The loaded root joint.
+	 * @return The root joint, owned by the caller.
+	 **/
 	static Joint *CreateJoints(const JointData &data);
 
-	static void AddJointsToArray(const Joint &headJoint, std::vector<Matrix4> &jointMatrices);
-
+private:
 	std::string m_filename;
 	std::shared_ptr<Model> m_model;
 	std::unique_ptr<Joint> m_headJoint;
@@ -50,5 +66,7 @@ private:
 	std::unique_ptr<Animation> m_animation;
 
 	std::vector<Matrix4> m_jointMatrices;
+	// Animators are updated on the job system, so every animated mesh in the scene is posed in parallel.
+	ThreadPool::Counter m_updating;
 };
 }
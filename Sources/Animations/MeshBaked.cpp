@@ -0,0 +1,52 @@
+#include "MeshBaked.hpp"
+
+#include "Engine/Engine.hpp"
+
+namespace acid
+{
+MeshBaked::MeshBaked(std::shared_ptr<BakedAnimation> animation, const uint32_t &clip, const Time &timeOffset, const float &speed) :
+	Mesh(animation != nullptr ? animation->GetModel() : nullptr),
+	m_animation(std::move(animation)),
+	m_clip(clip),
+	m_timeOffset(timeOffset),
+	m_speed(speed)
+{
+}
+
+void MeshBaked::SetAnimation(const std::shared_ptr<BakedAnimation> &animation)
+{
+	m_animation = animation;
+	SetModel(m_animation != nullptr ? m_animation->GetModel() : nullptr);
+}
+
+std::pair<float, uint32_t> MeshBaked::GetFrames() const
+{
+	if (m_animation == nullptr)
+	{
+		return { 0.0f, 0 };
+	}
+
+	// Every baked mesh reads the same clock, so no mesh keeps a time that has to be updated.
+	return m_animation->GetFrames(m_clip, Engine::GetTime() * m_speed + m_timeOffset);
+}
+
+const Metadata &operator>>(const Metadata &metadata, MeshBaked &meshBaked)
+{
+	std::shared_ptr<BakedAnimation> animation;
+	metadata.GetResource("Animation", animation);
+	meshBaked.SetAnimation(animation);
+	metadata.GetChild("Clip", meshBaked.m_clip);
+	metadata.GetChild("Time Offset", meshBaked.m_timeOffset);
+	metadata.GetChild("Speed", meshBaked.m_speed);
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const MeshBaked &meshBaked)
+{
+	metadata.SetResource("Animation", meshBaked.m_animation);
+	metadata.SetChild("Clip", meshBaked.m_clip);
+	metadata.SetChild("Time Offset", meshBaked.m_timeOffset);
+	metadata.SetChild("Speed", meshBaked.m_speed);
+	return metadata;
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Meshes/Mesh.hpp"
+#include "Geometry/VertexAnimated.hpp"
+#include "BakedAnimation.hpp"
+
+namespace acid
+{
+/**
+ * @brief Component that represents a skinned mesh posed from a {@link BakedAnimation}, such as one of thousands of characters in a crowd.
+ * The mesh has no animator or joint uniforms, the playing clip and time are written into its batch instance and the vertex shader reads the baked pose.
+ * Meshes using the same baked animation and material are drawn in one instanced batch.
+ **/
+class ACID_EXPORT MeshBaked :
+	public Mesh
+{
+public:
+	/**
+	 * Creates a new baked mesh.
+	 * @param animation The baked animation the model and poses come from.
+	 * @param clip The index of the clip played.
+	 * @param timeOffset The time added to the clip time, so meshes playing the same clip are not in step.
+	 * @param speed The rate the clip is played at.
+	 **/
+	explicit MeshBaked(std::shared_ptr<BakedAnimation> animation = nullptr, const uint32_t &clip = 0, const Time &timeOffset = Time::Zero, const float &speed = 1.0f);
+
+	Shader::VertexInput GetVertexInput(const uint32_t &binding = 0) const override { return VertexAnimated::GetVertexInput(binding); }
+
+	const std::shared_ptr<BakedAnimation> &GetAnimation() const { return m_animation; }
+
+	void SetAnimation(const std::shared_ptr<BakedAnimation> &animation);
+
+	const uint32_t &GetClip() const { return m_clip; }
+
+	/**
+	 * Sets the clip played, it starts from the current time so meshes can change clip without a update.
+	 * @param clip The index of the clip.
+	 **/
+	void SetClip(const uint32_t &clip) { m_clip = clip; }
+
+	const Time &GetTimeOffset() const { return m_timeOffset; }
+
+	void SetTimeOffset(const Time &timeOffset) { m_timeOffset = timeOffset; }
+
+	const float &GetSpeed() const { return m_speed; }
+
+	void SetSpeed(const float &speed) { m_speed = speed; }
+
+	/**
+	 * Gets the baked frames the mesh is between now.
+	 * @return The frame blended from with the progression in its fraction, and the frame blended to.
+	 **/
+	std::pair<float, uint32_t> GetFrames() const;
+
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, MeshBaked &meshBaked);
+
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const MeshBaked &meshBaked);
+
+private:
+	std::shared_ptr<BakedAnimation> m_animation;
+	uint32_t m_clip;
+	Time m_timeOffset;
+	float m_speed;
+};
+}
@@ -6,9 +6,11 @@
 #else
 #include <al.h>
 #include <alc.h>
+#include <alext.h>
 #endif
 #include "Files/FileSystem.hpp"
 #include "Scenes/Scenes.hpp"
+#include "ReverbZone.hpp"
 
 namespace acid
 {
@@ -19,10 +21,22 @@ Audio::Audio() :
 	m_alDevice = alcOpenDevice(nullptr);
 	m_alContext = alcCreateContext(m_alDevice, nullptr);
 	alcMakeContextCurrent(m_alContext);
+
+	m_effects = std::make_unique<AudioEffects>(m_alDevice);
+	m_soundCache = std::make_unique<SoundCache>();
+	m_voicePool = std::make_unique<VoicePool>();
+
+	// Music is not in the space of the listener, so it is not sent to the reverb.
+	m_buses[Type::Music].m_reverbSend = 0.0f;
 }
 
 Audio::~Audio()
 {
+	// Sounds return their stream buffers to the cache as the voice pool stops them.
+	m_voicePool.reset();
+	m_soundCache.reset();
+	m_effects.reset();
+
 	alcMakeContextCurrent(nullptr);
 	alcDestroyContext(m_alContext);
 	alcCloseDevice(m_alDevice);
@@ -34,6 +48,7 @@ void Audio::Update()
 
 	if (camera == nullptr)
 	{
+		m_voicePool->Update(Engine::Get()->GetDelta());
 		return;
 	}
 
@@ -53,6 +68,11 @@ void Audio::Update()
 	ALfloat orientation[6] = { currentRay.m_x, currentRay.m_y, currentRay.m_z, 0.0f, 1.0f, 0.0f };
 	alListenerfv(AL_ORIENTATION, orientation);
 
+	UpdateReverb(position);
+
+	// Sounds are ranked by their distance to the listener set above.
+	m_voicePool->Update(Engine::Get()->GetDelta());
+
 	//CheckAl(alGetError());
 }
 
@@ -93,28 +113,110 @@ void Audio::CheckAl(const int32_t &result)
 
 float Audio::GetGain(const Type &type) const
 {
-	auto it = m_gains.find(type);
+	auto it = m_buses.find(type);
 
-	if (it == m_gains.end())
+	if (it == m_buses.end())
 	{
 		return 1.0f;
 	}
 
-	return it->second;
+	return it->second.m_gain;
 }
 
 void Audio::SetGain(const Type &type, const float &volume)
 {
-	auto it = m_gains.find(type);
+	m_buses[type].m_gain = volume;
+	m_onGain(type, volume);
+}
+
+float Audio::GetReverbSend(const Type &type) const
+{
+	auto it = m_buses.find(type);
+
+	if (it == m_buses.end())
+	{
+		return 1.0f;
+	}
+
+	return it->second.m_reverbSend;
+}
+
+void Audio::SetReverbSend(const Type &type, const float &send)
+{
+	m_buses[type].m_reverbSend = send;
+}
+
+uint32_t Audio::GetVoiceLimit(const Type &type) const
+{
+	auto it = m_buses.find(type);
+
+	if (it == m_buses.end())
+	{
+		return 0;
+	}
+
+	return it->second.m_voiceLimit;
+}
+
+void Audio::SetVoiceLimit(const Type &type, const uint32_t &voiceLimit)
+{
+	m_buses[type].m_voiceLimit = voiceLimit;
+}
 
-	if (it != m_gains.end())
+bool Audio::IsHrtf() const
+{
+#if defined(ACID_BUILD_MACOS)
+	return false;
+#else
+	if (!alcIsExtensionPresent(m_alDevice, "ALC_SOFT_HRTF"))
+	{
+		return false;
+	}
+
+	ALCint hrtf = ALC_FALSE;
+	alcGetIntegerv(m_alDevice, ALC_HRTF_SOFT, 1, &hrtf);
+	return hrtf == ALC_TRUE;
+#endif
+}
+
+void Audio::SetHrtf(const bool &hrtf)
+{
+#if !defined(ACID_BUILD_MACOS)
+	if (!alcIsExtensionPresent(m_alDevice, "ALC_SOFT_HRTF"))
 	{
-		it->second = volume;
-		m_onGain(type, volume);
+		Log::Warning("Audio device does not support HRTF\n");
 		return;
 	}
 
-	m_gains.emplace(type, volume);
-	m_onGain(type, volume);
+	auto alcResetDeviceSOFT = reinterpret_cast<LPALCRESETDEVICESOFT>(alcGetProcAddress(m_alDevice, "alcResetDeviceSOFT"));
+	ALCint attributes[] = { ALC_HRTF_SOFT, hrtf ? ALC_TRUE : ALC_FALSE, 0 };
+
+	if (alcResetDeviceSOFT == nullptr || !alcResetDeviceSOFT(m_alDevice, attributes))
+	{
+		Log::Error("Failed to reset audio device for HRTF: %s\n", alcGetString(m_alDevice, alcGetError(m_alDevice)));
+	}
+#endif
+}
+
+void Audio::UpdateReverb(const Vector3f &listener)
+{
+	ReverbZone *zone = nullptr;
+	auto blend = 0.0f;
+
+	if (auto structure = Scenes::Get()->GetStructure(); structure != nullptr)
+	{
+		for (auto reverbZone : structure->ViewComponents<ReverbZone>())
+		{
+			auto zoneBlend = reverbZone->GetBlend(listener);
+
+			if (zoneBlend > 0.0f && (zone == nullptr || reverbZone->GetRadius() < zone->GetRadius()))
+			{
+				zone = reverbZone;
+				blend = zoneBlend;
+			}
+		}
+	}
+
+	m_effects->SetReverb(zone, blend);
 }
 }
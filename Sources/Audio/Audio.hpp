@@ -2,6 +2,10 @@
 
 #include "Engine/Engine.hpp"
 #include "Helpers/Delegate.hpp"
+#include "Maths/Vector3.hpp"
+#include "AudioEffects.hpp"
+#include "SoundCache.hpp"
+#include "VoicePool.hpp"
 
 typedef struct ALCdevice_struct ALCdevice;
 typedef struct ALCcontext_struct ALCcontext;
@@ -10,6 +14,8 @@ namespace acid
 {
 /**
  * M@brief odule used for loading, managing and playing a variety of different sound types.
+ * Each sound type is a bus with its own gain, reverb send and voice limit, the master bus gain is applied to the listener.
+ * The reverb heard is that of the smallest acid::ReverbZone the listener is in, and sounds behind physics objects are filtered as occluded.
  */
 class ACID_EXPORT Audio :
 	public Module
@@ -40,6 +46,20 @@ public:
 
 	ACID_HIDDEN ALCcontext *GetContext() const { return m_alContext; }
 
+	/**
+	 * Gets the pool of sources shared by the playing sounds.
+	 * @return The voice pool.
+	 */
+	VoicePool &GetVoicePool() { return *m_voicePool; }
+
+	/**
+	 * Gets the pool of stream buffers, and the decoded samples of recently played compressed sounds.
+	 * @return The sound cache.
+	 */
+	SoundCache &GetSoundCache() { return *m_soundCache; }
+
+	ACID_HIDDEN AudioEffects &GetEffects() { return *m_effects; }
+
 	float GetGain(const Type &type) const;
 
 	void SetGain(const Type &type, const float &volume);
@@ -50,11 +70,54 @@ public:
 	 */
 	Delegate<void(Type, float)> &OnGain() { return m_onGain; }
 
+	float GetReverbSend(const Type &type) const;
+
+	/**
+	 * Sets how much of the sounds of a type are sent to the reverb of the zone the listener is in.
+	 * @param type The type.
+	 * @param send The send gain, zero sends none, music is not sent by default.
+	 */
+	void SetReverbSend(const Type &type, const float &send);
+
+	uint32_t GetVoiceLimit(const Type &type) const;
+
+	/**
+	 * Sets the most sounds of a type given a source at once, sounds ranked below the limit are virtual.
+	 * @param type The type.
+	 * @param voiceLimit The limit, zero only limits the type by the sources in the voice pool.
+	 */
+	void SetVoiceLimit(const Type &type, const uint32_t &voiceLimit);
+
+	/**
+	 * Gets if the device renders with head related transfer functions.
+	 * @return If HRTF is enabled.
+	 */
+	bool IsHrtf() const;
+
+	/**
+	 * Resets the device to render with or without head related transfer functions, this does nothing if the device does not support HRTF.
+	 * @param hrtf If HRTF is enabled.
+	 */
+	void SetHrtf(const bool &hrtf);
+
 private:
+	class Bus
+	{
+	public:
+		float m_gain = 1.0f;
+		float m_reverbSend = 1.0f;
+		uint32_t m_voiceLimit = 0;
+	};
+
+	void UpdateReverb(const Vector3f &listener);
+
 	ALCdevice *m_alDevice;
 	ALCcontext *m_alContext;
+	std::unique_ptr<AudioEffects> m_effects;
+	std::unique_ptr<SoundCache> m_soundCache;
+	std::unique_ptr<VoicePool> m_voicePool;
 
-	std::map<Type, float> m_gains;
+	std::map<Type, Bus> m_buses;
 
 	Delegate<void(Type, float)> m_onGain;
 };
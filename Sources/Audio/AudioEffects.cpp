@@ -0,0 +1,162 @@
+#include "AudioEffects.hpp"
+
+#if !defined(ACID_BUILD_MACOS)
+#include <al.h>
+#include <alc.h>
+#include <efx.h>
+#endif
+#include "Engine/Log.hpp"
+#include "ReverbZone.hpp"
+
+namespace acid
+{
+#if !defined(ACID_BUILD_MACOS)
+// The extension functions are loaded from the device when the first effects are created.
+static LPALGENEFFECTS alGenEffects;
+static LPALDELETEEFFECTS alDeleteEffects;
+static LPALEFFECTI alEffecti;
+static LPALEFFECTF alEffectf;
+static LPALGENFILTERS alGenFilters;
+static LPALDELETEFILTERS alDeleteFilters;
+static LPALFILTERI alFilteri;
+static LPALFILTERF alFilterf;
+static LPALGENAUXILIARYEFFECTSLOTS alGenAuxiliaryEffectSlots;
+static LPALDELETEAUXILIARYEFFECTSLOTS alDeleteAuxiliaryEffectSlots;
+static LPALAUXILIARYEFFECTSLOTI alAuxiliaryEffectSloti;
+static LPALAUXILIARYEFFECTSLOTF alAuxiliaryEffectSlotf;
+
+template<typename T>
+static bool LoadProc(T &proc, const char *name)
+{
+	proc = reinterpret_cast<T>(alGetProcAddress(name));
+	return proc != nullptr;
+}
+#endif
+
+AudioEffects::AudioEffects(ALCdevice *device) :
+	m_supported(false),
+	m_slot(0),
+	m_reverb(0),
+	m_filter(0),
+	m_zone(nullptr)
+{
+#if !defined(ACID_BUILD_MACOS)
+	if (device == nullptr || !alcIsExtensionPresent(device, "ALC_EXT_EFX"))
+	{
+		Log::Warning("Audio device does not support effects\n");
+		return;
+	}
+
+	m_supported = LoadProc(alGenEffects, "alGenEffects") && LoadProc(alDeleteEffects, "alDeleteEffects") && LoadProc(alEffecti, "alEffecti") &&
+		LoadProc(alEffectf, "alEffectf") && LoadProc(alGenFilters, "alGenFilters") && LoadProc(alDeleteFilters, "alDeleteFilters") &&
+		LoadProc(alFilteri, "alFilteri") && LoadProc(alFilterf, "alFilterf") && LoadProc(alGenAuxiliaryEffectSlots, "alGenAuxiliaryEffectSlots") &&
+		LoadProc(alDeleteAuxiliaryEffectSlots, "alDeleteAuxiliaryEffectSlots") && LoadProc(alAuxiliaryEffectSloti, "alAuxiliaryEffectSloti") &&
+		LoadProc(alAuxiliaryEffectSlotf, "alAuxiliaryEffectSlotf");
+
+	if (!m_supported)
+	{
+		return;
+	}
+
+	alGetError();
+	alGenAuxiliaryEffectSlots(1, &m_slot);
+	alGenEffects(1, &m_reverb);
+	alEffecti(m_reverb, AL_EFFECT_TYPE, AL_EFFECT_REVERB);
+	alGenFilters(1, &m_filter);
+	alFilteri(m_filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+
+	if (alGetError() != AL_NO_ERROR)
+	{
+		Log::Warning("Audio device could not create a reverb\n");
+		m_supported = false;
+		return;
+	}
+
+	SetReverb(nullptr, 0.0f);
+#endif
+}
+
+AudioEffects::~AudioEffects()
+{
+#if !defined(ACID_BUILD_MACOS)
+	if (m_slot != 0)
+	{
+		alDeleteAuxiliaryEffectSlots(1, &m_slot);
+	}
+
+	if (m_reverb != 0)
+	{
+		alDeleteEffects(1, &m_reverb);
+	}
+
+	if (m_filter != 0)
+	{
+		alDeleteFilters(1, &m_filter);
+	}
+#endif
+}
+
+void AudioEffects::SetReverb(const ReverbZone *zone, const float &blend)
+{
+#if !defined(ACID_BUILD_MACOS)
+	if (!m_supported)
+	{
+		return;
+	}
+
+	if (zone != nullptr && zone != m_zone)
+	{
+		alEffectf(m_reverb, AL_REVERB_DENSITY, zone->GetDensity());
+		alEffectf(m_reverb, AL_REVERB_DIFFUSION, zone->GetDiffusion());
+		alEffectf(m_reverb, AL_REVERB_GAIN, zone->GetGain());
+		alEffectf(m_reverb, AL_REVERB_GAINHF, zone->GetGainHf());
+		alEffectf(m_reverb, AL_REVERB_DECAY_TIME, zone->GetDecayTime());
+		alEffectf(m_reverb, AL_REVERB_DECAY_HFRATIO, zone->GetDecayHfRatio());
+		alEffectf(m_reverb, AL_REVERB_REFLECTIONS_GAIN, zone->GetReflectionsGain());
+		alEffectf(m_reverb, AL_REVERB_REFLECTIONS_DELAY, zone->GetReflectionsDelay());
+		alEffectf(m_reverb, AL_REVERB_LATE_REVERB_GAIN, zone->GetLateReverbGain());
+		alEffectf(m_reverb, AL_REVERB_LATE_REVERB_DELAY, zone->GetLateReverbDelay());
+
+		// The slot keeps a copy of the effect, so it is set again after the effect changed.
+		alAuxiliaryEffectSloti(m_slot, AL_EFFECTSLOT_EFFECT, static_cast<ALint>(m_reverb));
+	}
+
+	m_zone = zone;
+	alAuxiliaryEffectSlotf(m_slot, AL_EFFECTSLOT_GAIN, zone != nullptr ? std::clamp(blend, 0.0f, 1.0f) : 0.0f);
+#endif
+}
+
+void AudioEffects::SetDirect(const uint32_t &source, const float &gain, const float &gainHf)
+{
+#if !defined(ACID_BUILD_MACOS)
+	if (!m_supported)
+	{
+		return;
+	}
+
+	alFilterf(m_filter, AL_LOWPASS_GAIN, gain);
+	alFilterf(m_filter, AL_LOWPASS_GAINHF, gainHf);
+	alSourcei(source, AL_DIRECT_FILTER, static_cast<ALint>(m_filter));
+#endif
+}
+
+void AudioEffects::SetSend(const uint32_t &source, const float &send, const float &gainHf)
+{
+#if !defined(ACID_BUILD_MACOS)
+	if (!m_supported)
+	{
+		return;
+	}
+
+	if (send <= 0.0f)
+	{
+		alSource3i(source, AL_AUXILIARY_SEND_FILTER, AL_EFFECTSLOT_NULL, 0, AL_FILTER_NULL);
+		return;
+	}
+
+	alFilterf(m_filter, AL_LOWPASS_GAIN, send);
+	alFilterf(m_filter, AL_LOWPASS_GAINHF, gainHf);
+	alSource3i(source, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(m_slot), 0, static_cast<ALint>(m_filter));
+#endif
+}
+}
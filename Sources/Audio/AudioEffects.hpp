@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+
+typedef struct ALCdevice_struct ALCdevice;
+
+namespace acid
+{
+class ReverbZone;
+
+/**
+ * @brief The OpenAL effects extension objects shared by every source, a reverb in a auxiliary effect slot, and the filters used for occlusion and sends.
+ * Filters are copied onto a source when they are set on it, so the same filter is reused for every source with different parameters.
+ * When the device does not support the extension every method does nothing.
+ */
+class ACID_HIDDEN AudioEffects :
+	public NonCopyable
+{
+public:
+	explicit AudioEffects(ALCdevice *device);
+
+	~AudioEffects();
+
+	bool IsSupported() const { return m_supported; }
+
+	/**
+	 * Loads the properties of a reverb zone into the reverb effect, the properties are only loaded again when the zone changes.
+	 * @param zone The zone the listener is in, or null to silence the reverb.
+	 * @param blend How much of the reverb is heard, from zero to one, used to fade at the edge of the zone.
+	 */
+	void SetReverb(const ReverbZone *zone, const float &blend);
+
+	/**
+	 * Sets the direct path filter of a source.
+	 * @param source The source.
+	 * @param gain The gain of the direct path.
+	 * @param gainHf The gain of high frequencies on the direct path, lowered for occluded sounds.
+	 */
+	void SetDirect(const uint32_t &source, const float &gain, const float &gainHf);
+
+	/**
+	 * Sets how much of a source is sent to the reverb.
+	 * @param source The source.
+	 * @param send The send gain, zero disconnects the source from the reverb.
+	 * @param gainHf The gain of high frequencies sent to the reverb.
+	 */
+	void SetSend(const uint32_t &source, const float &send, const float &gainHf);
+
+private:
+	bool m_supported;
+	uint32_t m_slot;
+	uint32_t m_reverb;
+	uint32_t m_filter;
+	const ReverbZone *m_zone;
+};
+}
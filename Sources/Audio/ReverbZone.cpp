@@ -0,0 +1,80 @@
+#include "ReverbZone.hpp"
+
+#include "Scenes/Entity.hpp"
+
+namespace acid
+{
+ReverbZone::ReverbZone(const float &radius, const float &fade) :
+	m_radius(radius),
+	m_fade(fade),
+	m_density(1.0f),
+	m_diffusion(1.0f),
+	m_gain(0.32f),
+	m_gainHf(0.89f),
+	m_decayTime(1.49f),
+	m_decayHfRatio(0.83f),
+	m_reflectionsGain(0.05f),
+	m_reflectionsDelay(0.007f),
+	m_lateReverbGain(1.26f),
+	m_lateReverbDelay(0.011f)
+{
+}
+
+void ReverbZone::Start()
+{
+}
+
+void ReverbZone::Update()
+{
+	if (GetParent() != nullptr)
+	{
+		m_position = GetParent()->GetWorldTransform().GetPosition();
+	}
+}
+
+float ReverbZone::GetBlend(const Vector3f &position) const
+{
+	auto inside = m_radius - m_position.Distance(position);
+
+	if (inside <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	return m_fade > 0.0f ? std::min(inside / m_fade, 1.0f) : 1.0f;
+}
+
+const Metadata &operator>>(const Metadata &metadata, ReverbZone &reverbZone)
+{
+	metadata.GetChild("Radius", reverbZone.m_radius);
+	metadata.GetChild("Fade", reverbZone.m_fade);
+	metadata.GetChild("Density", reverbZone.m_density);
+	metadata.GetChild("Diffusion", reverbZone.m_diffusion);
+	metadata.GetChild("Gain", reverbZone.m_gain);
+	metadata.GetChild("Gain HF", reverbZone.m_gainHf);
+	metadata.GetChild("Decay Time", reverbZone.m_decayTime);
+	metadata.GetChild("Decay HF Ratio", reverbZone.m_decayHfRatio);
+	metadata.GetChild("Reflections Gain", reverbZone.m_reflectionsGain);
+	metadata.GetChild("Reflections Delay", reverbZone.m_reflectionsDelay);
+	metadata.GetChild("Late Reverb Gain", reverbZone.m_lateReverbGain);
+	metadata.GetChild("Late Reverb Delay", reverbZone.m_lateReverbDelay);
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const ReverbZone &reverbZone)
+{
+	metadata.SetChild("Radius", reverbZone.m_radius);
+	metadata.SetChild("Fade", reverbZone.m_fade);
+	metadata.SetChild("Density", reverbZone.m_density);
+	metadata.SetChild("Diffusion", reverbZone.m_diffusion);
+	metadata.SetChild("Gain", reverbZone.m_gain);
+	metadata.SetChild("Gain HF", reverbZone.m_gainHf);
+	metadata.SetChild("Decay Time", reverbZone.m_decayTime);
+	metadata.SetChild("Decay HF Ratio", reverbZone.m_decayHfRatio);
+	metadata.SetChild("Reflections Gain", reverbZone.m_reflectionsGain);
+	metadata.SetChild("Reflections Delay", reverbZone.m_reflectionsDelay);
+	metadata.SetChild("Late Reverb Gain", reverbZone.m_lateReverbGain);
+	metadata.SetChild("Late Reverb Delay", reverbZone.m_lateReverbDelay);
+	return metadata;
+}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Maths/Vector3.hpp"
+#include "Serialized/Metadata.hpp"
+#include "Scenes/Component.hpp"
+
+namespace acid
+{
+/**
+ * @brief Component that gives the space around its entity a reverb, heard by every sound sent to the reverb while the listener is inside the zone.
+ * When zones overlap the smallest zone the listener is in is heard, the reverb fades out over the fade distance inside the edge of the zone.
+ * The properties are those of the OpenAL effects extensions standard reverb, the defaults are its defaults.
+ */
+class ACID_EXPORT ReverbZone :
+	public Component
+{
+public:
+	/**
+	 * Creates a new reverb zone.
+	 * @param radius The radius of the zone around its entity.
+	 * @param fade The distance inside the edge of the zone the reverb fades over.
+	 */
+	explicit ReverbZone(const float &radius = 10.0f, const float &fade = 2.0f);
+
+	void Start() override;
+
+	void Update() override;
+
+	/**
+	 * Gets how much of the reverb is heard at a position.
+	 * @param position The position of the listener.
+	 * @return The blend, zero outside of the zone and one further inside than the fade distance.
+	 */
+	float GetBlend(const Vector3f &position) const;
+
+	const float &GetRadius() const { return m_radius; }
+
+	void SetRadius(const float &radius) { m_radius = radius; }
+
+	const float &GetFade() const { return m_fade; }
+
+	void SetFade(const float &fade) { m_fade = fade; }
+
+	const float &GetDensity() const { return m_density; }
+
+	void SetDensity(const float &density) { m_density = density; }
+
+	const float &GetDiffusion() const { return m_diffusion; }
+
+	void SetDiffusion(const float &diffusion) { m_diffusion = diffusion; }
+
+	const float &GetGain() const { return m_gain; }
+
+	void SetGain(const float &gain) { m_gain = gain; }
+
+	const float &GetGainHf() const { return m_gainHf; }
+
+	void SetGainHf(const float &gainHf) { m_gainHf = gainHf; }
+
+	const float &GetDecayTime() const { return m_decayTime; }
+
+	void SetDecayTime(const float &decayTime) { m_decayTime = decayTime; }
+
+	const float &GetDecayHfRatio() const { return m_decayHfRatio; }
+
+	void SetDecayHfRatio(const float &decayHfRatio) { m_decayHfRatio = decayHfRatio; }
+
+	const float &GetReflectionsGain() const { return m_reflectionsGain; }
+
+	void SetReflectionsGain(const float &reflectionsGain) { m_reflectionsGain = reflectionsGain; }
+
+	const float &GetReflectionsDelay() const { return m_reflectionsDelay; }
+
+	void SetReflectionsDelay(const float &reflectionsDelay) { m_reflectionsDelay = reflectionsDelay; }
+
+	const float &GetLateReverbGain() const { return m_lateReverbGain; }
+
+	void SetLateReverbGain(const float &lateReverbGain) { m_lateReverbGain = lateReverbGain; }
+
+	const float &GetLateReverbDelay() const { return m_lateReverbDelay; }
+
+	void SetLateReverbDelay(const float &lateReverbDelay) { m_lateReverbDelay = lateReverbDelay; }
+
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, ReverbZone &reverbZone);
+
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ReverbZone &reverbZone);
+
+private:
+	Vector3f m_position;
+	float m_radius;
+	float m_fade;
+
+	float m_density;
+	float m_diffusion;
+	float m_gain;
+	float m_gainHf;
+	float m_decayTime;
+	float m_decayHfRatio;
+	float m_reflectionsGain;
+	float m_reflectionsDelay;
+	float m_lateReverbGain;
+	float m_lateReverbDelay;
+};
+}
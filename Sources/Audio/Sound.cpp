@@ -9,20 +9,24 @@
 
 namespace acid
 {
-Sound::Sound(const std::string &filename, const Audio::Type &type, const bool &begin, const bool &loop, const float &gain, const float &pitch) :
-	m_soundBuffer(SoundBuffer::Create(filename)),
+Sound::Sound(const std::string &filename, const Audio::Type &type, const bool &begin, const bool &loop, const float &gain, const float &pitch,
+	const bool &streamed, const bool &compressed) :
+	m_soundBuffer(SoundBuffer::Create(filename, streamed, compressed)),
 	m_source(0),
+	m_playing(false),
+	m_paused(false),
+	m_loop(false),
+	m_voiced(false),
+	m_frame(0.0),
+	m_occlusion(0.0f),
 	m_type(type),
 	m_gain(gain),
-	m_pitch(pitch)
+	m_pitch(pitch),
+	m_priority(1.0f)
 {
-	alGenSources(1, &m_source);
-	alSourcei(m_source, AL_BUFFER, m_soundBuffer->GetBuffer());
-
-	Audio::CheckAl(alGetError());
-
-	SetGain(gain);
-	SetPitch(pitch);
+	// Only the position of the voice is updated, a sound far from the listener can follow its entity a few frames late.
+	SetUpdatePriority(UpdatePriority::Low);
+	SetThreadSafe(true);
 
 	if (begin)
 	{
@@ -40,8 +44,11 @@ Sound::Sound(const std::string &filename, const Audio::Type &type, const bool &b
 
 Sound::~Sound()
 {
-	alDeleteSources(1, &m_source);
-	Audio::CheckAl(alGetError());
+	// The source is returned to the pool, and the streams buffers unqueued from it before they are deleted.
+	if (m_playing)
+	{
+		Audio::Get()->GetVoicePool().Remove(this);
+	}
 }
 
 void Sound::Start()
@@ -50,16 +57,34 @@ void Sound::Start()
 
 void Sound::Update()
 {
-	SetPosition(GetParent()->GetWorldTransform().GetPosition());
+	// Only the position is kept here, the voice pool sets it on the source if the sound has one.
+	if (m_playing && GetParent() != nullptr)
+	{
+		m_position = GetParent()->GetWorldTransform().GetPosition();
+	}
 }
 
 void Sound::Play(const bool &loop)
 {
-	alSourcei(m_source, AL_LOOPING, loop);
-	alSourcePlay(m_source);
-	Audio::CheckAl(alGetError());
+	m_loop = loop;
+	m_paused = false;
+
+	if (GetParent() != nullptr)
+	{
+		m_position = GetParent()->GetWorldTransform().GetPosition();
+	}
 
-	SetGain(m_gain);
+	if (m_source != 0)
+	{
+		// Restarts the sound on the source it already has.
+		auto source = Virtualize();
+		m_frame = 0.0;
+		Realize(source);
+		return;
+	}
+
+	m_frame = 0.0;
+	Audio::Get()->GetVoicePool().Add(this);
 }
 
 void Sound::Pause()
@@ -69,74 +94,214 @@ void Sound::Pause()
 		return;
 	}
 
-	alSourcePause(m_source);
-	Audio::CheckAl(alGetError());
+	// A paused sound is not heard, so the next update of the voice pool gives its source to another sound.
+	m_paused = true;
+
+	if (m_source != 0)
+	{
+		alSourcePause(m_source);
+		Audio::CheckAl(alGetError());
+	}
 }
 
 void Sound::Resume()
 {
-	if (IsPlaying())
+	if (!m_playing || !m_paused)
 	{
 		return;
 	}
 
-	alSourcePlay(m_source);
-	Audio::CheckAl(alGetError());
+	m_paused = false;
 
-	SetGain(m_gain);
+	if (m_source != 0)
+	{
+		alSourcePlay(m_source);
+		Audio::CheckAl(alGetError());
+	}
 }
 
 void Sound::Stop()
 {
-	if (!IsPlaying())
+	if (!m_playing)
 	{
 		return;
 	}
 
-	alSourceStop(m_source);
-	Audio::CheckAl(alGetError());
-}
-
-bool Sound::IsPlaying() const
-{
-	ALenum state;
-	alGetSourcei(m_source, AL_SOURCE_STATE, &state);
-	return state == AL_PLAYING;
+	Audio::Get()->GetVoicePool().Remove(this);
+	m_frame = 0.0;
 }
 
 void Sound::SetPosition(const Vector3f &position)
 {
 	m_position = position;
-	alSource3f(m_source, AL_POSITION, m_position.m_x, m_position.m_y, m_position.m_z);
-	Audio::CheckAl(alGetError());
 }
 
 void Sound::SetDirection(const Vector3f &direction)
 {
 	m_direction = direction;
-	alSource3f(m_source, AL_DIRECTION, m_direction.m_x, m_direction.m_y, m_direction.m_z);
-	Audio::CheckAl(alGetError());
+
+	if (m_source != 0)
+	{
+		alSource3f(m_source, AL_DIRECTION, m_direction.m_x, m_direction.m_y, m_direction.m_z);
+		Audio::CheckAl(alGetError());
+	}
 }
 
 void Sound::SetVelocity(const Vector3f &velocity)
 {
 	m_velocity = velocity;
-	alSource3f(m_source, AL_VELOCITY, m_velocity.m_x, m_velocity.m_y, m_velocity.m_z);
-	Audio::CheckAl(alGetError());
+
+	if (m_source != 0)
+	{
+		alSource3f(m_source, AL_VELOCITY, m_velocity.m_x, m_velocity.m_y, m_velocity.m_z);
+		Audio::CheckAl(alGetError());
+	}
 }
 
 void Sound::SetGain(const float &gain)
 {
 	m_gain = gain;
-	alSourcef(m_source, AL_GAIN, m_gain * Audio::Get()->GetGain(m_type));
-	Audio::CheckAl(alGetError());
+
+	if (m_source != 0)
+	{
+		alSourcef(m_source, AL_GAIN, m_gain * Audio::Get()->GetGain(m_type));
+		Audio::CheckAl(alGetError());
+	}
 }
 
 void Sound::SetPitch(const float &pitch)
 {
 	m_pitch = pitch;
+
+	if (m_source != 0)
+	{
+		alSourcef(m_source, AL_PITCH, m_pitch);
+		Audio::CheckAl(alGetError());
+	}
+}
+
+float Sound::GetAudibleGain(const Vector3f &listener) const
+{
+	if (m_paused)
+	{
+		return 0.0f;
+	}
+
+	// OpenALs default inverse distance model, with a reference distance and rolloff of one.
+	auto distance = std::max(m_position.Distance(listener), 1.0f);
+	return m_gain * Audio::Get()->GetGain(m_type) * Audio::Get()->GetGain(Audio::Type::Master) / distance;
+}
+
+void Sound::Realize(const uint32_t &source)
+{
+	m_source = source;
+	alSourcef(m_source, AL_GAIN, m_gain * Audio::Get()->GetGain(m_type));
 	alSourcef(m_source, AL_PITCH, m_pitch);
+	alSource3f(m_source, AL_POSITION, m_position.m_x, m_position.m_y, m_position.m_z);
+	alSource3f(m_source, AL_DIRECTION, m_direction.m_x, m_direction.m_y, m_direction.m_z);
+	alSource3f(m_source, AL_VELOCITY, m_velocity.m_x, m_velocity.m_y, m_velocity.m_z);
+
+	// The sound continues from where it played to while it was virtual.
+	auto frame = static_cast<std::size_t>(m_frame);
+
+	if (!m_soundBuffer->IsStreamed() && m_soundBuffer->IsCompressed())
+	{
+		m_decoded = Audio::Get()->GetSoundCache().Find(m_soundBuffer->GetFilename());
+	}
+
+	if (m_soundBuffer->IsStreamed() || (m_soundBuffer->IsCompressed() && m_decoded == nullptr))
+	{
+		if (m_soundStream == nullptr)
+		{
+			m_soundStream = std::make_unique<SoundStream>(m_soundBuffer);
+		}
+
+		m_soundStream->Start(m_source, m_loop, frame);
+	}
+	else
+	{
+		alSourcei(m_source, AL_LOOPING, m_loop);
+		alSourcei(m_source, AL_BUFFER, m_decoded != nullptr ? m_decoded->GetBuffer() : m_soundBuffer->GetBuffer());
+		alSourcei(m_source, AL_SAMPLE_OFFSET, static_cast<ALint>(frame));
+	}
+
+	if (!m_paused)
+	{
+		alSourcePlay(m_source);
+	}
+
+	Audio::CheckAl(alGetError());
+}
+
+uint32_t Sound::Virtualize()
+{
+	if (m_soundStream != nullptr)
+	{
+		m_frame = static_cast<double>(m_soundStream->GetFrame(m_source));
+		m_soundStream->Stop(m_source);
+
+		// Compressed sounds are not kept streaming while virtual, the buffers go back to the pool.
+		if (!m_soundBuffer->IsStreamed())
+		{
+			m_soundStream = nullptr;
+		}
+	}
+	else
+	{
+		ALint offset = 0;
+		alGetSourcei(m_source, AL_SAMPLE_OFFSET, &offset);
+		m_frame = static_cast<double>(offset);
+		alSourceStop(m_source);
+		alSourcei(m_source, AL_BUFFER, 0);
+		m_decoded = nullptr;
+	}
+
 	Audio::CheckAl(alGetError());
+
+	auto source = m_source;
+	m_source = 0;
+	return source;
+}
+
+bool Sound::Advance(const Time &delta)
+{
+	if (m_source != 0)
+	{
+		// A stream the source played to the end of before its next block was decoded has not finished.
+		ALint state = AL_STOPPED;
+		alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+		return state != AL_STOPPED || (m_soundStream != nullptr && !m_soundStream->IsEnded());
+	}
+
+	if (m_paused)
+	{
+		return true;
+	}
+
+	auto frameCount = static_cast<double>(m_soundBuffer->GetFrameCount());
+	m_frame += delta.AsSeconds<double>() * m_soundBuffer->GetSampleRate() * m_pitch;
+
+	if (m_frame >= frameCount)
+	{
+		if (!m_loop || frameCount == 0.0)
+		{
+			return false;
+		}
+
+		m_frame = std::fmod(m_frame, frameCount);
+	}
+
+	return true;
+}
+
+void Sound::UpdateSource()
+{
+	alSource3f(m_source, AL_POSITION, m_position.m_x, m_position.m_y, m_position.m_z);
+
+	if (m_soundStream != nullptr)
+	{
+		m_soundStream->Update(m_source);
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, Sound &sound)
@@ -145,6 +310,7 @@ const Metadata &operator>>(const Metadata &metadata, Sound &sound)
 	metadata.GetChild("Type", sound.m_type);
 	metadata.GetChild("Gain", sound.m_gain);
 	metadata.GetChild("Pitch", sound.m_pitch);
+	metadata.GetChild("Priority", sound.m_priority);
 	return metadata;
 }
 
@@ -154,6 +320,7 @@ Metadata &operator<<(Metadata &metadata, const Sound &sound)
 	metadata.SetChild("Type", sound.m_type);
 	metadata.SetChild("Gain", sound.m_gain);
 	metadata.SetChild("Pitch", sound.m_pitch);
+	metadata.SetChild("Priority", sound.m_priority);
 	return metadata;
 }
 }
@@ -3,19 +3,24 @@
 #include "Maths/Vector3.hpp"
 #include "Scenes/Component.hpp"
 #include "SoundBuffer.hpp"
+#include "SoundStream.hpp"
 #include "Audio.hpp"
 
 namespace acid
 {
 /**
  * @brief Class that represents a playable sound.
+ * A streamed sound is decoded as it plays by a acid::SoundStream, this is used for long music tracks so they are never held decoded in memory.
+ * A compressed sound plays the samples cached by the acid::SoundCache if it was decoded recently, otherwise it is decoded as it plays by a stream that is
+ * destroyed once it stops, so only the sounds with a source hold a decoder.
+ * Playing sounds share the sources of the acid::VoicePool, a sound without a source is virtual and keeps playing silently until it is given one.
  */
 class ACID_EXPORT Sound :
 	public Component
 {
 public:
 	explicit Sound(const std::string &filename, const Audio::Type &type = Audio::Type::General, const bool &begin = false,
-		const bool &loop = false, const float &gain = 1.0f, const float &pitch = 1.0f);
+		const bool &loop = false, const float &gain = 1.0f, const float &pitch = 1.0f, const bool &streamed = false, const bool &compressed = false);
 
 	~Sound();
 
@@ -31,7 +36,17 @@ public:
 
 	void Stop();
 
-	bool IsPlaying() const;
+	/**
+	 * Gets if the sound is playing and not paused, a virtual sound plays without being heard.
+	 * @return If the sound is playing.
+	 */
+	bool IsPlaying() const { return m_playing && !m_paused; }
+
+	/**
+	 * Gets if the sound has a source, a playing sound without one is virtual.
+	 * @return If the sound has a source.
+	 */
+	bool IsVirtual() const { return m_source == 0; }
 
 	void SetPosition(const Vector3f &position);
 
@@ -51,13 +66,59 @@ public:
 
 	void SetPitch(const float &pitch);
 
+	const float &GetPriority() const { return m_priority; }
+
+	/**
+	 * Sets the priority the sound is ranked by for a source, multiplied by the gain it is heard at.
+	 * @param priority The priority, one by default.
+	 */
+	void SetPriority(const float &priority) { m_priority = priority; }
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Sound &sound);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Sound &sound);
 
 private:
+	friend class VoicePool;
+
+	float GetAudibleGain(const Vector3f &listener) const;
+
+	/**
+	 * Plays the sound on a source from the frame it is at.
+	 * @param source The source.
+	 */
+	void Realize(const uint32_t &source);
+
+	/**
+	 * Stops the source and keeps the frame it played to.
+	 * @return The source.
+	 */
+	uint32_t Virtualize();
+
+	/**
+	 * Advances a virtual sound by the time it would have played for.
+	 * @param delta The time since the last update.
+	 * @return False once a sound that does not loop has finished.
+	 */
+	bool Advance(const Time &delta);
+
+	void UpdateSource();
+
 	std::shared_ptr<SoundBuffer> m_soundBuffer;
+	std::unique_ptr<SoundStream> m_soundStream;
+	/// The cached samples of a compressed sound the source plays, held so they are not deleted while playing.
+	std::shared_ptr<SoundCache::Decoded> m_decoded;
+	/// The source from the voice pool, zero when virtual or not playing.
 	uint32_t m_source;
+	bool m_playing;
+	bool m_paused;
+	bool m_loop;
+	/// If the sound ranked high enough for a source in the last update.
+	bool m_voiced;
+	/// The frame played to, kept while the sound is virtual.
+	double m_frame;
+	/// How occluded the sound is from the listener, from zero to one.
+	float m_occlusion;
 
 	Vector3f m_position;
 	Vector3f m_direction;
@@ -66,5 +127,6 @@ private:
 	Audio::Type m_type;
 	float m_gain;
 	float m_pitch;
+	float m_priority;
 };
 }
@@ -15,31 +15,32 @@ namespace acid
 {
 std::shared_ptr<SoundBuffer> SoundBuffer::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<SoundBuffer>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<SoundBuffer>(resource);
-	}
-
-	auto result = std::make_shared<SoundBuffer>("");
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<SoundBuffer>("");
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
-std::shared_ptr<SoundBuffer> SoundBuffer::Create(const std::string &filename)
+std::shared_ptr<SoundBuffer> SoundBuffer::Create(const std::string &filename, const bool &streamed, const bool &compressed)
 {
-	auto temp = SoundBuffer(filename, false);
+	auto temp = SoundBuffer(filename, streamed, compressed, false);
 	Metadata metadata = Metadata();
 	metadata << temp;
 	return Create(metadata);
 }
 
-SoundBuffer::SoundBuffer(std::string filename, const bool &load) :
+SoundBuffer::SoundBuffer(std::string filename, const bool &streamed, const bool &compressed, const bool &load) :
 	m_filename(std::move(filename)),
-	m_buffer(0)
+	m_streamed(streamed),
+	m_compressed(compressed),
+	m_buffer(0),
+	m_format(AL_FORMAT_MONO16),
+	m_channels(0),
+	m_sampleRate(0),
+	m_frameCount(0)
 {
 	if (load)
 	{
@@ -63,139 +64,179 @@ void SoundBuffer::Load()
 
 	if (fileExt == ".wav")
 	{
-		m_buffer = LoadBufferWav(m_filename);
+		LoadWav();
 	}
 	else if (fileExt == ".ogg")
 	{
-		m_buffer = LoadBufferOgg(m_filename);
+		LoadOgg();
 	}
 }
 
-uint32_t SoundBuffer::LoadBufferWav(const std::string &filename)
+void SoundBuffer::LoadWav()
 {
 #if defined(ACID_VERBOSE)
 	auto debugStart = Engine::GetTime();
 #endif
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadView(m_filename);
 
 	if (!fileLoaded)
 	{
-		Log::Error("WAV file could not be loaded: '%s'\n", filename.c_str());
-		return 0;
+		Log::Error("WAV file could not be loaded: '%s'\n", m_filename.c_str());
+		return;
 	}
 
-	std::stringstream file;
-	file << *fileLoaded;
-
-	char chunkId[5] = "\0";
-
-	// Read header.
-	uint32_t size;
-
-	file.read(chunkId, 4);
-	file.read(reinterpret_cast<char *>(&size), 4);
+	// The chunks are read in place from the file view, the samples are passed to OpenAL without being copied.
+	auto data = fileLoaded->GetData();
+	auto size = fileLoaded->GetSize();
 
-	chunkId[4] = '\0';
-	file.read(chunkId, 4);
-
-	chunkId[4] = '\0';
-
-	// Read first chunk header.
-	file.read(chunkId, 4);
-	file.read(reinterpret_cast<char *>(&size), 4);
-
-	chunkId[4] = '\0';
+	auto readChunk = [&](const std::size_t &offset, uint32_t &chunkSize) -> std::string
+	{
+		std::memcpy(&chunkSize, data + offset + 4, 4);
+		return std::string(reinterpret_cast<const char *>(data + offset), 4);
+	};
 
-	// Read first chunk content.
-	int16_t formatTag;
-	int16_t channels;
-	int32_t samplesPerSec;
-	int32_t averageBytesPerSec;
-	int16_t blockAlign;
-	int16_t bitsPerSample;
+	if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0)
+	{
+		Log::Error("WAV file has an invalid header: '%s'\n", m_filename.c_str());
+		return;
+	}
 
-	file.read(reinterpret_cast<char *>(&formatTag), 2);
-	file.read(reinterpret_cast<char *>(&channels), 2);
-	file.read(reinterpret_cast<char *>(&samplesPerSec), 4);
-	file.read(reinterpret_cast<char *>(&averageBytesPerSec), 4);
-	file.read(reinterpret_cast<char *>(&blockAlign), 2);
-	file.read(reinterpret_cast<char *>(&bitsPerSample), 2);
+	int16_t channels = 0;
+	int32_t samplesPerSec = 0;
+	FileView samples;
 
-	if (size > 16)
+	for (std::size_t offset = 12; offset + 8 <= size;)
 	{
-		file.seekg(static_cast<int>(file.tellg()) + (size - 16));
+		uint32_t chunkSize;
+		auto chunkId = readChunk(offset, chunkSize);
+		auto chunkData = offset + 8;
+		chunkSize = static_cast<uint32_t>(std::min<std::size_t>(chunkSize, size - chunkData));
+
+		if (chunkId == "fmt " && chunkSize >= 16)
+		{
+			std::memcpy(&channels, data + chunkData + 2, 2);
+			std::memcpy(&samplesPerSec, data + chunkData + 4, 4);
+		}
+		else if (chunkId == "data")
+		{
+			samples = fileLoaded->GetSubView(chunkData, chunkSize);
+			break;
+		}
+
+		// Chunks are padded to an even size.
+		offset = chunkData + chunkSize + (chunkSize & 1);
 	}
 
-	// Read data chunk header.
-	file.read(chunkId, 4);
-	file.read(reinterpret_cast<char *>(&size), 4);
-
-	chunkId[4] = '\0';
+	if (samples.GetData() == nullptr || samplesPerSec == 0)
+	{
+		Log::Error("WAV file is missing its format or data: '%s'\n", m_filename.c_str());
+		return;
+	}
 
-	std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
-	file.read(reinterpret_cast<char *>(data.get()), size);
+	m_format = (channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+	m_channels = (channels == 2) ? 2 : 1;
+	m_sampleRate = samplesPerSec;
+	m_frameCount = samples.GetSize() / (sizeof(int16_t) * m_channels);
 
-	uint32_t buffer;
-	alGenBuffers(1, &buffer);
-	alBufferData(buffer, (channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, data.get(), size, samplesPerSec);
+	if (m_streamed || m_compressed)
+	{
+		// The samples stay mapped, streams copy a block at a time from them.
+		m_streamData = std::move(samples);
+	}
+	else
+	{
+		alGenBuffers(1, &m_buffer);
+		alBufferData(m_buffer, m_format, samples.GetData(), static_cast<ALsizei>(samples.GetSize()), m_sampleRate);
 
-	Audio::CheckAl(alGetError());
+		Audio::CheckAl(alGetError());
+	}
 
 #if defined(ACID_VERBOSE)
 	auto debugEnd = Engine::GetTime();
-	Log::Out("Sound WAV '%s' loaded in %.3fms\n", filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
+	Log::Out("Sound WAV '%s' loaded in %.3fms\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
 #endif
-	return buffer;
 }
 
-uint32_t SoundBuffer::LoadBufferOgg(const std::string &filename)
+void SoundBuffer::LoadOgg()
 {
 #if defined(ACID_VERBOSE)
 	auto debugStart = Engine::GetTime();
 #endif
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadView(m_filename);
 
 	if (!fileLoaded)
 	{
-		Log::Error("OGG file could not be loaded: '%s'\n", filename.c_str());
-		return 0;
+		Log::Error("OGG file could not be loaded: '%s'\n", m_filename.c_str());
+		return;
 	}
 
-	int32_t channels;
-	int32_t samplesPerSec;
-	int16_t *data;
-	auto size = stb_vorbis_decode_memory(reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size()), &channels, &samplesPerSec, &data);
-
-	if (size == -1)
+	if (m_streamed || m_compressed)
 	{
-		Log::Error("Error reading the OGG '%s', could not find size! The audio could not be loaded.\n", filename.c_str());
+		// Only the headers are read, the audio packets are decoded by each stream as it plays.
+		int32_t error = 0;
+		auto vorbis = stb_vorbis_open_memory(fileLoaded->GetData(), static_cast<int32_t>(fileLoaded->GetSize()), &error, nullptr);
+
+		if (vorbis == nullptr)
+		{
+			Log::Error("Error reading the OGG '%s' header, error %i! The audio could not be loaded.\n", m_filename.c_str(), error);
+			return;
+		}
+
+		auto info = stb_vorbis_get_info(vorbis);
+		m_frameCount = stb_vorbis_stream_length_in_samples(vorbis);
+		stb_vorbis_close(vorbis);
+
+		m_channels = std::min(info.channels, 2);
+		m_sampleRate = static_cast<int32_t>(info.sample_rate);
+		m_streamData = std::move(*fileLoaded);
+	}
+	else
+	{
+		int32_t channels;
+		int32_t samplesPerSec;
+		int16_t *data;
+		auto frames = stb_vorbis_decode_memory(fileLoaded->GetData(), static_cast<int32_t>(fileLoaded->GetSize()), &channels, &samplesPerSec, &data);
+
+		if (frames == -1)
+		{
+			Log::Error("Error reading the OGG '%s', could not find size! The audio could not be loaded.\n", m_filename.c_str());
+			return;
+		}
+
+		// The decoded size is in frames of every channel, and the samples were allocated with malloc.
+		m_channels = (channels == 2) ? 2 : 1;
+		m_sampleRate = samplesPerSec;
+		m_frameCount = static_cast<std::size_t>(frames);
+		alGenBuffers(1, &m_buffer);
+		alBufferData(m_buffer, (channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, data, frames * channels * static_cast<int32_t>(sizeof(int16_t)), samplesPerSec);
+
+		std::free(data);
+		Audio::CheckAl(alGetError());
 	}
 
-	uint32_t buffer;
-	alGenBuffers(1, &buffer);
-	alBufferData(buffer, (channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, data, size, samplesPerSec);
-
-	delete[] data;
-	Audio::CheckAl(alGetError());
+	m_format = (m_channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
 
 #if defined(ACID_VERBOSE)
 	auto debugEnd = Engine::GetTime();
-	Log::Out("Sound OGG '%s' loaded in %.3fms\n", filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
+	Log::Out("Sound OGG '%s' loaded in %.3fms\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
 #endif
-	return buffer;
 }
 
 const Metadata &operator>>(const Metadata &metadata, SoundBuffer &soundBuffer)
 {
 	metadata.GetChild("Filename", soundBuffer.m_filename);
+	metadata.GetChild("Streamed", soundBuffer.m_streamed);
+	metadata.GetChild("Compressed", soundBuffer.m_compressed);
 	return metadata;
 }
 
 Metadata &operator<<(Metadata &metadata, const SoundBuffer &soundBuffer)
 {
 	metadata.SetChild("Filename", soundBuffer.m_filename);
+	metadata.SetChild("Streamed", soundBuffer.m_streamed);
+	metadata.SetChild("Compressed", soundBuffer.m_compressed);
 	return metadata;
 }
 }
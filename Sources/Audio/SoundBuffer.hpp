@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Files/FileView.hpp"
 #include "Maths/Vector3.hpp"
 #include "Resources/Resource.hpp"
 #include "Audio.hpp"
@@ -8,6 +9,9 @@ namespace acid
 {
 /**
  * @brief Resource that represents a sound buffer.
+ * A streamed sound buffer only reads the format of its file when loaded, the file is kept mapped and each playing acid::SoundStream decodes it as it plays.
+ * A compressed sound buffer is also kept as its file, used for the many short clips of sound effects and voices. Each time it is played it is decoded by a stream
+ * with buffers from the acid::SoundCache, which keeps the decoded samples of the most recently played so they are not decoded again.
  */
 class ACID_EXPORT SoundBuffer :
 	public Resource
@@ -23,16 +27,20 @@ public:
 	/**
 	 * Creates a new sound buffer, or finds one with the same values.
 	 * @param filename The file to load the sound buffer from.
+	 * @param streamed If the sound is decoded as it plays instead of being loaded into one buffer, used for long music tracks.
+	 * @param compressed If the sound is kept compressed and decoded each time it is played unless its decoded samples are cached, this is ignored when streamed.
 	 * @return The sound buffer with the requested values.
 	 */
-	static std::shared_ptr<SoundBuffer> Create(const std::string &filename);
+	static std::shared_ptr<SoundBuffer> Create(const std::string &filename, const bool &streamed = false, const bool &compressed = false);
 
 	/**
 	 * Creates a new sound buffer.
 	 * @param filename The file to load the sound buffer from.
+	 * @param streamed If the sound is decoded as it plays instead of being loaded into one buffer.
+	 * @param compressed If the sound is kept compressed and decoded each time it is played.
 	 * @param load If this resource will be loaded immediately, otherwise {@link SoundBuffer#Load} can be called later.
 	 */
-	explicit SoundBuffer(std::string filename, const bool &load = true);
+	explicit SoundBuffer(std::string filename, const bool &streamed = false, const bool &compressed = false, const bool &load = true);
 
 	~SoundBuffer();
 
@@ -40,18 +48,55 @@ public:
 
 	const std::string &GetFilename() const { return m_filename; };
 
+	const bool &IsStreamed() const { return m_streamed; }
+
+	const bool &IsCompressed() const { return m_compressed; }
+
+	/**
+	 * Gets the OpenAL buffer holding the whole sound, zero when streamed or compressed.
+	 * @return The buffer.
+	 */
 	const uint32_t &GetBuffer() const { return m_buffer; }
 
+	/**
+	 * Gets the OpenAL format of the samples, 16 bit mono or stereo.
+	 * @return The format.
+	 */
+	const int32_t &GetFormat() const { return m_format; }
+
+	const int32_t &GetChannels() const { return m_channels; }
+
+	const int32_t &GetSampleRate() const { return m_sampleRate; }
+
+	/**
+	 * Gets the length of the sound in frames, a frame holds one sample of each channel.
+	 * @return The frame count.
+	 */
+	const std::size_t &GetFrameCount() const { return m_frameCount; }
+
+	/**
+	 * Gets the data a stream decodes, the Ogg file or the WAV samples, empty when neither streamed or compressed.
+	 * @return The streamed data.
+	 */
+	const FileView &GetStreamData() const { return m_streamData; }
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, SoundBuffer &soundBuffer);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const SoundBuffer &soundBuffer);
 
 private:
-	static uint32_t LoadBufferWav(const std::string &filename);
+	void LoadWav();
 
-	static uint32_t LoadBufferOgg(const std::string &filename);
+	void LoadOgg();
 
 	std::string m_filename;
+	bool m_streamed;
+	bool m_compressed;
 	uint32_t m_buffer;
+	int32_t m_format;
+	int32_t m_channels;
+	int32_t m_sampleRate;
+	std::size_t m_frameCount;
+	FileView m_streamData;
 };
 }
@@ -0,0 +1,119 @@
+#include "SoundCache.hpp"
+
+#if defined(ACID_BUILD_MACOS)
+#include <OpenAL/al.h>
+#else
+#include <al.h>
+#endif
+#include "Audio.hpp"
+
+namespace acid
+{
+SoundCache::Decoded::Decoded(const int32_t &format, const std::vector<int16_t> &samples, const int32_t &sampleRate) :
+	m_buffer(0),
+	m_size(samples.size() * sizeof(int16_t))
+{
+	alGenBuffers(1, &m_buffer);
+	alBufferData(m_buffer, format, samples.data(), static_cast<ALsizei>(m_size), sampleRate);
+	Audio::CheckAl(alGetError());
+}
+
+SoundCache::Decoded::~Decoded()
+{
+	alDeleteBuffers(1, &m_buffer);
+	Audio::CheckAl(alGetError());
+}
+
+SoundCache::SoundCache(const std::size_t &capacity) :
+	m_capacity(capacity),
+	m_size(0),
+	m_uses(0)
+{
+}
+
+SoundCache::~SoundCache()
+{
+	m_entries.clear();
+
+	alDeleteBuffers(static_cast<ALsizei>(m_pool.size()), m_pool.data());
+	Audio::CheckAl(alGetError());
+}
+
+void SoundCache::AcquireBuffers(uint32_t *buffers, const uint32_t &count)
+{
+	auto pooled = std::min<std::size_t>(count, m_pool.size());
+	std::copy(m_pool.end() - pooled, m_pool.end(), buffers);
+	m_pool.resize(m_pool.size() - pooled);
+
+	if (pooled < count)
+	{
+		alGenBuffers(static_cast<ALsizei>(count - pooled), buffers + pooled);
+		Audio::CheckAl(alGetError());
+	}
+}
+
+void SoundCache::ReleaseBuffers(const uint32_t *buffers, const uint32_t &count)
+{
+	m_pool.insert(m_pool.end(), buffers, buffers + count);
+}
+
+std::shared_ptr<SoundCache::Decoded> SoundCache::Find(const std::string &filename)
+{
+	auto it = m_entries.find(filename);
+
+	if (it == m_entries.end())
+	{
+		return nullptr;
+	}
+
+	it->second.m_used = ++m_uses;
+	return it->second.m_decoded;
+}
+
+void SoundCache::Insert(const std::string &filename, const int32_t &format, const std::vector<int16_t> &samples, const int32_t &sampleRate)
+{
+	if (!IsCacheable(samples.size() * sizeof(int16_t)))
+	{
+		return;
+	}
+
+	// Two sounds playing the same file finish decoding it separately, the samples are only kept once.
+	auto &entry = m_entries[filename];
+	entry.m_used = ++m_uses;
+
+	if (entry.m_decoded != nullptr)
+	{
+		return;
+	}
+
+	entry.m_decoded = std::make_shared<Decoded>(format, samples, sampleRate);
+	m_size += entry.m_decoded->GetSize();
+	Evict();
+}
+
+void SoundCache::SetCapacity(const std::size_t &capacity)
+{
+	m_capacity = capacity;
+	Evict();
+}
+
+void SoundCache::Evict()
+{
+	// Sources still playing a dropped sound keep its buffer until they stop.
+	while (m_size > m_capacity && !m_entries.empty())
+	{
+		auto leastRecent = m_entries.begin();
+
+		for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+		{
+			if (it->second.m_used < leastRecent->second.m_used)
+			{
+				leastRecent = it;
+			}
+		}
+
+		m_size -= leastRecent->second.m_decoded->GetSize();
+		m_entries.erase(leastRecent);
+	}
+}
+}
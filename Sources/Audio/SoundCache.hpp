@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+/**
+ * @brief Holds the OpenAL buffers shared by every acid::SoundStream, and the decoded samples of the most recently played compressed sounds.
+ * Streams take their buffers from the pool and return them once they are destroyed, so playing a compressed sound does not create any buffers.
+ * A compressed sound that was decoded from its start to its end has its samples kept in a buffer, so the next time it is played it is not decoded again,
+ * the least recently played are dropped once the decoded samples are larger than the capacity.
+ */
+class ACID_EXPORT SoundCache :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief The decoded samples of a sound, the buffer is deleted once it has been dropped from the cache and no source plays it.
+	 */
+	class ACID_EXPORT Decoded :
+		public NonCopyable
+	{
+	public:
+		Decoded(const int32_t &format, const std::vector<int16_t> &samples, const int32_t &sampleRate);
+
+		~Decoded();
+
+		const uint32_t &GetBuffer() const { return m_buffer; }
+
+		/**
+		 * Gets the size of the samples in bytes.
+		 * @return The size.
+		 */
+		const std::size_t &GetSize() const { return m_size; }
+
+	private:
+		uint32_t m_buffer;
+		std::size_t m_size;
+	};
+
+	/**
+	 * Creates the cache.
+	 * @param capacity The most bytes of decoded samples kept.
+	 */
+	explicit SoundCache(const std::size_t &capacity = 32 * 1024 * 1024);
+
+	~SoundCache();
+
+	/**
+	 * Takes buffers from the pool, buffers are created if the pool is empty.
+	 * @param buffers The buffers taken.
+	 * @param count The number of buffers.
+	 */
+	void AcquireBuffers(uint32_t *buffers, const uint32_t &count);
+
+	/**
+	 * Returns buffers to the pool, they must not be queued on a source.
+	 * @param buffers The buffers returned.
+	 * @param count The number of buffers.
+	 */
+	void ReleaseBuffers(const uint32_t *buffers, const uint32_t &count);
+
+	/**
+	 * Finds the decoded samples of a sound, and marks them as the most recently played.
+	 * @param filename The file of the sound.
+	 * @return The decoded samples, or nullptr if they are not cached.
+	 */
+	std::shared_ptr<Decoded> Find(const std::string &filename);
+
+	/**
+	 * Gets if decoded samples of a size would be kept, a sound larger than an eighth of the capacity is decoded every time it is played.
+	 * @param size The size of the samples in bytes.
+	 * @return If the samples can be cached.
+	 */
+	bool IsCacheable(const std::size_t &size) const { return size != 0 && size <= m_capacity / 8; }
+
+	/**
+	 * Keeps the decoded samples of a sound, dropping the least recently played until the cache is within its capacity.
+	 * @param filename The file of the sound.
+	 * @param format The OpenAL format of the samples.
+	 * @param samples The samples of every frame of the sound.
+	 * @param sampleRate The sample rate.
+	 */
+	void Insert(const std::string &filename, const int32_t &format, const std::vector<int16_t> &samples, const int32_t &sampleRate);
+
+	const std::size_t &GetCapacity() const { return m_capacity; }
+
+	/**
+	 * Sets the most bytes of decoded samples kept, the least recently played are dropped if the cache is larger.
+	 * @param capacity The capacity.
+	 */
+	void SetCapacity(const std::size_t &capacity);
+
+	/**
+	 * Gets the bytes of decoded samples kept.
+	 * @return The size.
+	 */
+	const std::size_t &GetSize() const { return m_size; }
+
+	std::size_t GetPooledCount() const { return m_pool.size(); }
+
+private:
+	class Entry
+	{
+	public:
+		std::shared_ptr<Decoded> m_decoded;
+		/// When the sound was last played, counted in finds.
+		uint64_t m_used = 0;
+	};
+
+	void Evict();
+
+	std::vector<uint32_t> m_pool;
+	std::map<std::string, Entry> m_entries;
+	std::size_t m_capacity;
+	std::size_t m_size;
+	uint64_t m_uses;
+};
+}
@@ -0,0 +1,300 @@
+#include "SoundStream.hpp"
+
+#if defined(ACID_BUILD_MACOS)
+#include <OpenAL/al.h>
+#else
+#include <al.h>
+#endif
+#include "Files/FileSystem.hpp"
+#include "Helpers/String.hpp"
+#define STB_VORBIS_HEADER_ONLY
+#include "stb_vorbis.c"
+
+namespace acid
+{
+SoundStream::SoundStream(std::shared_ptr<SoundBuffer> soundBuffer) :
+	m_soundBuffer(std::move(soundBuffer)),
+	m_buffers{},
+	m_vorbis(nullptr),
+	m_frame(0),
+	m_loop(false),
+	m_ended(true),
+	m_decodedStart(0),
+	m_decodedFrames(0),
+	m_recording(false)
+{
+	Audio::Get()->GetSoundCache().AcquireBuffers(m_buffers.data(), BufferCount);
+	m_free.assign(m_buffers.begin(), m_buffers.end());
+
+	// WAV samples are copied from the mapped data chunk, anything else is a Ogg file decoded by its own decoder.
+	if (String::Lowercase(FileSystem::FileSuffix(m_soundBuffer->GetFilename())) == ".ogg" && !m_soundBuffer->GetStreamData().IsEmpty())
+	{
+		const auto &data = m_soundBuffer->GetStreamData();
+		int32_t error = 0;
+		m_vorbis = stb_vorbis_open_memory(data.GetData(), static_cast<int32_t>(data.GetSize()), &error, nullptr);
+
+		if (m_vorbis == nullptr)
+		{
+			Log::Error("Error opening the OGG stream '%s', error %i\n", m_soundBuffer->GetFilename().c_str(), error);
+		}
+	}
+
+	m_decoded.resize(BlockFrames * std::max(m_soundBuffer->GetChannels(), 1));
+}
+
+SoundStream::~SoundStream()
+{
+	Engine::Get()->GetThreadPool().Wait(m_decoding);
+
+	if (m_vorbis != nullptr)
+	{
+		stb_vorbis_close(m_vorbis);
+	}
+
+	// The buffers were unqueued when the stream was stopped.
+	if (auto audio = Audio::Get(); audio != nullptr)
+	{
+		audio->GetSoundCache().ReleaseBuffers(m_buffers.data(), BufferCount);
+	}
+	else
+	{
+		alDeleteBuffers(BufferCount, m_buffers.data());
+		Audio::CheckAl(alGetError());
+	}
+}
+
+void SoundStream::Start(const uint32_t &source, const bool &loop, const std::size_t &frame)
+{
+	Stop(source);
+
+	m_loop = loop;
+	Seek(frame);
+
+	// A compressed sound is only kept whole when it is decoded from its start, and is small enough to be cached.
+	auto channels = std::max(m_soundBuffer->GetChannels(), 1);
+	auto size = m_soundBuffer->GetFrameCount() * channels * sizeof(int16_t);
+	m_recording = m_soundBuffer->IsCompressed() && !m_soundBuffer->IsStreamed() && m_frame == 0 && Audio::Get()->GetSoundCache().IsCacheable(size);
+
+	if (m_recording)
+	{
+		m_recorded.reserve(m_soundBuffer->GetFrameCount() * channels);
+	}
+
+	// Looping is done by rewinding the decoder, a looping source would replay the queued blocks.
+	alSourcei(source, AL_LOOPING, AL_FALSE);
+
+	// Only the first block is decoded here, so starting many sounds at once does not stall the update.
+	Decode();
+
+	if (m_decodedFrames != 0)
+	{
+		auto buffer = m_free.back();
+		m_free.pop_back();
+		Queue(source, buffer);
+	}
+
+	Audio::CheckAl(alGetError());
+	DecodeAhead();
+}
+
+void SoundStream::Stop(const uint32_t &source)
+{
+	Engine::Get()->GetThreadPool().Wait(m_decoding);
+	Cache();
+
+	// A stopped source with no buffer set has every queued buffer removed.
+	alSourceStop(source);
+	alSourcei(source, AL_BUFFER, 0);
+	Audio::CheckAl(alGetError());
+
+	m_ended = true;
+	m_decodedFrames = 0;
+	m_queued.clear();
+	m_free.assign(m_buffers.begin(), m_buffers.end());
+
+	// A sound stopped before it reached its end is not cached.
+	m_recording = false;
+	m_recorded.clear();
+	m_recorded.shrink_to_fit();
+}
+
+void SoundStream::Update(const uint32_t &source)
+{
+	// The decoded block and the decoder belong to the job until it has finished.
+	if (!m_decoding.IsDone())
+	{
+		return;
+	}
+
+	Cache();
+
+	ALint processed = 0;
+	ALint state = AL_STOPPED;
+	alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	// A source that played every queued block before the next was decoded stops, it is refilled here and played again.
+	auto starved = state == AL_STOPPED && m_decodedFrames != 0;
+
+	while (m_decodedFrames != 0)
+	{
+		uint32_t buffer;
+
+		// Buffers not yet queued since the stream started are used before those the source has played.
+		if (!m_free.empty())
+		{
+			buffer = m_free.back();
+			m_free.pop_back();
+		}
+		else if (processed > 0)
+		{
+			alSourceUnqueueBuffers(source, 1, &buffer);
+			m_queued.pop_front();
+			processed--;
+		}
+		else
+		{
+			break;
+		}
+
+		Queue(source, buffer);
+
+		if (!starved)
+		{
+			break;
+		}
+
+		Decode();
+	}
+
+	if (starved)
+	{
+		alSourcePlay(source);
+	}
+
+	Audio::CheckAl(alGetError());
+	DecodeAhead();
+}
+
+std::size_t SoundStream::GetFrame(const uint32_t &source) const
+{
+	if (m_queued.empty() || m_soundBuffer->GetFrameCount() == 0)
+	{
+		return 0;
+	}
+
+	// The sample offset of a streaming source counts from the start of the oldest buffer still queued.
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+	return (m_queued.front() + static_cast<std::size_t>(offset)) % m_soundBuffer->GetFrameCount();
+}
+
+void SoundStream::Decode()
+{
+	auto channels = std::max(m_soundBuffer->GetChannels(), 1);
+	uint32_t frames = 0;
+	auto rewound = false;
+	m_decodedStart = m_frame;
+
+	while (frames < BlockFrames && !m_ended)
+	{
+		uint32_t read = 0;
+		auto samples = m_decoded.data() + frames * channels;
+
+		if (m_vorbis != nullptr)
+		{
+			read = static_cast<uint32_t>(stb_vorbis_get_samples_short_interleaved(m_vorbis, channels, samples, static_cast<int32_t>((BlockFrames - frames) * channels)));
+			m_frame += read;
+		}
+		else
+		{
+			const auto &data = m_soundBuffer->GetStreamData();
+			auto totalFrames = data.GetSize() / (sizeof(int16_t) * channels);
+			read = static_cast<uint32_t>(std::min<std::size_t>(BlockFrames - frames, totalFrames - std::min(m_frame, totalFrames)));
+			std::memcpy(samples, data.GetData() + m_frame * sizeof(int16_t) * channels, read * sizeof(int16_t) * channels);
+			m_frame += read;
+		}
+
+		frames += read;
+
+		if (m_recording)
+		{
+			m_recorded.insert(m_recorded.end(), samples, samples + read * channels);
+		}
+
+		if (read == 0)
+		{
+			// Every frame from the start has been recorded, the samples are cached on the next update.
+			m_recording = false;
+
+			// A sound with no samples is not rewound forever.
+			if (!m_loop || rewound)
+			{
+				m_ended = true;
+				break;
+			}
+
+			Seek(0);
+			rewound = true;
+		}
+		else
+		{
+			rewound = false;
+		}
+	}
+
+	m_decodedFrames = frames;
+}
+
+void SoundStream::DecodeAhead()
+{
+	if (m_ended || m_decodedFrames != 0)
+	{
+		return;
+	}
+
+	Engine::Get()->GetThreadPool().Dispatch([this]()
+	{
+		Decode();
+	}, &m_decoding);
+}
+
+void SoundStream::Queue(const uint32_t &source, const uint32_t &buffer)
+{
+	auto size = m_decodedFrames * std::max(m_soundBuffer->GetChannels(), 1) * sizeof(int16_t);
+	alBufferData(buffer, m_soundBuffer->GetFormat(), m_decoded.data(), static_cast<ALsizei>(size), m_soundBuffer->GetSampleRate());
+	alSourceQueueBuffers(source, 1, &buffer);
+	m_queued.emplace_back(m_decodedStart);
+	m_decodedFrames = 0;
+}
+
+void SoundStream::Cache()
+{
+	if (m_recording || m_recorded.empty())
+	{
+		return;
+	}
+
+	Audio::Get()->GetSoundCache().Insert(m_soundBuffer->GetFilename(), m_soundBuffer->GetFormat(), m_recorded, m_soundBuffer->GetSampleRate());
+	m_recorded.clear();
+	m_recorded.shrink_to_fit();
+}
+
+void SoundStream::Seek(const std::size_t &frame)
+{
+	m_frame = frame < m_soundBuffer->GetFrameCount() ? frame : 0;
+	m_ended = false;
+
+	if (m_vorbis != nullptr)
+	{
+		if (m_frame == 0)
+		{
+			stb_vorbis_seek_start(m_vorbis);
+		}
+		else
+		{
+			stb_vorbis_seek(m_vorbis, static_cast<uint32_t>(m_frame));
+		}
+	}
+}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <deque>
+#include "Helpers/NonCopyable.hpp"
+#include "Helpers/ThreadPool.hpp"
+#include "SoundBuffer.hpp"
+
+struct stb_vorbis;
+
+namespace acid
+{
+/**
+ * @brief Plays a streamed or compressed sound buffer on a source, blocks of samples are decoded on the engines job system into a ring of OpenAL buffers queued on the source.
+ * Only the blocks queued and the one decoded ahead are held in memory, however long the sound is. The buffers are taken from the acid::SoundCache.
+ * A compressed sound played from its start is also kept whole as it is decoded, once it reaches the end the samples are given to the cache.
+ */
+class ACID_EXPORT SoundStream :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new stream of a sound buffer.
+	 * @param soundBuffer The streamed sound buffer.
+	 */
+	explicit SoundStream(std::shared_ptr<SoundBuffer> soundBuffer);
+
+	~SoundStream();
+
+	/**
+	 * Seeks to a frame of the sound and queues the first block on a source, it is decoded on the calling thread so the sound can be played immediately.
+	 * The following blocks are decoded by jobs and queued by {@link SoundStream#Update}.
+	 * @param source The source, it must be stopped.
+	 * @param loop If the sound continues from the start when it ends.
+	 * @param frame The frame to start from.
+	 */
+	void Start(const uint32_t &source, const bool &loop, const std::size_t &frame = 0);
+
+	/**
+	 * Stops the source and unqueues every buffer of the stream from it.
+	 * @param source The source.
+	 */
+	void Stop(const uint32_t &source);
+
+	/**
+	 * Queues the block decoded ahead in a free buffer or in place of a buffer the source has played, and starts decoding the next block.
+	 * If the source ran out of blocks it is refilled and played again, this is called every update while the sound plays.
+	 * @param source The source.
+	 */
+	void Update(const uint32_t &source);
+
+	/**
+	 * Gets the frame of the sound the source is playing.
+	 * @param source The source.
+	 * @return The frame.
+	 */
+	std::size_t GetFrame(const uint32_t &source) const;
+
+	/**
+	 * Gets if every block of a sound that does not loop has been queued, the sound has finished once the source stops.
+	 * @return If the stream has ended.
+	 */
+	bool IsEnded() const { return m_ended && m_decodedFrames == 0; }
+
+	/// Number of buffers queued on the source.
+	static constexpr uint32_t BufferCount = 4;
+	/// Frames of samples in each buffer, about a third of a second at 48kHz.
+	static constexpr uint32_t BlockFrames = 16384;
+
+private:
+	/**
+	 * Decodes the next block into the decoded samples, the decoder is rewound at the end when looping.
+	 */
+	void Decode();
+
+	void DecodeAhead();
+
+	void Queue(const uint32_t &source, const uint32_t &buffer);
+
+	void Seek(const std::size_t &frame);
+
+	/**
+	 * Gives the samples of a compressed sound to the cache once every frame of it has been decoded.
+	 */
+	void Cache();
+
+	std::shared_ptr<SoundBuffer> m_soundBuffer;
+	std::array<uint32_t, BufferCount> m_buffers;
+	/// The buffers not queued on the source.
+	std::vector<uint32_t> m_free;
+
+	stb_vorbis *m_vorbis;
+	/// The next frame decoded.
+	std::size_t m_frame;
+	bool m_loop;
+	/// If the decoder reached the end of a sound that does not loop.
+	bool m_ended;
+
+	/// The first frame of each block queued on the source, oldest first.
+	std::deque<std::size_t> m_queued;
+
+	std::vector<int16_t> m_decoded;
+	std::size_t m_decodedStart;
+	uint32_t m_decodedFrames;
+	ThreadPool::Counter m_decoding;
+
+	/// If every block decoded is added to the recorded samples, until the end of the sound is reached.
+	bool m_recording;
+	std::vector<int16_t> m_recorded;
+};
+}
@@ -0,0 +1,231 @@
+#include "VoicePool.hpp"
+
+#if defined(ACID_BUILD_MACOS)
+#include <OpenAL/al.h>
+#include <OpenAL/alc.h>
+#else
+#include <al.h>
+#include <alc.h>
+#endif
+#include "Physics/CollisionObject.hpp"
+#include "Scenes/Entity.hpp"
+#include "Scenes/Scenes.hpp"
+#include "Sound.hpp"
+
+namespace acid
+{
+VoicePool::VoicePool(const uint32_t &sourceCount) :
+	m_audibleGain(0.001f)
+{
+	for (uint32_t i = 0; i < sourceCount; i++)
+	{
+		uint32_t source;
+		alGenSources(1, &source);
+
+		if (alGetError() != AL_NO_ERROR)
+		{
+			Log::Warning("Audio device only has %i sources\n", i);
+			break;
+		}
+
+		m_sources.emplace_back(source);
+	}
+
+	m_free = m_sources;
+}
+
+VoicePool::~VoicePool()
+{
+	for (auto &sound : m_sounds)
+	{
+		Release(sound);
+		sound->m_playing = false;
+	}
+
+	alDeleteSources(static_cast<ALsizei>(m_sources.size()), m_sources.data());
+	Audio::CheckAl(alGetError());
+}
+
+void VoicePool::Add(Sound *sound)
+{
+	if (std::find(m_sounds.begin(), m_sounds.end(), sound) != m_sounds.end())
+	{
+		return;
+	}
+
+	m_sounds.emplace_back(sound);
+	sound->m_playing = true;
+
+	// A free source is taken immediately so the sound starts when played, the next update ranks it with the others.
+	if (!m_free.empty())
+	{
+		sound->Realize(m_free.back());
+		m_free.pop_back();
+	}
+}
+
+void VoicePool::Remove(Sound *sound)
+{
+	auto it = std::find(m_sounds.begin(), m_sounds.end(), sound);
+
+	if (it == m_sounds.end())
+	{
+		return;
+	}
+
+	Release(sound);
+	sound->m_playing = false;
+	m_sounds.erase(it);
+}
+
+void VoicePool::Update(const Time &delta)
+{
+	// Sounds that finished are removed, virtual sounds advance as if they were playing.
+	for (auto it = m_sounds.begin(); it != m_sounds.end();)
+	{
+		if ((*it)->Advance(delta))
+		{
+			++it;
+			continue;
+		}
+
+		Release(*it);
+		(*it)->m_playing = false;
+		(*it)->m_frame = 0.0;
+		it = m_sounds.erase(it);
+	}
+
+	Vector3f listener;
+	alGetListener3f(AL_POSITION, &listener.m_x, &listener.m_y, &listener.m_z);
+
+	auto audio = Audio::Get();
+	m_ranked.clear();
+
+	for (auto &sound : m_sounds)
+	{
+		sound->m_voiced = false;
+		auto audible = sound->GetAudibleGain(listener) * (1.0f - sound->m_occlusion * (1.0f - OcclusionGain));
+
+		if (audible >= m_audibleGain)
+		{
+			m_ranked.emplace_back(sound->m_priority * audible * (sound->m_source != 0 ? Hysteresis : 1.0f), sound);
+		}
+	}
+
+	std::sort(m_ranked.begin(), m_ranked.end(), [](const auto &a, const auto &b)
+	{
+		return a.first > b.first;
+	});
+
+	// Sounds are voiced from the highest ranked until the sources run out, skipping sounds whos bus is at its voice limit.
+	std::map<Audio::Type, uint32_t> busVoices;
+	std::size_t voiced = 0;
+
+	for (auto &[rank, sound] : m_ranked)
+	{
+		if (voiced == m_sources.size())
+		{
+			break;
+		}
+
+		auto limit = audio->GetVoiceLimit(sound->m_type);
+		auto &voices = busVoices[sound->m_type];
+
+		if (limit != 0 && voices >= limit)
+		{
+			continue;
+		}
+
+		sound->m_voiced = true;
+		voices++;
+		voiced++;
+	}
+
+	// Sources are taken from the sounds that lost their rank before they are given to the sounds that gained it.
+	for (auto &sound : m_sounds)
+	{
+		if (sound->m_source != 0 && !sound->m_voiced)
+		{
+			Release(sound);
+		}
+	}
+
+	for (auto &sound : m_sounds)
+	{
+		if (sound->m_source == 0 && sound->m_voiced)
+		{
+			sound->Realize(m_free.back());
+			m_free.pop_back();
+		}
+	}
+
+	UpdateOcclusion(listener, delta);
+
+	// Changes to every source are applied together once the context is processed again.
+	auto &effects = audio->GetEffects();
+	auto context = alcGetCurrentContext();
+	alcSuspendContext(context);
+
+	for (auto &sound : m_sounds)
+	{
+		if (sound->m_source != 0)
+		{
+			sound->UpdateSource();
+
+			auto gainHf = 1.0f - sound->m_occlusion * (1.0f - OcclusionGainHf);
+			effects.SetDirect(sound->m_source, 1.0f - sound->m_occlusion * (1.0f - OcclusionGain), gainHf);
+			effects.SetSend(sound->m_source, audio->GetReverbSend(sound->m_type), gainHf);
+		}
+	}
+
+	alcProcessContext(context);
+	Audio::CheckAl(alGetError());
+}
+
+void VoicePool::UpdateOcclusion(const Vector3f &listener, const Time &delta)
+{
+	auto physics = Scenes::Get()->GetPhysics();
+
+	if (physics == nullptr)
+	{
+		return;
+	}
+
+	m_rayQueries.clear();
+	m_raySounds.clear();
+
+	// Only sounds with a source are raycast, a virtual sound keeps the occlusion it had when it lost its source.
+	for (auto &sound : m_sounds)
+	{
+		if (sound->m_source != 0)
+		{
+			m_rayQueries.emplace_back(RayQuery{ listener, sound->m_position });
+			m_raySounds.emplace_back(sound);
+		}
+	}
+
+	m_rayResults.resize(m_rayQueries.size());
+	physics->Raytest(m_rayQueries.data(), m_rayResults.data(), m_rayQueries.size());
+
+	auto fade = std::min(delta.AsSeconds() * OcclusionRate, 1.0f);
+
+	for (std::size_t i = 0; i < m_raySounds.size(); i++)
+	{
+		auto sound = m_raySounds[i];
+		const auto &result = m_rayResults[i];
+
+		// The object the sound is attached to does not occlude it.
+		auto occluded = result.HasHit() && (result.GetCollisionObject() == nullptr || sound->GetParent() == nullptr ||
+			result.GetCollisionObject()->GetParent() != sound->GetParent());
+		sound->m_occlusion += ((occluded ? 1.0f : 0.0f) - sound->m_occlusion) * fade;
+	}
+}
+
+void VoicePool::Release(Sound *sound)
+{
+	if (sound->m_source != 0)
+	{
+		m_free.emplace_back(sound->Virtualize());
+	}
+}
+}
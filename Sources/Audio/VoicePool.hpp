@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Time.hpp"
+#include "Scenes/ScenePhysics.hpp"
+
+namespace acid
+{
+class Sound;
+
+/**
+ * @brief A fixed pool of OpenAL sources shared by every playing acid::Sound.
+ * Each update the playing sounds are ranked by their priority times the gain they are heard at, the highest ranked are given a source
+ * and the rest are virtual, they keep their playback position without a source and are given one again once they rank high enough.
+ * Sounds quieter than the audible gain are always virtual, and only sounds with a source have their position set on OpenAL.
+ * The sounds of each type are limited to the voice limit of their bus, and sounds with a source are raycast against the scenes physics in one batch
+ * every update, a sound behind a object is filtered as occluded.
+ */
+class ACID_EXPORT VoicePool :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates the pool, fewer sources are created if the device runs out of them.
+	 * @param sourceCount The most sources created.
+	 */
+	explicit VoicePool(const uint32_t &sourceCount = 32);
+
+	~VoicePool();
+
+	/**
+	 * Adds a sound that started playing, it is given a source immediately if one is free.
+	 * @param sound The sound.
+	 */
+	void Add(Sound *sound);
+
+	/**
+	 * Removes a sound that stopped playing, its source is stopped and returned to the pool.
+	 * @param sound The sound.
+	 */
+	void Remove(Sound *sound);
+
+	/**
+	 * Advances virtual sounds, removes sounds that finished, gives the sources to the highest ranked sounds and sets their positions.
+	 * @param delta The time since the last update.
+	 */
+	void Update(const Time &delta);
+
+	std::size_t GetSourceCount() const { return m_sources.size(); }
+
+	std::size_t GetPlayingCount() const { return m_sounds.size(); }
+
+	/**
+	 * Gets the number of playing sounds that have a source.
+	 * @return The number of sounds that are not virtual.
+	 */
+	std::size_t GetRealCount() const { return m_sources.size() - m_free.size(); }
+
+	const float &GetAudibleGain() const { return m_audibleGain; }
+
+	/**
+	 * Sets the gain at the listener below which a sound is virtual even if a source is free.
+	 * @param audibleGain The audible gain.
+	 */
+	void SetAudibleGain(const float &audibleGain) { m_audibleGain = audibleGain; }
+
+	/// How much a sound with a source is favoured over one without, so sounds ranked about the same do not swap sources every update.
+	static constexpr float Hysteresis = 1.25f;
+
+	/// The gain of a fully occluded sound, and the gain of its high frequencies.
+	static constexpr float OcclusionGain = 0.5f;
+	static constexpr float OcclusionGainHf = 0.1f;
+	/// How fast occlusion fades in and out per second, so sounds are not cut off as objects pass in front of them.
+	static constexpr float OcclusionRate = 8.0f;
+
+private:
+	void Release(Sound *sound);
+
+	void UpdateOcclusion(const Vector3f &listener, const Time &delta);
+
+	std::vector<uint32_t> m_sources;
+	std::vector<uint32_t> m_free;
+	std::vector<Sound *> m_sounds;
+	std::vector<std::pair<float, Sound *>> m_ranked;
+	std::vector<RayQuery> m_rayQueries;
+	std::vector<Raycast> m_rayResults;
+	std::vector<Sound *> m_raySounds;
+	float m_audibleGain;
+};
+}
@@ -3,19 +3,28 @@ set(_temp_acid_headers
 		Acid.hpp
 		Animations/Animation/Animation.hpp
 		Animations/Animation/AnimationLoader.hpp
+		Animations/Animation/CompressedAnimation.hpp
 		Animations/Animator.hpp
+		Animations/BakedAnimation.hpp
 		Animations/Geometry/GeometryLoader.hpp
 		Animations/Geometry/VertexAnimated.hpp
 		Animations/Joint/Joint.hpp
 		Animations/Joint/JointTransform.hpp
 		Animations/Keyframe/Keyframe.hpp
 		Animations/MeshAnimated.hpp
+		Animations/MeshBaked.hpp
 		Animations/Skeleton/SkeletonLoader.hpp
 		Animations/Skin/SkinLoader.hpp
 		Animations/Skin/VertexWeights.hpp
 		Audio/Audio.hpp
+		Audio/AudioEffects.hpp
+		Audio/ReverbZone.hpp
 		Audio/Sound.hpp
+		Audio/SoundCache.hpp
 		Audio/SoundBuffer.hpp
+		Audio/SoundStream.hpp
+		Audio/VoicePool.hpp
+		Devices/InputEvent.hpp
 		Devices/Instance.hpp
 		Devices/Joysticks.hpp
 		Devices/Keyboard.hpp
@@ -31,14 +40,21 @@ set(_temp_acid_headers
 		Emitters/EmitterPoint.hpp
 		Emitters/EmitterSphere.hpp
 		Engine/Engine.hpp
+		Engine/FrameAllocator.hpp
 		Engine/Game.hpp
 		Engine/Log.hpp
+		Engine/MemoryTracker.hpp
 		Engine/Module.hpp
 		Engine/ModuleHolder.hpp
+		Engine/Profiler.hpp
+		Files/AsyncReader.hpp
 		Files/File.hpp
 		Files/Files.hpp
 		Files/FileSystem.hpp
+		Files/FileView.hpp
 		Files/FileWatcher.hpp
+		Files/Pack.hpp
+		Fonts/FontAtlas.hpp
 		Fonts/FontMetafile.hpp
 		Fonts/FontType.hpp
 		Fonts/Geometry.hpp
@@ -52,11 +68,13 @@ set(_temp_acid_headers
 		Gizmos/SubrenderGizmos.hpp
 		Guis/Gui.hpp
 		Guis/SubrenderGuis.hpp
+		Helpers/AtomicRingBuffer.hpp
 		Helpers/ConstExpr.hpp
 		Helpers/Delegate.hpp
 		Helpers/EnumClass.hpp
 		Helpers/Future.hpp
 		Helpers/NonCopyable.hpp
+		Helpers/RadixSort.hpp
 		Helpers/Reference.hpp
 		Helpers/RingBuffer.hpp
 		Helpers/String.hpp
@@ -75,6 +93,7 @@ set(_temp_acid_headers
 		Inputs/InputDelay.hpp
 		Lights/Fog.hpp
 		Lights/Light.hpp
+		Lights/LightSelection.hpp
 		Materials/Material.hpp
 		Materials/MaterialDefault.hpp
 		Materials/PipelineMaterial.hpp
@@ -87,6 +106,7 @@ set(_temp_acid_headers
 		Maths/Matrix4.hpp
 		Maths/Noise/Noise.hpp
 		Maths/Quaternion.hpp
+		Maths/Simd.hpp
 		Maths/Time.hpp
 		Maths/Timer.hpp
 		Maths/Transform.hpp
@@ -100,11 +120,18 @@ set(_temp_acid_headers
 		Maths/Visual/DriverLinear.hpp
 		Maths/Visual/DriverSinwave.hpp
 		Maths/Visual/DriverSlide.hpp
+		Maths/Visual/Tweens.hpp
+		Meshes/DepthPyramid.hpp
+		Meshes/ImpostorType.hpp
 		Meshes/Mesh.hpp
 		Meshes/MeshRender.hpp
+		Meshes/SubrenderDepth.hpp
+		Meshes/SubrenderImpostors.hpp
 		Meshes/SubrenderMeshes.hpp
+		Models/Gltf/GltfFile.hpp
 		Models/Gltf/ModelGltf.hpp
 		Models/Model.hpp
+		Models/ModelOptimizer.hpp
 		Models/ModelRegister.hpp
 		Models/Obj/ModelObj.hpp
 		Models/Shapes/MeshPattern.hpp
@@ -115,22 +142,34 @@ set(_temp_acid_headers
 		Models/Shapes/ModelRectangle.hpp
 		Models/Shapes/ModelSphere.hpp
 		Models/VertexDefault.hpp
+		Models/VertexQuantized.hpp
 		Network/Ftp/Ftp.hpp
 		Network/Ftp/FtpDataChannel.hpp
 		Network/Ftp/FtpResponse.hpp
 		Network/Ftp/FtpResponseDirectory.hpp
 		Network/Ftp/FtpResponseListing.hpp
+		Network/Ftp/FtpTransferPool.hpp
 		Network/Http/Http.hpp
 		Network/Http/HttpRequest.hpp
 		Network/Http/HttpResponse.hpp
+		Network/HostResolver.hpp
 		Network/IpAddress.hpp
+		Network/Lz4.hpp
 		Network/Packet.hpp
+		Network/Replication/EntityState.hpp
+		Network/Replication/Replicated.hpp
+		Network/Replication/ReplicationClient.hpp
+		Network/Replication/ReplicationServer.hpp
 		Network/Socket.hpp
+		Network/SocketPoller.hpp
 		Network/SocketSelector.hpp
 		Network/Tcp/TcpListener.hpp
 		Network/Tcp/TcpSocket.hpp
+		Network/Udp/UdpConnection.hpp
 		Network/Udp/UdpSocket.hpp
 		Particles/Particle.hpp
+		Particles/ParticleList.hpp
+		Particles/ParticlePool.hpp
 		Particles/Particles.hpp
 		Particles/ParticleSystem.hpp
 		Particles/ParticleType.hpp
@@ -143,14 +182,19 @@ set(_temp_acid_headers
 		Physics/Colliders/ColliderCylinder.hpp
 		Physics/Colliders/ColliderHeightfield.hpp
 		Physics/Colliders/ColliderSphere.hpp
+		Physics/Colliders/ColliderShape.hpp
+		Physics/Colliders/HullShape.hpp
 		Physics/CollisionObject.hpp
 		Physics/Force.hpp
 		Physics/Frustum.hpp
+		Physics/FrustumCuller.hpp
 		Physics/KinematicCharacter.hpp
 		Physics/Ray.hpp
 		Physics/Rigidbody.hpp
+		Plugins/Plugins.hpp
 		Post/Deferred/SubrenderDeferred.hpp
 		Post/Filters/FilterBlur.hpp
+		Post/Filters/FilterChain.hpp
 		Post/Filters/FilterCrt.hpp
 		Post/Filters/FilterDarken.hpp
 		Post/Filters/FilterDefault.hpp
@@ -164,61 +208,99 @@ set(_temp_acid_headers
 		Post/Filters/FilterPixel.hpp
 		Post/Filters/FilterSepia.hpp
 		Post/Filters/FilterSsao.hpp
+		Post/Filters/FilterTaa.hpp
 		Post/Filters/FilterTiltshift.hpp
 		Post/Filters/FilterTone.hpp
+		Post/Filters/FilterUpscale.hpp
 		Post/Filters/FilterVignette.hpp
 		Post/Filters/FilterWobble.hpp
+		Post/Pipelines/BlurPyramid.hpp
 		Post/Pipelines/PipelineBlur.hpp
+		Post/Pipelines/PipelineShadingRate.hpp
 		Post/PostFilter.hpp
 		Post/PostPipeline.hpp
+		Graphics/Buffers/AccelerationStructure.hpp
 		Graphics/Buffers/Buffer.hpp
+		Graphics/Buffers/GeometryHeap.hpp
+		Graphics/Buffers/IndirectBuffer.hpp
 		Graphics/Buffers/InstanceBuffer.hpp
 		Graphics/Buffers/PushHandler.hpp
 		Graphics/Buffers/StorageBuffer.hpp
 		Graphics/Buffers/StorageHandler.hpp
 		Graphics/Buffers/UniformBuffer.hpp
 		Graphics/Buffers/UniformHandler.hpp
+		Graphics/Buffers/UniformRing.hpp
 		Graphics/Commands/CommandBuffer.hpp
 		Graphics/Commands/CommandPool.hpp
+		Graphics/Commands/TimelineSemaphore.hpp
+		Graphics/Commands/TimestampQueries.hpp
+		Graphics/Commands/UploadContext.hpp
+		Graphics/Descriptors/BindlessDescriptors.hpp
 		Graphics/Descriptors/Descriptor.hpp
+		Graphics/Descriptors/DescriptorAllocator.hpp
 		Graphics/Descriptors/DescriptorSet.hpp
 		Graphics/Descriptors/DescriptorsHandler.hpp
 		Graphics/Images/Image.hpp
 		Graphics/Images/Image2d.hpp
 		Graphics/Images/ImageCube.hpp
 		Graphics/Images/ImageDepth.hpp
+		Graphics/Images/ImageKtx.hpp
+		Graphics/Images/ImageReadback.hpp
+		Graphics/Images/ImageStreamer.hpp
+		Graphics/Images/MipmapGenerator.hpp
+		Graphics/Images/SamplerCache.hpp
+		Graphics/Images/VirtualTexture.hpp
+		Graphics/Memory/MemoryAllocator.hpp
 		Graphics/Pipelines/Pipeline.hpp
 		Graphics/Pipelines/PipelineCompute.hpp
 		Graphics/Pipelines/PipelineGraphics.hpp
 		Graphics/Pipelines/Shader.hpp
+		Graphics/Pipelines/ShaderReloader.hpp
+		Graphics/Pipelines/UniformId.hpp
+		Graphics/DynamicResolution.hpp
 		Graphics/Graphics.hpp
 		Graphics/Renderer.hpp
 		Graphics/Renderpass/Framebuffers.hpp
+		Graphics/Renderpass/RenderGraph.hpp
 		Graphics/Renderpass/Renderpass.hpp
 		Graphics/Renderpass/Swapchain.hpp
 		Graphics/RenderStage.hpp
 		Graphics/Subrender.hpp
 		Graphics/SubrenderHolder.hpp
 		Resources/Resource.hpp
+		Resources/ResourceRequest.hpp
 		Resources/Resources.hpp
 		Scenes/Camera.hpp
 		Scenes/Component.hpp
 		Scenes/ComponentRegister.hpp
 		Scenes/Entity.hpp
+		Scenes/EntityHandle.hpp
+		Scenes/EntityPicker.hpp
 		Scenes/EntityPrefab.hpp
 		Scenes/Scene.hpp
 		Scenes/ScenePhysics.hpp
 		Scenes/Scenes.hpp
+		Scenes/SceneStreamer.hpp
 		Scenes/SceneStructure.hpp
+		Serialized/Binary/Binary.hpp
 		Serialized/Json/Json.hpp
 		Serialized/Metadata.hpp
+		Serialized/MetadataArena.hpp
+		Serialized/MetadataWriter.hpp
 		Serialized/Xml/Xml.hpp
 		Serialized/Yaml/Yaml.hpp
+		Shadows/ShadowAccelerationStructure.hpp
+		Shadows/ShadowAtlas.hpp
 		Shadows/ShadowBox.hpp
 		Shadows/ShadowRender.hpp
 		Shadows/Shadows.hpp
 		Shadows/SubrenderShadows.hpp
 		Skyboxes/MaterialSkybox.hpp
+		Terrains/Heightmap.hpp
+		Terrains/SubrenderTerrains.hpp
+		Terrains/Terrain.hpp
+		Telemetry/Histogram.hpp
+		Telemetry/Telemetry.hpp
 		Timers/Timers.hpp
 		Uis/Inputs/UiColourWheel.hpp
 		Uis/Inputs/UiInputBoolean.hpp
@@ -229,6 +311,8 @@ set(_temp_acid_headers
 		Uis/Inputs/UiInputSlider.hpp
 		Uis/Inputs/UiInputText.hpp
 		Uis/UiBound.hpp
+		Uis/UiGrid.hpp
+		Uis/UiList.hpp
 		Uis/UiObject.hpp
 		Uis/UiPanel.hpp
 		Uis/Uis.hpp
@@ -240,18 +324,26 @@ set(_temp_acid_sources
 		StdAfx.cpp
 		Animations/Animation/Animation.cpp
 		Animations/Animation/AnimationLoader.cpp
+		Animations/Animation/CompressedAnimation.cpp
 		Animations/Animator.cpp
+		Animations/BakedAnimation.cpp
 		Animations/Geometry/GeometryLoader.cpp
 		Animations/Joint/Joint.cpp
 		Animations/Joint/JointTransform.cpp
 		Animations/Keyframe/Keyframe.cpp
 		Animations/MeshAnimated.cpp
+		Animations/MeshBaked.cpp
 		Animations/Skeleton/SkeletonLoader.cpp
 		Animations/Skin/SkinLoader.cpp
 		Animations/Skin/VertexWeights.cpp
 		Audio/Audio.cpp
+		Audio/AudioEffects.cpp
+		Audio/ReverbZone.cpp
 		Audio/Sound.cpp
+		Audio/SoundCache.cpp
 		Audio/SoundBuffer.cpp
+		Audio/SoundStream.cpp
+		Audio/VoicePool.cpp
 		Devices/Instance.cpp
 		Devices/Joysticks.cpp
 		Devices/Keyboard.cpp
@@ -261,17 +353,25 @@ set(_temp_acid_sources
 		Devices/PhysicalDevice.cpp
 		Devices/Surface.cpp
 		Devices/Window.cpp
+		Emitters/Emitter.cpp
 		Emitters/EmitterCircle.cpp
 		Emitters/EmitterLine.cpp
 		Emitters/EmitterPoint.cpp
 		Emitters/EmitterSphere.cpp
 		Engine/Engine.cpp
+		Engine/FrameAllocator.cpp
 		Engine/Log.cpp
+		Engine/MemoryTracker.cpp
 		Engine/ModuleHolder.cpp
+		Engine/Profiler.cpp
+		Files/AsyncReader.cpp
 		Files/File.cpp
 		Files/Files.cpp
 		Files/FileSystem.cpp
+		Files/FileView.cpp
 		Files/FileWatcher.cpp
+		Files/Pack.cpp
+		Fonts/FontAtlas.cpp
 		Fonts/FontMetafile.cpp
 		Fonts/FontType.cpp
 		Fonts/Geometry.cpp
@@ -298,6 +398,7 @@ set(_temp_acid_sources
 		Inputs/InputDelay.cpp
 		Lights/Fog.cpp
 		Lights/Light.cpp
+		Lights/LightSelection.cpp
 		Materials/MaterialDefault.cpp
 		Materials/PipelineMaterial.cpp
 		Maths/Colour.cpp
@@ -314,11 +415,18 @@ set(_temp_acid_sources
 		Maths/Vector2.cpp
 		Maths/Vector3.cpp
 		Maths/Vector4.cpp
+		Maths/Visual/Tweens.cpp
+		Meshes/DepthPyramid.cpp
+		Meshes/ImpostorType.cpp
 		Meshes/Mesh.cpp
 		Meshes/MeshRender.cpp
+		Meshes/SubrenderDepth.cpp
+		Meshes/SubrenderImpostors.cpp
 		Meshes/SubrenderMeshes.cpp
+		Models/Gltf/GltfFile.cpp
 		Models/Gltf/ModelGltf.cpp
 		Models/Model.cpp
+		Models/ModelOptimizer.cpp
 		Models/ModelRegister.cpp
 		Models/Obj/ModelObj.cpp
 		Models/Shapes/MeshPattern.cpp
@@ -333,17 +441,28 @@ set(_temp_acid_sources
 		Network/Ftp/FtpResponse.cpp
 		Network/Ftp/FtpResponseDirectory.cpp
 		Network/Ftp/FtpResponseListing.cpp
+		Network/Ftp/FtpTransferPool.cpp
 		Network/Http/Http.cpp
 		Network/Http/HttpRequest.cpp
 		Network/Http/HttpResponse.cpp
+		Network/HostResolver.cpp
 		Network/IpAddress.cpp
+		Network/Lz4.cpp
 		Network/Packet.cpp
+		Network/Replication/EntityState.cpp
+		Network/Replication/Replicated.cpp
+		Network/Replication/ReplicationClient.cpp
+		Network/Replication/ReplicationServer.cpp
 		Network/Socket.cpp
+		Network/SocketPoller.cpp
 		Network/SocketSelector.cpp
 		Network/Tcp/TcpListener.cpp
 		Network/Tcp/TcpSocket.cpp
+		Network/Udp/UdpConnection.cpp
 		Network/Udp/UdpSocket.cpp
 		Particles/Particle.cpp
+		Particles/ParticleList.cpp
+		Particles/ParticlePool.cpp
 		Particles/Particles.cpp
 		Particles/ParticleSystem.cpp
 		Particles/ParticleType.cpp
@@ -356,14 +475,19 @@ set(_temp_acid_sources
 		Physics/Colliders/ColliderCylinder.cpp
 		Physics/Colliders/ColliderHeightfield.cpp
 		Physics/Colliders/ColliderSphere.cpp
+		Physics/Colliders/ColliderShape.cpp
+		Physics/Colliders/HullShape.cpp
 		Physics/CollisionObject.cpp
 		Physics/Force.cpp
 		Physics/Frustum.cpp
+		Physics/FrustumCuller.cpp
 		Physics/KinematicCharacter.cpp
 		Physics/Ray.cpp
 		Physics/Rigidbody.cpp
+		Plugins/Plugins.cpp
 		Post/Deferred/SubrenderDeferred.cpp
 		Post/Filters/FilterBlur.cpp
+		Post/Filters/FilterChain.cpp
 		Post/Filters/FilterCrt.cpp
 		Post/Filters/FilterDarken.cpp
 		Post/Filters/FilterDefault.cpp
@@ -377,52 +501,89 @@ set(_temp_acid_sources
 		Post/Filters/FilterPixel.cpp
 		Post/Filters/FilterSepia.cpp
 		Post/Filters/FilterSsao.cpp
+		Post/Filters/FilterTaa.cpp
 		Post/Filters/FilterTiltshift.cpp
 		Post/Filters/FilterTone.cpp
+		Post/Filters/FilterUpscale.cpp
 		Post/Filters/FilterVignette.cpp
 		Post/Filters/FilterWobble.cpp
+		Post/Pipelines/BlurPyramid.cpp
 		Post/Pipelines/PipelineBlur.cpp
+		Post/Pipelines/PipelineShadingRate.cpp
 		Post/PostFilter.cpp
+		Graphics/Buffers/AccelerationStructure.cpp
 		Graphics/Buffers/Buffer.cpp
+		Graphics/Buffers/GeometryHeap.cpp
+		Graphics/Buffers/IndirectBuffer.cpp
 		Graphics/Buffers/InstanceBuffer.cpp
 		Graphics/Buffers/PushHandler.cpp
 		Graphics/Buffers/StorageBuffer.cpp
 		Graphics/Buffers/StorageHandler.cpp
 		Graphics/Buffers/UniformBuffer.cpp
 		Graphics/Buffers/UniformHandler.cpp
+		Graphics/Buffers/UniformRing.cpp
 		Graphics/Commands/CommandBuffer.cpp
 		Graphics/Commands/CommandPool.cpp
+		Graphics/Commands/TimelineSemaphore.cpp
+		Graphics/Commands/TimestampQueries.cpp
+		Graphics/Commands/UploadContext.cpp
+		Graphics/Descriptors/BindlessDescriptors.cpp
+		Graphics/Descriptors/DescriptorAllocator.cpp
 		Graphics/Descriptors/DescriptorSet.cpp
 		Graphics/Descriptors/DescriptorsHandler.cpp
 		Graphics/Images/Image.cpp
 		Graphics/Images/Image2d.cpp
 		Graphics/Images/ImageCube.cpp
 		Graphics/Images/ImageDepth.cpp
+		Graphics/Images/ImageKtx.cpp
+		Graphics/Images/ImageReadback.cpp
+		Graphics/Images/ImageStreamer.cpp
+		Graphics/Images/MipmapGenerator.cpp
+		Graphics/Images/SamplerCache.cpp
+		Graphics/Images/VirtualTexture.cpp
+		Graphics/Memory/MemoryAllocator.cpp
 		Graphics/Pipelines/PipelineCompute.cpp
 		Graphics/Pipelines/PipelineGraphics.cpp
 		Graphics/Pipelines/Shader.cpp
+		Graphics/Pipelines/ShaderReloader.cpp
+		Graphics/DynamicResolution.cpp
 		Graphics/Graphics.cpp
 		Graphics/Renderpass/Framebuffers.cpp
+		Graphics/Renderpass/RenderGraph.cpp
 		Graphics/Renderpass/Renderpass.cpp
 		Graphics/Renderpass/Swapchain.cpp
 		Graphics/RenderStage.cpp
 		Graphics/SubrenderHolder.cpp
+		Resources/ResourceRequest.cpp
 		Resources/Resources.cpp
+		Scenes/Camera.cpp
 		Scenes/ComponentRegister.cpp
 		Scenes/Entity.cpp
+		Scenes/EntityPicker.cpp
 		Scenes/EntityPrefab.cpp
 		Scenes/ScenePhysics.cpp
 		Scenes/Scenes.cpp
+		Scenes/SceneStreamer.cpp
 		Scenes/SceneStructure.cpp
+		Serialized/Binary/Binary.cpp
 		Serialized/Json/Json.cpp
 		Serialized/Metadata.cpp
+		Serialized/MetadataArena.cpp
+		Serialized/MetadataWriter.cpp
 		Serialized/Xml/Xml.cpp
 		Serialized/Yaml/Yaml.cpp
+		Shadows/ShadowAccelerationStructure.cpp
+		Shadows/ShadowAtlas.cpp
 		Shadows/ShadowBox.cpp
 		Shadows/ShadowRender.cpp
 		Shadows/Shadows.cpp
 		Shadows/SubrenderShadows.cpp
 		Skyboxes/MaterialSkybox.cpp
+		Terrains/Heightmap.cpp
+		Terrains/SubrenderTerrains.cpp
+		Terrains/Terrain.cpp
+		Telemetry/Histogram.cpp
+		Telemetry/Telemetry.cpp
 		Timers/Timers.cpp
 		Uis/Inputs/UiColourWheel.cpp
 		Uis/Inputs/UiInputBoolean.cpp
@@ -433,6 +594,8 @@ set(_temp_acid_sources
 		Uis/Inputs/UiInputSlider.cpp
 		Uis/Inputs/UiInputText.cpp
 		Uis/UiBound.cpp
+		Uis/UiGrid.cpp
+		Uis/UiList.cpp
 		Uis/UiObject.cpp
 		Uis/UiPanel.cpp
 		Uis/Uis.cpp
@@ -440,26 +603,60 @@ set(_temp_acid_sources
 		Uis/UiSection.cpp
 		Uis/UiStartLogo.cpp
 		)
-add_precompiled_header(Acid
-		StdAfx.hpp
-		SOURCE_CXX
-		StdAfx.cpp
-		FORCEINCLUDE
+# The server library is built from the directories that need no GPU, audio device or window,
+# except for the files that still need a model loaded to the GPU and the header including everything
+set(_temp_acid_server_directories Engine Files Helpers Maths Network Physics Resources Scenes Serialized Telemetry Timers)
+set(_temp_acid_server_excluded
+		Acid.hpp
+		Physics/Colliders/ColliderConvexHull.hpp
+		Physics/Colliders/ColliderConvexHull.cpp
+		Physics/Colliders/HullShape.hpp
+		Physics/Colliders/HullShape.cpp
 		)
-
-# Sets all headers as PUBLIC sources for Acid
-# The BUILD/INSTALL interface generator expressions are for the EXPORT command
-# Otherwise it wouldn't know where to look for them
-foreach(_acid_header IN LISTS _temp_acid_headers)
-	target_sources(Acid PUBLIC
-			$<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/${_acid_header}>
-			$<INSTALL_INTERFACE:${CMAKE_INSTALL_INCLUDEDIR}/${PROJECT_NAME}/${_acid_header}>
-			)
+set(_temp_acid_server_headers)
+set(_temp_acid_server_sources)
+foreach(_acid_list IN ITEMS headers sources)
+	foreach(_acid_file IN LISTS _temp_acid_${_acid_list})
+		string(REGEX MATCH "^[^/]+" _acid_directory "${_acid_file}")
+		list(FIND _temp_acid_server_directories "${_acid_directory}" _acid_directory_index)
+		list(FIND _temp_acid_server_excluded "${_acid_file}" _acid_excluded_index)
+		# Files outside of a directory, such as StdAfx, are in every library
+		if((_acid_directory_index GREATER -1 OR _acid_directory STREQUAL _acid_file) AND _acid_excluded_index EQUAL -1)
+			list(APPEND _temp_acid_server_${_acid_list} "${_acid_file}")
+		endif()
+	endforeach()
 endforeach()
-# Sets all sources (cpp) as PRIVATE sources for Acid
-# An INSTALL_INTERFACE isn't needed, as cpp files aren't installed
-foreach(_acid_source IN LISTS _temp_acid_sources)
-	target_sources(Acid PRIVATE
-			$<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/${_acid_source}>
+
+foreach(_acid_target IN LISTS _acid_targets)
+	if(_acid_target STREQUAL "AcidServer")
+		set(_acid_target_headers ${_temp_acid_server_headers})
+		set(_acid_target_sources ${_temp_acid_server_sources})
+	else()
+		set(_acid_target_headers ${_temp_acid_headers})
+		set(_acid_target_sources ${_temp_acid_sources})
+	endif()
+
+	add_precompiled_header(${_acid_target}
+			StdAfx.hpp
+			SOURCE_CXX
+			StdAfx.cpp
+			FORCEINCLUDE
 			)
+
+	# Sets all headers as PUBLIC sources for the target
+	# The BUILD/INSTALL interface generator expressions are for the EXPORT command
+	# Otherwise it wouldn't know where to look for them
+	foreach(_acid_header IN LISTS _acid_target_headers)
+		target_sources(${_acid_target} PUBLIC
+				$<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/${_acid_header}>
+				$<INSTALL_INTERFACE:${CMAKE_INSTALL_INCLUDEDIR}/${PROJECT_NAME}/${_acid_header}>
+				)
+	endforeach()
+	# Sets all sources (cpp) as PRIVATE sources for the target
+	# An INSTALL_INTERFACE isn't needed, as cpp files aren't installed
+	foreach(_acid_source IN LISTS _acid_target_sources)
+		target_sources(${_acid_target} PRIVATE
+				$<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/${_acid_source}>
+				)
+	endforeach()
 endforeach()
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Maths/Time.hpp"
+#include "Maths/Vector2.hpp"
+#include "Window.hpp"
+
+namespace acid
+{
+/**
+ * @brief A timestamped input from a device, queued by the device callbacks and read by the device module in its update.
+ * Events are kept in the order they happened, so inputs shorter than a update, such as a key pressed and released between two updates, are never lost.
+ */
+class ACID_EXPORT InputEvent
+{
+public:
+	enum class Type :
+		uint8_t
+	{
+		Key, Char, MouseButton, MousePosition, MouseScroll, JoystickButton, JoystickAxis, JoystickHat
+	};
+
+	/// The type of event.
+	Type m_type = Type::Key;
+	/// When the event was received, in engine time.
+	Time m_time;
+	/// The joystick of a joystick event.
+	uint32_t m_port = 0;
+	/// The key, character, mouse button, or the joystick button, axis or hat index.
+	int32_t m_code = 0;
+	/// The action of a key or button.
+	InputAction m_action = InputAction::Release;
+	BitMask<InputMod> m_mods;
+	/// The direction bits of a joystick hat, as acid::JoystickHat.
+	int32_t m_hat = 0;
+	/// The mouse position or scroll offset, or the joystick axis value in x.
+	Vector2f m_value;
+};
+}
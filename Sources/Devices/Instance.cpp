@@ -1,5 +1,6 @@
 #include "Instance.hpp"
 
+#include "Engine/Engine.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Window.hpp"
 
@@ -55,6 +56,171 @@ void Instance::FvkCmdPushDescriptorSetKHR(VkDevice device, VkCommandBuffer comma
 	}
 }
 
+VkResult Instance::FvkWaitForPresentKHR(VkDevice device, VkSwapchainKHR swapchain, uint64_t presentId, uint64_t timeout)
+{
+#if defined(VK_KHR_present_wait)
+	auto func = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device, "vkWaitForPresentKHR"));
+
+	if (func != nullptr)
+	{
+		return func(device, swapchain, presentId, timeout);
+	}
+#endif
+
+	return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+
+void Instance::FvkCmdDrawMeshTasksEXT(VkDevice device, VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+#if defined(VK_EXT_mesh_shader)
+	auto func = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(vkGetDeviceProcAddr(device, "vkCmdDrawMeshTasksEXT"));
+
+	if (func != nullptr)
+	{
+		func(commandBuffer, groupCountX, groupCountY, groupCountZ);
+	}
+#endif
+}
+
+VkResult Instance::FvkGetSemaphoreCounterValueKHR(VkDevice device, VkSemaphore semaphore, uint64_t *pValue)
+{
+#if defined(VK_KHR_timeline_semaphore)
+	auto func = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+
+	if (func != nullptr)
+	{
+		return func(device, semaphore, pValue);
+	}
+#endif
+
+	return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+
+VkResult Instance::FvkWaitSemaphoreKHR(VkDevice device, VkSemaphore semaphore, uint64_t value, uint64_t timeout)
+{
+#if defined(VK_KHR_timeline_semaphore)
+	auto func = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+
+	if (func != nullptr)
+	{
+		VkSemaphoreWaitInfoKHR semaphoreWaitInfo = {};
+		semaphoreWaitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+		semaphoreWaitInfo.semaphoreCount = 1;
+		semaphoreWaitInfo.pSemaphores = &semaphore;
+		semaphoreWaitInfo.pValues = &value;
+		return func(device, &semaphoreWaitInfo, timeout);
+	}
+#endif
+
+	return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+
+VkDeviceAddress Instance::FvkGetBufferDeviceAddressKHR(VkDevice device, VkBuffer buffer)
+{
+	auto func = reinterpret_cast<PFN_vkGetBufferDeviceAddressKHR>(vkGetDeviceProcAddr(device, "vkGetBufferDeviceAddressKHR"));
+
+	if (func != nullptr)
+	{
+		VkBufferDeviceAddressInfoKHR bufferDeviceAddressInfo = {};
+		bufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
+		bufferDeviceAddressInfo.buffer = buffer;
+		return func(device, &bufferDeviceAddressInfo);
+	}
+
+	return 0;
+}
+
+VkResult Instance::FvkCreateAccelerationStructureKHR(VkDevice device, const VkAccelerationStructureCreateInfoKHR *pCreateInfo, const VkAllocationCallbacks *pAllocator,
+	VkAccelerationStructureKHR *pAccelerationStructure)
+{
+	auto func = reinterpret_cast<PFN_vkCreateAccelerationStructureKHR>(vkGetDeviceProcAddr(device, "vkCreateAccelerationStructureKHR"));
+
+	if (func != nullptr)
+	{
+		return func(device, pCreateInfo, pAllocator, pAccelerationStructure);
+	}
+
+	return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+
+void Instance::FvkDestroyAccelerationStructureKHR(VkDevice device, VkAccelerationStructureKHR accelerationStructure, const VkAllocationCallbacks *pAllocator)
+{
+	auto func = reinterpret_cast<PFN_vkDestroyAccelerationStructureKHR>(vkGetDeviceProcAddr(device, "vkDestroyAccelerationStructureKHR"));
+
+	if (func != nullptr)
+	{
+		func(device, accelerationStructure, pAllocator);
+	}
+}
+
+VkDeviceAddress Instance::FvkGetAccelerationStructureDeviceAddressKHR(VkDevice device, VkAccelerationStructureKHR accelerationStructure)
+{
+	auto func = reinterpret_cast<PFN_vkGetAccelerationStructureDeviceAddressKHR>(vkGetDeviceProcAddr(device, "vkGetAccelerationStructureDeviceAddressKHR"));
+
+	if (func != nullptr)
+	{
+		VkAccelerationStructureDeviceAddressInfoKHR deviceAddressInfo = {};
+		deviceAddressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
+		deviceAddressInfo.accelerationStructure = accelerationStructure;
+		return func(device, &deviceAddressInfo);
+	}
+
+	return 0;
+}
+
+void Instance::FvkGetAccelerationStructureBuildSizesKHR(VkDevice device, const VkAccelerationStructureBuildGeometryInfoKHR *pBuildInfo, const uint32_t *pMaxPrimitiveCounts,
+	VkAccelerationStructureBuildSizesInfoKHR *pSizeInfo)
+{
+	auto func = reinterpret_cast<PFN_vkGetAccelerationStructureBuildSizesKHR>(vkGetDeviceProcAddr(device, "vkGetAccelerationStructureBuildSizesKHR"));
+
+	if (func != nullptr)
+	{
+		func(device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, pBuildInfo, pMaxPrimitiveCounts, pSizeInfo);
+	}
+}
+
+void Instance::FvkCmdBuildAccelerationStructuresKHR(VkDevice device, VkCommandBuffer commandBuffer, uint32_t infoCount,
+	const VkAccelerationStructureBuildGeometryInfoKHR *pInfos, const VkAccelerationStructureBuildRangeInfoKHR *const *ppBuildRangeInfos)
+{
+	auto func = reinterpret_cast<PFN_vkCmdBuildAccelerationStructuresKHR>(vkGetDeviceProcAddr(device, "vkCmdBuildAccelerationStructuresKHR"));
+
+	if (func != nullptr)
+	{
+		func(commandBuffer, infoCount, pInfos, ppBuildRangeInfos);
+	}
+}
+
+#if defined(VK_KHR_create_renderpass2)
+VkResult Instance::FvkCreateRenderPass2KHR(VkDevice device, const VkRenderPassCreateInfo2KHR *pCreateInfo, const VkAllocationCallbacks *pAllocator,
+	VkRenderPass *pRenderPass)
+{
+	auto func = reinterpret_cast<PFN_vkCreateRenderPass2KHR>(vkGetDeviceProcAddr(device, "vkCreateRenderPass2KHR"));
+
+	if (func != nullptr)
+	{
+		return func(device, pCreateInfo, pAllocator, pRenderPass);
+	}
+
+	return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+#endif
+
+VkResult Instance::FvkCreateHeadlessSurfaceEXT(VkInstance instance, VkSurfaceKHR *pSurface)
+{
+#if defined(VK_EXT_headless_surface)
+	auto func = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+
+	if (func != nullptr)
+	{
+		VkHeadlessSurfaceCreateInfoEXT headlessSurfaceCreateInfo = {};
+		headlessSurfaceCreateInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+		return func(instance, &headlessSurfaceCreateInfo, nullptr, pSurface);
+	}
+#endif
+
+	return VK_ERROR_EXTENSION_NOT_PRESENT;
+}
+
 uint32_t Instance::FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties *deviceMemoryProperties, const VkMemoryRequirements *memoryRequirements,
 	const VkMemoryPropertyFlags &requiredProperties)
 {
@@ -74,6 +240,7 @@ uint32_t Instance::FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties *d
 }
 
 Instance::Instance() :
+	m_headlessSurface(false),
 	m_debugReportCallback(VK_NULL_HANDLE),
 	m_instance(VK_NULL_HANDLE)
 {
@@ -133,12 +300,40 @@ void Instance::SetupLayers()
 void Instance::SetupExtensions()
 {
 	// Sets up the extensions.
-	auto instanceExtensions = Window::Get()->GetInstanceExtensions();
+	if (Engine::Get()->HasModule<Window>())
+	{
+		auto instanceExtensions = Window::Get()->GetInstanceExtensions();
 
-	for (uint32_t i = 0; i < instanceExtensions.second; i++)
+		for (uint32_t i = 0; i < instanceExtensions.second; i++)
+		{
+			m_instanceExtensions.emplace_back(instanceExtensions.first[i]);
+		}
+	}
+#if defined(VK_EXT_headless_surface)
+	else if (Engine::Get()->GetConfig().m_headlessSurface)
 	{
-		m_instanceExtensions.emplace_back(instanceExtensions.first[i]);
+		// Without a window the headless surface is optional, when the driver has no support frames are rendered to offscreen swapchain images.
+		uint32_t extensionPropertyCount = 0;
+		vkEnumerateInstanceExtensionProperties(nullptr, &extensionPropertyCount, nullptr);
+		std::vector<VkExtensionProperties> extensionProperties(extensionPropertyCount);
+		vkEnumerateInstanceExtensionProperties(nullptr, &extensionPropertyCount, extensionProperties.data());
+
+		m_headlessSurface = std::any_of(extensionProperties.begin(), extensionProperties.end(), [](const VkExtensionProperties &properties)
+		{
+			return std::strcmp(properties.extensionName, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME) == 0;
+		});
+
+		if (m_headlessSurface)
+		{
+			m_instanceExtensions.emplace_back(VK_KHR_SURFACE_EXTENSION_NAME);
+			m_instanceExtensions.emplace_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+		}
+		else
+		{
+			Log::Warning("Vulkan headless surfaces are not supported, rendering offscreen\n");
+		}
 	}
+#endif
 
 	for (const auto &instanceExtension : InstanceExtensions)
 	{
@@ -27,6 +27,36 @@ public:
 	static void FvkCmdPushDescriptorSetKHR(VkDevice device, VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t set,
 		uint32_t descriptorWriteCount, const VkWriteDescriptorSet *pDescriptorWrites);
 
+	static VkResult FvkWaitForPresentKHR(VkDevice device, VkSwapchainKHR swapchain, uint64_t presentId, uint64_t timeout);
+
+	static void FvkCmdDrawMeshTasksEXT(VkDevice device, VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+
+	static VkResult FvkGetSemaphoreCounterValueKHR(VkDevice device, VkSemaphore semaphore, uint64_t *pValue);
+
+	static VkResult FvkWaitSemaphoreKHR(VkDevice device, VkSemaphore semaphore, uint64_t value, uint64_t timeout);
+
+	static VkDeviceAddress FvkGetBufferDeviceAddressKHR(VkDevice device, VkBuffer buffer);
+
+	static VkResult FvkCreateAccelerationStructureKHR(VkDevice device, const VkAccelerationStructureCreateInfoKHR *pCreateInfo, const VkAllocationCallbacks *pAllocator,
+		VkAccelerationStructureKHR *pAccelerationStructure);
+
+	static void FvkDestroyAccelerationStructureKHR(VkDevice device, VkAccelerationStructureKHR accelerationStructure, const VkAllocationCallbacks *pAllocator);
+
+	static VkDeviceAddress FvkGetAccelerationStructureDeviceAddressKHR(VkDevice device, VkAccelerationStructureKHR accelerationStructure);
+
+	static void FvkGetAccelerationStructureBuildSizesKHR(VkDevice device, const VkAccelerationStructureBuildGeometryInfoKHR *pBuildInfo, const uint32_t *pMaxPrimitiveCounts,
+		VkAccelerationStructureBuildSizesInfoKHR *pSizeInfo);
+
+	static void FvkCmdBuildAccelerationStructuresKHR(VkDevice device, VkCommandBuffer commandBuffer, uint32_t infoCount,
+		const VkAccelerationStructureBuildGeometryInfoKHR *pInfos, const VkAccelerationStructureBuildRangeInfoKHR *const *ppBuildRangeInfos);
+
+	static VkResult FvkCreateHeadlessSurfaceEXT(VkInstance instance, VkSurfaceKHR *pSurface);
+
+#if defined(VK_KHR_create_renderpass2)
+	static VkResult FvkCreateRenderPass2KHR(VkDevice device, const VkRenderPassCreateInfo2KHR *pCreateInfo, const VkAllocationCallbacks *pAllocator,
+		VkRenderPass *pRenderPass);
+#endif
+
 	static uint32_t FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties *deviceMemoryProperties, const VkMemoryRequirements *memoryRequirements,
 		const VkMemoryPropertyFlags &requiredProperties);
 
@@ -40,6 +70,12 @@ public:
 
 	const VkInstance &GetInstance() const { return m_instance; }
 
+	/**
+	 * Gets if the instance was created to make a headless surface, used by headless engines that asked for one when the driver supports it.
+	 * @return If surfaces are created headless.
+	 */
+	bool IsHeadlessSurface() const { return m_headlessSurface; }
+
 private:
 	friend class Graphics;
 
@@ -57,6 +93,8 @@ private:
 	std::vector<const char *> m_instanceExtensions;
 	std::vector<const char *> m_deviceExtensions;
 
+	bool m_headlessSurface;
+
 	VkDebugReportCallbackEXT m_debugReportCallback;
 	VkInstance m_instance;
 };
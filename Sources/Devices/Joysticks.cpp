@@ -40,6 +40,19 @@ Joysticks::Joysticks()
 
 void Joysticks::Update()
 {
+	m_events.clear();
+	auto time = Engine::GetTime();
+
+	auto addEvent = [this, &time](const InputEvent::Type &type, const uint32_t &port, const uint32_t &code)
+	{
+		auto &event = m_events.emplace_back();
+		event.m_type = type;
+		event.m_time = time;
+		event.m_port = port;
+		event.m_code = static_cast<int32_t>(code);
+		return &event;
+	};
+
 	for (auto &[port, joystick] : m_connected)
 	{
 		int32_t axeCount = 0;
@@ -51,6 +64,7 @@ void Joysticks::Update()
 			if (joystick.m_axes[i] != axes[i])
 			{
 				joystick.m_axes[i] = axes[i];
+				addEvent(InputEvent::Type::JoystickAxis, port, i)->m_value.m_x = axes[i];
 				m_onAxis(port, i, joystick.m_axes[i]);
 			}
 		}
@@ -68,6 +82,7 @@ void Joysticks::Update()
 			else if (joystick.m_buttons[i] != static_cast<InputAction>(buttons[i]))
 			{
 				joystick.m_buttons[i] = static_cast<InputAction>(buttons[i]);
+				addEvent(InputEvent::Type::JoystickButton, port, i)->m_action = joystick.m_buttons[i];
 				m_onButton(port, i, joystick.m_buttons[i]);
 			}
 		}
@@ -81,6 +96,7 @@ void Joysticks::Update()
 			if (joystick.m_hats[i] != MakeBitMask<JoystickHat>(hats[i]))
 			{
 				joystick.m_hats[i] = MakeBitMask<JoystickHat>(hats[i]);
+				addEvent(InputEvent::Type::JoystickHat, port, i)->m_hat = hats[i];
 				m_onHat(port, i, joystick.m_hats[i]);
 			}
 		}
@@ -3,6 +3,7 @@
 #include "Devices/Window.hpp"
 #include "Engine/Engine.hpp"
 #include "Helpers/Delegate.hpp"
+#include "InputEvent.hpp"
 
 namespace acid
 {
@@ -16,6 +17,7 @@ ENABLE_BITMASK_OPERATORS(JoystickHat)
 
 /**
  * @brief Module used for the creation, updating and destruction of the joysticks.
+ * Joysticks have no callbacks, so their state is polled each update and every change is read as a timestamped event.
  */
 class ACID_EXPORT Joysticks :
 	public Module
@@ -90,6 +92,12 @@ public:
 	 */
 	BitMask<JoystickHat> GetHat(const uint32_t &port, const uint32_t &hat) const;
 
+	/**
+	 * Gets the events read in the last update, in the order they were polled.
+	 * @return The events.
+	 */
+	const std::vector<InputEvent> &GetEvents() const { return m_events; }
+
 	/**
 	 * Called when a joystick has been connected or disconnected.
 	 * @return The delegate.
@@ -126,6 +134,7 @@ private:
 	std::optional<JoystickImpl> GetJoystick(const uint32_t &port) const;
 
 	std::map<uint32_t, JoystickImpl> m_connected;
+	std::vector<InputEvent> m_events;
 	Delegate<void(uint32_t, bool)> m_onConnect;
 	Delegate<void(uint32_t, uint32_t, InputAction)> m_onButton;
 	Delegate<void(uint32_t, uint32_t, float)> m_onAxis;
@@ -6,15 +6,26 @@ namespace acid
 {
 void CallbackKey(GLFWwindow *window, int32_t key, int32_t scancode, int32_t action, int32_t mods)
 {
-	Keyboard::Get()->m_onKey(static_cast<Key>(key), static_cast<InputAction>(action), MakeBitMask<InputMod>(mods));
+	InputEvent event;
+	event.m_type = InputEvent::Type::Key;
+	event.m_time = Engine::GetTime();
+	event.m_code = key;
+	event.m_action = static_cast<InputAction>(action);
+	event.m_mods = MakeBitMask<InputMod>(mods);
+	Keyboard::Get()->Queue(event);
 }
 
 void CallbackChar(GLFWwindow *window, uint32_t codepoint)
 {
-	Keyboard::Get()->m_onChar(static_cast<char>(codepoint));
+	InputEvent event;
+	event.m_type = InputEvent::Type::Char;
+	event.m_time = Engine::GetTime();
+	event.m_code = static_cast<int32_t>(codepoint);
+	Keyboard::Get()->Queue(event);
 }
 
-Keyboard::Keyboard()
+Keyboard::Keyboard() :
+	m_keys{}
 {
 	glfwSetKeyCallback(Window::Get()->GetWindow(), CallbackKey);
 	glfwSetCharCallback(Window::Get()->GetWindow(), CallbackChar);
@@ -22,12 +33,47 @@ Keyboard::Keyboard()
 
 void Keyboard::Update()
 {
+	m_events.clear();
+	InputEvent event;
+
+	while (m_queue.Pop(event))
+	{
+		m_events.emplace_back(event);
+
+		if (event.m_type == InputEvent::Type::Key)
+		{
+			if (event.m_code >= 0 && event.m_code < static_cast<int32_t>(m_keys.size()))
+			{
+				m_keys[event.m_code] = event.m_action;
+			}
+
+			m_onKey(static_cast<Key>(event.m_code), event.m_action, event.m_mods);
+		}
+		else if (event.m_type == InputEvent::Type::Char)
+		{
+			m_onChar(static_cast<char>(event.m_code));
+		}
+	}
 }
 
 InputAction Keyboard::GetKey(const Key &key) const
 {
-	auto state = glfwGetKey(Window::Get()->GetWindow(), static_cast<int32_t>(key));
-	return static_cast<InputAction>(state);
+	auto index = static_cast<int32_t>(key);
+
+	if (index < 0 || index >= static_cast<int32_t>(m_keys.size()))
+	{
+		return InputAction::Release;
+	}
+
+	return m_keys[index];
+}
+
+void Keyboard::Queue(const InputEvent &event)
+{
+	if (!m_queue.Push(event))
+	{
+		Log::Warning("Keyboard event queue is full, an event was dropped\n");
+	}
 }
 
 std::string Keyboard::ToString(const Key &key)
@@ -2,6 +2,8 @@
 
 #include "Devices/Window.hpp"
 #include "Engine/Engine.hpp"
+#include "Helpers/AtomicRingBuffer.hpp"
+#include "InputEvent.hpp"
 
 namespace acid
 {
@@ -135,6 +137,7 @@ enum class Key :
 
 /**
  * @brief Module used for managing a virtual keyboard.
+ * Key and character callbacks queue timestamped events, each update reads the queued events in order into the key states and calls the delegates.
  */
 class ACID_EXPORT Keyboard :
 	public Module
@@ -151,12 +154,18 @@ public:
 	void Update() override;
 
 	/**
-	 * Gets the current state of a key.
+	 * Gets the state of a key after the events read in the last update.
 	 * @param key The key to get the state of.
 	 * @return The keys state.
 	 */
 	InputAction GetKey(const Key &key) const;
 
+	/**
+	 * Gets the events read in the last update, in the order they were received.
+	 * @return The events.
+	 */
+	const std::vector<InputEvent> &GetEvents() const { return m_events; }
+
 	static std::string ToString(const Key &key);
 
 	/**
@@ -172,6 +181,12 @@ public:
 	Delegate<void(char)> &OnChar() { return m_onChar; }
 
 private:
+	void Queue(const InputEvent &event);
+
+	AtomicRingBuffer<InputEvent, 1024> m_queue;
+	std::vector<InputEvent> m_events;
+	std::array<InputAction, static_cast<std::size_t>(Key::Last) + 1> m_keys;
+
 	Delegate<void(Key, InputAction, BitMask<InputMod>)> m_onKey;
 	Delegate<void(char)> m_onChar;
 
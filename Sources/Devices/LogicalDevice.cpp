@@ -12,6 +12,19 @@ LogicalDevice::LogicalDevice(const Instance *instance, const PhysicalDevice *phy
 	m_physicalDevice(physicalDevice),
 	m_surface(surface),
 	m_logicalDevice(VK_NULL_HANDLE),
+	m_descriptorIndexing(false),
+	m_presentWait(false),
+	m_meshShader(false),
+	m_timelineSemaphore(false),
+	m_rayQuery(false),
+	m_scratchAlignment(256),
+	m_memoryBudget(false),
+	m_fragmentShadingRate(false),
+	m_shadingRateTexelSize({ 16, 16 }),
+	m_maxViewCount(1),
+	m_deviceCount(1),
+	m_deviceGroupPresentModes(0),
+	m_deviceGroupPresentMasks({ 1 }),
 	m_supportedQueues(0),
 	m_graphicsFamily(0),
 	m_presentFamily(0),
@@ -55,9 +68,17 @@ void LogicalDevice::CreateQueueIndices()
 			m_supportedQueues |= VK_QUEUE_GRAPHICS_BIT;
 		}
 
-		// Check for presentation support.
+		// Check for presentation support, without a surface frames are presented by the graphics queue.
 		VkBool32 presentSupport = VK_FALSE;
-		vkGetPhysicalDeviceSurfaceSupportKHR(*m_physicalDevice, i, *m_surface, &presentSupport);
+
+		if (*m_surface != VK_NULL_HANDLE)
+		{
+			vkGetPhysicalDeviceSurfaceSupportKHR(*m_physicalDevice, i, *m_surface, &presentSupport);
+		}
+		else
+		{
+			presentSupport = (deviceQueueFamilyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+		}
 
 		if (deviceQueueFamilyProperties[i].queueCount > 0 && presentSupport)
 		{
@@ -91,6 +112,32 @@ void LogicalDevice::CreateQueueIndices()
 	{
 		throw std::runtime_error("Failed to find queue family supporting VK_QUEUE_GRAPHICS_BIT");
 	}
+
+	// Prefers a compute family without graphics, compute submitted to it runs alongside rendering instead of between it.
+	for (uint32_t i = 0; i < deviceQueueFamilyPropertyCount; i++)
+	{
+		auto queueFlags = deviceQueueFamilyProperties[i].queueFlags;
+
+		if (deviceQueueFamilyProperties[i].queueCount > 0 && queueFlags & VK_QUEUE_COMPUTE_BIT && !(queueFlags & VK_QUEUE_GRAPHICS_BIT))
+		{
+			m_computeFamily = i;
+			m_supportedQueues |= VK_QUEUE_COMPUTE_BIT;
+			break;
+		}
+	}
+
+	// Prefers a transfer only family, on discrete GPUs this is a copy engine that uploads alongside rendering.
+	for (uint32_t i = 0; i < deviceQueueFamilyPropertyCount; i++)
+	{
+		auto queueFlags = deviceQueueFamilyProperties[i].queueFlags;
+
+		if (deviceQueueFamilyProperties[i].queueCount > 0 && queueFlags & VK_QUEUE_TRANSFER_BIT && !(queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+		{
+			m_transferFamily = i;
+			m_supportedQueues |= VK_QUEUE_TRANSFER_BIT;
+			break;
+		}
+	}
 }
 
 void LogicalDevice::CreateLogicalDevice()
@@ -254,16 +301,359 @@ void LogicalDevice::CreateLogicalDevice()
 		Log::Error("Selected GPU does not support multi viewports!");
 	}
 
+	if (physicalDeviceFeatures.drawIndirectFirstInstance)
+	{
+		enabledFeatures.drawIndirectFirstInstance = VK_TRUE;
+	}
+	else
+	{
+		Log::Error("Selected GPU does not support indirect draws with a first instance!");
+	}
+
+	if (physicalDeviceFeatures.multiDrawIndirect)
+	{
+		enabledFeatures.multiDrawIndirect = VK_TRUE;
+	}
+	else
+	{
+		Log::Error("Selected GPU does not support multiple indirect draws!");
+	}
+
+	auto deviceExtensions = m_instance->GetDeviceExtensions();
+
+	// Descriptor indexing lets bindless materials index one shared array of images instead of writing their own descriptors.
+	uint32_t extensionPropertyCount;
+	vkEnumerateDeviceExtensionProperties(*m_physicalDevice, nullptr, &extensionPropertyCount, nullptr);
+	std::vector<VkExtensionProperties> extensionProperties(extensionPropertyCount);
+	vkEnumerateDeviceExtensionProperties(*m_physicalDevice, nullptr, &extensionPropertyCount, extensionProperties.data());
+
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT enabledDescriptorIndexing = {};
+	enabledDescriptorIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+	for (const auto &extension : extensionProperties)
+	{
+		if (strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) != 0)
+		{
+			continue;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+		descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &descriptorIndexingFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_physicalDevice, &physicalDeviceFeatures2);
+
+		m_descriptorIndexing = descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing && descriptorIndexingFeatures.runtimeDescriptorArray
+			&& descriptorIndexingFeatures.descriptorBindingPartiallyBound && descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind
+			&& descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+		break;
+	}
+
+	if (m_descriptorIndexing)
+	{
+		enabledDescriptorIndexing.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		enabledDescriptorIndexing.runtimeDescriptorArray = VK_TRUE;
+		enabledDescriptorIndexing.descriptorBindingPartiallyBound = VK_TRUE;
+		enabledDescriptorIndexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		enabledDescriptorIndexing.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		deviceExtensions.emplace_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+	}
+	else
+	{
+		Log::Error("Selected GPU does not support descriptor indexing, materials will not be bindless!");
+	}
+
+	void *enabledFeaturesChain = m_descriptorIndexing ? &enabledDescriptorIndexing : nullptr;
+
+	auto hasExtension = [&extensionProperties](const char *extensionName)
+	{
+		return std::any_of(extensionProperties.begin(), extensionProperties.end(), [extensionName](const VkExtensionProperties &extension)
+		{
+			return strcmp(extension.extensionName, extensionName) == 0;
+		});
+	};
+
+#if defined(VK_KHR_present_wait) && defined(VK_KHR_present_id)
+	// Present waits let the frame pacing limit how many images are queued for the display, instead of only how many frames the GPU has queued.
+	VkPhysicalDevicePresentIdFeaturesKHR enabledPresentId = {};
+	enabledPresentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+
+	VkPhysicalDevicePresentWaitFeaturesKHR enabledPresentWait = {};
+	enabledPresentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+	if (hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) && hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+	{
+		VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+		presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+
+		VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+		presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+		presentWaitFeatures.pNext = &presentIdFeatures;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &presentWaitFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_physicalDevice, &physicalDeviceFeatures2);
+
+		m_presentWait = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+	}
+
+	if (m_presentWait)
+	{
+		enabledPresentId.presentId = VK_TRUE;
+		enabledPresentId.pNext = enabledFeaturesChain;
+		enabledPresentWait.presentWait = VK_TRUE;
+		enabledPresentWait.pNext = &enabledPresentId;
+		enabledFeaturesChain = &enabledPresentWait;
+		deviceExtensions.emplace_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+		deviceExtensions.emplace_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+	}
+#endif
+
+#if defined(VK_EXT_mesh_shader)
+	// Task and mesh shaders cull and draw the meshlets of dense models without expanding them into indirect draws first.
+	VkPhysicalDeviceMeshShaderFeaturesEXT enabledMeshShader = {};
+	enabledMeshShader.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+
+	if (hasExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME) && hasExtension(VK_KHR_SPIRV_1_4_EXTENSION_NAME)
+		&& hasExtension(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures = {};
+		meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &meshShaderFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_physicalDevice, &physicalDeviceFeatures2);
+
+		m_meshShader = meshShaderFeatures.taskShader && meshShaderFeatures.meshShader;
+	}
+
+	if (m_meshShader)
+	{
+		enabledMeshShader.taskShader = VK_TRUE;
+		enabledMeshShader.meshShader = VK_TRUE;
+		enabledMeshShader.pNext = enabledFeaturesChain;
+		enabledFeaturesChain = &enabledMeshShader;
+		deviceExtensions.emplace_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+		deviceExtensions.emplace_back(VK_KHR_SPIRV_1_4_EXTENSION_NAME);
+		deviceExtensions.emplace_back(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME);
+	}
+#endif
+
+#if defined(VK_KHR_timeline_semaphore)
+	// Timeline semaphores let frames and uploads be waited on by a counter, instead of a fence being created or reset for each submit.
+	VkPhysicalDeviceTimelineSemaphoreFeaturesKHR enabledTimelineSemaphore = {};
+	enabledTimelineSemaphore.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+
+	if (hasExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures = {};
+		timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &timelineSemaphoreFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_physicalDevice, &physicalDeviceFeatures2);
+
+		m_timelineSemaphore = timelineSemaphoreFeatures.timelineSemaphore;
+	}
+
+	if (m_timelineSemaphore)
+	{
+		enabledTimelineSemaphore.timelineSemaphore = VK_TRUE;
+		enabledTimelineSemaphore.pNext = enabledFeaturesChain;
+		enabledFeaturesChain = &enabledTimelineSemaphore;
+		deviceExtensions.emplace_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+	}
+#endif
+
+#if defined(VK_KHR_ray_query) && defined(VK_KHR_acceleration_structure)
+	// Ray queries let the lighting pass trace shadow rays against the scene, instead of a shadow map being rendered for each light.
+	VkPhysicalDeviceBufferDeviceAddressFeaturesKHR enabledBufferDeviceAddress = {};
+	enabledBufferDeviceAddress.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR;
+
+	VkPhysicalDeviceAccelerationStructureFeaturesKHR enabledAccelerationStructure = {};
+	enabledAccelerationStructure.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR;
+
+	VkPhysicalDeviceRayQueryFeaturesKHR enabledRayQuery = {};
+	enabledRayQuery.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR;
+
+	// Acceleration structures require the descriptor indexing extension.
+	if (m_descriptorIndexing && hasExtension(VK_KHR_RAY_QUERY_EXTENSION_NAME) && hasExtension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME)
+		&& hasExtension(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME) && hasExtension(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME)
+		&& hasExtension(VK_KHR_SPIRV_1_4_EXTENSION_NAME) && hasExtension(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceBufferDeviceAddressFeaturesKHR bufferDeviceAddressFeatures = {};
+		bufferDeviceAddressFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR;
+
+		VkPhysicalDeviceAccelerationStructureFeaturesKHR accelerationStructureFeatures = {};
+		accelerationStructureFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR;
+		accelerationStructureFeatures.pNext = &bufferDeviceAddressFeatures;
+
+		VkPhysicalDeviceRayQueryFeaturesKHR rayQueryFeatures = {};
+		rayQueryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR;
+		rayQueryFeatures.pNext = &accelerationStructureFeatures;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &rayQueryFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_physicalDevice, &physicalDeviceFeatures2);
+
+		m_rayQuery = rayQueryFeatures.rayQuery && accelerationStructureFeatures.accelerationStructure && bufferDeviceAddressFeatures.bufferDeviceAddress;
+	}
+
+	if (m_rayQuery)
+	{
+		VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties = {};
+		accelerationStructureProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
+
+		VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+		physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		physicalDeviceProperties2.pNext = &accelerationStructureProperties;
+		vkGetPhysicalDeviceProperties2(*m_physicalDevice, &physicalDeviceProperties2);
+		m_scratchAlignment = std::max<VkDeviceSize>(accelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment, 1);
+
+		enabledBufferDeviceAddress.bufferDeviceAddress = VK_TRUE;
+		enabledBufferDeviceAddress.pNext = enabledFeaturesChain;
+		enabledAccelerationStructure.accelerationStructure = VK_TRUE;
+		enabledAccelerationStructure.pNext = &enabledBufferDeviceAddress;
+		enabledRayQuery.rayQuery = VK_TRUE;
+		enabledRayQuery.pNext = &enabledAccelerationStructure;
+		enabledFeaturesChain = &enabledRayQuery;
+
+		// Mesh shaders may have enabled the SPIR-V 1.4 extensions already.
+		for (const auto &extensionName : { VK_KHR_RAY_QUERY_EXTENSION_NAME, VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME, VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME,
+			VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME, VK_KHR_SPIRV_1_4_EXTENSION_NAME, VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME })
+		{
+			if (std::none_of(deviceExtensions.begin(), deviceExtensions.end(), [extensionName](const char *enabled) { return strcmp(enabled, extensionName) == 0; }))
+			{
+				deviceExtensions.emplace_back(extensionName);
+			}
+		}
+	}
+#endif
+
+#if defined(VK_EXT_memory_budget)
+	// The memory budget reports how much of each heap the whole process uses, and how much it can use before the driver starts evicting.
+	if (hasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+	{
+		m_memoryBudget = true;
+		deviceExtensions.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	}
+#endif
+
+#if defined(VK_KHR_fragment_shading_rate) && defined(VK_KHR_create_renderpass2)
+	// Shading rate attachments are read by subpasses of render passes created with the second render pass API.
+	VkPhysicalDeviceFragmentShadingRateFeaturesKHR enabledFragmentShadingRate = {};
+	enabledFragmentShadingRate.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+
+	if (hasExtension(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME) && hasExtension(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceFragmentShadingRateFeaturesKHR fragmentShadingRateFeatures = {};
+		fragmentShadingRateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &fragmentShadingRateFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_physicalDevice, &physicalDeviceFeatures2);
+
+		m_fragmentShadingRate = fragmentShadingRateFeatures.pipelineFragmentShadingRate && fragmentShadingRateFeatures.attachmentFragmentShadingRate;
+	}
+
+	if (m_fragmentShadingRate)
+	{
+		VkPhysicalDeviceFragmentShadingRatePropertiesKHR fragmentShadingRateProperties = {};
+		fragmentShadingRateProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR;
+
+		VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+		physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		physicalDeviceProperties2.pNext = &fragmentShadingRateProperties;
+		vkGetPhysicalDeviceProperties2(*m_physicalDevice, &physicalDeviceProperties2);
+
+		// Texels of 16 pixels are used where supported, the analysis pass reads a few samples from each.
+		auto &minTexelSize = fragmentShadingRateProperties.minFragmentShadingRateAttachmentTexelSize;
+		auto &maxTexelSize = fragmentShadingRateProperties.maxFragmentShadingRateAttachmentTexelSize;
+		m_shadingRateTexelSize.width = std::clamp(16u, minTexelSize.width, maxTexelSize.width);
+		m_shadingRateTexelSize.height = std::clamp(16u, minTexelSize.height, maxTexelSize.height);
+
+		enabledFragmentShadingRate.pipelineFragmentShadingRate = VK_TRUE;
+		enabledFragmentShadingRate.attachmentFragmentShadingRate = VK_TRUE;
+		enabledFragmentShadingRate.pNext = enabledFeaturesChain;
+		enabledFeaturesChain = &enabledFragmentShadingRate;
+		deviceExtensions.emplace_back(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+		deviceExtensions.emplace_back(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+	}
+#endif
+
+	// Multiview render passes draw each view into a layer of their attachments at once, such as both eyes of a headset, it is part of Vulkan 1.1.
+	VkPhysicalDeviceMultiviewFeatures enabledMultiview = {};
+	enabledMultiview.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+
+	{
+		VkPhysicalDeviceMultiviewFeatures multiviewFeatures = {};
+		multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &multiviewFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_physicalDevice, &physicalDeviceFeatures2);
+
+		if (multiviewFeatures.multiview)
+		{
+			VkPhysicalDeviceMultiviewProperties multiviewProperties = {};
+			multiviewProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES;
+
+			VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+			physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			physicalDeviceProperties2.pNext = &multiviewProperties;
+			vkGetPhysicalDeviceProperties2(*m_physicalDevice, &physicalDeviceProperties2);
+
+			m_maxViewCount = std::max(multiviewProperties.maxMultiviewViewCount, 1u);
+			enabledMultiview.multiview = VK_TRUE;
+			enabledMultiview.pNext = enabledFeaturesChain;
+			enabledFeaturesChain = &enabledMultiview;
+		}
+	}
+
+	// The device is created over every GPU in the device group, device local memory is then allocated on each of them.
+	auto &deviceGroup = m_physicalDevice->GetDeviceGroup();
+
+	VkDeviceGroupDeviceCreateInfo deviceGroupCreateInfo = {};
+	deviceGroupCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO;
+
+	if (deviceGroup.size() > 1)
+	{
+		deviceGroupCreateInfo.physicalDeviceCount = static_cast<uint32_t>(deviceGroup.size());
+		deviceGroupCreateInfo.pPhysicalDevices = deviceGroup.data();
+		deviceGroupCreateInfo.pNext = enabledFeaturesChain;
+		enabledFeaturesChain = &deviceGroupCreateInfo;
+		m_deviceCount = deviceGroupCreateInfo.physicalDeviceCount;
+	}
+
 	VkDeviceCreateInfo deviceCreateInfo = {};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceCreateInfo.pNext = enabledFeaturesChain;
 	deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 	deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(m_instance->GetInstanceLayers().size());
 	deviceCreateInfo.ppEnabledLayerNames = m_instance->GetInstanceLayers().data();
-	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(m_instance->GetDeviceExtensions().size());
-	deviceCreateInfo.ppEnabledExtensionNames = m_instance->GetDeviceExtensions().data();
+	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+	deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 	deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 	Graphics::CheckVk(vkCreateDevice(*m_physicalDevice, &deviceCreateInfo, nullptr, &m_logicalDevice));
+	m_enabledFeatures = enabledFeatures;
+
+	if (m_deviceCount > 1)
+	{
+		VkDeviceGroupPresentCapabilitiesKHR presentCapabilities = {};
+		presentCapabilities.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_PRESENT_CAPABILITIES_KHR;
+		Graphics::CheckVk(vkGetDeviceGroupPresentCapabilitiesKHR(m_logicalDevice, &presentCapabilities));
+		m_deviceGroupPresentModes = presentCapabilities.modes;
+		std::copy(std::begin(presentCapabilities.presentMask), std::end(presentCapabilities.presentMask), m_deviceGroupPresentMasks.begin());
+	}
 
 	vkGetDeviceQueue(m_logicalDevice, m_graphicsFamily, 0, &m_graphicsQueue);
 	vkGetDeviceQueue(m_logicalDevice, m_presentFamily, 0, &m_presentQueue);
@@ -22,6 +22,91 @@ public:
 
 	const VkPhysicalDeviceFeatures &GetEnabledFeatures() const { return m_enabledFeatures; }
 
+	/**
+	 * Gets if descriptor indexing is enabled, so a shader can index a partially bound array of images that is updated after being bound.
+	 * @return If descriptor indexing is enabled.
+	 */
+	const bool &IsDescriptorIndexing() const { return m_descriptorIndexing; }
+
+	/**
+	 * Gets if present ids and present waits are enabled, so the CPU can wait until a earlier image has been shown on the display.
+	 * @return If present waits are enabled.
+	 */
+	const bool &IsPresentWait() const { return m_presentWait; }
+
+	/**
+	 * Gets if task and mesh shaders are enabled, so meshlets can be culled and drawn by the same workgroups.
+	 * @return If mesh shaders are enabled.
+	 */
+	const bool &IsMeshShader() const { return m_meshShader; }
+
+	/**
+	 * Gets if timeline semaphores are enabled, so submits can signal a counter that the CPU and other submits wait on.
+	 * @return If timeline semaphores are enabled.
+	 */
+	const bool &IsTimelineSemaphore() const { return m_timelineSemaphore; }
+
+	/**
+	 * Gets if acceleration structures and ray queries are enabled, so shaders can trace rays against the scene. Buffer device addresses are enabled with them.
+	 * @return If ray queries are enabled.
+	 */
+	const bool &IsRayQuery() const { return m_rayQuery; }
+
+	/**
+	 * Gets the alignment of the scratch memory acceleration structures are built with.
+	 * @return The scratch alignment in bytes.
+	 */
+	const VkDeviceSize &GetScratchAlignment() const { return m_scratchAlignment; }
+
+	/**
+	 * Gets if the memory budget extension is enabled, so the usage and budget of each memory heap can be queried from the driver.
+	 * @return If memory budgets are enabled.
+	 */
+	const bool &IsMemoryBudget() const { return m_memoryBudget; }
+
+	/**
+	 * Gets if fragment shading rates are enabled, so render passes can read a shading rate attachment that lets regions of low detail be shaded at coarser rates.
+	 * @return If variable rate shading is enabled.
+	 */
+	const bool &IsFragmentShadingRate() const { return m_fragmentShadingRate; }
+
+	/**
+	 * Gets the size in pixels of the region covered by each texel of a shading rate attachment.
+	 * @return The shading rate texel size.
+	 */
+	const VkExtent2D &GetShadingRateTexelSize() const { return m_shadingRateTexelSize; }
+
+	/**
+	 * Gets the most views a multiview render pass can draw at once, one if multiview is not supported.
+	 * @return The most views of a multiview render pass.
+	 */
+	const uint32_t &GetMaxViewCount() const { return m_maxViewCount; }
+
+	/**
+	 * Gets the number of GPUs this device was created over, more than one when the physical device is part of a device group.
+	 * @return The number of GPUs.
+	 */
+	const uint32_t &GetDeviceCount() const { return m_deviceCount; }
+
+	/**
+	 * Gets the mask of every GPU in the device group, commands recorded with this mask run on all of them.
+	 * @return The device mask.
+	 */
+	uint32_t GetDeviceMask() const { return (1u << m_deviceCount) - 1; }
+
+	/**
+	 * Gets the ways the GPUs of the device group can present swapchain images.
+	 * @return The device group present modes, zero when there is no device group.
+	 */
+	const VkDeviceGroupPresentModeFlagsKHR &GetDeviceGroupPresentModes() const { return m_deviceGroupPresentModes; }
+
+	/**
+	 * Gets the GPUs a GPU of the device group can present swapchain images from.
+	 * @param deviceIndex The index of the GPU in the device group.
+	 * @return The device mask, zero if the GPU has no display connected.
+	 */
+	uint32_t GetDeviceGroupPresentMask(const uint32_t &deviceIndex) const { return m_deviceGroupPresentMasks[deviceIndex]; }
+
 	const VkQueue &GetGraphicsQueue() const { return m_graphicsQueue; }
 
 	const VkQueue &GetPresentQueue() const { return m_presentQueue; }
@@ -36,6 +121,12 @@ public:
 
 	const uint32_t &GetComputeFamily() const { return m_computeFamily; }
 
+	/**
+	 * Gets if compute has a queue family separate from graphics, so compute work can overlap with rendering.
+	 * @return If compute is asynchronous.
+	 */
+	bool IsAsyncCompute() const { return m_computeFamily != m_graphicsFamily; }
+
 	const uint32_t &GetTransferFamily() const { return m_transferFamily; }
 
 private:
@@ -51,6 +142,19 @@ private:
 
 	VkDevice m_logicalDevice;
 	VkPhysicalDeviceFeatures m_enabledFeatures;
+	bool m_descriptorIndexing;
+	bool m_presentWait;
+	bool m_meshShader;
+	bool m_timelineSemaphore;
+	bool m_rayQuery;
+	VkDeviceSize m_scratchAlignment;
+	bool m_memoryBudget;
+	bool m_fragmentShadingRate;
+	VkExtent2D m_shadingRateTexelSize;
+	uint32_t m_maxViewCount;
+	uint32_t m_deviceCount;
+	VkDeviceGroupPresentModeFlagsKHR m_deviceGroupPresentModes;
+	std::array<uint32_t, VK_MAX_DEVICE_GROUP_SIZE> m_deviceGroupPresentMasks;
 
 	VkQueueFlags m_supportedQueues;
 	uint32_t m_graphicsFamily;
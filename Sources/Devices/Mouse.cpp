@@ -8,14 +8,23 @@ namespace acid
 {
 void CallbackMouseButton(GLFWwindow *window, int32_t button, int32_t action, int32_t mods)
 {
-	Mouse::Get()->m_onButton(static_cast<MouseButton>(button), static_cast<InputAction>(action), MakeBitMask<InputMod>(mods));
+	InputEvent event;
+	event.m_type = InputEvent::Type::MouseButton;
+	event.m_time = Engine::GetTime();
+	event.m_code = button;
+	event.m_action = static_cast<InputAction>(action);
+	event.m_mods = MakeBitMask<InputMod>(mods);
+	Mouse::Get()->Queue(event);
 }
 
 void CallbackCursorPos(GLFWwindow *window, double xpos, double ypos)
 {
-	Mouse::Get()->m_mousePosition.m_x = static_cast<float>(xpos) / static_cast<float>(Window::Get()->GetSize().m_x);
-	Mouse::Get()->m_mousePosition.m_y = static_cast<float>(ypos) / static_cast<float>(Window::Get()->GetSize().m_y);
-	Mouse::Get()->m_onPosition(Mouse::Get()->m_mousePosition);
+	InputEvent event;
+	event.m_type = InputEvent::Type::MousePosition;
+	event.m_time = Engine::GetTime();
+	event.m_value.m_x = static_cast<float>(xpos) / static_cast<float>(Window::Get()->GetSize().m_x);
+	event.m_value.m_y = static_cast<float>(ypos) / static_cast<float>(Window::Get()->GetSize().m_y);
+	Mouse::Get()->Queue(event);
 }
 
 void CallbackCursorEnter(GLFWwindow *window, int32_t entered)
@@ -26,9 +35,12 @@ void CallbackCursorEnter(GLFWwindow *window, int32_t entered)
 
 void CallbackScroll(GLFWwindow *window, double xoffset, double yoffset)
 {
-	Mouse::Get()->m_mouseWheelDelta.m_x = static_cast<float>(yoffset);
-	Mouse::Get()->m_mouseWheelDelta.m_y = static_cast<float>(yoffset);
-	Mouse::Get()->m_onScroll(Mouse::Get()->m_mouseWheelDelta);
+	InputEvent event;
+	event.m_type = InputEvent::Type::MouseScroll;
+	event.m_time = Engine::GetTime();
+	event.m_value.m_x = static_cast<float>(yoffset);
+	event.m_value.m_y = static_cast<float>(yoffset);
+	Mouse::Get()->Queue(event);
 }
 
 void CallbackDrop(GLFWwindow *window, int32_t count, const char **paths)
@@ -45,6 +57,7 @@ void CallbackDrop(GLFWwindow *window, int32_t count, const char **paths)
 
 Mouse::Mouse() :
 	m_cursor(nullptr),
+	m_buttons{},
 	m_windowSelected(true),
 	m_cursorHidden(false)
 {
@@ -62,6 +75,36 @@ Mouse::~Mouse()
 
 void Mouse::Update()
 {
+	m_events.clear();
+	InputEvent event;
+
+	while (m_queue.Pop(event))
+	{
+		m_events.emplace_back(event);
+
+		switch (event.m_type)
+		{
+		case InputEvent::Type::MouseButton:
+			if (event.m_code >= 0 && event.m_code < static_cast<int32_t>(m_buttons.size()))
+			{
+				m_buttons[event.m_code] = event.m_action;
+			}
+
+			m_onButton(static_cast<MouseButton>(event.m_code), event.m_action, event.m_mods);
+			break;
+		case InputEvent::Type::MousePosition:
+			m_mousePosition = event.m_value;
+			m_onPosition(m_mousePosition);
+			break;
+		case InputEvent::Type::MouseScroll:
+			m_mouseWheelDelta = event.m_value;
+			m_onScroll(m_mouseWheelDelta);
+			break;
+		default:
+			break;
+		}
+	}
+
 	float delta = Engine::Get()->GetDelta().AsSeconds();
 
 	// Updates the mouses delta.
@@ -151,8 +194,14 @@ void Mouse::SetClipboard(const std::string &string) const
 
 InputAction Mouse::GetButton(const MouseButton &mouseButton) const
 {
-	auto state = glfwGetMouseButton(Window::Get()->GetWindow(), static_cast<int32_t>(mouseButton));
-	return static_cast<InputAction>(state);
+	auto index = static_cast<int32_t>(mouseButton);
+
+	if (index < 0 || index >= static_cast<int32_t>(m_buttons.size()))
+	{
+		return InputAction::Release;
+	}
+
+	return m_buttons[index];
 }
 
 void Mouse::SetPosition(const Vector2f &position)
@@ -176,6 +225,14 @@ void Mouse::SetCursorHidden(const bool &hidden)
 	m_cursorHidden = hidden;
 }
 
+void Mouse::Queue(const InputEvent &event)
+{
+	if (!m_queue.Push(event))
+	{
+		Log::Warning("Mouse event queue is full, an event was dropped\n");
+	}
+}
+
 float Mouse::SmoothScrollWheel(float value, const float &delta)
 {
 	if (value != 0.0f)
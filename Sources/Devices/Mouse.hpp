@@ -2,7 +2,9 @@
 
 #include "Devices/Window.hpp"
 #include "Engine/Engine.hpp"
+#include "Helpers/AtomicRingBuffer.hpp"
 #include "Helpers/Delegate.hpp"
+#include "InputEvent.hpp"
 
 struct GLFWcursor;
 
@@ -43,6 +45,7 @@ enum class CursorStandard
 
 /**
  * @brief Module used for managing a virtual mouse.
+ * Button, cursor and scroll callbacks queue timestamped events, each update reads the queued events in order into the mouse state and calls the delegates.
  */
 class ACID_EXPORT Mouse :
 	public Module
@@ -61,12 +64,18 @@ public:
 	void Update() override;
 
 	/**
-	 * Gets the current state of a mouse button.
+	 * Gets the state of a mouse button after the events read in the last update.
 	 * @param mouseButton The mouse button to get the state of.
 	 * @return The mouse buttons state.
 	 */
 	InputAction GetButton(const MouseButton &mouseButton) const;
 
+	/**
+	 * Gets the events read in the last update, in the order they were received.
+	 * @return The events.
+	 */
+	const std::vector<InputEvent> &GetEvents() const { return m_events; }
+
 	/**
 	 * Sets the cursor to a image file.
 	 * @param filename The new custom mouse file.
@@ -167,6 +176,8 @@ public:
 private:
 	static float SmoothScrollWheel(float value, const float &delta);
 
+	void Queue(const InputEvent &event);
+
 	friend void CallbackMouseButton(GLFWwindow *window, int32_t button, int32_t action, int32_t mods);
 
 	friend void CallbackCursorPos(GLFWwindow *window, double xpos, double ypos);
@@ -181,6 +192,10 @@ private:
 	std::optional<CursorStandard> m_currentStandard;
 	GLFWcursor *m_cursor;
 
+	AtomicRingBuffer<InputEvent, 1024> m_queue;
+	std::vector<InputEvent> m_events;
+	std::array<InputAction, static_cast<std::size_t>(MouseButton::Last) + 1> m_buttons;
+
 	Vector2f m_lastMousePosition;
 	Vector2f m_mousePosition;
 	Vector2f m_mouseDelta;
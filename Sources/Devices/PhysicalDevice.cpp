@@ -1,6 +1,7 @@
 #include "PhysicalDevice.hpp"
 
 #include "Graphics/Graphics.hpp"
+#include "Helpers/String.hpp"
 #include "Instance.hpp"
 
 namespace acid
@@ -8,13 +9,16 @@ namespace acid
 static const std::vector<VkSampleCountFlagBits> STAGE_FLAG_BITS = { VK_SAMPLE_COUNT_64_BIT, VK_SAMPLE_COUNT_32_BIT, VK_SAMPLE_COUNT_16_BIT, VK_SAMPLE_COUNT_8_BIT,
 	VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_2_BIT };
 
+PhysicalDevice::Selection PhysicalDevice::SELECTION;
+
 PhysicalDevice::PhysicalDevice(const Instance *instance) :
 	m_instance(instance),
 	m_physicalDevice(VK_NULL_HANDLE),
 	m_properties({}),
 	m_features({}),
 	m_memoryProperties({}),
-	m_msaaSamples(VK_SAMPLE_COUNT_1_BIT)
+	m_msaaSamples(VK_SAMPLE_COUNT_1_BIT),
+	m_deviceGroupMode(DeviceGroupMode::None)
 {
 	uint32_t physicalDeviceCount;
 	vkEnumeratePhysicalDevices(*m_instance, &physicalDeviceCount, nullptr);
@@ -32,13 +36,37 @@ PhysicalDevice::PhysicalDevice(const Instance *instance) :
 	vkGetPhysicalDeviceFeatures(m_physicalDevice, &m_features);
 	vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
 	m_msaaSamples = GetMaxUsableSampleCount();
+	ChooseDeviceGroup();
 
 #if defined(ACID_VERBOSE)
 	Log::Out("Selected Physical Device: '%s', %i\n", m_properties.deviceName, m_properties.deviceID);
 	Log::Out("Max MSAA Samples: %i\n", m_msaaSamples);
+	Log::Out("Device Group Size: %i\n", m_deviceGroup.size());
 #endif
 }
 
+std::string PhysicalDevice::GetUuid(const VkPhysicalDevice &device)
+{
+	VkPhysicalDeviceIDProperties idProperties = {};
+	idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+	VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+	physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	physicalDeviceProperties2.pNext = &idProperties;
+	vkGetPhysicalDeviceProperties2(device, &physicalDeviceProperties2);
+
+	static const char *digits = "0123456789abcdef";
+	std::string uuid;
+
+	for (const auto &byte : idProperties.deviceUUID)
+	{
+		uuid += digits[byte >> 4];
+		uuid += digits[byte & 0xf];
+	}
+
+	return uuid;
+}
+
 VkPhysicalDevice PhysicalDevice::ChoosePhysicalDevice(const std::vector<VkPhysicalDevice> &devices)
 {
 	// Maps to hold devices and sort by rank.
@@ -51,6 +79,31 @@ VkPhysicalDevice PhysicalDevice::ChoosePhysicalDevice(const std::vector<VkPhysic
 		rankedDevices.emplace(score, device);
 	}
 
+	if (rankedDevices.empty())
+	{
+		return nullptr;
+	}
+
+	// A configured UUID or name picks the best matching device, the best scoring device is used when none match.
+	auto uuid = String::ReplaceAll(String::Lowercase(SELECTION.m_uuid), "-", "");
+	auto name = String::Lowercase(SELECTION.m_name);
+
+	if (!uuid.empty() || !name.empty())
+	{
+		for (auto it = rankedDevices.rbegin(); it != rankedDevices.rend() && it->first > 0; ++it)
+		{
+			VkPhysicalDeviceProperties physicalDeviceProperties;
+			vkGetPhysicalDeviceProperties(it->second, &physicalDeviceProperties);
+
+			if ((uuid.empty() || GetUuid(it->second) == uuid) && (name.empty() || String::Contains(String::Lowercase(physicalDeviceProperties.deviceName), name)))
+			{
+				return it->second;
+			}
+		}
+
+		Log::Warning("No suitable GPU matches the selection name '%s' and UUID '%s', choosing the best GPU\n", SELECTION.m_name.c_str(), SELECTION.m_uuid.c_str());
+	}
+
 	// Checks to make sure the best candidate scored higher than 0  rbegin points to last element of ranked devices(highest rated), first is its rating.
 	if (rankedDevices.rbegin()->first > 0)
 	{
@@ -99,11 +152,13 @@ int32_t PhysicalDevice::ScorePhysicalDevice(const VkPhysicalDevice &device)
 	vkGetPhysicalDeviceFeatures(device, &physicalDeviceFeatures);
 
 #if defined(ACID_VERBOSE)
-	LogVulkanDevice(physicalDeviceProperties, extensionProperties);
+	LogVulkanDevice(physicalDeviceProperties, extensionProperties, GetUuid(device));
 #endif
 
-	// Adds a large score boost for discrete GPUs (dedicated graphics cards).
-	if (physicalDeviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+	// Adds a large score boost for discrete GPUs (dedicated graphics cards), or for integrated GPUs when they are preferred to save power.
+	auto preferredType = SELECTION.m_preferDiscrete ? VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU : VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU;
+
+	if (physicalDeviceProperties.deviceType == preferredType)
 	{
 		score += 1000;
 	}
@@ -114,6 +169,42 @@ int32_t PhysicalDevice::ScorePhysicalDevice(const VkPhysicalDevice &device)
 	return score;
 }
 
+void PhysicalDevice::ChooseDeviceGroup()
+{
+	m_deviceGroup = { m_physicalDevice };
+
+	if (SELECTION.m_deviceGroupMode == DeviceGroupMode::None)
+	{
+		return;
+	}
+
+	uint32_t deviceGroupCount;
+	vkEnumeratePhysicalDeviceGroups(*m_instance, &deviceGroupCount, nullptr);
+	std::vector<VkPhysicalDeviceGroupProperties> deviceGroups(deviceGroupCount);
+
+	for (auto &deviceGroup : deviceGroups)
+	{
+		deviceGroup.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES;
+	}
+
+	vkEnumeratePhysicalDeviceGroups(*m_instance, &deviceGroupCount, deviceGroups.data());
+
+	for (const auto &deviceGroup : deviceGroups)
+	{
+		auto begin = deviceGroup.physicalDevices;
+		auto end = deviceGroup.physicalDevices + deviceGroup.physicalDeviceCount;
+
+		if (deviceGroup.physicalDeviceCount > 1 && std::find(begin, end, m_physicalDevice) != end)
+		{
+			m_deviceGroup = std::vector<VkPhysicalDevice>(begin, end);
+			m_deviceGroupMode = SELECTION.m_deviceGroupMode;
+			return;
+		}
+	}
+
+	Log::Warning("Selected GPU '%s' is not linked with other GPUs in a device group, rendering on it alone\n", m_properties.deviceName);
+}
+
 VkSampleCountFlagBits PhysicalDevice::GetMaxUsableSampleCount()
 {
 	VkPhysicalDeviceProperties physicalDeviceProperties;
@@ -132,9 +223,11 @@ VkSampleCountFlagBits PhysicalDevice::GetMaxUsableSampleCount()
 	return VK_SAMPLE_COUNT_1_BIT;
 }
 
-void PhysicalDevice::LogVulkanDevice(const VkPhysicalDeviceProperties &physicalDeviceProperties, const std::vector<VkExtensionProperties> &extensionProperties)
+void PhysicalDevice::LogVulkanDevice(const VkPhysicalDeviceProperties &physicalDeviceProperties, const std::vector<VkExtensionProperties> &extensionProperties,
+	const std::string &uuid)
 {
 	Log::Out("-- Physical Device: %i '%s' --\n", physicalDeviceProperties.deviceID, physicalDeviceProperties.deviceName);
+	Log::Out("UUID: %s\n", uuid.c_str());
 
 	Log::Out("Extensions: ");
 
@@ -10,8 +10,48 @@ class Instance;
 class ACID_EXPORT PhysicalDevice
 {
 public:
+	/**
+	 * @brief How the GPUs of a device group share the rendering of frames.
+	 */
+	enum class DeviceGroupMode
+	{
+		/// Only the chosen GPU renders.
+		None,
+		/// Each GPU renders every other frame, frames in flight are spread over the GPUs.
+		AlternateFrame,
+		/// Each GPU renders and presents the part of every frame shown by its displays.
+		SplitFrame
+	};
+
+	/**
+	 * @brief The preferences the GPU is chosen with, set with {@link PhysicalDevice#SetSelection} before the engine is created.
+	 */
+	class Selection
+	{
+	public:
+		/// If set only GPUs with names containing this are chosen, ignoring case.
+		std::string m_name;
+		/// If set only the GPU with this UUID is chosen, as hex with or without dashes, this is logged for every GPU in verbose builds.
+		std::string m_uuid;
+		/// If discrete GPUs are preferred over integrated GPUs.
+		bool m_preferDiscrete = true;
+		/// How the other GPUs in the device group of the chosen GPU are used.
+		DeviceGroupMode m_deviceGroupMode = DeviceGroupMode::None;
+	};
+
 	explicit PhysicalDevice(const Instance *instance);
 
+	static const Selection &GetSelection() { return SELECTION; }
+
+	static void SetSelection(const Selection &selection) { SELECTION = selection; }
+
+	/**
+	 * Gets the UUID of a GPU, this stays the same between runs and driver updates unlike the order GPUs are enumerated in.
+	 * @param device The GPU.
+	 * @return The UUID as lowercase hex.
+	 */
+	static std::string GetUuid(const VkPhysicalDevice &device);
+
 	operator const VkPhysicalDevice &() const { return m_physicalDevice; }
 
 	const VkPhysicalDevice &GetPhysicalDevice() const { return m_physicalDevice; }
@@ -24,6 +64,14 @@ public:
 
 	const VkSampleCountFlagBits &GetMsaaSamples() const { return m_msaaSamples; }
 
+	/**
+	 * Gets the GPUs the logical device is created over, only more than one when the selection uses a device group and the chosen GPU is in one.
+	 * @return The GPUs of the device group, the chosen GPU alone when there is no group.
+	 */
+	const std::vector<VkPhysicalDevice> &GetDeviceGroup() const { return m_deviceGroup; }
+
+	const DeviceGroupMode &GetDeviceGroupMode() const { return m_deviceGroupMode; }
+
 private:
 	friend class Graphics;
 
@@ -31,9 +79,14 @@ private:
 
 	int32_t ScorePhysicalDevice(const VkPhysicalDevice &device);
 
+	void ChooseDeviceGroup();
+
 	VkSampleCountFlagBits GetMaxUsableSampleCount();
 
-	static void LogVulkanDevice(const VkPhysicalDeviceProperties &physicalDeviceProperties, const std::vector<VkExtensionProperties> &extensionProperties);
+	static void LogVulkanDevice(const VkPhysicalDeviceProperties &physicalDeviceProperties, const std::vector<VkExtensionProperties> &extensionProperties,
+		const std::string &uuid);
+
+	static Selection SELECTION;
 
 	const Instance *m_instance;
 
@@ -42,5 +95,7 @@ private:
 	VkPhysicalDeviceFeatures m_features;
 	VkPhysicalDeviceMemoryProperties m_memoryProperties;
 	VkSampleCountFlagBits m_msaaSamples;
+	std::vector<VkPhysicalDevice> m_deviceGroup;
+	DeviceGroupMode m_deviceGroupMode;
 };
 }
@@ -1,5 +1,6 @@
 #include "Surface.hpp"
 
+#include "Engine/Engine.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Instance.hpp"
 #include "PhysicalDevice.hpp"
@@ -14,8 +15,22 @@ Surface::Surface(const Instance *instance, const PhysicalDevice *physicalDevice)
 	m_capabilities({}),
 	m_format({})
 {
-	// Creates the surface.
-	Window::Get()->CreateSurface(*m_instance, nullptr, &m_surface);
+	// Creates the surface, headless engines without a headless surface leave it null and render to offscreen swapchain images.
+	if (Engine::Get()->HasModule<Window>())
+	{
+		Window::Get()->CreateSurface(*m_instance, nullptr, &m_surface);
+	}
+	else if (m_instance->IsHeadlessSurface())
+	{
+		Graphics::CheckVk(Instance::FvkCreateHeadlessSurfaceEXT(*m_instance, &m_surface));
+	}
+
+	if (m_surface == VK_NULL_HANDLE)
+	{
+		m_format.format = VK_FORMAT_B8G8R8A8_UNORM;
+		m_format.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+		return;
+	}
 
 	Graphics::CheckVk(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(*m_physicalDevice, m_surface, &m_capabilities));
 
@@ -58,6 +73,9 @@ Surface::Surface(const Instance *instance, const PhysicalDevice *physicalDevice)
 
 Surface::~Surface()
 {
-	vkDestroySurfaceKHR(*m_instance, m_surface, nullptr);
+	if (m_surface != VK_NULL_HANDLE)
+	{
+		vkDestroySurfaceKHR(*m_instance, m_surface, nullptr);
+	}
 }
 }
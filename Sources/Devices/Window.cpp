@@ -209,6 +209,11 @@ void Window::Update()
 	glfwPollEvents();
 }
 
+void Window::WaitEvents(const Time &timeout)
+{
+	glfwWaitEventsTimeout(std::max(timeout.AsSeconds<double>(), 0.0));
+}
+
 void Window::SetSize(const Vector2i &size)
 {
 	m_size.m_x = size.m_x == -1 ? m_size.m_x : size.m_x;
@@ -321,6 +326,11 @@ void Window::SetIconified(const bool &iconify)
 	}
 }
 
+bool Window::IsVisible() const
+{
+	return glfwGetWindowAttrib(m_window, GLFW_VISIBLE) == GLFW_TRUE;
+}
+
 std::string Window::StringifyResultGlfw(const int32_t &result)
 {
 	switch (result)
@@ -44,6 +44,12 @@ public:
 
 	void Update() override;
 
+	/**
+	 * Blocks until a window event is received or the timeout passes, then handles the events like {@link Window#Update}.
+	 * @param timeout The longest time to wait.
+	 */
+	void WaitEvents(const Time &timeout);
+
 	/**
 	 * Gets the size of the window in pixels.
 	 * @param checkFullscreen If in fullscreen and true size will be the screens size.
@@ -166,6 +172,12 @@ public:
 	 */
 	void SetIconified(const bool &iconify);
 
+	/**
+	 * Gets if the window is shown, windows are hidden while they are created.
+	 * @return If the window is visible.
+	 */
+	bool IsVisible() const;
+
 	ACID_HIDDEN GLFWwindow *GetWindow() const { return m_window; }
 
 	const std::vector<std::unique_ptr<Monitor>> &GetMonitors() const { return m_monitors; };
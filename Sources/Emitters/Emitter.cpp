@@ -0,0 +1,69 @@
+#include "Emitter.hpp"
+
+#include "Engine/FrameAllocator.hpp"
+#include "Maths/Simd.hpp"
+
+namespace acid
+{
+void Emitter::GeneratePositions(Vector3f *positions, const uint32_t &count) const
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		positions[i] = GeneratePosition();
+	}
+}
+
+void Emitter::RandomUnitVectors(Vector3f *vectors, const uint32_t &count)
+{
+	std::pmr::vector<float> values(3 * count, FrameAllocator::Get());
+	Maths::Random(values.data(), 2 * count);
+	auto thetas = values.data();
+	auto zs = thetas + count;
+	auto roots = zs + count;
+
+	auto ones = Simd::Splat(1.0f);
+	auto twos = Simd::Splat(2.0f);
+	uint32_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		auto z = Simd::Subtract(Simd::Multiply(Simd::Load(&zs[i]), twos), ones);
+		Simd::Store(&zs[i], z);
+		Simd::Store(&roots[i], Simd::Sqrt(Simd::Max(Simd::Subtract(ones, Simd::Multiply(z, z)), Simd::Splat(0.0f))));
+	}
+
+	for (; i < count; i++)
+	{
+		zs[i] = zs[i] * 2.0f - 1.0f;
+		roots[i] = std::sqrt(std::max(1.0f - zs[i] * zs[i], 0.0f));
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		auto theta = thetas[i] * 2.0f * Maths::Pi;
+		vectors[i] = Vector3f(roots[i] * std::cos(theta), roots[i] * std::sin(theta), zs[i]);
+	}
+}
+
+void Emitter::RandomRadii(float *distances, const uint32_t &count, const float &radius)
+{
+	// The length of the point the single position emitters build from a and b is the larger of the two.
+	std::pmr::vector<float> values(2 * count, FrameAllocator::Get());
+	Maths::Random(values.data(), values.size());
+	auto a = values.data();
+	auto b = a + count;
+
+	auto radii = Simd::Splat(radius);
+	uint32_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		Simd::Store(&distances[i], Simd::Multiply(Simd::Max(Simd::Load(&a[i]), Simd::Load(&b[i])), radii));
+	}
+
+	for (; i < count; i++)
+	{
+		distances[i] = std::max(a[i], b[i]) * radius;
+	}
+}
+}
@@ -20,6 +20,13 @@ public:
 	 */
 	virtual Vector3f GeneratePosition() const = 0;
 
+	/**
+	 * Creates many new objects positions, emitters that override this draw the random values of the whole batch at once.
+	 * @param positions The positions to write.
+	 * @param count The number of positions.
+	 */
+	virtual void GeneratePositions(Vector3f *positions, const uint32_t &count) const;
+
 	static Vector3f RandomUnitVector()
 	{
 		auto theta = Maths::Random(0.0f, 1.0f) * 2.0f * Maths::Pi;
@@ -29,5 +36,20 @@ public:
 		auto y = rootOneMinusZSquared * std::sin(theta);
 		return Vector3f(x, y, z);
 	}
+
+	/**
+	 * Writes random unit vectors with the same spread as {@link Emitter#RandomUnitVector}, the square roots are taken four at a time.
+	 * @param vectors The vectors to write.
+	 * @param count The number of vectors.
+	 */
+	static void RandomUnitVectors(Vector3f *vectors, const uint32_t &count);
+
+	/**
+	 * Writes random distances from the centre that spread points evenly over a disc, the larger of two random values as the single position emitters use.
+	 * @param distances The distances to write.
+	 * @param count The number of distances.
+	 * @param radius The radius of the disc.
+	 */
+	static void RandomRadii(float *distances, const uint32_t &count, const float &radius);
 };
 }
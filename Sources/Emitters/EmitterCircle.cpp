@@ -1,5 +1,6 @@
 ﻿#include "EmitterCircle.hpp"
 
+#include "Engine/FrameAllocator.hpp"
 #include "Scenes/Entity.hpp"
 
 namespace acid
@@ -48,6 +49,26 @@ Vector3f EmitterCircle::GeneratePosition() const
 	return Vector3f(direction * distance);
 }
 
+void EmitterCircle::GeneratePositions(Vector3f *positions, const uint32_t &count) const
+{
+	std::pmr::vector<float> distances(count, FrameAllocator::Get());
+	Emitter::RandomRadii(distances.data(), count, m_radius);
+	Emitter::RandomUnitVectors(positions, count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		auto direction = positions[i].Cross(m_heading);
+
+		// Vectors parallel to the heading are drawn again, as in the single position.
+		while (direction.Length() == 0.0f)
+		{
+			direction = Emitter::RandomUnitVector().Cross(m_heading);
+		}
+
+		positions[i] = direction.Normalize() * distances[i];
+	}
+}
+
 const Metadata &operator>>(const Metadata &metadata, EmitterCircle &emitter)
 {
 	metadata.GetChild("Radius", emitter.m_radius);
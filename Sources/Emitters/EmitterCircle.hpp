@@ -16,6 +16,8 @@ public:
 
 	Vector3f GeneratePosition() const override;
 
+	void GeneratePositions(Vector3f *positions, const uint32_t &count) const override;
+
 	const float &GetRadius() const { return m_radius; }
 
 	void SetRadius(const float &radius) { m_radius = radius; }
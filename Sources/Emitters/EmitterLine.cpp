@@ -1,5 +1,6 @@
 ﻿#include "EmitterLine.hpp"
 
+#include "Engine/FrameAllocator.hpp"
 #include "Maths/Maths.hpp"
 #include "Scenes/Entity.hpp"
 
@@ -24,6 +25,18 @@ Vector3f EmitterLine::GeneratePosition() const
 	return m_axis * m_length * Maths::Random(-0.5f, 0.5f);
 }
 
+void EmitterLine::GeneratePositions(Vector3f *positions, const uint32_t &count) const
+{
+	std::pmr::vector<float> offsets(count, FrameAllocator::Get());
+	Maths::Random(offsets.data(), count, -0.5f, 0.5f);
+	auto axis = m_axis * m_length;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		positions[i] = axis * offsets[i];
+	}
+}
+
 const Metadata &operator>>(const Metadata &metadata, EmitterLine &emitter)
 {
 	metadata.GetChild("Length", emitter.m_length);
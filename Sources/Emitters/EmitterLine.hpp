@@ -16,6 +16,8 @@ public:
 
 	Vector3f GeneratePosition() const override;
 
+	void GeneratePositions(Vector3f *positions, const uint32_t &count) const override;
+
 	const float &GetLength() const { return m_length; }
 
 	void SetLength(const float &length) { m_length = length; }
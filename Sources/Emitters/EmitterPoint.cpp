@@ -21,6 +21,11 @@ Vector3f EmitterPoint::GeneratePosition() const
 	return m_point;
 }
 
+void EmitterPoint::GeneratePositions(Vector3f *positions, const uint32_t &count) const
+{
+	std::fill(positions, positions + count, m_point);
+}
+
 const Metadata &operator>>(const Metadata &metadata, EmitterPoint &emitter)
 {
 	metadata.GetChild("Point", emitter.m_point);
@@ -16,6 +16,8 @@ public:
 
 	Vector3f GeneratePosition() const override;
 
+	void GeneratePositions(Vector3f *positions, const uint32_t &count) const override;
+
 	const Vector3f &GetPoint() const { return m_point; }
 
 	void SetPoint(const Vector3f &point) { m_point = point; }
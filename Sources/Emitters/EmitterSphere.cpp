@@ -1,5 +1,6 @@
 ﻿#include "EmitterSphere.hpp"
 
+#include "Engine/FrameAllocator.hpp"
 #include "Maths/Maths.hpp"
 #include "Maths/Vector2.hpp"
 #include "Scenes/Entity.hpp"
@@ -37,6 +38,18 @@ Vector3f EmitterSphere::GeneratePosition() const
 	return m_radius * distance * Emitter::RandomUnitVector();
 }
 
+void EmitterSphere::GeneratePositions(Vector3f *positions, const uint32_t &count) const
+{
+	std::pmr::vector<float> distances(count, FrameAllocator::Get());
+	Emitter::RandomRadii(distances.data(), count, m_radius);
+	Emitter::RandomUnitVectors(positions, count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		positions[i] *= distances[i];
+	}
+}
+
 const Metadata &operator>>(const Metadata &metadata, EmitterSphere &emitter)
 {
 	metadata.GetChild("Radius", emitter.m_radius);
@@ -1,22 +1,29 @@
 #include "Engine.hpp"
 
 #include <chrono>
+#include <thread>
 #include "Maths/Maths.hpp"
+#include "FrameAllocator.hpp"
+#include "MemoryTracker.hpp"
 
+#include "Files/Files.hpp"
+#include "Resources/Resources.hpp"
+#include "Scenes/Scenes.hpp"
+#include "Telemetry/Telemetry.hpp"
+#include "Timers/Timers.hpp"
+#if !defined(ACID_BUILD_SERVER)
 #include "Audio/Audio.hpp"
 #include "Devices/Joysticks.hpp"
 #include "Devices/Keyboard.hpp"
 #include "Devices/Mouse.hpp"
 #include "Devices/Window.hpp"
-#include "Files/Files.hpp"
 #include "Gizmos/Gizmos.hpp"
 #include "Particles/Particles.hpp"
 #include "Graphics/Graphics.hpp"
-#include "Resources/Resources.hpp"
-#include "Scenes/Scenes.hpp"
+#include "Materials/PipelineMaterial.hpp"
 #include "Shadows/Shadows.hpp"
-#include "Timers/Timers.hpp"
 #include "Uis/Uis.hpp"
+#endif
 
 namespace acid
 {
@@ -26,40 +33,116 @@ using MicrosecondsType = std::chrono::duration<int64_t, std::micro>;
 Engine *Engine::INSTANCE = nullptr;
 std::chrono::time_point<HighResolutionClock> TIME_START = HighResolutionClock::now();
 
+static const Time MAX_FRAME_TIME = Time::Seconds(0.25f);
+static const uint32_t MAX_UPDATE_STEPS = 5;
+// Sleeping is only accurate to around a millisecond on most platforms, the final stretch before a deadline is yielded instead.
+static const Time SLEEP_MARGIN = Time::Milliseconds(2);
+
+static void WaitUntil(const Time &deadline)
+{
+	while (true)
+	{
+		auto remaining = deadline - Engine::GetTime();
+
+		if (remaining <= Time())
+		{
+			return;
+		}
+
+		if (remaining > SLEEP_MARGIN)
+		{
+			std::this_thread::sleep_for(MicrosecondsType((remaining - SLEEP_MARGIN).AsMicroseconds()));
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
 Engine::Engine(std::string argv0, const bool &emptyRegister) :
+	Engine(std::move(argv0), Config{ emptyRegister })
+{
+}
+
+Engine::Engine(std::string argv0, const Config &config) :
 	m_game(nullptr),
 	m_argv0(std::move(argv0)),
+	m_config(config),
 	m_fpsLimit(-1.0f),
+	m_upsLimit(68.0f),
+	m_updateAlpha(0.0f),
+	m_presentPacing(true),
+	m_powerState(PowerState::Foreground),
 	m_running(true),
-	m_timerUpdate(Time::Seconds(1.0f / 68.0f)),
-	m_timerRender(Time::Seconds(1.0f / -1.0f)),
 	m_ups(),
 	m_fps()
 {
 	INSTANCE = this;
 	Log::OpenLog("Logs/" + GetDateTime() + ".log");
 
-	if (!emptyRegister)
+#if defined(ACID_BUILD_SERVER)
+	m_config.m_server = true;
+#endif
+
+	// The default modules are created concurrently, such as the graphics device while audio and files open, only windowing is kept on this thread.
+	if (!m_config.m_emptyRegister && m_config.m_server)
 	{
-		AddModule<Window>(Module::Stage::Always);
-		AddModule<Graphics>(Module::Stage::Render);
-		AddModule<Audio>(Module::Stage::Pre);
-		AddModule<Joysticks>(Module::Stage::Pre);
-		AddModule<Keyboard>(Module::Stage::Pre);
-		AddModule<Mouse>(Module::Stage::Pre);
-		AddModule<Files>(Module::Stage::Pre);
-		AddModule<Scenes>(Module::Stage::Normal);
-		AddModule<Gizmos>(Module::Stage::Normal);
-		AddModule<Resources>(Module::Stage::Pre);
-		AddModule<Uis>(Module::Stage::Pre);
-		AddModule<Particles>(Module::Stage::Normal);
-		AddModule<Shadows>(Module::Stage::Normal);
-		AddModule<Timers>(Module::Stage::Always);
+		QueueModule<Files>(Module::Stage::Pre);
+		QueueModule<Scenes>(Module::Stage::Normal);
+		QueueModule<Resources>(Module::Stage::Pre);
+		QueueModule<Timers>(Module::Stage::Always);
+		QueueModule<Telemetry>(Module::Stage::Always);
+	}
+#if !defined(ACID_BUILD_SERVER)
+	else if (!m_config.m_emptyRegister)
+	{
+		// Headless engines have no window to read input from, the graphics module renders without one.
+		if (!m_config.m_headless)
+		{
+			QueueModule<Window>(Module::Stage::Always, true);
+		}
+
+		QueueModule<Graphics, Window>(Module::Stage::Render);
+		QueueModule<Audio>(Module::Stage::Pre);
+
+		if (!m_config.m_headless)
+		{
+			QueueModule<Joysticks, Window>(Module::Stage::Pre, true);
+			QueueModule<Keyboard, Window>(Module::Stage::Pre, true);
+			QueueModule<Mouse, Window>(Module::Stage::Pre, true);
+		}
+
+		QueueModule<Files>(Module::Stage::Pre);
+		QueueModule<Scenes>(Module::Stage::Normal);
+		QueueModule<Gizmos>(Module::Stage::Normal);
+		QueueModule<Resources>(Module::Stage::Pre);
+		QueueModule<Uis>(Module::Stage::Pre);
+		QueueModule<Particles>(Module::Stage::Normal);
+		QueueModule<Shadows>(Module::Stage::Normal);
+		QueueModule<Timers>(Module::Stage::Always);
+		QueueModule<Telemetry>(Module::Stage::Always);
 	}
+#endif
+
+	CreateModules();
 }
 
 int32_t Engine::Run()
 {
+	auto lastTime = GetTime();
+	auto nextRender = lastTime;
+	Time accumulator;
+#if !defined(ACID_BUILD_SERVER)
+	uint64_t presentCount = 0;
+
+	// Pipelines start compiling on the job system while the first frames are prepared, variants of render stages that do not exist yet compile once first bound.
+	if (!m_config.m_pipelineManifest.empty() && HasModule<Graphics>() && HasModule<Files>())
+	{
+		m_warmPipelines = PipelineMaterial::Precompile(m_config.m_pipelineManifest);
+	}
+#endif
+
 	while (m_running)
 	{
 		if (m_game != nullptr)
@@ -67,54 +150,193 @@ int32_t Engine::Run()
 			m_game->Update();
 		}
 
-		m_timerRender.SetInterval(Time::Seconds(1.0f / m_fpsLimit));
+		// A window going to or from the background renders straight away, so focusing or restoring it shows a new frame without waiting.
+		if (auto powerState = FindPowerState(); powerState != m_powerState)
+		{
+			m_powerState = powerState;
+			nextRender = GetTime();
+		}
+
+		auto fpsLimit = m_fpsLimit;
+		auto upsLimit = m_upsLimit;
+		auto renderSkipped = m_powerState == PowerState::Hidden && m_powerPolicy.m_hiddenFps <= 0.0f;
+
+		if (m_powerState != PowerState::Foreground)
+		{
+			auto backgroundFps = m_powerState == PowerState::Hidden ? m_powerPolicy.m_hiddenFps : m_powerPolicy.m_backgroundFps;
+
+			if (backgroundFps > 0.0f)
+			{
+				fpsLimit = m_fpsLimit > 0.0f ? std::min(m_fpsLimit, backgroundFps) : backgroundFps;
+			}
+
+			if (m_powerPolicy.m_backgroundUps > 0.0f)
+			{
+				upsLimit = std::min(m_upsLimit, m_powerPolicy.m_backgroundUps);
+			}
+		}
+
+		auto updateInterval = Time::Seconds(1.0f / upsLimit);
+		auto renderInterval = fpsLimit > 0.0f ? Time::Seconds(1.0f / fpsLimit) : Time();
+
+		// Accumulates real time, clamped so a stall or time offset change does not cause a spiral of catch up updates.
+		auto now = GetTime();
+
+		// Fixed frames hold the engine time to one update interval past the last frame, however long the last frame really took.
+		if (m_config.m_fixedFrames)
+		{
+			m_timeOffset += lastTime + updateInterval - now;
+			now = lastTime + updateInterval;
+		}
+
+		accumulator += std::clamp(now - lastTime, Time(), MAX_FRAME_TIME);
+		lastTime = now;
+
+#if defined(ACID_BUILD_SERVER)
+		auto presentPaced = false;
+#else
+		// The display already paces frames when it presents slower than the fps limit.
+		auto swapchain = m_presentPacing && HasModule<Graphics>() ? Graphics::Get()->GetSwapchain() : nullptr;
+		auto presentPaced = swapchain != nullptr && swapchain->IsVsync() && swapchain->GetPresentInterval() >= renderInterval;
+#endif
+		auto renderDue = !renderSkipped && (GetTime() >= nextRender || presentPaced || m_config.m_fixedFrames);
+
+#if !defined(ACID_BUILD_SERVER)
+		// Waits for the frame before input is sampled, so the input used to record it is as new as possible.
+		if (renderDue && HasModule<Graphics>())
+		{
+			Graphics::Get()->WaitForFrame();
+		}
+#endif
 
 		// Always-Update.
-		m_modules.UpdateStage(Module::Stage::Always);
+		m_modules.UpdateStage(Module::Stage::Always, &m_threadPool);
 
-		if (m_timerUpdate.IsPassedTime())
+		uint32_t steps = 0;
+
+		while (accumulator >= updateInterval && m_running)
 		{
-			// Resets the timer.
-			m_timerUpdate.ResetStartTime();
+			// Drops the remaining time when updates can not keep up.
+			if (steps == MAX_UPDATE_STEPS)
+			{
+				accumulator = Time();
+				break;
+			}
+
+			accumulator -= updateInterval;
+			steps++;
 			m_ups.Update(GetTime().AsSeconds());
 
 			// Pre-Update.
-			m_modules.UpdateStage(Module::Stage::Pre);
+			m_modules.UpdateStage(Module::Stage::Pre, &m_threadPool);
 
 			// Update.
-			m_modules.UpdateStage(Module::Stage::Normal);
+			m_modules.UpdateStage(Module::Stage::Normal, &m_threadPool);
 
 			// Post-Update.
-			m_modules.UpdateStage(Module::Stage::Post);
+			m_modules.UpdateStage(Module::Stage::Post, &m_threadPool);
 
 			// Updates the engines delta.
-			m_deltaUpdate.Update();
+			m_deltaUpdate.Update(updateInterval);
 		}
 
-		// Prioritize updates over rendering.
-		if (!Maths::AlmostEqual(m_timerUpdate.GetInterval().AsSeconds(), m_deltaUpdate.GetChange().AsSeconds(), 0.8f))
+		m_updateAlpha = accumulator / updateInterval;
+
+		// Frame scratch memory is released at the end of a render, without one it is released after the updates.
+		if (renderSkipped && steps != 0)
 		{
-			continue;
+			FrameAllocator::EndFrame();
 		}
 
 		// Renders when needed.
-		if (m_timerRender.IsPassedTime())
+		if (renderDue)
 		{
-			// Resets the timer.
-			m_timerRender.ResetStartTime();
+			// Schedules from the last deadline to hold the rate, unless the deadline was missed by a whole frame.
+			nextRender = std::max(nextRender + renderInterval, GetTime());
 			m_fps.Update(GetTime().AsSeconds());
 
+			if (HasModule<Scenes>())
+			{
+				Scenes::Get()->Interpolate(m_updateAlpha);
+			}
+
 			// Render
 			m_modules.UpdateStage(Module::Stage::Render);
+			MemoryTracker::EndFrame(m_profiler);
+			m_profiler.EndFrame();
+			FrameAllocator::EndFrame();
 
 			// Updates the render delta, and render time extension.
 			m_deltaRender.Update();
 		}
+
+#if defined(ACID_BUILD_SERVER)
+		auto presented = false;
+#else
+		// Rendering without a limit is paced by presentation, there is nothing to wait for unless nothing was presented (e.g. the window is iconified).
+		swapchain = HasModule<Graphics>() ? Graphics::Get()->GetSwapchain() : nullptr;
+		auto presented = swapchain != nullptr && swapchain->GetPresentCount() != presentCount;
+		presentCount = swapchain != nullptr ? swapchain->GetPresentCount() : 0;
+#endif
+
+		if (((fpsLimit <= 0.0f || presentPaced) && presented) || m_config.m_fixedFrames)
+		{
+			continue;
+		}
+
+		// Sleeps until the next update or render deadline.
+		auto deadline = GetTime() + (updateInterval - accumulator);
+
+		if (fpsLimit > 0.0f && !presentPaced && !renderSkipped)
+		{
+			deadline = std::min(deadline, nextRender);
+		}
+
+		// While throttled the loop blocks on window events, focusing or restoring the window wakes it before the deadline.
+		if (m_powerState != PowerState::Foreground)
+		{
+#if !defined(ACID_BUILD_SERVER)
+			while (m_running && FindPowerState() == m_powerState && GetTime() < deadline)
+			{
+				Window::Get()->WaitEvents(deadline - GetTime());
+			}
+#endif
+
+			continue;
+		}
+
+		WaitUntil(deadline);
 	}
 
 	return EXIT_SUCCESS;
 }
 
+Engine::PowerState Engine::FindPowerState() const
+{
+#if defined(ACID_BUILD_SERVER)
+	return PowerState::Foreground;
+#else
+	if (!m_powerPolicy.m_enabled || m_config.m_fixedFrames || !HasModule<Window>())
+	{
+		return PowerState::Foreground;
+	}
+
+	auto window = Window::Get();
+
+	if (window->IsIconified() || !window->IsVisible())
+	{
+		return PowerState::Hidden;
+	}
+
+	if (!window->IsFocused())
+	{
+		return PowerState::Background;
+	}
+
+	return PowerState::Foreground;
+#endif
+}
+
 Time Engine::GetTime()
 {
 	auto duration = Time::Microseconds(std::chrono::duration_cast<MicrosecondsType>(HighResolutionClock::now() - TIME_START).count());
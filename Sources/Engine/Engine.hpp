@@ -4,11 +4,15 @@
 #include "Maths/Delta.hpp"
 #include "Maths/Time.hpp"
 #include "Maths/Timer.hpp"
+#include "Maths/Vector2.hpp"
 #include "ModuleHolder.hpp"
+#include "Profiler.hpp"
 #include "Game.hpp"
 
 namespace acid
 {
+class PipelineMaterial;
+
 class ACID_EXPORT ChangePerSecond
 {
 public:
@@ -42,6 +46,58 @@ public:
 	 */
 	static Engine *Get() { return INSTANCE; }
 
+	/**
+	 * @brief The options the engine is created with.
+	 */
+	class Config
+	{
+	public:
+		/// If the module register will start empty.
+		bool m_emptyRegister = false;
+		/// If the engine runs without a window, the Window, Mouse, Keyboard and Joysticks modules are not registered and frames are rendered offscreen.
+		bool m_headless = false;
+		/// The size frames are rendered at when headless.
+		Vector2ui m_headlessSize = Vector2ui(1920, 1080);
+		/// If a headless engine presents to a VK_EXT_headless_surface when the driver has one, instead of to offscreen images.
+		bool m_headlessSurface = false;
+		/// If every frame runs exactly one update and advances the engine time by the update interval, however long it really takes, so captures are deterministic and render as fast as possible.
+		bool m_fixedFrames = false;
+		/// If the engine is a dedicated server, only the Files, Resources, Scenes and Timers modules are registered. The AcidServer library is always a server.
+		bool m_server = false;
+		/// A manifest written by {@link PipelineMaterial#RecordManifest}, its pipeline variants start compiling before the first frame. Empty disables the warmup.
+		std::string m_pipelineManifest;
+	};
+
+	/**
+	 * @brief The state of the window the power policy throttles for.
+	 */
+	enum class PowerState
+	{
+		/// The window is focused, or there is no window, the fps and ups limits are used.
+		Foreground,
+		/// The window is shown but not focused.
+		Background,
+		/// The window is iconified or not visible.
+		Hidden
+	};
+
+	/**
+	 * @brief How the engine throttles rendering and updates while its window is in the background, so it does not use the GPU and battery at full rate.
+	 * While throttled the engine blocks on window events between frames, so it resumes as soon as the window is focused or restored.
+	 */
+	class PowerPolicy
+	{
+	public:
+		/// If the engine is throttled while the window is in the background or hidden.
+		bool m_enabled = true;
+		/// The frames per second rendered while the window is unfocused, -1 keeps the fps limit.
+		float m_backgroundFps = 30.0f;
+		/// The frames per second rendered while the window is hidden, 0 skips rendering and presentation entirely.
+		float m_hiddenFps = 0.0f;
+		/// The updates per second while the window is unfocused or hidden, -1 keeps the ups limit.
+		float m_backgroundUps = -1.0f;
+	};
+
 	/**
 	 * Carries out the setup for basic engine components and the engine. Call {@link Engine#Run} after creating a instance.
 	 * @param argv0 The first argument passed to main.
@@ -49,6 +105,13 @@ public:
 	 */
 	explicit Engine(std::string argv0, const bool &emptyRegister = false);
 
+	/**
+	 * Carries out the setup for the engine with options such as headless rendering. Call {@link Engine#Run} after creating a instance.
+	 * @param argv0 The first argument passed to main.
+	 * @param config The options to create the engine with.
+	 */
+	Engine(std::string argv0, const Config &config);
+
 	/**
 	 * The update function for the updater.
 	 * @return {@code EXIT_SUCCESS} or {@code EXIT_FAILURE}
@@ -90,6 +153,24 @@ public:
 		m_modules.Add<T>(stage, std::make_unique<T>(std::forward<Args>(args)...));
 	}
 
+	/**
+	 * Queues a Module to be created by {@link Engine#CreateModules}, queued modules that do not depend on each other are created concurrently.
+	 * @tparam T The Module type.
+	 * @tparam Dependencies The Module types the constructor of the module reads, queued dependencies are created first.
+	 * @param stage The Module stage.
+	 * @param mainThread If the module must be created on the thread creating the engine, such as modules that call windowing functions.
+	 */
+	template<typename T, typename... Dependencies>
+	void QueueModule(const Module::Stage &stage, const bool &mainThread = false)
+	{
+		m_modules.Queue<T>(stage, { GetModuleTypeId<Dependencies>()... }, mainThread);
+	}
+
+	/**
+	 * Creates every queued Module, the engine calls this after queuing the default modules.
+	 */
+	void CreateModules() { m_modules.CreateQueued(m_threadPool); }
+
 	/**
 	 * Removes a Module.
 	 * @tparam T The Module type.
@@ -100,6 +181,18 @@ public:
 		m_modules.Remove<T>();
 	}
 
+	/**
+	 * Gets the engines profiler, it records nothing until it is enabled.
+	 * @return The profiler.
+	 */
+	Profiler *GetProfiler() { return &m_profiler; }
+
+	/**
+	 * Gets the engines job system, concurrent modules are updated on it and modules can fan their own work out on it.
+	 * @return The thread pool.
+	 */
+	ThreadPool &GetThreadPool() { return m_threadPool; }
+
 	/**
 	 * Gets the current game.
 	 * @return The renderer manager.
@@ -130,6 +223,12 @@ public:
 	 */
 	const std::string &GetArgv0() const { return m_argv0; };
 
+	/**
+	 * Gets the options the engine was created with.
+	 * @return The engine config.
+	 */
+	const Config &GetConfig() const { return m_config; }
+
 	/**
 	 * Gets the added/removed time for the engine.
 	 * @return The time offset.
@@ -154,6 +253,46 @@ public:
 	 */
 	void SetFpsLimit(const float &fpsLimit) { m_fpsLimit = fpsLimit; }
 
+	/**
+	 * Gets the fixed update rate.
+	 * @return The updates per second.
+	 */
+	const float &GetUpsLimit() const { return m_upsLimit; }
+
+	/**
+	 * Sets the fixed update rate, update stages always advance by the inverse of this.
+	 * @param upsLimit The new updates per second.
+	 */
+	void SetUpsLimit(const float &upsLimit) { m_upsLimit = upsLimit; }
+
+	/**
+	 * Gets how far rendering is between the last and next fixed update, used to interpolate state when rendering.
+	 * @return The interpolation alpha, between 0 and 1.
+	 */
+	const float &GetUpdateAlpha() const { return m_updateAlpha; }
+
+	/**
+	 * Gets if the swapchains present timing is used to pace frames, the engine will not sleep for the fps limit while the display is already slower.
+	 * @return If present pacing is used.
+	 */
+	const bool &IsPresentPacing() const { return m_presentPacing; }
+
+	/**
+	 * Sets if the swapchains present timing is used to pace frames.
+	 * @param presentPacing If present pacing is used.
+	 */
+	void SetPresentPacing(const bool &presentPacing) { m_presentPacing = presentPacing; }
+
+	const PowerPolicy &GetPowerPolicy() const { return m_powerPolicy; }
+
+	void SetPowerPolicy(const PowerPolicy &powerPolicy) { m_powerPolicy = powerPolicy; }
+
+	/**
+	 * Gets the state of the window the loop is currently throttled for.
+	 * @return The power state, always foreground while the policy is disabled, the engine is headless or uses fixed frames.
+	 */
+	const PowerState &GetPowerState() const { return m_powerState; }
+
 	/**
 	 * Gets if the engine is running.
 	 * @return If the engine is running.
@@ -161,7 +300,7 @@ public:
 	const bool &IsRunning() const { return m_running; }
 
 	/**
-	 * Gets the delta (seconds) between updates.
+	 * Gets the delta (seconds) between updates, this is the fixed update interval.
 	 * @return The delta between updates.
 	 */
 	const Time &GetDelta() const { return m_deltaUpdate.GetChange(); }
@@ -191,21 +330,36 @@ public:
 	void RequestClose(const bool &error) { m_running = false; }
 
 private:
+	/**
+	 * Gets the power state from the window.
+	 * @return The power state.
+	 */
+	PowerState FindPowerState() const;
+
 	static ACID_STATE Engine *INSTANCE;
 
+	Profiler m_profiler;
+	ThreadPool m_threadPool;
 	ModuleHolder m_modules;
 	std::unique_ptr<Game> m_game;
 
 	std::string m_argv0;
+	Config m_config;
 	Time m_timeOffset;
 	float m_fpsLimit;
+	float m_upsLimit;
+	float m_updateAlpha;
+	bool m_presentPacing;
+	PowerPolicy m_powerPolicy;
+	PowerState m_powerState;
 	bool m_running;
 
 	Delta m_deltaUpdate;
 	Delta m_deltaRender;
-	Timer m_timerUpdate;
-	Timer m_timerRender;
 
 	ChangePerSecond m_ups, m_fps;
+
+	// Held so the warmed pipelines are not released before they are first bound.
+	std::vector<std::shared_ptr<PipelineMaterial>> m_warmPipelines;
 };
 }
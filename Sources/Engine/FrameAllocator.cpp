@@ -0,0 +1,80 @@
+#include "FrameAllocator.hpp"
+
+namespace acid
+{
+std::atomic<uint64_t> FrameAllocator::Frame = 0;
+
+FrameAllocator *FrameAllocator::Get()
+{
+	thread_local FrameAllocator frameAllocator;
+	return &frameAllocator;
+}
+
+void FrameAllocator::EndFrame()
+{
+	Frame.fetch_add(1, std::memory_order_release);
+}
+
+FrameAllocator::FrameAllocator(const std::size_t &capacity) :
+	m_head(0),
+	m_used(0),
+	m_frame(Frame.load(std::memory_order_acquire))
+{
+	m_blocks.emplace_back(Block{ std::make_unique<uint8_t[]>(capacity), capacity });
+}
+
+void *FrameAllocator::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	if (auto frame = Frame.load(std::memory_order_acquire); frame != m_frame)
+	{
+		m_frame = frame;
+		Rewind();
+	}
+
+	auto &block = m_blocks.back();
+	auto address = reinterpret_cast<uintptr_t>(block.m_data.get()) + m_head;
+	auto padding = (alignment - address % alignment) % alignment;
+
+	if (m_head + padding + bytes > block.m_size)
+	{
+		// Blocks are fresh from the heap, so at most alignment - 1 bytes are skipped to align the first allocation.
+		auto size = std::max(m_blocks.front().m_size, bytes + alignment);
+		m_blocks.emplace_back(Block{ std::make_unique<uint8_t[]>(size), size });
+		m_head = 0;
+		return do_allocate(bytes, alignment);
+	}
+
+	m_head += padding + bytes;
+	m_used += bytes;
+	return reinterpret_cast<void *>(address + padding);
+}
+
+void FrameAllocator::do_deallocate(void *p, std::size_t bytes, std::size_t alignment)
+{
+}
+
+bool FrameAllocator::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+	return this == &other;
+}
+
+void FrameAllocator::Rewind()
+{
+	// The overflow of the last frame is merged into the first block, the next frame of the same size fits in one block.
+	if (m_blocks.size() > 1)
+	{
+		std::size_t capacity = 0;
+
+		for (const auto &block : m_blocks)
+		{
+			capacity += block.m_size;
+		}
+
+		m_blocks.clear();
+		m_blocks.emplace_back(Block{ std::make_unique<uint8_t[]>(capacity), capacity });
+	}
+
+	m_head = 0;
+	m_used = 0;
+}
+}
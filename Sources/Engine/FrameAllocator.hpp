@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <memory_resource>
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+/**
+ * @brief A per thread bump allocator for temporaries that live until the end of the frame, used through std::pmr containers.
+ * Deallocation does nothing, every thread rewinds its allocator the first time it allocates after {@link FrameAllocator#EndFrame}.
+ * When a frame needs more than the allocator holds, the overflow blocks are merged into one larger block on the rewind,
+ * so once frames are steady the allocator does not use the global heap.
+ * Memory from this allocator must not be kept past the end of the frame it was allocated in, or used by work that runs across frames such as resource loading.
+ */
+class ACID_EXPORT FrameAllocator :
+	public std::pmr::memory_resource,
+	public NonCopyable
+{
+public:
+	/**
+	 * Gets the frame allocator of the calling thread.
+	 * @return The frame allocator.
+	 */
+	static FrameAllocator *Get();
+
+	/**
+	 * Ends the frame for every thread, called by the engine once a frame has been rendered.
+	 */
+	static void EndFrame();
+
+	explicit FrameAllocator(const std::size_t &capacity = 256 * 1024);
+
+	/**
+	 * Gets the bytes this allocator can hand out before it needs another block.
+	 * @return The capacity of the first block.
+	 */
+	std::size_t GetCapacity() const { return m_blocks.front().m_size; }
+
+	/**
+	 * Gets the bytes allocated from this allocator since it was last rewound.
+	 * @return The used bytes.
+	 */
+	const std::size_t &GetUsed() const { return m_used; }
+
+private:
+	class Block
+	{
+	public:
+		std::unique_ptr<uint8_t[]> m_data;
+		std::size_t m_size = 0;
+	};
+
+	void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+	void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+
+	bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+	void Rewind();
+
+	static std::atomic<uint64_t> Frame;
+
+	std::vector<Block> m_blocks;
+	std::size_t m_head;
+	std::size_t m_used;
+	uint64_t m_frame;
+};
+}
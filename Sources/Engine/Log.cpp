@@ -1,5 +1,8 @@
 #include "Log.hpp"
 
+#include <chrono>
+#include <cctype>
+#include <condition_variable>
 #include <fstream>
 #if defined(ACID_BUILD_WINDOWS)
 #include <Windows.h>
@@ -8,34 +11,654 @@
 
 namespace acid
 {
-std::mutex Log::MUTEX = std::mutex();
-std::ofstream Log::STREAM = std::ofstream();
+std::atomic<Log::Level> Log::LEVEL(Log::Level::Info);
+std::atomic<uint32_t> Log::RATE_LIMIT(1000);
+
+namespace
+{
+// The number of messages each thread can queue before it waits on the writer, this must be a power of two.
+const uint32_t RING_CAPACITY = 256;
+// Messages with a larger format and args are formatted when they are queued.
+const std::size_t PAYLOAD_SIZE = 240;
+const std::chrono::milliseconds FLUSH_INTERVAL(10);
+
+class LogRecord
+{
+public:
+	uint64_t m_sequence = 0;
+	Log::Level m_level = Log::Level::Info;
+	bool m_plain = true;
+	bool m_external = false;
+	uint8_t m_argCount = 0;
+	std::array<char, PAYLOAD_SIZE> m_payload;
+	std::string m_text;
+};
+
+class LogRateWindow
+{
+public:
+	int64_t m_start = 0;
+	uint32_t m_count = 0;
+	uint32_t m_suppressed = 0;
+};
+
+/**
+ * A single producer single consumer queue of records, the producer is the thread that owns it and the consumer is whoever holds the drain lock.
+ */
+class LogRing
+{
+public:
+	LogRing() :
+		m_records(RING_CAPACITY),
+		m_head(0),
+		m_tail(0)
+	{
+	}
+
+	std::vector<LogRecord> m_records;
+	std::atomic<uint32_t> m_head;
+	std::atomic<uint32_t> m_tail;
+
+	// Only touched by the owning thread.
+	std::unordered_map<const char *, LogRateWindow> m_rates;
+};
+
+class LogWriter
+{
+public:
+	LogWriter();
+
+	~LogWriter();
+
+	std::shared_ptr<LogRing> Register();
+
+	void Notify();
+
+	void Drain();
+
+	void OpenLog(const std::string &filename);
+
+private:
+	std::mutex m_drainMutex;
+	std::ofstream m_stream;
+
+	std::mutex m_ringsMutex;
+	std::vector<std::shared_ptr<LogRing>> m_rings;
+
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+	bool m_running;
+	std::thread m_thread;
+};
+
+std::atomic<bool> WRITER_DESTROYED(false);
+std::atomic<uint64_t> SEQUENCE(0);
+std::mutex FALLBACK_MUTEX;
+
+LogWriter &GetWriter()
+{
+	static LogWriter writer;
+	return writer;
+}
+
+/**
+ * Starts the writer on the first message, after the writer has been destroyed messages are written synchronously.
+ */
+bool IsWriterAlive()
+{
+	if (WRITER_DESTROYED)
+	{
+		return false;
+	}
+
+	GetWriter();
+	return true;
+}
+
+LogRing &GetRing()
+{
+	thread_local std::shared_ptr<LogRing> ring = GetWriter().Register();
+	return *ring;
+}
+
+int64_t AsSigned(const Log::Arg &arg)
+{
+	switch (arg.m_type)
+	{
+	case Log::Arg::Type::Signed:
+		return arg.m_signed;
+	case Log::Arg::Type::Unsigned:
+		// Reinterprets the value at its own width, as printf would.
+		switch (arg.m_size)
+		{
+		case 1:
+			return static_cast<int8_t>(arg.m_unsigned);
+		case 2:
+			return static_cast<int16_t>(arg.m_unsigned);
+		case 4:
+			return static_cast<int32_t>(arg.m_unsigned);
+		default:
+			return static_cast<int64_t>(arg.m_unsigned);
+		}
+	case Log::Arg::Type::Float:
+		return static_cast<int64_t>(arg.m_float);
+	case Log::Arg::Type::Pointer:
+		return static_cast<int64_t>(reinterpret_cast<uintptr_t>(arg.m_pointer));
+	default:
+		return 0;
+	}
+}
+
+uint64_t AsUnsigned(const Log::Arg &arg)
+{
+	switch (arg.m_type)
+	{
+	case Log::Arg::Type::Signed:
+		return arg.m_size < 8 ? static_cast<uint64_t>(arg.m_signed) & ((1ull << (arg.m_size * 8)) - 1) : static_cast<uint64_t>(arg.m_signed);
+	case Log::Arg::Type::Unsigned:
+		return arg.m_unsigned;
+	case Log::Arg::Type::Float:
+		return static_cast<uint64_t>(arg.m_float);
+	case Log::Arg::Type::Pointer:
+		return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(arg.m_pointer));
+	default:
+		return 0;
+	}
+}
+
+double AsFloat(const Log::Arg &arg)
+{
+	switch (arg.m_type)
+	{
+	case Log::Arg::Type::Signed:
+		return static_cast<double>(arg.m_signed);
+	case Log::Arg::Type::Unsigned:
+		return static_cast<double>(arg.m_unsigned);
+	case Log::Arg::Type::Float:
+		return arg.m_float;
+	default:
+		return 0.0;
+	}
+}
+
+template<typename T>
+void AppendFormat(std::string &result, const std::string &spec, const T &value)
+{
+	char buffer[128];
+	auto length = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+
+	if (length < 0)
+	{
+		return;
+	}
+
+	if (static_cast<std::size_t>(length) < sizeof(buffer))
+	{
+		result.append(buffer, static_cast<std::size_t>(length));
+		return;
+	}
+
+	auto offset = result.size();
+	result.resize(offset + length + 1);
+	snprintf(&result[offset], static_cast<std::size_t>(length) + 1, spec.c_str(), value);
+	result.resize(offset + length);
+}
+
+/**
+ * Applies a printf format one conversion at a time, length modifiers are replaced by the width the argument was stored at.
+ */
+std::string FormatArgs(const char *format, const Log::Arg *args, const std::size_t &argCount)
+{
+	std::string result;
+	std::size_t next = 0;
+
+	for (auto c = format; *c != '\0';)
+	{
+		if (*c != '%')
+		{
+			auto end = std::strchr(c, '%');
+			auto length = end == nullptr ? std::strlen(c) : static_cast<std::size_t>(end - c);
+			result.append(c, length);
+			c += length;
+			continue;
+		}
+
+		if (c[1] == '%')
+		{
+			result += '%';
+			c += 2;
+			continue;
+		}
+
+		std::string spec = "%";
+		auto s = c + 1;
+
+		while (*s != '\0' && std::strchr("-+ #0", *s) != nullptr)
+		{
+			spec += *s++;
+		}
+
+		while (*s != '\0' && (std::isdigit(static_cast<unsigned char>(*s)) || *s == '.'))
+		{
+			spec += *s++;
+		}
+
+		while (*s != '\0' && std::strchr("hljztL", *s) != nullptr)
+		{
+			s++;
+		}
+
+		auto conversion = *s;
+
+		if (conversion == '\0' || next >= argCount)
+		{
+			result.append(c, conversion == '\0' ? std::strlen(c) : static_cast<std::size_t>(s - c + 1));
+			c = conversion == '\0' ? s : s + 1;
+			continue;
+		}
+
+		c = s + 1;
+		const auto &arg = args[next++];
+
+		switch (conversion)
+		{
+		case 'd':
+		case 'i':
+			AppendFormat(result, spec + "lld", static_cast<long long>(AsSigned(arg)));
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'o':
+			AppendFormat(result, spec + "ll" + conversion, static_cast<unsigned long long>(AsUnsigned(arg)));
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			AppendFormat(result, spec + conversion, AsFloat(arg));
+			break;
+		case 'c':
+			AppendFormat(result, spec + conversion, static_cast<int>(AsSigned(arg)));
+			break;
+		case 's':
+			AppendFormat(result, spec + conversion, arg.m_type == Log::Arg::Type::String && arg.m_string != nullptr ? arg.m_string : "(null)");
+			break;
+		case 'p':
+			AppendFormat(result, spec + conversion, arg.m_type == Log::Arg::Type::Pointer ? arg.m_pointer : nullptr);
+			break;
+		default:
+			result += spec;
+			result += conversion;
+			break;
+		}
+	}
+
+	return result;
+}
+
+std::string FormatRecord(const LogRecord &record)
+{
+	if (record.m_external)
+	{
+		return record.m_text;
+	}
+
+	auto format = record.m_payload.data();
+
+	if (record.m_plain)
+	{
+		return format;
+	}
+
+	auto offset = std::strlen(format) + 1;
+	offset = (offset + alignof(Log::Arg) - 1) / alignof(Log::Arg) * alignof(Log::Arg);
+
+	std::array<Log::Arg, std::numeric_limits<uint8_t>::max()> args;
+	std::memcpy(args.data(), record.m_payload.data() + offset, record.m_argCount * sizeof(Log::Arg));
+
+	for (uint32_t i = 0; i < record.m_argCount; i++)
+	{
+		if (args[i].m_type == Log::Arg::Type::String)
+		{
+			args[i].m_string = args[i].m_unsigned == 0 ? nullptr : record.m_payload.data() + args[i].m_unsigned;
+		}
+	}
+
+	return FormatArgs(format, args.data(), record.m_argCount);
+}
+
+void WriteText(const Log::Level &level, const std::string &text, std::ofstream *stream)
+{
+	fprintf(level >= Log::Level::Warning ? stderr : stdout, "%s", text.c_str());
+
+	if (stream != nullptr)
+	{
+		*stream << text;
+	}
+}
+
+/**
+ * Fills the next record of the calling threads ring, waiting for the writer if the ring is full.
+ */
+void PushRecord(const Log::Level &level, const char *format, const Log::Arg *args, const std::size_t &argCount, const bool &plain)
+{
+	auto &ring = GetRing();
+	auto tail = ring.m_tail.load(std::memory_order_relaxed);
+
+	while (tail - ring.m_head.load(std::memory_order_acquire) >= RING_CAPACITY)
+	{
+		GetWriter().Notify();
+		std::this_thread::yield();
+	}
+
+	auto &record = ring.m_records[tail & (RING_CAPACITY - 1)];
+	record.m_sequence = SEQUENCE.fetch_add(1, std::memory_order_relaxed);
+	record.m_level = level;
+	record.m_plain = plain;
+	record.m_external = false;
+	record.m_argCount = static_cast<uint8_t>(argCount);
+
+	auto formatLength = std::strlen(format) + 1;
+	auto argsOffset = (formatLength + alignof(Log::Arg) - 1) / alignof(Log::Arg) * alignof(Log::Arg);
+	auto size = plain ? formatLength : argsOffset + argCount * sizeof(Log::Arg);
+
+	for (std::size_t i = 0; !plain && i < argCount; i++)
+	{
+		if (args[i].m_type == Log::Arg::Type::String && args[i].m_string != nullptr)
+		{
+			size += std::strlen(args[i].m_string) + 1;
+		}
+	}
+
+	if (size > PAYLOAD_SIZE || argCount > std::numeric_limits<uint8_t>::max())
+	{
+		record.m_external = true;
+		record.m_text = plain ? format : FormatArgs(format, args, argCount);
+	}
+	else
+	{
+		std::memcpy(record.m_payload.data(), format, formatLength);
+
+		if (!plain)
+		{
+			auto stringOffset = argsOffset + argCount * sizeof(Log::Arg);
+
+			for (std::size_t i = 0; i < argCount; i++)
+			{
+				auto arg = args[i];
+
+				// Strings are copied after the args, the arg keeps the offset of its copy.
+				if (arg.m_type == Log::Arg::Type::String)
+				{
+					if (arg.m_string != nullptr)
+					{
+						auto length = std::strlen(arg.m_string) + 1;
+						std::memcpy(record.m_payload.data() + stringOffset, arg.m_string, length);
+						arg.m_unsigned = stringOffset;
+						stringOffset += length;
+					}
+					else
+					{
+						arg.m_unsigned = 0;
+					}
+				}
+
+				std::memcpy(record.m_payload.data() + argsOffset + i * sizeof(Log::Arg), &arg, sizeof(Log::Arg));
+			}
+		}
+	}
+
+	ring.m_tail.store(tail + 1, std::memory_order_release);
+}
+
+void PushText(const Log::Level &level, const std::string &text)
+{
+	if (level < Log::GetLevel())
+	{
+		return;
+	}
+
+	if (!IsWriterAlive())
+	{
+		std::lock_guard<std::mutex> lock(FALLBACK_MUTEX);
+		WriteText(level, text, nullptr);
+		return;
+	}
+
+	if (text.size() < PAYLOAD_SIZE)
+	{
+		PushRecord(level, text.c_str(), nullptr, 0, true);
+	}
+	else
+	{
+		// Avoids measuring and copying long text twice.
+		auto &ring = GetRing();
+		auto tail = ring.m_tail.load(std::memory_order_relaxed);
+
+		while (tail - ring.m_head.load(std::memory_order_acquire) >= RING_CAPACITY)
+		{
+			GetWriter().Notify();
+			std::this_thread::yield();
+		}
+
+		auto &record = ring.m_records[tail & (RING_CAPACITY - 1)];
+		record.m_sequence = SEQUENCE.fetch_add(1, std::memory_order_relaxed);
+		record.m_level = level;
+		record.m_external = true;
+		record.m_text = text;
+		ring.m_tail.store(tail + 1, std::memory_order_release);
+	}
+
+	if (level >= Log::Level::Error)
+	{
+		GetWriter().Drain();
+	}
+}
+
+LogWriter::LogWriter() :
+	m_running(true)
+{
+	m_thread = std::thread([this]()
+	{
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+
+		while (m_running)
+		{
+			m_wake.wait_for(lock, FLUSH_INTERVAL);
+			lock.unlock();
+			Drain();
+			lock.lock();
+		}
+	});
+}
+
+LogWriter::~LogWriter()
+{
+	// Messages logged from here on are written synchronously.
+	WRITER_DESTROYED = true;
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_running = false;
+	}
+
+	m_wake.notify_one();
+
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+
+	Drain();
+}
+
+std::shared_ptr<LogRing> LogWriter::Register()
+{
+	auto ring = std::make_shared<LogRing>();
+	std::lock_guard<std::mutex> lock(m_ringsMutex);
+	m_rings.emplace_back(ring);
+	return ring;
+}
+
+void LogWriter::Notify()
+{
+	m_wake.notify_one();
+}
+
+void LogWriter::Drain()
+{
+	std::lock_guard<std::mutex> drainLock(m_drainMutex);
+
+	std::vector<std::shared_ptr<LogRing>> rings;
+
+	{
+		std::lock_guard<std::mutex> lock(m_ringsMutex);
+		rings = m_rings;
+	}
+
+	std::vector<std::tuple<uint64_t, Log::Level, std::string>> messages;
+
+	for (const auto &ring : rings)
+	{
+		auto head = ring->m_head.load(std::memory_order_relaxed);
+		auto tail = ring->m_tail.load(std::memory_order_acquire);
+
+		for (; head != tail; head++)
+		{
+			auto &record = ring->m_records[head & (RING_CAPACITY - 1)];
+			messages.emplace_back(record.m_sequence, record.m_level, FormatRecord(record));
+			record.m_text.clear();
+		}
+
+		ring->m_head.store(head, std::memory_order_release);
+	}
+
+	{
+		// Rings of threads that have exited are released once they are empty.
+		std::lock_guard<std::mutex> lock(m_ringsMutex);
+		m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [](const std::shared_ptr<LogRing> &ring)
+		{
+			return ring.use_count() == 1 && ring->m_head.load() == ring->m_tail.load();
+		}), m_rings.end());
+	}
+
+	if (messages.empty())
+	{
+		return;
+	}
+
+	// Threads queue into separate rings, the sequence restores the order messages were logged in.
+	std::sort(messages.begin(), messages.end(), [](const auto &a, const auto &b)
+	{
+		return std::get<0>(a) < std::get<0>(b);
+	});
+
+	for (const auto &[sequence, level, text] : messages)
+	{
+		WriteText(level, text, m_stream.is_open() ? &m_stream : nullptr);
+	}
+
+	fflush(stdout);
+	m_stream.flush();
+}
+
+void LogWriter::OpenLog(const std::string &filename)
+{
+	std::lock_guard<std::mutex> lock(m_drainMutex);
+	FileSystem::Create(filename);
+	m_stream.open(filename);
+}
+}
 
 void Log::Out(const std::string &string)
 {
-	std::lock_guard<std::mutex> lock(MUTEX);
-	fprintf(stdout, "%s", string.c_str());
-	STREAM << string;
+	PushText(Level::Info, string);
 }
 
 void Log::Error(const std::string &string)
 {
-	std::lock_guard<std::mutex> lock(MUTEX);
-	fprintf(stderr, "%s", string.c_str());
-	STREAM << string;
+	PushText(Level::Error, string);
 }
 
 void Log::Popup(const std::string &title, const std::string &message)
 {
 #if defined(ACID_BUILD_WINDOWS)
+	Flush();
 	MessageBox(nullptr, message.c_str(), title.c_str(), 0);
 #endif
 }
 
 void Log::OpenLog(const std::string &filename)
 {
-	std::lock_guard<std::mutex> lock(MUTEX);
-	FileSystem::Create(filename);
-	STREAM.open(filename);
+	GetWriter().OpenLog(filename);
+}
+
+void Log::Flush()
+{
+	if (!WRITER_DESTROYED)
+	{
+		GetWriter().Drain();
+	}
+}
+
+void Log::Enqueue(const Level &level, const char *format, const Arg *args, const std::size_t &argCount, const bool &plain)
+{
+	if (!IsWriterAlive())
+	{
+		std::lock_guard<std::mutex> lock(FALLBACK_MUTEX);
+		WriteText(level, plain ? format : FormatArgs(format, args, argCount), nullptr);
+		return;
+	}
+
+	if (auto rateLimit = RATE_LIMIT.load(); rateLimit != 0)
+	{
+		auto &window = GetRing().m_rates[format];
+		auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		if (now - window.m_start >= 1000)
+		{
+			if (window.m_suppressed != 0)
+			{
+				auto suppressed = window.m_suppressed;
+				Log::Arg summaryArgs[2] = {};
+				summaryArgs[0].m_type = Arg::Type::Unsigned;
+				summaryArgs[0].m_size = sizeof(uint32_t);
+				summaryArgs[0].m_unsigned = suppressed;
+				summaryArgs[1].m_type = Arg::Type::String;
+				summaryArgs[1].m_size = sizeof(const char *);
+				summaryArgs[1].m_string = format;
+				PushRecord(Level::Warning, "Log suppressed %u messages with the format: %s", summaryArgs, 2, false);
+			}
+
+			window = {};
+			window.m_start = now;
+		}
+
+		if (++window.m_count > rateLimit)
+		{
+			if (window.m_suppressed++ == 0)
+			{
+				Log::Arg formatArg = {};
+				formatArg.m_type = Arg::Type::String;
+				formatArg.m_size = sizeof(const char *);
+				formatArg.m_string = format;
+				PushRecord(Level::Warning, "Log rate limit reached by the format: %s", &formatArg, 1, false);
+			}
+
+			return;
+		}
+	}
+
+	PushRecord(level, format, args, argCount, plain);
+
+	if (level >= Level::Error)
+	{
+		GetWriter().Drain();
+	}
 }
 }
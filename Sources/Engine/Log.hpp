@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include "StdAfx.hpp"
 
@@ -7,16 +8,59 @@ namespace acid
 {
 /**
  * @brief A logging class used in Acid, will write output to a file one the application has closed.
+ * Messages are queued into a lock free ring owned by the calling thread and formatted and written by a background thread,
+ * messages with a literal format keep their arguments by value and are only formatted when written. Errors are written before returning.
  */
 class ACID_EXPORT Log
 {
 public:
+	enum class Level
+	{
+		Debug, Info, Warning, Error
+	};
+
+	/**
+	 * @brief A argument kept for deferred formatting, strings are copied into the queue.
+	 */
+	class Arg
+	{
+	public:
+		enum class Type : uint8_t
+		{
+			Signed, Unsigned, Float, Pointer, String
+		};
+
+		Type m_type;
+		uint8_t m_size;
+		union
+		{
+			int64_t m_signed;
+			uint64_t m_unsigned;
+			double m_float;
+			const void *m_pointer;
+			const char *m_string;
+		};
+	};
+
 	/**
 	 * Outputs a message into the console.
 	 * @param string The string to output.
 	 */
 	static void Out(const std::string &string);
 
+	/**
+	 * Outputs a message into the console, the format is only applied once the message is written.
+	 * @tparam N The format length.
+	 * @tparam Args The args types.
+	 * @param format The format to output into, without args this is output as is.
+	 * @param args The args to be added into the format.
+	 */
+	template<std::size_t N, typename... Args>
+	static void Out(const char (&format)[N], Args &&... args)
+	{
+		Write(Level::Info, format, std::forward<Args>(args)...);
+	}
+
 	/**
 	 * Outputs a message into the console.
 	 * @tparam Args The args types.
@@ -29,12 +73,51 @@ public:
 		Out(StringFormat(format, std::forward<Args>(args)...));
 	}
 
+	/**
+	 * Outputs a debug message into the console, these are hidden at the default level.
+	 * @tparam N The format length.
+	 * @tparam Args The args types.
+	 * @param format The format to output into, without args this is output as is.
+	 * @param args The args to be added into the format.
+	 */
+	template<std::size_t N, typename... Args>
+	static void Debug(const char (&format)[N], Args &&... args)
+	{
+		Write(Level::Debug, format, std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Outputs a warning into the console.
+	 * @tparam N The format length.
+	 * @tparam Args The args types.
+	 * @param format The format to output into, without args this is output as is.
+	 * @param args The args to be added into the format.
+	 */
+	template<std::size_t N, typename... Args>
+	static void Warning(const char (&format)[N], Args &&... args)
+	{
+		Write(Level::Warning, format, std::forward<Args>(args)...);
+	}
+
 	/**
 	 * Outputs a error into the console.
 	 * @param string The string to output.
 	 */
 	static void Error(const std::string &string);
 
+	/**
+	 * Outputs a error into the console.
+	 * @tparam N The format length.
+	 * @tparam Args The args types.
+	 * @param format The format to output into, without args this is output as is.
+	 * @param args The args to be added into the format.
+	 */
+	template<std::size_t N, typename... Args>
+	static void Error(const char (&format)[N], Args &&... args)
+	{
+		Write(Level::Error, format, std::forward<Args>(args)...);
+	}
+
 	/**
 	 * Outputs a error into the console.
 	 * @tparam Args The args types.
@@ -60,9 +143,101 @@ public:
 	 */
 	static void OpenLog(const std::string &filename);
 
+	/**
+	 * Writes every queued message before returning.
+	 */
+	static void Flush();
+
+	static Level GetLevel() { return LEVEL; }
+
+	/**
+	 * Sets the lowest level of messages that are output, messages below it are dropped before being queued.
+	 * @param level The lowest level.
+	 */
+	static void SetLevel(const Level &level) { LEVEL = level; }
+
+	static uint32_t GetRateLimit() { return RATE_LIMIT; }
+
+	/**
+	 * Sets how many messages with the same format a thread may output each second, the rest are counted and reported once the second ends.
+	 * @param rateLimit The messages per second, or 0 for no limit.
+	 */
+	static void SetRateLimit(const uint32_t &rateLimit) { RATE_LIMIT = rateLimit; }
+
 private:
-	static ACID_STATE std::mutex MUTEX;
-	static ACID_STATE std::ofstream STREAM;
+	static ACID_STATE std::atomic<Level> LEVEL;
+	static ACID_STATE std::atomic<uint32_t> RATE_LIMIT;
+
+	template<typename... Args>
+	static void Write(const Level &level, const char *format, Args &&... args)
+	{
+		if (level < LEVEL)
+		{
+			return;
+		}
+
+		if constexpr (sizeof...(Args) == 0)
+		{
+			Enqueue(level, format, nullptr, 0, true);
+		}
+		else
+		{
+			const Arg packed[] = { MakeArg(args)... };
+			Enqueue(level, format, packed, sizeof...(Args), false);
+		}
+	}
+
+	static void Enqueue(const Level &level, const char *format, const Arg *args, const std::size_t &argCount, const bool &plain);
+
+	template<typename T>
+	static Arg MakeArg(const T &value)
+	{
+		using Type = std::decay_t<T>;
+
+		Arg arg = {};
+		arg.m_size = sizeof(Type);
+
+		if constexpr (std::is_same_v<Type, std::string>)
+		{
+			arg.m_type = Arg::Type::String;
+			arg.m_string = value.c_str();
+		}
+		else if constexpr (std::is_same_v<Type, char *> || std::is_same_v<Type, const char *>)
+		{
+			arg.m_type = Arg::Type::String;
+			arg.m_string = value;
+		}
+		else if constexpr (std::is_pointer_v<Type> || std::is_null_pointer_v<Type>)
+		{
+			arg.m_type = Arg::Type::Pointer;
+			arg.m_pointer = value;
+		}
+		else if constexpr (std::is_floating_point_v<Type>)
+		{
+			arg.m_type = Arg::Type::Float;
+			arg.m_float = static_cast<double>(value);
+		}
+		else if constexpr (std::is_enum_v<Type>)
+		{
+			return MakeArg(static_cast<std::underlying_type_t<Type>>(value));
+		}
+		else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+		{
+			arg.m_type = Arg::Type::Signed;
+			arg.m_signed = static_cast<int64_t>(value);
+		}
+		else if constexpr (std::is_integral_v<Type>)
+		{
+			arg.m_type = Arg::Type::Unsigned;
+			arg.m_unsigned = static_cast<uint64_t>(value);
+		}
+		else
+		{
+			static_assert(std::is_void_v<Type>, "Log arguments must be numbers, enums, pointers, or strings");
+		}
+
+		return arg;
+	}
 
 	template<typename... Args>
 	static std::string StringFormat(const std::string &format, Args &&... args)
@@ -0,0 +1,76 @@
+#include "MemoryTracker.hpp"
+
+#include "Profiler.hpp"
+
+namespace acid
+{
+void MemoryTracker::Allocated(const MemoryTag &tag, const std::size_t &size)
+{
+	auto &counters = GetCounters()[static_cast<std::size_t>(tag)];
+	auto bytes = counters.m_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+	counters.m_allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_frameAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	auto peakBytes = counters.m_peakBytes.load(std::memory_order_relaxed);
+
+	while (bytes > peakBytes && !counters.m_peakBytes.compare_exchange_weak(peakBytes, bytes, std::memory_order_relaxed))
+	{
+	}
+}
+
+void MemoryTracker::Freed(const MemoryTag &tag, const std::size_t &size)
+{
+	GetCounters()[static_cast<std::size_t>(tag)].m_bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+MemoryTracker::Stats MemoryTracker::GetStats(const MemoryTag &tag)
+{
+	auto &counters = GetCounters()[static_cast<std::size_t>(tag)];
+
+	Stats stats;
+	stats.m_bytes = counters.m_bytes.load(std::memory_order_relaxed);
+	stats.m_peakBytes = counters.m_peakBytes.load(std::memory_order_relaxed);
+	stats.m_allocations = counters.m_allocations.load(std::memory_order_relaxed);
+	stats.m_frameAllocations = counters.m_frameAllocations.load(std::memory_order_relaxed);
+	return stats;
+}
+
+std::string MemoryTracker::GetName(const MemoryTag &tag)
+{
+	switch (tag)
+	{
+	case MemoryTag::Resources:
+		return "Resources";
+	case MemoryTag::Particles:
+		return "Particles";
+	case MemoryTag::Fonts:
+		return "Fonts";
+	case MemoryTag::Scenes:
+		return "Scenes";
+	default:
+		return "Unknown";
+	}
+}
+
+void MemoryTracker::EndFrame(Profiler &profiler)
+{
+	for (std::size_t i = 0; i < static_cast<std::size_t>(MemoryTag::Count); i++)
+	{
+		auto tag = static_cast<MemoryTag>(i);
+		auto &counters = GetCounters()[i];
+		auto frameAllocations = counters.m_frameAllocations.exchange(0, std::memory_order_relaxed);
+
+		if (profiler.IsEnabled())
+		{
+			profiler.SetCounter("Heap " + GetName(tag), static_cast<double>(counters.m_bytes.load(std::memory_order_relaxed)));
+			profiler.SetCounter("Allocations " + GetName(tag), static_cast<double>(frameAllocations));
+		}
+	}
+}
+
+std::array<MemoryTracker::Counters, static_cast<std::size_t>(MemoryTag::Count)> &MemoryTracker::GetCounters()
+{
+	static std::array<Counters, static_cast<std::size_t>(MemoryTag::Count)> counters;
+	return counters;
+}
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include "StdAfx.hpp"
+
+namespace acid
+{
+class Profiler;
+
+/**
+ * The subsystems heap memory is counted for, containers opt in by allocating with a {@link TrackedAllocator} of the subsystems tag.
+ */
+enum class MemoryTag : uint8_t
+{
+	Resources, Particles, Fonts, Scenes, Count
+};
+
+/**
+ * @brief Counts the heap memory allocated by each engine subsystem.
+ * Counts are kept in atomics so containers on worker threads do not lock, they are published to the profiler as counters once a frame.
+ */
+class ACID_EXPORT MemoryTracker
+{
+public:
+	class Stats
+	{
+	public:
+		/// The bytes currently allocated.
+		int64_t m_bytes = 0;
+		/// The most bytes allocated at once.
+		int64_t m_peakBytes = 0;
+		/// The number of allocations since the start of the engine.
+		uint64_t m_allocations = 0;
+		/// The number of allocations since the last frame was published.
+		uint64_t m_frameAllocations = 0;
+	};
+
+	/**
+	 * Counts an allocation, this can be called from any thread.
+	 * @param tag The subsystem the memory belongs to.
+	 * @param size The number of bytes allocated.
+	 */
+	static void Allocated(const MemoryTag &tag, const std::size_t &size);
+
+	/**
+	 * Counts a deallocation, this can be called from any thread.
+	 * @param tag The subsystem the memory belonged to.
+	 * @param size The number of bytes freed.
+	 */
+	static void Freed(const MemoryTag &tag, const std::size_t &size);
+
+	/**
+	 * Gets the counts of a subsystem.
+	 * @param tag The subsystem.
+	 * @return The subsystem stats.
+	 */
+	static Stats GetStats(const MemoryTag &tag);
+
+	static std::string GetName(const MemoryTag &tag);
+
+	/**
+	 * Sets the counts of every subsystem as counters of the profilers current frame, then restarts the per frame allocation counts.
+	 * @param profiler The profiler to publish to, the per frame counts are restarted even if it is disabled.
+	 */
+	static void EndFrame(Profiler &profiler);
+
+private:
+	class Counters
+	{
+	public:
+		std::atomic<int64_t> m_bytes = 0;
+		std::atomic<int64_t> m_peakBytes = 0;
+		std::atomic<uint64_t> m_allocations = 0;
+		std::atomic<uint64_t> m_frameAllocations = 0;
+	};
+
+	// Containers with static storage may allocate before any other static is initialized.
+	static std::array<Counters, static_cast<std::size_t>(MemoryTag::Count)> &GetCounters();
+};
+
+/**
+ * @brief A standard allocator that counts its allocations against a {@link MemoryTag}, memory itself comes from the global heap.
+ * @tparam T The type allocated.
+ * @tparam Tag The subsystem the memory is counted against.
+ */
+template<typename T, MemoryTag Tag>
+class TrackedAllocator
+{
+public:
+	using value_type = T;
+
+	template<typename U>
+	struct rebind
+	{
+		using other = TrackedAllocator<U, Tag>;
+	};
+
+	TrackedAllocator() noexcept = default;
+
+	template<typename U>
+	TrackedAllocator(const TrackedAllocator<U, Tag> &) noexcept
+	{
+	}
+
+	T *allocate(const std::size_t n)
+	{
+		MemoryTracker::Allocated(Tag, n * sizeof(T));
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T *p, const std::size_t n) noexcept
+	{
+		MemoryTracker::Freed(Tag, n * sizeof(T));
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template<typename U>
+	bool operator==(const TrackedAllocator<U, Tag> &) const noexcept { return true; }
+
+	template<typename U>
+	bool operator!=(const TrackedAllocator<U, Tag> &) const noexcept { return false; }
+};
+
+template<typename T, MemoryTag Tag>
+using TrackedVector = std::vector<T, TrackedAllocator<T, Tag>>;
+
+template<typename K, typename V, MemoryTag Tag, typename Compare = std::less<K>>
+using TrackedMap = std::map<K, V, Compare, TrackedAllocator<std::pair<const K, V>, Tag>>;
+
+template<typename K, typename V, MemoryTag Tag, typename Hash = std::hash<K>>
+using TrackedUnorderedMap = std::unordered_map<K, V, Hash, std::equal_to<K>, TrackedAllocator<std::pair<const K, V>, Tag>>;
+
+template<typename K, typename V, MemoryTag Tag, typename Hash = std::hash<K>>
+using TrackedUnorderedMultimap = std::unordered_multimap<K, V, Hash, std::equal_to<K>, TrackedAllocator<std::pair<const K, V>, Tag>>;
+}
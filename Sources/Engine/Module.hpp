@@ -26,6 +26,49 @@ public:
 	 * The update function for the module.
 	 */
 	virtual void Update() = 0;
+
+	/**
+	 * Gets if this module has declared what it touches, only these modules are updated concurrently with other modules in their stage.
+	 * @return If the module can be run on the job system.
+	 */
+	const bool &IsConcurrent() const { return m_concurrent; }
+
+	const std::set<TypeId> &GetReads() const { return m_reads; }
+
+	const std::set<TypeId> &GetWrites() const { return m_writes; }
+
+protected:
+	/**
+	 * Declares that this module reads the data of another module while updating. A module always writes itself.
+	 * @tparam T The Module type that is read.
+	 */
+	template<typename T>
+	void Reads()
+	{
+		m_reads.emplace(TypeInfo<Module>::GetTypeId<T>());
+		m_concurrent = true;
+	}
+
+	/**
+	 * Declares that this module changes the data of another module while updating.
+	 * @tparam T The Module type that is written.
+	 */
+	template<typename T>
+	void Writes()
+	{
+		m_writes.emplace(TypeInfo<Module>::GetTypeId<T>());
+		m_concurrent = true;
+	}
+
+	/**
+	 * Declares that this module only touches its own data while updating.
+	 */
+	void Isolated() { m_concurrent = true; }
+
+private:
+	bool m_concurrent = false;
+	std::set<TypeId> m_reads;
+	std::set<TypeId> m_writes;
 };
 
 template class ACID_EXPORT TypeInfo<Module>;
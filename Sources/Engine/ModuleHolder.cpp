@@ -1,5 +1,7 @@
 #include "ModuleHolder.hpp"
 
+#include "Profiler.hpp"
+
 namespace acid
 {
 void ModuleHolder::RemoveModuleStage(const TypeId &id)
@@ -17,8 +19,62 @@ void ModuleHolder::RemoveModuleStage(const TypeId &id)
 	}
 }
 
-void ModuleHolder::UpdateStage(const Module::Stage &stage)
+bool ModuleHolder::Conflicts(const TypeId &a, const TypeId &b) const
 {
+	auto &moduleA = m_modules.at(a);
+	auto &moduleB = m_modules.at(b);
+
+	if (moduleA == nullptr || moduleB == nullptr || !moduleA->IsConcurrent() || !moduleB->IsConcurrent())
+	{
+		return true;
+	}
+
+	auto writes = [](const TypeId &id, const Module &module, const TypeId &other)
+	{
+		return id == other || module.GetWrites().count(other) != 0;
+	};
+	auto touches = [&writes](const TypeId &id, const Module &module, const TypeId &other)
+	{
+		return writes(id, module, other) || module.GetReads().count(other) != 0;
+	};
+
+	// A module always writes itself.
+	if (touches(b, *moduleB, a))
+	{
+		return true;
+	}
+
+	for (const auto &write : moduleA->GetWrites())
+	{
+		if (touches(b, *moduleB, write))
+		{
+			return true;
+		}
+	}
+
+	for (const auto &read : moduleA->GetReads())
+	{
+		if (writes(b, *moduleB, read))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const std::vector<std::vector<TypeId>> &ModuleHolder::GetSchedule(const Module::Stage &stage)
+{
+	auto it = m_schedules.find(stage);
+
+	if (it != m_schedules.end())
+	{
+		return it->second;
+	}
+
+	auto &schedule = m_schedules[stage];
+	std::vector<std::pair<TypeId, std::size_t>> placed;
+
 	for (const auto &typeId : m_stages)
 	{
 		if (typeId.first.first != stage)
@@ -26,12 +82,137 @@ void ModuleHolder::UpdateStage(const Module::Stage &stage)
 			continue;
 		}
 
-		auto &module = m_modules[typeId.second];
+		// Runs one wave after the latest module this conflicts with.
+		std::size_t wave = 0;
 
-		if (module != nullptr)
+		for (const auto &[other, otherWave] : placed)
 		{
-			module->Update();
+			if (Conflicts(typeId.second, other))
+			{
+				wave = std::max(wave, otherWave + 1);
+			}
+		}
+
+		if (wave >= schedule.size())
+		{
+			schedule.resize(wave + 1);
+		}
+
+		schedule[wave].emplace_back(typeId.second);
+		placed.emplace_back(typeId.second, wave);
+	}
+
+	return schedule;
+}
+
+void ModuleHolder::UpdateStage(const Module::Stage &stage, ThreadPool *threadPool)
+{
+	for (const auto &wave : GetSchedule(stage))
+	{
+		if (threadPool == nullptr || wave.size() == 1)
+		{
+			for (const auto &typeId : wave)
+			{
+				UpdateModule(typeId);
+			}
+
+			continue;
 		}
+
+		threadPool->ParallelFor(0, wave.size(), [this, &wave](const std::size_t &i)
+		{
+			UpdateModule(wave[i]);
+		}, 1);
+	}
+}
+
+void ModuleHolder::CreateQueued(ThreadPool &threadPool)
+{
+	auto queued = std::move(m_queued);
+	m_queued.clear();
+
+	while (!queued.empty())
+	{
+		std::set<TypeId> waiting;
+
+		for (const auto &module : queued)
+		{
+			waiting.emplace(module.m_typeId);
+		}
+
+		// Dependencies that were never queued are ignored, they either already exist or the module runs without them.
+		auto ready = std::stable_partition(queued.begin(), queued.end(), [&waiting](const Queued &module)
+		{
+			return std::none_of(module.m_dependencies.begin(), module.m_dependencies.end(), [&waiting](const TypeId &dependency)
+			{
+				return waiting.count(dependency) != 0;
+			});
+		});
+
+		if (ready == queued.begin())
+		{
+			Log::Error("Module dependencies of '%s' form a cycle, the remaining modules are created in the order they were queued\n",
+				m_names.at(queued.front().m_typeId).c_str());
+			ready = queued.end();
+		}
+
+		std::vector<Queued> wave(std::make_move_iterator(queued.begin()), std::make_move_iterator(ready));
+		queued.erase(queued.begin(), ready);
+
+		std::vector<std::unique_ptr<Module>> created(wave.size());
+		auto create = [this, &wave, &created](const std::size_t &i)
+		{
+			Profiler::Scope scope(m_names.at(wave[i].m_typeId));
+			created[i] = wave[i].m_create();
+		};
+
+		std::vector<std::future<void>> creating;
+
+		for (std::size_t i = 0; i < wave.size(); i++)
+		{
+			if (!wave[i].m_mainThread && wave.size() > 1)
+			{
+				creating.emplace_back(threadPool.Enqueue(create, i));
+			}
+		}
+
+		for (std::size_t i = 0; i < wave.size(); i++)
+		{
+			if (wave[i].m_mainThread || wave.size() == 1)
+			{
+				create(i);
+			}
+		}
+
+		// Every creation finishes before a failure is rethrown, they write into this wave.
+		for (auto &future : creating)
+		{
+			future.wait();
+		}
+
+		for (auto &future : creating)
+		{
+			future.get();
+		}
+
+		for (std::size_t i = 0; i < wave.size(); i++)
+		{
+			m_modules[wave[i].m_typeId] = std::move(created[i]);
+		}
+	}
+
+	m_schedules.clear();
+}
+
+void ModuleHolder::UpdateModule(const TypeId &id)
+{
+	// Called from workers, so the maps are only searched.
+	auto it = m_modules.find(id);
+
+	if (it != m_modules.end() && it->second != nullptr)
+	{
+		Profiler::Scope scope(m_names.at(id));
+		it->second->Update();
 	}
 }
 }
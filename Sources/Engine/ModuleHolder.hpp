@@ -1,5 +1,8 @@
 #pragma once
 
+#include <typeinfo>
+#include "Helpers/String.hpp"
+#include "Helpers/ThreadPool.hpp"
 #include "Module.hpp"
 #include "Log.hpp"
 
@@ -61,10 +64,33 @@ public:
 		const auto typeId = GetModuleTypeId<T>();
 
 		// Insert the stage value
-		m_stages.insert({ StageIndex(stage, m_modules.size()), typeId });
+		m_stages.insert({ StageIndex(stage, m_modules.size() + m_queued.size()), typeId });
 
 		// Then, add the Module
 		m_modules[typeId] = std::move(module);
+		m_names[typeId] = String::Demangle(typeid(T).name());
+		m_schedules.clear();
+	}
+
+	/**
+	 * Queues a Module to be created by {@link ModuleHolder#CreateQueued}, it is updated in the order it was queued in.
+	 * @tparam T The Module type.
+	 * @param stage The Module stage.
+	 * @param dependencies The Module types read by the module constructor, they are created first if they are queued.
+	 * @param mainThread If the module must be created on the thread that creates the queue, such as modules that call windowing functions.
+	 */
+	template<typename T>
+	void Queue(const Module::Stage &stage, std::vector<TypeId> dependencies, const bool &mainThread)
+	{
+		const auto typeId = GetModuleTypeId<T>();
+
+		m_stages.insert({ StageIndex(stage, m_modules.size() + m_queued.size()), typeId });
+		m_names[typeId] = String::Demangle(typeid(T).name());
+		m_queued.push_back({ typeId, []() -> std::unique_ptr<Module>
+		{
+			return std::make_unique<T>();
+		}, std::move(dependencies), mainThread });
+		m_schedules.clear();
 	}
 
 	/**
@@ -78,9 +104,15 @@ public:
 
 		// Remove the stage value for this Module.
 		RemoveModuleStage(typeId);
+		m_queued.erase(std::remove_if(m_queued.begin(), m_queued.end(), [&typeId](const Queued &queued)
+		{
+			return queued.m_typeId == typeId;
+		}), m_queued.end());
 
 		// Then, remove the Module.
 		m_modules.erase(typeId);
+		m_names.erase(typeId);
+		m_schedules.clear();
 	}
 
 private:
@@ -88,18 +120,61 @@ private:
 
 	using StageIndex = std::pair<Module::Stage, std::size_t>;
 
+	class Queued
+	{
+	public:
+		TypeId m_typeId;
+		std::function<std::unique_ptr<Module>()> m_create;
+		std::vector<TypeId> m_dependencies;
+		bool m_mainThread;
+	};
+
 	void RemoveModuleStage(const TypeId &id);
 
 	/**
-	 * Iterates through all Modules.
+	 * Gets if two modules can not be updated at the same time.
+	 * @param a The first module type.
+	 * @param b The second module type.
+	 * @return If either module writes something the other touches, or either has not declared what it touches.
+	 */
+	bool Conflicts(const TypeId &a, const TypeId &b) const;
+
+	/**
+	 * Gets the waves of a stage, modules in a wave do not conflict and every module runs after the earlier registered modules it conflicts with.
+	 * @param stage The Module stage.
+	 * @return The waves of module types.
+	 */
+	const std::vector<std::vector<TypeId>> &GetSchedule(const Module::Stage &stage);
+
+	/**
+	 * Iterates through all Modules, independent modules are updated concurrently.
 	 * @param stage The Module stage.
+	 * @param threadPool The job system concurrent modules are run on, if null every module is run on the calling thread.
 	 */
-	void UpdateStage(const Module::Stage& stage);
+	void UpdateStage(const Module::Stage& stage, ThreadPool *threadPool = nullptr);
+
+	void UpdateModule(const TypeId &id);
+
+	/**
+	 * Creates every queued Module in waves, the modules in a wave only depend on modules from earlier waves and are created concurrently.
+	 * Modules are added once their wave has been created, so a constructor only finds the modules it depends on.
+	 * @param threadPool The job system modules not bound to the calling thread are created on.
+	 */
+	void CreateQueued(ThreadPool &threadPool);
 
 	// List of all Modules.
 	std::unordered_map<TypeId, std::unique_ptr<Module>> m_modules;
 
+	// Readable Module names, used to label profiler regions.
+	std::unordered_map<TypeId, std::string> m_names;
+
 	// List of module stages.
 	std::multimap<StageIndex, TypeId> m_stages;
+
+	// Modules waiting to be created, in the order they were queued.
+	std::vector<Queued> m_queued;
+
+	// Cached waves of each stage, cleared when a module is added or removed.
+	std::map<Module::Stage, std::vector<std::vector<TypeId>>> m_schedules;
 };
 }
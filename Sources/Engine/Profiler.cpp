@@ -0,0 +1,183 @@
+#include "Profiler.hpp"
+
+#include "Files/FileSystem.hpp"
+#include "Helpers/String.hpp"
+#include "Engine.hpp"
+
+namespace acid
+{
+Profiler::Scope::Scope(const std::string &name, const std::string &category) :
+	m_profiler(Profiler::Get())
+{
+	if (m_profiler == nullptr || !m_profiler->IsEnabled())
+	{
+		m_profiler = nullptr;
+		return;
+	}
+
+	m_marker.m_name = name;
+	m_marker.m_category = category;
+	m_marker.m_thread = m_profiler->GetThreadIndex();
+	m_marker.m_start = Engine::GetTime();
+}
+
+Profiler::Scope::~Scope()
+{
+	if (m_profiler == nullptr)
+	{
+		return;
+	}
+
+	m_marker.m_duration = Engine::GetTime() - m_marker.m_start;
+	m_profiler->AddMarker(std::move(m_marker));
+}
+
+Profiler *Profiler::Get()
+{
+	if (Engine::Get() == nullptr)
+	{
+		return nullptr;
+	}
+
+	return Engine::Get()->GetProfiler();
+}
+
+Profiler::Profiler() :
+	m_enabled(false),
+	m_historySize(120)
+{
+	m_frame.m_start = Engine::GetTime();
+}
+
+void Profiler::SetHistorySize(const std::size_t &historySize)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_historySize = historySize;
+
+	while (m_frames.size() > m_historySize)
+	{
+		m_frames.pop_front();
+	}
+}
+
+void Profiler::AddMarker(Marker &&marker)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_frame.m_markers.emplace_back(std::move(marker));
+}
+
+void Profiler::SetCounter(const std::string &name, const double &value)
+{
+	if (!m_enabled)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_frame.m_counters[name] = value;
+}
+
+void Profiler::EndFrame()
+{
+	auto now = Engine::GetTime();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto index = m_frame.m_index;
+
+	if (m_enabled && m_historySize > 0)
+	{
+		m_frame.m_duration = now - m_frame.m_start;
+		m_lastGpuTime = Time();
+
+		for (const auto &marker : m_frame.m_markers)
+		{
+			if (marker.m_category == "gpu")
+			{
+				m_lastGpuTime += marker.m_duration;
+			}
+		}
+
+		if (m_frames.size() >= m_historySize)
+		{
+			m_frames.pop_front();
+		}
+
+		m_frames.emplace_back(std::move(m_frame));
+	}
+
+	m_frame = {};
+	m_frame.m_index = index + 1;
+	m_frame.m_start = now;
+}
+
+std::optional<Profiler::Frame> Profiler::GetLastFrame() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_frames.empty())
+	{
+		return std::nullopt;
+	}
+
+	return m_frames.back();
+}
+
+std::vector<Profiler::Frame> Profiler::GetFrames() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return std::vector<Frame>(m_frames.begin(), m_frames.end());
+}
+
+Time Profiler::GetLastGpuTime() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_lastGpuTime;
+}
+
+bool Profiler::WriteTrace(const std::string &filename) const
+{
+	std::stringstream stream;
+	stream << "{\"traceEvents\":[\n";
+	stream << R"({"name":"process_name","ph":"M","pid":0,"args":{"name":"CPU"}},)" << "\n";
+	stream << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"GPU"}})";
+
+	auto writeEvent = [&stream](const std::string &name, const std::string &category, const Time &start, const Time &duration, const uint32_t &pid,
+		const uint32_t &tid)
+	{
+		stream << ",\n{\"name\":\"" << String::ReplaceAll(name, "\"", "\\\"") << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"ts\":"
+			<< start.AsMicroseconds<int64_t>() << ",\"dur\":" << duration.AsMicroseconds<int64_t>() << ",\"pid\":" << pid << ",\"tid\":" << tid << "}";
+	};
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (const auto &frame : m_frames)
+		{
+			writeEvent("Frame " + String::To(frame.m_index), "frame", frame.m_start, frame.m_duration, 0, 0);
+
+			for (const auto &marker : frame.m_markers)
+			{
+				writeEvent(marker.m_name, marker.m_category, marker.m_start, marker.m_duration, marker.m_category == "gpu" ? 1 : 0, marker.m_thread);
+			}
+
+			// Counters are sampled as the frame ends.
+			for (const auto &[name, value] : frame.m_counters)
+			{
+				stream << ",\n{\"name\":\"" << String::ReplaceAll(name, "\"", "\\\"") << "\",\"ph\":\"C\",\"ts\":" << (frame.m_start + frame.m_duration).AsMicroseconds<int64_t>()
+					<< ",\"pid\":0,\"args\":{\"value\":" << String::To(value) << "}}";
+			}
+		}
+	}
+
+	stream << "\n]}\n";
+
+	FileSystem::Create(filename);
+	return FileSystem::WriteTextFile(filename, stream.str());
+}
+
+uint32_t Profiler::GetThreadIndex()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_threads.emplace(std::this_thread::get_id(), static_cast<uint32_t>(m_threads.size())).first->second;
+}
+}
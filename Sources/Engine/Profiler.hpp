@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that records timed CPU and GPU regions for each frame, results can be read back per frame or written as a Chrome trace.
+ */
+class ACID_EXPORT Profiler :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief A timed region.
+	 */
+	class Marker
+	{
+	public:
+		std::string m_name;
+		std::string m_category;
+		Time m_start;
+		Time m_duration;
+		uint32_t m_thread = 0;
+	};
+
+	/**
+	 * @brief All regions and counters recorded between two calls to {@link Profiler#EndFrame}.
+	 */
+	class Frame
+	{
+	public:
+		uint64_t m_index = 0;
+		Time m_start;
+		Time m_duration;
+		std::vector<Marker> m_markers;
+		/// Values sampled once a frame, such as the memory used by a subsystem.
+		std::map<std::string, double> m_counters;
+	};
+
+	/**
+	 * @brief Records a CPU region from construction until destruction, nothing is recorded when the profiler is disabled.
+	 */
+	class ACID_EXPORT Scope :
+		public NonCopyable
+	{
+	public:
+		explicit Scope(const std::string &name, const std::string &category = "cpu");
+
+		~Scope();
+
+	private:
+		Profiler *m_profiler;
+		Marker m_marker;
+	};
+
+	/**
+	 * Gets the engines profiler.
+	 * @return The current profiler instance.
+	 */
+	static Profiler *Get();
+
+	Profiler();
+
+	bool IsEnabled() const { return m_enabled; }
+
+	void SetEnabled(const bool &enabled) { m_enabled = enabled; }
+
+	const std::size_t &GetHistorySize() const { return m_historySize; }
+
+	/**
+	 * Sets how many finished frames are kept.
+	 * @param historySize The number of frames.
+	 */
+	void SetHistorySize(const std::size_t &historySize);
+
+	/**
+	 * Adds a region to the current frame, this can be called from any thread.
+	 * @param marker The region.
+	 */
+	void AddMarker(Marker &&marker);
+
+	/**
+	 * Sets the value of a counter for the current frame, this can be called from any thread.
+	 * @param name The counter name.
+	 * @param value The counter value.
+	 */
+	void SetCounter(const std::string &name, const double &value);
+
+	/**
+	 * Finishes the current frame and starts the next.
+	 */
+	void EndFrame();
+
+	/**
+	 * Gets the last finished frame.
+	 * @return The frame, or nullopt if no frame has been finished while enabled.
+	 */
+	std::optional<Frame> GetLastFrame() const;
+
+	/**
+	 * Gets every kept frame, oldest first.
+	 * @return The frames.
+	 */
+	std::vector<Frame> GetFrames() const;
+
+	/**
+	 * Gets the summed duration of the GPU regions of the last finished frame, this does not copy the frame.
+	 * @return The GPU time, zero if no frame has been finished while enabled.
+	 */
+	Time GetLastGpuTime() const;
+
+	/**
+	 * Writes the kept frames as a Chrome trace event file, counters are written as counter events, this can be opened with chrome://tracing.
+	 * @param filename The file to write to.
+	 * @return If the file was written.
+	 */
+	bool WriteTrace(const std::string &filename) const;
+
+	/**
+	 * Gets a small index for the calling thread, the first thread to ask is 0.
+	 * @return The thread index.
+	 */
+	uint32_t GetThreadIndex();
+
+private:
+	std::atomic<bool> m_enabled;
+	std::size_t m_historySize;
+
+	Frame m_frame;
+	std::deque<Frame> m_frames;
+	Time m_lastGpuTime;
+	std::map<std::thread::id, uint32_t> m_threads;
+	mutable std::mutex m_mutex;
+};
+}
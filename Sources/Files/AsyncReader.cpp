@@ -0,0 +1,839 @@
+#include "AsyncReader.hpp"
+
+#include <deque>
+#if defined(ACID_BUILD_WINDOWS)
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(ACID_BUILD_LINUX)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#endif
+#endif
+#include "Files.hpp"
+
+// io_uring reads without a offset, used to wait on the wake event, and IORING_OP_READ both need Linux 5.6.
+#if defined(ACID_BUILD_LINUX) && defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+#define ACID_IO_URING
+#endif
+
+namespace acid
+{
+class AsyncReader::Device
+{
+public:
+	virtual ~Device() = default;
+
+	/**
+	 * Opens the file of a request.
+	 * @param request The request, its file is set.
+	 * @param filename The real path of the file.
+	 * @param size The size of the file.
+	 * @return If the file was opened.
+	 */
+	virtual bool Open(Request &request, const std::string &filename, std::size_t &size) = 0;
+
+	virtual void Close(Request &request) = 0;
+
+	/**
+	 * Issues a read of the rest of a request, up to {@link AsyncReader#MaxReadSize} bytes.
+	 * @param request The request.
+	 * @return If the read was issued.
+	 */
+	virtual bool Submit(Request &request) = 0;
+
+	/**
+	 * Waits until reads have finished or the device is woken.
+	 * @param completions The requests finished, with the bytes read or a negative error.
+	 */
+	virtual void Wait(std::vector<std::pair<Request *, int64_t>> &completions) = 0;
+
+	/**
+	 * Wakes the I/O thread from {@link Device#Wait}, this is safe to call from any thread.
+	 */
+	virtual void Wake() = 0;
+
+protected:
+#if !defined(ACID_BUILD_WINDOWS)
+	static bool OpenPosix(Request &request, const std::string &filename, std::size_t &size);
+
+	static void ClosePosix(Request &request);
+#endif
+};
+
+#if !defined(ACID_BUILD_WINDOWS)
+bool AsyncReader::Device::OpenPosix(Request &request, const std::string &filename, std::size_t &size)
+{
+	auto file = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (file == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+
+	if (fstat(file, &fileStat) != 0)
+	{
+		close(file);
+		return false;
+	}
+
+	size = static_cast<std::size_t>(fileStat.st_size);
+	request.m_file = file;
+	return true;
+}
+
+void AsyncReader::Device::ClosePosix(Request &request)
+{
+	close(static_cast<int>(request.m_file));
+	request.m_file = -1;
+}
+#endif
+
+#if defined(ACID_IO_URING)
+/**
+ * @brief Issues reads through a io_uring, a read of a eventfd is kept submitted so waiting for completions can be woken.
+ */
+class AsyncReader::UringDevice :
+	public Device
+{
+public:
+	UringDevice()
+	{
+		io_uring_params params = {};
+		m_ring = static_cast<int>(syscall(__NR_io_uring_setup, 2 * QueueDepth, &params));
+
+		if (m_ring < 0)
+		{
+			return;
+		}
+
+		if (!(params.features & IORING_FEAT_RW_CUR_POS))
+		{
+			return;
+		}
+
+		m_sqMappingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		m_cqMappingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+		// Newer kernels map both rings at once.
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			m_sqMappingSize = std::max(m_sqMappingSize, m_cqMappingSize);
+			m_cqMappingSize = 0;
+		}
+
+		m_sqMapping = mmap(nullptr, m_sqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+
+		if (m_sqMapping == MAP_FAILED)
+		{
+			m_sqMapping = nullptr;
+			return;
+		}
+
+		if (m_cqMappingSize != 0)
+		{
+			m_cqMapping = mmap(nullptr, m_cqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+
+			if (m_cqMapping == MAP_FAILED)
+			{
+				m_cqMapping = nullptr;
+				return;
+			}
+		}
+
+		m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		auto sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES);
+
+		if (sqes == MAP_FAILED)
+		{
+			return;
+		}
+
+		auto sq = static_cast<uint8_t *>(m_sqMapping);
+		auto cq = m_cqMapping != nullptr ? static_cast<uint8_t *>(m_cqMapping) : sq;
+		m_sqes = static_cast<io_uring_sqe *>(sqes);
+		m_sqEntries = params.sq_entries;
+		m_sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+		m_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+		m_sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+		m_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+		m_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+		m_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+		m_cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+		m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+		m_wake = eventfd(0, EFD_CLOEXEC);
+
+		if (m_wake == -1 || !PushRead(m_wake, &m_wakeValue, sizeof(m_wakeValue), static_cast<uint64_t>(-1), 0))
+		{
+			return;
+		}
+
+		m_valid = true;
+	}
+
+	~UringDevice()
+	{
+		if (m_sqes != nullptr)
+		{
+			munmap(m_sqes, m_sqesSize);
+		}
+
+		if (m_cqMapping != nullptr)
+		{
+			munmap(m_cqMapping, m_cqMappingSize);
+		}
+
+		if (m_sqMapping != nullptr)
+		{
+			munmap(m_sqMapping, m_sqMappingSize);
+		}
+
+		if (m_ring >= 0)
+		{
+			close(m_ring);
+		}
+
+		if (m_wake != -1)
+		{
+			close(m_wake);
+		}
+	}
+
+	/**
+	 * Gets if the ring was created, kernels before 5.6 or sandboxes that block io_uring fail.
+	 * @return If the ring can be used.
+	 */
+	bool IsValid() const { return m_valid; }
+
+	bool Open(Request &request, const std::string &filename, std::size_t &size) override
+	{
+		return OpenPosix(request, filename, size);
+	}
+
+	void Close(Request &request) override
+	{
+		ClosePosix(request);
+	}
+
+	bool Submit(Request &request) override
+	{
+		auto size = std::min(request.m_size - request.m_done, MaxReadSize);
+		return PushRead(static_cast<int>(request.m_file), request.m_buffer.data() + request.m_done, static_cast<uint32_t>(size),
+			request.m_offset + request.m_done, reinterpret_cast<uint64_t>(&request));
+	}
+
+	void Wait(std::vector<std::pair<Request *, int64_t>> &completions) override
+	{
+		// Every read pushed since the last wait is submitted with this one call.
+		int result;
+
+		do
+		{
+			result = static_cast<int>(syscall(__NR_io_uring_enter, m_ring, m_unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+		}
+		while (result < 0 && errno == EINTR);
+
+		if (result > 0)
+		{
+			m_unsubmitted -= std::min(static_cast<uint32_t>(result), m_unsubmitted);
+		}
+
+		auto head = *m_cqHead;
+		auto tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+		for (; head != tail; head++)
+		{
+			auto &cqe = m_cqes[head & *m_cqMask];
+
+			if (cqe.user_data == 0)
+			{
+				PushRead(m_wake, &m_wakeValue, sizeof(m_wakeValue), static_cast<uint64_t>(-1), 0);
+				continue;
+			}
+
+			completions.emplace_back(reinterpret_cast<Request *>(cqe.user_data), cqe.res);
+		}
+
+		__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+	}
+
+	void Wake() override
+	{
+		uint64_t value = 1;
+		[[maybe_unused]] auto written = write(m_wake, &value, sizeof(value));
+	}
+
+private:
+	bool PushRead(const int &file, void *data, const uint32_t &size, const uint64_t &offset, const uint64_t &userData)
+	{
+		auto tail = *m_sqTail;
+
+		if (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries)
+		{
+			return false;
+		}
+
+		auto index = tail & *m_sqMask;
+		auto &sqe = m_sqes[index];
+		std::memset(&sqe, 0, sizeof(io_uring_sqe));
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = file;
+		sqe.addr = reinterpret_cast<uint64_t>(data);
+		sqe.len = size;
+		sqe.off = offset;
+		sqe.user_data = userData;
+		m_sqArray[index] = index;
+		__atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+		m_unsubmitted++;
+		return true;
+	}
+
+	bool m_valid = false;
+	int m_ring = -1;
+	int m_wake = -1;
+	uint64_t m_wakeValue = 0;
+	uint32_t m_unsubmitted = 0;
+
+	void *m_sqMapping = nullptr;
+	std::size_t m_sqMappingSize = 0;
+	void *m_cqMapping = nullptr;
+	std::size_t m_cqMappingSize = 0;
+	io_uring_sqe *m_sqes = nullptr;
+	std::size_t m_sqesSize = 0;
+	uint32_t m_sqEntries = 0;
+
+	unsigned *m_sqHead = nullptr;
+	unsigned *m_sqTail = nullptr;
+	unsigned *m_sqMask = nullptr;
+	unsigned *m_sqArray = nullptr;
+	unsigned *m_cqHead = nullptr;
+	unsigned *m_cqTail = nullptr;
+	unsigned *m_cqMask = nullptr;
+	io_uring_cqe *m_cqes = nullptr;
+};
+#endif
+
+#if defined(ACID_BUILD_WINDOWS)
+/**
+ * @brief Issues overlapped reads of files associated with a completion port, waking posts a empty completion.
+ */
+class AsyncReader::OverlappedDevice :
+	public Device
+{
+public:
+	OverlappedDevice() :
+		m_port(CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1))
+	{
+		if (m_port == nullptr)
+		{
+			Log::Error("Failed to create the I/O completion port: %i\n", static_cast<int32_t>(GetLastError()));
+		}
+	}
+
+	~OverlappedDevice()
+	{
+		if (m_port != nullptr)
+		{
+			CloseHandle(m_port);
+		}
+	}
+
+	bool Open(Request &request, const std::string &filename, std::size_t &size) override
+	{
+		if (m_port == nullptr)
+		{
+			return false;
+		}
+
+		auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+
+		if (!GetFileSizeEx(file, &fileSize) || CreateIoCompletionPort(file, m_port, 0, 0) == nullptr)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		size = static_cast<std::size_t>(fileSize.QuadPart);
+		request.m_file = reinterpret_cast<intptr_t>(file);
+		return true;
+	}
+
+	void Close(Request &request) override
+	{
+		CloseHandle(reinterpret_cast<HANDLE>(request.m_file));
+		request.m_file = -1;
+		m_overlapped.erase(&request);
+	}
+
+	bool Submit(Request &request) override
+	{
+		auto &overlapped = m_overlapped[&request];
+
+		if (overlapped == nullptr)
+		{
+			overlapped = std::make_unique<Overlapped>();
+		}
+
+		auto offset = static_cast<uint64_t>(request.m_offset + request.m_done);
+		auto size = std::min(request.m_size - request.m_done, MaxReadSize);
+		std::memset(&overlapped->m_overlapped, 0, sizeof(OVERLAPPED));
+		overlapped->m_overlapped.Offset = static_cast<DWORD>(offset);
+		overlapped->m_overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+		overlapped->m_request = &request;
+
+		// Reads that finish right away still post their completion to the port.
+		if (!ReadFile(reinterpret_cast<HANDLE>(request.m_file), request.m_buffer.data() + request.m_done, static_cast<DWORD>(size), nullptr,
+			&overlapped->m_overlapped) && GetLastError() != ERROR_IO_PENDING)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	void Wait(std::vector<std::pair<Request *, int64_t>> &completions) override
+	{
+		DWORD bytes = 0;
+		ULONG_PTR key = 0;
+		LPOVERLAPPED result = nullptr;
+		auto succeeded = GetQueuedCompletionStatus(m_port, &bytes, &key, &result, INFINITE);
+
+		// A completion without a overlapped was posted by Wake.
+		if (result == nullptr)
+		{
+			return;
+		}
+
+		auto overlapped = reinterpret_cast<Overlapped *>(result);
+
+		if (succeeded)
+		{
+			completions.emplace_back(overlapped->m_request, static_cast<int64_t>(bytes));
+			return;
+		}
+
+		auto error = GetLastError();
+		completions.emplace_back(overlapped->m_request, error == ERROR_HANDLE_EOF ? 0 : -static_cast<int64_t>(error));
+	}
+
+	void Wake() override
+	{
+		PostQueuedCompletionStatus(m_port, 0, 0, nullptr);
+	}
+
+private:
+	class Overlapped
+	{
+	public:
+		/// The first member, so the overlapped returned by the port is also this.
+		OVERLAPPED m_overlapped;
+		Request *m_request = nullptr;
+	};
+
+	HANDLE m_port;
+	std::map<Request *, std::unique_ptr<Overlapped>> m_overlapped;
+};
+#else
+/**
+ * @brief Reads files one at a time on the I/O thread, used where io_uring is not available.
+ */
+class AsyncReader::BlockingDevice :
+	public Device
+{
+public:
+	bool Open(Request &request, const std::string &filename, std::size_t &size) override
+	{
+		return OpenPosix(request, filename, size);
+	}
+
+	void Close(Request &request) override
+	{
+		ClosePosix(request);
+	}
+
+	bool Submit(Request &request) override
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_submitted.emplace_back(&request);
+		return true;
+	}
+
+	void Wait(std::vector<std::pair<Request *, int64_t>> &completions) override
+	{
+		Request *request;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]()
+			{
+				return m_woken || !m_submitted.empty();
+			});
+			m_woken = false;
+
+			if (m_submitted.empty())
+			{
+				return;
+			}
+
+			request = m_submitted.front();
+			m_submitted.pop_front();
+		}
+
+		auto size = std::min(request->m_size - request->m_done, MaxReadSize);
+		ssize_t result;
+
+		do
+		{
+			result = pread(static_cast<int>(request->m_file), request->m_buffer.data() + request->m_done, size,
+				static_cast<off_t>(request->m_offset + request->m_done));
+		}
+		while (result < 0 && errno == EINTR);
+
+		completions.emplace_back(request, result < 0 ? -static_cast<int64_t>(errno) : static_cast<int64_t>(result));
+	}
+
+	void Wake() override
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_woken = true;
+		}
+
+		m_condition.notify_one();
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<Request *> m_submitted;
+	bool m_woken = false;
+};
+#endif
+
+AsyncReader::AsyncReader() :
+	m_backend(Backend::Blocking),
+	m_nextId(1),
+	m_issued(0),
+	m_stop(false),
+	m_running(0)
+{
+#if defined(ACID_BUILD_WINDOWS)
+	m_device = std::make_unique<OverlappedDevice>();
+	m_backend = Backend::Overlapped;
+#else
+#if defined(ACID_IO_URING)
+	if (auto device = std::make_unique<UringDevice>(); device->IsValid())
+	{
+		m_device = std::move(device);
+		m_backend = Backend::IoUring;
+	}
+#endif
+
+	if (m_device == nullptr)
+	{
+		m_device = std::make_unique<BlockingDevice>();
+	}
+#endif
+
+	m_thread = std::thread(&AsyncReader::Run, this);
+}
+
+AsyncReader::~AsyncReader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+
+		// Queued reads are dropped, issued reads finish before the thread stops but their callbacks are not called.
+		for (const auto &key : m_queue)
+		{
+			m_requests.erase(key.second);
+		}
+
+		m_queue.clear();
+
+		for (auto &[id, request] : m_requests)
+		{
+			request->m_cancelled = true;
+		}
+	}
+
+	m_device->Wake();
+
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+AsyncReader *AsyncReader::Get()
+{
+	static AsyncReader reader;
+	return &reader;
+}
+
+uint64_t AsyncReader::Read(const std::string &filename, ReadCallback &&onRead, const Priority &priority, const std::size_t &offset, const std::size_t &size)
+{
+	auto request = std::make_unique<Request>();
+	request->m_filename = filename;
+	request->m_onRead = std::move(onRead);
+	request->m_priority = priority;
+	request->m_offset = offset;
+	request->m_size = size;
+
+	uint64_t id;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		id = m_nextId++;
+		request->m_id = id;
+		m_queue.emplace(GetQueueKey(*request));
+		m_requests.emplace(id, std::move(request));
+	}
+
+	m_device->Wake();
+	return id;
+}
+
+bool AsyncReader::Cancel(const uint64_t &id)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (m_running == id)
+	{
+		if (std::this_thread::get_id() != m_thread.get_id())
+		{
+			m_runningCondition.wait(lock, [this, id]()
+			{
+				return m_running != id;
+			});
+		}
+
+		return false;
+	}
+
+	auto it = m_requests.find(id);
+
+	if (it == m_requests.end())
+	{
+		return false;
+	}
+
+	auto &request = *it->second;
+
+	if (request.m_state == State::Queued)
+	{
+		m_queue.erase(GetQueueKey(request));
+		m_requests.erase(it);
+		return true;
+	}
+
+	request.m_cancelled = true;
+	return true;
+}
+
+bool AsyncReader::SetPriority(const uint64_t &id, const Priority &priority)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_requests.find(id);
+
+	if (it == m_requests.end() || it->second->m_state != State::Queued)
+	{
+		return false;
+	}
+
+	auto &request = *it->second;
+	m_queue.erase(GetQueueKey(request));
+	request.m_priority = priority;
+	m_queue.emplace(GetQueueKey(request));
+	return true;
+}
+
+std::size_t AsyncReader::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_requests.size();
+}
+
+void AsyncReader::Run()
+{
+	std::vector<Request *> issuing;
+	std::vector<std::pair<Request *, int64_t>> completions;
+
+	while (true)
+	{
+		issuing.clear();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_stop && m_issued == 0)
+			{
+				break;
+			}
+
+			while (!m_stop && m_issued < QueueDepth && !m_queue.empty())
+			{
+				auto &request = *m_requests[m_queue.begin()->second];
+				m_queue.erase(m_queue.begin());
+				request.m_state = State::Issued;
+				m_issued++;
+				issuing.emplace_back(&request);
+			}
+		}
+
+		auto finished = false;
+
+		for (auto request : issuing)
+		{
+			if (!Issue(*request))
+			{
+				finished = true;
+			}
+		}
+
+		// Reads that finished without the device made room for more, those are issued before waiting.
+		if (finished)
+		{
+			continue;
+		}
+
+		completions.clear();
+		m_device->Wait(completions);
+
+		for (auto &[request, result] : completions)
+		{
+			Complete(*request, result);
+		}
+	}
+}
+
+bool AsyncReader::Issue(Request &request)
+{
+	auto filename = Files::FindRealPath(request.m_filename);
+
+	if (!filename)
+	{
+		auto contents = Files::ReadView(request.m_filename);
+
+		if (contents && (request.m_offset != 0 || request.m_size != 0))
+		{
+			auto offset = std::min(request.m_offset, contents->GetSize());
+			auto available = contents->GetSize() - offset;
+			contents = contents->GetSubView(offset, request.m_size == 0 ? available : std::min(request.m_size, available));
+		}
+
+		Finish(request, std::move(contents));
+		return false;
+	}
+
+	std::size_t fileSize = 0;
+
+	if (!m_device->Open(request, *filename, fileSize))
+	{
+		Log::Error("Error while opening file to read %s\n", filename->c_str());
+		Finish(request, std::nullopt);
+		return false;
+	}
+
+	auto available = request.m_offset < fileSize ? fileSize - request.m_offset : 0;
+	request.m_size = request.m_size == 0 ? available : std::min(request.m_size, available);
+	request.m_buffer.resize(request.m_size);
+
+	if (request.m_size == 0)
+	{
+		Finish(request, FileView::FromBuffer(std::move(request.m_buffer)));
+		return false;
+	}
+
+	if (!m_device->Submit(request))
+	{
+		Log::Error("Error while issuing read of file %s\n", filename->c_str());
+		Finish(request, std::nullopt);
+		return false;
+	}
+
+	return true;
+}
+
+void AsyncReader::Complete(Request &request, const int64_t &result)
+{
+	if (result < 0)
+	{
+		Log::Error("Error while reading file %s: %i\n", request.m_filename.c_str(), static_cast<int32_t>(-result));
+		Finish(request, std::nullopt);
+		return;
+	}
+
+	request.m_done += static_cast<std::size_t>(result);
+	bool cancelled;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		cancelled = request.m_cancelled;
+	}
+
+	// Files truncated while they were read end early, reads that were cancelled stop at the end of the current read.
+	if (result == 0 || request.m_done >= request.m_size || cancelled)
+	{
+		request.m_buffer.resize(request.m_done);
+		Finish(request, FileView::FromBuffer(std::move(request.m_buffer)));
+		return;
+	}
+
+	if (!m_device->Submit(request))
+	{
+		Log::Error("Error while issuing read of file %s\n", request.m_filename.c_str());
+		Finish(request, std::nullopt);
+	}
+}
+
+void AsyncReader::Finish(Request &request, std::optional<FileView> &&contents)
+{
+	if (request.m_file != -1)
+	{
+		m_device->Close(request);
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_issued--;
+	auto id = request.m_id;
+
+	if (request.m_cancelled)
+	{
+		m_requests.erase(id);
+		return;
+	}
+
+	auto onRead = std::move(request.m_onRead);
+	m_requests.erase(id);
+	m_running = id;
+	lock.unlock();
+
+	if (onRead)
+	{
+		onRead(std::move(contents));
+	}
+
+	lock.lock();
+	m_running = 0;
+	lock.unlock();
+	m_runningCondition.notify_all();
+}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include "Helpers/NonCopyable.hpp"
+#include "FileView.hpp"
+
+namespace acid
+{
+/**
+ * @brief Reads files without blocking the calling thread or a worker, every read is issued from one I/O thread through the native asynchronous API.
+ * Linux reads through io_uring and Windows through overlapped reads on a completion port, when neither is available files are read one at a time on the I/O thread.
+ * Queued reads are issued highest priority first, up to {@link AsyncReader#QueueDepth} at once and submitted to the kernel together.
+ * Files inside zips and packs are read through {@link Files#ReadView} on the I/O thread.
+ */
+class ACID_EXPORT AsyncReader :
+	public NonCopyable
+{
+public:
+	enum class Backend
+	{
+		IoUring, Overlapped, Blocking
+	};
+
+	enum class Priority
+	{
+		Low, Normal, High
+	};
+
+	/**
+	 * Called on the I/O thread with the contents read, or nullopt if the file could not be read.
+	 * It should be short, such as dispatching the decoding to the thread pool, as no other read completes while it runs.
+	 */
+	using ReadCallback = std::function<void(std::optional<FileView>)>;
+
+	/// The most reads issued at the same time.
+	static constexpr uint32_t QueueDepth = 32;
+	/// The most bytes read by one request to the kernel, larger reads are issued again from where they stopped.
+	static constexpr std::size_t MaxReadSize = 8 * 1024 * 1024;
+
+	AsyncReader();
+
+	~AsyncReader();
+
+	/**
+	 * Gets the reader shared by the engine, it is created the first time it is used.
+	 * @return The shared reader.
+	 */
+	static AsyncReader *Get();
+
+	/**
+	 * Queues a read of a file found by real or partial path, returns immediately.
+	 * @param filename The path to read.
+	 * @param onRead The function called once the read has finished.
+	 * @param priority The priority of the read, reads of the same priority are issued in the order they were queued.
+	 * @param offset The offset in bytes the read starts at.
+	 * @param size The most bytes read, zero reads until the end of the file.
+	 * @return The id of the read, used to cancel it.
+	 */
+	uint64_t Read(const std::string &filename, ReadCallback &&onRead, const Priority &priority = Priority::Normal, const std::size_t &offset = 0,
+		const std::size_t &size = 0);
+
+	/**
+	 * Cancels a read, a read already issued finishes but its contents are discarded.
+	 * If the callback of the read is running this waits for it to return, so it must not be called from the callback.
+	 * @param id The id of the read.
+	 * @return If the read was cancelled, otherwise its callback has already been called.
+	 */
+	bool Cancel(const uint64_t &id);
+
+	/**
+	 * Changes the priority of a read that has not been issued yet.
+	 * @param id The id of the read.
+	 * @param priority The new priority.
+	 * @return If the read was still queued.
+	 */
+	bool SetPriority(const uint64_t &id, const Priority &priority);
+
+	const Backend &GetBackend() const { return m_backend; }
+
+	/**
+	 * Gets the number of reads that are queued or issued.
+	 * @return The number of reads.
+	 */
+	std::size_t GetPendingCount() const;
+
+private:
+	/// Opens files and issues reads through one of the backends.
+	class Device;
+	class UringDevice;
+	class OverlappedDevice;
+	class BlockingDevice;
+
+	enum class State
+	{
+		Queued, Issued
+	};
+
+	class Request
+	{
+	public:
+		uint64_t m_id = 0;
+		std::string m_filename;
+		ReadCallback m_onRead;
+		Priority m_priority = Priority::Normal;
+		State m_state = State::Queued;
+		bool m_cancelled = false;
+
+		std::size_t m_offset = 0;
+		std::size_t m_size = 0;
+		/// The file opened by the device, a descriptor or handle.
+		intptr_t m_file = -1;
+		std::vector<uint8_t> m_buffer;
+		std::size_t m_done = 0;
+	};
+
+	/// Queued requests are ordered by highest priority, then by lowest id.
+	using QueueKey = std::pair<int32_t, uint64_t>;
+
+	static QueueKey GetQueueKey(const Request &request) { return { -static_cast<int32_t>(request.m_priority), request.m_id }; }
+
+	void Run();
+
+	bool Issue(Request &request);
+
+	void Complete(Request &request, const int64_t &result);
+
+	void Finish(Request &request, std::optional<FileView> &&contents);
+
+	std::unique_ptr<Device> m_device;
+	Backend m_backend;
+
+	mutable std::mutex m_mutex;
+	std::map<uint64_t, std::unique_ptr<Request>> m_requests;
+	std::set<QueueKey> m_queue;
+	uint64_t m_nextId;
+	uint32_t m_issued;
+	bool m_stop;
+
+	/// The request whose callback is running, zero if none is.
+	uint64_t m_running;
+	std::condition_variable m_runningCondition;
+
+	std::thread m_thread;
+};
+}
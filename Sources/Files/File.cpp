@@ -8,7 +8,8 @@ namespace acid
 {
 File::File(std::string filename, Metadata *metadata) :
 	m_filename(std::move(filename)),
-	m_metadata(metadata)
+	m_metadata(metadata),
+	m_writes(std::make_shared<Writes>())
 {
 }
 
@@ -18,16 +19,13 @@ void File::Read()
 	auto debugStart = Engine::GetTime();
 #endif
 
-	if (Files::ExistsInPath(m_filename))
+	if (Files::ExistsInPath(m_filename) || FileSystem::Exists(m_filename))
 	{
-		IFStream inStream(m_filename);
-		m_metadata->Load(&inStream);
-	}
-	else if (FileSystem::Exists(m_filename))
-	{
-		std::ifstream inStream(m_filename);
-		m_metadata->Load(&inStream);
-		inStream.close();
+		// The file is loaded from one contiguous view instead of through a stream.
+		if (auto view = Files::ReadView(m_filename))
+		{
+			m_metadata->Load(view->GetString());
+		}
 	}
 
 #if defined(ACID_VERBOSE)
@@ -42,17 +40,11 @@ void File::Write()
 	auto debugStart = Engine::GetTime();
 #endif
 
-	if (Files::ExistsInPath(m_filename))
-	{
-		OFStream outStream(m_filename);
-		m_metadata->Write(&outStream);
-	}
-	else // if (FileSystem::Exists(m_filename))
 	{
-		FileSystem::Create(m_filename);
-		std::ofstream outStream(m_filename);
-		m_metadata->Write(&outStream);
-		outStream.close();
+		std::lock_guard<std::mutex> lock(m_writes->m_mutex);
+		Write(m_filename, *m_metadata);
+		// Snapshots started before this write are older, they are skipped.
+		m_writes->m_written = m_writes->m_started;
 	}
 
 #if defined(ACID_VERBOSE)
@@ -61,8 +53,58 @@ void File::Write()
 #endif
 }
 
+std::future<void> File::WriteAsync()
+{
+	std::shared_ptr<Metadata> snapshot(m_metadata->Clone());
+	uint64_t index;
+
+	{
+		std::lock_guard<std::mutex> lock(m_writes->m_mutex);
+		index = ++m_writes->m_started;
+	}
+
+	return Engine::Get()->GetThreadPool().Enqueue([filename = m_filename, snapshot, writes = m_writes, index]()
+	{
+#if defined(ACID_VERBOSE)
+		auto debugStart = Engine::GetTime();
+#endif
+
+		std::lock_guard<std::mutex> lock(writes->m_mutex);
+
+		if (index <= writes->m_written)
+		{
+			return;
+		}
+
+		Write(filename, *snapshot);
+		writes->m_written = index;
+
+#if defined(ACID_VERBOSE)
+		auto debugEnd = Engine::GetTime();
+		Log::Out("File '%s' saved in the background in %.3fms\n", filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
+#endif
+	});
+}
+
 void File::Clear()
 {
 	m_metadata->ClearChildren();
 }
+
+void File::Write(const std::string &filename, const Metadata &metadata)
+{
+	// The formats write through a buffered writer, so the file is written in large blocks as the tree is visited.
+	if (Files::ExistsInPath(filename))
+	{
+		OFStream outStream(filename);
+		metadata.Write(&outStream);
+	}
+	else // if (FileSystem::Exists(filename))
+	{
+		FileSystem::Create(filename);
+		std::ofstream outStream(filename, std::ios::binary);
+		metadata.Write(&outStream);
+		outStream.close();
+	}
+}
 }
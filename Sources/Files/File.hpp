@@ -16,6 +16,14 @@ public:
 
 	void Write();
 
+	/**
+	 * Writes a snapshot of the metadata on the engine thread pool, the metadata can keep changing while the snapshot is written.
+	 * Taking the snapshot shares the children with the metadata, so it does not copy the tree.
+	 * Writes of the same file run one at a time, a write that starts after a newer snapshot of the file has been written is skipped.
+	 * @return The future that is ready once the snapshot has been written or skipped.
+	 */
+	std::future<void> WriteAsync();
+
 	void Clear();
 
 	const std::string &GetFilename() const { return m_filename; }
@@ -25,7 +33,19 @@ public:
 	Metadata *GetMetadata() const { return m_metadata.get(); }
 
 private:
+	/// Orders the writes of a file, shared with the writes still running.
+	class Writes
+	{
+	public:
+		std::mutex m_mutex;
+		uint64_t m_started = 0;
+		uint64_t m_written = 0;
+	};
+
+	static void Write(const std::string &filename, const Metadata &metadata);
+
 	std::string m_filename;
 	std::unique_ptr<Metadata> m_metadata;
+	std::shared_ptr<Writes> m_writes;
 };
 }
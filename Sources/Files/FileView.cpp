@@ -0,0 +1,167 @@
+#include "FileView.hpp"
+
+#if defined(ACID_BUILD_WINDOWS)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+class FileView::Storage :
+	public NonCopyable
+{
+public:
+	explicit Storage(std::vector<uint8_t> &&buffer) :
+		m_buffer(std::move(buffer))
+	{
+	}
+
+	Storage(void *mapping, const std::size_t &size) :
+		m_mapping(mapping),
+		m_mappingSize(size)
+	{
+	}
+
+	~Storage()
+	{
+		if (m_mapping == nullptr)
+		{
+			return;
+		}
+
+#if defined(ACID_BUILD_WINDOWS)
+		UnmapViewOfFile(m_mapping);
+#else
+		munmap(m_mapping, m_mappingSize);
+#endif
+	}
+
+	const uint8_t *GetData() const { return m_mapping != nullptr ? static_cast<const uint8_t *>(m_mapping) : m_buffer.data(); }
+
+	std::size_t GetSize() const { return m_mapping != nullptr ? m_mappingSize : m_buffer.size(); }
+
+	bool IsMapped() const { return m_mapping != nullptr; }
+
+private:
+	std::vector<uint8_t> m_buffer;
+	void *m_mapping = nullptr;
+	std::size_t m_mappingSize = 0;
+};
+
+std::optional<FileView> FileView::Map(const std::string &filename)
+{
+	void *mapping = nullptr;
+	std::size_t size = 0;
+
+#if defined(ACID_BUILD_WINDOWS)
+	auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return std::nullopt;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		return std::nullopt;
+	}
+
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+
+	if (size != 0)
+	{
+		// The view keeps the mapping alive after the handles are closed.
+		auto fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (fileMapping != nullptr)
+		{
+			mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(fileMapping);
+		}
+	}
+
+	CloseHandle(file);
+#else
+	auto file = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (file == -1)
+	{
+		return std::nullopt;
+	}
+
+	struct stat st;
+
+	if (fstat(file, &st) != 0 || !S_ISREG(st.st_mode))
+	{
+		close(file);
+		return std::nullopt;
+	}
+
+	size = static_cast<std::size_t>(st.st_size);
+
+	if (size != 0)
+	{
+		mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		if (mapping == MAP_FAILED)
+		{
+			mapping = nullptr;
+		}
+	}
+
+	close(file);
+#endif
+
+	if (size == 0)
+	{
+		return FromBuffer({});
+	}
+
+	if (mapping == nullptr)
+	{
+		return std::nullopt;
+	}
+
+	FileView view;
+	view.m_storage = std::make_shared<Storage>(mapping, size);
+	view.m_data = view.m_storage->GetData();
+	view.m_size = size;
+	return view;
+}
+
+FileView FileView::FromBuffer(std::vector<uint8_t> &&buffer)
+{
+	FileView view;
+	view.m_storage = std::make_shared<Storage>(std::move(buffer));
+	view.m_data = view.m_storage->GetData();
+	view.m_size = view.m_storage->GetSize();
+	return view;
+}
+
+FileView FileView::GetSubView(const std::size_t &offset, const std::size_t &size) const
+{
+	if (offset > m_size || size > m_size - offset)
+	{
+		return {};
+	}
+
+	FileView view;
+	view.m_storage = m_storage;
+	view.m_data = m_data + offset;
+	view.m_size = size;
+	return view;
+}
+
+bool FileView::IsMapped() const
+{
+	return m_storage != nullptr && m_storage->IsMapped();
+}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string_view>
+#include "StdAfx.hpp"
+
+namespace acid
+{
+/**
+ * @brief A reference counted read only view of file contents, the contents are memory mapped when they are stored uncompressed on disk.
+ * Copies of a view and views into it share the same mapping or buffer, it is released once the last view is destroyed.
+ */
+class ACID_EXPORT FileView
+{
+public:
+	FileView() = default;
+
+	/**
+	 * Maps a file on disk into memory.
+	 * @param filename The real path of the file.
+	 * @return The mapped view, or nullopt if the file could not be opened or mapped.
+	 */
+	static std::optional<FileView> Map(const std::string &filename);
+
+	/**
+	 * Creates a view that owns a buffer, used when the contents had to be decompressed or copied.
+	 * @param buffer The contents.
+	 * @return The view.
+	 */
+	static FileView FromBuffer(std::vector<uint8_t> &&buffer);
+
+	/**
+	 * Gets a view of part of this view, it shares the same storage.
+	 * @param offset The offset of the part in bytes.
+	 * @param size The size of the part in bytes.
+	 * @return The view, empty if the part is outside of this view.
+	 */
+	FileView GetSubView(const std::size_t &offset, const std::size_t &size) const;
+
+	const uint8_t *GetData() const { return m_data; }
+
+	const std::size_t &GetSize() const { return m_size; }
+
+	bool IsEmpty() const { return m_size == 0; }
+
+	/**
+	 * Gets if the contents are mapped from disk instead of being held in a buffer.
+	 * @return If the view is mapped.
+	 */
+	bool IsMapped() const;
+
+	/**
+	 * Gets the contents as characters, they are not null terminated.
+	 * @return The contents.
+	 */
+	std::string_view GetString() const { return std::string_view(reinterpret_cast<const char *>(m_data), m_size); }
+
+private:
+	class Storage;
+
+	std::shared_ptr<const Storage> m_storage;
+	const uint8_t *m_data = nullptr;
+	std::size_t m_size = 0;
+};
+}
@@ -1,20 +1,444 @@
 #include "FileWatcher.hpp"
 
 #include <chrono>
+#if defined(ACID_BUILD_LINUX)
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif defined(ACID_BUILD_WINDOWS)
+#include <Windows.h>
+#elif defined(ACID_BUILD_MACOS)
+#include <condition_variable>
+#include <CoreServices/CoreServices.h>
+#endif
+#include "Engine/Engine.hpp"
 #include "FileSystem.hpp"
 
 namespace acid
 {
+// Changes to a file closer together than this are called once.
+const Time COALESCE_TIME = Time::Milliseconds(100);
+// The longest a read waits, so the watcher notices path changes and destruction.
+const Time WAIT_TIME = Time::Milliseconds(100);
+
+namespace
+{
+using Changes = std::vector<std::pair<std::string, FileWatcher::Status>>;
+
+#if defined(ACID_BUILD_LINUX)
+/**
+ * Watches every directory under a path with inotify, new directories are watched as they are created.
+ */
+class NativeWatcher
+{
+public:
+	explicit NativeWatcher(const std::string &path) :
+		m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+	{
+		if (m_fd != -1)
+		{
+			AddWatches(path, nullptr);
+		}
+	}
+
+	~NativeWatcher()
+	{
+		if (m_fd != -1)
+		{
+			close(m_fd);
+		}
+	}
+
+	bool IsValid() const { return m_fd != -1 && !m_directories.empty(); }
+
+	bool Read(const Time &timeout, Changes &changes)
+	{
+		pollfd descriptor = {};
+		descriptor.fd = m_fd;
+		descriptor.events = POLLIN;
+
+		if (poll(&descriptor, 1, timeout.AsMilliseconds<int>()) <= 0)
+		{
+			return true;
+		}
+
+		alignas(inotify_event) char buffer[64 * 1024];
+		ssize_t length;
+
+		while ((length = read(m_fd, buffer, sizeof(buffer))) > 0)
+		{
+			for (auto offset = buffer; offset < buffer + length;)
+			{
+				auto event = reinterpret_cast<const inotify_event *>(offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					Log::Error("File watcher event queue overflowed, some changes were missed\n");
+					continue;
+				}
+
+				auto it = m_directories.find(event->wd);
+
+				if (it == m_directories.end())
+				{
+					continue;
+				}
+
+				if (event->mask & IN_IGNORED)
+				{
+					m_directories.erase(it);
+					continue;
+				}
+
+				if (event->len == 0)
+				{
+					continue;
+				}
+
+				auto path = it->second + FileSystem::Separator + event->name;
+
+				if (event->mask & IN_ISDIR)
+				{
+					// Files may be written into a new directory before it is watched.
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					{
+						AddWatches(path, &changes);
+					}
+
+					continue;
+				}
+
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					changes.emplace_back(path, FileWatcher::Status::Created);
+				}
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					changes.emplace_back(path, FileWatcher::Status::Erased);
+				}
+				else if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))
+				{
+					changes.emplace_back(path, FileWatcher::Status::Modified);
+				}
+			}
+		}
+
+		// The watched path itself was removed.
+		return !m_directories.empty();
+	}
+
+private:
+	void AddWatches(const std::string &path, Changes *changes)
+	{
+		auto wd = inotify_add_watch(m_fd, path.c_str(), IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+
+		if (wd == -1)
+		{
+			return;
+		}
+
+		m_directories[wd] = path;
+
+		auto dr = opendir(path.c_str());
+
+		if (dr == nullptr)
+		{
+			return;
+		}
+
+		while (auto de = readdir(dr))
+		{
+			if (std::strcmp(de->d_name, ".") == 0 || std::strcmp(de->d_name, "..") == 0)
+			{
+				continue;
+			}
+
+			auto childPath = path + FileSystem::Separator + de->d_name;
+
+			if (FileSystem::IsDirectory(childPath))
+			{
+				AddWatches(childPath, changes);
+			}
+			else if (changes != nullptr)
+			{
+				changes->emplace_back(childPath, FileWatcher::Status::Created);
+			}
+		}
+
+		closedir(dr);
+	}
+
+	int m_fd;
+	std::map<int, std::string> m_directories;
+};
+#elif defined(ACID_BUILD_WINDOWS)
+/**
+ * Watches a directory tree with overlapped ReadDirectoryChangesW calls.
+ */
+class NativeWatcher
+{
+public:
+	explicit NativeWatcher(const std::string &path) :
+		m_path(path),
+		m_handle(CreateFileA(path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+			FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr)),
+		m_overlapped({}),
+		m_buffer(64 * 1024 / sizeof(DWORD))
+	{
+		if (m_handle == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		m_overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+		m_reading = Issue();
+	}
+
+	~NativeWatcher()
+	{
+		if (m_handle == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		if (m_reading)
+		{
+			DWORD bytes;
+			CancelIoEx(m_handle, &m_overlapped);
+			GetOverlappedResult(m_handle, &m_overlapped, &bytes, TRUE);
+		}
+
+		CloseHandle(m_overlapped.hEvent);
+		CloseHandle(m_handle);
+	}
+
+	bool IsValid() const { return m_handle != INVALID_HANDLE_VALUE && m_reading; }
+
+	bool Read(const Time &timeout, Changes &changes)
+	{
+		if (WaitForSingleObject(m_overlapped.hEvent, timeout.AsMilliseconds<DWORD>()) != WAIT_OBJECT_0)
+		{
+			return true;
+		}
+
+		DWORD bytes = 0;
+
+		if (!GetOverlappedResult(m_handle, &m_overlapped, &bytes, FALSE))
+		{
+			return false;
+		}
+
+		if (bytes == 0)
+		{
+			Log::Error("File watcher event buffer overflowed, some changes were missed\n");
+		}
+
+		for (auto offset = reinterpret_cast<char *>(m_buffer.data()); bytes != 0;)
+		{
+			auto information = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(offset);
+			auto nameLength = static_cast<int>(information->FileNameLength / sizeof(WCHAR));
+			auto size = WideCharToMultiByte(CP_UTF8, 0, information->FileName, nameLength, nullptr, 0, nullptr, nullptr);
+			std::string name(size, '\0');
+			WideCharToMultiByte(CP_UTF8, 0, information->FileName, nameLength, name.data(), size, nullptr, nullptr);
+			std::replace(name.begin(), name.end(), FileSystem::AltSeparator, FileSystem::Separator);
+			auto path = m_path + FileSystem::Separator + name;
+
+			switch (information->Action)
+			{
+			case FILE_ACTION_ADDED:
+			case FILE_ACTION_RENAMED_NEW_NAME:
+				changes.emplace_back(path, FileWatcher::Status::Created);
+				break;
+			case FILE_ACTION_REMOVED:
+			case FILE_ACTION_RENAMED_OLD_NAME:
+				changes.emplace_back(path, FileWatcher::Status::Erased);
+				break;
+			case FILE_ACTION_MODIFIED:
+				if (!FileSystem::IsDirectory(path))
+				{
+					changes.emplace_back(path, FileWatcher::Status::Modified);
+				}
+				break;
+			}
+
+			if (information->NextEntryOffset == 0)
+			{
+				break;
+			}
+
+			offset += information->NextEntryOffset;
+		}
+
+		m_reading = Issue();
+		return m_reading;
+	}
+
+private:
+	bool Issue()
+	{
+		ResetEvent(m_overlapped.hEvent);
+		return ReadDirectoryChangesW(m_handle, m_buffer.data(), static_cast<DWORD>(m_buffer.size() * sizeof(DWORD)), TRUE,
+			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, nullptr, &m_overlapped, nullptr) != 0;
+	}
+
+	std::string m_path;
+	HANDLE m_handle;
+	OVERLAPPED m_overlapped;
+	std::vector<DWORD> m_buffer;
+	bool m_reading = false;
+};
+#elif defined(ACID_BUILD_MACOS)
+/**
+ * Watches a directory tree with a FSEvents stream delivering file level events onto its own dispatch queue.
+ */
+class NativeWatcher
+{
+public:
+	explicit NativeWatcher(const std::string &path) :
+		m_path(path),
+		m_stream(nullptr),
+		m_queue(nullptr)
+	{
+		char resolved[PATH_MAX];
+
+		if (realpath(path.c_str(), resolved) == nullptr)
+		{
+			return;
+		}
+
+		m_resolved = resolved;
+
+		auto cfPath = CFStringCreateWithCString(nullptr, resolved, kCFStringEncodingUTF8);
+		auto cfPaths = CFArrayCreate(nullptr, reinterpret_cast<const void **>(&cfPath), 1, &kCFTypeArrayCallBacks);
+
+		FSEventStreamContext context = {};
+		context.info = this;
+		m_stream = FSEventStreamCreate(nullptr, &NativeWatcher::Callback, &context, cfPaths, kFSEventStreamEventIdSinceNow, COALESCE_TIME.AsSeconds<double>(),
+			kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer);
+		CFRelease(cfPaths);
+		CFRelease(cfPath);
+
+		if (m_stream == nullptr)
+		{
+			return;
+		}
+
+		m_queue = dispatch_queue_create("acid.filewatcher", DISPATCH_QUEUE_SERIAL);
+		FSEventStreamSetDispatchQueue(m_stream, m_queue);
+
+		if (!FSEventStreamStart(m_stream))
+		{
+			FSEventStreamInvalidate(m_stream);
+			FSEventStreamRelease(m_stream);
+			m_stream = nullptr;
+		}
+	}
+
+	~NativeWatcher()
+	{
+		if (m_stream != nullptr)
+		{
+			FSEventStreamStop(m_stream);
+			FSEventStreamInvalidate(m_stream);
+			FSEventStreamRelease(m_stream);
+		}
+
+		if (m_queue != nullptr)
+		{
+			dispatch_release(m_queue);
+		}
+	}
+
+	bool IsValid() const { return m_stream != nullptr; }
+
+	bool Read(const Time &timeout, Changes &changes)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait_for(lock, std::chrono::microseconds(timeout.AsMicroseconds()), [this]()
+		{
+			return !m_changes.empty();
+		});
+		changes.insert(changes.end(), m_changes.begin(), m_changes.end());
+		m_changes.clear();
+		return true;
+	}
+
+private:
+	static void Callback(ConstFSEventStreamRef stream, void *info, size_t count, void *paths, const FSEventStreamEventFlags flags[], const FSEventStreamEventId ids[])
+	{
+		auto watcher = static_cast<NativeWatcher *>(info);
+		auto eventPaths = static_cast<char **>(paths);
+
+		std::lock_guard<std::mutex> lock(watcher->m_mutex);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (!(flags[i] & kFSEventStreamEventFlagItemIsFile))
+			{
+				continue;
+			}
+
+			// Events report the resolved path, they are called with the path the watcher was given.
+			std::string path = eventPaths[i];
+
+			if (path.compare(0, watcher->m_resolved.size(), watcher->m_resolved) == 0)
+			{
+				path = watcher->m_path + path.substr(watcher->m_resolved.size());
+			}
+
+			// A event may carry several flags, the files current state decides between them.
+			auto exists = FileSystem::Exists(path);
+
+			if (!exists && (flags[i] & (kFSEventStreamEventFlagItemRemoved | kFSEventStreamEventFlagItemRenamed)))
+			{
+				watcher->m_changes.emplace_back(path, FileWatcher::Status::Erased);
+			}
+			else if (exists && (flags[i] & (kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemRenamed)))
+			{
+				watcher->m_changes.emplace_back(path, FileWatcher::Status::Created);
+			}
+			else if (exists)
+			{
+				watcher->m_changes.emplace_back(path, FileWatcher::Status::Modified);
+			}
+		}
+
+		watcher->m_condition.notify_one();
+	}
+
+	std::string m_path;
+	std::string m_resolved;
+	FSEventStreamRef m_stream;
+	dispatch_queue_t m_queue;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	Changes m_changes;
+};
+#else
+class NativeWatcher
+{
+public:
+	explicit NativeWatcher(const std::string &path)
+	{
+	}
+
+	bool IsValid() const { return false; }
+
+	bool Read(const Time &timeout, Changes &changes) { return false; }
+};
+#endif
+}
+
 FileWatcher::FileWatcher(std::string path, const Time &delay) :
 	m_path(std::move(path)),
 	m_delay(delay),
 	m_running(true),
-	m_thread(&FileWatcher::QueueLoop, this)
+	m_native(false)
 {
-	for (auto &file : FileSystem::FilesInPath(m_path))
-	{
-		m_paths[file] = FileSystem::LastModified(file);
-	}
+	m_thread = std::thread(&FileWatcher::QueueLoop, this);
 }
 
 FileWatcher::~FileWatcher()
@@ -26,12 +450,95 @@ FileWatcher::~FileWatcher()
 	}
 }
 
+std::string FileWatcher::GetPath() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_path;
+}
+
+void FileWatcher::SetPath(const std::string &path)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_path = path;
+}
+
 void FileWatcher::QueueLoop()
 {
 	while (m_running)
 	{
-		// Wait for "delay" milliseconds
-		std::this_thread::sleep_for(std::chrono::microseconds(m_delay.AsMicroseconds()));
+		auto path = GetPath();
+
+		if (NativeWatcher native(path); native.IsValid())
+		{
+			m_native = true;
+			NativeLoop(native, path);
+			continue;
+		}
+
+		m_native = false;
+		PollLoop(path);
+	}
+}
+
+template<typename T>
+void FileWatcher::NativeLoop(T &native, const std::string &path)
+{
+	std::vector<std::pair<std::string, Status>> changes;
+
+	while (m_running && path == GetPath())
+	{
+		auto wait = WAIT_TIME;
+
+		// Wakes when the oldest waiting change has settled.
+		for (const auto &[pendingPath, pending] : m_pending)
+		{
+			wait = std::min(wait, std::max(pending.m_time + COALESCE_TIME - Engine::GetTime(), Time::Milliseconds(1)));
+		}
+
+		changes.clear();
+		auto valid = native.Read(wait, changes);
+		auto now = Engine::GetTime();
+
+		for (const auto &[changePath, status] : changes)
+		{
+			Coalesce(changePath, status, now);
+		}
+
+		CallPending(now, false);
+
+		if (!valid)
+		{
+			// The watch can no longer be read, it is created again or replaced by polling.
+			break;
+		}
+	}
+
+	CallPending(Engine::GetTime(), true);
+}
+
+void FileWatcher::PollLoop(const std::string &path)
+{
+	m_paths.clear();
+
+	for (auto &file : FileSystem::FilesInPath(path))
+	{
+		m_paths[file] = FileSystem::LastModified(file);
+	}
+
+	while (m_running && path == GetPath())
+	{
+		// Wait for "delay" milliseconds, while still noticing when the watcher is destroyed.
+		auto waitStart = Engine::GetTime();
+
+		while (m_running && Engine::GetTime() - waitStart < m_delay)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(std::min(WAIT_TIME, m_delay).AsMicroseconds()));
+		}
+
+		if (!m_running)
+		{
+			return;
+		}
 
 		// Check if one of the old files was erased
 		for (auto it = m_paths.begin(); it != m_paths.end();)
@@ -47,7 +554,7 @@ void FileWatcher::QueueLoop()
 		}
 
 		// Check if a file was created or modified
-		for (auto &file : FileSystem::FilesInPath(m_path))
+		for (auto &file : FileSystem::FilesInPath(path))
 		{
 			auto lastWriteTime = FileSystem::LastModified(file);
 
@@ -70,6 +577,53 @@ void FileWatcher::QueueLoop()
 	}
 }
 
+void FileWatcher::CallPending(const Time &now, const bool &force)
+{
+	for (auto it = m_pending.begin(); it != m_pending.end();)
+	{
+		if (!force && now - it->second.m_time < COALESCE_TIME)
+		{
+			it++;
+			continue;
+		}
+
+		m_onChange(it->first, it->second.m_status);
+		it = m_pending.erase(it);
+	}
+}
+
+void FileWatcher::Coalesce(const std::string &path, const Status &status, const Time &time)
+{
+	auto it = m_pending.find(path);
+
+	if (it == m_pending.end())
+	{
+		m_pending.emplace(path, Pending{ status, time });
+		return;
+	}
+
+	auto &pending = it->second;
+	pending.m_time = time;
+
+	switch (pending.m_status)
+	{
+	case Status::Created:
+		// A file that is created then erased was never seen.
+		if (status == Status::Erased)
+		{
+			m_pending.erase(it);
+		}
+		break;
+	case Status::Modified:
+		pending.m_status = status == Status::Erased ? Status::Erased : Status::Modified;
+		break;
+	case Status::Erased:
+		// Editors often save by replacing the file.
+		pending.m_status = Status::Modified;
+		break;
+	}
+}
+
 bool FileWatcher::Contains(const std::string &key) const
 {
 	auto el = m_paths.find(key);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <thread>
 #include "Maths/Time.hpp"
 #include "Helpers/Delegate.hpp"
@@ -8,6 +10,8 @@ namespace acid
 {
 /**
  * @brief Class that can listen to file changes on a path recursively.
+ * Changes are read from inotify, ReadDirectoryChangesW, or FSEvents, and changes to the same file in quick succession are coalesced into one.
+ * If the platform can not watch the path the files are polled instead.
  */
 class ACID_EXPORT FileWatcher
 {
@@ -20,15 +24,25 @@ public:
 	/**
 	 * Creates a new file watcher.
 	 * @param path The path to watch recursively.
-	 * @param delay How frequently to check for changes.
+	 * @param delay How frequently to check for changes when polling.
 	 */
 	explicit FileWatcher(std::string path, const Time &delay = Time::Seconds(5.0f));
 
 	~FileWatcher();
 
-	const std::string &GetPath() const { return m_path; }
+	std::string GetPath() const;
 
-	void SetPath(const std::string &path) { m_path = path; }
+	/**
+	 * Sets the path to watch, the new path is watched from the next check.
+	 * @param path The path to watch recursively.
+	 */
+	void SetPath(const std::string &path);
+
+	/**
+	 * Gets if changes are read from the platform instead of being polled.
+	 * @return If the watcher is native.
+	 */
+	bool IsNative() const { return m_native; }
 
 	const Time &GetDelay() const { return m_delay; }
 
@@ -41,16 +55,46 @@ public:
 	Delegate<void(std::string, Status)> &OnChange() { return m_onChange; }
 
 private:
+	class Pending
+	{
+	public:
+		Status m_status;
+		Time m_time;
+	};
+
 	void QueueLoop();
 
+	template<typename T>
+	void NativeLoop(T &native, const std::string &path);
+
+	void PollLoop(const std::string &path);
+
+	/**
+	 * Calls the changes that have not been merged with another for the coalescing time.
+	 * @param now The current time.
+	 * @param force If every change is called.
+	 */
+	void CallPending(const Time &now, const bool &force);
+
+	/**
+	 * Merges a change into the changes waiting to be called.
+	 * @param path The changed path.
+	 * @param status The change.
+	 * @param time When the change was read.
+	 */
+	void Coalesce(const std::string &path, const Status &status, const Time &time);
+
 	bool Contains(const std::string &key) const;
 
+	mutable std::mutex m_mutex;
 	std::string m_path;
 	Time m_delay;
 	Delegate<void(std::string, Status)> m_onChange;
 
-	bool m_running;
-	std::thread m_thread;
+	std::atomic<bool> m_running;
+	std::atomic<bool> m_native;
+	std::map<std::string, Pending> m_pending;
 	std::unordered_map<std::string, long> m_paths;
+	std::thread m_thread;
 };
 }
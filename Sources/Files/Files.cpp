@@ -3,12 +3,29 @@
 #include <physfs.h>
 #include "Engine/Engine.hpp"
 #include "FileSystem.hpp"
+#include "Pack.hpp"
 
 namespace acid
 {
 using std::streambuf;
 using std::ios_base;
 
+namespace
+{
+template<typename T>
+T ReadLittle(const uint8_t *data)
+{
+	T value = 0;
+
+	for (std::size_t i = 0; i < sizeof(T); i++)
+	{
+		value |= static_cast<T>(static_cast<T>(data[i]) << (8 * i));
+	}
+
+	return value;
+}
+}
+
 class FBuffer :
 	public NonCopyable,
 	public streambuf
@@ -208,6 +225,7 @@ FStream::~FStream()
 Files::Files()
 {
 	PHYSFS_init(Engine::Get()->GetArgv0().c_str());
+	Pack::RegisterArchiver();
 }
 
 Files::~Files()
@@ -251,6 +269,10 @@ void Files::RemoveSearchPath(const std::string &path)
 	}
 
 	m_searchPaths.erase(it);
+
+	std::unique_lock<std::mutex> lock(m_archiveMutex);
+	m_archives.erase(path);
+	m_packs.erase(path);
 }
 
 void Files::ClearSearchPath()
@@ -273,29 +295,92 @@ bool Files::ExistsInPath(const std::string &path)
 
 std::optional<std::string> Files::Read(const std::string &path)
 {
-	auto fsFile = PHYSFS_openRead(path.c_str());
+	auto view = ReadView(path);
+
+	if (!view)
+	{
+		return std::nullopt;
+	}
+
+	return std::string(view->GetString());
+}
 
-	if (fsFile == nullptr)
+std::optional<FileView> Files::ReadView(const std::string &path)
+{
+	if (PHYSFS_isInit() != 0)
 	{
-		if (!FileSystem::Exists(path) || !FileSystem::IsFile(path))
+		if (auto realDir = PHYSFS_getRealDir(path.c_str()); realDir != nullptr)
 		{
-			Log::Error("Error while opening file to load %s: %s\n", path.c_str(), PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
-			return {};
+			std::string searchPath = realDir;
+
+			// Loose files are mapped from their real path, files inside zips and packs are mapped when they are stored uncompressed.
+			if (FileSystem::IsDirectory(searchPath))
+			{
+				if (auto view = FileView::Map(searchPath + FileSystem::Separator + path))
+				{
+					return view;
+				}
+			}
+			else if (auto files = Files::Get(); files != nullptr)
+			{
+				if (auto view = files->ReadArchive(searchPath, path))
+				{
+					return view;
+				}
+			}
+		}
+
+		if (auto fsFile = PHYSFS_openRead(path.c_str()); fsFile != nullptr)
+		{
+			auto size = PHYSFS_fileLength(fsFile);
+			std::vector<uint8_t> data(static_cast<std::size_t>(std::max<PHYSFS_sint64>(size, 0)));
+			auto bytesRead = PHYSFS_readBytes(fsFile, data.data(), static_cast<PHYSFS_uint64>(data.size()));
+			data.resize(static_cast<std::size_t>(std::max<PHYSFS_sint64>(bytesRead, 0)));
+
+			if (PHYSFS_close(fsFile) == 0)
+			{
+				Log::Error("Error while closing file %s: %s\n", path.c_str(), PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+			}
+
+			return FileView::FromBuffer(std::move(data));
 		}
+	}
 
-		return FileSystem::ReadTextFile(path);
+	if (FileSystem::Exists(path) && FileSystem::IsFile(path))
+	{
+		if (auto view = FileView::Map(path))
+		{
+			return view;
+		}
 	}
 
-	auto size = PHYSFS_fileLength(fsFile);
-	std::vector<uint8_t> data(size);
-	PHYSFS_readBytes(fsFile, data.data(), static_cast<PHYSFS_uint64>(size));
+	Log::Error("Error while opening file to load %s: %s\n", path.c_str(), PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+	return std::nullopt;
+}
+
+std::optional<std::string> Files::FindRealPath(const std::string &path)
+{
+	if (PHYSFS_isInit() != 0)
+	{
+		if (auto realDir = PHYSFS_getRealDir(path.c_str()); realDir != nullptr)
+		{
+			std::string searchPath = realDir;
+
+			if (!FileSystem::IsDirectory(searchPath))
+			{
+				return std::nullopt;
+			}
+
+			return searchPath + FileSystem::Separator + path;
+		}
+	}
 
-	if (PHYSFS_close(fsFile) == 0)
+	if (FileSystem::Exists(path) && FileSystem::IsFile(path))
 	{
-		Log::Error("Error while closing file %s: %s\n", path.c_str(), PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+		return path;
 	}
 
-	return std::string(data.begin(), data.end());
+	return std::nullopt;
 }
 
 std::vector<std::string> Files::FilesInPath(const std::string &path, const bool &recursive)
@@ -324,6 +409,155 @@ std::vector<std::string> Files::FilesInPath(const std::string &path, const bool
 	return files;
 }
 
+std::optional<FileView> Files::ReadArchive(const std::string &archive, const std::string &path)
+{
+	std::unique_lock<std::mutex> lock(m_archiveMutex);
+
+	if (FileSystem::FileSuffix(archive) == Pack::Extension)
+	{
+		auto pack = m_packs.find(archive);
+
+		if (pack == m_packs.end())
+		{
+			pack = m_packs.emplace(archive, Pack::Open(archive)).first;
+		}
+
+		if (pack->second == nullptr)
+		{
+			return std::nullopt;
+		}
+
+		auto entry = pack->second->Find(path);
+
+		if (entry == nullptr)
+		{
+			return std::nullopt;
+		}
+
+		return pack->second->Read(*entry);
+	}
+
+	auto it = m_archives.find(archive);
+
+	if (it == m_archives.end())
+	{
+		it = m_archives.emplace(archive, LoadArchive(archive)).first;
+	}
+
+	if (!it->second)
+	{
+		return std::nullopt;
+	}
+
+	auto entry = it->second->m_entries.find(path);
+
+	if (entry == it->second->m_entries.end())
+	{
+		return std::nullopt;
+	}
+
+	return it->second->m_view.GetSubView(entry->second.first, entry->second.second);
+}
+
+std::optional<Files::Archive> Files::LoadArchive(const std::string &archive)
+{
+	static const std::size_t EndRecordSize = 22;
+	static const std::size_t CentralHeaderSize = 46;
+	static const std::size_t LocalHeaderSize = 30;
+
+	auto view = FileView::Map(archive);
+
+	if (!view || !view->IsMapped() || view->GetSize() < EndRecordSize)
+	{
+		return std::nullopt;
+	}
+
+	auto data = view->GetData();
+	auto size = view->GetSize();
+
+	// The end of central directory record is followed by a comment of up to 65535 bytes.
+	std::optional<std::size_t> endRecord;
+
+	for (std::size_t i = size - EndRecordSize + 1; i-- > 0 && size - i <= EndRecordSize + 0xFFFF;)
+	{
+		if (ReadLittle<uint32_t>(data + i) == 0x06054b50)
+		{
+			endRecord = i;
+			break;
+		}
+	}
+
+	if (!endRecord)
+	{
+		return std::nullopt;
+	}
+
+	auto entryCount = ReadLittle<uint16_t>(data + *endRecord + 10);
+	auto directorySize = ReadLittle<uint32_t>(data + *endRecord + 12);
+	auto directoryOffset = ReadLittle<uint32_t>(data + *endRecord + 16);
+
+	// Zip64 archives are left to PhysFS.
+	if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF ||
+		static_cast<std::size_t>(directoryOffset) + directorySize > *endRecord)
+	{
+		return std::nullopt;
+	}
+
+	Archive result;
+	result.m_view = *view;
+	std::size_t offset = directoryOffset;
+
+	for (uint16_t i = 0; i < entryCount; i++)
+	{
+		if (offset + CentralHeaderSize > *endRecord || ReadLittle<uint32_t>(data + offset) != 0x02014b50)
+		{
+			break;
+		}
+
+		auto flags = ReadLittle<uint16_t>(data + offset + 8);
+		auto method = ReadLittle<uint16_t>(data + offset + 10);
+		auto compressedSize = ReadLittle<uint32_t>(data + offset + 20);
+		auto uncompressedSize = ReadLittle<uint32_t>(data + offset + 24);
+		auto nameLength = ReadLittle<uint16_t>(data + offset + 28);
+		auto extraLength = ReadLittle<uint16_t>(data + offset + 30);
+		auto commentLength = ReadLittle<uint16_t>(data + offset + 32);
+		auto localOffset = static_cast<std::size_t>(ReadLittle<uint32_t>(data + offset + 42));
+
+		if (offset + CentralHeaderSize + nameLength > *endRecord)
+		{
+			break;
+		}
+
+		std::string name(reinterpret_cast<const char *>(data + offset + CentralHeaderSize), nameLength);
+		offset += CentralHeaderSize + nameLength + extraLength + commentLength;
+
+		// Only entries that are stored without compression or encryption can be read in place.
+		if (method != 0 || (flags & 0x1) != 0 || compressedSize != uncompressedSize || name.empty() || name.back() == '/')
+		{
+			continue;
+		}
+
+		if (localOffset + LocalHeaderSize > size || ReadLittle<uint32_t>(data + localOffset) != 0x04034b50)
+		{
+			continue;
+		}
+
+		auto dataOffset = localOffset + LocalHeaderSize + ReadLittle<uint16_t>(data + localOffset + 26) + ReadLittle<uint16_t>(data + localOffset + 28);
+
+		if (dataOffset + uncompressedSize > size)
+		{
+			continue;
+		}
+
+		result.m_entries.emplace(name, std::make_pair(dataOffset, static_cast<std::size_t>(uncompressedSize)));
+	}
+
+#if defined(ACID_VERBOSE)
+	Log::Out("Archive '%s' has %i entries that can be mapped\n", archive.c_str(), static_cast<int32_t>(result.m_entries.size()));
+#endif
+	return result;
+}
+
 std::istream &Files::SafeGetLine(std::istream &is, std::string &t)
 {
 	t.clear();
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <mutex>
 #include "Engine/Engine.hpp"
+#include "FileView.hpp"
 
 struct PHYSFS_File;
 
 namespace acid
 {
+class Pack;
+
 enum class FileMode
 {
 	Read, Write, Append
@@ -73,7 +77,7 @@ public:
 	void Update() override;
 
 	/**
-	 * Adds an file search path.
+	 * Adds an file search path, this may be a folder, a zip, or a cooked {@link Pack}.
 	 * @param path The path to add.
 	 */
 	void AddSearchPath(const std::string &path);
@@ -103,6 +107,20 @@ public:
 	 */
 	static std::optional<std::string> Read(const std::string &path);
 
+	/**
+	 * Reads a file found by real or partial path without copying it when possible, loose files and entries stored uncompressed in zip or pack search paths are memory mapped.
+	 * @param path The path to read.
+	 * @return The view of the file contents.
+	 */
+	static std::optional<FileView> ReadView(const std::string &path);
+
+	/**
+	 * Finds the path on disk of a file found by real or partial path, such as to read it without PhysFS.
+	 * @param path The path to look for.
+	 * @return The real path, or nullopt if the file was not found or is inside a zip or pack.
+	 */
+	static std::optional<std::string> FindRealPath(const std::string &path);
+
 	/**
 	 * Finds all the files in a path.
 	 * @param path The path to search.
@@ -120,6 +138,23 @@ public:
 	static std::istream &SafeGetLine(std::istream &is, std::string &t);
 
 private:
+	/**
+	 * @brief The mapping of a zip search path, with the location of every entry that is stored uncompressed.
+	 */
+	class Archive
+	{
+	public:
+		FileView m_view;
+		std::map<std::string, std::pair<std::size_t, std::size_t>> m_entries;
+	};
+
+	std::optional<FileView> ReadArchive(const std::string &archive, const std::string &path);
+
+	static std::optional<Archive> LoadArchive(const std::string &archive);
+
 	std::vector<std::string> m_searchPaths;
+	std::map<std::string, std::optional<Archive>> m_archives;
+	std::map<std::string, std::shared_ptr<Pack>> m_packs;
+	std::mutex m_archiveMutex;
 };
 }
@@ -0,0 +1,721 @@
+#include "Pack.hpp"
+
+#include <fstream>
+#include <physfs.h>
+#include "Engine/Log.hpp"
+
+namespace acid
+{
+namespace
+{
+/**
+ * @brief The header at the start of every pack, followed by the aligned entry contents, the table of contents, and the entry names.
+ */
+class Header
+{
+public:
+	char m_magic[4];
+	uint32_t m_version;
+	uint32_t m_entryCount;
+	uint32_t m_alignment;
+	uint64_t m_entriesOffset;
+	uint64_t m_namesOffset;
+};
+
+static_assert(sizeof(Header) == 32, "Pack header layout must match the archive on disk");
+static_assert(sizeof(Pack::Entry) == 40, "Pack entry layout must match the archive on disk");
+
+const char PackMagic[4] = { 'A', 'C', 'P', 'K' };
+const uint32_t PackVersion = 1;
+
+// LZ4 blocks end with at least 5 literals, and the last match starts at least 12 bytes before the end.
+const std::size_t Lz4MinMatch = 4;
+const std::size_t Lz4LastLiterals = 5;
+const std::size_t Lz4MatchLimit = 12;
+const std::size_t Lz4MaxOffset = 65535;
+const uint32_t Lz4HashBits = 16;
+
+uint32_t Read32(const uint8_t *data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+void WriteLength(std::vector<uint8_t> &output, std::size_t length)
+{
+	while (length >= 255)
+	{
+		output.emplace_back(255);
+		length -= 255;
+	}
+
+	output.emplace_back(static_cast<uint8_t>(length));
+}
+
+std::size_t Align(const std::size_t &offset, const std::size_t &alignment)
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief The contents of a entry opened through PhysFS.
+ */
+class EntryStream
+{
+public:
+	FileView m_view;
+	uint64_t m_position = 0;
+};
+
+PHYSFS_Io *CreateEntryIo(const FileView &view);
+
+PHYSFS_sint64 EntryRead(PHYSFS_Io *io, void *buffer, PHYSFS_uint64 length)
+{
+	auto stream = static_cast<EntryStream *>(io->opaque);
+	auto available = stream->m_view.GetSize() - stream->m_position;
+	auto count = std::min<PHYSFS_uint64>(length, available);
+	std::memcpy(buffer, stream->m_view.GetData() + stream->m_position, static_cast<std::size_t>(count));
+	stream->m_position += count;
+	return static_cast<PHYSFS_sint64>(count);
+}
+
+PHYSFS_sint64 EntryWrite(PHYSFS_Io *io, const void *buffer, PHYSFS_uint64 length)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return -1;
+}
+
+int EntrySeek(PHYSFS_Io *io, PHYSFS_uint64 offset)
+{
+	auto stream = static_cast<EntryStream *>(io->opaque);
+
+	if (offset > stream->m_view.GetSize())
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+		return 0;
+	}
+
+	stream->m_position = offset;
+	return 1;
+}
+
+PHYSFS_sint64 EntryTell(PHYSFS_Io *io)
+{
+	return static_cast<PHYSFS_sint64>(static_cast<EntryStream *>(io->opaque)->m_position);
+}
+
+PHYSFS_sint64 EntryLength(PHYSFS_Io *io)
+{
+	return static_cast<PHYSFS_sint64>(static_cast<EntryStream *>(io->opaque)->m_view.GetSize());
+}
+
+PHYSFS_Io *EntryDuplicate(PHYSFS_Io *io)
+{
+	return CreateEntryIo(static_cast<EntryStream *>(io->opaque)->m_view);
+}
+
+int EntryFlush(PHYSFS_Io *io)
+{
+	return 1;
+}
+
+void EntryDestroy(PHYSFS_Io *io)
+{
+	delete static_cast<EntryStream *>(io->opaque);
+	delete io;
+}
+
+PHYSFS_Io *CreateEntryIo(const FileView &view)
+{
+	auto io = new PHYSFS_Io{};
+	io->version = 0;
+	io->opaque = new EntryStream{view};
+	io->read = EntryRead;
+	io->write = EntryWrite;
+	io->seek = EntrySeek;
+	io->tell = EntryTell;
+	io->length = EntryLength;
+	io->duplicate = EntryDuplicate;
+	io->flush = EntryFlush;
+	io->destroy = EntryDestroy;
+	return io;
+}
+
+void *ArchiveOpen(PHYSFS_Io *io, const char *name, int forWrite, int *claimed)
+{
+	char magic[sizeof(PackMagic)];
+
+	if (io->seek(io, 0) == 0 || io->read(io, magic, sizeof(magic)) != sizeof(magic) || std::memcmp(magic, PackMagic, sizeof(magic)) != 0)
+	{
+		return nullptr;
+	}
+
+	*claimed = 1;
+
+	if (forWrite != 0)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+		return nullptr;
+	}
+
+	// Packs on disk are mapped, packs nested in other archives are read into memory.
+	auto length = io->length(io);
+	auto view = FileView::Map(name);
+
+	if (!view || static_cast<PHYSFS_sint64>(view->GetSize()) != length)
+	{
+		std::vector<uint8_t> data(static_cast<std::size_t>(std::max<PHYSFS_sint64>(length, 0)));
+
+		if (io->seek(io, 0) == 0 || io->read(io, data.data(), data.size()) != static_cast<PHYSFS_sint64>(data.size()))
+		{
+			return nullptr;
+		}
+
+		view = FileView::FromBuffer(std::move(data));
+	}
+
+	auto pack = Pack::Open(*view);
+
+	if (pack == nullptr)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	// The archiver owns the io once it is opened, the pack does not need it after this.
+	io->destroy(io);
+	return new std::shared_ptr<Pack>(pack);
+}
+
+PHYSFS_EnumerateCallbackResult ArchiveEnumerate(void *opaque, const char *dirname, PHYSFS_EnumerateCallback callback, const char *origdir, void *callbackdata)
+{
+	auto &pack = *static_cast<std::shared_ptr<Pack> *>(opaque);
+	auto children = pack->GetChildren(dirname);
+
+	if (children == nullptr)
+	{
+		return PHYSFS_ENUM_OK;
+	}
+
+	for (const auto &child : *children)
+	{
+		auto result = callback(callbackdata, origdir, child.c_str());
+
+		if (result == PHYSFS_ENUM_ERROR)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_APP_CALLBACK);
+		}
+
+		if (result != PHYSFS_ENUM_OK)
+		{
+			return result;
+		}
+	}
+
+	return PHYSFS_ENUM_OK;
+}
+
+PHYSFS_Io *ArchiveOpenRead(void *opaque, const char *filename)
+{
+	auto &pack = *static_cast<std::shared_ptr<Pack> *>(opaque);
+	auto entry = pack->Find(filename);
+
+	if (entry == nullptr)
+	{
+		PHYSFS_setErrorCode(pack->GetChildren(filename) != nullptr ? PHYSFS_ERR_NOT_A_FILE : PHYSFS_ERR_NOT_FOUND);
+		return nullptr;
+	}
+
+	auto view = pack->Read(*entry);
+
+	if (!view)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	return CreateEntryIo(*view);
+}
+
+PHYSFS_Io *ArchiveOpenWrite(void *opaque, const char *filename)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return nullptr;
+}
+
+int ArchiveRemove(void *opaque, const char *filename)
+{
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return 0;
+}
+
+int ArchiveStat(void *opaque, const char *filename, PHYSFS_Stat *stat)
+{
+	auto &pack = *static_cast<std::shared_ptr<Pack> *>(opaque);
+	*stat = {};
+	stat->modtime = -1;
+	stat->createtime = -1;
+	stat->accesstime = -1;
+	stat->readonly = 1;
+
+	if (auto entry = pack->Find(filename); entry != nullptr)
+	{
+		stat->filesize = static_cast<PHYSFS_sint64>(entry->m_size);
+		stat->filetype = PHYSFS_FILETYPE_REGULAR;
+		return 1;
+	}
+
+	if (pack->GetChildren(filename) != nullptr)
+	{
+		stat->filesize = 0;
+		stat->filetype = PHYSFS_FILETYPE_DIRECTORY;
+		return 1;
+	}
+
+	PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+	return 0;
+}
+
+void ArchiveClose(void *opaque)
+{
+	delete static_cast<std::shared_ptr<Pack> *>(opaque);
+}
+}
+
+const std::string Pack::Extension = ".acidpack";
+
+std::shared_ptr<Pack> Pack::Open(const std::string &filename)
+{
+	auto view = FileView::Map(filename);
+
+	if (!view)
+	{
+		return nullptr;
+	}
+
+	return Open(*view);
+}
+
+std::shared_ptr<Pack> Pack::Open(const FileView &view)
+{
+	if (view.GetSize() < sizeof(Header))
+	{
+		return nullptr;
+	}
+
+	Header header;
+	std::memcpy(&header, view.GetData(), sizeof(Header));
+
+	if (std::memcmp(header.m_magic, PackMagic, sizeof(PackMagic)) != 0 || header.m_version != PackVersion)
+	{
+		return nullptr;
+	}
+
+	auto size = static_cast<uint64_t>(view.GetSize());
+
+	if (header.m_entriesOffset > size || header.m_entryCount > (size - header.m_entriesOffset) / sizeof(Entry) || header.m_namesOffset > size)
+	{
+		return nullptr;
+	}
+
+	auto pack = std::shared_ptr<Pack>(new Pack());
+	pack->m_view = view;
+	pack->m_namesOffset = header.m_namesOffset;
+	pack->m_entries.resize(header.m_entryCount);
+	std::memcpy(pack->m_entries.data(), view.GetData() + header.m_entriesOffset, header.m_entryCount * sizeof(Entry));
+	pack->m_directories[""];
+
+	for (auto &entry : pack->m_entries)
+	{
+		if (header.m_namesOffset + entry.m_nameOffset + entry.m_nameLength > size || entry.m_offset > size || entry.m_storedSize > size - entry.m_offset ||
+			(entry.m_compression == Compression::None && entry.m_storedSize != entry.m_size) || entry.m_compression > Compression::Lz4)
+		{
+			return nullptr;
+		}
+
+		std::string name(pack->GetName(entry));
+		std::string parent;
+
+		for (std::size_t start = 0;;)
+		{
+			auto end = name.find('/', start);
+			auto &children = pack->m_directories[parent];
+			auto child = name.substr(start, end - start);
+
+			if (std::find(children.begin(), children.end(), child) == children.end())
+			{
+				children.emplace_back(child);
+			}
+
+			if (end == std::string::npos)
+			{
+				break;
+			}
+
+			parent = name.substr(0, end);
+			start = end + 1;
+		}
+	}
+
+	return pack;
+}
+
+bool Pack::RegisterArchiver()
+{
+	static const PHYSFS_Archiver archiver = {
+		0,
+		{
+			"acidpack", "Acid cooked asset pack", "Acid", "https://github.com/Equilibrium-Games/Acid", 0
+		},
+		ArchiveOpen,
+		ArchiveEnumerate,
+		ArchiveOpenRead,
+		ArchiveOpenWrite,
+		ArchiveOpenWrite,
+		ArchiveRemove,
+		ArchiveRemove,
+		ArchiveStat,
+		ArchiveClose
+	};
+
+	if (PHYSFS_registerArchiver(&archiver) == 0)
+	{
+		Log::Error("File System error while registering the pack archiver: %s\n", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+		return false;
+	}
+
+	return true;
+}
+
+const Pack::Entry *Pack::Find(const std::string_view &name) const
+{
+	auto hash = Hash(name);
+	auto it = std::lower_bound(m_entries.begin(), m_entries.end(), hash, [](const Entry &entry, const uint64_t &value)
+	{
+		return entry.m_hash < value;
+	});
+
+	for (; it != m_entries.end() && it->m_hash == hash; ++it)
+	{
+		if (GetName(*it) == name)
+		{
+			return &*it;
+		}
+	}
+
+	return nullptr;
+}
+
+std::optional<FileView> Pack::Read(const Entry &entry) const
+{
+	switch (entry.m_compression)
+	{
+	case Compression::None:
+		return m_view.GetSubView(static_cast<std::size_t>(entry.m_offset), static_cast<std::size_t>(entry.m_size));
+	case Compression::Lz4:
+	{
+		std::vector<uint8_t> data(static_cast<std::size_t>(entry.m_size));
+
+		if (!DecompressLz4(m_view.GetData() + entry.m_offset, static_cast<std::size_t>(entry.m_storedSize), data.data(), data.size()))
+		{
+			Log::Error("Pack entry '%s' could not be decompressed\n", std::string(GetName(entry)).c_str());
+			return std::nullopt;
+		}
+
+		return FileView::FromBuffer(std::move(data));
+	}
+	default:
+		return std::nullopt;
+	}
+}
+
+std::string_view Pack::GetName(const Entry &entry) const
+{
+	return std::string_view(reinterpret_cast<const char *>(m_view.GetData() + m_namesOffset + entry.m_nameOffset), entry.m_nameLength);
+}
+
+const std::vector<std::string> *Pack::GetChildren(const std::string &directory) const
+{
+	auto it = m_directories.find(directory);
+
+	if (it == m_directories.end())
+	{
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+uint64_t Pack::Hash(const std::string_view &name)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	for (auto c : name)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+std::vector<uint8_t> Pack::CompressLz4(const uint8_t *data, const std::size_t &size)
+{
+	std::vector<uint8_t> output;
+	output.reserve(size + size / 255 + 16);
+
+	std::vector<uint32_t> table(1 << Lz4HashBits, 0);
+	std::size_t anchor = 0;
+	std::size_t position = 0;
+
+	auto emitSequence = [&](const std::size_t &literalEnd, const std::size_t &offset, const std::size_t &matchLength)
+	{
+		auto literalLength = literalEnd - anchor;
+		auto tokenIndex = output.size();
+		output.emplace_back(static_cast<uint8_t>(std::min<std::size_t>(literalLength, 15) << 4));
+
+		if (literalLength >= 15)
+		{
+			WriteLength(output, literalLength - 15);
+		}
+
+		output.insert(output.end(), data + anchor, data + literalEnd);
+
+		if (matchLength == 0)
+		{
+			return;
+		}
+
+		output.emplace_back(static_cast<uint8_t>(offset & 0xFF));
+		output.emplace_back(static_cast<uint8_t>(offset >> 8));
+		output[tokenIndex] |= static_cast<uint8_t>(std::min<std::size_t>(matchLength - Lz4MinMatch, 15));
+
+		if (matchLength - Lz4MinMatch >= 15)
+		{
+			WriteLength(output, matchLength - Lz4MinMatch - 15);
+		}
+	};
+
+	if (size > Lz4MatchLimit)
+	{
+		auto startLimit = size - Lz4MatchLimit;
+		auto matchLimit = size - Lz4LastLiterals;
+
+		while (position < startLimit)
+		{
+			auto sequence = Read32(data + position);
+			auto hash = (sequence * 2654435761u) >> (32 - Lz4HashBits);
+			auto candidate = static_cast<std::size_t>(table[hash]);
+			table[hash] = static_cast<uint32_t>(position + 1);
+
+			if (candidate == 0 || position - (candidate - 1) > Lz4MaxOffset || Read32(data + candidate - 1) != sequence)
+			{
+				position++;
+				continue;
+			}
+
+			auto match = candidate - 1;
+			auto matchLength = Lz4MinMatch;
+
+			while (position + matchLength < matchLimit && data[match + matchLength] == data[position + matchLength])
+			{
+				matchLength++;
+			}
+
+			emitSequence(position, position - match, matchLength);
+			position += matchLength;
+			anchor = position;
+		}
+	}
+
+	emitSequence(size, 0, 0);
+	return output;
+}
+
+bool Pack::DecompressLz4(const uint8_t *source, const std::size_t &sourceSize, uint8_t *destination, const std::size_t &destinationSize)
+{
+	std::size_t input = 0;
+	std::size_t output = 0;
+
+	auto readLength = [&](std::size_t &length) -> bool
+	{
+		if (length != 15)
+		{
+			return true;
+		}
+
+		uint8_t next;
+
+		do
+		{
+			if (input >= sourceSize)
+			{
+				return false;
+			}
+
+			next = source[input++];
+			length += next;
+		} while (next == 255);
+
+		return true;
+	};
+
+	while (input < sourceSize)
+	{
+		auto token = source[input++];
+		std::size_t literalLength = token >> 4;
+
+		if (!readLength(literalLength) || literalLength > sourceSize - input || literalLength > destinationSize - output)
+		{
+			return false;
+		}
+
+		std::memcpy(destination + output, source + input, literalLength);
+		input += literalLength;
+		output += literalLength;
+
+		// The last sequence only has literals.
+		if (input == sourceSize)
+		{
+			break;
+		}
+
+		if (sourceSize - input < 2)
+		{
+			return false;
+		}
+
+		std::size_t offset = source[input] | (source[input + 1] << 8);
+		input += 2;
+		std::size_t matchLength = token & 0xF;
+
+		if (offset == 0 || offset > output || !readLength(matchLength))
+		{
+			return false;
+		}
+
+		matchLength += Lz4MinMatch;
+
+		if (matchLength > destinationSize - output)
+		{
+			return false;
+		}
+
+		// Matches may overlap the bytes they are writing, so they are copied forwards one byte at a time.
+		for (std::size_t i = 0; i < matchLength; i++)
+		{
+			destination[output + i] = destination[output - offset + i];
+		}
+
+		output += matchLength;
+	}
+
+	return output == destinationSize;
+}
+
+PackWriter::PackWriter(const uint32_t &alignment) :
+	m_alignment(std::max<uint32_t>(alignment, 1))
+{
+}
+
+void PackWriter::Add(const std::string &name, std::vector<uint8_t> &&data, const bool &compress)
+{
+	PendingEntry entry = {name, std::move(data), 0, Pack::Compression::None};
+	entry.m_size = entry.m_data.size();
+
+	if (compress && !entry.m_data.empty())
+	{
+		// Compressed entries can not be read in place, so they are only kept when they save at least an eighth of the size.
+		auto compressed = Pack::CompressLz4(entry.m_data.data(), entry.m_data.size());
+
+		if (compressed.size() < entry.m_size - entry.m_size / 8)
+		{
+			entry.m_data = std::move(compressed);
+			entry.m_compression = Pack::Compression::Lz4;
+		}
+	}
+
+	m_entries[name] = std::move(entry);
+}
+
+bool PackWriter::Write(const std::string &filename) const
+{
+	// Contents are written in name order so entries in the same folder stay close together, only the table is sorted by hash.
+	std::vector<const PendingEntry *> ordered;
+	ordered.reserve(m_entries.size());
+
+	for (const auto &[name, entry] : m_entries)
+	{
+		ordered.emplace_back(&entry);
+	}
+
+	std::vector<Pack::Entry> entries;
+	std::string names;
+	std::size_t offset = Align(sizeof(Header), m_alignment);
+
+	for (const auto &pending : ordered)
+	{
+		Pack::Entry entry = {};
+		entry.m_hash = Pack::Hash(pending->m_name);
+		entry.m_offset = offset;
+		entry.m_storedSize = pending->m_data.size();
+		entry.m_size = pending->m_size;
+		entry.m_nameOffset = static_cast<uint32_t>(names.size());
+		entry.m_nameLength = static_cast<uint16_t>(pending->m_name.size());
+		entry.m_compression = pending->m_compression;
+		entries.emplace_back(entry);
+
+		names += pending->m_name;
+		offset = Align(offset + pending->m_data.size(), m_alignment);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Pack::Entry &a, const Pack::Entry &b)
+	{
+		return a.m_hash < b.m_hash;
+	});
+
+	Header header = {};
+	std::memcpy(header.m_magic, PackMagic, sizeof(PackMagic));
+	header.m_version = PackVersion;
+	header.m_entryCount = static_cast<uint32_t>(entries.size());
+	header.m_alignment = m_alignment;
+	header.m_entriesOffset = Align(offset, alignof(Pack::Entry));
+	header.m_namesOffset = header.m_entriesOffset + entries.size() * sizeof(Pack::Entry);
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+	if (!file)
+	{
+		Log::Error("Pack could not be opened for writing: '%s'\n", filename.c_str());
+		return false;
+	}
+
+	std::vector<char> padding(m_alignment, 0);
+	auto pad = [&](const std::size_t &to)
+	{
+		auto position = static_cast<std::size_t>(file.tellp());
+		file.write(padding.data(), static_cast<std::streamsize>(to - position));
+	};
+
+	file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+	for (const auto &pending : ordered)
+	{
+		pad(Align(static_cast<std::size_t>(file.tellp()), m_alignment));
+		file.write(reinterpret_cast<const char *>(pending->m_data.data()), static_cast<std::streamsize>(pending->m_data.size()));
+	}
+
+	pad(static_cast<std::size_t>(header.m_entriesOffset));
+	file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Pack::Entry)));
+	file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+	if (!file)
+	{
+		Log::Error("Pack could not be written: '%s'\n", filename.c_str());
+		return false;
+	}
+
+	return true;
+}
+}
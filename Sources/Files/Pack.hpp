@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+#include "FileView.hpp"
+
+namespace acid
+{
+/**
+ * @brief A cooked archive of assets, entries are aligned and listed in a table of contents sorted by the hash of their name.
+ * Entries stored without compression are read in place from the mapped archive, packs are mounted by adding them as a search path in {@link Files}.
+ */
+class ACID_EXPORT Pack :
+	public NonCopyable
+{
+public:
+	enum class Compression : uint8_t
+	{
+		None = 0, Lz4 = 1
+	};
+
+	/**
+	 * @brief A entry in the table of contents, the layout matches the archive on disk.
+	 */
+	class Entry
+	{
+	public:
+		uint64_t m_hash;
+		uint64_t m_offset;
+		uint64_t m_storedSize;
+		uint64_t m_size;
+		uint32_t m_nameOffset;
+		uint16_t m_nameLength;
+		Compression m_compression;
+		uint8_t m_reserved;
+	};
+
+	static const std::string Extension;
+
+	/**
+	 * Opens a pack from a file on disk.
+	 * @param filename The real path of the pack.
+	 * @return The pack, or nullptr if the file is not a valid pack.
+	 */
+	static std::shared_ptr<Pack> Open(const std::string &filename);
+
+	/**
+	 * Opens a pack from its contents.
+	 * @param view The contents of the pack, kept alive by the pack.
+	 * @return The pack, or nullptr if the contents are not a valid pack.
+	 */
+	static std::shared_ptr<Pack> Open(const FileView &view);
+
+	/**
+	 * Registers packs as a PhysFS archive type, so they can be mounted as search paths.
+	 * @return If the pack archiver was registered.
+	 */
+	static bool RegisterArchiver();
+
+	/**
+	 * Finds a entry using a binary search over the table of contents.
+	 * @param name The name of the entry, using '/' as the separator.
+	 * @return The entry, or nullptr if the pack does not contain it.
+	 */
+	const Entry *Find(const std::string_view &name) const;
+
+	/**
+	 * Reads a entry, entries stored without compression are views into the pack.
+	 * @param entry The entry to read.
+	 * @return The contents, or nullopt if the entry is corrupt.
+	 */
+	std::optional<FileView> Read(const Entry &entry) const;
+
+	std::string_view GetName(const Entry &entry) const;
+
+	const std::vector<Entry> &GetEntries() const { return m_entries; }
+
+	/**
+	 * Gets the entries and folders directly inside a folder.
+	 * @param directory The folder, empty for the root of the pack.
+	 * @return The names of the children, or nullptr if the folder does not exist.
+	 */
+	const std::vector<std::string> *GetChildren(const std::string &directory) const;
+
+	/**
+	 * Hashes a entry name for the table of contents using 64 bit FNV-1a.
+	 * @param name The name to hash.
+	 * @return The hash.
+	 */
+	static uint64_t Hash(const std::string_view &name);
+
+	/**
+	 * Compresses data into a LZ4 block.
+	 * @param data The data to compress.
+	 * @param size The size of the data.
+	 * @return The compressed block.
+	 */
+	static std::vector<uint8_t> CompressLz4(const uint8_t *data, const std::size_t &size);
+
+	/**
+	 * Decompresses a LZ4 block.
+	 * @param source The compressed block.
+	 * @param sourceSize The size of the compressed block.
+	 * @param destination The decompressed data.
+	 * @param destinationSize The exact size of the decompressed data.
+	 * @return If the block was valid and decompressed into exactly the destination size.
+	 */
+	static bool DecompressLz4(const uint8_t *source, const std::size_t &sourceSize, uint8_t *destination, const std::size_t &destinationSize);
+
+private:
+	Pack() = default;
+
+	FileView m_view;
+	uint64_t m_namesOffset = 0;
+	std::vector<Entry> m_entries;
+	std::map<std::string, std::vector<std::string>> m_directories;
+};
+
+/**
+ * @brief Writes a {@link Pack}, entries are sorted by their hash and aligned when written.
+ */
+class ACID_EXPORT PackWriter
+{
+public:
+	/**
+	 * Creates a new pack writer.
+	 * @param alignment The alignment of entry contents in bytes, must be a power of two.
+	 */
+	explicit PackWriter(const uint32_t &alignment = 64);
+
+	/**
+	 * Adds a entry to the pack, a entry with the same name is replaced.
+	 * @param name The name of the entry, using '/' as the separator.
+	 * @param data The contents of the entry.
+	 * @param compress If the contents will be compressed when that makes them meaningfully smaller.
+	 */
+	void Add(const std::string &name, std::vector<uint8_t> &&data, const bool &compress = false);
+
+	/**
+	 * Writes the pack to a file on disk.
+	 * @param filename The real path to write to.
+	 * @return If the pack was written.
+	 */
+	bool Write(const std::string &filename) const;
+
+	std::size_t GetEntryCount() const { return m_entries.size(); }
+
+private:
+	class PendingEntry
+	{
+	public:
+		std::string m_name;
+		std::vector<uint8_t> m_data;
+		std::size_t m_size;
+		Pack::Compression m_compression;
+	};
+
+	uint32_t m_alignment;
+	std::map<std::string, PendingEntry> m_entries;
+};
+}
@@ -0,0 +1,595 @@
+#include "FontAtlas.hpp"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_OUTLINE_H
+#include "Engine/Engine.hpp"
+
+namespace acid
+{
+// Edges meeting at more than about 8 degrees from a straight line are corners.
+static const float CORNER_CROSS_THRESHOLD = std::sin(3.0f);
+// Curves are flattened into segments no longer than this many pixels, so they are never more than a small fraction of a pixel from the curve.
+static const float MAX_SEGMENT_LENGTH = 0.5f;
+static const uint32_t MAX_CURVE_SEGMENTS = 64;
+// Glyphs are spaced apart so filtering at the edge of a glyph never reads its neighbours.
+static const uint32_t GLYPH_SPACING = 1;
+
+// The contours of an outline as decomposed by FreeType, each edge is a list of its control points.
+struct OutlineContours
+{
+	std::vector<std::vector<std::vector<Vector2f>>> contours;
+	Vector2f current;
+};
+
+static Vector2f ConvertVector(const FT_Vector *vector)
+{
+	return Vector2f(static_cast<float>(vector->x), static_cast<float>(vector->y));
+}
+
+static void AddEdge(OutlineContours *outline, std::vector<Vector2f> &&points)
+{
+	outline->current = points.back();
+
+	// Degenerate edges have no direction to colour or measure from.
+	for (std::size_t i = 1; i < points.size(); i++)
+	{
+		if (points[i] != points[0])
+		{
+			outline->contours.back().emplace_back(std::move(points));
+			return;
+		}
+	}
+}
+
+static int32_t MoveToFunc(const FT_Vector *to, OutlineContours *outline)
+{
+	outline->contours.emplace_back();
+	outline->current = ConvertVector(to);
+	return 0;
+}
+
+static int32_t LineToFunc(const FT_Vector *to, OutlineContours *outline)
+{
+	AddEdge(outline, { outline->current, ConvertVector(to) });
+	return 0;
+}
+
+static int32_t ConicToFunc(const FT_Vector *control, const FT_Vector *to, OutlineContours *outline)
+{
+	AddEdge(outline, { outline->current, ConvertVector(control), ConvertVector(to) });
+	return 0;
+}
+
+static int32_t CubicToFunc(const FT_Vector *control1, const FT_Vector *control2, const FT_Vector *to, OutlineContours *outline)
+{
+	AddEdge(outline, { outline->current, ConvertVector(control1), ConvertVector(control2), ConvertVector(to) });
+	return 0;
+}
+
+static float Cross(const Vector2f &a, const Vector2f &b)
+{
+	return a.m_x * b.m_y - a.m_y * b.m_x;
+}
+
+static float Median(const float &a, const float &b, const float &c)
+{
+	return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+static Vector2f EvaluateBezier(std::vector<Vector2f> points, const float &t)
+{
+	for (auto count = points.size() - 1; count > 0; count--)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			points[i] = points[i] + (points[i + 1] - points[i]) * t;
+		}
+	}
+
+	return points[0];
+}
+
+FontAtlas::FontAtlas(FT_FaceRec_ *face, const std::vector<char32_t> &codepoints, const uint32_t &emSize, const float &range) :
+	m_range(range),
+	m_spaceWidth(0.0f)
+{
+	// Pixels per font unit, and the size of a font unit in the units of the metafile where a line is FontMetafile::LineHeight high.
+	auto scale = static_cast<float>(emSize) / static_cast<float>(face->units_per_EM);
+	auto unitSize = FontMetafile::LineHeight / static_cast<float>(face->height);
+	auto pixelSize = unitSize / scale;
+	auto padding = static_cast<int32_t>(std::ceil(range));
+
+	FT_Outline_Funcs funcs = {};
+	funcs.move_to = reinterpret_cast<FT_Outline_MoveToFunc>(MoveToFunc);
+	funcs.line_to = reinterpret_cast<FT_Outline_LineToFunc>(LineToFunc);
+	funcs.conic_to = reinterpret_cast<FT_Outline_ConicToFunc>(ConicToFunc);
+	funcs.cubic_to = reinterpret_cast<FT_Outline_CubicToFunc>(CubicToFunc);
+
+	std::vector<GlyphField> glyphs;
+
+	// The face is not thread safe, outlines are read on this thread and only the fields are generated on the pool.
+	for (const auto &codepoint : codepoints)
+	{
+		auto glyphIndex = FT_Get_Char_Index(face, codepoint);
+
+		if (glyphIndex == 0 || FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_SCALE | FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP) != 0)
+		{
+			continue;
+		}
+
+		auto advance = static_cast<float>(face->glyph->metrics.horiAdvance);
+
+		if (codepoint == FontMetafile::SpaceAscii)
+		{
+			m_spaceWidth = advance * unitSize;
+			continue;
+		}
+
+		auto &outline = face->glyph->outline;
+		OutlineContours contours;
+
+		if (outline.n_contours == 0 || FT_Outline_Decompose(&outline, &funcs, &contours) != 0)
+		{
+			m_characters.emplace(codepoint, FontMetafile::Character(codepoint, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, advance * unitSize));
+			continue;
+		}
+
+		FT_BBox cbox;
+		FT_Outline_Get_CBox(&outline, &cbox);
+
+		auto &glyph = glyphs.emplace_back();
+		glyph.codepoint = codepoint;
+		glyph.left = static_cast<int32_t>(std::floor(cbox.xMin * scale)) - padding;
+		glyph.bottom = static_cast<int32_t>(std::floor(cbox.yMin * scale)) - padding;
+		glyph.size.m_x = static_cast<uint32_t>(static_cast<int32_t>(std::ceil(cbox.xMax * scale)) + padding - glyph.left);
+		glyph.size.m_y = static_cast<uint32_t>(static_cast<int32_t>(std::ceil(cbox.yMax * scale)) + padding - glyph.bottom);
+		glyph.advance = advance;
+
+		// Filled areas are to the right of TrueType contours, PostScript contours wind the other way and are reversed.
+		auto reversed = FT_Outline_Get_Orientation(&outline) == FT_ORIENTATION_POSTSCRIPT;
+		auto origin = Vector2f(static_cast<float>(glyph.left), static_cast<float>(glyph.bottom));
+
+		for (auto &contourPoints : contours.contours)
+		{
+			std::vector<Edge> contour;
+
+			for (auto &points : contourPoints)
+			{
+				for (auto &point : points)
+				{
+					point = point * scale - origin;
+				}
+
+				contour.emplace_back(Edge{ std::move(points), White });
+			}
+
+			ColourContour(contour);
+
+			for (const auto &edge : contour)
+			{
+				uint32_t segmentCount = 1;
+
+				if (edge.points.size() > 2)
+				{
+					auto length = 0.0f;
+
+					for (std::size_t i = 1; i < edge.points.size(); i++)
+					{
+						length += (edge.points[i] - edge.points[i - 1]).Length();
+					}
+
+					segmentCount = std::clamp(static_cast<uint32_t>(std::ceil(length / MAX_SEGMENT_LENGTH)), 1u, MAX_CURVE_SEGMENTS);
+				}
+
+				auto previous = edge.points.front();
+
+				for (uint32_t i = 1; i <= segmentCount; i++)
+				{
+					auto point = i == segmentCount ? edge.points.back() : EvaluateBezier(edge.points, static_cast<float>(i) / static_cast<float>(segmentCount));
+
+					if (point != previous)
+					{
+						glyph.segments.emplace_back(reversed ? Segment{ point, previous, edge.channels } : Segment{ previous, point, edge.channels });
+					}
+
+					previous = point;
+				}
+			}
+		}
+	}
+
+	// The atlas is as narrow as gives the smallest area, starting from a square the size of every glyph.
+	uint64_t area = 0;
+	uint32_t minWidth = 1;
+
+	for (const auto &glyph : glyphs)
+	{
+		area += static_cast<uint64_t>(glyph.size.m_x + GLYPH_SPACING) * (glyph.size.m_y + GLYPH_SPACING);
+		minWidth = std::max(minWidth, glyph.size.m_x + GLYPH_SPACING);
+	}
+
+	std::sort(glyphs.begin(), glyphs.end(), [](const GlyphField &a, const GlyphField &b)
+	{
+		return a.size.m_y != b.size.m_y ? a.size.m_y > b.size.m_y : a.size.m_x > b.size.m_x;
+	});
+
+	uint32_t squareWidth = 1;
+
+	while (static_cast<uint64_t>(squareWidth) * squareWidth < area)
+	{
+		squareWidth *= 2;
+	}
+
+	auto width = std::max(squareWidth, minWidth);
+	auto height = PackGlyphs(glyphs, width);
+
+	for (const auto &candidate : { squareWidth / 2, squareWidth * 2 })
+	{
+		if (candidate < minWidth)
+		{
+			continue;
+		}
+
+		if (auto candidateHeight = PackGlyphs(glyphs, candidate); static_cast<uint64_t>(candidate) * candidateHeight < static_cast<uint64_t>(width) * height)
+		{
+			width = candidate;
+			height = candidateHeight;
+		}
+	}
+
+	PackGlyphs(glyphs, width);
+	m_extent = Vector2ui(width, std::max(height, 1u));
+	m_pixels = std::make_unique<uint8_t[]>(4 * m_extent.m_x * m_extent.m_y);
+
+	Engine::Get()->GetThreadPool().ParallelFor(0, glyphs.size(), [this, &glyphs](const std::size_t &i)
+	{
+		GenerateField(glyphs[i]);
+	}, 1);
+
+	auto ascender = static_cast<float>(face->ascender) * scale;
+	auto extent = Vector2f(m_extent);
+
+	for (const auto &glyph : glyphs)
+	{
+		auto size = Vector2f(glyph.size);
+		m_characters.emplace(glyph.codepoint, FontMetafile::Character(glyph.codepoint, glyph.position.m_x / extent.m_x, glyph.position.m_y / extent.m_y,
+			size.m_x / extent.m_x, size.m_y / extent.m_y, glyph.left * pixelSize, (ascender - glyph.bottom - size.m_y) * pixelSize, size.m_x * pixelSize,
+			size.m_y * pixelSize, glyph.advance * unitSize));
+	}
+}
+
+Vector2f FontAtlas::GetDirection(const Edge &edge, const bool &end)
+{
+	auto count = edge.points.size();
+
+	// Control points can be at the end point, the direction is then towards the next control point that is not.
+	for (std::size_t i = 1; i < count; i++)
+	{
+		auto direction = end ? edge.points[count - 1] - edge.points[count - 1 - i] : edge.points[i] - edge.points[0];
+
+		if (direction != Vector2f())
+		{
+			return direction.Normalize();
+		}
+	}
+
+	return Vector2f();
+}
+
+std::pair<FontAtlas::Edge, FontAtlas::Edge> FontAtlas::SplitEdge(const Edge &edge, const float &t)
+{
+	// De Casteljau, the first point of each level is on the first half and the last on the second.
+	auto points = edge.points;
+	Edge first = { { points.front() }, edge.channels };
+	Edge second = { { points.back() }, edge.channels };
+
+	for (auto count = points.size() - 1; count > 0; count--)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			points[i] = points[i] + (points[i + 1] - points[i]) * t;
+		}
+
+		first.points.emplace_back(points[0]);
+		second.points.emplace_back(points[count - 1]);
+	}
+
+	std::reverse(second.points.begin(), second.points.end());
+	return { first, second };
+}
+
+void FontAtlas::ColourContour(std::vector<Edge> &contour)
+{
+	if (contour.empty())
+	{
+		return;
+	}
+
+	std::vector<std::size_t> corners;
+	auto previous = GetDirection(contour.back(), true);
+
+	for (std::size_t i = 0; i < contour.size(); i++)
+	{
+		auto current = GetDirection(contour[i], false);
+
+		if (previous.Dot(current) <= 0.0f || std::abs(Cross(previous, current)) > CORNER_CROSS_THRESHOLD)
+		{
+			corners.emplace_back(i);
+		}
+
+		previous = GetDirection(contour[i], true);
+	}
+
+	// A smooth contour has no corners to keep, every channel has the same distance.
+	if (corners.empty())
+	{
+		for (auto &edge : contour)
+		{
+			edge.channels = White;
+		}
+
+		return;
+	}
+
+	// A teardrop has one corner, the contour is split in three so the edges on either side of the corner have different colours.
+	if (corners.size() == 1)
+	{
+		std::rotate(contour.begin(), contour.begin() + corners.front(), contour.end());
+
+		if (contour.size() < 3)
+		{
+			std::vector<Edge> thirds;
+
+			for (const auto &edge : contour)
+			{
+				auto [first, rest] = SplitEdge(edge, 1.0f / 3.0f);
+				auto [second, third] = SplitEdge(rest, 0.5f);
+				thirds.emplace_back(std::move(first));
+				thirds.emplace_back(std::move(second));
+				thirds.emplace_back(std::move(third));
+			}
+
+			contour = std::move(thirds);
+		}
+
+		const uint8_t colours[3] = { Magenta, White, Yellow };
+		auto last = static_cast<float>(contour.size() - 1);
+
+		for (std::size_t i = 0; i < contour.size(); i++)
+		{
+			auto third = static_cast<int32_t>(2.875f * static_cast<float>(i) / last - 1.4375f + 3.5f) - 3;
+			contour[i].channels = colours[std::clamp(third + 1, 0, 2)];
+		}
+
+		return;
+	}
+
+	// Edges between corners share a colour, the colour changes at each corner and the last run also differs from the first.
+	auto switchColour = [](const uint8_t &colour, const uint8_t &banned)
+	{
+		for (const auto &candidate : { Cyan, Magenta, Yellow })
+		{
+			if (candidate != colour && candidate != banned)
+			{
+				return static_cast<uint8_t>(candidate);
+			}
+		}
+
+		return colour;
+	};
+
+	auto start = corners.front();
+	uint8_t colour = Cyan;
+	std::size_t spline = 0;
+
+	for (std::size_t i = 0; i < contour.size(); i++)
+	{
+		auto index = (start + i) % contour.size();
+
+		if (spline + 1 < corners.size() && corners[spline + 1] == index)
+		{
+			spline++;
+			colour = switchColour(colour, spline + 1 == corners.size() ? Cyan : 0);
+		}
+
+		contour[index].channels = colour;
+	}
+}
+
+uint32_t FontAtlas::PackGlyphs(std::vector<GlyphField> &glyphs, const uint32_t &width)
+{
+	// Each node is the top row of the filled area over a range of columns, ordered by column.
+	struct SkylineNode
+	{
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+	};
+
+	std::vector<SkylineNode> skyline = {{ 0, 0, width }};
+	uint32_t height = 0;
+
+	for (auto &glyph : glyphs)
+	{
+		auto size = glyph.size + GLYPH_SPACING;
+		std::size_t bestIndex = 0;
+		auto bestTop = std::numeric_limits<uint32_t>::max();
+		auto bestWidth = std::numeric_limits<uint32_t>::max();
+		uint32_t bestY = 0;
+
+		for (std::size_t i = 0; i < skyline.size() && skyline[i].x + size.m_x <= width; i++)
+		{
+			uint32_t y = 0;
+			auto j = i;
+
+			for (auto remaining = size.m_x; remaining > 0; j++)
+			{
+				y = std::max(y, skyline[j].y);
+				remaining -= std::min(remaining, skyline[j].width);
+			}
+
+			if (y + size.m_y < bestTop || (y + size.m_y == bestTop && skyline[i].width < bestWidth))
+			{
+				bestIndex = i;
+				bestTop = y + size.m_y;
+				bestWidth = skyline[i].width;
+				bestY = y;
+			}
+		}
+
+		auto x = skyline[bestIndex].x;
+		glyph.position = Vector2ui(x, bestY);
+		height = std::max(height, bestTop);
+
+		// The glyph covers the nodes under it, the node it partly covers is shortened.
+		skyline.insert(skyline.begin() + bestIndex, SkylineNode{ x, bestTop, size.m_x });
+
+		for (auto i = bestIndex + 1; i < skyline.size();)
+		{
+			auto &node = skyline[i];
+
+			if (node.x >= x + size.m_x)
+			{
+				break;
+			}
+
+			auto covered = x + size.m_x - node.x;
+
+			if (node.width <= covered)
+			{
+				skyline.erase(skyline.begin() + i);
+				continue;
+			}
+
+			node.x += covered;
+			node.width -= covered;
+			break;
+		}
+
+		for (std::size_t i = 0; i + 1 < skyline.size();)
+		{
+			if (skyline[i].y == skyline[i + 1].y)
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+				continue;
+			}
+
+			i++;
+		}
+	}
+
+	return height;
+}
+
+void FontAtlas::GenerateField(const GlyphField &glyph)
+{
+	// The nearest segment to a pixel for a channel, distances are compared by magnitude then by how straight on the segment is to the pixel.
+	struct Nearest
+	{
+		float distance = -std::numeric_limits<float>::infinity();
+		float orthogonality = 0.0f;
+		const Segment *segment = nullptr;
+		float t = 0.0f;
+	};
+
+	auto encode = [this](const float &distance)
+	{
+		return std::clamp(0.5f + 0.5f * distance / m_range, 0.0f, 1.0f);
+	};
+
+	for (uint32_t y = 0; y < glyph.size.m_y; y++)
+	{
+		for (uint32_t x = 0; x < glyph.size.m_x; x++)
+		{
+			// Atlas rows go down, the outline goes up.
+			auto p = Vector2f(static_cast<float>(x) + 0.5f, static_cast<float>(glyph.size.m_y - y) - 0.5f);
+			Nearest nearest;
+			Nearest channels[3];
+
+			for (const auto &segment : glyph.segments)
+			{
+				auto ab = segment.b - segment.a;
+				auto aq = p - segment.a;
+				auto t = aq.Dot(ab) / ab.LengthSquared();
+				auto eq = (t > 0.5f ? segment.b : segment.a) - p;
+				auto endpointDistance = eq.Length();
+				float distance;
+				float orthogonality = 0.0f;
+
+				if (auto orthogonal = Cross(aq, ab) / ab.Length(); t > 0.0f && t < 1.0f && std::abs(orthogonal) < endpointDistance)
+				{
+					distance = orthogonal;
+				}
+				else
+				{
+					distance = Cross(aq, ab) >= 0.0f ? endpointDistance : -endpointDistance;
+
+					if (endpointDistance > 0.0f)
+					{
+						orthogonality = std::abs(ab.Normalize().Dot(eq / endpointDistance));
+					}
+				}
+
+				auto closer = [&](const Nearest &other)
+				{
+					return std::abs(distance) < std::abs(other.distance) || (std::abs(distance) == std::abs(other.distance) && orthogonality < other.orthogonality);
+				};
+
+				if (closer(nearest))
+				{
+					nearest = { distance, orthogonality, &segment, t };
+				}
+
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					if ((segment.channels & (1 << c)) != 0 && closer(channels[c]))
+					{
+						channels[c] = { distance, orthogonality, &segment, t };
+					}
+				}
+			}
+
+			float values[3];
+
+			// Past the ends of its nearest segment a channel uses the distance to the line through it, so the channels meet cleanly at corners.
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				auto &channel = channels[c];
+
+				if (channel.segment != nullptr && (channel.t < 0.0f || channel.t > 1.0f))
+				{
+					auto direction = (channel.segment->b - channel.segment->a).Normalize();
+					auto q = p - (channel.t < 0.0f ? channel.segment->a : channel.segment->b);
+					auto along = q.Dot(direction);
+
+					if ((channel.t < 0.0f) == (along < 0.0f))
+					{
+						if (auto pseudoDistance = Cross(q, direction); std::abs(pseudoDistance) <= std::abs(channel.distance))
+						{
+							channel.distance = pseudoDistance;
+						}
+					}
+				}
+
+				values[c] = encode(channel.distance);
+			}
+
+			auto alpha = encode(nearest.distance);
+
+			// Where the channels disagree with the true distance on which side of the edge a pixel is, the true distance is used so no artifact is drawn.
+			if ((Median(values[0], values[1], values[2]) < 0.5f) != (alpha < 0.5f))
+			{
+				values[0] = values[1] = values[2] = alpha;
+			}
+
+			auto pixel = &m_pixels[4 * ((glyph.position.m_y + y) * m_extent.m_x + glyph.position.m_x + x)];
+			pixel[0] = static_cast<uint8_t>(std::round(values[0] * 255.0f));
+			pixel[1] = static_cast<uint8_t>(std::round(values[1] * 255.0f));
+			pixel[2] = static_cast<uint8_t>(std::round(values[2] * 255.0f));
+			pixel[3] = static_cast<uint8_t>(std::round(alpha * 255.0f));
+		}
+	}
+}
+}
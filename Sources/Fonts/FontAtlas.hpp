@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Maths/Vector2.hpp"
+#include "FontMetafile.hpp"
+
+struct FT_FaceRec_;
+
+namespace acid
+{
+/**
+ * @brief A multi-channel signed distance field atlas generated from the outlines of a font face, used by {@link FontType} in place of a baked atlas.
+ * Edges of each outline are coloured so the median of the red, green and blue distances keeps corners sharp, alpha holds the true signed distance.
+ * Glyphs are packed tightly by skyline bottom-left packing and their fields are generated on the thread pool.
+ */
+class ACID_EXPORT FontAtlas
+{
+public:
+	/// The size of the em square in atlas pixels.
+	static constexpr uint32_t EmSize = 32;
+	/// The distance in atlas pixels from an edge to where the field saturates, this is also the padding around each glyph.
+	static constexpr float DistanceRange = 4.0f;
+
+	/**
+	 * Generates an atlas of the glyphs of code points in a face.
+	 * @param face The face to read outlines from, outlines are loaded unscaled so the size of the face is not used.
+	 * @param codepoints The code points to generate, code points without a glyph in the face are skipped.
+	 * @param emSize The size of the em square in atlas pixels.
+	 * @param range The distance in atlas pixels from an edge to where the field saturates.
+	 */
+	FontAtlas(FT_FaceRec_ *face, const std::vector<char32_t> &codepoints, const uint32_t &emSize = EmSize, const float &range = DistanceRange);
+
+	const Vector2ui &GetExtent() const { return m_extent; }
+
+	/**
+	 * Gets the RGBA pixels of the atlas, they can be moved into the image created from them.
+	 * @return The pixels.
+	 */
+	std::unique_ptr<uint8_t[]> &GetPixels() { return m_pixels; }
+
+	/**
+	 * Gets the characters in the atlas, their sizes are in the units of {@link FontMetafile}.
+	 * @return The characters.
+	 */
+	const std::map<int32_t, FontMetafile::Character> &GetCharacters() const { return m_characters; }
+
+	const float &GetSpaceWidth() const { return m_spaceWidth; }
+
+private:
+	/// The colour channels an edge is written to.
+	enum Channel : uint8_t
+	{
+		Red = 1, Green = 2, Blue = 4,
+		Cyan = Green | Blue, Magenta = Red | Blue, Yellow = Red | Green, White = Red | Green | Blue
+	};
+
+	/// A line, quadratic or cubic bezier edge of a contour, in font units.
+	struct Edge
+	{
+		std::vector<Vector2f> points;
+		uint8_t channels;
+	};
+
+	/// A line segment of a flattened edge, in atlas pixels of the glyph.
+	struct Segment
+	{
+		Vector2f a;
+		Vector2f b;
+		uint8_t channels;
+	};
+
+	/// A glyph being generated, its outline and where it is placed in the atlas.
+	struct GlyphField
+	{
+		char32_t codepoint;
+		std::vector<Segment> segments;
+		// The padded box of the glyph in pixels from the origin, y up.
+		int32_t left, bottom;
+		Vector2ui size;
+		Vector2ui position;
+		float advance;
+	};
+
+	static Vector2f GetDirection(const Edge &edge, const bool &end);
+
+	static std::pair<Edge, Edge> SplitEdge(const Edge &edge, const float &t);
+
+	/**
+	 * Colours the edges of a contour so the two edges meeting at each corner share one channel at most.
+	 * @param contour The edges of the contour.
+	 */
+	static void ColourContour(std::vector<Edge> &contour);
+
+	/**
+	 * Places glyphs tallest first at the lowest position along a skyline of the filled rows.
+	 * @param glyphs The glyphs to place.
+	 * @param width The width of the atlas.
+	 * @return The height of the atlas.
+	 */
+	static uint32_t PackGlyphs(std::vector<GlyphField> &glyphs, const uint32_t &width);
+
+	void GenerateField(const GlyphField &glyph);
+
+	float m_range;
+	Vector2ui m_extent;
+	std::unique_ptr<uint8_t[]> m_pixels;
+	std::map<int32_t, FontMetafile::Character> m_characters;
+	float m_spaceWidth;
+};
+}
@@ -43,6 +43,23 @@ FontMetafile::FontMetafile(std::string filename) :
 	}
 }
 
+FontMetafile::FontMetafile(std::string filename, std::map<int32_t, Character> characters, const float &spaceWidth) :
+	m_characters(std::move(characters)),
+	m_filename(std::move(filename)),
+	m_verticalPerPixelSize(0.0f),
+	m_horizontalPerPixelSize(0.0f),
+	m_imageWidth(0),
+	m_spaceWidth(spaceWidth),
+	m_paddingWidth(0),
+	m_paddingHeight(0),
+	m_maxSizeY(0.0f)
+{
+	for (const auto &[id, character] : m_characters)
+	{
+		m_maxSizeY = std::max(m_maxSizeY, character.m_sizeY);
+	}
+}
+
 std::optional<FontMetafile::Character> FontMetafile::GetCharacter(const int32_t &ascii) const
 {
 	auto it = m_characters.find(ascii);
@@ -71,6 +71,14 @@ public:
 	 */
 	explicit FontMetafile(std::string filename);
 
+	/**
+	 * Creates a meta file from characters that were not read from a file, such as those of a generated {@link FontAtlas}.
+	 * @param filename The font file the characters were generated from.
+	 * @param characters The characters by ASCII value.
+	 * @param spaceWidth How far the cursor advances after a space.
+	 */
+	FontMetafile(std::string filename, std::map<int32_t, Character> characters, const float &spaceWidth);
+
 	std::optional<Character> GetCharacter(const int32_t &ascii) const;
 
 	const std::string &GetFileName() const { return m_filename; }
@@ -1,34 +1,43 @@
 ﻿#include "FontType.hpp"
 
+#include <fstream>
+#include <iomanip>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include "Engine/Engine.hpp"
 #include "Resources/Resources.hpp"
+#include "Files/FileSystem.hpp"
 #include "Graphics/Graphics.hpp"
+#include "FontAtlas.hpp"
 #include "Text.hpp"
 
 namespace acid
 {
-static const uint32_t MAX_VISIBLE_GLYPHS = 4096;
+static const uint32_t INITIAL_INSTANCES = 4096;
+// The glyph cache is limited to this many glyphs and outline cells and points, so fonts with large character sets stay bounded.
+static const uint32_t MAX_CACHED_GLYPHS = 2048;
+static const uint32_t MAX_CACHED_CELLS = 512 * 1024;
+static const uint32_t MAX_CACHED_POINTS = 512 * 1024;
+// Glyphs drawn in the last few frames may still be read by frames in flight, so they are not evicted.
+static const uint64_t MIN_EVICTION_FRAMES = 4;
+static const std::string FONT_CACHE_DIRECTORY = "Cache/Fonts/";
+// Increment when the cache layout or the outline conversion changes.
+static const uint32_t FONT_CACHE_VERSION = 1;
 
 std::shared_ptr<FontType> FontType::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<FontType>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<FontType>(resource);
-	}
-
-	auto result = std::make_shared<FontType>("", "");
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<FontType>("", "");
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
-std::shared_ptr<FontType> FontType::Create(const std::string &filename, const std::string &style)
+std::shared_ptr<FontType> FontType::Create(const std::string &filename, const std::string &style, const bool &msdf)
 {
-	auto temp = FontType(filename, style, false);
+	auto temp = FontType(filename, style, msdf, false);
 	temp.m_filename = filename;
 	temp.m_style = style;
 	Metadata metadata = Metadata();
@@ -36,13 +45,22 @@ std::shared_ptr<FontType> FontType::Create(const std::string &filename, const st
 	return Create(metadata);
 }
 
-FontType::FontType(std::string filename, std::string style, const bool &load) :
+FontType::FontType(std::string filename, std::string style, const bool &msdf, const bool &load) :
 	m_filename(std::move(filename)),
 	m_style(std::move(style)),
+	m_msdf(msdf),
+	m_msdfAtlas(false),
 	m_image(nullptr),
 	m_metadata(nullptr),
+	m_library(nullptr),
+	m_face(nullptr),
+	m_hasKerning(false),
+	m_lineAdvance(0.0f),
+	m_glyphData(nullptr),
+	m_frame(0),
 	m_storageGlyphs(nullptr),
 	m_instanceBuffer(nullptr),
+	m_maxInstances(0),
 	m_instances(0)
 {
 	if (load)
@@ -51,72 +69,124 @@ FontType::FontType(std::string filename, std::string style, const bool &load) :
 	}
 }
 
+FontType::~FontType()
+{
+	if (!m_convertedOutlines.empty())
+	{
+		SaveCache();
+	}
+
+	if (m_face != nullptr)
+	{
+		FT_Done_Face(m_face);
+	}
+
+	if (m_library != nullptr)
+	{
+		FT_Done_FreeType(m_library);
+	}
+}
+
 void FontType::Update(const std::vector<Text *> &texts)
 {
 	m_instances = 0;
+	m_frame++;
 
-	if (texts.empty())
+	if (texts.empty() || m_face == nullptr)
 	{
+		m_textInstances.clear();
 		return;
 	}
 
-	Instance *instances;
-	m_instanceBuffer->MapMemory(reinterpret_cast<void **>(&instances));
+	m_textInstances.resize(texts.size());
+
+	// Glyphs of texts that changed are converted together, so the conversions can run in parallel.
+	m_missingGlyphs.clear();
+	std::size_t requiredInstances = 0;
 
-	for (const auto &text : texts)
+	for (uint32_t i = 0; i < texts.size(); i++)
 	{
-		Vector2f extent = Window::Get()->GetSize();
-		auto scale = text->GetScreenScale() / 64.0f;
-		//auto dimensions = 2.0f * text->GetScreenDimensions();
-		auto position = extent * text->GetScreenPosition(); // 2.0f *text->GetScreenPosition() - 1.0f;
+		auto text = texts[i];
+		UpdateGlyphs(*text);
+		requiredInstances += text->m_glyphs.size();
 
-		Vector2f localOffset = Vector2f();
+		const auto &textInstances = m_textInstances[i];
 
-		for (const auto &c : text->GetString())
+		if (textInstances.m_text == text && textInstances.m_version == text->m_glyphsVersion && textInstances.m_frame + 1 == m_frame)
 		{
-			if (m_instances >= MAX_VISIBLE_GLYPHS)
+			continue;
+		}
+
+		for (const auto &glyph : text->m_glyphs)
+		{
+			if (!glyph.m_newLine && m_cachedSlots.find(glyph.m_glyphIndex) == m_cachedSlots.end())
 			{
-				break;
+				m_missingGlyphs.emplace_back(glyph.m_glyphIndex);
 			}
+		}
+	}
 
-			const uint32_t glyphIndex = m_charmap[c];
-			const HostGlyphInfo *gi = &m_glyphInfos[glyphIndex];
-			auto instance = &instances[m_instances];
+	PrepareGlyphs(m_missingGlyphs);
 
-			if (c == '\n')
-			{
-				localOffset.m_x = 0.0f;
-				localOffset.m_y += gi->vertAdvance * scale.m_y;
-				continue;
-			}
+	if (requiredInstances > m_maxInstances)
+	{
+		// The old buffer may still be read by frames in flight, it is destroyed once they have finished.
+		while (m_maxInstances < requiredInstances)
+		{
+			m_maxInstances *= 2;
+		}
 
-			instance->m_rect.minX = ((position.m_x + localOffset.m_x) + gi->bbox.minX * scale.m_x) / (extent.m_x / 2.0f) - 1.0f;
-			instance->m_rect.minY = ((position.m_y + localOffset.m_y) - gi->bbox.minY * scale.m_y) / (extent.m_y / 2.0f) - 1.0f;
-			instance->m_rect.maxX = ((position.m_x + localOffset.m_x) + gi->bbox.maxX * scale.m_x) / (extent.m_x / 2.0f) - 1.0f;
-			instance->m_rect.maxY = ((position.m_y + localOffset.m_y) - gi->bbox.maxY * scale.m_y) / (extent.m_y / 2.0f) - 1.0f;
+		m_instanceBuffer = std::make_unique<InstanceBuffer>(sizeof(Instance) * m_maxInstances);
 
-			//inst->rect.minX = ((x + local.m_x) + gi->bbox.minX * localScale) / (extent.m_x / 2.0f) - 1.0f;
-			//inst->rect.minY = ((y + local.m_y) - gi->bbox.minY * localScale) / (extent.m_y / 2.0f) - 1.0f;
-			//inst->rect.maxX = ((x + local.m_x) + gi->bbox.maxX * localScale) / (extent.m_x / 2.0f) - 1.0f;
-			//inst->rect.maxY = ((y + local.m_y) - gi->bbox.maxY * localScale) / (extent.m_y / 2.0f) - 1.0f;
+		// Instances kept in the old buffer are gone, every text is written again.
+		m_textInstances.clear();
+		m_textInstances.resize(texts.size());
+	}
 
-			if (instance->m_rect.minX <= 1.0f && instance->m_rect.maxX >= -1.0f && instance->m_rect.maxY <= 1.0f && instance->m_rect.minY >= -1.0f)
-			{
-				instance->m_glyphIndex = glyphIndex;
-				instance->m_sharpness = scale.m_x;
-				instance->m_colour = text->m_textColour;
+	Instance *instances;
+	m_instanceBuffer->MapMemory(reinterpret_cast<void **>(&instances));
+
+	for (uint32_t i = 0; i < texts.size(); i++)
+	{
+		auto text = texts[i];
+
+		// The instances written last update are still in the buffer, they are kept if they would be written the same and at the same offset.
+		auto &textInstances = m_textInstances[i];
 
-				m_instances++;
+		if (textInstances.m_text == text && textInstances.m_frame + 1 == m_frame && textInstances.m_version == text->m_glyphsVersion && textInstances.m_offset == m_instances &&
+			textInstances.m_position == text->GetScreenPosition() && textInstances.m_scale == text->GetScreenScale() && textInstances.m_colour == text->m_textColour)
+		{
+			for (const auto &slot : textInstances.m_slots)
+			{
+				m_cachedGlyphs[slot].lastUsed = m_frame;
 			}
 
-			localOffset.m_x += gi->horiAdvance * scale.m_x;
+			textInstances.m_frame = m_frame;
+			m_instances += textInstances.m_count;
+			continue;
 		}
+
+		textInstances.m_text = text;
+		textInstances.m_version = text->m_glyphsVersion;
+		textInstances.m_position = text->GetScreenPosition();
+		textInstances.m_scale = text->GetScreenScale();
+		textInstances.m_colour = text->m_textColour;
+		textInstances.m_offset = m_instances;
+		textInstances.m_frame = m_frame;
+		textInstances.m_count = WriteInstances(*text, instances, textInstances.m_slots);
+		m_instances += textInstances.m_count;
 	}
 
 	m_instanceBuffer->UnmapMemory();
+
+	if (m_glyphData != nullptr)
+	{
+		m_storageGlyphs->UnmapMemory();
+		m_glyphData = nullptr;
+	}
 }
 
-bool FontType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline)
+bool FontType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
 {
 	if (m_instances == 0)
 	{
@@ -124,6 +194,7 @@ bool FontType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraph
 	}
 
 	// Updates descriptors.
+	m_descriptorSet.Push("UniformScene", uniformScene);
 	m_descriptorSet.Push("BufferGlyph", *m_storageGlyphs, OffsetSize(m_glyphInfoOffset, m_glyphInfoSize));
 	m_descriptorSet.Push("BufferCell", *m_storageGlyphs, OffsetSize(m_glyphCellsOffset, m_glyphCellsSize));
 	m_descriptorSet.Push("BufferPoint", *m_storageGlyphs, OffsetSize(m_glyphPointsOffset, m_glyphPointsSize));
@@ -150,8 +221,17 @@ void FontType::Load()
 		return;
 	}
 
+	auto metafile = m_filename + "/" + m_style + ".fnt";
+
+	if (m_msdf || !Files::ExistsInPath(metafile))
+	{
+		LoadFont(m_filename + "/" + m_style + ".ttf");
+		GenerateAtlas();
+		return;
+	}
+
 	m_image = Image2d::Create(m_filename + "/" + m_style + ".png");
-	m_metadata = std::make_unique<FontMetafile>(m_filename + "/" + m_style + ".fnt");
+	m_metadata = std::make_unique<FontMetafile>(metafile);
 	LoadFont(m_filename + "/" + m_style + ".ttf");
 }
 
@@ -159,6 +239,7 @@ const Metadata &operator>>(const Metadata &metadata, FontType &fontType)
 {
 	metadata.GetChild("Filename", fontType.m_filename);
 	metadata.GetChild("Style", fontType.m_style);
+	metadata.GetChild("Msdf", fontType.m_msdf);
 	return metadata;
 }
 
@@ -166,6 +247,7 @@ Metadata &operator<<(Metadata &metadata, const FontType &fontType)
 {
 	metadata.SetChild("Filename", fontType.m_filename);
 	metadata.SetChild("Style", fontType.m_style);
+	metadata.SetChild("Msdf", fontType.m_msdf);
 	return metadata;
 }
 
@@ -174,131 +256,566 @@ uint32_t FontType::AlignUint32(const uint32_t &value, const uint32_t &alignment)
 	return (value + alignment - 1) / alignment * alignment;
 }
 
-void FontType::LoadFont(const std::string &filename)
+std::optional<uint32_t> FontType::AllocateRange(std::map<uint32_t, uint32_t> &freeRanges, const uint32_t &size)
 {
-	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+	if (size == 0)
+	{
+		return 0;
+	}
 
-	auto fileLoaded = Files::Read(filename); // TODO: Use a stream.
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+	{
+		auto [offset, rangeSize] = *it;
 
-	if (!fileLoaded)
+		if (rangeSize < size)
+		{
+			continue;
+		}
+
+		freeRanges.erase(it);
+
+		if (rangeSize > size)
+		{
+			freeRanges.emplace(offset + size, rangeSize - size);
+		}
+
+		return offset;
+	}
+
+	return std::nullopt;
+}
+
+void FontType::FreeRange(std::map<uint32_t, uint32_t> &freeRanges, const uint32_t &offset, const uint32_t &size)
+{
+	if (size == 0)
 	{
-		Log::Error("Font could not be loaded: '%s'\n", filename.c_str());
 		return;
 	}
 
-	FT_Library library;
+	auto it = freeRanges.emplace(offset, size).first;
 
-	if (FT_Init_FreeType(&library) != 0)
+	// Merges with the following and preceding free ranges.
+	if (auto next = std::next(it); next != freeRanges.end() && it->first + it->second == next->first)
 	{
-		throw std::runtime_error("Freetype failed to initialize");
+		it->second += next->second;
+		freeRanges.erase(next);
+	}
+
+	if (it != freeRanges.begin())
+	{
+		if (auto previous = std::prev(it); previous->first + previous->second == it->first)
+		{
+			previous->second += it->second;
+			freeRanges.erase(it);
+		}
 	}
+}
 
-	FT_Face face;
+void FontType::UpdateGlyphs(Text &text)
+{
+	if (text.m_glyphsFont == this && text.m_glyphsVersion == text.m_stringVersion)
+	{
+		return;
+	}
 
-	if (FT_New_Memory_Face(library, reinterpret_cast<FT_Byte *>(fileLoaded->data()), static_cast<FT_Long>(fileLoaded->size()), 0, &face) != 0)
+	auto changedIndex = text.m_glyphsFont == this ? text.m_glyphsChangedIndex : 0;
+	const auto &string = text.GetString();
+	auto &glyphs = text.m_glyphs;
+
+	if (text.m_glyphsFont != this)
 	{
-		throw std::runtime_error("Freetype failed to create face from memory");
+		glyphs.clear();
 	}
 
-	if (FT_Set_Char_Size(face, 0, 1000 * 64, 96, 96) != 0)
+	// Each glyph only depends on the glyphs before it. The last kept glyph is shaped again, its code point may be partly changed.
+	while (!glyphs.empty() && glyphs.back().m_index >= changedIndex)
 	{
-		throw std::runtime_error("Freetype failed to set char size");
+		glyphs.pop_back();
 	}
 
-	uint32_t totalPoints = 0;
-	uint32_t totalCells = 0;
+	std::size_t index = 0;
 
-	uint32_t glyphCount = face->num_glyphs;
-	m_charmap = std::map<wchar_t, uint32_t>();
-	m_glyphInfos = std::vector<HostGlyphInfo>(glyphCount);
-	std::vector<Outline> outlines(glyphCount);
+	if (!glyphs.empty())
+	{
+		index = glyphs.back().m_index;
+		glyphs.pop_back();
+	}
 
-	//Log::Out("Glyph Count: %i\n", glyphCount);
+	Vector2f offset;
+	uint32_t previousGlyph = 0;
 
-	FT_UInt glyphIndex;
-	FT_ULong charcode = FT_Get_First_Char(face, &glyphIndex);
-	uint32_t i = 0;
+	if (!glyphs.empty())
+	{
+		const auto &previous = glyphs.back();
+		offset = previous.m_newLine ? Vector2f(0.0f, previous.m_offset.m_y + previous.m_advance.m_y) : Vector2f(previous.m_offset.m_x + previous.m_advance.m_x, previous.m_offset.m_y);
+		previousGlyph = previous.m_newLine ? 0 : previous.m_glyphIndex;
+	}
 
-	while (glyphIndex != 0)
+	while (index < string.size())
 	{
-		if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_HINTING) != 0)
+		auto start = static_cast<uint32_t>(index);
+		auto codepoint = String::DecodeUtf8(string, index);
+
+		if (codepoint == '\n')
+		{
+			glyphs.emplace_back(Glyph{ 0, start, offset, Vector2f(0.0f, m_lineAdvance), true });
+			offset = Vector2f(0.0f, offset.m_y + m_lineAdvance);
+			previousGlyph = 0;
+			continue;
+		}
+
+		auto glyphIndex = FT_Get_Char_Index(m_face, codepoint);
+
+		if (m_hasKerning && previousGlyph != 0 && glyphIndex != 0)
 		{
-			throw std::runtime_error("Freetype failed to load a glyph");
+			FT_Vector kerning;
+
+			if (FT_Get_Kerning(m_face, previousGlyph, glyphIndex, FT_KERNING_UNFITTED, &kerning) == 0)
+			{
+				offset.m_x += static_cast<float>(kerning.x) / 64.0f;
+			}
 		}
 
-		m_charmap.emplace(static_cast<wchar_t>(charcode), i);
-		HostGlyphInfo *hgi = &m_glyphInfos[i];
-		Outline *o = &outlines[i];
+		const auto &glyphInfo = GetGlyphInfo(glyphIndex);
+		glyphs.emplace_back(Glyph{ glyphIndex, start, offset, Vector2f(glyphInfo.horiAdvance, 0.0f), false });
+		offset.m_x += glyphInfo.horiAdvance;
+		previousGlyph = glyphIndex;
+	}
 
-		OutlineConvert(&face->glyph->outline, o);
+	text.m_glyphsFont = this;
+	text.m_glyphsVersion = text.m_stringVersion;
+	text.m_glyphsChangedIndex = std::numeric_limits<std::size_t>::max();
+}
 
-		hgi->bbox = o->bbox;
-		hgi->horiAdvance = face->glyph->metrics.horiAdvance / 64.0f;
-		hgi->vertAdvance = face->glyph->metrics.vertAdvance / 64.0f;
+const FontType::HostGlyphInfo &FontType::GetGlyphInfo(const uint32_t &glyphIndex)
+{
+	if (auto it = m_glyphInfos.find(glyphIndex); it != m_glyphInfos.end())
+	{
+		return it->second;
+	}
+
+	HostGlyphInfo glyphInfo = {};
+
+	if (FT_Load_Glyph(m_face, glyphIndex, FT_LOAD_NO_HINTING) == 0)
+	{
+		glyphInfo.horiAdvance = m_face->glyph->metrics.horiAdvance / 64.0f;
+	}
 
-		totalPoints += static_cast<uint32_t>(o->points.size());
-		totalCells += static_cast<uint32_t>(o->cells.size());
+	return m_glyphInfos.emplace(glyphIndex, glyphInfo).first->second;
+}
 
-		charcode = FT_Get_Next_Char(face, charcode, &glyphIndex);
-		i++;
+std::optional<uint32_t> FontType::RequestGlyph(const uint32_t &glyphIndex)
+{
+	if (auto it = m_cachedSlots.find(glyphIndex); it != m_cachedSlots.end())
+	{
+		m_cachedGlyphs[it->second].lastUsed = m_frame;
+		return it->second;
 	}
 
-	m_glyphInfoSize = sizeof(DeviceGlyphInfo) * static_cast<uint32_t>(m_glyphInfos.size());
-	m_glyphCellsSize = sizeof(uint32_t) * totalCells;
-	m_glyphPointsSize = sizeof(Vector2f) * totalPoints;
+	// Outlines come from the cache file, from this run, or are converted now if they were not prepared.
+	Rect bbox;
+	uint32_t cellCountX, cellCountY;
+	const uint32_t *cells;
+	const Vector2f *points;
+	uint32_t cellCount, pointCount;
+
+	if (auto entry = m_cacheEntries.find(glyphIndex); entry != m_cacheEntries.end())
+	{
+		auto cacheEntry = entry->second;
+		bbox = cacheEntry->bbox;
+		cellCountX = cacheEntry->cellCountX;
+		cellCountY = cacheEntry->cellCountY;
+		cells = m_cacheCells + cacheEntry->cellOffset;
+		cellCount = cacheEntry->cellCount;
+		points = m_cachePoints + cacheEntry->pointOffset;
+		pointCount = cacheEntry->pointCount;
+	}
+	else
+	{
+		auto converted = m_convertedOutlines.find(glyphIndex);
+
+		if (converted == m_convertedOutlines.end())
+		{
+			std::vector<uint32_t> glyphIndices = { glyphIndex };
+			PrepareGlyphs(glyphIndices);
+			converted = m_convertedOutlines.find(glyphIndex);
+
+			if (converted == m_convertedOutlines.end())
+			{
+				return std::nullopt;
+			}
+		}
+
+		const auto &outline = converted->second;
+		bbox = outline.bbox;
+		cellCountX = outline.cellCountX;
+		cellCountY = outline.cellCountY;
+		cells = outline.cells.data();
+		cellCount = static_cast<uint32_t>(outline.cells.size());
+		points = outline.points.data();
+		pointCount = static_cast<uint32_t>(outline.points.size());
+	}
+	std::optional<uint32_t> cellOffset;
+	std::optional<uint32_t> pointOffset;
+
+	// Evicts the least recently drawn glyphs until there is a free slot and room for the outline.
+	while (true)
+	{
+		if (!cellOffset)
+		{
+			cellOffset = AllocateRange(m_freeCells, cellCount);
+		}
+
+		if (!pointOffset)
+		{
+			pointOffset = AllocateRange(m_freePoints, pointCount);
+		}
+
+		if (!m_freeSlots.empty() && cellOffset && pointOffset)
+		{
+			break;
+		}
+
+		std::optional<uint32_t> leastRecent;
+
+		for (uint32_t i = 0; i < m_cachedGlyphs.size(); i++)
+		{
+			const auto &cachedGlyph = m_cachedGlyphs[i];
+
+			if (cachedGlyph.cached && cachedGlyph.lastUsed + MIN_EVICTION_FRAMES <= m_frame && (!leastRecent || cachedGlyph.lastUsed < m_cachedGlyphs[*leastRecent].lastUsed))
+			{
+				leastRecent = i;
+			}
+		}
+
+		if (!leastRecent)
+		{
+			if (cellOffset)
+			{
+				FreeRange(m_freeCells, *cellOffset, cellCount);
+			}
+
+			if (pointOffset)
+			{
+				FreeRange(m_freePoints, *pointOffset, pointCount);
+			}
+
+			return std::nullopt;
+		}
+
+		EvictGlyph(*leastRecent);
+	}
+
+	auto slot = m_freeSlots.back();
+	m_freeSlots.pop_back();
+	m_cachedSlots[glyphIndex] = slot;
+	m_cachedGlyphs[slot] = { glyphIndex, bbox, *pointOffset, pointCount, *cellOffset, cellCount, m_frame, true };
+
+	if (m_glyphData == nullptr)
+	{
+		m_storageGlyphs->MapMemory(reinterpret_cast<void **>(&m_glyphData));
+	}
+
+	auto deviceGlyphInfo = reinterpret_cast<DeviceGlyphInfo *>(m_glyphData + m_glyphInfoOffset) + slot;
+	deviceGlyphInfo->cellInfo.cellCountX = cellCountX;
+	deviceGlyphInfo->cellInfo.cellCountY = cellCountY;
+	deviceGlyphInfo->cellInfo.pointOffset = *pointOffset;
+	deviceGlyphInfo->cellInfo.cellOffset = *cellOffset;
+	deviceGlyphInfo->bbox = bbox;
+
+	std::memcpy(reinterpret_cast<uint32_t *>(m_glyphData + m_glyphCellsOffset) + *cellOffset, cells, sizeof(uint32_t) * cellCount);
+	std::memcpy(reinterpret_cast<Vector2f *>(m_glyphData + m_glyphPointsOffset) + *pointOffset, points, sizeof(Vector2f) * pointCount);
+	return slot;
+}
+
+void FontType::PrepareGlyphs(std::vector<uint32_t> &glyphIndices)
+{
+	std::sort(glyphIndices.begin(), glyphIndices.end());
+	glyphIndices.erase(std::unique(glyphIndices.begin(), glyphIndices.end()), glyphIndices.end());
+
+	std::vector<std::pair<uint32_t, Outline>> outlines;
+
+	// The face is not thread safe, outlines are decomposed on this thread and only finished on the pool.
+	for (const auto &glyphIndex : glyphIndices)
+	{
+		if (m_cacheEntries.count(glyphIndex) != 0 || m_convertedOutlines.count(glyphIndex) != 0 || FT_Load_Glyph(m_face, glyphIndex, FT_LOAD_NO_HINTING) != 0)
+		{
+			continue;
+		}
+
+		OutlineDecompose(&m_face->glyph->outline, &outlines.emplace_back(glyphIndex, Outline()).second);
+	}
+
+	if (outlines.empty())
+	{
+		return;
+	}
+
+	Engine::Get()->GetThreadPool().ParallelFor(0, outlines.size(), [&outlines](const std::size_t &i)
+	{
+		OutlineFinish(&outlines[i].second);
+	}, 1);
+
+	for (auto &[glyphIndex, outline] : outlines)
+	{
+		m_convertedOutlines.emplace(glyphIndex, std::move(outline));
+	}
+}
+
+void FontType::LoadCache()
+{
+	// FNV-1a of the font file and the size outlines are converted at, stable between runs unlike std::hash.
+	uint64_t hash = 14695981039346656037ull;
+
+	auto hashBytes = [&hash](const void *data, const std::size_t &size)
+	{
+		auto bytes = static_cast<const uint8_t *>(data);
+
+		for (std::size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	hashBytes(m_fontData->GetData(), m_fontData->GetSize());
+	hashBytes(&FONT_CACHE_VERSION, sizeof(FONT_CACHE_VERSION));
+
+	std::stringstream stream;
+	stream << FONT_CACHE_DIRECTORY << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+	m_cachePath = stream.str();
+
+	m_cacheView = FileView::Map(m_cachePath);
+	m_cacheEntries.clear();
+
+	if (!m_cacheView)
+	{
+		return;
+	}
+
+	// Header of the version, entry count, cell count and point count.
+	uint32_t header[4] = {};
+	auto headerSize = sizeof(header);
+
+	if (m_cacheView->GetSize() >= headerSize)
+	{
+		std::memcpy(header, m_cacheView->GetData(), headerSize);
+	}
+
+	auto entriesSize = sizeof(CacheEntry) * header[1];
+	auto dataSize = sizeof(uint32_t) * header[2] + sizeof(Vector2f) * header[3];
+
+	if (header[0] != FONT_CACHE_VERSION || m_cacheView->GetSize() != headerSize + entriesSize + dataSize)
+	{
+		Log::Warning("Ignoring invalid font cache: '%s'\n", m_cachePath.c_str());
+		m_cacheView = std::nullopt;
+		return;
+	}
+
+	auto entries = reinterpret_cast<const CacheEntry *>(m_cacheView->GetData() + headerSize);
+	m_cacheCells = reinterpret_cast<const uint32_t *>(m_cacheView->GetData() + headerSize + entriesSize);
+	m_cachePoints = reinterpret_cast<const Vector2f *>(m_cacheView->GetData() + headerSize + entriesSize + sizeof(uint32_t) * header[2]);
+
+	for (uint32_t i = 0; i < header[1]; i++)
+	{
+		const auto &entry = entries[i];
+
+		if (static_cast<uint64_t>(entry.cellOffset) + entry.cellCount <= header[2] && static_cast<uint64_t>(entry.pointOffset) + entry.pointCount <= header[3])
+		{
+			m_cacheEntries.emplace(entry.glyphIndex, &entry);
+		}
+	}
+}
+
+void FontType::SaveCache()
+{
+	// The file is built in memory first, the old file stays mapped until it has been read.
+	std::vector<CacheEntry> entries;
+	std::vector<uint32_t> cells;
+	std::vector<Vector2f> points;
+
+	auto addEntry = [&](const uint32_t &glyphIndex, const Rect &bbox, const uint32_t &cellCountX, const uint32_t &cellCountY, const uint32_t *entryCells,
+		const uint32_t &cellCount, const Vector2f *entryPoints, const uint32_t &pointCount)
+	{
+		entries.emplace_back(CacheEntry{ glyphIndex, bbox, cellCountX, cellCountY, static_cast<uint32_t>(cells.size()), cellCount, static_cast<uint32_t>(points.size()), pointCount });
+		cells.insert(cells.end(), entryCells, entryCells + cellCount);
+		points.insert(points.end(), entryPoints, entryPoints + pointCount);
+	};
+
+	for (const auto &[glyphIndex, entry] : m_cacheEntries)
+	{
+		addEntry(glyphIndex, entry->bbox, entry->cellCountX, entry->cellCountY, m_cacheCells + entry->cellOffset, entry->cellCount, m_cachePoints + entry->pointOffset,
+			entry->pointCount);
+	}
+
+	for (const auto &[glyphIndex, outline] : m_convertedOutlines)
+	{
+		addEntry(glyphIndex, outline.bbox, outline.cellCountX, outline.cellCountY, outline.cells.data(), static_cast<uint32_t>(outline.cells.size()), outline.points.data(),
+			static_cast<uint32_t>(outline.points.size()));
+	}
+
+	m_cacheEntries.clear();
+	m_cacheView = std::nullopt;
+
+	FileSystem::Create(m_cachePath);
+	std::ofstream outStream(m_cachePath, std::ios::binary | std::ios::trunc);
+
+	if (!outStream.is_open())
+	{
+		Log::Error("Could not write font cache: '%s'\n", m_cachePath.c_str());
+		return;
+	}
+
+	uint32_t header[4] = { FONT_CACHE_VERSION, static_cast<uint32_t>(entries.size()), static_cast<uint32_t>(cells.size()), static_cast<uint32_t>(points.size()) };
+	outStream.write(reinterpret_cast<const char *>(header), sizeof(header));
+	outStream.write(reinterpret_cast<const char *>(entries.data()), sizeof(CacheEntry) * entries.size());
+	outStream.write(reinterpret_cast<const char *>(cells.data()), sizeof(uint32_t) * cells.size());
+	outStream.write(reinterpret_cast<const char *>(points.data()), sizeof(Vector2f) * points.size());
+}
+
+void FontType::EvictGlyph(const uint32_t &slot)
+{
+	auto &cachedGlyph = m_cachedGlyphs[slot];
+	cachedGlyph.cached = false;
+	FreeRange(m_freeCells, cachedGlyph.cellOffset, cachedGlyph.cellCount);
+	FreeRange(m_freePoints, cachedGlyph.pointOffset, cachedGlyph.pointCount);
+	m_cachedSlots.erase(cachedGlyph.glyphIndex);
+	m_freeSlots.emplace_back(slot);
+}
+
+uint32_t FontType::WriteInstances(const Text &text, Instance *instances, std::vector<uint32_t> &slots)
+{
+	auto scale = text.GetScreenScale() / 64.0f;
+	uint32_t count = 0;
+	slots.clear();
+
+	for (const auto &glyph : text.m_glyphs)
+	{
+		if (glyph.m_newLine)
+		{
+			continue;
+		}
+
+		auto slot = RequestGlyph(glyph.m_glyphIndex);
+
+		if (!slot)
+		{
+			continue;
+		}
+
+		auto localOffset = glyph.m_offset * scale;
+		const auto &bbox = m_cachedGlyphs[*slot].bbox;
+		slots.emplace_back(*slot);
+
+		// Glyphs off the screen are clipped on the GPU, so moving the text or resizing the window does not cull glyphs on the CPU.
+		auto instance = &instances[m_instances + count];
+		instance->m_rect.minX = localOffset.m_x + bbox.minX * scale.m_x;
+		instance->m_rect.minY = localOffset.m_y - bbox.minY * scale.m_y;
+		instance->m_rect.maxX = localOffset.m_x + bbox.maxX * scale.m_x;
+		instance->m_rect.maxY = localOffset.m_y - bbox.maxY * scale.m_y;
+		instance->m_glyphIndex = *slot;
+		instance->m_sharpness = scale.m_x;
+		instance->m_colour = text.m_textColour;
+		instance->m_position = text.GetScreenPosition();
+		count++;
+	}
+
+	std::sort(slots.begin(), slots.end());
+	slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+	return count;
+}
+
+void FontType::LoadFont(const std::string &filename)
+{
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+
+	// The face reads glyphs from the file while it is open.
+	m_fontData = Files::ReadView(filename);
+
+	if (!m_fontData)
+	{
+		Log::Error("Font could not be loaded: '%s'\n", filename.c_str());
+		return;
+	}
+
+	if (FT_Init_FreeType(&m_library) != 0)
+	{
+		throw std::runtime_error("Freetype failed to initialize");
+	}
+
+	if (FT_New_Memory_Face(m_library, reinterpret_cast<const FT_Byte *>(m_fontData->GetData()), static_cast<FT_Long>(m_fontData->GetSize()), 0, &m_face) != 0)
+	{
+		throw std::runtime_error("Freetype failed to create face from memory");
+	}
+
+	if (FT_Set_Char_Size(m_face, 0, 1000 * 64, 96, 96) != 0)
+	{
+		throw std::runtime_error("Freetype failed to set char size");
+	}
+
+	m_hasKerning = FT_HAS_KERNING(m_face);
+	m_lineAdvance = m_face->size->metrics.height / 64.0f;
+
+	m_glyphInfoSize = sizeof(DeviceGlyphInfo) * MAX_CACHED_GLYPHS;
+	m_glyphCellsSize = sizeof(uint32_t) * MAX_CACHED_CELLS;
+	m_glyphPointsSize = sizeof(Vector2f) * MAX_CACHED_POINTS;
 
 	uint32_t alignment = static_cast<uint32_t>(physicalDevice->GetProperties().limits.minStorageBufferOffsetAlignment);
 	m_glyphInfoOffset = 0;
 	m_glyphCellsOffset = AlignUint32(m_glyphInfoSize, alignment);
-	m_glyphPointsOffset = AlignUint32(m_glyphInfoSize + m_glyphCellsSize, alignment);
+	m_glyphPointsOffset = AlignUint32(m_glyphCellsOffset + m_glyphCellsSize, alignment);
 
 	m_glyphDataSize = m_glyphPointsOffset + m_glyphPointsSize;
 	m_storageGlyphs = std::make_unique<StorageBuffer>(m_glyphDataSize);
-	m_instanceBuffer = std::make_unique<InstanceBuffer>(MAX_VISIBLE_GLYPHS * sizeof(Instance));
-
-	char *glyphData;
-	m_storageGlyphs->MapMemory(reinterpret_cast<void **>(&glyphData));
-
-	auto deviceGlyphInfos = reinterpret_cast<DeviceGlyphInfo *>(glyphData + m_glyphInfoOffset);
-	auto cells = reinterpret_cast<uint32_t *>(glyphData + m_glyphCellsOffset);
-	auto points = reinterpret_cast<Vector2f *>(glyphData + m_glyphPointsOffset);
+	m_maxInstances = INITIAL_INSTANCES;
+	m_instanceBuffer = std::make_unique<InstanceBuffer>(sizeof(Instance) * m_maxInstances);
+	m_textInstances.clear();
 
-	uint32_t pointOffset = 0;
-	uint32_t cellOffset = 0;
+	// Outlines are converted and uploaded when a glyph is first drawn.
+	m_cachedGlyphs.assign(MAX_CACHED_GLYPHS, {});
+	m_cachedSlots.clear();
+	m_freeSlots.clear();
 
-	for (uint32_t j = 0; j < m_glyphInfos.size(); j++)
+	for (auto i = MAX_CACHED_GLYPHS; i > 0; i--)
 	{
-		Outline *o = &outlines[j];
-		DeviceGlyphInfo *dgi = &deviceGlyphInfos[j];
+		m_freeSlots.emplace_back(i - 1);
+	}
 
-		dgi->cellInfo.cellCountX = o->cellCountX;
-		dgi->cellInfo.cellCountY = o->cellCountY;
-		dgi->cellInfo.pointOffset = pointOffset;
-		dgi->cellInfo.cellOffset = cellOffset;
-		dgi->bbox = o->bbox;
+	m_freeCells = {{ 0, MAX_CACHED_CELLS }};
+	m_freePoints = {{ 0, MAX_CACHED_POINTS }};
 
-		std::memcpy(cells + cellOffset, o->cells.data(), sizeof(uint32_t) * o->cells.size());
-		std::memcpy(points + pointOffset, o->points.data(), sizeof(Vector2f) * o->points.size());
+	LoadCache();
 
-		//OutlineU16Points(o, &dgi->cbox, reinterpret_cast<PointU16 *>(reinterpret_cast<char *>(points) + pointOffset));
+	// Printable ASCII is converted up front, other glyphs when first drawn.
+	std::vector<uint32_t> glyphIndices;
 
-		pointOffset += static_cast<uint32_t>(o->points.size());
-		cellOffset += static_cast<uint32_t>(o->cells.size());
+	for (char32_t codepoint = 0x20; codepoint < 0x7F; codepoint++)
+	{
+		glyphIndices.emplace_back(FT_Get_Char_Index(m_face, codepoint));
 	}
 
-	m_storageGlyphs->UnmapMemory();
-
-	assert(pointOffset == totalPoints);
-	assert(cellOffset == totalCells);
+	PrepareGlyphs(glyphIndices);
+}
 
-	if (FT_Done_Face(face) != 0)
+void FontType::GenerateAtlas()
+{
+	if (m_face == nullptr)
 	{
-		throw std::runtime_error("Freetype failed to destory face");
+		return;
 	}
 
-	if (FT_Done_FreeType(library) != 0)
+	// Texts are laid out one byte at a time, so the atlas holds printable ASCII.
+	std::vector<char32_t> codepoints;
+
+	for (char32_t codepoint = 0x20; codepoint < 0x7F; codepoint++)
 	{
-		throw std::runtime_error("Freetype failed to destory library");
+		codepoints.emplace_back(codepoint);
 	}
+
+	FontAtlas atlas(m_face, codepoints);
+	m_image = std::make_shared<Image2d>(atlas.GetExtent(), std::move(atlas.GetPixels()), VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+	m_metadata = std::make_unique<FontMetafile>(m_filename + "/" + m_style + ".ttf", atlas.GetCharacters(), atlas.GetSpaceWidth());
+	m_msdfAtlas = true;
 }
 }
@@ -1,15 +1,21 @@
 ﻿#pragma once
 
+#include "Engine/MemoryTracker.hpp"
 #include "Resources/Resource.hpp"
+#include "Files/FileView.hpp"
 #include "Maths/Colour.hpp"
 #include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/InstanceBuffer.hpp"
+#include "Graphics/Buffers/UniformHandler.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Images/Image2d.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 #include "FontMetafile.hpp"
 #include "Outline.hpp"
 
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+
 namespace acid
 {
 class Text;
@@ -32,16 +38,36 @@ public:
 			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
 				VkVertexInputAttributeDescription{ 0, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_rect) },
 				VkVertexInputAttributeDescription{ 1, baseBinding, VK_FORMAT_R32_UINT, offsetof(Instance, m_glyphIndex) },
-				VkVertexInputAttributeDescription{ 2, baseBinding, VK_FORMAT_R32_UINT, offsetof(Instance, m_sharpness) },
-				VkVertexInputAttributeDescription{ 3, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_colour) }
+				VkVertexInputAttributeDescription{ 2, baseBinding, VK_FORMAT_R32_SFLOAT, offsetof(Instance, m_sharpness) },
+				VkVertexInputAttributeDescription{ 3, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_colour) },
+				VkVertexInputAttributeDescription{ 4, baseBinding, VK_FORMAT_R32G32_SFLOAT, offsetof(Instance, m_position) }
 			};
 			return Shader::VertexInput(bindingDescriptions, attributeDescriptions);
 		}
 
+		// The glyph rectangle in pixels from the text position, the shader maps it to the screen so instances do not change with the window size.
 		Rect m_rect;
 		uint32_t m_glyphIndex;
 		float m_sharpness;
 		Colour m_colour;
+		// The screen position of the text, from 0 to 1.
+		Vector2f m_position;
+	};
+
+	/**
+	 * @brief A glyph of a text shaped by this font, a text keeps one for each UTF-8 code point of its string.
+	 */
+	class Glyph
+	{
+	public:
+		// The index of the glyph in the font face.
+		uint32_t m_glyphIndex;
+		// The byte in the string the code point starts at.
+		uint32_t m_index;
+		// The pen position before this glyph with kerning applied, in unscaled font units.
+		Vector2f m_offset;
+		Vector2f m_advance;
+		bool m_newLine;
 	};
 
 	/**
@@ -55,21 +81,31 @@ public:
 	 * Creates a new font type, or finds one with the same values.
 	 * @param filename The family file path that the texture atlases and character infos are contained in.
 	 * @param style The style postfix to load as this type.
+	 * @param msdf If the atlas is generated from the outlines of the font even if the style has a baked atlas.
 	 * @return The font type with the requested values.
 	 */
-	static std::shared_ptr<FontType> Create(const std::string &filename, const std::string &style = "Regular");
+	static std::shared_ptr<FontType> Create(const std::string &filename, const std::string &style = "Regular", const bool &msdf = false);
 
 	/**
-	 * Creates a new font type.
+	 * Creates a new font type. Styles without a baked atlas have a multi-channel signed distance field atlas generated by {@link FontAtlas}.
 	 * @param filename The family file path that the texture atlases and character infos are contained in.
 	 * @param style The style postfix to load as this type.
+	 * @param msdf If the atlas is generated from the outlines of the font even if the style has a baked atlas.
 	 * @param load If this resource will be loaded immediately, otherwise {@link FontType#Load} can be called later.
 	 */
-	FontType(std::string filename, std::string style, const bool &load = true);
+	FontType(std::string filename, std::string style, const bool &msdf = false, const bool &load = true);
+
+	~FontType();
 
+	/**
+	 * Writes the glyph instances of texts into the instance buffer. Texts are shaped again only from their first changed character,
+	 * and the instances of a text are only written again when it changed or moved inside the buffer. The instance buffer grows to fit every glyph.
+	 * Glyph outlines are converted when first drawn and kept in a cache of bounded size, the least recently drawn glyphs are evicted.
+	 * @param texts The texts drawn with this font.
+	 */
 	void Update(const std::vector<Text *> &texts);
 
-	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline);
+	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
 
 	void Load() override;
 
@@ -77,6 +113,12 @@ public:
 
 	const FontMetafile *GetMetadata() const { return m_metadata.get(); }
 
+	/**
+	 * Gets if the atlas is a generated multi-channel distance field, otherwise it is a baked single channel field in alpha.
+	 * @return If the atlas is multi-channel.
+	 */
+	bool IsMsdf() const { return m_msdfAtlas; }
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, FontType &fontType);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const FontType &fontType);
@@ -92,9 +134,20 @@ private:
 
 	struct HostGlyphInfo
 	{
-		Rect bbox;
 		float horiAdvance;
-		float vertAdvance;
+	};
+
+	// A slot in the glyph storage buffer, holding the converted outline of a glyph.
+	struct CachedGlyph
+	{
+		uint32_t glyphIndex;
+		Rect bbox;
+		uint32_t pointOffset;
+		uint32_t pointCount;
+		uint32_t cellOffset;
+		uint32_t cellCount;
+		uint64_t lastUsed;
+		bool cached;
 	};
 
 	struct DeviceGlyphInfo
@@ -104,15 +157,99 @@ private:
 		CellInfo cellInfo;
 	};
 
+	// A converted outline in the glyph cache file, offsets and counts are in cells and points.
+	struct CacheEntry
+	{
+		uint32_t glyphIndex;
+		Rect bbox;
+		uint32_t cellCountX;
+		uint32_t cellCountY;
+		uint32_t cellOffset;
+		uint32_t cellCount;
+		uint32_t pointOffset;
+		uint32_t pointCount;
+	};
+
+	// The instances a text wrote into the instance buffer, and the values they were written with.
+	struct TextInstances
+	{
+		const Text *m_text;
+		uint64_t m_version;
+		Vector2f m_position;
+		Vector2f m_scale;
+		Colour m_colour;
+		uint32_t m_offset;
+		uint32_t m_count;
+		uint64_t m_frame;
+		// The cache slots the instances use, marked as used while the instances are kept.
+		std::vector<uint32_t> m_slots;
+	};
+
 	static uint32_t AlignUint32(const uint32_t &value, const uint32_t &alignment);
 
+	static std::optional<uint32_t> AllocateRange(std::map<uint32_t, uint32_t> &freeRanges, const uint32_t &size);
+
+	static void FreeRange(std::map<uint32_t, uint32_t> &freeRanges, const uint32_t &offset, const uint32_t &size);
+
+	void UpdateGlyphs(Text &text);
+
+	/**
+	 * Converts the outlines of glyphs that are not cached yet, the cell fitting of each outline runs on the thread pool.
+	 * @param glyphIndices The indices of the glyphs in the font face.
+	 */
+	void PrepareGlyphs(std::vector<uint32_t> &glyphIndices);
+
+	void LoadCache();
+
+	void SaveCache();
+
+	const HostGlyphInfo &GetGlyphInfo(const uint32_t &glyphIndex);
+
+	/**
+	 * Gets the cache slot holding a glyph outline, converting and uploading the outline if it is not cached.
+	 * @param glyphIndex The index of the glyph in the font face.
+	 * @return The slot, or nullopt if the cache is full of glyphs that may still be drawn by frames in flight.
+	 */
+	std::optional<uint32_t> RequestGlyph(const uint32_t &glyphIndex);
+
+	void EvictGlyph(const uint32_t &slot);
+
+	uint32_t WriteInstances(const Text &text, Instance *instances, std::vector<uint32_t> &slots);
+
 	void LoadFont(const std::string &filename);
 
+	void GenerateAtlas();
+
 	std::string m_filename;
 	std::string m_style;
+	bool m_msdf;
+	bool m_msdfAtlas;
+
+	// The font file is kept loaded while the face is open.
+	std::optional<FileView> m_fontData;
+	FT_LibraryRec_ *m_library;
+	FT_FaceRec_ *m_face;
+	bool m_hasKerning;
+	float m_lineAdvance;
+	TrackedUnorderedMap<uint32_t, HostGlyphInfo, MemoryTag::Fonts> m_glyphInfos;
+
+	TrackedVector<CachedGlyph, MemoryTag::Fonts> m_cachedGlyphs;
+	TrackedUnorderedMap<uint32_t, uint32_t, MemoryTag::Fonts> m_cachedSlots;
+	std::vector<uint32_t> m_freeSlots;
+	std::map<uint32_t, uint32_t> m_freeCells;
+	std::map<uint32_t, uint32_t> m_freePoints;
+	char *m_glyphData;
+	uint64_t m_frame;
+	std::vector<uint32_t> m_missingGlyphs;
 
-	std::map<wchar_t, uint32_t> m_charmap;
-	std::vector<HostGlyphInfo> m_glyphInfos;
+	// Outlines converted by earlier runs are read from a cache file, keyed by a hash of the font file.
+	std::string m_cachePath;
+	std::optional<FileView> m_cacheView;
+	std::unordered_map<uint32_t, const CacheEntry *> m_cacheEntries;
+	const uint32_t *m_cacheCells = nullptr;
+	const Vector2f *m_cachePoints = nullptr;
+	// Outlines converted during this run, written to the cache file when the font is destroyed.
+	TrackedUnorderedMap<uint32_t, Outline, MemoryTag::Fonts> m_convertedOutlines;
 
 	uint32_t m_glyphDataSize{};
 	uint32_t m_glyphInfoSize{};
@@ -129,6 +266,8 @@ private:
 	std::unique_ptr<StorageBuffer> m_storageGlyphs;
 	std::unique_ptr<InstanceBuffer> m_instanceBuffer;
 
+	uint32_t m_maxInstances;
 	uint32_t m_instances;
+	TrackedVector<TextInstances, MemoryTag::Fonts> m_textInstances;
 };
 }
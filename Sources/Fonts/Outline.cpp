@@ -75,6 +75,11 @@ int32_t CubicToFunc(const FT_Vector *control1, const FT_Vector *control2, const
 void OutlineConvert(FT_Outline *outline, Outline *o)
 {
 	OutlineDecompose(outline, o);
+	OutlineFinish(o);
+}
+
+void OutlineFinish(Outline *o)
+{
 	//OutlineFixCorners(o);
 	//OutlineSubdivide(o);
 	OutlineFixThinLines(o);
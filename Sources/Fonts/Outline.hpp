@@ -59,6 +59,12 @@ void OutlineConvert(FT_Outline *outline, Outline *o);
 
 void OutlineDecompose(FT_Outline *outline, Outline *o);
 
+/**
+ * Fixes thin lines and fits the cells of a decomposed outline. Only the outline is used, so outlines can be finished on any thread.
+ * @param o The outline from {@link OutlineDecompose}.
+ */
+void OutlineFinish(Outline *o);
+
 static uint32_t CellAddRange(uint32_t cell, uint32_t from, uint32_t to);
 
 static bool IsCellFilled(const Outline *o, const Rect &bbox);
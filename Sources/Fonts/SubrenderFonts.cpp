@@ -21,19 +21,9 @@ void SubrenderFonts::Render(const CommandBuffer &commandBuffer)
 
 	m_pipeline.BindPipeline(commandBuffer);
 
-	for (const auto &screenObject : Uis::Get()->GetObjects())
+	for (const auto &text : Uis::Get()->GetTexts())
 	{
-		if (!screenObject->IsEnabled())
-		{
-			continue;
-		}
-
-		auto object = dynamic_cast<Text *>(screenObject);
-
-		if (object != nullptr)
-		{
-			object->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
-		}
+		text->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
 	}
 }
 }
@@ -1,5 +1,6 @@
 #include "SubrenderFonts2.hpp"
 
+#include "Graphics/Graphics.hpp"
 #include "FontType.hpp"
 #include "Uis/Uis.hpp"
 #include "Text.hpp"
@@ -15,37 +16,19 @@ SubrenderFonts2::SubrenderFonts2(const Pipeline::Stage &pipelineStage) :
 
 void SubrenderFonts2::Render(const CommandBuffer &commandBuffer)
 {
-	std::map<std::shared_ptr<FontType>, std::vector<Text *>> sorted;
+	m_uniformScene.Push("extent", Vector2f(Graphics::Get()->GetDisplaySize()));
 
-	for (const auto &screenObject : Uis::Get()->GetObjects())
+	m_pipeline.BindPipeline(commandBuffer);
+
+	for (const auto &[type, typeTexts] : Uis::Get()->GetTextsByFont())
 	{
-		if (!screenObject->IsEnabled())
+		if (typeTexts.empty())
 		{
 			continue;
 		}
 
-		auto object = dynamic_cast<Text *>(screenObject);
-
-		if (object != nullptr)
-		{
-			auto it = sorted.find(object->GetFontType());
-
-			if (it == sorted.end())
-			{
-				sorted.emplace(object->GetFontType(), std::vector<Text *>());
-				it = sorted.find(object->GetFontType());
-			}
-
-			(*it).second.emplace_back(object);
-		}
-	}
-
-	m_pipeline.BindPipeline(commandBuffer);
-
-	for (auto &[type, typeTexts] : sorted)
-	{
 		type->Update(typeTexts);
-		type->CmdRender(commandBuffer, m_pipeline);
+		type->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
 	}
 }
 }
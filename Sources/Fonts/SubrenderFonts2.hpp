@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/UniformHandler.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 
 namespace acid
@@ -15,5 +16,6 @@ public:
 
 private:
 	PipelineGraphics m_pipeline;
+	UniformHandler m_uniformScene;
 };
 }
@@ -1,14 +1,24 @@
 ﻿#include "Text.hpp"
 
-#include "Maths/Visual/DriverConstant.hpp"
+#include <atomic>
+#include "Uis/Uis.hpp"
 
 namespace acid
 {
+static std::atomic<uint64_t> STRING_VERSIONS(0);
+
 Text::Text(UiObject *parent, const UiBound &rectangle, const float &fontSize, std::string text, std::shared_ptr<FontType> fontType, const Justify &justify, const float &maxWidth,
 	const Colour &textColour, const float &kerning, const float &leading) :
 	UiObject(parent, rectangle),
 	m_model(nullptr),
 	m_numberLines(0),
+	m_layoutMaxWidth(maxWidth),
+	m_layoutKerning(kerning),
+	m_layoutLeading(leading),
+	m_glyphsFont(nullptr),
+	m_glyphsChangedIndex(0),
+	m_glyphsVersion(0),
+	m_stringVersion(++STRING_VERSIONS),
 	m_string(std::move(text)),
 	m_justify(justify),
 	m_fontType(std::move(fontType)),
@@ -19,26 +29,33 @@ Text::Text(UiObject *parent, const UiBound &rectangle, const float &fontSize, st
 	m_borderColour(Colour::White),
 	m_solidBorder(false),
 	m_glowBorder(false),
-	m_glowDriver(std::make_unique<DriverConstant<float>>(0.0f)),
 	m_glowSize(0.0f),
-	m_borderDriver(std::make_unique<DriverConstant<float>>(0.0f)),
 	m_borderSize(0.0f)
 {
-	SetScaleDriver(new DriverConstant<Vector2f>(Vector2f(fontSize)));
+	SetScale(Vector2f(fontSize));
 	LoadText();
 }
 
+Text::~Text()
+{
+	Tweens::Get()->Stop(m_glowTween);
+	Tweens::Get()->Stop(m_borderTween);
+}
+
 void Text::UpdateObject()
 {
 	if (m_newString.has_value())
 	{
-		m_string = *m_newString;
-		LoadText();
+		auto changedIndex = static_cast<std::size_t>(std::mismatch(m_string.begin(), m_string.end(), m_newString->begin(), m_newString->end()).first - m_string.begin());
+		m_string = std::move(*m_newString);
 		m_newString = {};
+		m_stringVersion = ++STRING_VERSIONS;
+		m_glyphsChangedIndex = std::min(m_glyphsChangedIndex, changedIndex);
+		LoadText(changedIndex);
 	}
 
-	m_glowSize = m_glowDriver->Update(Engine::Get()->GetDelta());
-	m_borderSize = m_borderDriver->Update(Engine::Get()->GetDelta());
+	m_glowSize = m_glowDriver ? m_glowDriver->Update(Engine::Get()->GetDelta()) : Tweens::Get()->GetValue(m_glowTween, m_glowSize);
+	m_borderSize = m_borderDriver ? m_borderDriver->Update(Engine::Get()->GetDelta()) : Tweens::Get()->GetValue(m_borderTween, m_borderSize);
 
 	// Updates uniforms.
 	m_uniformObject.Push("modelMatrix", GetModelMatrix());
@@ -51,6 +68,12 @@ void Text::UpdateObject()
 	m_uniformObject.Push("borderColour", m_borderColour);
 	m_uniformObject.Push("borderSizes", Vector2f(GetTotalBorderSize(), GetGlowSize()));
 	m_uniformObject.Push("edgeData", Vector2f(CalculateEdgeStart(), CalculateAntialiasSize()));
+	m_uniformObject.Push("msdf", static_cast<int32_t>(m_fontType != nullptr && m_fontType->IsMsdf()));
+}
+
+void Text::AddToLists(Uis &uis)
+{
+	uis.AddText(this);
 }
 
 bool Text::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
@@ -94,18 +117,32 @@ void Text::SetString(const std::string &string)
 
 void Text::SetBorderDriver(Driver<float> *borderDriver)
 {
+	Tweens::Get()->Stop(m_borderTween);
 	m_borderDriver.reset(borderDriver);
 	m_solidBorder = true;
 	m_glowBorder = false;
 }
 
+void Text::TweenBorder(const float &borderSize, const Time &length)
+{
+	SetBorderDriver(nullptr);
+	m_borderTween = Tweens::Get()->Start(m_borderSize, borderSize, length);
+}
+
 void Text::SetGlowDriver(Driver<float> *glowDriver)
 {
+	Tweens::Get()->Stop(m_glowTween);
 	m_glowDriver.reset(glowDriver);
 	m_solidBorder = false;
 	m_glowBorder = true;
 }
 
+void Text::TweenGlow(const float &glowSize, const Time &length)
+{
+	SetGlowDriver(nullptr);
+	m_glowTween = Tweens::Get()->Start(m_glowSize, glowSize, length);
+}
+
 void Text::RemoveBorder()
 {
 	m_solidBorder = false;
@@ -167,20 +204,36 @@ bool Text::IsLoaded() const
 	return !m_string.empty() && m_model != nullptr;
 }
 
-void Text::LoadText()
+void Text::LoadText(const std::size_t &changedIndex)
 {
 	if (m_string.empty())
 	{
 		m_model = nullptr;
+		m_lines.clear();
+		m_layoutPoints.clear();
+		m_vertices.clear();
+		m_lineVertices.clear();
 		return;
 	}
 
+	auto index = changedIndex;
+
+	// The kept lines were laid out with the old values.
+	if (m_maxWidth != m_layoutMaxWidth || m_kerning != m_layoutKerning || m_leading != m_layoutLeading)
+	{
+		m_layoutMaxWidth = m_maxWidth;
+		m_layoutKerning = m_kerning;
+		m_layoutLeading = m_leading;
+		index = 0;
+	}
+
 	// Creates mesh data.
-	auto lines = CreateStructure();
-	auto vertices = CreateQuad(lines);
+	auto firstLine = CreateStructure(index);
+	CreateQuad(firstLine);
 
 	// Calculates the bounds and normalizes the vertices.
 	Vector2f bounding;
+	auto vertices = m_vertices;
 	NormalizeQuad(bounding, vertices);
 
 	// Loads the mesh data.
@@ -188,25 +241,69 @@ void Text::LoadText()
 	GetRectangle().SetSize(bounding);
 }
 
-std::vector<Text::Line> Text::CreateStructure() const
+std::size_t Text::CreateStructure(const std::size_t &changedIndex)
 {
-	std::vector<Line> lines;
-	auto currentLine = Line(m_fontType->GetMetadata()->GetSpaceWidth(), m_maxWidth);
+	static const std::string_view whitespace = " \t\n\r";
+
+	auto spaceWidth = m_fontType->GetMetadata()->GetSpaceWidth();
+	auto currentLine = Line(spaceWidth, m_maxWidth);
 	auto currentWord = Word();
+	std::size_t index = 0;
+	bool tokenStart = true;
+
+	// Lines are greedily filled from the start, so the structure up to a point only read from the unchanged characters is the same.
+	while (!m_layoutPoints.empty() && m_layoutPoints.back().m_confirmIndex >= changedIndex)
+	{
+		m_layoutPoints.pop_back();
+	}
+
+	if (!m_layoutPoints.empty())
+	{
+		const auto &point = m_layoutPoints.back();
+		m_lines.erase(m_lines.begin() + point.m_lines, m_lines.end());
+		currentLine = point.m_line;
+		index = point.m_index;
+		tokenStart = point.m_tokenStart;
+	}
+	else
+	{
+		m_lines.clear();
+	}
 
-	auto formattedText = String::ReplaceAll(m_string, "\t", "	");
-	auto textLines = String::Split(formattedText, "\n", true);
+	auto firstLine = m_lines.size();
 
-	for (uint32_t i = 0; i < textLines.size(); i++)
+	// Each line of the string is trimmed and empty lines are skipped, like String::Split.
+	while (index < m_string.size())
 	{
-		if (textLines.at(i).empty())
+		auto tokenEnd = std::min(m_string.find('\n', index), m_string.size());
+
+		if (tokenEnd == index)
+		{
+			index++;
+			continue;
+		}
+
+		// A later line existing means the previous line was not the last one.
+		if (tokenStart && index > 0)
+		{
+			m_layoutPoints.emplace_back(LayoutPoint{index, index, true, m_lines.size(), currentLine});
+		}
+
+		auto token = std::string_view(m_string).substr(0, tokenEnd);
+		auto begin = tokenStart ? token.find_first_not_of(whitespace, index) : index;
+
+		if (begin == std::string_view::npos)
 		{
+			index = tokenEnd;
+			tokenStart = true;
 			continue;
 		}
 
-		for (const auto &c : textLines.at(i))
+		auto end = token.find_last_not_of(whitespace) + 1;
+
+		for (auto i = begin; i < end; i++)
 		{
-			auto ascii = static_cast<int32_t>(c);
+			auto ascii = static_cast<int32_t>(m_string[i]);
 
 			if (ascii == FontMetafile::SpaceAscii)
 			{
@@ -214,9 +311,11 @@ std::vector<Text::Line> Text::CreateStructure() const
 
 				if (!added)
 				{
-					lines.emplace_back(currentLine);
-					currentLine = Line(m_fontType->GetMetadata()->GetSpaceWidth(), m_maxWidth);
+					m_lines.emplace_back(std::move(currentLine));
+					currentLine = Line(spaceWidth, m_maxWidth);
 					currentLine.AddWord(currentWord);
+					// Only valid while the last character of this line is unchanged, otherwise this space could be trimmed.
+					m_layoutPoints.emplace_back(LayoutPoint{i + 1, end - 1, false, m_lines.size(), currentLine});
 				}
 
 				currentWord = Word();
@@ -231,11 +330,11 @@ std::vector<Text::Line> Text::CreateStructure() const
 			}
 		}
 
-		if (i != textLines.size() - 1)
+		if (m_string.find_first_not_of('\n', tokenEnd) != std::string::npos)
 		{
 			bool wordAdded = currentLine.AddWord(currentWord);
-			lines.emplace_back(currentLine);
-			currentLine = Line(m_fontType->GetMetadata()->GetSpaceWidth(), m_maxWidth);
+			m_lines.emplace_back(std::move(currentLine));
+			currentLine = Line(spaceWidth, m_maxWidth);
 
 			if (!wordAdded)
 			{
@@ -244,10 +343,13 @@ std::vector<Text::Line> Text::CreateStructure() const
 
 			currentWord = Word();
 		}
+
+		index = tokenEnd;
+		tokenStart = true;
 	}
 
-	CompleteStructure(lines, currentLine, currentWord);
-	return lines;
+	CompleteStructure(m_lines, currentLine, currentWord);
+	return firstLine;
 }
 
 void Text::CompleteStructure(std::vector<Line> &lines, Line &currentLine, const Word &currentWord) const
@@ -264,44 +366,54 @@ void Text::CompleteStructure(std::vector<Line> &lines, Line &currentLine, const
 	lines.emplace_back(currentLine);
 }
 
-std::vector<VertexDefault> Text::CreateQuad(const std::vector<Line> &lines)
+void Text::CreateQuad(const std::size_t &firstLine)
 {
-	std::vector<VertexDefault> vertices;
-	m_numberLines = static_cast<uint32_t>(lines.size());
+	m_numberLines = static_cast<uint32_t>(m_lines.size());
+
+	// Lines before the first changed line are never the last line, so their vertices are kept.
+	m_vertices.resize(firstLine < m_lineVertices.size() ? m_lineVertices[firstLine] : m_vertices.size());
+	m_lineVertices.resize(firstLine);
 
 	auto cursorX = 0.0f;
 	auto cursorY = 0.0f;
-	auto lineOrder = static_cast<int32_t>(lines.size());
+	auto lineOrder = static_cast<int32_t>(m_lines.size() - firstLine);
 
-	for (const auto &line : lines)
+	for (std::size_t i = 0; i < firstLine; i++)
 	{
+		cursorY += m_leading + FontMetafile::LineHeight;
+	}
+
+	for (auto line = m_lines.begin() + firstLine; line != m_lines.end(); ++line)
+	{
+		m_lineVertices.emplace_back(m_vertices.size());
+
 		switch (m_justify)
 		{
 		case Justify::Left:
 			cursorX = 0.0f;
 			break;
 		case Justify::Centre:
-			cursorX = (line.m_maxLength - line.m_currentLineLength) / 2.0f;
+			cursorX = (line->m_maxLength - line->m_currentLineLength) / 2.0f;
 			break;
 		case Justify::Right:
-			cursorX = line.m_maxLength - line.m_currentLineLength;
+			cursorX = line->m_maxLength - line->m_currentLineLength;
 			break;
 		case Justify::Fully:
 			cursorX = 0.0f;
 			break;
 		}
 
-		for (const auto &word : line.m_words)
+		for (const auto &word : line->m_words)
 		{
 			for (const auto &letter : word.m_characters)
 			{
-				AddVerticesForCharacter(cursorX, cursorY, letter, vertices);
+				AddVerticesForCharacter(cursorX, cursorY, letter, m_vertices);
 				cursorX += m_kerning + letter.m_advanceX;
 			}
 
 			if (m_justify == Justify::Fully && lineOrder > 1)
 			{
-				cursorX += (line.m_maxLength - line.m_currentWordsLength) / line.m_words.size();
+				cursorX += (line->m_maxLength - line->m_currentWordsLength) / line->m_words.size();
 			}
 			else
 			{
@@ -312,8 +424,6 @@ std::vector<VertexDefault> Text::CreateQuad(const std::vector<Line> &lines)
 		cursorY += m_leading + FontMetafile::LineHeight;
 		lineOrder--;
 	}
-
-	return vertices;
 }
 
 void Text::AddVerticesForCharacter(const float &cursorX, const float &cursorY, const FontMetafile::Character &character, std::vector<VertexDefault> &vertices)
@@ -44,8 +44,12 @@ public:
 	Text(UiObject *parent, const UiBound &rectangle, const float &fontSize, std::string text, std::shared_ptr<FontType> fontType = FontType::Create("Fonts/ProximaNova", "Regular"),
 		const Justify &justify = Justify::Left, const float &maxWidth = 1.0f, const Colour &textColour = Colour::Black, const float &kerning = 0.0f, const float &leading = 0.0f);
 
+	~Text();
+
 	void UpdateObject() override;
 
+	void AddToLists(Uis &uis) override;
+
 	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
 
 	/**
@@ -152,6 +156,13 @@ public:
 	 */
 	void SetGlowDriver(Driver<float> *glowDriver);
 
+	/**
+	 * Slides the glow size from its current value, will disable solid borders.
+	 * @param glowSize The glow size to slide to.
+	 * @param length The time taken to get to the glow size.
+	 */
+	void TweenGlow(const float &glowSize, const Time &length);
+
 	Driver<float> *GetBorderDriver() const { return m_borderDriver.get(); }
 
 	/**
@@ -160,6 +171,13 @@ public:
 	 */
 	void SetBorderDriver(Driver<float> *borderDriver);
 
+	/**
+	 * Slides the border size from its current value, will disable glowing.
+	 * @param borderSize The border size to slide to.
+	 * @param length The time taken to get to the border size.
+	 */
+	void TweenBorder(const float &borderSize, const Time &length);
+
 	/**
 	 * Disables both solid borders and glow borders.
 	 */
@@ -275,18 +293,35 @@ private:
 		float m_currentLineLength;
 	};
 
+	/**
+	 * A point the structure can be continued from, saved each time a line is started.
+	 */
+	class LayoutPoint
+	{
+	public:
+		std::size_t m_index;
+		// The point is only valid while the string is unchanged up to and including this index.
+		std::size_t m_confirmIndex;
+		// If the index starts a line of the string, so leading whitespace is still trimmed.
+		bool m_tokenStart;
+		std::size_t m_lines;
+		Line m_line;
+	};
+
 	/**
 	 * Takes in an unloaded text and calculate all of the vertices for the quads on which this text will be rendered.
 	 * The vertex positions and texture coords and calculated based on the information from the font file.
 	 * Then takes the information about the vertices of all the quads and stores it in a model.
+	 * Lines before the first changed character are kept from the last load.
+	 * @param changedIndex The index of the first character that changed since the last load.
 	 */
-	void LoadText();
+	void LoadText(const std::size_t &changedIndex = 0);
 
-	std::vector<Line> CreateStructure() const;
+	std::size_t CreateStructure(const std::size_t &changedIndex);
 
 	void CompleteStructure(std::vector<Line> &lines, Line &currentLine, const Word &currentWord) const;
 
-	std::vector<VertexDefault> CreateQuad(const std::vector<Line> &lines);
+	void CreateQuad(const std::size_t &firstLine);
 
 	static void AddVerticesForCharacter(const float &cursorX, const float &cursorY, const FontMetafile::Character &character, std::vector<VertexDefault> &vertices);
 
@@ -300,6 +335,23 @@ private:
 	std::unique_ptr<Model> m_model;
 	uint32_t m_numberLines;
 
+	// The structure and vertices from the last load, before the vertices are normalized.
+	std::vector<Line> m_lines;
+	std::vector<LayoutPoint> m_layoutPoints;
+	std::vector<VertexDefault> m_vertices;
+	std::vector<std::size_t> m_lineVertices;
+	float m_layoutMaxWidth;
+	float m_layoutKerning;
+	float m_layoutLeading;
+
+	// The glyphs the font type draws this text with, rebuilt by the font type from the first changed character.
+	std::vector<FontType::Glyph> m_glyphs;
+	const FontType *m_glyphsFont;
+	std::size_t m_glyphsChangedIndex;
+	uint64_t m_glyphsVersion;
+	// Unique between all texts, changed each time the string changes.
+	uint64_t m_stringVersion;
+
 	std::string m_string;
 	std::optional<std::string> m_newString;
 	Justify m_justify;
@@ -315,9 +367,11 @@ private:
 	bool m_glowBorder;
 
 	std::unique_ptr<Driver<float>> m_glowDriver;
+	Tween m_glowTween;
 	float m_glowSize;
 
 	std::unique_ptr<Driver<float>> m_borderDriver;
+	Tween m_borderTween;
 	float m_borderSize;
 };
 }
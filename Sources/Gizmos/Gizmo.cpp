@@ -2,10 +2,13 @@
 
 namespace acid
 {
-Gizmo::Gizmo(const std::shared_ptr<GizmoType> &gizmoType, const Transform &transform, const std::optional<Colour> &colour) :
+Gizmo::Gizmo(const std::shared_ptr<GizmoType> &gizmoType, const Transform &transform, const std::optional<Colour> &colour, const bool &isStatic) :
 	m_gizmoType(gizmoType),
 	m_transform(transform),
-	m_colour(colour ? *colour : gizmoType->GetColour())
+	m_colour(colour ? *colour : gizmoType->GetColour()),
+	m_static(isStatic),
+	m_poolIndex(0),
+	m_listIndex(0)
 {
 }
 
@@ -18,4 +21,34 @@ bool Gizmo::operator!=(const Gizmo &other) const
 {
 	return !(*this == other);
 }
+
+void Gizmo::SetTransform(const Transform &transform)
+{
+	m_transform = transform;
+
+	if (m_static)
+	{
+		m_gizmoType->m_staticModified = true;
+	}
+}
+
+void Gizmo::SetColour(const Colour &colour)
+{
+	m_colour = colour;
+
+	if (m_static)
+	{
+		m_gizmoType->m_staticModified = true;
+	}
+}
+
+void Gizmo::SetEntity(const EntityHandle &entity)
+{
+	m_entity = entity;
+
+	if (m_static)
+	{
+		m_gizmoType->m_staticModified = true;
+	}
+}
 }
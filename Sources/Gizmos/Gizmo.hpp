@@ -16,8 +16,9 @@ public:
 	 * @param gizmoType The gizmo template to build from.
 	 * @param transform The gizmos initial transform.
 	 * @param colour The colour for this gizmo, without a value it will be set to the types default.
+	 * @param isStatic If the gizmo rarely changes, static gizmos are only uploaded again when one of them is set or the static gizmos of the type change.
 	 */
-	Gizmo(const std::shared_ptr<GizmoType> &gizmoType, const Transform &transform, const std::optional<Colour> &colour = {});
+	Gizmo(const std::shared_ptr<GizmoType> &gizmoType, const Transform &transform, const std::optional<Colour> &colour = {}, const bool &isStatic = false);
 
 	bool operator==(const Gizmo &other) const;
 
@@ -27,19 +28,40 @@ public:
 
 	const Transform &GetTransform() const { return m_transform; }
 
+	/**
+	 * Gets the transform to modify in place, static gizmos must be changed with {@link Gizmo#SetTransform} to upload the change.
+	 * @return The transform.
+	 */
 	Transform &GetTransform() { return m_transform; }
 
-	void SetTransform(const Transform &transform) { m_transform = transform; }
+	void SetTransform(const Transform &transform);
 
 	const Colour &GetColour() const { return m_colour; }
 
-	void SetColour(const Colour &colour) { m_colour = colour; }
+	void SetColour(const Colour &colour);
+
+	const EntityHandle &GetEntity() const { return m_entity; }
+
+	/**
+	 * Sets the entity the gizmo is drawn for, the gizmo is then picked as that entity by a {@link EntityPicker}.
+	 * @param entity The entity handle, or a null handle if the gizmo is not picked.
+	 */
+	void SetEntity(const EntityHandle &entity);
+
+	const bool &IsStatic() const { return m_static; }
 
 private:
 	friend class GizmoType;
+	friend class Gizmos;
 
 	std::shared_ptr<GizmoType> m_gizmoType;
 	Transform m_transform;
 	Colour m_colour;
+	EntityHandle m_entity;
+	bool m_static;
+
+	// The slot of the gizmo in the pool and its position in the list of its type, so it can be removed without a search.
+	std::size_t m_poolIndex;
+	std::size_t m_listIndex;
 };
 }
@@ -1,29 +1,22 @@
 #include "GizmoType.hpp"
 
+#include "Graphics/Graphics.hpp"
 #include "Resources/Resources.hpp"
-#include "Scenes/Scenes.hpp"
 #include "Gizmo.hpp"
 
 namespace acid
 {
-static const uint32_t MAX_INSTANCES = 512;
-//static const uint32_t INSTANCE_STEPS = 128;
-//static const float FRUSTUM_BUFFER = 1.4f;
+static const uint32_t INITIAL_INSTANCES = 512;
 
 std::shared_ptr<GizmoType> GizmoType::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<GizmoType>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<GizmoType>(resource);
-	}
-
-	auto result = std::make_shared<GizmoType>(nullptr);
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<GizmoType>(nullptr);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<GizmoType> GizmoType::Create(const std::shared_ptr<Model> &model, const float &lineThickness, const Colour &colour)
@@ -38,47 +31,62 @@ GizmoType::GizmoType(std::shared_ptr<Model> model, const float &lineThickness, c
 	m_model(std::move(model)),
 	m_lineThickness(lineThickness),
 	m_colour(colour),
-	m_maxInstances(0),
+	m_maxInstances(INITIAL_INSTANCES),
 	m_instances(0),
-	m_instanceBuffer(sizeof(Instance) * MAX_INSTANCES)
+	m_staticModified(true),
+	m_instanceBuffer(std::make_unique<InstanceBuffer>(sizeof(Instance) * INITIAL_INSTANCES))
 {
 }
 
-void GizmoType::Update(const std::vector<std::unique_ptr<Gizmo>> &gizmos)
+void GizmoType::Update(const std::vector<Gizmo *> &staticGizmos, const std::vector<Gizmo *> &dynamicGizmos)
 {
-	// Calculates a max instance count over the time of the type. TODO: Allow decreasing max using a timer and average count over the delay.
-	//uint32_t instances = INSTANCE_STEPS * static_cast<uint32_t>(std::ceil(static_cast<float>(gizmos.size()) / static_cast<float>(INSTANCE_STEPS)));
-	//m_maxInstances = std::max(m_maxInstances, instances);
-	m_maxInstances = MAX_INSTANCES;
+	auto requiredInstances = staticGizmos.size() + dynamicGizmos.size();
 	m_instances = 0;
 
-	if (gizmos.empty())
+	if (requiredInstances == 0)
 	{
 		return;
 	}
 
+	if (requiredInstances > m_maxInstances)
+	{
+		// The old buffer may still be read by frames in flight, it is destroyed once they have finished.
+		while (m_maxInstances < requiredInstances)
+		{
+			m_maxInstances *= 2;
+		}
+
+		m_instanceBuffer = std::make_unique<InstanceBuffer>(sizeof(Instance) * m_maxInstances);
+		m_staticModified = true;
+	}
+
 	Instance *instances;
-	m_instanceBuffer.MapMemory(reinterpret_cast<void **>(&instances));
+	m_instanceBuffer->MapMemory(reinterpret_cast<void **>(&instances));
 
-	for (const auto &gizmo : gizmos)
+	if (m_staticModified)
 	{
-		if (m_instances >= m_maxInstances)
+		for (const auto &gizmo : staticGizmos)
 		{
-			break;
+			auto instance = &instances[m_instances++];
+			instance->m_modelMatrix = gizmo->m_transform.GetWorldMatrix();
+			instance->m_colour = gizmo->m_colour;
+			instance->m_entity = gizmo->m_entity;
 		}
 
-		//if (!Scenes::Get()->GetCamera()->GetViewFrustum().SphereInFrustum(gizmo->GetTransform().GetPosition(), FRUSTUM_BUFFER * gizmo->GetTransform().GetPosition().GetScale()))
-		//{
-		//continue;
-		//}
+		m_staticModified = false;
+	}
+
+	m_instances = static_cast<uint32_t>(staticGizmos.size());
 
-		auto instance = &instances[m_instances];
+	for (const auto &gizmo : dynamicGizmos)
+	{
+		auto instance = &instances[m_instances++];
 		instance->m_modelMatrix = gizmo->m_transform.GetWorldMatrix();
 		instance->m_colour = gizmo->m_colour;
-		m_instances++;
+		instance->m_entity = gizmo->m_entity;
 	}
 
-	m_instanceBuffer.UnmapMemory();
+	m_instanceBuffer->UnmapMemory();
 }
 
 bool GizmoType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
@@ -102,11 +110,11 @@ bool GizmoType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGrap
 	// Draws the instanced objects.
 	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
 
-	VkBuffer vertexBuffers[] = { m_model->GetVertexBuffer()->GetBuffer(), m_instanceBuffer.GetBuffer() };
+	VkBuffer vertexBuffers[] = { m_model->GetVertexBuffer()->GetBuffer(), m_instanceBuffer->GetBuffer() };
 	VkDeviceSize offsets[] = { 0, 0 };
 	vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
 	vkCmdBindIndexBuffer(commandBuffer, m_model->GetIndexBuffer()->GetBuffer(), 0, m_model->GetIndexType());
-	vkCmdDrawIndexed(commandBuffer, m_model->GetIndexCount(), m_instances, 0, 0, 0);
+	vkCmdDrawIndexed(commandBuffer, m_model->GetIndexCount(), m_instances, m_model->GetFirstIndex(), m_model->GetVertexOffset(), 0);
 	return true;
 }
 
@@ -7,6 +7,7 @@
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 #include "Resources/Resource.hpp"
+#include "Scenes/EntityHandle.hpp"
 #include "Serialized/Metadata.hpp"
 
 namespace acid
@@ -33,13 +34,15 @@ public:
 				VkVertexInputAttributeDescription{ 1, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_modelMatrix) + offsetof(Matrix4, m_rows[1]) },
 				VkVertexInputAttributeDescription{ 2, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_modelMatrix) + offsetof(Matrix4, m_rows[2]) },
 				VkVertexInputAttributeDescription{ 3, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_modelMatrix) + offsetof(Matrix4, m_rows[3]) },
-				VkVertexInputAttributeDescription{ 4, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_colour) }
+				VkVertexInputAttributeDescription{ 4, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_colour) },
+				VkVertexInputAttributeDescription{ 5, baseBinding, VK_FORMAT_R32G32_UINT, offsetof(Instance, m_entity) }
 			};
 			return Shader::VertexInput(bindingDescriptions, attributeDescriptions);
 		}
 
 		Matrix4 m_modelMatrix;
 		Colour m_colour;
+		EntityHandle m_entity;
 	};
 
 	/**
@@ -66,7 +69,12 @@ public:
 	 */
 	explicit GizmoType(std::shared_ptr<Model> model, const float &lineThickness = 1.0f, const Colour &colour = Colour::White);
 
-	void Update(const std::vector<std::unique_ptr<Gizmo>> &gizmos);
+	/**
+	 * Writes the gizmos into the instance buffer, static gizmos are kept at the start of the buffer and only written when they changed.
+	 * @param staticGizmos The static gizmos of this type.
+	 * @param dynamicGizmos The gizmos of this type that are written every update.
+	 */
+	void Update(const std::vector<Gizmo *> &staticGizmos, const std::vector<Gizmo *> &dynamicGizmos);
 
 	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
 
@@ -87,14 +95,18 @@ public:
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const GizmoType &gizmoType);
 
 private:
+	friend class Gizmo;
+	friend class Gizmos;
+
 	std::shared_ptr<Model> m_model;
 	float m_lineThickness;
 	Colour m_colour;
 
 	uint32_t m_maxInstances;
 	uint32_t m_instances;
+	bool m_staticModified;
 
 	DescriptorsHandler m_descriptorSet;
-	InstanceBuffer m_instanceBuffer;
+	std::unique_ptr<InstanceBuffer> m_instanceBuffer;
 };
 }
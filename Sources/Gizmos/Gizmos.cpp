@@ -1,55 +1,168 @@
 #include "Gizmos.hpp"
 
+#include "Maths/Maths.hpp"
+
 namespace acid
 {
+static const uint32_t SPHERE_SEGMENTS = 32;
+
 Gizmos::Gizmos()
 {
+	Isolated();
 }
 
 void Gizmos::Update()
 {
 	for (auto it = m_gizmos.begin(); it != m_gizmos.end();)
 	{
-		if (it->second.empty())
+		if (it->second.m_staticGizmos.empty() && it->second.m_dynamicGizmos.empty())
 		{
 			it = m_gizmos.erase(it);
 			continue;
 		}
 
-		(*it).first->Update((*it).second);
+		(*it).first->Update((*it).second.m_staticGizmos, (*it).second.m_dynamicGizmos);
 		++it;
 	}
+
+	// Lines drawn since the last update are rendered this frame, whichever order modules are updated in each line is shown once.
+	std::lock_guard<std::mutex> lock(m_linesMutex);
+	m_frameLines.swap(m_lines);
+	m_lines.clear();
 }
 
-Gizmo *Gizmos::AddGizmo(Gizmo *gizmo)
+Gizmo *Gizmos::AddGizmo(const std::shared_ptr<GizmoType> &gizmoType, const Transform &transform, const std::optional<Colour> &colour, const bool &isStatic)
 {
-	auto it = m_gizmos.find(gizmo->GetGizmoType());
+	std::size_t index;
 
-	if (it == m_gizmos.end())
+	if (!m_freeGizmos.empty())
+	{
+		index = m_freeGizmos.back();
+		m_freeGizmos.pop_back();
+	}
+	else
 	{
-		m_gizmos.emplace(gizmo->GetGizmoType(), std::vector<std::unique_ptr<Gizmo>>());
-		it = m_gizmos.find(gizmo->GetGizmoType());
+		index = m_pool.size();
+		m_pool.emplace_back();
+	}
+
+	auto gizmo = &m_pool[index].emplace(gizmoType, transform, colour, isStatic);
+	auto &typeGizmos = m_gizmos[gizmoType];
+	auto &list = isStatic ? typeGizmos.m_staticGizmos : typeGizmos.m_dynamicGizmos;
+	gizmo->m_poolIndex = index;
+	gizmo->m_listIndex = list.size();
+	list.emplace_back(gizmo);
+
+	if (isStatic)
+	{
+		gizmoType->m_staticModified = true;
 	}
 
-	(*it).second.emplace_back(gizmo);
 	return gizmo;
 }
 
+Gizmo *Gizmos::AddGizmo(Gizmo *gizmo)
+{
+	std::unique_ptr<Gizmo> owned(gizmo);
+	return AddGizmo(owned->m_gizmoType, owned->m_transform, owned->m_colour, owned->m_static);
+}
+
 void Gizmos::RemoveGizmo(Gizmo *gizmo)
 {
+	if (gizmo == nullptr)
+	{
+		return;
+	}
+
 	auto it = m_gizmos.find(gizmo->GetGizmoType());
 
-	if (it != m_gizmos.end())
+	if (it == m_gizmos.end())
 	{
-		it->second.erase(std::remove_if(it->second.begin(), it->second.end(), [&](std::unique_ptr<Gizmo> &g)
-		{
-			return g.get() == gizmo;
-		}), it->second.end());
+		return;
+	}
+
+	auto &list = gizmo->m_static ? it->second.m_staticGizmos : it->second.m_dynamicGizmos;
+
+	if (gizmo->m_listIndex >= list.size() || list[gizmo->m_listIndex] != gizmo)
+	{
+		return;
+	}
+
+	list[gizmo->m_listIndex] = list.back();
+	list[gizmo->m_listIndex]->m_listIndex = gizmo->m_listIndex;
+	list.pop_back();
+
+	if (gizmo->m_static)
+	{
+		gizmo->m_gizmoType->m_staticModified = true;
 	}
+
+	auto poolIndex = gizmo->m_poolIndex;
+	m_pool[poolIndex].reset();
+	m_freeGizmos.emplace_back(poolIndex);
 }
 
 void Gizmos::Clear()
 {
+	for (auto &[type, typeGizmos] : m_gizmos)
+	{
+		type->m_staticModified = true;
+	}
+
 	m_gizmos.clear();
+	m_pool.clear();
+	m_freeGizmos.clear();
+}
+
+void Gizmos::DrawLine(const Vector3f &start, const Vector3f &end, const Colour &colour)
+{
+	std::lock_guard<std::mutex> lock(m_linesMutex);
+	m_lines.emplace_back(LineVertex{ start, colour });
+	m_lines.emplace_back(LineVertex{ end, colour });
+}
+
+void Gizmos::DrawBox(const Vector3f &min, const Vector3f &max, const Colour &colour)
+{
+	Vector3f corners[8];
+
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		corners[i] = Vector3f((i & 1) ? max.m_x : min.m_x, (i & 2) ? max.m_y : min.m_y, (i & 4) ? max.m_z : min.m_z);
+	}
+
+	// Each edge joins two corners that differ in one axis.
+	std::lock_guard<std::mutex> lock(m_linesMutex);
+
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		for (uint32_t axis = 1; axis < 8; axis <<= 1)
+		{
+			if ((i & axis) == 0)
+			{
+				m_lines.emplace_back(LineVertex{ corners[i], colour });
+				m_lines.emplace_back(LineVertex{ corners[i | axis], colour });
+			}
+		}
+	}
+}
+
+void Gizmos::DrawSphere(const Vector3f &centre, const float &radius, const Colour &colour)
+{
+	std::lock_guard<std::mutex> lock(m_linesMutex);
+
+	for (uint32_t axis = 0; axis < 3; axis++)
+	{
+		for (uint32_t i = 0; i < SPHERE_SEGMENTS; i++)
+		{
+			for (auto segment : { i, i + 1 })
+			{
+				auto angle = 2.0f * Maths::Pi * static_cast<float>(segment) / static_cast<float>(SPHERE_SEGMENTS);
+				auto a = radius * std::cos(angle);
+				auto b = radius * std::sin(angle);
+				auto offset = axis == 0 ? Vector3f(0.0f, a, b) : axis == 1 ? Vector3f(a, 0.0f, b) : Vector3f(a, b, 0.0f);
+				m_lines.emplace_back(LineVertex{ centre + offset, colour });
+			}
+		}
+	}
 }
 }
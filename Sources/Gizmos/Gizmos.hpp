@@ -1,5 +1,7 @@
 #pragma once
 
+#include <deque>
+#include <mutex>
 #include "Engine/Engine.hpp"
 #include "Gizmo.hpp"
 
@@ -7,11 +9,44 @@ namespace acid
 {
 /**
  * @brief Module used for that manages debug gizmos.
+ * Gizmos are kept in a pool owned by the module, lines drawn with the immediate functions are only shown for one frame.
  */
 class ACID_EXPORT Gizmos :
 	public Module
 {
 public:
+	/**
+	 * @brief A vertex of a immediate line.
+	 */
+	class LineVertex
+	{
+	public:
+		static Shader::VertexInput GetVertexInput(const uint32_t &baseBinding = 0)
+		{
+			std::vector<VkVertexInputBindingDescription> bindingDescriptions = { 
+				VkVertexInputBindingDescription{ baseBinding, sizeof(LineVertex), VK_VERTEX_INPUT_RATE_VERTEX }
+			};
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+				VkVertexInputAttributeDescription{ 0, baseBinding, VK_FORMAT_R32G32B32_SFLOAT, offsetof(LineVertex, m_position) },
+				VkVertexInputAttributeDescription{ 1, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(LineVertex, m_colour) }
+			};
+			return Shader::VertexInput(bindingDescriptions, attributeDescriptions);
+		}
+
+		Vector3f m_position;
+		Colour m_colour;
+	};
+
+	/**
+	 * @brief The gizmos of a type, static gizmos are written to the instance buffer separately from the others.
+	 */
+	class TypeGizmos
+	{
+	public:
+		std::vector<Gizmo *> m_staticGizmos;
+		std::vector<Gizmo *> m_dynamicGizmos;
+	};
+
 	/**
 	 * Gets the engines instance.
 	 * @return The current module instance.
@@ -22,6 +57,21 @@ public:
 
 	void Update() override;
 
+	/**
+	 * Creates a gizmo in the pool.
+	 * @param gizmoType The gizmo template to build from.
+	 * @param transform The gizmos initial transform.
+	 * @param colour The colour for this gizmo, without a value it will be set to the types default.
+	 * @param isStatic If the gizmo rarely changes, see {@link Gizmo#Gizmo}.
+	 * @return The gizmo, valid until it is removed or the gizmos are cleared.
+	 */
+	Gizmo *AddGizmo(const std::shared_ptr<GizmoType> &gizmoType, const Transform &transform, const std::optional<Colour> &colour = {}, const bool &isStatic = false);
+
+	/**
+	 * Moves a gizmo into the pool, the gizmo passed in is deleted.
+	 * @param gizmo The gizmo to add.
+	 * @return The gizmo in the pool.
+	 */
 	Gizmo *AddGizmo(Gizmo *gizmo);
 
 	void RemoveGizmo(Gizmo *gizmo);
@@ -31,13 +81,49 @@ public:
 	 */
 	void Clear();
 
+	/**
+	 * Draws a line for one frame, this is safe to call from multiple threads.
+	 * @param start The start of the line in world space.
+	 * @param end The end of the line in world space.
+	 * @param colour The colour of the line.
+	 */
+	void DrawLine(const Vector3f &start, const Vector3f &end, const Colour &colour = Colour::White);
+
+	/**
+	 * Draws the edges of a axis aligned box for one frame.
+	 * @param min The minimum corner of the box.
+	 * @param max The maximum corner of the box.
+	 * @param colour The colour of the lines.
+	 */
+	void DrawBox(const Vector3f &min, const Vector3f &max, const Colour &colour = Colour::White);
+
+	/**
+	 * Draws three circles around the axes of a sphere for one frame.
+	 * @param centre The centre of the sphere.
+	 * @param radius The radius of the sphere.
+	 * @param colour The colour of the lines.
+	 */
+	void DrawSphere(const Vector3f &centre, const float &radius, const Colour &colour = Colour::White);
+
 	/**
 	 * Gets a list of all gizmos.
 	 * @return All gizmods.
 	 */
-	const std::map<std::shared_ptr<GizmoType>, std::vector<std::unique_ptr<Gizmo>>> &GetGizmos() const { return m_gizmos; }
+	const std::map<std::shared_ptr<GizmoType>, TypeGizmos> &GetGizmos() const { return m_gizmos; }
+
+	/**
+	 * Gets the line vertices drawn before the last update, two for each line.
+	 * @return The line vertices.
+	 */
+	const std::vector<LineVertex> &GetLines() const { return m_frameLines; }
 
 private:
-	std::map<std::shared_ptr<GizmoType>, std::vector<std::unique_ptr<Gizmo>>> m_gizmos;
+	std::deque<std::optional<Gizmo>> m_pool;
+	std::vector<std::size_t> m_freeGizmos;
+	std::map<std::shared_ptr<GizmoType>, TypeGizmos> m_gizmos;
+
+	std::vector<LineVertex> m_lines;
+	std::vector<LineVertex> m_frameLines;
+	std::mutex m_linesMutex;
 };
 }
@@ -1,15 +1,24 @@
 #include "SubrenderGizmos.hpp"
 
+#include "Graphics/Graphics.hpp"
 #include "Models/VertexDefault.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Gizmos.hpp"
 
 namespace acid
 {
+static const uint32_t INITIAL_LINE_VERTICES = 8192;
+
+// Gizmos are drawn in Mrt mode so they write the entity they are drawn for when the subpass has a entity attachment, immediate lines belong to no entity.
 SubrenderGizmos::SubrenderGizmos(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
 	m_pipeline(pipelineStage, { "Shaders/Gizmos/Gizmo.vert", "Shaders/Gizmos/Gizmo.frag" }, { VertexDefault::GetVertexInput(0), GizmoType::Instance::GetVertexInput(1) }, {},
-		PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::ReadWrite, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_LINE, VK_CULL_MODE_NONE)
+		PipelineGraphics::Mode::Mrt, PipelineGraphics::Depth::ReadWrite, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_LINE, VK_CULL_MODE_NONE),
+	m_pipelineLines(pipelineStage, { "Shaders/Gizmos/Line.vert", "Shaders/Gizmos/Gizmo.frag" }, { Gizmos::LineVertex::GetVertexInput(0) }, {},
+		PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::ReadWrite, VK_PRIMITIVE_TOPOLOGY_LINE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE),
+	m_lineBuffer(nullptr),
+	m_maxLineVertices(INITIAL_LINE_VERTICES),
+	m_lineFrameCount(0)
 {
 }
 
@@ -27,5 +36,54 @@ void SubrenderGizmos::Render(const CommandBuffer &commandBuffer)
 	{
 		type->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
 	}
+
+	RenderLines(commandBuffer);
+}
+
+void SubrenderGizmos::RenderLines(const CommandBuffer &commandBuffer)
+{
+	auto &lines = Gizmos::Get()->GetLines();
+
+	if (lines.empty())
+	{
+		return;
+	}
+
+	auto frameCount = Graphics::Get()->GetFramesInFlight();
+
+	if (m_lineBuffer == nullptr || lines.size() > m_maxLineVertices || frameCount != m_lineFrameCount)
+	{
+		// The old buffer may still be read by frames in flight, it is destroyed once they have finished.
+		while (m_maxLineVertices < lines.size())
+		{
+			m_maxLineVertices *= 2;
+		}
+
+		m_lineFrameCount = frameCount;
+		m_lineBuffer = std::make_unique<InstanceBuffer>(sizeof(Gizmos::LineVertex) * m_maxLineVertices * m_lineFrameCount);
+	}
+
+	// The region written this frame is not read by the frames still in flight.
+	VkDeviceSize offset = sizeof(Gizmos::LineVertex) * m_maxLineVertices * Graphics::Get()->GetCurrentFrame();
+
+	char *data;
+	m_lineBuffer->MapMemory(reinterpret_cast<void **>(&data));
+	std::memcpy(data + offset, lines.data(), sizeof(Gizmos::LineVertex) * lines.size());
+	m_lineBuffer->UnmapMemory();
+
+	m_descriptorSetLines.Push("UniformScene", m_uniformScene);
+
+	if (!m_descriptorSetLines.Update(m_pipelineLines))
+	{
+		return;
+	}
+
+	m_pipelineLines.BindPipeline(commandBuffer);
+	m_descriptorSetLines.BindDescriptor(commandBuffer, m_pipelineLines);
+	vkCmdSetLineWidth(commandBuffer, 1.0f);
+
+	VkDeviceSize offsets[] = { offset };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_lineBuffer->GetBuffer(), offsets);
+	vkCmdDraw(commandBuffer, static_cast<uint32_t>(lines.size()), 1, 0, 0);
 }
 }
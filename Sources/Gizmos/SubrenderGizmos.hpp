@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/InstanceBuffer.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 
 namespace acid
@@ -15,7 +17,16 @@ public:
 	void Render(const CommandBuffer &commandBuffer) override;
 
 private:
+	void RenderLines(const CommandBuffer &commandBuffer);
+
 	PipelineGraphics m_pipeline;
+	PipelineGraphics m_pipelineLines;
 	UniformHandler m_uniformScene;
+
+	// Immediate lines are written to a ring with one region for each frame in flight.
+	DescriptorsHandler m_descriptorSetLines;
+	std::unique_ptr<InstanceBuffer> m_lineBuffer;
+	uint32_t m_maxLineVertices;
+	uint32_t m_lineFrameCount;
 };
 }
@@ -0,0 +1,90 @@
+#include "AccelerationStructure.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+AccelerationStructure::AccelerationStructure(const Type &type, const VkDeviceSize &size) :
+	Buffer(size, VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+	m_type(type),
+	m_accelerationStructure(VK_NULL_HANDLE),
+	m_structureAddress(0)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkAccelerationStructureCreateInfoKHR accelerationStructureCreateInfo = {};
+	accelerationStructureCreateInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+	accelerationStructureCreateInfo.buffer = m_buffer;
+	accelerationStructureCreateInfo.size = size;
+	accelerationStructureCreateInfo.type = type == Type::Bottom ? VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR : VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+	Graphics::CheckVk(Instance::FvkCreateAccelerationStructureKHR(*logicalDevice, &accelerationStructureCreateInfo, nullptr, &m_accelerationStructure));
+
+	m_structureAddress = Instance::FvkGetAccelerationStructureDeviceAddressKHR(*logicalDevice, m_accelerationStructure);
+}
+
+AccelerationStructure::~AccelerationStructure()
+{
+	// Frames in flight may still trace against the structure, it is retired before the buffer it is stored in.
+	Graphics::Get()->Retire([accelerationStructure = m_accelerationStructure]()
+	{
+		Instance::FvkDestroyAccelerationStructureKHR(*Graphics::Get()->GetLogicalDevice(), accelerationStructure, nullptr);
+	});
+}
+
+VkBufferUsageFlags AccelerationStructure::GetBuildInputUsage()
+{
+	if (!Graphics::Get()->GetLogicalDevice()->IsRayQuery())
+	{
+		return 0;
+	}
+
+	return VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR;
+}
+
+VkAccelerationStructureBuildSizesInfoKHR AccelerationStructure::GetBuildSizes(const VkAccelerationStructureBuildGeometryInfoKHR &buildInfo,
+	const uint32_t *primitiveCounts)
+{
+	VkAccelerationStructureBuildSizesInfoKHR buildSizesInfo = {};
+	buildSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+	Instance::FvkGetAccelerationStructureBuildSizesKHR(*Graphics::Get()->GetLogicalDevice(), &buildInfo, primitiveCounts, &buildSizesInfo);
+	return buildSizesInfo;
+}
+
+std::unique_ptr<Buffer> AccelerationStructure::CreateScratchBuffer(const VkDeviceSize &size)
+{
+	auto alignment = Graphics::Get()->GetLogicalDevice()->GetScratchAlignment();
+	return std::make_unique<Buffer>(size + alignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+VkDeviceAddress AccelerationStructure::GetScratchAddress(const Buffer &scratchBuffer)
+{
+	auto alignment = Graphics::Get()->GetLogicalDevice()->GetScratchAlignment();
+	return (scratchBuffer.GetDeviceAddress() + alignment - 1) / alignment * alignment;
+}
+
+VkDescriptorSetLayoutBinding AccelerationStructure::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType,
+	const VkShaderStageFlags &stage, const uint32_t &count)
+{
+	VkDescriptorSetLayoutBinding descriptorSetLayoutBinding = {};
+	descriptorSetLayoutBinding.binding = binding;
+	descriptorSetLayoutBinding.descriptorType = descriptorType;
+	descriptorSetLayoutBinding.descriptorCount = 1;
+	descriptorSetLayoutBinding.stageFlags = stage;
+	descriptorSetLayoutBinding.pImmutableSamplers = nullptr;
+	return descriptorSetLayoutBinding;
+}
+
+WriteDescriptorSet AccelerationStructure::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+	const std::optional<OffsetSize> &offsetSize) const
+{
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = VK_NULL_HANDLE; // Will be set in the descriptor handler.
+	descriptorWrite.dstBinding = binding;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.descriptorType = descriptorType;
+	return WriteDescriptorSet(descriptorWrite, m_accelerationStructure);
+}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Graphics/Descriptors/Descriptor.hpp"
+#include "Buffer.hpp"
+
+namespace acid
+{
+/**
+ * @brief A acceleration structure that ray queries trace against, and the buffer it is stored in.
+ * Bottom levels hold the triangles of a model, top levels hold instances of bottom levels and are bound to shaders.
+ */
+class ACID_EXPORT AccelerationStructure :
+	public Descriptor,
+	public Buffer
+{
+public:
+	enum class Type
+	{
+		Bottom, Top
+	};
+
+	/**
+	 * Creates a acceleration structure, its contents are written by a build.
+	 * @param type The level of the structure.
+	 * @param size The size of the structure in bytes, given by {@link AccelerationStructure#GetBuildSizes}.
+	 */
+	AccelerationStructure(const Type &type, const VkDeviceSize &size);
+
+	~AccelerationStructure();
+
+	/**
+	 * Gets the usage buffers read by acceleration structure builds are created with, such as vertex and index buffers.
+	 * @return The build input usage, zero if ray queries are not enabled.
+	 */
+	static VkBufferUsageFlags GetBuildInputUsage();
+
+	/**
+	 * Gets the sizes of a structure and of the scratch memory its build needs.
+	 * @param buildInfo The build, its geometries are only read for their type and flags.
+	 * @param primitiveCounts The most primitives in each geometry.
+	 * @return The build sizes.
+	 */
+	static VkAccelerationStructureBuildSizesInfoKHR GetBuildSizes(const VkAccelerationStructureBuildGeometryInfoKHR &buildInfo, const uint32_t *primitiveCounts);
+
+	/**
+	 * Creates a buffer of scratch memory for builds, large enough for its address to be aligned.
+	 * @param size The scratch size of the build.
+	 * @return The scratch buffer.
+	 */
+	static std::unique_ptr<Buffer> CreateScratchBuffer(const VkDeviceSize &size);
+
+	/**
+	 * Gets the aligned address of a scratch buffer created by {@link AccelerationStructure#CreateScratchBuffer}.
+	 * @param scratchBuffer The scratch buffer.
+	 * @return The scratch address.
+	 */
+	static VkDeviceAddress GetScratchAddress(const Buffer &scratchBuffer);
+
+	static VkDescriptorSetLayoutBinding GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage,
+		const uint32_t &count);
+
+	WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
+
+	const Type &GetType() const { return m_type; }
+
+	const VkAccelerationStructureKHR &GetAccelerationStructure() const { return m_accelerationStructure; }
+
+	/**
+	 * Gets the address of the structure on the device, instances of a top level refer to bottom levels by it.
+	 * @return The device address.
+	 */
+	const VkDeviceAddress &GetStructureAddress() const { return m_structureAddress; }
+
+private:
+	Type m_type;
+	VkAccelerationStructureKHR m_accelerationStructure;
+	VkDeviceAddress m_structureAddress;
+};
+}
@@ -4,18 +4,24 @@
 
 namespace acid
 {
-Buffer::Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const VkMemoryPropertyFlags &properties, const void *data) :
+Buffer::Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const VkMemoryPropertyFlags &properties, const void *data,
+	const MemoryAllocator::Lifetime &lifetime) :
 	m_size(size),
-	m_buffer(VK_NULL_HANDLE),
-	m_bufferMemory(VK_NULL_HANDLE)
+	m_buffer(VK_NULL_HANDLE)
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
 	auto graphicsFamily = logicalDevice->GetGraphicsFamily();
-	auto presentFamily = logicalDevice->GetPresentFamily();
 	auto computeFamily = logicalDevice->GetComputeFamily();
+	auto transferFamily = logicalDevice->GetTransferFamily();
 
-	std::array<uint32_t, 3> queueFamily = { graphicsFamily, presentFamily, computeFamily };
+	// Staging buffers are also read by a transfer family.
+	std::vector<uint32_t> queueFamily = { graphicsFamily, computeFamily };
+
+	if (transferFamily != graphicsFamily && transferFamily != computeFamily)
+	{
+		queueFamily.emplace_back(transferFamily);
+	}
 
 	// Create the buffer handle.
 	VkBufferCreateInfo bufferCreateInfo = {};
@@ -23,19 +29,21 @@ Buffer::Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const
 	bufferCreateInfo.size = size;
 	bufferCreateInfo.usage = usage;
 	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-	bufferCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamily.size());
-	bufferCreateInfo.pQueueFamilyIndices = queueFamily.data();
+
+	// Buffers are shared with a async compute family, so compute results can be read by rendering without ownership transfers.
+	if (logicalDevice->IsAsyncCompute())
+	{
+		bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		bufferCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamily.size());
+		bufferCreateInfo.pQueueFamilyIndices = queueFamily.data();
+	}
 	Graphics::CheckVk(vkCreateBuffer(*logicalDevice, &bufferCreateInfo, nullptr, &m_buffer));
 
 	// Create the memory backing up the buffer handle.
 	VkMemoryRequirements memoryRequirements;
 	vkGetBufferMemoryRequirements(*logicalDevice, m_buffer, &memoryRequirements);
 
-	VkMemoryAllocateInfo memoryAllocateInfo = {};
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.allocationSize = memoryRequirements.size;
-	memoryAllocateInfo.memoryTypeIndex = FindMemoryType(memoryRequirements.memoryTypeBits, properties);
-	Graphics::CheckVk(vkAllocateMemory(*logicalDevice, &memoryAllocateInfo, nullptr, &m_bufferMemory));
+	m_allocation = Graphics::Get()->GetMemoryAllocator()->Allocate(memoryRequirements, properties, true, lifetime);
 
 	// If a pointer to the buffer data has been passed, map the buffer and copy over the data.
 	if (data != nullptr)
@@ -43,64 +51,42 @@ Buffer::Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const
 		void *mapped;
 		MapMemory(&mapped);
 		std::memcpy(mapped, data, size);
-
-		// If host coherency hasn't been requested, do a manual flush to make writes visible.
-		if ((properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
-		{
-			VkMappedMemoryRange mappedMemoryRange = {};
-			mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-			mappedMemoryRange.memory = m_bufferMemory;
-			mappedMemoryRange.offset = 0;
-			mappedMemoryRange.size = size;
-			vkFlushMappedMemoryRanges(*logicalDevice, 1, &mappedMemoryRange);
-		}
-
 		UnmapMemory();
 	}
 
 	// Attach the memory to the buffer object.
-	Graphics::CheckVk(vkBindBufferMemory(*logicalDevice, m_buffer, m_bufferMemory, 0));
+	Graphics::CheckVk(vkBindBufferMemory(*logicalDevice, m_buffer, m_allocation.GetMemory(), m_allocation.GetOffset()));
 }
 
 Buffer::~Buffer()
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	// Frames in flight may still read the buffer.
+	Graphics::Get()->Retire([buffer = m_buffer, allocation = m_allocation]() mutable
+	{
+		vkDestroyBuffer(*Graphics::Get()->GetLogicalDevice(), buffer, nullptr);
+		Graphics::Get()->GetMemoryAllocator()->Free(allocation);
+	});
+}
 
-	vkDestroyBuffer(*logicalDevice, m_buffer, nullptr);
-	vkFreeMemory(*logicalDevice, m_bufferMemory, nullptr);
+VkDeviceAddress Buffer::GetDeviceAddress() const
+{
+	return Instance::FvkGetBufferDeviceAddressKHR(*Graphics::Get()->GetLogicalDevice(), m_buffer);
 }
 
 void Buffer::MapMemory(void **data)
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-	Graphics::CheckVk(vkMapMemory(*logicalDevice, GetBufferMemory(), 0, m_size, 0, data));
+	// Host visible blocks stay mapped for the allocators lifetime.
+	*data = m_allocation.GetMapped();
 }
 
 void Buffer::UnmapMemory()
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-	vkUnmapMemory(*logicalDevice, GetBufferMemory());
+	// If host coherency hasn't been requested, do a manual flush to make writes visible.
+	Graphics::Get()->GetMemoryAllocator()->Flush(m_allocation);
 }
 
 uint32_t Buffer::FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties)
 {
-	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
-	auto memoryProperties = physicalDevice->GetMemoryProperties();
-
-	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
-	{
-		uint32_t memoryTypeBits = 1 << i;
-		bool isRequiredMemoryType = typeFilter & memoryTypeBits;
-
-		auto properties = memoryProperties.memoryTypes[i].propertyFlags;
-		bool hasRequiredProperties = (properties & requiredProperties) == requiredProperties;
-
-		if (isRequiredMemoryType && hasRequiredProperties)
-		{
-			return i;
-		}
-	}
-
-	throw std::runtime_error("Failed to find a valid memory type for buffer");
+	return Graphics::Get()->GetMemoryAllocator()->FindMemoryType(typeFilter, requiredProperties);
 }
 }
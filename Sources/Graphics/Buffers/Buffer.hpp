@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.h>
 #include "Graphics/Descriptors/DescriptorSet.hpp"
+#include "Graphics/Memory/MemoryAllocator.hpp"
 
 namespace acid
 {
@@ -22,8 +23,10 @@ public:
 	 * @param usage Usage flag bitmask for the buffer (i.e. index, vertex, uniform buffer).
 	 * @param properties Memory properties for this buffer (i.e. device local, host visible, coherent).
 	 * @param data Pointer to the data that should be copied to the buffer after creation (optional, if not set, no data is copied over).
+	 * @param lifetime If the buffer will be destroyed shortly after creation (i.e. staging buffers).
 	 */
-	Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const VkMemoryPropertyFlags &properties, const void *data = nullptr);
+	Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const VkMemoryPropertyFlags &properties, const void *data = nullptr,
+		const MemoryAllocator::Lifetime &lifetime = MemoryAllocator::Lifetime::Persistent);
 
 	virtual ~Buffer();
 
@@ -35,13 +38,21 @@ public:
 
 	const VkBuffer &GetBuffer() const { return m_buffer; }
 
-	const VkDeviceMemory &GetBufferMemory() const { return m_bufferMemory; }
+	/**
+	 * Gets the address of the buffer on the device, the buffer must be created with the shader device address usage.
+	 * @return The device address.
+	 */
+	VkDeviceAddress GetDeviceAddress() const;
+
+	const VkDeviceMemory &GetBufferMemory() const { return m_allocation.GetMemory(); }
+
+	const MemoryAllocation &GetAllocation() const { return m_allocation; }
 
 	static uint32_t FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties);
 
 protected:
 	VkDeviceSize m_size;
 	VkBuffer m_buffer;
-	VkDeviceMemory m_bufferMemory;
+	MemoryAllocation m_allocation;
 };
 }
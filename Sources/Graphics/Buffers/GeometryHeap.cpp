@@ -0,0 +1,164 @@
+#include "GeometryHeap.hpp"
+
+#include "Graphics/Buffers/AccelerationStructure.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+GeometryHeap::GeometryHeap(const uint32_t &vertexSize, const VkIndexType &indexType, const uint32_t &vertexCapacity, const uint32_t &indexCapacity) :
+	m_vertexSize(vertexSize),
+	m_indexType(indexType),
+	m_vertexBuffer(static_cast<VkDeviceSize>(vertexSize) * vertexCapacity, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+		AccelerationStructure::GetBuildInputUsage(), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+	m_indexBuffer(static_cast<VkDeviceSize>(GetIndexSize(indexType)) * indexCapacity, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+		AccelerationStructure::GetBuildInputUsage(), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+	m_vertexRanges(vertexCapacity),
+	m_indexRanges(indexCapacity)
+{
+}
+
+std::optional<GeometryHeap::Allocation> GeometryHeap::Allocate(const void *vertices, const uint32_t &vertexCount, const void *indices, const uint32_t &indexCount)
+{
+	if (vertexCount == 0)
+	{
+		return std::nullopt;
+	}
+
+	Allocation allocation;
+	allocation.m_vertexCount = vertexCount;
+	allocation.m_indexCount = indexCount;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Retire();
+
+		auto vertexOffset = m_vertexRanges.Allocate(vertexCount);
+
+		if (!vertexOffset)
+		{
+			return std::nullopt;
+		}
+
+		if (indexCount != 0)
+		{
+			auto firstIndex = m_indexRanges.Allocate(indexCount);
+
+			if (!firstIndex)
+			{
+				m_vertexRanges.Free(*vertexOffset, vertexCount);
+				return std::nullopt;
+			}
+
+			allocation.m_firstIndex = *firstIndex;
+		}
+
+		allocation.m_vertexOffset = *vertexOffset;
+	}
+
+	CmdUpload(m_vertexBuffer, vertices, static_cast<VkDeviceSize>(m_vertexSize) * allocation.m_vertexOffset, static_cast<VkDeviceSize>(m_vertexSize) * vertexCount);
+
+	if (indexCount != 0)
+	{
+		auto indexSize = static_cast<VkDeviceSize>(GetIndexSize(m_indexType));
+		CmdUpload(m_indexBuffer, indices, indexSize * allocation.m_firstIndex, indexSize * indexCount);
+	}
+
+	return allocation;
+}
+
+void GeometryHeap::Free(const Allocation &allocation)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_pendingFrees.emplace_back(PendingFree{ allocation, Graphics::Get()->GetFrameCount() });
+	Retire();
+}
+
+void GeometryHeap::CmdBind(const CommandBuffer &commandBuffer) const
+{
+	VkBuffer vertexBuffers[] = { m_vertexBuffer.GetBuffer() };
+	VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+	vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer.GetBuffer(), 0, m_indexType);
+}
+
+void GeometryHeap::Retire()
+{
+	// The frame being recorded when the range was freed may still draw from it, its fence has been waited on once more frames than are in flight have been recorded since.
+	auto graphics = Graphics::Get();
+
+	while (!m_pendingFrees.empty() && m_pendingFrees.front().m_frame + graphics->GetFramesInFlight() < graphics->GetFrameCount())
+	{
+		auto &allocation = m_pendingFrees.front().m_allocation;
+		m_vertexRanges.Free(allocation.m_vertexOffset, allocation.m_vertexCount);
+
+		if (allocation.m_indexCount != 0)
+		{
+			m_indexRanges.Free(allocation.m_firstIndex, allocation.m_indexCount);
+		}
+
+		m_pendingFrees.pop_front();
+	}
+}
+
+void GeometryHeap::CmdUpload(const Buffer &buffer, const void *data, const VkDeviceSize &offset, const VkDeviceSize &size)
+{
+	Graphics::Get()->GetUploadContext()->Record(data, size, [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+	{
+		VkBufferCopy copyRegion = {};
+		copyRegion.dstOffset = offset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(commandBuffer, bufferStaging.GetBuffer(), buffer.GetBuffer(), 1, &copyRegion);
+	});
+}
+
+GeometryHeap::FreeList::FreeList(const uint32_t &capacity)
+{
+	m_ranges.emplace(0, capacity);
+}
+
+std::optional<uint32_t> GeometryHeap::FreeList::Allocate(const uint32_t &count)
+{
+	// The first range large enough is split, so small allocations pack towards the start of the buffer.
+	for (auto it = m_ranges.begin(); it != m_ranges.end(); ++it)
+	{
+		auto [offset, size] = *it;
+
+		if (size < count)
+		{
+			continue;
+		}
+
+		m_ranges.erase(it);
+
+		if (size > count)
+		{
+			m_ranges.emplace(offset + count, size - count);
+		}
+
+		return offset;
+	}
+
+	return std::nullopt;
+}
+
+void GeometryHeap::FreeList::Free(const uint32_t &offset, const uint32_t &count)
+{
+	auto it = m_ranges.emplace(offset, count).first;
+
+	if (auto next = std::next(it); next != m_ranges.end() && it->first + it->second == next->first)
+	{
+		it->second += next->second;
+		m_ranges.erase(next);
+	}
+
+	if (it != m_ranges.begin())
+	{
+		if (auto previous = std::prev(it); previous->first + previous->second == it->first)
+		{
+			previous->second += it->second;
+			m_ranges.erase(it);
+		}
+	}
+}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <deque>
+#include "Helpers/NonCopyable.hpp"
+#include "Graphics/Commands/CommandBuffer.hpp"
+#include "Buffer.hpp"
+
+namespace acid
+{
+/**
+ * @brief A vertex and index buffer shared by many models of one vertex size and index type, each model is given a range of vertices and indices within them.
+ * Draws of models from the same heap bind the buffers once and select their geometry with the first index and vertex offset of the draw.
+ */
+class ACID_EXPORT GeometryHeap :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief The ranges of a heap given to one model, indices are relative to the first vertex.
+	 */
+	class Allocation
+	{
+	public:
+		uint32_t m_firstIndex = 0;
+		uint32_t m_indexCount = 0;
+		uint32_t m_vertexOffset = 0;
+		uint32_t m_vertexCount = 0;
+	};
+
+	/**
+	 * Creates a new geometry heap.
+	 * @param vertexSize The size of one vertex in bytes.
+	 * @param indexType The type of the indices.
+	 * @param vertexCapacity The number of vertices the heap holds.
+	 * @param indexCapacity The number of indices the heap holds.
+	 */
+	GeometryHeap(const uint32_t &vertexSize, const VkIndexType &indexType, const uint32_t &vertexCapacity = 1 << 20, const uint32_t &indexCapacity = 1 << 22);
+
+	/**
+	 * Finds space for geometry and copies it in, the copy is recorded into the {@link UploadContext} ahead of the next frame.
+	 * @param vertices The vertices, each of the heaps vertex size.
+	 * @param vertexCount The number of vertices.
+	 * @param indices The indices of the heaps index type, relative to the first vertex.
+	 * @param indexCount The number of indices.
+	 * @return The allocation, or nothing if the heap does not have space.
+	 */
+	std::optional<Allocation> Allocate(const void *vertices, const uint32_t &vertexCount, const void *indices, const uint32_t &indexCount);
+
+	/**
+	 * Returns a allocation to the heap, the space is reused once the frames that may still draw from it have completed.
+	 * @param allocation The allocation.
+	 */
+	void Free(const Allocation &allocation);
+
+	/**
+	 * Binds the vertex buffer to the first binding, and the index buffer.
+	 * @param commandBuffer The command buffer to write to.
+	 */
+	void CmdBind(const CommandBuffer &commandBuffer) const;
+
+	const uint32_t &GetVertexSize() const { return m_vertexSize; }
+
+	const VkIndexType &GetIndexType() const { return m_indexType; }
+
+	/**
+	 * Gets the size of one index of a type.
+	 * @param indexType The index type.
+	 * @return The size in bytes.
+	 */
+	static uint32_t GetIndexSize(const VkIndexType &indexType) { return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+	const Buffer *GetVertexBuffer() const { return &m_vertexBuffer; }
+
+	const Buffer *GetIndexBuffer() const { return &m_indexBuffer; }
+
+private:
+	/**
+	 * @brief Free ranges of a buffer, ordered by offset so neighbouring ranges are merged when freed.
+	 */
+	class FreeList
+	{
+	public:
+		explicit FreeList(const uint32_t &capacity);
+
+		std::optional<uint32_t> Allocate(const uint32_t &count);
+
+		void Free(const uint32_t &offset, const uint32_t &count);
+
+	private:
+		std::map<uint32_t, uint32_t> m_ranges;
+	};
+
+	class PendingFree
+	{
+	public:
+		Allocation m_allocation;
+		uint64_t m_frame;
+	};
+
+	void Retire();
+
+	static void CmdUpload(const Buffer &buffer, const void *data, const VkDeviceSize &offset, const VkDeviceSize &size);
+
+	uint32_t m_vertexSize;
+	VkIndexType m_indexType;
+	Buffer m_vertexBuffer;
+	Buffer m_indexBuffer;
+
+	std::mutex m_mutex;
+	FreeList m_vertexRanges;
+	FreeList m_indexRanges;
+	std::deque<PendingFree> m_pendingFrees;
+};
+}
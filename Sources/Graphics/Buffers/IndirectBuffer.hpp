@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Graphics/Descriptors/Descriptor.hpp"
+#include "Buffer.hpp"
+
+namespace acid
+{
+/**
+ * @brief Buffer that holds the arguments of indirect draw commands, it can also be bound as a storage buffer so compute shaders can write the arguments.
+ */
+class ACID_EXPORT IndirectBuffer :
+	public Descriptor,
+	public Buffer
+{
+public:
+	explicit IndirectBuffer(const VkDeviceSize &size);
+
+	void Update(const void *newData);
+
+	WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
+};
+}
@@ -4,6 +4,7 @@ namespace acid
 {
 PushHandler::PushHandler(const bool &multipipeline) :
 	m_multipipeline(multipipeline),
+	m_source(nullptr),
 	m_data(nullptr)
 {
 }
@@ -11,16 +12,20 @@ PushHandler::PushHandler(const bool &multipipeline) :
 PushHandler::PushHandler(const Shader::UniformBlock &uniformBlock, const bool &multipipeline) :
 	m_multipipeline(multipipeline),
 	m_uniformBlock(uniformBlock),
+	m_source(nullptr),
 	m_data(std::make_unique<char[]>(m_uniformBlock->GetSize()))
 {
 }
 
-bool PushHandler::Update(const std::optional<Shader::UniformBlock> &uniformBlock)
+bool PushHandler::Update(const Shader::UniformBlock *uniformBlock)
 {
-	if ((m_multipipeline && !m_uniformBlock) || (!m_multipipeline && m_uniformBlock != uniformBlock))
+	auto changed = uniformBlock != m_source && (m_uniformBlock.has_value() != (uniformBlock != nullptr) || (uniformBlock && *m_uniformBlock != *uniformBlock));
+	m_source = uniformBlock;
+
+	if ((m_multipipeline && !m_uniformBlock) || (!m_multipipeline && changed))
 	{
-		m_uniformBlock = uniformBlock;
-		m_data = std::make_unique<char[]>(m_uniformBlock->GetSize());
+		m_uniformBlock = uniformBlock ? std::make_optional(*uniformBlock) : std::nullopt;
+		m_data = m_uniformBlock ? std::make_unique<char[]>(m_uniformBlock->GetSize()) : nullptr;
 		return false;
 	}
 
@@ -29,6 +34,11 @@ bool PushHandler::Update(const std::optional<Shader::UniformBlock> &uniformBlock
 
 void PushHandler::BindPush(const CommandBuffer &commandBuffer, const Pipeline &pipeline)
 {
+	if (!m_uniformBlock)
+	{
+		return;
+	}
+
 	vkCmdPushConstants(commandBuffer, pipeline.GetPipelineLayout(), m_uniformBlock->GetStageFlags(), 0, static_cast<uint32_t>(m_uniformBlock->GetSize()), m_data.get());
 }
 }
@@ -21,14 +21,14 @@ public:
 	}
 
 	template<typename T>
-	void Push(const std::string &uniformName, const T &object, const std::size_t &size = 0)
+	void Push(const UniformId &uniformId, const T &object, const std::size_t &size = 0)
 	{
 		if (!m_uniformBlock)
 		{
 			return;
 		}
 
-		auto uniform = m_uniformBlock->GetUniform(uniformName);
+		auto uniform = m_uniformBlock->FindUniform(uniformId);
 
 		if (!uniform)
 		{
@@ -45,13 +45,20 @@ public:
 		Push(object, static_cast<std::size_t>(uniform->GetOffset()), realSize);
 	}
 
-	bool Update(const std::optional<Shader::UniformBlock> &uniformBlock);
+	/**
+	 * Updates the handler for the uniform block of a pipeline.
+	 * @param uniformBlock The uniform block, owned by the pipelines shader.
+	 * @return If the handler was already set up for the block.
+	 */
+	bool Update(const Shader::UniformBlock *uniformBlock);
 
 	void BindPush(const CommandBuffer &commandBuffer, const Pipeline &pipeline);
 
 private:
 	bool m_multipipeline;
 	std::optional<Shader::UniformBlock> m_uniformBlock;
+	// The block last updated with, blocks are only compared when this changes.
+	const Shader::UniformBlock *m_source;
 	std::unique_ptr<char[]> m_data;
 };
 }
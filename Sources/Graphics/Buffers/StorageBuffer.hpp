@@ -11,7 +11,15 @@ class ACID_EXPORT StorageBuffer :
 	public Buffer
 {
 public:
-	explicit StorageBuffer(const VkDeviceSize &size, const void *data = nullptr);
+	/**
+	 * Creates a new storage buffer.
+	 * @param size The size of the buffer in bytes.
+	 * @param data The initial data, this requires the buffer to be host visible.
+	 * @param properties The memory properties, buffers only written and read by shaders can be device local.
+	 * @param usage Usages added to the storage usage, such as a vertex buffer that shaders also read.
+	 */
+	explicit StorageBuffer(const VkDeviceSize &size, const void *data = nullptr,
+		const VkMemoryPropertyFlags &properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, const VkBufferUsageFlags &usage = 0);
 
 	void Update(const void *newData);
 
@@ -4,6 +4,7 @@ namespace acid
 {
 StorageHandler::StorageHandler(const bool &multipipeline) :
 	m_multipipeline(multipipeline),
+	m_source(nullptr),
 	m_size(0),
 	m_data(nullptr),
 	m_storageBuffer(nullptr),
@@ -14,6 +15,7 @@ StorageHandler::StorageHandler(const bool &multipipeline) :
 StorageHandler::StorageHandler(const Shader::UniformBlock &uniformBlock, const bool &multipipeline) :
 	m_multipipeline(multipipeline),
 	m_uniformBlock(uniformBlock),
+	m_source(nullptr),
 	m_size(static_cast<uint32_t>(m_uniformBlock->GetSize())),
 	m_data(std::make_unique<char[]>(m_size)),
 	m_storageBuffer(std::make_unique<StorageBuffer>(static_cast<VkDeviceSize>(m_size))),
@@ -21,16 +23,19 @@ StorageHandler::StorageHandler(const Shader::UniformBlock &uniformBlock, const b
 {
 }
 
-bool StorageHandler::Update(const std::optional<Shader::UniformBlock> &uniformBlock)
+bool StorageHandler::Update(const Shader::UniformBlock *uniformBlock)
 {
-	if (m_handlerStatus == Buffer::Status::Reset || (m_multipipeline && !m_uniformBlock) || (!m_multipipeline && m_uniformBlock != uniformBlock))
+	auto changed = uniformBlock != m_source && (m_uniformBlock.has_value() != (uniformBlock != nullptr) || (uniformBlock && *m_uniformBlock != *uniformBlock));
+	m_source = uniformBlock;
+
+	if (m_handlerStatus == Buffer::Status::Reset || (m_multipipeline && !m_uniformBlock) || (!m_multipipeline && changed))
 	{
-		if ((m_size == 0 && !m_uniformBlock) || (m_uniformBlock && m_uniformBlock != uniformBlock && static_cast<uint32_t>(m_uniformBlock->GetSize()) == m_size))
+		if (uniformBlock && ((m_size == 0 && !m_uniformBlock) || (m_uniformBlock && changed && static_cast<uint32_t>(m_uniformBlock->GetSize()) == m_size)))
 		{
 			m_size = static_cast<uint32_t>(uniformBlock->GetSize());
 		}
 
-		m_uniformBlock = uniformBlock;
+		m_uniformBlock = uniformBlock ? std::make_optional(*uniformBlock) : std::nullopt;
 		m_data = std::make_unique<char[]>(m_size);
 		m_storageBuffer = std::make_unique<StorageBuffer>(static_cast<VkDeviceSize>(m_size));
 		m_handlerStatus = Buffer::Status::Changed;
@@ -17,6 +17,14 @@ void UniformBuffer::Update(const void *newData)
 	Buffer::UnmapMemory();
 }
 
+void UniformBuffer::Update(const void *newData, const VkDeviceSize &offset, const VkDeviceSize &size)
+{
+	void *data;
+	Buffer::MapMemory(&data);
+	std::memcpy(static_cast<char *>(data) + offset, static_cast<const char *>(newData) + offset, static_cast<std::size_t>(size));
+	Buffer::UnmapMemory();
+}
+
 VkDescriptorSetLayoutBinding UniformBuffer::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage,
 	const uint32_t &count)
 {
@@ -15,6 +15,14 @@ public:
 
 	void Update(const void *newData);
 
+	/**
+	 * Copies a range of data into the buffer.
+	 * @param newData The data of the whole buffer, only the range is read.
+	 * @param offset The offset of the range in bytes.
+	 * @param size The size of the range in bytes.
+	 */
+	void Update(const void *newData, const VkDeviceSize &offset, const VkDeviceSize &size);
+
 	static VkDescriptorSetLayoutBinding GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage,
 		const uint32_t &count);
 
@@ -1,48 +1,111 @@
 #include "UniformHandler.hpp"
 
+#include "Graphics/Graphics.hpp"
+#include "UniformRing.hpp"
+
 namespace acid
 {
 UniformHandler::UniformHandler(const bool &multipipeline) :
 	m_multipipeline(multipipeline),
+	m_source(nullptr),
 	m_size(0),
 	m_data(nullptr),
-	m_uniformBuffer(nullptr),
-	m_handlerStatus(Buffer::Status::Normal)
+	m_handlerStatus(Buffer::Status::Normal),
+	m_dirtyBegin(std::numeric_limits<uint32_t>::max()),
+	m_dirtyEnd(0),
+	m_blockReported(false),
+	m_descriptor(nullptr),
+	m_offset(0),
+	m_frameId(std::numeric_limits<uint64_t>::max()),
+	m_uniformBuffer(nullptr)
 {
 }
 
 UniformHandler::UniformHandler(const Shader::UniformBlock &uniformBlock, const bool &multipipeline) :
 	m_multipipeline(multipipeline),
 	m_uniformBlock(uniformBlock),
+	m_source(nullptr),
 	m_size(static_cast<uint32_t>(m_uniformBlock->GetSize())),
 	m_data(std::make_unique<char[]>(m_size)),
-	m_uniformBuffer(std::make_unique<UniformBuffer>(static_cast<VkDeviceSize>(m_size))),
-	m_handlerStatus(Buffer::Status::Normal)
+	m_handlerStatus(Buffer::Status::Changed),
+	m_dirtyBegin(std::numeric_limits<uint32_t>::max()),
+	m_dirtyEnd(0),
+	m_blockReported(false),
+	m_descriptor(nullptr),
+	m_offset(0),
+	m_frameId(std::numeric_limits<uint64_t>::max()),
+	m_uniformBuffer(nullptr)
 {
 }
 
-bool UniformHandler::Update(const std::optional<Shader::UniformBlock> &uniformBlock)
+bool UniformHandler::Update(const Shader::UniformBlock *uniformBlock)
 {
-	if (m_handlerStatus == Buffer::Status::Reset || (m_multipipeline && !m_uniformBlock) || (!m_multipipeline && m_uniformBlock != uniformBlock))
+	auto reset = false;
+
+	// Blocks are only compared when the handler is given a different block than last time, a handler used by one pipeline compares a pointer each frame.
+	auto changed = uniformBlock != m_source && (m_uniformBlock.has_value() != (uniformBlock != nullptr) || (uniformBlock && *m_uniformBlock != *uniformBlock));
+	m_source = uniformBlock;
+
+	if (m_handlerStatus == Buffer::Status::Reset || (m_multipipeline && !m_uniformBlock) || (!m_multipipeline && changed))
 	{
-		if ((m_size == 0 && !m_uniformBlock) || (m_uniformBlock && m_uniformBlock != uniformBlock && static_cast<uint32_t>(m_uniformBlock->GetSize()) == m_size))
+		if (uniformBlock && ((m_size == 0 && !m_uniformBlock) || (m_uniformBlock && changed && static_cast<uint32_t>(m_uniformBlock->GetSize()) == m_size)))
 		{
 			m_size = static_cast<uint32_t>(uniformBlock->GetSize());
 		}
 
-		m_uniformBlock = uniformBlock;
+		m_uniformBlock = uniformBlock ? std::make_optional(*uniformBlock) : std::nullopt;
 		m_data = std::make_unique<char[]>(m_size);
-		m_uniformBuffer = std::make_unique<UniformBuffer>(static_cast<VkDeviceSize>(m_size));
+		m_uniformBuffer = nullptr;
 		m_handlerStatus = Buffer::Status::Changed;
-		return false;
+		m_blockReported = false;
+		reset = true;
 	}
 
-	if (m_handlerStatus != Buffer::Status::Normal)
+	if (m_size == 0)
+	{
+		return !reset;
+	}
+
+	auto uniformRing = Graphics::Get()->GetUniformRing();
+
+	// Regions of the ring are reused once their frame has finished, so the data is copied into each frame it is used in.
+	if (m_handlerStatus != Buffer::Status::Normal || (uniformRing != nullptr && m_frameId != uniformRing->GetFrameId()))
 	{
-		m_uniformBuffer->Update(m_data.get());
+		if (uniformRing != nullptr && uniformRing->Allocate(m_data.get(), m_size, m_offset))
+		{
+			m_descriptor = uniformRing;
+			m_frameId = uniformRing->GetFrameId();
+		}
+		else
+		{
+			// The fallback buffer keeps its data between frames, so once it holds the last copy only the changed range is copied.
+			if (m_uniformBuffer != nullptr && m_descriptor == m_uniformBuffer.get())
+			{
+				if (m_dirtyBegin < m_dirtyEnd)
+				{
+					m_uniformBuffer->Update(m_data.get(), m_dirtyBegin, m_dirtyEnd - m_dirtyBegin);
+				}
+			}
+			else
+			{
+				if (m_uniformBuffer == nullptr)
+				{
+					m_uniformBuffer = std::make_unique<UniformBuffer>(static_cast<VkDeviceSize>(m_size));
+				}
+
+				m_uniformBuffer->Update(m_data.get());
+			}
+
+			m_descriptor = m_uniformBuffer.get();
+			m_offset = 0;
+			m_frameId = uniformRing != nullptr ? uniformRing->GetFrameId() : std::numeric_limits<uint64_t>::max();
+		}
+
 		m_handlerStatus = Buffer::Status::Normal;
+		m_dirtyBegin = std::numeric_limits<uint32_t>::max();
+		m_dirtyEnd = 0;
 	}
 
-	return true;
+	return !reset;
 }
 }
@@ -5,7 +5,7 @@
 namespace acid
 {
 /**
- * @brief Class that handles a uniform buffer.
+ * @brief Class that handles a uniform buffer, the data is copied into the {@link UniformRing} once per frame or when it changes.
  */
 class ACID_EXPORT UniformHandler
 {
@@ -21,18 +21,50 @@ public:
 		{
 			std::memcpy(m_data.get() + offset, &object, size);
 			m_handlerStatus = Buffer::Status::Changed;
+			m_dirtyBegin = std::min(m_dirtyBegin, static_cast<uint32_t>(offset));
+			m_dirtyEnd = std::max(m_dirtyEnd, static_cast<uint32_t>(offset + size));
 		}
 	}
 
+	/**
+	 * Pushes the whole uniform block from a struct with the std140 layout of the block, so the block is compared and copied once instead of once per uniform.
+	 * The struct is checked against the size of the reflected block, a struct that does not match is reported once and not pushed.
+	 * @tparam T The block struct type.
+	 * @param block The block struct.
+	 */
 	template<typename T>
-	void Push(const std::string &uniformName, const T &object, const std::size_t &size = 0)
+	void PushBlock(const T &block)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Uniform block structs must be trivially copyable");
+
+		if (!m_uniformBlock)
+		{
+			return;
+		}
+
+		if (sizeof(T) != m_size)
+		{
+			if (!m_blockReported)
+			{
+				Log::Error("Uniform block struct of size %zu does not match the uniform block of size %u\n", sizeof(T), m_size);
+				m_blockReported = true;
+			}
+
+			return;
+		}
+
+		Push(block, 0, sizeof(T));
+	}
+
+	template<typename T>
+	void Push(const UniformId &uniformId, const T &object, const std::size_t &size = 0)
 	{
 		if (!m_uniformBlock)
 		{
 			return;
 		}
 
-		auto uniform = m_uniformBlock->GetUniform(uniformName);
+		auto uniform = m_uniformBlock->FindUniform(uniformId);
 
 		if (!uniform)
 		{
@@ -49,16 +81,44 @@ public:
 		Push(object, static_cast<std::size_t>(uniform->GetOffset()), realSize);
 	}
 
-	bool Update(const std::optional<Shader::UniformBlock> &uniformBlock);
+	/**
+	 * Updates the handler for the uniform block of a pipeline.
+	 * @param uniformBlock The uniform block, owned by the pipelines shader.
+	 * @return If the handler was already set up for the block.
+	 */
+	bool Update(const Shader::UniformBlock *uniformBlock);
 
-	const UniformBuffer *GetUniformBuffer() const { return m_uniformBuffer.get(); }
+	/**
+	 * Gets the descriptor holding this frames copy of the data, this is the uniform ring unless it was full.
+	 * @return The uniform descriptor.
+	 */
+	const Descriptor *GetDescriptor() const { return m_descriptor; }
+
+	/**
+	 * Gets the offset of this frames copy of the data into the descriptor.
+	 * @return The data offset.
+	 */
+	const uint32_t &GetOffset() const { return m_offset; }
+
+	const uint32_t &GetSize() const { return m_size; }
 
 private:
 	bool m_multipipeline;
 	std::optional<Shader::UniformBlock> m_uniformBlock;
+	// The block last updated with, blocks are only compared when this changes.
+	const Shader::UniformBlock *m_source;
 	uint32_t m_size;
 	std::unique_ptr<char[]> m_data;
-	std::unique_ptr<UniformBuffer> m_uniformBuffer;
 	Buffer::Status m_handlerStatus;
+	// The range of the data changed since it was last copied into the fallback buffer.
+	uint32_t m_dirtyBegin;
+	uint32_t m_dirtyEnd;
+	bool m_blockReported;
+
+	const Descriptor *m_descriptor;
+	uint32_t m_offset;
+	uint64_t m_frameId;
+	// Used for frames where the uniform ring has no room left.
+	std::unique_ptr<UniformBuffer> m_uniformBuffer;
 };
 }
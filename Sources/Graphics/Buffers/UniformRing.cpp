@@ -0,0 +1,88 @@
+#include "UniformRing.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+UniformRing::UniformRing(const VkDeviceSize &frameSize) :
+	m_buffer(nullptr),
+	m_frameSize(frameSize),
+	m_alignment(std::max<VkDeviceSize>(Graphics::Get()->GetPhysicalDevice()->GetProperties().limits.minUniformBufferOffsetAlignment, 1)),
+	m_regionStart(0),
+	m_head(0),
+	m_required(0),
+	m_frameId(0),
+	m_descriptorVersion(0)
+{
+}
+
+void UniformRing::Reset(const uint32_t &frame, const uint32_t &frameCount)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto it = m_retired.begin(); it != m_retired.end();)
+	{
+		if (--it->second == 0)
+		{
+			it = m_retired.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	// Grows when the last frame overflowed its region, handlers that did not fit fell back to their own buffer for that frame.
+	auto frameSize = m_frameSize;
+
+	while (frameSize < m_required)
+	{
+		frameSize *= 2;
+	}
+
+	if (m_buffer == nullptr || frameSize != m_frameSize || m_buffer->GetSize() != frameSize * frameCount)
+	{
+		if (m_buffer != nullptr)
+		{
+			m_retired.emplace_back(std::move(m_buffer), frameCount);
+		}
+
+		m_frameSize = frameSize;
+		m_buffer = std::make_unique<UniformBuffer>(m_frameSize * frameCount);
+		m_descriptorVersion++;
+	}
+
+	m_regionStart = frame * m_frameSize;
+	m_head = m_regionStart;
+	m_required = 0;
+	m_frameId++;
+}
+
+bool UniformRing::Allocate(const void *data, const VkDeviceSize &size, uint32_t &offset)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_buffer == nullptr)
+	{
+		return false;
+	}
+
+	auto alignedSize = (size + m_alignment - 1) & ~(m_alignment - 1);
+	m_required += alignedSize;
+
+	if (m_head + alignedSize > m_regionStart + m_frameSize)
+	{
+		return false;
+	}
+
+	offset = static_cast<uint32_t>(m_head);
+	m_head += alignedSize;
+
+	std::memcpy(static_cast<char *>(m_buffer->GetAllocation().GetMapped()) + offset, data, static_cast<std::size_t>(size));
+	return true;
+}
+
+WriteDescriptorSet UniformRing::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const
+{
+	return m_buffer->GetWriteDescriptor(binding, descriptorType, offsetSize);
+}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+#include "UniformBuffer.hpp"
+
+namespace acid
+{
+/**
+ * @brief A persistently mapped uniform buffer split into one region per frame in flight, uniform handlers suballocate from the current frames region.
+ * Uniform blocks are bound as dynamic uniform buffers, so every handler shares one descriptor write and only the dynamic offset changes.
+ */
+class ACID_EXPORT UniformRing :
+	public Descriptor,
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new uniform ring.
+	 * @param frameSize The initial bytes per frame region, the ring grows if a frame overflows it.
+	 */
+	explicit UniformRing(const VkDeviceSize &frameSize = 4 * 1024 * 1024);
+
+	/**
+	 * Starts a frames region, this must be called once the frame that last used the region has finished on the GPU.
+	 * @param frame The index of the frame in flight.
+	 * @param frameCount The number of frames in flight.
+	 */
+	void Reset(const uint32_t &frame, const uint32_t &frameCount);
+
+	/**
+	 * Copies data into the current frames region, this is safe to call from multiple threads.
+	 * @param data The data to copy.
+	 * @param size The size of the data in bytes.
+	 * @param offset The offset of the copy into the buffer.
+	 * @return If the region had room for the data.
+	 */
+	bool Allocate(const void *data, const VkDeviceSize &size, uint32_t &offset);
+
+	WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
+
+	uint32_t GetDescriptorVersion() const override { return m_descriptorVersion; }
+
+	/**
+	 * Gets a id for the current frames region, data copied in a earlier region must be copied again.
+	 * @return The frame id.
+	 */
+	const uint64_t &GetFrameId() const { return m_frameId; }
+
+	const VkDeviceSize &GetFrameSize() const { return m_frameSize; }
+
+private:
+	std::unique_ptr<UniformBuffer> m_buffer;
+	// Buffers replaced by a larger ring, kept until the frames that may use them have finished.
+	std::vector<std::pair<std::unique_ptr<UniformBuffer>, uint32_t>> m_retired;
+
+	VkDeviceSize m_frameSize;
+	VkDeviceSize m_alignment;
+	VkDeviceSize m_regionStart;
+	VkDeviceSize m_head;
+	VkDeviceSize m_required;
+	uint64_t m_frameId;
+	uint32_t m_descriptorVersion;
+	std::mutex m_mutex;
+};
+}
@@ -1,19 +1,27 @@
 #include "CommandBuffer.hpp"
 
 #include "Graphics/Graphics.hpp"
+#include "UploadContext.hpp"
 
 namespace acid
 {
+// Queues must be externally synchronized, command buffers are also submitted from loader threads.
+static std::mutex QUEUE_MUTEX;
+
 CommandBuffer::CommandBuffer(const bool &begin, const VkQueueFlagBits &queueType, const VkCommandBufferLevel &bufferLevel) :
-	m_commandPool(nullptr),
-	m_queueType(queueType),
+	CommandBuffer(Graphics::Get()->GetCommandPool(std::this_thread::get_id(), queueType), begin, bufferLevel)
+{
+}
+
+CommandBuffer::CommandBuffer(std::shared_ptr<CommandPool> commandPool, const bool &begin, const VkCommandBufferLevel &bufferLevel) :
+	m_commandPool(std::move(commandPool)),
+	m_queueType(m_commandPool->GetQueueType()),
 	m_commandBuffer(nullptr),
+	m_deviceMask(0),
 	m_running(false)
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
-	m_commandPool = Graphics::Get()->GetCommandPool();
-
 	VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
 	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	commandBufferAllocateInfo.commandPool = *m_commandPool;
@@ -34,7 +42,7 @@ CommandBuffer::~CommandBuffer()
 	vkFreeCommandBuffers(*logicalDevice, m_commandPool->GetCommandPool(), 1, &m_commandBuffer);
 }
 
-void CommandBuffer::Begin(const VkCommandBufferUsageFlags &usage)
+void CommandBuffer::Begin(const VkCommandBufferUsageFlags &usage, const VkCommandBufferInheritanceInfo *inheritanceInfo, const uint32_t &deviceMask)
 {
 	if (m_running)
 	{
@@ -44,6 +52,18 @@ void CommandBuffer::Begin(const VkCommandBufferUsageFlags &usage)
 	VkCommandBufferBeginInfo beginInfo = {};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	beginInfo.flags = usage;
+	beginInfo.pInheritanceInfo = inheritanceInfo;
+
+	VkDeviceGroupCommandBufferBeginInfo deviceGroupBeginInfo = {};
+	deviceGroupBeginInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_COMMAND_BUFFER_BEGIN_INFO;
+	deviceGroupBeginInfo.deviceMask = deviceMask;
+
+	if (deviceMask != 0)
+	{
+		beginInfo.pNext = &deviceGroupBeginInfo;
+	}
+
+	m_deviceMask = deviceMask;
 	Graphics::CheckVk(vkBeginCommandBuffer(m_commandBuffer, &beginInfo));
 	m_running = true;
 }
@@ -64,6 +84,12 @@ void CommandBuffer::SubmitIdle()
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 	auto queueSelected = GetQueue();
 
+	// Work submitted ahead of uploads recorded before it would see the resources before they are written.
+	if (auto uploadContext = Graphics::Get()->GetUploadContext(); uploadContext != nullptr)
+	{
+		uploadContext->Flush();
+	}
+
 	if (m_running)
 	{
 		End();
@@ -82,14 +108,29 @@ void CommandBuffer::SubmitIdle()
 
 	Graphics::CheckVk(vkResetFences(*logicalDevice, 1, &fence));
 
-	Graphics::CheckVk(vkQueueSubmit(queueSelected, 1, &submitInfo, fence));
+	{
+		std::lock_guard<std::mutex> lock(QUEUE_MUTEX);
+		Graphics::CheckVk(vkQueueSubmit(queueSelected, 1, &submitInfo, fence));
+	}
 
 	Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
 
 	vkDestroyFence(*logicalDevice, fence, nullptr);
 }
 
-void CommandBuffer::Submit(const VkSemaphore &waitSemaphore, const VkSemaphore &signalSemaphore, VkFence fence)
+void CommandBuffer::Submit(const VkSemaphore &waitSemaphore, const VkSemaphore &signalSemaphore, VkFence fence, const VkPipelineStageFlags &waitStage)
+{
+	if (waitSemaphore == VK_NULL_HANDLE)
+	{
+		Submit(std::vector<VkSemaphore>(), std::vector<VkPipelineStageFlags>(), signalSemaphore, fence);
+		return;
+	}
+
+	Submit(std::vector<VkSemaphore>{ waitSemaphore }, std::vector<VkPipelineStageFlags>{ waitStage }, signalSemaphore, fence);
+}
+
+void CommandBuffer::Submit(const std::vector<VkSemaphore> &waitSemaphores, const std::vector<VkPipelineStageFlags> &waitStages, const VkSemaphore &signalSemaphore,
+	VkFence fence, const VkSemaphore &timelineSemaphore, const uint64_t &timelineValue)
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 	auto queueSelected = GetQueue();
@@ -104,21 +145,69 @@ void CommandBuffer::Submit(const VkSemaphore &waitSemaphore, const VkSemaphore &
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &m_commandBuffer;
 
-	if (waitSemaphore != VK_NULL_HANDLE)
+	if (!waitSemaphores.empty())
 	{
-		// Pipeline stages used to wait at for graphics queue submissions.
-		static VkPipelineStageFlags submitPipelineStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-		submitInfo.pWaitDstStageMask = &submitPipelineStages;
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = &waitSemaphore;
+		submitInfo.pWaitDstStageMask = waitStages.data();
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
 	}
 
+	// Binary semaphores ignore their signal value, the timeline is signaled after them.
+	std::vector<VkSemaphore> signalSemaphores;
+	std::vector<uint64_t> signalValues;
+
 	if (signalSemaphore != VK_NULL_HANDLE)
 	{
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = &signalSemaphore;
+		signalSemaphores.emplace_back(signalSemaphore);
+		signalValues.emplace_back(0);
+	}
+
+	if (timelineSemaphore != VK_NULL_HANDLE)
+	{
+		signalSemaphores.emplace_back(timelineSemaphore);
+		signalValues.emplace_back(timelineValue);
+	}
+
+	submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+	submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+	// Semaphores of commands run on some GPUs of a device group are waited on and signaled by the first of them.
+	uint32_t deviceIndex = 0;
+
+	while (m_deviceMask != 0 && !(m_deviceMask & (1u << deviceIndex)))
+	{
+		deviceIndex++;
+	}
+
+	std::vector<uint32_t> waitDeviceIndices(waitSemaphores.size(), deviceIndex);
+	std::vector<uint32_t> signalDeviceIndices(signalSemaphores.size(), deviceIndex);
+
+	VkDeviceGroupSubmitInfo deviceGroupSubmitInfo = {};
+	deviceGroupSubmitInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO;
+	deviceGroupSubmitInfo.waitSemaphoreCount = submitInfo.waitSemaphoreCount;
+	deviceGroupSubmitInfo.pWaitSemaphoreDeviceIndices = waitDeviceIndices.data();
+	deviceGroupSubmitInfo.commandBufferCount = 1;
+	deviceGroupSubmitInfo.pCommandBufferDeviceMasks = &m_deviceMask;
+	deviceGroupSubmitInfo.signalSemaphoreCount = submitInfo.signalSemaphoreCount;
+	deviceGroupSubmitInfo.pSignalSemaphoreDeviceIndices = signalDeviceIndices.data();
+
+	if (m_deviceMask != 0)
+	{
+		submitInfo.pNext = &deviceGroupSubmitInfo;
+	}
+
+#if defined(VK_KHR_timeline_semaphore)
+	VkTimelineSemaphoreSubmitInfoKHR timelineSemaphoreSubmitInfo = {};
+	timelineSemaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+	timelineSemaphoreSubmitInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+	timelineSemaphoreSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+
+	if (timelineSemaphore != VK_NULL_HANDLE)
+	{
+		timelineSemaphoreSubmitInfo.pNext = submitInfo.pNext;
+		submitInfo.pNext = &timelineSemaphoreSubmitInfo;
 	}
+#endif
 
 	if (fence != VK_NULL_HANDLE)
 	{
@@ -126,6 +215,7 @@ void CommandBuffer::Submit(const VkSemaphore &waitSemaphore, const VkSemaphore &
 		//Renderer::CheckVk(vkWaitForFences(*logicalDevice, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
 	}
 
+	std::lock_guard<std::mutex> lock(QUEUE_MUTEX);
 	Graphics::CheckVk(vkQueueSubmit(queueSelected, 1, &submitInfo, fence));
 }
 
@@ -139,6 +229,8 @@ VkQueue CommandBuffer::GetQueue() const
 		return logicalDevice->GetGraphicsQueue();
 	case VK_QUEUE_COMPUTE_BIT:
 		return logicalDevice->GetComputeQueue();
+	case VK_QUEUE_TRANSFER_BIT:
+		return logicalDevice->GetTransferQueue();
 	default:
 		return nullptr;
 	}
@@ -19,13 +19,24 @@ public:
 	explicit CommandBuffer(const bool &begin = true, const VkQueueFlagBits &queueType = VK_QUEUE_GRAPHICS_BIT,
 		const VkCommandBufferLevel &bufferLevel = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
+	/**
+	 * Creates a new command buffer from a pool that is not owned by the current thread, the caller synchronizes access to the pool.
+	 * @param commandPool The pool to allocate from, this selects the queue to run this command buffer on.
+	 * @param begin If recording will start right away, if true {@link CommandBuffer#Begin} is called.
+	 * @param bufferLevel The buffer level.
+	 */
+	explicit CommandBuffer(std::shared_ptr<CommandPool> commandPool, const bool &begin = true, const VkCommandBufferLevel &bufferLevel = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
 	~CommandBuffer();
 
 	/**
 	 * Begins the recording state for this command buffer.
 	 * @param usage How this command buffer will be used.
+	 * @param inheritanceInfo The renderpass state inherited by a secondary command buffer, ignored for primary buffers.
+	 * @param deviceMask The GPUs of a device group that run the commands, zero runs them on every GPU.
 	 */
-	void Begin(const VkCommandBufferUsageFlags &usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	void Begin(const VkCommandBufferUsageFlags &usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, const VkCommandBufferInheritanceInfo *inheritanceInfo = nullptr,
+		const uint32_t &deviceMask = 0);
 
 	/**
 	 * Ends the recording state for this command buffer.
@@ -33,7 +44,8 @@ public:
 	void End();
 
 	/**
-	 * Submits the command buffer to the queue and will hold the current thread idle until it has finished.
+	 * Submits the command buffer to the queue and will hold the current thread idle until it has finished, pending uploads are flushed first.
+	 * This is meant for tooling such as screenshots, uploads should be recorded into the {@link UploadContext}.
 	 */
 	void SubmitIdle();
 
@@ -42,8 +54,23 @@ public:
 	 * @param waitSemaphore A optional semaphore that will waited upon before the command buffer is executed.
 	 * @param signalSemaphore A optional that is signaled once the command buffer has been executed.
 	 * @param fence A optional fence that is signaled once the command buffer has completed.
+	 * @param waitStage The pipeline stages that wait on the wait semaphore.
+	 */
+	void Submit(const VkSemaphore &waitSemaphore = VK_NULL_HANDLE, const VkSemaphore &signalSemaphore = VK_NULL_HANDLE, VkFence fence = VK_NULL_HANDLE,
+		const VkPipelineStageFlags &waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+	/**
+	 * Submits the command buffer after a number of semaphores, such as work from other queues the commands depend on.
+	 * @param waitSemaphores The semaphores that will be waited upon before the command buffer is executed.
+	 * @param waitStages The pipeline stages that wait on each of the wait semaphores.
+	 * @param signalSemaphore A optional that is signaled once the command buffer has been executed.
+	 * @param fence A optional fence that is signaled once the command buffer has completed.
+	 * @param timelineSemaphore A optional timeline semaphore that is signaled to a value once the command buffer has completed.
+	 * @param timelineValue The value the timeline semaphore is signaled to.
 	 */
-	void Submit(const VkSemaphore &waitSemaphore = VK_NULL_HANDLE, const VkSemaphore &signalSemaphore = VK_NULL_HANDLE, VkFence fence = VK_NULL_HANDLE);
+	void Submit(const std::vector<VkSemaphore> &waitSemaphores, const std::vector<VkPipelineStageFlags> &waitStages,
+		const VkSemaphore &signalSemaphore = VK_NULL_HANDLE, VkFence fence = VK_NULL_HANDLE, const VkSemaphore &timelineSemaphore = VK_NULL_HANDLE,
+		const uint64_t &timelineValue = 0);
 
 	const bool &IsRunning() const { return m_running; }
 
@@ -58,6 +85,7 @@ private:
 
 	VkQueueFlagBits m_queueType;
 	VkCommandBuffer m_commandBuffer;
+	uint32_t m_deviceMask;
 	bool m_running;
 };
 }
@@ -4,17 +4,31 @@
 
 namespace acid
 {
-CommandPool::CommandPool(const std::thread::id &threadId) :
+CommandPool::CommandPool(const std::thread::id &threadId, const VkQueueFlagBits &queueType) :
 	m_commandPool(VK_NULL_HANDLE),
-	m_threadId(threadId)
+	m_threadId(threadId),
+	m_queueType(queueType)
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-	auto graphicsFamily = logicalDevice->GetGraphicsFamily();
+	uint32_t queueFamily;
+
+	switch (m_queueType)
+	{
+	case VK_QUEUE_COMPUTE_BIT:
+		queueFamily = logicalDevice->GetComputeFamily();
+		break;
+	case VK_QUEUE_TRANSFER_BIT:
+		queueFamily = logicalDevice->GetTransferFamily();
+		break;
+	default:
+		queueFamily = logicalDevice->GetGraphicsFamily();
+		break;
+	}
 
 	VkCommandPoolCreateInfo commandPoolCreateInfo = {};
 	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-	commandPoolCreateInfo.queueFamilyIndex = graphicsFamily;
+	commandPoolCreateInfo.queueFamilyIndex = queueFamily;
 	Graphics::CheckVk(vkCreateCommandPool(*logicalDevice, &commandPoolCreateInfo, nullptr, &m_commandPool));
 }
 
@@ -11,7 +11,12 @@ namespace acid
 class ACID_EXPORT CommandPool
 {
 public:
-	explicit CommandPool(const std::thread::id &threadId = std::this_thread::get_id());
+	/**
+	 * Creates a new command pool.
+	 * @param threadId The thread that records command buffers from this pool.
+	 * @param queueType The queue the command buffers will be submitted to, this selects the queue family.
+	 */
+	explicit CommandPool(const std::thread::id &threadId = std::this_thread::get_id(), const VkQueueFlagBits &queueType = VK_QUEUE_GRAPHICS_BIT);
 
 	~CommandPool();
 
@@ -21,8 +26,11 @@ public:
 
 	const std::thread::id &GetThreadId() const { return m_threadId; }
 
+	const VkQueueFlagBits &GetQueueType() const { return m_queueType; }
+
 private:
 	VkCommandPool m_commandPool;
 	std::thread::id m_threadId;
+	VkQueueFlagBits m_queueType;
 };
 }
@@ -0,0 +1,55 @@
+#include "TimelineSemaphore.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+TimelineSemaphore::TimelineSemaphore(const uint64_t &initialValue) :
+	m_semaphore(VK_NULL_HANDLE)
+{
+#if defined(VK_KHR_timeline_semaphore)
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkSemaphoreTypeCreateInfoKHR semaphoreTypeCreateInfo = {};
+	semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+	semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+	semaphoreTypeCreateInfo.initialValue = initialValue;
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+	Graphics::CheckVk(vkCreateSemaphore(*logicalDevice, &semaphoreCreateInfo, nullptr, &m_semaphore));
+#endif
+}
+
+TimelineSemaphore::~TimelineSemaphore()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	vkDestroySemaphore(*logicalDevice, m_semaphore, nullptr);
+}
+
+uint64_t TimelineSemaphore::GetValue() const
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	uint64_t value = 0;
+	Graphics::CheckVk(Instance::FvkGetSemaphoreCounterValueKHR(*logicalDevice, m_semaphore, &value));
+	return value;
+}
+
+bool TimelineSemaphore::Wait(const uint64_t &value, const uint64_t &timeout) const
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	auto result = Instance::FvkWaitSemaphoreKHR(*logicalDevice, m_semaphore, value, timeout);
+
+	if (result == VK_TIMEOUT)
+	{
+		return false;
+	}
+
+	Graphics::CheckVk(result);
+	return true;
+}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+#include "StdAfx.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that represents a timeline semaphore, a counter that submits signal to a value and that the CPU or other submits wait to reach a value.
+ * Only created when {@link LogicalDevice#IsTimelineSemaphore} is enabled.
+ */
+class ACID_EXPORT TimelineSemaphore :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new timeline semaphore.
+	 * @param initialValue The value the counter starts at.
+	 */
+	explicit TimelineSemaphore(const uint64_t &initialValue = 0);
+
+	~TimelineSemaphore();
+
+	/**
+	 * Gets the value the counter has reached on the device.
+	 * @return The current value.
+	 */
+	uint64_t GetValue() const;
+
+	/**
+	 * Holds the current thread until the counter has reached a value.
+	 * @param value The value to wait for.
+	 * @param timeout The longest time to wait in nanoseconds.
+	 * @return If the value was reached before the timeout.
+	 */
+	bool Wait(const uint64_t &value, const uint64_t &timeout = std::numeric_limits<uint64_t>::max()) const;
+
+	operator const VkSemaphore &() const { return m_semaphore; }
+
+	const VkSemaphore &GetSemaphore() const { return m_semaphore; }
+
+private:
+	VkSemaphore m_semaphore;
+};
+}
@@ -0,0 +1,149 @@
+#include "TimestampQueries.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+TimestampQueries::TimestampQueries(const uint32_t &capacity) :
+	m_capacity(capacity),
+	m_supported(false),
+	m_period(0.0f),
+	m_queryPool(VK_NULL_HANDLE),
+	m_recording(false),
+	m_queryCount(0)
+{
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	uint32_t queueFamilyCount;
+	vkGetPhysicalDeviceQueueFamilyProperties(*physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(*physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+	m_supported = physicalDevice->GetProperties().limits.timestampComputeAndGraphics &&
+		queueFamilies[logicalDevice->GetGraphicsFamily()].timestampValidBits != 0;
+	m_period = physicalDevice->GetProperties().limits.timestampPeriod;
+
+	if (!m_supported)
+	{
+		return;
+	}
+
+	VkQueryPoolCreateInfo queryPoolCreateInfo = {};
+	queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolCreateInfo.queryCount = 2 * m_capacity;
+	Graphics::CheckVk(vkCreateQueryPool(*logicalDevice, &queryPoolCreateInfo, nullptr, &m_queryPool));
+}
+
+TimestampQueries::~TimestampQueries()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	vkDestroyQueryPool(*logicalDevice, m_queryPool, nullptr);
+}
+
+void TimestampQueries::Reset(const CommandBuffer &commandBuffer, const bool &timed)
+{
+	if (!m_supported)
+	{
+		return;
+	}
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto profiler = Profiler::Get();
+	m_gpuTime = std::nullopt;
+
+	// The regions are only reported if the command buffer has finished, if it has not the results are dropped.
+	if (m_queryCount != 0 && m_open.empty())
+	{
+		std::vector<uint64_t> timestamps(m_queryCount);
+
+		if (vkGetQueryPoolResults(*logicalDevice, m_queryPool, 0, m_queryCount, sizeof(uint64_t) * m_queryCount, timestamps.data(), sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			// GPU time is placed after the time the command buffer was recorded, the clocks are not calibrated.
+			auto toTime = [this, &timestamps](const uint32_t &query)
+			{
+				return Time::Microseconds(static_cast<double>(timestamps[query] - timestamps[0]) * m_period / 1000.0);
+			};
+
+			m_gpuTime = Time::Zero;
+
+			for (const auto &region : m_regions)
+			{
+				m_gpuTime = std::max(*m_gpuTime, toTime(region.m_end));
+
+				if (profiler == nullptr)
+				{
+					continue;
+				}
+
+				Profiler::Marker marker = {};
+				marker.m_name = region.m_name;
+				marker.m_category = "gpu";
+				marker.m_start = m_recordTime + toTime(region.m_begin);
+				marker.m_duration = toTime(region.m_end) - toTime(region.m_begin);
+				profiler->AddMarker(std::move(marker));
+			}
+		}
+	}
+
+	m_regions.clear();
+	m_open.clear();
+	m_recording = false;
+	m_queryCount = 0;
+
+	if (!timed && (profiler == nullptr || !profiler->IsEnabled()))
+	{
+		return;
+	}
+
+	m_recordTime = Engine::GetTime();
+	vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, 2 * m_capacity);
+	m_recording = true;
+}
+
+void TimestampQueries::Begin(const CommandBuffer &commandBuffer, const std::string &name)
+{
+	if (!m_recording)
+	{
+		return;
+	}
+
+	// Keeps begin and end paired when the pool is full.
+	if (m_regions.size() >= m_capacity)
+	{
+		m_open.emplace_back(std::numeric_limits<std::size_t>::max());
+		return;
+	}
+
+	Region region = {};
+	region.m_name = name;
+	region.m_begin = m_queryCount++;
+	region.m_end = region.m_begin;
+	m_open.emplace_back(m_regions.size());
+	m_regions.emplace_back(region);
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, region.m_begin);
+}
+
+void TimestampQueries::End(const CommandBuffer &commandBuffer)
+{
+	if (m_open.empty())
+	{
+		return;
+	}
+
+	auto index = m_open.back();
+	m_open.pop_back();
+
+	if (index == std::numeric_limits<std::size_t>::max())
+	{
+		return;
+	}
+
+	auto &region = m_regions[index];
+	region.m_end = m_queryCount++;
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, region.m_end);
+}
+}
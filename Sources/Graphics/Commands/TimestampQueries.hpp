@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Engine/Profiler.hpp"
+#include "Helpers/NonCopyable.hpp"
+#include "CommandBuffer.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that times regions of a command buffer with timestamp queries, results are read back into the {@link Profiler} the next time the pool is reset.
+ */
+class ACID_EXPORT TimestampQueries :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new timestamp query pool.
+	 * @param capacity The maximum number of timed regions per recording.
+	 */
+	explicit TimestampQueries(const uint32_t &capacity = 64);
+
+	~TimestampQueries();
+
+	/**
+	 * Reads back the regions timed the last time this pool was recorded and resets the queries, this must be called outside of a renderpass.
+	 * @param commandBuffer The command buffer that is starting to be recorded.
+	 * @param timed If regions are timed even when the profiler is disabled.
+	 */
+	void Reset(const CommandBuffer &commandBuffer, const bool &timed = false);
+
+	/**
+	 * Writes the starting timestamp of a region, regions can be nested.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param name The region name.
+	 */
+	void Begin(const CommandBuffer &commandBuffer, const std::string &name);
+
+	/**
+	 * Writes the ending timestamp of the last region begun.
+	 * @param commandBuffer The command buffer to record into.
+	 */
+	void End(const CommandBuffer &commandBuffer);
+
+	const bool &IsSupported() const { return m_supported; }
+
+	/**
+	 * Gets the GPU time from the first timestamp to the last of the recording read back by the last reset.
+	 * @return The GPU time, or nullopt if nothing was read back.
+	 */
+	const std::optional<Time> &GetGpuTime() const { return m_gpuTime; }
+
+private:
+	class Region
+	{
+	public:
+		std::string m_name;
+		uint32_t m_begin;
+		uint32_t m_end;
+	};
+
+	uint32_t m_capacity;
+	bool m_supported;
+	float m_period;
+	VkQueryPool m_queryPool;
+
+	bool m_recording;
+	std::vector<Region> m_regions;
+	std::vector<std::size_t> m_open;
+	uint32_t m_queryCount;
+	Time m_recordTime;
+	std::optional<Time> m_gpuTime;
+};
+}
@@ -0,0 +1,251 @@
+#include "UploadContext.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+UploadContext::UploadContext() :
+	m_commandPool(nullptr),
+	m_completed(0)
+{
+	m_recording.m_token = 1;
+}
+
+UploadContext::~UploadContext()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_timeline != nullptr && !m_submitted.empty())
+	{
+		m_timeline->Wait(m_submitted.back().m_token);
+	}
+
+	for (auto &batch : m_submitted)
+	{
+		if (batch.m_fence != VK_NULL_HANDLE)
+		{
+			Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &batch.m_fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+			vkDestroyFence(*logicalDevice, batch.m_fence, nullptr);
+		}
+	}
+
+	m_submitted.clear();
+	m_recording = {};
+	m_timeline = nullptr;
+}
+
+UploadContext::Token UploadContext::Record(const std::function<void(const CommandBuffer &)> &record)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	record(GetCommandBuffer());
+	return m_recording.m_token;
+}
+
+UploadContext::Token UploadContext::Record(const void *data, const VkDeviceSize &size, const std::function<void(const CommandBuffer &, const Buffer &)> &record)
+{
+	// Staging memory is written before locking, so threads only wait on each other while recording.
+	auto bufferStaging = std::make_unique<Buffer>(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		data, MemoryAllocator::Lifetime::Transient);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	record(GetCommandBuffer(), *bufferStaging);
+	m_recording.m_stagingBuffers.emplace_back(std::move(bufferStaging));
+	return m_recording.m_token;
+}
+
+UploadContext::Token UploadContext::Barrier(const VkImageMemoryBarrier &imageMemoryBarrier, const VkPipelineStageFlags &srcStageMask,
+	const VkPipelineStageFlags &dstStageMask)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto sameRange = [](const VkImageSubresourceRange &a, const VkImageSubresourceRange &b)
+	{
+		return a.aspectMask == b.aspectMask && a.baseMipLevel == b.baseMipLevel && a.levelCount == b.levelCount && a.baseArrayLayer == b.baseArrayLayer &&
+			a.layerCount == b.layerCount;
+	};
+
+	for (auto &queued : m_recording.m_imageBarriers)
+	{
+		if (queued.image != imageMemoryBarrier.image)
+		{
+			continue;
+		}
+
+		// A transition that carries on from a queued one, with no commands recorded between them, becomes one transition.
+		if (sameRange(queued.subresourceRange, imageMemoryBarrier.subresourceRange) && queued.newLayout == imageMemoryBarrier.oldLayout)
+		{
+			queued.newLayout = imageMemoryBarrier.newLayout;
+			queued.dstAccessMask = imageMemoryBarrier.dstAccessMask;
+			m_recording.m_srcStageMask |= srcStageMask;
+			m_recording.m_dstStageMask |= dstStageMask;
+			return m_recording.m_token;
+		}
+
+		// Barriers of the same image in one pipeline barrier have no order, so the queued barriers are recorded first.
+		GetCommandBuffer();
+		break;
+	}
+
+	m_recording.m_imageBarriers.emplace_back(imageMemoryBarrier);
+	m_recording.m_srcStageMask |= srcStageMask;
+	m_recording.m_dstStageMask |= dstStageMask;
+	return m_recording.m_token;
+}
+
+void UploadContext::Flush()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Submit();
+	Retire();
+}
+
+UploadContext::Token UploadContext::GetToken()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_recording.m_commandBuffer == nullptr && m_recording.m_imageBarriers.empty())
+	{
+		return m_recording.m_token - 1;
+	}
+
+	return m_recording.m_token;
+}
+
+bool UploadContext::IsComplete(const Token &token)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Retire();
+	return token <= m_completed;
+}
+
+void UploadContext::Wait(const Token &token)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (token >= m_recording.m_token)
+	{
+		Submit();
+	}
+
+	if (m_timeline != nullptr)
+	{
+		m_timeline->Wait(std::min(token, m_recording.m_token - 1));
+		Retire();
+		return;
+	}
+
+	for (const auto &batch : m_submitted)
+	{
+		if (batch.m_token >= token)
+		{
+			Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &batch.m_fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+			break;
+		}
+	}
+
+	Retire();
+}
+
+CommandBuffer &UploadContext::GetCommandBuffer()
+{
+	if (m_commandPool == nullptr)
+	{
+		m_commandPool = std::make_shared<CommandPool>();
+	}
+
+	if (m_recording.m_commandBuffer == nullptr)
+	{
+		m_recording.m_commandBuffer = std::make_unique<CommandBuffer>(m_commandPool);
+	}
+
+	RecordBarriers();
+	return *m_recording.m_commandBuffer;
+}
+
+void UploadContext::RecordBarriers()
+{
+	if (m_recording.m_imageBarriers.empty())
+	{
+		return;
+	}
+
+	vkCmdPipelineBarrier(*m_recording.m_commandBuffer, m_recording.m_srcStageMask, m_recording.m_dstStageMask, 0, 0, nullptr, 0, nullptr,
+		static_cast<uint32_t>(m_recording.m_imageBarriers.size()), m_recording.m_imageBarriers.data());
+	m_recording.m_imageBarriers.clear();
+	m_recording.m_srcStageMask = 0;
+	m_recording.m_dstStageMask = 0;
+}
+
+void UploadContext::Submit()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (m_recording.m_commandBuffer == nullptr && m_recording.m_imageBarriers.empty())
+	{
+		return;
+	}
+
+	auto &commandBuffer = GetCommandBuffer();
+
+	// Copies into buffers have no barrier of their own, every later command waits for the transfers of this batch.
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+	// Batches signal their token on the timeline, which completes them in order without a fence each.
+	if (m_timeline == nullptr && logicalDevice->IsTimelineSemaphore())
+	{
+		m_timeline = std::make_unique<TimelineSemaphore>(m_completed);
+	}
+
+	if (m_timeline != nullptr)
+	{
+		commandBuffer.Submit({}, {}, VK_NULL_HANDLE, VK_NULL_HANDLE, *m_timeline, m_recording.m_token);
+	}
+	else
+	{
+		VkFenceCreateInfo fenceCreateInfo = {};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		Graphics::CheckVk(vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &m_recording.m_fence));
+
+		commandBuffer.Submit(VK_NULL_HANDLE, VK_NULL_HANDLE, m_recording.m_fence);
+	}
+
+	auto token = m_recording.m_token;
+	m_submitted.emplace_back(std::move(m_recording));
+	m_recording = {};
+	m_recording.m_token = token + 1;
+}
+
+void UploadContext::Retire()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (m_timeline != nullptr)
+	{
+		auto value = m_timeline->GetValue();
+
+		while (!m_submitted.empty() && m_submitted.front().m_token <= value)
+		{
+			m_completed = m_submitted.front().m_token;
+			m_submitted.pop_front();
+		}
+
+		return;
+	}
+
+	while (!m_submitted.empty() && vkGetFenceStatus(*logicalDevice, m_submitted.front().m_fence) == VK_SUCCESS)
+	{
+		auto &batch = m_submitted.front();
+		vkDestroyFence(*logicalDevice, batch.m_fence, nullptr);
+		m_completed = batch.m_token;
+		m_submitted.pop_front();
+	}
+}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <deque>
+#include "Helpers/NonCopyable.hpp"
+#include "Graphics/Buffers/Buffer.hpp"
+#include "CommandBuffer.hpp"
+#include "TimelineSemaphore.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that batches resource uploads into one command buffer, the batch is submitted once per frame instead of each upload waiting for the queue to idle.
+ * Uploads may be recorded from any thread, every frame submission flushes the batch first so the frame sees its results through submission order.
+ * Resources recorded into a batch must stay alive until its token completes.
+ * Image barriers are queued and recorded together in one pipeline barrier before the next commands, transitions of the same image that follow each other are merged.
+ * Batches signal a timeline semaphore with their token when timeline semaphores are enabled, otherwise each batch is given a fence.
+ */
+class ACID_EXPORT UploadContext :
+	public NonCopyable
+{
+public:
+	/// Identifies the batch a upload was recorded into, batches complete in the order they are submitted.
+	using Token = uint64_t;
+
+	UploadContext();
+
+	~UploadContext();
+
+	/**
+	 * Records commands into the current batch.
+	 * @param record The function that records the commands, it is called while the batch is locked.
+	 * @return The token of the batch the commands were recorded into.
+	 */
+	Token Record(const std::function<void(const CommandBuffer &)> &record);
+
+	/**
+	 * Copies data into a staging buffer and records commands that read from it into the current batch, the staging buffer is released once the batch completes.
+	 * @param data The data to stage.
+	 * @param size The size of the data.
+	 * @param record The function that records the commands, it is called while the batch is locked.
+	 * @return The token of the batch the commands were recorded into.
+	 */
+	Token Record(const void *data, const VkDeviceSize &size, const std::function<void(const CommandBuffer &, const Buffer &)> &record);
+
+	/**
+	 * Queues a image barrier into the current batch, it is recorded along with the other queued barriers before any commands recorded after it.
+	 * @param imageMemoryBarrier The barrier.
+	 * @param srcStageMask The stages that must finish before the barrier.
+	 * @param dstStageMask The stages that wait on the barrier.
+	 * @return The token of the batch the barrier was queued into.
+	 */
+	Token Barrier(const VkImageMemoryBarrier &imageMemoryBarrier, const VkPipelineStageFlags &srcStageMask, const VkPipelineStageFlags &dstStageMask);
+
+	/**
+	 * Gets the token of the last batch anything was recorded into, every upload recorded so far has completed once it completes.
+	 * @return The token of the batch.
+	 */
+	Token GetToken();
+
+	/**
+	 * Submits the current batch if anything was recorded and releases batches that have completed.
+	 */
+	void Flush();
+
+	/**
+	 * Gets if a batch has finished executing.
+	 * @param token The token of the batch.
+	 * @return If the batch has completed.
+	 */
+	bool IsComplete(const Token &token);
+
+	/**
+	 * Holds the current thread until a batch has finished executing, the batch is submitted first if it has not been yet.
+	 * @param token The token of the batch.
+	 */
+	void Wait(const Token &token);
+
+private:
+	class Batch
+	{
+	public:
+		Token m_token = 0;
+		std::unique_ptr<CommandBuffer> m_commandBuffer;
+		std::vector<std::unique_ptr<Buffer>> m_stagingBuffers;
+		VkFence m_fence = VK_NULL_HANDLE;
+		// Barriers queued since the last commands were recorded.
+		std::vector<VkImageMemoryBarrier> m_imageBarriers;
+		VkPipelineStageFlags m_srcStageMask = 0;
+		VkPipelineStageFlags m_dstStageMask = 0;
+	};
+
+	/**
+	 * Gets the command buffer of the current batch with the queued barriers recorded into it.
+	 * @return The command buffer.
+	 */
+	CommandBuffer &GetCommandBuffer();
+
+	void RecordBarriers();
+
+	void Submit();
+
+	void Retire();
+
+	// Loader threads record into a pool of their own that is only used under the mutex.
+	std::shared_ptr<CommandPool> m_commandPool;
+
+	std::mutex m_mutex;
+	Batch m_recording;
+	std::deque<Batch> m_submitted;
+	Token m_completed;
+	std::unique_ptr<TimelineSemaphore> m_timeline;
+};
+}
@@ -0,0 +1,268 @@
+#include "BindlessDescriptors.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Images/Image2d.hpp"
+
+namespace acid
+{
+const uint32_t BindlessDescriptors::Set = 1;
+
+BindlessDescriptors::BindlessDescriptors(const uint32_t &maxImages, const uint32_t &maxMaterials) :
+	m_maxImages(maxImages),
+	m_maxMaterials(maxMaterials),
+	m_frameCount(1),
+	m_nextImage(0),
+	m_nextMaterial(0),
+	m_materialBuffer(std::make_unique<StorageBuffer>(sizeof(BindlessMaterial) * maxMaterials)),
+	m_descriptorSetLayout(VK_NULL_HANDLE),
+	m_descriptorPool(VK_NULL_HANDLE),
+	m_descriptorSet(VK_NULL_HANDLE)
+{
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+
+	// Descriptors in update after bind sets have their own, usually much larger, limits.
+	VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptorIndexingProperties = {};
+	descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+	VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+	physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	physicalDeviceProperties2.pNext = &descriptorIndexingProperties;
+	vkGetPhysicalDeviceProperties2(*physicalDevice, &physicalDeviceProperties2);
+
+	m_maxImages = std::min({ m_maxImages, descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+		descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages, descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages });
+
+	CreateDescriptorLayout();
+	CreateDescriptorPool();
+	CreateDescriptorSet();
+}
+
+BindlessDescriptors::~BindlessDescriptors()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	vkDestroyDescriptorPool(*logicalDevice, m_descriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(*logicalDevice, m_descriptorSetLayout, nullptr);
+}
+
+int32_t BindlessDescriptors::GetImageIndex(const std::shared_ptr<Image2d> &image)
+{
+	if (image == nullptr)
+	{
+		return -1;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_images.find(image.get());
+
+	if (it != m_images.end())
+	{
+		if (it->second.m_image.lock() == image)
+		{
+			return static_cast<int32_t>(it->second.m_index);
+		}
+
+		// A new image was created where a destroyed image used to be.
+		m_retiredImages.emplace_back(it->second.m_index, m_frameCount);
+		m_images.erase(it);
+	}
+
+	uint32_t index;
+
+	if (!m_freeImages.empty())
+	{
+		index = m_freeImages.back();
+		m_freeImages.pop_back();
+	}
+	else if (m_nextImage < m_maxImages)
+	{
+		index = m_nextImage++;
+	}
+	else
+	{
+		return -1;
+	}
+
+	// The image is written into the array by the next update, until then the slot is not read.
+	ImageSlot imageSlot;
+	imageSlot.m_image = image;
+	imageSlot.m_index = index;
+	m_images.emplace(image.get(), imageSlot);
+	return static_cast<int32_t>(index);
+}
+
+std::shared_ptr<BindlessDescriptors::MaterialSlot> BindlessDescriptors::AddMaterial()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	uint32_t index;
+
+	if (!m_freeMaterials.empty())
+	{
+		index = m_freeMaterials.back();
+		m_freeMaterials.pop_back();
+	}
+	else if (m_nextMaterial < m_maxMaterials)
+	{
+		index = m_nextMaterial++;
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	auto slot = std::make_shared<MaterialSlot>(index);
+	m_materials.emplace_back(index, slot);
+	return slot;
+}
+
+void BindlessDescriptors::SetMaterial(const MaterialSlot &slot, const BindlessMaterial &material)
+{
+	auto materials = static_cast<BindlessMaterial *>(m_materialBuffer->GetAllocation().GetMapped());
+	std::memcpy(materials + slot.GetIndex(), &material, sizeof(BindlessMaterial));
+}
+
+void BindlessDescriptors::Update(const uint32_t &frameCount)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_frameCount = frameCount;
+	Retire(m_retiredImages, m_freeImages);
+	Retire(m_retiredMaterials, m_freeMaterials);
+
+	for (auto it = m_materials.begin(); it != m_materials.end();)
+	{
+		if (it->second.expired())
+		{
+			m_retiredMaterials.emplace_back(it->first, m_frameCount);
+			it = m_materials.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	// Streamed images change their handles once resident, so slots are rewritten when the images descriptor version changes.
+	std::vector<WriteDescriptorSet> writeDescriptors;
+	std::vector<VkWriteDescriptorSet> descriptorWrites;
+
+	for (auto it = m_images.begin(); it != m_images.end();)
+	{
+		auto image = it->second.m_image.lock();
+
+		if (image == nullptr)
+		{
+			m_retiredImages.emplace_back(it->second.m_index, m_frameCount);
+			it = m_images.erase(it);
+			continue;
+		}
+
+		if (!it->second.m_written || it->second.m_version != image->GetDescriptorVersion())
+		{
+			it->second.m_written = true;
+			it->second.m_version = image->GetDescriptorVersion();
+
+			auto &writeDescriptor = writeDescriptors.emplace_back(image->GetWriteDescriptor(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, std::nullopt));
+			auto descriptorWrite = writeDescriptor.GetWriteDescriptorSet();
+			descriptorWrite.dstSet = m_descriptorSet;
+			descriptorWrite.dstArrayElement = it->second.m_index;
+			descriptorWrites.emplace_back(descriptorWrite);
+		}
+
+		++it;
+	}
+
+	if (!descriptorWrites.empty())
+	{
+		auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+		vkUpdateDescriptorSets(*logicalDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	}
+}
+
+void BindlessDescriptors::BindDescriptor(const CommandBuffer &commandBuffer, const Pipeline &pipeline) const
+{
+	vkCmdBindDescriptorSets(commandBuffer, pipeline.GetPipelineBindPoint(), pipeline.GetPipelineLayout(), Set, 1, &m_descriptorSet, 0, nullptr);
+}
+
+void BindlessDescriptors::CreateDescriptorLayout()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	std::array<VkDescriptorSetLayoutBinding, 2> descriptorSetLayouts = {
+		Image2d::GetDescriptorSetLayout(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL, m_maxImages),
+		StorageBuffer::GetDescriptorSetLayout(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_ALL, 1)
+	};
+
+	// Slots that are not used by a draw may be empty, or be written while frames that do not read them are in flight.
+	std::array<VkDescriptorBindingFlagsEXT, 2> descriptorBindingFlags = {
+		VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT,
+		0
+	};
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT descriptorSetLayoutBindingFlags = {};
+	descriptorSetLayoutBindingFlags.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	descriptorSetLayoutBindingFlags.bindingCount = static_cast<uint32_t>(descriptorBindingFlags.size());
+	descriptorSetLayoutBindingFlags.pBindingFlags = descriptorBindingFlags.data();
+
+	VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {};
+	descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	descriptorSetLayoutCreateInfo.pNext = &descriptorSetLayoutBindingFlags;
+	descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+	descriptorSetLayoutCreateInfo.bindingCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+	descriptorSetLayoutCreateInfo.pBindings = descriptorSetLayouts.data();
+	Graphics::CheckVk(vkCreateDescriptorSetLayout(*logicalDevice, &descriptorSetLayoutCreateInfo, nullptr, &m_descriptorSetLayout));
+}
+
+void BindlessDescriptors::CreateDescriptorPool()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	std::array<VkDescriptorPoolSize, 2> descriptorPools = {};
+	descriptorPools[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorPools[0].descriptorCount = m_maxImages;
+	descriptorPools[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	descriptorPools[1].descriptorCount = 1;
+
+	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
+	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+	descriptorPoolCreateInfo.maxSets = 1;
+	descriptorPoolCreateInfo.poolSizeCount = static_cast<uint32_t>(descriptorPools.size());
+	descriptorPoolCreateInfo.pPoolSizes = descriptorPools.data();
+	Graphics::CheckVk(vkCreateDescriptorPool(*logicalDevice, &descriptorPoolCreateInfo, nullptr, &m_descriptorPool));
+}
+
+void BindlessDescriptors::CreateDescriptorSet()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.descriptorPool = m_descriptorPool;
+	descriptorSetAllocateInfo.descriptorSetCount = 1;
+	descriptorSetAllocateInfo.pSetLayouts = &m_descriptorSetLayout;
+	Graphics::CheckVk(vkAllocateDescriptorSets(*logicalDevice, &descriptorSetAllocateInfo, &m_descriptorSet));
+
+	// The material buffer never changes, so it is written once.
+	auto writeDescriptor = m_materialBuffer->GetWriteDescriptor(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, std::nullopt);
+	auto descriptorWrite = writeDescriptor.GetWriteDescriptorSet();
+	descriptorWrite.dstSet = m_descriptorSet;
+	vkUpdateDescriptorSets(*logicalDevice, 1, &descriptorWrite, 0, nullptr);
+}
+
+void BindlessDescriptors::Retire(std::vector<std::pair<uint32_t, uint32_t>> &retired, std::vector<uint32_t> &free)
+{
+	for (auto it = retired.begin(); it != retired.end();)
+	{
+		if (it->second == 0 || --it->second == 0)
+		{
+			free.emplace_back(it->first);
+			it = retired.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+}
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Colour.hpp"
+#include "Graphics/Buffers/StorageBuffer.hpp"
+#include "Graphics/Commands/CommandBuffer.hpp"
+#include "Graphics/Pipelines/Pipeline.hpp"
+
+namespace acid
+{
+class Image2d;
+
+/**
+ * @brief The values of a material in the bindless material buffer, laid out to match the std430 Material struct in bindless shaders.
+ * Image indices are -1 when the material does not map that image.
+ */
+struct BindlessMaterial
+{
+	Colour m_baseDiffuse;
+	float m_metallic;
+	float m_roughness;
+	float m_ignoreFog;
+	float m_ignoreLighting;
+	int32_t m_imageDiffuse;
+	int32_t m_imageMaterial;
+	int32_t m_imageNormal;
+	int32_t m_padding;
+};
+
+/**
+ * @brief A descriptor set shared by every bindless pipeline, holding one large array of sampled images and a buffer of materials.
+ * Shaders declare these at set {@link BindlessDescriptors#Set} and index them with values from push constants or instance data,
+ * so drawing a object does not write any descriptors of its own.
+ */
+class ACID_EXPORT BindlessDescriptors :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief A index into the material buffer, the index is freed once the last handle to it is released.
+	 */
+	class ACID_EXPORT MaterialSlot
+	{
+	public:
+		explicit MaterialSlot(const uint32_t &index) :
+			m_index(index)
+		{
+		}
+
+		const uint32_t &GetIndex() const { return m_index; }
+
+	private:
+		uint32_t m_index;
+	};
+
+	static const uint32_t Set;
+
+	/**
+	 * Creates the bindless descriptors, this requires {@link LogicalDevice#IsDescriptorIndexing}.
+	 * @param maxImages The size of the image array, this is clamped to the devices limit.
+	 * @param maxMaterials The number of materials the material buffer can hold.
+	 */
+	explicit BindlessDescriptors(const uint32_t &maxImages = 16384, const uint32_t &maxMaterials = 16384);
+
+	~BindlessDescriptors();
+
+	/**
+	 * Gets the index of a image in the image array, the image is added the first time it is seen and removed once it is destroyed.
+	 * This is safe to call from multiple threads.
+	 * @param image The image.
+	 * @return The index of the image, or -1 if the image is nullptr or the array is full.
+	 */
+	int32_t GetImageIndex(const std::shared_ptr<Image2d> &image);
+
+	/**
+	 * Adds a material to the material buffer, this is safe to call from multiple threads.
+	 * @return The slot of the material, or nullptr if the buffer is full.
+	 */
+	std::shared_ptr<MaterialSlot> AddMaterial();
+
+	/**
+	 * Writes the values of a material into the material buffer.
+	 * @param slot The slot of the material.
+	 * @param material The material values.
+	 */
+	void SetMaterial(const MaterialSlot &slot, const BindlessMaterial &material);
+
+	/**
+	 * Writes images that were added or whos handles changed, and frees the slots of destroyed images and released materials.
+	 * This must be called from the thread that submits rendering.
+	 * @param frameCount The number of frames in flight, freed slots are reused once these have finished.
+	 */
+	void Update(const uint32_t &frameCount);
+
+	/**
+	 * Binds the bindless set into a pipeline whos shader is {@link Shader#IsBindless}.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param pipeline The bound pipeline.
+	 */
+	void BindDescriptor(const CommandBuffer &commandBuffer, const Pipeline &pipeline) const;
+
+	const VkDescriptorSetLayout &GetDescriptorSetLayout() const { return m_descriptorSetLayout; }
+
+	const uint32_t &GetMaxImages() const { return m_maxImages; }
+
+	const uint32_t &GetMaxMaterials() const { return m_maxMaterials; }
+
+private:
+	class ImageSlot
+	{
+	public:
+		std::weak_ptr<Image2d> m_image;
+		uint32_t m_index = 0;
+		uint32_t m_version = 0;
+		bool m_written = false;
+	};
+
+	void CreateDescriptorLayout();
+
+	void CreateDescriptorPool();
+
+	void CreateDescriptorSet();
+
+	/**
+	 * Counts down the frames a retired slot may still be read by, and frees the slots that reach zero.
+	 * @param retired The retired slots and their remaining frames.
+	 * @param free The free slots.
+	 */
+	static void Retire(std::vector<std::pair<uint32_t, uint32_t>> &retired, std::vector<uint32_t> &free);
+
+	uint32_t m_maxImages;
+	uint32_t m_maxMaterials;
+	uint32_t m_frameCount;
+
+	std::map<const Image2d *, ImageSlot> m_images;
+	std::vector<uint32_t> m_freeImages;
+	std::vector<std::pair<uint32_t, uint32_t>> m_retiredImages;
+	uint32_t m_nextImage;
+
+	std::vector<std::pair<uint32_t, std::weak_ptr<MaterialSlot>>> m_materials;
+	std::vector<uint32_t> m_freeMaterials;
+	std::vector<std::pair<uint32_t, uint32_t>> m_retiredMaterials;
+	uint32_t m_nextMaterial;
+	std::unique_ptr<StorageBuffer> m_materialBuffer;
+
+	VkDescriptorSetLayout m_descriptorSetLayout;
+	VkDescriptorPool m_descriptorPool;
+	VkDescriptorSet m_descriptorSet;
+	std::mutex m_mutex;
+};
+}
@@ -52,12 +52,28 @@ public:
 		m_writeDescriptorSet.pBufferInfo = m_bufferInfo.get();
 	}
 
+	WriteDescriptorSet(const VkWriteDescriptorSet &writeDescriptorSet, const VkAccelerationStructureKHR &accelerationStructure) :
+		m_writeDescriptorSet(writeDescriptorSet),
+		m_imageInfo(nullptr),
+		m_bufferInfo(nullptr),
+		m_accelerationStructure(std::make_unique<VkAccelerationStructureKHR>(accelerationStructure)),
+		m_accelerationStructureInfo(std::make_unique<VkWriteDescriptorSetAccelerationStructureKHR>())
+	{
+		// Acceleration structures are written through a structure chained to the write.
+		m_accelerationStructureInfo->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
+		m_accelerationStructureInfo->accelerationStructureCount = 1;
+		m_accelerationStructureInfo->pAccelerationStructures = m_accelerationStructure.get();
+		m_writeDescriptorSet.pNext = m_accelerationStructureInfo.get();
+	}
+
 	const VkWriteDescriptorSet &GetWriteDescriptorSet() const { return m_writeDescriptorSet; }
 
 private:
 	VkWriteDescriptorSet m_writeDescriptorSet;
 	std::unique_ptr<VkDescriptorImageInfo> m_imageInfo;
 	std::unique_ptr<VkDescriptorBufferInfo> m_bufferInfo;
+	std::unique_ptr<VkAccelerationStructureKHR> m_accelerationStructure;
+	std::unique_ptr<VkWriteDescriptorSetAccelerationStructureKHR> m_accelerationStructureInfo;
 };
 
 class ACID_EXPORT Descriptor
@@ -65,6 +81,12 @@ class ACID_EXPORT Descriptor
 public:
 	virtual WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const = 0;
 
+	/**
+	 * Gets a counter that changes whenever the handles written by {@link Descriptor#GetWriteDescriptor} change, so cached writes are refreshed.
+	 * @return The descriptor version.
+	 */
+	virtual uint32_t GetDescriptorVersion() const { return 0; }
+
 	Descriptor() = default;
 
 	virtual ~Descriptor() = default;
@@ -0,0 +1,220 @@
+#include "DescriptorAllocator.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+// Sets held by each page, and the descriptors of each type per set a page is sized for.
+static const uint32_t PAGE_SETS = 256;
+static const std::array<std::pair<VkDescriptorType, uint32_t>, 8> PAGE_DESCRIPTORS = {{
+	{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+	{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 },
+	{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 2 },
+	{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 },
+	{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 },
+	{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1 },
+	{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1 },
+	{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1 }
+}};
+
+DescriptorAllocator::DescriptorAllocator() :
+	m_frame(0),
+	m_frameCount(0)
+{
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	// Destroying a pool frees every set allocated from it.
+	for (const auto &page : m_pages)
+	{
+		vkDestroyDescriptorPool(*logicalDevice, page.m_pool, nullptr);
+	}
+
+	for (const auto &frame : m_frames)
+	{
+		for (const auto &pool : frame.m_pools)
+		{
+			vkDestroyDescriptorPool(*logicalDevice, pool, nullptr);
+		}
+	}
+}
+
+void DescriptorAllocator::Reset(const uint32_t &frame, const uint32_t &frameCount)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Frames in flight changing recreates every frame resource, so no transient set is in use.
+	if (m_frames.size() != frameCount)
+	{
+		for (const auto &oldFrame : m_frames)
+		{
+			for (const auto &pool : oldFrame.m_pools)
+			{
+				vkDestroyDescriptorPool(*logicalDevice, pool, nullptr);
+			}
+		}
+
+		m_frames = std::vector<Frame>(frameCount);
+	}
+
+	m_frame = frame;
+	m_frameCount++;
+
+	auto &current = m_frames[m_frame];
+
+	for (const auto &pool : current.m_pools)
+	{
+		Graphics::CheckVk(vkResetDescriptorPool(*logicalDevice, pool, 0));
+	}
+
+	current.m_current = 0;
+
+	for (auto it = m_freed.begin(); it != m_freed.end();)
+	{
+		if (it->m_frame + frameCount >= m_frameCount)
+		{
+			++it;
+			continue;
+		}
+
+		Graphics::CheckVk(vkFreeDescriptorSets(*logicalDevice, it->m_pool, 1, &it->m_descriptorSet));
+
+		// A page with a freed set may have room again.
+		for (auto &page : m_pages)
+		{
+			if (page.m_pool == it->m_pool)
+			{
+				page.m_full = false;
+			}
+		}
+
+		it = m_freed.erase(it);
+	}
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(const VkDescriptorSetLayout &layout, VkDescriptorPool &pool)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+	for (auto &page : m_pages)
+	{
+		if (page.m_full)
+		{
+			continue;
+		}
+
+		if (AllocateSet(page.m_pool, layout, descriptorSet))
+		{
+			pool = page.m_pool;
+			return descriptorSet;
+		}
+
+		page.m_full = true;
+	}
+
+	auto &page = m_pages.emplace_back(Page{ CreatePool(true), false });
+	pool = page.m_pool;
+
+	if (!AllocateSet(page.m_pool, layout, descriptorSet))
+	{
+		Log::Error("Descriptor set could not be allocated from a new descriptor pool\n");
+	}
+
+	return descriptorSet;
+}
+
+void DescriptorAllocator::Free(const VkDescriptorPool &pool, const VkDescriptorSet &descriptorSet)
+{
+	if (descriptorSet == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_freed.emplace_back(Freed{ pool, descriptorSet, m_frameCount });
+}
+
+VkDescriptorSet DescriptorAllocator::AllocateTransient(const VkDescriptorSetLayout &layout)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_frames.empty())
+	{
+		m_frames.resize(1);
+	}
+
+	auto &frame = m_frames[m_frame];
+	VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+	// Pages are filled in order, a full page is not tried again until the frame is reset.
+	for (; frame.m_current < frame.m_pools.size(); frame.m_current++)
+	{
+		if (AllocateSet(frame.m_pools[frame.m_current], layout, descriptorSet))
+		{
+			return descriptorSet;
+		}
+	}
+
+	frame.m_pools.emplace_back(CreatePool(false));
+
+	if (!AllocateSet(frame.m_pools.back(), layout, descriptorSet))
+	{
+		Log::Error("Transient descriptor set could not be allocated from a new descriptor pool\n");
+	}
+
+	return descriptorSet;
+}
+
+VkDescriptorPool DescriptorAllocator::CreatePool(const bool &freeable)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	std::array<VkDescriptorPoolSize, PAGE_DESCRIPTORS.size()> descriptorPools = {};
+
+	for (std::size_t i = 0; i < PAGE_DESCRIPTORS.size(); i++)
+	{
+		descriptorPools[i].type = PAGE_DESCRIPTORS[i].first;
+		descriptorPools[i].descriptorCount = PAGE_DESCRIPTORS[i].second * PAGE_SETS;
+	}
+
+	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
+	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolCreateInfo.flags = freeable ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0;
+	descriptorPoolCreateInfo.maxSets = PAGE_SETS;
+	descriptorPoolCreateInfo.poolSizeCount = static_cast<uint32_t>(descriptorPools.size());
+	descriptorPoolCreateInfo.pPoolSizes = descriptorPools.data();
+
+	VkDescriptorPool pool;
+	Graphics::CheckVk(vkCreateDescriptorPool(*logicalDevice, &descriptorPoolCreateInfo, nullptr, &pool));
+	return pool;
+}
+
+bool DescriptorAllocator::AllocateSet(const VkDescriptorPool &pool, const VkDescriptorSetLayout &layout, VkDescriptorSet &descriptorSet)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.descriptorPool = pool;
+	descriptorSetAllocateInfo.descriptorSetCount = 1;
+	descriptorSetAllocateInfo.pSetLayouts = &layout;
+
+	// A full or fragmented pool is expected, the next page is tried.
+	auto result = vkAllocateDescriptorSets(*logicalDevice, &descriptorSetAllocateInfo, &descriptorSet);
+
+	if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+	{
+		return false;
+	}
+
+	Graphics::CheckVk(result);
+	return true;
+}
+}
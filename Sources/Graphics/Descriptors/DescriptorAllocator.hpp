@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mutex>
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+/**
+ * @brief Allocates descriptor sets from pages of descriptor pools shared by every pipeline, a new page is created when every page is full.
+ * Sets that live across frames are freed back to their page once the frames that may use them have finished.
+ * Transient sets are allocated linearly from the current frames pages, and are only valid until the frame is submitted, the pages are reset wholesale when the frame is reused.
+ */
+class ACID_EXPORT DescriptorAllocator :
+	public NonCopyable
+{
+public:
+	DescriptorAllocator();
+
+	~DescriptorAllocator();
+
+	/**
+	 * Starts a frame, this must be called once the frame that last used the frames transient pages has finished on the GPU.
+	 * @param frame The index of the frame in flight.
+	 * @param frameCount The number of frames in flight.
+	 */
+	void Reset(const uint32_t &frame, const uint32_t &frameCount);
+
+	/**
+	 * Allocates a set that lives across frames, this is safe to call from multiple threads.
+	 * @param layout The layout of the set.
+	 * @param pool The pool the set was allocated from, given back when freeing the set.
+	 * @return The descriptor set.
+	 */
+	VkDescriptorSet Allocate(const VkDescriptorSetLayout &layout, VkDescriptorPool &pool);
+
+	/**
+	 * Frees a set once the frames in flight that may use it have finished.
+	 * @param pool The pool the set was allocated from.
+	 * @param descriptorSet The descriptor set.
+	 */
+	void Free(const VkDescriptorPool &pool, const VkDescriptorSet &descriptorSet);
+
+	/**
+	 * Allocates a set that is only used by the current frame, this is safe to call from multiple threads.
+	 * @param layout The layout of the set.
+	 * @return The descriptor set.
+	 */
+	VkDescriptorSet AllocateTransient(const VkDescriptorSetLayout &layout);
+
+private:
+	class Page
+	{
+	public:
+		VkDescriptorPool m_pool;
+		bool m_full;
+	};
+
+	class Freed
+	{
+	public:
+		VkDescriptorPool m_pool;
+		VkDescriptorSet m_descriptorSet;
+		uint64_t m_frame;
+	};
+
+	class Frame
+	{
+	public:
+		std::vector<VkDescriptorPool> m_pools;
+		std::size_t m_current;
+	};
+
+	static VkDescriptorPool CreatePool(const bool &freeable);
+
+	static bool AllocateSet(const VkDescriptorPool &pool, const VkDescriptorSetLayout &layout, VkDescriptorSet &descriptorSet);
+
+	std::mutex m_mutex;
+	std::vector<Page> m_pages;
+	std::vector<Freed> m_freed;
+	std::vector<Frame> m_frames;
+	uint32_t m_frame;
+	uint64_t m_frameCount;
+};
+}
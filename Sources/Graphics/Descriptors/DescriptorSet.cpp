@@ -1,32 +1,43 @@
 #include "DescriptorSet.hpp"
 
 #include "Graphics/Graphics.hpp"
+#include "DescriptorAllocator.hpp"
 
 namespace acid
 {
-DescriptorSet::DescriptorSet(const Pipeline &pipeline) :
+DescriptorSet::DescriptorSet(const Pipeline &pipeline, const bool &transient) :
 	m_pipelineLayout(pipeline.GetPipelineLayout()),
 	m_pipelineBindPoint(pipeline.GetPipelineBindPoint()),
-	m_descriptorPool(pipeline.GetDescriptorPool()),
-	m_descriptorSet(VK_NULL_HANDLE)
+	m_descriptorPool(VK_NULL_HANDLE),
+	m_descriptorSet(VK_NULL_HANDLE),
+	m_transient(transient),
+	m_frame(Graphics::Get()->GetFrameCount())
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-
-	VkDescriptorSetLayout layouts[1] = { pipeline.GetDescriptorSetLayout() };
-
-	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
-	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	descriptorSetAllocateInfo.descriptorPool = m_descriptorPool;
-	descriptorSetAllocateInfo.descriptorSetCount = 1;
-	descriptorSetAllocateInfo.pSetLayouts = layouts;
-	Graphics::CheckVk(vkAllocateDescriptorSets(*logicalDevice, &descriptorSetAllocateInfo, &m_descriptorSet));
+	auto descriptorAllocator = Graphics::Get()->GetDescriptorAllocator();
+
+	if (m_transient)
+	{
+		m_descriptorSet = descriptorAllocator->AllocateTransient(pipeline.GetDescriptorSetLayout());
+	}
+	else
+	{
+		m_descriptorSet = descriptorAllocator->Allocate(pipeline.GetDescriptorSetLayout(), m_descriptorPool);
+	}
 }
 
 DescriptorSet::~DescriptorSet()
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-
-	Graphics::CheckVk(vkFreeDescriptorSets(*logicalDevice, m_descriptorPool, 1, &m_descriptorSet));
+	// Transient sets are released when their frames pages are reset, others once the frames in flight that may bind them have finished.
+	if (!m_transient)
+	{
+		Graphics::Get()->Retire([descriptorPool = m_descriptorPool, descriptorSet = m_descriptorSet]()
+		{
+			if (auto descriptorAllocator = Graphics::Get()->GetDescriptorAllocator())
+			{
+				descriptorAllocator->Free(descriptorPool, descriptorSet);
+			}
+		});
+	}
 }
 
 void DescriptorSet::Update(const std::vector<VkWriteDescriptorSet> &descriptorWrites)
@@ -36,8 +47,9 @@ void DescriptorSet::Update(const std::vector<VkWriteDescriptorSet> &descriptorWr
 	vkUpdateDescriptorSets(*logicalDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 }
 
-void DescriptorSet::BindDescriptor(const CommandBuffer &commandBuffer)
+void DescriptorSet::BindDescriptor(const CommandBuffer &commandBuffer, const std::vector<uint32_t> &dynamicOffsets)
 {
-	vkCmdBindDescriptorSets(commandBuffer, m_pipelineBindPoint, m_pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+	vkCmdBindDescriptorSets(commandBuffer, m_pipelineBindPoint, m_pipelineLayout, 0, 1, &m_descriptorSet, static_cast<uint32_t>(dynamicOffsets.size()),
+		dynamicOffsets.data());
 }
 }
@@ -8,23 +8,46 @@ namespace acid
 class Descriptor;
 class WriteDescriptorSet;
 
+/**
+ * @brief Class that represents a descriptor set, allocated from the pages of the graphics descriptor allocator.
+ */
 class ACID_EXPORT DescriptorSet
 {
 public:
-	explicit DescriptorSet(const Pipeline &pipeline);
+	/**
+	 * Creates a new descriptor set.
+	 * @param pipeline The pipeline the set is laid out for.
+	 * @param transient If the set is allocated from the current frames pages, and is only valid until the frame is submitted.
+	 */
+	explicit DescriptorSet(const Pipeline &pipeline, const bool &transient = false);
 
 	~DescriptorSet();
 
 	void Update(const std::vector<VkWriteDescriptorSet> &descriptorWrites);
 
-	void BindDescriptor(const CommandBuffer &commandBuffer);
+	/**
+	 * Binds the descriptor set.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param dynamicOffsets The offsets of the dynamic descriptors, in binding order.
+	 */
+	void BindDescriptor(const CommandBuffer &commandBuffer, const std::vector<uint32_t> &dynamicOffsets = {});
 
 	const VkDescriptorSet &GetDescriptorSet() const { return m_descriptorSet; }
 
+	const bool &IsTransient() const { return m_transient; }
+
+	/**
+	 * Gets the frame this set was allocated in, a transient set can not be used after this frame.
+	 * @return The frame count when allocated.
+	 */
+	const uint64_t &GetFrame() const { return m_frame; }
+
 private:
 	VkPipelineLayout m_pipelineLayout;
 	VkPipelineBindPoint m_pipelineBindPoint;
 	VkDescriptorPool m_descriptorPool;
 	VkDescriptorSet m_descriptorSet;
+	bool m_transient;
+	uint64_t m_frame;
 };
 }
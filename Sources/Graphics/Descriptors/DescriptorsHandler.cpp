@@ -8,6 +8,8 @@ DescriptorsHandler::DescriptorsHandler() :
 	m_shader(nullptr),
 	m_pushDescriptors(false),
 	m_descriptorSet(nullptr),
+	m_written(false),
+	m_changedFrame(0),
 	m_changed(false)
 {
 }
@@ -16,40 +18,61 @@ DescriptorsHandler::DescriptorsHandler(const Pipeline &pipeline) :
 	m_shader(pipeline.GetShader()),
 	m_pushDescriptors(pipeline.IsPushDescriptors()),
 	m_descriptorSet(std::make_unique<DescriptorSet>(pipeline)),
+	m_written(false),
+	m_changedFrame(0),
 	m_changed(true)
 {
 }
 
-void DescriptorsHandler::Push(const std::string &descriptorName, UniformHandler &uniformHandler, const std::optional<OffsetSize> &offsetSize)
+void DescriptorsHandler::Push(const UniformId &descriptorId, UniformHandler &uniformHandler, const std::optional<OffsetSize> &offsetSize)
 {
 	if (m_shader == nullptr)
 	{
 		return;
 	}
 
-	uniformHandler.Update(m_shader->GetUniformBlock(descriptorName));
-	Push(descriptorName, uniformHandler.GetUniformBuffer(), offsetSize);
+	uniformHandler.Update(m_shader->FindUniformBlock(descriptorId));
+
+	auto offset = uniformHandler.GetOffset() + (offsetSize ? offsetSize->GetOffset() : 0);
+	auto size = offsetSize ? offsetSize->GetSize() : uniformHandler.GetSize();
+
+	// Pushed descriptors can not be dynamic, so the offset is written into the descriptor instead.
+	if (m_pushDescriptors)
+	{
+		Push(descriptorId, uniformHandler.GetDescriptor(), OffsetSize(offset, size));
+		return;
+	}
+
+	// The descriptor write stays the same between frames, only the dynamic offset given when binding changes.
+	Push(descriptorId, uniformHandler.GetDescriptor(), OffsetSize(0, size));
+
+	auto it = m_descriptors.find(descriptorId.GetHash());
+
+	if (it != m_descriptors.end())
+	{
+		it->second.m_dynamicOffset = offset;
+	}
 }
 
-void DescriptorsHandler::Push(const std::string &descriptorName, StorageHandler &storageHandler, const std::optional<OffsetSize> &offsetSize)
+void DescriptorsHandler::Push(const UniformId &descriptorId, StorageHandler &storageHandler, const std::optional<OffsetSize> &offsetSize)
 {
 	if (m_shader == nullptr)
 	{
 		return;
 	}
 
-	storageHandler.Update(m_shader->GetUniformBlock(descriptorName));
-	Push(descriptorName, storageHandler.GetStorageBuffer(), offsetSize);
+	storageHandler.Update(m_shader->FindUniformBlock(descriptorId));
+	Push(descriptorId, storageHandler.GetStorageBuffer(), offsetSize);
 }
 
-void DescriptorsHandler::Push(const std::string &descriptorName, PushHandler &pushHandler, const std::optional<OffsetSize> &offsetSize)
+void DescriptorsHandler::Push(const UniformId &descriptorId, PushHandler &pushHandler, const std::optional<OffsetSize> &offsetSize)
 {
 	if (m_shader == nullptr)
 	{
 		return;
 	}
 
-	pushHandler.Update(m_shader->GetUniformBlock(descriptorName));
+	pushHandler.Update(m_shader->FindUniformBlock(descriptorId));
 }
 
 bool DescriptorsHandler::Update(const Pipeline &pipeline)
@@ -60,39 +83,67 @@ bool DescriptorsHandler::Update(const Pipeline &pipeline)
 		m_pushDescriptors = pipeline.IsPushDescriptors();
 		m_descriptors.clear();
 		m_writeDescriptorSets.clear();
+		m_dynamicDescriptors.clear();
 
 		if (!m_pushDescriptors)
 		{
 			m_descriptorSet = std::make_unique<DescriptorSet>(pipeline);
+			m_written = false;
 		}
 
 		m_changed = false;
 		return false;
 	}
 
+	auto frame = Graphics::Get()->GetFrameCount();
+
 	if (m_changed)
 	{
 		m_writeDescriptorSets.clear();
 		m_writeDescriptorSets.reserve(m_descriptors.size());
+		m_dynamicDescriptors.clear();
 
-		for (const auto &[descriptorName, descriptor] : m_descriptors)
+		for (const auto &[descriptorId, descriptor] : m_descriptors)
 		{
-			auto writeDescriptorSet = descriptor.m_writeDescriptor.GetWriteDescriptorSet();
-			writeDescriptorSet.dstSet = VK_NULL_HANDLE;
-
-			if (!m_pushDescriptors)
+			if (descriptor.m_descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || descriptor.m_descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)
 			{
-				writeDescriptorSet.dstSet = m_descriptorSet->GetDescriptorSet();
+				m_dynamicDescriptors.emplace_back(&descriptor);
 			}
 
+			auto writeDescriptorSet = descriptor.m_writeDescriptor.GetWriteDescriptorSet();
+			writeDescriptorSet.dstSet = VK_NULL_HANDLE;
 			m_writeDescriptorSets.emplace_back(writeDescriptorSet);
 		}
 
-		if (!m_pushDescriptors)
+		std::sort(m_dynamicDescriptors.begin(), m_dynamicDescriptors.end(), [](const DescriptorValue *l, const DescriptorValue *r)
+		{
+			return l->m_location < r->m_location;
+		});
+	}
+
+	// A set that may be used by a frame in flight is never written again, changed descriptors are written into a new set instead.
+	// Descriptors that change on consecutive frames use transient sets from the frames pages, a transient set is replaced every frame until they settle.
+	if (!m_pushDescriptors && (m_changed || (m_descriptorSet->IsTransient() && m_descriptorSet->GetFrame() != frame)))
+	{
+		auto transient = m_changed && m_written && m_changedFrame + 1 >= frame;
+
+		if (m_written || transient)
+		{
+			m_descriptorSet = std::make_unique<DescriptorSet>(pipeline, transient);
+		}
+
+		for (auto &writeDescriptorSet : m_writeDescriptorSets)
 		{
-			m_descriptorSet->Update(m_writeDescriptorSets);
+			writeDescriptorSet.dstSet = m_descriptorSet->GetDescriptorSet();
 		}
 
+		m_descriptorSet->Update(m_writeDescriptorSets);
+		m_written = true;
+	}
+
+	if (m_changed)
+	{
+		m_changedFrame = frame;
 		m_changed = false;
 	}
 
@@ -109,7 +160,14 @@ void DescriptorsHandler::BindDescriptor(const CommandBuffer &commandBuffer, cons
 	}
 	else
 	{
-		m_descriptorSet->BindDescriptor(commandBuffer);
+		m_dynamicOffsets.resize(m_dynamicDescriptors.size());
+
+		for (std::size_t i = 0; i < m_dynamicDescriptors.size(); i++)
+		{
+			m_dynamicOffsets[i] = m_dynamicDescriptors[i]->m_dynamicOffset;
+		}
+
+		m_descriptorSet->BindDescriptor(commandBuffer, m_dynamicOffsets);
 	}
 }
 }
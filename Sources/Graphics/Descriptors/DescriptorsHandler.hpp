@@ -20,7 +20,7 @@ public:
 	explicit DescriptorsHandler(const Pipeline &pipeline);
 
 	template<typename T>
-	void Push(const std::string &descriptorName, const T &descriptor, const std::optional<OffsetSize> &offsetSize = {})
+	void Push(const UniformId &descriptorId, const T &descriptor, const std::optional<OffsetSize> &offsetSize = {})
 	{
 		if (m_shader == nullptr)
 		{
@@ -28,12 +28,13 @@ public:
 		}
 
 		// Finds the local value given to the descriptor name.
-		auto it = m_descriptors.find(descriptorName);
+		auto it = m_descriptors.find(descriptorId.GetHash());
 
 		if (it != m_descriptors.end())
 		{
 			// If the descriptor and size have not changed then the write is not modified.
-			if (it->second.m_descriptor == ConstExpr::AsPtr(descriptor) && it->second.m_offsetSize == offsetSize)
+			if (it->second.m_descriptor == ConstExpr::AsPtr(descriptor) && it->second.m_offsetSize == offsetSize &&
+				it->second.m_version == ConstExpr::AsPtr(descriptor)->GetDescriptorVersion())
 			{
 				return;
 			}
@@ -48,14 +49,14 @@ public:
 		}
 
 		// When adding the descriptor find the location in the shader.
-		auto location = m_shader->GetDescriptorLocation(descriptorName);
+		auto location = m_shader->FindDescriptorLocation(descriptorId);
 
 		if (!location)
 		{
 #if defined(ACID_VERBOSE)
-			if (m_shader->ReportedNotFound(descriptorName, true))
+			if (m_shader->ReportedNotFound(std::string(descriptorId.GetName()), true))
 			{
-				Log::Error("Could not find descriptor in shader '%s' of name '%s'\n", m_shader->GetName().c_str(), descriptorName.c_str());
+				Log::Error("Could not find descriptor in shader '%s' of name '%s'\n", m_shader->GetName().c_str(), std::string(descriptorId.GetName()).c_str());
 			}
 #endif
 
@@ -67,9 +68,9 @@ public:
 		if (!descriptorType)
 		{
 #if defined(ACID_VERBOSE)
-			if (m_shader->ReportedNotFound(descriptorName, true))
+			if (m_shader->ReportedNotFound(std::string(descriptorId.GetName()), true))
 			{
-				Log::Error("Could not find descriptor in shader '%s' of name '%s' at location '%i'\n", m_shader->GetName().c_str(), descriptorName.c_str(), *location);
+				Log::Error("Could not find descriptor in shader '%s' of name '%s' at location '%i'\n", m_shader->GetName().c_str(), std::string(descriptorId.GetName()).c_str(), *location);
 			}
 #endif
 			return;
@@ -77,37 +78,39 @@ public:
 
 		// Adds the new descriptor value.
 		auto writeDescriptor = ConstExpr::AsPtr(descriptor)->GetWriteDescriptor(*location, *descriptorType, offsetSize);
-		m_descriptors.emplace(descriptorName, DescriptorValue{ ConstExpr::AsPtr(descriptor), std::move(writeDescriptor), offsetSize, *location });
+		m_descriptors.emplace(descriptorId.GetHash(), DescriptorValue{ ConstExpr::AsPtr(descriptor), std::move(writeDescriptor), offsetSize, *location,
+			ConstExpr::AsPtr(descriptor)->GetDescriptorVersion(), *descriptorType, 0 });
 		m_changed = true;
 	}
 
 	template<typename T>
-	void Push(const std::string &descriptorName, const T &descriptor, WriteDescriptorSet writeDescriptorSet)
+	void Push(const UniformId &descriptorId, const T &descriptor, WriteDescriptorSet writeDescriptorSet)
 	{
 		if (m_shader == nullptr)
 		{
 			return;
 		}
 
-		auto it = m_descriptors.find(descriptorName);
+		auto it = m_descriptors.find(descriptorId.GetHash());
 
 		if (it != m_descriptors.end())
 		{
 			m_descriptors.erase(it);
 		}
 
-		auto location = m_shader->GetDescriptorLocation(descriptorName);
+		auto location = m_shader->FindDescriptorLocation(descriptorId);
 		//auto descriptorType = m_shader->GetDescriptorType(*location);
 
-		m_descriptors.emplace(descriptorName, DescriptorValue{ ConstExpr::AsPtr(descriptor), std::move(writeDescriptorSet), {}, *location });
+		auto descriptorType = writeDescriptorSet.GetWriteDescriptorSet().descriptorType;
+		m_descriptors.emplace(descriptorId.GetHash(), DescriptorValue{ ConstExpr::AsPtr(descriptor), std::move(writeDescriptorSet), {}, *location, 0, descriptorType, 0 });
 		m_changed = true;
 	}
 
-	void Push(const std::string &descriptorName, UniformHandler &uniformHandler, const std::optional<OffsetSize> &offsetSize = {});
+	void Push(const UniformId &descriptorId, UniformHandler &uniformHandler, const std::optional<OffsetSize> &offsetSize = {});
 
-	void Push(const std::string &descriptorName, StorageHandler &storageHandler, const std::optional<OffsetSize> &offsetSize = {});
+	void Push(const UniformId &descriptorId, StorageHandler &storageHandler, const std::optional<OffsetSize> &offsetSize = {});
 
-	void Push(const std::string &descriptorName, PushHandler &pushHandler, const std::optional<OffsetSize> &offsetSize = {});
+	void Push(const UniformId &descriptorId, PushHandler &pushHandler, const std::optional<OffsetSize> &offsetSize = {});
 
 	bool Update(const Pipeline &pipeline);
 
@@ -122,14 +125,23 @@ private:
 		WriteDescriptorSet m_writeDescriptor;
 		std::optional<OffsetSize> m_offsetSize;
 		uint32_t m_location;
+		uint32_t m_version;
+		VkDescriptorType m_descriptorType;
+		uint32_t m_dynamicOffset;
 	};
 
 	const Shader *m_shader;
 	bool m_pushDescriptors;
 	std::unique_ptr<DescriptorSet> m_descriptorSet;
+	// If the current set has been written, and so may be in use by a frame in flight.
+	bool m_written;
+	uint64_t m_changedFrame;
 
-	std::map<std::string, DescriptorValue> m_descriptors;
+	std::unordered_map<uint64_t, DescriptorValue> m_descriptors;
 	std::vector<VkWriteDescriptorSet> m_writeDescriptorSets;
+	// Dynamic descriptors sorted by binding, the order their offsets are given in when binding.
+	std::vector<const DescriptorValue *> m_dynamicDescriptors;
+	std::vector<uint32_t> m_dynamicOffsets;
 	bool m_changed;
 };
 }
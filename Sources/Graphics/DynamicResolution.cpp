@@ -0,0 +1,96 @@
+#include "DynamicResolution.hpp"
+
+#include "Graphics.hpp"
+
+namespace acid
+{
+// Weight of each new frame time in the smoothed time.
+static const float SMOOTHING = 0.1f;
+// Time for frames from the last scale to be read back and for the smoothed time to settle.
+static const Time COOLDOWN = Time::Milliseconds(500);
+// The scale is lowered above this fraction of the target time, and only raised if the larger scale is expected to stay below it.
+static const float HEADROOM = 0.9f;
+
+DynamicResolution::DynamicResolution(const uint32_t &renderStage, const Time &targetTime, const float &minScale, const float &maxScale, const float &step) :
+	m_renderStage(renderStage),
+	m_targetTime(targetTime),
+	m_minScale(minScale),
+	m_maxScale(maxScale),
+	m_step(step),
+	m_scale(maxScale)
+{
+	Graphics::Get()->SetGpuTimed(true);
+}
+
+DynamicResolution::~DynamicResolution()
+{
+	if (auto graphics = Graphics::Get(); graphics != nullptr)
+	{
+		graphics->SetGpuTimed(false);
+	}
+}
+
+void DynamicResolution::Update()
+{
+	auto graphics = Graphics::Get();
+	auto renderStage = graphics->GetRenderStage(m_renderStage);
+
+	if (renderStage == nullptr)
+	{
+		return;
+	}
+
+	auto &viewport = renderStage->GetViewport();
+
+	// Render stages that were set again start at the scale last chosen.
+	if (viewport.GetScale() != Vector2f(m_scale))
+	{
+		viewport.SetScale(Vector2f(m_scale));
+	}
+
+	auto gpuFrameTime = graphics->GetGpuFrameTime();
+
+	if (!gpuFrameTime)
+	{
+		return;
+	}
+
+	auto now = Engine::GetTime();
+
+	if (now - m_lastChange < COOLDOWN)
+	{
+		return;
+	}
+
+	auto frameTime = gpuFrameTime->AsMilliseconds<float>();
+	m_gpuTime = Time::Milliseconds(m_gpuTime ? m_gpuTime->AsMilliseconds<float>() + (frameTime - m_gpuTime->AsMilliseconds<float>()) * SMOOTHING : frameTime);
+
+	auto ratio = m_gpuTime->AsMilliseconds<float>() / m_targetTime.AsMilliseconds<float>();
+	auto scale = m_scale;
+
+	if (ratio > HEADROOM)
+	{
+		// GPU time mostly grows with the number of pixels, so the scale changes with the square root of the time.
+		scale = std::floor(m_scale * std::sqrt(HEADROOM / ratio) / m_step) * m_step;
+	}
+	else if (ratio * std::pow((m_scale + m_step) / m_scale, 2.0f) < HEADROOM)
+	{
+		scale = m_scale + m_step;
+	}
+
+	scale = std::clamp(scale, m_minScale, m_maxScale);
+
+	if (scale == m_scale)
+	{
+		return;
+	}
+
+#if defined(ACID_VERBOSE)
+	Log::Out("Dynamic resolution scale from %.3f to %.3f at %.3fms\n", m_scale, scale, m_gpuTime->AsMilliseconds<float>());
+#endif
+	m_scale = scale;
+	m_gpuTime = std::nullopt;
+	m_lastChange = now;
+	viewport.SetScale(Vector2f(m_scale));
+}
+}
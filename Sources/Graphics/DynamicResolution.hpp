@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that scales the viewport of a render stage to hold a GPU frame time, the scale follows the GPU timestamps read back by {@link Graphics}.
+ * The scaled stage should not hold the swapchain, a later stage brings it back to the display resolution with {@link FilterUpscale}.
+ * Scales are quantized to steps and changed at most every few hundred milliseconds, so the stages attachments are only recreated when a step is crossed.
+ */
+class ACID_EXPORT DynamicResolution :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new dynamic resolution controller, frames are timed on the GPU while it exists.
+	 * @param renderStage The index of the render stage that is scaled.
+	 * @param targetTime The GPU frame time to hold.
+	 * @param minScale The smallest viewport scale.
+	 * @param maxScale The largest viewport scale.
+	 * @param step The scale is changed in multiples of this.
+	 */
+	explicit DynamicResolution(const uint32_t &renderStage, const Time &targetTime = Time::Seconds(1.0f / 60.0f), const float &minScale = 0.5f,
+		const float &maxScale = 1.0f, const float &step = 0.125f);
+
+	~DynamicResolution();
+
+	/**
+	 * Scales the render stage from the last GPU frame time, this is called once per frame before the render stages update such as from {@link Renderer#Update}.
+	 */
+	void Update();
+
+	const uint32_t &GetRenderStage() const { return m_renderStage; }
+
+	const Time &GetTargetTime() const { return m_targetTime; }
+
+	void SetTargetTime(const Time &targetTime) { m_targetTime = targetTime; }
+
+	const float &GetMinScale() const { return m_minScale; }
+
+	void SetMinScale(const float &minScale) { m_minScale = minScale; }
+
+	const float &GetMaxScale() const { return m_maxScale; }
+
+	void SetMaxScale(const float &maxScale) { m_maxScale = maxScale; }
+
+	const float &GetScale() const { return m_scale; }
+
+	/**
+	 * Gets the smoothed GPU frame time measured at the current scale.
+	 * @return The GPU frame time, or nullopt if none has been measured since the scale last changed.
+	 */
+	const std::optional<Time> &GetGpuTime() const { return m_gpuTime; }
+
+private:
+	uint32_t m_renderStage;
+	Time m_targetTime;
+	float m_minScale;
+	float m_maxScale;
+	float m_step;
+
+	float m_scale;
+	std::optional<Time> m_gpuTime;
+	Time m_lastChange;
+};
+}
@@ -3,20 +3,71 @@
 #include <SPIRV/GlslangToSpv.h>
 #include "Devices/Window.hpp"
 #include "Files/FileSystem.hpp"
+#include "Buffers/GeometryHeap.hpp"
+#include "Buffers/UniformRing.hpp"
+#include "Commands/TimelineSemaphore.hpp"
+#include "Commands/UploadContext.hpp"
+#include "Descriptors/BindlessDescriptors.hpp"
+#include "Images/ImageReadback.hpp"
+#include "Images/ImageStreamer.hpp"
+#include "Images/MipmapGenerator.hpp"
+#include "Images/SamplerCache.hpp"
+#include "Pipelines/ShaderReloader.hpp"
+#include "Descriptors/DescriptorAllocator.hpp"
+#include "Renderpass/RenderGraph.hpp"
 #include "Subrender.hpp"
 
 namespace acid
 {
+const std::string PIPELINE_CACHE_FILENAME = "Cache/Pipelines.bin";
+// A display that stops showing images (e.g. a hidden window) should not stall the frame loop.
+static const Time PRESENT_WAIT_TIMEOUT = Time::Milliseconds(100);
+// Compute results may be read by any shader of the stages that wait for them.
+static const VkPipelineStageFlags COMPUTE_WAIT_STAGES = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+	VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+static void AddLatencyMarker(const std::string &name, const Time &start)
+{
+	auto profiler = Profiler::Get();
+
+	if (profiler == nullptr || !profiler->IsEnabled())
+	{
+		return;
+	}
+
+	profiler->AddMarker({ name, "latency", start, Engine::GetTime() - start, profiler->GetThreadIndex() });
+}
+
 Graphics::Graphics() :
 	m_renderer(nullptr),
 	m_swapchain(nullptr),
+	m_presentPolicy(Swapchain::PresentPolicy::LowLatency),
+	m_headlessSize(Engine::Get()->GetConfig().m_headlessSize),
 	m_timerPurge(Time::Seconds(4.0f)),
+	m_multithreaded(false),
 	m_pipelineCache(VK_NULL_HANDLE),
+	m_framesInFlight(2),
 	m_currentFrame(0),
+	m_frameCount(0),
+	m_frameWaited(false),
+	m_presentLimited(true),
+	m_gpuTimed(false),
+	m_split(false),
+	m_destroying(false),
 	m_instance(std::make_unique<Instance>()),
 	m_physicalDevice(std::make_unique<PhysicalDevice>(m_instance.get())),
 	m_surface(std::make_unique<Surface>(m_instance.get(), m_physicalDevice.get())),
-	m_logicalDevice(std::make_unique<LogicalDevice>(m_instance.get(), m_physicalDevice.get(), m_surface.get()))
+	m_logicalDevice(std::make_unique<LogicalDevice>(m_instance.get(), m_physicalDevice.get(), m_surface.get())),
+	m_memoryAllocator(std::make_unique<MemoryAllocator>(m_physicalDevice.get(), m_logicalDevice.get())),
+	m_descriptorAllocator(std::make_unique<DescriptorAllocator>()),
+	m_samplerCache(std::make_unique<SamplerCache>()),
+	m_mipmapGenerator(std::make_unique<MipmapGenerator>()),
+	m_renderGraph(std::make_unique<RenderGraph>()),
+	m_imageStreamer(std::make_unique<ImageStreamer>()),
+	m_shaderReloader(std::make_unique<ShaderReloader>()),
+	m_uploadContext(std::make_unique<UploadContext>()),
+	m_imageReadback(std::make_unique<ImageReadback>()),
+	m_heapGeometry(false)
 {
 	glslang::InitializeProcess();
 
@@ -29,33 +80,81 @@ Graphics::~Graphics()
 
 	CheckVk(vkQueueWaitIdle(graphicsQueue));
 
+	// Objects are destroyed immediately from here on, the device is idle.
+	m_destroying = true;
+	DestroyRetired(true);
+	m_imageStreamer = nullptr;
+	m_uploadContext = nullptr;
+	m_imageReadback = nullptr;
+	m_secondaryCommandBuffers.clear();
+	m_timestampQueries.clear();
+
+	// Releases everything that suballocates memory before the allocator is destroyed.
+	m_subrenderHolder.Clear();
+	m_renderer = nullptr;
+	m_renderStages.clear();
+	m_renderGraph = nullptr;
+	m_uniformRing = nullptr;
+	m_bindlessDescriptors = nullptr;
+	m_geometryHeaps.clear();
+	m_shaderReloader = nullptr;
+	m_mipmapGenerator = nullptr;
+	m_descriptorAllocator = nullptr;
+	m_swapchain = nullptr;
+
 	glslang::FinalizeProcess();
 
+	SavePipelineCache();
 	vkDestroyPipelineCache(*m_logicalDevice, m_pipelineCache, nullptr);
 
-	for (size_t i = 0; i < m_flightFences.size(); i++)
+	DestroyFrameResources();
+
+	for (const auto &renderComplete : m_renderCompletes)
 	{
-		vkDestroyFence(*m_logicalDevice, m_flightFences[i], nullptr);
-		vkDestroySemaphore(*m_logicalDevice, m_renderCompletes[i], nullptr);
-		vkDestroySemaphore(*m_logicalDevice, m_presentCompletes[i], nullptr);
+		vkDestroySemaphore(*m_logicalDevice, renderComplete, nullptr);
 	}
 }
 
 void Graphics::Update()
 {
-	if (m_renderer == nullptr || Window::Get()->IsIconified())
+	// Streaming continues while nothing is rendered.
+	m_imageStreamer->Update();
+	m_mipmapGenerator->Update();
+
+	// Pipelines are only swapped between frames, before any command buffer records them.
+	m_shaderReloader->Update();
+
+	UpdateMemoryCounters();
+
+	if (m_renderer == nullptr || (Engine::Get()->HasModule<Window>() && Window::Get()->IsIconified()))
 	{
+		m_uploadContext->Flush();
 		return;
 	}
 
 	m_renderer->Update();
 
-	VkResult acquireResult = m_swapchain->AcquireNextImage(m_presentCompletes[m_currentFrame]);
+	// Images and materials added by this frames scene update are written before anything is recorded.
+	if (m_bindlessDescriptors != nullptr)
+	{
+		m_bindlessDescriptors->Update(m_framesInFlight);
+	}
+
+	// Attachment lifetimes learned from the last frames no longer match the memory they share.
+	if (m_renderGraph->IsDirty())
+	{
+		RecreateRenderGraph();
+	}
+
+	// The acquire semaphore of this frame may still be waited on by its last submit.
+	WaitForFrame();
+	DestroyRetired();
+
+	VkResult acquireResult = m_swapchain->AcquireNextImage(m_presentCompletes[m_currentFrame], GetFrameDeviceMask());
 
 	if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR)
 	{
-		VkExtent2D displayExtent = { Window::Get()->GetSize().m_x, Window::Get()->GetSize().m_y };
-		m_swapchain = std::make_unique<Swapchain>(displayExtent);
+		CreateSwapchain();
 		return;
 	}
 
@@ -69,22 +168,48 @@ void Graphics::Update()
 	for (auto &renderStage : m_renderStages)
 	{
 		renderStage->Update();
+		m_renderGraph->SetStage(stage.first);
 
-		if (!StartRenderpass(*renderStage))
+		if (!StartRenderpass(*renderStage, stage.first))
 		{
+			m_renderGraph->SetStage(std::nullopt);
 			return;
 		}
 
+		auto &commandBuffer = GetFrameCommandBuffer();
+
 		for (const auto &subpass : renderStage->GetSubpasses())
 		{
 			stage.second = subpass.GetBinding();
 
 			// Renders subpass subrender pipelines.
-			m_subrenderHolder.RenderStage(stage, *m_commandBuffers[m_swapchain->GetActiveImageIndex()]);
+			if (m_multithreaded)
+			{
+				VkCommandBufferInheritanceInfo inheritanceInfo = {};
+				inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+				inheritanceInfo.renderPass = *renderStage->GetRenderpass();
+				inheritanceInfo.subpass = subpass.GetBinding();
+				inheritanceInfo.framebuffer = renderStage->GetActiveFramebuffer(m_swapchain->GetActiveImageIndex());
+
+				VkRect2D renderArea = {};
+				renderArea.offset = { renderStage->GetRenderArea().GetOffset().m_x, renderStage->GetRenderArea().GetOffset().m_y };
+				renderArea.extent = { renderStage->GetRenderArea().GetExtent().m_x, renderStage->GetRenderArea().GetExtent().m_y };
+
+				m_subrenderHolder.RenderStageSecondary(stage, commandBuffer, inheritanceInfo, renderArea, m_threadPool,
+					m_secondaryCommandBuffers[m_currentFrame]);
+			}
+			else
+			{
+				// Timestamps can only be written between subpasses when the subpass contents are inline.
+				auto &timestampQueries = *m_timestampQueries[m_currentFrame];
+				timestampQueries.Begin(commandBuffer, "RenderStage " + String::To(stage.first) + " Subpass " + String::To(stage.second));
+				m_subrenderHolder.RenderStage(stage, commandBuffer);
+				timestampQueries.End(commandBuffer);
+			}
 
 			if (subpass.GetBinding() != renderStage->GetSubpasses().back().GetBinding())
 			{
-				vkCmdNextSubpass(*m_commandBuffers[m_swapchain->GetActiveImageIndex()], VK_SUBPASS_CONTENTS_INLINE);
+				vkCmdNextSubpass(commandBuffer, GetSubpassContents());
 			}
 		}
 
@@ -92,11 +217,15 @@ void Graphics::Update()
 		stage.first++;
 	}
 
+	m_renderGraph->EndFrame();
+
 	// Purges unused command pools.
 	if (m_timerPurge.IsPassedTime())
 	{
 		m_timerPurge.ResetStartTime();
 
+		std::lock_guard<std::mutex> lock(m_commandPoolMutex);
+
 		for (auto it = m_commandPools.begin(); it != m_commandPools.end();)
 		{
 			if ((*it).second.use_count() <= 1)
@@ -110,6 +239,46 @@ void Graphics::Update()
 	}
 }
 
+void Graphics::WaitForFrame()
+{
+	if (m_presentCompletes.empty() || m_frameWaited)
+	{
+		return;
+	}
+
+	// Holds the CPU back until at most the frames in flight are waiting to be shown, this keeps the display queue from adding latency in FIFO modes.
+	if (m_presentLimited && m_logicalDevice->IsPresentWait() && m_swapchain->GetPresentId() >= m_framesInFlight)
+	{
+		auto presentId = m_swapchain->GetPresentId() - m_framesInFlight + 1;
+
+		if (m_swapchain->WaitForPresent(presentId, PRESENT_WAIT_TIMEOUT) == VK_SUCCESS)
+		{
+			while (!m_presentInputTimes.empty() && m_presentInputTimes.front().first <= presentId)
+			{
+				if (m_presentInputTimes.front().first == presentId)
+				{
+					AddLatencyMarker("Input To Photon", m_presentInputTimes.front().second);
+				}
+
+				m_presentInputTimes.pop_front();
+			}
+		}
+	}
+
+	if (m_frameTimeline != nullptr)
+	{
+		m_frameTimeline->Wait(m_frameValues[m_currentFrame]);
+	}
+	else
+	{
+		CheckVk(vkWaitForFences(*m_logicalDevice, 1, &m_flightFences[m_currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max()));
+	}
+
+	m_imageReadback->Complete(m_currentFrame);
+	m_frameWaited = true;
+	m_inputTime = Engine::GetTime();
+}
+
 std::string Graphics::StringifyResultVk(const VkResult &result)
 {
 	switch (result)
@@ -183,6 +352,11 @@ void Graphics::CheckVk(const VkResult &result)
 
 void Graphics::UpdateSurfaceCapabilities()
 {
+	if (*m_surface == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
 	CheckVk(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(*m_physicalDevice, *m_surface, &m_surface->m_capabilities));
 }
 
@@ -192,46 +366,74 @@ void Graphics::CaptureScreenshot(const std::string &filename)
 	auto debugStart = Engine::GetTime();
 #endif
 
-	auto extent = Window::Get()->GetSize();
+	m_imageReadback->ReadSwapchain([=](const uint8_t *texels, const Vector2ui &extent, const VkFormat &format)
+	{
+		if (format != VK_FORMAT_B8G8R8A8_UNORM && format != VK_FORMAT_B8G8R8A8_SRGB && format != VK_FORMAT_R8G8B8A8_UNORM && format != VK_FORMAT_R8G8B8A8_SRGB)
+		{
+			Log::Error("Screenshot '%s' could not be saved from format %i\n", filename.c_str(), format);
+			return;
+		}
 
-	VkImage dstImage;
-	VkDeviceMemory dstImageMemory;
-	bool supportsBlit = Image::CopyImage(m_swapchain->GetActiveImage(), dstImage, dstImageMemory, m_surface->GetFormat().format, { extent.m_x, extent.m_y, 1 },
-		VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0, 0);
+		auto size = static_cast<std::size_t>(extent.m_x) * extent.m_y * 4;
+		auto pixels = std::make_unique<uint8_t[]>(size);
+		std::memcpy(pixels.get(), texels, size);
 
-	// Get layout of the image (including row pitch).
-	VkImageSubresource imageSubresource = {};
-	imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	imageSubresource.mipLevel = 0;
-	imageSubresource.arrayLayer = 0;
+		// Image files are written as RGBA, copies do not convert formats like blits.
+		if (format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB)
+		{
+			for (std::size_t i = 0; i < size; i += 4)
+			{
+				std::swap(pixels[i], pixels[i + 2]);
+			}
+		}
 
-	VkSubresourceLayout dstSubresourceLayout;
-	vkGetImageSubresourceLayout(*m_logicalDevice, dstImage, &imageSubresource, &dstSubresourceLayout);
+		// Creates the screenshot image file and writes to it.
+		FileSystem::ClearFile(filename);
+		Image::WritePixels(filename, pixels.get(), extent);
 
-	auto pixels = std::make_unique<uint8_t[]>(dstSubresourceLayout.size);
+#if defined(ACID_VERBOSE)
+		auto debugEnd = Engine::GetTime();
+		Log::Out("Screenshot '%s' saved in %.3fms\n", filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
+#endif
+	});
+}
 
-	void *data;
-	vkMapMemory(*m_logicalDevice, dstImageMemory, dstSubresourceLayout.offset, dstSubresourceLayout.size, 0, &data);
-	std::memcpy(pixels.get(), data, static_cast<size_t>(dstSubresourceLayout.size));
-	vkUnmapMemory(*m_logicalDevice, dstImageMemory);
+Vector2ui Graphics::GetDisplaySize() const
+{
+	if (!Engine::Get()->HasModule<Window>())
+	{
+		return m_headlessSize;
+	}
 
-	// Frees temp image and memory.
-	vkFreeMemory(*m_logicalDevice, dstImageMemory, nullptr);
-	vkDestroyImage(*m_logicalDevice, dstImage, nullptr);
+	return Window::Get()->GetSize();
+}
 
-	// Creates the screenshot image file and writes to it.
-	FileSystem::ClearFile(filename);
-	Image::WritePixels(filename, pixels.get(), extent);
+float Graphics::GetDisplayAspectRatio() const
+{
+	auto displaySize = GetDisplaySize();
+	return static_cast<float>(displaySize.m_x) / static_cast<float>(displaySize.m_y);
+}
 
-#if defined(ACID_VERBOSE)
-	auto debugEnd = Engine::GetTime();
-	Log::Out("Screenshot '%s' saved in %.3fms\n", filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
-#endif
+uint32_t Graphics::GetFrameDeviceMask() const
+{
+	auto deviceCount = m_logicalDevice->GetDeviceCount();
+
+	if (deviceCount == 1)
+	{
+		return 0;
+	}
+
+	if (IsDeviceGroupSplit())
+	{
+		return m_logicalDevice->GetDeviceMask();
+	}
+
+	return 1u << (m_frameCount % deviceCount);
 }
 
 RenderStage *Graphics::GetRenderStage(const uint32_t &index) const
 {
-	if (m_renderStages.empty() || m_renderStages.size() < index)
+	if (m_renderStages.empty() || index >= m_renderStages.size())
 	{
 		return nullptr;
 	}
@@ -241,53 +443,111 @@ RenderStage *Graphics::GetRenderStage(const uint32_t &index) const
 
 void Graphics::SetRenderStages(std::vector<std::unique_ptr<RenderStage>> renderStages)
 {
-	VkExtent2D displayExtent = { Window::Get()->GetSize().m_x, Window::Get()->GetSize().m_y };
-
 	m_renderStages = std::move(renderStages);
-	m_swapchain = std::make_unique<Swapchain>(displayExtent);
+	CreateSwapchain();
 
-	if (m_flightFences.size() != m_swapchain->GetImageCount())
+	if (m_uniformRing == nullptr)
 	{
-		for (size_t i = 0; i < m_flightFences.size(); i++)
-		{
-			vkDestroyFence(*m_logicalDevice, m_flightFences[i], nullptr);
-			vkDestroySemaphore(*m_logicalDevice, m_renderCompletes[i], nullptr);
-			vkDestroySemaphore(*m_logicalDevice, m_presentCompletes[i], nullptr);
-		}
+		m_uniformRing = std::make_unique<UniformRing>();
+	}
 
-		m_presentCompletes.resize(m_swapchain->GetImageCount());
-		m_renderCompletes.resize(m_swapchain->GetImageCount());
-		m_flightFences.resize(m_swapchain->GetImageCount());
-		m_commandBuffers.resize(m_swapchain->GetImageCount());
+	if (m_bindlessDescriptors == nullptr && m_logicalDevice->IsDescriptorIndexing())
+	{
+		m_bindlessDescriptors = std::make_unique<BindlessDescriptors>();
+	}
 
-		VkSemaphoreCreateInfo semaphoreCreateInfo = {};
-		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	if (m_presentCompletes.size() != m_framesInFlight)
+	{
+		CreateFrameResources();
+	}
 
-		VkFenceCreateInfo fenceCreateInfo = {};
-		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+	for (const auto &renderStage : m_renderStages)
+	{
+		renderStage->Update();
+	}
 
-		for (size_t i = 0; i < m_flightFences.size(); i++)
-		{
-			CheckVk(vkCreateSemaphore(*m_logicalDevice, &semaphoreCreateInfo, nullptr, &m_presentCompletes[i]));
+	m_renderGraph->Plan(m_renderStages);
+
+	for (const auto &renderStage : m_renderStages)
+	{
+		renderStage->Rebuild(*m_swapchain);
+	}
 
-			CheckVk(vkCreateSemaphore(*m_logicalDevice, &semaphoreCreateInfo, nullptr, &m_renderCompletes[i]));
+	RecreateAttachmentsMap();
+	m_subrenderHolder.ClearCache();
+}
 
-			CheckVk(vkCreateFence(*m_logicalDevice, &fenceCreateInfo, nullptr, &m_flightFences[i]));
+void Graphics::SetPresentPolicy(const Swapchain::PresentPolicy &presentPolicy)
+{
+	if (m_presentPolicy == presentPolicy)
+	{
+		return;
+	}
 
-			m_commandBuffers[i] = std::make_unique<CommandBuffer>(false);
-		}
+	m_presentPolicy = presentPolicy;
+
+	if (m_swapchain != nullptr)
+	{
+		CreateSwapchain();
+		RecreateRenderGraph();
 	}
+}
 
-	for (const auto &renderStage : m_renderStages)
+void Graphics::SetFramesInFlight(const uint32_t &framesInFlight)
+{
+	auto clamped = std::max(framesInFlight, 1u);
+
+	if (m_framesInFlight == clamped)
 	{
-		renderStage->Rebuild(*m_swapchain);
+		return;
 	}
 
-	RecreateAttachmentsMap();
+	m_framesInFlight = clamped;
+
+	if (!m_presentCompletes.empty())
+	{
+		CreateFrameResources();
+	}
 }
 
-const Descriptor *Graphics::GetAttachment(const std::string &name) const
+void Graphics::Retire(std::function<void()> &&destroy)
+{
+	// The device is idle while the module is destroyed.
+	if (m_destroying)
+	{
+		destroy();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_retiredMutex);
+	m_retiring.emplace_back(std::move(destroy));
+}
+
+void Graphics::DestroyRetired(const bool &all)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_retiredMutex);
+
+		// Objects retired from other threads may have been used by the frame recorded last, so the frame count is only read here.
+		for (auto &destroy : m_retiring)
+		{
+			m_retired.emplace_back(m_frameCount, std::move(destroy));
+		}
+
+		m_retiring.clear();
+	}
+
+	// The frame being recorded when a object was retired may still use it, it is destroyed once that frames fence has been waited on.
+	while (!m_retired.empty() && (all || m_retired.front().first + m_framesInFlight < m_frameCount))
+	{
+		// Popped first, destroying a object may retire others.
+		auto destroy = std::move(m_retired.front().second);
+		m_retired.pop_front();
+		destroy();
+	}
+}
+
+const Descriptor *Graphics::GetAttachment(const std::string &name, const bool &input) const
 {
 	auto it = m_attachments.find(name);
 
@@ -296,60 +556,491 @@ const Descriptor *Graphics::GetAttachment(const std::string &name) const
 		return nullptr;
 	}
 
+	if (!m_renderGraph->RecordRead(name, m_attachmentStages.at(name), input))
+	{
+		return nullptr;
+	}
+
 	return it->second;
 }
 
-const std::shared_ptr<CommandPool> &Graphics::GetCommandPool(const std::thread::id &threadId)
+const std::shared_ptr<CommandPool> &Graphics::GetCommandPool(const std::thread::id &threadId, const VkQueueFlagBits &queueType)
 {
-	auto it = m_commandPools.find(threadId);
+	std::lock_guard<std::mutex> lock(m_commandPoolMutex);
+
+	auto key = std::make_pair(threadId, queueType);
+	auto it = m_commandPools.find(key);
 
 	if (it != m_commandPools.end())
 	{
 		return it->second;
 	}
 
-	m_commandPools.emplace(threadId, std::make_shared<CommandPool>(threadId));
-	return m_commandPools.find(threadId)->second; // TODO: Cleanup.
+	m_commandPools.emplace(key, std::make_shared<CommandPool>(threadId, queueType));
+	return m_commandPools.find(key)->second; // TODO: Cleanup.
+}
+
+std::shared_ptr<GeometryHeap> Graphics::GetGeometryHeap(const uint32_t &vertexSize, const VkIndexType &indexType)
+{
+	if (!m_heapGeometry)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(m_geometryHeapMutex);
+	auto &geometryHeap = m_geometryHeaps[{ vertexSize, indexType }];
+
+	if (geometryHeap == nullptr)
+	{
+		geometryHeap = std::make_shared<GeometryHeap>(vertexSize, indexType);
+	}
+
+	return geometryHeap;
+}
+
+VkSubpassContents Graphics::GetSubpassContents() const
+{
+	return m_multithreaded ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+}
+
+void Graphics::CreateSwapchain()
+{
+	auto displaySize = GetDisplaySize();
+	VkExtent2D displayExtent = { displaySize.m_x, displaySize.m_y };
+	// Frames in flight may still present images of the old swapchain, it is handed over to the new swapchain and destroyed once they have finished.
+	auto oldSwapchain = std::move(m_swapchain);
+	m_swapchain = std::make_unique<Swapchain>(displayExtent, m_presentPolicy,
+		oldSwapchain != nullptr ? std::optional<Reference<Swapchain>>(*oldSwapchain) : std::nullopt);
+	Retire(std::move(oldSwapchain));
+	m_presentInputTimes.clear();
+	m_deviceRenderAreas.clear();
+
+	// Each GPU of a split frame renders the part of the surface shown by its displays, or a equal column when a GPU does not report one.
+	if (IsDeviceGroupSplit())
+	{
+		auto &deviceGroup = m_physicalDevice->GetDeviceGroup();
+		auto columnWidth = displayExtent.width / static_cast<uint32_t>(deviceGroup.size());
+		bool reported = true;
+
+		for (const auto &device : deviceGroup)
+		{
+			uint32_t rectCount = 0;
+			vkGetPhysicalDevicePresentRectanglesKHR(device, *m_surface, &rectCount, nullptr);
+			std::vector<VkRect2D> rects(rectCount);
+			vkGetPhysicalDevicePresentRectanglesKHR(device, *m_surface, &rectCount, rects.data());
+
+			if (rects.empty())
+			{
+				reported = false;
+				break;
+			}
+
+			// The bounds of every rectangle shown by the GPU.
+			auto minX = rects[0].offset.x, minY = rects[0].offset.y;
+			auto maxX = rects[0].offset.x + static_cast<int32_t>(rects[0].extent.width), maxY = rects[0].offset.y + static_cast<int32_t>(rects[0].extent.height);
+
+			for (const auto &rect : rects)
+			{
+				minX = std::min(minX, rect.offset.x);
+				minY = std::min(minY, rect.offset.y);
+				maxX = std::max(maxX, rect.offset.x + static_cast<int32_t>(rect.extent.width));
+				maxY = std::max(maxY, rect.offset.y + static_cast<int32_t>(rect.extent.height));
+			}
+
+			m_deviceRenderAreas.emplace_back(VkRect2D{ { minX, minY }, { static_cast<uint32_t>(maxX - minX), static_cast<uint32_t>(maxY - minY) } });
+		}
+
+		if (!reported)
+		{
+			m_deviceRenderAreas.clear();
+
+			for (uint32_t i = 0; i < deviceGroup.size(); i++)
+			{
+				auto width = i + 1 == deviceGroup.size() ? displayExtent.width - i * columnWidth : columnWidth;
+				m_deviceRenderAreas.emplace_back(VkRect2D{ { static_cast<int32_t>(i * columnWidth), 0 }, { width, displayExtent.height } });
+			}
+		}
+	}
+
+	if (m_renderCompletes.size() == m_swapchain->GetImageCount())
+	{
+		return;
+	}
+
+	// Semaphores may still be waited on by the presents queued to the old swapchain.
+	Retire([logicalDevice = m_logicalDevice.get(), renderCompletes = std::move(m_renderCompletes)]()
+	{
+		for (const auto &renderComplete : renderCompletes)
+		{
+			vkDestroySemaphore(*logicalDevice, renderComplete, nullptr);
+		}
+	});
+
+	m_renderCompletes.clear();
+	m_renderCompletes.resize(m_swapchain->GetImageCount());
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	for (auto &renderComplete : m_renderCompletes)
+	{
+		CheckVk(vkCreateSemaphore(*m_logicalDevice, &semaphoreCreateInfo, nullptr, &renderComplete));
+	}
+}
+
+void Graphics::CreateFrameResources()
+{
+	DestroyFrameResources();
+
+	m_presentCompletes.resize(m_framesInFlight);
+	m_frameValues.assign(m_framesInFlight, 0);
+	m_commandBuffers.resize(m_framesInFlight);
+	m_secondaryCommandBuffers.resize(m_framesInFlight);
+	m_timestampQueries.resize(m_framesInFlight);
+	m_computeCommandBuffers.resize(m_framesInFlight);
+	m_splitCommandBuffers.resize(m_framesInFlight);
+	m_computeCompletes.resize(m_framesInFlight);
+	m_splitCompletes.resize(m_framesInFlight);
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+	// A new timeline starts at zero, which every frame in flight has already reached.
+	if (m_logicalDevice->IsTimelineSemaphore())
+	{
+		m_frameTimeline = std::make_unique<TimelineSemaphore>();
+	}
+	else
+	{
+		m_flightFences.resize(m_framesInFlight);
+	}
+
+	for (uint32_t i = 0; i < m_framesInFlight; i++)
+	{
+		CheckVk(vkCreateSemaphore(*m_logicalDevice, &semaphoreCreateInfo, nullptr, &m_presentCompletes[i]));
+
+		CheckVk(vkCreateSemaphore(*m_logicalDevice, &semaphoreCreateInfo, nullptr, &m_computeCompletes[i]));
+
+		CheckVk(vkCreateSemaphore(*m_logicalDevice, &semaphoreCreateInfo, nullptr, &m_splitCompletes[i]));
+
+		if (m_frameTimeline == nullptr)
+		{
+			CheckVk(vkCreateFence(*m_logicalDevice, &fenceCreateInfo, nullptr, &m_flightFences[i]));
+		}
+
+		m_commandBuffers[i] = std::make_unique<CommandBuffer>(false);
+		m_computeCommandBuffers[i] = std::make_unique<CommandBuffer>(false, VK_QUEUE_COMPUTE_BIT);
+		m_splitCommandBuffers[i] = std::make_unique<CommandBuffer>(false);
+		m_timestampQueries[i] = std::make_unique<TimestampQueries>();
+	}
+
+	m_currentFrame = 0;
+	m_frameWaited = false;
+	m_computeStage = std::nullopt;
+	m_split = false;
+}
+
+void Graphics::DestroyFrameResources()
+{
+	if (m_presentCompletes.empty())
+	{
+		return;
+	}
+
+	CheckVk(vkDeviceWaitIdle(*m_logicalDevice));
+
+	for (uint32_t i = 0; i < m_presentCompletes.size(); i++)
+	{
+		// Readbacks recorded in frames that will not be waited on again are finished by the idle device.
+		if (m_imageReadback != nullptr)
+		{
+			m_imageReadback->Complete(i);
+		}
+
+		vkDestroySemaphore(*m_logicalDevice, m_presentCompletes[i], nullptr);
+		vkDestroySemaphore(*m_logicalDevice, m_computeCompletes[i], nullptr);
+		vkDestroySemaphore(*m_logicalDevice, m_splitCompletes[i], nullptr);
+	}
+
+	for (const auto &flightFence : m_flightFences)
+	{
+		vkDestroyFence(*m_logicalDevice, flightFence, nullptr);
+	}
+
+	m_presentCompletes.clear();
+	m_flightFences.clear();
+	m_frameTimeline = nullptr;
+	m_frameValues.clear();
+	m_computeCompletes.clear();
+	m_splitCompletes.clear();
+	m_commandBuffers.clear();
+	m_computeCommandBuffers.clear();
+	m_splitCommandBuffers.clear();
+	m_secondaryCommandBuffers.clear();
+	m_timestampQueries.clear();
+}
+
+CommandBuffer &Graphics::GetFrameCommandBuffer() const
+{
+	return m_split ? *m_splitCommandBuffers[m_currentFrame] : *m_commandBuffers[m_currentFrame];
+}
+
+bool Graphics::IsDeviceGroupSplit() const
+{
+	return m_swapchain != nullptr && m_swapchain->GetDeviceGroupPresentModes() & VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_MULTI_DEVICE_BIT_KHR;
+}
+
+std::vector<VkRect2D> Graphics::GetDeviceRenderAreas(const VkRect2D &renderArea) const
+{
+	// Only screen sized stages are split, stages such as shadow maps are read whole by every GPU so each GPU renders them whole.
+	auto swapchainExtent = m_swapchain->GetExtent();
+
+	if (m_deviceRenderAreas.empty() || renderArea.extent.width != swapchainExtent.width || renderArea.extent.height != swapchainExtent.height)
+	{
+		return {};
+	}
+
+	auto deviceRenderAreas = m_deviceRenderAreas;
+
+	for (auto &deviceRenderArea : deviceRenderAreas)
+	{
+		deviceRenderArea.offset.x += renderArea.offset.x;
+		deviceRenderArea.offset.y += renderArea.offset.y;
+	}
+
+	return deviceRenderAreas;
+}
+
+void Graphics::BeginFrame()
+{
+	// The secondary buffers recorded for this frame, its uniform data and transient descriptor sets are no longer in use.
+	m_secondaryCommandBuffers[m_currentFrame].clear();
+	m_uniformRing->Reset(m_currentFrame, m_framesInFlight);
+	m_descriptorAllocator->Reset(m_currentFrame, m_framesInFlight);
+
+	// Uploads recorded since the last frame are submitted ahead of anything that could read them.
+	m_uploadContext->Flush();
+
+	// Compute is submitted before the render stages are recorded, so the compute queue can start on it right away.
+	auto deviceMask = GetFrameDeviceMask();
+	auto &computeCommandBuffer = *m_computeCommandBuffers[m_currentFrame];
+	computeCommandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr, deviceMask);
+	m_computeStage = m_subrenderHolder.RenderCompute(computeCommandBuffer);
+
+	if (m_computeStage)
+	{
+		computeCommandBuffer.Submit(VK_NULL_HANDLE, m_computeCompletes[m_currentFrame]);
+	}
+	else
+	{
+		computeCommandBuffer.End();
+	}
+
+	auto &commandBuffer = *m_commandBuffers[m_currentFrame];
+	commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr, deviceMask);
+	m_timestampQueries[m_currentFrame]->Reset(commandBuffer, m_gpuTimed);
+
+	if (auto gpuTime = m_timestampQueries[m_currentFrame]->GetGpuTime())
+	{
+		m_gpuFrameTime = gpuTime;
+	}
+}
+
+void Graphics::SplitFrame()
+{
+	// The stages before are submitted without waiting for compute, the rest of the frame waits for them and the compute queue.
+	m_uploadContext->Flush();
+	m_commandBuffers[m_currentFrame]->Submit(VK_NULL_HANDLE, m_splitCompletes[m_currentFrame]);
+	m_splitCommandBuffers[m_currentFrame]->Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr, GetFrameDeviceMask());
+	m_split = true;
+}
+
+void Graphics::UpdateMemoryCounters() const
+{
+	auto profiler = Profiler::Get();
+
+	if (profiler == nullptr || !profiler->IsEnabled())
+	{
+		return;
+	}
+
+	auto stats = m_memoryAllocator->GetStats();
+	profiler->SetCounter("VRAM Buffers", static_cast<double>(stats.m_bufferBytes));
+	profiler->SetCounter("VRAM Images", static_cast<double>(stats.m_imageBytes));
+	profiler->SetCounter("VRAM Reserved", static_cast<double>(stats.m_reservedBytes));
+
+	VkDeviceSize usage = 0;
+	VkDeviceSize budget = 0;
+
+	for (const auto &heapBudget : m_memoryAllocator->GetBudgets())
+	{
+		if (heapBudget.m_deviceLocal)
+		{
+			usage += heapBudget.m_usage;
+			budget += heapBudget.m_budget;
+		}
+	}
+
+	profiler->SetCounter("VRAM Usage", static_cast<double>(usage));
+	profiler->SetCounter("VRAM Budget", static_cast<double>(budget));
+	profiler->SetCounter("Samplers", static_cast<double>(m_samplerCache->GetSamplerCount()));
 }
 
 void Graphics::CreatePipelineCache()
 {
+	std::vector<char> cacheData;
+
+	if (FileSystem::Exists(PIPELINE_CACHE_FILENAME))
+	{
+		if (auto fileData = FileSystem::ReadBinaryFile(PIPELINE_CACHE_FILENAME); fileData && IsPipelineCacheCompatible(*fileData))
+		{
+			cacheData = std::move(*fileData);
+		}
+		else
+		{
+			Log::Out("Discarding pipeline cache '%s', it was created by a different device or driver\n", PIPELINE_CACHE_FILENAME.c_str());
+		}
+	}
+
 	VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
 	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	pipelineCacheCreateInfo.initialDataSize = cacheData.size();
+	pipelineCacheCreateInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
 	CheckVk(vkCreatePipelineCache(*m_logicalDevice, &pipelineCacheCreateInfo, nullptr, &m_pipelineCache));
 }
 
-void Graphics::RecreatePass(RenderStage &renderStage)
+bool Graphics::IsPipelineCacheCompatible(const std::vector<char> &cacheData) const
 {
-	auto graphicsQueue = m_logicalDevice->GetGraphicsQueue();
+	// Layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE.
+	struct PipelineCacheHeader
+	{
+		uint32_t headerSize;
+		uint32_t headerVersion;
+		uint32_t vendorId;
+		uint32_t deviceId;
+		uint8_t uuid[VK_UUID_SIZE];
+	};
+
+	if (cacheData.size() < sizeof(PipelineCacheHeader))
+	{
+		return false;
+	}
 
-	VkExtent2D displayExtent = { Window::Get()->GetSize().m_x, Window::Get()->GetSize().m_y };
+	PipelineCacheHeader header;
+	std::memcpy(&header, cacheData.data(), sizeof(PipelineCacheHeader));
 
-	CheckVk(vkQueueWaitIdle(graphicsQueue));
+	auto &properties = m_physicalDevice->GetProperties();
+	return header.headerSize >= sizeof(PipelineCacheHeader) && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		header.vendorId == properties.vendorID && header.deviceId == properties.deviceID &&
+		std::memcmp(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+void Graphics::SavePipelineCache() const
+{
+	std::size_t cacheSize = 0;
+
+	if (vkGetPipelineCacheData(*m_logicalDevice, m_pipelineCache, &cacheSize, nullptr) != VK_SUCCESS || cacheSize == 0)
+	{
+		return;
+	}
+
+	std::vector<char> cacheData(cacheSize);
+
+	if (vkGetPipelineCacheData(*m_logicalDevice, m_pipelineCache, &cacheSize, cacheData.data()) != VK_SUCCESS)
+	{
+		return;
+	}
+
+	cacheData.resize(cacheSize);
+	FileSystem::Create(PIPELINE_CACHE_FILENAME);
+	FileSystem::WriteBinaryFile(PIPELINE_CACHE_FILENAME, cacheData);
+}
+
+void Graphics::RecreatePass(RenderStage &renderStage)
+{
+	auto displaySize = GetDisplaySize();
+	VkExtent2D displayExtent = { displaySize.m_x, displaySize.m_y };
 
+	// Nothing waits for the frames in flight, the swapchain, images and framebuffers they use are retired and destroyed once they have finished.
 	if (renderStage.HasSwapchain() && !m_swapchain->IsSameExtent(displayExtent))
 	{
 #if defined(ACID_VERBOSE)
 		Log::Out("Resizing swapchain from (%i, %i) to (%i, %i)\n", m_swapchain->GetExtent().width, m_swapchain->GetExtent().height, displayExtent.width, displayExtent.height);
 #endif
-		m_swapchain = std::make_unique<Swapchain>(displayExtent);
+		CreateSwapchain();
+	}
+
+	auto it = std::find_if(m_renderStages.begin(), m_renderStages.end(), [&renderStage](const std::unique_ptr<RenderStage> &stage)
+	{
+		return stage.get() == &renderStage;
+	});
+	auto stage = static_cast<uint32_t>(it - m_renderStages.begin());
+
+	// Stages that share attachment memory with others are planned and rebuilt together.
+	if (m_renderGraph->IsAliased(stage))
+	{
+		RecreateRenderGraph();
+		return;
 	}
 
 	renderStage.Rebuild(*m_swapchain);
-	RecreateAttachmentsMap(); // TODO: Maybe not recreate on a single change.
+	UpdateAttachmentsMap(stage);
+	// Cached secondary command buffers reference the framebuffers that were replaced.
+	m_subrenderHolder.ClearCache();
 }
 
 void Graphics::RecreateAttachmentsMap()
 {
 	m_attachments.clear();
+	m_attachmentStages.clear();
+
+	for (uint32_t i = 0; i < m_renderStages.size(); i++)
+	{
+		m_attachments.insert(m_renderStages[i]->m_descriptors.begin(), m_renderStages[i]->m_descriptors.end());
+
+		for (const auto &[name, descriptor] : m_renderStages[i]->m_descriptors)
+		{
+			m_attachmentStages.emplace(name, i);
+		}
+	}
+}
+
+void Graphics::UpdateAttachmentsMap(const uint32_t &stage)
+{
+	for (const auto &[name, descriptor] : m_renderStages[stage]->m_descriptors)
+	{
+		// Attachment names given by a earlier stage are looked up there.
+		if (auto it = m_attachmentStages.find(name); it != m_attachmentStages.end() && it->second == stage)
+		{
+			m_attachments[name] = descriptor;
+		}
+	}
+}
 
+void Graphics::RecreateRenderGraph()
+{
+	// The memory of the previous plan is retired with the images bound into it.
 	for (const auto &renderStage : m_renderStages)
 	{
-		m_attachments.insert(renderStage->m_descriptors.begin(), renderStage->m_descriptors.end());
+		renderStage->Update();
 	}
+
+	m_renderGraph->Plan(m_renderStages);
+
+	for (const auto &renderStage : m_renderStages)
+	{
+		renderStage->Rebuild(*m_swapchain);
+	}
+
+	RecreateAttachmentsMap();
+	m_subrenderHolder.ClearCache();
 }
 
-bool Graphics::StartRenderpass(RenderStage &renderStage)
+bool Graphics::StartRenderpass(RenderStage &renderStage, const uint32_t &renderpass)
 {
 	if (renderStage.IsOutOfDate())
 	{
@@ -357,12 +1048,23 @@ bool Graphics::StartRenderpass(RenderStage &renderStage)
 		return false;
 	}
 
-	if (!m_commandBuffers[m_swapchain->GetActiveImageIndex()]->IsRunning())
+	if (!m_split && !m_commandBuffers[m_currentFrame]->IsRunning())
 	{
-		CheckVk(vkWaitForFences(*m_logicalDevice, 1, &m_flightFences[m_currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max()));
-		m_commandBuffers[m_swapchain->GetActiveImageIndex()]->Begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
+		BeginFrame();
+	}
+
+	if (m_computeStage && renderpass == *m_computeStage && renderpass != 0 && !m_split)
+	{
+		SplitFrame();
 	}
 
+	auto &commandBuffer = GetFrameCommandBuffer();
+
+	m_timestampQueries[m_currentFrame]->Begin(commandBuffer, "RenderStage " + String::To(renderpass));
+
+	// Work such as compute dispatches cannot be recorded inside of a renderpass.
+	m_subrenderHolder.PreRenderStage(renderpass, commandBuffer);
+
 	VkRect2D renderArea = {};
 	renderArea.offset = { renderStage.GetRenderArea().GetOffset().m_x, renderStage.GetRenderArea().GetOffset().m_y };
 	renderArea.extent = { renderStage.GetRenderArea().GetExtent().m_x, renderStage.GetRenderArea().GetExtent().m_y };
@@ -374,15 +1076,36 @@ bool Graphics::StartRenderpass(RenderStage &renderStage)
 	viewport.height = static_cast<float>(renderArea.extent.height);
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(*m_commandBuffers[m_swapchain->GetActiveImageIndex()], 0, 1, &viewport);
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
 	VkRect2D scissor = {};
 	scissor.offset = renderArea.offset;
 	scissor.extent = renderArea.extent;
-	vkCmdSetScissor(*m_commandBuffers[m_swapchain->GetActiveImageIndex()], 0, 1, &scissor);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	// Each GPU of a split frame only rasterizes its own area.
+	auto deviceMask = GetFrameDeviceMask();
+	auto deviceRenderAreas = GetDeviceRenderAreas(renderArea);
+
+	for (uint32_t i = 0; i < deviceRenderAreas.size(); i++)
+	{
+		vkCmdSetDeviceMask(commandBuffer, 1u << i);
+		vkCmdSetScissor(commandBuffer, 0, 1, &deviceRenderAreas[i]);
+	}
+
+	if (!deviceRenderAreas.empty())
+	{
+		vkCmdSetDeviceMask(commandBuffer, deviceMask);
+	}
 
 	auto clearValues = renderStage.GetClearValues();
 
+	VkDeviceGroupRenderPassBeginInfo deviceGroupRenderPassBeginInfo = {};
+	deviceGroupRenderPassBeginInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_RENDER_PASS_BEGIN_INFO;
+	deviceGroupRenderPassBeginInfo.deviceMask = deviceMask;
+	deviceGroupRenderPassBeginInfo.deviceRenderAreaCount = static_cast<uint32_t>(deviceRenderAreas.size());
+	deviceGroupRenderPassBeginInfo.pDeviceRenderAreas = deviceRenderAreas.data();
+
 	VkRenderPassBeginInfo renderPassBeginInfo = {};
 	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 	renderPassBeginInfo.renderPass = *renderStage.GetRenderpass();
@@ -390,7 +1113,13 @@ bool Graphics::StartRenderpass(RenderStage &renderStage)
 	renderPassBeginInfo.renderArea = renderArea;
 	renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 	renderPassBeginInfo.pClearValues = clearValues.data();
-	vkCmdBeginRenderPass(*m_commandBuffers[m_swapchain->GetActiveImageIndex()], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	if (deviceMask != 0)
+	{
+		renderPassBeginInfo.pNext = &deviceGroupRenderPassBeginInfo;
+	}
+
+	vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, GetSubpassContents());
 
 	return true;
 }
@@ -399,27 +1128,73 @@ void Graphics::EndRenderpass(RenderStage &renderStage)
 {
 	auto presentQueue = m_logicalDevice->GetPresentQueue();
 
-	vkCmdEndRenderPass(*m_commandBuffers[m_swapchain->GetActiveImageIndex()]);
+	auto &commandBuffer = GetFrameCommandBuffer();
+	auto &renderComplete = m_renderCompletes[m_swapchain->GetActiveImageIndex()];
+
+	vkCmdEndRenderPass(commandBuffer);
+	m_timestampQueries[m_currentFrame]->End(commandBuffer);
 
 	if (!renderStage.HasSwapchain())
 	{
 		return;
 	}
 
-	m_commandBuffers[m_swapchain->GetActiveImageIndex()]->End();
-	m_commandBuffers[m_swapchain->GetActiveImageIndex()]->Submit(m_presentCompletes[m_currentFrame], m_renderCompletes[m_currentFrame], m_flightFences[m_currentFrame]);
-	VkResult presentResult = m_swapchain->QueuePresent(presentQueue, m_renderCompletes[m_currentFrame]);
+	auto swapchainExtent = m_swapchain->GetExtent();
+	m_imageReadback->CmdRecord(commandBuffer, m_currentFrame, m_swapchain->GetActiveImage(), m_surface->GetFormat().format,
+		{ swapchainExtent.width, swapchainExtent.height });
+
+	std::vector<VkSemaphore> waitSemaphores = { m_presentCompletes[m_currentFrame] };
+	std::vector<VkPipelineStageFlags> waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+
+	if (m_split)
+	{
+		waitSemaphores.emplace_back(m_splitCompletes[m_currentFrame]);
+		waitStages.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+	}
+
+	if (m_computeStage)
+	{
+		waitSemaphores.emplace_back(m_computeCompletes[m_currentFrame]);
+		waitStages.emplace_back(COMPUTE_WAIT_STAGES);
+	}
 
-	if (!(presentResult == VK_SUCCESS || presentResult == VK_SUBOPTIMAL_KHR))
+	commandBuffer.End();
+	m_uploadContext->Flush();
+	if (m_frameTimeline != nullptr)
 	{
-		if (presentResult == VK_ERROR_OUT_OF_DATE_KHR)
+		m_frameValues[m_currentFrame] = m_frameCount + 1;
+		commandBuffer.Submit(waitSemaphores, waitStages, renderComplete, VK_NULL_HANDLE, *m_frameTimeline, m_frameValues[m_currentFrame]);
+	}
+	else
+	{
+		commandBuffer.Submit(waitSemaphores, waitStages, renderComplete, m_flightFences[m_currentFrame]);
+	}
+	m_computeStage = std::nullopt;
+	m_split = false;
+	auto presentId = m_swapchain->GetPresentId();
+	VkResult presentResult = m_swapchain->QueuePresent(presentQueue, renderComplete, GetFrameDeviceMask());
+
+	// The submit owns this frames resources whether or not the present succeeds, the next frame uses its own.
+	m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+	m_frameCount++;
+	m_frameWaited = false;
+
+	if (presentResult == VK_SUCCESS || presentResult == VK_SUBOPTIMAL_KHR)
+	{
+		AddLatencyMarker("Input To Present", m_inputTime);
+
+		if (m_presentLimited && m_swapchain->GetPresentId() != presentId)
 		{
-			RecreatePass(renderStage);
-			return;
+			m_presentInputTimes.emplace_back(m_swapchain->GetPresentId(), m_inputTime);
 		}
+	}
+	else if (presentResult == VK_ERROR_OUT_OF_DATE_KHR)
+	{
+		RecreatePass(renderStage);
+	}
+	else
+	{
 		CheckVk(presentResult);
 	}
-
-	m_currentFrame = (m_currentFrame + 1) % m_swapchain->GetImageCount();
 }
 }
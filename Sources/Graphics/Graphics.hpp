@@ -1,10 +1,14 @@
 #pragma once
 
+#include <deque>
 #include <vulkan/vulkan.h>
 #include "Engine/Engine.hpp"
+#include "Helpers/ThreadPool.hpp"
 #include "Maths/Timer.hpp"
 #include "Commands/CommandBuffer.hpp"
 #include "Commands/CommandPool.hpp"
+#include "Commands/TimestampQueries.hpp"
+#include "Memory/MemoryAllocator.hpp"
 #include "Devices/Instance.hpp"
 #include "Devices/LogicalDevice.hpp"
 #include "Devices/PhysicalDevice.hpp"
@@ -15,6 +19,19 @@
 
 namespace acid
 {
+class BindlessDescriptors;
+class GeometryHeap;
+class ImageReadback;
+class ImageStreamer;
+class MipmapGenerator;
+class SamplerCache;
+class ShaderReloader;
+class DescriptorAllocator;
+class RenderGraph;
+class UniformRing;
+class UploadContext;
+class TimelineSemaphore;
+
 /**
  * @brief Module that manages the Vulkan instance, Surface, Window and the renderpass structure.
  */
@@ -34,6 +51,12 @@ public:
 
 	void Update() override;
 
+	/**
+	 * Waits until the resources of the next frame are no longer used by the GPU, and until the display has caught up when present waits are enabled.
+	 * The engine calls this before input is sampled so the wait does not add to the frames input latency, calling it again before the frame is recorded does nothing.
+	 */
+	void WaitForFrame();
+
 	static std::string StringifyResultVk(const VkResult &result);
 
 	static void CheckVk(const VkResult &result);
@@ -41,7 +64,8 @@ public:
 	void UpdateSurfaceCapabilities();
 
 	/**
-	 * Takes a screenshot of the current image of the display and saves it into a image file.
+	 * Takes a screenshot of the next image presented to the display and saves it into a image file.
+	 * The image is read back once its frame has completed and is encoded on a worker, so this does not stall rendering.
 	 * @param filename The file to save the screenshot to.
 	 */
 	void CaptureScreenshot(const std::string &filename);
@@ -115,11 +139,135 @@ public:
 
 	void SetRenderStages(std::vector<std::unique_ptr<RenderStage>> renderStages);
 
-	const Descriptor *GetAttachment(const std::string &name) const;
+	/**
+	 * Gets a render stage attachment by name, the lookup is recorded so attachments that are not read at the same time can share memory.
+	 * @param name The attachment name.
+	 * @param input If the attachment is read as a input attachment of the subpass, this does not keep its contents in memory after the stage that renders it.
+	 * @return The attachment, or nullptr if it does not exist or is never read.
+	 */
+	const Descriptor *GetAttachment(const std::string &name, const bool &input = false) const;
+
+	/**
+	 * Gets the graph that places render stage attachments into shared memory.
+	 * @return The render graph.
+	 */
+	RenderGraph *GetRenderGraph() const { return m_renderGraph.get(); }
 
 	const Swapchain *GetSwapchain() const { return m_swapchain.get(); }
 
-	const std::shared_ptr<CommandPool> &GetCommandPool(const std::thread::id &threadId = std::this_thread::get_id());
+	/**
+	 * Gets the size frames are rendered at, the size of the window or the headless size when the engine has no window.
+	 * @return The display size.
+	 */
+	Vector2ui GetDisplaySize() const;
+
+	float GetDisplayAspectRatio() const;
+
+	/**
+	 * Sets the size frames are rendered at when the engine has no window, render stages are rebuilt at the new size on the next frame.
+	 * @param headlessSize The headless size.
+	 */
+	void SetHeadlessSize(const Vector2ui &headlessSize) { m_headlessSize = headlessSize; }
+
+	const Swapchain::PresentPolicy &GetPresentPolicy() const { return m_presentPolicy; }
+
+	/**
+	 * Sets how the swapchain picks its present mode, the swapchain is recreated if it exists.
+	 * @param presentPolicy The present policy.
+	 */
+	void SetPresentPolicy(const Swapchain::PresentPolicy &presentPolicy);
+
+	/**
+	 * Gets the number of frames the CPU can record ahead of the GPU, this is independent from the swapchain image count.
+	 * @return The frames in flight.
+	 */
+	const uint32_t &GetFramesInFlight() const { return m_framesInFlight; }
+
+	/**
+	 * Sets the number of frames the CPU can record ahead of the GPU, fewer frames lowers latency at the cost of less overlap between the CPU and GPU.
+	 * @param framesInFlight The frames in flight, at least one.
+	 */
+	void SetFramesInFlight(const uint32_t &framesInFlight);
+
+	/**
+	 * Gets the index of the frame being recorded, per frame resources are indexed with this.
+	 * @return The current frame, less than the frames in flight.
+	 */
+	const uint32_t &GetCurrentFrame() const { return m_currentFrame; }
+
+	/**
+	 * Gets the number of frames that have been submitted, this is used to tell frames apart when values are kept from one frame to the next.
+	 * @return The number of submitted frames.
+	 */
+	const uint64_t &GetFrameCount() const { return m_frameCount; }
+
+	/**
+	 * Destroys a object once the frames that may still use it have finished, such as the swapchain and images replaced when the window is resized.
+	 * Buffers, images and descriptor sets retire their handles when they are destroyed, so they can be released while frames are in flight.
+	 * This is safe to call from any thread, objects retired while the module is being destroyed are destroyed immediately.
+	 * @param destroy The function that destroys the object.
+	 */
+	void Retire(std::function<void()> &&destroy);
+
+	/**
+	 * Destroys a object once the frames that may still use it have finished.
+	 * @tparam T The object type.
+	 * @param object The object, nothing is done if it is nullptr.
+	 */
+	template<typename T>
+	void Retire(std::unique_ptr<T> &&object)
+	{
+		if (object != nullptr)
+		{
+			Retire([object = std::shared_ptr<T>(std::move(object))]() mutable
+			{
+				object = nullptr;
+			});
+		}
+	}
+
+	/**
+	 * Gets the GPUs of the device group that render the frame being recorded, alternate frames are rendered by one GPU and split frames by all of them.
+	 * Frame resources such as attachments have a instance on every GPU, so effects that read the last frame read the last frame rendered by the same GPU.
+	 * @return The device mask, zero when there is no device group.
+	 */
+	uint32_t GetFrameDeviceMask() const;
+
+	/**
+	 * Gets if the CPU waits for earlier images to be shown, so no more images than the frames in flight are queued for the display.
+	 * @return If presentation is limited, this only has a effect when the device supports present waits.
+	 */
+	const bool &IsPresentLimited() const { return m_presentLimited; }
+
+	void SetPresentLimited(const bool &presentLimited) { m_presentLimited = presentLimited; }
+
+	/**
+	 * Gets if render stages are timed on the GPU even when the profiler is disabled, such as for {@link DynamicResolution}.
+	 * @return If frames are timed on the GPU.
+	 */
+	const bool &IsGpuTimed() const { return m_gpuTimed; }
+
+	void SetGpuTimed(const bool &gpuTimed) { m_gpuTimed = gpuTimed; }
+
+	/**
+	 * Gets the GPU time taken by the render stages of the last frame that has been read back, this is a few frames behind.
+	 * @return The GPU frame time, or nullopt if frames are not timed or the device does not support timestamps.
+	 */
+	const std::optional<Time> &GetGpuFrameTime() const { return m_gpuFrameTime; }
+
+	const std::shared_ptr<CommandPool> &GetCommandPool(const std::thread::id &threadId = std::this_thread::get_id(), const VkQueueFlagBits &queueType = VK_QUEUE_GRAPHICS_BIT);
+
+	/**
+	 * Gets if subrenders are recorded into secondary command buffers on worker threads.
+	 * @return If subrender recording is multithreaded.
+	 */
+	const bool &IsMultithreaded() const { return m_multithreaded; }
+
+	/**
+	 * Sets if subrenders are recorded into secondary command buffers on worker threads, every Subrender must then be safe to render in parallel with the others.
+	 * @param multithreaded If subrender recording is multithreaded.
+	 */
+	void SetMultithreaded(const bool &multithreaded) { m_multithreaded = multithreaded; }
 
 	const VkPipelineCache &GetPipelineCache() const { return m_pipelineCache; }
 
@@ -129,14 +277,140 @@ public:
 
 	const LogicalDevice *GetLogicalDevice() const { return m_logicalDevice.get(); }
 
+	MemoryAllocator *GetMemoryAllocator() const { return m_memoryAllocator.get(); }
+
+	/**
+	 * Gets the allocator descriptor sets are allocated from, shared by every pipeline.
+	 * @return The descriptor allocator.
+	 */
+	DescriptorAllocator *GetDescriptorAllocator() const { return m_descriptorAllocator.get(); }
+
+	/**
+	 * Gets the cache samplers are shared from, every image sampled with the same parameters uses the same sampler.
+	 * @return The sampler cache.
+	 */
+	SamplerCache *GetSamplerCache() const { return m_samplerCache.get(); }
+
+	/**
+	 * Gets the generator that creates the mip chain of images in one compute dispatch.
+	 * @return The mipmap generator.
+	 */
+	MipmapGenerator *GetMipmapGenerator() const { return m_mipmapGenerator.get(); }
+
+	/**
+	 * Gets the streamer that decodes and uploads images in the background.
+	 * @return The image streamer.
+	 */
+	ImageStreamer *GetImageStreamer() const { return m_imageStreamer.get(); }
+
+	/**
+	 * Gets the reloader that rebuilds graphics pipelines when their shader files change, directories are watched with ShaderReloader::Watch.
+	 * @return The shader reloader.
+	 */
+	ShaderReloader *GetShaderReloader() const { return m_shaderReloader.get(); }
+
+	/**
+	 * Gets the context resource uploads are batched into, the batch is submitted ahead of each frame submission.
+	 * @return The upload context.
+	 */
+	UploadContext *GetUploadContext() const { return m_uploadContext.get(); }
+
+	/**
+	 * Gets the readback that copies images and presented frames to the host without stalling.
+	 * @return The image readback.
+	 */
+	ImageReadback *GetImageReadback() const { return m_imageReadback.get(); }
+
+	/**
+	 * Gets the ring that uniform handlers copy their per frame data into, this is created with the render stages.
+	 * @return The uniform ring, or nullptr if there are no render stages yet.
+	 */
+	UniformRing *GetUniformRing() const { return m_uniformRing.get(); }
+
+	/**
+	 * Gets the descriptors shared by bindless pipelines, this is created with the render stages.
+	 * @return The bindless descriptors, or nullptr if there are no render stages yet or the device does not support descriptor indexing.
+	 */
+	BindlessDescriptors *GetBindlessDescriptors() const { return m_bindlessDescriptors.get(); }
+
+	/**
+	 * Gets if models are suballocated from geometry heaps, so draws of models with the same vertex type share buffers.
+	 * @return If models use geometry heaps.
+	 */
+	const bool &IsHeapGeometry() const { return m_heapGeometry; }
+
+	/**
+	 * Sets if models are suballocated from geometry heaps, this only changes models created afterwards.
+	 * @param heapGeometry If models use geometry heaps.
+	 */
+	void SetHeapGeometry(const bool &heapGeometry) { m_heapGeometry = heapGeometry; }
+
+	/**
+	 * Gets the geometry heap for a vertex size and index type, creating it the first time it is used.
+	 * @param vertexSize The size of one vertex in bytes.
+	 * @param indexType The type of the indices.
+	 * @return The geometry heap, or nullptr if models do not use geometry heaps.
+	 */
+	std::shared_ptr<GeometryHeap> GetGeometryHeap(const uint32_t &vertexSize, const VkIndexType &indexType);
+
 private:
+	VkSubpassContents GetSubpassContents() const;
+
+	void CreateSwapchain();
+
+	void CreateFrameResources();
+
+	void DestroyFrameResources();
+
+	CommandBuffer &GetFrameCommandBuffer() const;
+
+	/**
+	 * Gets if the GPUs of the device group each render and present a part of every frame.
+	 * @return If frames are split between GPUs.
+	 */
+	bool IsDeviceGroupSplit() const;
+
+	/**
+	 * Gets the area of each GPU in the device group for a render stage of a split frame.
+	 * @param renderArea The area of the render stage.
+	 * @return The area of each GPU, empty when the stage is rendered whole by every GPU.
+	 */
+	std::vector<VkRect2D> GetDeviceRenderAreas(const VkRect2D &renderArea) const;
+
+	void BeginFrame();
+
+	void SplitFrame();
+
+	/**
+	 * Sets the device memory used by buffers and images, and the usage and budget of device local heaps, as counters of the profilers frame.
+	 */
+	void UpdateMemoryCounters() const;
+
 	void CreatePipelineCache();
 
+	bool IsPipelineCacheCompatible(const std::vector<char> &cacheData) const;
+
+	void SavePipelineCache() const;
+
 	void RecreatePass(RenderStage &renderStage);
 
 	void RecreateAttachmentsMap();
 
-	bool StartRenderpass(RenderStage &renderStage);
+	/**
+	 * Replaces the descriptors a render stage gives to the attachments map, the attachments of other stages are left as they are.
+	 * @param stage The render stage index.
+	 */
+	void UpdateAttachmentsMap(const uint32_t &stage);
+
+	void RecreateRenderGraph();
+
+	/**
+	 * Destroys retired objects whose frames have finished.
+	 * @param all If every retired object is destroyed, the device must then be idle.
+	 */
+	void DestroyRetired(const bool &all = false);
+
+	bool StartRenderpass(RenderStage &renderStage, const uint32_t &renderpass);
 
 	void EndRenderpass(RenderStage &renderStage);
 
@@ -144,22 +418,78 @@ private:
 	SubrenderHolder m_subrenderHolder;
 	std::vector<std::unique_ptr<RenderStage>> m_renderStages;
 	std::map<std::string, const Descriptor *> m_attachments;
+	std::map<std::string, uint32_t> m_attachmentStages;
 	std::unique_ptr<Swapchain> m_swapchain;
+	Swapchain::PresentPolicy m_presentPolicy;
+	Vector2ui m_headlessSize;
 
-	std::map<std::thread::id, std::shared_ptr<CommandPool>> m_commandPools;
+	std::map<std::pair<std::thread::id, VkQueueFlagBits>, std::shared_ptr<CommandPool>> m_commandPools;
+	std::mutex m_commandPoolMutex;
 	Timer m_timerPurge;
 
+	bool m_multithreaded;
+	ThreadPool m_threadPool;
+	std::vector<std::vector<std::unique_ptr<CommandBuffer>>> m_secondaryCommandBuffers;
+
 	VkPipelineCache m_pipelineCache;
+	uint32_t m_framesInFlight;
+	uint32_t m_currentFrame;
+	uint64_t m_frameCount;
+	bool m_frameWaited;
+	bool m_presentLimited;
+	bool m_gpuTimed;
+	std::optional<Time> m_gpuFrameTime;
+	// Per frame in flight, signaled when the acquired image can be rendered to and when the frames commands have finished.
 	std::vector<VkSemaphore> m_presentCompletes;
-	std::vector<VkSemaphore> m_renderCompletes;
 	std::vector<VkFence> m_flightFences;
-	size_t m_currentFrame;
+	// With timeline semaphores each frame signals its number on the timeline instead of a fence, the value each frame in flight waits for before it is reused.
+	std::unique_ptr<TimelineSemaphore> m_frameTimeline;
+	std::vector<uint64_t> m_frameValues;
+	// Per swapchain image, a presented image may still wait on its semaphore after the frame that rendered it is reused.
+	std::vector<VkSemaphore> m_renderCompletes;
+
+	// Per frame in flight, compute work recorded by subrenders runs on the compute queue, stages before the first stage that reads it are submitted on their own so they overlap.
+	std::vector<std::unique_ptr<CommandBuffer>> m_computeCommandBuffers;
+	std::vector<std::unique_ptr<CommandBuffer>> m_splitCommandBuffers;
+	std::vector<VkSemaphore> m_computeCompletes;
+	std::vector<VkSemaphore> m_splitCompletes;
+	std::optional<uint32_t> m_computeStage;
+	bool m_split;
+
+	// The part of the surface each GPU of a split frame renders and presents.
+	std::vector<VkRect2D> m_deviceRenderAreas;
+
+	// The time input was sampled for the frame being recorded, and for each present id still waiting to be shown.
+	Time m_inputTime;
+	std::deque<std::pair<uint64_t, Time>> m_presentInputTimes;
+
+	// Objects replaced while frames may still use them, those retired since the last frame are given its frame count when it starts.
+	std::deque<std::pair<uint64_t, std::function<void()>>> m_retired;
+	std::vector<std::function<void()>> m_retiring;
+	std::mutex m_retiredMutex;
+	std::atomic<bool> m_destroying;
 
 	std::vector<std::unique_ptr<CommandBuffer>> m_commandBuffers;
+	std::vector<std::unique_ptr<TimestampQueries>> m_timestampQueries;
 
 	std::unique_ptr<Instance> m_instance;
 	std::unique_ptr<PhysicalDevice> m_physicalDevice;
 	std::unique_ptr<Surface> m_surface;
 	std::unique_ptr<LogicalDevice> m_logicalDevice;
+	std::unique_ptr<MemoryAllocator> m_memoryAllocator;
+	std::unique_ptr<DescriptorAllocator> m_descriptorAllocator;
+	std::unique_ptr<SamplerCache> m_samplerCache;
+	std::unique_ptr<MipmapGenerator> m_mipmapGenerator;
+	std::unique_ptr<RenderGraph> m_renderGraph;
+	std::unique_ptr<ImageStreamer> m_imageStreamer;
+	std::unique_ptr<ShaderReloader> m_shaderReloader;
+	std::unique_ptr<UploadContext> m_uploadContext;
+	std::unique_ptr<ImageReadback> m_imageReadback;
+	std::unique_ptr<UniformRing> m_uniformRing;
+	std::unique_ptr<BindlessDescriptors> m_bindlessDescriptors;
+
+	bool m_heapGeometry;
+	std::map<std::pair<uint32_t, VkIndexType>, std::shared_ptr<GeometryHeap>> m_geometryHeaps;
+	std::mutex m_geometryHeapMutex;
 };
 }
@@ -2,8 +2,11 @@
 
 #include "Graphics/Graphics.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
 #include "Files/FileSystem.hpp"
 #include "Files/Files.hpp"
+#include "Maths/Simd.hpp"
+#include "MipmapGenerator.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -11,7 +14,63 @@
 
 namespace acid
 {
-static const float ANISOTROPY = 16.0f;
+static const char COOKED_MAGIC[4] = { 'A', 'C', 'T', 'X' };
+
+/**
+ * @brief The header of a cooked texture, followed by pixels in the format they are uploaded with.
+ */
+class CookedPixels
+{
+public:
+	char m_magic[4];
+	uint32_t m_width;
+	uint32_t m_height;
+	uint32_t m_components;
+	uint32_t m_format;
+	uint32_t m_reserved[3];
+};
+
+/**
+ * Expands tightly packed RGB pixels into RGBA with an opaque alpha, several pixels at a time where the instruction set allows.
+ * @param src The RGB pixels.
+ * @param dst The RGBA pixels written.
+ * @param count The number of pixels.
+ */
+static void ExpandRgbToRgba(const uint8_t *src, uint8_t *dst, const std::size_t &count)
+{
+	std::size_t i = 0;
+
+#if defined(ACID_SIMD_SSE) && defined(__SSSE3__)
+	// Each load reads 16 bytes for 4 pixels, so it stops while 6 pixels remain to stay within the source.
+	auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	auto alpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+
+	for (; i + 6 <= count; i += 4)
+	{
+		auto rgb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+	}
+#elif defined(ACID_SIMD_NEON)
+	for (; i + 8 <= count; i += 8)
+	{
+		auto rgb = vld3_u8(src + i * 3);
+		uint8x8x4_t rgba;
+		rgba.val[0] = rgb.val[0];
+		rgba.val[1] = rgb.val[1];
+		rgba.val[2] = rgb.val[2];
+		rgba.val[3] = vdup_n_u8(255);
+		vst4_u8(dst + i * 4, rgba);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		dst[i * 4 + 0] = src[i * 3 + 0];
+		dst[i * 4 + 1] = src[i * 3 + 1];
+		dst[i * 4 + 2] = src[i * 3 + 2];
+		dst[i * 4 + 3] = 255;
+	}
+}
 
 Image::Image(const VkExtent3D &extent, const VkImageType &imageType, const VkFormat &format, const VkSampleCountFlagBits &samples, const VkImageTiling &tiling,
 	const VkImageUsageFlags &usage, const VkMemoryPropertyFlags &properties, const uint32_t &mipLevels, const uint32_t &arrayLayers) :
@@ -26,7 +85,6 @@ Image::Image(const VkExtent3D &extent, const VkImageType &imageType, const VkFor
 	//m_anisotropic(anisotropic),
 	//m_layout(layout),
 	m_image(VK_NULL_HANDLE),
-	m_memory(VK_NULL_HANDLE),
 	m_sampler(VK_NULL_HANDLE),
 	m_view(VK_NULL_HANDLE)
 {
@@ -37,12 +95,7 @@ Image::Image(const VkExtent3D &extent, const VkImageType &imageType, const VkFor
 
 Image::~Image()
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-
-	vkDestroyImageView(*logicalDevice, m_view, nullptr);
-	vkDestroySampler(*logicalDevice, m_sampler, nullptr);
-	vkFreeMemory(*logicalDevice, m_memory, nullptr);
-	vkDestroyImage(*logicalDevice, m_image, nullptr);
+	DestroyImage(m_image, m_view, m_memory);
 }
 
 VkDescriptorSetLayoutBinding Image::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage, const uint32_t &count)
@@ -83,7 +136,7 @@ std::unique_ptr<uint8_t[]> Image::GetPixels(VkExtent3D &extent, const uint32_t &
 	extent.depth = 1;
 
 	VkImage dstImage;
-	VkDeviceMemory dstImageMemory;
+	MemoryAllocation dstImageMemory;
 	CopyImage(m_image, dstImage, dstImageMemory, m_format, m_extent, m_layout, mipLevel, arrayLayer);
 
 	VkImageSubresource dstImageSubresource = {};
@@ -97,11 +150,10 @@ std::unique_ptr<uint8_t[]> Image::GetPixels(VkExtent3D &extent, const uint32_t &
 	auto pixels = std::make_unique<uint8_t[]>(dstSubresourceLayout.size);
 
 	void *data;
-	vkMapMemory(*logicalDevice, dstImageMemory, dstSubresourceLayout.offset, dstSubresourceLayout.size, 0, &data);
+	data = static_cast<uint8_t *>(dstImageMemory.GetMapped()) + dstSubresourceLayout.offset;
 	std::memcpy(pixels.get(), data, static_cast<size_t>(dstSubresourceLayout.size));
-	vkUnmapMemory(*logicalDevice, dstImageMemory);
 
-	vkFreeMemory(*logicalDevice, dstImageMemory, nullptr);
+	Graphics::Get()->GetMemoryAllocator()->Free(dstImageMemory);
 	vkDestroyImage(*logicalDevice, dstImage, nullptr);
 
 	return pixels;
@@ -109,20 +161,15 @@ std::unique_ptr<uint8_t[]> Image::GetPixels(VkExtent3D &extent, const uint32_t &
 
 void Image::SetPixels(const uint8_t *pixels, const uint32_t &layerCount, const uint32_t &baseArrayLayer)
 {
-	Buffer bufferStaging = Buffer(m_extent.width * m_extent.height * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-	void *data;
-	bufferStaging.MapMemory(&data);
-	std::memcpy(data, pixels, bufferStaging.GetSize());
-	bufferStaging.UnmapMemory();
-
-	CopyBufferToImage(bufferStaging.GetBuffer(), m_image, m_extent, layerCount, baseArrayLayer);
+	Graphics::Get()->GetUploadContext()->Record(pixels, m_extent.width * m_extent.height * 4, [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+	{
+		CmdCopyBufferToImage(commandBuffer, bufferStaging.GetBuffer(), m_image, m_extent, layerCount, baseArrayLayer);
+	});
 }
 
 std::unique_ptr<uint8_t[]> Image::LoadPixels(const std::string &filename, Vector2ui &extent, uint32_t &components, VkFormat &format)
 {
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::ReadView(filename);
 
 	if (!fileLoaded)
 	{
@@ -130,20 +177,102 @@ std::unique_ptr<uint8_t[]> Image::LoadPixels(const std::string &filename, Vector
 		return nullptr;
 	}
 
-	std::unique_ptr<uint8_t[]> pixels(
-		stbi_load_from_memory(reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size()), reinterpret_cast<int32_t *>(&extent.m_x),
-			reinterpret_cast<int32_t *>(&extent.m_y), reinterpret_cast<int32_t *>(&components), STBI_rgb_alpha));
+	return LoadPixels(*fileLoaded, filename, extent, components, format);
+}
+
+std::unique_ptr<uint8_t[]> Image::LoadPixels(const FileView &file, const std::string &filename, Vector2ui &extent, uint32_t &components, VkFormat &format)
+{
+	// Textures cooked into a pack are already decoded, so they are copied out without going through stb.
+	if (file.GetSize() >= sizeof(CookedPixels) && std::memcmp(file.GetData(), COOKED_MAGIC, sizeof(COOKED_MAGIC)) == 0)
+	{
+		CookedPixels cooked;
+		std::memcpy(&cooked, file.GetData(), sizeof(CookedPixels));
+		auto size = static_cast<std::size_t>(cooked.m_width) * cooked.m_height * cooked.m_components;
+
+		if (size > file.GetSize() - sizeof(CookedPixels))
+		{
+			Log::Error("Cooked image is truncated: '%s'\n", filename.c_str());
+			return nullptr;
+		}
+
+		extent = Vector2ui(cooked.m_width, cooked.m_height);
+		components = cooked.m_components;
+		format = static_cast<VkFormat>(cooked.m_format);
+
+		std::unique_ptr<uint8_t[]> pixels(new uint8_t[size]);
+		std::memcpy(pixels.get(), file.GetData() + sizeof(CookedPixels), size);
+		return pixels;
+	}
+
+	auto pixels = DecodePixels(file.GetData(), file.GetSize(), extent, components, format);
+
+	if (pixels == nullptr)
+	{
+		Log::Error("Unable to load Image: '%s'\n", filename.c_str());
+	}
+
+	return pixels;
+}
+
+std::unique_ptr<uint8_t[]> Image::DecodePixels(const uint8_t *data, const std::size_t &size, Vector2ui &extent, uint32_t &components, VkFormat &format)
+{
+	int32_t width;
+	int32_t height;
+	int32_t channels;
+
+	// Images are uploaded as RGBA, RGB images are decoded as they are stored and expanded here instead of one pixel at a time by stb.
+	if (stbi_info_from_memory(data, static_cast<int32_t>(size), &width, &height, &channels) != 0 && channels == STBI_rgb)
+	{
+		std::unique_ptr<uint8_t[], decltype(&stbi_image_free)> rgb(
+			stbi_load_from_memory(data, static_cast<int32_t>(size), &width, &height, &channels, STBI_rgb), stbi_image_free);
+
+		if (rgb != nullptr)
+		{
+			auto count = static_cast<std::size_t>(width) * height;
+			std::unique_ptr<uint8_t[]> pixels(new uint8_t[count * 4]);
+			ExpandRgbToRgba(rgb.get(), pixels.get(), count);
+
+			extent = Vector2ui(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+			components = 4;
+			format = VK_FORMAT_R8G8B8A8_UNORM;
+			return pixels;
+		}
+	}
+
+	std::unique_ptr<uint8_t[]> pixels(stbi_load_from_memory(data, static_cast<int32_t>(size), reinterpret_cast<int32_t *>(&extent.m_x),
+		reinterpret_cast<int32_t *>(&extent.m_y), reinterpret_cast<int32_t *>(&components), STBI_rgb_alpha));
 
 	// STBI_rgb_alpha converts the loaded image to a 32 bit image, if another loader is used components and format may differ.
 	components = 4;
 	format = VK_FORMAT_R8G8B8A8_UNORM;
+	return pixels;
+}
+
+std::optional<std::vector<uint8_t>> Image::CookPixels(const FileView &file)
+{
+	Vector2ui extent;
+	uint32_t components;
+	VkFormat format;
+	auto pixels = DecodePixels(file.GetData(), file.GetSize(), extent, components, format);
 
 	if (pixels == nullptr)
 	{
-		Log::Error("Unable to load Image: '%s'\n", filename.c_str());
+		return std::nullopt;
 	}
 
-	return pixels;
+	// Matches the layout LoadPixels decodes into.
+	CookedPixels cooked = {};
+	std::memcpy(cooked.m_magic, COOKED_MAGIC, sizeof(COOKED_MAGIC));
+	cooked.m_width = extent.m_x;
+	cooked.m_height = extent.m_y;
+	cooked.m_components = components;
+	cooked.m_format = static_cast<uint32_t>(format);
+
+	auto size = static_cast<std::size_t>(cooked.m_width) * cooked.m_height * cooked.m_components;
+	std::vector<uint8_t> result(sizeof(CookedPixels) + size);
+	std::memcpy(result.data(), &cooked, sizeof(CookedPixels));
+	std::memcpy(result.data() + sizeof(CookedPixels), pixels.get(), size);
+	return result;
 }
 
 void Image::WritePixels(const std::string &filename, const uint8_t *pixels, const Vector2ui &extent, const int32_t &components)
@@ -174,11 +303,53 @@ bool Image::HasStencil(const VkFormat &format)
 	return std::find(STENCIL_FORMATS.begin(), STENCIL_FORMATS.end(), format) != std::end(STENCIL_FORMATS);
 }
 
-void Image::CreateImage(VkImage &image, VkDeviceMemory &memory, const VkExtent3D &extent, const VkFormat &format, const VkSampleCountFlagBits &samples, const VkImageTiling &tiling,
-	const VkImageUsageFlags &usage, const VkMemoryPropertyFlags &properties, const uint32_t &mipLevels, const uint32_t &arrayLayers, const VkImageType &type)
+uint32_t Image::GetFormatSize(const VkFormat &format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R8_UNORM:
+		return 1;
+	case VK_FORMAT_R8G8_UNORM:
+	case VK_FORMAT_R16_SFLOAT:
+		return 2;
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_R8G8B8A8_SRGB:
+	case VK_FORMAT_B8G8R8A8_UNORM:
+	case VK_FORMAT_R16G16_SFLOAT:
+	case VK_FORMAT_R32_SFLOAT:
+	case VK_FORMAT_R32_UINT:
+		return 4;
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+	case VK_FORMAT_R32G32_SFLOAT:
+	case VK_FORMAT_R32G32_UINT:
+		return 8;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+VkDeviceSize Image::GetImageDataSize(const VkFormat &format, const VkExtent3D &extent, const uint32_t &mipLevels, const uint32_t &arrayLayers)
+{
+	VkDeviceSize size = 0;
+
+	for (uint32_t i = 0; i < mipLevels; i++)
+	{
+		size += static_cast<VkDeviceSize>(std::max(extent.width >> i, 1u)) * std::max(extent.height >> i, 1u) * std::max(extent.depth >> i, 1u) * arrayLayers;
+	}
+
+	return size * GetFormatSize(format);
+}
+
+void Image::CreateImage(VkImage &image, MemoryAllocation &memory, const VkExtent3D &extent, const VkFormat &format, const VkSampleCountFlagBits &samples, const VkImageTiling &tiling,
+	const VkImageUsageFlags &usage, const VkMemoryPropertyFlags &properties, const uint32_t &mipLevels, const uint32_t &arrayLayers, const VkImageType &type,
+	const MemoryAllocator::Lifetime &lifetime)
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
+	std::array<uint32_t, 2> queueFamily = { logicalDevice->GetGraphicsFamily(), logicalDevice->GetComputeFamily() };
+
 	VkImageCreateInfo imageCreateInfo = {};
 	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 	imageCreateInfo.flags = arrayLayers == 6 ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
@@ -192,44 +363,59 @@ void Image::CreateImage(VkImage &image, VkDeviceMemory &memory, const VkExtent3D
 	imageCreateInfo.usage = usage;
 	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	// Images compute can write are shared with a async compute family, other images stay exclusive so they keep their compression.
+	if (usage & VK_IMAGE_USAGE_STORAGE_BIT && logicalDevice->IsAsyncCompute())
+	{
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		imageCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamily.size());
+		imageCreateInfo.pQueueFamilyIndices = queueFamily.data();
+	}
+
 	Graphics::CheckVk(vkCreateImage(*logicalDevice, &imageCreateInfo, nullptr, &image));
 
 	VkMemoryRequirements memoryRequirements;
 	vkGetImageMemoryRequirements(*logicalDevice, image, &memoryRequirements);
 
-	VkMemoryAllocateInfo memoryAllocateInfo = {};
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.allocationSize = memoryRequirements.size;
-	memoryAllocateInfo.memoryTypeIndex = Buffer::FindMemoryType(memoryRequirements.memoryTypeBits, properties);
-	Graphics::CheckVk(vkAllocateMemory(*logicalDevice, &memoryAllocateInfo, nullptr, &memory));
+	memory = Graphics::Get()->GetMemoryAllocator()->Allocate(memoryRequirements, properties, tiling == VK_IMAGE_TILING_LINEAR, lifetime);
 
-	Graphics::CheckVk(vkBindImageMemory(*logicalDevice, image, memory, 0));
+	Graphics::CheckVk(vkBindImageMemory(*logicalDevice, image, memory.GetMemory(), memory.GetOffset()));
 }
 
-void Image::CreateImageSampler(VkSampler &sampler, const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic, const uint32_t &mipLevels)
+void Image::CreateAliasedImage(VkImage &image, const MemoryAllocation &memory, const VkExtent3D &extent, const VkFormat &format, const VkSampleCountFlagBits &samples,
+	const VkImageTiling &tiling, const VkImageUsageFlags &usage, const uint32_t &mipLevels, const uint32_t &arrayLayers, const VkImageType &type)
 {
-	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
-	VkSamplerCreateInfo samplerCreateInfo = {};
-	samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-	samplerCreateInfo.magFilter = filter;
-	samplerCreateInfo.minFilter = filter;
-	samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-	samplerCreateInfo.addressModeU = addressMode;
-	samplerCreateInfo.addressModeV = addressMode;
-	samplerCreateInfo.addressModeW = addressMode;
-	samplerCreateInfo.mipLodBias = 0.0f;
-	samplerCreateInfo.anisotropyEnable = static_cast<VkBool32>(anisotropic);
-	samplerCreateInfo.maxAnisotropy =
-		(anisotropic && logicalDevice->GetEnabledFeatures().samplerAnisotropy) ? std::min(ANISOTROPY, physicalDevice->GetProperties().limits.maxSamplerAnisotropy) : 1.0f;
-	//samplerCreateInfo.compareEnable = VK_FALSE;
-	//samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-	samplerCreateInfo.minLod = 0.0f;
-	samplerCreateInfo.maxLod = static_cast<float>(mipLevels);
-	samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
-	samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
-	Graphics::CheckVk(vkCreateSampler(*logicalDevice, &samplerCreateInfo, nullptr, &sampler));
+	VkImageCreateInfo imageCreateInfo = {};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.flags = arrayLayers == 6 ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+	imageCreateInfo.imageType = type;
+	imageCreateInfo.format = format;
+	imageCreateInfo.extent = extent;
+	imageCreateInfo.mipLevels = mipLevels;
+	imageCreateInfo.arrayLayers = arrayLayers;
+	imageCreateInfo.samples = samples;
+	imageCreateInfo.tiling = tiling;
+	imageCreateInfo.usage = usage;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	Graphics::CheckVk(vkCreateImage(*logicalDevice, &imageCreateInfo, nullptr, &image));
+
+	VkMemoryRequirements memoryRequirements;
+	vkGetImageMemoryRequirements(*logicalDevice, image, &memoryRequirements);
+
+	if (memoryRequirements.size > memory.GetSize() || memory.GetOffset() % memoryRequirements.alignment != 0)
+	{
+		throw std::runtime_error("Aliased memory does not fit the image requirements");
+	}
+
+	Graphics::CheckVk(vkBindImageMemory(*logicalDevice, image, memory.GetMemory(), memory.GetOffset()));
+}
+
+VkSampler Image::GetImageSampler(const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic)
+{
+	return Graphics::Get()->GetSamplerCache()->Get(filter, addressMode, anisotropic);
 }
 
 void Image::CreateImageView(const VkImage &image, VkImageView &imageView, const VkImageViewType &type, const VkFormat &format, const VkImageAspectFlags &imageAspect,
@@ -251,11 +437,38 @@ void Image::CreateImageView(const VkImage &image, VkImageView &imageView, const
 	Graphics::CheckVk(vkCreateImageView(*logicalDevice, &imageViewCreateInfo, nullptr, &imageView));
 }
 
+void Image::DestroyImage(const VkImage &image, const VkImageView &imageView, const MemoryAllocation &memory)
+{
+	Graphics::Get()->Retire([image, imageView, memory]() mutable
+	{
+		auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+		vkDestroyImageView(*logicalDevice, imageView, nullptr);
+		Graphics::Get()->GetMemoryAllocator()->Free(memory);
+		vkDestroyImage(*logicalDevice, image, nullptr);
+	});
+}
+
 void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, const VkFormat &format, const VkImageLayout &dstImageLayout, const uint32_t &mipLevels,
-	const uint32_t &baseArrayLayer, const uint32_t &layerCount)
+	const uint32_t &baseArrayLayer, const uint32_t &layerCount, const VkImageUsageFlags &usage)
+{
+	Graphics::Get()->GetUploadContext()->Record([&](const CommandBuffer &commandBuffer)
+	{
+		CmdCreateMipmaps(commandBuffer, image, extent, format, dstImageLayout, mipLevels, baseArrayLayer, layerCount, usage);
+	});
+}
+
+void Image::CmdCreateMipmaps(const CommandBuffer &commandBuffer, const VkImage &image, const VkExtent3D &extent, const VkFormat &format,
+	const VkImageLayout &dstImageLayout, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount, const VkImageUsageFlags &usage)
 {
 	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
 
+	// One dispatch replaces the serial chain of blits, each of which waits on the level before.
+	if (baseArrayLayer == 0 && Graphics::Get()->GetMipmapGenerator()->CmdGenerate(commandBuffer, image, extent, format, usage, dstImageLayout, mipLevels, layerCount))
+	{
+		return;
+	}
+
 	// Get device properites for the requested Image format.
 	VkFormatProperties formatProperties;
 	vkGetPhysicalDeviceFormatProperties(*physicalDevice, format, &formatProperties);
@@ -264,8 +477,6 @@ void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, const
 	assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT);
 	assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
 
-	CommandBuffer commandBuffer = CommandBuffer();
-
 	for (uint32_t i = 1; i < mipLevels; i++)
 	{
 		VkImageMemoryBarrier barrier0 = {};
@@ -329,15 +540,11 @@ void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, const
 	barrier.subresourceRange.baseArrayLayer = baseArrayLayer;
 	barrier.subresourceRange.layerCount = layerCount;
 	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-	commandBuffer.SubmitIdle();
 }
 
 void Image::TransitionImageLayout(const VkImage &image, const VkFormat &format, const VkImageLayout &srcImageLayout, const VkImageLayout &dstImageLayout,
 	const VkImageAspectFlags &imageAspect, const uint32_t &mipLevels, const uint32_t &baseMipLevel, const uint32_t &layerCount, const uint32_t &baseArrayLayer)
 {
-	CommandBuffer commandBuffer = CommandBuffer();
-
 	VkImageMemoryBarrier imageMemoryBarrier = {};
 	imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 	imageMemoryBarrier.oldLayout = srcImageLayout;
@@ -408,12 +615,37 @@ void Image::TransitionImageLayout(const VkImage &image, const VkFormat &format,
 		break;
 	}
 
-	VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-	VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	// Transitions are queued together into one barrier, which only waits on the stages that use the layouts.
+	auto srcStageMask = GetLayoutStages(srcImageLayout);
 
-	vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+	if (srcImageLayout == VK_IMAGE_LAYOUT_UNDEFINED && imageMemoryBarrier.srcAccessMask != 0)
+	{
+		srcStageMask = VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	}
 
-	commandBuffer.SubmitIdle();
+	Graphics::Get()->GetUploadContext()->Barrier(imageMemoryBarrier, srcStageMask, GetLayoutStages(dstImageLayout));
+}
+
+VkPipelineStageFlags Image::GetLayoutStages(const VkImageLayout &imageLayout)
+{
+	switch (imageLayout)
+	{
+	case VK_IMAGE_LAYOUT_UNDEFINED:
+		return VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	case VK_IMAGE_LAYOUT_PREINITIALIZED:
+		return VK_PIPELINE_STAGE_HOST_BIT;
+	case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+	case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+		return VK_PIPELINE_STAGE_TRANSFER_BIT;
+	case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+		return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+		return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+		return VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	default:
+		return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	}
 }
 
 void Image::InsertImageMemoryBarrier(const CommandBuffer &commandBuffer, const VkImage &image, const VkAccessFlags &srcAccessMask, const VkAccessFlags &dstAccessMask,
@@ -440,7 +672,13 @@ void Image::InsertImageMemoryBarrier(const CommandBuffer &commandBuffer, const V
 void Image::CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent, const uint32_t &layerCount, const uint32_t &baseArrayLayer)
 {
 	CommandBuffer commandBuffer = CommandBuffer();
+	CmdCopyBufferToImage(commandBuffer, buffer, image, extent, layerCount, baseArrayLayer);
+	commandBuffer.SubmitIdle();
+}
 
+void Image::CmdCopyBufferToImage(const CommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent,
+	const uint32_t &layerCount, const uint32_t &baseArrayLayer)
+{
 	VkBufferImageCopy region = {};
 	region.bufferOffset = 0;
 	region.bufferRowLength = 0;
@@ -452,11 +690,9 @@ void Image::CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, cons
 	region.imageOffset = { 0, 0, 0 };
 	region.imageExtent = extent;
 	vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-	commandBuffer.SubmitIdle();
 }
 
-bool Image::CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, const VkFormat &srcFormat, const VkExtent3D &extent,
+bool Image::CopyImage(const VkImage &srcImage, VkImage &dstImage, MemoryAllocation &dstImageMemory, const VkFormat &srcFormat, const VkExtent3D &extent,
 	const VkImageLayout &srcImageLayout, const uint32_t &mipLevel, const uint32_t &arrayLayer)
 {
 	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
@@ -485,7 +721,8 @@ bool Image::CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory
 	}
 
 	CreateImage(dstImage, dstImageMemory, extent, VK_FORMAT_R8G8B8A8_UNORM, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_LINEAR,
-		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1, 1, VK_IMAGE_TYPE_2D);
+		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1, 1, VK_IMAGE_TYPE_2D,
+		MemoryAllocator::Lifetime::Transient);
 
 	// Do the actual blit from the swapchain image to our host visible destination image.
 	CommandBuffer commandBuffer = CommandBuffer();
@@ -544,4 +781,86 @@ bool Image::CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory
 
 	return supportsBlit;
 }
+
+std::vector<char> Image::ReadImageData(const VkImage &image, const VkFormat &format, const VkExtent3D &extent, const VkImageLayout &layout,
+	const uint32_t &mipLevels, const uint32_t &arrayLayers)
+{
+	auto size = GetImageDataSize(format, extent, mipLevels, arrayLayers);
+
+	if (size == 0)
+	{
+		return {};
+	}
+
+	Buffer bufferStaging = Buffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, nullptr,
+		MemoryAllocator::Lifetime::Transient);
+
+	std::vector<VkBufferImageCopy> regions(mipLevels);
+	VkDeviceSize offset = 0;
+
+	for (uint32_t i = 0; i < mipLevels; i++)
+	{
+		VkExtent3D levelExtent = { std::max(extent.width >> i, 1u), std::max(extent.height >> i, 1u), std::max(extent.depth >> i, 1u) };
+		regions[i].bufferOffset = offset;
+		regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		regions[i].imageSubresource.mipLevel = i;
+		regions[i].imageSubresource.baseArrayLayer = 0;
+		regions[i].imageSubresource.layerCount = arrayLayers;
+		regions[i].imageExtent = levelExtent;
+		offset += GetImageDataSize(format, levelExtent, 1, arrayLayers);
+	}
+
+	CommandBuffer commandBuffer = CommandBuffer();
+	InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+	vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, bufferStaging.GetBuffer(), static_cast<uint32_t>(regions.size()), regions.data());
+	InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_MEMORY_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, layout,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+	commandBuffer.SubmitIdle();
+
+	std::vector<char> data(size);
+	void *mapped;
+	bufferStaging.MapMemory(&mapped);
+	std::memcpy(data.data(), mapped, data.size());
+	bufferStaging.UnmapMemory();
+	return data;
+}
+
+bool Image::WriteImageData(const VkImage &image, const VkFormat &format, const VkExtent3D &extent, const VkImageLayout &layout, const uint32_t &mipLevels,
+	const uint32_t &arrayLayers, const std::vector<char> &data)
+{
+	auto size = GetImageDataSize(format, extent, mipLevels, arrayLayers);
+
+	if (size == 0 || size != data.size())
+	{
+		return false;
+	}
+
+	std::vector<VkBufferImageCopy> regions(mipLevels);
+	VkDeviceSize offset = 0;
+
+	for (uint32_t i = 0; i < mipLevels; i++)
+	{
+		VkExtent3D levelExtent = { std::max(extent.width >> i, 1u), std::max(extent.height >> i, 1u), std::max(extent.depth >> i, 1u) };
+		regions[i].bufferOffset = offset;
+		regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		regions[i].imageSubresource.mipLevel = i;
+		regions[i].imageSubresource.baseArrayLayer = 0;
+		regions[i].imageSubresource.layerCount = arrayLayers;
+		regions[i].imageExtent = levelExtent;
+		offset += GetImageDataSize(format, levelExtent, 1, arrayLayers);
+	}
+
+	// The previous contents are overwritten, so the image is moved from a undefined layout.
+	Graphics::Get()->GetUploadContext()->Record(data.data(), size, [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+	{
+		InsertImageMemoryBarrier(commandBuffer, image, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+		vkCmdCopyBufferToImage(commandBuffer, bufferStaging.GetBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()),
+			regions.data());
+		InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+	});
+	return true;
+}
 }
@@ -4,6 +4,8 @@
 #include "Maths/Vector2.hpp"
 #include "Graphics/Commands/CommandBuffer.hpp"
 #include "Graphics/Descriptors/Descriptor.hpp"
+#include "Graphics/Memory/MemoryAllocator.hpp"
+#include "Files/FileView.hpp"
 
 namespace acid
 {
@@ -76,9 +78,9 @@ public:
 
 	const VkImageLayout &GetLayout() const { return m_layout; }
 
-	const VkImage &GetImage() { return m_image; }
+	const VkImage &GetImage() const { return m_image; }
 
-	const VkDeviceMemory &GetMemory() { return m_memory; }
+	const MemoryAllocation &GetMemory() const { return m_memory; }
 
 	const VkSampler &GetSampler() const { return m_sampler; }
 
@@ -86,6 +88,35 @@ public:
 
 	static std::unique_ptr<uint8_t[]> LoadPixels(const std::string &filename, Vector2ui &extent, uint32_t &components, VkFormat &format);
 
+	/**
+	 * Decodes the contents of a image file already read, such as by acid::AsyncReader, the file may be encoded or cooked into a pack.
+	 * @param file The contents of the file.
+	 * @param filename The file read, used in errors.
+	 * @param extent Set to the extent of the image.
+	 * @param components Set to the number of components per pixel.
+	 * @param format Set to the format of the pixels.
+	 * @return The pixels, or nullptr if the image could not be decoded.
+	 */
+	static std::unique_ptr<uint8_t[]> LoadPixels(const FileView &file, const std::string &filename, Vector2ui &extent, uint32_t &components, VkFormat &format);
+
+	/**
+	 * Decodes a encoded image held in memory, such as a image embedded in a model file, into 32 bit pixels.
+	 * @param data The encoded image.
+	 * @param size The size of the encoded image.
+	 * @param extent Set to the extent of the image.
+	 * @param components Set to the number of components per pixel.
+	 * @param format Set to the format of the pixels.
+	 * @return The pixels, or nullptr if the image could not be decoded.
+	 */
+	static std::unique_ptr<uint8_t[]> DecodePixels(const uint8_t *data, const std::size_t &size, Vector2ui &extent, uint32_t &components, VkFormat &format);
+
+	/**
+	 * Decodes a image file into a cooked texture, these are loaded by {@link Image#LoadPixels} without being decoded again.
+	 * @param file The contents of the image file.
+	 * @return The cooked texture, or nullopt if the image could not be decoded.
+	 */
+	static std::optional<std::vector<uint8_t>> CookPixels(const FileView &file);
+
 	static void WritePixels(const std::string &filename, const uint8_t *pixels, const Vector2ui &extent, const int32_t &components = 4);
 
 	static uint32_t GetMipLevels(const VkExtent3D &extent);
@@ -104,30 +135,100 @@ public:
 	 */
 	static bool HasStencil(const VkFormat &format);
 
-	static void CreateImage(VkImage &image, VkDeviceMemory &memory, const VkExtent3D &extent, const VkFormat &format, const VkSampleCountFlagBits &samples,
+	/**
+	 * Gets the size of one texel of a uncompressed colour format.
+	 * @param format The format to check.
+	 * @return The texel size in bytes, or zero if the format is not supported.
+	 */
+	static uint32_t GetFormatSize(const VkFormat &format);
+
+	/**
+	 * Gets the size of every mip level and array layer of a image packed together, as read by {@link Image#ReadImageData}.
+	 * @return The size in bytes, or zero if the format is not supported.
+	 */
+	static VkDeviceSize GetImageDataSize(const VkFormat &format, const VkExtent3D &extent, const uint32_t &mipLevels, const uint32_t &arrayLayers);
+
+	static void CreateImage(VkImage &image, MemoryAllocation &memory, const VkExtent3D &extent, const VkFormat &format, const VkSampleCountFlagBits &samples,
 		const VkImageTiling &tiling, const VkImageUsageFlags &usage, const VkMemoryPropertyFlags &properties, const uint32_t &mipLevels, const uint32_t &arrayLayers,
-		const VkImageType &type);
+		const VkImageType &type, const MemoryAllocator::Lifetime &lifetime = MemoryAllocator::Lifetime::Persistent);
 
-	static void CreateImageSampler(VkSampler &sampler, const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic, const uint32_t &mipLevels);
+	/**
+	 * Creates a image bound at the start of memory that is owned by the caller, the memory must be large enough and of a type the image accepts.
+	 */
+	static void CreateAliasedImage(VkImage &image, const MemoryAllocation &memory, const VkExtent3D &extent, const VkFormat &format, const VkSampleCountFlagBits &samples,
+		const VkImageTiling &tiling, const VkImageUsageFlags &usage, const uint32_t &mipLevels, const uint32_t &arrayLayers, const VkImageType &type);
+
+	/**
+	 * Gets the sampler shared by every image sampled with the same parameters from the {@link SamplerCache}, it must not be destroyed.
+	 */
+	static VkSampler GetImageSampler(const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic);
 
 	static void CreateImageView(const VkImage &image, VkImageView &imageView, const VkImageViewType &type, const VkFormat &format, const VkImageAspectFlags &imageAspect,
 		const uint32_t &mipLevels, const uint32_t &baseMipLevel, const uint32_t &layerCount, const uint32_t &baseArrayLayer);
 
+	/**
+	 * Destroys a image with its view and memory once the frames in flight that may still use them have finished, through {@link Graphics#Retire}.
+	 * Memory owned by something else, such as the memory of a aliased image, should not be given.
+	 */
+	static void DestroyImage(const VkImage &image, const VkImageView &imageView, const MemoryAllocation &memory = {});
+
+	/**
+	 * Records the mipmap generation into the {@link UploadContext}, it is submitted ahead of the next frame.
+	 */
 	static void CreateMipmaps(const VkImage &image, const VkExtent3D &extent, const VkFormat &format, const VkImageLayout &dstImageLayout, const uint32_t &mipLevels,
-		const uint32_t &baseArrayLayer, const uint32_t &layerCount);
+		const uint32_t &baseArrayLayer, const uint32_t &layerCount, const VkImageUsageFlags &usage = 0);
 
+	/**
+	 * Records the mipmap generation into a command buffer instead of submitting them, the command buffer must be on a graphics queue.
+	 * Images created with storage usage in a format supported by {@link MipmapGenerator} are generated in one dispatch, others are blitted level by level.
+	 */
+	static void CmdCreateMipmaps(const CommandBuffer &commandBuffer, const VkImage &image, const VkExtent3D &extent, const VkFormat &format,
+		const VkImageLayout &dstImageLayout, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount,
+		const VkImageUsageFlags &usage = 0);
+
+	/**
+	 * Queues a layout transition into the {@link UploadContext}, it is recorded with the other queued barriers and submitted ahead of the next frame.
+	 */
 	static void TransitionImageLayout(const VkImage &image, const VkFormat &format, const VkImageLayout &srcImageLayout, const VkImageLayout &dstImageLayout,
 		const VkImageAspectFlags &imageAspect, const uint32_t &mipLevels, const uint32_t &baseMipLevel, const uint32_t &layerCount, const uint32_t &baseArrayLayer);
 
+	/**
+	 * Gets the pipeline stages that access a image in a layout, the stages a transition from or to the layout waits on.
+	 * @param imageLayout The image layout.
+	 * @return The pipeline stages.
+	 */
+	static VkPipelineStageFlags GetLayoutStages(const VkImageLayout &imageLayout);
+
 	static void InsertImageMemoryBarrier(const CommandBuffer &commandBuffer, const VkImage &image, const VkAccessFlags &srcAccessMask, const VkAccessFlags &dstAccessMask,
 		const VkImageLayout &oldImageLayout, const VkImageLayout &newImageLayout, const VkPipelineStageFlags &srcStageMask, const VkPipelineStageFlags &dstStageMask,
 		const VkImageAspectFlags &imageAspect, const uint32_t &mipLevels, const uint32_t &baseMipLevel, const uint32_t &layerCount, const uint32_t &baseArrayLayer);
 
+	/**
+	 * Copies a buffer into a image and waits for the queue to idle, uploads made while rendering should record {@link Image#CmdCopyBufferToImage} into the {@link UploadContext}.
+	 */
 	static void CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent, const uint32_t &layerCount, const uint32_t &baseArrayLayer);
 
-	static bool CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, const VkFormat &srcFormat, const VkExtent3D &extent,
+	static void CmdCopyBufferToImage(const CommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent,
+		const uint32_t &layerCount, const uint32_t &baseArrayLayer);
+
+	static bool CopyImage(const VkImage &srcImage, VkImage &dstImage, MemoryAllocation &dstImageMemory, const VkFormat &srcFormat, const VkExtent3D &extent,
 		const VkImageLayout &srcImageLayout, const uint32_t &mipLevel, const uint32_t &arrayLayer);
 
+	/**
+	 * Copies every mip level and array layer of a image into host memory without converting the format, unlike {@link Image#GetPixels}.
+	 * Mip levels are packed one after another, each holding its array layers in order.
+	 * @return The packed texels, empty if the format is not supported.
+	 */
+	static std::vector<char> ReadImageData(const VkImage &image, const VkFormat &format, const VkExtent3D &extent, const VkImageLayout &layout,
+		const uint32_t &mipLevels, const uint32_t &arrayLayers);
+
+	/**
+	 * Copies texels packed by {@link Image#ReadImageData} into every mip level and array layer of a image, the image is left in the layout.
+	 * @return If the data matched the size of the image and was copied.
+	 */
+	static bool WriteImageData(const VkImage &image, const VkFormat &format, const VkExtent3D &extent, const VkImageLayout &layout, const uint32_t &mipLevels,
+		const uint32_t &arrayLayers, const std::vector<char> &data);
+
 private:
 	VkExtent3D m_extent;
 	VkFormat m_format;
@@ -143,7 +244,7 @@ private:
 	VkImageLayout m_layout;
 
 	VkImage m_image;
-	VkDeviceMemory m_memory;
+	MemoryAllocation m_memory;
 	VkSampler m_sampler;
 	VkImageView m_view;
 };
@@ -1,35 +1,44 @@
 #include "Image2d.hpp"
 
 #include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Resources/Resources.hpp"
 #include "Serialized/Metadata.hpp"
 #include "Image.hpp"
+#include "ImageKtx.hpp"
+#include "ImageStreamer.hpp"
+#include "MipmapGenerator.hpp"
 
 namespace acid
 {
-std::shared_ptr<Image2d> Image2d::Create(const Metadata &metadata)
+std::shared_ptr<Image2d> Image2d::Create(const Metadata &metadata, const bool &async)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<Image2d>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<Image2d>(resource);
-	}
-
-	auto result = std::make_shared<Image2d>("");
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<Image2d>("");
+		metadata >> *result;
+
+		if (async)
+		{
+			Graphics::Get()->GetImageStreamer()->Load(result);
+		}
+		else
+		{
+			result->Load();
+		}
+
+		return result;
+	});
 }
 
-std::shared_ptr<Image2d> Image2d::Create(const std::string &filename, const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic, const bool &mipmap)
+std::shared_ptr<Image2d> Image2d::Create(const std::string &filename, const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic, const bool &mipmap,
+	const bool &async)
 {
 	auto temp = Image2d(filename, filter, addressMode, anisotropic, mipmap, false);
 	Metadata metadata = Metadata();
 	metadata << temp;
-	return Create(metadata);
+	return Create(metadata, async);
 }
 
 Image2d::Image2d(std::string filename, const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic, const bool &mipmap, const bool &load) :
@@ -44,11 +53,18 @@ Image2d::Image2d(std::string filename, const VkFilter &filter, const VkSamplerAd
 	m_components(0),
 	m_loadPixels(nullptr),
 	m_mipLevels(0),
+	m_arrayLayers(1),
 	m_image(VK_NULL_HANDLE),
-	m_memory(VK_NULL_HANDLE),
 	m_sampler(VK_NULL_HANDLE),
 	m_view(VK_NULL_HANDLE),
-	m_format(VK_FORMAT_R8G8B8A8_UNORM)
+	m_format(VK_FORMAT_R8G8B8A8_UNORM),
+	m_resident(true),
+	m_descriptorVersion(0),
+	m_aliased(false),
+	m_baseMip(0),
+	m_requestedPixels(0.0f),
+	m_requestedFrame(0),
+	m_mipsPending(false)
 {
 	if (load)
 	{
@@ -57,7 +73,8 @@ Image2d::Image2d(std::string filename, const VkFilter &filter, const VkSamplerAd
 }
 
 Image2d::Image2d(const Vector2ui &extent, std::unique_ptr<uint8_t[]> pixels, const VkFormat &format, const VkImageLayout &imageLayout, const VkImageUsageFlags &usage,
-	const VkFilter &filter, const VkSamplerAddressMode &addressMode, const VkSampleCountFlagBits &samples, const bool &anisotropic, const bool &mipmap) :
+	const VkFilter &filter, const VkSamplerAddressMode &addressMode, const VkSampleCountFlagBits &samples, const bool &anisotropic, const bool &mipmap,
+	const uint32_t &arrayLayers) :
 	m_filename(""),
 	m_filter(filter),
 	m_addressMode(addressMode),
@@ -70,23 +87,56 @@ Image2d::Image2d(const Vector2ui &extent, std::unique_ptr<uint8_t[]> pixels, con
 	m_extent(extent),
 	m_loadPixels(std::move(pixels)),
 	m_mipLevels(0),
+	m_arrayLayers(arrayLayers),
 	m_image(VK_NULL_HANDLE),
-	m_memory(VK_NULL_HANDLE),
 	m_sampler(VK_NULL_HANDLE),
 	m_view(VK_NULL_HANDLE),
-	m_format(format)
+	m_format(format),
+	m_resident(true),
+	m_descriptorVersion(0),
+	m_aliased(false),
+	m_baseMip(0),
+	m_requestedPixels(0.0f),
+	m_requestedFrame(0),
+	m_mipsPending(false)
 {
 	Image2d::Load();
 }
 
-Image2d::~Image2d()
+Image2d::Image2d(const Vector2ui &extent, const VkFormat &format, const VkImageLayout &layout, const VkImageUsageFlags &usage, const VkSampleCountFlagBits &samples,
+	const MemoryAllocation &memory, const uint32_t &arrayLayers) :
+	m_filename(""),
+	m_filter(VK_FILTER_LINEAR),
+	m_addressMode(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE),
+	m_anisotropic(false),
+	m_mipmap(false),
+	m_samples(samples),
+	m_layout(layout),
+	m_usage(usage),
+	m_components(4),
+	m_extent(extent),
+	m_mipLevels(0),
+	m_arrayLayers(arrayLayers),
+	m_image(VK_NULL_HANDLE),
+	m_memory(memory),
+	m_sampler(VK_NULL_HANDLE),
+	m_view(VK_NULL_HANDLE),
+	m_format(format),
+	m_resident(true),
+	m_descriptorVersion(0),
+	m_aliased(true),
+	m_baseMip(0),
+	m_requestedPixels(0.0f),
+	m_requestedFrame(0),
+	m_mipsPending(false)
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	Image2d::Load();
+}
 
-	vkDestroySampler(*logicalDevice, m_sampler, nullptr);
-	vkDestroyImageView(*logicalDevice, m_view, nullptr);
-	vkFreeMemory(*logicalDevice, m_memory, nullptr);
-	vkDestroyImage(*logicalDevice, m_image, nullptr);
+Image2d::~Image2d()
+{
+	// Aliased memory is shared with other images, it is freed by its owner.
+	Image::DestroyImage(m_image, m_view, m_aliased ? MemoryAllocation() : m_memory);
 }
 
 VkDescriptorSetLayoutBinding Image2d::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage,
@@ -95,7 +145,7 @@ VkDescriptorSetLayoutBinding Image2d::GetDescriptorSetLayout(const uint32_t &bin
 	VkDescriptorSetLayoutBinding descriptorSetLayoutBinding = {};
 	descriptorSetLayoutBinding.binding = binding;
 	descriptorSetLayoutBinding.descriptorType = descriptorType;
-	descriptorSetLayoutBinding.descriptorCount = 1;
+	descriptorSetLayoutBinding.descriptorCount = count;
 	descriptorSetLayoutBinding.stageFlags = stage;
 	descriptorSetLayoutBinding.pImmutableSamplers = nullptr;
 	return descriptorSetLayoutBinding;
@@ -103,11 +153,23 @@ VkDescriptorSetLayoutBinding Image2d::GetDescriptorSetLayout(const uint32_t &bin
 
 WriteDescriptorSet Image2d::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const
 {
+	if (!m_resident)
+	{
+		return Graphics::Get()->GetImageStreamer()->GetPlaceholder()->GetWriteDescriptor(binding, descriptorType, offsetSize);
+	}
+
 	VkDescriptorImageInfo imageInfo = {};
 	imageInfo.sampler = m_sampler;
 	imageInfo.imageView = m_view;
 	imageInfo.imageLayout = m_layout;
 
+	// Input attachments are read in the layout the subpass references them with.
+	if (descriptorType == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT)
+	{
+		imageInfo.sampler = VK_NULL_HANDLE;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
+
 	VkWriteDescriptorSet descriptorWrite = {};
 	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 	descriptorWrite.dstSet = VK_NULL_HANDLE; // Will be set in the descriptor handler.
@@ -121,12 +183,31 @@ WriteDescriptorSet Image2d::GetWriteDescriptor(const uint32_t &binding, const Vk
 
 void Image2d::Load()
 {
+	std::optional<ImageKtx> texture;
+
 	if (!m_filename.empty() && m_loadPixels == nullptr)
 	{
 #if defined(ACID_VERBOSE)
 		auto debugStart = Engine::GetTime();
 #endif
-		m_loadPixels = Image::LoadPixels(m_filename, m_extent, m_components, m_format);
+		texture = ImageKtx::Load(m_filename);
+
+		if (texture && texture->GetLayers() != 1)
+		{
+			Log::Error("Image 2D texture has more than one layer: '%s'\n", m_filename.c_str());
+			texture = std::nullopt;
+		}
+
+		if (texture)
+		{
+			auto extent = texture->GetExtent();
+			m_extent = Vector2ui(extent.width, extent.height);
+			m_format = texture->GetFormat();
+		}
+		else
+		{
+			m_loadPixels = Image::LoadPixels(m_filename, m_extent, m_components, m_format);
+		}
 #if defined(ACID_VERBOSE)
 		auto debugEnd = Engine::GetTime();
 		Log::Out("Image 2D '%s' loaded in %.3fms\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
@@ -138,47 +219,82 @@ void Image2d::Load()
 		return;
 	}
 
+	if (texture)
+	{
+		// Compressed textures can not be blitted, their mip levels come from the file.
+		m_mipLevels = m_mipmap ? texture->GetMipLevels() : 1;
+		Image::CreateImage(m_image, m_memory, texture->GetExtent(), m_format, m_samples, VK_IMAGE_TILING_OPTIMAL, m_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			m_mipLevels, 1, VK_IMAGE_TYPE_2D);
+		m_sampler = Image::GetImageSampler(m_filter, m_addressMode, m_anisotropic);
+		Image::CreateImageView(m_image, m_view, VK_IMAGE_VIEW_TYPE_2D, m_format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+		Graphics::Get()->GetUploadContext()->Record(texture->GetData().get(), texture->GetSize(), [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+		{
+			texture->CmdCopyToImage(commandBuffer, bufferStaging.GetBuffer(), m_image, m_mipLevels);
+		});
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+		return;
+	}
+
 	m_mipLevels = m_mipmap ? Image::GetMipLevels({ m_extent.m_x, m_extent.m_y, 1 }) : 1;
+	auto viewType = m_arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+
+	if (m_aliased)
+	{
+		Image::CreateAliasedImage(m_image, m_memory, { m_extent.m_x, m_extent.m_y, 1 }, m_format, m_samples, VK_IMAGE_TILING_OPTIMAL, m_usage, m_mipLevels,
+			m_arrayLayers, VK_IMAGE_TYPE_2D);
+		Image::CreateImageView(m_image, m_view, viewType, m_format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, m_arrayLayers, 0);
+
+		if (m_usage & VK_IMAGE_USAGE_SAMPLED_BIT)
+		{
+			m_sampler = Image::GetImageSampler(m_filter, m_addressMode, m_anisotropic);
+		}
+
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, m_arrayLayers, 0);
+		return;
+	}
+
+	// Storage usage lets the mip chain be generated in one dispatch.
+	if (m_mipmap && MipmapGenerator::IsSupported(m_format))
+	{
+		m_usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+	}
 
 	Image::CreateImage(m_image, m_memory, { m_extent.m_x, m_extent.m_y, 1 }, m_format, m_samples, VK_IMAGE_TILING_OPTIMAL, m_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		m_mipLevels, 1, VK_IMAGE_TYPE_2D);
-	Image::CreateImageSampler(m_sampler, m_filter, m_addressMode, m_anisotropic, m_mipLevels);
-	Image::CreateImageView(m_image, m_view, VK_IMAGE_VIEW_TYPE_2D, m_format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+		m_mipLevels, m_arrayLayers, VK_IMAGE_TYPE_2D);
+	m_sampler = Image::GetImageSampler(m_filter, m_addressMode, m_anisotropic);
+	Image::CreateImageView(m_image, m_view, viewType, m_format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, m_arrayLayers, 0);
 
 	if (m_loadPixels != nullptr || m_mipmap)
 	{
 		//m_image.TransitionLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, m_arrayLayers, 0);
 	}
 
 	if (m_loadPixels != nullptr)
 	{
 		//m_image.SetPixels(m_loadPixels.get(), 1, 0);
-		auto bufferStaging = Buffer(m_extent.m_x * m_extent.m_y * m_components, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-		void *data;
-		bufferStaging.MapMemory(&data);
-		std::memcpy(data, m_loadPixels.get(), bufferStaging.GetSize());
-		bufferStaging.UnmapMemory();
-
-		Image::CopyBufferToImage(bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, 1, 0);
+		Graphics::Get()->GetUploadContext()->Record(m_loadPixels.get(), m_extent.m_x * m_extent.m_y * m_components * m_arrayLayers,
+			[this](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+		{
+			Image::CmdCopyBufferToImage(commandBuffer, bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, m_arrayLayers, 0);
+		});
 	}
 
 	if (m_mipmap)
 	{
 		//m_image.CreateMipmaps();
-		Image::CreateMipmaps(m_image, { m_extent.m_x, m_extent.m_y, 1 }, m_format, m_layout, m_mipLevels, 0, 1);
+		Image::CreateMipmaps(m_image, { m_extent.m_x, m_extent.m_y, 1 }, m_format, m_layout, m_mipLevels, 0, m_arrayLayers, m_usage);
 	}
 	else if (m_loadPixels != nullptr)
 	{
 		//m_image.TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_layout);
-		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, m_arrayLayers, 0);
 	}
 	else
 	{
 		//m_image.TransitionLayout(VK_IMAGE_LAYOUT_UNDEFINED, m_layout);
-		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, m_arrayLayers, 0);
 	}
 
 	m_loadPixels = nullptr;
@@ -188,11 +304,13 @@ std::unique_ptr<uint8_t[]> Image2d::GetPixels(Vector2ui &extent, const uint32_t
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
-	extent = m_extent >> mipLevel;
+	// Streamed images may not hold their highest levels, the highest resident level is read in their place.
+	auto level = std::max(mipLevel, m_baseMip);
+	extent = m_extent >> level;
 
 	VkImage dstImage;
-	VkDeviceMemory dstImageMemory;
-	Image::CopyImage(m_image, dstImage, dstImageMemory, m_format, { extent.m_x, extent.m_y, 1 }, m_layout, mipLevel, 0);
+	MemoryAllocation dstImageMemory;
+	Image::CopyImage(m_image, dstImage, dstImageMemory, m_format, { extent.m_x, extent.m_y, 1 }, m_layout, level - m_baseMip, 0);
 
 	VkImageSubresource dstImageSubresource = {};
 	dstImageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -205,27 +323,41 @@ std::unique_ptr<uint8_t[]> Image2d::GetPixels(Vector2ui &extent, const uint32_t
 	auto pixels = std::make_unique<uint8_t[]>(dstSubresourceLayout.size);
 
 	void *data;
-	vkMapMemory(*logicalDevice, dstImageMemory, dstSubresourceLayout.offset, dstSubresourceLayout.size, 0, &data);
+	data = static_cast<uint8_t *>(dstImageMemory.GetMapped()) + dstSubresourceLayout.offset;
 	std::memcpy(pixels.get(), data, static_cast<size_t>(dstSubresourceLayout.size));
-	vkUnmapMemory(*logicalDevice, dstImageMemory);
 
-	vkFreeMemory(*logicalDevice, dstImageMemory, nullptr);
+	Graphics::Get()->GetMemoryAllocator()->Free(dstImageMemory);
 	vkDestroyImage(*logicalDevice, dstImage, nullptr);
 
 	return pixels;
 }
 
-void Image2d::SetPixels(const uint8_t *pixels, const uint32_t &layerCount, const uint32_t &baseArrayLayer)
+void Image2d::ReadPixels(ImageReadback::Callback callback, const uint32_t &mipLevel) const
 {
-	Buffer bufferStaging = Buffer(m_extent.m_x * m_extent.m_y * m_components, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	auto level = std::max(mipLevel, m_baseMip);
+	Graphics::Get()->GetImageReadback()->Read(m_image, m_format, m_extent >> level, m_layout, std::move(callback), level - m_baseMip, 0);
+}
 
-	void *data;
-	bufferStaging.MapMemory(&data);
-	std::memcpy(data, pixels, bufferStaging.GetSize());
-	bufferStaging.UnmapMemory();
+void Image2d::RequestResidency(const float &pixels)
+{
+	auto frameCount = Graphics::Get()->GetFrameCount();
+
+	if (m_requestedFrame != frameCount)
+	{
+		m_requestedFrame = frameCount;
+		m_requestedPixels = pixels;
+		return;
+	}
+
+	m_requestedPixels = std::max(m_requestedPixels, pixels);
+}
 
-	Image::CopyBufferToImage(bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, layerCount, baseArrayLayer);
+void Image2d::SetPixels(const uint8_t *pixels, const uint32_t &layerCount, const uint32_t &baseArrayLayer)
+{
+	Graphics::Get()->GetUploadContext()->Record(pixels, m_extent.m_x * m_extent.m_y * m_components, [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+	{
+		Image::CmdCopyBufferToImage(commandBuffer, bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, layerCount, baseArrayLayer);
+	});
 }
 
 const Metadata &operator>>(const Metadata &metadata, Image2d &image)
@@ -3,6 +3,7 @@
 #include "Helpers/NonCopyable.hpp"
 #include "Resources/Resource.hpp"
 #include "Image.hpp"
+#include "ImageReadback.hpp"
 
 namespace acid
 {
@@ -18,9 +19,10 @@ public:
 	/**
 	 * Creates a new 2D image, or finds one with the same values.
 	 * @param metadata The metadata to decode values from.
+	 * @param async If the image is decoded and uploaded in the background by the {@link ImageStreamer}, a placeholder is bound until then.
 	 * @return The 2D image with the requested values.
 	 */
-	static std::shared_ptr<Image2d> Create(const Metadata &metadata);
+	static std::shared_ptr<Image2d> Create(const Metadata &metadata, const bool &async = false);
 
 	/**
 	 * Creates a new 2D image, or finds one with the same values.
@@ -29,10 +31,11 @@ public:
 	 * @param addressMode The addressing mode for outside [0..1] range.
 	 * @param anisotropic If anisotropic filtering is enabled.
 	 * @param mipmap If mapmaps will be generated.
+	 * @param async If the image is decoded and uploaded in the background by the {@link ImageStreamer}, a placeholder is bound until then.
 	 * @return The 2D image with the requested values.
 	 */
 	static std::shared_ptr<Image2d> Create(const std::string &filename, const VkFilter &filter = VK_FILTER_LINEAR,
-		const VkSamplerAddressMode &addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, const bool &anisotropic = true, const bool &mipmap = true);
+		const VkSamplerAddressMode &addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, const bool &anisotropic = true, const bool &mipmap = true, const bool &async = false);
 
 	/**
 	 * Creates a new 2D image.
@@ -58,11 +61,25 @@ public:
 	 * @param samples The number of samples per texel.
 	 * @param anisotropic If anisotropic filtering is enabled.
 	 * @param mipmap If mapmaps will be generated.
+	 * @param arrayLayers The number of layers, such as one for each view of a multiview render stage. The pixels hold every layer.
 	 */
 	Image2d(const Vector2ui &extent, std::unique_ptr<uint8_t[]> pixels = nullptr, const VkFormat &format = VK_FORMAT_R8G8B8A8_UNORM,
 		const VkImageLayout &layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, const VkImageUsageFlags &usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
 		const VkFilter &filter = VK_FILTER_LINEAR, const VkSamplerAddressMode &addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
-		const VkSampleCountFlagBits &samples = VK_SAMPLE_COUNT_1_BIT, const bool &anisotropic = false, const bool &mipmap = false);
+		const VkSampleCountFlagBits &samples = VK_SAMPLE_COUNT_1_BIT, const bool &anisotropic = false, const bool &mipmap = false, const uint32_t &arrayLayers = 1);
+
+	/**
+	 * Creates a new 2D attachment image that is bound into memory owned by the caller, so attachments that are not alive at the same time can share memory.
+	 * @param extent The images extent in pixels.
+	 * @param format The format and type of the texel blocks that will be contained in the image.
+	 * @param layout The layout that the image subresources accessible from.
+	 * @param usage The exact usage of the image, a sampler is only created if it includes sampling.
+	 * @param samples The number of samples per texel.
+	 * @param memory The memory to bind the image at the start of, it must outlive the image.
+	 * @param arrayLayers The number of layers, such as one for each view of a multiview render stage.
+	 */
+	Image2d(const Vector2ui &extent, const VkFormat &format, const VkImageLayout &layout, const VkImageUsageFlags &usage, const VkSampleCountFlagBits &samples,
+		const MemoryAllocation &memory, const uint32_t &arrayLayers = 1);
 
 	~Image2d();
 
@@ -71,8 +88,12 @@ public:
 
 	WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
 
+	uint32_t GetDescriptorVersion() const override { return m_descriptorVersion; }
+
 	void Load() override;
 
+	std::size_t GetGpuSize() const override { return m_aliased ? 0 : static_cast<std::size_t>(m_memory.GetSize()); }
+
 	/**
 	 * Copies the images pixels from memory.
 	 * @param extent The sampled images extent.
@@ -81,6 +102,13 @@ public:
 	 */
 	std::unique_ptr<uint8_t[]> GetPixels(Vector2ui &extent, const uint32_t &mipLevel = 0) const;
 
+	/**
+	 * Reads the images pixels back without stalling, the callback is run on a worker once the next frame has completed.
+	 * @param callback The function given the pixels.
+	 * @param mipLevel The mipmap level index to read.
+	 */
+	void ReadPixels(ImageReadback::Callback callback, const uint32_t &mipLevel = 0) const;
+
 	/**
 	 * Sets the pixels of this image.
 	 * @param pixels The pixels to copy from.
@@ -89,6 +117,12 @@ public:
 	 */
 	void SetPixels(const uint8_t *pixels, const uint32_t &layerCount, const uint32_t &baseArrayLayer);
 
+	/**
+	 * Tells the {@link ImageStreamer} how large the image was drawn, streamed images keep the mip levels needed for the largest size asked for each frame.
+	 * @param pixels The number of pixels the image spans on screen.
+	 */
+	void RequestResidency(const float &pixels);
+
 	const std::string &GetFilename() const { return m_filename; };
 
 	const VkFilter &GetFilter() const { return m_filter; }
@@ -99,21 +133,39 @@ public:
 
 	const bool &IsMipmap() const { return m_mipmap; }
 
+	/**
+	 * Gets the number of layers in the image, images with more than one are viewed as 2D arrays.
+	 * @return The number of layers.
+	 */
+	const uint32_t &GetArrayLayers() const { return m_arrayLayers; }
+
 	const VkSampleCountFlagBits &GetSamples() const { return m_samples; }
 
 	const VkImageLayout &GetLayout() const { return m_layout; }
 
 	const VkImageUsageFlags &GetUsage() const { return m_usage; }
 
+	/**
+	 * Gets if the image is bound into memory owned by something else, such as memory planned by the {@link RenderGraph}.
+	 * @return If the memory is aliased.
+	 */
+	const bool &IsAliased() const { return m_aliased; }
+
 	const uint32_t &GetComponents() const { return m_components; }
 
 	const Vector2ui &GetExtent() const { return m_extent; }
 
 	const uint32_t &GetMipLevels() const { return m_mipLevels; }
 
-	const VkImage &GetImage() { return m_image; }
+	/**
+	 * Gets the highest mip level held by the image, streamed images drop their highest levels while they are drawn small or memory is short.
+	 * @return The first resident mip level.
+	 */
+	const uint32_t &GetBaseMip() const { return m_baseMip; }
 
-	const VkDeviceMemory &GetMemory() { return m_memory; }
+	const VkImage &GetImage() const { return m_image; }
+
+	const MemoryAllocation &GetMemory() const { return m_memory; }
 
 	const VkSampler &GetSampler() const { return m_sampler; }
 
@@ -121,11 +173,19 @@ public:
 
 	const VkFormat &GetFormat() const { return m_format; }
 
+	/**
+	 * Gets if the image has been uploaded, images streamed by the {@link ImageStreamer} are not resident until their upload has finished.
+	 * @return If the image is resident.
+	 */
+	bool IsResident() const { return m_resident; }
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Image2d &image);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Image2d &image);
 
 private:
+	friend class ImageStreamer;
+
 	std::string m_filename;
 
 	VkFilter m_filter;
@@ -140,11 +200,21 @@ private:
 	Vector2ui m_extent;
 	std::unique_ptr<uint8_t[]> m_loadPixels;
 	uint32_t m_mipLevels;
+	uint32_t m_arrayLayers;
 
 	VkImage m_image;
-	VkDeviceMemory m_memory;
+	MemoryAllocation m_memory;
 	VkSampler m_sampler;
 	VkImageView m_view;
 	VkFormat m_format;
+
+	std::atomic<bool> m_resident;
+	uint32_t m_descriptorVersion;
+	bool m_aliased;
+
+	uint32_t m_baseMip;
+	float m_requestedPixels;
+	uint64_t m_requestedFrame;
+	bool m_mipsPending;
 };
 }
@@ -1,26 +1,23 @@
 ﻿#include "ImageCube.hpp"
 
 #include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Resources/Resources.hpp"
 #include "Image.hpp"
+#include "ImageKtx.hpp"
 
 namespace acid
 {
 std::shared_ptr<ImageCube> ImageCube::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ImageCube>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ImageCube>(resource);
-	}
-
-	auto result = std::make_shared<ImageCube>("");
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ImageCube>("");
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<ImageCube> ImageCube::Create(const std::string &filename, const std::string &fileSuffix, const VkFilter &filter, const VkSamplerAddressMode &addressMode,
@@ -48,7 +45,6 @@ ImageCube::ImageCube(std::string filename, std::string fileSuffix, const VkFilte
 	m_loadPixels(nullptr),
 	m_mipLevels(0),
 	m_image(VK_NULL_HANDLE),
-	m_memory(VK_NULL_HANDLE),
 	m_sampler(VK_NULL_HANDLE),
 	m_view(VK_NULL_HANDLE),
 	m_format(VK_FORMAT_R8G8B8A8_UNORM)
@@ -75,7 +71,6 @@ ImageCube::ImageCube(const Vector2ui &extent, std::unique_ptr<uint8_t[]> pixels,
 	m_loadPixels(std::move(pixels)),
 	m_mipLevels(0),
 	m_image(VK_NULL_HANDLE),
-	m_memory(VK_NULL_HANDLE),
 	m_sampler(VK_NULL_HANDLE),
 	m_view(VK_NULL_HANDLE),
 	m_format(format)
@@ -85,12 +80,7 @@ ImageCube::ImageCube(const Vector2ui &extent, std::unique_ptr<uint8_t[]> pixels,
 
 ImageCube::~ImageCube()
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-
-	vkDestroyImageView(*logicalDevice, m_view, nullptr);
-	vkDestroySampler(*logicalDevice, m_sampler, nullptr);
-	vkFreeMemory(*logicalDevice, m_memory, nullptr);
-	vkDestroyImage(*logicalDevice, m_image, nullptr);
+	Image::DestroyImage(m_image, m_view, m_memory);
 }
 
 VkDescriptorSetLayoutBinding ImageCube::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage,
@@ -125,12 +115,31 @@ WriteDescriptorSet ImageCube::GetWriteDescriptor(const uint32_t &binding, const
 
 void ImageCube::Load()
 {
+	std::optional<ImageKtx> texture;
+
 	if (!m_filename.empty() && m_loadPixels == nullptr)
 	{
 #if defined(ACID_VERBOSE)
 		auto debugStart = Engine::GetTime();
 #endif
-		m_loadPixels = LoadPixels(m_filename, m_fileSuffix, m_fileSides, m_extent, m_components, m_format);
+		texture = ImageKtx::Load(m_filename);
+
+		if (texture && texture->GetLayers() != 6)
+		{
+			Log::Error("Image cube texture does not have six faces: '%s'\n", m_filename.c_str());
+			texture = std::nullopt;
+		}
+
+		if (texture)
+		{
+			auto extent = texture->GetExtent();
+			m_extent = Vector2ui(extent.width, extent.height);
+			m_format = texture->GetFormat();
+		}
+		else
+		{
+			m_loadPixels = LoadPixels(m_filename, m_fileSuffix, m_fileSides, m_extent, m_components, m_format);
+		}
 #if defined(ACID_VERBOSE)
 		auto debugEnd = Engine::GetTime();
 		Log::Out("Image Cube '%s' loaded in %.3fms\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
@@ -142,13 +151,25 @@ void ImageCube::Load()
 		return;
 	}
 
-	m_mipLevels = m_mipmap ? Image::GetMipLevels({ m_extent.m_x, m_extent.m_y, 1 }) : 1;
+	// Compressed textures can not be blitted, their mip levels come from the file.
+	m_mipLevels = texture ? (m_mipmap ? texture->GetMipLevels() : 1) : m_mipmap ? Image::GetMipLevels({ m_extent.m_x, m_extent.m_y, 1 }) : 1;
 
 	Image::CreateImage(m_image, m_memory, { m_extent.m_x, m_extent.m_y, 1 }, m_format, m_samples, VK_IMAGE_TILING_OPTIMAL, m_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 		m_mipLevels, 6, VK_IMAGE_TYPE_2D);
-	Image::CreateImageSampler(m_sampler, m_filter, m_addressMode, m_anisotropic, m_mipLevels);
+	m_sampler = Image::GetImageSampler(m_filter, m_addressMode, m_anisotropic);
 	Image::CreateImageView(m_image, m_view, VK_IMAGE_VIEW_TYPE_CUBE, m_format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 6, 0);
 
+	if (texture)
+	{
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 6, 0);
+		Graphics::Get()->GetUploadContext()->Record(texture->GetData().get(), texture->GetSize(), [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+		{
+			texture->CmdCopyToImage(commandBuffer, bufferStaging.GetBuffer(), m_image, m_mipLevels);
+		});
+		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 6, 0);
+		return;
+	}
+
 	if (m_loadPixels != nullptr || m_mipmap)
 	{
 		Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 6, 0);
@@ -156,15 +177,11 @@ void ImageCube::Load()
 
 	if (m_loadPixels != nullptr)
 	{
-		auto bufferStaging = Buffer(m_extent.m_x * m_extent.m_y * m_components * 6, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-		void *data;
-		bufferStaging.MapMemory(&data);
-		std::memcpy(data, m_loadPixels.get(), bufferStaging.GetSize());
-		bufferStaging.UnmapMemory();
-
-		Image::CopyBufferToImage(bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, 6, 0);
+		Graphics::Get()->GetUploadContext()->Record(m_loadPixels.get(), m_extent.m_x * m_extent.m_y * m_components * 6,
+			[this](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+		{
+			Image::CmdCopyBufferToImage(commandBuffer, bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, 6, 0);
+		});
 	}
 
 	if (m_mipmap)
@@ -190,7 +207,7 @@ std::unique_ptr<uint8_t[]> ImageCube::GetPixels(Vector2ui &extent, const uint32_
 	extent = m_extent >> mipLevel;
 
 	VkImage dstImage;
-	VkDeviceMemory dstImageMemory;
+	MemoryAllocation dstImageMemory;
 	Image::CopyImage(m_image, dstImage, dstImageMemory, m_format, { extent.m_x, extent.m_y, 1 }, m_layout, mipLevel, arrayLayer);
 
 	VkImageSubresource dstImageSubresource = {};
@@ -204,11 +221,10 @@ std::unique_ptr<uint8_t[]> ImageCube::GetPixels(Vector2ui &extent, const uint32_
 	auto result = std::make_unique<uint8_t[]>(dstSubresourceLayout.size);
 
 	void *data;
-	vkMapMemory(*logicalDevice, dstImageMemory, dstSubresourceLayout.offset, dstSubresourceLayout.size, 0, &data);
+	data = static_cast<uint8_t *>(dstImageMemory.GetMapped()) + dstSubresourceLayout.offset;
 	std::memcpy(result.get(), data, static_cast<size_t>(dstSubresourceLayout.size));
-	vkUnmapMemory(*logicalDevice, dstImageMemory);
 
-	vkFreeMemory(*logicalDevice, dstImageMemory, nullptr);
+	Graphics::Get()->GetMemoryAllocator()->Free(dstImageMemory);
 	vkDestroyImage(*logicalDevice, dstImage, nullptr);
 
 	return result;
@@ -240,36 +256,57 @@ std::unique_ptr<uint8_t[]> ImageCube::GetPixels(Vector2ui &extent, const uint32_
 
 void ImageCube::SetPixels(const uint8_t *pixels, const uint32_t &layerCount, const uint32_t &baseArrayLayer)
 {
-	Buffer bufferStaging = Buffer(m_extent.m_x * m_extent.m_y * m_components * 6, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-	void *data;
-	bufferStaging.MapMemory(&data);
-	memcpy(data, pixels, bufferStaging.GetSize());
-	bufferStaging.UnmapMemory();
-
-	Image::CopyBufferToImage(bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, layerCount, baseArrayLayer);
+	Graphics::Get()->GetUploadContext()->Record(pixels, m_extent.m_x * m_extent.m_y * m_components * 6, [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+	{
+		Image::CmdCopyBufferToImage(commandBuffer, bufferStaging.GetBuffer(), m_image, { m_extent.m_x, m_extent.m_y, 1 }, layerCount, baseArrayLayer);
+	});
 }
 
 std::unique_ptr<uint8_t[]> ImageCube::LoadPixels(const std::string &filename, const std::string &fileSuffix, const std::vector<std::string> &fileSides, Vector2ui &extent,
 	uint32_t &components, VkFormat &format)
 {
-	std::unique_ptr<uint8_t[]> result = nullptr;
-	uint8_t *offset = nullptr;
+	class Side
+	{
+	public:
+		std::unique_ptr<uint8_t[]> m_pixels;
+		Vector2ui m_extent;
+		uint32_t m_components = 0;
+		VkFormat m_format = VK_FORMAT_UNDEFINED;
+	};
+
+	// Each side is its own file, so the sides are decoded in parallel. The calling thread helps, so this is safe from a job.
+	std::vector<Side> sides(fileSides.size());
+	Engine::Get()->GetThreadPool().ParallelFor(0, fileSides.size(), [&](const std::size_t &i)
+	{
+		std::string filenameSide = std::string(filename).append("/").append(fileSides[i]).append(fileSuffix);
+		sides[i].m_pixels = Image::LoadPixels(filenameSide, sides[i].m_extent, sides[i].m_components, sides[i].m_format);
+	}, 1);
 
-	for (const auto &side : fileSides)
+	if (sides.empty())
 	{
-		std::string filenameSide = std::string(filename).append("/").append(side).append(fileSuffix);
-		auto resultSide = Image::LoadPixels(filenameSide, extent, components, format);
-		int32_t sizeSide = extent.m_x * extent.m_y * components;
+		return nullptr;
+	}
 
-		if (result == nullptr)
+	extent = sides[0].m_extent;
+	components = sides[0].m_components;
+	format = sides[0].m_format;
+	std::size_t sizeSide = static_cast<std::size_t>(extent.m_x) * extent.m_y * components;
+
+	for (const auto &side : sides)
+	{
+		if (side.m_pixels == nullptr || side.m_extent != extent || side.m_components != components)
 		{
-			result = std::make_unique<uint8_t[]>(sizeSide * fileSides.size());
-			offset = result.get();
+			Log::Error("Image cube sides are missing or do not match: '%s'\n", filename.c_str());
+			return nullptr;
 		}
+	}
 
-		memcpy(offset, resultSide.get(), sizeSide);
+	auto result = std::make_unique<uint8_t[]>(sizeSide * sides.size());
+	auto offset = result.get();
+
+	for (const auto &side : sides)
+	{
+		std::memcpy(offset, side.m_pixels.get(), sizeSide);
 		offset += sizeSide;
 	}
 
@@ -75,6 +75,8 @@ public:
 
 	void Load() override;
 
+	std::size_t GetGpuSize() const override { return static_cast<std::size_t>(m_memory.GetSize()); }
+
 	/**
 	 * Copies the images pixels from memory.
 	 * @param extent The sampled images extent.
@@ -131,7 +133,7 @@ public:
 
 	const VkImage &GetImage() const { return m_image; }
 
-	const VkDeviceMemory &GetMemory() { return m_memory; }
+	const MemoryAllocation &GetMemory() const { return m_memory; }
 
 	const VkSampler &GetSampler() const { return m_sampler; }
 
@@ -162,7 +164,7 @@ private:
 	uint32_t m_mipLevels;
 
 	VkImage m_image;
-	VkDeviceMemory m_memory;
+	MemoryAllocation m_memory;
 	VkSampler m_sampler;
 	VkImageView m_view;
 	VkFormat m_format;
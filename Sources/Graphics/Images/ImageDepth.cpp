@@ -8,10 +8,10 @@ namespace acid
 static const std::vector<VkFormat> TRY_FORMATS = { VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D32_SFLOAT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D16_UNORM_S8_UINT,
 	VK_FORMAT_D16_UNORM };
 
-ImageDepth::ImageDepth(const Vector2ui &extent, const VkSampleCountFlagBits &samples) :
+ImageDepth::ImageDepth(const Vector2ui &extent, const VkSampleCountFlagBits &samples, const uint32_t &arrayLayers) :
 	m_extent(extent),
+	m_arrayLayers(arrayLayers),
 	m_image(VK_NULL_HANDLE),
-	m_memory(VK_NULL_HANDLE),
 	m_sampler(VK_NULL_HANDLE),
 	m_view(VK_NULL_HANDLE),
 	m_format(VK_FORMAT_UNDEFINED)
@@ -43,20 +43,16 @@ ImageDepth::ImageDepth(const Vector2ui &extent, const VkSampleCountFlagBits &sam
 	}
 
 	Image::CreateImage(m_image, m_memory, { m_extent.m_x, m_extent.m_y, 1 }, m_format, samples, VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, 1, VK_IMAGE_TYPE_2D);
-	Image::CreateImageSampler(m_sampler, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false, 1);
-	Image::CreateImageView(m_image, m_view, VK_IMAGE_VIEW_TYPE_2D, m_format, VK_IMAGE_ASPECT_DEPTH_BIT, 1, 0, 1, 0);
-	Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, aspectMask, 1, 0, 1, 0);
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, m_arrayLayers, VK_IMAGE_TYPE_2D);
+	m_sampler = Image::GetImageSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false);
+	Image::CreateImageView(m_image, m_view, m_arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D, m_format, VK_IMAGE_ASPECT_DEPTH_BIT, 1, 0,
+		m_arrayLayers, 0);
+	Image::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, aspectMask, 1, 0, m_arrayLayers, 0);
 }
 
 ImageDepth::~ImageDepth()
 {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-
-	vkDestroyImageView(*logicalDevice, m_view, nullptr);
-	vkDestroySampler(*logicalDevice, m_sampler, nullptr);
-	vkFreeMemory(*logicalDevice, m_memory, nullptr);
-	vkDestroyImage(*logicalDevice, m_image, nullptr);
+	Image::DestroyImage(m_image, m_view, m_memory);
 }
 
 VkDescriptorSetLayoutBinding ImageDepth::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage)
@@ -12,7 +12,13 @@ class ACID_EXPORT ImageDepth :
 	public Descriptor
 {
 public:
-	explicit ImageDepth(const Vector2ui &extent, const VkSampleCountFlagBits &samples = VK_SAMPLE_COUNT_1_BIT);
+	/**
+	 * Creates a new depth stencil image.
+	 * @param extent The size of the image.
+	 * @param samples The number of samples per texel.
+	 * @param arrayLayers The number of layers, one for each view of a multiview render stage.
+	 */
+	explicit ImageDepth(const Vector2ui &extent, const VkSampleCountFlagBits &samples = VK_SAMPLE_COUNT_1_BIT, const uint32_t &arrayLayers = 1);
 
 	~ImageDepth();
 
@@ -22,9 +28,11 @@ public:
 
 	const Vector2ui &GetExtent() const { return m_extent; }
 
+	const uint32_t &GetArrayLayers() const { return m_arrayLayers; }
+
 	const VkImage &GetImage() const { return m_image; }
 
-	const VkDeviceMemory &GetMemory() { return m_memory; }
+	const MemoryAllocation &GetMemory() const { return m_memory; }
 
 	const VkSampler &GetSampler() const { return m_sampler; }
 
@@ -34,9 +42,10 @@ public:
 
 private:
 	Vector2ui m_extent;
+	uint32_t m_arrayLayers;
 
 	VkImage m_image;
-	VkDeviceMemory m_memory;
+	MemoryAllocation m_memory;
 	VkSampler m_sampler;
 	VkImageView m_view;
 	VkFormat m_format;
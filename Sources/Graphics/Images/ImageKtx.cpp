@@ -0,0 +1,215 @@
+#include "ImageKtx.hpp"
+
+#include "Files/FileSystem.hpp"
+#include "Files/Files.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Helpers/String.hpp"
+
+namespace acid
+{
+static const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+static const std::size_t KTX2_HEADER_SIZE = 80;
+static const std::size_t KTX2_LEVEL_SIZE = 24;
+// Levels are copied from offsets aligned to the largest texel block.
+static const VkDeviceSize LEVEL_ALIGNMENT = 16;
+// The variants looked for next to a image, in the order they are preferred.
+static const std::vector<std::string> VARIANT_SUFFIXES = { ".bc.ktx2", ".astc.ktx2", ".etc2.ktx2", ".ktx2" };
+
+template<typename T>
+static T ReadValue(const uint8_t *data, const std::size_t &offset)
+{
+	T value;
+	std::memcpy(&value, data + offset, sizeof(T));
+	return value;
+}
+
+static bool IsKtx2(const uint8_t *data, const std::size_t &size)
+{
+	return size >= KTX2_HEADER_SIZE && std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+}
+
+std::optional<ImageKtx> ImageKtx::Load(const std::string &filename)
+{
+	auto suffix = String::Lowercase(FileSystem::FileSuffix(filename));
+
+	if (suffix == ".ktx2")
+	{
+		auto file = Files::ReadView(filename);
+
+		if (!file)
+		{
+			Log::Error("Texture could not be loaded: '%s'\n", filename.c_str());
+			return std::nullopt;
+		}
+
+		auto texture = Decode(file->GetData(), file->GetSize());
+
+		if (texture && !IsFormatSupported(texture->m_format))
+		{
+			Log::Error("Texture format %i can not be sampled by the device: '%s'\n", texture->m_format, filename.c_str());
+			return std::nullopt;
+		}
+
+		return texture;
+	}
+
+	for (const auto &variant : FindVariants(filename))
+	{
+		auto file = Files::ReadView(variant);
+
+		// The format is read from the header first, so variants the device can not sample are never decoded.
+		if (!file || !IsKtx2(file->GetData(), file->GetSize()) || !IsFormatSupported(static_cast<VkFormat>(ReadValue<uint32_t>(file->GetData(), 12))))
+		{
+			continue;
+		}
+
+		if (auto texture = Decode(file->GetData(), file->GetSize()))
+		{
+			return texture;
+		}
+
+		Log::Error("Texture variant could not be read: '%s'\n", variant.c_str());
+	}
+
+	return std::nullopt;
+}
+
+std::vector<std::string> ImageKtx::FindVariants(const std::string &filename)
+{
+	auto suffix = String::Lowercase(FileSystem::FileSuffix(filename));
+
+	if (suffix == ".ktx2")
+	{
+		return { filename };
+	}
+
+	auto stem = filename.substr(0, filename.size() - suffix.size());
+	std::vector<std::string> variants;
+
+	for (const auto &variant : VARIANT_SUFFIXES)
+	{
+		if (Files::ExistsInPath(stem + variant))
+		{
+			variants.emplace_back(stem + variant);
+		}
+	}
+
+	return variants;
+}
+
+std::optional<ImageKtx> ImageKtx::Decode(const uint8_t *data, const std::size_t &size)
+{
+	if (!IsKtx2(data, size))
+	{
+		return std::nullopt;
+	}
+
+	auto format = ReadValue<uint32_t>(data, 12);
+	auto width = ReadValue<uint32_t>(data, 20);
+	auto height = ReadValue<uint32_t>(data, 24);
+	auto depth = ReadValue<uint32_t>(data, 28);
+	auto layers = ReadValue<uint32_t>(data, 32);
+	auto faces = ReadValue<uint32_t>(data, 36);
+	auto levels = ReadValue<uint32_t>(data, 40);
+	auto supercompression = ReadValue<uint32_t>(data, 44);
+
+	// Basis Universal and zstd containers first have to be transcoded or inflated, the cooker writes containers without supercompression.
+	if (supercompression != 0 || format == VK_FORMAT_UNDEFINED)
+	{
+		Log::Error("Textures with supercompression %i are not supported\n", supercompression);
+		return std::nullopt;
+	}
+
+	if (width == 0 || height == 0 || depth > 1 || (faces != 1 && faces != 6))
+	{
+		Log::Error("Only 2D and cube textures are supported\n");
+		return std::nullopt;
+	}
+
+	ImageKtx result;
+	result.m_format = static_cast<VkFormat>(format);
+	result.m_extent = { width, height, 1 };
+	// A level count of zero asks the loader to generate mips, compressed mips can not be blitted so only the base level is used.
+	result.m_mipLevels = std::max(levels, 1u);
+	result.m_faces = faces;
+	result.m_layers = std::max(layers, 1u) * faces;
+
+	if (KTX2_HEADER_SIZE + result.m_mipLevels * KTX2_LEVEL_SIZE > size)
+	{
+		Log::Error("Texture level index is truncated\n");
+		return std::nullopt;
+	}
+
+	for (uint32_t i = 0; i < result.m_mipLevels; i++)
+	{
+		auto byteLength = ReadValue<uint64_t>(data, KTX2_HEADER_SIZE + i * KTX2_LEVEL_SIZE + 8);
+		result.m_offsets.emplace_back(result.m_size);
+		result.m_size += (byteLength + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT;
+	}
+
+	result.m_data = std::make_unique<uint8_t[]>(result.m_size);
+
+	for (uint32_t i = 0; i < result.m_mipLevels; i++)
+	{
+		auto byteOffset = ReadValue<uint64_t>(data, KTX2_HEADER_SIZE + i * KTX2_LEVEL_SIZE);
+		auto byteLength = ReadValue<uint64_t>(data, KTX2_HEADER_SIZE + i * KTX2_LEVEL_SIZE + 8);
+
+		if (byteOffset > size || byteLength > size - byteOffset)
+		{
+			Log::Error("Texture level %i is truncated\n", i);
+			return std::nullopt;
+		}
+
+		std::memcpy(result.m_data.get() + result.m_offsets[i], data + byteOffset, static_cast<std::size_t>(byteLength));
+	}
+
+	return result;
+}
+
+bool ImageKtx::IsFormatSupported(const VkFormat &format)
+{
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+	auto &enabledFeatures = Graphics::Get()->GetLogicalDevice()->GetEnabledFeatures();
+
+	if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK && !enabledFeatures.textureCompressionBC)
+	{
+		return false;
+	}
+
+	if (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK && !enabledFeatures.textureCompressionETC2)
+	{
+		return false;
+	}
+
+	if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK && !enabledFeatures.textureCompressionASTC_LDR)
+	{
+		return false;
+	}
+
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(*physicalDevice, format, &formatProperties);
+	return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+void ImageKtx::CmdCopyToImage(const CommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const uint32_t &mipLevels,
+	const uint32_t &baseMip) const
+{
+	std::vector<VkBufferImageCopy> regions(std::min(mipLevels, m_mipLevels - std::min(baseMip, m_mipLevels)));
+
+	for (uint32_t i = 0; i < regions.size(); i++)
+	{
+		auto level = baseMip + i;
+		regions[i].bufferOffset = m_offsets[level];
+		regions[i].bufferRowLength = 0;
+		regions[i].bufferImageHeight = 0;
+		regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		regions[i].imageSubresource.mipLevel = i;
+		regions[i].imageSubresource.baseArrayLayer = 0;
+		regions[i].imageSubresource.layerCount = m_layers;
+		regions[i].imageOffset = { 0, 0, 0 };
+		regions[i].imageExtent = { std::max(m_extent.width >> level, 1u), std::max(m_extent.height >> level, 1u), 1 };
+	}
+
+	vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+}
+}
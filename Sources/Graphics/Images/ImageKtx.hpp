@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "Graphics/Commands/CommandBuffer.hpp"
+
+namespace acid
+{
+/**
+ * @brief A texture read from a KTX2 container, its mip levels are stored in the file already in a format the device samples, such as BC1-7, ASTC or ETC2.
+ * Compressed variants of a image live next to it, a image "Rock.png" can have "Rock.bc.ktx2", "Rock.astc.ktx2", "Rock.etc2.ktx2" or "Rock.ktx2" variants.
+ * The first variant the device can sample is loaded in place of the image, when none can be sampled the image itself is decoded.
+ */
+class ACID_EXPORT ImageKtx
+{
+public:
+	/**
+	 * Loads the KTX2 texture of a image, the image itself when it is a KTX2 file, or else the first variant of it the device can sample.
+	 * @param filename The image file.
+	 * @return The texture, or nullopt if there is no texture the device can sample.
+	 */
+	static std::optional<ImageKtx> Load(const std::string &filename);
+
+	/**
+	 * Finds the KTX2 files that may be loaded for a image, the image itself when it is a KTX2 file, or else its variants that exist in the order they are preferred.
+	 * @param filename The image file.
+	 * @return The KTX2 files.
+	 */
+	static std::vector<std::string> FindVariants(const std::string &filename);
+
+	/**
+	 * Reads a KTX2 container held in memory, only containers without supercompression are read.
+	 * @param data The container.
+	 * @param size The size of the container.
+	 * @return The texture, or nullopt if the container could not be read.
+	 */
+	static std::optional<ImageKtx> Decode(const uint8_t *data, const std::size_t &size);
+
+	/**
+	 * Gets if the device can sample images of a format, compressed formats also need their texture compression feature to be enabled.
+	 * @param format The format.
+	 * @return If images of the format can be sampled.
+	 */
+	static bool IsFormatSupported(const VkFormat &format);
+
+	/**
+	 * Records copies of the mip levels from a staging buffer holding {@link ImageKtx#GetData} into a image in the transfer destination layout.
+	 * @param commandBuffer The command buffer.
+	 * @param buffer The staging buffer.
+	 * @param image The image.
+	 * @param mipLevels The number of levels copied.
+	 * @param baseMip The first level copied, it is copied into the first level of the image.
+	 */
+	void CmdCopyToImage(const CommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const uint32_t &mipLevels, const uint32_t &baseMip = 0) const;
+
+	const VkFormat &GetFormat() const { return m_format; }
+
+	const VkExtent3D &GetExtent() const { return m_extent; }
+
+	const uint32_t &GetMipLevels() const { return m_mipLevels; }
+
+	/**
+	 * Gets the number of layers in each level, array layers times faces.
+	 * @return The number of layers.
+	 */
+	const uint32_t &GetLayers() const { return m_layers; }
+
+	const uint32_t &GetFaces() const { return m_faces; }
+
+	/**
+	 * Gets the texel blocks of every level, the levels start at offsets aligned for copies, each holds its layers one after another.
+	 * @return The data.
+	 */
+	const uint8_t *GetData() const { return m_data.get(); }
+
+	std::unique_ptr<uint8_t[]> &GetData() { return m_data; }
+
+	const VkDeviceSize &GetSize() const { return m_size; }
+
+	/**
+	 * Gets where a level starts in {@link ImageKtx#GetData}, the levels after it follow to the end of the data.
+	 * @param mipLevel The level.
+	 * @return The offset in bytes.
+	 */
+	VkDeviceSize GetOffset(const uint32_t &mipLevel) const { return mipLevel < m_offsets.size() ? m_offsets[mipLevel] : m_size; }
+
+private:
+	VkFormat m_format = VK_FORMAT_UNDEFINED;
+	VkExtent3D m_extent = {};
+	uint32_t m_mipLevels = 0;
+	uint32_t m_layers = 0;
+	uint32_t m_faces = 0;
+	std::unique_ptr<uint8_t[]> m_data;
+	VkDeviceSize m_size = 0;
+	std::vector<VkDeviceSize> m_offsets;
+};
+}
@@ -0,0 +1,239 @@
+#include "ImageReadback.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Image.hpp"
+
+namespace acid
+{
+ImageReadback::ImageReadback(const uint32_t &slotCount) :
+	m_dropped(0)
+{
+	for (uint32_t i = 0; i < slotCount; i++)
+	{
+		m_slots.emplace_back(std::make_unique<Slot>());
+	}
+}
+
+ImageReadback::~ImageReadback()
+{
+	// The queue is idle by now, so every recorded copy has finished and is still handed to its callback.
+	std::vector<uint32_t> frames;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (const auto &slot : m_slots)
+		{
+			if (slot->m_frame && std::find(frames.begin(), frames.end(), *slot->m_frame) == frames.end())
+			{
+				frames.emplace_back(*slot->m_frame);
+			}
+		}
+	}
+
+	for (const auto &frame : frames)
+	{
+		Complete(frame);
+	}
+
+	Engine::Get()->GetThreadPool().Wait(m_reading);
+}
+
+void ImageReadback::Read(const VkImage &image, const VkFormat &format, const Vector2ui &extent, const VkImageLayout &layout, Callback callback,
+	const uint32_t &mipLevel, const uint32_t &arrayLayer)
+{
+	ReadRegion(image, format, Vector2ui::Zero, extent, layout, std::move(callback), mipLevel, arrayLayer);
+}
+
+void ImageReadback::ReadRegion(const VkImage &image, const VkFormat &format, const Vector2ui &offset, const Vector2ui &extent, const VkImageLayout &layout,
+	Callback callback, const uint32_t &mipLevel, const uint32_t &arrayLayer)
+{
+	if (image == VK_NULL_HANDLE || extent.m_x == 0 || extent.m_y == 0 || Image::GetImageDataSize(format, { extent.m_x, extent.m_y, 1 }, 1, 1) == 0)
+	{
+		Log::Error("Image readback of format %i is not supported\n", format);
+		return;
+	}
+
+	Request request = {};
+	request.m_image = image;
+	request.m_format = format;
+	request.m_offset = offset;
+	request.m_extent = extent;
+	request.m_layout = layout;
+	request.m_mipLevel = mipLevel;
+	request.m_arrayLayer = arrayLayer;
+	request.m_callback = std::move(callback);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_requests.emplace_back(std::move(request));
+}
+
+void ImageReadback::ReadSwapchain(Callback callback)
+{
+	Request request = {};
+	request.m_callback = std::move(callback);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_requests.emplace_back(std::move(request));
+}
+
+void ImageReadback::SetStream(Callback stream)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stream = std::move(stream);
+}
+
+void ImageReadback::CmdRecord(const CommandBuffer &commandBuffer, const uint32_t &frame, const VkImage &swapchainImage, const VkFormat &swapchainFormat,
+	const Vector2ui &swapchainExtent)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto recorded = false;
+
+	// Requests wait in order for a free slot, so a burst of captures is spread over the following frames.
+	while (!m_requests.empty())
+	{
+		auto slot = FindFreeSlot();
+
+		if (slot == nullptr)
+		{
+			break;
+		}
+
+		auto request = std::move(m_requests.front());
+		m_requests.pop_front();
+
+		if (request.m_image == VK_NULL_HANDLE)
+		{
+			request.m_image = swapchainImage;
+			request.m_format = swapchainFormat;
+			request.m_extent = swapchainExtent;
+			request.m_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		}
+
+		CmdCopy(commandBuffer, *slot, std::move(request), frame);
+		recorded = true;
+	}
+
+	if (m_stream)
+	{
+		if (auto slot = FindFreeSlot(); slot != nullptr)
+		{
+			Request request = {};
+			request.m_image = swapchainImage;
+			request.m_format = swapchainFormat;
+			request.m_extent = swapchainExtent;
+			request.m_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+			request.m_callback = m_stream;
+			CmdCopy(commandBuffer, *slot, std::move(request), frame);
+			recorded = true;
+		}
+		else
+		{
+			m_dropped++;
+		}
+	}
+
+	if (!recorded)
+	{
+		return;
+	}
+
+	// The copies are made visible to the host once, the fence of the frame then orders the reads.
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void ImageReadback::Complete(const uint32_t &frame)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const auto &slot : m_slots)
+	{
+		if (slot->m_frame != frame || slot->m_reading)
+		{
+			continue;
+		}
+
+		slot->m_reading = true;
+
+		Engine::Get()->GetThreadPool().Dispatch([this, reading = slot.get()]()
+		{
+			auto &request = *reading->m_request;
+			request.m_callback(static_cast<const uint8_t *>(reading->m_buffer->GetAllocation().GetMapped()), request.m_extent, request.m_format);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			reading->m_request = std::nullopt;
+			reading->m_frame = std::nullopt;
+			reading->m_reading = false;
+		}, &m_reading);
+	}
+}
+
+uint32_t ImageReadback::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto count = static_cast<uint32_t>(m_requests.size());
+
+	for (const auto &slot : m_slots)
+	{
+		if (slot->m_request)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+ImageReadback::Slot *ImageReadback::FindFreeSlot() const
+{
+	for (const auto &slot : m_slots)
+	{
+		if (!slot->m_request)
+		{
+			return slot.get();
+		}
+	}
+
+	return nullptr;
+}
+
+void ImageReadback::CmdCopy(const CommandBuffer &commandBuffer, Slot &slot, Request &&request, const uint32_t &frame) const
+{
+	auto size = Image::GetImageDataSize(request.m_format, { request.m_extent.m_x, request.m_extent.m_y, 1 }, 1, 1);
+
+	// Slot buffers are kept between readbacks and only replaced when a larger image is read.
+	if (slot.m_buffer == nullptr || slot.m_buffer->GetSize() < size)
+	{
+		slot.m_buffer = std::make_unique<Buffer>(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	}
+
+	auto swapchain = request.m_layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	auto srcAccessMask = swapchain ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_MEMORY_WRITE_BIT;
+	auto srcStageMask = swapchain ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	auto dstStageMask = swapchain ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+	Image::InsertImageMemoryBarrier(commandBuffer, request.m_image, srcAccessMask, VK_ACCESS_TRANSFER_READ_BIT, request.m_layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		srcStageMask, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, request.m_mipLevel, 1, request.m_arrayLayer);
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = request.m_mipLevel;
+	region.imageSubresource.baseArrayLayer = request.m_arrayLayer;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { static_cast<int32_t>(request.m_offset.m_x), static_cast<int32_t>(request.m_offset.m_y), 0 };
+	region.imageExtent = { request.m_extent.m_x, request.m_extent.m_y, 1 };
+	vkCmdCopyImageToBuffer(commandBuffer, request.m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.m_buffer->GetBuffer(), 1, &region);
+
+	Image::InsertImageMemoryBarrier(commandBuffer, request.m_image, VK_ACCESS_TRANSFER_READ_BIT, swapchain ? 0 : VK_ACCESS_MEMORY_READ_BIT,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, request.m_layout, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, VK_IMAGE_ASPECT_COLOR_BIT, 1, request.m_mipLevel, 1,
+		request.m_arrayLayer);
+
+	slot.m_request = std::move(request);
+	slot.m_frame = frame;
+}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <deque>
+#include "Helpers/NonCopyable.hpp"
+#include "Helpers/ThreadPool.hpp"
+#include "Maths/Vector2.hpp"
+#include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Commands/CommandBuffer.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that reads images back to the host without stalling, copies are recorded at the end of a frame and read once that frame has completed.
+ * Texels are copied into a ring of persistent host visible buffers, callbacks run on the engines job system so encoding never blocks the render thread.
+ */
+class ACID_EXPORT ImageReadback :
+	public NonCopyable
+{
+public:
+	/**
+	 * A function called from a worker thread with the texels of a finished readback, rows are tightly packed in the format of the image.
+	 * The texels are only valid until the function returns.
+	 */
+	using Callback = std::function<void(const uint8_t *texels, const Vector2ui &extent, const VkFormat &format)>;
+
+	/**
+	 * Creates a new image readback.
+	 * @param slotCount The number of readbacks that can be in flight at once.
+	 */
+	explicit ImageReadback(const uint32_t &slotCount = 4);
+
+	~ImageReadback();
+
+	/**
+	 * Queues a readback of a image, the image must stay alive and in the layout until the next frame has been recorded.
+	 * @param image The image to read, it must have been created with transfer source usage.
+	 * @param format The format of the image.
+	 * @param extent The extent of the mip level read.
+	 * @param layout The layout the image is in, it is returned to this layout after the copy.
+	 * @param callback The function given the texels.
+	 * @param mipLevel The mip level to read.
+	 * @param arrayLayer The array layer to read.
+	 */
+	void Read(const VkImage &image, const VkFormat &format, const Vector2ui &extent, const VkImageLayout &layout, Callback callback, const uint32_t &mipLevel = 0,
+		const uint32_t &arrayLayer = 0);
+
+	/**
+	 * Queues a readback of a region of a image, such as the texel under the cursor. Only the region is copied, so small reads use a few bytes of their slot.
+	 * @param image The image to read, it must have been created with transfer source usage.
+	 * @param format The format of the image.
+	 * @param offset The offset of the region in texels.
+	 * @param extent The extent of the region, the callback is given the texels of the region.
+	 * @param layout The layout the image is in, it is returned to this layout after the copy.
+	 * @param callback The function given the texels.
+	 * @param mipLevel The mip level to read.
+	 * @param arrayLayer The array layer to read.
+	 */
+	void ReadRegion(const VkImage &image, const VkFormat &format, const Vector2ui &offset, const Vector2ui &extent, const VkImageLayout &layout, Callback callback,
+		const uint32_t &mipLevel = 0, const uint32_t &arrayLayer = 0);
+
+	/**
+	 * Queues a readback of the next swapchain image that is presented.
+	 * @param callback The function given the texels.
+	 */
+	void ReadSwapchain(Callback callback);
+
+	/**
+	 * Sets a function that is given every presented frame, such as a external video encoder. Frames are dropped while every slot is in use.
+	 * @param stream The function, or nullptr to stop streaming.
+	 */
+	void SetStream(Callback stream);
+
+	/**
+	 * Records the queued copies, this is called by {@link Graphics} after the last renderpass of a frame.
+	 * @param commandBuffer The command buffer of the frame.
+	 * @param frame The index of the frame in flight.
+	 * @param swapchainImage The swapchain image the frame presents, in the present layout.
+	 * @param swapchainFormat The format of the swapchain image.
+	 * @param swapchainExtent The extent of the swapchain image.
+	 */
+	void CmdRecord(const CommandBuffer &commandBuffer, const uint32_t &frame, const VkImage &swapchainImage, const VkFormat &swapchainFormat,
+		const Vector2ui &swapchainExtent);
+
+	/**
+	 * Hands copies recorded in a frame to workers, this is called by {@link Graphics} once the fence of the frame has been waited on.
+	 * @param frame The index of the frame in flight.
+	 */
+	void Complete(const uint32_t &frame);
+
+	/**
+	 * Gets the number of readbacks that are queued, copying or being read.
+	 * @return The number of readbacks not yet finished.
+	 */
+	uint32_t GetPendingCount() const;
+
+	/**
+	 * Gets the number of streamed frames dropped because every slot was in use.
+	 * @return The number of dropped frames.
+	 */
+	uint32_t GetDroppedCount() const { return m_dropped.load(); }
+
+private:
+	class Request
+	{
+	public:
+		// A null image is resolved to the swapchain image when recorded.
+		VkImage m_image = VK_NULL_HANDLE;
+		VkFormat m_format = VK_FORMAT_UNDEFINED;
+		Vector2ui m_offset;
+		Vector2ui m_extent;
+		VkImageLayout m_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		uint32_t m_mipLevel = 0;
+		uint32_t m_arrayLayer = 0;
+		Callback m_callback;
+	};
+
+	class Slot
+	{
+	public:
+		std::unique_ptr<Buffer> m_buffer;
+		std::optional<Request> m_request;
+		std::optional<uint32_t> m_frame;
+		bool m_reading = false;
+	};
+
+	Slot *FindFreeSlot() const;
+
+	void CmdCopy(const CommandBuffer &commandBuffer, Slot &slot, Request &&request, const uint32_t &frame) const;
+
+	std::vector<std::unique_ptr<Slot>> m_slots;
+	std::deque<Request> m_requests;
+	Callback m_stream;
+	std::atomic<uint32_t> m_dropped;
+
+	ThreadPool::Counter m_reading;
+	mutable std::mutex m_mutex;
+};
+}
@@ -0,0 +1,718 @@
+#include "ImageStreamer.hpp"
+
+#include "Files/FileSystem.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Helpers/String.hpp"
+#include "Image.hpp"
+#include "MipmapGenerator.hpp"
+
+namespace acid
+{
+// Staging memory recorded for upload per update, the rest waits so a burst of loads does not stall a frame.
+static const VkDeviceSize UPLOAD_BUDGET = 64 * 1024 * 1024;
+// Streamed images always keep their levels of 64 texels and smaller, so they can be drawn while their higher levels stream in.
+static const uint32_t MIN_RESIDENT_LEVELS = 7;
+// Images not drawn for this many frames only want their lowest levels.
+static const uint64_t UNUSED_FRAMES = 300;
+
+static uint32_t GetMaxBaseMip(const uint32_t &mipLevels)
+{
+	return mipLevels > MIN_RESIDENT_LEVELS ? mipLevels - MIN_RESIDENT_LEVELS : 0;
+}
+
+static std::unique_ptr<uint8_t[]> Downsample(const uint8_t *pixels, Vector2ui &extent, const uint32_t &components)
+{
+	Vector2ui half(std::max(extent.m_x >> 1, 1u), std::max(extent.m_y >> 1, 1u));
+	auto result = std::make_unique<uint8_t[]>(half.m_x * half.m_y * components);
+
+	// Averages each 2x2 block of texels, the last row or column of a odd extent is repeated.
+	for (uint32_t y = 0; y < half.m_y; y++)
+	{
+		auto y0 = std::min(y * 2, extent.m_y - 1) * extent.m_x;
+		auto y1 = std::min(y * 2 + 1, extent.m_y - 1) * extent.m_x;
+
+		for (uint32_t x = 0; x < half.m_x; x++)
+		{
+			auto x0 = std::min(x * 2, extent.m_x - 1);
+			auto x1 = std::min(x * 2 + 1, extent.m_x - 1);
+
+			for (uint32_t c = 0; c < components; c++)
+			{
+				uint32_t sum = pixels[(y0 + x0) * components + c] + pixels[(y0 + x1) * components + c] + pixels[(y1 + x0) * components + c] +
+					pixels[(y1 + x1) * components + c];
+				result[(y * half.m_x + x) * components + c] = static_cast<uint8_t>((sum + 2) / 4);
+			}
+		}
+	}
+
+	extent = half;
+	return result;
+}
+
+static void CmdTransferOwnership(const CommandBuffer &commandBuffer, const VkImage &image, const uint32_t &mipLevels, const VkAccessFlags &srcAccessMask,
+	const VkAccessFlags &dstAccessMask, const VkImageLayout &oldImageLayout, const VkImageLayout &newImageLayout, const VkPipelineStageFlags &srcStageMask,
+	const VkPipelineStageFlags &dstStageMask, const uint32_t &srcQueueFamily, const uint32_t &dstQueueFamily)
+{
+	VkImageMemoryBarrier imageMemoryBarrier = {};
+	imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageMemoryBarrier.srcAccessMask = srcAccessMask;
+	imageMemoryBarrier.dstAccessMask = dstAccessMask;
+	imageMemoryBarrier.oldLayout = oldImageLayout;
+	imageMemoryBarrier.newLayout = newImageLayout;
+	imageMemoryBarrier.srcQueueFamilyIndex = srcQueueFamily;
+	imageMemoryBarrier.dstQueueFamilyIndex = dstQueueFamily;
+	imageMemoryBarrier.image = image;
+	imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+	imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
+	imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+	imageMemoryBarrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+}
+
+ImageStreamer::ImageStreamer() :
+	m_placeholder(nullptr),
+	m_streaming(0),
+	m_nextRead(1),
+	m_closing(false),
+	m_budget(0),
+	m_residentSize(0),
+	m_mipBias(0.0f)
+{
+}
+
+ImageStreamer::~ImageStreamer()
+{
+	std::vector<uint64_t> reads;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closing = true;
+
+		for (const auto &[ticket, id] : m_reads)
+		{
+			reads.emplace_back(id);
+		}
+	}
+
+	// Cancelling waits for callbacks that are running, so every decode they dispatched is counted before waiting.
+	for (const auto &id : reads)
+	{
+		AsyncReader::Get()->Cancel(id);
+	}
+
+	Engine::Get()->GetThreadPool().Wait(m_decoding);
+
+	for (auto &upload : m_uploads)
+	{
+		auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+		Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &upload.m_fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+		Destroy(upload.m_handles);
+		Release(upload);
+	}
+
+	for (auto &retired : m_retired)
+	{
+		Destroy(retired.m_handles);
+	}
+}
+
+void ImageStreamer::Load(const std::shared_ptr<Image2d> &image)
+{
+	if (image == nullptr || image->m_filename.empty() || !image->m_resident || image->m_image != VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	image->m_resident = false;
+	m_streaming++;
+	m_managed.emplace_back(image);
+
+	// The first upload skips the highest levels that do not fit in the memory left in the budget.
+	auto budget = GetBudget();
+	Decode(image, 0, budget > m_residentSize ? budget - m_residentSize : 0, AsyncReader::Priority::High);
+}
+
+void ImageStreamer::Decode(const std::shared_ptr<Image2d> &image, const uint32_t &baseMip, const VkDeviceSize &headroom, const AsyncReader::Priority &priority)
+{
+	image->m_mipsPending = true;
+
+	auto reading = std::make_shared<Reading>();
+	reading->m_image = image;
+	reading->m_baseMip = baseMip;
+	reading->m_headroom = headroom;
+	reading->m_priority = priority;
+	reading->m_files = ImageKtx::FindVariants(image->m_filename);
+
+	if (String::Lowercase(FileSystem::FileSuffix(image->m_filename)) != ".ktx2")
+	{
+		reading->m_files.emplace_back(image->m_filename);
+	}
+
+	Read(reading);
+}
+
+void ImageStreamer::Read(const std::shared_ptr<Reading> &reading)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_closing)
+	{
+		return;
+	}
+
+	// The lock is held until the id is stored, so the callback can not forget the read before it is known.
+	auto ticket = m_nextRead++;
+	m_reads[ticket] = AsyncReader::Get()->Read(reading->m_files[reading->m_file], [this, reading, ticket](std::optional<FileView> file)
+	{
+		// The decode is dispatched before the read is forgotten, so the destructor always waits for it.
+		Engine::Get()->GetThreadPool().Dispatch([this, reading, file = std::move(file)]()
+		{
+			DecodeFile(reading, file);
+		}, &m_decoding);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_reads.erase(ticket);
+	}, reading->m_priority);
+}
+
+void ImageStreamer::DecodeFile(const std::shared_ptr<Reading> &reading, const std::optional<FileView> &file)
+{
+	auto &image = reading->m_image;
+	auto &filename = reading->m_files[reading->m_file];
+
+	Decoded decoded = {};
+	decoded.m_image = image;
+#if defined(ACID_VERBOSE)
+	auto debugStart = Engine::GetTime();
+#endif
+
+	if (String::Lowercase(FileSystem::FileSuffix(filename)) == ".ktx2")
+	{
+		if (file)
+		{
+			decoded.m_texture = ImageKtx::Decode(file->GetData(), file->GetSize());
+		}
+
+		if (decoded.m_texture && ImageKtx::IsFormatSupported(decoded.m_texture->GetFormat()) && decoded.m_texture->GetLayers() == 1)
+		{
+			auto extent = decoded.m_texture->GetExtent();
+			decoded.m_extent = Vector2ui(extent.width, extent.height);
+			decoded.m_format = decoded.m_texture->GetFormat();
+			decoded.m_mipLevels = image->m_mipmap ? decoded.m_texture->GetMipLevels() : 1;
+		}
+		else
+		{
+			decoded.m_texture = std::nullopt;
+
+			if (reading->m_file + 1 < reading->m_files.size())
+			{
+				reading->m_file++;
+				Read(reading);
+				return;
+			}
+		}
+	}
+	else if (file)
+	{
+		decoded.m_pixels = Image::LoadPixels(*file, filename, decoded.m_extent, decoded.m_components, decoded.m_format);
+
+		if (decoded.m_pixels != nullptr && image->m_mipmap)
+		{
+			decoded.m_mipLevels = Image::GetMipLevels({ decoded.m_extent.m_x, decoded.m_extent.m_y, 1 });
+		}
+	}
+	else
+	{
+		Log::Error("Image could not be loaded: '%s'\n", filename.c_str());
+	}
+
+	auto maxBaseMip = GetMaxBaseMip(decoded.m_mipLevels);
+
+	// Only one byte per component can be downsampled, other decoded formats are uploaded from their first level.
+	if (!decoded.m_texture && Image::GetFormatSize(decoded.m_format) != decoded.m_components)
+	{
+		maxBaseMip = 0;
+	}
+
+	decoded.m_baseMip = std::min(reading->m_baseMip, maxBaseMip);
+
+	while (decoded.m_baseMip < maxBaseMip && GetLevelsSize(decoded, decoded.m_baseMip) > reading->m_headroom)
+	{
+		decoded.m_baseMip++;
+	}
+
+	if (decoded.m_pixels != nullptr)
+	{
+		auto extent = decoded.m_extent;
+
+		for (uint32_t i = 0; i < decoded.m_baseMip; i++)
+		{
+			decoded.m_pixels = Downsample(decoded.m_pixels.get(), extent, decoded.m_components);
+		}
+	}
+#if defined(ACID_VERBOSE)
+	auto debugEnd = Engine::GetTime();
+	Log::Out("Image 2D '%s' decoded in %.3fms\n", filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
+#endif
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_decoded.emplace_back(std::move(decoded));
+}
+
+void ImageStreamer::Update()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	// Finished uploads become resident, descriptors pick up the new handles the next time they are pushed.
+	for (auto it = m_uploads.begin(); it != m_uploads.end();)
+	{
+		if (vkGetFenceStatus(*logicalDevice, it->m_fence) != VK_SUCCESS)
+		{
+			++it;
+			continue;
+		}
+
+		auto &image = *it->m_image;
+		Swap(image, it->m_handles);
+		image.m_mipsPending = false;
+
+		if (!image.m_resident)
+		{
+			image.m_resident = true;
+			m_streaming--;
+		}
+
+		Release(*it);
+		it = m_uploads.erase(it);
+	}
+
+	std::vector<Decoded> decoded;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		VkDeviceSize budget = 0;
+
+		auto it = m_decoded.begin();
+
+		for (; it != m_decoded.end() && budget < UPLOAD_BUDGET; ++it)
+		{
+			budget += it->m_texture ? it->m_texture->GetSize() : GetLevelsSize(*it, it->m_baseMip);
+		}
+
+		decoded.insert(decoded.end(), std::make_move_iterator(m_decoded.begin()), std::make_move_iterator(it));
+		m_decoded.erase(m_decoded.begin(), it);
+	}
+
+	for (auto &image : decoded)
+	{
+		Submit(image);
+	}
+
+	UpdateResidency();
+}
+
+const Image2d *ImageStreamer::GetPlaceholder()
+{
+	if (m_placeholder == nullptr)
+	{
+		auto pixels = std::make_unique<uint8_t[]>(4);
+		std::fill(pixels.get(), pixels.get() + 4, 0xFF);
+		m_placeholder = std::make_unique<Image2d>(Vector2ui(1, 1), std::move(pixels), VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+	}
+
+	return m_placeholder.get();
+}
+
+uint32_t ImageStreamer::GetStreamingCount() const
+{
+	return m_streaming.load();
+}
+
+VkDeviceSize ImageStreamer::GetBudget() const
+{
+	if (m_budget != 0)
+	{
+		return m_budget;
+	}
+
+	// Half of the largest device local heap leaves the rest for attachments, buffers and other applications.
+	const auto &memoryProperties = Graphics::Get()->GetPhysicalDevice()->GetMemoryProperties();
+	VkDeviceSize heapSize = 0;
+
+	for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+	{
+		if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+		{
+			heapSize = std::max(heapSize, memoryProperties.memoryHeaps[i].size);
+		}
+	}
+
+	return heapSize / 2;
+}
+
+void ImageStreamer::Submit(Decoded &decoded)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto &image = *decoded.m_image;
+
+	if ((decoded.m_pixels == nullptr && !decoded.m_texture) || decoded.m_extent.m_x == 0 || decoded.m_extent.m_y == 0)
+	{
+		Log::Error("Failed to stream image: '%s'\n", image.m_filename.c_str());
+		image.m_mipsPending = false;
+
+		// Resident images keep the levels they already have.
+		if (!image.m_resident)
+		{
+			m_streaming--;
+		}
+
+		return;
+	}
+
+	image.m_extent = decoded.m_extent;
+	image.m_components = decoded.m_components;
+	image.m_format = decoded.m_format;
+	image.m_mipLevels = decoded.m_mipLevels;
+
+	if (image.m_mipmap && !decoded.m_texture && MipmapGenerator::IsSupported(image.m_format))
+	{
+		image.m_usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+	}
+
+	// Compressed textures can not be blitted, their mip levels are copied from the file instead.
+	auto createMipmaps = image.m_mipmap && !decoded.m_texture;
+	auto mipLevels = image.m_mipLevels - decoded.m_baseMip;
+	auto extent = VkExtent3D{ std::max(image.m_extent.m_x >> decoded.m_baseMip, 1u), std::max(image.m_extent.m_y >> decoded.m_baseMip, 1u), 1 };
+
+	// The image keeps its current handles until the upload has finished.
+	Upload upload = {};
+	upload.m_image = decoded.m_image;
+	upload.m_handles = CreateHandles(image, decoded.m_baseMip);
+	auto dstImage = upload.m_handles.m_image;
+
+	if (decoded.m_texture)
+	{
+		upload.m_bufferStaging = std::make_unique<Buffer>(decoded.m_texture->GetSize(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, decoded.m_texture->GetData().get(), MemoryAllocator::Lifetime::Transient);
+	}
+	else
+	{
+		upload.m_bufferStaging = std::make_unique<Buffer>(extent.width * extent.height * image.m_components, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, decoded.m_pixels.get(), MemoryAllocator::Lifetime::Transient);
+	}
+
+	decoded.m_pixels = nullptr;
+
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	Graphics::CheckVk(vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &upload.m_fence));
+
+	auto transferFamily = logicalDevice->GetTransferFamily();
+	auto graphicsFamily = logicalDevice->GetGraphicsFamily();
+	auto dedicated = transferFamily != graphicsFamily;
+
+	// Without a dedicated transfer family the whole upload is recorded on the graphics queue.
+	upload.m_transferCommandBuffer = std::make_unique<CommandBuffer>(true, dedicated ? VK_QUEUE_TRANSFER_BIT : VK_QUEUE_GRAPHICS_BIT);
+	Image::InsertImageMemoryBarrier(*upload.m_transferCommandBuffer, dstImage, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1, 0);
+
+	if (decoded.m_texture)
+	{
+		decoded.m_texture->CmdCopyToImage(*upload.m_transferCommandBuffer, upload.m_bufferStaging->GetBuffer(), dstImage, mipLevels, decoded.m_baseMip);
+		decoded.m_texture = std::nullopt;
+	}
+	else
+	{
+		Image::CmdCopyBufferToImage(*upload.m_transferCommandBuffer, upload.m_bufferStaging->GetBuffer(), dstImage, extent, 1, 0);
+	}
+
+	// Mipmaps are blitted on the graphics queue, so the image stays a transfer destination until then.
+	auto uploadedLayout = createMipmaps ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : image.m_layout;
+
+	if (!dedicated)
+	{
+		if (createMipmaps)
+		{
+			Image::CmdCreateMipmaps(*upload.m_transferCommandBuffer, dstImage, extent, image.m_format, image.m_layout, mipLevels, 0, 1, image.m_usage);
+		}
+		else
+		{
+			Image::InsertImageMemoryBarrier(*upload.m_transferCommandBuffer, dstImage, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, image.m_layout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
+				mipLevels, 0, 1, 0);
+		}
+
+		upload.m_transferCommandBuffer->Submit(VK_NULL_HANDLE, VK_NULL_HANDLE, upload.m_fence);
+		m_uploads.emplace_back(std::move(upload));
+		return;
+	}
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	Graphics::CheckVk(vkCreateSemaphore(*logicalDevice, &semaphoreCreateInfo, nullptr, &upload.m_semaphore));
+
+	// Releases the image from the transfer family, the graphics family acquires it with a matching barrier.
+	CmdTransferOwnership(*upload.m_transferCommandBuffer, dstImage, mipLevels, VK_ACCESS_TRANSFER_WRITE_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		uploadedLayout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, transferFamily, graphicsFamily);
+	upload.m_transferCommandBuffer->Submit(VK_NULL_HANDLE, upload.m_semaphore);
+
+	upload.m_graphicsCommandBuffer = std::make_unique<CommandBuffer>(true, VK_QUEUE_GRAPHICS_BIT);
+	CmdTransferOwnership(*upload.m_graphicsCommandBuffer, dstImage, mipLevels, 0,
+		createMipmaps ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uploadedLayout,
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, createMipmaps ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, transferFamily, graphicsFamily);
+
+	if (createMipmaps)
+	{
+		Image::CmdCreateMipmaps(*upload.m_graphicsCommandBuffer, dstImage, extent, image.m_format, image.m_layout, mipLevels, 0, 1, image.m_usage);
+	}
+
+	upload.m_graphicsCommandBuffer->Submit(upload.m_semaphore, VK_NULL_HANDLE, upload.m_fence, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+	m_uploads.emplace_back(std::move(upload));
+}
+
+void ImageStreamer::Release(Upload &upload) const
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	vkDestroyFence(*logicalDevice, upload.m_fence, nullptr);
+	vkDestroySemaphore(*logicalDevice, upload.m_semaphore, nullptr);
+	upload.m_transferCommandBuffer = nullptr;
+	upload.m_graphicsCommandBuffer = nullptr;
+	upload.m_bufferStaging = nullptr;
+	upload.m_image = nullptr;
+}
+
+void ImageStreamer::UpdateResidency()
+{
+	auto graphics = Graphics::Get();
+	auto frameCount = graphics->GetFrameCount();
+
+	// The frame being recorded when a image swapped handles may still sample its previous handles, they are destroyed once its fence has been waited on.
+	while (!m_retired.empty() && m_retired.front().m_frame + graphics->GetFramesInFlight() < frameCount)
+	{
+		Destroy(m_retired.front().m_handles);
+		m_retired.pop_front();
+	}
+
+	std::vector<std::shared_ptr<Image2d>> images;
+	m_residentSize = 0;
+
+	for (auto it = m_managed.begin(); it != m_managed.end();)
+	{
+		auto image = it->lock();
+
+		if (image == nullptr)
+		{
+			it = m_managed.erase(it);
+			continue;
+		}
+
+		if (image->m_resident)
+		{
+			m_residentSize += image->m_memory.GetSize();
+
+			if (!image->m_mipsPending && image->m_mipLevels > 1)
+			{
+				images.emplace_back(std::move(image));
+			}
+		}
+
+		++it;
+	}
+
+	auto budget = GetBudget();
+
+	// The least recently drawn images lose their levels first, images the mesh pass never asked for are not evicted.
+	std::sort(images.begin(), images.end(), [](const std::shared_ptr<Image2d> &a, const std::shared_ptr<Image2d> &b)
+	{
+		return a->m_requestedFrame < b->m_requestedFrame;
+	});
+
+	// Drops one level at a time from images drawn before a frame until the required memory fits in the budget.
+	auto evict = [&](const VkDeviceSize &required, const uint64_t &before)
+	{
+		for (auto &image : images)
+		{
+			if (m_residentSize + required <= budget || image->m_requestedFrame >= before)
+			{
+				break;
+			}
+
+			auto maxBaseMip = GetMaxBaseMip(image->m_mipLevels);
+
+			if (image->m_requestedFrame == 0 || image->m_mipsPending || image->m_baseMip >= maxBaseMip)
+			{
+				continue;
+			}
+
+			m_residentSize -= Evict(*image, std::min(std::max(image->m_baseMip + 1, GetWantedMip(*image)), maxBaseMip));
+		}
+
+		return m_residentSize + required <= budget;
+	};
+
+	evict(0, frameCount + 1);
+
+	// Levels no longer needed are dropped, one level is kept above the wanted level so images drawn at a changing size do not stream in and out.
+	for (auto &image : images)
+	{
+		auto wantedMip = GetWantedMip(*image);
+
+		if (wantedMip > image->m_baseMip + 1)
+		{
+			m_residentSize -= Evict(*image, wantedMip);
+		}
+	}
+
+	// The most recently drawn images stream in their missing levels first, the current levels stay resident until the upload has finished.
+	VkDeviceSize streaming = 0;
+
+	for (auto it = images.rbegin(); it != images.rend(); ++it)
+	{
+		auto &image = *it;
+		auto wantedMip = GetWantedMip(*image);
+
+		if (image->m_mipsPending || wantedMip >= image->m_baseMip)
+		{
+			continue;
+		}
+
+		// Each level is about four times the size of the level below it.
+		auto required = image->m_memory.GetSize() << (2 * (image->m_baseMip - wantedMip));
+
+		if (!evict(streaming + required, image->m_requestedFrame))
+		{
+			continue;
+		}
+
+		streaming += required;
+		Decode(image, wantedMip, std::numeric_limits<VkDeviceSize>::max(), AsyncReader::Priority::Normal);
+	}
+}
+
+uint32_t ImageStreamer::GetWantedMip(const Image2d &image) const
+{
+	auto maxBaseMip = GetMaxBaseMip(image.m_mipLevels);
+
+	// Images the mesh pass never asked for, such as interface images, are kept whole.
+	if (image.m_requestedFrame == 0)
+	{
+		return 0;
+	}
+
+	if (image.m_requestedFrame + UNUSED_FRAMES < Graphics::Get()->GetFrameCount())
+	{
+		return maxBaseMip;
+	}
+
+	auto size = static_cast<float>(std::max(image.m_extent.m_x, image.m_extent.m_y));
+	auto mip = std::floor(std::log2(size / std::max(image.m_requestedPixels, 1.0f)) + m_mipBias);
+	return static_cast<uint32_t>(std::clamp(mip, 0.0f, static_cast<float>(maxBaseMip)));
+}
+
+VkDeviceSize ImageStreamer::Evict(Image2d &image, const uint32_t &baseMip)
+{
+	auto handles = CreateHandles(image, baseMip);
+	auto mipLevels = image.m_mipLevels - baseMip;
+	auto srcMip = baseMip - image.m_baseMip;
+
+	Graphics::Get()->GetUploadContext()->Record([&](const CommandBuffer &commandBuffer)
+	{
+		Image::InsertImageMemoryBarrier(commandBuffer, image.m_image, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT, image.m_layout,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, srcMip, 1, 0);
+		Image::InsertImageMemoryBarrier(commandBuffer, handles.m_image, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1, 0);
+
+		std::vector<VkImageCopy> regions(mipLevels);
+
+		for (uint32_t i = 0; i < mipLevels; i++)
+		{
+			regions[i].srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, srcMip + i, 0, 1 };
+			regions[i].dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 };
+			regions[i].extent = { std::max(image.m_extent.m_x >> (baseMip + i), 1u), std::max(image.m_extent.m_y >> (baseMip + i), 1u), 1 };
+		}
+
+		vkCmdCopyImage(commandBuffer, image.m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, handles.m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels,
+			regions.data());
+
+		// The frames in flight still sample the previous handles, so they are returned to their layout.
+		Image::InsertImageMemoryBarrier(commandBuffer, image.m_image, VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			image.m_layout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, srcMip, 1, 0);
+		Image::InsertImageMemoryBarrier(commandBuffer, handles.m_image, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			image.m_layout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1, 0);
+	});
+
+	auto freed = image.m_memory.GetSize() - handles.m_memory.GetSize();
+	Swap(image, handles);
+	return freed;
+}
+
+ImageStreamer::Handles ImageStreamer::CreateHandles(const Image2d &image, const uint32_t &baseMip)
+{
+	Handles handles;
+	handles.m_baseMip = baseMip;
+
+	auto mipLevels = image.m_mipLevels - baseMip;
+	auto extent = VkExtent3D{ std::max(image.m_extent.m_x >> baseMip, 1u), std::max(image.m_extent.m_y >> baseMip, 1u), 1 };
+
+	Image::CreateImage(handles.m_image, handles.m_memory, extent, image.m_format, image.m_samples, VK_IMAGE_TILING_OPTIMAL, image.m_usage,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mipLevels, 1, VK_IMAGE_TYPE_2D);
+	handles.m_sampler = Image::GetImageSampler(image.m_filter, image.m_addressMode, image.m_anisotropic);
+	Image::CreateImageView(handles.m_image, handles.m_view, VK_IMAGE_VIEW_TYPE_2D, image.m_format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1, 0);
+	return handles;
+}
+
+VkDeviceSize ImageStreamer::GetLevelsSize(const Decoded &decoded, const uint32_t &baseMip)
+{
+	if (decoded.m_texture)
+	{
+		return decoded.m_texture->GetSize() - decoded.m_texture->GetOffset(baseMip);
+	}
+
+	VkDeviceSize size = 0;
+
+	for (auto i = baseMip; i < decoded.m_mipLevels; i++)
+	{
+		size += static_cast<VkDeviceSize>(std::max(decoded.m_extent.m_x >> i, 1u)) * std::max(decoded.m_extent.m_y >> i, 1u) * decoded.m_components;
+	}
+
+	return size;
+}
+
+void ImageStreamer::Swap(Image2d &image, Handles &handles)
+{
+	if (image.m_image != VK_NULL_HANDLE)
+	{
+		Retired retired = {};
+		retired.m_handles.m_image = image.m_image;
+		retired.m_handles.m_memory = image.m_memory;
+		retired.m_handles.m_view = image.m_view;
+		retired.m_handles.m_sampler = image.m_sampler;
+		retired.m_handles.m_baseMip = image.m_baseMip;
+		retired.m_frame = Graphics::Get()->GetFrameCount();
+		m_retired.emplace_back(retired);
+	}
+
+	image.m_image = handles.m_image;
+	image.m_memory = handles.m_memory;
+	image.m_view = handles.m_view;
+	image.m_sampler = handles.m_sampler;
+	image.m_baseMip = handles.m_baseMip;
+	image.m_descriptorVersion++;
+	handles = {};
+}
+
+void ImageStreamer::Destroy(Handles &handles)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	vkDestroyImageView(*logicalDevice, handles.m_view, nullptr);
+	Graphics::Get()->GetMemoryAllocator()->Free(handles.m_memory);
+	vkDestroyImage(*logicalDevice, handles.m_image, nullptr);
+	handles = {};
+}
+}
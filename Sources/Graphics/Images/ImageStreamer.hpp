@@ -0,0 +1,214 @@
+#pragma once
+
+#include <deque>
+#include "Helpers/NonCopyable.hpp"
+#include "Files/AsyncReader.hpp"
+#include "Helpers/ThreadPool.hpp"
+#include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Commands/CommandBuffer.hpp"
+#include "Image2d.hpp"
+#include "ImageKtx.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that streams 2D images in the background, files are read through acid::AsyncReader, decoded on the engines job system and uploaded on the transfer queue.
+ * Until an upload has finished the image is not resident and a placeholder is bound in its place.
+ * Streamed images are kept within a memory budget, each keeps the mip levels needed for the size it was last drawn at ({@link Image2d#RequestResidency}),
+ * higher levels are streamed in again from the file when they are needed and the highest levels of the least recently drawn images are dropped when memory is short.
+ */
+class ACID_EXPORT ImageStreamer :
+	public NonCopyable
+{
+public:
+	ImageStreamer();
+
+	~ImageStreamer();
+
+	/**
+	 * Starts streaming a image from its file, the image is kept alive until it is resident.
+	 * @param image The image to stream, its filename and sampler values must already be set.
+	 */
+	void Load(const std::shared_ptr<Image2d> &image);
+
+	/**
+	 * Records uploads for decoded images and makes finished uploads resident, this must be called from the thread that submits rendering.
+	 */
+	void Update();
+
+	/**
+	 * Gets the image bound in place of images that are still streaming, a single white texel.
+	 * @return The placeholder image.
+	 */
+	const Image2d *GetPlaceholder();
+
+	/**
+	 * Gets the number of images that are decoding or uploading.
+	 * @return The number of images not yet resident.
+	 */
+	uint32_t GetStreamingCount() const;
+
+	/**
+	 * Gets the device memory streamed images are kept within, by default half of the largest device local heap.
+	 * @return The budget in bytes.
+	 */
+	VkDeviceSize GetBudget() const;
+
+	void SetBudget(const VkDeviceSize &budget) { m_budget = budget; }
+
+	/**
+	 * Gets the device memory held by resident streamed images.
+	 * @return The resident size in bytes.
+	 */
+	const VkDeviceSize &GetResidentSize() const { return m_residentSize; }
+
+	/**
+	 * Gets the number of levels added to the mip level chosen from the drawn size of a image, a positive bias keeps less of every image resident.
+	 * @return The mip bias.
+	 */
+	const float &GetMipBias() const { return m_mipBias; }
+
+	void SetMipBias(const float &mipBias) { m_mipBias = mipBias; }
+
+private:
+	/**
+	 * @brief The Vulkan objects of one version of a image, a image swaps to a new version when it gains or drops mip levels.
+	 */
+	class Handles
+	{
+	public:
+		VkImage m_image = VK_NULL_HANDLE;
+		MemoryAllocation m_memory;
+		VkImageView m_view = VK_NULL_HANDLE;
+		VkSampler m_sampler = VK_NULL_HANDLE;
+		uint32_t m_baseMip = 0;
+	};
+
+	class Retired
+	{
+	public:
+		Handles m_handles;
+		uint64_t m_frame;
+	};
+
+	class Decoded
+	{
+	public:
+		std::shared_ptr<Image2d> m_image;
+		std::unique_ptr<uint8_t[]> m_pixels;
+		/// Set in place of pixels when a block compressed variant of the file was found.
+		std::optional<ImageKtx> m_texture;
+		Vector2ui m_extent;
+		uint32_t m_components = 0;
+		VkFormat m_format = VK_FORMAT_UNDEFINED;
+		uint32_t m_mipLevels = 1;
+		/// The first level uploaded, pixels decoded from a image are already downsampled to it.
+		uint32_t m_baseMip = 0;
+	};
+
+	/**
+	 * @brief The files that may be read for a image and the one being read, its KTX2 variants are read first and the image itself last.
+	 */
+	class Reading
+	{
+	public:
+		std::shared_ptr<Image2d> m_image;
+		uint32_t m_baseMip = 0;
+		VkDeviceSize m_headroom = 0;
+		AsyncReader::Priority m_priority = AsyncReader::Priority::Normal;
+		std::vector<std::string> m_files;
+		std::size_t m_file = 0;
+	};
+
+	class Upload
+	{
+	public:
+		std::shared_ptr<Image2d> m_image;
+		Handles m_handles;
+		std::unique_ptr<Buffer> m_bufferStaging;
+		std::unique_ptr<CommandBuffer> m_transferCommandBuffer;
+		std::unique_ptr<CommandBuffer> m_graphicsCommandBuffer;
+		VkSemaphore m_semaphore = VK_NULL_HANDLE;
+		VkFence m_fence = VK_NULL_HANDLE;
+	};
+
+	/**
+	 * Reads a image without blocking and decodes it on the job system, the decoded levels are queued for upload.
+	 * @param image The image.
+	 * @param baseMip The first level to upload.
+	 * @param headroom The memory the upload may use, higher levels are skipped until the image fits.
+	 * @param priority The priority of the read.
+	 */
+	void Decode(const std::shared_ptr<Image2d> &image, const uint32_t &baseMip, const VkDeviceSize &headroom, const AsyncReader::Priority &priority);
+
+	void Read(const std::shared_ptr<Reading> &reading);
+
+	/**
+	 * Decodes the file read for a image, the next file is read when a variant can not be sampled by the device.
+	 * @param reading The image being read.
+	 * @param file The contents of the file, nullopt if it could not be read.
+	 */
+	void DecodeFile(const std::shared_ptr<Reading> &reading, const std::optional<FileView> &file);
+
+	void Submit(Decoded &decoded);
+
+	void Release(Upload &upload) const;
+
+	/**
+	 * Streams in higher mip levels and drops the highest levels of images that are drawn small or not at all, within the budget.
+	 */
+	void UpdateResidency();
+
+	/**
+	 * Gets the first mip level a image should keep from the size it was last drawn at.
+	 * @param image The image.
+	 * @return The wanted base mip.
+	 */
+	uint32_t GetWantedMip(const Image2d &image) const;
+
+	/**
+	 * Moves a image to a smaller version without its highest levels, the kept levels are copied on the device.
+	 * @param image The image.
+	 * @param baseMip The new first level.
+	 * @return The memory freed in bytes.
+	 */
+	VkDeviceSize Evict(Image2d &image, const uint32_t &baseMip);
+
+	static Handles CreateHandles(const Image2d &image, const uint32_t &baseMip);
+
+	/**
+	 * Gets the size of the decoded levels from a level to the smallest.
+	 * @param decoded The decoded image.
+	 * @param baseMip The first level.
+	 * @return The size in bytes.
+	 */
+	static VkDeviceSize GetLevelsSize(const Decoded &decoded, const uint32_t &baseMip);
+
+	/**
+	 * Swaps the handles of a image, its previous handles are destroyed once no frame in flight can use them.
+	 * @param image The image.
+	 * @param handles The new handles.
+	 */
+	void Swap(Image2d &image, Handles &handles);
+
+	static void Destroy(Handles &handles);
+
+	std::unique_ptr<Image2d> m_placeholder;
+
+	ThreadPool::Counter m_decoding;
+	std::atomic<uint32_t> m_streaming;
+	std::mutex m_mutex;
+	/// The ids of reads that have not finished, by the ticket their callback forgets them with.
+	std::map<uint64_t, uint64_t> m_reads;
+	uint64_t m_nextRead;
+	bool m_closing;
+	std::vector<Decoded> m_decoded;
+	std::vector<Upload> m_uploads;
+
+	VkDeviceSize m_budget;
+	VkDeviceSize m_residentSize;
+	float m_mipBias;
+	std::vector<std::weak_ptr<Image2d>> m_managed;
+	std::deque<Retired> m_retired;
+};
+}
@@ -0,0 +1,167 @@
+#include "MipmapGenerator.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Descriptors/DescriptorAllocator.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
+#include "Image.hpp"
+
+namespace acid
+{
+// The bindings of Shaders/Mipmaps.comp, the base level is read from the first and each level below is written through its own binding.
+static const uint32_t BINDING_COUNTER = MipmapGenerator::MaxMipLevels;
+// Every workgroup reduces a tile this wide of the base level.
+static const uint32_t TILE_SIZE = 64;
+
+class PushMipmaps
+{
+public:
+	int32_t m_size[2];
+	int32_t m_mipLevels;
+};
+
+MipmapGenerator::~MipmapGenerator()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto &dispatch : m_dispatches)
+	{
+		Destroy(dispatch);
+	}
+
+	m_dispatches.clear();
+	m_pipeline = nullptr;
+}
+
+bool MipmapGenerator::IsSupported(const VkFormat &format)
+{
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+
+	// The shader declares its images as rgba8.
+	if (format != VK_FORMAT_R8G8B8A8_UNORM)
+	{
+		return false;
+	}
+
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(*physicalDevice, format, &formatProperties);
+	return formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+}
+
+bool MipmapGenerator::CmdGenerate(const CommandBuffer &commandBuffer, const VkImage &image, const VkExtent3D &extent, const VkFormat &format,
+	const VkImageUsageFlags &usage, const VkImageLayout &dstImageLayout, const uint32_t &mipLevels, const uint32_t &layerCount)
+{
+	auto graphics = Graphics::Get();
+	auto logicalDevice = graphics->GetLogicalDevice();
+
+	if (mipLevels < 2 || mipLevels > MaxMipLevels || layerCount != 1 || !(usage & VK_IMAGE_USAGE_STORAGE_BIT) || !IsSupported(format))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_pipeline == nullptr)
+	{
+		m_pipeline = std::make_unique<PipelineCompute>("Shaders/Mipmaps.comp");
+	}
+
+	Dispatch dispatch;
+	dispatch.m_frame = graphics->GetFrameCount();
+
+	for (uint32_t i = 0; i < mipLevels; i++)
+	{
+		VkImageView view;
+		Image::CreateImageView(image, view, VK_IMAGE_VIEW_TYPE_2D, format, VK_IMAGE_ASPECT_COLOR_BIT, 1, i, 1, 0);
+		dispatch.m_views.emplace_back(view);
+	}
+
+	// Counts the workgroups that have finished their tile, the last to finish continues the chain.
+	uint32_t counter = 0;
+	dispatch.m_bufferCounter = std::make_unique<Buffer>(sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &counter, MemoryAllocator::Lifetime::Transient);
+	dispatch.m_descriptorSet = graphics->GetDescriptorAllocator()->Allocate(m_pipeline->GetDescriptorSetLayout(), dispatch.m_descriptorPool);
+
+	// Levels past the last are never stored to, their bindings repeat the last level so every binding is valid.
+	std::array<VkDescriptorImageInfo, MaxMipLevels> imageInfos = {};
+
+	for (uint32_t i = 0; i < MaxMipLevels; i++)
+	{
+		imageInfos[i].imageView = dispatch.m_views[std::min(i, mipLevels - 1)];
+		imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+	}
+
+	VkDescriptorBufferInfo bufferInfo = {};
+	bufferInfo.buffer = dispatch.m_bufferCounter->GetBuffer();
+	bufferInfo.offset = 0;
+	bufferInfo.range = sizeof(uint32_t);
+
+	std::array<VkWriteDescriptorSet, 2> descriptorWrites = {};
+	descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[0].dstSet = dispatch.m_descriptorSet;
+	descriptorWrites[0].dstBinding = 0;
+	descriptorWrites[0].descriptorCount = MaxMipLevels;
+	descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	descriptorWrites[0].pImageInfo = imageInfos.data();
+	descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[1].dstSet = dispatch.m_descriptorSet;
+	descriptorWrites[1].dstBinding = BINDING_COUNTER;
+	descriptorWrites[1].descriptorCount = 1;
+	descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	descriptorWrites[1].pBufferInfo = &bufferInfo;
+	// The image bindings are consecutive and of one type, so a single write updates all of them.
+	vkUpdateDescriptorSets(*logicalDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+	Image::InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1, 0);
+
+	PushMipmaps push = {};
+	push.m_size[0] = static_cast<int32_t>(extent.width);
+	push.m_size[1] = static_cast<int32_t>(extent.height);
+	push.m_mipLevels = static_cast<int32_t>(mipLevels);
+
+	m_pipeline->BindPipeline(commandBuffer);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline->GetPipelineLayout(), 0, 1, &dispatch.m_descriptorSet, 0, nullptr);
+	vkCmdPushConstants(commandBuffer, m_pipeline->GetPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushMipmaps), &push);
+	vkCmdDispatch(commandBuffer, (extent.width + TILE_SIZE - 1) / TILE_SIZE, (extent.height + TILE_SIZE - 1) / TILE_SIZE, 1);
+
+	Image::InsertImageMemoryBarrier(commandBuffer, image, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, dstImageLayout,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1, 0);
+
+	m_dispatches.emplace_back(std::move(dispatch));
+	return true;
+}
+
+void MipmapGenerator::Update()
+{
+	auto graphics = Graphics::Get();
+	auto frameCount = graphics->GetFrameCount();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Uploads may be submitted with the frame after the one they were recorded in, so one more frame is waited on.
+	while (!m_dispatches.empty() && m_dispatches.front().m_frame + graphics->GetFramesInFlight() + 1 < frameCount)
+	{
+		Destroy(m_dispatches.front());
+		m_dispatches.pop_front();
+	}
+}
+
+void MipmapGenerator::Destroy(Dispatch &dispatch)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	for (const auto &view : dispatch.m_views)
+	{
+		vkDestroyImageView(*logicalDevice, view, nullptr);
+	}
+
+	if (auto descriptorAllocator = Graphics::Get()->GetDescriptorAllocator())
+	{
+		descriptorAllocator->Free(dispatch.m_descriptorPool, dispatch.m_descriptorSet);
+	}
+
+	dispatch.m_views.clear();
+	dispatch.m_bufferCounter = nullptr;
+}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+#include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Commands/CommandBuffer.hpp"
+
+namespace acid
+{
+class PipelineCompute;
+
+/**
+ * @brief Class that generates the mip chain of a image in a single compute dispatch, instead of a blit and a barrier for every level.
+ * Each workgroup reduces a 64x64 tile of the base level through six levels in shared memory, the last workgroup to finish then reduces the level every tile wrote into through the remaining levels.
+ * Images the shader can not store into, with several layers, or with more than 13 levels are left to the blit chain in {@link Image#CmdCreateMipmaps}.
+ */
+class ACID_EXPORT MipmapGenerator :
+	public NonCopyable
+{
+public:
+	/// The number of levels one dispatch can generate, enough for a 4096x4096 base level.
+	static constexpr uint32_t MaxMipLevels = 13;
+
+	MipmapGenerator() = default;
+
+	~MipmapGenerator();
+
+	/**
+	 * Gets if images of a format can have their mipmaps generated by the dispatch, those images should be created with storage usage.
+	 * @param format The images format.
+	 * @return If the format can be generated.
+	 */
+	static bool IsSupported(const VkFormat &format);
+
+	/**
+	 * Records the dispatch that generates every level below the base level, this is safe to call from multiple threads.
+	 * @param commandBuffer The command buffer to record into, its queue must support compute.
+	 * @param image The image, every level must be in the transfer destination layout.
+	 * @param extent The extent of the base level.
+	 * @param format The images format.
+	 * @param usage The usage the image was created with.
+	 * @param dstImageLayout The layout every level is left in.
+	 * @param mipLevels The number of levels.
+	 * @param layerCount The number of layers.
+	 * @return If the dispatch was recorded, otherwise nothing was recorded and the levels should be blitted.
+	 */
+	bool CmdGenerate(const CommandBuffer &commandBuffer, const VkImage &image, const VkExtent3D &extent, const VkFormat &format, const VkImageUsageFlags &usage,
+		const VkImageLayout &dstImageLayout, const uint32_t &mipLevels, const uint32_t &layerCount);
+
+	/**
+	 * Destroys the level views and descriptor sets of dispatches that no frame in flight can still be executing.
+	 */
+	void Update();
+
+private:
+	class Dispatch
+	{
+	public:
+		std::vector<VkImageView> m_views;
+		VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+		VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+		std::unique_ptr<Buffer> m_bufferCounter;
+		uint64_t m_frame = 0;
+	};
+
+	static void Destroy(Dispatch &dispatch);
+
+	std::unique_ptr<PipelineCompute> m_pipeline;
+	std::mutex m_mutex;
+	std::deque<Dispatch> m_dispatches;
+};
+}
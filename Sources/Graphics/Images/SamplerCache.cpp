@@ -0,0 +1,63 @@
+#include "SamplerCache.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+static const float ANISOTROPY = 16.0f;
+
+SamplerCache::~SamplerCache()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	for (const auto &[key, sampler] : m_samplers)
+	{
+		vkDestroySampler(*logicalDevice, sampler, nullptr);
+	}
+}
+
+VkSampler SamplerCache::Get(const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic)
+{
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	// Without the feature anisotropic samplers are the same as the others.
+	auto key = std::make_tuple(filter, addressMode, anisotropic && logicalDevice->GetEnabledFeatures().samplerAnisotropy);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (auto it = m_samplers.find(key); it != m_samplers.end())
+	{
+		return it->second;
+	}
+
+	VkSamplerCreateInfo samplerCreateInfo = {};
+	samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerCreateInfo.magFilter = filter;
+	samplerCreateInfo.minFilter = filter;
+	samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	samplerCreateInfo.addressModeU = addressMode;
+	samplerCreateInfo.addressModeV = addressMode;
+	samplerCreateInfo.addressModeW = addressMode;
+	samplerCreateInfo.mipLodBias = 0.0f;
+	samplerCreateInfo.anisotropyEnable = static_cast<VkBool32>(std::get<2>(key));
+	samplerCreateInfo.maxAnisotropy = std::get<2>(key) ? std::min(ANISOTROPY, physicalDevice->GetProperties().limits.maxSamplerAnisotropy) : 1.0f;
+	//samplerCreateInfo.compareEnable = VK_FALSE;
+	//samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+	samplerCreateInfo.minLod = 0.0f;
+	samplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;
+	samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+	samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+
+	VkSampler sampler;
+	Graphics::CheckVk(vkCreateSampler(*logicalDevice, &samplerCreateInfo, nullptr, &sampler));
+	m_samplers.emplace(key, sampler);
+	return sampler;
+}
+
+uint32_t SamplerCache::GetSamplerCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return static_cast<uint32_t>(m_samplers.size());
+}
+}
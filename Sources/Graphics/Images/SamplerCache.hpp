@@ -0,0 +1,42 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that creates a sampler once for each set of sampling parameters, every image sampled the same way shares it.
+ * Samplers are not clamped to a images mip levels, the image view limits the levels that are read, so images with different mip counts share a sampler too.
+ * Samplers live until the cache is destroyed, there are only as many as there are distinct parameters.
+ */
+class ACID_EXPORT SamplerCache :
+	public NonCopyable
+{
+public:
+	SamplerCache() = default;
+
+	~SamplerCache();
+
+	/**
+	 * Gets the sampler for a set of parameters, creating it the first time they are asked for. This is safe to call from multiple threads.
+	 * @param filter The magnification and minification filter.
+	 * @param addressMode The addressing mode on every axis.
+	 * @param anisotropic If anisotropic filtering is used when the device supports it.
+	 * @return The shared sampler, it must not be destroyed.
+	 */
+	VkSampler Get(const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic);
+
+	/**
+	 * Gets the number of distinct samplers created.
+	 * @return The sampler count.
+	 */
+	uint32_t GetSamplerCount() const;
+
+private:
+	std::map<std::tuple<VkFilter, VkSamplerAddressMode, bool>, VkSampler> m_samplers;
+	mutable std::mutex m_mutex;
+};
+}
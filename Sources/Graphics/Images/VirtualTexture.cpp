@@ -0,0 +1,567 @@
+#include "VirtualTexture.hpp"
+
+#include "Files/Files.hpp"
+#include "Files/Pack.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Maths/Maths.hpp"
+
+namespace acid
+{
+static const char HEADER_MAGIC[4] = { 'A', 'V', 'T', 'X' };
+// Resident page table entries hold the cache slot of the page, zero is a page that is not resident.
+static const uint32_t ENTRY_RESIDENT = 0x80000000;
+static const uint32_t EMPTY_SLOT = std::numeric_limits<uint32_t>::max();
+// The texels along each side of a page in its file and in the cache.
+static const uint32_t PAGE_TEXELS = VirtualTexture::PageSize + 2 * VirtualTexture::PageBorder;
+static const VkDeviceSize PAGE_BYTES = 4 * PAGE_TEXELS * PAGE_TEXELS;
+
+std::shared_ptr<VirtualTexture> VirtualTexture::Create(const std::string &name, const uint32_t &cacheSize)
+{
+	auto file = Files::ReadView(name + "/Header");
+
+	if (!file)
+	{
+		Log::Error("Virtual texture could not be found: '%s'\n", name.c_str());
+		return nullptr;
+	}
+
+	Header header;
+
+	if (file->GetSize() < sizeof(Header) || std::memcmp(file->GetData(), HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0)
+	{
+		Log::Error("Virtual texture header is not valid: '%s'\n", name.c_str());
+		return nullptr;
+	}
+
+	std::memcpy(&header, file->GetData(), sizeof(Header));
+
+	// Pages are cooked with the page size and border they are cached with.
+	if (header.m_pageSize != PageSize || header.m_pageBorder != PageBorder || header.m_size < PageSize || (header.m_size & (header.m_size - 1)) != 0)
+	{
+		Log::Error("Virtual texture was cooked with different pages: '%s'\n", name.c_str());
+		return nullptr;
+	}
+
+	return std::make_shared<VirtualTexture>(name, header.m_size, cacheSize);
+}
+
+VirtualTexture::VirtualTexture(std::string name, const uint32_t &size, const uint32_t &cacheSize) :
+	m_name(std::move(name)),
+	m_size(size),
+	m_levelCount(0),
+	m_pageCount(0),
+	m_cacheSize(std::max(cacheSize, 2u)),
+	m_closing(false),
+	m_cleared(false)
+{
+	for (auto pages = m_size / PageSize; pages > 0; pages >>= 1)
+	{
+		m_levelCount++;
+	}
+
+	m_pageCount = GetLevelOffset(m_levelCount);
+	m_pages.resize(m_pageCount);
+	m_entries.resize(m_pageCount, 0);
+
+	for (uint32_t level = 0; level < m_levelCount; level++)
+	{
+		auto pages = GetPagesPerSide(level);
+
+		for (uint32_t y = 0; y < pages; y++)
+		{
+			for (uint32_t x = 0; x < pages; x++)
+			{
+				auto &page = m_pages[GetLevelOffset(level) + y * pages + x];
+				page.m_level = level;
+				page.m_x = x;
+				page.m_y = y;
+			}
+		}
+	}
+
+	auto slotCount = m_cacheSize * m_cacheSize;
+	m_slotPages.resize(slotCount, EMPTY_SLOT);
+	m_freeSlots.reserve(slotCount);
+
+	for (auto slot = slotCount; slot > 0; slot--)
+	{
+		m_freeSlots.emplace_back(slot - 1);
+	}
+
+	m_cache = std::make_unique<Image2d>(Vector2ui(m_cacheSize * PAGE_TEXELS), nullptr, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+	m_pageTable = std::make_unique<StorageBuffer>(sizeof(uint32_t) * m_pageCount, nullptr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+	// The coarsest page is what every lookup falls back to, it is read straight away and never leaves the cache.
+	Read(m_pageCount - 1);
+}
+
+VirtualTexture::~VirtualTexture()
+{
+	std::vector<uint64_t> reads;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closing = true;
+
+		for (const auto &[page, id] : m_reads)
+		{
+			reads.emplace_back(id);
+		}
+	}
+
+	// Cancelling waits for callbacks that are running, so none run once the texture is gone.
+	for (const auto &id : reads)
+	{
+		AsyncReader::Get()->Cancel(id);
+	}
+}
+
+bool VirtualTexture::Cook(const FileView &file, const std::string &name, PackWriter &writer)
+{
+	Vector2ui extent;
+	uint32_t components;
+	VkFormat format;
+	auto pixels = Image::LoadPixels(file, name, extent, components, format);
+
+	if (pixels == nullptr)
+	{
+		return false;
+	}
+
+	if (components != 4 || format != VK_FORMAT_R8G8B8A8_UNORM)
+	{
+		Log::Error("Virtual textures can only be cooked from 8 bit RGBA images: '%s'\n", name.c_str());
+		return false;
+	}
+
+	// The finest level is a square power of two, so every level halves into whole pages.
+	auto size = PageSize;
+
+	while (size < std::max(extent.m_x, extent.m_y))
+	{
+		size *= 2;
+	}
+
+	std::vector<uint8_t> level(4 * static_cast<std::size_t>(size) * size);
+
+	for (uint32_t y = 0; y < size; y++)
+	{
+		auto sourceY = std::clamp((static_cast<float>(y) + 0.5f) * static_cast<float>(extent.m_y) / static_cast<float>(size) - 0.5f, 0.0f,
+			static_cast<float>(extent.m_y - 1));
+		auto y0 = static_cast<uint32_t>(sourceY);
+		auto y1 = std::min(y0 + 1, extent.m_y - 1);
+		auto factorY = sourceY - static_cast<float>(y0);
+
+		for (uint32_t x = 0; x < size; x++)
+		{
+			auto sourceX = std::clamp((static_cast<float>(x) + 0.5f) * static_cast<float>(extent.m_x) / static_cast<float>(size) - 0.5f, 0.0f,
+				static_cast<float>(extent.m_x - 1));
+			auto x0 = static_cast<uint32_t>(sourceX);
+			auto x1 = std::min(x0 + 1, extent.m_x - 1);
+			auto factorX = sourceX - static_cast<float>(x0);
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				auto texel = [&](const uint32_t &tx, const uint32_t &ty)
+				{
+					return static_cast<float>(pixels[4 * (static_cast<std::size_t>(ty) * extent.m_x + tx) + c]);
+				};
+
+				auto top = Maths::Lerp(texel(x0, y0), texel(x1, y0), factorX);
+				auto bottom = Maths::Lerp(texel(x0, y1), texel(x1, y1), factorX);
+				level[4 * (static_cast<std::size_t>(y) * size + x) + c] = static_cast<uint8_t>(std::lround(Maths::Lerp(top, bottom, factorY)));
+			}
+		}
+	}
+
+	pixels = nullptr;
+
+	// Each level is split into pages with a border clamped to the edge of the level, then halved into the next level.
+	for (uint32_t levelIndex = 0, levelSize = size; levelSize >= PageSize; levelIndex++, levelSize /= 2)
+	{
+		auto pages = levelSize / PageSize;
+
+		for (uint32_t pageY = 0; pageY < pages; pageY++)
+		{
+			for (uint32_t pageX = 0; pageX < pages; pageX++)
+			{
+				std::vector<uint8_t> texels(PAGE_BYTES);
+
+				for (uint32_t y = 0; y < PAGE_TEXELS; y++)
+				{
+					auto sourceY = std::clamp(static_cast<int32_t>(pageY * PageSize + y) - static_cast<int32_t>(PageBorder), 0, static_cast<int32_t>(levelSize - 1));
+
+					for (uint32_t x = 0; x < PAGE_TEXELS; x++)
+					{
+						auto sourceX = std::clamp(static_cast<int32_t>(pageX * PageSize + x) - static_cast<int32_t>(PageBorder), 0, static_cast<int32_t>(levelSize - 1));
+						std::memcpy(&texels[4 * (y * PAGE_TEXELS + x)], &level[4 * (static_cast<std::size_t>(sourceY) * levelSize + sourceX)], 4);
+					}
+				}
+
+				writer.Add(GetPagePath(name, levelIndex, pageX, pageY), std::move(texels), true);
+			}
+		}
+
+		auto halfSize = levelSize / 2;
+
+		if (halfSize < PageSize)
+		{
+			break;
+		}
+
+		std::vector<uint8_t> half(4 * static_cast<std::size_t>(halfSize) * halfSize);
+
+		for (uint32_t y = 0; y < halfSize; y++)
+		{
+			for (uint32_t x = 0; x < halfSize; x++)
+			{
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					auto texel = [&](const uint32_t &tx, const uint32_t &ty)
+					{
+						return static_cast<uint32_t>(level[4 * (static_cast<std::size_t>(ty) * levelSize + tx) + c]);
+					};
+
+					auto sum = texel(2 * x, 2 * y) + texel(2 * x + 1, 2 * y) + texel(2 * x, 2 * y + 1) + texel(2 * x + 1, 2 * y + 1);
+					half[4 * (static_cast<std::size_t>(y) * halfSize + x) + c] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+
+		level = std::move(half);
+	}
+
+	Header header = {};
+	std::memcpy(header.m_magic, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+	header.m_size = size;
+	header.m_pageSize = PageSize;
+	header.m_pageBorder = PageBorder;
+
+	std::vector<uint8_t> headerData(sizeof(Header));
+	std::memcpy(headerData.data(), &header, sizeof(Header));
+	writer.Add(name + "/Header", std::move(headerData));
+	return true;
+}
+
+void VirtualTexture::CmdUpdate(const CommandBuffer &commandBuffer)
+{
+	auto graphics = Graphics::Get();
+
+	if (m_frames.size() != graphics->GetFramesInFlight())
+	{
+		m_frames.clear();
+		m_frames.resize(graphics->GetFramesInFlight());
+	}
+
+	auto &frame = m_frames[graphics->GetCurrentFrame()];
+
+	// This frames feedback was last written by a frame that has finished, so the pages it drew are read and it is cleared for this frame.
+	if (frame.m_feedback == nullptr)
+	{
+		std::vector<uint32_t> zeros(m_pageCount, 0);
+		frame.m_feedback = std::make_unique<StorageBuffer>(sizeof(uint32_t) * m_pageCount, zeros.data());
+		frame.m_staging = std::make_unique<Buffer>(MaxUploads * PAGE_BYTES + 2 * MaxUploads * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	}
+	else
+	{
+		uint32_t *feedback;
+		frame.m_feedback->MapMemory(reinterpret_cast<void **>(&feedback));
+		ReadFeedback(feedback);
+		std::memset(feedback, 0, sizeof(uint32_t) * m_pageCount);
+		frame.m_feedback->UnmapMemory();
+	}
+
+	std::vector<Loaded> loaded;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		loaded = std::move(m_loaded);
+		m_loaded.clear();
+	}
+
+	// Loaded pages are copied into the staging buffer of this frame, pages that do not fit wait for a later frame.
+	uint8_t *staging;
+	frame.m_staging->MapMemory(reinterpret_cast<void **>(&staging));
+	std::vector<VkBufferImageCopy> imageCopies;
+	std::vector<Loaded> waiting;
+
+	for (auto &page : loaded)
+	{
+		auto &info = m_pages[page.m_page];
+
+		// Pages that could not be read are not read again, lookups fall back to coarser levels.
+		if (!page.m_texels || page.m_texels->GetSize() != PAGE_BYTES)
+		{
+			Log::Error("Virtual texture page could not be read: '%s'\n", GetPagePath(m_name, info.m_level, info.m_x, info.m_y).c_str());
+			info.m_state = State::Failed;
+			continue;
+		}
+
+		std::optional<uint32_t> slot;
+
+		if (imageCopies.size() < MaxUploads)
+		{
+			slot = FindSlot();
+		}
+
+		if (!slot)
+		{
+			waiting.emplace_back(std::move(page));
+			continue;
+		}
+
+		auto offset = imageCopies.size() * PAGE_BYTES;
+		std::memcpy(staging + offset, page.m_texels->GetData(), PAGE_BYTES);
+
+		auto slotX = *slot % m_cacheSize;
+		auto slotY = *slot / m_cacheSize;
+
+		VkBufferImageCopy region = {};
+		region.bufferOffset = offset;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { static_cast<int32_t>(slotX * PAGE_TEXELS), static_cast<int32_t>(slotY * PAGE_TEXELS), 0 };
+		region.imageExtent = { PAGE_TEXELS, PAGE_TEXELS, 1 };
+		imageCopies.emplace_back(region);
+
+		info.m_state = State::Resident;
+		info.m_slot = *slot;
+		m_slotPages[*slot] = page.m_page;
+		SetEntry(page.m_page, ENTRY_RESIDENT | (slotY << 16) | slotX);
+	}
+
+	if (!waiting.empty())
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::move(waiting.begin(), waiting.end(), std::back_inserter(m_loaded));
+	}
+
+	// Only the entries that changed are copied into the page table, from after the pages in the staging buffer.
+	std::sort(m_dirtyEntries.begin(), m_dirtyEntries.end());
+	m_dirtyEntries.erase(std::unique(m_dirtyEntries.begin(), m_dirtyEntries.end()), m_dirtyEntries.end());
+	std::vector<VkBufferCopy> entryCopies;
+	auto entriesOffset = MaxUploads * PAGE_BYTES;
+
+	for (const auto &entry : m_dirtyEntries)
+	{
+		auto offset = entriesOffset + entryCopies.size() * sizeof(uint32_t);
+		std::memcpy(staging + offset, &m_entries[entry], sizeof(uint32_t));
+		entryCopies.emplace_back(VkBufferCopy{ offset, entry * sizeof(uint32_t), sizeof(uint32_t) });
+	}
+
+	m_dirtyEntries.clear();
+	frame.m_staging->UnmapMemory();
+
+	if (m_cleared && imageCopies.empty() && entryCopies.empty())
+	{
+		return;
+	}
+
+	// Earlier frames sampling the cache and reading the page table are finished with them before they are written.
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+	if (!m_cleared)
+	{
+		vkCmdFillBuffer(commandBuffer, m_pageTable->GetBuffer(), 0, VK_WHOLE_SIZE, 0);
+		m_cleared = true;
+
+		memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	if (!imageCopies.empty())
+	{
+		Image::InsertImageMemoryBarrier(commandBuffer, m_cache->GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+		vkCmdCopyBufferToImage(commandBuffer, frame.m_staging->GetBuffer(), m_cache->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(imageCopies.size()), imageCopies.data());
+		Image::InsertImageMemoryBarrier(commandBuffer, m_cache->GetImage(), VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+	}
+
+	if (!entryCopies.empty())
+	{
+		vkCmdCopyBuffer(commandBuffer, frame.m_staging->GetBuffer(), m_pageTable->GetBuffer(), static_cast<uint32_t>(entryCopies.size()), entryCopies.data());
+	}
+
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void VirtualTexture::PushDescriptors(DescriptorsHandler &descriptorSet)
+{
+	auto &frame = m_frames[Graphics::Get()->GetCurrentFrame()];
+
+	m_uniformVirtual.Push("pagesPerSide", GetPagesPerSide(0));
+	m_uniformVirtual.Push("levelCount", m_levelCount);
+	m_uniformVirtual.Push("pageSize", static_cast<float>(PageSize));
+	m_uniformVirtual.Push("pageBorder", static_cast<float>(PageBorder));
+	m_uniformVirtual.Push("cacheTexels", static_cast<float>(m_cacheSize * PAGE_TEXELS));
+
+	descriptorSet.Push("UniformVirtual", m_uniformVirtual);
+	descriptorSet.Push("BufferPageTable", m_pageTable);
+	descriptorSet.Push("BufferFeedback", frame.m_feedback);
+	descriptorSet.Push("samplerPages", m_cache);
+}
+
+bool VirtualTexture::IsSupported()
+{
+	return Graphics::Get()->GetLogicalDevice()->GetEnabledFeatures().fragmentStoresAndAtomics;
+}
+
+uint32_t VirtualTexture::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return static_cast<uint32_t>(m_reads.size() + m_loaded.size());
+}
+
+std::string VirtualTexture::GetPagePath(const std::string &name, const uint32_t &level, const uint32_t &x, const uint32_t &y)
+{
+	return name + "/" + String::To(level) + "/" + String::To(x) + "_" + String::To(y) + ".page";
+}
+
+uint32_t VirtualTexture::GetLevelOffset(const uint32_t &level) const
+{
+	// Each level has a quarter of the pages of the level before it.
+	auto pages = GetPagesPerSide(0);
+	auto levelPages = level < m_levelCount ? GetPagesPerSide(level) : 0;
+	return 4 * (pages * pages - levelPages * levelPages) / 3;
+}
+
+void VirtualTexture::ReadFeedback(const uint32_t *feedback)
+{
+	auto frame = Graphics::Get()->GetFrameCount();
+	m_wanted.clear();
+
+	for (uint32_t i = 0; i < m_pageCount; i++)
+	{
+		if (feedback[i] == 0)
+		{
+			continue;
+		}
+
+		// The coarser pages a drawn page falls back to are wanted too, so a page that is streaming is drawn with the closest level.
+		for (auto index = i;;)
+		{
+			auto &page = m_pages[index];
+
+			if (page.m_used == frame)
+			{
+				break;
+			}
+
+			page.m_used = frame;
+
+			if (page.m_state == State::Missing)
+			{
+				m_wanted.emplace_back(index);
+			}
+
+			if (page.m_level + 1 >= m_levelCount)
+			{
+				break;
+			}
+
+			auto parentPages = GetPagesPerSide(page.m_level + 1);
+			index = GetLevelOffset(page.m_level + 1) + (page.m_y / 2) * parentPages + page.m_x / 2;
+		}
+	}
+
+	std::sort(m_wanted.begin(), m_wanted.end(), [this](const uint32_t &a, const uint32_t &b)
+	{
+		return m_pages[a].m_level > m_pages[b].m_level;
+	});
+
+	for (const auto &page : m_wanted)
+	{
+		if (GetPendingCount() >= MaxReads)
+		{
+			break;
+		}
+
+		Read(page);
+	}
+}
+
+void VirtualTexture::Read(const uint32_t &page)
+{
+	auto &info = m_pages[page];
+	info.m_state = State::Reading;
+
+	// Pages of the coarsest levels cover the most of the texture, they are read first.
+	auto priority = info.m_level + 2 >= m_levelCount ? AsyncReader::Priority::High : AsyncReader::Priority::Normal;
+	auto path = GetPagePath(m_name, info.m_level, info.m_x, info.m_y);
+
+	// The lock is held until the id is stored, so the callback can not forget the read before it is known.
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_closing)
+	{
+		return;
+	}
+
+	m_reads[page] = AsyncReader::Get()->Read(path, [this, page](std::optional<FileView> texels)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_reads.erase(page);
+		m_loaded.emplace_back(Loaded{ page, std::move(texels) });
+	}, priority);
+}
+
+std::optional<uint32_t> VirtualTexture::FindSlot()
+{
+	if (!m_freeSlots.empty())
+	{
+		auto slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		return slot;
+	}
+
+	// Pages drawn in the last feedback are kept, as is the coarsest page that every lookup falls back to.
+	auto frame = Graphics::Get()->GetFrameCount();
+	std::optional<uint32_t> oldest;
+
+	for (uint32_t slot = 0; slot < m_slotPages.size(); slot++)
+	{
+		auto &page = m_pages[m_slotPages[slot]];
+
+		if (page.m_used == frame || page.m_level + 1 == m_levelCount)
+		{
+			continue;
+		}
+
+		if (!oldest || page.m_used < m_pages[m_slotPages[*oldest]].m_used)
+		{
+			oldest = slot;
+		}
+	}
+
+	if (oldest)
+	{
+		auto evicted = m_slotPages[*oldest];
+		m_pages[evicted].m_state = State::Missing;
+		m_slotPages[*oldest] = EMPTY_SLOT;
+		SetEntry(evicted, 0);
+	}
+
+	return oldest;
+}
+
+void VirtualTexture::SetEntry(const uint32_t &page, const uint32_t &entry)
+{
+	m_entries[page] = entry;
+	m_dirtyEntries.emplace_back(page);
+}
+}
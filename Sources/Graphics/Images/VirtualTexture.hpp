@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+#include "Files/AsyncReader.hpp"
+#include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Buffers/StorageBuffer.hpp"
+#include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Commands/CommandBuffer.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Image2d.hpp"
+
+namespace acid
+{
+class PackWriter;
+
+/**
+ * @brief A texture too large to keep resident, split into square pages at every mip level that are streamed into a fixed size cache as they are drawn.
+ * Shaders look pages up in a page table, falling back to coarser levels until a resident page is found, the coarsest level is a single page that is always resident.
+ * While drawing shaders write the pages they wanted into a feedback buffer, which is read once the frame has finished and the missing pages are read through
+ * acid::AsyncReader from the cooked files written by {@link VirtualTexture#Cook}, usually from inside a {@link Pack}.
+ * Loaded pages replace the least recently drawn pages in the cache, only the page table entries that changed are copied to the device.
+ * The cache and page table do not grow with the size of the texture, only the feedback and page table entries do, four bytes for each page.
+ */
+class ACID_EXPORT VirtualTexture :
+	public NonCopyable
+{
+public:
+	/// The texels along each side of a page, not counting its border.
+	static constexpr uint32_t PageSize = 128;
+	/// The texels copied from neighbouring pages around each page, so filtering never reads from another page in the cache.
+	static constexpr uint32_t PageBorder = 4;
+	/// The most pages uploaded into the cache in a frame.
+	static constexpr uint32_t MaxUploads = 16;
+	/// The most page reads in flight.
+	static constexpr uint32_t MaxReads = 32;
+
+	/**
+	 * Opens a virtual texture cooked by {@link VirtualTexture#Cook}.
+	 * @param name The name the texture was cooked with, its files are found by real or partial path.
+	 * @param cacheSize The number of pages along each side of the cache.
+	 * @return The texture, or nullptr if its header could not be read.
+	 */
+	static std::shared_ptr<VirtualTexture> Create(const std::string &name, const uint32_t &cacheSize = 16);
+
+	/**
+	 * Creates a virtual texture.
+	 * @param name The name the texture was cooked with.
+	 * @param size The texels along each side of the finest level, a power of two that is at least the page size.
+	 * @param cacheSize The number of pages along each side of the cache.
+	 */
+	VirtualTexture(std::string name, const uint32_t &size, const uint32_t &cacheSize = 16);
+
+	~VirtualTexture();
+
+	/**
+	 * Cooks a image into the pages of a virtual texture, the image is resized to a square power of two and each page is compressed into the pack.
+	 * @param file The contents of the image.
+	 * @param name The name the pages are stored under, and the texture is opened with.
+	 * @param writer The pack the pages are added to.
+	 * @return If the image was cooked.
+	 */
+	static bool Cook(const FileView &file, const std::string &name, PackWriter &writer);
+
+	/**
+	 * Reads the pages drawn by the last use of this frames feedback, queues reads of those missing, and records the uploads of loaded pages.
+	 * This must be called outside of a renderpass once a frame, before anything samples the texture.
+	 * @param commandBuffer The command buffer to record the uploads into.
+	 */
+	void CmdUpdate(const CommandBuffer &commandBuffer);
+
+	/**
+	 * Pushes the page table, feedback, cache and uniforms read by VirtualTexture.glsl.
+	 * @param descriptorSet The descriptors to push into.
+	 */
+	void PushDescriptors(DescriptorsHandler &descriptorSet);
+
+	/**
+	 * Gets if shaders can write feedback, which needs stores from fragment shaders. Without it the texture can not learn which pages to stream.
+	 * @return If the device supports virtual textures.
+	 */
+	static bool IsSupported();
+
+	const std::string &GetName() const { return m_name; }
+
+	const uint32_t &GetSize() const { return m_size; }
+
+	const uint32_t &GetLevelCount() const { return m_levelCount; }
+
+	const uint32_t &GetCacheSize() const { return m_cacheSize; }
+
+	/**
+	 * Gets the number of pages resident in the cache.
+	 * @return The resident page count.
+	 */
+	uint32_t GetResidentCount() const { return m_cacheSize * m_cacheSize - static_cast<uint32_t>(m_freeSlots.size()); }
+
+	/**
+	 * Gets the number of pages that are being read or are waiting to be uploaded.
+	 * @return The pending page count.
+	 */
+	uint32_t GetPendingCount() const;
+
+	/**
+	 * Gets the path of the file a page is cooked into.
+	 * @param name The name of the texture.
+	 * @param level The mip level of the page.
+	 * @param x The column of the page.
+	 * @param y The row of the page.
+	 * @return The path.
+	 */
+	static std::string GetPagePath(const std::string &name, const uint32_t &level, const uint32_t &x, const uint32_t &y);
+
+private:
+	/**
+	 * @brief The header cooked with the pages, the layout matches the file.
+	 */
+	class Header
+	{
+	public:
+		char m_magic[4];
+		uint32_t m_size;
+		uint32_t m_pageSize;
+		uint32_t m_pageBorder;
+	};
+
+	enum class State : uint8_t
+	{
+		Missing, Reading, Resident, Failed
+	};
+
+	/**
+	 * @brief A page of the texture, pages are indexed level by level from the finest.
+	 */
+	class Page
+	{
+	public:
+		State m_state = State::Missing;
+		uint32_t m_level = 0;
+		uint32_t m_x = 0;
+		uint32_t m_y = 0;
+		/// The cache slot the page is resident in.
+		uint32_t m_slot = 0;
+		/// The frame the page was last drawn in.
+		uint64_t m_used = 0;
+	};
+
+	class Loaded
+	{
+	public:
+		uint32_t m_page;
+		/// Nullopt if the page could not be read.
+		std::optional<FileView> m_texels;
+	};
+
+	/**
+	 * @brief The buffers used by one frame in flight, reused once that frame has finished.
+	 */
+	class Frame
+	{
+	public:
+		std::unique_ptr<StorageBuffer> m_feedback;
+		std::unique_ptr<Buffer> m_staging;
+	};
+
+	/**
+	 * Gets the index of the first page of a level.
+	 * @param level The mip level.
+	 * @return The index.
+	 */
+	uint32_t GetLevelOffset(const uint32_t &level) const;
+
+	uint32_t GetPagesPerSide(const uint32_t &level) const { return (m_size / PageSize) >> level; }
+
+	/**
+	 * Marks the pages drawn in a finished frame as used, and queues reads of those that are missing, coarsest levels first.
+	 * @param feedback The feedback of the frame, one value for each page.
+	 */
+	void ReadFeedback(const uint32_t *feedback);
+
+	void Read(const uint32_t &page);
+
+	/**
+	 * Finds a cache slot for a page, taking the least recently drawn page out of the cache if every slot is used.
+	 * @return The slot, or nullopt if every resident page was drawn in the last frames.
+	 */
+	std::optional<uint32_t> FindSlot();
+
+	void SetEntry(const uint32_t &page, const uint32_t &entry);
+
+	std::string m_name;
+	uint32_t m_size;
+	uint32_t m_levelCount;
+	uint32_t m_pageCount;
+	uint32_t m_cacheSize;
+
+	std::vector<Page> m_pages;
+	// The page table as it is on the device, and the entries changed since it was last copied.
+	std::vector<uint32_t> m_entries;
+	std::vector<uint32_t> m_dirtyEntries;
+	std::vector<uint32_t> m_freeSlots;
+	// The pages resident in each slot.
+	std::vector<uint32_t> m_slotPages;
+	std::vector<uint32_t> m_wanted;
+
+	mutable std::mutex m_mutex;
+	/// The ids of reads that have not finished, by the page they read.
+	std::map<uint32_t, uint64_t> m_reads;
+	std::vector<Loaded> m_loaded;
+	bool m_closing;
+
+	std::unique_ptr<Image2d> m_cache;
+	std::unique_ptr<StorageBuffer> m_pageTable;
+	std::vector<Frame> m_frames;
+	UniformHandler m_uniformVirtual;
+	bool m_cleared;
+};
+}
@@ -0,0 +1,424 @@
+#include "MemoryAllocator.hpp"
+
+#include "Devices/LogicalDevice.hpp"
+#include "Devices/PhysicalDevice.hpp"
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+static const VkDeviceSize DEVICE_BLOCK_SIZE = 64 * 1024 * 1024;
+static const VkDeviceSize HOST_BLOCK_SIZE = 16 * 1024 * 1024;
+
+class MemoryBlock
+{
+public:
+	VkDeviceMemory m_memory = VK_NULL_HANDLE;
+	VkDeviceSize m_size = 0;
+	uint32_t m_memoryType = 0;
+	void *m_mapped = nullptr;
+	bool m_coherent = true;
+	bool m_linear = true;
+	MemoryAllocator::Lifetime m_lifetime = MemoryAllocator::Lifetime::Persistent;
+	bool m_dedicated = false;
+
+	/// Free ranges of a persistent block, offset to size.
+	std::map<VkDeviceSize, VkDeviceSize> m_freeRanges;
+	/// The first unused byte of a transient block, rewound once the block is empty.
+	VkDeviceSize m_head = 0;
+
+	VkDeviceSize m_usedBytes = 0;
+	uint32_t m_allocationCount = 0;
+};
+
+static VkDeviceSize AlignUp(const VkDeviceSize &value, const VkDeviceSize &alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static bool AllocateFromBlock(MemoryBlock &block, const VkDeviceSize &size, const VkDeviceSize &alignment, VkDeviceSize &offset)
+{
+	if (block.m_lifetime == MemoryAllocator::Lifetime::Transient)
+	{
+		auto aligned = AlignUp(block.m_head, alignment);
+
+		if (aligned + size > block.m_size)
+		{
+			return false;
+		}
+
+		block.m_head = aligned + size;
+		offset = aligned;
+		return true;
+	}
+
+	// First fit, any padding in front of the aligned offset stays in the free list.
+	for (auto it = block.m_freeRanges.begin(); it != block.m_freeRanges.end(); ++it)
+	{
+		auto rangeOffset = it->first;
+		auto rangeEnd = it->first + it->second;
+		auto aligned = AlignUp(rangeOffset, alignment);
+
+		if (aligned + size > rangeEnd)
+		{
+			continue;
+		}
+
+		block.m_freeRanges.erase(it);
+
+		if (aligned > rangeOffset)
+		{
+			block.m_freeRanges.emplace(rangeOffset, aligned - rangeOffset);
+		}
+
+		if (aligned + size < rangeEnd)
+		{
+			block.m_freeRanges.emplace(aligned + size, rangeEnd - aligned - size);
+		}
+
+		offset = aligned;
+		return true;
+	}
+
+	return false;
+}
+
+static void FreeFromBlock(MemoryBlock &block, const VkDeviceSize &offset, const VkDeviceSize &size)
+{
+	if (block.m_lifetime == MemoryAllocator::Lifetime::Transient)
+	{
+		if (block.m_allocationCount == 0)
+		{
+			block.m_head = 0;
+		}
+
+		return;
+	}
+
+	auto it = block.m_freeRanges.emplace(offset, size).first;
+
+	// Coalesces with the following range.
+	auto next = std::next(it);
+
+	if (next != block.m_freeRanges.end() && it->first + it->second == next->first)
+	{
+		it->second += next->second;
+		block.m_freeRanges.erase(next);
+	}
+
+	// Coalesces with the preceding range.
+	if (it != block.m_freeRanges.begin())
+	{
+		auto previous = std::prev(it);
+
+		if (previous->first + previous->second == it->first)
+		{
+			previous->second += it->second;
+			block.m_freeRanges.erase(it);
+		}
+	}
+}
+
+MemoryAllocation::MemoryAllocation() :
+	m_memory(VK_NULL_HANDLE),
+	m_offset(0),
+	m_size(0),
+	m_mapped(nullptr),
+	m_block(nullptr)
+{
+}
+
+MemoryAllocator::MemoryAllocator(const PhysicalDevice *physicalDevice, const LogicalDevice *logicalDevice) :
+	m_physicalDevice(physicalDevice),
+	m_logicalDevice(logicalDevice)
+{
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+#if defined(ACID_VERBOSE)
+	auto stats = GetStats();
+
+	if (stats.m_allocationCount != 0)
+	{
+		Log::Error("Memory allocator destroyed with %i live allocations\n", stats.m_allocationCount);
+	}
+#endif
+
+	for (auto &block : m_blocks)
+	{
+		if (block->m_mapped != nullptr)
+		{
+			vkUnmapMemory(*m_logicalDevice, block->m_memory);
+		}
+
+		vkFreeMemory(*m_logicalDevice, block->m_memory, nullptr);
+	}
+}
+
+MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements &requirements, const VkMemoryPropertyFlags &properties, const bool &linear,
+	const Lifetime &lifetime)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto memoryType = FindMemoryType(requirements.memoryTypeBits, properties);
+	auto typeProperties = m_physicalDevice->GetMemoryProperties().memoryTypes[memoryType].propertyFlags;
+	auto alignment = requirements.alignment;
+
+	// Non coherent ranges are flushed in whole atoms, so allocations must not share one.
+	if ((typeProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0 && (typeProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
+	{
+		alignment = std::max(alignment, m_physicalDevice->GetProperties().limits.nonCoherentAtomSize);
+	}
+
+	auto blockSize = GetBlockSize(memoryType);
+	MemoryBlock *block = nullptr;
+	VkDeviceSize offset = 0;
+
+	if (requirements.size > blockSize / 2)
+	{
+		block = CreateBlock(memoryType, requirements.size, linear, Lifetime::Persistent, true);
+		AllocateFromBlock(*block, requirements.size, alignment, offset);
+	}
+	else
+	{
+		for (auto &candidate : m_blocks)
+		{
+			if (candidate->m_memoryType != memoryType || candidate->m_linear != linear || candidate->m_lifetime != lifetime || candidate->m_dedicated)
+			{
+				continue;
+			}
+
+			if (AllocateFromBlock(*candidate, requirements.size, alignment, offset))
+			{
+				block = candidate.get();
+				break;
+			}
+		}
+
+		if (block == nullptr)
+		{
+			block = CreateBlock(memoryType, blockSize, linear, lifetime, false);
+			AllocateFromBlock(*block, requirements.size, alignment, offset);
+		}
+	}
+
+	block->m_usedBytes += requirements.size;
+	block->m_allocationCount++;
+
+	MemoryAllocation allocation;
+	allocation.m_memory = block->m_memory;
+	allocation.m_offset = offset;
+	allocation.m_size = requirements.size;
+	allocation.m_mapped = block->m_mapped == nullptr ? nullptr : static_cast<uint8_t *>(block->m_mapped) + offset;
+	allocation.m_block = block;
+	return allocation;
+}
+
+void MemoryAllocator::Free(MemoryAllocation &allocation)
+{
+	if (!allocation.IsValid())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto block = allocation.m_block;
+	block->m_usedBytes -= allocation.m_size;
+	block->m_allocationCount--;
+	FreeFromBlock(*block, allocation.m_offset, allocation.m_size);
+
+	if (block->m_allocationCount == 0)
+	{
+		// Keeps one empty block of each kind around, so a resource that is recreated every frame does not reallocate device memory.
+		auto isSpare = !block->m_dedicated && std::none_of(m_blocks.begin(), m_blocks.end(), [block](const std::unique_ptr<MemoryBlock> &other)
+		{
+			return other.get() != block && other->m_memoryType == block->m_memoryType && other->m_linear == block->m_linear &&
+				other->m_lifetime == block->m_lifetime && !other->m_dedicated && other->m_allocationCount == 0;
+		});
+
+		if (!isSpare)
+		{
+			DestroyBlock(block);
+		}
+	}
+
+	allocation = MemoryAllocation();
+}
+
+void MemoryAllocator::Flush(const MemoryAllocation &allocation) const
+{
+	if (!allocation.IsValid() || allocation.m_block->m_coherent)
+	{
+		return;
+	}
+
+	auto atomSize = m_physicalDevice->GetProperties().limits.nonCoherentAtomSize;
+
+	VkMappedMemoryRange mappedMemoryRange = {};
+	mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	mappedMemoryRange.memory = allocation.m_memory;
+	mappedMemoryRange.offset = allocation.m_offset;
+	mappedMemoryRange.size = AlignUp(allocation.m_size, atomSize);
+
+	if (mappedMemoryRange.offset + mappedMemoryRange.size > allocation.m_block->m_size)
+	{
+		mappedMemoryRange.size = VK_WHOLE_SIZE;
+	}
+
+	Graphics::CheckVk(vkFlushMappedMemoryRanges(*m_logicalDevice, 1, &mappedMemoryRange));
+}
+
+MemoryAllocator::Stats MemoryAllocator::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Stats stats;
+
+	for (const auto &block : m_blocks)
+	{
+		stats.m_blockCount++;
+		stats.m_dedicatedBlockCount += block->m_dedicated ? 1 : 0;
+		stats.m_allocationCount += block->m_allocationCount;
+		stats.m_reservedBytes += block->m_size;
+		stats.m_usedBytes += block->m_usedBytes;
+		(block->m_linear ? stats.m_bufferBytes : stats.m_imageBytes) += block->m_usedBytes;
+	}
+
+	return stats;
+}
+
+std::vector<MemoryAllocator::Budget> MemoryAllocator::GetBudgets() const
+{
+	auto &memoryProperties = m_physicalDevice->GetMemoryProperties();
+	std::vector<Budget> budgets(memoryProperties.memoryHeapCount);
+
+	for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+	{
+		budgets[i].m_deviceLocal = (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+		budgets[i].m_budget = memoryProperties.memoryHeaps[i].size;
+	}
+
+#if defined(VK_EXT_memory_budget)
+	if (m_logicalDevice->IsMemoryBudget())
+	{
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudgetProperties = {};
+		memoryBudgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+		VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {};
+		memoryProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		memoryProperties2.pNext = &memoryBudgetProperties;
+		vkGetPhysicalDeviceMemoryProperties2(*m_physicalDevice, &memoryProperties2);
+
+		for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+		{
+			budgets[i].m_usage = memoryBudgetProperties.heapUsage[i];
+			budgets[i].m_budget = memoryBudgetProperties.heapBudget[i];
+		}
+
+		return budgets;
+	}
+#endif
+
+	// Without the extension only the blocks of this allocator are known.
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const auto &block : m_blocks)
+	{
+		budgets[memoryProperties.memoryTypes[block->m_memoryType].heapIndex].m_usage += block->m_size;
+	}
+
+	return budgets;
+}
+
+uint32_t MemoryAllocator::FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties) const
+{
+	auto memoryProperties = m_physicalDevice->GetMemoryProperties();
+
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+	{
+		uint32_t memoryTypeBits = 1 << i;
+		bool isRequiredMemoryType = typeFilter & memoryTypeBits;
+
+		auto properties = memoryProperties.memoryTypes[i].propertyFlags;
+		bool hasRequiredProperties = (properties & requiredProperties) == requiredProperties;
+
+		if (isRequiredMemoryType && hasRequiredProperties)
+		{
+			return i;
+		}
+	}
+
+	throw std::runtime_error("Failed to find a valid memory type for buffer");
+}
+
+VkDeviceSize MemoryAllocator::GetBlockSize(const uint32_t &memoryType) const
+{
+	auto memoryProperties = m_physicalDevice->GetMemoryProperties();
+	auto &type = memoryProperties.memoryTypes[memoryType];
+	auto heapSize = memoryProperties.memoryHeaps[type.heapIndex].size;
+	auto blockSize = (type.propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0 ? DEVICE_BLOCK_SIZE : HOST_BLOCK_SIZE;
+
+	// Small heaps (such as device local host visible memory) are split into eighths instead.
+	return std::min(blockSize, heapSize / 8);
+}
+
+MemoryBlock *MemoryAllocator::CreateBlock(const uint32_t &memoryType, const VkDeviceSize &size, const bool &linear, const Lifetime &lifetime,
+	const bool &dedicated)
+{
+	auto typeProperties = m_physicalDevice->GetMemoryProperties().memoryTypes[memoryType].propertyFlags;
+
+	auto block = std::make_unique<MemoryBlock>();
+	block->m_size = size;
+	block->m_memoryType = memoryType;
+	block->m_coherent = (typeProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+	block->m_linear = linear;
+	block->m_lifetime = lifetime;
+	block->m_dedicated = dedicated;
+
+	VkMemoryAllocateInfo memoryAllocateInfo = {};
+	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.allocationSize = size;
+	memoryAllocateInfo.memoryTypeIndex = memoryType;
+
+	// Buffers read by acceleration structure builds are found by their device address, which their memory must be allocated with.
+	VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo = {};
+	memoryAllocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+	memoryAllocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
+
+	if (linear && m_logicalDevice->IsRayQuery())
+	{
+		memoryAllocateInfo.pNext = &memoryAllocateFlagsInfo;
+	}
+
+	Graphics::CheckVk(vkAllocateMemory(*m_logicalDevice, &memoryAllocateInfo, nullptr, &block->m_memory));
+
+	if ((typeProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0)
+	{
+		Graphics::CheckVk(vkMapMemory(*m_logicalDevice, block->m_memory, 0, VK_WHOLE_SIZE, 0, &block->m_mapped));
+	}
+
+	if (lifetime == Lifetime::Persistent)
+	{
+		block->m_freeRanges.emplace(0, size);
+	}
+
+	m_blocks.emplace_back(std::move(block));
+	return m_blocks.back().get();
+}
+
+void MemoryAllocator::DestroyBlock(MemoryBlock *block)
+{
+	if (block->m_mapped != nullptr)
+	{
+		vkUnmapMemory(*m_logicalDevice, block->m_memory);
+	}
+
+	vkFreeMemory(*m_logicalDevice, block->m_memory, nullptr);
+
+	m_blocks.erase(std::remove_if(m_blocks.begin(), m_blocks.end(), [block](const std::unique_ptr<MemoryBlock> &other)
+	{
+		return other.get() == block;
+	}), m_blocks.end());
+}
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <mutex>
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+class LogicalDevice;
+class PhysicalDevice;
+class MemoryBlock;
+
+/**
+ * @brief A range of device memory handed out by the {@link MemoryAllocator}.
+ */
+class ACID_EXPORT MemoryAllocation
+{
+public:
+	MemoryAllocation();
+
+	bool IsValid() const { return m_memory != VK_NULL_HANDLE; }
+
+	const VkDeviceMemory &GetMemory() const { return m_memory; }
+
+	const VkDeviceSize &GetOffset() const { return m_offset; }
+
+	const VkDeviceSize &GetSize() const { return m_size; }
+
+	/**
+	 * Gets the host address of this allocation, the backing block is persistently mapped if it is host visible.
+	 * @return The mapped data, or nullptr if the memory is not host visible.
+	 */
+	void *GetMapped() const { return m_mapped; }
+
+private:
+	friend class MemoryAllocator;
+
+	VkDeviceMemory m_memory;
+	VkDeviceSize m_offset;
+	VkDeviceSize m_size;
+	void *m_mapped;
+	MemoryBlock *m_block;
+};
+
+/**
+ * @brief Class that suballocates buffers and images from large blocks of device memory.
+ * Persistent allocations come from per memory type free lists, transient allocations (staging and readback data) are bump allocated
+ * from blocks that rewind once every allocation in them has been freed.
+ */
+class ACID_EXPORT MemoryAllocator :
+	public NonCopyable
+{
+public:
+	enum class Lifetime
+	{
+		Persistent, Transient
+	};
+
+	class Stats
+	{
+	public:
+		uint32_t m_blockCount = 0;
+		uint32_t m_dedicatedBlockCount = 0;
+		uint32_t m_allocationCount = 0;
+		VkDeviceSize m_reservedBytes = 0;
+		VkDeviceSize m_usedBytes = 0;
+		/// The used bytes of linear blocks, these hold buffers and the few linear tiled images used for readback.
+		VkDeviceSize m_bufferBytes = 0;
+		/// The used bytes of optimal tiled image blocks.
+		VkDeviceSize m_imageBytes = 0;
+	};
+
+	/**
+	 * @brief The usage of a memory heap, by this process when the memory budget extension is enabled, otherwise by this allocator.
+	 */
+	class Budget
+	{
+	public:
+		bool m_deviceLocal = false;
+		VkDeviceSize m_usage = 0;
+		/// How much of the heap can be used before allocations may fail or be evicted, the heap size without the memory budget extension.
+		VkDeviceSize m_budget = 0;
+	};
+
+	MemoryAllocator(const PhysicalDevice *physicalDevice, const LogicalDevice *logicalDevice);
+
+	~MemoryAllocator();
+
+	/**
+	 * Allocates memory that fulfils a resources requirements.
+	 * @param requirements The memory requirements of the buffer or image.
+	 * @param properties The required memory properties.
+	 * @param linear If the resource is a buffer or linear tiled image, these are kept apart from optimal images to respect buffer image granularity.
+	 * @param lifetime If the allocation will be freed shortly after being created.
+	 * @return The allocation.
+	 */
+	MemoryAllocation Allocate(const VkMemoryRequirements &requirements, const VkMemoryPropertyFlags &properties, const bool &linear,
+		const Lifetime &lifetime = Lifetime::Persistent);
+
+	/**
+	 * Returns an allocation to its block, the allocation is reset.
+	 * @param allocation The allocation to free.
+	 */
+	void Free(MemoryAllocation &allocation);
+
+	/**
+	 * Flushes writes to a host visible allocation that is not host coherent.
+	 * @param allocation The allocation to flush.
+	 */
+	void Flush(const MemoryAllocation &allocation) const;
+
+	/**
+	 * Gets the usage of all blocks, this locks the allocator.
+	 * @return The allocator stats.
+	 */
+	Stats GetStats() const;
+
+	/**
+	 * Gets the usage and budget of every memory heap, this locks the allocator when the memory budget extension is not enabled.
+	 * @return The budgets, indexed by memory heap.
+	 */
+	std::vector<Budget> GetBudgets() const;
+
+	uint32_t FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties) const;
+
+private:
+	VkDeviceSize GetBlockSize(const uint32_t &memoryType) const;
+
+	MemoryBlock *CreateBlock(const uint32_t &memoryType, const VkDeviceSize &size, const bool &linear, const Lifetime &lifetime, const bool &dedicated);
+
+	void DestroyBlock(MemoryBlock *block);
+
+	const PhysicalDevice *m_physicalDevice;
+	const LogicalDevice *m_logicalDevice;
+
+	std::vector<std::unique_ptr<MemoryBlock>> m_blocks;
+	mutable std::mutex m_mutex;
+};
+}
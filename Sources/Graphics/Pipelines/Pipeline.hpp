@@ -33,8 +33,6 @@ public:
 
 	virtual const VkDescriptorSetLayout &GetDescriptorSetLayout() const = 0;
 
-	virtual const VkDescriptorPool &GetDescriptorPool() const = 0;
-
 	virtual const VkPipeline &GetPipeline() const = 0;
 
 	virtual const VkPipelineLayout &GetPipelineLayout() const = 0;
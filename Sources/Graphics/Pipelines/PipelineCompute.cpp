@@ -1,6 +1,7 @@
 #include "PipelineCompute.hpp"
 
 #include "Graphics/Graphics.hpp"
+#include "Graphics/Descriptors/BindlessDescriptors.hpp"
 #include "Files/FileSystem.hpp"
 
 namespace acid
@@ -9,11 +10,10 @@ PipelineCompute::PipelineCompute(std::string shaderStage, std::vector<Shader::De
 	m_shaderStage(std::move(shaderStage)),
 	m_defines(std::move(defines)),
 	m_pushDescriptors(pushDescriptors),
-	m_shader(std::make_unique<Shader>(m_shaderStage)),
+	m_shader(std::make_unique<Shader>(m_shaderStage, pushDescriptors)),
 	m_shaderModule(VK_NULL_HANDLE),
 	m_shaderStageCreateInfo({}),
 	m_descriptorSetLayout(VK_NULL_HANDLE),
-	m_descriptorPool(VK_NULL_HANDLE),
 	m_pipeline(VK_NULL_HANDLE),
 	m_pipelineLayout(VK_NULL_HANDLE),
 	m_pipelineBindPoint(VK_PIPELINE_BIND_POINT_COMPUTE)
@@ -24,7 +24,6 @@ PipelineCompute::PipelineCompute(std::string shaderStage, std::vector<Shader::De
 
 	CreateShaderProgram();
 	CreateDescriptorLayout();
-	CreateDescriptorPool();
 	CreatePipelineLayout();
 	CreatePipelineCompute();
 
@@ -42,7 +41,6 @@ PipelineCompute::~PipelineCompute()
 	vkDestroyShaderModule(*logicalDevice, m_shaderModule, nullptr);
 
 	vkDestroyDescriptorSetLayout(*logicalDevice, m_descriptorSetLayout, nullptr);
-	vkDestroyDescriptorPool(*logicalDevice, m_descriptorPool, nullptr);
 	vkDestroyPipeline(*logicalDevice, m_pipeline, nullptr);
 	vkDestroyPipelineLayout(*logicalDevice, m_pipelineLayout, nullptr);
 }
@@ -101,31 +99,31 @@ void PipelineCompute::CreateDescriptorLayout()
 	Graphics::CheckVk(vkCreateDescriptorSetLayout(*logicalDevice, &descriptorSetLayoutCreateInfo, nullptr, &m_descriptorSetLayout));
 }
 
-void PipelineCompute::CreateDescriptorPool()
+void PipelineCompute::CreatePipelineLayout()
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
-	auto descriptorPools = m_shader->GetDescriptorPools();
+	auto pushConstantRanges = m_shader->GetPushConstantRanges();
 
-	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
-	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-	descriptorPoolCreateInfo.maxSets = 8192; // 16384;
-	descriptorPoolCreateInfo.poolSizeCount = static_cast<uint32_t>(descriptorPools.size());
-	descriptorPoolCreateInfo.pPoolSizes = descriptorPools.data();
-	Graphics::CheckVk(vkCreateDescriptorPool(*logicalDevice, &descriptorPoolCreateInfo, nullptr, &m_descriptorPool));
-}
+	// Bindless shaders read the shared bindless set after their own set.
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { m_descriptorSetLayout };
 
-void PipelineCompute::CreatePipelineLayout()
-{
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	if (m_shader->IsBindless())
+	{
+		auto bindlessDescriptors = Graphics::Get()->GetBindlessDescriptors();
 
-	auto pushConstantRanges = m_shader->GetPushConstantRanges();
+		if (bindlessDescriptors == nullptr)
+		{
+			throw std::runtime_error("Bindless shader used without descriptor indexing");
+		}
+
+		descriptorSetLayouts.emplace_back(bindlessDescriptors->GetDescriptorSetLayout());
+	}
 
 	VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
 	pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutCreateInfo.setLayoutCount = 1;
-	pipelineLayoutCreateInfo.pSetLayouts = &m_descriptorSetLayout;
+	pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+	pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
 	pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
 	pipelineLayoutCreateInfo.pPushConstantRanges = pushConstantRanges.data();
 	Graphics::CheckVk(vkCreatePipelineLayout(*logicalDevice, &pipelineLayoutCreateInfo, nullptr, &m_pipelineLayout));
@@ -35,8 +35,6 @@ public:
 
 	const VkDescriptorSetLayout &GetDescriptorSetLayout() const override { return m_descriptorSetLayout; }
 
-	const VkDescriptorPool &GetDescriptorPool() const override { return m_descriptorPool; }
-
 	const VkPipeline &GetPipeline() const override { return m_pipeline; }
 
 	const VkPipelineLayout &GetPipelineLayout() const override { return m_pipelineLayout; }
@@ -48,8 +46,6 @@ private:
 
 	void CreateDescriptorLayout();
 
-	void CreateDescriptorPool();
-
 	void CreatePipelineLayout();
 
 	void CreatePipelineCompute();
@@ -64,7 +60,6 @@ private:
 	VkPipelineShaderStageCreateInfo m_shaderStageCreateInfo;
 
 	VkDescriptorSetLayout m_descriptorSetLayout;
-	VkDescriptorPool m_descriptorPool;
 
 	VkPipeline m_pipeline;
 	VkPipelineLayout m_pipelineLayout;
@@ -1,7 +1,11 @@
 ﻿#include "PipelineGraphics.hpp"
 
 #include "Graphics/Graphics.hpp"
+#include "Graphics/Descriptors/BindlessDescriptors.hpp"
+#include "Graphics/Renderpass/RenderGraph.hpp"
+#include "ShaderReloader.hpp"
 #include "Files/FileSystem.hpp"
+#include "Maths/Maths.hpp"
 
 namespace acid
 {
@@ -9,7 +13,7 @@ const std::vector<VkDynamicState> DYNAMIC_STATES = { VK_DYNAMIC_STATE_VIEWPORT,
 
 PipelineGraphics::PipelineGraphics(Stage stage, std::vector<std::string> shaderStages, std::vector<Shader::VertexInput> vertexInputs, std::vector<Shader::Define> defines,
 	const Mode &mode, const Depth &depth, const VkPrimitiveTopology &topology, const VkPolygonMode &polygonMode, const VkCullModeFlags &cullMode, const VkFrontFace &frontFace,
-	const bool &pushDescriptors) :
+	const bool &pushDescriptors, const bool &shadingRate) :
 	m_stage(std::move(stage)),
 	m_shaderStages(std::move(shaderStages)),
 	m_vertexInputs(std::move(vertexInputs)),
@@ -21,10 +25,10 @@ PipelineGraphics::PipelineGraphics(Stage stage, std::vector<std::string> shaderS
 	m_cullMode(cullMode),
 	m_frontFace(frontFace),
 	m_pushDescriptors(pushDescriptors),
-	m_shader(std::make_unique<Shader>(m_shaderStages.back())),
+	m_shadingRate(shadingRate),
+	m_shader(std::make_unique<Shader>(m_shaderStages.back(), pushDescriptors)),
 	m_dynamicStates(std::vector<VkDynamicState>(DYNAMIC_STATES)),
 	m_descriptorSetLayout(VK_NULL_HANDLE),
-	m_descriptorPool(VK_NULL_HANDLE),
 	m_pipeline(VK_NULL_HANDLE),
 	m_pipelineLayout(VK_NULL_HANDLE),
 	m_pipelineBindPoint(VK_PIPELINE_BIND_POINT_GRAPHICS),
@@ -44,23 +48,43 @@ PipelineGraphics::PipelineGraphics(Stage stage, std::vector<std::string> shaderS
 #endif
 
 	std::sort(m_vertexInputs.begin(), m_vertexInputs.end());
+
+	// Shaders that write storage images need the size of each coarse fragment to cover it.
+	if (m_shadingRate && Graphics::Get()->GetLogicalDevice()->IsFragmentShadingRate())
+	{
+		m_defines.emplace_back("SHADING_RATE", "1");
+	}
+
+	// Materials pack the G-buffer they write and post effects unpack it.
+	if (auto renderStage = Graphics::Get()->GetRenderStage(m_stage.first); renderStage != nullptr && renderStage->IsCompactGBuffer())
+	{
+		m_defines.emplace_back("COMPACT_GBUFFER", "1");
+	}
+
+	// Shaders of multiview stages read the matrices of the view they draw with gl_ViewIndex.
+	if (auto renderStage = Graphics::Get()->GetRenderStage(m_stage.first); renderStage != nullptr && renderStage->GetViewCount() > 1)
+	{
+		m_defines.emplace_back("MULTIVIEW", String::To(renderStage->GetViewCount()));
+	}
+
+	// Mrt pipelines write the handle of the entity they draw to the entity attachment, other pipelines of the subpass leave it unchanged.
+	if (auto renderStage = Graphics::Get()->GetRenderStage(m_stage.first); renderStage != nullptr && m_mode == Mode::Mrt)
+	{
+		if (auto entityLocation = renderStage->GetEntityLocation(m_stage.second))
+		{
+			m_defines.emplace_back("ENTITY_ID", String::To(*entityLocation));
+		}
+	}
+
 	CreateShaderProgram();
 	CreateDescriptorLayout();
-	CreateDescriptorPool();
 	CreatePipelineLayout();
 	CreateAttributes();
+	CreatePipelineMode();
 
-	switch (m_mode)
+	if (auto shaderReloader = Graphics::Get()->GetShaderReloader())
 	{
-	case Mode::Polygon:
-		CreatePipelinePolygon();
-		break;
-	case Mode::Mrt:
-		CreatePipelineMrt();
-		break;
-	default:
-		throw std::runtime_error("Unknown pipeline mode");
-		break;
+		shaderReloader->Add(this);
 	}
 
 #if defined(ACID_VERBOSE)
@@ -74,12 +98,16 @@ PipelineGraphics::~PipelineGraphics()
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
+	if (auto shaderReloader = Graphics::Get()->GetShaderReloader())
+	{
+		shaderReloader->Remove(this);
+	}
+
 	for (const auto &shaderModule : m_modules)
 	{
 		vkDestroyShaderModule(*logicalDevice, shaderModule, nullptr);
 	}
 
-	vkDestroyDescriptorPool(*logicalDevice, m_descriptorPool, nullptr);
 	vkDestroyPipeline(*logicalDevice, m_pipeline, nullptr);
 	vkDestroyPipelineLayout(*logicalDevice, m_pipelineLayout, nullptr);
 	vkDestroyDescriptorSetLayout(*logicalDevice, m_descriptorSetLayout, nullptr);
@@ -92,7 +120,16 @@ const ImageDepth *PipelineGraphics::GetDepthStencil(const std::optional<uint32_t
 
 const Image2d *PipelineGraphics::GetImage(const uint32_t &index, const std::optional<uint32_t> &stage) const
 {
-	return Graphics::Get()->GetRenderStage(stage ? *stage : m_stage.first)->GetFramebuffers()->GetAttachment(index);
+	auto stageIndex = stage ? *stage : m_stage.first;
+	auto renderStage = Graphics::Get()->GetRenderStage(stageIndex);
+
+	// Recorded as a read like lookups by name, transient attachments have no contents to read.
+	if (auto attachment = renderStage->GetAttachment(index); attachment && !Graphics::Get()->GetRenderGraph()->RecordRead(attachment->GetName(), stageIndex))
+	{
+		return nullptr;
+	}
+
+	return renderStage->GetFramebuffers()->GetAttachment(index);
 }
 
 RenderArea PipelineGraphics::GetRenderArea(const std::optional<uint32_t> &stage) const
@@ -100,16 +137,23 @@ RenderArea PipelineGraphics::GetRenderArea(const std::optional<uint32_t> &stage)
 	return Graphics::Get()->GetRenderStage(stage ? *stage : m_stage.first)->GetRenderArea();
 }
 
-void PipelineGraphics::CreateShaderProgram()
+std::string PipelineGraphics::GetDefineBlock(const std::vector<Shader::Define> &defines)
 {
 	std::stringstream defineBlock;
 	defineBlock << "\n";
 
-	for (const auto &define : m_defines)
+	for (const auto &define : defines)
 	{
 		defineBlock << "#define " << define.first << " " << define.second << "\n";
 	}
 
+	return defineBlock.str();
+}
+
+void PipelineGraphics::CreateShaderProgram()
+{
+	auto defineBlock = GetDefineBlock(m_defines);
+
 	for (const auto &shaderStage : m_shaderStages)
 	{
 		auto fileLoaded = Files::Read(shaderStage);
@@ -121,8 +165,8 @@ void PipelineGraphics::CreateShaderProgram()
 			return;
 		}
 
-		auto shaderCode = Shader::InsertDefineBlock(*fileLoaded, defineBlock.str());
-		shaderCode = Shader::ProcessIncludes(shaderCode);
+		auto shaderCode = Shader::InsertDefineBlock(*fileLoaded, defineBlock);
+		shaderCode = Shader::ProcessIncludes(shaderCode, &m_stageIncludes.emplace_back());
 
 		auto stageFlag = Shader::GetShaderStage(shaderStage);
 		auto shaderModule = m_shader->CreateShaderModule(shaderStage, shaderCode, stageFlag);
@@ -153,31 +197,31 @@ void PipelineGraphics::CreateDescriptorLayout()
 	Graphics::CheckVk(vkCreateDescriptorSetLayout(*logicalDevice, &descriptorSetLayoutCreateInfo, nullptr, &m_descriptorSetLayout));
 }
 
-void PipelineGraphics::CreateDescriptorPool()
+void PipelineGraphics::CreatePipelineLayout()
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
-	auto descriptorPools = m_shader->GetDescriptorPools();
+	auto pushConstantRanges = m_shader->GetPushConstantRanges();
 
-	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
-	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-	descriptorPoolCreateInfo.maxSets = 8192; // 16384;
-	descriptorPoolCreateInfo.poolSizeCount = static_cast<uint32_t>(descriptorPools.size());
-	descriptorPoolCreateInfo.pPoolSizes = descriptorPools.data();
-	Graphics::CheckVk(vkCreateDescriptorPool(*logicalDevice, &descriptorPoolCreateInfo, nullptr, &m_descriptorPool));
-}
+	// Bindless shaders read the shared bindless set after their own set.
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { m_descriptorSetLayout };
 
-void PipelineGraphics::CreatePipelineLayout()
-{
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	if (m_shader->IsBindless())
+	{
+		auto bindlessDescriptors = Graphics::Get()->GetBindlessDescriptors();
 
-	auto pushConstantRanges = m_shader->GetPushConstantRanges();
+		if (bindlessDescriptors == nullptr)
+		{
+			throw std::runtime_error("Bindless shader used without descriptor indexing");
+		}
+
+		descriptorSetLayouts.emplace_back(bindlessDescriptors->GetDescriptorSetLayout());
+	}
 
 	VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
 	pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutCreateInfo.setLayoutCount = 1;
-	pipelineLayoutCreateInfo.pSetLayouts = &m_descriptorSetLayout;
+	pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+	pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
 	pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
 	pipelineLayoutCreateInfo.pPushConstantRanges = pushConstantRanges.data();
 	Graphics::CheckVk(vkCreatePipelineLayout(*logicalDevice, &pipelineLayoutCreateInfo, nullptr, &m_pipelineLayout));
@@ -248,6 +292,19 @@ void PipelineGraphics::CreateAttributes()
 		m_depthStencilState.depthWriteEnable = VK_TRUE;
 		break;
 	case Depth::ReadWrite:
+		m_depthStencilState.depthTestEnable = VK_TRUE;
+		m_depthStencilState.depthWriteEnable = VK_TRUE;
+		break;
+	case Depth::Prepass:
+		// The pre-pass has written the nearest depth of every pixel, so only the surface that wrote it is shaded.
+		if (auto renderStage = Graphics::Get()->GetRenderStage(m_stage.first); renderStage != nullptr && renderStage->IsDepthPrepass())
+		{
+			m_depthStencilState.depthCompareOp = VK_COMPARE_OP_EQUAL;
+			m_depthStencilState.depthTestEnable = VK_TRUE;
+			m_depthStencilState.depthWriteEnable = VK_FALSE;
+			break;
+		}
+
 		m_depthStencilState.depthTestEnable = VK_TRUE;
 		m_depthStencilState.depthWriteEnable = VK_TRUE;
 		break;
@@ -344,11 +401,64 @@ void PipelineGraphics::CreatePipeline()
 	pipelineCreateInfo.subpass = m_stage.second;
 	pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 	pipelineCreateInfo.basePipelineIndex = -1;
+
+#if defined(VK_KHR_fragment_shading_rate)
+	// Pipelines shade at the full rate unless they read the attachment, where the rate of each region replaces it. Subpasses without one read a rate of one pixel.
+	VkPipelineFragmentShadingRateStateCreateInfoKHR fragmentShadingRateState = {};
+	fragmentShadingRateState.sType = VK_STRUCTURE_TYPE_PIPELINE_FRAGMENT_SHADING_RATE_STATE_CREATE_INFO_KHR;
+	fragmentShadingRateState.fragmentSize = { 1, 1 };
+	fragmentShadingRateState.combinerOps[0] = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR;
+	fragmentShadingRateState.combinerOps[1] = m_shadingRate ? VK_FRAGMENT_SHADING_RATE_COMBINER_OP_REPLACE_KHR : VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR;
+
+	if (logicalDevice->IsFragmentShadingRate())
+	{
+		pipelineCreateInfo.pNext = &fragmentShadingRateState;
+	}
+#endif
+
 	Graphics::CheckVk(vkCreateGraphicsPipelines(*logicalDevice, pipelineCache, 1, &pipelineCreateInfo, nullptr, &m_pipeline));
 }
 
+void PipelineGraphics::CreatePipelineMode()
+{
+	switch (m_mode)
+	{
+	case Mode::Polygon:
+		CreatePipelinePolygon();
+		break;
+	case Mode::Mrt:
+	case Mode::DepthOnly:
+		CreatePipelineMrt();
+		break;
+	default:
+		throw std::runtime_error("Unknown pipeline mode");
+		break;
+	}
+}
+
 void PipelineGraphics::CreatePipelinePolygon()
 {
+	auto entityLocation = Graphics::Get()->GetRenderStage(m_stage.first)->GetEntityLocation(m_stage.second);
+
+	if (!entityLocation)
+	{
+		CreatePipeline();
+		return;
+	}
+
+	// The entity attachment is another colour attachment of the subpass, it is masked so the first attachment is still the only one drawn to.
+	auto attachmentCount = std::max(Graphics::Get()->GetRenderStage(m_stage.first)->GetAttachmentCount(m_stage.second), *entityLocation + 1);
+	std::vector<VkPipelineColorBlendAttachmentState> blendAttachmentStates(attachmentCount);
+	blendAttachmentStates[0] = m_blendAttachmentStates[0];
+
+	if (*entityLocation == 0)
+	{
+		blendAttachmentStates[0] = {};
+	}
+
+	m_colourBlendState.attachmentCount = static_cast<uint32_t>(blendAttachmentStates.size());
+	m_colourBlendState.pAttachments = blendAttachmentStates.data();
+
 	CreatePipeline();
 }
 
@@ -356,6 +466,7 @@ void PipelineGraphics::CreatePipelineMrt()
 {
 	auto renderStage = Graphics::Get()->GetRenderStage(m_stage.first);
 	uint32_t attachmentCount = renderStage->GetAttachmentCount(m_stage.second);
+	auto entityLocation = renderStage->GetEntityLocation(m_stage.second);
 
 	std::vector<VkPipelineColorBlendAttachmentState> blendAttachmentStates;
 	blendAttachmentStates.reserve(attachmentCount);
@@ -363,6 +474,24 @@ void PipelineGraphics::CreatePipelineMrt()
 	for (uint32_t i = 0; i < attachmentCount; i++)
 	{
 		VkPipelineColorBlendAttachmentState blendAttachmentState = {};
+
+		if (m_mode == Mode::DepthOnly)
+		{
+			blendAttachmentState.blendEnable = VK_FALSE;
+			blendAttachmentState.colorWriteMask = 0;
+			blendAttachmentStates.emplace_back(blendAttachmentState);
+			continue;
+		}
+
+		// Entity handles are integers, they are never blended and the closest fragment replaces the handle.
+		if (i == entityLocation)
+		{
+			blendAttachmentState.blendEnable = VK_FALSE;
+			blendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT;
+			blendAttachmentStates.emplace_back(blendAttachmentState);
+			continue;
+		}
+
 		blendAttachmentState.blendEnable = VK_TRUE;
 		blendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
 		blendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
@@ -379,4 +508,59 @@ void PipelineGraphics::CreatePipelineMrt()
 
 	CreatePipeline();
 }
+
+std::size_t PipelineGraphicsCreate::GetHash() const
+{
+	std::size_t hash = 0;
+
+	for (const auto &shaderStage : m_shaderStages)
+	{
+		Maths::HashCombine(hash, shaderStage);
+	}
+
+	for (const auto &[name, value] : m_defines)
+	{
+		Maths::HashCombine(hash, name);
+		Maths::HashCombine(hash, value);
+	}
+
+	for (const auto &vertexInput : m_vertexInputs)
+	{
+		for (const auto &bindingDescription : vertexInput.GetBindingDescriptions())
+		{
+			Maths::HashCombine(hash, bindingDescription.binding);
+			Maths::HashCombine(hash, bindingDescription.stride);
+			Maths::HashCombine(hash, static_cast<uint32_t>(bindingDescription.inputRate));
+		}
+
+		for (const auto &attributeDescription : vertexInput.GetAttributeDescriptions())
+		{
+			Maths::HashCombine(hash, attributeDescription.location);
+			Maths::HashCombine(hash, attributeDescription.binding);
+			Maths::HashCombine(hash, static_cast<uint32_t>(attributeDescription.format));
+			Maths::HashCombine(hash, attributeDescription.offset);
+		}
+	}
+
+	Maths::HashCombine(hash, static_cast<uint32_t>(m_mode));
+	Maths::HashCombine(hash, static_cast<uint32_t>(m_depth));
+	Maths::HashCombine(hash, static_cast<uint32_t>(m_topology));
+	Maths::HashCombine(hash, static_cast<uint32_t>(m_polygonMode));
+	Maths::HashCombine(hash, static_cast<uint32_t>(m_cullMode));
+	Maths::HashCombine(hash, static_cast<uint32_t>(m_frontFace));
+	Maths::HashCombine(hash, m_pushDescriptors);
+	return hash;
+}
+
+bool PipelineGraphicsCreate::operator==(const PipelineGraphicsCreate &other) const
+{
+	return m_shaderStages == other.m_shaderStages && m_defines == other.m_defines && m_vertexInputs == other.m_vertexInputs && m_mode == other.m_mode &&
+		m_depth == other.m_depth && m_topology == other.m_topology && m_polygonMode == other.m_polygonMode && m_cullMode == other.m_cullMode &&
+		m_frontFace == other.m_frontFace && m_pushDescriptors == other.m_pushDescriptors;
+}
+
+bool PipelineGraphicsCreate::operator!=(const PipelineGraphicsCreate &other) const
+{
+	return !(*this == other);
+}
 }
@@ -17,14 +17,16 @@ class ACID_EXPORT PipelineGraphics :
 	public Pipeline
 {
 public:
+	/// Depth only pipelines bind every attachment of the subpass like Mrt, but leave them unwritten.
 	enum class Mode
 	{
-		Polygon, Mrt
+		Polygon, Mrt, DepthOnly
 	};
 
+	/// Prepass is read and written, unless the render stage has a depth pre-pass where it is only drawn where the pre-pass depth is equal.
 	enum class Depth
 	{
-		None = 0, Read = 1, Write = 2, ReadWrite = Read | Write
+		None = 0, Read = 1, Write = 2, ReadWrite = Read | Write, Prepass = 4 | ReadWrite
 	};
 
 	/**
@@ -40,11 +42,12 @@ public:
 	 * @param cullMode The vertex cull mode.
 	 * @param frontFace The direction to render faces.
 	 * @param pushDescriptors If no actual descriptor sets are allocated but instead pushed.
+	 * @param shadingRate If the shading rate attachment of the subpass is read, so regions it marks as low detail are shaded at coarser rates.
 	 */
 	PipelineGraphics(Stage stage, std::vector<std::string> shaderStages, std::vector<Shader::VertexInput> vertexInputs, std::vector<Shader::Define> defines = {},
 		const Mode &mode = Mode::Polygon, const Depth &depthMode = Depth::ReadWrite, const VkPrimitiveTopology &topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
 		const VkPolygonMode &polygonMode = VK_POLYGON_MODE_FILL, const VkCullModeFlags &cullMode = VK_CULL_MODE_BACK_BIT, const VkFrontFace &frontFace = VK_FRONT_FACE_CLOCKWISE,
-		const bool &pushDescriptors = false);
+		const bool &pushDescriptors = false, const bool &shadingRate = false);
 
 	~PipelineGraphics();
 
@@ -92,31 +95,46 @@ public:
 
 	const bool &IsPushDescriptors() const override { return m_pushDescriptors; }
 
+	const bool &IsShadingRate() const { return m_shadingRate; }
+
 	const Shader *GetShader() const override { return m_shader.get(); }
 
 	const VkDescriptorSetLayout &GetDescriptorSetLayout() const override { return m_descriptorSetLayout; }
 
-	const VkDescriptorPool &GetDescriptorPool() const override { return m_descriptorPool; }
-
 	const VkPipeline &GetPipeline() const override { return m_pipeline; }
 
 	const VkPipelineLayout &GetPipelineLayout() const override { return m_pipelineLayout; }
 
 	const VkPipelineBindPoint &GetPipelineBindPoint() const override { return m_pipelineBindPoint; }
 
+	/**
+	 * Gets the files included by each shader stage, in the order of the shader stages.
+	 * @return The included files of each stage.
+	 */
+	const std::vector<std::vector<std::string>> &GetStageIncludes() const { return m_stageIncludes; }
+
+	/**
+	 * Gets the block of defines inserted at the top of each shader stage.
+	 * @param defines The defines.
+	 * @return The define block.
+	 */
+	static std::string GetDefineBlock(const std::vector<Shader::Define> &defines);
+
 private:
+	friend class ShaderReloader;
+
 	void CreateShaderProgram();
 
 	void CreateDescriptorLayout();
 
-	void CreateDescriptorPool();
-
 	void CreatePipelineLayout();
 
 	void CreateAttributes();
 
 	void CreatePipeline();
 
+	void CreatePipelineMode();
+
 	void CreatePipelinePolygon();
 
 	void CreatePipelineMrt();
@@ -132,6 +150,7 @@ private:
 	VkCullModeFlags m_cullMode;
 	VkFrontFace m_frontFace;
 	bool m_pushDescriptors;
+	bool m_shadingRate;
 
 	std::unique_ptr<Shader> m_shader;
 
@@ -139,9 +158,9 @@ private:
 
 	std::vector<VkShaderModule> m_modules;
 	std::vector<VkPipelineShaderStageCreateInfo> m_stages;
+	std::vector<std::vector<std::string>> m_stageIncludes;
 
 	VkDescriptorSetLayout m_descriptorSetLayout;
-	VkDescriptorPool m_descriptorPool;
 
 	VkPipeline m_pipeline;
 	VkPipelineLayout m_pipelineLayout;
@@ -193,10 +212,11 @@ public:
 	friend const Metadata &operator>>(const Metadata &metadata, PipelineGraphicsCreate &pipelineCreate)
 	{
 		metadata.GetChild("Shader Stages", pipelineCreate.m_shaderStages);
-		//metadata.GetChild("Vertex Inputs", pipelineCreate.m_vertexInputs);
+		metadata.GetChild("Vertex Inputs", pipelineCreate.m_vertexInputs);
 		metadata.GetChild("Defines", pipelineCreate.m_defines);
 		metadata.GetChild("Mode", pipelineCreate.m_mode);
 		metadata.GetChild("Depth", pipelineCreate.m_depth);
+		metadata.GetChild("Topology", pipelineCreate.m_topology);
 		metadata.GetChild("Polygon Mode", pipelineCreate.m_polygonMode);
 		metadata.GetChild("Cull Mode", pipelineCreate.m_cullMode);
 		metadata.GetChild("Front Face", pipelineCreate.m_frontFace);
@@ -208,10 +228,11 @@ public:
 	friend Metadata &operator<<(Metadata &metadata, const PipelineGraphicsCreate &pipelineCreate)
 	{
 		metadata.SetChild("Shader Stages", pipelineCreate.m_shaderStages);
-		//metadata.SetChild("Vertex Inputs", pipelineCreate.m_vertexInputs);
+		metadata.SetChild("Vertex Inputs", pipelineCreate.m_vertexInputs);
 		metadata.SetChild("Defines", pipelineCreate.m_defines);
 		metadata.SetChild("Mode", pipelineCreate.m_mode);
 		metadata.SetChild("Depth", pipelineCreate.m_depth);
+		metadata.SetChild("Topology", pipelineCreate.m_topology);
 		metadata.SetChild("Polygon Mode", pipelineCreate.m_polygonMode);
 		metadata.SetChild("Cull Mode", pipelineCreate.m_cullMode);
 		metadata.SetChild("Front Face", pipelineCreate.m_frontFace);
@@ -240,6 +261,16 @@ public:
 
 	const bool &GetPushDescriptors() const { return m_pushDescriptors; }
 
+	/**
+	 * Gets a hash of every value that defines the pipeline variant, shader stages, defines, vertex inputs and render state, without serializing them.
+	 * @return The variant hash.
+	 */
+	std::size_t GetHash() const;
+
+	bool operator==(const PipelineGraphicsCreate &other) const;
+
+	bool operator!=(const PipelineGraphicsCreate &other) const;
+
 private:
 	std::vector<std::string> m_shaderStages;
 	std::vector<Shader::VertexInput> m_vertexInputs;
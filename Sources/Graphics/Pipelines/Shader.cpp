@@ -1,19 +1,31 @@
 #include "Shader.hpp"
 
+#include <iomanip>
 #include <SPIRV/GlslangToSpv.h>
 #include <glslang/Public/ShaderLang.h>
 #include "Graphics/Graphics.hpp"
 #include "Files/FileSystem.hpp"
 #include "Helpers/String.hpp"
+#include "Graphics/Buffers/AccelerationStructure.hpp"
 #include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/UniformBuffer.hpp"
+#include "Graphics/Descriptors/BindlessDescriptors.hpp"
 #include "Graphics/Images/Image2d.hpp"
 #include "Graphics/Images/ImageCube.hpp"
 
 namespace acid
 {
-Shader::Shader(std::string name) :
+const std::string SHADER_CACHE_DIRECTORY = "Cache/Shaders/";
+// Increment when the cache layout or the glslang compile options change.
+const uint32_t SHADER_CACHE_VERSION = 3;
+// glslang reflects subpass inputs without a GL type, they are given one outside of the GL enums.
+const int32_t GL_SUBPASS_INPUT = 0x10000;
+const int32_t GL_ACCELERATION_STRUCTURE = 0x10001;
+
+Shader::Shader(std::string name, const bool &pushDescriptors) :
 	m_name(std::move(name)),
+	m_pushDescriptors(pushDescriptors),
+	m_bindless(false),
 	m_lastDescriptorBinding(0)
 {
 }
@@ -45,7 +57,8 @@ void Shader::CreateReflection()
 		switch (uniformBlock.m_type)
 		{
 		case UniformBlock::Type::Uniform:
-			descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			// Uniform handlers share the frames UniformRing, so blocks are bound with a dynamic offset into it.
+			descriptorType = m_pushDescriptors ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 			m_descriptorSetLayouts.emplace_back(UniformBuffer::GetDescriptorSetLayout(static_cast<uint32_t>(uniformBlock.m_binding), descriptorType, uniformBlock.m_stageFlags, 1));
 			break;
 		case UniformBlock::Type::Storage:
@@ -82,6 +95,15 @@ void Shader::CreateReflection()
 			descriptorType = uniform.m_writeOnly ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 			m_descriptorSetLayouts.emplace_back(ImageCube::GetDescriptorSetLayout(static_cast<uint32_t>(uniform.m_binding), descriptorType, uniform.m_stageFlags, 1));
 			break;
+		case GL_SUBPASS_INPUT:
+			descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+			m_descriptorSetLayouts.emplace_back(Image2d::GetDescriptorSetLayout(static_cast<uint32_t>(uniform.m_binding), descriptorType, uniform.m_stageFlags, 1));
+			break;
+		case GL_ACCELERATION_STRUCTURE:
+			descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+			m_descriptorSetLayouts.emplace_back(AccelerationStructure::GetDescriptorSetLayout(static_cast<uint32_t>(uniform.m_binding), descriptorType,
+				uniform.m_stageFlags, 1));
+			break;
 		default:
 			break;
 		}
@@ -100,7 +122,7 @@ void Shader::CreateReflection()
 	}
 
 	// FIXME: This is a AMD workaround that works on Nvidia too...
-	m_descriptorPools = std::vector<VkDescriptorPoolSize>(6);
+	m_descriptorPools = std::vector<VkDescriptorPoolSize>(8);
 	m_descriptorPools[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	m_descriptorPools[0].descriptorCount = 4096;
 	m_descriptorPools[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -113,6 +135,18 @@ void Shader::CreateReflection()
 	m_descriptorPools[4].descriptorCount = 2048;
 	m_descriptorPools[5].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 	m_descriptorPools[5].descriptorCount = 2048;
+	m_descriptorPools[6].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	m_descriptorPools[6].descriptorCount = 2048;
+	m_descriptorPools[7].type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+	m_descriptorPools[7].descriptorCount = 2048;
+
+	if (Graphics::Get()->GetLogicalDevice()->IsRayQuery())
+	{
+		VkDescriptorPoolSize descriptorPoolSize = {};
+		descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+		descriptorPoolSize.descriptorCount = 256;
+		m_descriptorPools.emplace_back(descriptorPoolSize);
+	}
 
 	// Sort descriptors by binding.
 	std::sort(m_descriptorSetLayouts.begin(), m_descriptorSetLayouts.end(), [](const VkDescriptorSetLayoutBinding &l, const VkDescriptorSetLayoutBinding &r)
@@ -132,6 +166,24 @@ void Shader::CreateReflection()
 		m_descriptorTypes.emplace(descriptor.binding, descriptor.descriptorType);
 	}
 
+	// Resolves the ids of descriptors and uniforms, so handlers find them by hash.
+	for (const auto &[descriptorName, location] : m_descriptorLocations)
+	{
+		m_descriptorLocationIds.emplace(UniformId::Hash(descriptorName), location);
+	}
+
+	for (auto &[uniformBlockName, uniformBlock] : m_uniformBlocks)
+	{
+		uniformBlock.m_uniformIds.clear();
+
+		for (const auto &[uniformName, uniform] : uniformBlock.m_uniforms)
+		{
+			uniformBlock.m_uniformIds.emplace(UniformId::Hash(uniformName), uniform);
+		}
+
+		m_uniformBlockIds.emplace(UniformId::Hash(uniformBlockName), uniformBlock);
+	}
+
 	// Process attribute descriptions.
 	uint32_t currentOffset = 4;
 
@@ -154,6 +206,7 @@ const Metadata &operator>>(const Metadata &metadata, Shader &shader)
 	metadata.GetChild("Uniforms", shader.m_uniforms);
 	metadata.GetChild("Uniform Blocks", shader.m_uniformBlocks);
 	metadata.GetChild("Attributes", shader.m_attributes);
+	metadata.GetChild("Bindless", shader.m_bindless);
 	//metadata.GetChild("Local Sizes", shader.m_localSizes);
 	return metadata;
 }
@@ -165,6 +218,7 @@ Metadata &operator<<(Metadata &metadata, const Shader &shader)
 	metadata.SetChild("Uniforms", shader.m_uniforms);
 	metadata.SetChild("Uniform Blocks", shader.m_uniformBlocks);
 	metadata.SetChild("Attributes", shader.m_attributes);
+	metadata.SetChild("Bindless", shader.m_bindless);
 	//metadata.SetChild("Local Sizes", shader.m_localSizes);
 	return metadata;
 }
@@ -250,6 +304,30 @@ std::optional<Shader::UniformBlock> Shader::GetUniformBlock(const std::string &n
 	return it->second;
 }
 
+std::optional<uint32_t> Shader::FindDescriptorLocation(const UniformId &id) const
+{
+	auto it = m_descriptorLocationIds.find(id.GetHash());
+
+	if (it == m_descriptorLocationIds.end())
+	{
+		return {};
+	}
+
+	return it->second;
+}
+
+const Shader::UniformBlock *Shader::FindUniformBlock(const UniformId &id) const
+{
+	auto it = m_uniformBlockIds.find(id.GetHash());
+
+	if (it == m_uniformBlockIds.end())
+	{
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
 std::optional<Shader::Attribute> Shader::GetAttribute(const std::string &name) const
 {
 	auto it = m_attributes.find(name);
@@ -325,6 +403,16 @@ VkShaderStageFlagBits Shader::GetShaderStage(const std::string &filename)
 	{
 		return VK_SHADER_STAGE_FRAGMENT_BIT;
 	}
+#if defined(VK_EXT_mesh_shader)
+	if (fileExt == ".task")
+	{
+		return VK_SHADER_STAGE_TASK_BIT_EXT;
+	}
+	if (fileExt == ".mesh")
+	{
+		return VK_SHADER_STAGE_MESH_BIT_EXT;
+	}
+#endif
 
 	return VK_SHADER_STAGE_ALL;
 }
@@ -340,19 +428,22 @@ std::string Shader::InsertDefineBlock(const std::string &shaderCode, const std::
 	return updatedCode;
 }
 
-std::string Shader::ProcessIncludes(const std::string &shaderCode)
+std::string Shader::ProcessIncludes(const std::string &shaderCode, std::vector<std::string> *includes)
 {
-	auto lines = String::Split(shaderCode, "\n", true);
-
 	std::stringstream stream;
 
-	for (const auto &line : lines)
+	// Lines are views into the shader code, only include directives are copied.
+	for (const auto &line : String::SplitView(shaderCode, "\n", true))
 	{
-		if (String::Contains(line, "#include"))
+		if (auto directive = line.find("#include"); directive != std::string_view::npos)
 		{
-			std::string filename = String::ReplaceFirst(line, "#include", "");
-			filename = String::RemoveAll(filename, '\"');
-			filename = String::Trim(filename);
+			auto filename = String::RemoveAll(std::string(line.substr(directive + 8)), '\"');
+			String::TrimInPlace(filename);
+
+			if (includes)
+			{
+				includes->emplace_back(filename);
+			}
 
 			auto fileLoaded = Files::Read(filename);
 
@@ -388,6 +479,12 @@ EShLanguage GetEshLanguage(const VkShaderStageFlags &stageFlag)
 		return EShLangGeometry;
 	case VK_SHADER_STAGE_FRAGMENT_BIT:
 		return EShLangFragment;
+#if defined(VK_EXT_mesh_shader)
+	case VK_SHADER_STAGE_TASK_BIT_EXT:
+		return EShLangTask;
+	case VK_SHADER_STAGE_MESH_BIT_EXT:
+		return EShLangMesh;
+#endif
 	default:
 		return EShLangCount;
 	}
@@ -479,6 +576,15 @@ TBuiltInResource GetResources()
 	resources.maxCullDistances = 8;
 	resources.maxCombinedClipAndCullDistances = 8;
 	resources.maxSamples = 4;
+	resources.maxMeshOutputVerticesEXT = 256;
+	resources.maxMeshOutputPrimitivesEXT = 256;
+	resources.maxMeshWorkGroupSizeX_EXT = 128;
+	resources.maxMeshWorkGroupSizeY_EXT = 128;
+	resources.maxMeshWorkGroupSizeZ_EXT = 128;
+	resources.maxTaskWorkGroupSizeX_EXT = 128;
+	resources.maxTaskWorkGroupSizeY_EXT = 128;
+	resources.maxTaskWorkGroupSizeZ_EXT = 128;
+	resources.maxMeshViewCountEXT = 4;
 	resources.limits.nonInductiveForLoops = true;
 	resources.limits.whileLoops = true;
 	resources.limits.doWhileLoops = true;
@@ -497,6 +603,93 @@ VkShaderModule Shader::CreateShaderModule(const std::string &moduleName, const s
 
 	m_stages.emplace_back(moduleName);
 
+	// The reflection of this module alone, merged into this shader once loaded or compiled.
+	Shader reflection(moduleName);
+	std::vector<uint32_t> spirv;
+	auto cachePath = GetCachePath(moduleCode, moduleFlag);
+
+	if (!LoadCache(cachePath, reflection, spirv))
+	{
+		reflection = Shader(moduleName);
+		spirv.clear();
+
+		if (!CompileSpirv(moduleCode, moduleFlag, reflection, spirv))
+		{
+			Log::Error("Shader module could not be compiled: '%s'\n", moduleName.c_str());
+			return VK_NULL_HANDLE;
+		}
+
+		SaveCache(cachePath, reflection, spirv);
+	}
+
+	MergeReflection(reflection);
+
+	VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
+	shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	shaderModuleCreateInfo.codeSize = spirv.size() * sizeof(uint32_t);
+	shaderModuleCreateInfo.pCode = spirv.data();
+
+	VkShaderModule shaderModule;
+	Graphics::CheckVk(vkCreateShaderModule(*logicalDevice, &shaderModuleCreateInfo, nullptr, &shaderModule));
+	return shaderModule;
+}
+
+std::string Shader::ToString() const
+{
+	std::stringstream stream;
+
+	if (!m_attributes.empty())
+	{
+		stream << "Vertex Attributes: \n";
+
+		for (const auto &[attributeName, attribute] : m_attributes)
+		{
+			stream << "  - " << attributeName << ": " << attribute.ToString() << "\n";
+		}
+	}
+
+	if (!m_uniforms.empty())
+	{
+		stream << "Uniforms: \n";
+
+		for (const auto &[uniformName, uniform] : m_uniforms)
+		{
+			stream << "  - " << uniformName << ": " << uniform.ToString() << "\n";
+		}
+	}
+
+	if (!m_uniformBlocks.empty())
+	{
+		stream << "Uniform Blocks: \n";
+
+		for (const auto &[uniformBlockName, uniformBlock] : m_uniformBlocks)
+		{
+			stream << "  - " << uniformBlockName << ": " << uniformBlock.ToString() << " \n";
+
+			for (const auto &[uniformName, uniform] : uniformBlock.GetUniforms())
+			{
+				stream << "	- " << uniformName << ": " << uniform.ToString() << " \n";
+			}
+		}
+	}
+
+	for (uint32_t dim = 0; dim < m_localSizes.size(); dim++)
+	{
+		static const std::string AXES[] = { "X", "Y", "Z" };
+
+		if (m_localSizes[dim])
+		{
+			stream << "Local size " << AXES[dim] << ": " << *m_localSizes[dim] << " \n";
+		}
+	}
+
+	return stream.str();
+}
+
+bool Shader::CompileSpirv(const std::string &moduleCode, const VkShaderStageFlags &moduleFlag, Shader &reflection, std::vector<uint32_t> &spirv)
+{
+	bool success = true;
+
 	// Starts converting GLSL to SPIR-V.
 	EShLanguage language = GetEshLanguage(moduleFlag);
 	glslang::TProgram program;
@@ -514,7 +707,9 @@ VkShaderModule Shader::CreateShaderModule(const std::string &moduleName, const s
 
 	shader.setEnvInput(glslang::EShSourceGlsl, language, glslang::EShClientVulkan, 110);
 	shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_1);
-	shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+	// The mesh shading and ray query extensions require SPIR-V 1.4, which devices with either support through VK_KHR_spirv_1_4.
+	auto spirv14 = language == EShLangTask || language == EShLangMesh || moduleCode.find("#define RAY_QUERY ") != std::string::npos;
+	shader.setEnvTarget(glslang::EShTargetSpv, spirv14 ? glslang::EShTargetSpv_1_4 : glslang::EShTargetSpv_1_3);
 
 	const int defaultVersion = glslang::EShTargetOpenGL_450;
 
@@ -523,6 +718,7 @@ VkShaderModule Shader::CreateShaderModule(const std::string &moduleName, const s
 		Log::Out("%s\n", shader.getInfoLog());
 		Log::Out("%s\n", shader.getInfoDebugLog());
 		Log::Error("SPRIV shader compile failed!\n");
+		success = false;
 	}
 
 	program.addShader(&shader);
@@ -530,6 +726,7 @@ VkShaderModule Shader::CreateShaderModule(const std::string &moduleName, const s
 	if (!program.link(messages) || !program.mapIO())
 	{
 		Log::Error("Error while linking shader program.\n");
+		success = false;
 	}
 
 	program.buildReflection();
@@ -541,23 +738,23 @@ VkShaderModule Shader::CreateShaderModule(const std::string &moduleName, const s
 
 		if (localSize > 1)
 		{
-			m_localSizes[dim] = localSize;
+			reflection.m_localSizes[dim] = localSize;
 		}
 	}
 
 	for (int32_t i = program.getNumLiveUniformBlocks() - 1; i >= 0; i--)
 	{
-		LoadUniformBlock(program, moduleFlag, i);
+		reflection.LoadUniformBlock(program, moduleFlag, i);
 	}
 
 	for (int32_t i = 0; i < program.getNumLiveUniformVariables(); i++)
 	{
-		LoadUniform(program, moduleFlag, i);
+		reflection.LoadUniform(program, moduleFlag, i);
 	}
 
 	for (int32_t i = 0; i < program.getNumLiveAttributes(); i++)
 	{
-		LoadVertexAttribute(program, moduleFlag, i);
+		reflection.LoadVertexAttribute(program, moduleFlag, i);
 	}
 
 	glslang::SpvOptions spvOptions;
@@ -572,69 +769,199 @@ VkShaderModule Shader::CreateShaderModule(const std::string &moduleName, const s
 #endif
 
 	spv::SpvBuildLogger logger;
-	std::vector<uint32_t> spirv;
 	GlslangToSpv(*program.getIntermediate((EShLanguage) language), spirv, &logger, &spvOptions);
+	return success;
+}
 
-	VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
-	shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-	shaderModuleCreateInfo.codeSize = spirv.size() * sizeof(uint32_t);
-	shaderModuleCreateInfo.pCode = spirv.data();
+std::string Shader::GetCachePath(const std::string &moduleCode, const VkShaderStageFlags &moduleFlag)
+{
+	// FNV-1a, stable between runs and platforms unlike std::hash.
+	uint64_t hash = 14695981039346656037ull;
 
-	VkShaderModule shaderModule;
-	Graphics::CheckVk(vkCreateShaderModule(*logicalDevice, &shaderModuleCreateInfo, nullptr, &shaderModule));
-	return shaderModule;
+	auto hashBytes = [&hash](const void *data, const std::size_t &size)
+	{
+		auto bytes = static_cast<const uint8_t *>(data);
+
+		for (std::size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	hashBytes(moduleCode.data(), moduleCode.size());
+	hashBytes(&moduleFlag, sizeof(moduleFlag));
+#if defined(ACID_VERBOSE)
+	// Verbose builds generate SPIR-V with debug info.
+	hashBytes("verbose", 7);
+#endif
+
+	std::stringstream stream;
+	stream << SHADER_CACHE_DIRECTORY << std::hex << std::setw(16) << std::setfill('0') << hash << ".spv";
+	return stream.str();
 }
 
-std::string Shader::ToString() const
+void WriteCacheString(std::ostream &stream, const std::string &string)
 {
-	std::stringstream stream;
+	auto size = static_cast<uint32_t>(string.size());
+	stream.write(reinterpret_cast<const char *>(&size), sizeof(uint32_t));
+	stream.write(string.data(), size);
+}
 
-	if (!m_attributes.empty())
+bool ReadCacheString(std::istream &stream, std::string &string)
+{
+	uint32_t size = 0;
+
+	if (!stream.read(reinterpret_cast<char *>(&size), sizeof(uint32_t)))
 	{
-		stream << "Vertex Attributes: \n";
+		return false;
+	}
 
-		for (const auto &[attributeName, attribute] : m_attributes)
+	string.resize(size);
+	return static_cast<bool>(stream.read(&string[0], size));
+}
+
+void WriteCacheMetadata(std::ostream &stream, const Metadata &metadata)
+{
+	// Uniform names can contain brackets and periods, so the tree is written raw instead of through a text format.
+	WriteCacheString(stream, metadata.GetName());
+	WriteCacheString(stream, metadata.GetValue());
+	auto childCount = metadata.GetChildCount();
+	stream.write(reinterpret_cast<const char *>(&childCount), sizeof(uint32_t));
+
+	for (const auto &child : metadata.GetChildren())
+	{
+		WriteCacheMetadata(stream, *child);
+	}
+}
+
+bool ReadCacheMetadata(std::istream &stream, Metadata &metadata)
+{
+	std::string name, value;
+	uint32_t childCount = 0;
+
+	if (!ReadCacheString(stream, name) || !ReadCacheString(stream, value) || !stream.read(reinterpret_cast<char *>(&childCount), sizeof(uint32_t)))
+	{
+		return false;
+	}
+
+	metadata.SetName(name);
+	metadata.SetValue(value);
+
+	for (uint32_t i = 0; i < childCount; i++)
+	{
+		if (!ReadCacheMetadata(stream, *metadata.AddChild(new Metadata())))
 		{
-			stream << "  - " << attributeName << ": " << attribute.ToString() << "\n";
+			return false;
 		}
 	}
 
-	if (!m_uniforms.empty())
+	return true;
+}
+
+bool Shader::LoadCache(const std::string &cachePath, Shader &reflection, std::vector<uint32_t> &spirv)
+{
+	std::ifstream inStream(cachePath, std::ios::binary);
+
+	if (!inStream.is_open())
 	{
-		stream << "Uniforms: \n";
+		return false;
+	}
 
-		for (const auto &[uniformName, uniform] : m_uniforms)
+	uint32_t version = 0;
+	inStream.read(reinterpret_cast<char *>(&version), sizeof(uint32_t));
+
+	Metadata metadata;
+
+	if (version != SHADER_CACHE_VERSION || !ReadCacheMetadata(inStream, metadata))
+	{
+		return false;
+	}
+
+	uint32_t spirvSize = 0;
+	inStream.read(reinterpret_cast<char *>(&spirvSize), sizeof(uint32_t));
+	spirv.resize(spirvSize);
+
+	if (spirvSize == 0 || !inStream.read(reinterpret_cast<char *>(spirv.data()), spirvSize * sizeof(uint32_t)))
+	{
+		spirv.clear();
+		return false;
+	}
+
+	metadata >> reflection;
+
+	std::vector<std::optional<uint32_t>> localSizes;
+	metadata.GetChild("Local Sizes", localSizes);
+
+	for (uint32_t dim = 0; dim < std::min(static_cast<uint32_t>(localSizes.size()), static_cast<uint32_t>(reflection.m_localSizes.size())); dim++)
+	{
+		reflection.m_localSizes[dim] = localSizes[dim];
+	}
+
+	return true;
+}
+
+void Shader::SaveCache(const std::string &cachePath, const Shader &reflection, const std::vector<uint32_t> &spirv)
+{
+	Metadata metadata;
+	metadata << reflection;
+	metadata.SetChild("Local Sizes", std::vector<std::optional<uint32_t>>(reflection.m_localSizes.begin(), reflection.m_localSizes.end()));
+
+	FileSystem::Create(cachePath);
+	std::ofstream outStream(cachePath, std::ios::binary | std::ios::trunc);
+
+	if (!outStream.is_open())
+	{
+		Log::Error("Could not write shader cache: '%s'\n", cachePath.c_str());
+		return;
+	}
+
+	auto spirvSize = static_cast<uint32_t>(spirv.size());
+	outStream.write(reinterpret_cast<const char *>(&SHADER_CACHE_VERSION), sizeof(uint32_t));
+	WriteCacheMetadata(outStream, metadata);
+	outStream.write(reinterpret_cast<const char *>(&spirvSize), sizeof(uint32_t));
+	outStream.write(reinterpret_cast<const char *>(spirv.data()), spirv.size() * sizeof(uint32_t));
+}
+
+void Shader::MergeReflection(const Shader &reflection)
+{
+	for (const auto &[uniformBlockName, uniformBlock] : reflection.m_uniformBlocks)
+	{
+		auto it = m_uniformBlocks.find(uniformBlockName);
+
+		if (it == m_uniformBlocks.end())
 		{
-			stream << "  - " << uniformName << ": " << uniform.ToString() << "\n";
+			m_uniformBlocks.emplace(uniformBlockName, uniformBlock);
+			continue;
 		}
+
+		it->second.m_stageFlags |= uniformBlock.m_stageFlags;
+		it->second.m_uniforms.insert(uniformBlock.m_uniforms.begin(), uniformBlock.m_uniforms.end());
 	}
 
-	if (!m_uniformBlocks.empty())
+	for (const auto &[uniformName, uniform] : reflection.m_uniforms)
 	{
-		stream << "Uniform Blocks: \n";
+		auto it = m_uniforms.find(uniformName);
 
-		for (const auto &[uniformBlockName, uniformBlock] : m_uniformBlocks)
+		if (it == m_uniforms.end())
 		{
-			stream << "  - " << uniformBlockName << ": " << uniformBlock.ToString() << " \n";
-
-			for (const auto &[uniformName, uniform] : uniformBlock.GetUniforms())
-			{
-				stream << "	- " << uniformName << ": " << uniform.ToString() << " \n";
-			}
+			m_uniforms.emplace(uniformName, uniform);
+			continue;
 		}
+
+		it->second.m_stageFlags |= uniform.m_stageFlags;
 	}
 
+	m_attributes.insert(reflection.m_attributes.begin(), reflection.m_attributes.end());
+	m_bindless |= reflection.m_bindless;
+
 	for (uint32_t dim = 0; dim < m_localSizes.size(); dim++)
 	{
-		static const std::string AXES[] = { "X", "Y", "Z" };
-
-		if (m_localSizes[dim])
+		if (reflection.m_localSizes[dim])
 		{
-			stream << "Local size " << AXES[dim] << ": " << *m_localSizes[dim] << " \n";
+			m_localSizes[dim] = reflection.m_localSizes[dim];
 		}
 	}
-
-	return stream.str();
 }
 
 void Shader::IncrementDescriptorPool(std::map<VkDescriptorType, uint32_t> &descriptorPoolCounts, const VkDescriptorType &type)
@@ -667,6 +994,13 @@ void Shader::LoadUniformBlock(const glslang::TProgram &program, const VkShaderSt
 		}
 	}
 
+	// The bindless set is shared between pipelines, so it is not reflected into the shaders descriptors.
+	if (program.getUniformBlockTType(i)->getQualifier().layoutSet == BindlessDescriptors::Set)
+	{
+		m_bindless = true;
+		return;
+	}
+
 	auto type = UniformBlock::Type::Uniform;
 
 	if (strcmp(program.getUniformBlockTType(i)->getStorageQualifierString(), "buffer") == 0)
@@ -701,9 +1035,21 @@ void Shader::LoadUniform(const glslang::TProgram &program, const VkShaderStageFl
 					return;
 				}
 			}
+
+			// A member of a block in the bindless set.
+			if (m_bindless)
+			{
+				return;
+			}
 		}
 	}
 
+	if (program.getUniformTType(i)->getQualifier().layoutSet == BindlessDescriptors::Set)
+	{
+		m_bindless = true;
+		return;
+	}
+
 	for (auto &[uniformName, uniform] : m_uniforms)
 	{
 		if (uniformName == program.getUniformName(i))
@@ -714,8 +1060,20 @@ void Shader::LoadUniform(const glslang::TProgram &program, const VkShaderStageFl
 	}
 
 	auto &qualifier = program.getUniformTType(i)->getQualifier();
+	auto glType = program.getUniformType(i);
+
+	if (program.getUniformTType(i)->getBasicType() == glslang::EbtSampler && program.getUniformTType(i)->getSampler().isSubpass())
+	{
+		glType = GL_SUBPASS_INPUT;
+	}
+
+	if (program.getUniformTType(i)->getBasicType() == glslang::EbtAccStruct)
+	{
+		glType = GL_ACCELERATION_STRUCTURE;
+	}
+
 	m_uniforms.emplace(program.getUniformName(i),
-		Uniform(program.getUniformBinding(i), program.getUniformBufferOffset(i), -1, program.getUniformType(i), qualifier.readonly, qualifier.writeonly, stageFlag));
+		Uniform(program.getUniformBinding(i), program.getUniformBufferOffset(i), -1, glType, qualifier.readonly, qualifier.writeonly, stageFlag));
 }
 
 void Shader::LoadVertexAttribute(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i)
@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.h>
 #include "Serialized/Metadata.hpp"
+#include "UniformId.hpp"
 
 namespace glslang
 {
@@ -36,15 +37,60 @@ public:
 
 		friend const Metadata &operator>>(const Metadata &metadata, VertexInput &vertexInput)
 		{
-			//metadata.GetChild("Binding Descriptions", vertexInput.m_bindingDescriptions);
-			//metadata.GetChild("Attribute Descriptions", vertexInput.m_attributeDescriptions);
+			vertexInput.m_bindingDescriptions.clear();
+			vertexInput.m_attributeDescriptions.clear();
+
+			if (auto bindingDescriptions = metadata.FindChild("Binding Descriptions", false))
+			{
+				for (const auto &child : bindingDescriptions->GetChildren())
+				{
+					VkVertexInputBindingDescription bindingDescription = {};
+					child->GetChild("Binding", bindingDescription.binding);
+					child->GetChild("Stride", bindingDescription.stride);
+					child->GetChild("Input Rate", bindingDescription.inputRate);
+					vertexInput.m_bindingDescriptions.emplace_back(bindingDescription);
+				}
+			}
+
+			if (auto attributeDescriptions = metadata.FindChild("Attribute Descriptions", false))
+			{
+				for (const auto &child : attributeDescriptions->GetChildren())
+				{
+					VkVertexInputAttributeDescription attributeDescription = {};
+					child->GetChild("Location", attributeDescription.location);
+					child->GetChild("Binding", attributeDescription.binding);
+					child->GetChild("Format", attributeDescription.format);
+					child->GetChild("Offset", attributeDescription.offset);
+					vertexInput.m_attributeDescriptions.emplace_back(attributeDescription);
+				}
+			}
+
 			return metadata;
 		}
 
 		friend Metadata &operator<<(Metadata &metadata, const VertexInput &vertexInput)
 		{
-			//metadata.SetChild("Binding Descriptions", vertexInput.m_bindingDescriptions);
-			//metadata.SetChild("Attribute Descriptions", vertexInput.m_attributeDescriptions);
+			auto bindingDescriptions = metadata.CreateChild("Binding Descriptions");
+
+			for (const auto &bindingDescription : vertexInput.m_bindingDescriptions)
+			{
+				auto child = bindingDescriptions->CreateChild();
+				child->SetChild("Binding", bindingDescription.binding);
+				child->SetChild("Stride", bindingDescription.stride);
+				child->SetChild("Input Rate", bindingDescription.inputRate);
+			}
+
+			auto attributeDescriptions = metadata.CreateChild("Attribute Descriptions");
+
+			for (const auto &attributeDescription : vertexInput.m_attributeDescriptions)
+			{
+				auto child = attributeDescriptions->CreateChild();
+				child->SetChild("Location", attributeDescription.location);
+				child->SetChild("Binding", attributeDescription.binding);
+				child->SetChild("Format", attributeDescription.format);
+				child->SetChild("Offset", attributeDescription.offset);
+			}
+
 			return metadata;
 		}
 
@@ -57,6 +103,24 @@ public:
 			return m_bindingDescriptions.front().binding < other.m_bindingDescriptions.front().binding;
 		}
 
+		bool operator==(const VertexInput &other) const
+		{
+			return std::equal(m_bindingDescriptions.begin(), m_bindingDescriptions.end(), other.m_bindingDescriptions.begin(), other.m_bindingDescriptions.end(),
+				[](const VkVertexInputBindingDescription &a, const VkVertexInputBindingDescription &b)
+			{
+				return a.binding == b.binding && a.stride == b.stride && a.inputRate == b.inputRate;
+			}) && std::equal(m_attributeDescriptions.begin(), m_attributeDescriptions.end(), other.m_attributeDescriptions.begin(), other.m_attributeDescriptions.end(),
+				[](const VkVertexInputAttributeDescription &a, const VkVertexInputAttributeDescription &b)
+			{
+				return a.location == b.location && a.binding == b.binding && a.format == b.format && a.offset == b.offset;
+			});
+		}
+
+		bool operator!=(const VertexInput &other) const
+		{
+			return !(*this == other);
+		}
+
 	private:
 		uint32_t m_binding;
 		std::vector<VkVertexInputBindingDescription> m_bindingDescriptions;
@@ -204,6 +268,23 @@ public:
 			return it->second;
 		}
 
+		/**
+		 * Finds a uniform in the block by its id, ids are resolved once the shader reflection is created.
+		 * @param id The uniform id.
+		 * @return The uniform, or null if it is not in the block.
+		 */
+		const Uniform *FindUniform(const UniformId &id) const
+		{
+			auto it = m_uniformIds.find(id.GetHash());
+
+			if (it == m_uniformIds.end())
+			{
+				return nullptr;
+			}
+
+			return &it->second;
+		}
+
 		bool operator==(const UniformBlock &other) const
 		{
 			return m_binding == other.m_binding && m_size == other.m_size && m_stageFlags == other.m_stageFlags && m_type == other.m_type && m_uniforms == other.m_uniforms;
@@ -229,6 +310,7 @@ public:
 		VkShaderStageFlags m_stageFlags;
 		Type m_type;
 		std::map<std::string, Uniform> m_uniforms;
+		std::unordered_map<uint64_t, Uniform> m_uniformIds;
 	};
 
 	class Attribute
@@ -294,7 +376,12 @@ public:
 		int32_t m_glType;
 	};
 
-	explicit Shader(std::string name);
+	/**
+	 * Creates a new shader reflection.
+	 * @param name The shader name.
+	 * @param pushDescriptors If the pipeline pushes its descriptors, uniform blocks are then plain uniform buffers since pushed descriptors can not be dynamic.
+	 */
+	explicit Shader(std::string name, const bool &pushDescriptors = false);
 
 	const std::string &GetName() const { return m_name; }
 
@@ -316,12 +403,32 @@ public:
 
 	std::optional<UniformBlock> GetUniformBlock(const std::string &name) const;
 
+	/**
+	 * Finds the binding of a descriptor by its id, without comparing names.
+	 * @param id The descriptor id.
+	 * @return The binding, if the descriptor is in this shader.
+	 */
+	std::optional<uint32_t> FindDescriptorLocation(const UniformId &id) const;
+
+	/**
+	 * Finds a uniform block by its id, without comparing names or copying the block.
+	 * @param id The uniform block id.
+	 * @return The uniform block, or null if it is not in this shader. The block is owned by this shader.
+	 */
+	const UniformBlock *FindUniformBlock(const UniformId &id) const;
+
 	std::optional<Attribute> GetAttribute(const std::string &name) const;
 
 	std::vector<VkPushConstantRange> GetPushConstantRanges() const;
 
 	const uint32_t &GetLastDescriptorBinding() const { return m_lastDescriptorBinding; }
 
+	/**
+	 * Gets if the shader declares descriptors in the bindless set, these are not part of the shaders own descriptor set.
+	 * @return If the shader reads the bindless set.
+	 */
+	const bool &IsBindless() const { return m_bindless; }
+
 	const std::map<std::string, Uniform> &GetUniforms() const { return m_uniforms; };
 
 	const std::map<std::string, UniformBlock> &GetUniformBlocks() const { return m_uniformBlocks; };
@@ -342,8 +449,21 @@ public:
 
 	static std::string InsertDefineBlock(const std::string &shaderCode, const std::string &blockCode);
 
-	static std::string ProcessIncludes(const std::string &shaderCode);
+	/**
+	 * Replaces the include lines of a shader with the files they include.
+	 * @param shaderCode The shader code.
+	 * @param includes If not null, the files included are added to this.
+	 * @return The shader code with includes replaced.
+	 */
+	static std::string ProcessIncludes(const std::string &shaderCode, std::vector<std::string> *includes = nullptr);
 
+	/**
+	 * Creates a shader module and merges its reflection into this shader.
+	 * @param moduleName The name of the module, the stage filename.
+	 * @param moduleCode The processed shader code.
+	 * @param moduleFlag The stage of the module.
+	 * @return The shader module, or null if the code did not compile.
+	 */
 	VkShaderModule CreateShaderModule(const std::string &moduleName, const std::string &moduleCode, const VkShaderStageFlags &moduleFlag);
 
 	std::string ToString() const;
@@ -351,6 +471,16 @@ public:
 private:
 	static void IncrementDescriptorPool(std::map<VkDescriptorType, uint32_t> &descriptorPoolCounts, const VkDescriptorType &type);
 
+	static bool CompileSpirv(const std::string &moduleCode, const VkShaderStageFlags &moduleFlag, Shader &reflection, std::vector<uint32_t> &spirv);
+
+	static std::string GetCachePath(const std::string &moduleCode, const VkShaderStageFlags &moduleFlag);
+
+	static bool LoadCache(const std::string &cachePath, Shader &reflection, std::vector<uint32_t> &spirv);
+
+	static void SaveCache(const std::string &cachePath, const Shader &reflection, const std::vector<uint32_t> &spirv);
+
+	void MergeReflection(const Shader &reflection);
+
 	void LoadUniformBlock(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i);
 
 	void LoadUniform(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i);
@@ -360,6 +490,8 @@ private:
 	static int32_t ComputeSize(const glslang::TType *ttype);
 
 	std::string m_name;
+	bool m_pushDescriptors;
+	bool m_bindless;
 	std::vector<std::string> m_stages;
 	std::map<std::string, Uniform> m_uniforms;
 	std::map<std::string, UniformBlock> m_uniformBlocks;
@@ -369,6 +501,9 @@ private:
 
 	std::map<std::string, uint32_t> m_descriptorLocations;
 	std::map<std::string, uint32_t> m_descriptorSizes;
+	// Reflected values by the hash of their name, created with the reflection.
+	std::unordered_map<uint64_t, uint32_t> m_descriptorLocationIds;
+	std::unordered_map<uint64_t, UniformBlock> m_uniformBlockIds;
 
 	std::vector<VkDescriptorSetLayoutBinding> m_descriptorSetLayouts;
 	uint32_t m_lastDescriptorBinding;
@@ -0,0 +1,313 @@
+#include "ShaderReloader.hpp"
+
+#include "Engine/Engine.hpp"
+#include "Files/Files.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Helpers/String.hpp"
+#include "PipelineGraphics.hpp"
+
+namespace acid
+{
+ShaderReloader::~ShaderReloader()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	// Watchers are stopped first so no changes are queued while destroying.
+	m_watchers.clear();
+
+	for (auto &[pipeline, compiling] : m_compiling)
+	{
+		Destroy(compiling.get().m_modules);
+	}
+
+	for (const auto &retired : m_retired)
+	{
+		vkDestroyPipeline(*logicalDevice, retired.m_pipeline, nullptr);
+
+		for (const auto &shaderModule : retired.m_modules)
+		{
+			vkDestroyShaderModule(*logicalDevice, shaderModule, nullptr);
+		}
+	}
+}
+
+void ShaderReloader::Update()
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto frameCount = Graphics::Get()->GetFrameCount();
+	auto framesInFlight = Graphics::Get()->GetFramesInFlight();
+
+	// Pipelines swapped out are destroyed once no frame in flight can be using them.
+	for (auto it = m_retired.begin(); it != m_retired.end();)
+	{
+		if (it->m_frame + framesInFlight >= frameCount)
+		{
+			++it;
+			continue;
+		}
+
+		vkDestroyPipeline(*logicalDevice, it->m_pipeline, nullptr);
+
+		for (const auto &shaderModule : it->m_modules)
+		{
+			vkDestroyShaderModule(*logicalDevice, shaderModule, nullptr);
+		}
+
+		it = m_retired.erase(it);
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for (auto it = m_compiling.begin(); it != m_compiling.end();)
+	{
+		if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			++it;
+			continue;
+		}
+
+		auto pipeline = it->first;
+		auto compiled = it->second.get();
+		it = m_compiling.erase(it);
+
+		// The pipeline may have been destroyed while its stages were compiling.
+		if (m_pipelines.find(pipeline) == m_pipelines.end() || !compiled.m_compatible)
+		{
+			Destroy(compiled.m_modules);
+			continue;
+		}
+
+		Swap(pipeline, compiled);
+	}
+
+	if (m_changed.empty())
+	{
+		return;
+	}
+
+	std::set<std::string> changed;
+	std::swap(changed, m_changed);
+
+	for (const auto &pipeline : m_pipelines)
+	{
+		std::vector<std::size_t> indices;
+		std::vector<std::string> files;
+
+		for (std::size_t i = 0; i < pipeline->m_shaderStages.size(); i++)
+		{
+			auto uses = [&changed, &files](const std::string &filename)
+			{
+				if (changed.find(filename) == changed.end())
+				{
+					return false;
+				}
+
+				files.emplace_back(filename);
+				return true;
+			};
+
+			auto &includes = pipeline->m_stageIncludes[i];
+			auto stageChanged = uses(pipeline->m_shaderStages[i]);
+
+			for (const auto &include : includes)
+			{
+				stageChanged |= uses(include);
+			}
+
+			if (stageChanged)
+			{
+				indices.emplace_back(i);
+			}
+		}
+
+		if (indices.empty())
+		{
+			continue;
+		}
+
+		// A pipeline is compiled once at a time, so older stages are never swapped in after newer stages, the changes wait for the next update.
+		if (std::any_of(m_compiling.begin(), m_compiling.end(), [pipeline](const auto &compiling) { return compiling.first == pipeline; }))
+		{
+			m_changed.insert(files.begin(), files.end());
+			continue;
+		}
+
+		m_compiling.emplace_back(pipeline, Compile(pipeline, indices));
+	}
+}
+
+void ShaderReloader::Watch(const std::string &path)
+{
+	auto root = String::ReplaceAll(path, "\\", "/");
+
+	if (!root.empty() && root.back() != '/')
+	{
+		root += '/';
+	}
+
+	auto &watcher = m_watchers.emplace_back(std::make_unique<FileWatcher>(path, Time::Seconds(1.0f)));
+	watcher->OnChange().Add([this, root](std::string filename, FileWatcher::Status status)
+	{
+		if (status == FileWatcher::Status::Erased)
+		{
+			return;
+		}
+
+		// Stages are loaded by their path relative to a search path, with forward slashes on every platform.
+		filename = String::ReplaceAll(filename, "\\", "/");
+
+		if (String::StartsWith(filename, root))
+		{
+			filename = filename.substr(root.size());
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_changed.emplace(filename);
+	});
+}
+
+void ShaderReloader::Add(PipelineGraphics *pipeline)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_pipelines.emplace(pipeline);
+}
+
+void ShaderReloader::Remove(PipelineGraphics *pipeline)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_pipelines.erase(pipeline);
+}
+
+std::future<ShaderReloader::Compiled> ShaderReloader::Compile(PipelineGraphics *pipeline, const std::vector<std::size_t> &indices) const
+{
+	// Everything read from the pipeline is copied, the pipeline may be destroyed before the stages have compiled.
+	std::vector<std::string> shaderStages;
+
+	for (const auto &index : indices)
+	{
+		shaderStages.emplace_back(pipeline->m_shaderStages[index]);
+	}
+
+	return Engine::Get()->GetThreadPool().Enqueue([indices, shaderStages = std::move(shaderStages), defineBlock = PipelineGraphics::GetDefineBlock(pipeline->m_defines),
+		pushDescriptors = pipeline->m_pushDescriptors, uniforms = pipeline->m_shader->GetUniforms(), uniformBlocks = pipeline->m_shader->GetUniformBlocks()]()
+	{
+		Compiled compiled = {};
+		compiled.m_compatible = true;
+
+		// Reflection of the recompiled stages alone, compared against the reflection the pipeline layout was created from.
+		Shader reflection(shaderStages.back(), pushDescriptors);
+
+		for (std::size_t i = 0; i < shaderStages.size(); i++)
+		{
+			auto fileLoaded = Files::Read(shaderStages[i]);
+
+			if (!fileLoaded)
+			{
+				Log::Error("Shader Stage could not be reloaded: '%s'\n", shaderStages[i].c_str());
+				compiled.m_compatible = false;
+				break;
+			}
+
+			Module module = {};
+			module.m_index = indices[i];
+
+			auto shaderCode = Shader::InsertDefineBlock(*fileLoaded, defineBlock);
+			shaderCode = Shader::ProcessIncludes(shaderCode, &module.m_includes);
+			module.m_module = reflection.CreateShaderModule(shaderStages[i], shaderCode, Shader::GetShaderStage(shaderStages[i]));
+
+			if (module.m_module == VK_NULL_HANDLE)
+			{
+				compiled.m_compatible = false;
+				break;
+			}
+
+			compiled.m_modules.emplace_back(std::move(module));
+		}
+
+		if (compiled.m_compatible && !IsCompatible(reflection, uniforms, uniformBlocks))
+		{
+			Log::Warning("Shader Stage '%s' changed the pipeline layout, it is reloaded when the pipeline is created again\n", shaderStages.back().c_str());
+			compiled.m_compatible = false;
+		}
+
+		return compiled;
+	});
+}
+
+bool ShaderReloader::IsCompatible(const Shader &reflection, const std::map<std::string, Shader::Uniform> &uniforms,
+	const std::map<std::string, Shader::UniformBlock> &uniformBlocks)
+{
+	// Resources are matched by name, and must be in the same binding with the same layout and be visible to the stages now using them.
+	auto sameUniform = [](const Shader::Uniform &a, const Shader::Uniform &b)
+	{
+		return a.GetBinding() == b.GetBinding() && a.GetOffset() == b.GetOffset() && a.GetSize() == b.GetSize() && a.GetGlType() == b.GetGlType() &&
+			(b.GetStageFlags() & a.GetStageFlags()) == a.GetStageFlags();
+	};
+
+	for (const auto &[uniformName, uniform] : reflection.GetUniforms())
+	{
+		auto it = uniforms.find(uniformName);
+
+		if (it == uniforms.end() || !sameUniform(uniform, it->second))
+		{
+			return false;
+		}
+	}
+
+	for (const auto &[uniformBlockName, uniformBlock] : reflection.GetUniformBlocks())
+	{
+		auto it = uniformBlocks.find(uniformBlockName);
+
+		if (it == uniformBlocks.end() || uniformBlock.GetBinding() != it->second.GetBinding() || uniformBlock.GetSize() != it->second.GetSize() ||
+			uniformBlock.GetType() != it->second.GetType() || (it->second.GetStageFlags() & uniformBlock.GetStageFlags()) != uniformBlock.GetStageFlags())
+		{
+			return false;
+		}
+
+		for (const auto &[uniformName, uniform] : uniformBlock.GetUniforms())
+		{
+			auto blockUniform = it->second.GetUniform(uniformName);
+
+			if (!blockUniform || uniform.GetOffset() != blockUniform->GetOffset() || uniform.GetSize() != blockUniform->GetSize())
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void ShaderReloader::Swap(PipelineGraphics *pipeline, Compiled &compiled)
+{
+	Retired retired = {};
+	retired.m_pipeline = pipeline->m_pipeline;
+	retired.m_frame = Graphics::Get()->GetFrameCount();
+
+	for (auto &module : compiled.m_modules)
+	{
+		retired.m_modules.emplace_back(pipeline->m_modules[module.m_index]);
+		pipeline->m_modules[module.m_index] = module.m_module;
+		pipeline->m_stages[module.m_index].module = module.m_module;
+		pipeline->m_stageIncludes[module.m_index] = std::move(module.m_includes);
+	}
+
+	// The layout and fixed function state are unchanged, only the pipeline object is created again with the new stages.
+	pipeline->CreatePipelineMode();
+	m_retired.emplace_back(std::move(retired));
+
+#if defined(ACID_VERBOSE)
+	Log::Out("Pipeline graphics '%s' reloaded %zu stages\n", pipeline->m_shaderStages.back().c_str(), compiled.m_modules.size());
+#endif
+}
+
+void ShaderReloader::Destroy(const std::vector<Module> &modules)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	for (const auto &module : modules)
+	{
+		vkDestroyShaderModule(*logicalDevice, module.m_module, nullptr);
+	}
+}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <future>
+#include <mutex>
+#include <set>
+#include "Files/FileWatcher.hpp"
+#include "Helpers/NonCopyable.hpp"
+#include "Shader.hpp"
+
+namespace acid
+{
+class PipelineGraphics;
+
+/**
+ * @brief Rebuilds the graphics pipelines that use a shader file when it changes on disk.
+ * Only the stages that load or include a changed file are compiled again, on the thread pool, the other stages keep their modules.
+ * The new pipeline object is swapped in before a frame is recorded, so render stages, layouts and descriptor sets are kept.
+ * A stage that would change the descriptors or push constants of the pipeline is not reloaded.
+ */
+class ACID_EXPORT ShaderReloader :
+	public NonCopyable
+{
+public:
+	ShaderReloader() = default;
+
+	~ShaderReloader();
+
+	/**
+	 * Swaps in the stages compiled since the last update, and starts compiling the stages of pipelines using files changed since then.
+	 */
+	void Update();
+
+	/**
+	 * Watches a directory on disk for shader changes, changed files are matched to the filenames stages were loaded with relative to this directory.
+	 * @param path The directory, such as a search path added to Files.
+	 */
+	void Watch(const std::string &path);
+
+	/**
+	 * Adds a pipeline to be reloaded, called by the pipeline once it is created.
+	 * @param pipeline The pipeline.
+	 */
+	void Add(PipelineGraphics *pipeline);
+
+	/**
+	 * Removes a pipeline, called by the pipeline when it is destroyed.
+	 * @param pipeline The pipeline.
+	 */
+	void Remove(PipelineGraphics *pipeline);
+
+private:
+	class Module
+	{
+	public:
+		std::size_t m_index;
+		VkShaderModule m_module;
+		std::vector<std::string> m_includes;
+	};
+
+	class Compiled
+	{
+	public:
+		std::vector<Module> m_modules;
+		bool m_compatible;
+	};
+
+	class Retired
+	{
+	public:
+		VkPipeline m_pipeline;
+		std::vector<VkShaderModule> m_modules;
+		uint64_t m_frame;
+	};
+
+	std::future<Compiled> Compile(PipelineGraphics *pipeline, const std::vector<std::size_t> &indices) const;
+
+	/**
+	 * Gets if the reflection of recompiled stages can use the layout a pipeline was created with.
+	 * @param reflection The reflection of the recompiled stages.
+	 * @param uniforms The uniforms of the pipeline.
+	 * @param uniformBlocks The uniform blocks of the pipeline.
+	 * @return If the stages are compatible.
+	 */
+	static bool IsCompatible(const Shader &reflection, const std::map<std::string, Shader::Uniform> &uniforms,
+		const std::map<std::string, Shader::UniformBlock> &uniformBlocks);
+
+	void Swap(PipelineGraphics *pipeline, Compiled &compiled);
+
+	static void Destroy(const std::vector<Module> &modules);
+
+	std::vector<std::unique_ptr<FileWatcher>> m_watchers;
+
+	std::mutex m_mutex;
+	std::set<std::string> m_changed;
+	std::set<PipelineGraphics *> m_pipelines;
+
+	std::vector<std::pair<PipelineGraphics *, std::future<Compiled>>> m_compiling;
+	std::vector<Retired> m_retired;
+};
+}
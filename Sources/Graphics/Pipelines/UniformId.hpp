@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string_view>
+#include "StdAfx.hpp"
+
+namespace acid
+{
+/**
+ * @brief A name of a uniform, uniform block or descriptor in a shader with its hash, shaders find reflected values by the hash without comparing strings.
+ * Ids made from string literals are hashed at compile time when declared constexpr, such as {@code static constexpr UniformId ModelMatrix = "modelMatrix";}.
+ * The name is only kept for error messages, and is valid for as long as the string the id was made from.
+ */
+class ACID_EXPORT UniformId
+{
+public:
+	constexpr UniformId(const std::string_view &name) :
+		m_name(name),
+		m_hash(Hash(name))
+	{
+	}
+
+	constexpr UniformId(const char *name) :
+		UniformId(std::string_view(name))
+	{
+	}
+
+	UniformId(const std::string &name) :
+		UniformId(std::string_view(name))
+	{
+	}
+
+	/**
+	 * Hashes a name with 64 bit FNV-1a.
+	 * @param name The name.
+	 * @return The hash.
+	 */
+	static constexpr uint64_t Hash(const std::string_view &name)
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+
+		for (const auto &c : name)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001b3;
+		}
+
+		return hash;
+	}
+
+	constexpr const std::string_view &GetName() const { return m_name; }
+
+	constexpr const uint64_t &GetHash() const { return m_hash; }
+
+	constexpr bool operator==(const UniformId &other) const { return m_hash == other.m_hash; }
+
+	constexpr bool operator!=(const UniformId &other) const { return !(*this == other); }
+
+private:
+	std::string_view m_name;
+	uint64_t m_hash;
+};
+}
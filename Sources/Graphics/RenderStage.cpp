@@ -1,6 +1,5 @@
 #include "RenderStage.hpp"
 
-#include "Devices/Window.hpp"
 #include "Graphics.hpp"
 
 namespace acid
@@ -16,6 +15,9 @@ RenderStage::RenderStage(std::vector<Attachment> images, std::vector<SubpassType
 	m_depthAttachment({}),
 	m_swapchainAttachment({}),
 	m_subpassMultisampled(m_subpasses.size()),
+	m_swapchain(nullptr),
+	m_depthPrepass(false),
+	m_viewCount(1),
 	m_outOfDate(false)
 {
 	for (const auto &image : m_attachments)
@@ -51,6 +53,8 @@ RenderStage::RenderStage(std::vector<Attachment> images, std::vector<SubpassType
 			clearValue.color = {{ image.GetClearColour().m_r, image.GetClearColour().m_g, image.GetClearColour().m_b, image.GetClearColour().m_a }};
 			m_swapchainAttachment = image;
 			break;
+		case Attachment::Type::ShadingRate:
+			break;
 		}
 
 		m_clearValues.emplace_back(clearValue);
@@ -69,13 +73,14 @@ void RenderStage::Update()
 	}
 	else
 	{
-		m_renderArea.SetExtent(m_viewport.GetScale() * Window::Get()->GetSize());
+		m_renderArea.SetExtent(m_viewport.GetScale() * Graphics::Get()->GetDisplaySize());
 	}
 
 	m_renderArea.SetAspectRatio(static_cast<float>(m_renderArea.GetExtent().m_x) / static_cast<float>(m_renderArea.GetExtent().m_y));
 	m_renderArea.SetExtent(m_renderArea.GetExtent() + m_renderArea.GetOffset());
 
-	m_outOfDate = m_renderArea != lastRenderArea;
+	m_outOfDate = m_renderArea != lastRenderArea || (m_swapchainAttachment && m_swapchain != Graphics::Get()->GetSwapchain()) ||
+		(m_renderpass && m_renderpass->GetViewCount() != m_viewCount);
 }
 
 void RenderStage::Rebuild(const Swapchain &swapchain)
@@ -86,22 +91,27 @@ void RenderStage::Rebuild(const Swapchain &swapchain)
 
 	Update();
 
-	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
-	auto surface = Graphics::Get()->GetSurface();
+	auto graphics = Graphics::Get();
+	auto physicalDevice = graphics->GetPhysicalDevice();
+	auto surface = graphics->GetSurface();
 
 	auto msaaSamples = physicalDevice->GetMsaaSamples();
 
-	if (m_depthAttachment)
+	// Replaced objects may still be used by frames in flight, they are retired instead of destroyed. Attachments that kept their size are not created again.
+	if (m_depthAttachment && (m_depthStencil == nullptr || m_depthStencil->GetExtent() != m_renderArea.GetExtent() || m_depthStencil->GetArrayLayers() != m_viewCount))
 	{
-		m_depthStencil = std::make_unique<ImageDepth>(m_renderArea.GetExtent(), m_depthAttachment->IsMultisampled() ? msaaSamples : VK_SAMPLE_COUNT_1_BIT);
+		graphics->Retire(std::move(m_depthStencil));
+		m_depthStencil = std::make_unique<ImageDepth>(m_renderArea.GetExtent(), m_depthAttachment->IsMultisampled() ? msaaSamples : VK_SAMPLE_COUNT_1_BIT, m_viewCount);
 	}
 
-	if (m_renderpass == nullptr)
-	{
-		m_renderpass = std::make_unique<Renderpass>(*this, m_depthStencil->GetFormat(), surface->GetFormat().format, msaaSamples);
-	}
+	// Store operations follow the attachment lifetimes planned by the render graph, they do not change compatibility so pipelines stay valid.
+	graphics->Retire(std::move(m_renderpass));
+	m_renderpass = std::make_unique<Renderpass>(*this, m_depthStencil->GetFormat(), surface->GetFormat().format, msaaSamples);
 
-	m_framebuffers = std::make_unique<Framebuffers>(m_renderArea.GetExtent(), *this, *m_renderpass, swapchain, *m_depthStencil, msaaSamples);
+	auto framebuffers = std::make_unique<Framebuffers>(m_renderArea.GetExtent(), *this, *m_renderpass, swapchain, *m_depthStencil, msaaSamples, m_framebuffers.get());
+	graphics->Retire(std::move(m_framebuffers));
+	m_framebuffers = std::move(framebuffers);
+	m_swapchain = &swapchain;
 	m_outOfDate = false;
 
 	m_descriptors.clear();
@@ -154,6 +164,73 @@ std::optional<Attachment> RenderStage::GetAttachment(const uint32_t &binding) co
 	return *it;
 }
 
+bool RenderStage::IsInputAttachment(const uint32_t &binding) const
+{
+	return std::any_of(m_subpasses.begin(), m_subpasses.end(), [binding](const SubpassType &subpass)
+	{
+		auto &inputBindings = subpass.GetInputAttachmentBindings();
+		return std::find(inputBindings.begin(), inputBindings.end(), binding) != inputBindings.end();
+	});
+}
+
+std::optional<uint32_t> RenderStage::GetEntityLocation(const uint32_t &subpass) const
+{
+	auto entity = GetAttachment(EntityAttachment);
+
+	if (!entity || entity->GetType() != Attachment::Type::Image || subpass >= m_subpasses.size())
+	{
+		return std::nullopt;
+	}
+
+	// Colour locations follow the order of the subpass bindings, skipping the depth and shading rate attachments like the renderpass does.
+	uint32_t location = 0;
+
+	for (const auto &binding : m_subpasses[subpass].GetAttachmentBindings())
+	{
+		auto attachment = GetAttachment(binding);
+
+		if (!attachment || attachment->GetType() == Attachment::Type::Depth || attachment->GetType() == Attachment::Type::ShadingRate)
+		{
+			continue;
+		}
+
+		if (binding == entity->GetBinding())
+		{
+			return location;
+		}
+
+		location++;
+	}
+
+	return std::nullopt;
+}
+
+void RenderStage::SetViewCount(const uint32_t &viewCount)
+{
+	// Swapchain images have a single layer.
+	if (viewCount > 1 && HasSwapchain())
+	{
+		Log::Warning("Render stages drawing to the swapchain can only draw one view\n");
+		m_viewCount = 1;
+		return;
+	}
+
+	auto maxViewCount = Graphics::Get()->GetLogicalDevice()->GetMaxViewCount();
+
+	if (viewCount > maxViewCount)
+	{
+		Log::Warning("Render stage view count %i is more than the device supports, %i views are drawn\n", viewCount, maxViewCount);
+	}
+
+	m_viewCount = std::clamp(viewCount, 1u, maxViewCount);
+}
+
+bool RenderStage::IsCompactGBuffer() const
+{
+	auto normal = GetAttachment("normal");
+	return normal && normal->GetFormat() == VK_FORMAT_A2B10G10R10_UNORM_PACK32 && HasDepth() && !GetAttachment("position");
+}
+
 const Descriptor *RenderStage::GetDescriptor(const std::string &name) const
 {
 	auto it = m_descriptors.find(name);
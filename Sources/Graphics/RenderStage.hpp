@@ -16,9 +16,13 @@ namespace acid
 class ACID_EXPORT Attachment
 {
 public:
+	/**
+	 * A shading rate attachment is not drawn to, subpasses it is bound to read the rate each region is shaded at from it,
+	 * it is written before the render stage by {@link PipelineShadingRate}.
+	 */
 	enum class Type
 	{
-		Image, Depth, Swapchain
+		Image, Depth, Swapchain, ShadingRate
 	};
 
 	/**
@@ -27,17 +31,19 @@ public:
 	 * @param name The unique name given to the object for all renderpasses.
 	 * @param type The attachment type this represents.
 	 * @param multisampled If this attachment is multisampled.
-	 * @param format The format that will be created (only applies to type ATTACHMENT_IMAGE).
+	 * @param format The format that will be created (only applies to type ATTACHMENT_IMAGE, shading rate attachments are always VK_FORMAT_R8_UINT).
 	 * @param clearColour The colour to clear to before rendering to it.
+	 * @param preserved If the contents of the attachment are kept between frames instead of being cleared (only applies to type ATTACHMENT_IMAGE).
 	 */
 	Attachment(const uint32_t &binding, std::string name, const Type &type, const bool &multisampled = false, const VkFormat &format = VK_FORMAT_R8G8B8A8_UNORM,
-		const Colour &clearColour = Colour::Black) :
+		const Colour &clearColour = Colour::Black, const bool &preserved = false) :
 		m_binding(binding),
 		m_name(std::move(name)),
 		m_type(type),
 		m_multisampled(multisampled),
 		m_format(format),
-		m_clearColour(clearColour)
+		m_clearColour(clearColour),
+		m_preserved(preserved)
 	{
 	}
 
@@ -53,6 +59,8 @@ public:
 
 	const Colour &GetClearColour() const { return m_clearColour; }
 
+	const bool &IsPreserved() const { return m_preserved; }
+
 private:
 	uint32_t m_binding;
 	std::string m_name;
@@ -60,14 +68,26 @@ private:
 	bool m_multisampled;
 	VkFormat m_format;
 	Colour m_clearColour;
+	bool m_preserved;
 };
 
+/**
+ * @brief Class that represents a subpass in a renderpass.
+ */
 class ACID_EXPORT SubpassType
 {
 public:
-	SubpassType(const uint32_t &binding, std::vector<uint32_t> attachmentBindings) :
+	/**
+	 * Creates a new subpass.
+	 * @param binding The index of the subpass in the renderpass.
+	 * @param attachmentBindings The attachments drawn to by the subpass.
+	 * @param inputAttachmentBindings The attachments drawn to by earlier subpasses that are read as input attachments, in the order of their input attachment indices.
+	 * Input attachments are read from tile memory on tile based GPUs, and attachments that are only read this way are never stored.
+	 */
+	SubpassType(const uint32_t &binding, std::vector<uint32_t> attachmentBindings, std::vector<uint32_t> inputAttachmentBindings = {}) :
 		m_binding(binding),
-		m_attachmentBindings(std::move(attachmentBindings))
+		m_attachmentBindings(std::move(attachmentBindings)),
+		m_inputAttachmentBindings(std::move(inputAttachmentBindings))
 	{
 	}
 
@@ -75,9 +95,12 @@ public:
 
 	const std::vector<uint32_t> &GetAttachmentBindings() const { return m_attachmentBindings; }
 
+	const std::vector<uint32_t> &GetInputAttachmentBindings() const { return m_inputAttachmentBindings; }
+
 private:
 	uint32_t m_binding;
 	std::vector<uint32_t> m_attachmentBindings;
+	std::vector<uint32_t> m_inputAttachmentBindings;
 };
 
 class ACID_EXPORT RenderArea
@@ -159,6 +182,9 @@ private:
 class ACID_EXPORT RenderStage
 {
 public:
+	/// The name of the attachment entity handles are written to, a {@code VK_FORMAT_R32G32_UINT} image holding the slot index and generation of the entity drawn at each pixel.
+	static constexpr const char *EntityAttachment = "entity";
+
 	explicit RenderStage(std::vector<Attachment> images = {}, std::vector<SubpassType> subpasses = {}, const Viewport &viewport = Viewport());
 
 	void Update();
@@ -184,8 +210,8 @@ public:
 	const RenderArea &GetRenderArea() const { return m_renderArea; }
 
 	/**
-	 * Gets if the width or height has changed between the last update and now.
-	 * @return If the width or height has changed.
+	 * Gets if the width or height has changed between the last update and now, or if a stage drawing to the swapchain was built for a swapchain since replaced.
+	 * @return If the stage should be rebuilt.
 	 */
 	const bool &IsOutOfDate() const { return m_outOfDate; }
 
@@ -209,6 +235,58 @@ public:
 
 	bool IsMultisampled(const uint32_t &subpass) const { return m_subpassMultisampled[subpass]; }
 
+	/**
+	 * Gets if a attachment is read as a input attachment by any subpass.
+	 * @param binding The attachment binding.
+	 * @return If the attachment is a input attachment.
+	 */
+	bool IsInputAttachment(const uint32_t &binding) const;
+
+	/**
+	 * Gets the colour location the entity attachment is drawn to in a subpass, Mrt pipelines of the subpass are created with the define {@code ENTITY_ID} set to it.
+	 * Fragments that write no entity are left as the cleared null handle, so {@link EntityPicker} finds nothing there.
+	 * @param subpass The subpass index.
+	 * @return The colour location, or none if the subpass does not draw to the entity attachment.
+	 */
+	std::optional<uint32_t> GetEntityLocation(const uint32_t &subpass) const;
+
+	/**
+	 * Gets if the stage uses the compact G-buffer, a "normal" attachment in {@code VK_FORMAT_A2B10G10R10_UNORM_PACK32} with a depth attachment and no "position" attachment.
+	 * Pipelines of the stage are created with the define {@code COMPACT_GBUFFER}, materials then store octahedral normals with metallic and the material flags,
+	 * roughness in the diffuse alpha, and shaders reading the G-buffer reconstruct positions from depth.
+	 * @return If the G-buffer is compact.
+	 */
+	bool IsCompactGBuffer() const;
+
+	/**
+	 * Gets if the depth attachment is laid down by a {@link SubrenderDepth} before the materials of the stage are drawn.
+	 * Material pipelines created with {@code PipelineGraphics::Depth::Prepass} then only shade pixels whose depth equals the pre-pass, and do not write depth.
+	 * @return If the stage has a depth pre-pass.
+	 */
+	const bool &IsDepthPrepass() const { return m_depthPrepass; }
+
+	/**
+	 * Sets if the stage has a depth pre-pass, material pipelines of the stage are compiled again the next time they are bound.
+	 * The old pipelines are destroyed when that happens, so this should be changed while no frame is in flight.
+	 * @param depthPrepass If the stage has a depth pre-pass.
+	 */
+	void SetDepthPrepass(const bool &depthPrepass) { m_depthPrepass = depthPrepass; }
+
+	/**
+	 * Gets the number of views the stage draws in one pass with multiview, such as two for the eyes of a stereo display.
+	 * Attachments of the stage are then image arrays with a layer for each view, and its pipelines are created with the define {@code MULTIVIEW} set to the view count.
+	 * @return The number of views.
+	 */
+	const uint32_t &GetViewCount() const { return m_viewCount; }
+
+	/**
+	 * Sets the number of views the stage draws, the stage is rebuilt before the next frame.
+	 * Stages drawing to the swapchain draw one view, and the count is limited by {@link LogicalDevice#GetMaxViewCount}.
+	 * Material pipelines are compiled again, but pipelines owned by subrenders are created with the count their stage had, so it should be set before the subrenders are added.
+	 * @param viewCount The number of views.
+	 */
+	void SetViewCount(const uint32_t &viewCount);
+
 private:
 	friend class Graphics;
 
@@ -230,6 +308,10 @@ private:
 	std::vector<bool> m_subpassMultisampled;
 
 	RenderArea m_renderArea;
+	/// The swapchain the framebuffers were built with, they are rebuilt when it is replaced.
+	const Swapchain *m_swapchain;
+	bool m_depthPrepass;
+	uint32_t m_viewCount;
 	bool m_outOfDate;
 };
 }
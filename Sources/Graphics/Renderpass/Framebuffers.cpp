@@ -1,6 +1,7 @@
 ﻿#include "Framebuffers.hpp"
 
 #include "Graphics/Images/ImageDepth.hpp"
+#include "Graphics/Renderpass/RenderGraph.hpp"
 #include "Graphics/Renderpass/Renderpass.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Graphics/RenderStage.hpp"
@@ -8,26 +9,81 @@
 namespace acid
 {
 Framebuffers::Framebuffers(const Vector2ui &extent, const RenderStage &renderStage, const Renderpass &renderPass, const Swapchain &swapchain, const ImageDepth &depthStencil,
-	const VkSampleCountFlagBits &samples)
+	const VkSampleCountFlagBits &samples, Framebuffers *previous) :
+	m_extent(extent)
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto reuse = previous != nullptr && previous->m_extent == extent;
+	// Multiview stages draw each view into a layer of their attachments.
+	auto viewCount = renderStage.GetViewCount();
 
 	for (const auto &attachment : renderStage.GetAttachments())
 	{
 		auto attachmentSamples = attachment.IsMultisampled() ? samples : VK_SAMPLE_COUNT_1_BIT;
+		auto index = m_imageAttachments.size();
 
 		switch (attachment.GetType())
 		{
 		case Attachment::Type::Image:
+		{
+			auto input = renderStage.IsInputAttachment(attachment.GetBinding());
+			auto renderGraph = Graphics::Get()->GetRenderGraph();
+			auto memory = renderGraph->GetMemory(attachment.GetName());
+
+			// Memory planned by the render graph may have been planned again, so only images with their own memory are kept.
+			if (reuse && memory == nullptr)
+			{
+				if (auto &image = previous->m_imageAttachments[index]; image != nullptr && !image->IsAliased() && image->GetArrayLayers() == viewCount)
+				{
+					m_imageAttachments.emplace_back(std::move(image));
+					break;
+				}
+			}
+
+			// Attachments planned by the render graph are bound into memory they share with others.
+			if (memory != nullptr)
+			{
+				m_imageAttachments.emplace_back(std::make_unique<Image2d>(extent, attachment.GetFormat(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+					RenderGraph::GetAttachmentUsage(renderGraph->IsTransient(attachment.GetName()), input), attachmentSamples, *memory, viewCount));
+				break;
+			}
+
 			m_imageAttachments.emplace_back(std::make_unique<Image2d>(extent, nullptr, attachment.GetFormat(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, attachmentSamples));
+				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | (input ? VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT : 0), VK_FILTER_LINEAR,
+				VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, attachmentSamples, false, false, viewCount));
 			break;
+		}
 		case Attachment::Type::Depth:
 			m_imageAttachments.emplace_back(nullptr);
 			break;
 		case Attachment::Type::Swapchain:
 			m_imageAttachments.emplace_back(nullptr);
 			break;
+		case Attachment::Type::ShadingRate:
+		{
+			if (reuse && previous->m_imageAttachments[index] != nullptr)
+			{
+				m_imageAttachments.emplace_back(std::move(previous->m_imageAttachments[index]));
+				break;
+			}
+
+			// A texel holds the rate of a block of pixels, without variable rate shading the image is not read and only has to cover the framebuffer.
+			auto shadingRateExtent = extent;
+			VkImageUsageFlags usage = VK_IMAGE_USAGE_STORAGE_BIT;
+
+#if defined(VK_KHR_fragment_shading_rate)
+			if (logicalDevice->IsFragmentShadingRate())
+			{
+				auto &texelSize = logicalDevice->GetShadingRateTexelSize();
+				shadingRateExtent = { (extent.m_x + texelSize.width - 1) / texelSize.width, (extent.m_y + texelSize.height - 1) / texelSize.height };
+				usage |= VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR;
+			}
+#endif
+
+			m_imageAttachments.emplace_back(std::make_unique<Image2d>(shadingRateExtent, nullptr, VK_FORMAT_R8_UINT, VK_IMAGE_LAYOUT_GENERAL, usage, VK_FILTER_NEAREST,
+				VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE));
+			break;
+		}
 		}
 	}
 
@@ -42,6 +98,7 @@ Framebuffers::Framebuffers(const Vector2ui &extent, const RenderStage &renderSta
 			switch (attachment.GetType())
 			{
 			case Attachment::Type::Image:
+			case Attachment::Type::ShadingRate:
 				attachments.emplace_back(GetAttachment(attachment.GetBinding())->GetView());
 				break;
 			case Attachment::Type::Depth:
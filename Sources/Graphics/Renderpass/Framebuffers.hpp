@@ -13,11 +13,23 @@ class ACID_EXPORT Framebuffers :
 	public NonCopyable
 {
 public:
+	/**
+	 * Creates the attachments and framebuffers of a render stage.
+	 * @param extent The extent of the attachments.
+	 * @param renderStage The render stage.
+	 * @param renderPass The renderpass the framebuffers are used with.
+	 * @param swapchain The swapchain whose images are drawn to by swapchain attachments.
+	 * @param depthStencil The depth stencil of the render stage.
+	 * @param samples The samples of multisampled attachments.
+	 * @param previous The framebuffers being replaced, attachments of the same extent that allocate their own memory are taken from them instead of created again.
+	 */
 	Framebuffers(const Vector2ui &extent, const RenderStage &renderStage, const Renderpass &renderPass, const Swapchain &swapchain, const ImageDepth &depthStencil,
-		const VkSampleCountFlagBits &samples = VK_SAMPLE_COUNT_1_BIT);
+		const VkSampleCountFlagBits &samples = VK_SAMPLE_COUNT_1_BIT, Framebuffers *previous = nullptr);
 
 	~Framebuffers();
 
+	const Vector2ui &GetExtent() const { return m_extent; }
+
 	const std::vector<std::unique_ptr<Image2d>> &GetImageAttachments() const { return m_imageAttachments; }
 
 	Image2d *GetAttachment(const uint32_t &index) const { return m_imageAttachments[index].get(); }
@@ -25,6 +37,7 @@ public:
 	const std::vector<VkFramebuffer> &GetFramebuffers() const { return m_framebuffers; }
 
 private:
+	Vector2ui m_extent;
 	std::vector<std::unique_ptr<Image2d>> m_imageAttachments;
 	std::vector<VkFramebuffer> m_framebuffers;
 };
@@ -0,0 +1,325 @@
+#include "RenderGraph.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Graphics/RenderStage.hpp"
+
+namespace acid
+{
+// How many frames of lookups are learned before the first plan.
+const uint32_t PLAN_FRAMES = 3;
+
+RenderGraph::RenderGraph() :
+	m_frames(0),
+	m_dirty(false)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	ReleaseSlots();
+}
+
+void RenderGraph::SetStage(const std::optional<uint32_t> &stage)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stage = stage;
+}
+
+bool RenderGraph::RecordRead(const std::string &name, const uint32_t &producer, const bool &input)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto &lifetime = m_lifetimes[name];
+	auto bound = m_bindings.find(name) != m_bindings.end() || m_discarded.find(name) != m_discarded.end();
+
+	if (input && m_stage && *m_stage == producer)
+	{
+		// Read from tile memory while the stage renders, the attachment does not have to live past it.
+		return true;
+	}
+
+	if (!m_stage || *m_stage < producer)
+	{
+		// Read outside of the frame or before it is rendered, the contents must survive between frames.
+		if (!lifetime.m_persistent)
+		{
+			lifetime.m_persistent = true;
+			m_dirty = m_dirty || bound;
+		}
+	}
+	else if (!lifetime.m_lastRead || *m_stage > *lifetime.m_lastRead)
+	{
+		lifetime.m_lastRead = m_stage;
+		m_dirty = m_dirty || bound;
+	}
+
+	return m_transients.find(name) == m_transients.end() && m_discarded.find(name) == m_discarded.end();
+}
+
+void RenderGraph::EndFrame()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stage = std::nullopt;
+
+	if (m_frames < PLAN_FRAMES && ++m_frames == PLAN_FRAMES)
+	{
+		m_dirty = true;
+	}
+}
+
+void RenderGraph::Plan(const std::vector<std::unique_ptr<RenderStage>> &renderStages)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	ReleaseSlots(true);
+	m_dirty = false;
+
+	if (m_frames < PLAN_FRAMES)
+	{
+		return;
+	}
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
+	auto msaaSamples = physicalDevice->GetMsaaSamples();
+
+	class Candidate
+	{
+	public:
+		std::string m_name;
+		uint32_t m_stage;
+		std::pair<uint32_t, uint32_t> m_interval;
+		bool m_transient;
+		VkMemoryRequirements m_requirements;
+	};
+
+	std::vector<Candidate> candidates;
+	std::set<std::string> names;
+
+	for (uint32_t i = 0; i < renderStages.size(); i++)
+	{
+		auto extent = renderStages[i]->GetRenderArea().GetExtent();
+
+		for (const auto &attachment : renderStages[i]->GetAttachments())
+		{
+			auto it = m_lifetimes.find(attachment.GetName());
+			auto read = it != m_lifetimes.end() && (it->second.m_persistent || it->second.m_lastRead);
+
+			// Only the first stage with a name is found by lookups, later duplicates keep their own memory.
+			if ((attachment.GetType() != Attachment::Type::Image && attachment.GetType() != Attachment::Type::Depth) || !names.emplace(attachment.GetName()).second ||
+				attachment.IsPreserved())
+			{
+				continue;
+			}
+
+			// Contents that are never looked up after the render pass are not written back to memory at its end.
+			if (!read)
+			{
+				m_discarded.emplace(attachment.GetName());
+			}
+
+			// Depth images are created by their stage and keep their own memory.
+			if (attachment.GetType() == Attachment::Type::Depth || (it != m_lifetimes.end() && it->second.m_persistent))
+			{
+				continue;
+			}
+
+			Candidate candidate = {};
+			candidate.m_name = attachment.GetName();
+			candidate.m_stage = i;
+			candidate.m_transient = it == m_lifetimes.end() || !it->second.m_lastRead;
+			candidate.m_interval = { i, candidate.m_transient ? i : std::max(i, *it->second.m_lastRead) };
+
+			// The requirements are queried from a image that is never bound.
+			VkImageCreateInfo imageCreateInfo = {};
+			imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageCreateInfo.format = attachment.GetFormat();
+			imageCreateInfo.extent = { extent.m_x, extent.m_y, 1 };
+			imageCreateInfo.mipLevels = 1;
+			imageCreateInfo.arrayLayers = renderStages[i]->GetViewCount();
+			imageCreateInfo.samples = attachment.IsMultisampled() ? msaaSamples : VK_SAMPLE_COUNT_1_BIT;
+			imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageCreateInfo.usage = GetAttachmentUsage(candidate.m_transient, renderStages[i]->IsInputAttachment(attachment.GetBinding()));
+			imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			VkImage image;
+			Graphics::CheckVk(vkCreateImage(*logicalDevice, &imageCreateInfo, nullptr, &image));
+			vkGetImageMemoryRequirements(*logicalDevice, image, &candidate.m_requirements);
+			vkDestroyImage(*logicalDevice, image, nullptr);
+
+			candidates.emplace_back(candidate);
+		}
+	}
+
+	// Largest first, so small attachments fill in around the large ones.
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+	{
+		return a.m_requirements.size > b.m_requirements.size;
+	});
+
+	for (const auto &candidate : candidates)
+	{
+		Slot *found = nullptr;
+
+		if (candidate.m_transient && FindMemoryType(candidate.m_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT))
+		{
+			// Lazily allocated memory may never be backed, it is not shared.
+			auto &slot = m_slots.emplace_back(std::make_unique<Slot>());
+			slot->m_requirements = candidate.m_requirements;
+			slot->m_lazy = true;
+			found = slot.get();
+		}
+		else
+		{
+			for (auto &slot : m_slots)
+			{
+				if (slot->m_lazy || !FindMemoryType(slot->m_requirements.memoryTypeBits & candidate.m_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+				{
+					continue;
+				}
+
+				auto overlaps = std::any_of(slot->m_intervals.begin(), slot->m_intervals.end(), [&](const std::pair<uint32_t, uint32_t> &interval)
+				{
+					return candidate.m_interval.first <= interval.second && interval.first <= candidate.m_interval.second;
+				});
+
+				if (!overlaps)
+				{
+					found = slot.get();
+					break;
+				}
+			}
+
+			if (found == nullptr)
+			{
+				found = m_slots.emplace_back(std::make_unique<Slot>()).get();
+				found->m_requirements = candidate.m_requirements;
+			}
+		}
+
+		found->m_requirements.size = std::max(found->m_requirements.size, candidate.m_requirements.size);
+		found->m_requirements.alignment = std::max(found->m_requirements.alignment, candidate.m_requirements.alignment);
+		found->m_requirements.memoryTypeBits &= candidate.m_requirements.memoryTypeBits;
+		found->m_names.emplace_back(candidate.m_name);
+		found->m_intervals.emplace_back(candidate.m_interval);
+		found->m_transient = found->m_transient || candidate.m_transient;
+
+		if (candidate.m_transient)
+		{
+			m_transients.emplace(candidate.m_name);
+		}
+	}
+
+	VkDeviceSize candidateBytes = 0;
+	VkDeviceSize slotBytes = 0;
+
+	for (const auto &candidate : candidates)
+	{
+		candidateBytes += candidate.m_requirements.size;
+	}
+
+	for (auto &slot : m_slots)
+	{
+		// Slots with a single attachment that is read later are left to allocate their own memory.
+		if (slot->m_names.size() < 2 && !slot->m_transient)
+		{
+			slotBytes += slot->m_requirements.size;
+			continue;
+		}
+
+		auto properties = slot->m_lazy ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		slot->m_memory = Graphics::Get()->GetMemoryAllocator()->Allocate(slot->m_requirements, properties, false);
+		slotBytes += slot->m_lazy ? 0 : slot->m_requirements.size;
+
+		for (const auto &name : slot->m_names)
+		{
+			m_bindings.emplace(name, slot.get());
+		}
+
+		if (slot->m_names.size() >= 2)
+		{
+			for (const auto &interval : slot->m_intervals)
+			{
+				m_aliasedStages.emplace(interval.first);
+			}
+		}
+	}
+
+#if defined(ACID_VERBOSE)
+	Log::Out("Render graph placed %i attachments into %i slots, saving %.3fMB\n", static_cast<int32_t>(candidates.size()), static_cast<int32_t>(m_slots.size()),
+		static_cast<float>(candidateBytes - slotBytes) / 1048576.0f);
+#endif
+}
+
+const MemoryAllocation *RenderGraph::GetMemory(const std::string &name) const
+{
+	auto it = m_bindings.find(name);
+
+	if (it == m_bindings.end())
+	{
+		return nullptr;
+	}
+
+	return &it->second->m_memory;
+}
+
+VkImageUsageFlags RenderGraph::GetAttachmentUsage(const bool &transient, const bool &input)
+{
+	VkImageUsageFlags inputUsage = input ? VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT : 0;
+
+	if (transient)
+	{
+		return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | inputUsage;
+	}
+
+	// Matches the usage of attachments that allocate their own memory.
+	return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+		inputUsage;
+}
+
+void RenderGraph::ReleaseSlots(const bool &retire)
+{
+	for (auto &slot : m_slots)
+	{
+		if (!slot->m_memory.IsValid())
+		{
+			continue;
+		}
+
+		if (retire)
+		{
+			Graphics::Get()->Retire([memory = slot->m_memory]() mutable
+			{
+				Graphics::Get()->GetMemoryAllocator()->Free(memory);
+			});
+		}
+		else
+		{
+			Graphics::Get()->GetMemoryAllocator()->Free(slot->m_memory);
+		}
+	}
+
+	m_slots.clear();
+	m_bindings.clear();
+	m_transients.clear();
+	m_discarded.clear();
+	m_aliasedStages.clear();
+}
+
+std::optional<uint32_t> RenderGraph::FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties) const
+{
+	auto memoryProperties = Graphics::Get()->GetPhysicalDevice()->GetMemoryProperties();
+
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+	{
+		if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & requiredProperties) == requiredProperties)
+		{
+			return i;
+		}
+	}
+
+	return std::nullopt;
+}
+}
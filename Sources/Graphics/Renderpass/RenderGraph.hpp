@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vulkan/vulkan.h>
+#include "Graphics/Memory/MemoryAllocator.hpp"
+#include "Helpers/NonCopyable.hpp"
+#include "StdAfx.hpp"
+
+namespace acid
+{
+class RenderStage;
+
+/**
+ * @brief Class that learns when render stage attachments are written and read, and lets attachments that are never alive at the same time share memory.
+ * An attachment is alive from the stage that renders it to the last stage that looks it up by name, attachments looked up outside of a stage
+ * or before they are rendered keep their own memory. Attachments that are never looked up are transient, and use lazily allocated memory when the device has it.
+ * Reads as input attachments of the rendering stage do not extend a lifetime, so on tile based GPUs such attachments stay in tile memory and are never stored.
+ */
+class ACID_EXPORT RenderGraph :
+	public NonCopyable
+{
+public:
+	RenderGraph();
+
+	~RenderGraph();
+
+	/**
+	 * Sets the render stage lookups are made from.
+	 * @param stage The render stage index, or none when no stage is being recorded.
+	 */
+	void SetStage(const std::optional<uint32_t> &stage);
+
+	/**
+	 * Records a lookup of a attachment, this is safe to call from the threads recording subrenders.
+	 * @param name The attachment name.
+	 * @param producer The index of the render stage that renders the attachment.
+	 * @param input If the attachment is read as a input attachment of a later subpass in the stage that renders it.
+	 * @return If the attachment has contents that can be read, transient or discarded attachments can only be read as input attachments.
+	 */
+	bool RecordRead(const std::string &name, const uint32_t &producer, const bool &input = false);
+
+	/**
+	 * Ends the lifetimes learned this frame, a plan is asked for once enough frames have been seen.
+	 */
+	void EndFrame();
+
+	/**
+	 * Gets if the learned lifetimes no longer match the current plan.
+	 * @return If the render stages should be planned and rebuilt.
+	 */
+	bool IsDirty() const { return m_dirty; }
+
+	/**
+	 * Places the attachments of render stages into shared memory, this must be called before the stages are rebuilt and after their render areas are updated.
+	 * Images created from the previous plan must not be used again, they are replaced when the stages are rebuilt.
+	 * @param renderStages The render stages.
+	 */
+	void Plan(const std::vector<std::unique_ptr<RenderStage>> &renderStages);
+
+	/**
+	 * Gets the memory a attachment should be bound into.
+	 * @param name The attachment name.
+	 * @return The memory, or nullptr if the attachment allocates its own.
+	 */
+	const MemoryAllocation *GetMemory(const std::string &name) const;
+
+	bool IsTransient(const std::string &name) const { return m_transients.find(name) != m_transients.end(); }
+
+	/**
+	 * Gets if the contents of a attachment must be stored at the end of its render pass, those never looked up by name after it can be discarded.
+	 * @param name The attachment name.
+	 * @return If the attachment is stored.
+	 */
+	bool IsStored(const std::string &name) const { return m_discarded.find(name) == m_discarded.end(); }
+
+	/**
+	 * Gets if a render stage has attachments that share memory with other stages, so it can not be rebuilt on its own.
+	 * @param stage The render stage index.
+	 * @return If the stage is aliased.
+	 */
+	bool IsAliased(const uint32_t &stage) const { return m_aliasedStages.find(stage) != m_aliasedStages.end(); }
+
+	static VkImageUsageFlags GetAttachmentUsage(const bool &transient, const bool &input);
+
+private:
+	class Lifetime
+	{
+	public:
+		std::optional<uint32_t> m_lastRead;
+		bool m_persistent = false;
+	};
+
+	class Slot
+	{
+	public:
+		VkMemoryRequirements m_requirements = {};
+		std::vector<std::string> m_names;
+		std::vector<std::pair<uint32_t, uint32_t>> m_intervals;
+		bool m_transient = false;
+		bool m_lazy = false;
+		MemoryAllocation m_memory;
+	};
+
+	/**
+	 * Releases the memory of the current plan.
+	 * @param retire If the memory is freed once the frames in flight have finished, images bound into it may still be used by them.
+	 */
+	void ReleaseSlots(const bool &retire = false);
+
+	std::optional<uint32_t> FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties) const;
+
+	std::map<std::string, Lifetime> m_lifetimes;
+	std::optional<uint32_t> m_stage;
+	uint32_t m_frames;
+	std::atomic<bool> m_dirty;
+	std::mutex m_mutex;
+
+	std::vector<std::unique_ptr<Slot>> m_slots;
+	std::map<std::string, Slot *> m_bindings;
+	std::set<std::string> m_transients;
+	std::set<std::string> m_discarded;
+	std::set<uint32_t> m_aliasedStages;
+};
+}
@@ -2,13 +2,16 @@
 
 #include "Graphics/Graphics.hpp"
 #include "Graphics/RenderStage.hpp"
+#include "RenderGraph.hpp"
 
 namespace acid
 {
 Renderpass::Renderpass(const RenderStage &renderStage, const VkFormat &depthFormat, const VkFormat &surfaceFormat, const VkSampleCountFlagBits &samples) :
-	m_renderpass(VK_NULL_HANDLE)
+	m_renderpass(VK_NULL_HANDLE),
+	m_viewCount(renderStage.GetViewCount())
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto renderGraph = Graphics::Get()->GetRenderGraph();
 
 	// Creates the renderpasses attachment descriptions,
 	std::vector<VkAttachmentDescription> attachmentDescriptions;
@@ -29,15 +32,41 @@ Renderpass::Renderpass(const RenderStage &renderStage, const VkFormat &depthForm
 		case Attachment::Type::Image:
 			attachmentDescription.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 			attachmentDescription.format = attachment.GetFormat();
+
+			// Contents only read within the render pass stay in tile memory.
+			if (!renderGraph->IsStored(attachment.GetName()))
+			{
+				attachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			}
+
+			if (attachment.IsPreserved())
+			{
+				// Keeps the last frames contents, the image is created in and left in the attachment layout.
+				attachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+				attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			}
 			break;
 		case Attachment::Type::Depth:
 			attachmentDescription.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 			attachmentDescription.format = depthFormat;
+
+			if (!renderGraph->IsStored(attachment.GetName()))
+			{
+				attachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			}
 			break;
 		case Attachment::Type::Swapchain:
 			attachmentDescription.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 			attachmentDescription.format = surfaceFormat;
 			break;
+		case Attachment::Type::ShadingRate:
+			// Written before the render pass begins and only read by it.
+			attachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
+			attachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_GENERAL;
+			attachmentDescription.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+			attachmentDescription.format = VK_FORMAT_R8_UINT;
+			break;
 		}
 
 		attachmentDescriptions.emplace_back(attachmentDescription);
@@ -46,13 +75,24 @@ Renderpass::Renderpass(const RenderStage &renderStage, const VkFormat &depthForm
 	// Creates each subpass and its dependencies.
 	std::vector<std::unique_ptr<SubpassDescription>> subpasses;
 	std::vector<VkSubpassDependency> dependencies;
+	std::vector<std::optional<uint32_t>> shadingRateAttachments;
+
+	auto usesAttachment = [](const SubpassType &subpassType, const uint32_t &binding)
+	{
+		auto &bindings = subpassType.GetAttachmentBindings();
+		auto &inputBindings = subpassType.GetInputAttachmentBindings();
+		return std::find(bindings.begin(), bindings.end(), binding) != bindings.end() ||
+			std::find(inputBindings.begin(), inputBindings.end(), binding) != inputBindings.end();
+	};
 
 	for (const auto &subpassType : renderStage.GetSubpasses())
 	{
 		// Attachments.
 		std::vector<VkAttachmentReference> subpassColourAttachments;
+		std::vector<VkAttachmentReference> subpassInputAttachments;
 
 		std::optional<uint32_t> depthAttachment;
+		std::optional<uint32_t> shadingRateAttachment;
 
 		for (const auto &attachmentBinding : subpassType.GetAttachmentBindings())
 		{
@@ -70,21 +110,73 @@ Renderpass::Renderpass(const RenderStage &renderStage, const VkFormat &depthForm
 				continue;
 			}
 
+			if (attachment->GetType() == Attachment::Type::ShadingRate)
+			{
+				shadingRateAttachment = attachment->GetBinding();
+				continue;
+			}
+
 			VkAttachmentReference attachmentReference = {};
 			attachmentReference.attachment = attachment->GetBinding();
 			attachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 			subpassColourAttachments.emplace_back(attachmentReference);
 		}
 
+		for (const auto &attachmentBinding : subpassType.GetInputAttachmentBindings())
+		{
+			auto attachment = renderStage.GetAttachment(attachmentBinding);
+
+			if (!attachment || attachment->GetType() != Attachment::Type::Image)
+			{
+				Log::Error("Failed to find a renderpass input attachment image bound to: %i\n", attachmentBinding);
+				continue;
+			}
+
+			VkAttachmentReference attachmentReference = {};
+			attachmentReference.attachment = attachment->GetBinding();
+			attachmentReference.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			subpassInputAttachments.emplace_back(attachmentReference);
+		}
+
+		// Attachments drawn before the subpass and used again after it are kept through it, such as entity handles drawn by materials and then by gizmos.
+		std::vector<uint32_t> subpassPreserveAttachments;
+
+		for (const auto &attachment : renderStage.GetAttachments())
+		{
+			auto binding = attachment.GetBinding();
+
+			if (usesAttachment(subpassType, binding))
+			{
+				continue;
+			}
+
+			auto &subpassTypes = renderStage.GetSubpasses();
+			auto before = std::any_of(subpassTypes.begin(), subpassTypes.end(), [&](const SubpassType &other)
+			{
+				return other.GetBinding() < subpassType.GetBinding() && usesAttachment(other, binding);
+			});
+			auto after = std::any_of(subpassTypes.begin(), subpassTypes.end(), [&](const SubpassType &other)
+			{
+				return other.GetBinding() > subpassType.GetBinding() && usesAttachment(other, binding);
+			});
+
+			if (before && after)
+			{
+				subpassPreserveAttachments.emplace_back(binding);
+			}
+		}
+
 		// Subpass description.
-		subpasses.emplace_back(std::make_unique<SubpassDescription>(VK_PIPELINE_BIND_POINT_GRAPHICS, subpassColourAttachments, depthAttachment));
+		subpasses.emplace_back(std::make_unique<SubpassDescription>(VK_PIPELINE_BIND_POINT_GRAPHICS, subpassColourAttachments, depthAttachment,
+			subpassInputAttachments, subpassPreserveAttachments));
+		shadingRateAttachments.emplace_back(shadingRateAttachment);
 
 		// Subpass dependencies.
 		VkSubpassDependency subpassDependency = {};
 		subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 		subpassDependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 		subpassDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-		subpassDependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		subpassDependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
 		subpassDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
 		if (subpassType.GetBinding() == renderStage.GetSubpasses().size())
@@ -112,6 +204,12 @@ Renderpass::Renderpass(const RenderStage &renderStage, const VkFormat &depthForm
 			subpassDependency.srcSubpass = subpassType.GetBinding() - 1;
 		}
 
+		// Each view only depends on the same view of the previous subpass.
+		if (m_viewCount > 1 && subpassDependency.srcSubpass != VK_SUBPASS_EXTERNAL && subpassDependency.dstSubpass != VK_SUBPASS_EXTERNAL)
+		{
+			subpassDependency.dependencyFlags |= VK_DEPENDENCY_VIEW_LOCAL_BIT;
+		}
+
 		dependencies.emplace_back(subpassDependency);
 	}
 
@@ -132,6 +230,33 @@ Renderpass::Renderpass(const RenderStage &renderStage, const VkFormat &depthForm
 	renderPassCreateInfo.pSubpasses = subpassDescriptions.data();
 	renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
 	renderPassCreateInfo.pDependencies = dependencies.data();
+
+	// Every subpass draws all views, views are correlated so the implementation may render them together.
+	auto viewMask = m_viewCount > 1 ? (1u << m_viewCount) - 1 : 0;
+	std::vector<uint32_t> viewMasks(subpassDescriptions.size(), viewMask);
+
+	VkRenderPassMultiviewCreateInfo multiviewCreateInfo = {};
+	multiviewCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+	multiviewCreateInfo.subpassCount = static_cast<uint32_t>(viewMasks.size());
+	multiviewCreateInfo.pViewMasks = viewMasks.data();
+	multiviewCreateInfo.correlationMaskCount = 1;
+	multiviewCreateInfo.pCorrelationMasks = &viewMask;
+
+	if (viewMask != 0)
+	{
+		renderPassCreateInfo.pNext = &multiviewCreateInfo;
+	}
+
+	// Without variable rate shading the shading rate attachments are left unreferenced, every region is shaded at the full rate.
+	if (logicalDevice->IsFragmentShadingRate() && std::any_of(shadingRateAttachments.begin(), shadingRateAttachments.end(), [](const std::optional<uint32_t> &attachment)
+	{
+		return attachment.has_value();
+	}))
+	{
+		CreateRenderpass2(renderPassCreateInfo, shadingRateAttachments, viewMask);
+		return;
+	}
+
 	Graphics::CheckVk(vkCreateRenderPass(*logicalDevice, &renderPassCreateInfo, nullptr, &m_renderpass));
 }
 
@@ -141,4 +266,130 @@ Renderpass::~Renderpass()
 
 	vkDestroyRenderPass(*logicalDevice, m_renderpass, nullptr);
 }
+
+void Renderpass::CreateRenderpass2(const VkRenderPassCreateInfo &renderPassCreateInfo, const std::vector<std::optional<uint32_t>> &shadingRateAttachments,
+	const uint32_t &viewMask)
+{
+#if defined(VK_KHR_fragment_shading_rate) && defined(VK_KHR_create_renderpass2)
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	// The shading rate attachment of a subpass can only be given with the second render pass structures, the first are translated field by field.
+	std::vector<VkAttachmentDescription2KHR> attachmentDescriptions;
+
+	for (uint32_t i = 0; i < renderPassCreateInfo.attachmentCount; i++)
+	{
+		auto &description = renderPassCreateInfo.pAttachments[i];
+		VkAttachmentDescription2KHR attachmentDescription = {};
+		attachmentDescription.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2_KHR;
+		attachmentDescription.flags = description.flags;
+		attachmentDescription.format = description.format;
+		attachmentDescription.samples = description.samples;
+		attachmentDescription.loadOp = description.loadOp;
+		attachmentDescription.storeOp = description.storeOp;
+		attachmentDescription.stencilLoadOp = description.stencilLoadOp;
+		attachmentDescription.stencilStoreOp = description.stencilStoreOp;
+		attachmentDescription.initialLayout = description.initialLayout;
+		attachmentDescription.finalLayout = description.finalLayout;
+		attachmentDescriptions.emplace_back(attachmentDescription);
+	}
+
+	auto getReference = [](const VkAttachmentReference &reference, const VkImageAspectFlags &aspectMask)
+	{
+		VkAttachmentReference2KHR attachmentReference = {};
+		attachmentReference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
+		attachmentReference.attachment = reference.attachment;
+		attachmentReference.layout = reference.layout;
+		attachmentReference.aspectMask = aspectMask;
+		return attachmentReference;
+	};
+
+	// References are kept in lists sized up front, so the pointers given to each subpass stay valid.
+	std::vector<std::vector<VkAttachmentReference2KHR>> colourReferences(renderPassCreateInfo.subpassCount);
+	std::vector<std::vector<VkAttachmentReference2KHR>> inputReferences(renderPassCreateInfo.subpassCount);
+	std::vector<VkAttachmentReference2KHR> depthReferences(renderPassCreateInfo.subpassCount);
+	std::vector<VkAttachmentReference2KHR> shadingRateReferences(renderPassCreateInfo.subpassCount);
+	std::vector<VkFragmentShadingRateAttachmentInfoKHR> shadingRateInfos(renderPassCreateInfo.subpassCount);
+	std::vector<VkSubpassDescription2KHR> subpassDescriptions;
+	auto &texelSize = logicalDevice->GetShadingRateTexelSize();
+
+	for (uint32_t i = 0; i < renderPassCreateInfo.subpassCount; i++)
+	{
+		auto &description = renderPassCreateInfo.pSubpasses[i];
+		VkSubpassDescription2KHR subpassDescription = {};
+		subpassDescription.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2_KHR;
+		subpassDescription.pipelineBindPoint = description.pipelineBindPoint;
+		subpassDescription.viewMask = viewMask;
+
+		for (uint32_t j = 0; j < description.colorAttachmentCount; j++)
+		{
+			colourReferences[i].emplace_back(getReference(description.pColorAttachments[j], VK_IMAGE_ASPECT_COLOR_BIT));
+		}
+
+		subpassDescription.colorAttachmentCount = static_cast<uint32_t>(colourReferences[i].size());
+		subpassDescription.pColorAttachments = colourReferences[i].data();
+
+		for (uint32_t j = 0; j < description.inputAttachmentCount; j++)
+		{
+			inputReferences[i].emplace_back(getReference(description.pInputAttachments[j], VK_IMAGE_ASPECT_COLOR_BIT));
+		}
+
+		subpassDescription.inputAttachmentCount = static_cast<uint32_t>(inputReferences[i].size());
+		subpassDescription.pInputAttachments = inputReferences[i].data();
+
+		if (description.pDepthStencilAttachment != nullptr)
+		{
+			depthReferences[i] = getReference(*description.pDepthStencilAttachment, VK_IMAGE_ASPECT_DEPTH_BIT);
+			subpassDescription.pDepthStencilAttachment = &depthReferences[i];
+		}
+
+		if (i < shadingRateAttachments.size() && shadingRateAttachments[i])
+		{
+			shadingRateReferences[i].sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2_KHR;
+			shadingRateReferences[i].attachment = *shadingRateAttachments[i];
+			shadingRateReferences[i].layout = VK_IMAGE_LAYOUT_GENERAL;
+
+			shadingRateInfos[i].sType = VK_STRUCTURE_TYPE_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR;
+			shadingRateInfos[i].pFragmentShadingRateAttachment = &shadingRateReferences[i];
+			shadingRateInfos[i].shadingRateAttachmentTexelSize = texelSize;
+			subpassDescription.pNext = &shadingRateInfos[i];
+		}
+
+		subpassDescriptions.emplace_back(subpassDescription);
+	}
+
+	std::vector<VkSubpassDependency2KHR> dependencies;
+
+	for (uint32_t i = 0; i < renderPassCreateInfo.dependencyCount; i++)
+	{
+		auto &dependency = renderPassCreateInfo.pDependencies[i];
+		VkSubpassDependency2KHR subpassDependency = {};
+		subpassDependency.sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2_KHR;
+		subpassDependency.srcSubpass = dependency.srcSubpass;
+		subpassDependency.dstSubpass = dependency.dstSubpass;
+		subpassDependency.srcStageMask = dependency.srcStageMask;
+		subpassDependency.dstStageMask = dependency.dstStageMask;
+		subpassDependency.srcAccessMask = dependency.srcAccessMask;
+		subpassDependency.dstAccessMask = dependency.dstAccessMask;
+		subpassDependency.dependencyFlags = dependency.dependencyFlags;
+		dependencies.emplace_back(subpassDependency);
+	}
+
+	VkRenderPassCreateInfo2KHR renderPassCreateInfo2 = {};
+	renderPassCreateInfo2.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2_KHR;
+	renderPassCreateInfo2.attachmentCount = static_cast<uint32_t>(attachmentDescriptions.size());
+	renderPassCreateInfo2.pAttachments = attachmentDescriptions.data();
+	renderPassCreateInfo2.subpassCount = static_cast<uint32_t>(subpassDescriptions.size());
+	renderPassCreateInfo2.pSubpasses = subpassDescriptions.data();
+	renderPassCreateInfo2.dependencyCount = static_cast<uint32_t>(dependencies.size());
+	renderPassCreateInfo2.pDependencies = dependencies.data();
+
+	if (viewMask != 0)
+	{
+		renderPassCreateInfo2.correlatedViewMaskCount = 1;
+		renderPassCreateInfo2.pCorrelatedViewMasks = &viewMask;
+	}
+
+	Graphics::CheckVk(Instance::FvkCreateRenderPass2KHR(*logicalDevice, &renderPassCreateInfo2, nullptr, &m_renderpass));
+#endif
+}
 }
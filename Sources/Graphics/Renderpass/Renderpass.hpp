@@ -15,14 +15,21 @@ public:
 		public NonCopyable
 	{
 	public:
-		SubpassDescription(const VkPipelineBindPoint &bindPoint, std::vector<VkAttachmentReference> colorAttachments, const std::optional<uint32_t> &depthAttachment) :
+		SubpassDescription(const VkPipelineBindPoint &bindPoint, std::vector<VkAttachmentReference> colorAttachments, const std::optional<uint32_t> &depthAttachment,
+			std::vector<VkAttachmentReference> inputAttachments = {}, std::vector<uint32_t> preserveAttachments = {}) :
 			m_subpassDescription({}),
 			m_colorAttachments(std::move(colorAttachments)),
+			m_inputAttachments(std::move(inputAttachments)),
+			m_preserveAttachments(std::move(preserveAttachments)),
 			m_depthStencilAttachment({})
 		{
 			m_subpassDescription.pipelineBindPoint = bindPoint;
 			m_subpassDescription.colorAttachmentCount = static_cast<uint32_t>(m_colorAttachments.size());
 			m_subpassDescription.pColorAttachments = m_colorAttachments.data();
+			m_subpassDescription.inputAttachmentCount = static_cast<uint32_t>(m_inputAttachments.size());
+			m_subpassDescription.pInputAttachments = m_inputAttachments.data();
+			m_subpassDescription.preserveAttachmentCount = static_cast<uint32_t>(m_preserveAttachments.size());
+			m_subpassDescription.pPreserveAttachments = m_preserveAttachments.data();
 
 			if (depthAttachment)
 			{
@@ -37,6 +44,8 @@ public:
 	private:
 		VkSubpassDescription m_subpassDescription;
 		std::vector<VkAttachmentReference> m_colorAttachments;
+		std::vector<VkAttachmentReference> m_inputAttachments;
+		std::vector<uint32_t> m_preserveAttachments;
 		VkAttachmentReference m_depthStencilAttachment;
 	};
 
@@ -48,7 +57,23 @@ public:
 
 	const VkRenderPass &GetRenderpass() const { return m_renderpass; }
 
+	/**
+	 * Gets the number of views each subpass draws with multiview, one if the render pass does not use multiview.
+	 * @return The number of views.
+	 */
+	const uint32_t &GetViewCount() const { return m_viewCount; }
+
 private:
+	/**
+	 * Creates the render pass with the second render pass structures, so subpasses can read their shading rate attachments.
+	 * @param renderPassCreateInfo The render pass as it would be created without shading rates.
+	 * @param shadingRateAttachments The shading rate attachment of each subpass, if it has one.
+	 * @param viewMask The views every subpass draws, zero without multiview.
+	 */
+	void CreateRenderpass2(const VkRenderPassCreateInfo &renderPassCreateInfo, const std::vector<std::optional<uint32_t>> &shadingRateAttachments,
+		const uint32_t &viewMask);
+
 	VkRenderPass m_renderpass;
+	uint32_t m_viewCount;
 };
 }
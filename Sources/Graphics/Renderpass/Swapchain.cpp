@@ -6,16 +6,21 @@ namespace acid
 {
 static const std::vector<VkCompositeAlphaFlagBitsKHR> COMPOSITE_ALPHA_FLAGS = { VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR, VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR,
 	VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR, VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR, };
+static const uint32_t OFFSCREEN_IMAGE_COUNT = 3;
 
-Swapchain::Swapchain(const VkExtent2D &extent, const std::optional<Reference<Swapchain>> &oldSwapchain) :
+Swapchain::Swapchain(const VkExtent2D &extent, const PresentPolicy &presentPolicy, const std::optional<Reference<Swapchain>> &oldSwapchain) :
 	m_extent(extent),
+	m_presentPolicy(presentPolicy),
 	m_presentMode(VK_PRESENT_MODE_FIFO_KHR),
+	m_deviceGroupPresentModes(0),
 	m_imageCount(0),
 	m_preTransform(VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR),
 	m_compositeAlpha(VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR),
 	m_swapchain(VK_NULL_HANDLE),
 	m_fenceImage(VK_NULL_HANDLE),
-	m_activeImageIndex(std::numeric_limits<uint32_t>::max())
+	m_activeImageIndex(std::numeric_limits<uint32_t>::max()),
+	m_presentCount(0),
+	m_presentId(0)
 {
 	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
 	auto surface = Graphics::Get()->GetSurface();
@@ -26,22 +31,46 @@ Swapchain::Swapchain(const VkExtent2D &extent, const std::optional<Reference<Swa
 	auto graphicsFamily = logicalDevice->GetGraphicsFamily();
 	auto presentFamily = logicalDevice->GetPresentFamily();
 
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &m_fenceImage);
+
+	if (*surface == VK_NULL_HANDLE)
+	{
+		m_presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+		CreateOffscreenImages(surfaceFormat.format);
+		return;
+	}
+
 	uint32_t physicalPresentModeCount = 0;
 	vkGetPhysicalDeviceSurfacePresentModesKHR(*physicalDevice, *surface, &physicalPresentModeCount, nullptr);
 	std::vector<VkPresentModeKHR> physicalPresentModes(physicalPresentModeCount);
 	vkGetPhysicalDeviceSurfacePresentModesKHR(*physicalDevice, *surface, &physicalPresentModeCount, physicalPresentModes.data());
 
-	for (const auto &presentMode : physicalPresentModes)
+	// Modes in order of preference, FIFO is always supported and is the fallback.
+	std::vector<VkPresentModeKHR> preferredPresentModes;
+
+	switch (m_presentPolicy)
 	{
-		if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR)
-		{
-			m_presentMode = presentMode;
-			break;
-		}
+	case PresentPolicy::LowLatency:
+		preferredPresentModes = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+		break;
+	case PresentPolicy::Adaptive:
+		preferredPresentModes = { VK_PRESENT_MODE_FIFO_RELAXED_KHR };
+		break;
+	case PresentPolicy::Immediate:
+		preferredPresentModes = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+		break;
+	default:
+		break;
+	}
 
-		if (m_presentMode != VK_PRESENT_MODE_MAILBOX_KHR && presentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+	for (const auto &preferredPresentMode : preferredPresentModes)
+	{
+		if (std::find(physicalPresentModes.begin(), physicalPresentModes.end(), preferredPresentMode) != physicalPresentModes.end())
 		{
-			m_presentMode = presentMode;
+			m_presentMode = preferredPresentMode;
+			break;
 		}
 	}
 
@@ -111,6 +140,31 @@ Swapchain::Swapchain(const VkExtent2D &extent, const std::optional<Reference<Swa
 		swapchainCreateInfo.pQueueFamilyIndices = queueFamily.data();
 	}
 
+	// Split frames are presented from every GPU at once, each showing the part it rendered, alternate frames from the GPU that rendered them.
+	VkDeviceGroupSwapchainCreateInfoKHR deviceGroupSwapchainCreateInfo = {};
+	deviceGroupSwapchainCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_SWAPCHAIN_CREATE_INFO_KHR;
+
+	if (logicalDevice->GetDeviceCount() > 1)
+	{
+		if (physicalDevice->GetDeviceGroupMode() == PhysicalDevice::DeviceGroupMode::SplitFrame)
+		{
+			m_deviceGroupPresentModes = logicalDevice->GetDeviceGroupPresentModes() & VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_MULTI_DEVICE_BIT_KHR;
+
+			if (m_deviceGroupPresentModes == 0)
+			{
+				Log::Warning("Device group cannot present from multiple GPUs at once, rendering alternate frames instead of split frames\n");
+			}
+		}
+
+		if (m_deviceGroupPresentModes == 0)
+		{
+			m_deviceGroupPresentModes = logicalDevice->GetDeviceGroupPresentModes() & (VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_BIT_KHR | VK_DEVICE_GROUP_PRESENT_MODE_REMOTE_BIT_KHR);
+		}
+
+		deviceGroupSwapchainCreateInfo.modes = m_deviceGroupPresentModes;
+		swapchainCreateInfo.pNext = &deviceGroupSwapchainCreateInfo;
+	}
+
 	Graphics::CheckVk(vkCreateSwapchainKHR(*logicalDevice, &swapchainCreateInfo, nullptr, &m_swapchain));
 
 	Graphics::CheckVk(vkGetSwapchainImagesKHR(*logicalDevice, m_swapchain, &m_imageCount, nullptr));
@@ -122,32 +176,60 @@ Swapchain::Swapchain(const VkExtent2D &extent, const std::optional<Reference<Swa
 	{
 		Image::CreateImageView(m_images.at(i), m_imageViews.at(i), VK_IMAGE_VIEW_TYPE_2D, surfaceFormat.format, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
 	}
-
-	VkFenceCreateInfo fenceCreateInfo = {};
-	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &m_fenceImage);
 }
 
 Swapchain::~Swapchain()
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
-	vkDestroySwapchainKHR(*logicalDevice, m_swapchain, nullptr);
+	if (m_swapchain != VK_NULL_HANDLE)
+	{
+		vkDestroySwapchainKHR(*logicalDevice, m_swapchain, nullptr);
+	}
 
 	for (const auto &imageView : m_imageViews)
 	{
 		vkDestroyImageView(*logicalDevice, imageView, nullptr);
 	}
 
+	// Offscreen images are owned by the swapchain, images from a real swapchain are destroyed with it.
+	for (uint32_t i = 0; i < m_offscreenMemory.size(); i++)
+	{
+		Graphics::Get()->GetMemoryAllocator()->Free(m_offscreenMemory[i]);
+		vkDestroyImage(*logicalDevice, m_images[i], nullptr);
+	}
+
 	vkDestroyFence(*logicalDevice, m_fenceImage, nullptr);
 }
 
-VkResult Swapchain::AcquireNextImage(const VkSemaphore &presentCompleteSemaphore)
+VkResult Swapchain::AcquireNextImage(const VkSemaphore &presentCompleteSemaphore, const uint32_t &deviceMask)
 {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
-	VkResult acquireResult = vkAcquireNextImageKHR(*logicalDevice, m_swapchain, std::numeric_limits<uint64_t>::max(), presentCompleteSemaphore, VK_NULL_HANDLE,
-		&m_activeImageIndex);
+	if (IsOffscreen())
+	{
+		m_activeImageIndex = (m_activeImageIndex + 1) % m_imageCount;
+		SubmitSemaphore(VK_NULL_HANDLE, presentCompleteSemaphore);
+		return VK_SUCCESS;
+	}
+
+	VkResult acquireResult;
+
+	if (deviceMask != 0)
+	{
+		VkAcquireNextImageInfoKHR acquireNextImageInfo = {};
+		acquireNextImageInfo.sType = VK_STRUCTURE_TYPE_ACQUIRE_NEXT_IMAGE_INFO_KHR;
+		acquireNextImageInfo.swapchain = m_swapchain;
+		acquireNextImageInfo.timeout = std::numeric_limits<uint64_t>::max();
+		acquireNextImageInfo.semaphore = presentCompleteSemaphore;
+		acquireNextImageInfo.deviceMask = deviceMask;
+		acquireResult = vkAcquireNextImage2KHR(*logicalDevice, &acquireNextImageInfo, &m_activeImageIndex);
+	}
+	else
+	{
+		acquireResult = vkAcquireNextImageKHR(*logicalDevice, m_swapchain, std::numeric_limits<uint64_t>::max(), presentCompleteSemaphore, VK_NULL_HANDLE,
+			&m_activeImageIndex);
+	}
 
 	if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR && acquireResult != VK_ERROR_OUT_OF_DATE_KHR)
 	{
@@ -161,15 +243,148 @@ VkResult Swapchain::AcquireNextImage(const VkSemaphore &presentCompleteSemaphore
 	return acquireResult;
 }
 
-VkResult Swapchain::QueuePresent(const VkQueue &presentQueue, const VkSemaphore &waitSemaphore)
+VkResult Swapchain::QueuePresent(const VkQueue &presentQueue, const VkSemaphore &waitSemaphore, const uint32_t &deviceMask)
 {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (IsOffscreen())
+	{
+		SubmitSemaphore(waitSemaphore, VK_NULL_HANDLE);
+		UpdatePresentTiming(false);
+		return VK_SUCCESS;
+	}
+
 	VkPresentInfoKHR presentInfo = {};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+	bool presentIdUsed = false;
+
+#if defined(VK_KHR_present_id)
+	uint64_t presentId = m_presentId + 1;
+
+	VkPresentIdKHR presentIdInfo = {};
+	presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+	presentIdInfo.swapchainCount = 1;
+	presentIdInfo.pPresentIds = &presentId;
+
+	if (logicalDevice->IsPresentWait())
+	{
+		presentInfo.pNext = &presentIdInfo;
+		presentIdUsed = true;
+	}
+#endif
+
+	VkDeviceGroupPresentInfoKHR deviceGroupPresentInfo = {};
+	deviceGroupPresentInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_PRESENT_INFO_KHR;
+
+	if (deviceMask != 0)
+	{
+		deviceGroupPresentInfo.swapchainCount = 1;
+		deviceGroupPresentInfo.pDeviceMasks = &deviceMask;
+		deviceGroupPresentInfo.mode = VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_MULTI_DEVICE_BIT_KHR;
+
+		// A image rendered by one GPU is presented by it when it has a display, or by a GPU with a display that can read it.
+		if ((deviceMask & (deviceMask - 1)) == 0)
+		{
+			uint32_t deviceIndex = 0;
+
+			while ((deviceMask >> deviceIndex) != 1)
+			{
+				deviceIndex++;
+			}
+
+			auto local = m_deviceGroupPresentModes & VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_BIT_KHR && logicalDevice->GetDeviceGroupPresentMask(deviceIndex) & deviceMask;
+			deviceGroupPresentInfo.mode = local ? VK_DEVICE_GROUP_PRESENT_MODE_LOCAL_BIT_KHR : VK_DEVICE_GROUP_PRESENT_MODE_REMOTE_BIT_KHR;
+		}
+
+		deviceGroupPresentInfo.pNext = presentInfo.pNext;
+		presentInfo.pNext = &deviceGroupPresentInfo;
+	}
+
 	presentInfo.waitSemaphoreCount = 1;
 	presentInfo.pWaitSemaphores = &waitSemaphore;
 	presentInfo.swapchainCount = 1;
 	presentInfo.pSwapchains = &m_swapchain;
 	presentInfo.pImageIndices = &m_activeImageIndex;
-	return vkQueuePresentKHR(presentQueue, &presentInfo);
+	auto result = vkQueuePresentKHR(presentQueue, &presentInfo);
+
+	if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+	{
+		UpdatePresentTiming(presentIdUsed);
+	}
+
+	return result;
+}
+
+void Swapchain::CreateOffscreenImages(const VkFormat &format)
+{
+	m_imageCount = OFFSCREEN_IMAGE_COUNT;
+	m_images.resize(m_imageCount);
+	m_imageViews.resize(m_imageCount);
+	m_offscreenMemory.resize(m_imageCount);
+
+	for (uint32_t i = 0; i < m_imageCount; i++)
+	{
+		Image::CreateImage(m_images[i], m_offscreenMemory[i], { m_extent.width, m_extent.height, 1 }, format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, 1,
+			VK_IMAGE_TYPE_2D);
+		Image::CreateImageView(m_images[i], m_imageViews[i], VK_IMAGE_VIEW_TYPE_2D, format, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+	}
+}
+
+void Swapchain::UpdatePresentTiming(const bool &presentIdUsed)
+{
+	auto now = Engine::GetTime();
+
+	if (m_presentCount > 0)
+	{
+		auto interval = now - m_lastPresentTime;
+		// Smoothed so a single late frame does not throw off the engines frame pacing.
+		m_presentInterval = m_presentCount == 1 ? interval : 0.9f * m_presentInterval + 0.1f * interval;
+	}
+
+	m_lastPresentTime = now;
+	m_presentCount++;
+
+	if (presentIdUsed)
+	{
+		m_presentId++;
+	}
+}
+
+void Swapchain::SubmitSemaphore(const VkSemaphore &waitSemaphore, const VkSemaphore &signalSemaphore)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+	if (waitSemaphore != VK_NULL_HANDLE)
+	{
+		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.pWaitSemaphores = &waitSemaphore;
+		submitInfo.pWaitDstStageMask = &waitStage;
+	}
+
+	if (signalSemaphore != VK_NULL_HANDLE)
+	{
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &signalSemaphore;
+	}
+
+	Graphics::CheckVk(vkQueueSubmit(logicalDevice->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE));
+}
+
+VkResult Swapchain::WaitForPresent(const uint64_t &presentId, const Time &timeout) const
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (!logicalDevice->IsPresentWait() || presentId == 0 || IsOffscreen())
+	{
+		return VK_SUCCESS;
+	}
+
+	return Instance::FvkWaitForPresentKHR(*logicalDevice, m_swapchain, presentId, static_cast<uint64_t>(timeout.AsMicroseconds<int64_t>()) * 1000);
 }
 }
@@ -1,7 +1,9 @@
 ﻿#pragma once
 
 #include <vulkan/vulkan.h>
+#include "Graphics/Memory/MemoryAllocator.hpp"
 #include "Helpers/Reference.hpp"
+#include "Maths/Time.hpp"
 #include "StdAfx.hpp"
 
 namespace acid
@@ -9,25 +11,51 @@ namespace acid
 class ACID_EXPORT Swapchain
 {
 public:
-	explicit Swapchain(const VkExtent2D &extent, const std::optional<Reference<Swapchain>> &oldSwapchain = {});
+	/**
+	 * @brief How the present mode is picked from the modes the surface supports, FIFO is used when the preferred modes are not available.
+	 */
+	enum class PresentPolicy
+	{
+		/// Mailbox, then immediate, the newest image is shown without waiting for older images to be displayed.
+		LowLatency,
+		/// FIFO, images are shown in order on the vertical blank.
+		Vsync,
+		/// Relaxed FIFO, late images are shown immediately instead of waiting for the next vertical blank.
+		Adaptive,
+		/// Immediate, then mailbox, images are shown as soon as they are presented and may tear.
+		Immediate
+	};
+
+	explicit Swapchain(const VkExtent2D &extent, const PresentPolicy &presentPolicy = PresentPolicy::LowLatency,
+		const std::optional<Reference<Swapchain>> &oldSwapchain = {});
 
 	~Swapchain();
 
 	/**
 	 * Acquires the next image in the swapchain into the internal acquired image. The function will always wait until the next image has been acquired by setting timeout to UINT64_MAX.
 	 * @param presentCompleteSemaphore A optional semaphore that is signaled when the image is ready for use.
+	 * @param deviceMask The GPUs of a device group the image is acquired for, zero when there is no device group.
 	 * @return Result of the image acquisition.
 	 */
-	VkResult AcquireNextImage(const VkSemaphore &presentCompleteSemaphore = VK_NULL_HANDLE);
+	VkResult AcquireNextImage(const VkSemaphore &presentCompleteSemaphore = VK_NULL_HANDLE, const uint32_t &deviceMask = 0);
 
 	/**
 	 * Queue an image for presentation using the internal acquired image for queue presentation.
 	 * @param presentQueue Presentation queue for presenting the image.
 	 * @param waitSemaphore A optional semaphore that is waited on before the image is presented.
+	 * @param deviceMask The GPUs of a device group whose instances of the image are presented, zero when there is no device group.
 	 * @return Result of the queue presentation.
 	 */
-	VkResult QueuePresent(const VkQueue &presentQueue, const VkSemaphore &waitSemaphore = VK_NULL_HANDLE);
-	
+	VkResult QueuePresent(const VkQueue &presentQueue, const VkSemaphore &waitSemaphore = VK_NULL_HANDLE, const uint32_t &deviceMask = 0);
+
+	/**
+	 * Waits until a presented image has been shown on the display, this requires present waits to be enabled on the logical device.
+	 * @param presentId The id of the present, from {@link Swapchain#GetPresentId} after it was queued.
+	 * @param timeout The longest time to wait.
+	 * @return Result of the wait, VK_TIMEOUT if the image was not shown in time.
+	 */
+	VkResult WaitForPresent(const uint64_t &presentId, const Time &timeout) const;
+
 	operator const VkSwapchainKHR &() const { return m_swapchain; }
 
 	const VkExtent2D &GetExtent() const { return m_extent; }
@@ -46,22 +74,82 @@ public:
 
 	const VkSwapchainKHR &GetSwapchain() const { return m_swapchain; }
 
+	/**
+	 * Gets if the images are plain offscreen images, used when there is no surface to present to.
+	 * Offscreen images are acquired in turn and presenting only waits for the frame, reading them back works as with swapchain images.
+	 * @return If the swapchain is offscreen.
+	 */
+	bool IsOffscreen() const { return m_swapchain == VK_NULL_HANDLE; }
+
 	const uint32_t &GetActiveImageIndex() const { return m_activeImageIndex; }
 
+	const VkPresentModeKHR &GetPresentMode() const { return m_presentMode; }
+
+	const PresentPolicy &GetPresentPolicy() const { return m_presentPolicy; }
+
+	/**
+	 * Gets the ways the GPUs of a device group may present images of this swapchain.
+	 * @return The device group present modes, zero when there is no device group.
+	 */
+	const VkDeviceGroupPresentModeFlagsKHR &GetDeviceGroupPresentModes() const { return m_deviceGroupPresentModes; }
+
+	/**
+	 * Gets if presentation waits for the vertical blank, this paces rendering to the display rate.
+	 * @return If the present mode is vsynced.
+	 */
+	bool IsVsync() const { return m_presentMode == VK_PRESENT_MODE_FIFO_KHR || m_presentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR; }
+
+	/**
+	 * Gets the engine time of the last successful queue present.
+	 * @return The last present time.
+	 */
+	const Time &GetLastPresentTime() const { return m_lastPresentTime; }
+
+	/**
+	 * Gets the smoothed time between queue presents, zero until two images have been presented.
+	 * @return The present interval.
+	 */
+	const Time &GetPresentInterval() const { return m_presentInterval; }
+
+	const uint64_t &GetPresentCount() const { return m_presentCount; }
+
+	/**
+	 * Gets the id given to the last queued present, ids start at one and are only given when present waits are enabled.
+	 * @return The last present id, zero if nothing has been presented with a id.
+	 */
+	const uint64_t &GetPresentId() const { return m_presentId; }
+
 	bool IsSameExtent(const VkExtent2D &extent2D) { return m_extent.width == extent2D.width && m_extent.height == extent2D.height; }
 
 private:
+	void CreateOffscreenImages(const VkFormat &format);
+
+	void UpdatePresentTiming(const bool &presentIdUsed);
+
+	/**
+	 * Submits no work to the graphics queue, used by offscreen swapchains to wait on and signal the semaphores of a frame as a acquire and present would.
+	 */
+	static void SubmitSemaphore(const VkSemaphore &waitSemaphore, const VkSemaphore &signalSemaphore);
+
 	VkExtent2D m_extent;
+	PresentPolicy m_presentPolicy;
 	VkPresentModeKHR m_presentMode;
+	VkDeviceGroupPresentModeFlagsKHR m_deviceGroupPresentModes;
 
 	uint32_t m_imageCount;
 	VkSurfaceTransformFlagsKHR m_preTransform;
 	VkCompositeAlphaFlagBitsKHR m_compositeAlpha;
 	std::vector<VkImage> m_images;
 	std::vector<VkImageView> m_imageViews;
+	std::vector<MemoryAllocation> m_offscreenMemory;
 	VkSwapchainKHR m_swapchain;
 
 	VkFence m_fenceImage;
 	uint32_t m_activeImageIndex;
+
+	Time m_lastPresentTime;
+	Time m_presentInterval;
+	uint64_t m_presentCount;
+	uint64_t m_presentId;
 };
 }
@@ -30,6 +30,37 @@ public:
 	 */
 	virtual void Render(const CommandBuffer &commandBuffer) = 0;
 
+	/**
+	 * Records work that has to happen outside of the renderpass, such as compute dispatches, this is called before the stages renderpass begins.
+	 * @param commandBuffer The command buffer to record commands into.
+	 */
+	virtual void PreRender(const CommandBuffer &commandBuffer)
+	{
+	}
+
+	/**
+	 * Records compute work into the frames compute command buffer, this runs on the compute queue from the start of the frame alongside the earlier render stages.
+	 * The render stage of this subrender waits for the compute queue, so the results can be read when rendering, the command buffer can only record compute commands.
+	 * @param commandBuffer The compute command buffer to record commands into.
+	 * @return If any work was recorded.
+	 */
+	virtual bool RenderCompute(const CommandBuffer &commandBuffer)
+	{
+		return false;
+	}
+
+	/**
+	 * Gets a value that changes whenever the commands recorded by {@link Subrender#Render} would change, such as a count increased when its descriptors or instances change.
+	 * When subrenders are recorded into secondary command buffers, a subrender that gives a version is only recorded again when the version, the render area
+	 * or the render stage changes, otherwise the buffer recorded for the same framebuffer is replayed. The recorded commands must then only use buffers and
+	 * descriptor sets that outlive the frame, not the uniform ring or transient descriptor sets.
+	 * @return The version of the recorded commands, or nullopt if they are recorded every frame.
+	 */
+	virtual std::optional<uint64_t> GetVersion() const
+	{
+		return std::nullopt;
+	}
+
 	const Pipeline::Stage &GetStage() const { return m_stage; }
 
 	const bool &IsEnabled() const { return m_enabled; };
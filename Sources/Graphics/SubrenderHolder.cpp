@@ -1,10 +1,14 @@
 #include "SubrenderHolder.hpp"
 
+#include "Engine/Profiler.hpp"
+#include "Graphics.hpp"
+
 namespace acid
 {
 void SubrenderHolder::Clear()
 {
 	m_stages.clear();
+	ClearCache();
 }
 
 void SubrenderHolder::RemoveSubrenderStage(const TypeId &id)
@@ -20,6 +24,77 @@ void SubrenderHolder::RemoveSubrenderStage(const TypeId &id)
 			++it;
 		}
 	}
+
+	for (auto it = m_cached.begin(); it != m_cached.end();)
+	{
+		if (it->first.first == id)
+		{
+			Graphics::Get()->Retire(std::move(it->second.m_commandBuffer));
+			it = m_cached.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void SubrenderHolder::ClearCache()
+{
+	// Frames in flight may still execute the cached buffers.
+	for (auto &[key, cached] : m_cached)
+	{
+		Graphics::Get()->Retire(std::move(cached.m_commandBuffer));
+	}
+
+	m_cached.clear();
+}
+
+void SubrenderHolder::PreRenderStage(const uint32_t &renderpass, const CommandBuffer &commandBuffer)
+{
+	for (const auto &typeId : m_stages)
+	{
+		if (typeId.first.first.first != renderpass)
+		{
+			continue;
+		}
+
+		auto &subrender = m_subrenders[typeId.second];
+
+		if (subrender != nullptr)
+		{
+			if (subrender->IsEnabled())
+			{
+				Profiler::Scope scope(m_names[typeId.second] + " PreRender");
+				subrender->PreRender(commandBuffer);
+			}
+		}
+	}
+}
+
+std::optional<uint32_t> SubrenderHolder::RenderCompute(const CommandBuffer &commandBuffer)
+{
+	std::optional<uint32_t> renderpass;
+
+	for (const auto &typeId : m_stages)
+	{
+		auto &subrender = m_subrenders[typeId.second];
+
+		if (subrender == nullptr || !subrender->IsEnabled())
+		{
+			continue;
+		}
+
+		Profiler::Scope scope(m_names[typeId.second] + " RenderCompute");
+
+		// Stages are in order, the first one with compute work is the first that has to wait for it.
+		if (subrender->RenderCompute(commandBuffer) && !renderpass)
+		{
+			renderpass = typeId.first.first.first;
+		}
+	}
+
+	return renderpass;
 }
 
 void SubrenderHolder::RenderStage(const Pipeline::Stage &stage, const CommandBuffer &commandBuffer)
@@ -37,9 +112,111 @@ void SubrenderHolder::RenderStage(const Pipeline::Stage &stage, const CommandBuf
 		{
 			if (subrender->IsEnabled())
 			{
+				Profiler::Scope scope(m_names[typeId.second]);
 				subrender->Render(commandBuffer);
 			}
 		}
 	}
 }
+
+void SubrenderHolder::RenderStageSecondary(const Pipeline::Stage &stage, const CommandBuffer &commandBuffer, const VkCommandBufferInheritanceInfo &inheritanceInfo,
+	const VkRect2D &renderArea, ThreadPool &threadPool, std::vector<std::unique_ptr<CommandBuffer>> &secondaryBuffers)
+{
+	// Each subrender is either recorded on the thread pool, or replays the buffer cached for it when it has not changed.
+	std::vector<std::pair<std::future<std::unique_ptr<CommandBuffer>>, Cached *>> recordings;
+
+	for (const auto &typeId : m_stages)
+	{
+		if (typeId.first.first != stage)
+		{
+			continue;
+		}
+
+		auto subrender = m_subrenders[typeId.second].get();
+
+		if (subrender == nullptr || !subrender->IsEnabled())
+		{
+			continue;
+		}
+
+		Cached *cached = nullptr;
+
+		if (auto version = subrender->GetVersion())
+		{
+			cached = &m_cached[{ typeId.second, inheritanceInfo.framebuffer }];
+
+			if (cached->m_commandBuffer != nullptr && cached->m_version == *version && cached->m_renderArea.offset.x == renderArea.offset.x &&
+				cached->m_renderArea.offset.y == renderArea.offset.y && cached->m_renderArea.extent.width == renderArea.extent.width &&
+				cached->m_renderArea.extent.height == renderArea.extent.height)
+			{
+				recordings.emplace_back(std::future<std::unique_ptr<CommandBuffer>>(), cached);
+				continue;
+			}
+
+			cached->m_version = *version;
+			cached->m_renderArea = renderArea;
+		}
+
+		auto name = &m_names[typeId.second];
+		// Cached buffers may be executed by more than one frame in flight.
+		VkCommandBufferUsageFlags usage = cached != nullptr ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		recordings.emplace_back(threadPool.Enqueue([subrender, name, usage, &inheritanceInfo, &renderArea]()
+		{
+			// Allocated on the worker thread, so it comes from that threads command pool.
+			auto secondaryBuffer = std::make_unique<CommandBuffer>(false, VK_QUEUE_GRAPHICS_BIT, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+			secondaryBuffer->Begin(usage | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritanceInfo);
+
+			// Dynamic state is not inherited from the primary command buffer.
+			VkViewport viewport = {};
+			viewport.x = 0.0f;
+			viewport.y = 0.0f;
+			viewport.width = static_cast<float>(renderArea.extent.width);
+			viewport.height = static_cast<float>(renderArea.extent.height);
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			vkCmdSetViewport(*secondaryBuffer, 0, 1, &viewport);
+			vkCmdSetScissor(*secondaryBuffer, 0, 1, &renderArea);
+
+			{
+				Profiler::Scope scope(*name);
+				subrender->Render(*secondaryBuffer);
+			}
+
+			secondaryBuffer->End();
+			return secondaryBuffer;
+		}), cached);
+	}
+
+	std::vector<VkCommandBuffer> commandBuffers;
+	commandBuffers.reserve(recordings.size());
+
+	for (auto &[future, cached] : recordings)
+	{
+		if (!future.valid())
+		{
+			commandBuffers.emplace_back(*cached->m_commandBuffer);
+			continue;
+		}
+
+		auto secondaryBuffer = future.get();
+		commandBuffers.emplace_back(*secondaryBuffer);
+
+		if (cached != nullptr)
+		{
+			// The buffer replaced may still be executed by frames in flight.
+			Graphics::Get()->Retire(std::move(cached->m_commandBuffer));
+			cached->m_commandBuffer = std::move(secondaryBuffer);
+		}
+		else
+		{
+			secondaryBuffers.emplace_back(std::move(secondaryBuffer));
+		}
+	}
+
+	if (!commandBuffers.empty())
+	{
+		vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+	}
+}
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <typeinfo>
 #include "Helpers/NonCopyable.hpp"
+#include "Helpers/String.hpp"
+#include "Helpers/ThreadPool.hpp"
 #include "Pipelines/Pipeline.hpp"
 #include "Subrender.hpp"
 
@@ -54,6 +57,7 @@ public:
 
 		// Then, add the Subrender
 		m_subrenders[typeId] = std::move(subrender);
+		m_names[typeId] = String::Demangle(typeid(T).name());
 	}
 
 	/**
@@ -70,6 +74,7 @@ public:
 
 		// Then, remove the Subrender.
 		m_subrenders.erase(typeId);
+		m_names.erase(typeId);
 	}
 
 	/**
@@ -81,8 +86,38 @@ private:
 
 	using StageIndex = std::pair<Pipeline::Stage, std::size_t>;
 
+	/**
+	 * @brief A secondary command buffer kept for a subrender that gives a version, replayed while the version and render area stay the same.
+	 */
+	class Cached
+	{
+	public:
+		std::unique_ptr<CommandBuffer> m_commandBuffer;
+		uint64_t m_version = 0;
+		VkRect2D m_renderArea = {};
+	};
+
 	void RemoveSubrenderStage(const TypeId &id);
-	
+
+	/**
+	 * Releases every cached secondary command buffer, this is called when render stages are rebuilt as the buffers reference their framebuffers.
+	 */
+	void ClearCache();
+
+	/**
+	 * Calls pre render on all Subrenders in a renderpass, before the renderpass has begun.
+	 * @param renderpass The renderpass index.
+	 * @param commandBuffer The command buffer to record commands into.
+	 */
+	void PreRenderStage(const uint32_t &renderpass, const CommandBuffer &commandBuffer);
+
+	/**
+	 * Calls render compute on all Subrenders, before any renderpass has begun.
+	 * @param commandBuffer The compute command buffer to record commands into.
+	 * @return The first renderpass that reads the recorded work, or nullopt if nothing was recorded.
+	 */
+	std::optional<uint32_t> RenderCompute(const CommandBuffer &commandBuffer);
+
 	/**
 	 * Iterates through all Subrenders.
 	 * @param stage The Subrender stage.
@@ -90,10 +125,28 @@ private:
 	 */
 	void RenderStage(const Pipeline::Stage &stage, const CommandBuffer &commandBuffer);
 
+	/**
+	 * Records each Subrender in a stage into its own secondary command buffer on the thread pool, then executes them in stage order.
+	 * @param stage The Subrender stage.
+	 * @param commandBuffer The primary command buffer the secondary buffers are executed in.
+	 * @param inheritanceInfo The renderpass state the secondary buffers will inherit.
+	 * @param renderArea The render area used to set the viewport and scissor of each secondary buffer.
+	 * @param threadPool The thread pool used to record the secondary buffers.
+	 * @param secondaryBuffers The list that will own the recorded buffers until the frame has finished executing.
+	 */
+	void RenderStageSecondary(const Pipeline::Stage &stage, const CommandBuffer &commandBuffer, const VkCommandBufferInheritanceInfo &inheritanceInfo,
+		const VkRect2D &renderArea, ThreadPool &threadPool, std::vector<std::unique_ptr<CommandBuffer>> &secondaryBuffers);
+
 	// List of all Subrenders.
 	std::unordered_map<TypeId, std::unique_ptr<Subrender>> m_subrenders;
 
+	// Readable Subrender names, used to label profiler regions.
+	std::unordered_map<TypeId, std::string> m_names;
+
 	// List of subrender stages.
 	std::multimap<StageIndex, TypeId> m_stages;
+
+	// Secondary command buffers of versioned Subrenders, for each framebuffer they were recorded for.
+	std::map<std::pair<TypeId, VkFramebuffer>, Cached> m_cached;
 };
 }
@@ -2,7 +2,7 @@
 
 #include "Graphics/Graphics.hpp"
 #include "Models/Shapes/ModelRectangle.hpp"
-#include "Maths/Visual/DriverConstant.hpp"
+#include "Uis/Uis.hpp"
 
 namespace acid
 {
@@ -14,10 +14,15 @@ Gui::Gui(UiObject *parent, const UiBound &rectangle, std::shared_ptr<Image2d> im
 	m_selectedRow(0),
 	m_atlasScale(1.0f, 1.0f),
 	m_ninePatches(0.0f),
-	m_colourDriver(std::make_unique<DriverConstant<Colour>>(colourOffset))
+	m_colourOffset(colourOffset)
 {
 }
 
+Gui::~Gui()
+{
+	Tweens::Get()->Stop(m_colourTween);
+}
+
 void Gui::UpdateObject()
 {
 	int32_t numberOfRows = m_image != nullptr ? m_numberOfRows : 1;
@@ -25,10 +30,10 @@ void Gui::UpdateObject()
 	int32_t row = m_selectedRow / numberOfRows;
 	m_atlasOffset = Vector2f(static_cast<float>(column) / static_cast<float>(numberOfRows), static_cast<float>(row) / static_cast<float>(numberOfRows));
 
-	m_colourOffset = m_colourDriver->Update(Engine::Get()->GetDelta());
+	m_colourOffset = m_colourDriver ? m_colourDriver->Update(Engine::Get()->GetDelta()) : Tweens::Get()->GetValue(m_colourTween, m_colourOffset);
 
 	// Updates uniforms.
-	m_uniformObject.Push("aspectRatio", Window::Get()->GetAspectRatio());
+	m_uniformObject.Push("aspectRatio", Graphics::Get()->GetDisplayAspectRatio());
 	m_uniformObject.Push("modelMatrix", GetModelMatrix());
 	m_uniformObject.Push("screenOffset", Vector4f(2.0f * GetScreenSize(), 2.0f * GetScreenPosition() - 1.0f));
 	m_uniformObject.Push("modelMode", GetWorldTransform() ? (IsLockRotation() + 1) : 0);
@@ -42,6 +47,32 @@ void Gui::UpdateObject()
 	m_uniformObject.Push("ninePatches", m_ninePatches);
 }
 
+void Gui::SetColourDriver(Driver<Colour> *colourDriver)
+{
+	Tweens::Get()->Stop(m_colourTween);
+	m_colourDriver.reset(colourDriver);
+}
+
+void Gui::SetColourOffset(const Colour &colourOffset)
+{
+	SetColourDriver(nullptr);
+	m_colourOffset = colourOffset;
+}
+
+void Gui::TweenColourOffset(const Colour &colourOffset, const Time &length)
+{
+	SetColourDriver(nullptr);
+	m_colourTween = Tweens::Get()->Start(m_colourOffset, colourOffset, length);
+}
+
+void Gui::AddToLists(Uis &uis)
+{
+	if (m_image != nullptr)
+	{
+		uis.AddGui(this);
+	}
+}
+
 bool Gui::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
 {
 	// Gets if this should be rendered.
@@ -72,4 +103,14 @@ bool Gui::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &
 	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
 	return m_model->CmdRender(commandBuffer);
 }
+
+void Gui::WriteInstance(Instance &instance) const
+{
+	instance.m_modelMatrix = GetModelMatrix();
+	instance.m_screenOffset = Vector4f(2.0f * GetScreenSize(), 2.0f * GetScreenPosition() - 1.0f);
+	instance.m_colourOffset = m_colourOffset;
+	instance.m_ninePatches = m_ninePatches;
+	instance.m_atlas = Vector4f(m_atlasOffset, m_atlasScale);
+	instance.m_parameters = Vector4f(static_cast<float>(m_numberOfRows), GetScreenDepth(), GetScreenAlpha(), static_cast<float>(GetWorldTransform() ? (IsLockRotation() + 1) : 0));
+}
 }
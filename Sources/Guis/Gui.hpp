@@ -18,6 +18,41 @@ class ACID_EXPORT Gui :
 	public UiObject
 {
 public:
+	/**
+	 * @brief The per instance data used to draw a GUI in a batch, objects sharing a image are drawn with one instanced draw.
+	 */
+	class Instance
+	{
+	public:
+		static Shader::VertexInput GetVertexInput(const uint32_t &baseBinding = 0)
+		{
+			std::vector<VkVertexInputBindingDescription> bindingDescriptions = {
+				VkVertexInputBindingDescription{ baseBinding, sizeof(Instance), VK_VERTEX_INPUT_RATE_INSTANCE }
+			};
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+				VkVertexInputAttributeDescription{ 0, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_modelMatrix) + offsetof(Matrix4, m_rows[0]) },
+				VkVertexInputAttributeDescription{ 1, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_modelMatrix) + offsetof(Matrix4, m_rows[1]) },
+				VkVertexInputAttributeDescription{ 2, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_modelMatrix) + offsetof(Matrix4, m_rows[2]) },
+				VkVertexInputAttributeDescription{ 3, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_modelMatrix) + offsetof(Matrix4, m_rows[3]) },
+				VkVertexInputAttributeDescription{ 4, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_screenOffset) },
+				VkVertexInputAttributeDescription{ 5, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_colourOffset) },
+				VkVertexInputAttributeDescription{ 6, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_ninePatches) },
+				VkVertexInputAttributeDescription{ 7, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_atlas) },
+				VkVertexInputAttributeDescription{ 8, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_parameters) }
+			};
+			return Shader::VertexInput(bindingDescriptions, attributeDescriptions);
+		}
+
+		Matrix4 m_modelMatrix;
+		Vector4f m_screenOffset;
+		Colour m_colourOffset;
+		Vector4f m_ninePatches;
+		// The atlas offset in xy and scale in zw.
+		Vector4f m_atlas;
+		// The atlas rows, depth, alpha and model mode.
+		Vector4f m_parameters;
+	};
+
 	/**
 	 * Creates a new GUI object.
 	 * @param parent The parent screen object.
@@ -27,10 +62,20 @@ public:
 	 */
 	Gui(UiObject *parent, const UiBound &rectangle, std::shared_ptr<Image2d> image, const Colour &colourOffset = Colour::White);
 
+	~Gui();
+
 	void UpdateObject() override;
 
+	void AddToLists(Uis &uis) override;
+
 	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
 
+	/**
+	 * Writes the data this object is drawn with in a batch.
+	 * @param instance The instance to write into.
+	 */
+	void WriteInstance(Instance &instance) const;
+
 	const std::shared_ptr<Image2d> &GetImage() const { return m_image; }
 
 	void SetImage(const std::shared_ptr<Image2d> &image) { m_image = image; }
@@ -61,13 +106,26 @@ public:
 	Driver<Colour> *GetColourDriver() const { return m_colourDriver.get(); }
 
 	/**
-	 * Sets the colour offset driver.
-	 * @param colourDriver The new colour offset driver.
+	 * Sets the colour offset driver, it replaces any colour offset tween.
+	 * @param colourDriver The new colour offset driver, or nullptr to keep the current colour offset.
 	 */
-	void SetColourDriver(Driver<Colour> *colourDriver) { m_colourDriver.reset(colourDriver); }
+	void SetColourDriver(Driver<Colour> *colourDriver);
 
 	const Colour &GetColourOffset() const { return m_colourOffset; }
 
+	/**
+	 * Sets the colour offset, it replaces the colour offset driver and tween.
+	 * @param colourOffset The new colour offset.
+	 */
+	void SetColourOffset(const Colour &colourOffset);
+
+	/**
+	 * Slides the colour offset from its current value, it replaces the colour offset driver and tween.
+	 * @param colourOffset The colour offset to slide to.
+	 * @param length The time taken to get to the colour offset.
+	 */
+	void TweenColourOffset(const Colour &colourOffset, const Time &length);
+
 private:
 	DescriptorsHandler m_descriptorSet;
 	UniformHandler m_uniformObject;
@@ -81,6 +139,7 @@ private:
 	Vector4f m_ninePatches; // TODO: Use UiBound
 
 	std::unique_ptr<Driver<Colour>> m_colourDriver;
+	Tween m_colourTween;
 	Colour m_colourOffset;
 };
 }
@@ -1,15 +1,23 @@
 #include "SubrenderGuis.hpp"
 
+#include "Graphics/Graphics.hpp"
+#include "Models/Shapes/ModelRectangle.hpp"
 #include "Models/VertexDefault.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Uis/Uis.hpp"
-#include "Gui.hpp"
 
 namespace acid
 {
+static const uint32_t INITIAL_INSTANCES = 1024;
+// Descriptor sets for images that are not drawn are kept for a few frames, in case the frames in flight still use them.
+static const uint32_t MAX_UNUSED_FRAMES = 8;
+
 SubrenderGuis::SubrenderGuis(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
-	m_pipeline(pipelineStage, { "Shaders/Guis/Gui.vert", "Shaders/Guis/Gui.frag" }, { VertexDefault::GetVertexInput() })
+	m_pipeline(pipelineStage, { "Shaders/Guis/GuiBatch.vert", "Shaders/Guis/GuiBatch.frag" }, { VertexDefault::GetVertexInput(0), Gui::Instance::GetVertexInput(1) }),
+	m_model(ModelRectangle::Create(0.0f, 1.0f)),
+	m_maxInstances(INITIAL_INSTANCES),
+	m_instanceBuffer(std::make_unique<InstanceBuffer>(sizeof(Gui::Instance) * INITIAL_INSTANCES))
 {
 }
 
@@ -18,22 +26,126 @@ void SubrenderGuis::Render(const CommandBuffer &commandBuffer)
 	auto camera = Scenes::Get()->GetCamera();
 	m_uniformScene.Push("projection", camera->GetProjectionMatrix());
 	m_uniformScene.Push("view", camera->GetViewMatrix());
+	m_uniformScene.Push("aspectRatio", Graphics::Get()->GetDisplayAspectRatio());
+
+	m_guis.clear();
+
+	// The image may have been removed since the update.
+	for (const auto &gui : Uis::Get()->GetGuis())
+	{
+		if (gui->GetImage() != nullptr)
+		{
+			m_guis.emplace_back(gui);
+		}
+	}
+
+	if (m_guis.empty())
+	{
+		return;
+	}
+
+	// Back to front, so blending is done in order. Objects at the same depth are grouped by image.
+	std::stable_sort(m_guis.begin(), m_guis.end(), [](const Gui *a, const Gui *b)
+	{
+		if (a->GetScreenDepth() != b->GetScreenDepth())
+		{
+			return a->GetScreenDepth() < b->GetScreenDepth();
+		}
+
+		return a->GetImage().get() < b->GetImage().get();
+	});
+
+	if (m_guis.size() > m_maxInstances)
+	{
+		// The old buffer may still be read by frames in flight, it is destroyed once they have finished.
+		while (m_maxInstances < m_guis.size())
+		{
+			m_maxInstances *= 2;
+		}
+
+		m_instanceBuffer = std::make_unique<InstanceBuffer>(sizeof(Gui::Instance) * m_maxInstances);
+	}
+
+	m_batches.clear();
+	Gui::Instance *instances;
+	m_instanceBuffer->MapMemory(reinterpret_cast<void **>(&instances));
+
+	for (uint32_t i = 0; i < m_guis.size(); i++)
+	{
+		m_guis[i]->WriteInstance(instances[i]);
+
+		auto image = m_guis[i]->GetImage().get();
+		auto scissor = GetScissor(*m_guis[i]);
+
+		if (!m_batches.empty() && m_batches.back().m_image == image && std::memcmp(&m_batches.back().m_scissor, &scissor, sizeof(VkRect2D)) == 0)
+		{
+			m_batches.back().m_instances++;
+			continue;
+		}
+
+		m_batches.emplace_back(Batch{ image, scissor, i, 1 });
+	}
+
+	m_instanceBuffer->UnmapMemory();
+
+	for (auto &[image, descriptor] : m_descriptors)
+	{
+		descriptor.m_unusedFrames++;
+	}
 
 	m_pipeline.BindPipeline(commandBuffer);
 
-	for (const auto &screenObject : Uis::Get()->GetObjects())
+	VkBuffer vertexBuffers[] = { m_model->GetVertexBuffer()->GetBuffer(), m_instanceBuffer->GetBuffer() };
+	VkDeviceSize offsets[] = { 0, 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+	vkCmdBindIndexBuffer(commandBuffer, m_model->GetIndexBuffer()->GetBuffer(), 0, m_model->GetIndexType());
+
+	for (const auto &batch : m_batches)
 	{
-		if (!screenObject->IsEnabled())
+		auto &descriptor = m_descriptors[batch.m_image];
+
+		if (descriptor.m_image == nullptr)
+		{
+			descriptor.m_image = m_guis[batch.m_firstInstance]->GetImage();
+		}
+
+		descriptor.m_unusedFrames = 0;
+
+		// Updates descriptors.
+		descriptor.m_descriptorSet.Push("UniformScene", m_uniformScene);
+		descriptor.m_descriptorSet.Push("samplerColour", descriptor.m_image);
+
+		if (!descriptor.m_descriptorSet.Update(m_pipeline))
 		{
 			continue;
 		}
 
-		auto object = dynamic_cast<Gui *>(screenObject);
+		vkCmdSetScissor(commandBuffer, 0, 1, &batch.m_scissor);
+
+		// Draws the batch.
+		descriptor.m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+		vkCmdDrawIndexed(commandBuffer, m_model->GetIndexCount(), batch.m_instances, m_model->GetFirstIndex(), m_model->GetVertexOffset(), batch.m_firstInstance);
+	}
 
-		if (object != nullptr)
+	for (auto it = m_descriptors.begin(); it != m_descriptors.end();)
+	{
+		if (it->second.m_unusedFrames > MAX_UNUSED_FRAMES)
 		{
-			object->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
+			it = m_descriptors.erase(it);
+			continue;
 		}
+
+		++it;
 	}
 }
+
+VkRect2D SubrenderGuis::GetScissor(const Gui &gui) const
+{
+	VkRect2D scissorRect = {};
+	scissorRect.offset.x = static_cast<int32_t>(m_pipeline.GetRenderArea().GetExtent().m_x * gui.GetScissor().m_x);
+	scissorRect.offset.y = static_cast<int32_t>(m_pipeline.GetRenderArea().GetExtent().m_y * gui.GetScissor().m_y);
+	scissorRect.extent.width = static_cast<uint32_t>(m_pipeline.GetRenderArea().GetExtent().m_x * gui.GetScissor().m_z);
+	scissorRect.extent.height = static_cast<uint32_t>(m_pipeline.GetRenderArea().GetExtent().m_y * gui.GetScissor().m_w);
+	return scissorRect;
+}
 }
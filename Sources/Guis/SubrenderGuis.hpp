@@ -1,11 +1,19 @@
 #pragma once
 
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/InstanceBuffer.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Models/Model.hpp"
+#include "Gui.hpp"
 
 namespace acid
 {
+/**
+ * @brief Subrender that draws every GUI in batches, objects are sorted by their screen depth and then by image,
+ * each run of objects sharing a image and scissor is drawn with one instanced draw from a shared instance buffer.
+ */
 class ACID_EXPORT SubrenderGuis :
 	public Subrender
 {
@@ -15,7 +23,34 @@ public:
 	void Render(const CommandBuffer &commandBuffer) override;
 
 private:
+	class Batch
+	{
+	public:
+		Image2d *m_image;
+		VkRect2D m_scissor;
+		uint32_t m_firstInstance;
+		uint32_t m_instances;
+	};
+
+	class ImageDescriptor
+	{
+	public:
+		std::shared_ptr<Image2d> m_image;
+		DescriptorsHandler m_descriptorSet;
+		uint32_t m_unusedFrames = 0;
+	};
+
+	VkRect2D GetScissor(const Gui &gui) const;
+
 	PipelineGraphics m_pipeline;
 	UniformHandler m_uniformScene;
+	std::shared_ptr<Model> m_model;
+
+	uint32_t m_maxInstances;
+	std::unique_ptr<InstanceBuffer> m_instanceBuffer;
+	std::vector<Gui *> m_guis;
+	std::vector<Batch> m_batches;
+	// Descriptor sets are kept per image, so images drawn in several batches or over many frames share one set.
+	std::unordered_map<Image2d *, ImageDescriptor> m_descriptors;
 };
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include "NonCopyable.hpp"
+
+namespace acid
+{
+/**
+ * @brief A constant-sized lock free circular queue with one producer thread and one consumer thread.
+ * The producer only writes the head and the consumer only writes the tail, so neither waits on the other, a push to a full queue fails.
+ * @tparam T The type to hold.
+ * @tparam Capacity The number of values held, a power of two.
+ */
+template<typename T, std::size_t Capacity>
+class AtomicRingBuffer :
+	public NonCopyable
+{
+	static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	AtomicRingBuffer() :
+		m_head(0),
+		m_tail(0)
+	{
+	}
+
+	/**
+	 * Pushes a value, only called from the producer thread.
+	 * @param value The value.
+	 * @return If the value was pushed, false if the queue is full.
+	 */
+	bool Push(const T &value)
+	{
+		auto head = m_head.load(std::memory_order_relaxed);
+
+		if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+		{
+			return false;
+		}
+
+		m_data[head & (Capacity - 1)] = value;
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Pops the oldest value, only called from the consumer thread.
+	 * @param value The value popped.
+	 * @return If a value was popped, false if the queue is empty.
+	 */
+	bool Pop(T &value)
+	{
+		auto tail = m_tail.load(std::memory_order_relaxed);
+
+		if (tail == m_head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value = m_data[tail & (Capacity - 1)];
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool IsEmpty() const { return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire); }
+
+private:
+	std::array<T, Capacity> m_data;
+	// The head and tail are on separate cache lines so the producer and consumer do not share a line.
+	alignas(64) std::atomic<std::size_t> m_head;
+	alignas(64) std::atomic<std::size_t> m_tail;
+};
+}
@@ -6,7 +6,7 @@
 
 namespace acid
 {
-template<typename>
+template<typename, bool = true>
 class Delegate;
 
 class ACID_EXPORT Observer
@@ -28,21 +28,33 @@ class Invoker
 public:
 	using ReturnType = std::vector<TReturnType>;
 
-	static ReturnType Invoke(Delegate<TReturnType(TArgs ...)> &delegate, TArgs ... params)
+	template<typename TDelegate>
+	static ReturnType Invoke(TDelegate &delegate, TArgs ... params)
 	{
-		std::lock_guard<std::mutex> lock(delegate.m_mutex);
 		ReturnType returnValues;
+		auto functions = delegate.Load();
 
-		for (auto it = delegate.m_functions.begin(); it != delegate.m_functions.end();)
+		if (functions == nullptr)
 		{
-			if (it->IsExpired())
+			return returnValues;
+		}
+
+		auto expired = false;
+
+		for (const auto &function : *functions)
+		{
+			if (function.IsExpired())
 			{
-				it = delegate.m_functions.erase(it);
+				expired = true;
 				continue;
 			}
 
-			returnValues.emplace_back((*it->m_function)(params...));
-			++it;
+			returnValues.emplace_back(function.m_function(params...));
+		}
+
+		if (expired)
+		{
+			delegate.RemoveExpired();
 		}
 
 		return returnValues;
@@ -55,31 +67,46 @@ class Invoker<void, TArgs...>
 public:
 	using ReturnType = void;
 
-	static void Invoke(Delegate<void(TArgs ...)> &delegate, TArgs ... params)
+	template<typename TDelegate>
+	static void Invoke(TDelegate &delegate, TArgs ... params)
 	{
-		std::lock_guard<std::mutex> lock(delegate.m_mutex);
+		auto functions = delegate.Load();
 
-		if (delegate.m_functions.empty())
+		if (functions == nullptr)
 		{
 			return;
 		}
 
-		for (auto it = delegate.m_functions.begin(); it != delegate.m_functions.end();)
+		auto expired = false;
+
+		for (const auto &function : *functions)
 		{
-			if (it->IsExpired())
+			if (function.IsExpired())
 			{
-				it = delegate.m_functions.erase(it);
+				expired = true;
 				continue;
 			}
 
-			it->m_function(params...);
-			++it;
+			function.m_function(params...);
+		}
+
+		if (expired)
+		{
+			delegate.RemoveExpired();
 		}
 	}
 };
 
-template<typename TReturnType, typename ...TArgs>
-class Delegate<TReturnType(TArgs ...)>
+/**
+ * @brief A list of functions called when the delegate is invoked, a function is removed once any of the observers it was added with are destroyed.
+ * The functions are a copy on write list, adding or removing a function publishes a new list and invoking calls the functions in the list
+ * published when the invoke started, so functions may add or remove functions, or invoke the delegate, while it is being invoked.
+ * A thread safe delegate publishes the list atomically and serializes writers with a mutex, invoking never locks the mutex.
+ * A delegate that is not thread safe must only be used from one thread, and does no synchronization at all.
+ * @tparam ThreadSafe If the delegate may be added to and invoked from many threads at once.
+ */
+template<typename TReturnType, typename ...TArgs, bool ThreadSafe>
+class Delegate<TReturnType(TArgs ...), ThreadSafe>
 {
 public:
 	using Invoker = acid::Invoker<TReturnType, TArgs...>;
@@ -91,7 +118,7 @@ public:
 		FunctionType m_function;
 		ObserversType m_observers;
 
-		bool IsExpired()
+		bool IsExpired() const
 		{
 			for (const auto &observer : m_observers)
 			{
@@ -112,7 +139,6 @@ public:
 	template<typename ...KArgs>
 	void Add(FunctionType &&function, KArgs ...args)
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
 		ObserversType observers;
 
 		if constexpr (sizeof...(args) != 0)
@@ -123,22 +149,27 @@ public:
 			}
 		}
 
-		m_functions.emplace_back(FunctionPair{ std::move(function), observers });
+		Modify([&](FunctionsType &functions)
+		{
+			functions.emplace_back(FunctionPair{ std::move(function), std::move(observers) });
+		});
 	}
 
 	void Remove(const FunctionType &function)
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
-		m_functions.erase(std::remove_if(m_functions.begin(), m_functions.end(), [function](FunctionPair &f)
+		Modify([&function](FunctionsType &functions)
 		{
-			return Hash(f.m_function) == Hash(function);
-		}), m_functions.end());
+			functions.erase(std::remove_if(functions.begin(), functions.end(), [&function](const FunctionPair &f)
+			{
+				return Hash(f.m_function) == Hash(function);
+			}), functions.end());
+		});
 	}
 
 	void Clear()
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
-		m_functions.clear();
+		auto lock = Lock();
+		Store(nullptr);
 	}
 
 	typename Invoker::ReturnType Invoke(TArgs ... args)
@@ -148,12 +179,14 @@ public:
 
 	Delegate &operator+=(FunctionType &&function)
 	{
-		return Add(std::move(function));
+		Add(std::move(function));
+		return *this;
 	}
 
 	Delegate &operator-=(const FunctionType function)
 	{
-		return Remove(function);
+		Remove(function);
+		return *this;
 	}
 
 	typename Invoker::ReturnType operator()(TArgs ... args)
@@ -164,15 +197,85 @@ public:
 private:
 	friend Invoker;
 
-	static constexpr size_t Hash(const FunctionType &function)
+	using FunctionsType = std::vector<FunctionPair>;
+
+	static size_t Hash(const FunctionType &function)
 	{
 		return function.target_type().hash_code();
 	}
 
+	std::unique_lock<std::mutex> Lock()
+	{
+		if constexpr (ThreadSafe)
+		{
+			return std::unique_lock<std::mutex>(m_mutex);
+		}
+		else
+		{
+			return std::unique_lock<std::mutex>();
+		}
+	}
+
+	std::shared_ptr<const FunctionsType> Load() const
+	{
+		if constexpr (ThreadSafe)
+		{
+			return std::atomic_load(&m_functions);
+		}
+		else
+		{
+			return m_functions;
+		}
+	}
+
+	void Store(std::shared_ptr<const FunctionsType> functions)
+	{
+		if constexpr (ThreadSafe)
+		{
+			std::atomic_store(&m_functions, std::move(functions));
+		}
+		else
+		{
+			m_functions = std::move(functions);
+		}
+	}
+
+	/**
+	 * Publishes a modified copy of the functions, writers are serialized so only the writer holding the lock replaces the list.
+	 * @param modify The function that modifies the copy.
+	 */
+	template<typename T>
+	void Modify(const T &modify)
+	{
+		auto lock = Lock();
+		auto current = Load();
+		auto functions = current != nullptr ? std::make_shared<FunctionsType>(*current) : std::make_shared<FunctionsType>();
+		modify(*functions);
+		Store(functions->empty() ? nullptr : std::move(functions));
+	}
+
+	void RemoveExpired()
+	{
+		Modify([](FunctionsType &functions)
+		{
+			functions.erase(std::remove_if(functions.begin(), functions.end(), [](const FunctionPair &f)
+			{
+				return f.IsExpired();
+			}), functions.end());
+		});
+	}
+
 	std::mutex m_mutex;
-	std::vector<FunctionPair> m_functions;
+	/// The published functions, null when there are none so invoking a delegate without functions does not touch a list.
+	std::shared_ptr<const FunctionsType> m_functions;
 };
 
+/**
+ * A delegate that is only added to and invoked from one thread.
+ */
+template<typename T>
+using DelegateLocal = Delegate<T, false>;
+
 template<typename T>
 class DelegateValue :
 	public Delegate<void(T)>,
@@ -190,7 +293,7 @@ public:
 	DelegateValue &operator=(T value)
 	{
 		m_value = value;
-		Invoke(m_value);
+		this->Invoke(m_value);
 		return *this;
 	}
 
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace acid
+{
+/**
+ * Sorts items by a 64 bit key with a stable least significant digit radix sort, one pass per byte of the key.
+ * Passes where every key has the same byte are skipped, so keys that only use some of their bits sort in fewer passes.
+ * @tparam T The type of item.
+ * @tparam K The function type that gets the key of a item.
+ * @param items The items to sort.
+ * @param scratch A buffer the size of the items, kept by the caller to avoid allocating every sort.
+ * @param key The function that gets the key of a item, called several times for each item.
+ */
+template<typename T, typename K>
+void RadixSort(std::vector<T> &items, std::vector<T> &scratch, K &&key)
+{
+	if (items.size() < 2)
+	{
+		return;
+	}
+
+	scratch.resize(items.size());
+
+	for (uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		std::array<std::size_t, 256> offsets = {};
+
+		for (const auto &item : items)
+		{
+			offsets[(key(item) >> shift) & 0xFF]++;
+		}
+
+		if (offsets[(key(items.front()) >> shift) & 0xFF] == items.size())
+		{
+			continue;
+		}
+
+		std::size_t offset = 0;
+
+		for (auto &count : offsets)
+		{
+			auto bucketSize = count;
+			count = offset;
+			offset += bucketSize;
+		}
+
+		for (auto &item : items)
+		{
+			scratch[offsets[(key(item) >> shift) & 0xFF]++] = std::move(item);
+		}
+
+		items.swap(scratch);
+	}
+}
+}
@@ -1,27 +1,18 @@
 #include "String.hpp"
 #include <string_view>
+#if !defined(ACID_BUILD_MSVC)
+#include <cxxabi.h>
+#endif
 
 namespace acid
 {
 std::vector<std::string> String::Split(const std::string &str, const std::string &sep, bool trim)
 {
-	std::unique_ptr<char[]> copy(new char[strlen(str.c_str()) + 1]);
-	std::strcpy(copy.get(), str.c_str());
-
 	std::vector<std::string> splitVector;
-	auto current = std::strtok(copy.get(), sep.c_str());
 
-	while (current != nullptr)
+	for (const auto &part : SplitView(str, sep, trim))
 	{
-		auto currentS = std::string(current);
-
-		if (trim)
-		{
-			currentS = Trim(currentS);
-		}
-
-		splitVector.emplace_back(currentS);
-		current = std::strtok(nullptr, sep.c_str());
+		splitVector.emplace_back(part);
 	}
 
 	return splitVector;
@@ -54,26 +45,41 @@ int String::FindCharPos(std::string_view str, char c)
 }
 
 std::string String::Trim(std::string str, std::string_view whitespace)
+{
+	TrimInPlace(str, whitespace);
+	return str;
+}
+
+std::string_view String::TrimView(std::string_view str, std::string_view whitespace)
 {
 	auto strBegin = str.find_first_not_of(whitespace);
 
 	if (strBegin == std::string::npos)
 	{
-		return "";
+		return str.substr(0, 0);
 	}
 
 	auto strEnd = str.find_last_not_of(whitespace);
-	auto strRange = strEnd - strBegin + 1;
+	return str.substr(strBegin, strEnd - strBegin + 1);
+}
+
+void String::TrimInPlace(std::string &str, std::string_view whitespace)
+{
+	auto strEnd = str.find_last_not_of(whitespace);
 
-	auto trimmed = str;
-	trimmed = trimmed.substr(strBegin, strRange);
-	return trimmed;
+	if (strEnd == std::string::npos)
+	{
+		str.clear();
+		return;
+	}
+
+	str.erase(strEnd + 1);
+	str.erase(0, str.find_first_not_of(whitespace));
 }
 
 std::string String::Substring(std::string str, uint32_t start, uint32_t end)
 {
-	str = str.substr(start, end - start);
-	return str;
+	return str.substr(start, end - start);
 }
 
 std::string String::RemoveAll(std::string str, char token)
@@ -134,9 +140,87 @@ std::string String::Lowercase(std::string str)
 	return str;
 }
 
+bool String::EqualsIgnoreCase(std::string_view a, std::string_view b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char l, char r)
+	{
+		return std::tolower(static_cast<unsigned char>(l)) == std::tolower(static_cast<unsigned char>(r));
+	});
+}
+
 std::string String::Uppercase(std::string str)
 {
 	std::transform(str.begin(), str.end(), str.begin(), toupper);
 	return str;
 }
+
+char32_t String::DecodeUtf8(std::string_view str, std::size_t &index)
+{
+	static const char32_t replacement = 0xFFFD;
+
+	auto lead = static_cast<uint8_t>(str[index++]);
+
+	if (lead < 0x80)
+	{
+		return lead;
+	}
+
+	uint32_t length;
+	char32_t codepoint;
+	char32_t minimum;
+
+	if ((lead & 0xE0) == 0xC0)
+	{
+		length = 1;
+		codepoint = lead & 0x1F;
+		minimum = 0x80;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 2;
+		codepoint = lead & 0x0F;
+		minimum = 0x800;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 3;
+		codepoint = lead & 0x07;
+		minimum = 0x10000;
+	}
+	else
+	{
+		return replacement;
+	}
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		// A missing continuation byte is left to be decoded on its own.
+		if (index >= str.size() || (static_cast<uint8_t>(str[index]) & 0xC0) != 0x80)
+		{
+			return replacement;
+		}
+
+		codepoint = (codepoint << 6) | (static_cast<uint8_t>(str[index++]) & 0x3F);
+	}
+
+	// Overlong encodings, surrogates and values past the last code point are invalid.
+	if (codepoint < minimum || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+	{
+		return replacement;
+	}
+
+	return codepoint;
+}
+
+std::string String::Demangle(const std::string &name)
+{
+#if defined(ACID_BUILD_MSVC)
+	auto result = ReplaceAll(ReplaceAll(name, "class ", ""), "struct ", "");
+#else
+	int32_t status = 0;
+	std::unique_ptr<char, decltype(&std::free)> demangled(abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status), &std::free);
+	auto result = status == 0 ? std::string(demangled.get()) : name;
+#endif
+	return ReplaceAll(result, "acid::", "");
+}
 }
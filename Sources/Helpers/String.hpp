@@ -1,5 +1,6 @@
 #pragma once
 
+#include <charconv>
 #include <locale>
 #include "ConstExpr.hpp"
 
@@ -11,6 +12,98 @@ namespace acid
 class ACID_EXPORT String
 {
 public:
+	/**
+	 * @brief A range over the parts of a string between separators, without copying them.
+	 * The parts are views into the string, so the string must outlive the range.
+	 */
+	class SplitRange
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view *;
+			using reference = const std::string_view &;
+
+			Iterator(const SplitRange *range, const std::size_t &position) :
+				m_range(range),
+				m_position(position)
+			{
+				Next();
+			}
+
+			reference operator*() const { return m_part; }
+
+			pointer operator->() const { return &m_part; }
+
+			Iterator &operator++()
+			{
+				Next();
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				auto copy = *this;
+				Next();
+				return copy;
+			}
+
+			bool operator==(const Iterator &other) const { return m_position == other.m_position; }
+
+			bool operator!=(const Iterator &other) const { return m_position != other.m_position; }
+
+		private:
+			void Next()
+			{
+				if (m_position == std::string_view::npos)
+				{
+					return;
+				}
+
+				// Any character of the separator ends a part and empty parts are skipped, the same as strtok.
+				auto start = m_range->m_str.find_first_not_of(m_range->m_sep, m_position);
+
+				if (start == std::string_view::npos)
+				{
+					m_position = std::string_view::npos;
+					return;
+				}
+
+				m_position = std::min(m_range->m_str.find_first_of(m_range->m_sep, start), m_range->m_str.size());
+				m_part = m_range->m_str.substr(start, m_position - start);
+
+				if (m_range->m_trim)
+				{
+					m_part = TrimView(m_part);
+				}
+			}
+
+			const SplitRange *m_range;
+			std::size_t m_position;
+			std::string_view m_part;
+		};
+
+		SplitRange(std::string_view str, std::string_view sep, bool trim) :
+			m_str(str),
+			m_sep(sep),
+			m_trim(trim)
+		{
+		}
+
+		Iterator begin() const { return Iterator(this, 0); }
+
+		Iterator end() const { return Iterator(this, std::string_view::npos); }
+
+	private:
+		std::string_view m_str;
+		std::string_view m_sep;
+		bool m_trim;
+	};
+
 	/**
 	 * Splits a string by a separator.
 	 * @param str The string.
@@ -20,6 +113,15 @@ public:
 	 */
 	static std::vector<std::string> Split(const std::string &str, const std::string &sep, bool trim = false);
 
+	/**
+	 * Splits a string by a separator without allocating, each part is a view into the string.
+	 * @param str The string, must outlive the returned range.
+	 * @param sep The separator, any of its characters separate parts.
+	 * @param trim If each part should be trimmed.
+	 * @return The range of parts.
+	 */
+	static SplitRange SplitView(std::string_view str, std::string_view sep, bool trim = false) { return SplitRange(str, sep, trim); }
+
 	/**
 	 * Gets if a string starts with a token.
 	 * @param str The string.
@@ -59,6 +161,21 @@ public:
 	 */
 	static std::string Trim(std::string str, std::string_view whitespace = " \t\n\r");
 
+	/**
+	 * Trims the left and right side of a string view of whitespace.
+	 * @param str The string view.
+	 * @param whitespace The whitespace type.
+	 * @return The trimmed view into the string.
+	 */
+	static std::string_view TrimView(std::string_view str, std::string_view whitespace = " \t\n\r");
+
+	/**
+	 * Trims the left and right side of a string of whitespace without reallocating it.
+	 * @param str The string to trim.
+	 * @param whitespace The whitespace type.
+	 */
+	static void TrimInPlace(std::string &str, std::string_view whitespace = " \t\n\r");
+
 	/**
 	 * Takes a substring of a string between two bounds.
 	 * @param str The string.
@@ -116,6 +233,14 @@ public:
 	 */
 	static std::string Lowercase(std::string str);
 
+	/**
+	 * Gets if two strings are equal ignoring the case of ASCII letters.
+	 * @param a The first string.
+	 * @param b The second string.
+	 * @return If the strings are equal.
+	 */
+	static bool EqualsIgnoreCase(std::string_view a, std::string_view b);
+
 	/**
 	 * Uppercases a string.
 	 * @param str The string.
@@ -123,6 +248,21 @@ public:
 	 */
 	static std::string Uppercase(std::string str);
 
+	/**
+	 * Decodes the UTF-8 code point starting at a index, invalid or truncated sequences decode to the replacement character.
+	 * @param str The string.
+	 * @param index The byte index to decode from, moved past the decoded bytes.
+	 * @return The code point.
+	 */
+	static char32_t DecodeUtf8(std::string_view str, std::size_t &index);
+
+	/**
+	 * Converts a compiler type name, as returned by {@code typeid(T).name()}, into a readable name without the acid namespace.
+	 * @param name The type name.
+	 * @return The readable type name.
+	 */
+	static std::string Demangle(const std::string &name);
+
 	/**
 	 * Converts a type to a string.
 	 * @tparam T The type to convert from.
@@ -145,6 +285,26 @@ public:
 		{
 			return val;
 		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			// The shortest text that parses back to the same value, whole numbers keep a decimal point so they are still read as real numbers.
+			char buffer[64];
+			auto end = std::to_chars(buffer, buffer + sizeof(buffer), val).ptr;
+			std::string str(buffer, end);
+
+			if (str.find_first_not_of("-0123456789") == std::string::npos)
+			{
+				str += ".0";
+			}
+
+			return str;
+		}
+		else if constexpr (std::is_integral_v<T>)
+		{
+			char buffer[24];
+			auto end = std::to_chars(buffer, buffer + sizeof(buffer), val).ptr;
+			return std::string(buffer, end);
+		}
 		else
 		{
 			return std::to_string(static_cast<T>(val));
@@ -167,7 +327,7 @@ public:
 		}
 		else if constexpr (std::is_same_v<bool, T>)
 		{
-			return Lowercase(str) == "true" || From<std::optional<int32_t>>(str) == 1;
+			return EqualsIgnoreCase(str, "true") || From<std::optional<int32_t>>(str) == 1;
 		}
 		else if constexpr (std::is_same_v<std::string, T>)
 		{
@@ -177,15 +337,32 @@ public:
 		{
 			typedef typename T::value_type base_type;
 			base_type temp;
-			std::istringstream iss(str);
 
-			if ((iss >> temp).fail())
+			if constexpr (std::is_arithmetic_v<base_type> && !std::is_same_v<bool, base_type>)
+			{
+				if (!Parse(str, temp))
+				{
+					return {};
+				}
+			}
+			else
 			{
-				return {};
+				std::istringstream iss(str);
+
+				if ((iss >> temp).fail())
+				{
+					return {};
+				}
 			}
 
 			return temp;
 		}
+		else if constexpr (std::is_arithmetic_v<T>)
+		{
+			T temp = 0;
+			Parse(str, temp);
+			return temp;
+		}
 		else
 		{
 			T temp;
@@ -194,5 +371,38 @@ public:
 			return temp;
 		}
 	}
+
+private:
+	/**
+	 * Parses a number from the start of a string, skipping leading whitespace and a plus sign like stream extraction does.
+	 * @tparam T The arithmetic type to parse.
+	 * @param str The string to parse.
+	 * @param value The parsed value, zero if the string does not start with a number.
+	 * @return If a number was parsed.
+	 */
+	template<typename T>
+	static bool Parse(std::string_view str, T &value)
+	{
+		auto first = str.data();
+		auto last = str.data() + str.size();
+
+		while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+		{
+			first++;
+		}
+
+		if (first != last && *first == '+')
+		{
+			first++;
+		}
+
+		if (std::from_chars(first, last, value).ec != std::errc())
+		{
+			value = 0;
+			return false;
+		}
+
+		return true;
+	}
 };
 }
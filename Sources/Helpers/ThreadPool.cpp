@@ -2,36 +2,92 @@
 
 namespace acid
 {
+// The pool and deque index of the calling worker thread, workers from other pools and non worker threads have no deque.
+static thread_local const ThreadPool *WORKER_POOL = nullptr;
+static thread_local std::size_t WORKER_INDEX = 0;
+
+ThreadPool::Task::Task(Task &&other) noexcept
+{
+	*this = std::move(other);
+}
+
+ThreadPool::Task::~Task()
+{
+	Reset();
+}
+
+ThreadPool::Task &ThreadPool::Task::operator=(Task &&other) noexcept
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	Reset();
+
+	if (other.m_invoke != nullptr)
+	{
+		other.m_move(&m_buffer, &other.m_buffer);
+		m_invoke = other.m_invoke;
+		m_move = other.m_move;
+		m_destroy = other.m_destroy;
+		other.m_invoke = nullptr;
+		other.m_move = nullptr;
+		other.m_destroy = nullptr;
+	}
+
+	return *this;
+}
+
+void ThreadPool::Task::Reset()
+{
+	if (m_destroy != nullptr)
+	{
+		m_destroy(&m_buffer);
+	}
+
+	m_invoke = nullptr;
+	m_move = nullptr;
+	m_destroy = nullptr;
+}
+
 ThreadPool::ThreadPool(const uint32_t &threadCount) :
+	m_nextQueue(0),
+	m_queued(0),
 	m_stop(false)
 {
-	m_workers.reserve(threadCount);
+	auto workerCount = std::max(threadCount, 1u);
+	m_workers.reserve(workerCount);
+
+	for (uint32_t i = 0; i < workerCount; i++)
+	{
+		m_queues.emplace_back(std::make_unique<Queue>());
+	}
 
-	for (size_t i = 0; i < threadCount; ++i)
+	for (uint32_t i = 0; i < workerCount; i++)
 	{
-		m_workers.emplace_back([this]
+		m_workers.emplace_back([this, i]
 		{
+			WORKER_POOL = this;
+			WORKER_INDEX = i;
+
 			while (true)
 			{
-				std::function<void()> task;
-
+				if (RunOne())
 				{
-					std::unique_lock<std::mutex> lock(m_queueMutex);
-					m_condition.wait(lock, [this]
-					{
-						return m_stop || !m_tasks.empty();
-					});
-
-					if (m_stop && m_tasks.empty())
-					{
-						return;
-					}
-
-					task = std::move(m_tasks.front());
-					m_tasks.pop();
+					continue;
 				}
 
-				task();
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_condition.wait(lock, [this]
+				{
+					return m_stop || m_queued.load() != 0;
+				});
+
+				if (m_stop && m_queued.load() == 0)
+				{
+					return;
+				}
 			}
 		});
 	}
@@ -40,7 +96,7 @@ ThreadPool::ThreadPool(const uint32_t &threadCount) :
 ThreadPool::~ThreadPool()
 {
 	{
-		std::unique_lock<std::mutex> lock(m_queueMutex);
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
 		m_stop = true;
 	}
 
@@ -52,13 +108,153 @@ ThreadPool::~ThreadPool()
 	}
 }
 
+void ThreadPool::Dispatch(Task &&task, Counter *counter, const Counter *dependency)
+{
+	if (counter != nullptr)
+	{
+		counter->m_value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	m_unfinished.m_value.fetch_add(1, std::memory_order_relaxed);
+
+	Job job = {};
+	job.m_task = std::move(task);
+	job.m_counter = counter;
+
+	if (dependency != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(m_waitingMutex);
+
+		// Checked under the lock, the job is released by the last job of the dependency otherwise.
+		if (!dependency->IsDone())
+		{
+			m_waiting.emplace_back(dependency, std::move(job));
+			return;
+		}
+	}
+
+	Push(std::move(job));
+}
+
+void ThreadPool::Wait(const Counter &counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!RunOne())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
 void ThreadPool::Wait()
 {
-	std::unique_lock<std::mutex> lock(m_queueMutex);
+	Wait(m_unfinished);
+}
+
+void ThreadPool::Push(Job &&job)
+{
+	// Workers push to their own deque, other threads spread jobs over the deques.
+	auto index = WORKER_POOL == this ? WORKER_INDEX : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+	{
+		std::lock_guard<std::mutex> lock(m_queues[index]->m_mutex);
+		m_queues[index]->m_jobs.emplace_back(std::move(job));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_queued.fetch_add(1);
+	}
+
+	m_condition.notify_one();
+}
+
+bool ThreadPool::Pop(Job &job)
+{
+	if (m_queued.load() == 0)
+	{
+		return false;
+	}
+
+	auto owned = WORKER_POOL == this;
+	auto start = owned ? WORKER_INDEX : m_nextQueue.load(std::memory_order_relaxed) % m_queues.size();
+
+	// A worker takes its newest job first, then steals the oldest job of the other deques.
+	for (std::size_t i = 0; i < m_queues.size(); i++)
+	{
+		auto &queue = *m_queues[(start + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+
+		if (queue.m_jobs.empty())
+		{
+			continue;
+		}
+
+		if (owned && i == 0)
+		{
+			job = std::move(queue.m_jobs.back());
+			queue.m_jobs.pop_back();
+		}
+		else
+		{
+			job = std::move(queue.m_jobs.front());
+			queue.m_jobs.pop_front();
+		}
+
+		m_queued.fetch_sub(1);
+		return true;
+	}
+
+	return false;
+}
+
+bool ThreadPool::RunOne()
+{
+	Job job;
 
-	m_condition.wait(lock, [this]()
+	if (!Pop(job))
 	{
-		return m_tasks.empty();
-	});
+		return false;
+	}
+
+	job.m_task();
+	job.m_task = {};
+	Finish(job.m_counter);
+	return true;
+}
+
+void ThreadPool::Finish(Counter *counter)
+{
+	m_unfinished.m_value.fetch_sub(1, std::memory_order_acq_rel);
+
+	if (counter == nullptr || counter->m_value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+	{
+		return;
+	}
+
+	// The counter reached zero, jobs waiting on it can be scheduled.
+	std::vector<Job> released;
+
+	{
+		std::lock_guard<std::mutex> lock(m_waitingMutex);
+
+		for (auto it = m_waiting.begin(); it != m_waiting.end();)
+		{
+			if (it->first == counter)
+			{
+				released.emplace_back(std::move(it->second));
+				it = m_waiting.erase(it);
+				continue;
+			}
+
+			++it;
+		}
+	}
+
+	for (auto &job : released)
+	{
+		Push(std::move(job));
+	}
 }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <queue>
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include "StdAfx.hpp"
@@ -8,55 +10,235 @@
 namespace acid
 {
 /**
- * @brief A fixed size pool of threads.
+ * @brief A fixed size pool of threads that schedules jobs by work stealing.
+ * Each worker owns a deque, jobs dispatched from a worker are pushed to its own deque and run newest first, idle workers steal the oldest jobs from other deques.
+ * Jobs can signal a {@link ThreadPool::Counter} when finished, and can wait for a counter to reach zero before being scheduled.
  */
 class ACID_EXPORT ThreadPool
 {
 public:
+	/**
+	 * @brief A move only callable that stores small functors inline, larger functors are allocated on the heap.
+	 */
+	class ACID_EXPORT Task
+	{
+	public:
+		Task() = default;
+
+		template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+		Task(F &&f);
+
+		Task(Task &&other) noexcept;
+
+		~Task();
+
+		Task &operator=(Task &&other) noexcept;
+
+		void operator()() { m_invoke(&m_buffer); }
+
+		explicit operator bool() const { return m_invoke != nullptr; }
+
+	private:
+		static constexpr std::size_t BUFFER_SIZE = 48;
+
+		void Reset();
+
+		std::aligned_storage_t<BUFFER_SIZE, alignof(std::max_align_t)> m_buffer;
+		void (*m_invoke)(void *) = nullptr;
+		void (*m_move)(void *, void *) = nullptr;
+		void (*m_destroy)(void *) = nullptr;
+	};
+
+	/**
+	 * @brief Counts unfinished jobs, a counter is zero when every job dispatched with it has finished.
+	 */
+	class ACID_EXPORT Counter
+	{
+	public:
+		Counter() = default;
+
+		Counter(const Counter &) = delete;
+
+		Counter &operator=(const Counter &) = delete;
+
+		bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class ThreadPool;
+
+		std::atomic<uint32_t> m_value = 0;
+	};
+
 	explicit ThreadPool(const uint32_t &threadCount = std::thread::hardware_concurrency());
 
 	~ThreadPool();
 
+	/**
+	 * Enqueues a function, the result is returned as a future.
+	 * @tparam F The function type.
+	 * @tparam Args The argument types.
+	 * @param f The function.
+	 * @param args The arguments bound to the function.
+	 * @return The future result.
+	 */
 	template<class F, class... Args>
 	decltype(auto) Enqueue(F &&f, Args &&... args);
 
+	/**
+	 * Dispatches a job without a future.
+	 * @param task The job.
+	 * @param counter A optional counter that is incremented now and decremented once the job has finished.
+	 * @param dependency A optional counter that must reach zero before the job is scheduled.
+	 */
+	void Dispatch(Task &&task, Counter *counter = nullptr, const Counter *dependency = nullptr);
+
+	/**
+	 * Runs a function for every index in a range, split into jobs of grain size indices. The calling thread helps run the jobs and returns once all have finished.
+	 * @tparam F The function type, called with a std::size_t index.
+	 * @param begin The first index.
+	 * @param end One past the last index.
+	 * @param f The function.
+	 * @param grainSize The indices per job, if zero the range is split into a few jobs per worker.
+	 */
+	template<class F>
+	void ParallelFor(const std::size_t &begin, const std::size_t &end, F &&f, std::size_t grainSize = 0);
+
+	/**
+	 * Runs jobs on the calling thread until a counter reaches zero.
+	 * @param counter The counter to wait for.
+	 */
+	void Wait(const Counter &counter);
+
+	/**
+	 * Runs jobs on the calling thread until every dispatched job has finished.
+	 */
 	void Wait();
 
 	const std::vector<std::thread> &GetWorkers() const { return m_workers; }
 
 private:
+	class Job
+	{
+	public:
+		Task m_task;
+		Counter *m_counter = nullptr;
+	};
+
+	class Queue
+	{
+	public:
+		std::mutex m_mutex;
+		std::deque<Job> m_jobs;
+	};
+
+	void Push(Job &&job);
+
+	bool Pop(Job &job);
+
+	bool RunOne();
+
+	void Finish(Counter *counter);
+
 	std::vector<std::thread> m_workers;
-	std::queue<std::function<void()>> m_tasks;
+	std::vector<std::unique_ptr<Queue>> m_queues;
+	std::atomic<uint32_t> m_nextQueue;
+
+	std::mutex m_waitingMutex;
+	std::vector<std::pair<const Counter *, Job>> m_waiting;
 
-	std::mutex m_queueMutex;
+	std::atomic<std::size_t> m_queued;
+	Counter m_unfinished;
+
+	std::mutex m_sleepMutex;
 	std::condition_variable m_condition;
-	bool m_stop;
+	std::atomic<bool> m_stop;
 };
 
+template<typename F, typename>
+ThreadPool::Task::Task(F &&f)
+{
+	using Type = std::decay_t<F>;
+
+	if constexpr (sizeof(Type) <= BUFFER_SIZE && alignof(Type) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Type>)
+	{
+		new(&m_buffer) Type(std::forward<F>(f));
+		m_invoke = [](void *buffer)
+		{
+			(*static_cast<Type *>(buffer))();
+		};
+		m_move = [](void *dst, void *src)
+		{
+			new(dst) Type(std::move(*static_cast<Type *>(src)));
+			static_cast<Type *>(src)->~Type();
+		};
+		m_destroy = [](void *buffer)
+		{
+			static_cast<Type *>(buffer)->~Type();
+		};
+	}
+	else
+	{
+		new(&m_buffer) Type *(new Type(std::forward<F>(f)));
+		m_invoke = [](void *buffer)
+		{
+			(**static_cast<Type **>(buffer))();
+		};
+		m_move = [](void *dst, void *src)
+		{
+			new(dst) Type *(*static_cast<Type **>(src));
+		};
+		m_destroy = [](void *buffer)
+		{
+			delete *static_cast<Type **>(buffer);
+		};
+	}
+}
+
 template<class F, class ... Args>
 decltype(auto) ThreadPool::Enqueue(F &&f, Args &&... args)
 {
 	using return_type = typename std::result_of<F(Args...)>::type;
 
-	auto task = std::make_shared<std::packaged_task<return_type()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+	std::packaged_task<return_type()> task(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+	auto result = task.get_future();
 
-	auto result = task->get_future();
+	if (m_stop)
+	{
+		throw std::runtime_error("Enqueue called on a stopped ThreadPool");
+	}
+
+	Dispatch(std::move(task));
+	return result;
+}
+
+template<class F>
+void ThreadPool::ParallelFor(const std::size_t &begin, const std::size_t &end, F &&f, std::size_t grainSize)
+{
+	if (begin >= end)
+	{
+		return;
+	}
 
+	if (grainSize == 0)
 	{
-		std::unique_lock<std::mutex> lock(m_queueMutex);
+		grainSize = std::max<std::size_t>((end - begin) / (4 * (m_workers.size() + 1)), 1);
+	}
 
-		if (m_stop)
-		{
-			throw std::runtime_error("Enqueue called on a stopped ThreadPool");
-		}
+	Counter counter;
 
-		m_tasks.emplace([task]()
+	for (auto chunk = begin; chunk < end; chunk += grainSize)
+	{
+		auto chunkEnd = std::min(chunk + grainSize, end);
+
+		Dispatch([&f, chunk, chunkEnd]()
 		{
-			(*task)();
-		});
+			for (auto i = chunk; i < chunkEnd; i++)
+			{
+				f(i);
+			}
+		}, &counter);
 	}
 
-	m_condition.notify_one();
-	return result;
+	Wait(counter);
 }
 }
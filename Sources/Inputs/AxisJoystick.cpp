@@ -9,7 +9,13 @@ AxisJoystick::AxisJoystick(const uint32_t &port, const uint32_t &axis, const boo
 	m_axis(axis),
 	m_inverted(inverted)
 {
-	Joysticks::Get()->OnAxis().Add([this](uint32_t axis, uint32_t port, float value)
+	// Headless engines have no joysticks, the axis stays centred.
+	if (!Engine::Get()->HasModule<Joysticks>())
+	{
+		return;
+	}
+
+	Joysticks::Get()->OnAxis().Add([this](uint32_t port, uint32_t axis, float value)
 	{
 		if (port == m_port && axis == m_axis)
 		{
@@ -20,6 +26,11 @@ AxisJoystick::AxisJoystick(const uint32_t &port, const uint32_t &axis, const boo
 
 float AxisJoystick::GetAmount() const
 {
+	if (!Engine::Get()->HasModule<Joysticks>())
+	{
+		return 0.0f;
+	}
+
 	return Joysticks::Get()->GetAxis(m_port, m_axis) * (m_inverted ? -1.0f : 1.0f);
 }
 }
@@ -12,6 +12,18 @@ class ACID_EXPORT Button :
 	public Observer
 {
 public:
+	Button() :
+		m_presses(0)
+	{
+		m_onButton.Add([this](InputAction action, BitMask<InputMod> mods)
+		{
+			if (action == InputAction::Press)
+			{
+				m_presses++;
+			}
+		});
+	}
+
 	virtual ~Button() = default;
 
 	/**
@@ -21,14 +33,15 @@ public:
 	virtual bool IsDown() const = 0;
 
 	/**
-	 * Gets if the key is down and was not down before. Key press recognized as one click.
-	 * @return Is the key down and was not down before?
+	 * Gets if the button was pressed since this was last called. Presses are counted from the button events,
+	 * so a button pressed and released between two calls is still read as one click.
+	 * @return If the button was pressed.
 	 */
 	bool WasDown()
 	{
-		bool stillDown = m_wasDown && IsDown();
-		m_wasDown = IsDown();
-		return m_wasDown == !stillDown;
+		auto pressed = m_presses != 0;
+		m_presses = 0;
+		return pressed;
 	}
 
 	/**
@@ -41,6 +54,6 @@ protected:
 	Delegate<void(InputAction, BitMask < InputMod > )> m_onButton;
 
 private:
-	bool m_wasDown;
+	uint32_t m_presses;
 };
 }
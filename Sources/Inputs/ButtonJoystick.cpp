@@ -8,7 +8,13 @@ ButtonJoystick::ButtonJoystick(const uint32_t &port, const uint32_t &button) :
 	m_port(port),
 	m_button(button)
 {
-	Joysticks::Get()->OnButton().Add([this](uint32_t button, uint32_t port, InputAction action)
+	// Headless engines have no joysticks, the button is never pressed.
+	if (!Engine::Get()->HasModule<Joysticks>())
+	{
+		return;
+	}
+
+	Joysticks::Get()->OnButton().Add([this](uint32_t port, uint32_t button, InputAction action)
 	{
 		if (port == m_port && button == m_button)
 		{
@@ -19,6 +25,6 @@ ButtonJoystick::ButtonJoystick(const uint32_t &port, const uint32_t &button) :
 
 bool ButtonJoystick::IsDown() const
 {
-	return Joysticks::Get()->GetButton(m_port, m_button) != InputAction::Release;
+	return Engine::Get()->HasModule<Joysticks>() && Joysticks::Get()->GetButton(m_port, m_button) != InputAction::Release;
 }
 }
@@ -5,6 +5,12 @@ namespace acid
 ButtonKeyboard::ButtonKeyboard(const Key &key) :
 	m_key(key)
 {
+	// Headless engines have no keyboard, the key is never pressed.
+	if (!Engine::Get()->HasModule<Keyboard>())
+	{
+		return;
+	}
+
 	Keyboard::Get()->OnKey().Add([this](Key key, InputAction action, BitMask<InputMod> mods)
 	{
 		if (key == m_key)
@@ -16,6 +22,6 @@ ButtonKeyboard::ButtonKeyboard(const Key &key) :
 
 bool ButtonKeyboard::IsDown() const
 {
-	return Keyboard::Get()->GetKey(m_key) != InputAction::Release;
+	return Engine::Get()->HasModule<Keyboard>() && Keyboard::Get()->GetKey(m_key) != InputAction::Release;
 }
 }
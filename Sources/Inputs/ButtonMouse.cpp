@@ -5,6 +5,12 @@ namespace acid
 ButtonMouse::ButtonMouse(const MouseButton &button) :
 	m_button(button)
 {
+	// Headless engines have no mouse, the button is never pressed.
+	if (!Engine::Get()->HasModule<Mouse>())
+	{
+		return;
+	}
+
 	Mouse::Get()->OnButton().Add([this](MouseButton button, InputAction action, BitMask<InputMod> mods)
 	{
 		if (button == m_button)
@@ -16,6 +22,6 @@ ButtonMouse::ButtonMouse(const MouseButton &button) :
 
 bool ButtonMouse::IsDown() const
 {
-	return Mouse::Get()->GetButton(m_button) != InputAction::Release;
+	return Engine::Get()->HasModule<Mouse>() && Mouse::Get()->GetButton(m_button) != InputAction::Release;
 }
 }
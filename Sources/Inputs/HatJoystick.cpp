@@ -8,7 +8,13 @@ HatJoystick::HatJoystick(const uint32_t &port, const uint32_t &hat, const BitMas
 	m_hatFlags(hatFlags),
 	m_lastDown(false)
 {
-	Joysticks::Get()->OnHat().Add([this](uint32_t hat, uint32_t port, BitMask<JoystickHat> value)
+	// Headless engines have no joysticks, the hat stays centred.
+	if (!Engine::Get()->HasModule<Joysticks>())
+	{
+		return;
+	}
+
+	Joysticks::Get()->OnHat().Add([this](uint32_t port, uint32_t hat, BitMask<JoystickHat> value)
 	{
 		if (port == m_port && hat == m_hat)
 		{
@@ -35,6 +41,11 @@ HatJoystick::HatJoystick(const uint32_t &port, const uint32_t &hat, const BitMas
 
 float HatJoystick::GetAmount() const
 {
+	if (!Engine::Get()->HasModule<Joysticks>())
+	{
+		return 0.0f;
+	}
+
 	auto hat = Joysticks::Get()->GetHat(m_port, m_hat);
 
 	if (hat & JoystickHat::Up)
@@ -77,6 +88,6 @@ float HatJoystick::GetAmount() const
 
 bool HatJoystick::IsDown() const
 {
-	return Joysticks::Get()->GetHat(m_port, m_hat) & m_hatFlags;
+	return Engine::Get()->HasModule<Joysticks>() && Joysticks::Get()->GetHat(m_port, m_hat) & m_hatFlags;
 }
 }
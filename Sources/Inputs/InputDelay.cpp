@@ -5,7 +5,8 @@ namespace acid
 InputDelay::InputDelay(const Time &delay, const Time &repeat) :
 	m_timerDelay(delay),
 	m_timerRepeat(repeat),
-	m_delayOver(false)
+	m_delayOver(false),
+	m_pressed(false)
 {
 }
 
@@ -23,8 +24,29 @@ void InputDelay::Update(const bool &keyIsDown)
 	}
 }
 
+void InputDelay::Update(const InputAction &action)
+{
+	if (action == InputAction::Press)
+	{
+		m_pressed = true;
+		m_delayOver = false;
+		m_timerDelay.ResetStartTime();
+		m_timerRepeat.ResetStartTime();
+		return;
+	}
+
+	Update(action != InputAction::Release);
+}
+
 bool InputDelay::CanInput()
 {
+	if (m_pressed)
+	{
+		m_pressed = false;
+		m_timerRepeat.ResetStartTime();
+		return true;
+	}
+
 	if (m_delayOver && m_timerRepeat.IsPassedTime())
 	{
 		m_timerRepeat.ResetStartTime();
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "Devices/Window.hpp"
 #include "Maths/Timer.hpp"
 
 namespace acid
@@ -11,6 +12,12 @@ public:
 
 	void Update(const bool &keyIsDown);
 
+	/**
+	 * Updates the delay from a key or button event, a press can be input once even if it is released before {@link InputDelay#CanInput} is called.
+	 * @param action The action of the event.
+	 */
+	void Update(const InputAction &action);
+
 	bool CanInput();
 
 	const Time &GetDelay() const { return m_timerDelay.GetInterval(); }
@@ -25,5 +32,6 @@ private:
 	Timer m_timerDelay;
 	Timer m_timerRepeat;
 	bool m_delayOver;
+	bool m_pressed;
 };
 }
@@ -4,9 +4,10 @@
 
 namespace acid
 {
-Light::Light(const Colour &colour, const float &radius) :
+Light::Light(const Colour &colour, const float &radius, const bool &castShadows) :
 	m_colour(colour),
-	m_radius(radius)
+	m_radius(radius),
+	m_castShadows(castShadows)
 {
 }
 
@@ -22,6 +23,12 @@ const Metadata &operator>>(const Metadata &metadata, Light &light)
 {
 	metadata.GetChild("Colour", light.m_colour);
 	metadata.GetChild("Radius", light.m_radius);
+
+	if (auto castShadows = metadata.FindChild("Cast Shadows", false))
+	{
+		*castShadows >> light.m_castShadows;
+	}
+
 	return metadata;
 }
 
@@ -29,6 +36,7 @@ Metadata &operator<<(Metadata &metadata, const Light &light)
 {
 	metadata.SetChild("Colour", light.m_colour);
 	metadata.SetChild("Radius", light.m_radius);
+	metadata.SetChild("Cast Shadows", light.m_castShadows);
 	return metadata;
 }
 }
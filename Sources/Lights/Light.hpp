@@ -17,8 +17,9 @@ public:
 	 * Creates a new point light.
 	 * @param colour The colour of the light.
 	 * @param radius How far the light will have influence (-1 sets this to a directional light).
+	 * @param castShadows If the light can be selected to cast shadows, only directional lights cast the shadows of {@link Shadows}.
 	 */
-	explicit Light(const Colour &colour = Colour::White, const float &radius = -1.0f);
+	explicit Light(const Colour &colour = Colour::White, const float &radius = -1.0f, const bool &castShadows = false);
 
 	void Start() override;
 
@@ -32,6 +33,10 @@ public:
 
 	void SetRadius(const float &radius) { m_radius = radius; }
 
+	const bool &IsCastShadows() const { return m_castShadows; }
+
+	void SetCastShadows(const bool &castShadows) { m_castShadows = castShadows; }
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Light &light);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Light &light);
@@ -40,5 +45,6 @@ private:
 	Colour m_colour;
 	Vector3f m_position;
 	float m_radius;
+	bool m_castShadows;
 };
 }
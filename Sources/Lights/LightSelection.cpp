@@ -0,0 +1,88 @@
+#include "LightSelection.hpp"
+
+#include "Engine/Engine.hpp"
+#include "Engine/FrameAllocator.hpp"
+#include "Scenes/Camera.hpp"
+#include "Scenes/Entity.hpp"
+#include "Scenes/SceneStructure.hpp"
+
+namespace acid
+{
+LightSelection::LightSelection(const uint32_t &maxLights, const uint32_t &maxShadowCasters, const float &hysteresis) :
+	m_maxLights(maxLights),
+	m_maxShadowCasters(maxShadowCasters),
+	m_hysteresis(hysteresis)
+{
+}
+
+void LightSelection::Update(const Camera &camera, SceneStructure &structure)
+{
+	std::pmr::vector<Candidate> lights(FrameAllocator::Get());
+	std::pmr::vector<Candidate> casters(FrameAllocator::Get());
+	auto cameraPosition = camera.GetPosition();
+
+	for (const auto &light : structure.ViewComponents<Light>())
+	{
+		auto position = light->GetParent()->GetWorldTransform().GetPosition();
+		auto radius = light->GetRadius();
+
+		if (radius > 0.0f && !camera.GetViewFrustum().SphereInFrustum(position, radius))
+		{
+			continue;
+		}
+
+		// The area a light covers on screen falls with the square of its distance, a camera inside of its radius is covered by all of it.
+		auto &colour = light->GetColour();
+		auto luminance = 0.2126f * colour.m_r + 0.7152f * colour.m_g + 0.0722f * colour.m_b;
+		auto coverage = radius > 0.0f ? radius / std::max(cameraPosition.Distance(position), radius) : 1.0f;
+
+		Candidate candidate = { light, radius <= 0.0f, luminance * coverage * coverage };
+		lights.emplace_back(candidate);
+
+		if (light->IsCastShadows())
+		{
+			casters.emplace_back(candidate);
+		}
+	}
+
+	Select(lights, m_maxLights, m_selectedLights, m_lights);
+	Select(casters, m_maxShadowCasters, m_selectedCasters, m_shadowCasters);
+
+	if (auto profiler = Profiler::Get(); profiler != nullptr && profiler->IsEnabled())
+	{
+		profiler->SetCounter("Visible Lights", static_cast<double>(lights.size()));
+		profiler->SetCounter("Selected Lights", static_cast<double>(m_lights.size()));
+	}
+}
+
+void LightSelection::Select(std::pmr::vector<Candidate> &candidates, const uint32_t &count, std::unordered_set<const Light *> &selected, std::vector<Light *> &lights) const
+{
+	for (auto &candidate : candidates)
+	{
+		if (selected.find(candidate.m_light) != selected.end())
+		{
+			candidate.m_score *= 1.0f + m_hysteresis;
+		}
+	}
+
+	// Ties keep the order of the structure, so equal lights are not reordered between frames.
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+	{
+		if (a.m_directional != b.m_directional)
+		{
+			return a.m_directional;
+		}
+
+		return a.m_score > b.m_score;
+	});
+
+	lights.clear();
+	selected.clear();
+
+	for (std::size_t i = 0; i < std::min<std::size_t>(candidates.size(), count); i++)
+	{
+		lights.emplace_back(candidates[i].m_light);
+		selected.emplace(candidates[i].m_light);
+	}
+}
+}
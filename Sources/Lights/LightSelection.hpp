@@ -0,0 +1,87 @@
+#pragma once
+
+#include <unordered_set>
+#include "Light.hpp"
+
+namespace acid
+{
+class Camera;
+class SceneStructure;
+
+/**
+ * @brief Class that picks the lights rendered each frame, lights with a radius outside of the view frustum are culled and the rest are ranked by how much of the screen they light.
+ * Lights without a radius light everything and are always ranked first. Lights that were selected in the last frame keep a bonus to their score,
+ * so lights of similar importance do not swap in and out of the selection from frame to frame.
+ * Shadow casters are picked from the lights that cast shadows in the same way.
+ */
+class ACID_EXPORT LightSelection
+{
+public:
+	/**
+	 * Creates a new light selection.
+	 * @param maxLights The most lights that are selected.
+	 * @param maxShadowCasters The most shadow casters that are selected.
+	 * @param hysteresis How much the score of a light selected in the last frame is raised by, as a fraction of its score.
+	 */
+	explicit LightSelection(const uint32_t &maxLights = 256, const uint32_t &maxShadowCasters = 1, const float &hysteresis = 0.25f);
+
+	/**
+	 * Selects the lights of a structure for a camera, run once per frame after the transforms are updated.
+	 * @param camera The camera the lights are seen from.
+	 * @param structure The structure the lights are in.
+	 */
+	void Update(const Camera &camera, SceneStructure &structure);
+
+	/**
+	 * Gets the selected lights, ordered from the most important.
+	 * @return The selected lights.
+	 */
+	const std::vector<Light *> &GetLights() const { return m_lights; }
+
+	/**
+	 * Gets the selected lights that cast shadows, ordered from the most important.
+	 * @return The selected shadow casters.
+	 */
+	const std::vector<Light *> &GetShadowCasters() const { return m_shadowCasters; }
+
+	const uint32_t &GetMaxLights() const { return m_maxLights; }
+
+	void SetMaxLights(const uint32_t &maxLights) { m_maxLights = maxLights; }
+
+	const uint32_t &GetMaxShadowCasters() const { return m_maxShadowCasters; }
+
+	void SetMaxShadowCasters(const uint32_t &maxShadowCasters) { m_maxShadowCasters = maxShadowCasters; }
+
+	const float &GetHysteresis() const { return m_hysteresis; }
+
+	void SetHysteresis(const float &hysteresis) { m_hysteresis = hysteresis; }
+
+private:
+	class Candidate
+	{
+	public:
+		Light *m_light;
+		bool m_directional;
+		float m_score;
+	};
+
+	/**
+	 * Ranks candidates and keeps the most important.
+	 * @param candidates The candidates, they are sorted.
+	 * @param count The most candidates kept.
+	 * @param selected The lights selected in the last frame, replaced by the lights kept.
+	 * @param lights The list the kept lights are written to.
+	 */
+	void Select(std::pmr::vector<Candidate> &candidates, const uint32_t &count, std::unordered_set<const Light *> &selected, std::vector<Light *> &lights) const;
+
+	uint32_t m_maxLights;
+	uint32_t m_maxShadowCasters;
+	float m_hysteresis;
+
+	std::vector<Light *> m_lights;
+	std::vector<Light *> m_shadowCasters;
+	/// Only compared against, a destroyed light whose address is reused at most keeps a bonus for one frame.
+	std::unordered_set<const Light *> m_selectedLights;
+	std::unordered_set<const Light *> m_selectedCasters;
+};
+}
@@ -1,12 +1,44 @@
 #pragma once
 
+#include "Maths/Colour.hpp"
+#include "Maths/Matrix4.hpp"
+#include "Maths/Vector4.hpp"
 #include "Scenes/Component.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Buffers/PushHandler.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
 #include "PipelineMaterial.hpp"
 
 namespace acid
 {
+/**
+ * @brief The per instance values of a batched mesh, laid out to match the std430 Instance struct in the instanced shaders.
+ */
+struct MaterialInstance
+{
+	Matrix4 m_transform;
+	// The transform the instance was drawn with last frame, used to write motion vectors.
+	Matrix4 m_previousTransform;
+	Colour m_baseDiffuse;
+	float m_metallic;
+	float m_roughness;
+	float m_ignoreFog;
+	float m_ignoreLighting;
+	// The index of the material in the bindless material buffer, unused by materials that bind their own descriptors.
+	uint32_t m_material;
+	// Dithers the instance while it fades between levels of detail, positive for the level faded out and negative for the level faded in.
+	float m_lodFade;
+	// The baked animation frame blended from, the fraction is how far it has blended to the next frame.
+	float m_animationFrame;
+	uint32_t m_animationNext;
+	// Rebuilds model space positions from quantized vertices, a scale of one and no offset for full precision models.
+	Vector3f m_positionScale;
+	// The slot index and generation of the entity, written to the entity attachment for picking.
+	uint32_t m_entityIndex;
+	Vector3f m_positionOffset;
+	uint32_t m_entityGeneration;
+};
+
 /**
  * @brief Component that represents a material shader that is used to render a mesh.
  * The child of this object should initialize {@link Material#m_pipelineMaterial} in {@link Material#Start}.
@@ -16,7 +48,9 @@ class ACID_EXPORT Material :
 {
 public:
 	Material() :
-		m_pipelineMaterial(nullptr)
+		m_pipelineMaterial(nullptr),
+		m_pipelineInstanced(nullptr),
+		m_pipelineMeshlet(nullptr)
 	{
 	}
 
@@ -35,13 +69,61 @@ public:
 	 */
 	virtual void PushDescriptors(DescriptorsHandler &descriptorSet) = 0;
 
+	/**
+	 * Used to update the push constants of this materials shader, bindless materials push the index of their values in the bindless material buffer.
+	 * @param pushObject The push handler to update.
+	 */
+	virtual void PushConstants(PushHandler &pushObject) {}
+
+	/**
+	 * Used to write the per object values into the push constants, for shaders that declare them in their push block and have no uniform object.
+	 * Values pushed this way need no uniform buffer copy or descriptor write, materials that return false are drawn with the uniform object.
+	 * @param pushObject The push handler to update.
+	 * @return If the per object values were pushed.
+	 */
+	virtual bool PushObject(PushHandler &pushObject) { return false; }
+
 	/**
 	 * Gets the material pipeline defined in this material.
 	 * @return The material pipeline.
 	 */
 	const std::shared_ptr<PipelineMaterial> &GetPipelineMaterial() const { return m_pipelineMaterial; }
 
+	/**
+	 * Used to write the values of this material into a batch instance, materials that return false are always drawn on their own.
+	 * @param instance The instance to write to.
+	 * @return If this material can be drawn as part of a batch.
+	 */
+	virtual bool PushInstance(MaterialInstance &instance) const { return false; }
+
+	/**
+	 * Gets a key for the descriptors pushed by {@link Material#PushDescriptors}, instanced materials with the same pipeline and key share a batch.
+	 * @return The descriptors key.
+	 */
+	virtual std::size_t GetInstanceKey() const { return 0; }
+
+	/**
+	 * Used to tell the images of this material how large they are drawn, so streamed images keep the mip levels they need.
+	 * @param pixels The number of pixels the mesh covers on screen.
+	 */
+	virtual void RequestResidency(const float &pixels) const {}
+
+	/**
+	 * Gets the material pipeline used to draw batches of this material, materials that cannot be instanced leave this as nullptr.
+	 * @return The instanced material pipeline.
+	 */
+	const std::shared_ptr<PipelineMaterial> &GetPipelineInstanced() const { return m_pipelineInstanced; }
+
+	/**
+	 * Gets the task and mesh shader pipeline used to draw batches of models split into meshlets, only set when the device has mesh shaders.
+	 * Batches without one draw their meshlets with the instanced pipeline, from commands written by the meshlet culling pass.
+	 * @return The meshlet material pipeline.
+	 */
+	const std::shared_ptr<PipelineMaterial> &GetPipelineMeshlet() const { return m_pipelineMeshlet; }
+
 protected:
 	std::shared_ptr<PipelineMaterial> m_pipelineMaterial;
+	std::shared_ptr<PipelineMaterial> m_pipelineInstanced;
+	std::shared_ptr<PipelineMaterial> m_pipelineMeshlet;
 };
 }
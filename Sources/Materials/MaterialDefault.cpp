@@ -1,6 +1,9 @@
 #include "MaterialDefault.hpp"
 
 #include "Animations/MeshAnimated.hpp"
+#include "Animations/MeshBaked.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Maths/Maths.hpp"
 #include "Meshes/Mesh.hpp"
 #include "Models/VertexDefault.hpp"
 #include "Scenes/Entity.hpp"
@@ -10,6 +13,8 @@ namespace acid
 MaterialDefault::MaterialDefault(const Colour &baseDiffuse, std::shared_ptr<Image2d> imageDiffuse, const float &metallic, const float &roughness,
 	std::shared_ptr<Image2d> imageMaterial, std::shared_ptr<Image2d> imageNormal, const bool &castsShadows, const bool &ignoreLighting, const bool &ignoreFog) :
 	m_animated(false),
+	m_baked(false),
+	m_quantized(false),
 	m_baseDiffuse(baseDiffuse),
 	m_imageDiffuse(std::move(imageDiffuse)),
 	m_metallic(metallic),
@@ -18,7 +23,8 @@ MaterialDefault::MaterialDefault(const Colour &baseDiffuse, std::shared_ptr<Imag
 	m_imageNormal(std::move(imageNormal)),
 	m_castsShadows(castsShadows),
 	m_ignoreLighting(ignoreLighting),
-	m_ignoreFog(ignoreFog)
+	m_ignoreFog(ignoreFog),
+	m_bindlessMaterial()
 {
 }
 
@@ -33,12 +39,80 @@ void MaterialDefault::Start()
 	}
 
 	m_animated = dynamic_cast<MeshAnimated *>(mesh) != nullptr;
+	m_baked = dynamic_cast<MeshBaked *>(mesh) != nullptr;
+	m_quantized = !m_animated && !m_baked && mesh->GetModel() != nullptr && mesh->GetModel()->IsQuantized();
+
+	// With descriptor indexing the values and images are read from the bindless set, so default materials share pipelines and batches.
+	auto bindlessDescriptors = Graphics::Get()->GetBindlessDescriptors();
+	m_bindlessSlot = bindlessDescriptors != nullptr ? bindlessDescriptors->AddMaterial() : nullptr;
+	m_bindlessMaterial = {};
+	m_bindlessMaterial.m_padding = -1; // Never matches a written material, so the first update is always written.
+
+	// The depth pre-pass draws static meshes with vertex pipelines, animated meshes and mesh shaders still test and write depth themselves.
+	auto depth = m_animated || m_baked ? PipelineGraphics::Depth::ReadWrite : PipelineGraphics::Depth::Prepass;
 	m_pipelineMaterial = PipelineMaterial::Create({ 1, 0 },
-		PipelineGraphicsCreate({ "Shaders/Defaults/Default.vert", "Shaders/Defaults/Default.frag" }, { mesh->GetVertexInput() }, GetDefines(), PipelineGraphics::Mode::Mrt));
+		PipelineGraphicsCreate({ "Shaders/Defaults/Default.vert", "Shaders/Defaults/Default.frag" }, { mesh->GetVertexInput() }, GetDefines(), PipelineGraphics::Mode::Mrt,
+		depth));
+
+	// Joint transforms are per object, so animated meshes are not batched, baked meshes only keep their frame per instance.
+	if (!m_animated)
+	{
+		m_pipelineInstanced = PipelineMaterial::Create({ 1, 0 },
+			PipelineGraphicsCreate({ "Shaders/Defaults/Default.vert", "Shaders/Defaults/Default.frag" }, { mesh->GetVertexInput() }, GetDefines(true),
+			PipelineGraphics::Mode::Mrt, depth));
+
+		if (!m_baked && Graphics::Get()->GetLogicalDevice()->IsMeshShader() && mesh->GetModel() != nullptr && mesh->GetModel()->GetMeshletCount() != 0)
+		{
+			m_pipelineMeshlet = PipelineMaterial::Create({ 1, 0 },
+				PipelineGraphicsCreate({ "Shaders/Defaults/Default.task", "Shaders/Defaults/Default.mesh", "Shaders/Defaults/Default.frag" }, {}, GetDefines(true),
+				PipelineGraphics::Mode::Mrt));
+		}
+	}
 }
 
 void MaterialDefault::Update()
 {
+	if (m_bindlessSlot == nullptr)
+	{
+		return;
+	}
+
+	auto bindlessDescriptors = Graphics::Get()->GetBindlessDescriptors();
+
+	BindlessMaterial material = {};
+	material.m_baseDiffuse = m_baseDiffuse;
+	material.m_metallic = m_metallic;
+	material.m_roughness = m_roughness;
+	material.m_ignoreFog = static_cast<float>(m_ignoreFog);
+	material.m_ignoreLighting = static_cast<float>(m_ignoreLighting);
+	material.m_imageDiffuse = bindlessDescriptors->GetImageIndex(m_imageDiffuse);
+	material.m_imageMaterial = bindlessDescriptors->GetImageIndex(m_imageMaterial);
+	material.m_imageNormal = bindlessDescriptors->GetImageIndex(m_imageNormal);
+
+	if (std::memcmp(&material, &m_bindlessMaterial, sizeof(BindlessMaterial)) != 0)
+	{
+		m_bindlessMaterial = material;
+		bindlessDescriptors->SetMaterial(*m_bindlessSlot, m_bindlessMaterial);
+	}
+}
+
+template<typename T>
+void MaterialDefault::PushValues(T &handler)
+{
+	UpdateMotion();
+	handler.Push("transform", m_transform);
+	handler.Push("previousTransform", m_previousTransform);
+	handler.Push("baseDiffuse", m_baseDiffuse);
+	handler.Push("metallic", m_metallic);
+	handler.Push("roughness", m_roughness);
+	handler.Push("ignoreFog", static_cast<float>(m_ignoreFog));
+	handler.Push("ignoreLighting", static_cast<float>(m_ignoreLighting));
+
+	auto [quantizeOffset, quantizeScale] = GetQuantize();
+	handler.Push("positionScale", quantizeScale);
+	handler.Push("positionOffset", quantizeOffset);
+	handler.Push("entityIndex", GetParent()->GetHandle().GetIndex());
+	handler.Push("entityGeneration", GetParent()->GetHandle().GetGeneration());
 }
 
 void MaterialDefault::PushUniforms(UniformHandler &uniformObject)
@@ -46,37 +120,171 @@ void MaterialDefault::PushUniforms(UniformHandler &uniformObject)
 	if (m_animated)
 	{
 		auto meshAnimated = GetParent()->GetComponent<MeshAnimated>();
-		auto joints = meshAnimated->GetJointTransforms(); // TODO: Move into storage buffer and update every frame.
+		const auto &joints = meshAnimated->GetJointTransforms();
 		uniformObject.Push("jointTransforms", *joints.data(), sizeof(Matrix4) * joints.size());
 	}
 
-	uniformObject.Push("transform", GetParent()->GetWorldMatrix());
-	uniformObject.Push("baseDiffuse", m_baseDiffuse);
-	uniformObject.Push("metallic", m_metallic);
-	uniformObject.Push("roughness", m_roughness);
-	uniformObject.Push("ignoreFog", static_cast<float>(m_ignoreFog));
-	uniformObject.Push("ignoreLighting", static_cast<float>(m_ignoreLighting));
+	if (m_baked)
+	{
+		auto [animationFrame, animationNext] = GetParent()->GetComponent<MeshBaked>()->GetFrames();
+		uniformObject.Push("animationFrame", animationFrame);
+		uniformObject.Push("animationNext", animationNext);
+	}
+
+	PushValues(uniformObject);
 }
 
 void MaterialDefault::PushDescriptors(DescriptorsHandler &descriptorSet)
 {
+	if (m_baked)
+	{
+		auto meshBaked = GetParent()->GetComponent<MeshBaked>();
+		descriptorSet.Push("BufferAnimation", meshBaked->GetAnimation() != nullptr ? meshBaked->GetAnimation()->GetBuffer() : nullptr);
+	}
+
+	if (m_bindlessSlot != nullptr)
+	{
+		return;
+	}
+
 	descriptorSet.Push("samplerDiffuse", m_imageDiffuse);
 	descriptorSet.Push("samplerMaterial", m_imageMaterial);
 	descriptorSet.Push("samplerNormal", m_imageNormal);
 }
 
-std::vector<Shader::Define> MaterialDefault::GetDefines() const
+void MaterialDefault::PushConstants(PushHandler &pushObject)
+{
+	if (m_bindlessSlot != nullptr)
+	{
+		pushObject.Push("material", m_bindlessSlot->GetIndex());
+	}
+}
+
+bool MaterialDefault::PushObject(PushHandler &pushObject)
+{
+	// Joint transforms are too large for push constants, and the baked frame is not in the push block.
+	if (m_animated || m_baked)
+	{
+		return false;
+	}
+
+	PushValues(pushObject);
+	return true;
+}
+
+bool MaterialDefault::PushInstance(MaterialInstance &instance) const
+{
+	if (m_animated)
+	{
+		return false;
+	}
+
+	UpdateMotion();
+	instance.m_transform = m_transform;
+	instance.m_previousTransform = m_previousTransform;
+	instance.m_baseDiffuse = m_baseDiffuse;
+	instance.m_metallic = m_metallic;
+	instance.m_roughness = m_roughness;
+	instance.m_ignoreFog = static_cast<float>(m_ignoreFog);
+	instance.m_ignoreLighting = static_cast<float>(m_ignoreLighting);
+	instance.m_material = m_bindlessSlot != nullptr ? m_bindlessSlot->GetIndex() : 0;
+
+	if (m_baked)
+	{
+		std::tie(instance.m_animationFrame, instance.m_animationNext) = GetParent()->GetComponent<MeshBaked>()->GetFrames();
+	}
+	else
+	{
+		instance.m_animationFrame = 0.0f;
+		instance.m_animationNext = 0;
+	}
+
+	auto [quantizeOffset, quantizeScale] = GetQuantize();
+	instance.m_positionScale = quantizeScale;
+	instance.m_positionOffset = quantizeOffset;
+	instance.m_entityIndex = GetParent()->GetHandle().GetIndex();
+	instance.m_entityGeneration = GetParent()->GetHandle().GetGeneration();
+	return true;
+}
+
+std::size_t MaterialDefault::GetInstanceKey() const
+{
+	std::size_t key = 0;
+
+	// Baked instances share the joint buffer of their animation.
+	if (m_baked)
+	{
+		Maths::HashCombine(key, GetParent()->GetComponent<MeshBaked>()->GetAnimation().get());
+	}
+
+	// Bindless instances index their own images.
+	if (m_bindlessSlot != nullptr)
+	{
+		return key;
+	}
+
+	Maths::HashCombine(key, m_imageDiffuse.get());
+	Maths::HashCombine(key, m_imageMaterial.get());
+	Maths::HashCombine(key, m_imageNormal.get());
+	return key;
+}
+
+void MaterialDefault::RequestResidency(const float &pixels) const
+{
+	for (auto image : { m_imageDiffuse.get(), m_imageMaterial.get(), m_imageNormal.get() })
+	{
+		if (image != nullptr)
+		{
+			image->RequestResidency(pixels);
+		}
+	}
+}
+
+std::vector<Shader::Define> MaterialDefault::GetDefines(const bool &instanced) const
 {
 	std::vector<Shader::Define> defines;
-	defines.emplace_back("DIFFUSE_MAPPING", String::To<int32_t>(m_imageDiffuse != nullptr));
-	defines.emplace_back("MATERIAL_MAPPING", String::To<int32_t>(m_imageMaterial != nullptr));
-	defines.emplace_back("NORMAL_MAPPING", String::To<int32_t>(m_imageNormal != nullptr));
+	auto bindless = m_bindlessSlot != nullptr;
+	defines.emplace_back("BINDLESS", String::To<int32_t>(bindless));
+	defines.emplace_back("DIFFUSE_MAPPING", String::To<int32_t>(!bindless && m_imageDiffuse != nullptr));
+	defines.emplace_back("MATERIAL_MAPPING", String::To<int32_t>(!bindless && m_imageMaterial != nullptr));
+	defines.emplace_back("NORMAL_MAPPING", String::To<int32_t>(!bindless && m_imageNormal != nullptr));
 	defines.emplace_back("ANIMATED", String::To<int32_t>(m_animated));
+	defines.emplace_back("BAKED", String::To<int32_t>(m_baked));
+	defines.emplace_back("INSTANCED", String::To<int32_t>(instanced));
+	defines.emplace_back("QUANTIZED", String::To<int32_t>(m_quantized));
 	defines.emplace_back("MAX_JOINTS", String::To(MeshAnimated::MaxJoints));
 	defines.emplace_back("MAX_WEIGHTS", String::To(MeshAnimated::MaxWeights));
 	return defines;
 }
 
+void MaterialDefault::UpdateMotion() const
+{
+	auto frameCount = Graphics::Get()->GetFrameCount();
+
+	if (m_motionFrame == frameCount)
+	{
+		return;
+	}
+
+	// A material that was not drawn last frame has no motion, so it does not smear when it reappears.
+	const auto &transform = GetParent()->GetWorldMatrix();
+	m_previousTransform = m_motionFrame == frameCount - 1 ? m_transform : transform;
+	m_transform = transform;
+	m_motionFrame = frameCount;
+}
+
+std::pair<Vector3f, Vector3f> MaterialDefault::GetQuantize() const
+{
+	auto mesh = GetParent()->GetComponent<Mesh>(true);
+
+	if (!m_quantized || mesh == nullptr || mesh->GetModel() == nullptr)
+	{
+		return { Vector3f(), Vector3f(1.0f) };
+	}
+
+	return { mesh->GetModel()->GetQuantizeOffset(), mesh->GetModel()->GetQuantizeScale() };
+}
+
 const Metadata &operator>>(const Metadata &metadata, MaterialDefault &material)
 {
 	metadata.GetChild("Base Diffuse", material.m_baseDiffuse);
@@ -2,6 +2,7 @@
 
 #include "Maths/Colour.hpp"
 #include "Models/Model.hpp"
+#include "Graphics/Descriptors/BindlessDescriptors.hpp"
 #include "Graphics/Images/Image2d.hpp"
 #include "Material.hpp"
 
@@ -26,6 +27,16 @@ public:
 
 	void PushDescriptors(DescriptorsHandler &descriptorSet) override;
 
+	void PushConstants(PushHandler &pushObject) override;
+
+	bool PushObject(PushHandler &pushObject) override;
+
+	bool PushInstance(MaterialInstance &instance) const override;
+
+	std::size_t GetInstanceKey() const override;
+
+	void RequestResidency(const float &pixels) const override;
+
 	const Colour &GetBaseDiffuse() const { return m_baseDiffuse; }
 
 	void SetBaseDiffuse(const Colour &baseDiffuse) { m_baseDiffuse = baseDiffuse; }
@@ -67,9 +78,30 @@ public:
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const MaterialDefault &material);
 
 private:
-	std::vector<Shader::Define> GetDefines() const;
+	std::vector<Shader::Define> GetDefines(const bool &instanced = false) const;
+
+	/**
+	 * Keeps the world matrix of the last frame the material was drawn in, once per frame.
+	 */
+	void UpdateMotion() const;
+
+	/**
+	 * Gets the offset and scale quantized positions of the mesh are rebuilt with, positions are left as they are when the model is not quantized.
+	 * @return The quantize offset and scale.
+	 */
+	std::pair<Vector3f, Vector3f> GetQuantize() const;
+
+	/**
+	 * Pushes the per object values shared by the uniform object and the push constants.
+	 * @tparam T The uniform or push handler type.
+	 * @param handler The handler to push into.
+	 */
+	template<typename T>
+	void PushValues(T &handler);
 
 	bool m_animated;
+	bool m_baked;
+	bool m_quantized;
 	Colour m_baseDiffuse;
 	std::shared_ptr<Image2d> m_imageDiffuse;
 
@@ -81,5 +113,12 @@ private:
 	bool m_castsShadows;
 	bool m_ignoreLighting;
 	bool m_ignoreFog;
+
+	std::shared_ptr<BindlessDescriptors::MaterialSlot> m_bindlessSlot;
+	BindlessMaterial m_bindlessMaterial;
+
+	mutable Matrix4 m_transform;
+	mutable Matrix4 m_previousTransform;
+	mutable std::optional<uint64_t> m_motionFrame;
 };
 }
@@ -1,10 +1,19 @@
 #include "PipelineMaterial.hpp"
 
+#include "Files/File.hpp"
+#include "Maths/Maths.hpp"
 #include "Resources/Resources.hpp"
+#include "Serialized/Json/Json.hpp"
 #include "Graphics/Graphics.hpp"
 
 namespace acid
 {
+// Material pipelines keyed by the hash of their stage and pipeline create, resources keep them alive so the cache only holds weak references.
+static std::unordered_multimap<std::size_t, std::weak_ptr<PipelineMaterial>> VARIANTS;
+static std::mutex VARIANTS_MUTEX;
+// The manifest variants are recorded into, guarded by the variants mutex.
+static std::unique_ptr<File> MANIFEST;
+
 std::shared_ptr<PipelineMaterial> PipelineMaterial::Create(const Metadata &metadata)
 {
 	/*auto resource = Resources::Get()->Find(metadata);
@@ -24,21 +33,99 @@ std::shared_ptr<PipelineMaterial> PipelineMaterial::Create(const Metadata &metad
 
 std::shared_ptr<PipelineMaterial> PipelineMaterial::Create(const Pipeline::Stage &pipelineStage, const PipelineGraphicsCreate &pipelineCreate)
 {
-	auto temp = PipelineMaterial(pipelineStage, pipelineCreate);
-	Metadata metadata = Metadata();
-	metadata << temp;
+	auto hash = pipelineCreate.GetHash();
+	Maths::HashCombine(hash, pipelineStage.first);
+	Maths::HashCombine(hash, pipelineStage.second);
 
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
 	{
-		return std::dynamic_pointer_cast<PipelineMaterial>(resource);
+		std::lock_guard<std::mutex> lock(VARIANTS_MUTEX);
+		auto range = VARIANTS.equal_range(hash);
+
+		for (auto it = range.first; it != range.second;)
+		{
+			auto variant = it->second.lock();
+
+			if (variant == nullptr)
+			{
+				it = VARIANTS.erase(it);
+				continue;
+			}
+
+			if (variant->m_pipelineStage == pipelineStage && variant->m_pipelineCreate == pipelineCreate)
+			{
+				return variant;
+			}
+
+			++it;
+		}
 	}
 
+	// The metadata is only written for new variants, resources keep them alive with it.
 	auto result = std::make_shared<PipelineMaterial>(pipelineStage, pipelineCreate);
+	Metadata metadata = Metadata();
+	metadata << *result;
 	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	//metadata >> *result;
-	//result->Load();
+
+	std::lock_guard<std::mutex> lock(VARIANTS_MUTEX);
+	VARIANTS.emplace(hash, result);
+
+	if (MANIFEST != nullptr)
+	{
+		*MANIFEST->GetMetadata()->CreateChild() << *result;
+		MANIFEST->Write();
+	}
+
+	return result;
+}
+
+void PipelineMaterial::RecordManifest(const std::string &filename)
+{
+	std::lock_guard<std::mutex> lock(VARIANTS_MUTEX);
+
+	if (filename.empty())
+	{
+		MANIFEST = nullptr;
+		return;
+	}
+
+	MANIFEST = std::make_unique<File>(filename, new Json());
+
+	for (const auto &[hash, variant] : VARIANTS)
+	{
+		if (auto pipeline = variant.lock())
+		{
+			*MANIFEST->GetMetadata()->CreateChild() << *pipeline;
+		}
+	}
+
+	MANIFEST->Write();
+}
+
+std::vector<std::shared_ptr<PipelineMaterial>> PipelineMaterial::Precompile(const std::string &filename)
+{
+	File file(filename, new Json());
+	file.Read();
+
+	std::vector<std::shared_ptr<PipelineMaterial>> result;
+
+	for (const auto &child : file.GetMetadata()->GetChildren())
+	{
+		Pipeline::Stage pipelineStage;
+		PipelineGraphicsCreate pipelineCreate;
+		child->GetChild("Renderpass", pipelineStage.first);
+		child->GetChild("Subpass", pipelineStage.second);
+		child->GetChild("Pipeline Create", pipelineCreate);
+
+		if (pipelineCreate.GetShaderStages().empty())
+		{
+			Log::Warning("Pipeline manifest '%s' has a variant without shader stages\n", filename.c_str());
+			continue;
+		}
+
+		auto &pipeline = result.emplace_back(Create(pipelineStage, pipelineCreate));
+		pipeline->Compile();
+	}
+
 	return result;
 }
 
@@ -46,11 +133,25 @@ PipelineMaterial::PipelineMaterial(Pipeline::Stage pipelineStage, PipelineGraphi
 	m_pipelineStage(std::move(pipelineStage)),
 	m_pipelineCreate(std::move(pipelineCreate)),
 	m_renderStage(nullptr),
+	m_depthPrepass(false),
+	m_viewCount(1),
 	m_pipeline(nullptr)
 {
 }
 
 bool PipelineMaterial::BindPipeline(const CommandBuffer &commandBuffer)
+{
+	// Variants missing from the manifest compile in the background, their draws are skipped until then.
+	if (!Compile() || !IsCompiled())
+	{
+		return false;
+	}
+
+	m_pipeline->BindPipeline(commandBuffer);
+	return true;
+}
+
+bool PipelineMaterial::Compile()
 {
 	auto renderStage = Graphics::Get()->GetRenderStage(m_pipelineStage.first);
 
@@ -59,16 +160,36 @@ bool PipelineMaterial::BindPipeline(const CommandBuffer &commandBuffer)
 		return false;
 	}
 
-	if (m_renderStage != renderStage)
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Pipelines tested against a depth pre-pass are created with a different depth state, and pipelines of multiview stages with the view count defined.
+	if (m_renderStage != renderStage || m_depthPrepass != renderStage->IsDepthPrepass() || m_viewCount != renderStage->GetViewCount())
 	{
 		m_renderStage = renderStage;
-		m_pipeline.reset(m_pipelineCreate.Create(m_pipelineStage));
+		m_depthPrepass = renderStage->IsDepthPrepass();
+		m_viewCount = renderStage->GetViewCount();
+		m_pipeline = nullptr;
+		m_compiling = Engine::Get()->GetThreadPool().Enqueue([pipelineStage = m_pipelineStage, pipelineCreate = m_pipelineCreate]()
+		{
+			return std::unique_ptr<PipelineGraphics>(pipelineCreate.Create(pipelineStage));
+		});
 	}
 
-	m_pipeline->BindPipeline(commandBuffer);
 	return true;
 }
 
+bool PipelineMaterial::IsCompiled()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_pipeline == nullptr && m_compiling.valid() && m_compiling.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		m_pipeline = m_compiling.get();
+	}
+
+	return m_pipeline != nullptr;
+}
+
 const Metadata &operator>>(const Metadata &metadata, PipelineMaterial &pipeline)
 {
 	metadata.GetChild("Renderpass", pipeline.m_pipelineStage.first);
@@ -7,6 +7,8 @@ namespace acid
 {
 /**
  * @brief Resource that represents a material pipeline.
+ * The pipeline is compiled on the job system the first time it is bound to a render stage, draws are skipped until it has finished.
+ * Variants can be recorded into a manifest while playing and compiled from the manifest while loading, so they are ready before they are drawn.
  */
 class ACID_EXPORT PipelineMaterial :
 	public Resource
@@ -27,6 +29,20 @@ public:
 	 */
 	static std::shared_ptr<PipelineMaterial> Create(const Pipeline::Stage &pipelineStage, const PipelineGraphicsCreate &pipelineCreate);
 
+	/**
+	 * Records every material pipeline variant that exists or is created from now on into a manifest, the manifest is written each time a variant is added.
+	 * @param filename The file to write the manifest to, or empty to stop recording.
+	 */
+	static void RecordManifest(const std::string &filename);
+
+	/**
+	 * Creates every material pipeline variant in a manifest written by {@link PipelineMaterial#RecordManifest} and starts compiling them.
+	 * Variants of render stages that do not exist yet are compiled once they are first bound.
+	 * @param filename The manifest file.
+	 * @return The material pipelines, they stay alive while the caller holds them.
+	 */
+	static std::vector<std::shared_ptr<PipelineMaterial>> Precompile(const std::string &filename);
+
 	/**
 	 * Creates a new material pipeline.
 	 * @param pipelineStage Stage the pipeline will be executed on.
@@ -41,6 +57,18 @@ public:
 	 */
 	bool BindPipeline(const CommandBuffer &commandBuffer);
 
+	/**
+	 * Starts compiling the pipeline on the job system if it has not been compiled for the current render stage.
+	 * @return If the render stage of this pipeline exists.
+	 */
+	bool Compile();
+
+	/**
+	 * Gets if the pipeline has finished compiling for the current render stage.
+	 * @return If the pipeline can be bound.
+	 */
+	bool IsCompiled();
+
 	const Pipeline::Stage &GetStage() const { return m_pipelineStage; }
 
 	const PipelineGraphicsCreate &GetPipelineCreate() const { return m_pipelineCreate; }
@@ -55,6 +83,10 @@ private:
 	Pipeline::Stage m_pipelineStage;
 	PipelineGraphicsCreate m_pipelineCreate;
 	const RenderStage *m_renderStage;
+	bool m_depthPrepass;
+	uint32_t m_viewCount;
 	std::unique_ptr<PipelineGraphics> m_pipeline;
+	std::future<std::unique_ptr<PipelineGraphics>> m_compiling;
+	std::mutex m_mutex;
 };
 }
@@ -2,6 +2,8 @@
 
 namespace acid
 {
+static_assert(std::is_trivially_copyable_v<Colour>, "Colour is passed and stored as a plain value");
+
 const Colour Colour::Clear = Colour("#000000", 0.0f);
 const Colour Colour::Black = Colour("#000000");
 const Colour Colour::Grey = Colour("#808080");
@@ -108,19 +108,19 @@ public:
 	 **/
 	std::string GetHex() const;
 
-	const float &GetR() const { return m_r; }
+	float GetR() const { return m_r; }
 
 	void SetR(const float &r) { m_r = r; }
 
-	const float &GetG() const { return m_g; }
+	float GetG() const { return m_g; }
 
 	void SetG(const float &g) { m_g = g; }
 
-	const float &GetB() const { return m_b; }
+	float GetB() const { return m_b; }
 
 	void SetB(const float &b) { m_b = b; }
 
-	const float &GetA() const { return m_a; }
+	float GetA() const { return m_a; }
 
 	void SetA(const float &a) { m_a = a; }
 
@@ -11,4 +11,12 @@ void Delta::Update()
 	m_lastFrameTime = m_currentFrameTime;
 	m_time += m_change;
 }
+
+void Delta::Update(const Time &change)
+{
+	m_currentFrameTime = Engine::GetTime();
+	m_change = change;
+	m_lastFrameTime = m_currentFrameTime;
+	m_time += m_change;
+}
 }
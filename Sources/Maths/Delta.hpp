@@ -15,6 +15,12 @@ public:
 	 */
 	void Update();
 
+	/**
+	 * Advances by a fixed change instead of the measured time, used for fixed timestep updates.
+	 * @param change The change to advance by.
+	 */
+	void Update(const Time &change);
+
 	const Time &GetChange() const { return m_change; }
 
 	const Time &GetTime() const { return m_time; }
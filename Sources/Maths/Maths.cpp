@@ -13,6 +13,22 @@ float Maths::Random(const float &min, const float &max)
 	return dist(RANDOM_GENERATOR);
 }
 
+void Maths::Random(float *values, const std::size_t &count, const float &min, const float &max)
+{
+	// The top 24 bits of each output are exactly representable, so every value is below one before it is scaled into the range.
+	auto range = (max - min) / 16777216.0f;
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		values[i] = min + static_cast<float>(RANDOM_GENERATOR() >> 8) * range;
+	}
+}
+
+void Maths::SetRandomSeed(const uint32_t &seed)
+{
+	RANDOM_GENERATOR.seed(seed);
+}
+
 float Maths::RandomNormal(const float &standardDeviation, const float &mean)
 {
 	std::normal_distribution<float> dist(mean, standardDeviation);
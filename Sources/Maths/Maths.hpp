@@ -22,6 +22,21 @@ public:
 	 **/
 	static float Random(const float &min = 0.0f, const float &max = 1.0f);
 
+	/**
+	 * Fills a array with random values from between a range, drawn from the same generator as {@link Maths#Random} without a distribution per value.
+	 * @param values The values to fill.
+	 * @param count The number of values.
+	 * @param min The min value.
+	 * @param max The max value, values are less than it.
+	 **/
+	static void Random(float *values, const std::size_t &count, const float &min = 0.0f, const float &max = 1.0f);
+
+	/**
+	 * Seeds the generator used by the random functions, so the same values are generated every run.
+	 * @param seed The seed.
+	 **/
+	static void SetRandomSeed(const uint32_t &seed);
+
 	/**
 	 * Generates a single value from a normal distribution, using Box-Muller.
 	 * @param standardDeviation The standards deviation of the distribution. 
@@ -114,6 +129,23 @@ public:
 		return static_cast<T>(std::round(value * placeMul) / placeMul);
 	}
 
+	/**
+	 * Rounds a value up to the nearest power of two.
+	 * @param value The value to round, zero rounds to one.
+	 * @return The rounded value.
+	 **/
+	static uint32_t NextPowerOfTwo(const uint32_t &value)
+	{
+		uint32_t result = 1;
+
+		while (result < value)
+		{
+			result <<= 1;
+		}
+
+		return result;
+	}
+
 	/**
 	 * Used to floor the value if less than the min.
 	 * @tparam T The values type.
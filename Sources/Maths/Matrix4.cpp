@@ -2,9 +2,12 @@
 
 #include "Matrix2.hpp"
 #include "Matrix3.hpp"
+#include "Simd.hpp"
 
 namespace acid
 {
+static_assert(std::is_trivially_copyable_v<Matrix4>, "Matrix4 is passed and stored as a plain value");
+
 const Matrix4 Matrix4::Identity = Matrix4(1.0f);
 const Matrix4 Matrix4::Zero = Matrix4(0.0f);
 
@@ -75,13 +78,12 @@ Matrix4 Matrix4::Subtract(const Matrix4 &other) const
 Matrix4 Matrix4::Multiply(const Matrix4 &other) const
 {
 	Matrix4 result = Matrix4();
+	const Simd::Float4 rows[4] = { Simd::Load(m_linear), Simd::Load(m_linear + 4), Simd::Load(m_linear + 8), Simd::Load(m_linear + 12) };
 
+	// Each row of the result is the rows of this matrix weighted by the same row of the other matrix.
 	for (int32_t row = 0; row < 4; row++)
 	{
-		for (int32_t col = 0; col < 4; col++)
-		{
-			result[row][col] = m_rows[0][col] * other[row][0] + m_rows[1][col] * other[row][1] + m_rows[2][col] * other[row][2] + m_rows[3][col] * other[row][3];
-		}
+		Simd::Store(result.m_linear + 4 * row, Simd::CombineRows(rows, other[row][0], other[row][1], other[row][2], other[row][3]));
 	}
 
 	return result;
@@ -89,14 +91,7 @@ Matrix4 Matrix4::Multiply(const Matrix4 &other) const
 
 Vector4f Matrix4::Multiply(const Vector4f &other) const
 {
-	Vector4f result = Vector4f();
-
-	for (int32_t row = 0; row < 4; row++)
-	{
-		result[row] = m_rows[0][row] * other.m_x + m_rows[1][row] * other.m_y + m_rows[2][row] * other.m_z + m_rows[3][row] * other.m_w;
-	}
-
-	return result;
+	return Transform(other);
 }
 
 Matrix4 Matrix4::Divide(const Matrix4 &other) const
@@ -117,13 +112,39 @@ Matrix4 Matrix4::Divide(const Matrix4 &other) const
 Vector4f Matrix4::Transform(const Vector4f &other) const
 {
 	Vector4f result = Vector4f();
+	const Simd::Float4 rows[4] = { Simd::Load(m_linear), Simd::Load(m_linear + 4), Simd::Load(m_linear + 8), Simd::Load(m_linear + 12) };
+	Simd::Store(&result.m_x, Simd::CombineRows(rows, other.m_x, other.m_y, other.m_z, other.m_w));
+	return result;
+}
 
-	for (int32_t row = 0; row < 4; row++)
+void Matrix4::Transform(const Vector4f *points, Vector4f *results, const std::size_t &count) const
+{
+	const Simd::Float4 rows[4] = { Simd::Load(m_linear), Simd::Load(m_linear + 4), Simd::Load(m_linear + 8), Simd::Load(m_linear + 12) };
+
+	for (std::size_t i = 0; i < count; i++)
 	{
-		result[row] = m_rows[0][row] * other.m_x + m_rows[1][row] * other.m_y + m_rows[2][row] * other.m_z + m_rows[3][row] * other.m_w;
+		Simd::Store(&results[i].m_x, Simd::CombineRows(rows, points[i].m_x, points[i].m_y, points[i].m_z, points[i].m_w));
 	}
+}
 
-	return result;
+void Matrix4::TransformPoints(const Vector3f *points, Vector3f *results, const std::size_t &count) const
+{
+	const Simd::Float4 rows[4] = { Simd::Load(m_linear), Simd::Load(m_linear + 4), Simd::Load(m_linear + 8), Simd::Load(m_linear + 12) };
+	float transformed[4];
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		Simd::Store(transformed, Simd::CombineRows(rows, points[i].m_x, points[i].m_y, points[i].m_z, 1.0f));
+		results[i] = Vector3f(transformed[0], transformed[1], transformed[2]);
+	}
+}
+
+void Matrix4::Multiply(const Matrix4 *lefts, const Matrix4 *rights, Matrix4 *results, const std::size_t &count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		results[i] = lefts[i].Multiply(rights[i]);
+	}
 }
 
 Matrix4 Matrix4::Translate(const Vector2f &other) const
@@ -235,27 +256,42 @@ Matrix4 Matrix4::Inverse() const
 {
 	Matrix4 result = Matrix4();
 
-	float det = Determinant();
+	// The 2x2 minors of the top and bottom two rows, every cofactor is built from these instead of a 3x3 submatrix.
+	auto &a = m_rows;
+	float s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+	float s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+	float s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+	float s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+	float s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+	float s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+	float c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+	float c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+	float c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+	float c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+	float c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+	float c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+
+	float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 
 	if (det == 0.0f)
 	{
 		throw std::runtime_error("Can't invert a matrix with a determinant of zero");
 	}
 
-	for (int32_t j = 0; j < 4; j++)
-	{
-		for (int32_t i = 0; i < 4; i++)
-		{
-			// Get minor of element [j][i] - not [i][j], this is where the transpose happens.
-			Matrix3 minorSubmatrix = GetSubmatrix(j, i);
-			float minor = minorSubmatrix.Determinant();
+	result[0] = Vector4f(a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3, -a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3,
+		a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3, -a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3);
+	result[1] = Vector4f(-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1, a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1,
+		-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1, a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1);
+	result[2] = Vector4f(a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0, -a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0,
+		a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0, -a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0);
+	result[3] = Vector4f(-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0, a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0,
+		-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0, a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0);
 
-			// Multiply by (−1)^{i+j}.
-			float factor = ((i + j) % 2 == 1) ? -1.0f : 1.0f;
-			float cofactor = minor * factor;
+	auto invDet = Simd::Splat(1.0f / det);
 
-			result[i][j] = cofactor / det;
-		}
+	for (int32_t row = 0; row < 4; row++)
+	{
+		Simd::Store(result.m_linear + 4 * row, Simd::Multiply(Simd::Load(result.m_linear + 4 * row), invDet));
 	}
 
 	return result;
@@ -278,21 +314,20 @@ Matrix4 Matrix4::Transpose() const
 
 float Matrix4::Determinant() const
 {
-	float result = 0.0f;
-
-	for (int32_t i = 0; i < 4; i++)
-	{
-		// Get minor of element [0][i].
-		Matrix3 minorSubmatrix = GetSubmatrix(0, i);
-		float minor = minorSubmatrix.Determinant();
-
-		// If this is an odd-numbered row, negate the value.
-		float factor = (i % 2 == 1) ? -1.0f : 1.0f;
-
-		result += factor * m_rows[0][i] * minor;
-	}
-
-	return result;
+	auto &a = m_rows;
+	float s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+	float s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+	float s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+	float s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+	float s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+	float s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+	float c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+	float c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+	float c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+	float c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+	float c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+	float c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+	return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 }
 
 Matrix3 Matrix4::GetSubmatrix(const int32_t &row, const int32_t &col) const
@@ -87,6 +87,31 @@ public:
 	 **/
 	Vector4f Transform(const Vector4f &other) const;
 
+	/**
+	 * Transforms a array of vectors by this matrix.
+	 * @param points The vectors. 
+	 * @param results The transformed vectors, this may be the same array as points. 
+	 * @param count The number of vectors. 
+	 **/
+	void Transform(const Vector4f *points, Vector4f *results, const std::size_t &count) const;
+
+	/**
+	 * Transforms a array of points by this matrix, the points have a w of one.
+	 * @param points The points. 
+	 * @param results The transformed points, this may be the same array as points. 
+	 * @param count The number of points. 
+	 **/
+	void TransformPoints(const Vector3f *points, Vector3f *results, const std::size_t &count) const;
+
+	/**
+	 * Multiplies arrays of matrices, each result is lefts[i].Multiply(rights[i]).
+	 * @param lefts The left matrices. 
+	 * @param rights The right matrices. 
+	 * @param results The resultant matrices. 
+	 * @param count The number of matrices. 
+	 **/
+	static void Multiply(const Matrix4 *lefts, const Matrix4 *rights, Matrix4 *results, const std::size_t &count);
+
 	/**
 	 * Translates this matrix by a vector.
 	 * @param other The vector. 
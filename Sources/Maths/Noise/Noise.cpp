@@ -1,6 +1,8 @@
 ﻿#include "Noise.hpp"
 
 #include <random>
+#include "Engine/Engine.hpp"
+#include "Maths/Simd.hpp"
 
 namespace acid
 {
@@ -59,6 +61,44 @@ static const float CUBIC_3D_BOUNDING = 1.0f / (1.5f * 1.5f * 1.5f);
 
 static const int32_t FN_CELLULAR_INDEX_MAX = 3;
 
+// Batches of points are split into jobs of this many points.
+static const std::size_t BATCH_POINTS = 256;
+
+// Runs each job on the engines job system, or on the calling thread when there is no engine.
+static void ForEachBatch(const std::size_t &count, const std::function<void(const std::size_t &)> &function)
+{
+	if (auto engine = Engine::Get(); engine != nullptr && count > 1)
+	{
+		engine->GetThreadPool().ParallelFor(0, count, function);
+		return;
+	}
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		function(i);
+	}
+}
+
+// The lane versions of the interpolation helpers, written with the same operation order so every lane matches the scalar result.
+static Simd::Float4 InterpLanes(const Noise::Interp &interp, const Simd::Float4 &t)
+{
+	switch (interp)
+	{
+	case Noise::Interp::Hermite:
+		return Simd::Multiply(Simd::Multiply(t, t), Simd::Subtract(Simd::Splat(3.0f), Simd::Multiply(Simd::Splat(2.0f), t)));
+	case Noise::Interp::Quintic:
+		return Simd::Multiply(Simd::Multiply(Simd::Multiply(t, t), t),
+			Simd::Add(Simd::Multiply(t, Simd::Subtract(Simd::Multiply(t, Simd::Splat(6.0f)), Simd::Splat(15.0f))), Simd::Splat(10.0f)));
+	default:
+		return t;
+	}
+}
+
+static Simd::Float4 LerpLanes(const Simd::Float4 &a, const Simd::Float4 &b, const Simd::Float4 &t)
+{
+	return Simd::Add(a, Simd::Multiply(t, Simd::Subtract(b, a)));
+}
+
 static const float CELL_2D_X[] = { -0.6440658039f, -0.08028078721f, 0.9983546168f, 0.9869492062f, 0.9284746418f, 0.6051097552f, -0.794167404f, -0.3488667991f, -0.943136526f,
 	-0.9968171318f, 0.8740961579f, 0.1421139764f, 0.4282553608f, -0.9986665833f, 0.9996760121f, -0.06248383632f, 0.7120139305f, 0.8917660409f, 0.1094842955f, -0.8730880804f,
 	0.2594811489f, -0.6690063346f, -0.9996834972f, -0.8803608671f, -0.8166554937f, 0.8955599676f, -0.9398321388f, 0.07615451399f, -0.7147270565f, 0.8707354457f, -0.9580008579f,
@@ -712,6 +752,199 @@ float Noise::GetWhiteNoiseInt(int32_t x, int32_t y, int32_t z, int32_t w) const
 	return ValueCoord4d(m_seed, x, y, z, w);
 }
 
+// Batch
+void Noise::GetNoiseGrid(float *values, const Vector2f &start, const Vector2f &step, const Vector2ui &size) const
+{
+	ForEachBatch(size.m_y, [&](const std::size_t &row)
+	{
+		std::vector<float> x(size.m_x);
+		std::vector<float> y(size.m_x, start.m_y + static_cast<float>(row) * step.m_y);
+
+		for (uint32_t col = 0; col < size.m_x; col++)
+		{
+			x[col] = start.m_x + static_cast<float>(col) * step.m_x;
+		}
+
+		GetNoiseBatch(values + row * size.m_x, x.data(), y.data(), nullptr, size.m_x);
+	});
+}
+
+void Noise::GetNoiseGrid(float *values, const Vector3f &start, const Vector3f &step, const Vector3ui &size) const
+{
+	ForEachBatch(static_cast<std::size_t>(size.m_y) * size.m_z, [&](const std::size_t &row)
+	{
+		std::vector<float> x(size.m_x);
+		std::vector<float> y(size.m_x, start.m_y + static_cast<float>(row % size.m_y) * step.m_y);
+		std::vector<float> z(size.m_x, start.m_z + static_cast<float>(row / size.m_y) * step.m_z);
+
+		for (uint32_t col = 0; col < size.m_x; col++)
+		{
+			x[col] = start.m_x + static_cast<float>(col) * step.m_x;
+		}
+
+		GetNoiseBatch(values + row * size.m_x, x.data(), y.data(), z.data(), size.m_x);
+	});
+}
+
+void Noise::GetNoisePoints(float *values, const Vector2f *points, const std::size_t &count) const
+{
+	ForEachBatch((count + BATCH_POINTS - 1) / BATCH_POINTS, [&](const std::size_t &batch)
+	{
+		auto begin = batch * BATCH_POINTS;
+		auto end = std::min(begin + BATCH_POINTS, count);
+		std::vector<float> x(end - begin);
+		std::vector<float> y(end - begin);
+
+		for (auto i = begin; i < end; i++)
+		{
+			x[i - begin] = points[i].m_x;
+			y[i - begin] = points[i].m_y;
+		}
+
+		GetNoiseBatch(values + begin, x.data(), y.data(), nullptr, end - begin);
+	});
+}
+
+void Noise::GetNoisePoints(float *values, const Vector3f *points, const std::size_t &count) const
+{
+	ForEachBatch((count + BATCH_POINTS - 1) / BATCH_POINTS, [&](const std::size_t &batch)
+	{
+		auto begin = batch * BATCH_POINTS;
+		auto end = std::min(begin + BATCH_POINTS, count);
+		std::vector<float> x(end - begin);
+		std::vector<float> y(end - begin);
+		std::vector<float> z(end - begin);
+
+		for (auto i = begin; i < end; i++)
+		{
+			x[i - begin] = points[i].m_x;
+			y[i - begin] = points[i].m_y;
+			z[i - begin] = points[i].m_z;
+		}
+
+		GetNoiseBatch(values + begin, x.data(), y.data(), z.data(), end - begin);
+	});
+}
+
+void Noise::GetNoiseBatch(float *values, const float *x, const float *y, const float *z, const std::size_t &count) const
+{
+	if (m_type != Type::Perlin && m_type != Type::PerlinFractal)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			values[i] = z != nullptr ? GetNoise(x[i], y[i], z[i]) : GetNoise(x[i], y[i]);
+		}
+
+		return;
+	}
+
+	for (std::size_t i = 0; i < count; i += 4)
+	{
+		// The last group repeats its final point in the unused lanes.
+		float laneX[4], laneY[4], laneZ[4], laneValues[4];
+
+		for (std::size_t lane = 0; lane < 4; lane++)
+		{
+			auto index = std::min(i + lane, count - 1);
+			laneX[lane] = x[index] * m_frequency;
+			laneY[lane] = y[index] * m_frequency;
+			laneZ[lane] = z != nullptr ? z[index] * m_frequency : 0.0f;
+		}
+
+		GetPerlinLanes(laneValues, laneX, laneY, z != nullptr ? laneZ : nullptr);
+		std::copy(laneValues, laneValues + std::min<std::size_t>(4, count - i), values + i);
+	}
+}
+
+void Noise::GetPerlinLanes(float *values, const float *x, const float *y, const float *z) const
+{
+	auto Octave = [this, z](const uint8_t &offset, const float *laneX, const float *laneY, const float *laneZ)
+	{
+		float octave[4];
+
+		if (z != nullptr)
+		{
+			SinglePerlinLanes(offset, laneX, laneY, laneZ, octave);
+		}
+		else
+		{
+			SinglePerlinLanes(offset, laneX, laneY, octave);
+		}
+
+		return Simd::Load(octave);
+	};
+	auto Abs = [](const Simd::Float4 &value)
+	{
+		return Simd::Max(value, Simd::Subtract(Simd::Splat(0.0f), value));
+	};
+
+	if (m_type == Type::Perlin)
+	{
+		Simd::Store(values, Octave(0, x, y, z));
+		return;
+	}
+
+	// Matches the scalar fractals, the first octave uses the first permutation and later octaves scale the coordinates by the lacunarity.
+	float laneX[4], laneY[4], laneZ[4] = {};
+	std::copy(x, x + 4, laneX);
+	std::copy(y, y + 4, laneY);
+
+	if (z != nullptr)
+	{
+		std::copy(z, z + 4, laneZ);
+	}
+
+	auto one = Simd::Splat(1.0f);
+	auto two = Simd::Splat(2.0f);
+	auto lacunarity = Simd::Splat(m_lacunarity);
+	auto sum = Octave(m_perm[0], laneX, laneY, laneZ);
+
+	switch (m_fractal)
+	{
+	case Fractal::FBM:
+		break;
+	case Fractal::Billow:
+		sum = Simd::Subtract(Simd::Multiply(Abs(sum), two), one);
+		break;
+	case Fractal::RigidMulti:
+		sum = Simd::Subtract(one, Abs(sum));
+		break;
+	}
+
+	float amp = 1.0f;
+	int32_t i = 0;
+
+	while (++i < m_octaves)
+	{
+		Simd::Store(laneX, Simd::Multiply(Simd::Load(laneX), lacunarity));
+		Simd::Store(laneY, Simd::Multiply(Simd::Load(laneY), lacunarity));
+		Simd::Store(laneZ, Simd::Multiply(Simd::Load(laneZ), lacunarity));
+
+		amp *= m_gain;
+		auto octave = Octave(m_perm[i], laneX, laneY, laneZ);
+
+		switch (m_fractal)
+		{
+		case Fractal::FBM:
+			sum = Simd::Add(sum, Simd::Multiply(octave, Simd::Splat(amp)));
+			break;
+		case Fractal::Billow:
+			sum = Simd::Add(sum, Simd::Multiply(Simd::Subtract(Simd::Multiply(Abs(octave), two), one), Simd::Splat(amp)));
+			break;
+		case Fractal::RigidMulti:
+			sum = Simd::Subtract(sum, Simd::Multiply(Simd::Subtract(one, Abs(octave)), Simd::Splat(amp)));
+			break;
+		}
+	}
+
+	if (m_fractal != Fractal::RigidMulti)
+	{
+		sum = Simd::Multiply(sum, Simd::Splat(m_fractalBounding));
+	}
+
+	Simd::Store(values, sum);
+}
+
 void Noise::CalculateFractalBounding()
 {
 	float amp = m_gain;
@@ -1682,6 +1915,95 @@ float Noise::SinglePerlin(const uint8_t &offset, const float &x, const float &y,
 	return Lerp(yf0, yf1, zs);
 }
 
+void Noise::SinglePerlinLanes(const uint8_t &offset, const float *x, const float *y, float *values) const
+{
+	// Lattice lookups are gathered one lane at a time, the interpolation runs on every lane at once.
+	int32_t x0[4], y0[4];
+	float floorX[4], floorY[4], gradX[4][4], gradY[4][4];
+
+	for (uint32_t lane = 0; lane < 4; lane++)
+	{
+		x0[lane] = FastFloor(x[lane]);
+		y0[lane] = FastFloor(y[lane]);
+		floorX[lane] = static_cast<float>(x0[lane]);
+		floorY[lane] = static_cast<float>(y0[lane]);
+
+		for (uint32_t corner = 0; corner < 4; corner++)
+		{
+			auto lut = Index2d12(offset, x0[lane] + (corner & 1), y0[lane] + (corner >> 1));
+			gradX[corner][lane] = GRAD_X[lut];
+			gradY[corner][lane] = GRAD_Y[lut];
+		}
+	}
+
+	auto one = Simd::Splat(1.0f);
+	auto xd0 = Simd::Subtract(Simd::Load(x), Simd::Load(floorX));
+	auto yd0 = Simd::Subtract(Simd::Load(y), Simd::Load(floorY));
+	auto xd1 = Simd::Subtract(xd0, one);
+	auto yd1 = Simd::Subtract(yd0, one);
+	auto xs = InterpLanes(m_interp, xd0);
+	auto ys = InterpLanes(m_interp, yd0);
+
+	auto Grad = [&](const uint32_t &corner, const Simd::Float4 &xd, const Simd::Float4 &yd)
+	{
+		return Simd::Add(Simd::Multiply(xd, Simd::Load(gradX[corner])), Simd::Multiply(yd, Simd::Load(gradY[corner])));
+	};
+
+	auto xf0 = LerpLanes(Grad(0, xd0, yd0), Grad(1, xd1, yd0), xs);
+	auto xf1 = LerpLanes(Grad(2, xd0, yd1), Grad(3, xd1, yd1), xs);
+	Simd::Store(values, LerpLanes(xf0, xf1, ys));
+}
+
+void Noise::SinglePerlinLanes(const uint8_t &offset, const float *x, const float *y, const float *z, float *values) const
+{
+	int32_t x0[4], y0[4], z0[4];
+	float floorX[4], floorY[4], floorZ[4], gradX[8][4], gradY[8][4], gradZ[8][4];
+
+	for (uint32_t lane = 0; lane < 4; lane++)
+	{
+		x0[lane] = FastFloor(x[lane]);
+		y0[lane] = FastFloor(y[lane]);
+		z0[lane] = FastFloor(z[lane]);
+		floorX[lane] = static_cast<float>(x0[lane]);
+		floorY[lane] = static_cast<float>(y0[lane]);
+		floorZ[lane] = static_cast<float>(z0[lane]);
+
+		for (uint32_t corner = 0; corner < 8; corner++)
+		{
+			auto lut = Index3d12(offset, x0[lane] + (corner & 1), y0[lane] + ((corner >> 1) & 1), z0[lane] + (corner >> 2));
+			gradX[corner][lane] = GRAD_X[lut];
+			gradY[corner][lane] = GRAD_Y[lut];
+			gradZ[corner][lane] = GRAD_Z[lut];
+		}
+	}
+
+	auto one = Simd::Splat(1.0f);
+	auto xd0 = Simd::Subtract(Simd::Load(x), Simd::Load(floorX));
+	auto yd0 = Simd::Subtract(Simd::Load(y), Simd::Load(floorY));
+	auto zd0 = Simd::Subtract(Simd::Load(z), Simd::Load(floorZ));
+	auto xd1 = Simd::Subtract(xd0, one);
+	auto yd1 = Simd::Subtract(yd0, one);
+	auto zd1 = Simd::Subtract(zd0, one);
+	auto xs = InterpLanes(m_interp, xd0);
+	auto ys = InterpLanes(m_interp, yd0);
+	auto zs = InterpLanes(m_interp, zd0);
+
+	auto Grad = [&](const uint32_t &corner, const Simd::Float4 &xd, const Simd::Float4 &yd, const Simd::Float4 &zd)
+	{
+		return Simd::Add(Simd::Add(Simd::Multiply(xd, Simd::Load(gradX[corner])), Simd::Multiply(yd, Simd::Load(gradY[corner]))),
+			Simd::Multiply(zd, Simd::Load(gradZ[corner])));
+	};
+
+	auto xf00 = LerpLanes(Grad(0, xd0, yd0, zd0), Grad(1, xd1, yd0, zd0), xs);
+	auto xf10 = LerpLanes(Grad(2, xd0, yd1, zd0), Grad(3, xd1, yd1, zd0), xs);
+	auto xf01 = LerpLanes(Grad(4, xd0, yd0, zd1), Grad(5, xd1, yd0, zd1), xs);
+	auto xf11 = LerpLanes(Grad(6, xd0, yd1, zd1), Grad(7, xd1, yd1, zd1), xs);
+
+	auto yf0 = LerpLanes(xf00, xf10, ys);
+	auto yf1 = LerpLanes(xf01, xf11, ys);
+	Simd::Store(values, LerpLanes(yf0, yf1, zs));
+}
+
 float Noise::SingleSimplexFractalFbm(float x, float y, float z) const
 {
 	float sum = SingleSimplex(m_perm[0], x, y, z);
@@ -25,6 +25,8 @@
 #pragma once
 
 #include "StdAfx.hpp"
+#include "Maths/Vector2.hpp"
+#include "Maths/Vector3.hpp"
 
 namespace acid
 {
@@ -313,7 +315,53 @@ public:
 
 	float GetWhiteNoiseInt(int32_t x, int32_t y, int32_t z, int32_t w) const;
 
+	//Batch
+	/**
+	 * Fills a grid with the values of {@link Noise#GetNoise}, rows are split between the engines job system.
+	 * Perlin noise and its fractals are evaluated four samples at a time with SIMD, other types are evaluated one sample at a time.
+	 * @param values The values, row by row, with space for every sample of the grid.
+	 * @param start The position of the first sample.
+	 * @param step The distance between samples along each axis.
+	 * @param size The number of samples along each axis.
+	 */
+	void GetNoiseGrid(float *values, const Vector2f &start, const Vector2f &step, const Vector2ui &size) const;
+
+	/**
+	 * Fills a grid with the values of {@link Noise#GetNoise}, rows of each layer are split between the engines job system.
+	 * @param values The values, row by row then layer by layer, with space for every sample of the grid.
+	 * @param start The position of the first sample.
+	 * @param step The distance between samples along each axis.
+	 * @param size The number of samples along each axis.
+	 */
+	void GetNoiseGrid(float *values, const Vector3f &start, const Vector3f &step, const Vector3ui &size) const;
+
+	/**
+	 * Fills an array with the values of {@link Noise#GetNoise} at each point, the points are split between the engines job system.
+	 * @param values The values, with space for every point.
+	 * @param points The points to sample.
+	 * @param count The number of points.
+	 */
+	void GetNoisePoints(float *values, const Vector2f *points, const std::size_t &count) const;
+
+	/**
+	 * Fills an array with the values of {@link Noise#GetNoise} at each point, the points are split between the engines job system.
+	 * @param values The values, with space for every point.
+	 * @param points The points to sample.
+	 * @param count The number of points.
+	 */
+	void GetNoisePoints(float *values, const Vector3f *points, const std::size_t &count) const;
+
 private:
+	// Evaluates GetNoise for arrays of coordinates, z is null for 2D noise.
+	void GetNoiseBatch(float *values, const float *x, const float *y, const float *z, const std::size_t &count) const;
+
+	// Evaluates four lanes of Perlin noise or its fractal, coordinates are already scaled by the frequency.
+	void GetPerlinLanes(float *values, const float *x, const float *y, const float *z) const;
+
+	void SinglePerlinLanes(const uint8_t &offset, const float *x, const float *y, float *values) const;
+
+	void SinglePerlinLanes(const uint8_t &offset, const float *x, const float *y, const float *z, float *values) const;
+
 	void CalculateFractalBounding();
 
 	// Helpers
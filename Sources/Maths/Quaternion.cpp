@@ -1,7 +1,11 @@
 #include "Quaternion.hpp"
 
+#include "Simd.hpp"
+
 namespace acid
 {
+static_assert(std::is_trivially_copyable_v<Quaternion>, "Quaternion is passed and stored as a plain value");
+
 const Quaternion Quaternion::Zero = Quaternion(0.0f, 0.0f, 0.0f, 0.0f);
 const Quaternion Quaternion::One = Quaternion(1.0f, 1.0f, 1.0f, 1.0f);
 const Quaternion Quaternion::OneW = Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
@@ -135,7 +139,9 @@ float Quaternion::Dot(const Quaternion &other) const
 
 Quaternion Quaternion::Slerp(const Quaternion &other, const float &progression) const
 {
-	float cosom = m_x * other.m_x + m_y * other.m_y + m_z * other.m_z + m_w * other.m_w;
+	auto left = Simd::Load(&m_x);
+	auto right = Simd::Load(&other.m_x);
+	float cosom = Simd::Dot(left, right);
 	float absCosom = std::abs(cosom);
 	float scale0, scale1;
 
@@ -155,13 +161,18 @@ Quaternion Quaternion::Slerp(const Quaternion &other, const float &progression)
 
 	scale1 = cosom >= 0.0f ? scale1 : -scale1;
 	Quaternion result = Quaternion();
-	result.m_x = scale0 * m_x + scale1 * other.m_x;
-	result.m_y = scale0 * m_y + scale1 * other.m_y;
-	result.m_z = scale0 * m_z + scale1 * other.m_z;
-	result.m_w = scale0 * m_w + scale1 * other.m_w;
+	Simd::Store(&result.m_x, Simd::MultiplyAdd(right, Simd::Splat(scale1), Simd::Multiply(left, Simd::Splat(scale0))));
 	return result;
 }
 
+void Quaternion::Slerp(const Quaternion *from, const Quaternion *to, const float &progression, Quaternion *results, const std::size_t &count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		results[i] = from[i].Slerp(to[i], progression);
+	}
+}
+
 Quaternion Quaternion::Scale(const float &scalar) const
 {
 	return Quaternion(m_x * scalar, m_y * scalar, m_z * scalar, m_w * scalar);
@@ -91,6 +91,16 @@ public:
 	 **/
 	Quaternion Slerp(const Quaternion &other, const float &progression) const;
 
+	/**
+	 * Calculates the slerp between arrays of quaternions, they must be normalized!
+	 * @param from The left quaternions. 
+	 * @param to The right quaternions. 
+	 * @param progression The progression shared by every pair. 
+	 * @param results The resultant quaternions, this may be the same array as from or to. 
+	 * @param count The number of quaternions. 
+	 **/
+	static void Slerp(const Quaternion *from, const Quaternion *to, const float &progression, Quaternion *results, const std::size_t &count);
+
 	/**
 	 * Scales this quaternion by a scalar.
 	 * @param scalar The scalar value. 
@@ -147,19 +157,19 @@ public:
 	 **/
 	Vector3f ToEuler() const;
 
-	const float &GetX() const { return m_x; }
+	float GetX() const { return m_x; }
 
 	void SetX(const float &x) { m_x = x; }
 
-	const float &GetY() const { return m_y; }
+	float GetY() const { return m_y; }
 
 	void SetY(const float &y) { m_y = y; }
 
-	const float &GetZ() const { return m_z; }
+	float GetZ() const { return m_z; }
 
 	void SetZ(const float &z) { m_z = z; }
 
-	const float &GetW() const { return m_w; }
+	float GetW() const { return m_w; }
 
 	void SetW(const float &w) { m_w = w; }
 
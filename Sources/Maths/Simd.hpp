@@ -0,0 +1,221 @@
+#pragma once
+
+#include "StdAfx.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ACID_SIMD_SSE
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ACID_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace acid
+{
+/**
+ * @brief Four wide float operations used by the maths classes, selected at compile time between SSE, NEON and a scalar fallback.
+ * Loads and stores are unaligned, so any four packed floats such as a {@link Vector4f} row can be used.
+ **/
+class Simd
+{
+public:
+#if defined(ACID_SIMD_SSE)
+	using Float4 = __m128;
+#elif defined(ACID_SIMD_NEON)
+	using Float4 = float32x4_t;
+#else
+	struct Float4
+	{
+		float m_lanes[4];
+	};
+#endif
+
+	static Float4 Load(const float *source)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_loadu_ps(source);
+#elif defined(ACID_SIMD_NEON)
+		return vld1q_f32(source);
+#else
+		return Float4{{source[0], source[1], source[2], source[3]}};
+#endif
+	}
+
+	static void Store(float *destination, const Float4 &value)
+	{
+#if defined(ACID_SIMD_SSE)
+		_mm_storeu_ps(destination, value);
+#elif defined(ACID_SIMD_NEON)
+		vst1q_f32(destination, value);
+#else
+		std::memcpy(destination, value.m_lanes, sizeof(value.m_lanes));
+#endif
+	}
+
+	static Float4 Splat(const float &value)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_set1_ps(value);
+#elif defined(ACID_SIMD_NEON)
+		return vdupq_n_f32(value);
+#else
+		return Float4{{value, value, value, value}};
+#endif
+	}
+
+	static Float4 Add(const Float4 &a, const Float4 &b)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_add_ps(a, b);
+#elif defined(ACID_SIMD_NEON)
+		return vaddq_f32(a, b);
+#else
+		return Float4{{a.m_lanes[0] + b.m_lanes[0], a.m_lanes[1] + b.m_lanes[1], a.m_lanes[2] + b.m_lanes[2], a.m_lanes[3] + b.m_lanes[3]}};
+#endif
+	}
+
+	static Float4 Subtract(const Float4 &a, const Float4 &b)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_sub_ps(a, b);
+#elif defined(ACID_SIMD_NEON)
+		return vsubq_f32(a, b);
+#else
+		return Float4{{a.m_lanes[0] - b.m_lanes[0], a.m_lanes[1] - b.m_lanes[1], a.m_lanes[2] - b.m_lanes[2], a.m_lanes[3] - b.m_lanes[3]}};
+#endif
+	}
+
+	static Float4 Min(const Float4 &a, const Float4 &b)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_min_ps(a, b);
+#elif defined(ACID_SIMD_NEON)
+		return vminq_f32(a, b);
+#else
+		return Float4{{std::min(a.m_lanes[0], b.m_lanes[0]), std::min(a.m_lanes[1], b.m_lanes[1]), std::min(a.m_lanes[2], b.m_lanes[2]), std::min(a.m_lanes[3], b.m_lanes[3])}};
+#endif
+	}
+
+	static Float4 Max(const Float4 &a, const Float4 &b)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_max_ps(a, b);
+#elif defined(ACID_SIMD_NEON)
+		return vmaxq_f32(a, b);
+#else
+		return Float4{{std::max(a.m_lanes[0], b.m_lanes[0]), std::max(a.m_lanes[1], b.m_lanes[1]), std::max(a.m_lanes[2], b.m_lanes[2]), std::max(a.m_lanes[3], b.m_lanes[3])}};
+#endif
+	}
+
+	static Float4 Multiply(const Float4 &a, const Float4 &b)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_mul_ps(a, b);
+#elif defined(ACID_SIMD_NEON)
+		return vmulq_f32(a, b);
+#else
+		return Float4{{a.m_lanes[0] * b.m_lanes[0], a.m_lanes[1] * b.m_lanes[1], a.m_lanes[2] * b.m_lanes[2], a.m_lanes[3] * b.m_lanes[3]}};
+#endif
+	}
+
+	static Float4 Sqrt(const Float4 &a)
+	{
+#if defined(ACID_SIMD_SSE)
+		return _mm_sqrt_ps(a);
+#elif defined(ACID_SIMD_NEON) && defined(__aarch64__)
+		return vsqrtq_f32(a);
+#else
+		float lanes[4];
+		Store(lanes, a);
+
+		for (auto &lane : lanes)
+		{
+			lane = std::sqrt(lane);
+		}
+
+		return Load(lanes);
+#endif
+	}
+
+	/**
+	 * Compares each lane of a to b.
+	 * @param a The first values.
+	 * @param b The second values.
+	 * @return A bit mask with the lowest bit set if the first lane of a is greater, up to the fourth bit for the fourth lane.
+	 **/
+	static uint32_t Greater(const Float4 &a, const Float4 &b)
+	{
+#if defined(ACID_SIMD_SSE)
+		return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(a, b)));
+#elif defined(ACID_SIMD_NEON)
+		// Each lane keeps only its own bit of the mask, the lanes are then summed.
+		static const uint32_t bits[4] = { 1, 2, 4, 8 };
+		auto masked = vandq_u32(vcgtq_f32(a, b), vld1q_u32(bits));
+#if defined(__aarch64__)
+		return vaddvq_u32(masked);
+#else
+		auto sums = vadd_u32(vget_low_u32(masked), vget_high_u32(masked));
+		return vget_lane_u32(vpadd_u32(sums, sums), 0);
+#endif
+#else
+		return static_cast<uint32_t>(a.m_lanes[0] > b.m_lanes[0]) | static_cast<uint32_t>(a.m_lanes[1] > b.m_lanes[1]) << 1 |
+			static_cast<uint32_t>(a.m_lanes[2] > b.m_lanes[2]) << 2 | static_cast<uint32_t>(a.m_lanes[3] > b.m_lanes[3]) << 3;
+#endif
+	}
+
+	/**
+	 * Computes a * b + c, fused when the target has FMA.
+	 **/
+	static Float4 MultiplyAdd(const Float4 &a, const Float4 &b, const Float4 &c)
+	{
+#if defined(ACID_SIMD_SSE) && defined(__FMA__)
+		return _mm_fmadd_ps(a, b, c);
+#elif defined(ACID_SIMD_SSE)
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+#elif defined(ACID_SIMD_NEON)
+		return vmlaq_f32(c, a, b);
+#else
+		return Add(Multiply(a, b), c);
+#endif
+	}
+
+	/**
+	 * Sums the four lanes of a * b.
+	 **/
+	static float Dot(const Float4 &a, const Float4 &b)
+	{
+#if defined(ACID_SIMD_SSE)
+		auto product = _mm_mul_ps(a, b);
+		auto shuffled = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+		auto sums = _mm_add_ps(product, shuffled);
+		shuffled = _mm_movehl_ps(shuffled, sums);
+		return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+#elif defined(ACID_SIMD_NEON) && defined(__aarch64__)
+		return vaddvq_f32(vmulq_f32(a, b));
+#elif defined(ACID_SIMD_NEON)
+		auto product = vmulq_f32(a, b);
+		auto sums = vadd_f32(vget_low_f32(product), vget_high_f32(product));
+		return vget_lane_f32(vpadd_f32(sums, sums), 0);
+#else
+		return a.m_lanes[0] * b.m_lanes[0] + a.m_lanes[1] * b.m_lanes[1] + a.m_lanes[2] * b.m_lanes[2] + a.m_lanes[3] * b.m_lanes[3];
+#endif
+	}
+
+	/**
+	 * Multiplies four rows by the lanes of a vector and sums them, this is the core of every row major matrix product.
+	 * @param rows The four rows, 16 packed floats.
+	 * @param x The factor of the first row.
+	 * @param y The factor of the second row.
+	 * @param z The factor of the third row.
+	 * @param w The factor of the fourth row.
+	 * @return The sum of the scaled rows.
+	 **/
+	static Float4 CombineRows(const Float4 rows[4], const float &x, const float &y, const float &z, const float &w)
+	{
+		auto result = Multiply(rows[0], Splat(x));
+		result = MultiplyAdd(rows[1], Splat(y), result);
+		result = MultiplyAdd(rows[2], Splat(z), result);
+		return MultiplyAdd(rows[3], Splat(w), result);
+	}
+};
+}
@@ -25,7 +25,7 @@ Transform Transform::Multiply(const Transform &other) const
 	return Transform(Vector3f(GetWorldMatrix().Transform(Vector4f(other.m_position))), m_rotation + other.m_rotation, m_scaling * other.m_scaling);
 }
 
-Matrix4 Transform::GetWorldMatrix() const
+const Matrix4 &Transform::GetWorldMatrix() const
 {
 	if (m_dirty)
 	{
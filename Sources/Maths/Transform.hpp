@@ -35,7 +35,7 @@ public:
 	 */
 	Transform Multiply(const Transform &other) const;
 
-	Matrix4 GetWorldMatrix() const;
+	const Matrix4 &GetWorldMatrix() const;
 
 	const Vector3f &GetPosition() const { return m_position; }
 
@@ -49,7 +49,7 @@ public:
 
 	void SetScaling(const Vector3f &scaling);
 
-	const bool &IsDirty() const { return m_dirty; }
+	bool IsDirty() const { return m_dirty; }
 
 	void SetDirty(const bool &dirty) const;
 
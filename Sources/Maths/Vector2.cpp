@@ -2,6 +2,8 @@
 
 namespace acid
 {
+static_assert(std::is_trivially_copyable_v<Vector2f>, "Vector2 is passed and stored as a plain value");
+
 template<> const Vector2f Vector2f::Zero = Vector2f(0.0f, 0.0f);
 template<> const Vector2f Vector2f::One = Vector2f(1.0f, 1.0f);
 template<> const Vector2f Vector2f::Left = Vector2f(-1.0f, 0.0f);
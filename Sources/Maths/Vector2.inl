@@ -7,21 +7,21 @@
 namespace acid
 {
 template<typename T>
-Vector2<T>::Vector2():
+constexpr Vector2<T>::Vector2():
 	m_x(0),
 	m_y(0)
 {
 }
 
 template<typename T>
-Vector2<T>::Vector2(const T &a):
+constexpr Vector2<T>::Vector2(T a):
 	m_x(a),
 	m_y(a)
 {
 }
 
 template<typename T>
-Vector2<T>::Vector2(const T &x, const T &y):
+constexpr Vector2<T>::Vector2(T x, T y):
 	m_x(x),
 	m_y(y)
 {
@@ -29,7 +29,7 @@ Vector2<T>::Vector2(const T &x, const T &y):
 
 template<typename T>
 template<typename K>
-Vector2<T>::Vector2(const Vector2<K> &source):
+constexpr Vector2<T>::Vector2(const Vector2<K> &source):
 	m_x(static_cast<T>(source.m_x)),
 	m_y(static_cast<T>(source.m_y))
 {
@@ -37,7 +37,7 @@ Vector2<T>::Vector2(const Vector2<K> &source):
 
 template<typename T>
 template<typename K>
-Vector2<T>::Vector2(const Vector3<K> &source):
+constexpr Vector2<T>::Vector2(const Vector3<K> &source):
 	m_x(static_cast<T>(source.m_x)),
 	m_y(static_cast<T>(source.m_y))
 {
@@ -45,28 +45,28 @@ Vector2<T>::Vector2(const Vector3<K> &source):
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::Add(const Vector2<K> &other) const
+constexpr auto Vector2<T>::Add(const Vector2<K> &other) const
 {
 	return Vector2<decltype(m_x + other.m_x)>(m_x + other.m_x, m_y + other.m_y);
 }
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::Subtract(const Vector2<K> &other) const
+constexpr auto Vector2<T>::Subtract(const Vector2<K> &other) const
 {
 	return Vector2<decltype(m_x - other.m_x)>(m_x - other.m_x, m_y - other.m_y);
 }
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::Multiply(const Vector2<K> &other) const
+constexpr auto Vector2<T>::Multiply(const Vector2<K> &other) const
 {
 	return Vector2<decltype(m_x * other.m_x)>(m_x * other.m_x, m_y * other.m_y);
 }
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::Divide(const Vector2<K> &other) const
+constexpr auto Vector2<T>::Divide(const Vector2<K> &other) const
 {
 	return Vector2<decltype(m_x / other.m_x)>(m_x / other.m_x, m_y / other.m_y);
 }
@@ -91,14 +91,14 @@ auto Vector2<T>::Angle(const Vector2<K> &other) const
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::Dot(const Vector2<K> &other) const
+constexpr auto Vector2<T>::Dot(const Vector2<K> &other) const
 {
 	return m_x * other.m_x + m_y * other.m_y;
 }
 
 template<typename T>
 template<typename K, typename J>
-auto Vector2<T>::Lerp(const Vector2<K> &other, const J &progression) const
+constexpr auto Vector2<T>::Lerp(const Vector2<K> &other, J progression) const
 {
 	auto ta = *this * (1 - progression);
 	auto tb = other * progression;
@@ -107,21 +107,21 @@ auto Vector2<T>::Lerp(const Vector2<K> &other, const J &progression) const
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::Scale(const K &scalar) const
+constexpr auto Vector2<T>::Scale(K scalar) const
 {
 	return Vector2<decltype(m_x * scalar)>(m_x * scalar, m_y * scalar);
 }
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::Rotate(const K &angle) const
+auto Vector2<T>::Rotate(K angle) const
 {
 	return Vector2<decltype(m_x * angle)>(m_x * std::cos(angle) - m_y * std::sin(angle), m_x * std::sin(angle) + m_y * std::cos(angle));
 }
 
 template<typename T>
 template<typename K, typename J>
-auto Vector2<T>::Rotate(const K &angle, const Vector2<J> &rotationAxis) const
+auto Vector2<T>::Rotate(K angle, const Vector2<J> &rotationAxis) const
 {
 	auto x = ((m_x - rotationAxis.m_x) * std::cos(angle)) - ((m_y - rotationAxis.m_y) * std::sin(angle) + rotationAxis.m_x);
 	auto y = ((m_x - rotationAxis.m_x) * std::sin(angle)) + ((m_y - rotationAxis.m_y) * std::cos(angle) + rotationAxis.m_y);
@@ -140,7 +140,7 @@ auto Vector2<T>::Normalize() const
 }
 
 template<typename T>
-auto Vector2<T>::LengthSquared() const
+constexpr auto Vector2<T>::LengthSquared() const
 {
 	return m_x * m_x + m_y * m_y;
 }
@@ -185,7 +185,7 @@ auto Vector2<T>::Max(const Vector2<K> &other)
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::DistanceSquared(const Vector2<K> &other) const
+constexpr auto Vector2<T>::DistanceSquared(const Vector2<K> &other) const
 {
 	auto dx = m_x - other.m_x;
 	auto dy = m_y - other.m_y;
@@ -201,7 +201,7 @@ auto Vector2<T>::Distance(const Vector2<K> &other) const
 
 template<typename T>
 template<typename K>
-auto Vector2<T>::DistanceVector(const Vector2<K> &other) const
+constexpr auto Vector2<T>::DistanceVector(const Vector2<K> &other) const
 {
 	return (*this - other) * (*this - other);
 }
@@ -250,34 +250,34 @@ std::string Vector2<T>::ToString() const
 
 template<typename T>
 template<typename K>
-bool Vector2<T>::operator==(const Vector2<K> &other) const
+constexpr bool Vector2<T>::operator==(const Vector2<K> &other) const
 {
 	return m_x == other.m_x && m_y == other.m_y;
 }
 
 template<typename T>
 template<typename K>
-bool Vector2<T>::operator!=(const Vector2<K> &other) const
+constexpr bool Vector2<T>::operator!=(const Vector2<K> &other) const
 {
 	return !(*this == other);
 }
 
 template<typename T>
 template<typename U>
-std::enable_if_t<std::is_signed_v<U>, Vector2<T>> Vector2<T>::operator-() const
+constexpr std::enable_if_t<std::is_signed_v<U>, Vector2<T>> Vector2<T>::operator-() const
 {
 	return Vector2(-m_x, -m_y);
 }
 
 template<typename T>
 template<typename U>
-std::enable_if_t<std::is_integral_v<U>, Vector2<T>> Vector2<T>::operator~() const
+constexpr std::enable_if_t<std::is_integral_v<U>, Vector2<T>> Vector2<T>::operator~() const
 {
 	return Vector2(~m_x, ~m_y);
 }
 
 template<typename T>
-const T &Vector2<T>::operator[](const uint32_t &index) const
+constexpr const T &Vector2<T>::operator[](uint32_t index) const
 {
 	switch (index)
 	{
@@ -291,7 +291,7 @@ const T &Vector2<T>::operator[](const uint32_t &index) const
 }
 
 template<typename T>
-T &Vector2<T>::operator[](const uint32_t &index)
+constexpr T &Vector2<T>::operator[](uint32_t index)
 {
 	switch (index)
 	{
@@ -306,52 +306,52 @@ T &Vector2<T>::operator[](const uint32_t &index)
 
 template<typename T>
 template<typename K>
-Vector2<T> &Vector2<T>::operator+=(const Vector2<K> &other)
+constexpr Vector2<T> &Vector2<T>::operator+=(const Vector2<K> &other)
 {
 	return *this = Add(other);
 }
 
 template<typename T>
 template<typename K>
-Vector2<T> &Vector2<T>::operator-=(const Vector2<K> &other)
+constexpr Vector2<T> &Vector2<T>::operator-=(const Vector2<K> &other)
 {
 	return *this = Subtract(other);
 }
 
 template<typename T>
 template<typename K>
-Vector2<T> &Vector2<T>::operator*=(const Vector2<K> &other)
+constexpr Vector2<T> &Vector2<T>::operator*=(const Vector2<K> &other)
 {
 	return *this = Multiply(other);
 }
 
 template<typename T>
 template<typename K>
-Vector2<T> &Vector2<T>::operator/=(const Vector2<K> &other)
+constexpr Vector2<T> &Vector2<T>::operator/=(const Vector2<K> &other)
 {
 	return *this = Divide(other);
 }
 
 template<typename T>
-Vector2<T> &Vector2<T>::operator+=(const T &other)
+constexpr Vector2<T> &Vector2<T>::operator+=(T other)
 {
 	return *this = Add(Vector2<T>(other));
 }
 
 template<typename T>
-Vector2<T> &Vector2<T>::operator-=(const T &other)
+constexpr Vector2<T> &Vector2<T>::operator-=(T other)
 {
 	return *this = Subtract(Vector2<T>(other));
 }
 
 template<typename T>
-Vector2<T> &Vector2<T>::operator*=(const T &other)
+constexpr Vector2<T> &Vector2<T>::operator*=(T other)
 {
 	return *this = Multiply(Vector2<T>(other));
 }
 
 template<typename T>
-Vector2<T> &Vector2<T>::operator/=(const T &other)
+constexpr Vector2<T> &Vector2<T>::operator/=(T other)
 {
 	return *this = Divide(Vector2<T>(other));
 }
@@ -380,121 +380,121 @@ std::ostream &operator<<(std::ostream &stream, const Vector2<K> &vector)
 }
 
 template<typename K, typename J>
-auto operator+(const Vector2<K> &left, const Vector2<J> &right)
+constexpr auto operator+(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return left.Add(right);
 }
 
 template<typename K, typename J>
-auto operator-(const Vector2<K> &left, const Vector2<J> &right)
+constexpr auto operator-(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return left.Subtract(right);
 }
 
 template<typename K, typename J>
-auto operator*(const Vector2<K> &left, const Vector2<J> &right)
+constexpr auto operator*(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return left.Multiply(right);
 }
 
 template<typename K, typename J>
-auto operator/(const Vector2<K> &left, const Vector2<J> &right)
+constexpr auto operator/(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return left.Divide(right);
 }
 
 template<typename K, typename J>
-auto operator+(const K &left, const Vector2<J> &right)
+constexpr auto operator+(K left, const Vector2<J> &right)
 {
 	return Vector2<K>(left).Add(right);
 }
 
 template<typename K, typename J>
-auto operator-(const K &left, const Vector2<J> &right)
+constexpr auto operator-(K left, const Vector2<J> &right)
 {
 	return Vector2<K>(left).Subtract(right);
 }
 
 template<typename K, typename J>
-auto operator*(const K &left, const Vector2<J> &right)
+constexpr auto operator*(K left, const Vector2<J> &right)
 {
 	return Vector2<K>(left).Multiply(right);
 }
 
 template<typename K, typename J>
-auto operator/(const K &left, const Vector2<J> &right)
+constexpr auto operator/(K left, const Vector2<J> &right)
 {
 	return Vector2<K>(left).Divide(right);
 }
 
 template<typename K, typename J>
-auto operator+(const Vector2<K> &left, const J &right)
+constexpr auto operator+(const Vector2<K> &left, J right)
 {
 	return left.Add(Vector2<J>(right));
 }
 
 template<typename K, typename J>
-auto operator-(const Vector2<K> &left, const J &right)
+constexpr auto operator-(const Vector2<K> &left, J right)
 {
 	return left.Subtract(Vector2<J>(right));
 }
 
 template<typename K, typename J>
-auto operator*(const Vector2<K> &left, const J &right)
+constexpr auto operator*(const Vector2<K> &left, J right)
 {
 	return left.Multiply(Vector2<J>(right));
 }
 
 template<typename K, typename J>
-auto operator/(const Vector2<K> &left, const J &right)
+constexpr auto operator/(const Vector2<K> &left, J right)
 {
 	return left.Divide(Vector2<J>(right));
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator&(const Vector2<K> &left, const Vector2<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator&(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return Vector2<J>(left.m_x & right.m_x, left.m_y & right.m_y);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator|(const Vector2<K> &left, const Vector2<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator|(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return Vector2<J>(left.m_x | right.m_x, left.m_y | right.m_y);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator>>(const Vector2<K> &left, const Vector2<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator>>(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return Vector2<J>(left.m_x >> right.m_x, left.m_y >> right.m_y);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator<<(const Vector2<K> &left, const Vector2<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator<<(const Vector2<K> &left, const Vector2<J> &right)
 {
 	return Vector2<J>(left.m_x << right.m_x, left.m_y << right.m_y);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator&(const Vector2<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator&(const Vector2<K> &left, J right)
 {
 	return Vector2<J>(left.m_x & right, left.m_y & right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator|(const Vector2<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator|(const Vector2<K> &left, J right)
 {
 	return Vector2<J>(left.m_x | right, left.m_y | right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator>>(const Vector2<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator>>(const Vector2<K> &left, J right)
 {
 	return Vector2<J>(left.m_x >> right, left.m_y >> right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator<<(const Vector2<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector2<J>> operator<<(const Vector2<K> &left, J right)
 {
 	return Vector2<J>(left.m_x << right, left.m_y << right);
 }
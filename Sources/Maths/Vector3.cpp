@@ -2,6 +2,8 @@
 
 namespace acid
 {
+static_assert(std::is_trivially_copyable_v<Vector3f>, "Vector3 is passed and stored as a plain value");
+
 template<> const Vector3f Vector3f::Zero = Vector3f(0.0f, 0.0f, 0.0f);
 template<> const Vector3f Vector3f::One = Vector3f(1.0f, 1.0f, 1.0f);
 template<> const Vector3f Vector3f::Left = Vector3f(-1.0f, 0.0f, 0.0f);
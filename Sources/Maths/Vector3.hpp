@@ -21,13 +21,13 @@ public:
 	/**
 	 * Constructor for Vector3.
 	 **/
-	explicit Vector3(); 
+	explicit constexpr Vector3(); 
 	
 	/**
 	 * Constructor for Vector3.
 	 * @param a The value to set all components to.
 	 **/
-	explicit Vector3(const T &a); 
+	explicit constexpr Vector3(T a); 
 	
 	/**
 	 * Constructor for Vector3.
@@ -35,7 +35,7 @@ public:
 	 * @param y Start y.
 	 * @param z Start z.
 	 **/
-	Vector3(const T &x, const T &y, const T &z); 
+	constexpr Vector3(T x, T y, T z); 
 	
 	/**
 	 * Constructor for Vector3.
@@ -44,7 +44,7 @@ public:
 	 * @param z Start z.
 	 **/
 	template<typename K>
-	explicit Vector3(const Vector2<K> &source, const float &z = 0); 
+	explicit constexpr Vector3(const Vector2<K> &source, float z = 0); 
 	
 	/**
 	 * Constructor for Vector3.
@@ -52,7 +52,7 @@ public:
 	 * @param source Creates this vector out of a existing vector.
 	 **/
 	template<typename K>
-	Vector3(const Vector3<K> &source); 
+	constexpr Vector3(const Vector3<K> &source); 
 	
 	/**
 	 * Constructor for Vector3.
@@ -60,7 +60,7 @@ public:
 	 * @param source Creates this vector out of a existing vector.
 	 **/
 	template<typename K>
-	explicit Vector3(const Vector4<K> &source); 
+	explicit constexpr Vector3(const Vector4<K> &source); 
 	
 	/**
 	 * Adds this vector to another vector.
@@ -69,7 +69,7 @@ public:
 	 * @return The resultant vector.
 	 **/
 	template<typename K>
-	auto Add(const Vector3<K> &other) const; 
+	constexpr auto Add(const Vector3<K> &other) const; 
 	
 	/**
 	 * Subtracts this vector to another vector.
@@ -78,7 +78,7 @@ public:
 	 * @return The resultant vector.
 	 **/
 	template<typename K>
-	auto Subtract(const Vector3<K> &other) const; 
+	constexpr auto Subtract(const Vector3<K> &other) const; 
 	
 	/**
 	 * Multiplies this vector with another vector.
@@ -87,7 +87,7 @@ public:
 	 * @return The resultant vector.
 	 **/
 	template<typename K>
-	auto Multiply(const Vector3<K> &other) const; 
+	constexpr auto Multiply(const Vector3<K> &other) const; 
 	
 	/**
 	 * Divides this vector by another vector.
@@ -96,7 +96,7 @@ public:
 	 * @return The resultant vector.
 	 **/
 	template<typename K>
-	auto Divide(const Vector3<K> &other) const; 
+	constexpr auto Divide(const Vector3<K> &other) const; 
 	
 	/**
 	 * Calculates the angle between this vector and another vector.
@@ -114,7 +114,7 @@ public:
 	 * @return The dot product.
 	 **/
 	template<typename K>
-	auto Dot(const Vector3<K> &other) const; 
+	constexpr auto Dot(const Vector3<K> &other) const; 
 	
 	/**
 	 * Calculates the cross product of the this vector and another vector.
@@ -123,7 +123,7 @@ public:
 	 * @return The cross product.
 	 **/
 	template<typename K>
-	auto Cross(const Vector3<K> &other) const; 
+	constexpr auto Cross(const Vector3<K> &other) const; 
 	
 	/**
 	 * Calculates the linear interpolation between this vector and another vector.
@@ -134,7 +134,7 @@ public:
 	 * @return Left lerp right.
 	 **/
 	template<typename K, typename J = float>
-	auto Lerp(const Vector3<K> &other, const J &progression) const; 
+	constexpr auto Lerp(const Vector3<K> &other, J progression) const; 
 	
 	/**
 	 * Scales this vector by a scalar.
@@ -143,7 +143,7 @@ public:
 	 * @return The scaled vector.
 	 **/
 	template<typename K = float>
-	auto Scale(const K &scalar) const; 
+	constexpr auto Scale(K scalar) const; 
 	
 	/**
 	 * Rotates this vector by a angle around the origin.
@@ -164,7 +164,7 @@ public:
 	 * Gets the length squared of this vector.
 	 * @return The length squared.
 	 **/
-	auto LengthSquared() const; 
+	constexpr auto LengthSquared() const; 
 	
 	/**
 	 * Gets the length of this vector.
@@ -215,7 +215,7 @@ public:
 	 * @return The squared distance.
 	 **/
 	template<typename K>
-	auto DistanceSquared(const Vector3<K> &other) const; 
+	constexpr auto DistanceSquared(const Vector3<K> &other) const; 
 	
 	/**
 	 * Gets the between this vector and another vector.
@@ -233,7 +233,7 @@ public:
 	 * @return The vector distance.
 	 **/
 	template<typename K>
-	auto DistanceVector(const Vector3<K> &other) const; 
+	constexpr auto DistanceVector(const Vector3<K> &other) const; 
 	
 	/**
 	 * Gradually changes this vector to a target.
@@ -256,55 +256,55 @@ public:
 	 **/
 	auto PolarToCartesian() const;
 
-	const T &GetX() const { return m_x; }
+	constexpr T GetX() const { return m_x; }
 
-	void SetX(const T &x) { m_x = x; }
+	void SetX(T x) { m_x = x; }
 
-	const T &GetY() const { return m_y; }
+	constexpr T GetY() const { return m_y; }
 
-	void SetY(const T &y) { m_y = y; }
+	void SetY(T y) { m_y = y; }
 
-	const T &GetZ() const { return m_z; }
+	constexpr T GetZ() const { return m_z; }
 
-	void SetZ(const T &z) { m_z = z; }
+	void SetZ(T z) { m_z = z; }
 
 	std::string ToString() const;
 
 	template<typename K>
-	bool operator==(const Vector3<K> &other) const;
+	constexpr bool operator==(const Vector3<K> &other) const;
 
 	template<typename K>
-	bool operator!=(const Vector3<K> &other) const;
+	constexpr bool operator!=(const Vector3<K> &other) const;
 
 	template<typename U = T>
-	std::enable_if_t<std::is_signed_v<U>, Vector3> operator-() const;
+	constexpr std::enable_if_t<std::is_signed_v<U>, Vector3> operator-() const;
 
 	template<typename U = T>
-	std::enable_if_t<std::is_integral_v<U>, Vector3> operator~() const;
+	constexpr std::enable_if_t<std::is_integral_v<U>, Vector3> operator~() const;
 
-	const T &operator[](const uint32_t &index) const;
+	constexpr const T &operator[](uint32_t index) const;
 
-	T &operator[](const uint32_t &index);
+	constexpr T &operator[](uint32_t index);
 
 	template<typename K>
-	Vector3 &operator+=(const Vector3<K> &other);
+	constexpr Vector3 &operator+=(const Vector3<K> &other);
 
 	template<typename K>
-	Vector3 &operator-=(const Vector3<K> &other);
+	constexpr Vector3 &operator-=(const Vector3<K> &other);
 
 	template<typename K>
-	Vector3 &operator*=(const Vector3<K> &other);
+	constexpr Vector3 &operator*=(const Vector3<K> &other);
 
 	template<typename K>
-	Vector3 &operator/=(const Vector3<K> &other);
+	constexpr Vector3 &operator/=(const Vector3<K> &other);
 
-	Vector3 &operator+=(const T &other);
+	constexpr Vector3 &operator+=(T other);
 
-	Vector3 &operator-=(const T &other);
+	constexpr Vector3 &operator-=(T other);
 
-	Vector3 &operator*=(const T &other);
+	constexpr Vector3 &operator*=(T other);
 
-	Vector3 &operator/=(const T &other);
+	constexpr Vector3 &operator/=(T other);
 
 	ACID_EXPORT static const Vector3 Zero;
 	ACID_EXPORT static const Vector3 One;
@@ -7,7 +7,7 @@
 namespace acid
 {
 template<typename T>
-Vector3<T>::Vector3():
+constexpr Vector3<T>::Vector3():
 	m_x(0),
 	m_y(0),
 	m_z(0)
@@ -15,7 +15,7 @@ Vector3<T>::Vector3():
 }
 
 template<typename T>
-Vector3<T>::Vector3(const T &a):
+constexpr Vector3<T>::Vector3(T a):
 	m_x(a),
 	m_y(a),
 	m_z(a)
@@ -23,7 +23,7 @@ Vector3<T>::Vector3(const T &a):
 }
 
 template<typename T>
-Vector3<T>::Vector3(const T &x, const T &y, const T &z):
+constexpr Vector3<T>::Vector3(T x, T y, T z):
 	m_x(x),
 	m_y(y),
 	m_z(z)
@@ -32,7 +32,7 @@ Vector3<T>::Vector3(const T &x, const T &y, const T &z):
 
 template<typename T>
 template<typename K>
-Vector3<T>::Vector3(const Vector2<K> &source, const float &z):
+constexpr Vector3<T>::Vector3(const Vector2<K> &source, float z):
 	m_x(static_cast<T>(source.m_x)),
 	m_y(static_cast<T>(source.m_y)),
 	m_z(z)
@@ -41,7 +41,7 @@ Vector3<T>::Vector3(const Vector2<K> &source, const float &z):
 
 template<typename T>
 template<typename K>
-Vector3<T>::Vector3(const Vector3<K> &source):
+constexpr Vector3<T>::Vector3(const Vector3<K> &source):
 	m_x(static_cast<T>(source.m_x)),
 	m_y(static_cast<T>(source.m_y)),
 	m_z(static_cast<T>(source.m_z))
@@ -50,7 +50,7 @@ Vector3<T>::Vector3(const Vector3<K> &source):
 
 template<typename T>
 template<typename K>
-Vector3<T>::Vector3(const Vector4<K> &source):
+constexpr Vector3<T>::Vector3(const Vector4<K> &source):
 	m_x(static_cast<T>(source.m_x)),
 	m_y(static_cast<T>(source.m_y)),
 	m_z(static_cast<T>(source.m_z))
@@ -59,28 +59,28 @@ Vector3<T>::Vector3(const Vector4<K> &source):
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::Add(const Vector3<K> &other) const
+constexpr auto Vector3<T>::Add(const Vector3<K> &other) const
 {
 	return Vector3<decltype(m_x + other.m_x)>(m_x + other.m_x, m_y + other.m_y, m_z + other.m_z);
 }
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::Subtract(const Vector3<K> &other) const
+constexpr auto Vector3<T>::Subtract(const Vector3<K> &other) const
 {
 	return Vector3<decltype(m_x - other.m_x)>(m_x - other.m_x, m_y - other.m_y, m_z - other.m_z);
 }
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::Multiply(const Vector3<K> &other) const
+constexpr auto Vector3<T>::Multiply(const Vector3<K> &other) const
 {
 	return Vector3<decltype(m_x * other.m_x)>(m_x * other.m_x, m_y * other.m_y, m_z * other.m_z);
 }
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::Divide(const Vector3<K> &other) const
+constexpr auto Vector3<T>::Divide(const Vector3<K> &other) const
 {
 	return Vector3<decltype(m_x / other.m_x)>(m_x / other.m_x, m_y / other.m_y, m_z / other.m_z);
 }
@@ -105,21 +105,21 @@ auto Vector3<T>::Angle(const Vector3<K> &other) const
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::Dot(const Vector3<K> &other) const
+constexpr auto Vector3<T>::Dot(const Vector3<K> &other) const
 {
 	return m_x * other.m_x + m_y * other.m_y + m_z * other.m_z;
 }
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::Cross(const Vector3<K> &other) const
+constexpr auto Vector3<T>::Cross(const Vector3<K> &other) const
 {
 	return Vector3<decltype(m_x * other.m_x)>(m_y * other.m_z - m_z * other.m_y, other.m_x * m_z - other.m_z * m_x, m_x * other.m_y - m_y * other.m_x);
 }
 
 template<typename T>
 template<typename K, typename J>
-auto Vector3<T>::Lerp(const Vector3<K> &other, const J &progression) const
+constexpr auto Vector3<T>::Lerp(const Vector3<K> &other, J progression) const
 {
 	auto ta = *this * (1 - progression);
 	auto tb = other * progression;
@@ -136,7 +136,7 @@ auto Vector3<T>::Rotate(const Vector3<K> &angle) const
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::Scale(const K &scalar) const
+constexpr auto Vector3<T>::Scale(K scalar) const
 {
 	return Vector3<decltype(m_x * scalar)>(m_x * scalar, m_y * scalar, m_z * scalar);
 }
@@ -153,7 +153,7 @@ auto Vector3<T>::Normalize() const
 }
 
 template<typename T>
-auto Vector3<T>::LengthSquared() const
+constexpr auto Vector3<T>::LengthSquared() const
 {
 	return m_x * m_x + m_y * m_y + m_z * m_z;
 }
@@ -198,7 +198,7 @@ auto Vector3<T>::Max(const Vector3<K> &other)
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::DistanceSquared(const Vector3<K> &other) const
+constexpr auto Vector3<T>::DistanceSquared(const Vector3<K> &other) const
 {
 	auto dx = m_x - other.m_x;
 	auto dy = m_y - other.m_y;
@@ -215,7 +215,7 @@ auto Vector3<T>::Distance(const Vector3<K> &other) const
 
 template<typename T>
 template<typename K>
-auto Vector3<T>::DistanceVector(const Vector3<K> &other) const
+constexpr auto Vector3<T>::DistanceVector(const Vector3<K> &other) const
 {
 	return (*this - other) * (*this - other);
 }
@@ -256,34 +256,34 @@ std::string Vector3<T>::ToString() const
 
 template<typename T>
 template<typename K>
-bool Vector3<T>::operator==(const Vector3<K> &other) const
+constexpr bool Vector3<T>::operator==(const Vector3<K> &other) const
 {
 	return m_x == other.m_x && m_y == other.m_y && m_z == other.m_z;
 }
 
 template<typename T>
 template<typename K>
-bool Vector3<T>::operator!=(const Vector3<K> &other) const
+constexpr bool Vector3<T>::operator!=(const Vector3<K> &other) const
 {
 	return !(*this == other);
 }
 
 template<typename T>
 template<typename U>
-std::enable_if_t<std::is_signed_v<U>, Vector3<T>> Vector3<T>::operator-() const
+constexpr std::enable_if_t<std::is_signed_v<U>, Vector3<T>> Vector3<T>::operator-() const
 {
 	return Vector3(-m_x, -m_y, -m_z);;
 }
 
 template<typename T>
 template<typename U>
-std::enable_if_t<std::is_integral_v<U>, Vector3<T>> Vector3<T>::operator~() const
+constexpr std::enable_if_t<std::is_integral_v<U>, Vector3<T>> Vector3<T>::operator~() const
 {
 	return Vector3(~m_x, ~m_y, ~m_z);
 }
 
 template<typename T>
-const T &Vector3<T>::operator[](const uint32_t &index) const
+constexpr const T &Vector3<T>::operator[](uint32_t index) const
 {
 	switch (index)
 	{
@@ -299,7 +299,7 @@ const T &Vector3<T>::operator[](const uint32_t &index) const
 }
 
 template<typename T>
-T &Vector3<T>::operator[](const uint32_t &index)
+constexpr T &Vector3<T>::operator[](uint32_t index)
 {
 	switch (index)
 	{
@@ -316,52 +316,52 @@ T &Vector3<T>::operator[](const uint32_t &index)
 
 template<typename T>
 template<typename K>
-Vector3<T> &Vector3<T>::operator+=(const Vector3<K> &other)
+constexpr Vector3<T> &Vector3<T>::operator+=(const Vector3<K> &other)
 {
 	return *this = Add(other);
 }
 
 template<typename T>
 template<typename K>
-Vector3<T> &Vector3<T>::operator-=(const Vector3<K> &other)
+constexpr Vector3<T> &Vector3<T>::operator-=(const Vector3<K> &other)
 {
 	return *this = Subtract(other);
 }
 
 template<typename T>
 template<typename K>
-Vector3<T> &Vector3<T>::operator*=(const Vector3<K> &other)
+constexpr Vector3<T> &Vector3<T>::operator*=(const Vector3<K> &other)
 {
 	return *this = Multiply(other);
 }
 
 template<typename T>
 template<typename K>
-Vector3<T> &Vector3<T>::operator/=(const Vector3<K> &other)
+constexpr Vector3<T> &Vector3<T>::operator/=(const Vector3<K> &other)
 {
 	return *this = Divide(other);
 }
 
 template<typename T>
-Vector3<T> &Vector3<T>::operator+=(const T &other)
+constexpr Vector3<T> &Vector3<T>::operator+=(T other)
 {
 	return *this = Add(Vector3<T>(other));
 }
 
 template<typename T>
-Vector3<T> &Vector3<T>::operator-=(const T &other)
+constexpr Vector3<T> &Vector3<T>::operator-=(T other)
 {
 	return *this = Subtract(Vector3<T>(other));
 }
 
 template<typename T>
-Vector3<T> &Vector3<T>::operator*=(const T &other)
+constexpr Vector3<T> &Vector3<T>::operator*=(T other)
 {
 	return *this = Multiply(Vector3<T>(other));
 }
 
 template<typename T>
-Vector3<T> &Vector3<T>::operator/=(const T &other)
+constexpr Vector3<T> &Vector3<T>::operator/=(T other)
 {
 	return *this = Divide(Vector3<T>(other));
 }
@@ -392,121 +392,121 @@ std::ostream &operator<<(std::ostream &stream, const Vector3<K> &vector)
 }
 
 template<typename K, typename J>
-auto operator+(const Vector3<K> &left, const Vector3<J> &right)
+constexpr auto operator+(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return left.Add(right);
 }
 
 template<typename K, typename J>
-auto operator-(const Vector3<K> &left, const Vector3<J> &right)
+constexpr auto operator-(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return left.Subtract(right);
 }
 
 template<typename K, typename J>
-auto operator*(const Vector3<K> &left, const Vector3<J> &right)
+constexpr auto operator*(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return left.Multiply(right);
 }
 
 template<typename K, typename J>
-auto operator/(const Vector3<K> &left, const Vector3<J> &right)
+constexpr auto operator/(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return left.Divide(right);
 }
 
 template<typename K, typename J>
-auto operator+(const K &left, const Vector3<J> &right)
+constexpr auto operator+(K left, const Vector3<J> &right)
 {
 	return Vector3<K>(left).Add(right);
 }
 
 template<typename K, typename J>
-auto operator-(const K &left, const Vector3<J> &right)
+constexpr auto operator-(K left, const Vector3<J> &right)
 {
 	return Vector3<K>(left).Subtract(right);
 }
 
 template<typename K, typename J>
-auto operator*(const K &left, const Vector3<J> &right)
+constexpr auto operator*(K left, const Vector3<J> &right)
 {
 	return Vector3<K>(left).Multiply(right);
 }
 
 template<typename K, typename J>
-auto operator/(const K &left, const Vector3<J> &right)
+constexpr auto operator/(K left, const Vector3<J> &right)
 {
 	return Vector3<K>(left).Divide(right);
 }
 
 template<typename K, typename J>
-auto operator+(const Vector3<K> &left, const J &right)
+constexpr auto operator+(const Vector3<K> &left, J right)
 {
 	return left.Add(Vector3<J>(right));
 }
 
 template<typename K, typename J>
-auto operator-(const Vector3<K> &left, const J &right)
+constexpr auto operator-(const Vector3<K> &left, J right)
 {
 	return left.Subtract(Vector3<J>(right));
 }
 
 template<typename K, typename J>
-auto operator*(const Vector3<K> &left, const J &right)
+constexpr auto operator*(const Vector3<K> &left, J right)
 {
 	return left.Multiply(Vector3<J>(right));
 }
 
 template<typename K, typename J>
-auto operator/(const Vector3<K> &left, const J &right)
+constexpr auto operator/(const Vector3<K> &left, J right)
 {
 	return left.Divide(Vector3<J>(right));
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator&(const Vector3<K> &left, const Vector3<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator&(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return Vector3<J>(left.m_x & right.m_x, left.m_y & right.m_y, left.m_z & right.m_z);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator|(const Vector3<K> &left, const Vector3<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator|(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return Vector3<J>(left.m_x | right.m_x, left.m_y | right.m_y, left.m_z | right.m_z);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator>>(const Vector3<K> &left, const Vector3<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator>>(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return Vector3<J>(left.m_x >> right.m_x, left.m_y >> right.m_y, left.m_z >> right.m_z);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator<<(const Vector3<K> &left, const Vector3<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator<<(const Vector3<K> &left, const Vector3<J> &right)
 {
 	return Vector3<J>(left.m_x << right.m_x, left.m_y << right.m_y, left.m_z << right.m_z);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator&(const Vector3<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator&(const Vector3<K> &left, J right)
 {
 	return Vector3<J>(left.m_x & right, left.m_y & right, left.m_z & right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator|(const Vector3<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator|(const Vector3<K> &left, J right)
 {
 	return Vector3<J>(left.m_x | right, left.m_y | right, left.m_z | right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator>>(const Vector3<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator>>(const Vector3<K> &left, J right)
 {
 	return Vector3<J>(left.m_x >> right, left.m_y >> right, left.m_z >> right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator<<(const Vector3<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector3<J>> operator<<(const Vector3<K> &left, J right)
 {
 	return Vector3<J>(left.m_x << right, left.m_y << right, left.m_z << right);
 }
@@ -2,6 +2,8 @@
 
 namespace acid
 {
+static_assert(std::is_trivially_copyable_v<Vector4f>, "Vector4 is passed and stored as a plain value");
+
 template<> const Vector4f Vector4f::Zero = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);
 template<> const Vector4f Vector4f::One = Vector4f(1.0f, 1.0f, 1.0f, 1.0f);
 template<> const Vector4f Vector4f::PositiveInfinity = Vector4f(+std::numeric_limits<float>::infinity(), +std::numeric_limits<float>::infinity(),
@@ -7,7 +7,7 @@
 namespace acid
 {
 template<typename T>
-Vector4<T>::Vector4():
+constexpr Vector4<T>::Vector4():
 	m_x(0),
 	m_y(0),
 	m_z(0),
@@ -16,7 +16,7 @@ Vector4<T>::Vector4():
 }
 
 template<typename T>
-Vector4<T>::Vector4(const T &a):
+constexpr Vector4<T>::Vector4(T a):
 	m_x(a),
 	m_y(a),
 	m_z(a),
@@ -25,7 +25,7 @@ Vector4<T>::Vector4(const T &a):
 }
 
 template<typename T>
-Vector4<T>::Vector4(const T &x, const T &y, const T &z, const T &w):
+constexpr Vector4<T>::Vector4(T x, T y, T z, T w):
 	m_x(x),
 	m_y(y),
 	m_z(z),
@@ -35,7 +35,7 @@ Vector4<T>::Vector4(const T &x, const T &y, const T &z, const T &w):
 
 template<typename T>
 template<typename K>
-Vector4<T>::Vector4(const Vector2<K> &left, const Vector2<K> &right):
+constexpr Vector4<T>::Vector4(const Vector2<K> &left, const Vector2<K> &right):
 	m_x(static_cast<T>(left.m_x)),
 	m_y(static_cast<T>(left.m_y)),
 	m_z(static_cast<T>(right.m_x)),
@@ -45,7 +45,7 @@ Vector4<T>::Vector4(const Vector2<K> &left, const Vector2<K> &right):
 
 template<typename T>
 template<typename K>
-Vector4<T>::Vector4(const Vector3<K> &source, const T &w):
+constexpr Vector4<T>::Vector4(const Vector3<K> &source, T w):
 	m_x(static_cast<T>(source.m_x)),
 	m_y(static_cast<T>(source.m_y)),
 	m_z(static_cast<T>(source.m_z)),
@@ -55,7 +55,7 @@ Vector4<T>::Vector4(const Vector3<K> &source, const T &w):
 
 template<typename T>
 template<typename K>
-Vector4<T>::Vector4(const Vector4<K> &source):
+constexpr Vector4<T>::Vector4(const Vector4<K> &source):
 	m_x(static_cast<T>(source.m_x)),
 	m_y(static_cast<T>(source.m_y)),
 	m_z(static_cast<T>(source.m_z)),
@@ -65,28 +65,28 @@ Vector4<T>::Vector4(const Vector4<K> &source):
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::Add(const Vector4<K> &other) const
+constexpr auto Vector4<T>::Add(const Vector4<K> &other) const
 {
 	return Vector4<decltype(m_x + other.m_x)>(m_x + other.m_x, m_y + other.m_y, m_z + other.m_z, m_w + other.m_w);
 }
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::Subtract(const Vector4<K> &other) const
+constexpr auto Vector4<T>::Subtract(const Vector4<K> &other) const
 {
 	return Vector4<decltype(m_x - other.m_x)>(m_x - other.m_x, m_y - other.m_y, m_z - other.m_z, m_w - other.m_w);
 }
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::Multiply(const Vector4<K> &other) const
+constexpr auto Vector4<T>::Multiply(const Vector4<K> &other) const
 {
 	return Vector4<decltype(m_x * other.m_x)>(m_x * other.m_x, m_y * other.m_y, m_z * other.m_z, m_w * other.m_w);
 }
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::Divide(const Vector4<K> &other) const
+constexpr auto Vector4<T>::Divide(const Vector4<K> &other) const
 {
 	return Vector4<decltype(m_x / other.m_x)>(m_x / other.m_x, m_y / other.m_y, m_z / other.m_z, m_w / other.m_w);
 }
@@ -111,14 +111,14 @@ auto Vector4<T>::Angle(const Vector4<K> &other) const
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::Dot(const Vector4<K> &other) const
+constexpr auto Vector4<T>::Dot(const Vector4<K> &other) const
 {
 	return m_x * other.m_x + m_y * other.m_y + m_z * other.m_z + m_w * other.m_w;
 }
 
 template<typename T>
 template<typename K, typename J>
-auto Vector4<T>::Lerp(const Vector4<K> &other, const J &progression) const
+constexpr auto Vector4<T>::Lerp(const Vector4<K> &other, J progression) const
 {
 	auto ta = *this * (1 - progression);
 	auto tb = other * progression;
@@ -127,7 +127,7 @@ auto Vector4<T>::Lerp(const Vector4<K> &other, const J &progression) const
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::Scale(const K &scalar) const
+constexpr auto Vector4<T>::Scale(K scalar) const
 {
 	return Vector4<decltype(m_x * scalar)>(m_x * scalar, m_y * scalar, m_z * scalar, m_w * scalar);
 }
@@ -144,7 +144,7 @@ auto Vector4<T>::Normalize() const
 }
 
 template<typename T>
-auto Vector4<T>::LengthSquared() const
+constexpr auto Vector4<T>::LengthSquared() const
 {
 	return m_x * m_x + m_y * m_y + m_z * m_z + m_w * m_w;
 }
@@ -189,7 +189,7 @@ auto Vector4<T>::Max(const Vector4<K> &other)
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::DistanceSquared(const Vector4<K> &other) const
+constexpr auto Vector4<T>::DistanceSquared(const Vector4<K> &other) const
 {
 	auto dx = m_x - other.m_x;
 	auto dy = m_y - other.m_y;
@@ -207,7 +207,7 @@ auto Vector4<T>::Distance(const Vector4<K> &other) const
 
 template<typename T>
 template<typename K>
-auto Vector4<T>::DistanceVector(const Vector4<K> &other) const
+constexpr auto Vector4<T>::DistanceVector(const Vector4<K> &other) const
 {
 	return (*this - other) * (*this - other);
 }
@@ -230,34 +230,34 @@ std::string Vector4<T>::ToString() const
 
 template<typename T>
 template<typename K>
-bool Vector4<T>::operator==(const Vector4<K> &other) const
+constexpr bool Vector4<T>::operator==(const Vector4<K> &other) const
 {
 	return m_x == other.m_x && m_y == other.m_y && m_z == other.m_z && m_w == other.m_w;
 }
 
 template<typename T>
 template<typename K>
-bool Vector4<T>::operator!=(const Vector4<K> &other) const
+constexpr bool Vector4<T>::operator!=(const Vector4<K> &other) const
 {
 	return !(*this == other);
 }
 
 template<typename T>
 template<typename U>
-std::enable_if_t<std::is_signed_v<U>, Vector4<T>> Vector4<T>::operator-() const
+constexpr std::enable_if_t<std::is_signed_v<U>, Vector4<T>> Vector4<T>::operator-() const
 {
 	return Vector4(-m_x, -m_y, -m_z, -m_w);
 }
 
 template<typename T>
 template<typename U>
-std::enable_if_t<std::is_integral_v<U>, Vector4<T>> Vector4<T>::operator~() const
+constexpr std::enable_if_t<std::is_integral_v<U>, Vector4<T>> Vector4<T>::operator~() const
 {
 	return Vector4(~m_x, ~m_y, ~m_z, ~m_w);
 }
 
 template<typename T>
-const T &Vector4<T>::operator[](const uint32_t &index) const
+constexpr const T &Vector4<T>::operator[](uint32_t index) const
 {
 	switch (index)
 	{
@@ -275,7 +275,7 @@ const T &Vector4<T>::operator[](const uint32_t &index) const
 }
 
 template<typename T>
-T &Vector4<T>::operator[](const uint32_t &index)
+constexpr T &Vector4<T>::operator[](uint32_t index)
 {
 	switch (index)
 	{
@@ -294,52 +294,52 @@ T &Vector4<T>::operator[](const uint32_t &index)
 
 template<typename T>
 template<typename K>
-Vector4<T> &Vector4<T>::operator+=(const Vector4<K> &other)
+constexpr Vector4<T> &Vector4<T>::operator+=(const Vector4<K> &other)
 {
 	return *this = Add(other);
 }
 
 template<typename T>
 template<typename K>
-Vector4<T> &Vector4<T>::operator-=(const Vector4<K> &other)
+constexpr Vector4<T> &Vector4<T>::operator-=(const Vector4<K> &other)
 {
 	return *this = Subtract(other);
 }
 
 template<typename T>
 template<typename K>
-Vector4<T> &Vector4<T>::operator*=(const Vector4<K> &other)
+constexpr Vector4<T> &Vector4<T>::operator*=(const Vector4<K> &other)
 {
 	return *this = Multiply(other);
 }
 
 template<typename T>
 template<typename K>
-Vector4<T> &Vector4<T>::operator/=(const Vector4<K> &other)
+constexpr Vector4<T> &Vector4<T>::operator/=(const Vector4<K> &other)
 {
 	return *this = Divide(other);
 }
 
 template<typename T>
-Vector4<T> &Vector4<T>::operator+=(const T &other)
+constexpr Vector4<T> &Vector4<T>::operator+=(T other)
 {
 	return *this = Add(Vector4<T>(other));
 }
 
 template<typename T>
-Vector4<T> &Vector4<T>::operator-=(const T &other)
+constexpr Vector4<T> &Vector4<T>::operator-=(T other)
 {
 	return *this = Subtract(Vector4<T>(other));
 }
 
 template<typename T>
-Vector4<T> &Vector4<T>::operator*=(const T &other)
+constexpr Vector4<T> &Vector4<T>::operator*=(T other)
 {
 	return *this = Multiply(Vector4<T>(other));
 }
 
 template<typename T>
-Vector4<T> &Vector4<T>::operator/=(const T &other)
+constexpr Vector4<T> &Vector4<T>::operator/=(T other)
 {
 	return *this = Divide(Vector4<T>(other));
 }
@@ -372,121 +372,121 @@ std::ostream &operator<<(std::ostream &stream, const Vector4<K> &vector)
 }
 
 template<typename K, typename J>
-auto operator+(const Vector4<K> &left, const Vector4<J> &right)
+constexpr auto operator+(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return left.Add(right);
 }
 
 template<typename K, typename J>
-auto operator-(const Vector4<K> &left, const Vector4<J> &right)
+constexpr auto operator-(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return left.Subtract(right);
 }
 
 template<typename K, typename J>
-auto operator*(const Vector4<K> &left, const Vector4<J> &right)
+constexpr auto operator*(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return left.Multiply(right);
 }
 
 template<typename K, typename J>
-auto operator/(const Vector4<K> &left, const Vector4<J> &right)
+constexpr auto operator/(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return left.Divide(right);
 }
 
 template<typename K, typename J>
-auto operator+(const K &left, const Vector4<J> &right)
+constexpr auto operator+(K left, const Vector4<J> &right)
 {
 	return Vector4<K>(left).Add(right);
 }
 
 template<typename K, typename J>
-auto operator-(const K &left, const Vector4<J> &right)
+constexpr auto operator-(K left, const Vector4<J> &right)
 {
 	return Vector4<K>(left).Subtract(right);
 }
 
 template<typename K, typename J>
-auto operator*(const K &left, const Vector4<J> &right)
+constexpr auto operator*(K left, const Vector4<J> &right)
 {
 	return Vector4<K>(left).Multiply(right);
 }
 
 template<typename K, typename J>
-auto operator/(const K &left, const Vector4<J> &right)
+constexpr auto operator/(K left, const Vector4<J> &right)
 {
 	return Vector4<K>(left).Divide(right);
 }
 
 template<typename K, typename J>
-auto operator+(const Vector4<K> &left, const J &right)
+constexpr auto operator+(const Vector4<K> &left, J right)
 {
 	return left.Add(Vector4<J>(right));
 }
 
 template<typename K, typename J>
-auto operator-(const Vector4<K> &left, const J &right)
+constexpr auto operator-(const Vector4<K> &left, J right)
 {
 	return left.Subtract(Vector4<J>(right));
 }
 
 template<typename K, typename J>
-auto operator*(const Vector4<K> &left, const J &right)
+constexpr auto operator*(const Vector4<K> &left, J right)
 {
 	return left.Multiply(Vector4<J>(right));
 }
 
 template<typename K, typename J>
-auto operator/(const Vector4<K> &left, const J &right)
+constexpr auto operator/(const Vector4<K> &left, J right)
 {
 	return left.Divide(Vector4<J>(right));
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator&(const Vector4<K> &left, const Vector4<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator&(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return Vector4<J>(left.m_x & right.m_x, left.m_y & right.m_y, left.m_z & right.m_z, left.m_w & right.m_w);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator|(const Vector4<K> &left, const Vector4<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator|(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return Vector4<J>(left.m_x | right.m_x, left.m_y | right.m_y, left.m_z | right.m_z, left.m_w | right.m_w);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator>>(const Vector4<K> &left, const Vector4<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator>>(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return Vector4<J>(left.m_x >> right.m_x, left.m_y >> right.m_y, left.m_z >> right.m_z, left.m_w >> right.m_w);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator<<(const Vector4<K> &left, const Vector4<J> &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator<<(const Vector4<K> &left, const Vector4<J> &right)
 {
 	return Vector4<J>(left.m_x << right.m_x, left.m_y << right.m_y, left.m_z << right.m_z, left.m_w << right.m_w);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator&(const Vector4<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator&(const Vector4<K> &left, J right)
 {
 	return Vector4<J>(left.m_x & right, left.m_y & right, left.m_z & right, left.m_w & right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator|(const Vector4<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator|(const Vector4<K> &left, J right)
 {
 	return Vector4<J>(left.m_x | right, left.m_y | right, left.m_z | right, left.m_w | right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator>>(const Vector4<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator>>(const Vector4<K> &left, J right)
 {
 	return Vector4<J>(left.m_x >> right, left.m_y >> right, left.m_z >> right, left.m_w >> right);
 }
 
 template<typename K, typename J>
-std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator<<(const Vector4<K> &left, const J &right)
+constexpr std::enable_if_t<std::is_integral_v<K> && std::is_integral_v<J>, Vector4<J>> operator<<(const Vector4<K> &left, J right)
 {
 	return Vector4<J>(left.m_x << right, left.m_y << right, left.m_z << right, left.m_w << right);
 }
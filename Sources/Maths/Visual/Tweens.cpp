@@ -0,0 +1,231 @@
+#include "Tweens.hpp"
+
+#include "Maths/Simd.hpp"
+
+namespace acid
+{
+Tweens::Tweens()
+{
+	for (uint32_t i = 0; i < MaxLanes; i++)
+	{
+		m_pools[i].m_lanes = i + 1;
+	}
+}
+
+Tweens *Tweens::Get()
+{
+	static Tweens tweens;
+	return &tweens;
+}
+
+bool Tweens::IsFinished(const Tween &tween) const
+{
+	auto slot = GetSlot(tween);
+	return slot == nullptr || !slot->m_row;
+}
+
+void Tweens::Stop(Tween &tween)
+{
+	if (GetSlot(tween) == nullptr)
+	{
+		tween = {};
+		return;
+	}
+
+	auto &slot = m_slots[tween.GetIndex()];
+
+	if (slot.m_row)
+	{
+		RemoveRow(m_pools[slot.m_lanes - 1], *slot.m_row);
+		slot.m_row = std::nullopt;
+	}
+
+	slot.m_lanes = 0;
+
+	// Zero is the null generation, so it is skipped when the generation wraps.
+	if (++slot.m_generation == 0)
+	{
+		slot.m_generation = 1;
+	}
+
+	m_freeSlots.emplace_back(tween.GetIndex());
+	tween = {};
+}
+
+void Tweens::Update(const Time &delta)
+{
+	auto deltas = Simd::Splat(delta.AsSeconds());
+	auto ones = Simd::Splat(1.0f);
+
+	for (auto &pool : m_pools)
+	{
+		auto lanes = pool.m_rows * pool.m_lanes;
+
+		// The arrays are padded to four, so the lanes past the last tween are advanced and ignored.
+		for (uint32_t i = 0; i < lanes; i += 4)
+		{
+			auto elapsed = Simd::Add(Simd::Load(&pool.m_elapsed[i]), deltas);
+			Simd::Store(&pool.m_elapsed[i], elapsed);
+
+			auto factor = Simd::Min(Simd::Multiply(elapsed, Simd::Load(&pool.m_rates[i])), ones);
+			Simd::Store(&pool.m_values[i], Simd::MultiplyAdd(factor, Simd::Load(&pool.m_deltas[i]), Simd::Load(&pool.m_starts[i])));
+		}
+
+		for (uint32_t row = 0; row < pool.m_rows;)
+		{
+			auto first = row * pool.m_lanes;
+
+			if (pool.m_elapsed[first] * pool.m_rates[first] < 1.0f)
+			{
+				row++;
+				continue;
+			}
+
+			if (pool.m_repeats[row])
+			{
+				auto elapsed = std::fmod(pool.m_elapsed[first], 1.0f / pool.m_rates[first]);
+
+				for (auto i = first; i < first + pool.m_lanes; i++)
+				{
+					pool.m_elapsed[i] = elapsed;
+					pool.m_values[i] = pool.m_starts[i] + elapsed * pool.m_rates[i] * pool.m_deltas[i];
+				}
+
+				row++;
+				continue;
+			}
+
+			// The slot keeps the end value, and the last row is moved into this one.
+			auto &slot = m_slots[pool.m_owners[row]];
+			std::copy_n(&pool.m_values[first], pool.m_lanes, slot.m_value);
+			slot.m_row = std::nullopt;
+			RemoveRow(pool, row);
+		}
+	}
+}
+
+std::size_t Tweens::GetActiveCount() const
+{
+	std::size_t count = 0;
+
+	for (const auto &pool : m_pools)
+	{
+		count += pool.m_rows;
+	}
+
+	return count;
+}
+
+void Tweens::Pool::Resize(const uint32_t &rows)
+{
+	auto lanes = (rows * m_lanes + 3) & ~3u;
+
+	for (auto array : { &m_elapsed, &m_rates, &m_starts, &m_deltas, &m_values })
+	{
+		array->resize(lanes);
+	}
+
+	m_owners.resize(rows);
+	m_repeats.resize(rows);
+	m_rows = rows;
+}
+
+Tween Tweens::Start(const uint32_t &lanes, const float *starts, const float *ends, const Time &length, const bool &repeat)
+{
+	uint32_t index;
+
+	if (!m_freeSlots.empty())
+	{
+		index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_slots.size());
+		m_slots.emplace_back();
+	}
+
+	auto &slot = m_slots[index];
+	slot.m_lanes = lanes;
+
+	if (length <= Time::Zero)
+	{
+		std::copy_n(ends, lanes, slot.m_value);
+		return Tween(index, slot.m_generation);
+	}
+
+	auto &pool = m_pools[lanes - 1];
+	auto row = pool.m_rows;
+	pool.Resize(row + 1);
+	pool.m_owners[row] = index;
+	pool.m_repeats[row] = repeat;
+
+	auto rate = 1.0f / length.AsSeconds();
+
+	for (uint32_t i = 0; i < lanes; i++)
+	{
+		auto lane = row * lanes + i;
+		pool.m_elapsed[lane] = 0.0f;
+		pool.m_rates[lane] = rate;
+		pool.m_starts[lane] = starts[i];
+		pool.m_deltas[lane] = ends[i] - starts[i];
+		pool.m_values[lane] = starts[i];
+	}
+
+	slot.m_row = row;
+	return Tween(index, slot.m_generation);
+}
+
+const float *Tweens::GetValues(const Tween &tween, const uint32_t &lanes) const
+{
+	auto slot = GetSlot(tween);
+
+	if (slot == nullptr || slot->m_lanes != lanes)
+	{
+		return nullptr;
+	}
+
+	if (slot->m_row)
+	{
+		return &m_pools[lanes - 1].m_values[*slot->m_row * lanes];
+	}
+
+	return slot->m_value;
+}
+
+const Tweens::Slot *Tweens::GetSlot(const Tween &tween) const
+{
+	if (!tween || tween.GetIndex() >= m_slots.size())
+	{
+		return nullptr;
+	}
+
+	auto &slot = m_slots[tween.GetIndex()];
+
+	if (slot.m_generation != tween.GetGeneration() || slot.m_lanes == 0)
+	{
+		return nullptr;
+	}
+
+	return &slot;
+}
+
+void Tweens::RemoveRow(Pool &pool, const uint32_t &row)
+{
+	auto last = pool.m_rows - 1;
+
+	if (row != last)
+	{
+		for (auto array : { &pool.m_elapsed, &pool.m_rates, &pool.m_starts, &pool.m_deltas, &pool.m_values })
+		{
+			std::copy_n(array->begin() + last * pool.m_lanes, pool.m_lanes, array->begin() + row * pool.m_lanes);
+		}
+
+		pool.m_owners[row] = pool.m_owners[last];
+		pool.m_repeats[row] = pool.m_repeats[last];
+		m_slots[pool.m_owners[row]].m_row = row;
+	}
+
+	pool.Resize(last);
+}
+}
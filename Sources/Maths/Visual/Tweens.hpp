@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Time.hpp"
+
+namespace acid
+{
+/**
+ * @brief A handle to a tween started by {@link Tweens#Start}, the slot the tween is stored in and the generation of that slot.
+ **/
+class ACID_EXPORT Tween
+{
+public:
+	/**
+	 * Creates a null handle, it never finds a tween.
+	 **/
+	Tween() = default;
+
+	Tween(const uint32_t &index, const uint32_t &generation) :
+		m_index(index),
+		m_generation(generation)
+	{
+	}
+
+	const uint32_t &GetIndex() const { return m_index; }
+
+	const uint32_t &GetGeneration() const { return m_generation; }
+
+	bool IsValid() const { return m_generation != 0; }
+
+	explicit operator bool() const { return IsValid(); }
+
+	bool operator==(const Tween &other) const { return m_index == other.m_index && m_generation == other.m_generation; }
+
+	bool operator!=(const Tween &other) const { return !(*this == other); }
+
+private:
+	uint32_t m_index = 0;
+	// Slot generations start at one, zero is the null handle.
+	uint32_t m_generation = 0;
+};
+
+/**
+ * @brief Slides values from a start to an end value over time, such as the alpha, scale and colour of ui objects, in place of a {@link Driver} per value.
+ * Tweens of values made of the same number of floats are stored together in arrays, one float per lane, and all are advanced by one pass in {@link Tweens#Update}.
+ * A tween that has finished is removed from the arrays and keeps its end value until it is stopped, a repeating tween starts again from its start value.
+ * Tweens are started, read and stopped from the update thread.
+ **/
+class ACID_EXPORT Tweens :
+	public NonCopyable
+{
+public:
+	/// The most floats a tweened value can be made of.
+	static constexpr uint32_t MaxLanes = 4;
+
+	/**
+	 * Gets the tweens shared by the engine, advanced by the uis module before ui objects are updated.
+	 * @return The shared tweens.
+	 **/
+	static Tweens *Get();
+
+	/**
+	 * Starts a tween between two values.
+	 * @tparam T The type tweened, made of up to four floats such as a float, {@link Vector2f} or {@link Colour}.
+	 * @param start The start value.
+	 * @param end The end value.
+	 * @param length The time taken to get to the end value, if zero the tween is finished when started.
+	 * @param repeat If the tween starts again from the start value once it has got to the end value.
+	 * @return The handle to the tween, it must be stopped once it is no longer read.
+	 **/
+	template<typename T>
+	Tween Start(const T &start, const T &end, const Time &length, const bool &repeat = false)
+	{
+		static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(float) == 0 && sizeof(T) <= MaxLanes * sizeof(float),
+			"Tweened types must be made of up to four floats");
+		float starts[MaxLanes];
+		float ends[MaxLanes];
+		std::memcpy(starts, &start, sizeof(T));
+		std::memcpy(ends, &end, sizeof(T));
+		return Start(sizeof(T) / sizeof(float), starts, ends, length, repeat);
+	}
+
+	/**
+	 * Gets the current value of a tween.
+	 * @tparam T The type the tween was started with.
+	 * @param tween The tween.
+	 * @param fallback The value given if the tween was stopped or was started with another type.
+	 * @return The value of the tween.
+	 **/
+	template<typename T>
+	T GetValue(const Tween &tween, const T &fallback) const
+	{
+		auto value = fallback;
+
+		if (auto values = GetValues(tween, sizeof(T) / sizeof(float)))
+		{
+			std::memcpy(&value, values, sizeof(T));
+		}
+
+		return value;
+	}
+
+	/**
+	 * Gets if a tween has got to its end value, repeating tweens never finish.
+	 * @param tween The tween.
+	 * @return If the tween has finished or was stopped.
+	 **/
+	bool IsFinished(const Tween &tween) const;
+
+	/**
+	 * Stops a tween and releases its slot, the handle is reset.
+	 * @param tween The tween to stop.
+	 **/
+	void Stop(Tween &tween);
+
+	/**
+	 * Advances every tween that has not finished.
+	 * @param delta The time since the last update.
+	 **/
+	void Update(const Time &delta);
+
+	/**
+	 * Gets the number of tweens that have not finished.
+	 * @return The number of tweens being advanced.
+	 **/
+	std::size_t GetActiveCount() const;
+
+private:
+	/**
+	 * @brief Tweens made of the same number of floats, the arrays hold one float per lane and are padded to four.
+	 * The elapsed time and rate of a tween are repeated in each of its lanes so every array is advanced the same way.
+	 **/
+	class Pool
+	{
+	public:
+		void Resize(const uint32_t &rows);
+
+		uint32_t m_lanes = 0;
+		uint32_t m_rows = 0;
+
+		std::vector<float> m_elapsed;
+		std::vector<float> m_rates;
+		std::vector<float> m_starts;
+		std::vector<float> m_deltas;
+		std::vector<float> m_values;
+
+		/// The slot of each row.
+		std::vector<uint32_t> m_owners;
+		std::vector<bool> m_repeats;
+	};
+
+	class Slot
+	{
+	public:
+		uint32_t m_generation = 1;
+		uint32_t m_lanes = 0;
+		/// The row in the pool of the tween, none once it has finished.
+		std::optional<uint32_t> m_row;
+		float m_value[MaxLanes] = {};
+	};
+
+	Tweens();
+
+	Tween Start(const uint32_t &lanes, const float *starts, const float *ends, const Time &length, const bool &repeat);
+
+	const float *GetValues(const Tween &tween, const uint32_t &lanes) const;
+
+	const Slot *GetSlot(const Tween &tween) const;
+
+	void RemoveRow(Pool &pool, const uint32_t &row);
+
+	std::array<Pool, MaxLanes> m_pools;
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
+};
+}
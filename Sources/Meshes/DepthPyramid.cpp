@@ -0,0 +1,137 @@
+#include "DepthPyramid.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+static const VkFormat PYRAMID_FORMAT = VK_FORMAT_R32_SFLOAT;
+
+DepthPyramid::DepthPyramid(const Vector2ui &extent) :
+	m_extent(extent),
+	m_mipLevels(Image::GetMipLevels({ extent.m_x, extent.m_y, 1 })),
+	m_image(VK_NULL_HANDLE),
+	m_sampler(VK_NULL_HANDLE),
+	m_view(VK_NULL_HANDLE),
+	m_pipeline("Shaders/Culling/Pyramid.comp")
+{
+	Image::CreateImage(m_image, m_memory, { m_extent.m_x, m_extent.m_y, 1 }, PYRAMID_FORMAT, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL,
+		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_mipLevels, 1, VK_IMAGE_TYPE_2D);
+	m_sampler = Image::GetImageSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false);
+	Image::CreateImageView(m_image, m_view, VK_IMAGE_VIEW_TYPE_2D, PYRAMID_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+	Image::TransitionImageLayout(m_image, PYRAMID_FORMAT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+
+	for (uint32_t i = 0; i < m_mipLevels; i++)
+	{
+		VkImageView levelView = VK_NULL_HANDLE;
+		Image::CreateImageView(m_image, levelView, VK_IMAGE_VIEW_TYPE_2D, PYRAMID_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT, 1, i, 1, 0);
+		Vector2ui levelExtent = { std::max(m_extent.m_x >> i, 1u), std::max(m_extent.m_y >> i, 1u) };
+		m_levels.emplace_back(std::make_unique<Level>(m_sampler, levelView, levelExtent));
+		m_descriptorSets.emplace_back(std::make_unique<DescriptorsHandler>(m_pipeline));
+	}
+}
+
+DepthPyramid::~DepthPyramid()
+{
+	// Retired objects are destroyed in order, the views of the levels go before the image.
+	for (const auto &level : m_levels)
+	{
+		Image::DestroyImage(VK_NULL_HANDLE, level->GetView());
+	}
+
+	Image::DestroyImage(m_image, m_view, m_memory);
+}
+
+void DepthPyramid::Update(const CommandBuffer &commandBuffer, const ImageDepth &depth)
+{
+	VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+	if (Image::HasStencil(depth.GetFormat()))
+	{
+		depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+	}
+
+	// The depth writes of the last frame must be visible, and the last frames culling must be done reading the pyramid.
+	Image::InsertImageMemoryBarrier(commandBuffer, depth.GetImage(), VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, depthAspect, 1, 0, 1, 0);
+	Image::InsertImageMemoryBarrier(commandBuffer, m_image, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL,
+		VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1, 0);
+
+	m_pipeline.BindPipeline(commandBuffer);
+
+	for (uint32_t i = 0; i < m_mipLevels; i++)
+	{
+		auto &descriptorSet = *m_descriptorSets[i];
+
+		if (i == 0)
+		{
+			descriptorSet.Push("samplerInput", depth);
+		}
+		else
+		{
+			descriptorSet.Push("samplerInput", m_levels[i - 1]);
+		}
+
+		descriptorSet.Push("outDepth", m_levels[i]);
+
+		if (!descriptorSet.Update(m_pipeline))
+		{
+			return;
+		}
+
+		descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+		m_pipeline.CmdRender(commandBuffer, m_levels[i]->GetExtent());
+
+		// The next level reads from this level.
+		Image::InsertImageMemoryBarrier(commandBuffer, m_image, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+			VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, i, 1, 0);
+	}
+
+	// The renderpass clearing the depth image has to wait for the reduction to finish reading it.
+	Image::InsertImageMemoryBarrier(commandBuffer, depth.GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+		VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, depthAspect, 1, 0, 1, 0);
+}
+
+WriteDescriptorSet DepthPyramid::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const
+{
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.sampler = m_sampler;
+	imageInfo.imageView = m_view;
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = VK_NULL_HANDLE; // Will be set in the descriptor handler.
+	descriptorWrite.dstBinding = binding;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.descriptorType = descriptorType;
+	return WriteDescriptorSet(descriptorWrite, imageInfo);
+}
+
+DepthPyramid::Level::Level(const VkSampler &sampler, const VkImageView &view, const Vector2ui &extent) :
+	m_sampler(sampler),
+	m_view(view),
+	m_extent(extent)
+{
+}
+
+WriteDescriptorSet DepthPyramid::Level::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+	const std::optional<OffsetSize> &offsetSize) const
+{
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.sampler = m_sampler;
+	imageInfo.imageView = m_view;
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = VK_NULL_HANDLE; // Will be set in the descriptor handler.
+	descriptorWrite.dstBinding = binding;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.descriptorType = descriptorType;
+	return WriteDescriptorSet(descriptorWrite, imageInfo);
+}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Images/ImageDepth.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
+
+namespace acid
+{
+/**
+ * @brief Hierarchical depth image, each mip level holds the furthest depth of the texels it covers in the level above.
+ * Built from a depth image and sampled by compute shaders to test if bounds are occluded.
+ */
+class ACID_EXPORT DepthPyramid :
+	public Descriptor
+{
+public:
+	/**
+	 * Creates a new depth pyramid.
+	 * @param extent The extent of the depth image that will be reduced, this is the extent of the first level.
+	 */
+	explicit DepthPyramid(const Vector2ui &extent);
+
+	~DepthPyramid();
+
+	/**
+	 * Records the reduction of a depth image into every level of the pyramid, this must be called outside of a renderpass.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param depth The depth image, is expected to be in the depth stencil attachment layout.
+	 */
+	void Update(const CommandBuffer &commandBuffer, const ImageDepth &depth);
+
+	WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
+
+	const Vector2ui &GetExtent() const { return m_extent; }
+
+	const uint32_t &GetMipLevels() const { return m_mipLevels; }
+
+private:
+	/**
+	 * @brief A view of a single mip level, bound as the storage image being written or the sampled image being reduced.
+	 */
+	class Level :
+		public Descriptor
+	{
+	public:
+		Level(const VkSampler &sampler, const VkImageView &view, const Vector2ui &extent);
+
+		WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
+
+		const VkImageView &GetView() const { return m_view; }
+
+		const Vector2ui &GetExtent() const { return m_extent; }
+
+	private:
+		VkSampler m_sampler;
+		VkImageView m_view;
+		Vector2ui m_extent;
+	};
+
+	Vector2ui m_extent;
+	uint32_t m_mipLevels;
+
+	VkImage m_image;
+	MemoryAllocation m_memory;
+	VkSampler m_sampler;
+	VkImageView m_view;
+
+	std::vector<std::unique_ptr<Level>> m_levels;
+	PipelineCompute m_pipeline;
+	std::vector<std::unique_ptr<DescriptorsHandler>> m_descriptorSets;
+};
+}
@@ -0,0 +1,197 @@
+#include "ImpostorType.hpp"
+
+#include "Resources/Resources.hpp"
+#include "Models/Shapes/ModelRectangle.hpp"
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+static const uint32_t INSTANCE_STEPS = 128;
+
+std::shared_ptr<ImpostorType> ImpostorType::Create(const Metadata &metadata)
+{
+	return Resources::Get()->FindOrLoad<ImpostorType>(metadata, [&]()
+	{
+		auto result = std::make_shared<ImpostorType>(nullptr);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
+}
+
+std::shared_ptr<ImpostorType> ImpostorType::Create(const std::shared_ptr<Model> &model, const Colour &baseDiffuse, const std::shared_ptr<Image2d> &imageDiffuse,
+	const uint32_t &frames)
+{
+	auto temp = ImpostorType(model, baseDiffuse, imageDiffuse, frames);
+	Metadata metadata = Metadata();
+	metadata << temp;
+	return Create(metadata);
+}
+
+ImpostorType::ImpostorType(std::shared_ptr<Model> model, const Colour &baseDiffuse, std::shared_ptr<Image2d> imageDiffuse, const uint32_t &frames) :
+	m_model(std::move(model)),
+	m_baseDiffuse(baseDiffuse),
+	m_imageDiffuse(std::move(imageDiffuse)),
+	m_frames(frames),
+	m_maxInstances(0),
+	m_instances(0)
+{
+}
+
+void ImpostorType::Load()
+{
+	m_frames = std::max(m_frames, 1u);
+	m_quad = ModelRectangle::Create(-1.0f, 1.0f);
+}
+
+void ImpostorType::AddInstance(const Matrix4 &worldMatrix, const Vector3f &cameraPosition)
+{
+	if (!m_region || m_model == nullptr)
+	{
+		return;
+	}
+
+	auto [centre, radius] = GetBounds();
+	auto camera = worldMatrix.Inverse().Transform(Vector4f(cameraPosition));
+	auto direction = Vector3f(camera.m_x, camera.m_y, camera.m_z) - centre;
+
+	// Folds the direction onto the octahedron, the lower half is unfolded over the corners of the grid.
+	auto sum = std::abs(direction.m_x) + std::abs(direction.m_y) + std::abs(direction.m_z);
+	Vector2f grid(sum > 0.0f ? direction.m_x / sum : 0.0f, sum > 0.0f ? direction.m_z / sum : 0.0f);
+
+	if (direction.m_y < 0.0f)
+	{
+		grid = Vector2f((1.0f - std::abs(grid.m_y)) * (grid.m_x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::abs(grid.m_x)) * (grid.m_y >= 0.0f ? 1.0f : -1.0f));
+	}
+
+	auto frames = static_cast<float>(m_frames);
+	Vector2ui frame(std::min(static_cast<uint32_t>(std::max((grid.m_x * 0.5f + 0.5f) * frames, 0.0f)), m_frames - 1),
+		std::min(static_cast<uint32_t>(std::max((grid.m_y * 0.5f + 0.5f) * frames, 0.0f)), m_frames - 1));
+
+	auto frameDirection = GetFrameDirection(frame);
+	auto [right, up] = GetFrameBasis(frameDirection);
+
+	Instance instance;
+	instance.m_centre = worldMatrix.Transform(Vector4f(centre));
+	instance.m_right = worldMatrix.Transform(Vector4f(right * radius, 0.0f));
+	instance.m_up = worldMatrix.Transform(Vector4f(up * radius, 0.0f));
+	instance.m_forward = worldMatrix.Transform(Vector4f(frameDirection, 0.0f));
+	instance.m_frame = Vector4f(m_region->m_x + m_region->m_z * static_cast<float>(frame.m_x) / frames,
+		m_region->m_y + m_region->m_w * static_cast<float>(frame.m_y) / frames, m_region->m_z / frames, m_region->m_w / frames);
+	m_pending.emplace_back(instance);
+}
+
+void ImpostorType::Update()
+{
+	m_instances = 0;
+	ResizeInstances(static_cast<uint32_t>(m_pending.size()));
+
+	if (!m_pending.empty())
+	{
+		Instance *instances;
+		m_instanceBuffer->MapMemory(reinterpret_cast<void **>(&instances));
+		std::memcpy(instances, m_pending.data(), sizeof(Instance) * m_pending.size());
+		m_instanceBuffer->UnmapMemory();
+		m_instances = static_cast<uint32_t>(m_pending.size());
+	}
+
+	m_pending.clear();
+}
+
+bool ImpostorType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
+{
+	if (m_instances == 0)
+	{
+		return false;
+	}
+
+	// Updates descriptors.
+	m_descriptorSet.Push("UniformScene", uniformScene);
+	m_descriptorSet.Push("samplerDiffuse", Graphics::Get()->GetAttachment("impostorDiffuse"));
+	m_descriptorSet.Push("samplerNormal", Graphics::Get()->GetAttachment("impostorNormal"));
+	bool updateSuccess = m_descriptorSet.Update(pipeline);
+
+	if (!updateSuccess)
+	{
+		return false;
+	}
+
+	// Draws the instanced quads.
+	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
+
+	VkBuffer vertexBuffers[] = { m_quad->GetVertexBuffer()->GetBuffer(), m_instanceBuffer->GetBuffer() };
+	VkDeviceSize offsets[] = { 0, 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+	vkCmdBindIndexBuffer(commandBuffer, m_quad->GetIndexBuffer()->GetBuffer(), 0, m_quad->GetIndexType());
+	vkCmdDrawIndexed(commandBuffer, m_quad->GetIndexCount(), m_instances, m_quad->GetFirstIndex(), m_quad->GetVertexOffset(), 0);
+	return true;
+}
+
+Vector3f ImpostorType::GetFrameDirection(const Vector2ui &frame) const
+{
+	// Unfolds the centre of the frame from the octahedral grid, the corners of the grid look from below.
+	auto frames = static_cast<float>(m_frames);
+	Vector2f grid((static_cast<float>(frame.m_x) + 0.5f) / frames * 2.0f - 1.0f, (static_cast<float>(frame.m_y) + 0.5f) / frames * 2.0f - 1.0f);
+	Vector3f direction(grid.m_x, 1.0f - std::abs(grid.m_x) - std::abs(grid.m_y), grid.m_y);
+
+	if (direction.m_y < 0.0f)
+	{
+		auto x = direction.m_x;
+		direction.m_x = (1.0f - std::abs(direction.m_z)) * (x >= 0.0f ? 1.0f : -1.0f);
+		direction.m_z = (1.0f - std::abs(x)) * (direction.m_z >= 0.0f ? 1.0f : -1.0f);
+	}
+
+	return direction.Normalize();
+}
+
+std::pair<Vector3f, Vector3f> ImpostorType::GetFrameBasis(const Vector3f &direction)
+{
+	// Frames looking from straight above or below take their up from the front of the model.
+	auto reference = std::abs(direction.m_y) > 0.99f ? Vector3f::Front : Vector3f::Up;
+	auto right = reference.Cross(direction).Normalize();
+	auto up = direction.Cross(right);
+	return { right, up };
+}
+
+std::pair<Vector3f, float> ImpostorType::GetBounds() const
+{
+	if (m_model == nullptr)
+	{
+		return { Vector3f(), 0.0f };
+	}
+
+	auto centre = (m_model->GetMinExtents() + m_model->GetMaxExtents()) / 2.0f;
+	auto radius = (m_model->GetMaxExtents() - m_model->GetMinExtents()).Length() / 2.0f;
+	return { centre, radius };
+}
+
+void ImpostorType::ResizeInstances(const uint32_t &count)
+{
+	// Sizes are kept in steps so small changes in the instance count do not reallocate.
+	auto required = INSTANCE_STEPS * std::max(static_cast<uint32_t>(std::ceil(static_cast<float>(count) / static_cast<float>(INSTANCE_STEPS))), 1u);
+
+	if (m_instanceBuffer == nullptr || required > m_maxInstances)
+	{
+		m_maxInstances = std::max(required, m_maxInstances + m_maxInstances / 2);
+		m_instanceBuffer = std::make_unique<InstanceBuffer>(sizeof(Instance) * m_maxInstances);
+	}
+}
+
+const Metadata &operator>>(const Metadata &metadata, ImpostorType &impostorType)
+{
+	metadata.GetResource("Model", impostorType.m_model);
+	metadata.GetChild("Base Diffuse", impostorType.m_baseDiffuse);
+	metadata.GetResource("Image Diffuse", impostorType.m_imageDiffuse);
+	metadata.GetChild("Frames", impostorType.m_frames);
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const ImpostorType &impostorType)
+{
+	metadata.SetResource("Model", impostorType.m_model);
+	metadata.SetChild("Base Diffuse", impostorType.m_baseDiffuse);
+	metadata.SetResource("Image Diffuse", impostorType.m_imageDiffuse);
+	metadata.SetChild("Frames", impostorType.m_frames);
+	return metadata;
+}
+}
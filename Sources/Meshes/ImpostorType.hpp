@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Maths/Colour.hpp"
+#include "Maths/Matrix4.hpp"
+#include "Maths/Vector4.hpp"
+#include "Models/Model.hpp"
+#include "Graphics/Buffers/InstanceBuffer.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Graphics/Images/Image2d.hpp"
+#include "Resources/Resource.hpp"
+
+namespace acid
+{
+/**
+ * @brief Resource that represents a model drawn from afar as a billboard, from views of the model baked around it into an octahedral grid of frames.
+ * The frames are baked into a region of the "impostorDiffuse" and "impostorNormal" attachments by {@link SubrenderImpostors},
+ * the frame facing the camera is then drawn on a instanced quad in place of the model.
+ */
+class ACID_EXPORT ImpostorType :
+	public Resource
+{
+public:
+	class Instance
+	{
+	public:
+		static Shader::VertexInput GetVertexInput(const uint32_t &baseBinding = 0)
+		{
+			std::vector<VkVertexInputBindingDescription> bindingDescriptions = {
+				VkVertexInputBindingDescription{ baseBinding, sizeof(Instance), VK_VERTEX_INPUT_RATE_INSTANCE }
+			};
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+				VkVertexInputAttributeDescription{ 3, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_centre) },
+				VkVertexInputAttributeDescription{ 4, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_right) },
+				VkVertexInputAttributeDescription{ 5, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_up) },
+				VkVertexInputAttributeDescription{ 6, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_forward) },
+				VkVertexInputAttributeDescription{ 7, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, m_frame) }
+			};
+			return Shader::VertexInput(bindingDescriptions, attributeDescriptions);
+		}
+
+		Vector4f m_centre;
+		// The half extents of the quad in world space, along the right and up of the frame.
+		Vector4f m_right;
+		Vector4f m_up;
+		// The direction the frame was baked from in world space, normals are baked relative to the frame.
+		Vector4f m_forward;
+		// The offset (xy) and size (zw) of the frame in the atlas.
+		Vector4f m_frame;
+	};
+
+	/**
+	 * Creates a new impostor type, or finds one with the same values.
+	 * @param metadata The metadata to decode values from.
+	 * @return The impostor type with the requested values.
+	 */
+	static std::shared_ptr<ImpostorType> Create(const Metadata &metadata);
+
+	/**
+	 * Creates a new impostor type, or finds one with the same values.
+	 * @param model The model baked into the frames.
+	 * @param baseDiffuse The diffuse colour the model is baked with.
+	 * @param imageDiffuse The diffuse image the model is baked with.
+	 * @param frames The number of frames along each side of the octahedral grid.
+	 * @return The impostor type with the requested values.
+	 */
+	static std::shared_ptr<ImpostorType> Create(const std::shared_ptr<Model> &model, const Colour &baseDiffuse = Colour::White,
+		const std::shared_ptr<Image2d> &imageDiffuse = nullptr, const uint32_t &frames = 8);
+
+	/**
+	 * Creates a new impostor type.
+	 * @param model The model baked into the frames.
+	 * @param baseDiffuse The diffuse colour the model is baked with.
+	 * @param imageDiffuse The diffuse image the model is baked with.
+	 * @param frames The number of frames along each side of the octahedral grid.
+	 */
+	explicit ImpostorType(std::shared_ptr<Model> model, const Colour &baseDiffuse = Colour::White, std::shared_ptr<Image2d> imageDiffuse = nullptr,
+		const uint32_t &frames = 8);
+
+	void Load() override;
+
+	/**
+	 * Adds a instance drawn this frame, facing the frame baked nearest to the direction it is seen from.
+	 * @param worldMatrix The world matrix of the mesh the impostor stands in for.
+	 * @param cameraPosition The position the instance is seen from.
+	 */
+	void AddInstance(const Matrix4 &worldMatrix, const Vector3f &cameraPosition);
+
+	/**
+	 * Uploads the instances added since the last update, then clears them for the next frame.
+	 */
+	void Update();
+
+	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
+
+	/**
+	 * Gets the direction a frame is baked from, in the space of the model.
+	 * @param frame The column and row of the frame.
+	 * @return The direction from the centre of the model.
+	 */
+	Vector3f GetFrameDirection(const Vector2ui &frame) const;
+
+	/**
+	 * Gets the right and up of a frame in the space of the model, the frame is baked looking back along its direction.
+	 * @param direction The direction the frame is baked from.
+	 * @return The right and up of the frame.
+	 */
+	static std::pair<Vector3f, Vector3f> GetFrameBasis(const Vector3f &direction);
+
+	/**
+	 * Gets the centre and radius of the sphere bounding the model, the frames are baked to fit it.
+	 * @return The centre and radius.
+	 */
+	std::pair<Vector3f, float> GetBounds() const;
+
+	const std::shared_ptr<Model> &GetModel() const { return m_model; }
+
+	const Colour &GetBaseDiffuse() const { return m_baseDiffuse; }
+
+	const std::shared_ptr<Image2d> &GetImageDiffuse() const { return m_imageDiffuse; }
+
+	const uint32_t &GetFrames() const { return m_frames; }
+
+	/**
+	 * Gets the offset (xy) and size (zw) of the atlas region the frames were baked into.
+	 * @return The region, or nullopt if the frames are not baked.
+	 */
+	const std::optional<Vector4f> &GetRegion() const { return m_region; }
+
+	/**
+	 * Sets the atlas region the frames are baked into, set by {@link SubrenderImpostors} once they are baked and cleared when the atlas is lost.
+	 * @param region The offset (xy) and size (zw) of the region, or nullopt if the frames are not baked.
+	 */
+	void SetRegion(const std::optional<Vector4f> &region) { m_region = region; }
+
+	bool IsBaked() const { return m_region.has_value(); }
+
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, ImpostorType &impostorType);
+
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ImpostorType &impostorType);
+
+private:
+	void ResizeInstances(const uint32_t &count);
+
+	std::shared_ptr<Model> m_model;
+	Colour m_baseDiffuse;
+	std::shared_ptr<Image2d> m_imageDiffuse;
+	uint32_t m_frames;
+	std::optional<Vector4f> m_region;
+
+	std::shared_ptr<Model> m_quad;
+	std::vector<Instance> m_pending;
+	uint32_t m_maxInstances;
+	uint32_t m_instances;
+
+	DescriptorsHandler m_descriptorSet;
+	std::unique_ptr<InstanceBuffer> m_instanceBuffer;
+};
+}
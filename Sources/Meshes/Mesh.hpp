@@ -2,6 +2,7 @@
 
 #include "Models/Model.hpp"
 #include "Models/VertexDefault.hpp"
+#include "Models/VertexQuantized.hpp"
 #include "Scenes/Component.hpp"
 
 namespace acid
@@ -25,7 +26,10 @@ public:
 
 	virtual const std::shared_ptr<Model> &GetModel() const { return m_model; }
 
-	virtual Shader::VertexInput GetVertexInput(const uint32_t &binding = 0) const { return VertexDefault::GetVertexInput(binding); }
+	virtual Shader::VertexInput GetVertexInput(const uint32_t &binding = 0) const
+	{
+		return m_model != nullptr && m_model->IsQuantized() ? VertexQuantized::GetVertexInput(binding) : VertexDefault::GetVertexInput(binding);
+	}
 
 	virtual void SetModel(const std::shared_ptr<Model> &model) { m_model = model; }
 
@@ -1,12 +1,28 @@
 #include "MeshRender.hpp"
 
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Descriptors/BindlessDescriptors.hpp"
 #include "Materials/Material.hpp"
-#include "Physics/Rigidbody.hpp"
 #include "Scenes/Entity.hpp"
 #include "Scenes/Scenes.hpp"
 
 namespace acid
 {
+// The time a change between levels of detail is dithered over.
+static const float LOD_FADE_TIME = 0.25f;
+
+MeshRender::MeshRender() :
+	m_lod(0),
+	m_lodFade(0.0f),
+	m_lodThreshold(1.0f),
+	m_impostorDistance(100.0f),
+	m_impostorActive(false),
+	m_objectPushed(false)
+{
+	// Uniforms are written into this meshes own handler.
+	SetThreadSafe(true);
+}
+
 void MeshRender::Start()
 {
 }
@@ -20,21 +36,19 @@ void MeshRender::Update()
 		return;
 	}
 
-	// Updates uniforms.
-	material->PushUniforms(m_uniformObject);
+	// Updates uniforms, materials drawn with push constants write their values when they are drawn.
+	if (!m_objectPushed)
+	{
+		material->PushUniforms(m_uniformObject);
+	}
 }
 
-bool MeshRender::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const Pipeline::Stage &pipelineStage)
+bool MeshRender::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const Pipeline::Stage &pipelineStage, const PipelineMaterial **boundPipeline)
 {
-	// Checks if the mesh is in view.
-	auto rigidbody = GetParent()->GetComponent<Rigidbody>();
-
-	if (rigidbody != nullptr)
+	// Meshes drawn as their impostor are drawn by the meshes subrender with the other impostors.
+	if (m_impostorActive)
 	{
-		if (!rigidbody->InFrustum(Scenes::Get()->GetCamera()->GetViewFrustum()))
-		{
-			return false;
-		}
+		return false;
 	}
 
 	// Gets required components.
@@ -55,19 +69,38 @@ bool MeshRender::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &u
 	}
 
 	// Binds the material pipeline.
-	bool bindSuccess = materialPipeline->BindPipeline(commandBuffer);
-
-	if (!bindSuccess)
+	if (boundPipeline == nullptr || *boundPipeline != materialPipeline.get())
 	{
-		return false;
+		bool bindSuccess = materialPipeline->BindPipeline(commandBuffer);
+
+		if (!bindSuccess)
+		{
+			return false;
+		}
+
+		if (boundPipeline != nullptr)
+		{
+			*boundPipeline = materialPipeline.get();
+		}
 	}
 
 	auto &pipeline = *materialPipeline->GetPipeline();
 
+	// Shaders without a uniform object take the per object values as push constants, so no uniform buffer or descriptor is written for them.
+	auto pushObject = pipeline.GetShader()->FindUniformBlock("UniformObject") == nullptr;
+
 	// Updates descriptors.
 	m_descriptorSet.Push("UniformScene", uniformScene);
-	m_descriptorSet.Push("UniformObject", m_uniformObject);
+
+	if (!pushObject)
+	{
+		m_descriptorSet.Push("UniformObject", m_uniformObject);
+	}
+
+	m_descriptorSet.Push("PushObject", m_pushObject);
 	material->PushDescriptors(m_descriptorSet);
+	material->PushConstants(m_pushObject);
+	m_objectPushed = pushObject && material->PushObject(m_pushObject);
 	bool updateSuccess = m_descriptorSet.Update(pipeline);
 
 	if (!updateSuccess)
@@ -75,9 +108,177 @@ bool MeshRender::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &u
 		return false;
 	}
 
-	// Draws the object.
+	// Draws the object, bindless materials are selected by push constant from the shared bindless set.
 	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
-	return meshModel->CmdRender(commandBuffer);
+
+	if (pipeline.GetShader()->IsBindless())
+	{
+		Graphics::Get()->GetBindlessDescriptors()->BindDescriptor(commandBuffer, pipeline);
+	}
+
+	// During a fade both levels are drawn, each discards the pixels the other keeps.
+	auto fade = std::max(m_lodFade, 1e-3f);
+	m_pushObject.Push("lodFade", m_lodNext ? fade : 0.0f);
+	m_pushObject.BindPush(commandBuffer, pipeline);
+
+	if (!meshModel->CmdRender(commandBuffer, 1, m_lod))
+	{
+		return false;
+	}
+
+	if (m_lodNext)
+	{
+		m_pushObject.Push("lodFade", -fade);
+		m_pushObject.BindPush(commandBuffer, pipeline);
+		meshModel->CmdRender(commandBuffer, 1, *m_lodNext);
+	}
+
+	return true;
+}
+
+bool MeshRender::CmdRenderDepth(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const PipelineGraphics &pipeline)
+{
+	// Skips the meshes the material pass skips, depth without a surface shaded over it would leave a hole.
+	if (m_impostorActive)
+	{
+		return false;
+	}
+
+	auto mesh = GetParent()->GetComponent<Mesh>();
+
+	if (mesh == nullptr || mesh->GetModel() == nullptr)
+	{
+		return false;
+	}
+
+	// The transform the material pushes this frame, read from the entity so the material is not touched while it is being drawn.
+	auto &model = *mesh->GetModel();
+	m_pushDepth.Push("transform", GetParent()->GetWorldMatrix());
+
+	if (model.IsQuantized())
+	{
+		m_pushDepth.Push("positionScale", Vector4f(model.GetQuantizeScale(), 0.0f));
+		m_pushDepth.Push("positionOffset", Vector4f(model.GetQuantizeOffset(), 0.0f));
+	}
+
+	m_descriptorDepth.Push("UniformScene", uniformScene);
+	m_descriptorDepth.Push("PushObject", m_pushDepth);
+
+	if (!m_descriptorDepth.Update(pipeline))
+	{
+		return false;
+	}
+
+	m_descriptorDepth.BindDescriptor(commandBuffer, pipeline);
+
+	auto fade = std::max(m_lodFade, 1e-3f);
+	m_pushDepth.Push("lodFade", m_lodNext ? fade : 0.0f);
+	m_pushDepth.BindPush(commandBuffer, pipeline);
+
+	if (!model.CmdRender(commandBuffer, 1, m_lod))
+	{
+		return false;
+	}
+
+	if (m_lodNext)
+	{
+		m_pushDepth.Push("lodFade", -fade);
+		m_pushDepth.BindPush(commandBuffer, pipeline);
+		model.CmdRender(commandBuffer, 1, *m_lodNext);
+	}
+
+	return true;
+}
+
+void MeshRender::UpdateLod(const float &pixelScale)
+{
+	auto frameCount = Graphics::Get()->GetFrameCount();
+
+	if (m_lodFrame == frameCount)
+	{
+		return;
+	}
+
+	auto mesh = GetParent()->GetComponent<Mesh>();
+	auto model = mesh != nullptr ? mesh->GetModel() : nullptr;
+
+	// Impostors stand in for the model once they are baked, the model is drawn while close or until then.
+	m_impostorActive = m_impostor != nullptr && m_impostor->IsBaked() &&
+		(Scenes::Get()->GetCamera()->GetPosition() - GetParent()->GetWorldTransform().GetPosition()).Length() > m_impostorDistance;
+
+	// Streamed textures keep the mip levels needed for the size the mesh covers on screen.
+	if (auto material = GetParent()->GetComponent<Material>(); material != nullptr && model != nullptr)
+	{
+		auto transform = GetParent()->GetWorldTransform();
+		auto scaling = transform.GetScaling();
+		auto radius = model->GetRadius() * std::max({ std::abs(scaling.m_x), std::abs(scaling.m_y), std::abs(scaling.m_z) });
+		auto camera = Scenes::Get()->GetCamera();
+
+		if (camera->GetViewFrustum().SphereInFrustum(transform.GetPosition(), radius))
+		{
+			auto distance = (camera->GetPosition() - transform.GetPosition()).Length() - radius;
+			material->RequestResidency(distance > 0.0f ? 2.0f * radius / distance * pixelScale : std::numeric_limits<float>::max());
+		}
+	}
+
+	if (model == nullptr || model->GetLods().size() <= 1)
+	{
+		m_lod = 0;
+		m_lodNext = std::nullopt;
+		m_lodFade = 0.0f;
+		m_lodFrame = frameCount;
+		return;
+	}
+
+	// The distance is taken to the nearest point of the bounding sphere, so large meshes do not coarsen while the camera is close to their surface.
+	auto transform = GetParent()->GetWorldTransform();
+	auto scaling = transform.GetScaling();
+	auto maxScale = std::max({ std::abs(scaling.m_x), std::abs(scaling.m_y), std::abs(scaling.m_z) });
+	auto distance = (Scenes::Get()->GetCamera()->GetPosition() - transform.GetPosition()).Length() - model->GetRadius() * maxScale;
+
+	const auto &lods = model->GetLods();
+	uint32_t selected = 0;
+
+	if (distance > 0.0f)
+	{
+		for (auto i = static_cast<uint32_t>(lods.size()) - 1; i > 0; i--)
+		{
+			if (lods[i].m_error * maxScale / distance * pixelScale < m_lodThreshold)
+			{
+				selected = i;
+				break;
+			}
+		}
+	}
+
+	// A mesh seen for the first time starts at its level, it has nothing on screen to fade from.
+	if (!m_lodFrame)
+	{
+		m_lod = selected;
+		m_lodFrame = frameCount;
+		return;
+	}
+
+	m_lodFrame = frameCount;
+
+	if (m_lodNext)
+	{
+		m_lodFade += Engine::Get()->GetDeltaRender().AsSeconds() / LOD_FADE_TIME;
+
+		if (m_lodFade < 1.0f)
+		{
+			return;
+		}
+
+		m_lod = *m_lodNext;
+		m_lodNext = std::nullopt;
+		m_lodFade = 0.0f;
+	}
+
+	if (selected != m_lod)
+	{
+		m_lodNext = selected;
+	}
 }
 
 bool MeshRender::operator<(const MeshRender &other) const
@@ -92,11 +293,17 @@ bool MeshRender::operator<(const MeshRender &other) const
 
 const Metadata &operator>>(const Metadata &metadata, MeshRender &meshRender)
 {
+	metadata.GetChild("Lod Threshold", meshRender.m_lodThreshold);
+	metadata.GetResource("Impostor", meshRender.m_impostor);
+	metadata.GetChild("Impostor Distance", meshRender.m_impostorDistance);
 	return metadata;
 }
 
 Metadata &operator<<(Metadata &metadata, const MeshRender &meshRender)
 {
+	metadata.SetChild("Lod Threshold", meshRender.m_lodThreshold);
+	metadata.SetResource("Impostor", meshRender.m_impostor);
+	metadata.SetChild("Impostor Distance", meshRender.m_impostorDistance);
 	return metadata;
 }
 }
@@ -1,20 +1,103 @@
 #pragma once
 
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Buffers/PushHandler.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "ImpostorType.hpp"
 #include "Mesh.hpp"
 
 namespace acid
 {
+class PipelineGraphics;
+class PipelineMaterial;
+
 class ACID_EXPORT MeshRender :
 	public Component
 {
 public:
+	MeshRender();
+
 	void Start() override;
 
 	void Update() override;
 
-	bool CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const Pipeline::Stage &pipelineStage);
+	/**
+	 * Draws the mesh with its material, meshes outside the view are culled beforehand by {@link SubrenderMeshes}.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param uniformScene The scene uniforms.
+	 * @param pipelineStage The stage being drawn, meshes with a material for another stage are skipped.
+	 * @param boundPipeline If not null, the pipeline last bound by a mesh in the same pass. The pipeline is not bound again if it is the same, and is updated when bound.
+	 * @return If the mesh was drawn.
+	 */
+	bool CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const Pipeline::Stage &pipelineStage, const PipelineMaterial **boundPipeline = nullptr);
+
+	/**
+	 * Draws the depth of the mesh for a depth pre-pass, with the levels of detail and fade it is drawn with by {@link MeshRender#CmdRender}.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param uniformScene The scene uniforms.
+	 * @param pipeline The depth pipeline, already bound and matching the vertex type of the model.
+	 * @return If the mesh was drawn.
+	 */
+	bool CmdRenderDepth(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const PipelineGraphics &pipeline);
+
+	/**
+	 * Selects the coarsest level of detail of the model whos error covers less than the threshold on screen, changes between levels are faded over a few frames.
+	 * This is only run once a frame, so the meshes of every pass are drawn with the same levels.
+	 * @param pixelScale The number of pixels a unit of size covers at a distance of one unit, the projections vertical scale times half the height of the render.
+	 */
+	void UpdateLod(const float &pixelScale);
+
+	/**
+	 * Gets the level of detail being drawn, during a fade this is the level being faded out.
+	 * @return The level of detail.
+	 */
+	uint32_t GetLod() const { return m_lod; }
+
+	/**
+	 * Gets the level of detail being faded in.
+	 * @return The level faded to, if a fade is running.
+	 */
+	const std::optional<uint32_t> &GetLodNext() const { return m_lodNext; }
+
+	/**
+	 * Gets how far the fade to the next level has run.
+	 * @return The fade, from zero to one.
+	 */
+	float GetLodFade() const { return m_lodFade; }
+
+	/**
+	 * Gets the largest error in pixels that a level may have on screen to be selected.
+	 * @return The error threshold in pixels.
+	 */
+	float GetLodThreshold() const { return m_lodThreshold; }
+
+	/**
+	 * Sets the largest error in pixels that a level may have on screen to be selected.
+	 * @param lodThreshold The error threshold in pixels.
+	 */
+	void SetLodThreshold(const float &lodThreshold) { m_lodThreshold = lodThreshold; }
+
+	const std::shared_ptr<ImpostorType> &GetImpostor() const { return m_impostor; }
+
+	/**
+	 * Sets the impostor drawn in place of the mesh when it is far away, the mesh is drawn until the impostor is baked.
+	 * @param impostor The impostor, or nullptr to always draw the mesh.
+	 */
+	void SetImpostor(const std::shared_ptr<ImpostorType> &impostor) { m_impostor = impostor; }
+
+	float GetImpostorDistance() const { return m_impostorDistance; }
+
+	/**
+	 * Sets the distance from the camera past which the impostor is drawn in place of the mesh.
+	 * @param impostorDistance The distance in units.
+	 */
+	void SetImpostorDistance(const float &impostorDistance) { m_impostorDistance = impostorDistance; }
+
+	/**
+	 * Gets if the impostor is drawn in place of the mesh this frame, selected along with the level of detail by {@link MeshRender#UpdateLod}.
+	 * @return If the mesh is drawn as its impostor.
+	 */
+	bool IsImpostor() const { return m_impostorActive; }
 
 	bool operator<(const MeshRender &other) const;
 
@@ -25,5 +108,18 @@ public:
 private:
 	DescriptorsHandler m_descriptorSet;
 	UniformHandler m_uniformObject;
+	PushHandler m_pushObject;
+	DescriptorsHandler m_descriptorDepth;
+	PushHandler m_pushDepth;
+
+	uint32_t m_lod;
+	std::optional<uint32_t> m_lodNext;
+	float m_lodFade;
+	float m_lodThreshold;
+	std::optional<uint64_t> m_lodFrame;
+	std::shared_ptr<ImpostorType> m_impostor;
+	float m_impostorDistance;
+	bool m_impostorActive;
+	bool m_objectPushed;
 };
 }
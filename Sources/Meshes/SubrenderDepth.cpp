@@ -0,0 +1,130 @@
+#include "SubrenderDepth.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Materials/Material.hpp"
+#include "Materials/PipelineMaterial.hpp"
+#include "Models/VertexDefault.hpp"
+#include "Models/VertexQuantized.hpp"
+#include "Scenes/Scenes.hpp"
+#include "MeshRender.hpp"
+#include "SubrenderMeshes.hpp"
+
+namespace acid
+{
+SubrenderDepth::SubrenderDepth(const Pipeline::Stage &pipelineStage) :
+	Subrender(pipelineStage),
+	m_pipeline(pipelineStage, { "Shaders/Defaults/Depth.vert", "Shaders/Defaults/Depth.frag" }, { GetPositionInput(VertexDefault::GetVertexInput()) },
+		{ { "INSTANCED", "0" }, { "QUANTIZED", "0" } }, PipelineGraphics::Mode::DepthOnly),
+	m_pipelineQuantized(pipelineStage, { "Shaders/Defaults/Depth.vert", "Shaders/Defaults/Depth.frag" }, { GetPositionInput(VertexQuantized::GetVertexInput()) },
+		{ { "INSTANCED", "0" }, { "QUANTIZED", "1" } }, PipelineGraphics::Mode::DepthOnly),
+	m_pipelineInstanced(pipelineStage, { "Shaders/Defaults/Depth.vert", "Shaders/Defaults/Depth.frag" }, { GetPositionInput(VertexDefault::GetVertexInput()) },
+		{ { "INSTANCED", "1" }, { "QUANTIZED", "0" } }, PipelineGraphics::Mode::DepthOnly),
+	m_pipelineInstancedQuantized(pipelineStage, { "Shaders/Defaults/Depth.vert", "Shaders/Defaults/Depth.frag" }, { GetPositionInput(VertexQuantized::GetVertexInput()) },
+		{ { "INSTANCED", "1" }, { "QUANTIZED", "1" } }, PipelineGraphics::Mode::DepthOnly),
+	m_uniformScene(true)
+{
+}
+
+void SubrenderDepth::Render(const CommandBuffer &commandBuffer)
+{
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+	auto subrenderMeshes = Graphics::Get()->GetSubrender<SubrenderMeshes>();
+
+	// Sorted passes select their meshes and levels while they are drawn, so only the unsorted pass has its meshes ready before it draws.
+	if (renderStage == nullptr || !renderStage->IsDepthPrepass() || subrenderMeshes == nullptr || subrenderMeshes->GetStage() != GetStage() ||
+		subrenderMeshes->m_sort != SubrenderMeshes::Sort::None)
+	{
+		return;
+	}
+
+	// The same jittered projections and views the materials are drawn with.
+	auto viewCount = subrenderMeshes->UpdateViews(*Scenes::Get()->GetCamera());
+	m_uniformScene.Push("projection", *subrenderMeshes->m_projections.data(), sizeof(Matrix4) * viewCount);
+	m_uniformScene.Push("view", *subrenderMeshes->m_views.data(), sizeof(Matrix4) * viewCount);
+
+	const PipelineGraphics *boundPipeline = nullptr;
+
+	for (const auto &meshRender : subrenderMeshes->m_unbatched)
+	{
+		auto material = meshRender->GetParent()->GetComponent<Material>();
+		auto mesh = meshRender->GetParent()->GetComponent<Mesh>();
+
+		if (material == nullptr || mesh == nullptr || mesh->GetModel() == nullptr || !IsPrepassed(material->GetPipelineMaterial().get()))
+		{
+			continue;
+		}
+
+		auto &pipeline = mesh->GetModel()->IsQuantized() ? m_pipelineQuantized : m_pipeline;
+
+		if (&pipeline != boundPipeline)
+		{
+			pipeline.BindPipeline(commandBuffer);
+			boundPipeline = &pipeline;
+		}
+
+		meshRender->CmdRenderDepth(commandBuffer, m_uniformScene, pipeline);
+	}
+
+	RenderBatches(commandBuffer, *subrenderMeshes);
+}
+
+Shader::VertexInput SubrenderDepth::GetPositionInput(const Shader::VertexInput &vertexInput)
+{
+	return Shader::VertexInput(vertexInput.GetBindingDescriptions(), { vertexInput.GetAttributeDescriptions()[0] });
+}
+
+bool SubrenderDepth::IsPrepassed(PipelineMaterial *pipelineMaterial) const
+{
+	// Materials that are not compiled yet are skipped by the material pass too.
+	return pipelineMaterial != nullptr && pipelineMaterial->GetStage() == GetStage() && pipelineMaterial->GetPipelineCreate().GetDepth() == PipelineGraphics::Depth::Prepass &&
+		pipelineMaterial->IsCompiled();
+}
+
+void SubrenderDepth::RenderBatches(const CommandBuffer &commandBuffer, SubrenderMeshes &subrenderMeshes)
+{
+	// Draws from the commands the culling passes wrote for the material pass, so the same instances and meshlets are drawn.
+	uint32_t batchIndex = 0;
+	const PipelineGraphics *boundPipeline = nullptr;
+	std::pair<const Buffer *, const Buffer *> boundBuffers;
+
+	for (const auto &[key, batch] : subrenderMeshes.m_batches)
+	{
+		auto offset = sizeof(VkDrawIndexedIndirectCommand) * batchIndex++;
+
+		if ((batch->m_meshlets && batch->m_pipelineMeshlet != nullptr) || !IsPrepassed(batch->m_pipelineMaterial.get()))
+		{
+			continue;
+		}
+
+		auto &pipeline = batch->m_model->IsQuantized() ? m_pipelineInstancedQuantized : m_pipelineInstanced;
+
+		if (&pipeline != boundPipeline)
+		{
+			pipeline.BindPipeline(commandBuffer);
+			boundPipeline = &pipeline;
+		}
+
+		batch->m_descriptorDepth.Push("UniformScene", m_uniformScene);
+		batch->m_descriptorDepth.Push("BufferInstances", subrenderMeshes.m_instanceBuffer);
+		batch->m_descriptorDepth.Push("BufferVisible", subrenderMeshes.m_visibleBuffer);
+
+		if (!batch->m_descriptorDepth.Update(pipeline))
+		{
+			continue;
+		}
+
+		batch->m_descriptorDepth.BindDescriptor(commandBuffer, pipeline);
+
+		auto buffers = std::make_pair(batch->m_model->GetVertexBuffer(), batch->m_model->GetIndexBuffer());
+		auto drawn = batch->m_meshlets ?
+			batch->m_model->CmdRenderIndirect(commandBuffer, *subrenderMeshes.m_meshletCommands, sizeof(VkDrawIndexedIndirectCommand) * batch->m_firstMeshletCommand,
+				buffers != boundBuffers, batch->m_model->GetMeshletCount() * static_cast<uint32_t>(batch->m_instances.size())) :
+			batch->m_model->CmdRenderIndirect(commandBuffer, *subrenderMeshes.m_indirectBuffer, offset, buffers != boundBuffers);
+
+		if (drawn)
+		{
+			boundBuffers = buffers;
+		}
+	}
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Pipelines/PipelineGraphics.hpp"
+
+namespace acid
+{
+class PipelineMaterial;
+class SubrenderMeshes;
+
+/**
+ * @brief Lays down the depth of the meshes of the unsorted {@link SubrenderMeshes} in its stage, so their materials only shade the visible surface of each pixel.
+ * It is added to the same subpass before the meshes, and only draws when the render stage has a depth pre-pass, see {@link RenderStage#SetDepthPrepass}.
+ * Meshes are drawn like shadows, with minimal pipelines that only read positions, and use the batches and culling results of the mesh subrender.
+ * Only materials created with {@code PipelineGraphics::Depth::Prepass} are drawn, animated meshes and mesh shader batches test and write depth themselves.
+ */
+class ACID_EXPORT SubrenderDepth :
+	public Subrender
+{
+public:
+	explicit SubrenderDepth(const Pipeline::Stage &pipelineStage);
+
+	void Render(const CommandBuffer &commandBuffer) override;
+
+private:
+	/**
+	 * Gets the vertex input of the position attribute of a vertex type, the other attributes are skipped over by the stride.
+	 * @param vertexInput The full vertex input.
+	 * @return The position only vertex input.
+	 */
+	static Shader::VertexInput GetPositionInput(const Shader::VertexInput &vertexInput);
+
+	/**
+	 * Gets if the depth of a material pipeline is drawn by the pre-pass, the material pass tests for equality with what the pre-pass draws.
+	 * @param pipelineMaterial The material pipeline.
+	 * @return If the pipelines meshes are drawn.
+	 */
+	bool IsPrepassed(PipelineMaterial *pipelineMaterial) const;
+
+	void RenderBatches(const CommandBuffer &commandBuffer, SubrenderMeshes &subrenderMeshes);
+
+	PipelineGraphics m_pipeline;
+	PipelineGraphics m_pipelineQuantized;
+	PipelineGraphics m_pipelineInstanced;
+	PipelineGraphics m_pipelineInstancedQuantized;
+	UniformHandler m_uniformScene;
+};
+}
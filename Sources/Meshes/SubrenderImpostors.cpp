@@ -0,0 +1,199 @@
+#include "SubrenderImpostors.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Models/VertexDefault.hpp"
+#include "Models/VertexQuantized.hpp"
+#include "Scenes/Scenes.hpp"
+#include "MeshRender.hpp"
+
+namespace acid
+{
+SubrenderImpostors::SubrenderImpostors(const Pipeline::Stage &pipelineStage, const uint32_t &regionSize) :
+	Subrender(pipelineStage),
+	m_regionSize(regionSize),
+	m_lastAtlas(nullptr)
+{
+}
+
+void SubrenderImpostors::Render(const CommandBuffer &commandBuffer)
+{
+	auto extent = Graphics::Get()->GetRenderStage(GetStage().first)->GetRenderArea().GetExtent();
+	auto columns = std::max(extent.m_x / m_regionSize, 1u);
+	auto rows = std::max(extent.m_y / m_regionSize, 1u);
+
+	// Every impostor is baked again once the attachments are lost, or resized into a different number of regions.
+	if (!IsAtlasKept() || m_regions.size() != columns * rows)
+	{
+		for (const auto &region : m_regions)
+		{
+			if (auto impostorType = region.lock())
+			{
+				impostorType->SetRegion(std::nullopt);
+			}
+		}
+
+		m_regions.clear();
+		m_regions.resize(columns * rows);
+	}
+
+	// Finds a impostor in view that is not baked, and a region that is free.
+	std::shared_ptr<ImpostorType> impostorType;
+
+	for (const auto &meshRender : Scenes::Get()->GetStructure()->ViewComponents<MeshRender>())
+	{
+		auto &impostor = meshRender->GetImpostor();
+
+		if (impostor != nullptr && !impostor->IsBaked() && impostor->GetModel() != nullptr && impostor->GetModel()->GetIndexBuffer() != nullptr)
+		{
+			impostorType = impostor;
+			break;
+		}
+	}
+
+	if (impostorType == nullptr)
+	{
+		return;
+	}
+
+	auto freeRegion = std::find_if(m_regions.begin(), m_regions.end(), [](const std::weak_ptr<ImpostorType> &region)
+	{
+		return region.expired();
+	});
+
+	if (freeRegion == m_regions.end())
+	{
+		return;
+	}
+
+	auto index = static_cast<uint32_t>(freeRegion - m_regions.begin());
+	auto regionSize = Vector2f(static_cast<float>(m_regionSize) / static_cast<float>(extent.m_x), static_cast<float>(m_regionSize) / static_cast<float>(extent.m_y));
+	Vector4f region(static_cast<float>(index % columns) * regionSize.m_x, static_cast<float>(index / columns) * regionSize.m_y, regionSize.m_x, regionSize.m_y);
+
+	auto &model = *impostorType->GetModel();
+	auto &pipeline = GetPipeline(*impostorType);
+	auto [centre, radius] = impostorType->GetBounds();
+
+	m_descriptorSet.Push("PushObject", m_pushObject);
+
+	if (impostorType->GetImageDiffuse() != nullptr)
+	{
+		m_descriptorSet.Push("samplerDiffuse", impostorType->GetImageDiffuse());
+	}
+
+	if (!m_descriptorSet.Update(pipeline))
+	{
+		return;
+	}
+
+	pipeline.BindPipeline(commandBuffer);
+	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
+
+	auto frames = impostorType->GetFrames();
+
+	for (uint32_t y = 0; y < frames; y++)
+	{
+		for (uint32_t x = 0; x < frames; x++)
+		{
+			auto direction = impostorType->GetFrameDirection({ x, y });
+			auto [right, up] = ImpostorType::GetFrameBasis(direction);
+
+			BeginTile(commandBuffer, extent, { region.m_x + region.m_z * static_cast<float>(x) / static_cast<float>(frames),
+				region.m_y + region.m_w * static_cast<float>(y) / static_cast<float>(frames), region.m_z / static_cast<float>(frames), region.m_w / static_cast<float>(frames) });
+
+			m_pushObject.Push("centre", Vector4f(centre, radius));
+			m_pushObject.Push("right", Vector4f(right, 0.0f));
+			m_pushObject.Push("up", Vector4f(up, 0.0f));
+			m_pushObject.Push("forward", Vector4f(direction, 0.0f));
+			m_pushObject.Push("positionScale", Vector4f(model.GetQuantizeScale(), 0.0f));
+			m_pushObject.Push("positionOffset", Vector4f(model.GetQuantizeOffset(), 0.0f));
+			m_pushObject.Push("baseDiffuse", impostorType->GetBaseDiffuse());
+			m_pushObject.BindPush(commandBuffer, pipeline);
+
+			model.CmdRender(commandBuffer, 1, 0);
+		}
+	}
+
+	*freeRegion = impostorType;
+	impostorType->SetRegion(region);
+
+	// Restores the full render area for any subrenders after this one.
+	VkViewport viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(extent.m_x);
+	viewport.height = static_cast<float>(extent.m_y);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor = {};
+	scissor.offset = { 0, 0 };
+	scissor.extent = { extent.m_x, extent.m_y };
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+void SubrenderImpostors::BeginTile(const CommandBuffer &commandBuffer, const Vector2ui &extent, const Vector4f &tile)
+{
+	VkRect2D tileArea = {};
+	tileArea.offset = { static_cast<int32_t>(tile.m_x * extent.m_x), static_cast<int32_t>(tile.m_y * extent.m_y) };
+	tileArea.extent = { static_cast<uint32_t>(tile.m_z * extent.m_x), static_cast<uint32_t>(tile.m_w * extent.m_y) };
+
+	VkViewport viewport = {};
+	viewport.x = static_cast<float>(tileArea.offset.x);
+	viewport.y = static_cast<float>(tileArea.offset.y);
+	viewport.width = static_cast<float>(tileArea.extent.width);
+	viewport.height = static_cast<float>(tileArea.extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &tileArea);
+
+	// The preserved attachments are not cleared by the renderpass, so each frame is cleared before it is baked, uncovered texels keep a zero alpha.
+	std::array<VkClearAttachment, 3> clearAttachments = {};
+	clearAttachments[0].aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	clearAttachments[0].colorAttachment = 0;
+	clearAttachments[0].clearValue.color = { { 0.0f, 0.0f, 0.0f, 0.0f } };
+	clearAttachments[1].aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	clearAttachments[1].colorAttachment = 1;
+	clearAttachments[1].clearValue.color = { { 0.5f, 0.5f, 1.0f, 0.0f } };
+	clearAttachments[2].aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	clearAttachments[2].clearValue.depthStencil = { 1.0f, 0 };
+
+	VkClearRect clearRect = {};
+	clearRect.rect = tileArea;
+	clearRect.baseArrayLayer = 0;
+	clearRect.layerCount = 1;
+	vkCmdClearAttachments(commandBuffer, static_cast<uint32_t>(clearAttachments.size()), clearAttachments.data(), 1, &clearRect);
+}
+
+PipelineGraphics &SubrenderImpostors::GetPipeline(const ImpostorType &impostorType)
+{
+	auto quantized = impostorType.GetModel()->IsQuantized();
+	auto diffuseMapping = impostorType.GetImageDiffuse() != nullptr;
+	auto &pipeline = m_pipelines[{ quantized, diffuseMapping }];
+
+	if (pipeline == nullptr)
+	{
+		std::vector<Shader::Define> defines;
+		defines.emplace_back("QUANTIZED", String::To<int32_t>(quantized));
+		defines.emplace_back("DIFFUSE_MAPPING", String::To<int32_t>(diffuseMapping));
+		pipeline = std::make_unique<PipelineGraphics>(GetStage(), std::vector<std::string>{ "Shaders/Impostors/Bake.vert", "Shaders/Impostors/Bake.frag" },
+			std::vector<Shader::VertexInput>{ quantized ? VertexQuantized::GetVertexInput() : VertexDefault::GetVertexInput() }, defines, PipelineGraphics::Mode::Mrt,
+			PipelineGraphics::Depth::ReadWrite, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE);
+	}
+
+	return *pipeline;
+}
+
+bool SubrenderImpostors::IsAtlasKept()
+{
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+	auto attachment = renderStage->GetAttachment("impostorDiffuse");
+	auto atlas = Graphics::Get()->GetAttachment("impostorDiffuse");
+
+	// The attachments are recreated along with the framebuffers, which loses every baked impostor.
+	auto kept = attachment && attachment->IsPreserved() && atlas == m_lastAtlas;
+	m_lastAtlas = atlas;
+	return kept;
+}
+}
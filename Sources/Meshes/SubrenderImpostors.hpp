@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Maths/Vector4.hpp"
+#include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/PushHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "ImpostorType.hpp"
+
+namespace acid
+{
+/**
+ * @brief Bakes the frames of impostors into regions of the "impostorDiffuse" and "impostorNormal" attachments, drawn from by {@link SubrenderMeshes}.
+ * The stage should be drawn before the meshes, with both attachments preserved between frames and a depth attachment.
+ * One impostor is baked each frame, every impostor is baked again when the attachments are recreated.
+ */
+class ACID_EXPORT SubrenderImpostors :
+	public Subrender
+{
+public:
+	/**
+	 * Creates a new impostor baking subrender.
+	 * @param pipelineStage The stage the impostors are baked in.
+	 * @param regionSize The size in pixels of the region each impostor is baked into, the attachments are split into as many regions as fit.
+	 */
+	explicit SubrenderImpostors(const Pipeline::Stage &pipelineStage, const uint32_t &regionSize = 1024);
+
+	void Render(const CommandBuffer &commandBuffer) override;
+
+private:
+	/**
+	 * Sets the viewport and scissor to a frame of a region and clears it.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param extent The size of the attachments.
+	 * @param tile The offset (xy) and size (zw) of the frame, in the range of zero to one.
+	 */
+	static void BeginTile(const CommandBuffer &commandBuffer, const Vector2ui &extent, const Vector4f &tile);
+
+	/**
+	 * Gets the pipeline an impostor is baked with, created the first time it is used.
+	 * @param impostorType The impostor that will be baked.
+	 * @return The pipeline.
+	 */
+	PipelineGraphics &GetPipeline(const ImpostorType &impostorType);
+
+	/**
+	 * Gets if the baked regions from last frame are still in the attachments.
+	 * @return If the baked impostors can be reused.
+	 */
+	bool IsAtlasKept();
+
+	uint32_t m_regionSize;
+	// Pipelines by if the model is quantized and if it is baked with a diffuse image.
+	std::map<std::pair<bool, bool>, std::unique_ptr<PipelineGraphics>> m_pipelines;
+	DescriptorsHandler m_descriptorSet;
+	PushHandler m_pushObject;
+
+	std::vector<std::weak_ptr<ImpostorType>> m_regions;
+	const Descriptor *m_lastAtlas;
+};
+}
@@ -1,39 +1,648 @@
 ﻿#include "SubrenderMeshes.hpp"
 
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Descriptors/BindlessDescriptors.hpp"
+#include "Helpers/RadixSort.hpp"
+#include "Models/VertexDefault.hpp"
+#include "Physics/Rigidbody.hpp"
 #include "Scenes/Scenes.hpp"
 #include "MeshRender.hpp"
 
 namespace acid
 {
+static const uint32_t MIN_BATCH_INSTANCES = 256;
+static const uint32_t MIN_BATCHES = 32;
+// Each task shader workgroup culls this many meshlets, matching its local size.
+static const uint32_t TASK_MESHLETS = 32;
+
 SubrenderMeshes::SubrenderMeshes(const Pipeline::Stage &pipelineStage, const Sort &sort) :
 	Subrender(pipelineStage),
 	m_sort(sort),
-	m_uniformScene(true)
+	m_uniformScene(true),
+	m_instanceCount(0),
+	m_meshletCommandCount(0),
+	m_pipelineCull("Shaders/Culling/Cull.comp"),
+	m_descriptorCull(m_pipelineCull),
+	m_pipelineCullMeshlets("Shaders/Culling/Meshlets.comp"),
+	m_pyramidSource(nullptr)
 {
 }
 
+void SubrenderMeshes::PreRender(const CommandBuffer &commandBuffer)
+{
+	if (m_sort != Sort::None)
+	{
+		return;
+	}
+
+	if (UpdateBatches())
+	{
+		CmdCull(commandBuffer);
+	}
+
+	// Meshlets are culled within the instances the culling pass left visible.
+	CmdCullMeshlets(commandBuffer);
+}
+
 void SubrenderMeshes::Render(const CommandBuffer &commandBuffer)
 {
 	auto camera = Scenes::Get()->GetCamera();
-	m_uniformScene.Push("projection", camera->GetProjectionMatrix());
-	m_uniformScene.Push("view", camera->GetViewMatrix());
+	auto frameCount = Graphics::Get()->GetFrameCount();
+	auto viewCount = UpdateViews(*camera);
+
+	if (m_motionFrame != frameCount - 1 || m_previousViews.size() != viewCount)
+	{
+		m_previousProjections.resize(viewCount);
+		m_previousViews = m_views;
+
+		for (uint32_t i = 0; i < viewCount; i++)
+		{
+			m_previousProjections[i] = viewCount > 1 ? camera->GetProjectionMatrix(i) : camera->GetProjectionMatrix();
+		}
+	}
+
+	m_uniformScene.Push("projection", *m_projections.data(), sizeof(Matrix4) * viewCount);
+	m_uniformScene.Push("view", *m_views.data(), sizeof(Matrix4) * viewCount);
 	m_uniformScene.Push("cameraPos", camera->GetPosition());
+	m_uniformScene.Push("previousProjection", *m_previousProjections.data(), sizeof(Matrix4) * viewCount);
+	m_uniformScene.Push("previousView", *m_previousViews.data(), sizeof(Matrix4) * viewCount);
+	m_uniformScene.Push("jitter", camera->GetJitter());
+
+	for (uint32_t i = 0; i < viewCount; i++)
+	{
+		m_previousProjections[i] = viewCount > 1 ? camera->GetProjectionMatrix(i) : camera->GetProjectionMatrix();
+	}
 
-	auto sceneMeshRenders = Scenes::Get()->GetStructure()->QueryComponents<MeshRender>();
+	m_previousViews = m_views;
+	m_motionFrame = frameCount;
 
-	if (m_sort != Sort::None)
+	if (m_sort == Sort::None)
+	{
+		SortMeshes(m_unbatched);
+	}
+	else
+	{
+		auto meshRenders = Scenes::Get()->GetStructure()->QueryComponents<MeshRender>(FrameAllocator::Get());
+		auto pixelScale = GetLodPixelScale();
+
+		for (const auto &meshRender : meshRenders)
+		{
+			meshRender->UpdateLod(pixelScale);
+		}
+
+		CullMeshes(meshRenders);
+		SortMeshes(meshRenders);
+	}
+
+	// Meshes next to each other in the order often share a pipeline, it is only bound when it changes.
+	const PipelineMaterial *boundPipeline = nullptr;
+
+	for (const auto &sortItem : m_sortItems)
+	{
+		sortItem.m_meshRender->CmdRender(commandBuffer, m_uniformScene, GetStage(), &boundPipeline);
+	}
+
+	if (m_sort == Sort::None)
+	{
+		RenderBatches(commandBuffer);
+		RenderImpostors(commandBuffer);
+	}
+}
+
+uint32_t SubrenderMeshes::UpdateViews(const Camera &camera)
+{
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+	auto viewCount = renderStage != nullptr ? renderStage->GetViewCount() : 1;
+
+	// Multiview stages draw each view with its own matrices, other stages draw with the camera matrices.
+	m_projections.resize(viewCount);
+	m_views.resize(viewCount);
+
+	for (uint32_t i = 0; i < viewCount; i++)
+	{
+		m_projections[i] = viewCount > 1 ? camera.GetJitteredProjectionMatrix(i) : camera.GetJitteredProjectionMatrix();
+		m_views[i] = viewCount > 1 ? camera.GetViewMatrix(i) : camera.GetViewMatrix();
+	}
+
+	return viewCount;
+}
+
+void SubrenderMeshes::SortMeshes(const std::pmr::vector<MeshRender *> &meshRenders)
+{
+	auto cameraPosition = Scenes::Get()->GetCamera()->GetPosition();
+
+	// Pipelines and materials are given small ids in the order they are first seen this frame.
+	m_sortIds.clear();
+
+	auto getId = [this](const void *object) -> uint64_t
+	{
+		if (object == nullptr)
+		{
+			return 0;
+		}
+
+		return m_sortIds.try_emplace(object, static_cast<uint16_t>(m_sortIds.size() + 1)).first->second;
+	};
+
+	m_sortItems.clear();
+
+	for (const auto &meshRender : meshRenders)
+	{
+		auto material = meshRender->GetParent()->GetComponent<Material>();
+		auto pipelineId = getId(material != nullptr ? material->GetPipelineMaterial().get() : nullptr);
+		auto materialId = getId(material);
+
+		// The bits of a positive float sort in the same order as the float.
+		auto distance = (cameraPosition - meshRender->GetParent()->GetWorldTransform().GetPosition()).LengthSquared();
+		uint32_t depth;
+		std::memcpy(&depth, &distance, sizeof(uint32_t));
+
+		uint64_t key;
+
+		switch (m_sort)
+		{
+		case Sort::Back:
+			key = (static_cast<uint64_t>(~depth) << 32) | (pipelineId << 16) | materialId;
+			break;
+		case Sort::Front:
+			key = (static_cast<uint64_t>(depth) << 32) | (pipelineId << 16) | materialId;
+			break;
+		default:
+			key = (pipelineId << 48) | (materialId << 32) | depth;
+			break;
+		}
+
+		m_sortItems.emplace_back(SortItem{ key, meshRender });
+	}
+
+	RadixSort(m_sortItems, m_sortScratch, [](const SortItem &item)
+	{
+		return item.m_key;
+	});
+}
+
+void SubrenderMeshes::CullMeshes(std::pmr::vector<MeshRender *> &meshRenders)
+{
+	// Meshes without a rigidbody have no bounds and are always kept.
+	m_meshCuller.Clear();
+	m_meshBounded.clear();
+
+	for (uint32_t i = 0; i < meshRenders.size(); i++)
+	{
+		if (auto rigidbody = meshRenders[i]->GetParent()->GetComponent<Rigidbody>())
+		{
+			Vector3f min;
+			Vector3f max;
+			rigidbody->GetWorldAabb(min, max);
+			m_meshCuller.AddCube(min, max);
+			m_meshBounded.emplace_back(i);
+		}
+	}
+
+	if (m_meshBounded.empty())
+	{
+		return;
+	}
+
+	m_meshCuller.CullCubes(Scenes::Get()->GetCamera()->GetViewFrustum(), m_meshVisible);
+
+	// Both lists are ascending, culled meshes are cleared and then removed in one pass.
+	auto visible = m_meshVisible.begin();
+
+	for (uint32_t i = 0; i < m_meshBounded.size(); i++)
+	{
+		if (visible != m_meshVisible.end() && *visible == i)
+		{
+			++visible;
+			continue;
+		}
+
+		meshRenders[m_meshBounded[i]] = nullptr;
+	}
+
+	meshRenders.erase(std::remove(meshRenders.begin(), meshRenders.end(), nullptr), meshRenders.end());
+}
+
+float SubrenderMeshes::GetLodPixelScale() const
+{
+	auto extent = Graphics::Get()->GetRenderStage(GetStage().first)->GetRenderArea().GetExtent();
+	return Scenes::Get()->GetCamera()->GetProjectionMatrix()[1].m_y * static_cast<float>(extent.m_y) / 2.0f;
+}
+
+bool SubrenderMeshes::UpdateBatches()
+{
+	auto batchingSupported = Graphics::Get()->GetLogicalDevice()->GetEnabledFeatures().drawIndirectFirstInstance;
+	auto multiDrawSupported = Graphics::Get()->GetLogicalDevice()->GetEnabledFeatures().multiDrawIndirect;
+
+	m_unbatched.clear();
+	m_impostors.clear();
+
+	for (auto &[key, batch] : m_batches)
+	{
+		batch->m_instances.clear();
+	}
+
+	// Groups instanceable meshes into batches, everything else is drawn on its own.
+	MaterialInstance instance = {};
+	auto pixelScale = GetLodPixelScale();
+
+	for (const auto &meshRender : Scenes::Get()->GetStructure()->ViewComponents<MeshRender>())
+	{
+		meshRender->UpdateLod(pixelScale);
+
+		auto material = meshRender->GetParent()->GetComponent<Material>();
+		auto mesh = meshRender->GetParent()->GetComponent<Mesh>();
+
+		// Meshes far enough to be drawn as their impostor are drawn by the pass their material is drawn in.
+		if (meshRender->IsImpostor())
+		{
+			if (material != nullptr && material->GetPipelineMaterial() != nullptr && material->GetPipelineMaterial()->GetStage() == GetStage())
+			{
+				auto &impostor = meshRender->GetImpostor();
+				impostor->AddInstance(meshRender->GetParent()->GetWorldMatrix(), Scenes::Get()->GetCamera()->GetPosition());
+
+				if (std::find(m_impostors.begin(), m_impostors.end(), impostor) == m_impostors.end())
+				{
+					m_impostors.emplace_back(impostor);
+				}
+			}
+
+			continue;
+		}
+
+		if (!batchingSupported || material == nullptr || mesh == nullptr || material->GetPipelineInstanced() == nullptr || mesh->GetModel() == nullptr ||
+			mesh->GetModel()->GetIndexBuffer() == nullptr || material->GetPipelineInstanced()->GetStage() != GetStage() || !material->PushInstance(instance))
+		{
+			m_unbatched.emplace_back(meshRender);
+			continue;
+		}
+
+		// A mesh fading between levels is an instance in the batch of each level.
+		auto addInstance = [&](const uint32_t &lod, const float &lodFade)
+		{
+			auto &batch = m_batches[{ material->GetPipelineInstanced().get(), mesh->GetModel().get(), lod, material->GetInstanceKey() }];
+
+			if (batch == nullptr)
+			{
+				batch = std::make_unique<Batch>();
+				batch->m_pipelineMaterial = material->GetPipelineInstanced();
+				batch->m_model = mesh->GetModel();
+				batch->m_lod = lod;
+			}
+
+			instance.m_lodFade = lodFade;
+			batch->m_material = material;
+			batch->m_pipelineMeshlet = material->GetPipelineMeshlet();
+			batch->m_instances.emplace_back(instance);
+		};
+
+		if (auto lodNext = meshRender->GetLodNext())
+		{
+			auto fade = std::max(meshRender->GetLodFade(), 1e-3f);
+			addInstance(meshRender->GetLod(), fade);
+			addInstance(*lodNext, -fade);
+		}
+		else
+		{
+			addInstance(meshRender->GetLod(), 0.0f);
+		}
+	}
+
+	// Removes batches that are no longer drawn, and packs the instances of the remaining batches.
+	m_instanceCount = 0;
+	m_meshletCommandCount = 0;
+
+	for (auto it = m_batches.begin(); it != m_batches.end();)
 	{
-		std::sort(sceneMeshRenders.begin(), sceneMeshRenders.end());
+		if (it->second->m_instances.empty())
+		{
+			it = m_batches.erase(it);
+			continue;
+		}
+
+		auto &batch = *it->second;
+		batch.m_firstInstance = m_instanceCount;
+		m_instanceCount += static_cast<uint32_t>(batch.m_instances.size());
+
+		// Without mesh shaders each meshlet of each instance is given a draw command, which needs multiple indirect draws.
+		auto meshletCount = batch.m_model->GetMeshletCount();
+		batch.m_meshlets = batch.m_lod == 0 && meshletCount != 0 && (batch.m_pipelineMeshlet != nullptr || multiDrawSupported);
+
+		if (batch.m_meshlets && batch.m_pipelineMeshlet == nullptr)
+		{
+			batch.m_firstMeshletCommand = m_meshletCommandCount;
+			m_meshletCommandCount += meshletCount * static_cast<uint32_t>(batch.m_instances.size());
+		}
+
+		++it;
+	}
+
+	// Meshes drawn on their own are culled here, the depth pre-pass draws the same list.
+	CullMeshes(m_unbatched);
+
+	if (m_batches.empty())
+	{
+		return false;
+	}
+
+	if (m_instanceBuffer == nullptr || m_instanceBuffer->GetSize() < sizeof(MaterialInstance) * m_instanceCount)
+	{
+		auto capacity = std::max(2 * m_instanceCount, MIN_BATCH_INSTANCES);
+		m_instanceBuffer = std::make_unique<StorageBuffer>(sizeof(MaterialInstance) * capacity);
+		m_boundsBuffer = std::make_unique<StorageBuffer>(sizeof(Bounds) * capacity);
+		m_visibleBuffer = std::make_unique<StorageBuffer>(sizeof(uint32_t) * capacity);
+	}
+
+	if (m_indirectBuffer == nullptr || m_indirectBuffer->GetSize() < sizeof(VkDrawIndexedIndirectCommand) * m_batches.size())
+	{
+		m_indirectBuffer = std::make_unique<IndirectBuffer>(sizeof(VkDrawIndexedIndirectCommand) * std::max(2 * static_cast<uint32_t>(m_batches.size()), MIN_BATCHES));
+	}
+
+	if (m_meshletCommandCount != 0 && (m_meshletCommands == nullptr || m_meshletCommands->GetSize() < sizeof(VkDrawIndexedIndirectCommand) * m_meshletCommandCount))
+	{
+		m_meshletCommands = std::make_unique<IndirectBuffer>(sizeof(VkDrawIndexedIndirectCommand) * 2 * m_meshletCommandCount);
+	}
+
+	// Without a depth attachment to build the pyramid from every instance is drawn.
+	auto culling = dynamic_cast<const ImageDepth *>(Graphics::Get()->GetAttachment("depth")) != nullptr;
+
+	MaterialInstance *instances;
+	Bounds *bounds;
+	uint32_t *visible;
+	VkDrawIndexedIndirectCommand *commands;
+	m_instanceBuffer->MapMemory(reinterpret_cast<void **>(&instances));
+	m_boundsBuffer->MapMemory(reinterpret_cast<void **>(&bounds));
+	m_visibleBuffer->MapMemory(reinterpret_cast<void **>(&visible));
+	m_indirectBuffer->MapMemory(reinterpret_cast<void **>(&commands));
+	uint32_t batchIndex = 0;
+
+	for (const auto &[key, batch] : m_batches)
+	{
+		std::memcpy(instances + batch->m_firstInstance, batch->m_instances.data(), sizeof(MaterialInstance) * batch->m_instances.size());
+
+		auto &model = *batch->m_model;
+		auto centre = (model.GetMinExtents() + model.GetMaxExtents()) / 2.0f;
+		auto radius = (model.GetMaxExtents() - model.GetMinExtents()).Length() / 2.0f;
+
+		for (uint32_t i = 0; i < batch->m_instances.size(); i++)
+		{
+			auto &instanceBounds = bounds[batch->m_firstInstance + i];
+			instanceBounds.m_sphere = { centre.m_x, centre.m_y, centre.m_z, radius };
+			instanceBounds.m_batch = batchIndex;
+
+			if (!culling)
+			{
+				visible[batch->m_firstInstance + i] = batch->m_firstInstance + i;
+			}
+		}
+
+		// The culling pass counts visible instances up from zero.
+		auto lod = model.GetLod(batch->m_lod);
+		auto &command = commands[batchIndex++];
+		command.indexCount = lod.m_indexCount;
+		command.instanceCount = culling ? 0 : static_cast<uint32_t>(batch->m_instances.size());
+		command.firstIndex = model.GetFirstIndex() + lod.m_firstIndex;
+		command.vertexOffset = model.GetVertexOffset();
+		command.firstInstance = batch->m_firstInstance;
+	}
+
+	m_instanceBuffer->UnmapMemory();
+	m_boundsBuffer->UnmapMemory();
+	m_visibleBuffer->UnmapMemory();
+	m_indirectBuffer->UnmapMemory();
+	return culling;
+}
+
+void SubrenderMeshes::CmdCull(const CommandBuffer &commandBuffer)
+{
+	auto camera = Scenes::Get()->GetCamera();
+	auto depth = dynamic_cast<const ImageDepth *>(Graphics::Get()->GetAttachment("depth"));
+
+	// The depth image holds the last frames depth, a new depth image has not been rendered into yet so occlusion is skipped for a frame.
+	auto occlusion = false;
+
+	if (m_depthPyramid == nullptr || depth != m_pyramidSource || m_depthPyramid->GetExtent() != depth->GetExtent())
+	{
+		m_depthPyramid = std::make_unique<DepthPyramid>(depth->GetExtent());
+		m_pyramidSource = depth;
+	}
+	else
+	{
+		m_depthPyramid->Update(commandBuffer, *depth);
+		occlusion = true;
+	}
+
+	// Occlusion is tested with the camera the pyramids depth was rendered from.
+	m_uniformCulling.Push("previousViewProjection", m_previousViewProjection);
+	m_uniformCulling.Push("frustum", camera->GetViewFrustum().GetPlanes());
+	m_uniformCulling.Push("pyramidSize", Vector2f(static_cast<float>(m_depthPyramid->GetExtent().m_x), static_cast<float>(m_depthPyramid->GetExtent().m_y)));
+	m_uniformCulling.Push("pyramidLevels", static_cast<float>(m_depthPyramid->GetMipLevels()));
+	m_uniformCulling.Push("occlusion", occlusion ? 1.0f : 0.0f);
+	m_uniformCulling.Push("instanceCount", m_instanceCount);
+	m_previousViewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+
+	m_descriptorCull.Push("UniformCulling", m_uniformCulling);
+	m_descriptorCull.Push("BufferInstances", m_instanceBuffer);
+	m_descriptorCull.Push("BufferBounds", m_boundsBuffer);
+	m_descriptorCull.Push("BufferCommands", m_indirectBuffer);
+	m_descriptorCull.Push("BufferVisible", m_visibleBuffer);
+	m_descriptorCull.Push("samplerPyramid", m_depthPyramid);
+
+	if (!m_descriptorCull.Update(m_pipelineCull))
+	{
+		return;
+	}
+
+	m_pipelineCull.BindPipeline(commandBuffer);
+	m_descriptorCull.BindDescriptor(commandBuffer, m_pipelineCull);
+	m_pipelineCull.CmdRender(commandBuffer, { m_instanceCount, 1 });
+
+	// The draw commands and visible list are read by the indirect draws in the renderpass, and by the meshlet culling that follows.
+	VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+#if defined(VK_EXT_mesh_shader)
+	if (Graphics::Get()->GetLogicalDevice()->IsMeshShader())
+	{
+		dstStageMask |= VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT;
+	}
+#endif
+
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStageMask, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void SubrenderMeshes::CmdCullMeshlets(const CommandBuffer &commandBuffer)
+{
+	auto camera = Scenes::Get()->GetCamera();
+	auto dispatched = false;
+	uint32_t batchIndex = 0;
+
+	for (const auto &[key, batch] : m_batches)
+	{
+		auto index = batchIndex++;
 
-		if (m_sort == Sort::Front)
+		if (!batch->m_meshlets)
 		{
-			std::reverse(sceneMeshRenders.begin(), sceneMeshRenders.end());
+			continue;
+		}
+
+		auto &model = *batch->m_model;
+		batch->m_uniformMeshlets.Push("frustum", camera->GetViewFrustum().GetPlanes());
+		batch->m_uniformMeshlets.Push("cameraPos", camera->GetPosition());
+		batch->m_uniformMeshlets.Push("batch", index);
+		batch->m_uniformMeshlets.Push("meshletCount", model.GetMeshletCount());
+		batch->m_uniformMeshlets.Push("firstCommand", batch->m_firstMeshletCommand);
+		batch->m_uniformMeshlets.Push("firstIndex", model.GetFirstIndex());
+		batch->m_uniformMeshlets.Push("vertexOffset", model.GetVertexOffset());
+
+		// Mesh shaders cull their meshlets as they are drawn.
+		if (batch->m_pipelineMeshlet != nullptr)
+		{
+			continue;
+		}
+
+		batch->m_descriptorMeshlets.Push("UniformMeshlets", batch->m_uniformMeshlets);
+		batch->m_descriptorMeshlets.Push("BufferInstances", m_instanceBuffer);
+		batch->m_descriptorMeshlets.Push("BufferVisible", m_visibleBuffer);
+		batch->m_descriptorMeshlets.Push("BufferCommands", m_indirectBuffer);
+		batch->m_descriptorMeshlets.Push("BufferMeshlets", model.GetMeshletBuffer());
+		batch->m_descriptorMeshlets.Push("BufferMeshletCommands", m_meshletCommands);
+
+		if (!batch->m_descriptorMeshlets.Update(m_pipelineCullMeshlets))
+		{
+			continue;
+		}
+
+		if (!dispatched)
+		{
+			m_pipelineCullMeshlets.BindPipeline(commandBuffer);
+			dispatched = true;
+		}
+
+		batch->m_descriptorMeshlets.BindDescriptor(commandBuffer, m_pipelineCullMeshlets);
+		m_pipelineCullMeshlets.CmdRender(commandBuffer, { model.GetMeshletCount(), static_cast<uint32_t>(batch->m_instances.size()) });
+	}
+
+	if (!dispatched)
+	{
+		return;
+	}
+
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void SubrenderMeshes::RenderBatches(const CommandBuffer &commandBuffer)
+{
+	// Draws each batch, the instance buffer is shared and indexed with the batches first instance.
+	// Batches are ordered by pipeline, so each pipeline is bound once.
+	// Models in the same geometry heap share buffers, so they are only bound when the buffers change.
+	uint32_t batchIndex = 0;
+	const PipelineMaterial *boundPipeline = nullptr;
+	std::pair<const Buffer *, const Buffer *> boundBuffers;
+
+	for (const auto &[key, batch] : m_batches)
+	{
+		auto offset = sizeof(VkDrawIndexedIndirectCommand) * batchIndex++;
+		auto meshShading = batch->m_meshlets && batch->m_pipelineMeshlet != nullptr;
+		auto &pipelineMaterial = meshShading ? batch->m_pipelineMeshlet : batch->m_pipelineMaterial;
+
+		if (pipelineMaterial.get() != boundPipeline)
+		{
+			if (!pipelineMaterial->BindPipeline(commandBuffer))
+			{
+				continue;
+			}
+
+			boundPipeline = pipelineMaterial.get();
+		}
+
+		auto &pipeline = *pipelineMaterial->GetPipeline();
+
+		batch->m_descriptorSet.Push("UniformScene", m_uniformScene);
+		batch->m_descriptorSet.Push("BufferInstances", m_instanceBuffer);
+		batch->m_descriptorSet.Push("BufferVisible", m_visibleBuffer);
+
+		if (meshShading)
+		{
+			batch->m_descriptorSet.Push("UniformMeshlets", batch->m_uniformMeshlets);
+			batch->m_descriptorSet.Push("BufferCommands", m_indirectBuffer);
+			batch->m_descriptorSet.Push("BufferVertices", batch->m_model->GetVertexStorage());
+			batch->m_descriptorSet.Push("BufferMeshlets", batch->m_model->GetMeshletBuffer());
+			batch->m_descriptorSet.Push("BufferMeshletVertices", batch->m_model->GetMeshletVertexBuffer());
+			batch->m_descriptorSet.Push("BufferMeshletTriangles", batch->m_model->GetMeshletTriangleBuffer());
+		}
+
+		batch->m_material->PushDescriptors(batch->m_descriptorSet);
+
+		if (!batch->m_descriptorSet.Update(pipeline))
+		{
+			continue;
+		}
+
+		batch->m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
+
+		if (pipeline.GetShader()->IsBindless())
+		{
+			Graphics::Get()->GetBindlessDescriptors()->BindDescriptor(commandBuffer, pipeline);
+		}
+
+		// Task shaders read the instance count the culling pass wrote, so every slot the batch could draw is launched.
+		if (meshShading)
+		{
+			auto groupCountX = (batch->m_model->GetMeshletCount() + TASK_MESHLETS - 1) / TASK_MESHLETS;
+			Instance::FvkCmdDrawMeshTasksEXT(*Graphics::Get()->GetLogicalDevice(), commandBuffer, groupCountX, static_cast<uint32_t>(batch->m_instances.size()), 1);
+			continue;
+		}
+
+		auto buffers = std::make_pair(batch->m_model->GetVertexBuffer(), batch->m_model->GetIndexBuffer());
+
+		if (batch->m_meshlets)
+		{
+			// Meshlet batches draw from the commands the meshlet culling pass wrote, in a single multiple draw.
+			auto drawCount = batch->m_model->GetMeshletCount() * static_cast<uint32_t>(batch->m_instances.size());
+
+			if (batch->m_model->CmdRenderIndirect(commandBuffer, *m_meshletCommands, sizeof(VkDrawIndexedIndirectCommand) * batch->m_firstMeshletCommand,
+				buffers != boundBuffers, drawCount))
+			{
+				boundBuffers = buffers;
+			}
+
+			continue;
+		}
+
+		if (batch->m_model->CmdRenderIndirect(commandBuffer, *m_indirectBuffer, offset, buffers != boundBuffers))
+		{
+			boundBuffers = buffers;
 		}
 	}
+}
+
+void SubrenderMeshes::RenderImpostors(const CommandBuffer &commandBuffer)
+{
+	if (m_impostors.empty())
+	{
+		return;
+	}
+
+	if (m_pipelineImpostor == nullptr)
+	{
+		m_pipelineImpostor = std::make_unique<PipelineGraphics>(GetStage(), std::vector<std::string>{ "Shaders/Impostors/Impostor.vert", "Shaders/Impostors/Impostor.frag" },
+			std::vector<Shader::VertexInput>{ VertexDefault::GetVertexInput(0), ImpostorType::Instance::GetVertexInput(1) }, std::vector<Shader::Define>{},
+			PipelineGraphics::Mode::Mrt, PipelineGraphics::Depth::ReadWrite, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE);
+	}
+
+	m_pipelineImpostor->BindPipeline(commandBuffer);
 
-	for (const auto &meshRender : sceneMeshRenders)
+	for (const auto &impostor : m_impostors)
 	{
-		meshRender->CmdRender(commandBuffer, m_uniformScene, GetStage());
+		impostor->Update();
+		impostor->CmdRender(commandBuffer, *m_pipelineImpostor, m_uniformScene);
 	}
 }
 }
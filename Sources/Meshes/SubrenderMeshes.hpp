@@ -1,11 +1,23 @@
 ﻿#pragma once
 
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/IndirectBuffer.hpp"
+#include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Materials/Material.hpp"
+#include "Models/Model.hpp"
+#include "Physics/FrustumCuller.hpp"
+#include "Scenes/Camera.hpp"
+#include "DepthPyramid.hpp"
+#include "ImpostorType.hpp"
 
 namespace acid
 {
+class MeshRender;
+
 class ACID_EXPORT SubrenderMeshes :
 	public Subrender
 {
@@ -17,10 +29,145 @@ public:
 
 	explicit SubrenderMeshes(const Pipeline::Stage &pipelineStage, const Sort &sort = Sort::None);
 
+	void PreRender(const CommandBuffer &commandBuffer) override;
+
 	void Render(const CommandBuffer &commandBuffer) override;
 
 private:
+	friend class SubrenderDepth;
+
+	/**
+	 * @brief Meshes that share an instanced pipeline, model level of detail, and material descriptors, drawn with one indirect draw.
+	 */
+	class Batch
+	{
+	public:
+		std::shared_ptr<PipelineMaterial> m_pipelineMaterial;
+		std::shared_ptr<Model> m_model;
+		uint32_t m_lod = 0;
+		Material *m_material = nullptr;
+		DescriptorsHandler m_descriptorSet;
+		DescriptorsHandler m_descriptorDepth;
+		std::vector<MaterialInstance> m_instances;
+		uint32_t m_firstInstance = 0;
+		// Batches of models split into meshlets cull each meshlet, with mesh shaders when the material has a meshlet pipeline.
+		bool m_meshlets = false;
+		std::shared_ptr<PipelineMaterial> m_pipelineMeshlet;
+		uint32_t m_firstMeshletCommand = 0;
+		UniformHandler m_uniformMeshlets;
+		DescriptorsHandler m_descriptorMeshlets;
+	};
+
+	/**
+	 * @brief The local bounding sphere of an instance, and the batch whos draw command it is counted into when visible.
+	 */
+	class Bounds
+	{
+	public:
+		Vector4f m_sphere;
+		uint32_t m_batch;
+		uint32_t m_padding[3];
+	};
+
+	/**
+	 * @brief A mesh drawn on its own, with a key that orders it by depth, pipeline and material.
+	 */
+	class SortItem
+	{
+	public:
+		uint64_t m_key;
+		MeshRender *m_meshRender;
+	};
+
+	using BatchKey = std::tuple<const PipelineMaterial *, const Model *, uint32_t, std::size_t>;
+
+	/**
+	 * Updates the jittered projection and view matrices of each view the stage draws, the depth pre-pass is drawn with the same matrices.
+	 * @param camera The camera drawn from.
+	 * @return The number of views.
+	 */
+	uint32_t UpdateViews(const Camera &camera);
+
+	/**
+	 * Computes a sort key for each mesh once and radix sorts them. Sorted passes order by depth first, other passes group by pipeline and then material and draw front to back.
+	 * @param meshRenders The meshes to sort.
+	 */
+	void SortMeshes(const std::pmr::vector<MeshRender *> &meshRenders);
+
+	/**
+	 * Removes meshes whos rigidbody is outside the camera frustum, the boxes of every mesh are tested together.
+	 * @param meshRenders The meshes to cull, the order of the meshes kept is unchanged.
+	 */
+	void CullMeshes(std::pmr::vector<MeshRender *> &meshRenders);
+
+	/**
+	 * Gets the number of pixels a unit of size covers at a distance of one unit in this subrenders stage, used to select levels of detail.
+	 * @return The pixel scale.
+	 */
+	float GetLodPixelScale() const;
+
+	/**
+	 * Groups meshes into batches and uploads the instances and draw commands.
+	 * @return If the draw commands need to be filled by the culling pass.
+	 */
+	bool UpdateBatches();
+
+	/**
+	 * Records the culling pass, visible instances are compacted into the visible buffer and counted into the draw commands.
+	 * @param commandBuffer The command buffer to record into.
+	 */
+	void CmdCull(const CommandBuffer &commandBuffer);
+
+	/**
+	 * Updates the meshlet uniforms of meshlet batches, and records the meshlet culling pass of those drawn without mesh shaders.
+	 * Each meshlet of each instance slot is written a draw command, the commands of culled meshlets draw no instances.
+	 * @param commandBuffer The command buffer to record into.
+	 */
+	void CmdCullMeshlets(const CommandBuffer &commandBuffer);
+
+	void RenderBatches(const CommandBuffer &commandBuffer);
+
+	/**
+	 * Uploads and draws the instances of each impostor added while grouping batches.
+	 * @param commandBuffer The command buffer to record into.
+	 */
+	void RenderImpostors(const CommandBuffer &commandBuffer);
+
 	Sort m_sort;
 	UniformHandler m_uniformScene;
+	// The matrices of each view this frame, and of the last frame that meshes reproject into to write motion vectors.
+	std::vector<Matrix4> m_projections;
+	std::vector<Matrix4> m_views;
+	std::vector<Matrix4> m_previousProjections;
+	std::vector<Matrix4> m_previousViews;
+	std::optional<uint64_t> m_motionFrame;
+
+	std::map<BatchKey, std::unique_ptr<Batch>> m_batches;
+	// Kept across frames on the default memory resource, the sorted meshes of a frame come from the frame allocator.
+	std::pmr::vector<MeshRender *> m_unbatched;
+	std::vector<SortItem> m_sortItems;
+	std::vector<SortItem> m_sortScratch;
+	std::unordered_map<const void *, uint16_t> m_sortIds;
+	FrustumCuller m_meshCuller;
+	std::vector<uint32_t> m_meshBounded;
+	std::vector<uint32_t> m_meshVisible;
+	uint32_t m_instanceCount;
+	std::unique_ptr<StorageBuffer> m_instanceBuffer;
+	std::unique_ptr<StorageBuffer> m_boundsBuffer;
+	std::unique_ptr<StorageBuffer> m_visibleBuffer;
+	std::unique_ptr<IndirectBuffer> m_indirectBuffer;
+	uint32_t m_meshletCommandCount;
+	std::unique_ptr<IndirectBuffer> m_meshletCommands;
+	// Impostors drawn this frame, the pipeline is created once the first impostor is drawn.
+	std::vector<std::shared_ptr<ImpostorType>> m_impostors;
+	std::unique_ptr<PipelineGraphics> m_pipelineImpostor;
+
+	PipelineCompute m_pipelineCull;
+	DescriptorsHandler m_descriptorCull;
+	UniformHandler m_uniformCulling;
+	PipelineCompute m_pipelineCullMeshlets;
+	std::unique_ptr<DepthPyramid> m_depthPyramid;
+	const ImageDepth *m_pyramidSource;
+	Matrix4 m_previousViewProjection;
 };
 }
@@ -0,0 +1,589 @@
+#include "GltfFile.hpp"
+
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#define TINYGLTF_IMPLEMENTATION
+
+#include "tiny_gltf.h"
+#include "Engine/Engine.hpp"
+#include "Files/Files.hpp"
+#include "Files/FileSystem.hpp"
+#include "Maths/Quaternion.hpp"
+#include "Materials/MaterialDefault.hpp"
+
+namespace acid
+{
+// Images are kept encoded while the file is parsed, so they can be decoded in parallel with the primitives.
+static bool KeepImageData(tinygltf::Image *image, const int imageIndex, std::string *err, std::string *warn, int reqWidth, int reqHeight, const unsigned char *bytes,
+	int size, void *userData)
+{
+	image->image.assign(bytes, bytes + size);
+	image->as_is = true;
+	return true;
+}
+
+static float ReadComponent(const uint8_t *data, const int &componentType, const bool &normalized)
+{
+	switch (componentType)
+	{
+	case TINYGLTF_COMPONENT_TYPE_FLOAT:
+	{
+		float value;
+		std::memcpy(&value, data, sizeof(float));
+		return value;
+	}
+	case TINYGLTF_COMPONENT_TYPE_BYTE:
+	{
+		auto value = static_cast<float>(*reinterpret_cast<const int8_t *>(data));
+		return normalized ? std::max(value / 127.0f, -1.0f) : value;
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+	{
+		auto value = static_cast<float>(*data);
+		return normalized ? value / 255.0f : value;
+	}
+	case TINYGLTF_COMPONENT_TYPE_SHORT:
+	{
+		int16_t value;
+		std::memcpy(&value, data, sizeof(int16_t));
+		return normalized ? std::max(static_cast<float>(value) / 32767.0f, -1.0f) : static_cast<float>(value);
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+	{
+		uint16_t value;
+		std::memcpy(&value, data, sizeof(uint16_t));
+		return normalized ? static_cast<float>(value) / 65535.0f : static_cast<float>(value);
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+	{
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(uint32_t));
+		return static_cast<float>(value);
+	}
+	default:
+		return 0.0f;
+	}
+}
+
+/**
+ * Finds the bytes of each element of a accessor, checked against the size of its buffer.
+ * @return The first element and the stride between elements, or nullptr if the accessor has no data that can be read.
+ */
+static const uint8_t *GetAccessorData(const tinygltf::Model &model, const tinygltf::Accessor &accessor, std::size_t &stride)
+{
+	// Data that is only held compressed has no buffer view, sparse accessors are not supported by this version of tinygltf.
+	if (accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(model.bufferViews.size()) || accessor.sparse.isSparse)
+	{
+		return nullptr;
+	}
+
+	const auto &bufferView = model.bufferViews[accessor.bufferView];
+
+	if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(model.buffers.size()))
+	{
+		return nullptr;
+	}
+
+	const auto &buffer = model.buffers[bufferView.buffer];
+	auto byteStride = accessor.ByteStride(bufferView);
+	auto componentSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+	auto componentCount = tinygltf::GetTypeSizeInBytes(static_cast<uint32_t>(accessor.type));
+
+	if (byteStride <= 0 || componentSize <= 0 || componentCount <= 0 || accessor.count == 0)
+	{
+		return nullptr;
+	}
+
+	// Meshopt compressed views read from a fallback buffer, which is empty when the file only holds the compressed data.
+	auto offset = bufferView.byteOffset + accessor.byteOffset;
+	auto end = offset + static_cast<std::size_t>(byteStride) * (accessor.count - 1) + static_cast<std::size_t>(componentSize * componentCount);
+
+	if (end > buffer.data.size() || end > bufferView.byteOffset + bufferView.byteLength)
+	{
+		return nullptr;
+	}
+
+	stride = static_cast<std::size_t>(byteStride);
+	return buffer.data.data() + offset;
+}
+
+static bool ReadFloats(const tinygltf::Model &model, const int &accessorIndex, const uint32_t &components, std::vector<float> &values)
+{
+	if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size()))
+	{
+		return false;
+	}
+
+	const auto &accessor = model.accessors[accessorIndex];
+	std::size_t stride;
+	auto data = GetAccessorData(model, accessor, stride);
+
+	if (data == nullptr)
+	{
+		return false;
+	}
+
+	auto componentSize = static_cast<std::size_t>(tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType)));
+	auto componentCount = static_cast<uint32_t>(tinygltf::GetTypeSizeInBytes(static_cast<uint32_t>(accessor.type)));
+	values.resize(accessor.count * components);
+
+	for (std::size_t i = 0; i < accessor.count; i++)
+	{
+		for (uint32_t c = 0; c < components; c++)
+		{
+			values[i * components + c] = c < componentCount ? ReadComponent(data + i * stride + c * componentSize, accessor.componentType, accessor.normalized) : 0.0f;
+		}
+	}
+
+	return true;
+}
+
+static bool ReadIndices(const tinygltf::Model &model, const int &accessorIndex, std::vector<uint32_t> &indices)
+{
+	if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size()))
+	{
+		return false;
+	}
+
+	const auto &accessor = model.accessors[accessorIndex];
+	std::size_t stride;
+	auto data = GetAccessorData(model, accessor, stride);
+
+	if (data == nullptr)
+	{
+		return false;
+	}
+
+	indices.resize(accessor.count);
+
+	for (std::size_t i = 0; i < accessor.count; i++)
+	{
+		switch (accessor.componentType)
+		{
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+			indices[i] = data[i * stride];
+			break;
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		{
+			uint16_t index;
+			std::memcpy(&index, data + i * stride, sizeof(uint16_t));
+			indices[i] = index;
+			break;
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+			std::memcpy(&indices[i], data + i * stride, sizeof(uint32_t));
+			break;
+		default:
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static std::optional<GltfFile::Geometry> BuildGeometry(const tinygltf::Model &model, const tinygltf::Primitive &primitive, const std::string &filename)
+{
+	if (primitive.mode != TINYGLTF_MODE_TRIANGLES)
+	{
+		Log::Warning("GLTF primitive in '%s' is not a triangle list, it is skipped\n", filename.c_str());
+		return std::nullopt;
+	}
+
+	auto attribute = [&primitive](const std::string &name)
+	{
+		auto it = primitive.attributes.find(name);
+		return it != primitive.attributes.end() ? it->second : -1;
+	};
+
+	std::vector<float> positions;
+
+	if (!ReadFloats(model, attribute("POSITION"), 3, positions))
+	{
+		if (primitive.extensions.find("KHR_draco_mesh_compression") != primitive.extensions.end())
+		{
+			Log::Warning("GLTF primitive in '%s' is Draco compressed, tinygltf must be built with TINYGLTF_ENABLE_DRACO to decode it\n", filename.c_str());
+		}
+		else
+		{
+			Log::Warning("GLTF primitive in '%s' has no readable positions, it is skipped\n", filename.c_str());
+		}
+
+		return std::nullopt;
+	}
+
+	auto vertexCount = static_cast<uint32_t>(positions.size() / 3);
+	std::vector<float> normals;
+	std::vector<float> uvs;
+	auto hasNormals = ReadFloats(model, attribute("NORMAL"), 3, normals) && normals.size() == positions.size();
+	auto hasUvs = ReadFloats(model, attribute("TEXCOORD_0"), 2, uvs) && uvs.size() / 2 == vertexCount;
+
+	GltfFile::Geometry geometry;
+
+	if (primitive.indices >= 0)
+	{
+		if (!ReadIndices(model, primitive.indices, geometry.m_indices))
+		{
+			Log::Warning("GLTF primitive in '%s' has no readable indices, it is skipped\n", filename.c_str());
+			return std::nullopt;
+		}
+
+	}
+	else
+	{
+		geometry.m_indices.resize(vertexCount);
+		std::iota(geometry.m_indices.begin(), geometry.m_indices.end(), 0);
+	}
+
+	// Triangles that reference vertices past the end of the primitive are dropped.
+	std::size_t kept = 0;
+
+	for (std::size_t i = 0; i + 2 < geometry.m_indices.size(); i += 3)
+	{
+		if (geometry.m_indices[i] < vertexCount && geometry.m_indices[i + 1] < vertexCount && geometry.m_indices[i + 2] < vertexCount)
+		{
+			std::copy(geometry.m_indices.begin() + i, geometry.m_indices.begin() + i + 3, geometry.m_indices.begin() + kept);
+			kept += 3;
+		}
+	}
+
+	geometry.m_indices.resize(kept);
+
+	// Primitives without normals are given area weighted normals of their triangles.
+	if (!hasNormals)
+	{
+		normals.assign(positions.size(), 0.0f);
+
+		for (std::size_t i = 0; i < geometry.m_indices.size(); i += 3)
+		{
+			auto i0 = geometry.m_indices[i], i1 = geometry.m_indices[i + 1], i2 = geometry.m_indices[i + 2];
+			auto p0 = Vector3f(positions[3 * i0], positions[3 * i0 + 1], positions[3 * i0 + 2]);
+			auto p1 = Vector3f(positions[3 * i1], positions[3 * i1 + 1], positions[3 * i1 + 2]);
+			auto p2 = Vector3f(positions[3 * i2], positions[3 * i2 + 1], positions[3 * i2 + 2]);
+			auto normal = (p1 - p0).Cross(p2 - p0);
+
+			for (auto index : { i0, i1, i2 })
+			{
+				normals[3 * index] += normal.m_x;
+				normals[3 * index + 1] += normal.m_y;
+				normals[3 * index + 2] += normal.m_z;
+			}
+		}
+	}
+
+	geometry.m_vertices.reserve(vertexCount);
+
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		auto position = Vector3f(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+		auto uv = hasUvs ? Vector2f(uvs[2 * i], uvs[2 * i + 1]) : Vector2f();
+		auto normal = Vector3f(normals[3 * i], normals[3 * i + 1], normals[3 * i + 2]);
+		geometry.m_vertices.emplace_back(position, uv, normal.Length() > 0.0f ? normal.Normalize() : Vector3f::Up);
+	}
+
+	return geometry;
+}
+
+static Matrix4 GetNodeMatrix(const tinygltf::Node &node)
+{
+	// GLTF matrices are column major, as are the rows of a Matrix4.
+	if (node.matrix.size() == 16)
+	{
+		float source[16];
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			source[i] = static_cast<float>(node.matrix[i]);
+		}
+
+		return Matrix4(source);
+	}
+
+	auto result = Matrix4();
+
+	if (node.translation.size() == 3)
+	{
+		result = result.Translate(Vector3f(static_cast<float>(node.translation[0]), static_cast<float>(node.translation[1]), static_cast<float>(node.translation[2])));
+	}
+
+	if (node.rotation.size() == 4)
+	{
+		result = result * Quaternion(static_cast<float>(node.rotation[0]), static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2]),
+			static_cast<float>(node.rotation[3])).ToMatrix();
+	}
+
+	if (node.scale.size() == 3)
+	{
+		result = result.Scale(Vector3f(static_cast<float>(node.scale[0]), static_cast<float>(node.scale[1]), static_cast<float>(node.scale[2])));
+	}
+
+	return result;
+}
+
+static void AddInstances(const tinygltf::Model &model, const int &nodeIndex, const Matrix4 &parent, const uint32_t &depth, std::vector<GltfFile::Instance> &instances)
+{
+	// Node graphs must be trees, the depth stops files with cycles from recursing forever.
+	if (nodeIndex < 0 || nodeIndex >= static_cast<int>(model.nodes.size()) || depth > model.nodes.size())
+	{
+		return;
+	}
+
+	const auto &node = model.nodes[nodeIndex];
+	auto transform = parent * GetNodeMatrix(node);
+
+	if (node.mesh >= 0 && node.mesh < static_cast<int>(model.meshes.size()))
+	{
+		instances.emplace_back(GltfFile::Instance{ static_cast<uint32_t>(node.mesh), transform });
+	}
+
+	for (const auto &child : node.children)
+	{
+		AddInstances(model, child, transform, depth + 1, instances);
+	}
+}
+
+MaterialDefault *GltfFile::Material::CreateComponent() const
+{
+	return new MaterialDefault(m_baseDiffuse, m_imageDiffuse, m_metallic, m_roughness, nullptr, m_imageNormal);
+}
+
+GltfFile::GltfFile(std::string filename, const bool &createModels) :
+	m_filename(std::move(filename)),
+	m_loaded(false)
+{
+#if defined(ACID_VERBOSE)
+	auto debugStart = Engine::GetTime();
+#endif
+
+	auto folder = FileSystem::ParentDirectory(m_filename);
+	auto fileLoaded = Files::ReadView(m_filename);
+
+	if (!fileLoaded)
+	{
+		Log::Error("GLTF file could not be loaded: '%s'\n", m_filename.c_str());
+		return;
+	}
+
+	tinygltf::Model gltfModel;
+	tinygltf::TinyGLTF gltfContext;
+	gltfContext.SetImageLoader(KeepImageData, nullptr);
+	std::string warn, err;
+
+	if (String::Lowercase(FileSystem::FileSuffix(m_filename)) == ".glb")
+	{
+		if (!gltfContext.LoadBinaryFromMemory(&gltfModel, &err, &warn, fileLoaded->GetData(), static_cast<uint32_t>(fileLoaded->GetSize())))
+		{
+			throw std::runtime_error(warn + err);
+		}
+	}
+	else
+	{
+		if (!gltfContext.LoadASCIIFromString(&gltfModel, &err, &warn, fileLoaded->GetString().data(), static_cast<uint32_t>(fileLoaded->GetSize()), folder))
+		{
+			throw std::runtime_error(warn + err);
+		}
+	}
+
+	for (const auto &extension : gltfModel.extensionsRequired)
+	{
+		if (extension == "EXT_meshopt_compression")
+		{
+			Log::Warning("GLTF file '%s' requires meshopt decoding, primitives without a uncompressed fallback are skipped\n", m_filename.c_str());
+		}
+	}
+
+	// Materials only load the images they use, encoded images are decoded with the primitives.
+	std::vector<std::shared_ptr<Image2d>> images(gltfModel.images.size());
+	std::vector<uint32_t> decodes;
+
+	auto getImage = [&](const tinygltf::ParameterMap &values, const std::string &name) -> std::optional<uint32_t>
+	{
+		auto it = values.find(name);
+
+		if (it == values.end())
+		{
+			return std::nullopt;
+		}
+
+		auto texture = it->second.TextureIndex();
+
+		if (texture < 0 || texture >= static_cast<int>(gltfModel.textures.size()))
+		{
+			return std::nullopt;
+		}
+
+		auto source = gltfModel.textures[texture].source;
+
+		if (source < 0 || source >= static_cast<int>(gltfModel.images.size()))
+		{
+			return std::nullopt;
+		}
+
+		auto &image = gltfModel.images[source];
+
+		if (images[source] == nullptr && std::find(decodes.begin(), decodes.end(), source) == decodes.end())
+		{
+			if (!image.image.empty())
+			{
+				decodes.emplace_back(source);
+			}
+			else if (!image.uri.empty())
+			{
+				images[source] = Image2d::Create(FileSystem::JoinPath({ folder, image.uri }), VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, true, true, true);
+			}
+		}
+
+		return static_cast<uint32_t>(source);
+	};
+
+	std::vector<std::pair<std::optional<uint32_t>, std::optional<uint32_t>>> materialImages;
+
+	for (const auto &gltfMaterial : gltfModel.materials)
+	{
+		auto &material = m_materials.emplace_back();
+		material.m_name = gltfMaterial.name;
+
+		if (auto it = gltfMaterial.values.find("baseColorFactor"); it != gltfMaterial.values.end())
+		{
+			auto colour = it->second.ColorFactor();
+			material.m_baseDiffuse = Colour(static_cast<float>(colour[0]), static_cast<float>(colour[1]), static_cast<float>(colour[2]), static_cast<float>(colour[3]));
+		}
+
+		if (auto it = gltfMaterial.values.find("metallicFactor"); it != gltfMaterial.values.end())
+		{
+			material.m_metallic = static_cast<float>(it->second.Factor());
+		}
+
+		if (auto it = gltfMaterial.values.find("roughnessFactor"); it != gltfMaterial.values.end())
+		{
+			material.m_roughness = static_cast<float>(it->second.Factor());
+		}
+
+		materialImages.emplace_back(getImage(gltfMaterial.values, "baseColorTexture"), getImage(gltfMaterial.additionalValues, "normalTexture"));
+	}
+
+	for (uint32_t mesh = 0; mesh < gltfModel.meshes.size(); mesh++)
+	{
+		for (const auto &gltfPrimitive : gltfModel.meshes[mesh].primitives)
+		{
+			auto &primitive = m_primitives.emplace_back();
+			primitive.m_mesh = mesh;
+
+			if (gltfPrimitive.material >= 0 && gltfPrimitive.material < static_cast<int>(m_materials.size()))
+			{
+				primitive.m_material = static_cast<uint32_t>(gltfPrimitive.material);
+			}
+		}
+	}
+
+	// Every primitive and embedded image is built as its own job, models are optimized and uploaded from the workers.
+	std::vector<const tinygltf::Primitive *> gltfPrimitives;
+
+	for (const auto &mesh : gltfModel.meshes)
+	{
+		for (const auto &gltfPrimitive : mesh.primitives)
+		{
+			gltfPrimitives.emplace_back(&gltfPrimitive);
+		}
+	}
+
+	class Decoded
+	{
+	public:
+		std::unique_ptr<uint8_t[]> m_pixels;
+		Vector2ui m_extent;
+		uint32_t m_components = 0;
+		VkFormat m_format = VK_FORMAT_UNDEFINED;
+	};
+
+	std::vector<Decoded> decoded(decodes.size());
+	// Not a vector of bool, each job writes its own element.
+	std::vector<uint8_t> built(gltfPrimitives.size(), 0);
+
+	Engine::Get()->GetThreadPool().ParallelFor(0, gltfPrimitives.size() + decodes.size(), [&](const std::size_t &i)
+	{
+		if (i >= gltfPrimitives.size())
+		{
+			auto &image = gltfModel.images[decodes[i - gltfPrimitives.size()]];
+			auto &result = decoded[i - gltfPrimitives.size()];
+			result.m_pixels = Image::DecodePixels(image.image.data(), image.image.size(), result.m_extent, result.m_components, result.m_format);
+			return;
+		}
+
+		auto geometry = BuildGeometry(gltfModel, *gltfPrimitives[i], m_filename);
+
+		if (!geometry)
+		{
+			return;
+		}
+
+		if (createModels)
+		{
+			m_primitives[i].m_model = std::make_shared<Model>(geometry->m_vertices, geometry->m_indices);
+		}
+		else
+		{
+			m_primitives[i].m_geometry = std::move(*geometry);
+		}
+
+		built[i] = 1;
+	}, 1);
+
+	for (uint32_t i = 0; i < decodes.size(); i++)
+	{
+		if (decoded[i].m_pixels == nullptr)
+		{
+			Log::Error("GLTF image %i in '%s' could not be decoded\n", decodes[i], m_filename.c_str());
+			continue;
+		}
+
+		images[decodes[i]] = std::make_shared<Image2d>(decoded[i].m_extent, std::move(decoded[i].m_pixels), decoded[i].m_format, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLE_COUNT_1_BIT, true, true);
+	}
+
+	for (uint32_t i = 0; i < m_materials.size(); i++)
+	{
+		auto [diffuse, normal] = materialImages[i];
+		m_materials[i].m_imageDiffuse = diffuse ? images[*diffuse] : nullptr;
+		m_materials[i].m_imageNormal = normal ? images[*normal] : nullptr;
+	}
+
+	// Primitives that could not be read are removed once every job has finished.
+	std::size_t kept = 0;
+
+	for (std::size_t i = 0; i < m_primitives.size(); i++)
+	{
+		if (built[i] != 0)
+		{
+			m_primitives[kept++] = std::move(m_primitives[i]);
+		}
+	}
+
+	m_primitives.resize(kept);
+
+	if (gltfModel.scenes.empty())
+	{
+		for (uint32_t mesh = 0; mesh < gltfModel.meshes.size(); mesh++)
+		{
+			m_instances.emplace_back(Instance{ mesh, Matrix4() });
+		}
+	}
+	else
+	{
+		const auto &scene = gltfModel.scenes[gltfModel.defaultScene >= 0 && gltfModel.defaultScene < static_cast<int>(gltfModel.scenes.size()) ? gltfModel.defaultScene : 0];
+
+		for (const auto &node : scene.nodes)
+		{
+			AddInstances(gltfModel, node, Matrix4(), 0, m_instances);
+		}
+	}
+
+	m_loaded = true;
+
+#if defined(ACID_VERBOSE)
+	auto debugEnd = Engine::GetTime();
+	Log::Out("GLTF file '%s' loaded %i primitives in %.3fms\n", m_filename.c_str(), static_cast<int32_t>(m_primitives.size()),
+		(debugEnd - debugStart).AsMilliseconds<float>());
+#endif
+}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Colour.hpp"
+#include "Maths/Matrix4.hpp"
+#include "Models/Model.hpp"
+#include "Models/VertexDefault.hpp"
+#include "Graphics/Images/Image2d.hpp"
+
+namespace acid
+{
+class MaterialDefault;
+
+/**
+ * @brief Class that loads every mesh primitive and material of a GLTF file, the file is parsed once and primitives are built in parallel on the engines job system.
+ * Images stored next to the file are streamed in the background, embedded images are decoded with the primitives.
+ * Buffers compressed with Draco are read once tinygltf has decoded them, meshopt compressed buffers are read through their uncompressed fallback.
+ */
+class ACID_EXPORT GltfFile :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief The vertices and indices of a primitive, in the space of its mesh.
+	 */
+	class Geometry
+	{
+	public:
+		std::vector<VertexDefault> m_vertices;
+		std::vector<uint32_t> m_indices;
+	};
+
+	/**
+	 * @brief A triangle primitive of a mesh in the file.
+	 */
+	class Primitive
+	{
+	public:
+		uint32_t m_mesh = 0;
+		std::optional<uint32_t> m_material;
+		// Only set when the file was loaded with models.
+		std::shared_ptr<Model> m_model;
+		// Only set when the file was loaded without models.
+		Geometry m_geometry;
+	};
+
+	/**
+	 * @brief The metallic roughness values of a material in the file.
+	 */
+	class Material
+	{
+	public:
+		/**
+		 * Creates a default material with the values of this material, ownership passes to the caller such as {@link Entity#AddComponent}.
+		 * The metallic roughness texture is not used, its channels are laid out differently to the material images of {@link MaterialDefault}.
+		 * @return The material component.
+		 */
+		MaterialDefault *CreateComponent() const;
+
+		std::string m_name;
+		Colour m_baseDiffuse = Colour::White;
+		float m_metallic = 1.0f;
+		float m_roughness = 1.0f;
+		std::shared_ptr<Image2d> m_imageDiffuse;
+		std::shared_ptr<Image2d> m_imageNormal;
+	};
+
+	/**
+	 * @brief A node of the default scene that draws a mesh.
+	 */
+	class Instance
+	{
+	public:
+		uint32_t m_mesh = 0;
+		Matrix4 m_transform;
+	};
+
+	/**
+	 * Loads a GLTF file.
+	 * @param filename The file to load.
+	 * @param createModels If a model is created for each primitive, otherwise the geometry of each primitive is kept for the caller.
+	 */
+	explicit GltfFile(std::string filename, const bool &createModels = true);
+
+	bool IsLoaded() const { return m_loaded; }
+
+	const std::string &GetFilename() const { return m_filename; }
+
+	const std::vector<Primitive> &GetPrimitives() const { return m_primitives; }
+
+	std::vector<Primitive> &GetPrimitives() { return m_primitives; }
+
+	const std::vector<Material> &GetMaterials() const { return m_materials; }
+
+	/**
+	 * Gets the meshes drawn by the default scene, with the world transform of each node. Files without a scene draw every mesh once.
+	 * @return The instances.
+	 */
+	const std::vector<Instance> &GetInstances() const { return m_instances; }
+
+private:
+	std::string m_filename;
+	bool m_loaded;
+	std::vector<Primitive> m_primitives;
+	std::vector<Material> m_materials;
+	std::vector<Instance> m_instances;
+};
+}
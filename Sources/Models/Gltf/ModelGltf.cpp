@@ -1,30 +1,19 @@
 #include "ModelGltf.hpp"
 
-#define TINYGLTF_NO_STB_IMAGE
-#define TINYGLTF_NO_STB_IMAGE_WRITE
-#define TINYGLTF_IMPLEMENTATION
-
-#include "tiny_gltf.h"
-#include "Files/FileSystem.hpp"
 #include "Resources/Resources.hpp"
-#include "Models/VertexDefault.hpp"
+#include "GltfFile.hpp"
 
 namespace acid
 {
 std::shared_ptr<ModelGltf> ModelGltf::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ModelGltf>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ModelGltf>(resource);
-	}
-
-	auto result = std::make_shared<ModelGltf>("");
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ModelGltf>("");
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<ModelGltf> ModelGltf::Create(const std::string &filename)
@@ -51,86 +40,45 @@ void ModelGltf::Load()
 		return;
 	}
 
-#if defined(ACID_VERBOSE)
-	auto debugStart = Engine::GetTime();
-#endif
+	GltfFile file(m_filename, false);
 
-	auto folder = FileSystem::ParentDirectory(m_filename);
-	auto fileLoaded = Files::Read(m_filename);
-
-	if (!fileLoaded)
+	if (!file.IsLoaded())
 	{
-
-		Log::Error("GLTF file could not be loaded: '%s'\n", m_filename.c_str());
 		return;
 	}
 
-	tinygltf::Model gltfModel;
-	tinygltf::TinyGLTF gltfContext;
-	std::string warn, err;
-
-	if (String::Lowercase(FileSystem::FileSuffix(m_filename)) == ".glb")
-	{
-		if (!gltfContext.LoadBinaryFromMemory(&gltfModel, &err, &warn, reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size())))
-		{
-			throw std::runtime_error(warn + err);
-		}
-	}
-	else
-	{
-		if (!gltfContext.LoadASCIIFromString(&gltfModel, &err, &warn, fileLoaded->c_str(), static_cast<uint32_t>(fileLoaded->size()), folder))
-		{
-			throw std::runtime_error(warn + err);
-		}
-	}
-
+	// Every instance in the default scene is merged into one model, in the space of the scene.
 	std::vector<VertexDefault> vertices;
 	std::vector<uint32_t> indices;
-	std::unordered_map<VertexDefault, size_t> uniqueVertices;
-
-	//LoadTextureSamplers(gltfModel);
-	//LoadTextures(gltfModel);
-	//LoadMaterials(gltfModel);
-	float scale = 1.0f;
-
-	// TODO: Scene handling with no default scene.
-	/*const tinygltf::Scene &scene = gltfModel.scenes[gltfModel.defaultScene > -1 ? gltfModel.defaultScene : 0];
-
-	for (size_t i = 0; i < scene.nodes.size(); i++)
-	{
-		const tinygltf::Node node = gltfModel.nodes[scene.nodes[i]];
-		LoadNode(nullptr, node, scene.nodes[i], gltfModel, indices, vertices, scale);
-	}
 
-	if (gltfModel.animations.size() > 0)
+	for (const auto &instance : file.GetInstances())
 	{
-		LoadAnimations(gltfModel);
-	}
-
-	LoadSkins(gltfModel);
+		auto normalMatrix = instance.m_transform.Inverse().Transpose();
 
-	for (auto node : linearNodes) {
-		// Assign skins.
-		if (node->skinIndex > -1)
+		for (const auto &primitive : file.GetPrimitives())
 		{
-			node->skin = skins[node->skinIndex];
-		}
-
-		// Initial pose.
-		if (node->mesh)
-		{
-			node->update();
+			if (primitive.m_mesh != instance.m_mesh)
+			{
+				continue;
+			}
+
+			auto firstVertex = static_cast<uint32_t>(vertices.size());
+
+			for (const auto &vertex : primitive.m_geometry.m_vertices)
+			{
+				auto position = instance.m_transform.Transform(Vector4f(vertex.m_position, 1.0f));
+				auto normal = Vector3f(normalMatrix.Transform(Vector4f(vertex.m_normal, 0.0f)));
+				vertices.emplace_back(Vector3f(position), vertex.m_uv, normal.Length() > 0.0f ? normal.Normalize() : vertex.m_normal);
+			}
+
+			for (const auto &index : primitive.m_geometry.m_indices)
+			{
+				indices.emplace_back(firstVertex + index);
+			}
 		}
 	}
 
-	auto extensions = gltfModel.extensionsUsed;*/
-
-#if defined(ACID_VERBOSE)
-	auto debugEnd = Engine::GetTime();
-	Log::Out("Model GLTF '%s' loaded in %.3fms\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
-#endif
-
-	Initialize(vertices, indices);
+	Initialize(std::move(vertices), std::move(indices));
 }
 
 const Metadata &operator>>(const Metadata &metadata, ModelGltf &model)
@@ -6,7 +6,8 @@
 namespace acid
 {
 /**
- * @brief Resource that represents a GLTF model.
+ * @brief Resource that represents a GLTF model, the meshes of the default scene are merged into one model.
+ * Use a {@link GltfFile} to load each primitive as its own model along with its material.
  */
 class ACID_EXPORT ModelGltf :
 	public Model
@@ -1,10 +1,25 @@
 #include "Model.hpp"
 
+#include <limits>
+#include <set>
+#include "Graphics/Buffers/AccelerationStructure.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
+#include "Graphics/Graphics.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Resources/Resources.hpp"
+#include "VertexQuantized.hpp"
 
 namespace acid
 {
+// The cells of the first simplified level, as a fraction of the diagonal of the model. Each level after it doubles the cell size.
+static const float LOD_FIRST_CELL = 1.0f / 64.0f;
+// A level is only kept when it has at most this share of the triangles of the level before it.
+static const float LOD_REDUCTION = 0.75f;
+// Convex hulls gain little from more points, and building them is quadratic in the worst case.
+static const uint32_t HULL_POINT_LIMIT = 1024;
+// Models with fewer triangles are culled well enough as a whole, and their meshlets would cost more memory than culling saves.
+static const uint32_t MESHLET_MIN_TRIANGLES = 1 << 16;
+
 std::shared_ptr<Model> Model::Create(const Metadata &metadata)
 {
 	return Scenes::Get()->GetModelRegister().Create(metadata);
@@ -16,71 +31,483 @@ std::shared_ptr<Model> Model::Create(const std::string &filename)
 }
 
 Model::Model() :
+	m_quantized(false),
+	m_lodCount(0),
 	m_vertexBuffer(nullptr),
 	m_indexBuffer(nullptr),
 	m_vertexCount(0),
+	m_vertexSize(0),
 	m_indexCount(0),
-	m_radius(0.0f)
+	m_indexType(VK_INDEX_TYPE_UINT32),
+	m_meshletCount(0),
+	m_radius(0.0f),
+	m_quantizeScale(1.0f)
+{
+}
+
+Model::~Model()
+{
+	ReleaseBuffers();
+}
+
+std::size_t Model::GetCpuSize() const
 {
+	return m_hullPoints.size() * sizeof(Vector3f) + m_lods.size() * sizeof(Lod);
 }
 
-bool Model::CmdRender(const CommandBuffer &commandBuffer, const uint32_t &instances) const
+std::size_t Model::GetGpuSize() const
 {
-	if (m_vertexBuffer != nullptr && m_indexBuffer != nullptr)
+	VkDeviceSize size = 0;
+
+	// Models in a geometry heap only own their ranges of the heaps buffers.
+	if (m_allocation && m_geometryHeap != nullptr)
 	{
-		VkBuffer vertexBuffers[] = { m_vertexBuffer->GetBuffer() };
-		VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-		vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer->GetBuffer(), 0, GetIndexType());
-		vkCmdDrawIndexed(commandBuffer, m_indexCount, instances, 0, 0, 0);
+		size += static_cast<VkDeviceSize>(m_allocation->m_vertexCount) * m_geometryHeap->GetVertexSize() +
+			static_cast<VkDeviceSize>(m_allocation->m_indexCount) * GeometryHeap::GetIndexSize(m_geometryHeap->GetIndexType());
 	}
-	else if (m_vertexBuffer != nullptr && m_indexBuffer == nullptr)
+
+	for (const auto buffer : { static_cast<const Buffer *>(m_vertexBuffer.get()), m_indexBuffer.get(), static_cast<const Buffer *>(m_meshletBuffer.get()),
+		static_cast<const Buffer *>(m_meshletVertexBuffer.get()), static_cast<const Buffer *>(m_meshletTriangleBuffer.get()) })
 	{
-		VkBuffer vertexBuffers[] = { m_vertexBuffer->GetBuffer() };
-		VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-		vkCmdDraw(commandBuffer, m_vertexCount, instances, 0, 0);
+		if (buffer != nullptr)
+		{
+			size += buffer->GetSize();
+		}
 	}
-	else
+
+	return static_cast<std::size_t>(size);
+}
+
+bool Model::CmdBind(const CommandBuffer &commandBuffer) const
+{
+	auto vertexBuffer = GetVertexBuffer();
+	auto indexBuffer = GetIndexBuffer();
+
+	if (vertexBuffer == nullptr)
+	{
+		return false;
+	}
+
+	VkBuffer vertexBuffers[] = { vertexBuffer->GetBuffer() };
+	VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+	if (indexBuffer != nullptr)
+	{
+		vkCmdBindIndexBuffer(commandBuffer, indexBuffer->GetBuffer(), 0, GetIndexType());
+	}
+
+	return true;
+}
+
+bool Model::CmdRender(const CommandBuffer &commandBuffer, const uint32_t &instances, const uint32_t &lod) const
+{
+	if (!CmdBind(commandBuffer))
 	{
 		//throw std::runtime_error("Model with no buffers cannot be rendered");
 		return false;
 	}
 
+	if (m_indexCount != 0)
+	{
+		auto level = GetLod(lod);
+		vkCmdDrawIndexed(commandBuffer, level.m_indexCount, instances, GetFirstIndex() + level.m_firstIndex, GetVertexOffset(), 0);
+	}
+	else
+	{
+		vkCmdDraw(commandBuffer, m_vertexCount, instances, static_cast<uint32_t>(GetVertexOffset()), 0);
+	}
+
 	return true;
 }
 
-void Model::Load()
+bool Model::CmdRenderIndirect(const CommandBuffer &commandBuffer, const IndirectBuffer &indirectBuffer, const VkDeviceSize &offset, const bool &bind,
+	const uint32_t &drawCount) const
 {
+	if (GetVertexBuffer() == nullptr || GetIndexBuffer() == nullptr)
+	{
+		return false;
+	}
+
+	if (bind)
+	{
+		CmdBind(commandBuffer);
+	}
+
+	vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer.GetBuffer(), offset, drawCount, sizeof(VkDrawIndexedIndirectCommand));
+	return true;
 }
 
-std::vector<float> Model::GetPointCloud() const
+Model::Lod Model::GetLod(const uint32_t &lod) const
 {
-	if (m_vertexBuffer == nullptr)
+	if (m_lods.empty())
 	{
-		return std::vector<float>();
+		return {};
 	}
 
-	// TODO: Fix Vulkan memory mapping error.
-	std::vector<uint32_t> indices(m_indexBuffer->GetSize() / sizeof(uint32_t));
-	m_vertexBuffer->MapMemory(reinterpret_cast<void **>(indices.data()));
-	m_vertexBuffer->UnmapMemory();
+	return m_lods[std::min(lod, static_cast<uint32_t>(m_lods.size()) - 1)];
+}
 
-	std::vector<float> vertices(m_vertexBuffer->GetSize() / sizeof(float));
-	m_vertexBuffer->MapMemory(reinterpret_cast<void **>(vertices.data()));
-	m_vertexBuffer->UnmapMemory();
+const Buffer *Model::GetVertexBuffer() const
+{
+	if (m_allocation)
+	{
+		return m_geometryHeap->GetVertexBuffer();
+	}
+
+	return m_vertexBuffer.get();
+}
+
+const Buffer *Model::GetIndexBuffer() const
+{
+	if (m_allocation)
+	{
+		return m_allocation->m_indexCount != 0 ? m_geometryHeap->GetIndexBuffer() : nullptr;
+	}
+
+	return m_indexBuffer.get();
+}
 
+void Model::Load()
+{
+}
+
+std::vector<float> Model::GetPointCloud() const
+{
 	std::vector<float> pointCloud;
-	pointCloud.reserve(indices.size());
+	pointCloud.reserve(3 * m_hullPoints.size());
 
-	for (auto index : indices)
+	for (const auto &point : m_hullPoints)
 	{
-		pointCloud.emplace_back(vertices[index]);
+		pointCloud.insert(pointCloud.end(), { point.m_x, point.m_y, point.m_z });
 	}
 
 	return pointCloud;
 }
 
+void Model::InitializeQuantized(std::vector<VertexDefault> vertices, std::vector<uint32_t> indices)
+{
+	ModelOptimizer::Optimize(vertices, indices);
+	m_minExtents = Vector3f::PositiveInfinity;
+	m_maxExtents = Vector3f::NegativeInfinity;
+
+	for (const auto &vertex : vertices)
+	{
+		m_minExtents = m_minExtents.Min(vertex.m_position);
+		m_maxExtents = m_maxExtents.Max(vertex.m_position);
+	}
+
+	m_radius = std::max(m_minExtents.Length(), m_maxExtents.Length());
+
+	if (vertices.empty())
+	{
+		m_minExtents = Vector3f();
+		m_maxExtents = Vector3f();
+	}
+
+	m_quantizeOffset = m_minExtents;
+	m_quantizeScale = m_maxExtents - m_minExtents;
+
+	std::vector<VertexQuantized> quantized;
+	quantized.reserve(vertices.size());
+
+	for (const auto &vertex : vertices)
+	{
+		quantized.emplace_back(vertex, m_quantizeOffset, m_quantizeScale);
+	}
+
+	std::vector<Vector3f> positions;
+	positions.reserve(vertices.size());
+
+	for (const auto &vertex : vertices)
+	{
+		positions.emplace_back(vertex.m_position);
+	}
+
+	m_quantized = true;
+	CreateBuffers(quantized.data(), sizeof(VertexQuantized), static_cast<uint32_t>(quantized.size()), indices, positions);
+}
+
+void Model::CreateBuffers(const void *vertices, const uint32_t &vertexSize, const uint32_t &vertexCount, const std::vector<uint32_t> &lod0Indices,
+	const std::vector<Vector3f> &positions)
+{
+	ReleaseBuffers();
+	m_lods.clear();
+	m_hullPoints = CreateHullPoints(positions, (m_minExtents + m_maxExtents) / 2.0f, m_maxExtents - m_minExtents);
+	m_vertexCount = vertexCount;
+	m_vertexSize = vertexSize;
+	m_indexCount = static_cast<uint32_t>(lod0Indices.size());
+	m_indexType = VK_INDEX_TYPE_UINT32;
+
+	if (vertexCount == 0)
+	{
+		return;
+	}
+
+	auto indices = GenerateLods(positions, lod0Indices);
+	auto indexCount = static_cast<uint32_t>(indices.size());
+
+	// Every index is less than the vertex count, so small models halve their index memory with 16 bit indices.
+	std::vector<uint16_t> indices16;
+	const void *indexData = indices.data();
+
+	if (vertexCount <= std::numeric_limits<uint16_t>::max() + 1u)
+	{
+		indices16.assign(indices.begin(), indices.end());
+		indexData = indices16.data();
+		m_indexType = VK_INDEX_TYPE_UINT16;
+	}
+
+	auto meshlets = !indices.empty() && m_indexCount / 3 >= MESHLET_MIN_TRIANGLES;
+
+	if (meshlets)
+	{
+		CreateMeshlets(lod0Indices, positions);
+	}
+	else if (auto geometryHeap = Graphics::Get()->GetGeometryHeap(vertexSize, m_indexType))
+	{
+		m_allocation = geometryHeap->Allocate(vertices, vertexCount, indexData, indexCount);
+
+		if (m_allocation)
+		{
+			m_geometryHeap = std::move(geometryHeap);
+			return;
+		}
+
+		Log::Warning("Geometry heap for %i byte vertices is full, model given buffers of its own\n", vertexSize);
+	}
+
+	// Acceleration structure builds read the vertices and indices of models that ray queries trace against.
+	auto buildInputUsage = AccelerationStructure::GetBuildInputUsage();
+	m_vertexBuffer = CreateStorageBuffer(vertices, static_cast<VkDeviceSize>(vertexSize) * vertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | buildInputUsage);
+
+	if (!indices.empty())
+	{
+		m_indexBuffer = CreateBuffer(indexData, static_cast<VkDeviceSize>(GeometryHeap::GetIndexSize(m_indexType)) * indices.size(),
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | buildInputUsage);
+	}
+}
+
+std::vector<uint32_t> Model::GenerateLods(const std::vector<Vector3f> &positions, const std::vector<uint32_t> &indices)
+{
+	if (indices.empty())
+	{
+		return indices;
+	}
+
+	m_lods.emplace_back(Lod{ 0, static_cast<uint32_t>(indices.size()), 0.0f });
+
+	if (m_lodCount == 0 || positions.empty())
+	{
+		return indices;
+	}
+
+	auto combined = indices;
+	auto diagonal = (m_maxExtents - m_minExtents).Length();
+
+	// Every level is simplified from the full detail triangles, so errors do not build up from one level to the next.
+	for (auto cellSize = LOD_FIRST_CELL * diagonal; m_lods.size() <= m_lodCount && cellSize < diagonal; cellSize *= 2.0f)
+	{
+		float error;
+		auto simplified = Simplify(positions, indices, cellSize, error);
+
+		if (simplified.empty())
+		{
+			break;
+		}
+
+		if (simplified.size() > LOD_REDUCTION * m_lods.back().m_indexCount)
+		{
+			continue;
+		}
+
+		ModelOptimizer::OptimizeVertexCache(simplified, static_cast<uint32_t>(positions.size()));
+		m_lods.emplace_back(Lod{ static_cast<uint32_t>(combined.size()), static_cast<uint32_t>(simplified.size()), error });
+		combined.insert(combined.end(), simplified.begin(), simplified.end());
+	}
+
+	return combined;
+}
+
+std::vector<Vector3f> Model::CreateHullPoints(const std::vector<Vector3f> &positions, const Vector3f &centre, const Vector3f &size)
+{
+	if (positions.size() <= HULL_POINT_LIMIT)
+	{
+		return positions;
+	}
+
+	// The grid is made coarser until few enough cells are occupied, the point furthest out in a cell is the one that can be on the hull.
+	for (uint32_t resolution = 32; ; resolution /= 2)
+	{
+		std::unordered_map<uint32_t, std::pair<float, uint32_t>> cells;
+
+		for (uint32_t i = 0; i < positions.size(); i++)
+		{
+			uint32_t cell = 0;
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				auto normalized = size[j] > 0.0f ? (positions[i][j] - centre[j]) / size[j] + 0.5f : 0.0f;
+				cell = cell * resolution + std::min(static_cast<uint32_t>(std::max(normalized, 0.0f) * resolution), resolution - 1);
+			}
+
+			auto distance = (positions[i] - centre).LengthSquared();
+			auto [it, inserted] = cells.try_emplace(cell, distance, i);
+
+			if (!inserted && distance > it->second.first)
+			{
+				it->second = { distance, i };
+			}
+		}
+
+		if (cells.size() <= HULL_POINT_LIMIT || resolution <= 2)
+		{
+			std::vector<Vector3f> points;
+			points.reserve(cells.size());
+
+			for (const auto &[cell, point] : cells)
+			{
+				points.emplace_back(positions[point.second]);
+			}
+
+			return points;
+		}
+	}
+}
+
+std::vector<uint32_t> Model::Simplify(const std::vector<Vector3f> &positions, const std::vector<uint32_t> &indices, const float &cellSize, float &error)
+{
+	// Each vertex is given the cell it falls in, cells are numbered in the order they are first seen.
+	std::map<std::tuple<int32_t, int32_t, int32_t>, uint32_t> cellIds;
+	std::vector<uint32_t> vertexCells(positions.size());
+	std::vector<Vector3f> cellSums;
+	std::vector<uint32_t> cellCounts;
+
+	for (uint32_t i = 0; i < positions.size(); i++)
+	{
+		auto cell = positions[i] / cellSize;
+		auto key = std::make_tuple(static_cast<int32_t>(std::floor(cell.m_x)), static_cast<int32_t>(std::floor(cell.m_y)), static_cast<int32_t>(std::floor(cell.m_z)));
+		auto id = cellIds.try_emplace(key, static_cast<uint32_t>(cellIds.size())).first->second;
+
+		if (id == cellSums.size())
+		{
+			cellSums.emplace_back();
+			cellCounts.emplace_back(0);
+		}
+
+		cellSums[id] += positions[i];
+		cellCounts[id]++;
+		vertexCells[i] = id;
+	}
+
+	// Cells collapse onto an existing vertex, so the other attributes of the vertex are kept and the vertex buffer is shared.
+	std::vector<uint32_t> representatives(cellSums.size(), std::numeric_limits<uint32_t>::max());
+	std::vector<float> representativeDistances(cellSums.size(), std::numeric_limits<float>::max());
+
+	for (uint32_t i = 0; i < positions.size(); i++)
+	{
+		auto id = vertexCells[i];
+		auto distance = (positions[i] - cellSums[id] / static_cast<float>(cellCounts[id])).LengthSquared();
+
+		if (distance < representativeDistances[id])
+		{
+			representatives[id] = i;
+			representativeDistances[id] = distance;
+		}
+	}
+
+	error = 0.0f;
+	std::vector<uint32_t> simplified;
+	std::set<std::tuple<uint32_t, uint32_t, uint32_t>> triangles;
+
+	for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t triangle[3];
+
+		for (uint32_t j = 0; j < 3; j++)
+		{
+			triangle[j] = representatives[vertexCells[indices[i + j]]];
+			error = std::max(error, (positions[indices[i + j]] - positions[triangle[j]]).Length());
+		}
+
+		if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+		{
+			continue;
+		}
+
+		// Triangles are rotated to start at their smallest index, so repeats are found without changing the winding.
+		auto first = std::min_element(triangle, triangle + 3) - triangle;
+		auto key = std::make_tuple(triangle[first], triangle[(first + 1) % 3], triangle[(first + 2) % 3]);
+
+		if (!triangles.insert(key).second)
+		{
+			continue;
+		}
+
+		simplified.insert(simplified.end(), { std::get<0>(key), std::get<1>(key), std::get<2>(key) });
+	}
+
+	return simplified;
+}
+
+void Model::CreateMeshlets(const std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions)
+{
+	std::vector<uint32_t> meshletVertices;
+	std::vector<uint32_t> meshletTriangles;
+	auto meshlets = ModelOptimizer::BuildMeshlets(indices, positions, meshletVertices, meshletTriangles);
+
+	if (meshlets.empty())
+	{
+		return;
+	}
+
+	m_meshletCount = static_cast<uint32_t>(meshlets.size());
+	m_meshletBuffer = CreateStorageBuffer(meshlets.data(), sizeof(ModelOptimizer::Meshlet) * meshlets.size());
+	m_meshletVertexBuffer = CreateStorageBuffer(meshletVertices.data(), sizeof(uint32_t) * meshletVertices.size());
+	m_meshletTriangleBuffer = CreateStorageBuffer(meshletTriangles.data(), sizeof(uint32_t) * meshletTriangles.size());
+}
+
+void Model::ReleaseBuffers()
+{
+	if (m_allocation)
+	{
+		m_geometryHeap->Free(*m_allocation);
+	}
+
+	m_vertexBuffer = nullptr;
+	m_indexBuffer = nullptr;
+	m_geometryHeap = nullptr;
+	m_allocation = std::nullopt;
+	m_meshletCount = 0;
+	m_meshletBuffer = nullptr;
+	m_meshletVertexBuffer = nullptr;
+	m_meshletTriangleBuffer = nullptr;
+}
+
+std::unique_ptr<Buffer> Model::CreateBuffer(const void *data, const VkDeviceSize &size, const VkBufferUsageFlags &usage)
+{
+	auto buffer = std::make_unique<Buffer>(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	UploadBuffer(*buffer, data, size);
+	return buffer;
+}
+
+std::unique_ptr<StorageBuffer> Model::CreateStorageBuffer(const void *data, const VkDeviceSize &size, const VkBufferUsageFlags &usage)
+{
+	auto buffer = std::make_unique<StorageBuffer>(size, nullptr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, usage);
+	UploadBuffer(*buffer, data, size);
+	return buffer;
+}
+
+void Model::UploadBuffer(const Buffer &buffer, const void *data, const VkDeviceSize &size)
+{
+	Graphics::Get()->GetUploadContext()->Record(data, size, [&](const CommandBuffer &commandBuffer, const Buffer &bufferStaging)
+	{
+		VkBufferCopy copyRegion = {};
+		copyRegion.size = size;
+		vkCmdCopyBuffer(commandBuffer, bufferStaging.GetBuffer(), buffer.GetBuffer(), 1, &copyRegion);
+	});
+}
+
 const Metadata &operator>>(const Metadata &metadata, Model &model)
 {
 	// TODO: Virtual?
@@ -2,17 +2,37 @@
 
 #include "Maths/Vector3.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
+#include "Graphics/Buffers/GeometryHeap.hpp"
+#include "Graphics/Buffers/IndirectBuffer.hpp"
+#include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Resources/Resource.hpp"
+#include "ModelOptimizer.hpp"
 
 namespace acid
 {
+class VertexDefault;
+
 /**
  * @brief Resource that represents a model vertex and index buffer.
+ * Indices are stored as 16 bit when every vertex can be addressed with them.
  */
 class ACID_EXPORT Model :
 	public Resource
 {
 public:
+	/**
+	 * @brief A level of detail of a model, a range of the index buffer drawn with the same vertices as the full detail level.
+	 */
+	class Lod
+	{
+	public:
+		// Relative to the first index of the model.
+		uint32_t m_firstIndex = 0;
+		uint32_t m_indexCount = 0;
+		// The furthest a vertex has moved from its full detail position, in model space.
+		float m_error = 0.0f;
+	};
+
 	/**
 	 * Creates a new model, or finds one with the same values.
 	 * @param metadata The metadata to decode values from.
@@ -32,8 +52,10 @@ public:
 	 */
 	Model();
 
+	~Model();
+
 	/**
-	 * Creates a new model.
+	 * Creates a new model, indexed geometry is reordered by the {@link ModelOptimizer} first.
 	 * @tparam T The vertex type.
 	 * @param vertices The model vertices.
 	 * @param indices The model indices.
@@ -45,12 +67,53 @@ public:
 		Initialize(vertices, indices);
 	}
 
-	bool CmdRender(const CommandBuffer &commandBuffer, const uint32_t &instances = 1) const;
+	/**
+	 * Binds the vertex buffer to the first binding, and the index buffer if the model is indexed.
+	 * @param commandBuffer The command buffer to write to.
+	 * @return If the model has a vertex buffer.
+	 */
+	bool CmdBind(const CommandBuffer &commandBuffer) const;
+
+	/**
+	 * Draws this model.
+	 * @param commandBuffer The command buffer to write to.
+	 * @param instances The number of instances to draw.
+	 * @param lod The level of detail to draw, clamped to the levels of the model.
+	 * @return If the model has been drawn.
+	 */
+	bool CmdRender(const CommandBuffer &commandBuffer, const uint32_t &instances = 1, const uint32_t &lod = 0) const;
+
+	/**
+	 * Draws this model with arguments read from an indirect buffer, only indexed models can be drawn indirectly.
+	 * The command must use the first index and vertex offset of this model.
+	 * @param commandBuffer The command buffer to write to.
+	 * @param indirectBuffer The buffer containing a VkDrawIndexedIndirectCommand.
+	 * @param offset The offset of the command in the indirect buffer.
+	 * @param bind If the buffers are bound first, this can be skipped when the last model drawn has the same buffers.
+	 * @param drawCount The number of consecutive commands to draw, more than one requires the multi draw indirect feature.
+	 * @return If the model has been drawn.
+	 */
+	bool CmdRenderIndirect(const CommandBuffer &commandBuffer, const IndirectBuffer &indirectBuffer, const VkDeviceSize &offset, const bool &bind = true,
+		const uint32_t &drawCount = 1) const;
 
 	void Load() override;
 
+	std::size_t GetCpuSize() const override;
+
+	std::size_t GetGpuSize() const override;
+
+	/**
+	 * Gets the points physics builds convex hulls from, read from a copy kept on the host so it never touches device memory and can be called from any thread.
+	 * @return The x, y, z coordinates of each point.
+	 */
 	std::vector<float> GetPointCloud() const;
 
+	/**
+	 * Gets the host copy of the model space positions kept for physics, large models are decimated to a bounded number of points that keep the outline of the model.
+	 * @return The hull points.
+	 */
+	const std::vector<Vector3f> &GetHullPoints() const { return m_hullPoints; }
+
 	const Vector3f &GetMinExtents() const { return m_minExtents; }
 
 	const Vector3f &GetMaxExtents() const { return m_maxExtents; }
@@ -63,82 +126,240 @@ public:
 
 	float GetRadius() const { return m_radius; }
 
-	const Buffer *GetVertexBuffer() const { return m_vertexBuffer.get(); }
+	/**
+	 * Gets the buffer the vertices are in, this is shared with other models when the model is in a geometry heap.
+	 * @return The vertex buffer.
+	 */
+	const Buffer *GetVertexBuffer() const;
 
-	const Buffer *GetIndexBuffer() const { return m_indexBuffer.get(); }
+	/**
+	 * Gets the buffer the indices are in, this is shared with other models when the model is in a geometry heap.
+	 * @return The index buffer, or nullptr if the model is not indexed.
+	 */
+	const Buffer *GetIndexBuffer() const;
+
+	/**
+	 * Gets the vertex buffer as a storage buffer shaders can read, only models with buffers of their own have one.
+	 * @return The vertex storage buffer, or nullptr if the model is in a geometry heap.
+	 */
+	const StorageBuffer *GetVertexStorage() const { return m_vertexBuffer.get(); }
+
+	/**
+	 * Gets the number of meshlets the full detail level is split into, only dense models have meshlets.
+	 * @return The meshlet count.
+	 */
+	const uint32_t &GetMeshletCount() const { return m_meshletCount; }
+
+	/**
+	 * Gets the {@link ModelOptimizer#Meshlet} bounds and ranges of each meshlet.
+	 * @return The meshlet buffer, or nullptr if the model has no meshlets.
+	 */
+	const StorageBuffer *GetMeshletBuffer() const { return m_meshletBuffer.get(); }
+
+	/**
+	 * Gets the unique vertices of each meshlet, as indices into the vertex buffer.
+	 * @return The meshlet vertex buffer, or nullptr if the model has no meshlets.
+	 */
+	const StorageBuffer *GetMeshletVertexBuffer() const { return m_meshletVertexBuffer.get(); }
+
+	/**
+	 * Gets the triangles of each meshlet, three 8 bit indices into the meshlets vertices packed into each entry.
+	 * @return The meshlet triangle buffer, or nullptr if the model has no meshlets.
+	 */
+	const StorageBuffer *GetMeshletTriangleBuffer() const { return m_meshletTriangleBuffer.get(); }
 
 	const uint32_t &GetVertexCount() const { return m_vertexCount; }
 
-	const uint32_t &GetIndexCount() const { return m_indexCount; }
+	/**
+	 * Gets the size of one vertex in bytes, every vertex type starts with its position.
+	 * @return The vertex size.
+	 */
+	const uint32_t &GetVertexSize() const { return m_vertexSize; }
 
-	VkIndexType GetIndexType() const { return VK_INDEX_TYPE_UINT32; }
+	/**
+	 * Gets the number of indices of the full detail level.
+	 * @return The index count.
+	 */
+	const uint32_t &GetIndexCount() const { return m_indexCount; }
 
-	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Model &model);
+	/**
+	 * Gets the levels of detail of the model, ordered from the full detail level to the coarsest. Indexed models have at least one level.
+	 * @return The levels of detail.
+	 */
+	const std::vector<Lod> &GetLods() const { return m_lods; }
 
-	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Model &model);
+	/**
+	 * Gets a level of detail, levels past the coarsest give the coarsest level.
+	 * @param lod The level.
+	 * @return The level of detail.
+	 */
+	Lod GetLod(const uint32_t &lod) const;
 
-protected:
-	template<typename T>
-	void Initialize(const std::vector<T> &vertices, const std::vector<uint32_t> &indices = {})
-	{
-		m_vertexBuffer = nullptr;
-		m_indexBuffer = nullptr;
+	/**
+	 * Gets the index of the first index of this model in the index buffer, draws must start from it.
+	 * @return The first index.
+	 */
+	uint32_t GetFirstIndex() const { return m_allocation ? m_allocation->m_firstIndex : 0; }
 
-		if (!vertices.empty())
-		{
-			auto vertexStaging = Buffer(sizeof(T) * vertices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				vertices.data());
-			m_vertexBuffer = std::make_unique<Buffer>(sizeof(T) * vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-			m_vertexCount = static_cast<uint32_t>(vertices.size());
+	/**
+	 * Gets the vertex offset of this model in the vertex buffer, draws must add it to each index.
+	 * @return The vertex offset.
+	 */
+	int32_t GetVertexOffset() const { return m_allocation ? static_cast<int32_t>(m_allocation->m_vertexOffset) : 0; }
 
-			CommandBuffer commandBuffer = CommandBuffer();
+	const GeometryHeap *GetGeometryHeap() const { return m_geometryHeap.get(); }
 
-			VkBufferCopy copyRegion = {};
-			copyRegion.size = sizeof(T) * vertices.size();
-			vkCmdCopyBuffer(commandBuffer, vertexStaging.GetBuffer(), m_vertexBuffer->GetBuffer(), 1, &copyRegion);
+	const VkIndexType &GetIndexType() const { return m_indexType; }
 
-			commandBuffer.SubmitIdle();
-		}
+	/**
+	 * Gets if the vertices are {@link VertexQuantized}, pipelines drawing the model must use its vertex input and dequantize positions.
+	 * @return If the model is quantized.
+	 */
+	const bool &IsQuantized() const { return m_quantized; }
 
-		if (!indices.empty())
-		{
-			auto indexStaging = Buffer(sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, indices.data());
-			m_indexBuffer = std::make_unique<Buffer>(sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-			m_indexCount = static_cast<uint32_t>(indices.size());
+	/**
+	 * Gets the offset quantized positions are rebuilt with, the smallest position of the model.
+	 * @return The quantize offset.
+	 */
+	const Vector3f &GetQuantizeOffset() const { return m_quantizeOffset; }
 
-			CommandBuffer commandBuffer = CommandBuffer();
+	/**
+	 * Gets the scale quantized positions are rebuilt with, the size of the bounds of the model.
+	 * @return The quantize scale.
+	 */
+	const Vector3f &GetQuantizeScale() const { return m_quantizeScale; }
 
-			VkBufferCopy copyRegion = {};
-			copyRegion.size = sizeof(uint32_t) * indices.size();
-			vkCmdCopyBuffer(commandBuffer, indexStaging.GetBuffer(), m_indexBuffer->GetBuffer(), 1, &copyRegion);
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Model &model);
 
-			commandBuffer.SubmitIdle();
-		}
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Model &model);
 
+protected:
+	template<typename T>
+	void Initialize(std::vector<T> vertices, std::vector<uint32_t> indices = {})
+	{
+		ModelOptimizer::Optimize(vertices, indices);
+		m_quantized = false;
 		m_minExtents = Vector3f::PositiveInfinity;
 		m_maxExtents = Vector3f::NegativeInfinity;
 
+		std::vector<Vector3f> positions;
+		positions.reserve(vertices.size());
+
 		for (const auto &vertex : vertices)
 		{
 			auto position = Vector3f(vertex.m_position);
 			m_minExtents = m_minExtents.Min(position);
 			m_maxExtents = m_maxExtents.Max(position);
+			positions.emplace_back(position);
 		}
 
 		m_radius = std::max(m_minExtents.Length(), m_maxExtents.Length());
+		CreateBuffers(vertices.data(), sizeof(T), static_cast<uint32_t>(vertices.size()), indices, positions);
 	}
 
+	/**
+	 * Initializes the model with vertices quantized to {@link VertexQuantized}, about half the memory of full precision vertices.
+	 * Indexed geometry is reordered by the {@link ModelOptimizer} first.
+	 * @param vertices The model vertices.
+	 * @param indices The model indices.
+	 */
+	void InitializeQuantized(std::vector<VertexDefault> vertices, std::vector<uint32_t> indices = {});
+
+	// Set by loaders before loading, so materials can create pipelines for quantized vertices before the model has loaded.
+	bool m_quantized;
+	// The number of simplified levels generated past the full detail level, set by loaders before loading.
+	uint32_t m_lodCount;
+
 private:
-	std::unique_ptr<Buffer> m_vertexBuffer;
+	/**
+	 * Places the geometry in the geometry heap for its vertex size, or in buffers of its own when heaps are not used or the heap is full.
+	 * Dense models are split into meshlets, and always given buffers of their own so shaders can read their vertices.
+	 * @param vertices The vertices.
+	 * @param vertexSize The size of one vertex in bytes.
+	 * @param vertexCount The number of vertices.
+	 * @param indices The indices.
+	 * @param positions The vertex positions, levels of detail are simplified from them and the hull points are taken from them.
+	 */
+	void CreateBuffers(const void *vertices, const uint32_t &vertexSize, const uint32_t &vertexCount, const std::vector<uint32_t> &indices,
+		const std::vector<Vector3f> &positions);
+
+	/**
+	 * Generates up to the requested number of simplified levels, every level after the full detail level is appended to the indices.
+	 * @param positions The vertex positions.
+	 * @param indices The full detail indices.
+	 * @return The indices of every level.
+	 */
+	std::vector<uint32_t> GenerateLods(const std::vector<Vector3f> &positions, const std::vector<uint32_t> &indices);
+
+	/**
+	 * Decimates positions to a bounded number of points by keeping the point furthest from the centre in each cell of a grid.
+	 * @param positions The vertex positions.
+	 * @param centre The centre of the bounds of the model.
+	 * @param size The size of the bounds of the model.
+	 * @return The hull points.
+	 */
+	static std::vector<Vector3f> CreateHullPoints(const std::vector<Vector3f> &positions, const Vector3f &centre, const Vector3f &size);
+
+	/**
+	 * Simplifies triangles by clustering vertices into a grid, each cell is collapsed onto the vertex closest to the centre of its vertices.
+	 * Triangles that collapse to a line or point, and repeated triangles, are removed.
+	 * @param positions The vertex positions.
+	 * @param indices The triangles to simplify.
+	 * @param cellSize The size of the grid cells.
+	 * @param error Set to the furthest distance a vertex is moved.
+	 * @return The simplified triangles.
+	 */
+	static std::vector<uint32_t> Simplify(const std::vector<Vector3f> &positions, const std::vector<uint32_t> &indices, const float &cellSize, float &error);
+
+	/**
+	 * Builds the meshlets of the full detail level and uploads them.
+	 * @param indices The full detail indices.
+	 * @param positions The vertex positions.
+	 */
+	void CreateMeshlets(const std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions);
+
+	void ReleaseBuffers();
+
+	/**
+	 * Creates a device local buffer, its contents are copied in by the {@link UploadContext} ahead of the next frame.
+	 * @param data The contents of the buffer.
+	 * @param size The size of the contents.
+	 * @param usage How the buffer will be used, the transfer destination usage is added.
+	 * @return The buffer.
+	 */
+	static std::unique_ptr<Buffer> CreateBuffer(const void *data, const VkDeviceSize &size, const VkBufferUsageFlags &usage);
+
+	/**
+	 * Creates a device local storage buffer, its contents are copied in by the {@link UploadContext} ahead of the next frame.
+	 * @param data The contents of the buffer.
+	 * @param size The size of the contents.
+	 * @param usage Usages added to the storage usage.
+	 * @return The buffer.
+	 */
+	static std::unique_ptr<StorageBuffer> CreateStorageBuffer(const void *data, const VkDeviceSize &size, const VkBufferUsageFlags &usage = 0);
+
+	static void UploadBuffer(const Buffer &buffer, const void *data, const VkDeviceSize &size);
+
+	std::unique_ptr<StorageBuffer> m_vertexBuffer;
 	std::unique_ptr<Buffer> m_indexBuffer;
+	std::shared_ptr<GeometryHeap> m_geometryHeap;
+	std::optional<GeometryHeap::Allocation> m_allocation;
 	uint32_t m_vertexCount;
+	uint32_t m_vertexSize;
 	uint32_t m_indexCount;
+	VkIndexType m_indexType;
+	std::vector<Lod> m_lods;
+	std::vector<Vector3f> m_hullPoints;
+	uint32_t m_meshletCount;
+	std::unique_ptr<StorageBuffer> m_meshletBuffer;
+	std::unique_ptr<StorageBuffer> m_meshletVertexBuffer;
+	std::unique_ptr<StorageBuffer> m_meshletTriangleBuffer;
 
 	Vector3f m_minExtents;
 	Vector3f m_maxExtents;
 	float m_radius;
+
+	Vector3f m_quantizeOffset;
+	Vector3f m_quantizeScale;
 };
 }
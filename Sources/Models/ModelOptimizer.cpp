@@ -0,0 +1,423 @@
+#include "ModelOptimizer.hpp"
+
+namespace acid
+{
+// The size of the simulated post transform cache, at least as large as the caches of current hardware.
+static const uint32_t CACHE_SIZE = 32;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+void ModelOptimizer::OptimizeVertexCache(std::vector<uint32_t> &indices, const uint32_t &vertexCount)
+{
+	auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// The triangles of each vertex, live triangles are kept at the front of each vertexs range.
+	std::vector<uint32_t> remaining(vertexCount, 0);
+
+	for (std::size_t i = 0; i < 3 * triangleCount; i++)
+	{
+		remaining[indices[i]]++;
+	}
+
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		offsets[i + 1] = offsets[i] + remaining[i];
+	}
+
+	std::vector<uint32_t> adjacency(3 * triangleCount);
+	auto cursors = offsets;
+
+	for (uint32_t i = 0; i < 3 * triangleCount; i++)
+	{
+		adjacency[cursors[indices[i]]++] = i / 3;
+	}
+
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		vertexScores[i] = GetVertexScore(-1, remaining[i]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	uint32_t bestTriangle = 0;
+
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		triangleScores[i] = vertexScores[indices[3 * i]] + vertexScores[indices[3 * i + 1]] + vertexScores[indices[3 * i + 2]];
+
+		if (triangleScores[i] > triangleScores[bestTriangle])
+		{
+			bestTriangle = i;
+		}
+	}
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> nextCache;
+	std::vector<uint32_t> output;
+	output.reserve(3 * triangleCount);
+	uint32_t nextUnemitted = 0;
+
+	while (output.size() < 3 * triangleCount)
+	{
+		// Nothing in the cache has a live triangle, the next triangle not yet emitted starts again.
+		if (bestTriangle == UNUSED)
+		{
+			while (emitted[nextUnemitted])
+			{
+				nextUnemitted++;
+			}
+
+			bestTriangle = nextUnemitted;
+		}
+
+		emitted[bestTriangle] = true;
+		nextCache.clear();
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			auto vertex = indices[3 * bestTriangle + i];
+			output.emplace_back(vertex);
+			nextCache.emplace_back(vertex);
+
+			auto begin = adjacency.begin() + offsets[vertex];
+			auto end = begin + remaining[vertex];
+			std::iter_swap(std::find(begin, end, bestTriangle), end - 1);
+			remaining[vertex]--;
+		}
+
+		for (const auto &vertex : cache)
+		{
+			if (std::find(nextCache.begin(), nextCache.begin() + 3, vertex) == nextCache.begin() + 3)
+			{
+				nextCache.emplace_back(vertex);
+			}
+		}
+
+		// Vertices pushed out of the cache lose their cache score, every vertex that moved rescores its live triangles.
+		for (uint32_t i = 0; i < nextCache.size(); i++)
+		{
+			auto vertex = nextCache[i];
+			cachePositions[vertex] = i < CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+			vertexScores[vertex] = GetVertexScore(cachePositions[vertex], remaining[vertex]);
+		}
+
+		bestTriangle = UNUSED;
+		auto bestScore = -1.0f;
+
+		for (const auto &vertex : nextCache)
+		{
+			for (uint32_t j = offsets[vertex]; j < offsets[vertex] + remaining[vertex]; j++)
+			{
+				auto triangle = adjacency[j];
+				triangleScores[triangle] = vertexScores[indices[3 * triangle]] + vertexScores[indices[3 * triangle + 1]] + vertexScores[indices[3 * triangle + 2]];
+
+				if (triangleScores[triangle] > bestScore)
+				{
+					bestTriangle = triangle;
+					bestScore = triangleScores[triangle];
+				}
+			}
+		}
+
+		nextCache.resize(std::min(static_cast<uint32_t>(nextCache.size()), CACHE_SIZE));
+		std::swap(cache, nextCache);
+	}
+
+	indices = std::move(output);
+}
+
+void ModelOptimizer::OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions)
+{
+	auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// Clusters are split where a triangle misses the simulated cache with every vertex.
+	std::vector<uint32_t> clusterStarts;
+	std::vector<uint32_t> cacheTimes(positions.size(), 0);
+	uint32_t time = CACHE_SIZE + 1;
+
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		uint32_t misses = 0;
+
+		for (uint32_t j = 0; j < 3; j++)
+		{
+			auto vertex = indices[3 * i + j];
+
+			if (time - cacheTimes[vertex] > CACHE_SIZE)
+			{
+				cacheTimes[vertex] = time++;
+				misses++;
+			}
+		}
+
+		if (i == 0 || misses == 3)
+		{
+			clusterStarts.emplace_back(i);
+		}
+	}
+
+	if (clusterStarts.size() < 2)
+	{
+		return;
+	}
+
+	auto meshCentroid = Vector3f();
+
+	for (const auto &position : positions)
+	{
+		meshCentroid += position;
+	}
+
+	meshCentroid /= static_cast<float>(positions.size());
+
+	// Clusters on the outside of the model facing away from its centre are likely to cover the others, so they sort first.
+	std::vector<std::pair<float, uint32_t>> clusterSort;
+	clusterSort.reserve(clusterStarts.size());
+
+	for (uint32_t i = 0; i < clusterStarts.size(); i++)
+	{
+		auto end = i + 1 < clusterStarts.size() ? clusterStarts[i + 1] : triangleCount;
+		auto centroid = Vector3f();
+		auto normal = Vector3f();
+		auto area = 0.0f;
+
+		for (auto triangle = clusterStarts[i]; triangle < end; triangle++)
+		{
+			const auto &p0 = positions[indices[3 * triangle]];
+			const auto &p1 = positions[indices[3 * triangle + 1]];
+			const auto &p2 = positions[indices[3 * triangle + 2]];
+			auto triangleNormal = (p1 - p0).Cross(p2 - p0);
+			auto triangleArea = triangleNormal.Length();
+
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += triangleNormal;
+			area += triangleArea;
+		}
+
+		auto key = 0.0f;
+
+		if (area > 0.0f && normal.Length() > 0.0f)
+		{
+			key = (centroid / area - meshCentroid).Dot(normal.Normalize());
+		}
+
+		clusterSort.emplace_back(-key, i);
+	}
+
+	std::stable_sort(clusterSort.begin(), clusterSort.end(), [](const std::pair<float, uint32_t> &a, const std::pair<float, uint32_t> &b)
+	{
+		return a.first < b.first;
+	});
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+
+	for (const auto &[key, cluster] : clusterSort)
+	{
+		auto begin = clusterStarts[cluster];
+		auto end = cluster + 1 < clusterStarts.size() ? clusterStarts[cluster + 1] : triangleCount;
+		output.insert(output.end(), indices.begin() + 3 * begin, indices.begin() + 3 * end);
+	}
+
+	indices = std::move(output);
+}
+
+std::vector<uint32_t> ModelOptimizer::OptimizeVertexFetch(std::vector<uint32_t> &indices, const uint32_t &vertexCount)
+{
+	std::vector<uint32_t> remap(vertexCount, UNUSED);
+	uint32_t nextVertex = 0;
+
+	for (auto &index : indices)
+	{
+		if (remap[index] == UNUSED)
+		{
+			remap[index] = nextVertex++;
+		}
+
+		index = remap[index];
+	}
+
+	return remap;
+}
+
+std::vector<ModelOptimizer::Meshlet> ModelOptimizer::BuildMeshlets(const std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions,
+	std::vector<uint32_t> &vertices, std::vector<uint32_t> &triangles)
+{
+	std::vector<Meshlet> meshlets;
+	vertices.clear();
+	triangles.clear();
+
+	auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+	if (triangleCount == 0)
+	{
+		return meshlets;
+	}
+
+	// The index of each vertex in the meshlet being built.
+	std::vector<uint32_t> localIndices(positions.size(), UNUSED);
+	Meshlet meshlet;
+
+	auto finishMeshlet = [&](const uint32_t &nextTriangle)
+	{
+		for (auto i = meshlet.m_vertexOffset; i < meshlet.m_vertexOffset + meshlet.m_vertexCount; i++)
+		{
+			localIndices[vertices[i]] = UNUSED;
+		}
+
+		ComputeMeshletBounds(meshlet, indices, positions, vertices);
+		meshlets.emplace_back(meshlet);
+
+		meshlet = Meshlet();
+		meshlet.m_vertexOffset = static_cast<uint32_t>(vertices.size());
+		meshlet.m_triangleOffset = nextTriangle;
+	};
+
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		uint32_t newVertices = 0;
+
+		for (uint32_t j = 0; j < 3; j++)
+		{
+			if (localIndices[indices[3 * i + j]] == UNUSED)
+			{
+				newVertices++;
+			}
+		}
+
+		if (meshlet.m_vertexCount + newVertices > MESHLET_MAX_VERTICES || meshlet.m_triangleCount == MESHLET_MAX_TRIANGLES)
+		{
+			finishMeshlet(i);
+		}
+
+		uint32_t packed = 0;
+
+		for (uint32_t j = 0; j < 3; j++)
+		{
+			auto vertex = indices[3 * i + j];
+
+			if (localIndices[vertex] == UNUSED)
+			{
+				localIndices[vertex] = meshlet.m_vertexCount++;
+				vertices.emplace_back(vertex);
+			}
+
+			packed |= localIndices[vertex] << (8 * j);
+		}
+
+		triangles.emplace_back(packed);
+		meshlet.m_triangleCount++;
+	}
+
+	finishMeshlet(triangleCount);
+	return meshlets;
+}
+
+float ModelOptimizer::GetVertexScore(const int32_t &cachePosition, const uint32_t &remaining)
+{
+	if (remaining == 0)
+	{
+		return -1.0f;
+	}
+
+	auto score = 0.0f;
+
+	// The vertices of the last triangle get a fixed score, so the next triangle is not always one that shares an edge with it.
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+		{
+			score = LAST_TRIANGLE_SCORE;
+		}
+		else
+		{
+			score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / static_cast<float>(CACHE_SIZE - 3), CACHE_DECAY_POWER);
+		}
+	}
+
+	// Vertices with few triangles left are favoured, so they are finished and do not linger as lone triangles.
+	return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining), -VALENCE_BOOST_POWER);
+}
+
+void ModelOptimizer::ComputeMeshletBounds(Meshlet &meshlet, const std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions,
+	const std::vector<uint32_t> &vertices)
+{
+	auto minExtents = Vector3f::PositiveInfinity;
+	auto maxExtents = Vector3f::NegativeInfinity;
+
+	for (auto i = meshlet.m_vertexOffset; i < meshlet.m_vertexOffset + meshlet.m_vertexCount; i++)
+	{
+		minExtents = minExtents.Min(positions[vertices[i]]);
+		maxExtents = maxExtents.Max(positions[vertices[i]]);
+	}
+
+	meshlet.m_centre = (minExtents + maxExtents) / 2.0f;
+	meshlet.m_radius = 0.0f;
+
+	for (auto i = meshlet.m_vertexOffset; i < meshlet.m_vertexOffset + meshlet.m_vertexCount; i++)
+	{
+		meshlet.m_radius = std::max(meshlet.m_radius, (positions[vertices[i]] - meshlet.m_centre).Length());
+	}
+
+	// The cone axis is the mean of the triangle normals, and the cone opens as wide as the normal furthest from it.
+	std::vector<Vector3f> normals;
+	normals.reserve(meshlet.m_triangleCount);
+	auto axis = Vector3f();
+
+	for (auto triangle = meshlet.m_triangleOffset; triangle < meshlet.m_triangleOffset + meshlet.m_triangleCount; triangle++)
+	{
+		const auto &p0 = positions[indices[3 * triangle]];
+		const auto &p1 = positions[indices[3 * triangle + 1]];
+		const auto &p2 = positions[indices[3 * triangle + 2]];
+		auto normal = (p1 - p0).Cross(p2 - p0);
+
+		if (normal.Length() > 0.0f)
+		{
+			normals.emplace_back(normal.Normalize());
+			axis += normals.back();
+		}
+	}
+
+	meshlet.m_coneAxis = Vector3f();
+	meshlet.m_coneCutoff = 1.0f;
+
+	if (normals.empty() || axis.Length() == 0.0f)
+	{
+		return;
+	}
+
+	axis = axis.Normalize();
+	auto minDot = 1.0f;
+
+	for (const auto &normal : normals)
+	{
+		minDot = std::min(minDot, axis.Dot(normal));
+	}
+
+	// Normals more than a right angle from the axis leave no direction every triangle faces away from.
+	if (minDot <= 0.0f)
+	{
+		return;
+	}
+
+	meshlet.m_coneAxis = axis;
+	meshlet.m_coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+}
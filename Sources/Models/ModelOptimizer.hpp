@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Maths/Vector3.hpp"
+
+namespace acid
+{
+/**
+ * @brief Reorders the triangles and vertices of a model when it is imported, so the GPU transforms fewer vertices, shades fewer hidden pixels,
+ * and reads vertex memory in order.
+ */
+class ACID_EXPORT ModelOptimizer
+{
+public:
+	/**
+	 * @brief A cluster of triangles culled and drawn together, laid out to match the std430 Meshlet struct in the meshlet shaders.
+	 */
+	class Meshlet
+	{
+	public:
+		// The bounding sphere of the triangles, in model space.
+		Vector3f m_centre;
+		float m_radius = 0.0f;
+		// Every triangle faces away from cameras the cone around this axis points at, a cutoff of one never culls.
+		Vector3f m_coneAxis;
+		float m_coneCutoff = 1.0f;
+		// The first of the meshlets unique vertices in the meshlet vertex list.
+		uint32_t m_vertexOffset = 0;
+		uint32_t m_vertexCount = 0;
+		// The first triangle of the meshlet, the triangles of a meshlet are also a range of the index buffer.
+		uint32_t m_triangleOffset = 0;
+		uint32_t m_triangleCount = 0;
+	};
+
+	/**
+	 * Runs every pass over a indexed model, vertices that no triangle uses are removed.
+	 * @tparam T The vertex type.
+	 * @param vertices The vertices, reordered in place.
+	 * @param indices The triangles, reordered and remapped in place.
+	 */
+	template<typename T>
+	static void Optimize(std::vector<T> &vertices, std::vector<uint32_t> &indices)
+	{
+		if (vertices.empty() || indices.size() < 3)
+		{
+			return;
+		}
+
+		std::vector<Vector3f> positions;
+		positions.reserve(vertices.size());
+
+		for (const auto &vertex : vertices)
+		{
+			positions.emplace_back(Vector3f(vertex.m_position));
+		}
+
+		auto vertexCount = static_cast<uint32_t>(vertices.size());
+		OptimizeVertexCache(indices, vertexCount);
+		OptimizeOverdraw(indices, positions);
+		auto remap = OptimizeVertexFetch(indices, vertexCount);
+
+		auto usedCount = static_cast<std::size_t>(std::count_if(remap.begin(), remap.end(), [](const uint32_t &index)
+		{
+			return index != UNUSED;
+		}));
+		std::vector<T> reordered(usedCount, vertices.front());
+
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			if (remap[i] != UNUSED)
+			{
+				reordered[remap[i]] = vertices[i];
+			}
+		}
+
+		vertices = std::move(reordered);
+	}
+
+	/**
+	 * Orders triangles so they reuse vertices still in the post transform cache, using Forsyths linear speed algorithm.
+	 * @param indices The triangles, reordered in place.
+	 * @param vertexCount The number of vertices the indices address.
+	 */
+	static void OptimizeVertexCache(std::vector<uint32_t> &indices, const uint32_t &vertexCount);
+
+	/**
+	 * Orders clusters of cache ordered triangles so those facing out from the centre of the model are drawn first, and occlude those behind them.
+	 * Clusters start where the cache is cold, so the order within and across clusters keeps most of its cache efficiency.
+	 * @param indices The cache ordered triangles, reordered in place.
+	 * @param positions The vertex positions.
+	 */
+	static void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions);
+
+	/**
+	 * Renumbers vertices in the order triangles first use them, so vertex reads move forward through memory.
+	 * @param indices The triangles, remapped in place.
+	 * @param vertexCount The number of vertices the indices address.
+	 * @return The new index of each vertex, or {@link ModelOptimizer#UNUSED} for vertices no triangle uses.
+	 */
+	static std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t> &indices, const uint32_t &vertexCount);
+
+	/**
+	 * Splits triangles into meshlets in the order they are drawn, so the triangles of each meshlet are a range of the index buffer.
+	 * Cache ordered triangles share most of their vertices with the triangles drawn around them, so consecutive triangles make compact meshlets.
+	 * @param indices The triangles.
+	 * @param positions The vertex positions, used for the bounds of each meshlet.
+	 * @param vertices Set to the unique vertices of each meshlet.
+	 * @param triangles Set to the triangles of each meshlet, each entry packs three 8 bit indices into the meshlets vertices.
+	 * @return The meshlets.
+	 */
+	static std::vector<Meshlet> BuildMeshlets(const std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions, std::vector<uint32_t> &vertices,
+		std::vector<uint32_t> &triangles);
+
+	static constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+	// The outputs of one mesh shader workgroup, within the limits every mesh shading device supports.
+	static constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+	static constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+private:
+	static float GetVertexScore(const int32_t &cachePosition, const uint32_t &remaining);
+
+	static void ComputeMeshletBounds(Meshlet &meshlet, const std::vector<uint32_t> &indices, const std::vector<Vector3f> &positions, const std::vector<uint32_t> &vertices);
+};
+}
@@ -49,31 +49,29 @@ private:
 
 std::shared_ptr<ModelObj> ModelObj::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ModelObj>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ModelObj>(resource);
-	}
-
-	auto result = std::make_shared<ModelObj>("");
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ModelObj>("");
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
-std::shared_ptr<ModelObj> ModelObj::Create(const std::string &filename)
+std::shared_ptr<ModelObj> ModelObj::Create(const std::string &filename, const bool &quantize, const uint32_t &lodCount)
 {
-	auto temp = ModelObj(filename, false);
+	auto temp = ModelObj(filename, false, quantize, lodCount);
 	Metadata metadata = Metadata();
 	metadata << temp;
 	return Create(metadata);
 }
 
-ModelObj::ModelObj(std::string filename, const bool &load) :
+ModelObj::ModelObj(std::string filename, const bool &load, const bool &quantize, const uint32_t &lodCount) :
 	m_filename(std::move(filename))
 {
+	m_quantized = quantize;
+	m_lodCount = lodCount;
+
 	if (load)
 	{
 		ModelObj::Load();
@@ -133,12 +131,21 @@ void ModelObj::Load()
 	Log::Out("Model OBJ '%s' loaded in %.3fms\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds<float>());
 #endif
 
-	Initialize(vertices, indices);
+	if (m_quantized)
+	{
+		InitializeQuantized(std::move(vertices), std::move(indices));
+	}
+	else
+	{
+		Initialize(std::move(vertices), std::move(indices));
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, ModelObj &model)
 {
 	metadata.GetChild("Filename", model.m_filename);
+	metadata.GetChild("Quantize", model.m_quantized);
+	metadata.GetChild("Lods", model.m_lodCount);
 	return metadata;
 }
 
@@ -146,6 +153,8 @@ Metadata &operator<<(Metadata &metadata, const ModelObj &model)
 {
 	metadata.SetChild<std::string>("Type", "ModelObj");
 	metadata.SetChild("Filename", model.m_filename);
+	metadata.SetChild("Quantize", model.m_quantized);
+	metadata.SetChild("Lods", model.m_lodCount);
 	return metadata;
 }
 }
@@ -21,16 +21,20 @@ public:
 	/**
 	 * Creates a new OBJ model, or finds one with the same values.
 	 * @param filename The file to load the OBJ model from.
+	 * @param quantize If the vertices are quantized, for large static geometry where the precision loss is not visible.
+	 * @param lodCount The number of simplified levels of detail generated after the full detail level.
 	 * @return The OBJ model with the requested values.
 	 */
-	static std::shared_ptr<ModelObj> Create(const std::string &filename);
+	static std::shared_ptr<ModelObj> Create(const std::string &filename, const bool &quantize = false, const uint32_t &lodCount = 0);
 
 	/**
 	 * Creates a new OBJ model.
 	 * @param filename The file to load the OBJ model from.
 	 * @param load If this resource will be loaded immediately, otherwise {@link ModelObj#Load} can be called later.
+	 * @param quantize If the vertices are quantized.
+	 * @param lodCount The number of simplified levels of detail generated.
 	 */
-	explicit ModelObj(std::string filename, const bool &load = true);
+	explicit ModelObj(std::string filename, const bool &load = true, const bool &quantize = false, const uint32_t &lodCount = 0);
 
 	void Load() override;
 
@@ -7,18 +7,13 @@ namespace acid
 {
 std::shared_ptr<ModelCube> ModelCube::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ModelCube>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ModelCube>(resource);
-	}
-
-	auto result = std::make_shared<ModelCube>(Vector3f::Zero);
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ModelCube>(Vector3f::Zero);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<ModelCube> ModelCube::Create(const Vector3f &extents)
@@ -8,18 +8,13 @@ namespace acid
 {
 std::shared_ptr<ModelDisk> ModelDisk::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ModelDisk>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ModelDisk>(resource);
-	}
-
-	auto result = std::make_shared<ModelDisk>(0.0f, 0.0f);
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ModelDisk>(0.0f, 0.0f);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<ModelDisk> ModelDisk::Create(const float &innerRadius, const float &outerRadius, const uint32_t &slices, const uint32_t &loops)
@@ -7,18 +7,13 @@ namespace acid
 {
 std::shared_ptr<ModelRectangle> ModelRectangle::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ModelRectangle>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ModelRectangle>(resource);
-	}
-
-	auto result = std::make_shared<ModelRectangle>(0.0f, 0.0f);
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ModelRectangle>(0.0f, 0.0f);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<ModelRectangle> ModelRectangle::Create(const float &min, const float &max)
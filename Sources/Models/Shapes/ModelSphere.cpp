@@ -8,18 +8,13 @@ namespace acid
 {
 std::shared_ptr<ModelSphere> ModelSphere::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ModelSphere>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ModelSphere>(resource);
-	}
-
-	auto result = std::make_shared<ModelSphere>(0.0f);
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ModelSphere>(0.0f);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<ModelSphere> ModelSphere::Create(const float &radius, const uint32_t &latitudeBands, const uint32_t &longitudeBands)
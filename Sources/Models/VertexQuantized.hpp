@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstring>
+#include "Maths/Vector2.hpp"
+#include "Maths/Vector3.hpp"
+#include "Graphics/Pipelines/Pipeline.hpp"
+#include "VertexDefault.hpp"
+
+namespace acid
+{
+/**
+ * @brief A compressed {@link VertexDefault} of 16 bytes, positions are normalized over the bounds of the model, uvs are half floats and normals are octahedral.
+ * Shaders rebuild the model space position as offset + position * scale, with the offset and scale of the model.
+ */
+class ACID_EXPORT VertexQuantized
+{
+public:
+	/**
+	 * Creates a new quantized vertex.
+	 * @param vertex The full precision vertex.
+	 * @param offset The smallest position of the model.
+	 * @param scale The size of the bounds of the model.
+	 */
+	VertexQuantized(const VertexDefault &vertex, const Vector3f &offset, const Vector3f &scale)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			auto normalized = scale[i] > 0.0f ? (vertex.m_position[i] - offset[i]) / scale[i] : 0.0f;
+			m_position[i] = static_cast<uint16_t>(std::round(std::clamp(normalized, 0.0f, 1.0f) * 65535.0f));
+		}
+
+		m_position[3] = 0;
+		m_uv[0] = FloatToHalf(vertex.m_uv.m_x);
+		m_uv[1] = FloatToHalf(vertex.m_uv.m_y);
+
+		// The normal is projected onto a octahedron, the lower half is folded over the upper half.
+		auto normal = vertex.m_normal;
+		auto length = std::abs(normal.m_x) + std::abs(normal.m_y) + std::abs(normal.m_z);
+		Vector2f encoded = length > 0.0f ? Vector2f(normal.m_x, normal.m_y) / length : Vector2f(0.0f, 0.0f);
+
+		if (normal.m_z < 0.0f)
+		{
+			encoded = Vector2f((1.0f - std::abs(encoded.m_y)) * (encoded.m_x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::abs(encoded.m_x)) * (encoded.m_y >= 0.0f ? 1.0f : -1.0f));
+		}
+
+		m_normal[0] = static_cast<int16_t>(std::round(std::clamp(encoded.m_x, -1.0f, 1.0f) * 32767.0f));
+		m_normal[1] = static_cast<int16_t>(std::round(std::clamp(encoded.m_y, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	static Shader::VertexInput GetVertexInput(const uint32_t &baseBinding = 0)
+	{
+		std::vector<VkVertexInputBindingDescription> bindingDescriptions = { 
+			VkVertexInputBindingDescription{ baseBinding, sizeof(VertexQuantized), VK_VERTEX_INPUT_RATE_VERTEX }
+		};
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+			VkVertexInputAttributeDescription{ 0, baseBinding, VK_FORMAT_R16G16B16A16_UNORM, offsetof(VertexQuantized, m_position) },
+			VkVertexInputAttributeDescription{ 1, baseBinding, VK_FORMAT_R16G16_SFLOAT, offsetof(VertexQuantized, m_uv) },
+			VkVertexInputAttributeDescription{ 2, baseBinding, VK_FORMAT_R16G16_SNORM, offsetof(VertexQuantized, m_normal) }
+		};
+		return Shader::VertexInput(bindingDescriptions, attributeDescriptions);
+	}
+
+	/**
+	 * Converts a float to a half float, values too small for a normal half are flushed to zero and values too large become infinity.
+	 * @param value The float.
+	 * @return The bits of the half float.
+	 */
+	static uint16_t FloatToHalf(const float &value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(float));
+
+		auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+		auto exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+		auto mantissa = bits & 0x7fffff;
+
+		if (((bits >> 23) & 0xff) == 0xff)
+		{
+			return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+		}
+
+		if (exponent <= 0)
+		{
+			return sign;
+		}
+
+		// Rounds to the nearest half, a carry out of the mantissa correctly moves up to the next exponent.
+		auto half = static_cast<uint32_t>(exponent << 10) | (mantissa >> 13);
+		half += (mantissa >> 12) & 1;
+
+		if (half >= 0x7c00)
+		{
+			return static_cast<uint16_t>(sign | 0x7c00);
+		}
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	uint16_t m_position[4];
+	uint16_t m_uv[2];
+	int16_t m_normal[2];
+};
+}
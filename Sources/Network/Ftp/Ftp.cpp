@@ -1,5 +1,7 @@
 #include "Ftp.hpp"
 
+#include "Helpers/String.hpp"
+#include "Network/HostResolver.hpp"
 #include "Network/IpAddress.hpp"
 
 namespace acid
@@ -26,6 +28,23 @@ FtpResponse Ftp::Connect(const IpAddress &server, const uint16_t &port, const Ti
 	return GetResponse();
 }
 
+FtpResponse Ftp::Connect(const std::string &server, const uint16_t &port, const Time &timeout)
+{
+	auto address = HostResolver::Get()->Resolve(server);
+
+	if (timeout != Time::Zero && address.wait_for(std::chrono::microseconds(timeout.AsMicroseconds())) != std::future_status::ready)
+	{
+		return FtpResponse(FtpResponse::Status::ConnectionFailed);
+	}
+
+	if (address.get() == IpAddress::None)
+	{
+		return FtpResponse(FtpResponse::Status::ConnectionFailed);
+	}
+
+	return Connect(address.get(), port, timeout);
+}
+
 FtpResponse Ftp::Login()
 {
 	return Login("anonymous", "user@sfml-dev.org");
@@ -128,38 +147,56 @@ FtpResponse Ftp::DeleteRemoteFile(const std::string &name)
 	return SendCommand("DELE", name);
 }
 
-FtpResponse Ftp::Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode)
+FtpResponse Ftp::Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode, const bool &resume)
 {
+	// Extract the filename from the file path
+	std::string filename = remoteFile;
+	std::string::size_type pos = filename.find_last_of("/\\");
+
+	if (pos != std::string::npos)
+	{
+		filename = filename.substr(pos + 1);
+	}
+
+	// Make sure the destination path ends with a slash.
+	std::string path = localPath;
+
+	if (!path.empty() && (path[path.size() - 1] != '\\') && (path[path.size() - 1] != '/'))
+	{
+		path += "/";
+	}
+
 	// Open a data channel using the given transfer mode.
 	FtpDataChannel data(*this);
 	FtpResponse response = data.Open(mode);
 
 	if (response.IsOk())
 	{
-		// Tell the server to start the transfer.
-		response = SendCommand("RETR", remoteFile);
+		// A partial file is continued from its size, the server replies to REST with 350 when it will restart the transfer there.
+		std::streamoff offset = 0;
 
-		if (response.IsOk())
+		if (resume)
 		{
-			// Extract the filename from the file path
-			std::string filename = remoteFile;
-			std::string::size_type pos = filename.find_last_of("/\\");
+			std::ifstream existing((path + filename).c_str(), std::ios_base::binary | std::ios_base::ate);
 
-			if (pos != std::string::npos)
+			if (existing)
 			{
-				filename = filename.substr(pos + 1);
+				offset = existing.tellg();
 			}
+		}
 
-			// Make sure the destination path ends with a slash.
-			std::string path = localPath;
+		if (offset > 0 && SendCommand("REST", String::To(offset)).GetStatus() != FtpResponse::Status::NeedInformation)
+		{
+			offset = 0;
+		}
 
-			if (!path.empty() && (path[path.size() - 1] != '\\') && (path[path.size() - 1] != '/'))
-			{
-				path += "/";
-			}
+		// Tell the server to start the transfer.
+		response = SendCommand("RETR", remoteFile);
 
-			// Create the file and truncate it if necessary.
-			std::ofstream file((path + filename).c_str(), std::ios_base::binary | std::ios_base::trunc);
+		if (response.IsOk())
+		{
+			// Create the file and truncate it if necessary, or append to it when restarting.
+			std::ofstream file((path + filename).c_str(), std::ios_base::binary | (offset > 0 ? std::ios_base::app : std::ios_base::trunc));
 
 			if (!file)
 			{
@@ -167,7 +204,7 @@ FtpResponse Ftp::Download(const std::string &remoteFile, const std::string &loca
 			}
 
 			// Receive the file data.
-			data.Receive(file);
+			auto written = data.Receive(file);
 
 			// Close the file.
 			file.close();
@@ -175,8 +212,13 @@ FtpResponse Ftp::Download(const std::string &remoteFile, const std::string &loca
 			// Get the response from the server.
 			response = GetResponse();
 
-			// If the download was unsuccessful, delete the partial file.
-			if (!response.IsOk())
+			if (!written && response.IsOk())
+			{
+				response = FtpResponse(FtpResponse::Status::InvalidFile);
+			}
+
+			// If the download was unsuccessful, delete the partial file unless it is to be resumed.
+			if (!response.IsOk() && !resume)
 			{
 				std::remove((path + filename).c_str());
 			}
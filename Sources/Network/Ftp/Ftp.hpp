@@ -61,6 +61,16 @@ public:
 	 **/
 	FtpResponse Connect(const IpAddress &server, const uint16_t &port = 21, const Time &timeout = Time::Zero);
 
+	/**
+	 * Connects to the specified FTP server by name, the name is resolved by acid::HostResolver so a recently used name is not looked up again.
+	 * The timeout limits both resolving the name and connecting to the server.
+	 * @param server Name or address of the FTP server to connect to. 
+	 * @param port Port used for the connection. 
+	 * @param timeout Maximum time to wait. 
+	 * @return Server response to the request. 
+	 **/
+	FtpResponse Connect(const std::string &server, const uint16_t &port = 21, const Time &timeout = Time::Zero);
+
 	/**
 	 * Close the connection with the server.
 	 * @return Server response to the request. 
@@ -162,13 +172,17 @@ public:
 	 * The filename of the distant file is relative to the current working directory of the server,
 	 * and the local destination path is relative to the current directory of your application.
 	 * If a file with the same filename as the distant file already exists in the local destination path,
-	 * it will be overwritten.
+	 * it will be overwritten, unless resuming where the existing file is taken as the start of the distant file
+	 * and only the rest is downloaded. A failed download is deleted, or kept to be resumed by a later download when resuming.
+	 * The file is written as it is received.
 	 * @param remoteFile Filename of the distant file to download. 
 	 * @param localPath The directory in which to put the file on the local computer. 
 	 * @param mode Transfer mode. 
+	 * @param resume Pass true to continue a partial file, if the server supports restarting transfers. 
 	 * @return Server response to the request. 
 	 **/
-	FtpResponse Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary);
+	FtpResponse Download(const std::string &remoteFile, const std::string &localPath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary,
+		const bool &resume = false);
 
 	/**
 	 * Upload a file to the server.
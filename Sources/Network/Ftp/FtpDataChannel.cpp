@@ -76,37 +76,41 @@ FtpResponse FtpDataChannel::Open(const Mode &mode)
 	return response;
 }
 
-void FtpDataChannel::Receive(std::ostream &stream)
+bool FtpDataChannel::Receive(std::ostream &stream)
 {
 	// Receive data.
-	char buffer[1024];
+	std::unique_ptr<char[]> buffer(new char[BlockSize]);
 	std::size_t received;
+	bool written = true;
 
-	while (m_dataSocket.Receive(buffer, sizeof(buffer), received) == Socket::Status::Done)
+	while (m_dataSocket.Receive(buffer.get(), BlockSize, received) == Socket::Status::Done)
 	{
-		stream.write(buffer, static_cast<std::streamsize>(received));
+		stream.write(buffer.get(), static_cast<std::streamsize>(received));
 
 		if (!stream.good())
 		{
 			Log::Error("FTP Error: Writing to the file has failed\n");
+			written = false;
 			break;
 		}
 	}
 
 	// Close the data socket.
 	m_dataSocket.Disconnect();
+	return written;
 }
 
-void FtpDataChannel::Send(std::istream &stream)
+bool FtpDataChannel::Send(std::istream &stream)
 {
 	// Send data.
-	char buffer[1024];
+	std::unique_ptr<char[]> buffer(new char[BlockSize]);
 	std::size_t count;
+	bool sent = false;
 
 	for (;;)
 	{
 		// Read some data from the stream.
-		stream.read(buffer, sizeof(buffer));
+		stream.read(buffer.get(), BlockSize);
 
 		if (!stream.good() && !stream.eof())
 		{
@@ -119,7 +123,7 @@ void FtpDataChannel::Send(std::istream &stream)
 		if (count > 0)
 		{
 			// We could read more data from the stream: send them.
-			if (m_dataSocket.Send(buffer, count) != Socket::Status::Done)
+			if (m_dataSocket.Send(buffer.get(), count) != Socket::Status::Done)
 			{
 				break;
 			}
@@ -127,11 +131,13 @@ void FtpDataChannel::Send(std::istream &stream)
 		else
 		{
 			// No more data: exit the loop.
+			sent = true;
 			break;
 		}
 	}
 
 	// Close the data socket.
 	m_dataSocket.Disconnect();
+	return sent;
 }
 }
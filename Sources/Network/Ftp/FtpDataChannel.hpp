@@ -28,9 +28,22 @@ public:
 
 	FtpResponse Open(const Mode &mode);
 
-	void Send(std::istream &stream);
+	/**
+	 * Send a stream over the data channel and close it.
+	 * @param stream The stream to read from. 
+	 * @return If the whole stream was read and sent. 
+	 **/
+	bool Send(std::istream &stream);
+
+	/**
+	 * Receive the data channel into a stream, each block is written as it arrives so the transfer is never held in memory.
+	 * @param stream The stream to write to. 
+	 * @return If every block received was written. 
+	 **/
+	bool Receive(std::ostream &stream);
 
-	void Receive(std::ostream &stream);
+	/// Size of the blocks moved between the data channel and the stream.
+	static constexpr std::size_t BlockSize = 65536;
 
 private:
 	/// Reference to the owner Ftp instance.
@@ -0,0 +1,150 @@
+#include "FtpTransferPool.hpp"
+
+namespace acid
+{
+FtpTransferPool::FtpTransferPool(const IpAddress &server, const uint16_t &port, std::string name, std::string password, const uint32_t &connections,
+	const Time &timeout) :
+	m_server(server),
+	m_port(port),
+	m_name(std::move(name)),
+	m_password(std::move(password)),
+	m_timeout(timeout),
+	m_running(0),
+	m_stop(false)
+{
+	for (uint32_t i = 0; i < std::max(connections, 1u); i++)
+	{
+		m_workers.emplace_back([this]()
+		{
+			Run();
+		});
+	}
+}
+
+FtpTransferPool::~FtpTransferPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+
+	for (auto &worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+std::future<FtpResponse> FtpTransferPool::Download(std::string remoteFile, std::string localPath, const FtpDataChannel::Mode &mode, const bool &resume)
+{
+	return Queue([remoteFile = std::move(remoteFile), localPath = std::move(localPath), mode, resume](Ftp &ftp)
+	{
+		return ftp.Download(remoteFile, localPath, mode, resume);
+	});
+}
+
+std::future<FtpResponse> FtpTransferPool::Upload(std::string localFile, std::string remotePath, const FtpDataChannel::Mode &mode, const bool &append)
+{
+	return Queue([localFile = std::move(localFile), remotePath = std::move(remotePath), mode, append](Ftp &ftp)
+	{
+		return ftp.Upload(localFile, remotePath, mode, append);
+	});
+}
+
+std::size_t FtpTransferPool::GetPendingCount()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_queue.size() + m_running;
+}
+
+std::future<FtpResponse> FtpTransferPool::Queue(std::function<FtpResponse(Ftp &)> &&function)
+{
+	Transfer transfer;
+	transfer.m_function = std::move(function);
+	auto result = transfer.m_promise.get_future();
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_queue.emplace_back(std::move(transfer));
+	}
+
+	m_condition.notify_one();
+	return result;
+}
+
+void FtpTransferPool::Run()
+{
+	Ftp ftp;
+	bool connected = false;
+
+	for (;;)
+	{
+		Transfer transfer;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]()
+			{
+				return m_stop || !m_queue.empty();
+			});
+
+			// Transfers queued before stopping are still run.
+			if (m_queue.empty())
+			{
+				break;
+			}
+
+			transfer = std::move(m_queue.front());
+			m_queue.pop_front();
+			m_running++;
+		}
+
+		FtpResponse response;
+
+		// A connection that was idle may have been closed by the server, the transfer is run again on a new connection.
+		for (uint32_t attempt = 0; attempt < 2; attempt++)
+		{
+			auto reused = connected;
+
+			if (!connected)
+			{
+				response = ftp.Connect(m_server, m_port, m_timeout);
+
+				if (response.IsOk())
+				{
+					response = ftp.Login(m_name, m_password);
+				}
+
+				if (!response.IsOk())
+				{
+					break;
+				}
+
+				connected = true;
+			}
+
+			response = transfer.m_function(ftp);
+
+			if (response.GetStatus() != FtpResponse::Status::ConnectionClosed)
+			{
+				break;
+			}
+
+			connected = false;
+
+			if (!reused)
+			{
+				break;
+			}
+		}
+
+		transfer.m_promise.set_value(response);
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_running--;
+		}
+	}
+}
+}
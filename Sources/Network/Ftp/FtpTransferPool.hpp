@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+#include "Network/IpAddress.hpp"
+#include "Ftp.hpp"
+
+namespace acid
+{
+/**
+ * @brief Runs many FTP transfers at once over several connections to the same server.
+ * A FTP control connection carries one data transfer at a time, so each worker owns its own acid::Ftp connection
+ * and takes the next transfer from a shared queue. Workers connect and log in on their first transfer,
+ * and connect again when the server closes a idle connection.
+ **/
+class ACID_EXPORT FtpTransferPool :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates the pool, no connection is opened until a transfer is queued.
+	 * @param server Address of the FTP server. 
+	 * @param port Port of the FTP server. 
+	 * @param name Username to log in with. 
+	 * @param password Password to log in with. 
+	 * @param connections Number of connections, and of transfers run at once. 
+	 * @param timeout Maximum time to wait for each connection, zero uses the system timeout. 
+	 **/
+	explicit FtpTransferPool(const IpAddress &server, const uint16_t &port = 21, std::string name = "anonymous", std::string password = "user@sfml-dev.org",
+		const uint32_t &connections = 4, const Time &timeout = Time::Zero);
+
+	/**
+	 * Finishes the queued transfers and closes every connection.
+	 **/
+	~FtpTransferPool();
+
+	/**
+	 * Queues a download, see Ftp::Download.
+	 * @param remoteFile Filename of the distant file to download. 
+	 * @param localPath The directory in which to put the file on the local computer. 
+	 * @param mode Transfer mode. 
+	 * @param resume Pass true to continue a partial file. 
+	 * @return The future server response. 
+	 **/
+	std::future<FtpResponse> Download(std::string remoteFile, std::string localPath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary,
+		const bool &resume = false);
+
+	/**
+	 * Queues a upload, see Ftp::Upload.
+	 * @param localFile Path of the local file to upload. 
+	 * @param remotePath The directory in which to put the file on the server. 
+	 * @param mode Transfer mode. 
+	 * @param append Pass true to append to or false to overwrite the remote file if it already exists. 
+	 * @return The future server response. 
+	 **/
+	std::future<FtpResponse> Upload(std::string localFile, std::string remotePath, const FtpDataChannel::Mode &mode = FtpDataChannel::Mode::Binary,
+		const bool &append = false);
+
+	/**
+	 * Gets the number of transfers queued or running.
+	 * @return The number of transfers not finished. 
+	 **/
+	std::size_t GetPendingCount();
+
+private:
+	class Transfer
+	{
+	public:
+		std::function<FtpResponse(Ftp &)> m_function;
+		std::promise<FtpResponse> m_promise;
+	};
+
+	std::future<FtpResponse> Queue(std::function<FtpResponse(Ftp &)> &&function);
+
+	void Run();
+
+	IpAddress m_server;
+	uint16_t m_port;
+	std::string m_name;
+	std::string m_password;
+	Time m_timeout;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<Transfer> m_queue;
+	std::size_t m_running;
+	bool m_stop;
+	std::vector<std::thread> m_workers;
+};
+}
@@ -0,0 +1,95 @@
+#include "HostResolver.hpp"
+
+namespace acid
+{
+HostResolver::HostResolver() :
+	m_timeToLive(Time::Seconds(300)),
+	m_failureTimeToLive(Time::Seconds(10)),
+	m_nextId(1),
+	m_workers(MaxResolving)
+{
+}
+
+HostResolver::~HostResolver()
+{
+	m_workers.Wait();
+}
+
+HostResolver *HostResolver::Get()
+{
+	static HostResolver resolver;
+	return &resolver;
+}
+
+std::shared_future<IpAddress> HostResolver::Resolve(const std::string &address)
+{
+	if (auto parsed = IpAddress::Parse(address); parsed || address.empty())
+	{
+		std::promise<IpAddress> promise;
+		promise.set_value(parsed.value_or(IpAddress::None));
+		return promise.get_future().share();
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(address);
+
+	if (it != m_entries.end() && (!it->second.m_expires || Clock::now() < *it->second.m_expires))
+	{
+		return it->second.m_address;
+	}
+
+	Entry entry;
+	entry.m_id = m_nextId++;
+	// The lookup takes the lock to cache its result, so it can not finish before the entry is stored.
+	entry.m_address = m_workers.Enqueue([this, address, id = entry.m_id]()
+	{
+		return Lookup(address, id);
+	}).share();
+
+	auto result = entry.m_address;
+	m_entries[address] = std::move(entry);
+	return result;
+}
+
+std::optional<IpAddress> HostResolver::Find(const std::string &address)
+{
+	if (auto parsed = IpAddress::Parse(address))
+	{
+		return parsed;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(address);
+
+	if (it == m_entries.end() || !it->second.m_expires || Clock::now() >= *it->second.m_expires ||
+		it->second.m_address.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return std::nullopt;
+	}
+
+	return it->second.m_address.get();
+}
+
+void HostResolver::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+}
+
+IpAddress HostResolver::Lookup(const std::string &address, const uint64_t &id)
+{
+	auto resolved = IpAddress(address);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(address);
+
+	// The entry may have been cleared, or replaced after it was cleared.
+	if (it != m_entries.end() && it->second.m_id == id)
+	{
+		auto timeToLive = resolved != IpAddress::None ? m_timeToLive : m_failureTimeToLive;
+		it->second.m_expires = Clock::now() + std::chrono::microseconds(timeToLive.AsMicroseconds());
+	}
+
+	return resolved;
+}
+}
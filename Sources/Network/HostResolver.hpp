@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+#include "Helpers/ThreadPool.hpp"
+#include "IpAddress.hpp"
+
+namespace acid
+{
+/**
+ * @brief Resolves host names on worker threads and caches the addresses, so resolving never stalls the calling thread.
+ * Requests for a name already being resolved share its result, and resolved names are reused until their time to live passes.
+ * getaddrinfo does not report the records time to live, so every cached name uses the resolvers time to live,
+ * names that failed to resolve are cached for a shorter time so a missing host is not looked up on every request.
+ * Decimal addresses are parsed on the calling thread and never cached.
+ **/
+class ACID_EXPORT HostResolver :
+	public NonCopyable
+{
+public:
+	HostResolver();
+
+	~HostResolver();
+
+	/**
+	 * Gets the resolver shared by acid::Http and acid::Ftp.
+	 * @return The shared resolver.
+	 **/
+	static HostResolver *Get();
+
+	/**
+	 * Resolves a host name, returns immediately.
+	 * @param address IP address or network name. 
+	 * @return The future address, acid::IpAddress::None if the name could not be resolved. 
+	 **/
+	std::shared_future<IpAddress> Resolve(const std::string &address);
+
+	/**
+	 * Finds the address of a name that has finished resolving and has not expired, never resolves the name.
+	 * @param address IP address or network name. 
+	 * @return The cached address. 
+	 **/
+	std::optional<IpAddress> Find(const std::string &address);
+
+	/**
+	 * Removes every cached name, names being resolved finish but are not cached.
+	 **/
+	void Clear();
+
+	const Time &GetTimeToLive() const { return m_timeToLive; }
+
+	void SetTimeToLive(const Time &timeToLive) { m_timeToLive = timeToLive; }
+
+	const Time &GetFailureTimeToLive() const { return m_failureTimeToLive; }
+
+	void SetFailureTimeToLive(const Time &failureTimeToLive) { m_failureTimeToLive = failureTimeToLive; }
+
+	/// Names resolved at the same time.
+	static constexpr uint32_t MaxResolving = 2;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	class Entry
+	{
+	public:
+		std::shared_future<IpAddress> m_address;
+		/// Set once resolved, until then the entry never expires.
+		std::optional<Clock::time_point> m_expires;
+		uint64_t m_id = 0;
+	};
+
+	IpAddress Lookup(const std::string &address, const uint64_t &id);
+
+	Time m_timeToLive;
+	Time m_failureTimeToLive;
+	std::unordered_map<std::string, Entry> m_entries;
+	uint64_t m_nextId;
+	std::mutex m_mutex;
+	/// Destroyed first so no lookup outlives the cache.
+	ThreadPool m_workers;
+};
+}
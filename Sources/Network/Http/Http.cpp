@@ -16,6 +16,16 @@ Http::Http(const std::string &host, const uint16_t &port) :
 	SetHost(host, port);
 }
 
+Http::~Http()
+{
+	// Requests still queued are run before the workers stop, so every future gets its response.
+	if (m_workers)
+	{
+		m_workers->Wait();
+		m_workers.reset();
+	}
+}
+
 void Http::SetHost(const std::string &host, const uint16_t &port)
 {
 	// Check the protocol.
@@ -45,79 +55,352 @@ void Http::SetHost(const std::string &host, const uint16_t &port)
 		m_hostName.erase(m_hostName.size() - 1);
 	}
 
-	m_host = IpAddress(m_hostName);
+	m_host = HostResolver::Get()->Resolve(m_hostName);
+	CloseIdleConnections();
 }
 
 HttpResponse Http::SendRequest(const HttpRequest &request, const Time &timeout)
 {
-	// First make sure that the request is valid -- add missing mandatory fields.
-	HttpRequest toSend(request);
+	return Send(request, nullptr, timeout);
+}
 
-	if (!toSend.HasField("From"))
+HttpResponse Http::SendRequest(const HttpRequest &request, const BodySink &sink, const Time &timeout)
+{
+	return Send(request, &sink, timeout);
+}
+
+HttpResponse Http::Download(const HttpRequest &request, const std::string &filename, const Time &timeout)
+{
+	std::ofstream file(filename, std::ios::out | std::ios::binary);
+
+	if (!file)
 	{
-		toSend.SetField("From", "user@sfml-dev.org");
+		Log::Error("Failed to open file for download: '%s'\n", filename.c_str());
+		return HttpResponse();
 	}
 
-	if (!toSend.HasField("User-Agent"))
+	return SendRequest(request, [&file](const char *data, const std::size_t &size)
 	{
-		toSend.SetField("User-Agent", "libsfml-network/2.x");
-	}
+		file.write(data, static_cast<std::streamsize>(size));
+		return file.good();
+	}, timeout);
+}
 
-	if (!toSend.HasField("Host"))
+std::future<HttpResponse> Http::SendRequestAsync(const HttpRequest &request, const Time &timeout)
+{
 	{
-		toSend.SetField("Host", m_hostName);
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_workers)
+		{
+			m_workers = std::make_unique<ThreadPool>(static_cast<uint32_t>(MaxConnections));
+		}
 	}
 
-	if (!toSend.HasField("Content-Length"))
+	return m_workers->Enqueue([this, request, timeout]()
 	{
-		std::ostringstream out;
-		out << toSend.m_body.size();
-		toSend.SetField("Content-Length", out.str());
+		return Send(request, nullptr, timeout);
+	});
+}
+
+void Http::CloseIdleConnections()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_idle.clear();
+}
+
+HttpResponse Http::Send(const HttpRequest &request, const BodySink *sink, const Time &timeout)
+{
+	// First make sure that the request is valid -- missing mandatory fields are written after the requests own fields, so it is not copied.
+	HttpRequest::FieldTable defaults = {
+		{ "from", "user@sfml-dev.org" },
+		{ "user-agent", "libsfml-network/2.x" },
+		{ "host", m_hostName },
+		{ "content-length", String::To(request.m_body.size()) },
+		// HTTP 1.1 connections are persistent by default, HTTP 1.0 servers only keep the connection alive when asked to.
+		{ "connection", "keep-alive" }
+	};
+
+	if (request.m_method == HttpRequest::Method::Post)
+	{
+		defaults.emplace("content-type", "application/x-www-form-urlencoded");
 	}
 
-	if ((toSend.m_method == HttpRequest::Method::Post) && !toSend.HasField("Content-Type"))
+	auto header = request.Prepare(defaults);
+	auto head = request.m_method == HttpRequest::Method::Head;
+	auto connectionField = request.m_fields.find("connection");
+	auto closeRequested = connectionField != request.m_fields.end() && String::Lowercase(connectionField->second) == "close";
+
+	// Prepare the response.
+	HttpResponse response;
+
+	// A server may close a idle connection kept alive just as it is reused, when the reused connection closes
+	// before any of the response is received the request is sent again on a new connection.
+	for (uint32_t attempt = 0; attempt < 2; attempt++)
 	{
-		toSend.SetField("Content-Type", "application/x-www-form-urlencoded");
+		bool reused = false;
+		auto connection = AcquireConnection(timeout, reused);
+
+		if (!connection)
+		{
+			break;
+		}
+
+		bool received = false;
+		response = HttpResponse();
+
+		if (Exchange(*connection, header, request.m_body, head, sink, response, received) && !closeRequested)
+		{
+			ReleaseConnection(std::move(connection));
+		}
+
+		if (received || !reused)
+		{
+			break;
+		}
 	}
 
-	if ((toSend.m_majorVersion * 10 + toSend.m_minorVersion >= 11) && !toSend.HasField("Connection"))
+	return response;
+}
+
+bool Http::Exchange(TcpSocket &connection, const std::string &header, const std::string &body, const bool &head, const BodySink *sink,
+	HttpResponse &response, bool &received)
+{
+	// The header and body are gathered by a single call, so a large body is not copied behind the header.
+	std::pair<const void *, std::size_t> buffers[] = { { header.data(), header.size() }, { body.data(), body.size() } };
+	std::size_t sent;
+
+	if (connection.Send(buffers, TcpSocket::MaxSendBuffers, 0, sent) != Socket::Status::Done)
 	{
-		toSend.SetField("Connection", "close");
+		return false;
 	}
 
-	// Prepare the response.
-	HttpResponse received;
+	// Bytes received and not parsed yet.
+	std::string buffer;
+	char chunk[4096];
 
-	// Connect the socket to the host.
-	if (m_connection.Connect(m_host, m_port, timeout) == Socket::Status::Done)
+	auto fill = [&]()
 	{
-		// Convert the request to string and send it through the connected socket.
-		std::string requestStr = toSend.Prepare();
+		std::size_t size = 0;
 
-		if (!requestStr.empty())
+		if (connection.Receive(chunk, sizeof(chunk), size) != Socket::Status::Done)
 		{
-			// Send it through the socket.
-			if (m_connection.Send(requestStr.c_str(), requestStr.size()) == Socket::Status::Done)
+			return false;
+		}
+
+		buffer.append(chunk, size);
+		received = true;
+		return true;
+	};
+
+	auto readBody = [&](std::size_t remaining)
+	{
+		while (remaining > 0)
+		{
+			if (buffer.empty() && !fill())
 			{
-				// Wait for the server's response.
-				std::string receivedStr;
-				std::size_t size = 0;
-				char buffer[1024];
+				return false;
+			}
 
-				while (m_connection.Receive(buffer, sizeof(buffer), size) == Socket::Status::Done)
+			auto size = std::min(remaining, buffer.size());
+
+			if (sink != nullptr)
+			{
+				if (!(*sink)(buffer.data(), size))
 				{
-					receivedStr.append(buffer, buffer + size);
+					return false;
 				}
+			}
+			else
+			{
+				response.m_body.append(buffer.data(), size);
+			}
 
-				// Build the Response object from the received data.
-				received.Parse(receivedStr);
+			buffer.erase(0, size);
+			remaining -= size;
+		}
+
+		return true;
+	};
+
+	// Informational responses, such as 100 Continue, are followed by the final response.
+	do
+	{
+		std::size_t headerEnd;
+
+		while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+		{
+			if (!fill())
+			{
+				response.m_status = received ? HttpResponse::Status::InvalidResponse : HttpResponse::Status::ConnectionFailed;
+				return false;
 			}
 		}
 
-		// Close the connection.
-		m_connection.Disconnect();
+		response.ParseHeader(buffer.substr(0, headerEnd + 4));
+		buffer.erase(0, headerEnd + 4);
+
+		if (response.m_status == HttpResponse::Status::InvalidResponse)
+		{
+			return false;
+		}
+	}
+	while (static_cast<int32_t>(response.m_status) >= 100 && static_cast<int32_t>(response.m_status) < 200);
+
+	auto status = static_cast<int32_t>(response.m_status);
+	auto contentLength = response.GetField("content-length");
+
+	if (head || status == 204 || status == 304)
+	{
+		// These responses never have a body, whatever their fields say.
 	}
+	else if (String::Lowercase(response.GetField("transfer-encoding")) == "chunked")
+	{
+		// Chunked - have to read chunk by chunk, identified by a chunk-size not being 0.
+		while (true)
+		{
+			std::size_t lineEnd;
 
-	return received;
+			while ((lineEnd = buffer.find("\r\n")) == std::string::npos)
+			{
+				if (!fill())
+				{
+					return false;
+				}
+			}
+
+			// The chunk-size is hexadecimal, any chunk-extension after it is ignored.
+			char *end = nullptr;
+			auto length = std::strtoull(buffer.c_str(), &end, 16);
+
+			if (end == buffer.c_str())
+			{
+				response.m_status = HttpResponse::Status::InvalidResponse;
+				return false;
+			}
+
+			buffer.erase(0, lineEnd + 2);
+
+			if (length == 0)
+			{
+				break;
+			}
+
+			if (!readBody(static_cast<std::size_t>(length)))
+			{
+				return false;
+			}
+
+			// Drop the line break after the chunk data.
+			while (buffer.size() < 2)
+			{
+				if (!fill())
+				{
+					return false;
+				}
+			}
+
+			buffer.erase(0, 2);
+		}
+
+		// Read all trailers (if present), each is a line and they end with a empty line.
+		std::size_t lineEnd;
+
+		while ((lineEnd = buffer.find("\r\n")) != 0)
+		{
+			if (lineEnd == std::string::npos)
+			{
+				if (!fill())
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			std::istringstream in(buffer.substr(0, lineEnd + 2));
+			response.ParseFields(in);
+			buffer.erase(0, lineEnd + 2);
+		}
+
+		buffer.erase(0, 2);
+	}
+	else if (!contentLength.empty())
+	{
+		if (!readBody(static_cast<std::size_t>(std::strtoull(contentLength.c_str(), nullptr, 10))))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// Without a length the body ends when the server closes the connection.
+		while (readBody(buffer.size()) && fill())
+		{
+		}
+
+		return false;
+	}
+
+	// The connection is reused only when the server keeps it alive and nothing follows the response.
+	auto connectionField = String::Lowercase(response.GetField("connection"));
+	auto persistent = response.m_majorVersion * 10 + response.m_minorVersion >= 11 ? connectionField != "close" : connectionField == "keep-alive";
+	return persistent && buffer.empty();
+}
+
+std::unique_ptr<TcpSocket> Http::AcquireConnection(const Time &timeout, bool &reused)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_idle.empty())
+		{
+			auto connection = std::move(m_idle.back());
+			m_idle.pop_back();
+			reused = true;
+			return connection;
+		}
+	}
+
+	reused = false;
+
+	if (!m_host.valid())
+	{
+		return nullptr;
+	}
+
+	// The time spent resolving the host counts towards the timeout.
+	if (timeout != Time::Zero && m_host.wait_for(std::chrono::microseconds(timeout.AsMicroseconds())) != std::future_status::ready)
+	{
+		return nullptr;
+	}
+
+	auto host = m_host.get();
+
+	if (host == IpAddress::None)
+	{
+		return nullptr;
+	}
+
+	auto connection = std::make_unique<TcpSocket>();
+
+	// Connect the socket to the host.
+	if (connection->Connect(host, m_port, timeout) != Socket::Status::Done)
+	{
+		return nullptr;
+	}
+
+	return connection;
+}
+
+void Http::ReleaseConnection(std::unique_ptr<TcpSocket> connection)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Connections beyond the most kept alive are closed as they are destroyed.
+	if (m_idle.size() < MaxConnections)
+	{
+		m_idle.emplace_back(std::move(connection));
+	}
 }
 }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+#include "Helpers/ThreadPool.hpp"
 #include "Network/Tcp/TcpSocket.hpp"
-#include "Network/IpAddress.hpp"
+#include "Network/HostResolver.hpp"
 #include "HttpRequest.hpp"
 #include "HttpResponse.hpp"
 
@@ -32,10 +35,20 @@ namespace acid
  * acid::Http provides a simple function, SendRequest, to send a acid::HttpRequest and
  * return the corresponding acid::HttpResponse
  * from the server.
+ *
+ * Connections are kept alive and reused by later requests to the same host, so only the first request pays the TCP handshake.
+ * Requests sent with SendRequestAsync run on the clients own workers, each on its own pooled connection,
+ * and a response body can be streamed to a sink or a file instead of being kept in the response.
  **/
-class ACID_EXPORT Http
+class ACID_EXPORT Http :
+	public NonCopyable
 {
 public:
+	/**
+	 * A function given each part of a response body as it is received, returns false to stop receiving the body.
+	 **/
+	using BodySink = std::function<bool(const char *data, const std::size_t &size)>;
+
 	/**
 	 * Default constructor.
 	 **/
@@ -52,12 +65,19 @@ public:
 	 **/
 	Http(const std::string &host, const uint16_t &port = 0);
 
+	/**
+	 * Waits for every asynchronous request to finish and closes the pooled connections.
+	 **/
+	~Http();
+
 	/**
 	 * Set the target host.
 	 * This function just stores the host address and port, it doesn't actually connect to it until you send a request.
+	 * The host name is resolved by acid::HostResolver, the first request waits for it to finish resolving.
 	 * The port has a default value of 0, which means that the HTTP client will use the right port according to the
 	 * protocol used (80 for HTTP). You should leave it like this unless you really need a port other than the
 	 * standard one, or use an unknown protocol.
+	 * The connections kept alive to the previous host are closed, the host must not be changed while asynchronous requests are running.
 	 * @param host Web server to connect to. 
 	 * @param port Port to use for connection. 
 	 **/
@@ -68,22 +88,81 @@ public:
 	 * You must have a valid host before sending a request (see setHost).
 	 * Any missing mandatory header field in the request will be added with an appropriate value.
 	 * Warning: this function waits for the server's response and may not return instantly;
-	 * use a thread if you don't want to block your application, or use a timeout to limit the time to wait.
+	 * use SendRequestAsync if you don't want to block your application, or use a timeout to limit the time to wait.
 	 * A value of Time::ZERO means that the client will use the system default timeout (which is usually pretty long).
 	 * @param request Request to send. 
-	 * @param timeout Maximum time to wait. 
+	 * @param timeout Maximum time to connect. 
 	 * @return Server's response. 
 	 **/
 	HttpResponse SendRequest(const HttpRequest &request, const Time &timeout = Time::Zero);
 
+	/**
+	 * Send a HTTP request and give the response body to a sink as it is received, the body of the returned response is empty.
+	 * The call still waits for the whole response, the body is just never held in memory.
+	 * @param request Request to send. 
+	 * @param sink The function given each part of the body. 
+	 * @param timeout Maximum time to connect. 
+	 * @return Server's response. 
+	 **/
+	HttpResponse SendRequest(const HttpRequest &request, const BodySink &sink, const Time &timeout = Time::Zero);
+
+	/**
+	 * Send a HTTP request and write the response body to a file as it is received.
+	 * @param request Request to send. 
+	 * @param filename The file to write the body to, it is replaced if it exists. 
+	 * @param timeout Maximum time to connect. 
+	 * @return Server's response, with a empty body. 
+	 **/
+	HttpResponse Download(const HttpRequest &request, const std::string &filename, const Time &timeout = Time::Zero);
+
+	/**
+	 * Send a HTTP request from one of the clients workers, returns immediately.
+	 * Requests started while every worker is busy wait for the first worker to finish.
+	 * @param request Request to send, it is copied. 
+	 * @param timeout Maximum time to connect. 
+	 * @return The future server's response. 
+	 **/
+	std::future<HttpResponse> SendRequestAsync(const HttpRequest &request, const Time &timeout = Time::Zero);
+
+	/**
+	 * Closes the connections kept alive that are not in use.
+	 **/
+	void CloseIdleConnections();
+
+	/// Most connections kept alive to the host, and the number of workers running asynchronous requests.
+	static constexpr std::size_t MaxConnections = 4;
+
 private:
-	/// Connection to the host.
-	TcpSocket m_connection;
-	/// Web host address.
-	IpAddress m_host;
+	HttpResponse Send(const HttpRequest &request, const BodySink *sink, const Time &timeout);
+
+	/**
+	 * Send a request over a connection and receive the response.
+	 * @param connection The connection, already connected to the host. 
+	 * @param header The request header. 
+	 * @param body The request body. 
+	 * @param head If the request is a HEAD request, the response of which has no body. 
+	 * @param sink The sink given the body, or null to keep the body in the response. 
+	 * @param response The response to fill. 
+	 * @param received If any bytes of the response were received. 
+	 * @return If the connection can be reused by the next request. 
+	 **/
+	static bool Exchange(TcpSocket &connection, const std::string &header, const std::string &body, const bool &head, const BodySink *sink,
+		HttpResponse &response, bool &received);
+
+	std::unique_ptr<TcpSocket> AcquireConnection(const Time &timeout, bool &reused);
+
+	void ReleaseConnection(std::unique_ptr<TcpSocket> connection);
+
+	/// Web host address, resolved from the host name.
+	std::shared_future<IpAddress> m_host;
 	/// Web host name.
 	std::string m_hostName;
 	/// Port used for connection with host.
 	uint16_t m_port;
+	/// Connections kept alive that are not in use.
+	std::vector<std::unique_ptr<TcpSocket>> m_idle;
+	std::mutex m_mutex;
+	/// Workers running asynchronous requests, created by the first one, destroyed first so no request outlives the client.
+	std::unique_ptr<ThreadPool> m_workers;
 };
 }
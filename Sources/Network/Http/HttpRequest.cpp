@@ -35,7 +35,7 @@ void HttpRequest::SetHttpVersion(const uint32_t &major, const uint32_t &minor)
 	m_minorVersion = minor;
 }
 
-std::string HttpRequest::Prepare() const
+std::string HttpRequest::Prepare(const FieldTable &defaults) const
 {
 	std::ostringstream out;
 
@@ -83,12 +83,16 @@ std::string HttpRequest::Prepare() const
 		out << field.first << ": " << field.second << "\r\n";
 	}
 
+	for (const auto &field : defaults)
+	{
+		if (m_fields.find(field.first) == m_fields.end())
+		{
+			out << field.first << ": " << field.second << "\r\n";
+		}
+	}
+
 	// Use an extra \r\n to separate the header from the body.
 	out << "\r\n";
-
-	// Add the body.
-	out << m_body;
-
 	return out.str();
 }
 
@@ -81,11 +81,12 @@ private:
 	using FieldTable = std::map<std::string, std::string>;
 
 	/**
-	 * Prepare the final request to send to the server.
+	 * Prepare the header of the request to send to the server, the body is sent after it.
 	 * This is used internally by Http before sending the request to the web server.
-	 * @return String containing the request, ready to be sent. 
+	 * @param defaults Lowercase fields written when the request does not define them. 
+	 * @return String containing the request header, ready to be sent. 
 	 **/
-	std::string Prepare() const;
+	std::string Prepare(const FieldTable &defaults) const;
 
 	/**
 	 * Check if the request defines a field. This function uses case-insensitive comparisons.
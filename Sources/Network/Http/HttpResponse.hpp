@@ -108,11 +108,11 @@ private:
 	using FieldTable = std::map<std::string, std::string>;
 
 	/**
-	 * Construct the header from a response string.
+	 * Construct the header from the status line and fields of a response, the body is read by Http as it is received.
 	 * This function is used by Http to build the response of a request.
-	 * @param data Content of the response to parse. 
+	 * @param data Header of the response to parse, up to and including the empty line. 
 	 **/
-	void Parse(const std::string &data);
+	void ParseHeader(const std::string &data);
 
 	/**
 	 * Read values passed in the answer header.
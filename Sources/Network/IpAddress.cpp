@@ -115,7 +115,7 @@ IpAddress IpAddress::GetPublicAddress(const Time &timeout)
 
 	if (page.GetStatus() == HttpResponse::Status::Ok)
 	{
-		return IpAddress(page.GetBody());
+		return Parse(page.GetBody()).value_or(IpAddress());
 	}
 
 	// Something failed: return an invalid address.
@@ -166,49 +166,53 @@ std::istream &operator>>(std::istream &stream, IpAddress &address)
 	return stream;
 }
 
-void IpAddress::Resolve(const std::string &address)
+std::optional<IpAddress> IpAddress::Parse(const std::string &address)
 {
-	m_address = 0;
-	m_valid = false;
-
 	if (address == "255.255.255.255")
 	{
 		// The broadcast address needs to be handled explicitly, because it is also the value returned by inet_addr on error.
-		m_address = INADDR_BROADCAST;
-		m_valid = true;
+		return IpAddress(255, 255, 255, 255);
 	}
-	else if (address == "0.0.0.0")
+
+	if (address == "0.0.0.0")
 	{
-		m_address = INADDR_ANY;
-		m_valid = true;
+		return IpAddress(0, 0, 0, 0);
 	}
-	else
+
+	// Try to convert the address as a byte representation ("xxx.xxx.xxx.xxx").
+	uint32_t ip = inet_addr(address.c_str());
+
+	if (ip == INADDR_NONE)
+	{
+		return std::nullopt;
+	}
+
+	return IpAddress(ntohl(ip));
+}
+
+void IpAddress::Resolve(const std::string &address)
+{
+	m_address = 0;
+	m_valid = false;
+
+	if (auto parsed = Parse(address))
 	{
-		// Try to convert the address as a byte representation ("xxx.xxx.xxx.xxx").
-		uint32_t ip = inet_addr(address.c_str());
+		*this = *parsed;
+		return;
+	}
+
+	// Not a valid address, try to convert it as a host name.
+	addrinfo hints = {};
+	hints.ai_family = AF_INET;
+	addrinfo *result = nullptr;
 
-		if (ip != INADDR_NONE)
+	if (getaddrinfo(address.c_str(), nullptr, &hints, &result) == 0)
+	{
+		if (result)
 		{
-			m_address = ip;
+			m_address = reinterpret_cast<sockaddr_in *>(result->ai_addr)->sin_addr.s_addr;
 			m_valid = true;
-		}
-		else
-		{
-			// Not a valid address, try to convert it as a host name.
-			addrinfo hints = {};
-			hints.ai_family = AF_INET;
-			addrinfo *result = nullptr;
-
-			if (getaddrinfo(address.c_str(), nullptr, &hints, &result) == 0)
-			{
-				if (result)
-				{
-					ip = reinterpret_cast<sockaddr_in *>(result->ai_addr)->sin_addr.s_addr;
-					freeaddrinfo(result);
-					m_address = ip;
-					m_valid = true;
-				}
-			}
+			freeaddrinfo(result);
 		}
 	}
 }
@@ -20,6 +20,7 @@ public:
 	/**
 	 * Construct the address from a string.
 	 * Here \a address can be either a decimal address (ex: "192.168.1.56") or a network name (ex: "localhost").
+	 * Network names are resolved before this returns, which may take a long time, runtime code should resolve them with acid::HostResolver instead.
 	 * @param address IP address or network name. 
 	 **/
 	explicit IpAddress(const std::string &address);
@@ -44,6 +45,13 @@ public:
 	 **/
 	explicit IpAddress(const uint32_t &address);
 
+	/**
+	 * Parse a decimal address (ex: "192.168.1.56"), network names are not resolved.
+	 * @param address The decimal address. 
+	 * @return The address, or std::nullopt if the string is not a decimal address. 
+	 **/
+	static std::optional<IpAddress> Parse(const std::string &address);
+
 	/**
 	 * Get a string representation of the address.
 	 * The returned string is the decimal representation of the IP address (like "192.168.1.56"), even if it was constructed from a host name.
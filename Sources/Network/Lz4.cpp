@@ -0,0 +1,236 @@
+#include "Lz4.hpp"
+
+namespace acid
+{
+static const std::size_t MIN_MATCH = 4;
+// The last match must start this many bytes before the end of the block, and the last bytes must be literals.
+static const std::size_t MATCH_LIMIT = 12;
+static const std::size_t LAST_LITERALS = 5;
+static const std::size_t MAX_OFFSET = 65535;
+static const uint32_t HASH_BITS = 12;
+static const uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+static uint32_t Hash(const uint32_t &sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void WriteLength(std::vector<char> &destination, std::size_t length)
+{
+	while (length >= 255)
+	{
+		destination.emplace_back(static_cast<char>(255));
+		length -= 255;
+	}
+
+	destination.emplace_back(static_cast<char>(length));
+}
+
+std::size_t Lz4::Compress(const char *source, const std::size_t &size, std::vector<char> &destination, const char *dictionary, const std::size_t &dictionarySize)
+{
+	auto start = destination.size();
+	destination.reserve(start + GetBound(size));
+
+	// The dictionary and source are matched as one window, positions below the dictionary size are in the dictionary.
+	auto dictionaryUsed = dictionary != nullptr ? std::min(dictionarySize, MAX_OFFSET) : 0;
+	auto window = dictionaryUsed != 0 ? dictionary + dictionarySize - dictionaryUsed : nullptr;
+	auto total = dictionaryUsed + size;
+
+	auto at = [&](const std::size_t &position) -> uint8_t
+	{
+		return static_cast<uint8_t>(position < dictionaryUsed ? window[position] : source[position - dictionaryUsed]);
+	};
+	auto read32 = [&](const std::size_t &position) -> uint32_t
+	{
+		uint32_t value;
+
+		if (position >= dictionaryUsed)
+		{
+			std::memcpy(&value, source + position - dictionaryUsed, sizeof(value));
+			return value;
+		}
+
+		uint8_t bytes[4] = { at(position), at(position + 1), at(position + 2), at(position + 3) };
+		std::memcpy(&value, bytes, sizeof(value));
+		return value;
+	};
+	auto emit = [&](const std::size_t &anchor, const std::size_t &position, const std::size_t &offset, const std::size_t &matchLength)
+	{
+		auto literalLength = position - anchor;
+		auto token = static_cast<uint8_t>(std::min<std::size_t>(literalLength, 15) << 4);
+
+		if (matchLength != 0)
+		{
+			token |= static_cast<uint8_t>(std::min<std::size_t>(matchLength - MIN_MATCH, 15));
+		}
+
+		destination.emplace_back(static_cast<char>(token));
+
+		if (literalLength >= 15)
+		{
+			WriteLength(destination, literalLength - 15);
+		}
+
+		// Literals are never in the dictionary, matching starts at the source.
+		auto literals = source + anchor - dictionaryUsed;
+		destination.insert(destination.end(), literals, literals + literalLength);
+
+		if (matchLength != 0)
+		{
+			destination.emplace_back(static_cast<char>(offset & 0xFF));
+			destination.emplace_back(static_cast<char>(offset >> 8));
+
+			if (matchLength - MIN_MATCH >= 15)
+			{
+				WriteLength(destination, matchLength - MIN_MATCH - 15);
+			}
+		}
+	};
+
+	std::array<uint32_t, 1 << HASH_BITS> table;
+	table.fill(EMPTY);
+
+	for (std::size_t position = 0; position + MIN_MATCH <= dictionaryUsed; position++)
+	{
+		table[Hash(read32(position))] = static_cast<uint32_t>(position);
+	}
+
+	auto anchor = dictionaryUsed;
+
+	if (size > MATCH_LIMIT)
+	{
+		auto matchEnd = total - LAST_LITERALS;
+
+		for (auto position = dictionaryUsed; position < total - MATCH_LIMIT;)
+		{
+			auto sequence = read32(position);
+			auto hash = Hash(sequence);
+			auto candidate = table[hash];
+			table[hash] = static_cast<uint32_t>(position);
+
+			if (candidate == EMPTY || position - candidate > MAX_OFFSET || read32(candidate) != sequence)
+			{
+				position++;
+				continue;
+			}
+
+			auto matchLength = MIN_MATCH;
+
+			while (position + matchLength < matchEnd && at(candidate + matchLength) == at(position + matchLength))
+			{
+				matchLength++;
+			}
+
+			emit(anchor, position, position - candidate, matchLength);
+			position += matchLength;
+			anchor = position;
+		}
+	}
+
+	emit(anchor, total, 0, 0);
+	return destination.size() - start;
+}
+
+bool Lz4::Decompress(const char *source, const std::size_t &size, char *destination, const std::size_t &destinationSize, const char *dictionary,
+	const std::size_t &dictionarySize)
+{
+	auto bytes = reinterpret_cast<const uint8_t *>(source);
+	auto dictionaryUsed = dictionary != nullptr ? std::min(dictionarySize, MAX_OFFSET) : 0;
+	auto window = dictionaryUsed != 0 ? dictionary + dictionarySize - dictionaryUsed : nullptr;
+	std::size_t in = 0;
+	std::size_t out = 0;
+
+	auto readLength = [&](std::size_t &length) -> bool
+	{
+		uint8_t byte;
+
+		do
+		{
+			if (in >= size)
+			{
+				return false;
+			}
+
+			byte = bytes[in++];
+			length += byte;
+		}
+		while (byte == 255);
+
+		return true;
+	};
+
+	while (in < size)
+	{
+		auto token = bytes[in++];
+		std::size_t literalLength = token >> 4;
+
+		if (literalLength == 15 && !readLength(literalLength))
+		{
+			return false;
+		}
+
+		if (literalLength > size - in || literalLength > destinationSize - out)
+		{
+			return false;
+		}
+
+		std::memcpy(destination + out, source + in, literalLength);
+		in += literalLength;
+		out += literalLength;
+
+		// The last sequence has only literals.
+		if (in == size)
+		{
+			break;
+		}
+
+		if (in + 2 > size)
+		{
+			return false;
+		}
+
+		std::size_t offset = bytes[in] | bytes[in + 1] << 8;
+		in += 2;
+		std::size_t matchLength = token & 15;
+
+		if (matchLength == 15 && !readLength(matchLength))
+		{
+			return false;
+		}
+
+		matchLength += MIN_MATCH;
+
+		if (offset == 0 || offset > out + dictionaryUsed || matchLength > destinationSize - out)
+		{
+			return false;
+		}
+
+		// Matches may overlap the bytes they write, so they are copied a byte at a time.
+		for (std::size_t i = 0; i < matchLength; i++, out++)
+		{
+			destination[out] = offset > out ? window[dictionaryUsed + out - offset] : destination[out - offset];
+		}
+	}
+
+	return out == destinationSize;
+}
+
+uint32_t Lz4::GetDictionaryId(const char *dictionary, const std::size_t &dictionarySize)
+{
+	if (dictionary == nullptr || dictionarySize == 0)
+	{
+		return 0;
+	}
+
+	// FNV-1a, a id of zero is kept for no dictionary.
+	uint32_t hash = 2166136261u;
+
+	for (std::size_t i = 0; i < dictionarySize; i++)
+	{
+		hash ^= static_cast<uint8_t>(dictionary[i]);
+		hash *= 16777619u;
+	}
+
+	return hash != 0 ? hash : 1;
+}
+}
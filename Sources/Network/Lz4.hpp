@@ -0,0 +1,55 @@
+#pragma once
+
+#include "StdAfx.hpp"
+
+namespace acid
+{
+/**
+ * @brief Compresses network messages in the LZ4 block format, fast enough to compress every snapshot sent.
+ * A dictionary of data typical of the messages, such as a earlier snapshot, lets small messages match against it,
+ * the same dictionary must be given to both the compressor and the decompressor. Only the last 64KB of a dictionary are used.
+ **/
+class ACID_EXPORT Lz4
+{
+public:
+	/**
+	 * Gets the most bytes a source can compress to, for incompressible data.
+	 * @param size The size of the source. 
+	 * @return The compressed size bound. 
+	 **/
+	static constexpr std::size_t GetBound(const std::size_t &size) { return size + size / 255 + 16; }
+
+	/**
+	 * Compresses bytes, appending the block to the destination.
+	 * @param source The bytes to compress. 
+	 * @param size The number of bytes to compress. 
+	 * @param destination The vector the block is appended to. 
+	 * @param dictionary The dictionary, or null. 
+	 * @param dictionarySize The size of the dictionary. 
+	 * @return The size of the block. 
+	 **/
+	static std::size_t Compress(const char *source, const std::size_t &size, std::vector<char> &destination, const char *dictionary = nullptr,
+		const std::size_t &dictionarySize = 0);
+
+	/**
+	 * Decompresses a block into a destination the size of the uncompressed bytes.
+	 * @param source The block. 
+	 * @param size The size of the block. 
+	 * @param destination Where the bytes are written. 
+	 * @param destinationSize The number of uncompressed bytes. 
+	 * @param dictionary The dictionary the block was compressed with, or null. 
+	 * @param dictionarySize The size of the dictionary. 
+	 * @return If the block was valid and decompressed to exactly the destination size. 
+	 **/
+	static bool Decompress(const char *source, const std::size_t &size, char *destination, const std::size_t &destinationSize, const char *dictionary = nullptr,
+		const std::size_t &dictionarySize = 0);
+
+	/**
+	 * Gets a id for a dictionary, sent with compressed messages so a peer using another dictionary is detected.
+	 * @param dictionary The dictionary. 
+	 * @param dictionarySize The size of the dictionary. 
+	 * @return The dictionary id, zero if there is no dictionary. 
+	 **/
+	static uint32_t GetDictionaryId(const char *dictionary, const std::size_t &dictionarySize);
+};
+}
@@ -13,21 +13,92 @@
 
 namespace acid
 {
+// The most buffers each thread keeps for new packets.
+static const std::size_t POOL_BUFFERS = 64;
+// Larger buffers are freed, so one large packet does not keep its memory for the life of the thread.
+static const std::size_t POOL_MAX_CAPACITY = 1 << 16;
+
+/**
+ * @brief Buffers of packets destroyed on a thread, ready for the next packets created there.
+ */
+struct PacketPool
+{
+	PacketPool()
+	{
+		buffers.reserve(POOL_BUFFERS);
+	}
+
+	~PacketPool()
+	{
+		destroyed = true;
+	}
+
+	std::vector<std::vector<char>> buffers;
+	// Packets destroyed after their threads pool during thread exit free their own memory.
+	static thread_local bool destroyed;
+};
+
+thread_local bool PacketPool::destroyed = false;
+
+static PacketPool *GetPool()
+{
+	thread_local PacketPool pool;
+	return PacketPool::destroyed ? nullptr : &pool;
+}
+
 Packet::Packet() :
 	m_readPos(0),
 	m_sendPos(0),
 	m_isValid(true)
 {
+	auto pool = GetPool();
+
+	if (pool != nullptr && !pool->buffers.empty())
+	{
+		m_data = std::move(pool->buffers.back());
+		pool->buffers.pop_back();
+	}
+}
+
+Packet::~Packet()
+{
+	if (m_data.capacity() == 0 || m_data.capacity() > POOL_MAX_CAPACITY)
+	{
+		return;
+	}
+
+	auto pool = GetPool();
+
+	if (pool != nullptr && pool->buffers.size() < POOL_BUFFERS)
+	{
+		m_data.clear();
+		pool->buffers.emplace_back(std::move(m_data));
+	}
 }
 
 void Packet::Append(const void *data, const std::size_t &sizeInBytes)
 {
 	if (data && (sizeInBytes > 0))
 	{
-		auto start = m_data.size();
-		m_data.resize(start + sizeInBytes);
-		std::memcpy(&m_data[start], data, sizeInBytes);
+		std::memcpy(Extend(sizeInBytes), data, sizeInBytes);
+	}
+}
+
+void *Packet::Extend(const std::size_t &sizeInBytes)
+{
+	if (sizeInBytes == 0)
+	{
+		return nullptr;
 	}
+
+	auto start = m_data.size();
+	m_data.resize(start + sizeInBytes);
+	return &m_data[start];
+}
+
+void Packet::Reserve(const std::size_t &sizeInBytes)
+{
+	m_data.reserve(sizeInBytes);
 }
 
 void Packet::Clear()
@@ -360,14 +431,15 @@ Packet &Packet::operator<<(const char *data)
 
 Packet &Packet::operator<<(const std::string &data)
 {
-	// First insert string length.
+	// The length and characters are written with one extend.
 	auto length = static_cast<uint32_t>(data.size());
-	*this << length;
+	auto networkLength = htonl(length);
+	auto bytes = static_cast<char *>(Extend(sizeof(networkLength) + length * sizeof(std::string::value_type)));
+	std::memcpy(bytes, &networkLength, sizeof(networkLength));
 
-	// Then insert characters.
 	if (length > 0)
 	{
-		Append(data.c_str(), length * sizeof(std::string::value_type));
+		std::memcpy(bytes + sizeof(networkLength), data.c_str(), length * sizeof(std::string::value_type));
 	}
 
 	return *this;
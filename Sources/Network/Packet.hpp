@@ -19,6 +19,9 @@ namespace acid
  * to avoid possible differences between the sender and the receiver.
  * Indeed, the native C++ types may have different sizes on two platforms and your data may be
  * corrupted if that happens.
+ * 
+ * The memory of a destroyed packet is kept by its thread and given to the next packet created there,
+ * so a thread that builds a packet per message stops allocating once its packets have grown to their usual size.
  **/
 class ACID_EXPORT Packet
 {
@@ -27,11 +30,14 @@ public:
 	typedef bool (Packet::*BoolType)(const std::size_t &);
 
 	/**
-	 * Creates an empty packet.
+	 * Creates an empty packet, using a recycled buffer from this thread when one is free.
 	 **/
 	Packet();
 
-	virtual ~Packet() = default;
+	/**
+	 * Destructor that recycles the packets buffer for the next packet created on this thread.
+	 **/
+	virtual ~Packet();
 
 	/**
 	 * Append data to the end of the packet.
@@ -40,8 +46,30 @@ public:
 	 **/
 	void Append(const void *data, const std::size_t &sizeInBytes);
 
+	/**
+	 * Extend the packet by a number of bytes and get where to write them, so data can be written in place instead of copied by Append.
+	 * Warning: the returned pointer becomes invalid after more data is appended to the packet.
+	 * The bytes are written in the order they are sent, multi byte values must be converted to network byte order by the caller.
+	 * @param sizeInBytes Number of bytes to add. 
+	 * @return Pointer to the added bytes, or null if the size is zero. 
+	 **/
+	void *Extend(const std::size_t &sizeInBytes);
+
+	/**
+	 * Reserve memory for the packet to grow to a size without allocating, usually the size of the last packet of the same kind.
+	 * @param sizeInBytes The number of bytes to reserve. 
+	 **/
+	void Reserve(const std::size_t &sizeInBytes);
+
+	/**
+	 * Get the number of bytes the packet can hold before it allocates.
+	 * @return Capacity, in bytes. 
+	 **/
+	std::size_t GetCapacity() const { return m_data.capacity(); }
+
 	/**
 	 * Clear the packet, after calling Clear, the packet is empty.
+	 * The memory of the packet is kept, so it can be reused for another packet.
 	 **/
 	void Clear();
 
@@ -162,6 +190,7 @@ public:
 
 protected:
 	friend class TcpSocket;
+	friend class UdpConnection;
 	friend class UdpSocket;
 
 	/**
@@ -0,0 +1,269 @@
+#include "EntityState.hpp"
+
+#include "Helpers/EnumClass.hpp"
+#include "Network/Packet.hpp"
+
+namespace acid
+{
+// The fields written by a delta, a spawn writes every field.
+enum class StateField : uint8_t
+{
+	None = 0, Prefab = 1, Position = 2, Rotation = 4, Scaling = 8, Components = 16
+};
+
+ENABLE_BITMASK_OPERATORS(StateField)
+
+// Maps signed differences to unsigned so small negative values stay small, as in protocol buffers.
+static uint32_t ZigZag(const int32_t &value)
+{
+	return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t UnZigZag(const uint32_t &value)
+{
+	return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+EntityState::EntityState() :
+	m_position{},
+	m_rotation{},
+	m_scaling(Vector3f::One)
+{
+}
+
+Transform EntityState::GetTransform() const
+{
+	Vector3f position(static_cast<float>(m_position[0]), static_cast<float>(m_position[1]), static_cast<float>(m_position[2]));
+	Vector3f rotation(static_cast<float>(m_rotation[0]), static_cast<float>(m_rotation[1]), static_cast<float>(m_rotation[2]));
+	return Transform(position * PositionPrecision, rotation * (360.0f / 65536.0f), m_scaling);
+}
+
+void EntityState::SetTransform(const Transform &transform)
+{
+	const auto &position = transform.GetPosition();
+	const auto &rotation = transform.GetRotation();
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		m_position[i] = static_cast<int32_t>(std::round(position[i] / PositionPrecision));
+		auto turns = rotation[i] / 360.0f;
+		m_rotation[i] = static_cast<uint16_t>(static_cast<int32_t>(std::round((turns - std::floor(turns)) * 65536.0f)) & 0xFFFF);
+	}
+
+	m_scaling = transform.GetScaling();
+}
+
+void EntityState::WriteDelta(Packet &packet, const EntityState *baseline, const EntityState &state)
+{
+	BitMask<StateField> fields;
+
+	if (baseline == nullptr || baseline->m_prefab != state.m_prefab)
+	{
+		fields |= StateField::Prefab;
+	}
+
+	if (baseline == nullptr || baseline->m_position != state.m_position)
+	{
+		fields |= StateField::Position;
+	}
+
+	if (baseline == nullptr || baseline->m_rotation != state.m_rotation)
+	{
+		fields |= StateField::Rotation;
+	}
+
+	if (baseline == nullptr || baseline->m_scaling != state.m_scaling)
+	{
+		fields |= StateField::Scaling;
+	}
+
+	if (baseline == nullptr || baseline->m_components != state.m_components)
+	{
+		fields |= StateField::Components;
+	}
+
+	packet << fields.m_value;
+
+	if (fields & StateField::Prefab)
+	{
+		packet << state.m_prefab;
+	}
+
+	if (fields & StateField::Position)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			// Differences are taken with wrapping so every value round trips.
+			auto from = baseline != nullptr ? static_cast<uint32_t>(baseline->m_position[i]) : 0;
+			WriteVarint(packet, ZigZag(static_cast<int32_t>(static_cast<uint32_t>(state.m_position[i]) - from)));
+		}
+	}
+
+	if (fields & StateField::Rotation)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			auto from = baseline != nullptr ? baseline->m_rotation[i] : 0;
+			WriteVarint(packet, ZigZag(static_cast<int16_t>(static_cast<uint16_t>(state.m_rotation[i] - from))));
+		}
+	}
+
+	if (fields & StateField::Scaling)
+	{
+		packet << state.m_scaling.m_x << state.m_scaling.m_y << state.m_scaling.m_z;
+	}
+
+	if (fields & StateField::Components)
+	{
+		// Components the same as the baseline component at the same index are only a flag.
+		WriteVarint(packet, static_cast<uint32_t>(state.m_components.size()));
+
+		for (std::size_t i = 0; i < state.m_components.size(); i++)
+		{
+			auto same = baseline != nullptr && i < baseline->m_components.size() && baseline->m_components[i] == state.m_components[i];
+			packet << same;
+
+			if (!same)
+			{
+				packet << state.m_components[i].first << state.m_components[i].second;
+			}
+		}
+	}
+}
+
+bool EntityState::ReadDelta(Packet &packet, const EntityState *baseline, EntityState &state)
+{
+	BitMask<StateField> fields;
+
+	if (!(packet >> fields.m_value))
+	{
+		return false;
+	}
+
+	state = baseline != nullptr ? *baseline : EntityState();
+
+	if (fields & StateField::Prefab)
+	{
+		packet >> state.m_prefab;
+	}
+
+	if (fields & StateField::Position)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			uint32_t difference;
+
+			if (!ReadVarint(packet, difference))
+			{
+				return false;
+			}
+
+			state.m_position[i] = static_cast<int32_t>(static_cast<uint32_t>(state.m_position[i]) + static_cast<uint32_t>(UnZigZag(difference)));
+		}
+	}
+
+	if (fields & StateField::Rotation)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			uint32_t difference;
+
+			if (!ReadVarint(packet, difference))
+			{
+				return false;
+			}
+
+			state.m_rotation[i] = static_cast<uint16_t>(state.m_rotation[i] + UnZigZag(difference));
+		}
+	}
+
+	if (fields & StateField::Scaling)
+	{
+		packet >> state.m_scaling.m_x >> state.m_scaling.m_y >> state.m_scaling.m_z;
+	}
+
+	if (fields & StateField::Components)
+	{
+		uint32_t count;
+
+		// Each component is at least a byte, so a corrupt count cannot allocate more than the packet.
+		if (!ReadVarint(packet, count) || count > packet.GetDataSize())
+		{
+			return false;
+		}
+
+		std::vector<std::pair<std::string, std::string>> components(count);
+
+		for (uint32_t i = 0; i < count && packet; i++)
+		{
+			bool same = false;
+			packet >> same;
+
+			if (same)
+			{
+				if (baseline == nullptr || i >= baseline->m_components.size())
+				{
+					return false;
+				}
+
+				components[i] = baseline->m_components[i];
+				continue;
+			}
+
+			packet >> components[i].first >> components[i].second;
+		}
+
+		state.m_components = std::move(components);
+	}
+
+	return static_cast<bool>(packet);
+}
+
+void EntityState::WriteVarint(Packet &packet, const uint32_t &value)
+{
+	auto remaining = value;
+
+	while (remaining >= 0x80)
+	{
+		packet << static_cast<uint8_t>(remaining | 0x80);
+		remaining >>= 7;
+	}
+
+	packet << static_cast<uint8_t>(remaining);
+}
+
+bool EntityState::ReadVarint(Packet &packet, uint32_t &value)
+{
+	value = 0;
+
+	for (uint32_t shift = 0; shift < 35; shift += 7)
+	{
+		uint8_t byte;
+
+		if (!(packet >> byte))
+		{
+			return false;
+		}
+
+		value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool EntityState::operator==(const EntityState &other) const
+{
+	return m_prefab == other.m_prefab && m_position == other.m_position && m_rotation == other.m_rotation && m_scaling == other.m_scaling &&
+		m_components == other.m_components;
+}
+
+bool EntityState::operator!=(const EntityState &other) const
+{
+	return !(*this == other);
+}
+}
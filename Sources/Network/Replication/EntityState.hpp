@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Maths/Transform.hpp"
+
+namespace acid
+{
+class Packet;
+
+/**
+ * @brief The replicated state of a entity in a snapshot, with its transform quantized so unchanged values compare equal.
+ * States are written as a delta against the state the receiver already has, only the changed fields are sent and
+ * positions and rotations are sent as the difference from the baseline, which is a byte or two for a moving entity.
+ **/
+class ACID_EXPORT EntityState
+{
+public:
+	EntityState();
+
+	/**
+	 * Gets the transform the quantized state decodes to.
+	 * @return The transform.
+	 **/
+	Transform GetTransform() const;
+
+	/**
+	 * Quantizes a transform into the state, positions to PositionPrecision and rotations to 16 bits per axis.
+	 * @param transform The transform.
+	 **/
+	void SetTransform(const Transform &transform);
+
+	/**
+	 * Writes the fields of a state that differ from a baseline.
+	 * @param packet The packet to write to.
+	 * @param baseline The state the receiver already has, or null to write every field.
+	 * @param state The state to write.
+	 **/
+	static void WriteDelta(Packet &packet, const EntityState *baseline, const EntityState &state);
+
+	/**
+	 * Reads a state written by WriteDelta, fields that were not written are copied from the baseline.
+	 * @param packet The packet to read from.
+	 * @param baseline The same baseline the state was written against.
+	 * @param state The state to read into.
+	 * @return If the state was read.
+	 **/
+	static bool ReadDelta(Packet &packet, const EntityState *baseline, EntityState &state);
+
+	/**
+	 * Writes a integer in as few bytes as it needs, seven bits a byte.
+	 * @param packet The packet to write to.
+	 * @param value The value to write.
+	 **/
+	static void WriteVarint(Packet &packet, const uint32_t &value);
+
+	/**
+	 * Reads a integer written by WriteVarint.
+	 * @param packet The packet to read from.
+	 * @param value The value to read into.
+	 * @return If the value was read.
+	 **/
+	static bool ReadVarint(Packet &packet, uint32_t &value);
+
+	bool operator==(const EntityState &other) const;
+
+	bool operator!=(const EntityState &other) const;
+
+	/// Size of a position step in world units.
+	static constexpr float PositionPrecision = 1.0f / 512.0f;
+
+	std::string m_prefab;
+	std::array<int32_t, 3> m_position;
+	/// Rotation in degrees wrapped into [0, 360), as a fraction of a turn.
+	std::array<uint16_t, 3> m_rotation;
+	Vector3f m_scaling;
+	/// Registered names of the replicated components, with their metadata in binary.
+	std::vector<std::pair<std::string, std::string>> m_components;
+};
+}
@@ -0,0 +1,28 @@
+#include "Replicated.hpp"
+
+namespace acid
+{
+Replicated::Replicated(const std::string &prefab, const float &priority, std::vector<std::string> components) :
+	m_networkId(0),
+	m_prefab(prefab),
+	m_priority(priority),
+	m_components(std::move(components))
+{
+}
+
+const Metadata &operator>>(const Metadata &metadata, Replicated &replicated)
+{
+	metadata.GetChild("Prefab", replicated.m_prefab);
+	metadata.GetChild("Priority", replicated.m_priority);
+	metadata.GetChild("Components", replicated.m_components);
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const Replicated &replicated)
+{
+	metadata.SetChild("Prefab", replicated.m_prefab);
+	metadata.SetChild("Priority", replicated.m_priority);
+	metadata.SetChild("Components", replicated.m_components);
+	return metadata;
+}
+}
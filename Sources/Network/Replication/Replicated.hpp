@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Scenes/Component.hpp"
+
+namespace acid
+{
+/**
+ * @brief Component that marks a entity to be replicated to clients by a acid::ReplicationServer.
+ * The world transform of the entity is always replicated, other components of the entity are replicated
+ * by listing their registered names, they are sent with their metadata serialization when it changes.
+ **/
+class ACID_EXPORT Replicated :
+	public Component
+{
+public:
+	/**
+	 * Creates a new replicated component.
+	 * @param prefab The prefab clients create the entity from, empty creates a entity with only the replicated components.
+	 * @param priority How often the entity is sent compared to others at the same distance, when there is not room for every change.
+	 * @param components The registered names of the components replicated with the transform.
+	 **/
+	explicit Replicated(const std::string &prefab = "", const float &priority = 1.0f, std::vector<std::string> components = {});
+
+	/**
+	 * Gets the id of the entity shared by the server and clients, zero until the server first replicates it.
+	 * @return The network id.
+	 **/
+	const uint32_t &GetNetworkId() const { return m_networkId; }
+
+	void SetNetworkId(const uint32_t &networkId) { m_networkId = networkId; }
+
+	const std::string &GetPrefab() const { return m_prefab; }
+
+	void SetPrefab(const std::string &prefab) { m_prefab = prefab; }
+
+	const float &GetPriority() const { return m_priority; }
+
+	void SetPriority(const float &priority) { m_priority = priority; }
+
+	const std::vector<std::string> &GetComponents() const { return m_components; }
+
+	void SetComponents(const std::vector<std::string> &components) { m_components = components; }
+
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Replicated &replicated);
+
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Replicated &replicated);
+
+private:
+	uint32_t m_networkId;
+	std::string m_prefab;
+	float m_priority;
+	std::vector<std::string> m_components;
+};
+}
@@ -0,0 +1,177 @@
+#include "ReplicationClient.hpp"
+
+#include "Network/Packet.hpp"
+#include "Scenes/Scenes.hpp"
+#include "Serialized/Binary/Binary.hpp"
+#include "Replicated.hpp"
+
+namespace acid
+{
+ReplicationClient::ReplicationClient(SceneStructure &structure) :
+	m_structure(&structure),
+	m_latestSnapshot(0)
+{
+}
+
+std::optional<uint32_t> ReplicationClient::ReadSnapshot(Packet &packet)
+{
+	uint32_t snapshot = 0;
+	uint32_t removalCount = 0;
+
+	if (!(packet >> snapshot) || snapshot <= m_latestSnapshot || !EntityState::ReadVarint(packet, removalCount) || removalCount > packet.GetDataSize())
+	{
+		return std::nullopt;
+	}
+
+	std::vector<uint32_t> removals(removalCount);
+
+	for (auto &id : removals)
+	{
+		if (!EntityState::ReadVarint(packet, id))
+		{
+			return std::nullopt;
+		}
+	}
+
+	uint32_t updateCount = 0;
+
+	if (!EntityState::ReadVarint(packet, updateCount) || updateCount > packet.GetDataSize())
+	{
+		return std::nullopt;
+	}
+
+	// The whole snapshot is read before any of it is applied, so a snapshot with a missing baseline changes nothing.
+	std::unordered_map<uint32_t, EntityState> states;
+
+	for (uint32_t i = 0; i < updateCount; i++)
+	{
+		uint32_t id = 0;
+		uint32_t age = 0;
+
+		if (!EntityState::ReadVarint(packet, id) || !EntityState::ReadVarint(packet, age))
+		{
+			return std::nullopt;
+		}
+
+		const EntityState *baseline = nullptr;
+
+		if (age != 0)
+		{
+			auto record = std::find_if(m_history.begin(), m_history.end(), [&](const auto &record)
+			{
+				return record.first == snapshot - age;
+			});
+
+			if (record == m_history.end() || record->second.find(id) == record->second.end())
+			{
+				return std::nullopt;
+			}
+
+			baseline = &record->second.at(id);
+		}
+
+		if (!EntityState::ReadDelta(packet, baseline, states[id]))
+		{
+			return std::nullopt;
+		}
+	}
+
+	for (const auto &id : removals)
+	{
+		auto it = m_entities.find(id);
+
+		if (it != m_entities.end())
+		{
+			m_structure->Remove(it->second.first);
+			m_entities.erase(it);
+		}
+	}
+
+	for (const auto &[id, state] : states)
+	{
+		Apply(id, state);
+	}
+
+	m_latestSnapshot = snapshot;
+	m_history.emplace_back(snapshot, std::move(states));
+
+	if (m_history.size() > HistorySize)
+	{
+		m_history.pop_front();
+	}
+
+	return snapshot;
+}
+
+Entity *ReplicationClient::GetEntity(const uint32_t &networkId) const
+{
+	auto it = m_entities.find(networkId);
+	return it != m_entities.end() ? m_structure->Get(it->second.first) : nullptr;
+}
+
+void ReplicationClient::Apply(const uint32_t &id, const EntityState &state)
+{
+	auto &componentRegister = Scenes::Get()->GetComponentRegister();
+	auto &[handle, applied] = m_entities[id];
+	auto entity = m_structure->Get(handle);
+
+	if (entity == nullptr)
+	{
+		entity = state.m_prefab.empty() ? m_structure->CreateEntity(state.GetTransform()) : m_structure->CreateEntity(state.m_prefab, state.GetTransform());
+		handle = entity->GetHandle();
+		applied = EntityState();
+		auto replicated = entity->GetComponent<Replicated>(true);
+
+		if (replicated == nullptr)
+		{
+			replicated = entity->AddComponent<Replicated>(state.m_prefab);
+		}
+
+		replicated->SetNetworkId(id);
+	}
+	else if (state.m_position != applied.m_position || state.m_rotation != applied.m_rotation || state.m_scaling != applied.m_scaling)
+	{
+		entity->SetLocalTransform(state.GetTransform());
+	}
+
+	// Only components that changed since the state last applied are decoded, decoding can reset state the component keeps.
+	for (std::size_t i = 0; i < state.m_components.size(); i++)
+	{
+		const auto &[name, data] = state.m_components[i];
+
+		if (i < applied.m_components.size() && applied.m_components[i] == state.m_components[i])
+		{
+			continue;
+		}
+
+		Component *found = nullptr;
+
+		for (const auto &component : entity->GetComponents())
+		{
+			if (componentRegister.FindName(component.get()) == name)
+			{
+				found = component.get();
+				break;
+			}
+		}
+
+		if (found == nullptr)
+		{
+			found = componentRegister.Create(name);
+
+			if (found == nullptr)
+			{
+				continue;
+			}
+
+			entity->AddComponent(found);
+		}
+
+		Binary metadata;
+		metadata.Load(std::string_view(data));
+		componentRegister.Decode(name, metadata, found);
+	}
+
+	applied = state;
+}
+}
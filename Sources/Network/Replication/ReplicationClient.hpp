@@ -0,0 +1,62 @@
+#pragma once
+
+#include <deque>
+
+#include "Helpers/NonCopyable.hpp"
+#include "Scenes/EntityHandle.hpp"
+#include "EntityState.hpp"
+
+namespace acid
+{
+class Entity;
+class Packet;
+class SceneStructure;
+
+/**
+ * @brief Reads snapshots written by a acid::ReplicationServer, and spawns, updates and removes the replicated entities in a structure.
+ * The states read from recent snapshots are kept as the baselines of later deltas, the id returned by ReadSnapshot
+ * must be sent back to the server, which then writes the entities in later snapshots against the states in that snapshot.
+ **/
+class ACID_EXPORT ReplicationClient :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new replication client.
+	 * @param structure The structure entities are spawned into, it must outlive the client.
+	 **/
+	explicit ReplicationClient(SceneStructure &structure);
+
+	/**
+	 * Reads a snapshot and applies it to the structure, snapshots older than the latest read are ignored.
+	 * @param packet The packet containing the snapshot.
+	 * @return The id of the snapshot to acknowledge, or std::nullopt if the snapshot was not read.
+	 **/
+	std::optional<uint32_t> ReadSnapshot(Packet &packet);
+
+	/**
+	 * Gets the entity spawned for a network id.
+	 * @param networkId The network id.
+	 * @return The entity, or null if it is not spawned.
+	 **/
+	Entity *GetEntity(const uint32_t &networkId) const;
+
+	/**
+	 * Gets the id of the latest snapshot read.
+	 * @return The snapshot id, zero if no snapshot was read.
+	 **/
+	const uint32_t &GetLatestSnapshot() const { return m_latestSnapshot; }
+
+	/// Snapshots kept as baselines, twice the servers history so every baseline the server uses is kept.
+	static constexpr uint32_t HistorySize = 64;
+
+private:
+	void Apply(const uint32_t &id, const EntityState &state);
+
+	SceneStructure *m_structure;
+	uint32_t m_latestSnapshot;
+	/// The spawned entities, with the state last applied to each. Entities removed by the game are spawned again by the next state.
+	std::unordered_map<uint32_t, std::pair<EntityHandle, EntityState>> m_entities;
+	std::deque<std::pair<uint32_t, std::unordered_map<uint32_t, EntityState>>> m_history;
+};
+}
@@ -0,0 +1,232 @@
+#include "ReplicationServer.hpp"
+
+#include "Network/Packet.hpp"
+#include "Scenes/Scenes.hpp"
+#include "Serialized/Binary/Binary.hpp"
+#include "Replicated.hpp"
+
+namespace acid
+{
+ReplicationServer::ReplicationServer(SceneStructure &structure) :
+	m_structure(&structure),
+	m_nextNetworkId(1),
+	m_nextClient(1),
+	m_range(0.0f),
+	m_falloff(50.0f),
+	m_budget(1000)
+{
+}
+
+uint32_t ReplicationServer::AddClient()
+{
+	auto client = m_nextClient++;
+	m_clients[client];
+	return client;
+}
+
+void ReplicationServer::RemoveClient(const uint32_t &client)
+{
+	m_clients.erase(client);
+}
+
+void ReplicationServer::Update()
+{
+	auto &componentRegister = Scenes::Get()->GetComponentRegister();
+	m_sources.clear();
+
+	for (auto replicated : m_structure->ViewComponents<Replicated>())
+	{
+		auto entity = replicated->GetParent();
+
+		if (entity == nullptr || entity->IsRemoved())
+		{
+			continue;
+		}
+
+		if (replicated->GetNetworkId() == 0)
+		{
+			replicated->SetNetworkId(m_nextNetworkId++);
+		}
+
+		auto &source = m_sources[replicated->GetNetworkId()];
+		source.m_state.SetTransform(entity->GetWorldTransform());
+		source.m_state.m_prefab = replicated->GetPrefab();
+		source.m_position = entity->GetWorldTransform().GetPosition();
+		source.m_priority = replicated->GetPriority();
+
+		// Components are compared by their binary metadata, so only components that changed are sent.
+		for (const auto &name : replicated->GetComponents())
+		{
+			for (const auto &component : entity->GetComponents())
+			{
+				if (componentRegister.FindName(component.get()) != name)
+				{
+					continue;
+				}
+
+				Metadata metadata;
+				componentRegister.Encode(name, metadata, component.get());
+				std::ostringstream stream;
+				Binary(&metadata).Write(&stream);
+				source.m_state.m_components.emplace_back(name, stream.str());
+				break;
+			}
+		}
+	}
+}
+
+bool ReplicationServer::WriteSnapshot(const uint32_t &client, const Vector3f &viewer, Packet &packet)
+{
+	auto it = m_clients.find(client);
+
+	if (it == m_clients.end())
+	{
+		return false;
+	}
+
+	auto &state = it->second;
+	auto snapshot = state.m_nextSnapshot++;
+	std::vector<SentEntity> sent;
+
+	auto relevant = [this, &viewer](const Source &source, float &distance)
+	{
+		distance = source.m_position.Distance(viewer);
+		return m_range <= 0.0f || distance <= m_range;
+	};
+
+	// Entities the client may have that are destroyed or out of range are removed until the client acknowledges it.
+	std::vector<uint32_t> removals;
+
+	for (const auto &[id, entity] : state.m_entities)
+	{
+		auto source = m_sources.find(id);
+		float distance;
+
+		if (source == m_sources.end() || !relevant(source->second, distance))
+		{
+			removals.emplace_back(id);
+			sent.emplace_back(SentEntity{ id, true, {} });
+		}
+	}
+
+	std::vector<std::pair<float, uint32_t>> candidates;
+
+	for (const auto &[id, source] : m_sources)
+	{
+		float distance;
+
+		if (!relevant(source, distance))
+		{
+			continue;
+		}
+
+		auto entity = state.m_entities.find(id);
+
+		if (entity != state.m_entities.end() && entity->second.m_ackedSnapshot != 0 && entity->second.m_acked == source.m_state)
+		{
+			entity->second.m_accumulated = 0.0f;
+			continue;
+		}
+
+		auto &accumulated = state.m_entities[id].m_accumulated;
+		accumulated += source.m_priority / (1.0f + distance / m_falloff);
+		candidates.emplace_back(accumulated, id);
+	}
+
+	std::sort(candidates.begin(), candidates.end(), std::greater<>());
+
+	Packet updates;
+	Packet update;
+	uint32_t updateCount = 0;
+
+	for (const auto &[priority, id] : candidates)
+	{
+		auto &entity = state.m_entities[id];
+		const auto &source = m_sources[id];
+		auto hasBaseline = entity.m_ackedSnapshot != 0 && snapshot - entity.m_ackedSnapshot < HistorySize;
+
+		update.Clear();
+		EntityState::WriteVarint(update, id);
+		EntityState::WriteVarint(update, hasBaseline ? snapshot - entity.m_ackedSnapshot : 0);
+		EntityState::WriteDelta(update, hasBaseline ? &entity.m_acked : nullptr, source.m_state);
+
+		if (updateCount != 0 && updates.GetDataSize() + update.GetDataSize() > m_budget)
+		{
+			continue;
+		}
+
+		updates.Append(update.GetData(), update.GetDataSize());
+		updateCount++;
+		entity.m_lastSent = snapshot;
+		entity.m_accumulated = 0.0f;
+		sent.emplace_back(SentEntity{ id, false, source.m_state });
+	}
+
+	packet << snapshot;
+	EntityState::WriteVarint(packet, static_cast<uint32_t>(removals.size()));
+
+	for (const auto &id : removals)
+	{
+		EntityState::WriteVarint(packet, id);
+	}
+
+	EntityState::WriteVarint(packet, updateCount);
+	packet.Append(updates.GetData(), updates.GetDataSize());
+
+	state.m_history.emplace_back(snapshot, std::move(sent));
+
+	if (state.m_history.size() > HistorySize)
+	{
+		state.m_history.pop_front();
+	}
+
+	return true;
+}
+
+void ReplicationServer::OnAck(const uint32_t &client, const uint32_t &snapshot)
+{
+	auto it = m_clients.find(client);
+
+	if (it == m_clients.end())
+	{
+		return;
+	}
+
+	auto &state = it->second;
+	auto record = std::find_if(state.m_history.begin(), state.m_history.end(), [&snapshot](const auto &sent)
+	{
+		return sent.first == snapshot;
+	});
+
+	if (record == state.m_history.end())
+	{
+		return;
+	}
+
+	for (auto &sent : record->second)
+	{
+		auto entity = state.m_entities.find(sent.m_id);
+
+		if (entity == state.m_entities.end())
+		{
+			continue;
+		}
+
+		if (sent.m_removed)
+		{
+			// A entity sent again after the removal is kept, the client spawns it again from the later snapshot.
+			if (entity->second.m_lastSent < snapshot)
+			{
+				state.m_entities.erase(entity);
+			}
+		}
+		else if (entity->second.m_ackedSnapshot < snapshot)
+		{
+			entity->second.m_acked = std::move(sent.m_state);
+			entity->second.m_ackedSnapshot = snapshot;
+		}
+	}
+
+	state.m_history.erase(record);
+}
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <deque>
+
+#include "Helpers/NonCopyable.hpp"
+#include "EntityState.hpp"
+
+namespace acid
+{
+class Packet;
+class SceneStructure;
+
+/**
+ * @brief Writes snapshots of the entities in a structure with a acid::Replicated component, for each client to read with a acid::ReplicationClient.
+ * Each entity is sent as a delta against the last state of it the client acknowledged, so a entity that did not change is not sent
+ * and one that moved is sent as its position difference. Snapshots are sent unreliably, usually on UdpConnection::Channel::Sequenced,
+ * and the client acknowledges the snapshots it read, a change is sent again in later snapshots until a snapshot carrying it is acknowledged.
+ *
+ * When the changes do not fit in the byte budget of a snapshot the entities are sent by priority, each entity that is not sent
+ * accumulates its priority divided by its distance from the clients viewer, so far entities are sent less often but are never starved.
+ * Entities beyond the range of a client are despawned on that client.
+ **/
+class ACID_EXPORT ReplicationServer :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new replication server.
+	 * @param structure The structure the replicated entities are in, it must outlive the server.
+	 **/
+	explicit ReplicationServer(SceneStructure &structure);
+
+	/**
+	 * Adds a client, the first snapshot written for it spawns every entity in range.
+	 * @return The id of the client.
+	 **/
+	uint32_t AddClient();
+
+	/**
+	 * Removes a client and the state kept for it.
+	 * @param client The id of the client.
+	 **/
+	void RemoveClient(const uint32_t &client);
+
+	/**
+	 * Captures the state of every replicated entity, called once per tick before the snapshots for that tick are written.
+	 **/
+	void Update();
+
+	/**
+	 * Writes the next snapshot for a client.
+	 * @param client The id of the client.
+	 * @param viewer The position the client views the world from, entities are prioritized and ranged by their distance to it.
+	 * @param packet The packet to write the snapshot to.
+	 * @return If the client exists and a snapshot was written.
+	 **/
+	bool WriteSnapshot(const uint32_t &client, const Vector3f &viewer, Packet &packet);
+
+	/**
+	 * Called when a client acknowledges a snapshot, the states in it become the baselines of later deltas.
+	 * @param client The id of the client.
+	 * @param snapshot The id of the snapshot returned by ReplicationClient::ReadSnapshot.
+	 **/
+	void OnAck(const uint32_t &client, const uint32_t &snapshot);
+
+	const float &GetRange() const { return m_range; }
+
+	/**
+	 * Sets the distance beyond which entities are not sent to a client, zero sends every entity.
+	 * @param range The range.
+	 **/
+	void SetRange(const float &range) { m_range = range; }
+
+	const float &GetFalloff() const { return m_falloff; }
+
+	/**
+	 * Sets the distance at which the priority of a entity is halved.
+	 * @param falloff The falloff distance.
+	 **/
+	void SetFalloff(const float &falloff) { m_falloff = falloff; }
+
+	const std::size_t &GetBudget() const { return m_budget; }
+
+	/**
+	 * Sets the most bytes of entity changes written in a snapshot, the first change is written even if it is larger.
+	 * @param budget The budget in bytes.
+	 **/
+	void SetBudget(const std::size_t &budget) { m_budget = budget; }
+
+	/// Snapshots kept waiting for acknowledgement, a baseline older than this is not used and the entity is sent without a delta.
+	static constexpr uint32_t HistorySize = 32;
+
+private:
+	/**
+	 * @brief A replicated entity as captured this tick.
+	 **/
+	class Source
+	{
+	public:
+		EntityState m_state;
+		Vector3f m_position;
+		float m_priority;
+	};
+
+	/**
+	 * @brief What a client has of a entity, kept from the first time it is sent until the client acknowledges its removal.
+	 **/
+	class ClientEntity
+	{
+	public:
+		EntityState m_acked;
+		/// The snapshot the acknowledged state was sent in, zero if no state was acknowledged.
+		uint32_t m_ackedSnapshot = 0;
+		uint32_t m_lastSent = 0;
+		float m_accumulated = 0.0f;
+	};
+
+	/**
+	 * @brief A entity written in a snapshot, kept until the snapshot is acknowledged or forgotten.
+	 **/
+	class SentEntity
+	{
+	public:
+		uint32_t m_id;
+		bool m_removed;
+		EntityState m_state;
+	};
+
+	class Client
+	{
+	public:
+		uint32_t m_nextSnapshot = 1;
+		std::unordered_map<uint32_t, ClientEntity> m_entities;
+		std::deque<std::pair<uint32_t, std::vector<SentEntity>>> m_history;
+	};
+
+	SceneStructure *m_structure;
+	uint32_t m_nextNetworkId;
+	uint32_t m_nextClient;
+	std::map<uint32_t, Source> m_sources;
+	std::unordered_map<uint32_t, Client> m_clients;
+	float m_range;
+	float m_falloff;
+	std::size_t m_budget;
+};
+}
@@ -13,13 +13,15 @@
 #endif
 
 #include "Engine/Log.hpp"
+#include "SocketPoller.hpp"
 
 namespace acid
 {
 Socket::Socket(Type type) :
 	m_type(type),
 	m_socket(InvalidSocketHandle()),
-	m_isBlocking(true)
+	m_isBlocking(true),
+	m_poller(nullptr)
 {
 }
 
@@ -238,6 +240,13 @@ void Socket::Close()
 	// Close the socket.
 	if (m_socket != InvalidSocketHandle())
 	{
+		// Handles are reused once closed, so the poller must forget this one first.
+		if (m_poller != nullptr)
+		{
+			m_poller->Remove(*this);
+		}
+
+
 		CloseSocketHandle(m_socket);
 		m_socket = InvalidSocketHandle();
 	}
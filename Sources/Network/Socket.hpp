@@ -6,6 +6,8 @@ struct sockaddr_in;
 
 namespace acid
 {
+class SocketPoller;
+
 // Define the low-level socket handle type, specific to each platform.
 #if defined(ACID_BUILD_WINDOWS)
 #if defined(_WIN64)
@@ -156,6 +158,7 @@ protected:
 
 private:
 	friend class SocketSelector;
+	friend class SocketPoller;
 
 	/// Type of the socket (TCP or UDP).
 	Type m_type;
@@ -163,5 +166,7 @@ private:
 	SocketHandle m_socket;
 	/// Current blocking mode of the socket.
 	bool m_isBlocking;
+	/// The poller watching the socket, the socket is removed from it when closed.
+	SocketPoller *m_poller;
 };
 }
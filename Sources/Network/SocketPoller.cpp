@@ -0,0 +1,412 @@
+#include "SocketPoller.hpp"
+
+#if defined(ACID_BUILD_WINDOWS)
+#include <WinSock2.h>
+#elif defined(ACID_BUILD_LINUX)
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include "Engine/Log.hpp"
+
+namespace acid
+{
+// The most events read from the operating system in one call, more ready sockets are reported by the next call.
+static const int32_t MAX_EVENTS = 256;
+
+struct SocketPoller::SocketPollerImpl
+{
+#if defined(ACID_BUILD_WINDOWS)
+	/// Poll entries of every socket, and the index of each sockets entry.
+	std::vector<WSAPOLLFD> pollFds;
+	std::unordered_map<SocketHandle, std::size_t> indices;
+#elif defined(ACID_BUILD_LINUX)
+	int epoll = -1;
+	epoll_event events[MAX_EVENTS];
+#else
+	int kqueue = -1;
+	struct kevent events[MAX_EVENTS];
+#endif
+};
+
+SocketPoller::SocketPoller() :
+	m_impl(std::make_unique<SocketPollerImpl>())
+{
+#if defined(ACID_BUILD_LINUX)
+	m_impl->epoll = epoll_create1(EPOLL_CLOEXEC);
+
+	if (m_impl->epoll == -1)
+	{
+		Log::Error("Failed to create epoll instance: %i\n", errno);
+	}
+#elif !defined(ACID_BUILD_WINDOWS)
+	m_impl->kqueue = kqueue();
+
+	if (m_impl->kqueue == -1)
+	{
+		Log::Error("Failed to create kqueue: %i\n", errno);
+	}
+#endif
+}
+
+SocketPoller::~SocketPoller()
+{
+	for (const auto &[handle, entry] : m_entries)
+	{
+		entry->m_socket->m_poller = nullptr;
+	}
+
+#if defined(ACID_BUILD_LINUX)
+	if (m_impl->epoll != -1)
+	{
+		close(m_impl->epoll);
+	}
+#elif !defined(ACID_BUILD_WINDOWS)
+	if (m_impl->kqueue != -1)
+	{
+		close(m_impl->kqueue);
+	}
+#endif
+}
+
+bool SocketPoller::Add(Socket &socket, const BitMask<SocketEvent> &events, Callback callback)
+{
+	SocketHandle handle = socket.GetHandle();
+
+	if (handle == Socket::InvalidSocketHandle() || socket.m_poller != nullptr)
+	{
+		return false;
+	}
+
+	// Edge triggered readiness is only reported once, so reads and writes must return instead of blocking until the socket is drained.
+	socket.SetBlocking(false);
+
+	if (!Register(handle, events, false))
+	{
+		return false;
+	}
+
+	m_entries[handle] = std::make_shared<Entry>(Entry{ &socket, events, std::move(callback) });
+	socket.m_poller = this;
+	return true;
+}
+
+bool SocketPoller::Modify(Socket &socket, const BitMask<SocketEvent> &events)
+{
+	auto it = m_entries.find(socket.GetHandle());
+
+	if (socket.m_poller != this || it == m_entries.end())
+	{
+		return false;
+	}
+
+	if (!Register(it->first, events, true))
+	{
+		return false;
+	}
+
+#if !defined(ACID_BUILD_WINDOWS) && !defined(ACID_BUILD_LINUX)
+	// kqueue filters are registered one at a time, a filter no longer watched is deleted.
+	Unregister(it->first, BitMask<SocketEvent>(static_cast<uint8_t>(it->second->m_events.m_value & ~events.m_value)));
+#endif
+
+	it->second->m_events = events;
+	return true;
+}
+
+void SocketPoller::Remove(Socket &socket)
+{
+	if (socket.m_poller != this)
+	{
+		return;
+	}
+
+	auto it = m_entries.find(socket.GetHandle());
+
+	if (it != m_entries.end())
+	{
+		Unregister(it->first, it->second->m_events);
+		// Clears the socket, so a callback that is running for it or a event already read for it is not given a destroyed socket.
+		it->second->m_socket = nullptr;
+		m_entries.erase(it);
+	}
+
+	socket.m_poller = nullptr;
+}
+
+std::size_t SocketPoller::Poll(const std::optional<Time> &timeout)
+{
+	std::size_t dispatched = 0;
+
+#if defined(ACID_BUILD_WINDOWS)
+	if (m_impl->pollFds.empty())
+	{
+		return 0;
+	}
+
+	auto count = WSAPoll(m_impl->pollFds.data(), static_cast<ULONG>(m_impl->pollFds.size()), timeout ? static_cast<INT>(timeout->AsMilliseconds()) : -1);
+
+	if (count == SOCKET_ERROR)
+	{
+		Log::Error("Failed to poll sockets: %i\n", WSAGetLastError());
+		return 0;
+	}
+
+	// Callbacks can add and remove sockets, which reorders the poll entries, so the ready handles are collected first.
+	std::vector<std::pair<SocketHandle, BitMask<SocketEvent>>> ready;
+	ready.reserve(static_cast<std::size_t>(count));
+
+	for (auto &pollFd : m_impl->pollFds)
+	{
+		if (pollFd.revents == 0)
+		{
+			continue;
+		}
+
+		BitMask<SocketEvent> events;
+
+		if (pollFd.revents & (POLLRDNORM | POLLHUP | POLLERR))
+		{
+			events |= SocketEvent::Read;
+		}
+
+		if (pollFd.revents & POLLWRNORM)
+		{
+			events |= SocketEvent::Write;
+		}
+
+		if (pollFd.revents & (POLLHUP | POLLERR))
+		{
+			events |= SocketEvent::Hangup;
+		}
+
+		ready.emplace_back(pollFd.fd, events);
+		pollFd.revents = 0;
+	}
+
+	for (const auto &[handle, events] : ready)
+	{
+		Dispatch(handle, events, dispatched);
+	}
+#elif defined(ACID_BUILD_LINUX)
+	auto count = epoll_wait(m_impl->epoll, m_impl->events, MAX_EVENTS, timeout ? static_cast<int>(timeout->AsMilliseconds()) : -1);
+
+	if (count == -1)
+	{
+		if (errno != EINTR)
+		{
+			Log::Error("Failed to wait for epoll events: %i\n", errno);
+		}
+
+		return 0;
+	}
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		const auto &event = m_impl->events[i];
+		BitMask<SocketEvent> events;
+
+		if (event.events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP | EPOLLERR))
+		{
+			events |= SocketEvent::Read;
+		}
+
+		if (event.events & EPOLLOUT)
+		{
+			events |= SocketEvent::Write;
+		}
+
+		if (event.events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR))
+		{
+			events |= SocketEvent::Hangup;
+		}
+
+		Dispatch(event.data.fd, events, dispatched);
+	}
+#else
+	timespec time = {};
+
+	if (timeout)
+	{
+		time.tv_sec = static_cast<time_t>(timeout->AsMicroseconds() / 1000000);
+		time.tv_nsec = static_cast<long>(timeout->AsMicroseconds() % 1000000) * 1000;
+	}
+
+	auto count = kevent(m_impl->kqueue, nullptr, 0, m_impl->events, MAX_EVENTS, timeout ? &time : nullptr);
+
+	if (count == -1)
+	{
+		if (errno != EINTR)
+		{
+			Log::Error("Failed to wait for kqueue events: %i\n", errno);
+		}
+
+		return 0;
+	}
+
+	// Reads and writes are separate kqueue events, a socket ready for both is dispatched once.
+	for (int32_t i = 0; i < count; i++)
+	{
+		const auto &event = m_impl->events[i];
+		BitMask<SocketEvent> events = event.filter == EVFILT_WRITE ? SocketEvent::Write : SocketEvent::Read;
+
+		if (event.flags & (EV_EOF | EV_ERROR))
+		{
+			events |= SocketEvent::Read;
+			events |= SocketEvent::Hangup;
+		}
+
+		for (int32_t j = i + 1; j < count && m_impl->events[j].ident == event.ident; j++, i++)
+		{
+			events |= m_impl->events[j].filter == EVFILT_WRITE ? SocketEvent::Write : SocketEvent::Read;
+		}
+
+		Dispatch(static_cast<SocketHandle>(event.ident), events, dispatched);
+	}
+#endif
+
+	return dispatched;
+}
+
+bool SocketPoller::Register(const SocketHandle &handle, const BitMask<SocketEvent> &events, const bool &modify)
+{
+#if defined(ACID_BUILD_WINDOWS)
+	SHORT pollEvents = 0;
+
+	if (events & SocketEvent::Read)
+	{
+		pollEvents |= POLLRDNORM;
+	}
+
+	if (events & SocketEvent::Write)
+	{
+		pollEvents |= POLLWRNORM;
+	}
+
+	if (modify)
+	{
+		m_impl->pollFds[m_impl->indices[handle]].events = pollEvents;
+		return true;
+	}
+
+	m_impl->indices[handle] = m_impl->pollFds.size();
+	m_impl->pollFds.emplace_back(WSAPOLLFD{ handle, pollEvents, 0 });
+	return true;
+#elif defined(ACID_BUILD_LINUX)
+	epoll_event event = {};
+	event.events = EPOLLET | EPOLLRDHUP;
+	event.data.fd = handle;
+
+	if (events & SocketEvent::Read)
+	{
+		event.events |= EPOLLIN;
+	}
+
+	if (events & SocketEvent::Write)
+	{
+		event.events |= EPOLLOUT;
+	}
+
+	if (epoll_ctl(m_impl->epoll, modify ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, handle, &event) == -1)
+	{
+		Log::Error("Failed to register socket with epoll: %i\n", errno);
+		return false;
+	}
+
+	return true;
+#else
+	struct kevent changes[2];
+	int32_t changeCount = 0;
+
+	if (events & SocketEvent::Read)
+	{
+		EV_SET(&changes[changeCount++], handle, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+	}
+
+	if (events & SocketEvent::Write)
+	{
+		EV_SET(&changes[changeCount++], handle, EVFILT_WRITE, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+	}
+
+	if (changeCount != 0 && kevent(m_impl->kqueue, changes, changeCount, nullptr, 0, nullptr) == -1)
+	{
+		Log::Error("Failed to register socket with kqueue: %i\n", errno);
+		return false;
+	}
+
+	return true;
+#endif
+}
+
+void SocketPoller::Unregister(const SocketHandle &handle, const BitMask<SocketEvent> &events)
+{
+#if defined(ACID_BUILD_WINDOWS)
+	// Moves the last entry into the removed entries place.
+	auto it = m_impl->indices.find(handle);
+
+	if (it == m_impl->indices.end())
+	{
+		return;
+	}
+
+	auto index = it->second;
+	m_impl->indices.erase(it);
+
+	if (index != m_impl->pollFds.size() - 1)
+	{
+		m_impl->pollFds[index] = m_impl->pollFds.back();
+		m_impl->indices[m_impl->pollFds[index].fd] = index;
+	}
+
+	m_impl->pollFds.pop_back();
+#elif defined(ACID_BUILD_LINUX)
+	epoll_ctl(m_impl->epoll, EPOLL_CTL_DEL, handle, nullptr);
+#else
+	struct kevent changes[2];
+	int32_t changeCount = 0;
+
+	if (events & SocketEvent::Read)
+	{
+		EV_SET(&changes[changeCount++], handle, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+	}
+
+	if (events & SocketEvent::Write)
+	{
+		EV_SET(&changes[changeCount++], handle, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+	}
+
+	if (changeCount != 0)
+	{
+		kevent(m_impl->kqueue, changes, changeCount, nullptr, 0, nullptr);
+	}
+#endif
+}
+
+void SocketPoller::Dispatch(const SocketHandle &handle, const BitMask<SocketEvent> &events, std::size_t &dispatched)
+{
+	auto it = m_entries.find(handle);
+
+	if (it == m_entries.end())
+	{
+		return;
+	}
+
+	// Holds the entry, so the callback stays alive if it removes its own socket.
+	auto entry = it->second;
+
+	if (entry->m_socket == nullptr || !events)
+	{
+		return;
+	}
+
+	entry->m_callback(*entry->m_socket, events);
+	dispatched++;
+}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Helpers/EnumClass.hpp"
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Time.hpp"
+#include "Socket.hpp"
+
+namespace acid
+{
+/**
+ * @brief The readiness a socket poller watches for and reports.
+ **/
+enum class SocketEvent :
+	uint8_t
+{
+	None = 0, Read = 1, Write = 2, Hangup = 4
+};
+
+ENABLE_BITMASK_OPERATORS(SocketEvent)
+
+/**
+ * @brief Socket pollers are an event loop for servers with many more sockets than a acid::SocketSelector can handle.
+ * Sockets are registered once with a callback, and each call to Poll asks the operating system only for the sockets that changed,
+ * so a poll costs as much as the number of ready sockets instead of the number registered.
+ *
+ * The backend is epoll on Linux, kqueue on macOS and the BSDs, and WSAPoll on Windows.
+ * epoll and kqueue are edge triggered: a socket is reported once each time it becomes ready, so a callback must
+ * receive, send or accept until the socket returns Socket::Status::NotReady or it will not be reported again.
+ * WSAPoll reports a socket for as long as it is ready, so callbacks written for edge triggering work on every platform.
+ *
+ * All types of sockets can be used in a poller:
+ * \li acid::TcpListener, ready to read when a connection can be accepted
+ * \li acid::TcpSocket, ready to write when a connect in progress completes or the send buffer has room again
+ * \li acid::UdpSocket
+ *
+ * Sockets are made non-blocking when added, and remove themselves from their poller when they are closed or destroyed.
+ * The poller must outlive its sockets, or they must be removed before it is destroyed.
+ * A poller is used from one thread, callbacks run on the thread calling Poll and may add or remove sockets.
+ **/
+class ACID_EXPORT SocketPoller :
+	public NonCopyable
+{
+public:
+	/**
+	 * A callback called with the socket and the events it is ready for.
+	 **/
+	using Callback = std::function<void(Socket &, BitMask<SocketEvent>)>;
+
+	SocketPoller();
+
+	~SocketPoller();
+
+	/**
+	 * Add a socket to the poller, does nothing if the socket is not valid or is already in a poller.
+	 * Hangups and errors are always reported, as Read and Hangup so the callbacks receive gets the status.
+	 * @param socket The socket to watch, it must stay alive until it is closed or removed.
+	 * @param events The events to watch for.
+	 * @param callback The callback called for the events.
+	 * @return If the socket was added.
+	 **/
+	bool Add(Socket &socket, const BitMask<SocketEvent> &events, Callback callback);
+
+	/**
+	 * Change the events watched for on a socket in this poller, usually to watch for Write only while there is data waiting to be sent.
+	 * @param socket The socket.
+	 * @param events The events to watch for.
+	 * @return If the socket is in this poller and was changed.
+	 **/
+	bool Modify(Socket &socket, const BitMask<SocketEvent> &events);
+
+	/**
+	 * Remove a socket from the poller, its callback will not be called again.
+	 * This function doesn't destroy the socket, and does nothing if the socket is not in this poller.
+	 * @param socket The socket to remove.
+	 **/
+	void Remove(Socket &socket);
+
+	/**
+	 * Wait until one or more sockets are ready, and call the callback of each ready socket.
+	 * @param timeout Maximum time to wait, Time::Zero returns without waiting and std::nullopt waits until a socket is ready.
+	 * @return The number of callbacks called.
+	 **/
+	std::size_t Poll(const std::optional<Time> &timeout = std::nullopt);
+
+	/**
+	 * Gets the number of sockets in the poller.
+	 * @return The socket count.
+	 **/
+	std::size_t GetSocketCount() const { return m_entries.size(); }
+
+private:
+	/**
+	 * @brief A socket in the poller, callbacks hold a reference while they run so a callback can remove its own socket.
+	 **/
+	class Entry
+	{
+	public:
+		Socket *m_socket;
+		BitMask<SocketEvent> m_events;
+		Callback m_callback;
+	};
+
+	bool Register(const SocketHandle &handle, const BitMask<SocketEvent> &events, const bool &modify);
+
+	void Unregister(const SocketHandle &handle, const BitMask<SocketEvent> &events);
+
+	void Dispatch(const SocketHandle &handle, const BitMask<SocketEvent> &events, std::size_t &dispatched);
+
+	struct SocketPollerImpl;
+
+	/// Opaque pointer to the implementation (which requires OS-specific types).
+	std::unique_ptr<SocketPollerImpl> m_impl;
+	std::unordered_map<SocketHandle, std::shared_ptr<Entry>> m_entries;
+};
+}
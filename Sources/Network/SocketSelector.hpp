@@ -27,6 +27,9 @@ class Socket;
  * \li populate the selector with all the sockets that you want to observe
  * \li make it wait until there is data available on any of the sockets
  * \li test each socket to find out which ones are ready
+ *
+ * Selectors are limited to FD_SETSIZE sockets and test every socket on each wait,
+ * servers with many clients should use a acid::SocketPoller instead.
  **/
 class ACID_EXPORT SocketSelector
 {
@@ -6,11 +6,14 @@
 
 #else
 #include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #endif
 
 #include "Engine/Log.hpp"
 #include "Network/IpAddress.hpp"
+#include "Network/Lz4.hpp"
 #include "Network/Packet.hpp"
 
 #ifdef _MSC_VER
@@ -20,14 +23,19 @@
 namespace acid
 {
 // Define the low-level send/receive flags, which depends on the OS.
-#if defined(ACID_PLATFORM_LINUX)
+#if defined(ACID_BUILD_LINUX)
 const int flags = MSG_NOSIGNAL;
 #else
 const int flags = 0;
 #endif
 
+// Set in the size prefix of a compressed packet, the data starts with the uncompressed size.
+static const uint32_t COMPRESSED_FLAG = 0x80000000;
+
 TcpSocket::TcpSocket() :
-	Socket(Type::Tcp)
+	Socket(Type::Tcp),
+	m_sendQueueOffset(0),
+	m_compress(false)
 {
 }
 
@@ -185,6 +193,8 @@ void TcpSocket::Disconnect()
 
 	// Reset the pending packet data.
 	m_pendingPacket = PendingPacket();
+	m_sendQueue.clear();
+	m_sendQueueOffset = 0;
 }
 
 Socket::Status TcpSocket::Send(const void *data, const std::size_t &size)
@@ -268,31 +278,20 @@ Socket::Status TcpSocket::Send(Packet &packet)
 	// This means that we have to send the packet size first, so that the
 	// receiver knows the actual end of the packet in the data stream.
 
-	// We allocate an extra memory block so that the size can be sent
-	// together with the data in a single call. This may seem inefficient,
-	// but it is actually required to avoid partial send, which could cause
-	// data corruption on the receiving end.
+	// The size and the data are gathered by a single call, so they are
+	// sent together without being copied into one block first.
 
-	// Get the data to send from the packet.
-	auto dataSize = packet.OnSend();
+	// Get the data to send from the packet, compression gives the same bytes each time so a partial send resumes correctly.
+	auto data = packet.OnSend();
+	auto dataSize = Compress(data);
 
 	// First convert the packet size to network byte order
-	uint32_t packetSize = htonl(static_cast<uint32_t>(dataSize.second));
-
-	// Allocate memory for the data block to send
-	std::vector<char> blockToSend(sizeof(packetSize) + dataSize.second);
-
-	// Copy the packet size and data into the block to send
-	std::memcpy(&blockToSend[0], &packetSize, sizeof(packetSize));
-
-	if (dataSize.second > 0)
-	{
-		std::memcpy(&blockToSend[0] + sizeof(packetSize), dataSize.first, dataSize.second);
-	}
+	uint32_t packetSize = htonl(static_cast<uint32_t>(dataSize.second) | (dataSize.first != data.first ? COMPRESSED_FLAG : 0));
 
-	// Send the data block.
+	// Send the size and the data, resuming after the bytes of a earlier partial send.
+	std::pair<const void *, std::size_t> buffers[] = { { &packetSize, sizeof(packetSize) }, dataSize };
 	std::size_t sent;
-	Status status = Send(&blockToSend[0] + packet.m_sendPos, blockToSend.size() - packet.m_sendPos, sent);
+	Status status = Send(buffers, MaxSendBuffers, packet.m_sendPos, sent);
 
 	// In the case of a partial send, record the location to resume from
 	if (status == Status::Partial)
@@ -307,6 +306,118 @@ Socket::Status TcpSocket::Send(Packet &packet)
 	return status;
 }
 
+void TcpSocket::Queue(Packet &packet)
+{
+	auto data = packet.OnSend();
+	auto dataSize = Compress(data);
+	uint32_t packetSize = htonl(static_cast<uint32_t>(dataSize.second) | (dataSize.first != data.first ? COMPRESSED_FLAG : 0));
+
+	// A fully sent queue is reused from the start, so its memory is only allocated while it grows.
+	if (m_sendQueueOffset == m_sendQueue.size())
+	{
+		m_sendQueue.clear();
+		m_sendQueueOffset = 0;
+	}
+
+	auto offset = m_sendQueue.size();
+	m_sendQueue.resize(offset + sizeof(packetSize) + dataSize.second);
+	std::memcpy(&m_sendQueue[offset], &packetSize, sizeof(packetSize));
+
+	if (dataSize.second > 0)
+	{
+		std::memcpy(&m_sendQueue[offset + sizeof(packetSize)], dataSize.first, dataSize.second);
+	}
+}
+
+Socket::Status TcpSocket::Flush()
+{
+	if (m_sendQueueOffset == m_sendQueue.size())
+	{
+		return Status::Done;
+	}
+
+	std::pair<const void *, std::size_t> buffer = { m_sendQueue.data(), m_sendQueue.size() };
+	std::size_t sent;
+	Status status = Send(&buffer, 1, m_sendQueueOffset, sent);
+	m_sendQueueOffset += sent;
+
+	if (status == Status::Done)
+	{
+		m_sendQueue.clear();
+		m_sendQueueOffset = 0;
+	}
+
+	return status;
+}
+
+Socket::Status TcpSocket::Send(const std::pair<const void *, std::size_t> *buffers, const std::size_t &count, const std::size_t &offset, std::size_t &sent)
+{
+	std::size_t size = 0;
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		size += buffers[i].second;
+	}
+
+	// Loop until every byte has been sent, each call gathers the bytes not sent yet from every buffer.
+	for (sent = 0; offset + sent < size;)
+	{
+#if defined(ACID_BUILD_WINDOWS)
+		WSABUF ioBuffers[MaxSendBuffers];
+#else
+		iovec ioBuffers[MaxSendBuffers];
+#endif
+		std::size_t ioCount = 0;
+		std::size_t skip = offset + sent;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			if (skip >= buffers[i].second)
+			{
+				skip -= buffers[i].second;
+				continue;
+			}
+
+			auto data = static_cast<const char *>(buffers[i].first) + skip;
+			auto length = buffers[i].second - skip;
+			skip = 0;
+
+#if defined(ACID_BUILD_WINDOWS)
+			ioBuffers[ioCount++] = WSABUF{ static_cast<ULONG>(length), const_cast<char *>(data) };
+#else
+			ioBuffers[ioCount++] = iovec{ const_cast<char *>(data), length };
+#endif
+		}
+
+#if defined(ACID_BUILD_WINDOWS)
+		DWORD result = 0;
+
+		if (WSASend(GetHandle(), ioBuffers, static_cast<DWORD>(ioCount), &result, 0, nullptr, nullptr) == SOCKET_ERROR)
+#else
+		msghdr message = {};
+		message.msg_iov = ioBuffers;
+		message.msg_iovlen = ioCount;
+		auto result = sendmsg(GetHandle(), &message, flags);
+
+		if (result < 0)
+#endif
+		{
+			Status status = GetErrorStatus();
+
+			if ((status == Status::NotReady) && sent)
+			{
+				return Status::Partial;
+			}
+
+			return status;
+		}
+
+		sent += static_cast<std::size_t>(result);
+	}
+
+	return Status::Done;
+}
+
 Socket::Status TcpSocket::Receive(Packet &packet)
 {
 	// First clear the variables to fill.
@@ -340,6 +451,9 @@ Socket::Status TcpSocket::Receive(Packet &packet)
 		packetSize = ntohl(m_pendingPacket.m_size);
 	}
 
+	auto compressed = (packetSize & COMPRESSED_FLAG) != 0;
+	packetSize &= ~COMPRESSED_FLAG;
+
 	// Loop until we receive all the packet data.
 	char buffer[1024];
 
@@ -363,6 +477,33 @@ Socket::Status TcpSocket::Receive(Packet &packet)
 		}
 	}
 
+	if (compressed)
+	{
+		auto &data = m_pendingPacket.m_data;
+		uint32_t size = 0;
+
+		if (data.size() >= sizeof(size))
+		{
+			std::memcpy(&size, data.data(), sizeof(size));
+			size = ntohl(size);
+		}
+
+		// A block can not expand by more than 255 times, larger sizes are malformed.
+		m_decompressed.resize(size);
+
+		if (data.size() < sizeof(size) || size > (data.size() - sizeof(size)) * 255 ||
+			!Lz4::Decompress(data.data() + sizeof(size), data.size() - sizeof(size), m_decompressed.data(), m_decompressed.size()))
+		{
+			Log::Error("Received a malformed compressed packet\n");
+			m_pendingPacket = PendingPacket();
+			return Status::Error;
+		}
+
+		packet.OnReceive(m_decompressed.data(), m_decompressed.size());
+		m_pendingPacket = PendingPacket();
+		return Status::Done;
+	}
+
 	// We have received all the packet data: we can copy it to the user packet.
 	if (!m_pendingPacket.m_data.empty())
 	{
@@ -373,4 +514,25 @@ Socket::Status TcpSocket::Receive(Packet &packet)
 	m_pendingPacket = PendingPacket();
 	return Status::Done;
 }
+
+std::pair<const void *, std::size_t> TcpSocket::Compress(const std::pair<const void *, std::size_t> &data)
+{
+	if (!m_compress || data.second < MinCompressSize)
+	{
+		return data;
+	}
+
+	uint32_t size = htonl(static_cast<uint32_t>(data.second));
+	m_compressed.resize(sizeof(size));
+	std::memcpy(m_compressed.data(), &size, sizeof(size));
+	Lz4::Compress(static_cast<const char *>(data.first), data.second, m_compressed);
+
+	// Packets that do not shrink are sent as they are.
+	if (m_compressed.size() >= data.second)
+	{
+		return data;
+	}
+
+	return { m_compressed.data(), m_compressed.size() };
+}
 }
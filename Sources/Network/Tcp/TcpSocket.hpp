@@ -130,6 +130,15 @@ public:
 	 **/
 	Status Receive(void *data, const std::size_t &size, std::size_t &received);
 
+	/**
+	 * Sets if packets sent by Send and Queue are compressed with acid::Lz4, packets smaller than MinCompressSize or that do not shrink are sent as they are.
+	 * Compressed packets are flagged in their size prefix, so the peer reads them whether or not it compresses its own packets.
+	 * @param compress If packets are compressed. 
+	 **/
+	void SetCompression(const bool &compress) { m_compress = compress; }
+
+	const bool &IsCompressed() const { return m_compress; }
+
 	/**
 	 * Send a formatted packet of data to the remote peer.
 	 * In non-blocking mode, if this function returns SOCKET_STATUS_PARTIAL, you \em must retry sending the same unmodified
@@ -140,6 +149,28 @@ public:
 	 **/
 	Status Send(Packet &packet);
 
+	/**
+	 * Queue a formatted packet to be sent by the next call to Flush, so many small packets are sent with one system call.
+	 * The packet is copied into the send queue, it can be modified or destroyed once this returns.
+	 * @param packet Packet to queue. 
+	 **/
+	void Queue(Packet &packet);
+
+	/**
+	 * Send every queued packet to the remote peer, usually once per tick.
+	 * In non-blocking mode, if this function returns Status::Partial the bytes not sent stay queued and are sent by the next flush,
+	 * packets queued in between are sent after them.
+	 * This function will fail if the socket is not connected.
+	 * @return Status code, Status::Done if the queue is empty. 
+	 **/
+	Status Flush();
+
+	/**
+	 * Get the number of queued bytes not sent yet, including the size prefix of each packet.
+	 * @return The queued size. 
+	 **/
+	std::size_t GetQueuedSize() const { return m_sendQueue.size() - m_sendQueueOffset; }
+
 	/**
 	 * Receive a formatted packet of data from the remote peer.
 	 * In blocking mode, this function will wait until the whole packet has been received.
@@ -149,10 +180,41 @@ public:
 	 **/
 	Status Receive(Packet &packet);
 
+	/// Packets smaller than this are never compressed.
+	static constexpr std::size_t MinCompressSize = 64;
+
 private:
+	friend class Http;
 	friend class TcpListener;
 
+	/**
+	 * Send a list of buffers to the remote peer as one sequence of bytes, with one system call while the socket accepts them all.
+	 * @param buffers The data and size of each buffer. 
+	 * @param count The number of buffers, at most TcpSocket::MaxSendBuffers. 
+	 * @param offset The number of bytes sent by an earlier partial send, which are skipped. 
+	 * @param sent The number of bytes sent by this call will be written here. 
+	 * @return Status code. 
+	 **/
+	Status Send(const std::pair<const void *, std::size_t> *buffers, const std::size_t &count, const std::size_t &offset, std::size_t &sent);
+
+	/**
+	 * Compresses the data of a packet into the compression buffer when compression is enabled and the data shrinks.
+	 * @param data The data and size of the packet. 
+	 * @return The data and size to send, the compression buffer if the data was compressed. 
+	 **/
+	std::pair<const void *, std::size_t> Compress(const std::pair<const void *, std::size_t> &data);
+
+	static constexpr std::size_t MaxSendBuffers = 2;
+
 	/// Temporary data of the packet currently being received.
 	PendingPacket m_pendingPacket;
+	/// Size prefixed packets waiting for the next flush, the memory is kept between flushes.
+	std::vector<char> m_sendQueue;
+	/// Number of queued bytes sent by partial flushes.
+	std::size_t m_sendQueueOffset;
+	bool m_compress;
+	/// The last compressed packet, and a received packet being decompressed, the memory is kept between packets.
+	std::vector<char> m_compressed;
+	std::vector<char> m_decompressed;
 };
 }
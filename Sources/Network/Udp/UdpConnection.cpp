@@ -0,0 +1,667 @@
+#include "UdpConnection.hpp"
+
+#if defined(ACID_BUILD_WINDOWS)
+#include <WinSock2.h>
+#else
+#include <netinet/in.h>
+#endif
+
+#include "Engine/Engine.hpp"
+#include "Engine/Log.hpp"
+#include "Network/Lz4.hpp"
+#include "Network/Packet.hpp"
+#include "UdpSocket.hpp"
+
+namespace acid
+{
+// Identifies the datagrams of this protocol, other datagrams sent to the socket are ignored.
+static const uint16_t PROTOCOL_ID = 0xAC1D;
+// Protocol id, sequence, latest sequence received and the bitfield of the 32 before it.
+static const std::size_t HEADER_SIZE = 10;
+// Channel, message id and size, followed by the fragment index and count if the message is fragmented.
+static const std::size_t FRAGMENT_HEADER_SIZE = 5;
+static const std::size_t FRAGMENTED_HEADER_SIZE = 9;
+static const uint8_t FRAGMENTED_FLAG = 0x80;
+// Set on every fragment of a compressed message, which starts with its uncompressed size and dictionary id.
+static const uint8_t COMPRESSED_FLAG = 0x40;
+static const std::size_t COMPRESSED_HEADER_SIZE = 8;
+// Sent datagrams remembered for acknowledgements, more than the largest congestion window.
+static const std::size_t SENT_SIZE = 1024;
+// Round trips a datagram can be overtaken by one sent after it before it is declared lost.
+static const float REORDER_WINDOW = 1.25f;
+
+static const float CONGESTION_WINDOW_MIN = 2.0f;
+static const float CONGESTION_WINDOW_MAX = 256.0f;
+static const float CONGESTION_WINDOW_START = 4.0f;
+static const Time RETRANSMIT_MIN = Time::Milliseconds(100);
+static const Time RETRANSMIT_MAX = Time::Seconds(2);
+static const Time RETRANSMIT_START = Time::Seconds(1);
+// Time a incomplete unreliable message is kept waiting for its other fragments.
+static const Time REASSEMBLY_TIMEOUT = Time::Seconds(1);
+
+static void Write16(char *destination, const uint16_t &value)
+{
+	uint16_t toWrite = htons(value);
+	std::memcpy(destination, &toWrite, sizeof(toWrite));
+}
+
+static void Write32(char *destination, const uint32_t &value)
+{
+	uint32_t toWrite = htonl(value);
+	std::memcpy(destination, &toWrite, sizeof(toWrite));
+}
+
+static uint16_t Read16(const char *source)
+{
+	uint16_t value;
+	std::memcpy(&value, source, sizeof(value));
+	return ntohs(value);
+}
+
+static uint32_t Read32(const char *source)
+{
+	uint32_t value;
+	std::memcpy(&value, source, sizeof(value));
+	return ntohl(value);
+}
+
+UdpConnection::UdpConnection(UdpSocket &socket, const IpAddress &remoteAddress, const uint16_t &remotePort) :
+	m_socket(&socket),
+	m_remoteAddress(remoteAddress),
+	m_remotePort(remotePort),
+	m_localSequence(0),
+	m_remoteSequence(0xFFFF),
+	m_receivedBits(0),
+	m_receivedAny(false),
+	m_ackPending(false),
+	m_lastReceive(Engine::GetTime()),
+	m_sent(SENT_SIZE),
+	m_datagram(HEADER_SIZE),
+	m_nextReliableId(0),
+	m_nextUnreliableId(0),
+	m_expectedReliableId(0),
+	m_lastSequencedId(0),
+	m_receivedSequenced(false),
+	m_roundTripTime(RETRANSMIT_START),
+	m_measuredRoundTrip(false),
+	m_congestionWindow(CONGESTION_WINDOW_START),
+	m_slowStartThreshold(CONGESTION_WINDOW_MAX),
+	m_lastLoss(Time::Zero),
+	m_ackedSendTime(Time::Min),
+	m_compress{},
+	m_dictionaryIds{}
+{
+	m_datagram.reserve(MaxDatagramSize);
+}
+
+bool UdpConnection::Send(Packet &packet, const Channel &channel)
+{
+	auto [data, size] = packet.OnSend();
+	std::vector<char> compressed;
+	auto isCompressed = Compress(channel, data, size, compressed);
+
+	if (isCompressed)
+	{
+		data = compressed.data();
+		size = compressed.size();
+	}
+
+	auto fragmentCount = std::max<std::size_t>((size + FragmentSize - 1) / FragmentSize, 1);
+
+	if (fragmentCount > MaxFragments)
+	{
+		Log::Error("Message of %i bytes is too large to send over a UDP connection\n", static_cast<int32_t>(size));
+		return false;
+	}
+
+	if (channel == Channel::Reliable && m_reliableOut.size() >= MaxReliablePending)
+	{
+		return false;
+	}
+
+	auto &message = channel == Channel::Reliable ? m_reliableOut.emplace_back() : m_unreliableOut.emplace_back();
+	message.m_id = channel == Channel::Reliable ? m_nextReliableId++ : m_nextUnreliableId++;
+	message.m_channel = channel;
+	message.m_compressed = isCompressed;
+	message.m_data.assign(static_cast<const char *>(data), static_cast<const char *>(data) + size);
+	message.m_fragmentCount = static_cast<uint16_t>(fragmentCount);
+
+	if (channel == Channel::Reliable)
+	{
+		message.m_acked.assign(fragmentCount, false);
+		message.m_pending.assign(fragmentCount, true);
+	}
+
+	return true;
+}
+
+void UdpConnection::SetDictionary(const Channel &channel, std::vector<char> dictionary)
+{
+	auto index = static_cast<std::size_t>(channel);
+	m_dictionaryIds[index] = Lz4::GetDictionaryId(dictionary.data(), dictionary.size());
+	m_dictionaries[index] = std::move(dictionary);
+}
+
+bool UdpConnection::OnReceive(const void *data, const std::size_t &size)
+{
+	auto bytes = static_cast<const char *>(data);
+
+	if (size < HEADER_SIZE || Read16(bytes) != PROTOCOL_ID)
+	{
+		return false;
+	}
+
+	auto now = Engine::GetTime();
+	auto sequence = Read16(bytes + 2);
+	auto ack = Read16(bytes + 4);
+	auto ackBits = Read32(bytes + 6);
+	m_lastReceive = now;
+
+	OnAcked(ack, now);
+
+	for (uint16_t i = 0; i < 32; i++)
+	{
+		if (ackBits & (1u << i))
+		{
+			OnAcked(static_cast<uint16_t>(ack - 1 - i), now);
+		}
+	}
+
+	// Bit i of the received bitfield is set if the datagram i + 1 before the latest was received, so duplicates are dropped.
+	if (!m_receivedAny)
+	{
+		m_receivedAny = true;
+		m_remoteSequence = sequence;
+		m_receivedBits = 0;
+	}
+	else if (SequenceGreater(sequence, m_remoteSequence))
+	{
+		uint16_t shift = sequence - m_remoteSequence;
+		m_receivedBits = shift < 32 ? (m_receivedBits << shift) | (1u << (shift - 1)) : shift == 32 ? 1u << 31 : 0;
+		m_remoteSequence = sequence;
+	}
+	else
+	{
+		uint16_t difference = m_remoteSequence - sequence;
+
+		// Datagrams too old to tell if they are duplicates are dropped, the reliable fragments they carried are resent.
+		if (difference == 0 || difference > 32 || m_receivedBits & (1u << (difference - 1)))
+		{
+			return true;
+		}
+
+		m_receivedBits |= 1u << (difference - 1);
+	}
+
+	for (std::size_t offset = HEADER_SIZE; offset < size;)
+	{
+		if (offset + FRAGMENT_HEADER_SIZE > size)
+		{
+			return false;
+		}
+
+		auto flags = static_cast<uint8_t>(bytes[offset]);
+		auto channel = static_cast<Channel>(flags & ~(FRAGMENTED_FLAG | COMPRESSED_FLAG));
+		auto id = Read16(bytes + offset + 1);
+		uint16_t fragment = 0;
+		uint16_t fragmentCount = 1;
+		offset += 3;
+
+		if (flags & FRAGMENTED_FLAG)
+		{
+			if (offset + FRAGMENTED_HEADER_SIZE - 3 > size)
+			{
+				return false;
+			}
+
+			fragment = Read16(bytes + offset);
+			fragmentCount = Read16(bytes + offset + 2);
+			offset += 4;
+		}
+
+		auto fragmentSize = Read16(bytes + offset);
+		offset += 2;
+
+		if (channel > Channel::Reliable || fragmentCount == 0 || fragmentCount > MaxFragments || fragment >= fragmentCount ||
+			fragmentSize > FragmentSize || offset + fragmentSize > size)
+		{
+			return false;
+		}
+
+		OnFragment(channel, (flags & COMPRESSED_FLAG) != 0, id, fragment, fragmentCount, bytes + offset, fragmentSize, now);
+		offset += fragmentSize;
+		// Only datagrams carrying messages are acknowledged on their own, so acknowledgements are not acknowledged back.
+		m_ackPending = true;
+	}
+
+	return true;
+}
+
+bool UdpConnection::Receive(Packet &packet)
+{
+	if (m_delivered.empty())
+	{
+		return false;
+	}
+
+	packet.Clear();
+	packet.OnReceive(m_delivered.front().data(), m_delivered.front().size());
+	m_delivered.pop_front();
+	return true;
+}
+
+Socket::Status UdpConnection::Update()
+{
+	auto now = Engine::GetTime();
+	auto status = Socket::Status::Done;
+
+	// Datagrams not acknowledged within the retransmission timeout from RFC 6298 are lost, or sooner when a datagram
+	// sent after them was acknowledged and they are a quarter of a round trip late, as in RACK from RFC 8985.
+	auto retransmit = m_measuredRoundTrip ? m_roundTripTime + int64_t(4) * m_roundTripVariance : RETRANSMIT_START;
+	retransmit = std::clamp(retransmit, RETRANSMIT_MIN, RETRANSMIT_MAX);
+	auto reordering = m_roundTripTime * REORDER_WINDOW;
+
+	while (!m_inFlight.empty())
+	{
+		auto &datagram = m_sent[m_inFlight.front() % SENT_SIZE];
+		auto age = now - datagram.m_sendTime;
+
+		if (age <= retransmit && (datagram.m_sendTime >= m_ackedSendTime || age <= reordering))
+		{
+			break;
+		}
+
+		OnLost(datagram, now);
+		m_inFlight.pop_front();
+	}
+
+	// Unreliable messages are sent first since they are only useful this update, then lost and new reliable fragments in message order.
+	auto open = m_inFlight.size() < static_cast<std::size_t>(m_congestionWindow);
+
+	for (auto &message : m_unreliableOut)
+	{
+		for (uint16_t fragment = 0; open && fragment < message.m_fragmentCount; fragment++)
+		{
+			open = AppendFragment(message, fragment, now, status);
+		}
+	}
+
+	m_unreliableOut.clear();
+
+	for (auto &message : m_reliableOut)
+	{
+		for (uint16_t fragment = 0; open && fragment < message.m_fragmentCount; fragment++)
+		{
+			if (message.m_pending[fragment])
+			{
+				open = AppendFragment(message, fragment, now, status);
+				message.m_pending[fragment] = !open;
+			}
+		}
+	}
+
+	if (m_datagram.size() > HEADER_SIZE || m_ackPending)
+	{
+		auto sendStatus = SendDatagram(now, m_datagram.size() > HEADER_SIZE);
+
+		if (sendStatus != Socket::Status::Done)
+		{
+			status = sendStatus;
+		}
+	}
+
+	for (auto it = m_incoming.begin(); it != m_incoming.end();)
+	{
+		if (it->first.first != Channel::Reliable && now - it->second.m_firstReceive > REASSEMBLY_TIMEOUT)
+		{
+			it = m_incoming.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	return status;
+}
+
+Time UdpConnection::GetTimeSinceReceive() const
+{
+	return Engine::GetTime() - m_lastReceive;
+}
+
+bool UdpConnection::SequenceGreater(const uint16_t &a, const uint16_t &b)
+{
+	return static_cast<uint16_t>(a - b) != 0 && static_cast<uint16_t>(a - b) < 0x8000;
+}
+
+UdpConnection::OutgoingMessage *UdpConnection::FindReliable(const uint16_t &id)
+{
+	if (m_reliableOut.empty())
+	{
+		return nullptr;
+	}
+
+	// Reliable ids are consecutive, so the message is found by its distance from the oldest.
+	auto index = static_cast<uint16_t>(id - m_reliableOut.front().m_id);
+	return index < m_reliableOut.size() ? &m_reliableOut[index] : nullptr;
+}
+
+void UdpConnection::OnAcked(const uint16_t &sequence, const Time &now)
+{
+	auto &datagram = m_sent[sequence % SENT_SIZE];
+
+	if (datagram.m_sequence != sequence || datagram.m_acked || !SequenceGreater(m_localSequence, sequence))
+	{
+		return;
+	}
+
+	datagram.m_acked = true;
+
+	m_ackedSendTime = std::max(m_ackedSendTime, datagram.m_sendTime);
+
+	if (datagram.m_inFlight)
+	{
+		datagram.m_inFlight = false;
+		m_inFlight.erase(std::find(m_inFlight.begin(), m_inFlight.end(), sequence));
+
+		auto sample = now - datagram.m_sendTime;
+
+		if (!m_measuredRoundTrip)
+		{
+			m_roundTripTime = sample;
+			m_roundTripVariance = sample / int64_t(2);
+			m_measuredRoundTrip = true;
+		}
+		else
+		{
+			auto difference = m_roundTripTime > sample ? m_roundTripTime - sample : sample - m_roundTripTime;
+			m_roundTripVariance = 0.75f * m_roundTripVariance + 0.25f * difference;
+			m_roundTripTime = 0.875f * m_roundTripTime + 0.125f * sample;
+		}
+
+		// Slow start doubles the window each round trip, then it grows by one datagram each round trip.
+		m_congestionWindow += m_congestionWindow < m_slowStartThreshold ? 1.0f : 1.0f / m_congestionWindow;
+		m_congestionWindow = std::min(m_congestionWindow, CONGESTION_WINDOW_MAX);
+	}
+
+	// Acknowledgements of a datagram already declared lost still count, the resent fragments are then ignored by the peer.
+	for (const auto &fragment : datagram.m_fragments)
+	{
+		auto message = FindReliable(fragment.m_message);
+
+		if (message && !message->m_acked[fragment.m_fragment])
+		{
+			message->m_acked[fragment.m_fragment] = true;
+			message->m_pending[fragment.m_fragment] = false;
+			message->m_ackedCount++;
+		}
+	}
+
+	datagram.m_fragments.clear();
+
+	while (!m_reliableOut.empty() && m_reliableOut.front().m_ackedCount == m_reliableOut.front().m_fragmentCount)
+	{
+		m_reliableOut.pop_front();
+	}
+}
+
+void UdpConnection::OnLost(SentDatagram &datagram, const Time &now)
+{
+	datagram.m_inFlight = false;
+
+	for (const auto &fragment : datagram.m_fragments)
+	{
+		auto message = FindReliable(fragment.m_message);
+
+		if (message && !message->m_acked[fragment.m_fragment])
+		{
+			message->m_pending[fragment.m_fragment] = true;
+		}
+	}
+
+	// Datagrams lost together are one congestion event, the window is halved at most once each round trip.
+	if (now - m_lastLoss > m_roundTripTime)
+	{
+		m_slowStartThreshold = std::max(m_congestionWindow / 2.0f, CONGESTION_WINDOW_MIN);
+		m_congestionWindow = m_slowStartThreshold;
+		m_lastLoss = now;
+	}
+}
+
+void UdpConnection::OnFragment(const Channel &channel, const bool &compressed, const uint16_t &id, const uint16_t &fragment, const uint16_t &fragmentCount,
+	const char *data, const std::size_t &size, const Time &now)
+{
+	// Resent fragments of messages already delivered, and messages too old or too new for the window are ignored.
+	if (channel == Channel::Reliable && (static_cast<uint16_t>(id - m_expectedReliableId) >= MaxReliablePending || m_reliableReady.count(id) != 0))
+	{
+		return;
+	}
+
+	if (channel == Channel::Sequenced && m_receivedSequenced && !SequenceGreater(id, m_lastSequencedId))
+	{
+		return;
+	}
+
+	if (fragmentCount == 1)
+	{
+		Deliver(channel, id, compressed, std::vector<char>(data, data + size));
+		return;
+	}
+
+	// Every fragment but the last is full, so each fragment is written to its place in the message.
+	auto last = fragment == fragmentCount - 1;
+
+	if (!last && size != FragmentSize)
+	{
+		return;
+	}
+
+	auto &incoming = m_incoming[std::make_pair(channel, id)];
+
+	if (incoming.m_fragmentCount == 0)
+	{
+		incoming.m_data.resize(fragmentCount * FragmentSize);
+		incoming.m_fragmentCount = fragmentCount;
+		incoming.m_compressed = compressed;
+		incoming.m_received.assign(fragmentCount, false);
+		incoming.m_firstReceive = now;
+	}
+
+	if (incoming.m_fragmentCount != fragmentCount || incoming.m_compressed != compressed || incoming.m_received[fragment])
+	{
+		return;
+	}
+
+	std::memcpy(incoming.m_data.data() + fragment * FragmentSize, data, size);
+	incoming.m_received[fragment] = true;
+	incoming.m_receivedCount++;
+
+	if (last)
+	{
+		incoming.m_size = fragment * FragmentSize + size;
+	}
+
+	if (incoming.m_receivedCount == incoming.m_fragmentCount)
+	{
+		auto message = std::move(incoming.m_data);
+		message.resize(incoming.m_size);
+		m_incoming.erase(std::make_pair(channel, id));
+		Deliver(channel, id, compressed, std::move(message));
+	}
+}
+
+void UdpConnection::Deliver(const Channel &channel, const uint16_t &id, const bool &compressed, std::vector<char> &&data)
+{
+	// A message that fails to decompress is still delivered empty, so reliable messages after it are not held back.
+	if (compressed && !Decompress(channel, data))
+	{
+		data.clear();
+	}
+
+	switch (channel)
+	{
+	case Channel::Unreliable:
+		m_delivered.emplace_back(std::move(data));
+		break;
+	case Channel::Sequenced:
+		if (!m_receivedSequenced || SequenceGreater(id, m_lastSequencedId))
+		{
+			m_lastSequencedId = id;
+			m_receivedSequenced = true;
+			m_delivered.emplace_back(std::move(data));
+		}
+
+		break;
+	case Channel::Reliable:
+		if (id != m_expectedReliableId)
+		{
+			m_reliableReady.emplace(id, std::move(data));
+			break;
+		}
+
+		m_delivered.emplace_back(std::move(data));
+		m_expectedReliableId++;
+
+		// Messages that arrived before this one are delivered in order behind it.
+		for (auto it = m_reliableReady.find(m_expectedReliableId); it != m_reliableReady.end(); it = m_reliableReady.find(m_expectedReliableId))
+		{
+			m_delivered.emplace_back(std::move(it->second));
+			m_reliableReady.erase(it);
+			m_expectedReliableId++;
+		}
+
+		break;
+	}
+}
+
+bool UdpConnection::AppendFragment(OutgoingMessage &message, const uint16_t &fragment, const Time &now, Socket::Status &status)
+{
+	auto offset = fragment * FragmentSize;
+	auto size = std::min(message.m_data.size() - offset, FragmentSize);
+	auto fragmented = message.m_fragmentCount > 1;
+	auto headerSize = fragmented ? FRAGMENTED_HEADER_SIZE : FRAGMENT_HEADER_SIZE;
+
+	if (m_datagram.size() + headerSize + size > MaxDatagramSize)
+	{
+		auto sendStatus = SendDatagram(now, true);
+
+		if (sendStatus != Socket::Status::Done)
+		{
+			status = sendStatus;
+		}
+
+		if (m_inFlight.size() >= static_cast<std::size_t>(m_congestionWindow))
+		{
+			return false;
+		}
+	}
+
+	auto position = m_datagram.size();
+	m_datagram.resize(position + headerSize + size);
+	auto destination = m_datagram.data() + position;
+
+	destination[0] = static_cast<char>(static_cast<uint8_t>(message.m_channel) | (fragmented ? FRAGMENTED_FLAG : 0) | (message.m_compressed ? COMPRESSED_FLAG : 0));
+	Write16(destination + 1, message.m_id);
+
+	if (fragmented)
+	{
+		Write16(destination + 3, fragment);
+		Write16(destination + 5, message.m_fragmentCount);
+	}
+
+	Write16(destination + headerSize - 2, static_cast<uint16_t>(size));
+	std::memcpy(destination + headerSize, message.m_data.data() + offset, size);
+
+	if (message.m_channel == Channel::Reliable)
+	{
+		m_datagramFragments.emplace_back(FragmentId{ message.m_id, fragment });
+	}
+
+	return true;
+}
+
+Socket::Status UdpConnection::SendDatagram(const Time &now, const bool &inFlight)
+{
+	Write16(m_datagram.data(), PROTOCOL_ID);
+	Write16(m_datagram.data() + 2, m_localSequence);
+	Write16(m_datagram.data() + 4, m_remoteSequence);
+	Write32(m_datagram.data() + 6, m_receivedBits);
+
+	auto &datagram = m_sent[m_localSequence % SENT_SIZE];
+	datagram.m_sequence = m_localSequence;
+	datagram.m_sendTime = now;
+	datagram.m_inFlight = inFlight;
+	datagram.m_acked = false;
+	datagram.m_fragments.swap(m_datagramFragments);
+	m_datagramFragments.clear();
+
+	if (inFlight)
+	{
+		m_inFlight.emplace_back(m_localSequence);
+	}
+
+	auto status = m_socket->Send(m_datagram.data(), m_datagram.size(), m_remoteAddress, m_remotePort);
+
+	m_localSequence++;
+	m_datagram.resize(HEADER_SIZE);
+	m_ackPending = false;
+	return status;
+}
+
+bool UdpConnection::Compress(const Channel &channel, const void *data, const std::size_t &size, std::vector<char> &compressed) const
+{
+	auto index = static_cast<std::size_t>(channel);
+
+	if (!m_compress[index] || size < MinCompressSize)
+	{
+		return false;
+	}
+
+	auto &dictionary = m_dictionaries[index];
+	compressed.resize(COMPRESSED_HEADER_SIZE);
+	Write32(compressed.data(), static_cast<uint32_t>(size));
+	Write32(compressed.data() + 4, m_dictionaryIds[index]);
+	Lz4::Compress(static_cast<const char *>(data), size, compressed, dictionary.data(), dictionary.size());
+
+	// Messages that do not shrink are sent as they are.
+	return compressed.size() < size;
+}
+
+bool UdpConnection::Decompress(const Channel &channel, std::vector<char> &data) const
+{
+	auto index = static_cast<std::size_t>(channel);
+
+	if (data.size() < COMPRESSED_HEADER_SIZE)
+	{
+		return false;
+	}
+
+	auto size = Read32(data.data());
+	auto dictionaryId = Read32(data.data() + 4);
+
+	if (dictionaryId != m_dictionaryIds[index])
+	{
+		Log::Error("Compressed message on channel %i uses a different dictionary than this connection\n", static_cast<int32_t>(index));
+		return false;
+	}
+
+	// A block can not expand by more than 255 times, larger sizes are malformed.
+	if (size > (data.size() - COMPRESSED_HEADER_SIZE) * 255)
+	{
+		return false;
+	}
+
+	auto &dictionary = m_dictionaries[index];
+	std::vector<char> uncompressed(size);
+
+	if (!Lz4::Decompress(data.data() + COMPRESSED_HEADER_SIZE, data.size() - COMPRESSED_HEADER_SIZE, uncompressed.data(), uncompressed.size(),
+		dictionary.data(), dictionary.size()))
+	{
+		return false;
+	}
+
+	data = std::move(uncompressed);
+	return true;
+}
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <deque>
+
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Time.hpp"
+#include "Network/IpAddress.hpp"
+#include "Network/Socket.hpp"
+
+namespace acid
+{
+class Packet;
+class UdpSocket;
+
+/**
+ * @brief A connection to one remote peer over a acid::UdpSocket, that sends messages on reliable and unreliable channels.
+ * Latency sensitive state is sent over UDP, a lost datagram only delays the reliable messages it carried instead of every message after it.
+ *
+ * Every datagram has a sequence number, and acknowledges the latest datagram received from the peer and the 32 before it.
+ * Messages are split into fragments that fit a datagram under the path MTU, many small messages are packed into one datagram.
+ * Messages on a channel with compression are compressed with acid::Lz4 before they are split, against the channels dictionary if it has one.
+ * Each compressed message is flagged and carries the id of its dictionary, so a peer without compression still reads them and a dictionary mismatch is detected.
+ * Reliable fragments carried by a datagram that is not acknowledged within the retransmission timeout, or that is late
+ * while a datagram sent after it was acknowledged, are sent again, only the lost fragments are resent. The number of datagrams in flight is limited by a congestion window that grows
+ * as datagrams are acknowledged and halves when they are lost.
+ *
+ * A socket can be shared by many connections, such as every client of a server.
+ * The owner of the socket receives each datagram and gives it to the connection of its remote address with OnReceive.
+ * Update is called once per tick to send queued messages, resend lost fragments and send acknowledgements.
+ **/
+class ACID_EXPORT UdpConnection :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief How messages on a channel are delivered.
+	 **/
+	enum class Channel : uint8_t
+	{
+		/// Delivered at most once and in any order, messages the congestion window does not allow sending by the next update are dropped.
+		Unreliable,
+		/// Delivered at most once, a message arriving after a newer one is dropped. Dropped like unreliable messages.
+		Sequenced,
+		/// Delivered exactly once, in the order they were sent.
+		Reliable
+	};
+
+	/**
+	 * Creates a connection to a remote peer.
+	 * @param socket The bound socket datagrams are sent with, it must outlive the connection.
+	 * @param remoteAddress Address of the remote peer.
+	 * @param remotePort Port of the remote peer.
+	 **/
+	UdpConnection(UdpSocket &socket, const IpAddress &remoteAddress, const uint16_t &remotePort);
+
+	/**
+	 * Queue a message to be sent by the next update.
+	 * @param packet Packet containing the message, it is copied and can be reused once this returns.
+	 * @param channel The channel to send the message on.
+	 * @return If the message was queued, messages over MaxFragments or reliable messages past MaxReliablePending are refused.
+	 **/
+	bool Send(Packet &packet, const Channel &channel);
+
+	/**
+	 * Sets if messages sent on a channel are compressed, messages smaller than MinCompressSize or that do not shrink are sent as they are.
+	 * @param channel The channel.
+	 * @param compress If messages are compressed.
+	 **/
+	void SetCompression(const Channel &channel, const bool &compress) { m_compress[static_cast<std::size_t>(channel)] = compress; }
+
+	bool IsCompressed(const Channel &channel) const { return m_compress[static_cast<std::size_t>(channel)]; }
+
+	/**
+	 * Sets the dictionary messages on a channel are compressed and decompressed with, the peer must set the same dictionary.
+	 * @param channel The channel.
+	 * @param dictionary The dictionary, empty for none.
+	 **/
+	void SetDictionary(const Channel &channel, std::vector<char> dictionary);
+
+	/**
+	 * Read a datagram received from the remote peer, messages it completes are delivered by Receive.
+	 * @param data Pointer to the received bytes.
+	 * @param size Number of bytes received.
+	 * @return If the datagram was read, datagrams from another protocol or that are malformed are ignored.
+	 **/
+	bool OnReceive(const void *data, const std::size_t &size);
+
+	/**
+	 * Take the next delivered message.
+	 * @param packet Packet to fill with the message.
+	 * @return If a message was delivered.
+	 **/
+	bool Receive(Packet &packet);
+
+	/**
+	 * Send queued messages and lost reliable fragments while the congestion window allows it,
+	 * and a acknowledgement when datagrams have been received but no data is sent.
+	 * @return Status code of the socket sends.
+	 **/
+	Socket::Status Update();
+
+	const IpAddress &GetRemoteAddress() const { return m_remoteAddress; }
+
+	const uint16_t &GetRemotePort() const { return m_remotePort; }
+
+	/**
+	 * Gets the smoothed round trip time to the peer, measured from acknowledged datagrams.
+	 * @return The round trip time.
+	 **/
+	const Time &GetRoundTripTime() const { return m_roundTripTime; }
+
+	/**
+	 * Gets the number of datagrams allowed in flight before the connection waits for acknowledgements.
+	 * @return The congestion window.
+	 **/
+	float GetCongestionWindow() const { return m_congestionWindow; }
+
+	/**
+	 * Gets the number of reliable messages sent and not fully acknowledged yet.
+	 * @return The unacknowledged message count.
+	 **/
+	std::size_t GetReliablePending() const { return m_reliableOut.size(); }
+
+	/**
+	 * Gets the time since a datagram was last received from the peer, used to time out connections.
+	 * @return The time since the last receive.
+	 **/
+	Time GetTimeSinceReceive() const;
+
+	/// Size of the datagrams sent, below the MTU of almost every path so datagrams are not fragmented by IP.
+	static constexpr std::size_t MaxDatagramSize = 1200;
+	/// Size of each fragment a message is split into, the last fragment of a message may be smaller.
+	static constexpr std::size_t FragmentSize = 1024;
+	/// The most fragments a message can be split into.
+	static constexpr std::size_t MaxFragments = 1024;
+	/// The most reliable messages waiting for acknowledgement, kept well below half the message ids so ids can wrap.
+	static constexpr std::size_t MaxReliablePending = 4096;
+	/// Messages smaller than this are never compressed.
+	static constexpr std::size_t MinCompressSize = 64;
+
+private:
+	/**
+	 * @brief A fragment of a message, the fragments of a message share its id.
+	 **/
+	class FragmentId
+	{
+	public:
+		uint16_t m_message;
+		uint16_t m_fragment;
+	};
+
+	/**
+	 * @brief A reliable message sent until each of its fragments is acknowledged.
+	 **/
+	class OutgoingMessage
+	{
+	public:
+		uint16_t m_id = 0;
+		Channel m_channel = Channel::Reliable;
+		bool m_compressed = false;
+		std::vector<char> m_data;
+		uint16_t m_fragmentCount = 0;
+		uint16_t m_ackedCount = 0;
+		std::vector<bool> m_acked;
+		/// Fragments not sent yet, or carried by a datagram that was lost.
+		std::vector<bool> m_pending;
+	};
+
+	/**
+	 * @brief A message being reassembled from its fragments.
+	 **/
+	class IncomingMessage
+	{
+	public:
+		std::vector<char> m_data;
+		std::size_t m_size = 0;
+		bool m_compressed = false;
+		uint16_t m_fragmentCount = 0;
+		uint16_t m_receivedCount = 0;
+		std::vector<bool> m_received;
+		Time m_firstReceive;
+	};
+
+	/**
+	 * @brief A sent datagram, and the reliable fragments it carried.
+	 **/
+	class SentDatagram
+	{
+	public:
+		uint16_t m_sequence = 0;
+		Time m_sendTime;
+		bool m_inFlight = false;
+		bool m_acked = false;
+		std::vector<FragmentId> m_fragments;
+	};
+
+	static bool SequenceGreater(const uint16_t &a, const uint16_t &b);
+
+	OutgoingMessage *FindReliable(const uint16_t &id);
+
+	void OnAcked(const uint16_t &sequence, const Time &now);
+
+	void OnLost(SentDatagram &datagram, const Time &now);
+
+	void OnFragment(const Channel &channel, const bool &compressed, const uint16_t &id, const uint16_t &fragment, const uint16_t &fragmentCount, const char *data,
+		const std::size_t &size, const Time &now);
+
+	bool AppendFragment(OutgoingMessage &message, const uint16_t &fragment, const Time &now, Socket::Status &status);
+
+	void Deliver(const Channel &channel, const uint16_t &id, const bool &compressed, std::vector<char> &&data);
+
+	bool Compress(const Channel &channel, const void *data, const std::size_t &size, std::vector<char> &compressed) const;
+
+	bool Decompress(const Channel &channel, std::vector<char> &data) const;
+
+	Socket::Status SendDatagram(const Time &now, const bool &inFlight);
+
+	UdpSocket *m_socket;
+	IpAddress m_remoteAddress;
+	uint16_t m_remotePort;
+
+	uint16_t m_localSequence;
+	uint16_t m_remoteSequence;
+	uint32_t m_receivedBits;
+	bool m_receivedAny;
+	bool m_ackPending;
+	Time m_lastReceive;
+
+	/// Sent datagrams indexed by sequence, and the sequences still in flight in the order they were sent.
+	std::vector<SentDatagram> m_sent;
+	std::deque<uint16_t> m_inFlight;
+	/// The datagram being written, and the reliable fragments written to it.
+	std::vector<char> m_datagram;
+	std::vector<FragmentId> m_datagramFragments;
+
+	uint16_t m_nextReliableId;
+	uint16_t m_nextUnreliableId;
+	std::deque<OutgoingMessage> m_reliableOut;
+	std::vector<OutgoingMessage> m_unreliableOut;
+
+	uint16_t m_expectedReliableId;
+	uint16_t m_lastSequencedId;
+	bool m_receivedSequenced;
+	std::map<std::pair<Channel, uint16_t>, IncomingMessage> m_incoming;
+	std::map<uint16_t, std::vector<char>> m_reliableReady;
+	std::deque<std::vector<char>> m_delivered;
+
+	Time m_roundTripTime;
+	Time m_roundTripVariance;
+	bool m_measuredRoundTrip;
+	float m_congestionWindow;
+	float m_slowStartThreshold;
+	Time m_lastLoss;
+	/// Send time of the latest sent datagram that was acknowledged, older datagrams still in flight are late.
+	Time m_ackedSendTime;
+
+	std::array<bool, 3> m_compress;
+	std::array<std::vector<char>, 3> m_dictionaries;
+	std::array<uint32_t, 3> m_dictionaryIds;
+};
+}
@@ -6,6 +6,12 @@
 
 #else
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <errno.h>
+#endif
+
+#if defined(ACID_BUILD_LINUX)
+#include <netinet/udp.h>
 #endif
 
 #include "Engine/Log.hpp"
@@ -15,13 +21,33 @@
 namespace acid
 {
 static const uint32_t MAX_DATAGRAM_SIZE = 65507;
+// The most datagrams moved by one system call, the headers for a call are on the stack.
+static const std::size_t MAX_BATCH = 64;
+// The most segments the kernel splits one send into.
+static const std::size_t MAX_SEGMENTS = 64;
+
+static std::atomic<uint64_t> DATAGRAMS_SENT = 0;
+static std::atomic<uint64_t> BYTES_SENT = 0;
+static std::atomic<uint64_t> DATAGRAMS_RECEIVED = 0;
+static std::atomic<uint64_t> BYTES_RECEIVED = 0;
 
 UdpSocket::UdpSocket() :
 	Socket(Type::Udp),
-	m_buffer(MAX_DATAGRAM_SIZE)
+	m_buffer(MAX_DATAGRAM_SIZE),
+	m_segmentationUnsupported(false)
 {
 }
 
+UdpSocket::Traffic UdpSocket::GetTraffic()
+{
+	Traffic traffic;
+	traffic.m_datagramsSent = DATAGRAMS_SENT.load(std::memory_order_relaxed);
+	traffic.m_bytesSent = BYTES_SENT.load(std::memory_order_relaxed);
+	traffic.m_datagramsReceived = DATAGRAMS_RECEIVED.load(std::memory_order_relaxed);
+	traffic.m_bytesReceived = BYTES_RECEIVED.load(std::memory_order_relaxed);
+	return traffic;
+}
+
 uint16_t UdpSocket::GetLocalPort() const
 {
 	if (GetHandle() != InvalidSocketHandle())
@@ -96,6 +122,7 @@ Socket::Status UdpSocket::Send(const void *data, const std::size_t &size, const
 		return GetErrorStatus();
 	}
 
+	CountSent(1, size);
 	return Status::Done;
 }
 
@@ -131,6 +158,282 @@ Socket::Status UdpSocket::Receive(void *data, const std::size_t &size, std::size
 	remoteAddress = IpAddress(ntohl(address.sin_addr.s_addr));
 	remotePort = ntohs(address.sin_port);
 
+	CountReceived(1, received);
+	return Status::Done;
+}
+
+Socket::Status UdpSocket::Send(const Datagram *datagrams, const std::size_t &count, std::size_t &sent)
+{
+	sent = 0;
+
+	// Create the internal socket if it doesn't exist.
+	Create();
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		if (datagrams[i].m_size > MAX_DATAGRAM_SIZE)
+		{
+			Log::Error("Cannot send data over the network (the number of bytes to send is greater than UdpSocket::MAX_DATAGRAM_SIZE)\n");
+			return Status::Error;
+		}
+	}
+
+#if defined(ACID_BUILD_LINUX)
+	while (sent < count)
+	{
+		auto batch = std::min(count - sent, MAX_BATCH);
+		mmsghdr headers[MAX_BATCH] = {};
+		iovec buffers[MAX_BATCH];
+		sockaddr_in addresses[MAX_BATCH];
+
+		for (std::size_t i = 0; i < batch; i++)
+		{
+			const auto &datagram = datagrams[sent + i];
+			addresses[i] = CreateAddress(datagram.m_address.ToInteger(), datagram.m_port);
+			buffers[i].iov_base = datagram.m_data;
+			buffers[i].iov_len = datagram.m_size;
+			headers[i].msg_hdr.msg_name = &addresses[i];
+			headers[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+			headers[i].msg_hdr.msg_iov = &buffers[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		auto result = sendmmsg(GetHandle(), headers, static_cast<unsigned int>(batch), 0);
+
+		if (result < 0)
+		{
+			return sent == 0 ? GetErrorStatus() : Status::Partial;
+		}
+
+		std::size_t bytes = 0;
+
+		for (std::size_t i = 0; i < static_cast<std::size_t>(result); i++)
+		{
+			bytes += datagrams[sent + i].m_size;
+		}
+
+		CountSent(static_cast<std::size_t>(result), bytes);
+		sent += static_cast<std::size_t>(result);
+
+		// The kernel stops at a datagram that fails, sending it alone reports its error.
+		if (static_cast<std::size_t>(result) < batch)
+		{
+			auto status = Send(datagrams[sent].m_data, datagrams[sent].m_size, datagrams[sent].m_address, datagrams[sent].m_port);
+
+			if (status != Status::Done)
+			{
+				return sent == 0 ? status : Status::Partial;
+			}
+
+			sent++;
+		}
+	}
+#else
+	for (; sent < count; sent++)
+	{
+		auto status = Send(datagrams[sent].m_data, datagrams[sent].m_size, datagrams[sent].m_address, datagrams[sent].m_port);
+
+		if (status != Status::Done)
+		{
+			return sent == 0 ? status : Status::Partial;
+		}
+	}
+#endif
+
+	return Status::Done;
+}
+
+Socket::Status UdpSocket::Receive(Datagram *datagrams, const std::size_t &count, std::size_t &received)
+{
+	received = 0;
+
+	if (count == 0)
+	{
+		return Status::Done;
+	}
+
+#if defined(ACID_BUILD_LINUX)
+	while (received < count)
+	{
+		auto batch = std::min(count - received, MAX_BATCH);
+		mmsghdr headers[MAX_BATCH] = {};
+		iovec buffers[MAX_BATCH];
+		sockaddr_in addresses[MAX_BATCH];
+
+		for (std::size_t i = 0; i < batch; i++)
+		{
+			buffers[i].iov_base = datagrams[received + i].m_data;
+			buffers[i].iov_len = datagrams[received + i].m_capacity;
+			headers[i].msg_hdr.msg_name = &addresses[i];
+			headers[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+			headers[i].msg_hdr.msg_iov = &buffers[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		// Only the first call may block, and it returns once one datagram arrived with those already waiting.
+		auto result = recvmmsg(GetHandle(), headers, static_cast<unsigned int>(batch), received == 0 ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr);
+
+		if (result < 0)
+		{
+			return received == 0 ? GetErrorStatus() : Status::Done;
+		}
+
+		std::size_t bytes = 0;
+
+		for (std::size_t i = 0; i < static_cast<std::size_t>(result); i++)
+		{
+			auto &datagram = datagrams[received + i];
+			datagram.m_size = headers[i].msg_len;
+			datagram.m_address = IpAddress(ntohl(addresses[i].sin_addr.s_addr));
+			datagram.m_port = ntohs(addresses[i].sin_port);
+			bytes += datagram.m_size;
+		}
+
+		CountReceived(static_cast<std::size_t>(result), bytes);
+
+		received += static_cast<std::size_t>(result);
+
+		if (static_cast<std::size_t>(result) < batch)
+		{
+			break;
+		}
+	}
+#else
+	for (; received < count; received++)
+	{
+		auto &datagram = datagrams[received];
+
+		// After the first datagram only those already waiting are taken, so a blocking socket does not wait again.
+		if (received != 0 && IsBlocking())
+		{
+#if defined(ACID_BUILD_WINDOWS)
+			u_long waiting = 0;
+
+			if (ioctlsocket(GetHandle(), FIONREAD, &waiting) != 0 || waiting == 0)
+			{
+				break;
+			}
+#endif
+		}
+
+		sockaddr_in address = CreateAddress(INADDR_ANY, 0);
+		SocketAddrLength addressSize = sizeof(address);
+#if defined(ACID_BUILD_WINDOWS)
+		int flags = 0;
+#else
+		int flags = received != 0 ? MSG_DONTWAIT : 0;
+#endif
+		int sizeReceived = recvfrom(GetHandle(), static_cast<char *>(datagram.m_data), static_cast<int>(datagram.m_capacity), flags,
+			reinterpret_cast<sockaddr *>(&address), &addressSize);
+
+		if (sizeReceived < 0)
+		{
+			if (received == 0)
+			{
+				return GetErrorStatus();
+			}
+
+			break;
+		}
+
+		datagram.m_size = static_cast<std::size_t>(sizeReceived);
+		datagram.m_address = IpAddress(ntohl(address.sin_addr.s_addr));
+		datagram.m_port = ntohs(address.sin_port);
+		CountReceived(1, datagram.m_size);
+	}
+#endif
+
+	return Status::Done;
+}
+
+Socket::Status UdpSocket::SendSegmented(const void *data, const std::size_t &size, const std::size_t &segmentSize, const IpAddress &remoteAddress,
+	const uint16_t &remotePort)
+{
+	if (segmentSize == 0)
+	{
+		return Status::Error;
+	}
+
+	auto bytes = static_cast<const char *>(data);
+
+#if defined(ACID_BUILD_LINUX) && defined(UDP_SEGMENT)
+	// Create the internal socket if it doesn't exist.
+	Create();
+
+	sockaddr_in address = CreateAddress(remoteAddress.ToInteger(), remotePort);
+	auto chunk = std::min(segmentSize * MAX_SEGMENTS, static_cast<std::size_t>(MAX_DATAGRAM_SIZE) / segmentSize * segmentSize);
+
+	for (std::size_t offset = 0; !m_segmentationUnsupported && offset < size && chunk != 0;)
+	{
+		auto length = std::min(size - offset, chunk);
+		iovec buffer = { const_cast<char *>(bytes + offset), length };
+		char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+
+		msghdr header = {};
+		header.msg_name = &address;
+		header.msg_namelen = sizeof(address);
+		header.msg_iov = &buffer;
+		header.msg_iovlen = 1;
+		header.msg_control = control;
+		header.msg_controllen = sizeof(control);
+
+		auto message = CMSG_FIRSTHDR(&header);
+		message->cmsg_level = SOL_UDP;
+		message->cmsg_type = UDP_SEGMENT;
+		message->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+		auto segment = static_cast<uint16_t>(segmentSize);
+		std::memcpy(CMSG_DATA(message), &segment, sizeof(segment));
+
+		if (sendmsg(GetHandle(), &header, 0) < 0)
+		{
+			// Kernels and devices without segmentation offload refuse it, the rest is sent a datagram at a time.
+			if (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP)
+			{
+				m_segmentationUnsupported = true;
+				bytes += offset;
+				break;
+			}
+
+			return GetErrorStatus();
+		}
+
+		CountSent((length + segmentSize - 1) / segmentSize, length);
+		offset += length;
+
+		if (offset == size)
+		{
+			return Status::Done;
+		}
+	}
+
+	auto remaining = size - static_cast<std::size_t>(bytes - static_cast<const char *>(data));
+#else
+	auto remaining = size;
+#endif
+
+	Datagram datagrams[MAX_BATCH];
+
+	for (std::size_t offset = 0; offset < remaining;)
+	{
+		std::size_t count = 0;
+
+		for (; count < MAX_BATCH && offset < remaining; count++, offset += segmentSize)
+		{
+			datagrams[count].m_data = const_cast<char *>(bytes + offset);
+			datagrams[count].m_size = std::min(segmentSize, remaining - offset);
+			datagrams[count].m_address = remoteAddress;
+			datagrams[count].m_port = remotePort;
+		}
+
+		std::size_t sent = 0;
+		auto status = Send(datagrams, count, sent);
+
+		if (status != Status::Done)
+		{
+			return status;
+		}
+	}
+
 	return Status::Done;
 }
 
@@ -169,4 +472,16 @@ Socket::Status UdpSocket::Receive(Packet &packet, IpAddress &remoteAddress, uint
 
 	return status;
 }
+
+void UdpSocket::CountSent(const std::size_t &datagrams, const std::size_t &bytes)
+{
+	DATAGRAMS_SENT.fetch_add(datagrams, std::memory_order_relaxed);
+	BYTES_SENT.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void UdpSocket::CountReceived(const std::size_t &datagrams, const std::size_t &bytes)
+{
+	DATAGRAMS_RECEIVED.fetch_add(datagrams, std::memory_order_relaxed);
+	BYTES_RECEIVED.fetch_add(bytes, std::memory_order_relaxed);
+}
 }
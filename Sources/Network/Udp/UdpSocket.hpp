@@ -33,6 +33,9 @@ class Packet;
  * Indeed, even packets are unable to split and recompose data, due to the unreliability of the protocol
  * (dropped, mixed or duplicated datagrams may lead to a big mess when trying to recompose a packet).
  * 
+ * Servers with many peers send and receive in batches, many datagrams are moved with one system call
+ * (sendmmsg and recvmmsg on Linux) into buffers the caller allocated once, and on other platforms the batch is a loop.
+ * 
  * If the socket is bound to a port, it is automatically unbound from it when the socket is destroyed.
  * However, you can unbind the socket explicitly with the Unbind function if necessary,
  * to stop receiving messages or make the port available for other sockets.
@@ -41,11 +44,46 @@ class ACID_EXPORT UdpSocket :
 	public Socket
 {
 public:
+	/**
+	 * @brief A datagram sent or received in a batch, it points to memory owned by the caller so batches do not allocate.
+	 **/
+	class Datagram
+	{
+	public:
+		/// The bytes to send, or the buffer to receive into.
+		void *m_data = nullptr;
+		/// Number of bytes to send, or the number of bytes received.
+		std::size_t m_size = 0;
+		/// Size of the buffer to receive into, unused when sending.
+		std::size_t m_capacity = 0;
+		/// Address of the receiver, or of the peer that sent the datagram.
+		IpAddress m_address;
+		uint16_t m_port = 0;
+	};
+
+	/**
+	 * @brief The datagrams and bytes moved by every UDP socket since the start of the engine.
+	 **/
+	class Traffic
+	{
+	public:
+		uint64_t m_datagramsSent = 0;
+		uint64_t m_bytesSent = 0;
+		uint64_t m_datagramsReceived = 0;
+		uint64_t m_bytesReceived = 0;
+	};
+
 	/**
 	 * Default constructor.
 	 **/
 	UdpSocket();
 
+	/**
+	 * Gets the traffic of every UDP socket, the counts are kept in atomics so this can be called from any thread.
+	 * @return The traffic counts. 
+	 **/
+	static Traffic GetTraffic();
+
 	/**
 	 * Get the port to which the socket is bound locally. If the socket is not bound to a port, this function returns 0.
 	 * @return Port to which the socket is bound. 
@@ -98,6 +136,37 @@ public:
 	 **/
 	Status Receive(void *data, const std::size_t &size, std::size_t &received, IpAddress &remoteAddress, uint16_t &remotePort);
 
+	/**
+	 * Send many datagrams, each to its own receiver.
+	 * @param datagrams The datagrams to send. 
+	 * @param count Number of datagrams. 
+	 * @param sent This variable is filled with the number of datagrams sent, they are sent in order. 
+	 * @return Status code, Partial if only some of the datagrams were sent before the socket would block. 
+	 **/
+	Status Send(const Datagram *datagrams, const std::size_t &count, std::size_t &sent);
+
+	/**
+	 * Receive many datagrams.
+	 * In blocking mode, this function waits for the first datagram and then takes those already waiting without blocking again.
+	 * @param datagrams The datagrams to fill, each with a buffer and capacity. 
+	 * @param count Number of datagrams. 
+	 * @param received This variable is filled with the number of datagrams received. 
+	 * @return Status code, Done if at least one datagram was received. 
+	 **/
+	Status Receive(Datagram *datagrams, const std::size_t &count, std::size_t &received);
+
+	/**
+	 * Send a buffer split into datagrams of a size to one receiver, as when a message is fragmented.
+	 * On Linux the kernel splits the buffer with UDP segmentation offload, so a burst of datagrams costs one system call.
+	 * @param data Pointer to the sequence of bytes to send. 
+	 * @param size Number of bytes to send. 
+	 * @param segmentSize Size of each datagram, the last datagram may be smaller. 
+	 * @param remoteAddress Address of the receiver. 
+	 * @param remotePort Port of the receiver to send the data to. 
+	 * @return Status code. 
+	 **/
+	Status SendSegmented(const void *data, const std::size_t &size, const std::size_t &segmentSize, const IpAddress &remoteAddress, const uint16_t &remotePort);
+
 	/**
 	 * Send a formatted packet of data to a remote peer.
 	 * Make sure that the packet size is not greater than UdpSocket::MAX_DATAGRAM_SIZE, otherwise this function will fail and no data will be sent.
@@ -119,7 +188,13 @@ public:
 	Status Receive(Packet &packet, IpAddress &remoteAddress, uint16_t &remotePort);
 
 private:
+	static void CountSent(const std::size_t &datagrams, const std::size_t &bytes);
+
+	static void CountReceived(const std::size_t &datagrams, const std::size_t &bytes);
+
 	/// Temporary buffer holding the received data in Receive(Packet).
 	std::vector<char> m_buffer;
+	/// If the kernel refused segmentation offload, so SendSegmented sends each datagram.
+	bool m_segmentationUnsupported;
 };
 }
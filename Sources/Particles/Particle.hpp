@@ -1,13 +1,12 @@
 ﻿#pragma once
 
-#include "Maths/Vector2.hpp"
 #include "Maths/Vector3.hpp"
 #include "ParticleType.hpp"
 
 namespace acid
 {
 /**
- * @brief A instance of a particle type.
+ * @brief A instance of a particle type, this holds the values a particle is emitted with into a {@link ParticleList} or {@link ParticlePool}.
  */
 class ACID_EXPORT Particle
 {
@@ -26,11 +25,6 @@ public:
 	Particle(std::shared_ptr<ParticleType> particleType, const Vector3f &position, const Vector3f &velocity, const float &lifeLength, const float &stageCycles,
 		const float &rotation, const float &scale, const float &gravityEffect);
 
-	/**
-	 * Updates the particle.
-	 */
-	void Update();
-
 	bool IsAlive() const { return m_transparency > 0.0f; }
 
 	const std::shared_ptr<ParticleType> &GetParticleType() const { return m_particleType; }
@@ -39,10 +33,10 @@ public:
 
 	const Vector3f &GetVelocity() const { return m_velocity; }
 
-	const Vector3f &GetChange() const { return m_change; }
-
 	const float &GetLifeLength() const { return m_lifeLength; }
 
+	const float &GetStageCycles() const { return m_stageCycles; }
+
 	const float &GetRotation() const { return m_rotation; }
 
 	const float &GetScale() const { return m_scale; }
@@ -55,21 +49,11 @@ public:
 
 	const float &DistanceToCamera() const { return m_distanceToCamera; }
 
-	bool operator<(const Particle &other) const;
-
 private:
-	friend class ParticleType;
-
-	Vector2f CalculateImageOffset(const int32_t &index) const;
-
 	std::shared_ptr<ParticleType> m_particleType;
 
 	Vector3f m_position;
 	Vector3f m_velocity;
-	Vector3f m_change;
-
-	Vector2f m_imageOffset1;
-	Vector2f m_imageOffset2;
 
 	float m_lifeLength;
 	float m_stageCycles;
@@ -79,7 +63,6 @@ private:
 
 	float m_elapsedTime;
 	float m_transparency;
-	float m_imageBlendFactor;
 	float m_distanceToCamera;
 };
 }
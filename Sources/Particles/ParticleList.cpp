@@ -0,0 +1,197 @@
+#include "ParticleList.hpp"
+
+#include <numeric>
+#include "Maths/Simd.hpp"
+#include "Physics/FrustumCuller.hpp"
+#include "Particle.hpp"
+
+namespace acid
+{
+static const float FADE_TIME = 1.0f;
+
+ParticleList::ParticleList() :
+	m_size(0)
+{
+}
+
+void ParticleList::Add(const Particle &particle)
+{
+	Resize(m_size + 1);
+	m_positionX[m_size] = particle.GetPosition().m_x;
+	m_positionY[m_size] = particle.GetPosition().m_y;
+	m_positionZ[m_size] = particle.GetPosition().m_z;
+	m_velocityX[m_size] = particle.GetVelocity().m_x;
+	m_velocityY[m_size] = particle.GetVelocity().m_y;
+	m_velocityZ[m_size] = particle.GetVelocity().m_z;
+	m_lifeLength[m_size] = particle.GetLifeLength();
+	m_stageCycles[m_size] = particle.GetStageCycles();
+	m_rotation[m_size] = particle.GetRotation();
+	m_scale[m_size] = particle.GetScale();
+	m_gravityEffect[m_size] = particle.GetGravityEffect();
+	m_elapsedTime[m_size] = particle.GetElapsedTime();
+	m_transparency[m_size] = particle.GetTransparency();
+	m_distanceToCamera[m_size] = particle.DistanceToCamera();
+	m_size++;
+}
+
+void ParticleList::Add(const Vector3f &position, const Vector3f &velocity, const float &lifeLength, const float &stageCycles, const float &rotation, const float &scale,
+	const float &gravityEffect)
+{
+	Resize(m_size + 1);
+	m_positionX[m_size] = position.m_x;
+	m_positionY[m_size] = position.m_y;
+	m_positionZ[m_size] = position.m_z;
+	m_velocityX[m_size] = velocity.m_x;
+	m_velocityY[m_size] = velocity.m_y;
+	m_velocityZ[m_size] = velocity.m_z;
+	m_lifeLength[m_size] = lifeLength;
+	m_stageCycles[m_size] = stageCycles;
+	m_rotation[m_size] = rotation;
+	m_scale[m_size] = scale;
+	m_gravityEffect[m_size] = gravityEffect;
+	m_elapsedTime[m_size] = 0.0f;
+	m_transparency[m_size] = 1.0f;
+	m_distanceToCamera[m_size] = 0.0f;
+	m_size++;
+}
+
+void ParticleList::Append(const ParticleList &other)
+{
+	if (other.m_size == 0)
+	{
+		return;
+	}
+
+	Resize(m_size + other.m_size);
+	auto arrays = GetArrays();
+	auto otherArrays = other.GetArrays();
+
+	for (std::size_t i = 0; i < arrays.size(); i++)
+	{
+		std::copy_n(otherArrays[i]->begin(), other.m_size, arrays[i]->begin() + m_size);
+	}
+
+	m_size += other.m_size;
+}
+
+void ParticleList::Reserve(const uint32_t &capacity)
+{
+	for (auto array : GetArrays())
+	{
+		array->reserve((capacity + 3) & ~3u);
+	}
+}
+
+void ParticleList::Update(const float &delta, const Vector3f &cameraPosition)
+{
+	auto deltas = Simd::Splat(delta);
+	auto gravityDeltas = Simd::Splat(-10.0f * delta);
+	auto fadeTimes = Simd::Splat(FADE_TIME);
+	auto fadeRates = Simd::Splat(1.0f / FADE_TIME);
+	auto zeros = Simd::Splat(0.0f);
+	auto cameraX = Simd::Splat(cameraPosition.m_x);
+	auto cameraY = Simd::Splat(cameraPosition.m_y);
+	auto cameraZ = Simd::Splat(cameraPosition.m_z);
+
+	// The arrays are padded to four, so the lanes past the last particle are simulated and ignored.
+	for (uint32_t i = 0; i < m_size; i += 4)
+	{
+		auto velocityX = Simd::Load(&m_velocityX[i]);
+		auto velocityY = Simd::MultiplyAdd(Simd::Load(&m_gravityEffect[i]), gravityDeltas, Simd::Load(&m_velocityY[i]));
+		auto velocityZ = Simd::Load(&m_velocityZ[i]);
+		Simd::Store(&m_velocityY[i], velocityY);
+
+		auto positionX = Simd::MultiplyAdd(velocityX, deltas, Simd::Load(&m_positionX[i]));
+		auto positionY = Simd::MultiplyAdd(velocityY, deltas, Simd::Load(&m_positionY[i]));
+		auto positionZ = Simd::MultiplyAdd(velocityZ, deltas, Simd::Load(&m_positionZ[i]));
+		Simd::Store(&m_positionX[i], positionX);
+		Simd::Store(&m_positionY[i], positionY);
+		Simd::Store(&m_positionZ[i], positionZ);
+
+		auto elapsedTime = Simd::Add(Simd::Load(&m_elapsedTime[i]), deltas);
+		Simd::Store(&m_elapsedTime[i], elapsedTime);
+
+		// Fades over the last second of life, by the part of this frame that was inside that second.
+		auto fadeStart = Simd::Subtract(Simd::Load(&m_lifeLength[i]), fadeTimes);
+		auto fading = Simd::Min(Simd::Max(Simd::Subtract(elapsedTime, fadeStart), zeros), deltas);
+		Simd::Store(&m_transparency[i], Simd::Subtract(Simd::Load(&m_transparency[i]), Simd::Multiply(fading, fadeRates)));
+
+		auto toCameraX = Simd::Subtract(cameraX, positionX);
+		auto toCameraY = Simd::Subtract(cameraY, positionY);
+		auto toCameraZ = Simd::Subtract(cameraZ, positionZ);
+		auto distance = Simd::Multiply(toCameraX, toCameraX);
+		distance = Simd::MultiplyAdd(toCameraY, toCameraY, distance);
+		distance = Simd::MultiplyAdd(toCameraZ, toCameraZ, distance);
+		Simd::Store(&m_distanceToCamera[i], distance);
+	}
+
+	for (uint32_t i = 0; i < m_size;)
+	{
+		if (m_transparency[i] <= 0.0f)
+		{
+			SwapAndPop(i);
+			continue;
+		}
+
+		i++;
+	}
+
+	m_order.resize(m_size);
+	std::iota(m_order.begin(), m_order.end(), 0);
+	std::sort(m_order.begin(), m_order.end(), [this](const uint32_t &a, const uint32_t &b)
+	{
+		return m_distanceToCamera[a] > m_distanceToCamera[b];
+	});
+}
+
+void ParticleList::Clear()
+{
+	for (auto array : GetArrays())
+	{
+		array->clear();
+	}
+
+	m_size = 0;
+	m_order.clear();
+}
+
+void ParticleList::QueryFrustum(const Frustum &frustum, const float &radiusScale, std::vector<uint32_t> &visible) const
+{
+	FrustumCuller::CullSpheres(frustum, m_positionX.data(), m_positionY.data(), m_positionZ.data(), m_scale.data(), radiusScale, m_size, visible);
+}
+
+void ParticleList::SwapAndPop(const uint32_t &index)
+{
+	m_size--;
+
+	for (auto array : GetArrays())
+	{
+		(*array)[index] = (*array)[m_size];
+	}
+}
+
+std::array<ParticleList::Array *, 14> ParticleList::GetArrays()
+{
+	return { &m_positionX, &m_positionY, &m_positionZ, &m_velocityX, &m_velocityY, &m_velocityZ, &m_lifeLength, &m_stageCycles, &m_rotation, &m_scale,
+		&m_gravityEffect, &m_elapsedTime, &m_transparency, &m_distanceToCamera };
+}
+
+std::array<const ParticleList::Array *, 14> ParticleList::GetArrays() const
+{
+	return { &m_positionX, &m_positionY, &m_positionZ, &m_velocityX, &m_velocityY, &m_velocityZ, &m_lifeLength, &m_stageCycles, &m_rotation, &m_scale,
+		&m_gravityEffect, &m_elapsedTime, &m_transparency, &m_distanceToCamera };
+}
+
+void ParticleList::Resize(const uint32_t &size)
+{
+	if (size <= m_positionX.size())
+	{
+		return;
+	}
+
+	for (auto array : GetArrays())
+	{
+		array->resize((size + 3) & ~3u);
+	}
+}
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Engine/MemoryTracker.hpp"
+#include "Maths/Vector3.hpp"
+
+namespace acid
+{
+class Frustum;
+class Particle;
+
+/**
+ * @brief The CPU simulated particles of one type, each value is kept in its own array so the update runs four particles at a time.
+ * Dead particles are removed by moving the last particle into their place, so the order of particles is not kept between updates.
+ */
+class ACID_EXPORT ParticleList
+{
+public:
+	ParticleList();
+
+	/**
+	 * Adds a particle to the end of the list.
+	 * @param particle The particle to add.
+	 */
+	void Add(const Particle &particle);
+
+	/**
+	 * Adds a new particle to the end of the list, without building a {@link Particle} and copying its type.
+	 * @param position The particles initial position.
+	 * @param velocity The particles initial velocity.
+	 * @param lifeLength The particles life length.
+	 * @param stageCycles The amount of times stages will be shown.
+	 * @param rotation The particles rotation.
+	 * @param scale The particles scale.
+	 * @param gravityEffect The particles gravity effect.
+	 */
+	void Add(const Vector3f &position, const Vector3f &velocity, const float &lifeLength, const float &stageCycles, const float &rotation, const float &scale,
+		const float &gravityEffect);
+
+	/**
+	 * Adds every particle of another list to the end of this list, each array is copied at once.
+	 * @param other The list to add.
+	 */
+	void Append(const ParticleList &other);
+
+	/**
+	 * Grows the arrays to hold a number of particles without reallocating.
+	 * @param capacity The number of particles.
+	 */
+	void Reserve(const uint32_t &capacity);
+
+	/**
+	 * Simulates every particle, removes those that have died, and sorts the remaining far to near.
+	 * @param delta The frame delta in seconds.
+	 * @param cameraPosition The position distances are measured from.
+	 */
+	void Update(const float &delta, const Vector3f &cameraPosition);
+
+	void Clear();
+
+	/**
+	 * Finds the particles partially in a frustum, four particles are tested at a time from the position and scale arrays.
+	 * @param frustum The frustum to test against.
+	 * @param radiusScale The radius of each particle as a multiple of its scale.
+	 * @param visible The indices of the visible particles in ascending order, cleared first.
+	 */
+	void QueryFrustum(const Frustum &frustum, const float &radiusScale, std::vector<uint32_t> &visible) const;
+
+	bool IsEmpty() const { return m_size == 0; }
+
+	uint32_t GetSize() const { return m_size; }
+
+	/**
+	 * Gets the particle indices sorted from the furthest from the camera to the nearest.
+	 * @return The sorted indices.
+	 */
+	const TrackedVector<uint32_t, MemoryTag::Particles> &GetOrder() const { return m_order; }
+
+	Vector3f GetPosition(const uint32_t &index) const { return Vector3f(m_positionX[index], m_positionY[index], m_positionZ[index]); }
+
+	Vector3f GetVelocity(const uint32_t &index) const { return Vector3f(m_velocityX[index], m_velocityY[index], m_velocityZ[index]); }
+
+	const float &GetLifeLength(const uint32_t &index) const { return m_lifeLength[index]; }
+
+	const float &GetStageCycles(const uint32_t &index) const { return m_stageCycles[index]; }
+
+	const float &GetRotation(const uint32_t &index) const { return m_rotation[index]; }
+
+	const float &GetScale(const uint32_t &index) const { return m_scale[index]; }
+
+	const float &GetGravityEffect(const uint32_t &index) const { return m_gravityEffect[index]; }
+
+	const float &GetElapsedTime(const uint32_t &index) const { return m_elapsedTime[index]; }
+
+	const float &GetTransparency(const uint32_t &index) const { return m_transparency[index]; }
+
+	const float &GetDistanceToCamera(const uint32_t &index) const { return m_distanceToCamera[index]; }
+
+private:
+	using Array = TrackedVector<float, MemoryTag::Particles>;
+
+	/**
+	 * Moves the last particle into a index and shrinks the list by one.
+	 * @param index The index to remove.
+	 */
+	void SwapAndPop(const uint32_t &index);
+
+	/**
+	 * Gets every array of the list, the arrays are sized to a multiple of four so the update never reads past the end.
+	 * @return The arrays.
+	 */
+	std::array<Array *, 14> GetArrays();
+
+	std::array<const Array *, 14> GetArrays() const;
+
+	/**
+	 * Grows the arrays for a number of particles, padded to a multiple of four.
+	 * @param size The number of particles.
+	 */
+	void Resize(const uint32_t &size);
+
+	uint32_t m_size;
+
+	Array m_positionX;
+	Array m_positionY;
+	Array m_positionZ;
+	Array m_velocityX;
+	Array m_velocityY;
+	Array m_velocityZ;
+	Array m_lifeLength;
+	Array m_stageCycles;
+	Array m_rotation;
+	Array m_scale;
+	Array m_gravityEffect;
+	Array m_elapsedTime;
+	Array m_transparency;
+	Array m_distanceToCamera;
+
+	TrackedVector<uint32_t, MemoryTag::Particles> m_order;
+};
+}
@@ -0,0 +1,276 @@
+#include "ParticlePool.hpp"
+
+#include "Maths/Maths.hpp"
+#include "Models/Shapes/ModelRectangle.hpp"
+#include "Scenes/Scenes.hpp"
+#include "Particle.hpp"
+#include "ParticleList.hpp"
+
+namespace acid
+{
+static const uint32_t MIN_EMIT_PARTICLES = 256;
+static const float FADE_TIME = 1.0f;
+// Expiries are rounded up into steps so the CPU only tracks a few buckets, the slack covers frames where the GPU was a frame behind.
+static const float EXPIRY_STEP = 0.25f;
+static const float EXPIRY_SLACK = 0.5f;
+
+ParticlePool::ParticlePool(const uint32_t &capacity) :
+	m_capacity(Maths::NextPowerOfTwo(std::max(capacity, 2u))),
+	m_model(ModelRectangle::Create(-0.5f, 0.5f)),
+	m_aliveBound(0),
+	m_time(0.0f),
+	m_delta(0.0f),
+	m_parity(0),
+	m_reset(true),
+	m_particleBuffer(sizeof(Instance) * m_capacity, nullptr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+	m_aliveBuffer(sizeof(uint32_t) * 2 * m_capacity, nullptr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+	m_deadBuffer(sizeof(uint32_t) * m_capacity, nullptr, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+	m_counterBuffer(sizeof(VkDrawIndexedIndirectCommand) + 3 * sizeof(uint32_t)),
+	m_emitBuffer(std::make_unique<StorageBuffer>(sizeof(Instance) * MIN_EMIT_PARTICLES)),
+	m_uniformParticles(true)
+{
+}
+
+void ParticlePool::Emit(const Particle &particle)
+{
+	Instance instance = {};
+	instance.m_position = Vector4f(particle.GetPosition(), particle.GetRotation());
+	instance.m_velocity = Vector4f(particle.GetVelocity(), particle.GetGravityEffect());
+	instance.m_life = Vector4f(0.0f, particle.GetLifeLength(), particle.GetStageCycles(), particle.GetScale());
+	instance.m_state = Vector4f(particle.GetTransparency(), 0.0f, 0.0f, 0.0f);
+	m_emitted.emplace_back(instance);
+
+	// A particle starts fading a second before its life ends, short lived particles fade for the whole second.
+	auto expiry = m_time + std::max(particle.GetLifeLength(), FADE_TIME) + EXPIRY_SLACK;
+	m_expiries[std::ceil(expiry / EXPIRY_STEP) * EXPIRY_STEP]++;
+	m_aliveBound++;
+}
+
+void ParticlePool::Emit(const ParticleList &particles)
+{
+	m_emitted.reserve(m_emitted.size() + particles.GetSize());
+
+	// Particles of a batch mostly share a expiry step, so the step is only looked up when it changes.
+	auto expiries = m_expiries.end();
+
+	for (uint32_t i = 0; i < particles.GetSize(); i++)
+	{
+		Instance instance = {};
+		instance.m_position = Vector4f(particles.GetPosition(i), particles.GetRotation(i));
+		instance.m_velocity = Vector4f(particles.GetVelocity(i), particles.GetGravityEffect(i));
+		instance.m_life = Vector4f(particles.GetElapsedTime(i), particles.GetLifeLength(i), particles.GetStageCycles(i), particles.GetScale(i));
+		instance.m_state = Vector4f(particles.GetTransparency(i), 0.0f, 0.0f, 0.0f);
+		m_emitted.emplace_back(instance);
+
+		auto expiry = m_time + std::max(particles.GetLifeLength(i), FADE_TIME) + EXPIRY_SLACK;
+		auto step = std::ceil(expiry / EXPIRY_STEP) * EXPIRY_STEP;
+
+		if (expiries == m_expiries.end() || expiries->first != step)
+		{
+			expiries = m_expiries.try_emplace(step, 0).first;
+		}
+
+		expiries->second++;
+	}
+
+	m_aliveBound += particles.GetSize();
+}
+
+void ParticlePool::Update(const float &delta)
+{
+	m_time += delta;
+	m_delta += delta;
+
+	for (auto it = m_expiries.begin(); it != m_expiries.end() && it->first <= m_time;)
+	{
+		m_aliveBound -= it->second;
+		it = m_expiries.erase(it);
+	}
+}
+
+void ParticlePool::Clear()
+{
+	m_emitted.clear();
+	m_expiries.clear();
+	m_aliveBound = 0;
+	m_delta = 0.0f;
+	m_parity = 0;
+	m_reset = true;
+}
+
+void ParticlePool::CmdSimulate(const CommandBuffer &commandBuffer, const PipelineCompute &pipelinePrepare, const PipelineCompute &pipelineEmit,
+	const PipelineCompute &pipelineSimulate, const PipelineCompute &pipelineSort)
+{
+	auto camera = Scenes::Get()->GetCamera();
+
+	if (camera == nullptr)
+	{
+		return;
+	}
+
+	// Particles emitted past the pools capacity would be dropped by the emit pass anyway.
+	auto emitCount = std::min(static_cast<uint32_t>(m_emitted.size()), m_capacity);
+
+	if (m_emitBuffer->GetSize() < sizeof(Instance) * emitCount)
+	{
+		m_emitBuffer = std::make_unique<StorageBuffer>(sizeof(Instance) * std::max(2 * emitCount, MIN_EMIT_PARTICLES));
+	}
+
+	auto currentOffset = m_parity * m_capacity;
+	auto nextOffset = (1 - m_parity) * m_capacity;
+
+	m_uniformParticles.Push("cameraPosition", camera->GetPosition());
+	m_uniformParticles.Push("delta", m_delta);
+	m_uniformParticles.Push("capacity", m_capacity);
+	m_uniformParticles.Push("emitCount", emitCount);
+	m_uniformParticles.Push("currentOffset", currentOffset);
+	m_uniformParticles.Push("nextOffset", nextOffset);
+	m_uniformParticles.Push("indexCount", m_model->GetIndexCount());
+	m_uniformParticles.Push("firstIndex", m_model->GetFirstIndex());
+	m_uniformParticles.Push("vertexOffset", m_model->GetVertexOffset());
+	m_uniformParticles.Push("reset", static_cast<uint32_t>(m_reset));
+
+	m_descriptorPrepare.Push("UniformParticles", m_uniformParticles);
+	m_descriptorPrepare.Push("BufferDead", m_deadBuffer);
+	m_descriptorPrepare.Push("BufferCounters", m_counterBuffer);
+
+	m_descriptorEmit.Push("UniformParticles", m_uniformParticles);
+	m_descriptorEmit.Push("BufferParticles", m_particleBuffer);
+	m_descriptorEmit.Push("BufferAlive", m_aliveBuffer);
+	m_descriptorEmit.Push("BufferDead", m_deadBuffer);
+	m_descriptorEmit.Push("BufferCounters", m_counterBuffer);
+	m_descriptorEmit.Push("BufferEmitted", m_emitBuffer);
+
+	m_descriptorSimulate.Push("UniformParticles", m_uniformParticles);
+	m_descriptorSimulate.Push("BufferParticles", m_particleBuffer);
+	m_descriptorSimulate.Push("BufferAlive", m_aliveBuffer);
+	m_descriptorSimulate.Push("BufferDead", m_deadBuffer);
+	m_descriptorSimulate.Push("BufferCounters", m_counterBuffer);
+
+	m_descriptorSort.Push("UniformParticles", m_uniformParticles);
+	m_descriptorSort.Push("PushSort", m_pushSort);
+	m_descriptorSort.Push("BufferParticles", m_particleBuffer);
+	m_descriptorSort.Push("BufferAlive", m_aliveBuffer);
+	m_descriptorSort.Push("BufferCounters", m_counterBuffer);
+
+	// Every pass must be ready, otherwise the frame is skipped and its delta and particles carry over to the next.
+	auto updated = m_descriptorPrepare.Update(pipelinePrepare);
+	updated &= m_descriptorEmit.Update(pipelineEmit);
+	updated &= m_descriptorSimulate.Update(pipelineSimulate);
+	updated &= m_descriptorSort.Update(pipelineSort);
+
+	if (!updated)
+	{
+		return;
+	}
+
+	if (emitCount != 0)
+	{
+		Instance *emitted;
+		m_emitBuffer->MapMemory(reinterpret_cast<void **>(&emitted));
+		std::memcpy(emitted, m_emitted.data(), sizeof(Instance) * emitCount);
+		m_emitBuffer->UnmapMemory();
+	}
+
+	// The last frames draw reads the lists this frame writes.
+	CmdBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0);
+
+	pipelinePrepare.BindPipeline(commandBuffer);
+	m_descriptorPrepare.BindDescriptor(commandBuffer, pipelinePrepare);
+	pipelinePrepare.CmdRender(commandBuffer, { m_reset ? m_capacity : 1, 1 });
+	CmdBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+	if (emitCount != 0)
+	{
+		pipelineEmit.BindPipeline(commandBuffer);
+		m_descriptorEmit.BindDescriptor(commandBuffer, pipelineEmit);
+		pipelineEmit.CmdRender(commandBuffer, { emitCount, 1 });
+		CmdBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+	}
+
+	// The living count is only known on the GPU, so the simulation is sized to the CPUs upper bound.
+	pipelineSimulate.BindPipeline(commandBuffer);
+	m_descriptorSimulate.BindDescriptor(commandBuffer, pipelineSimulate);
+	pipelineSimulate.CmdRender(commandBuffer, { std::max(std::min(m_aliveBound, m_capacity), 1u), 1 });
+	CmdBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+	CmdSort(commandBuffer, pipelineSort);
+
+	// The draw command and sorted list are read by the indirect draw in the renderpass.
+	CmdBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+		VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+
+	m_emitted.clear();
+	m_delta = 0.0f;
+	m_parity = 1 - m_parity;
+	m_reset = false;
+}
+
+bool ParticlePool::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const ParticleType &particleType)
+{
+	// The counters are written by the first simulation.
+	if (m_reset)
+	{
+		return false;
+	}
+
+	// After simulating the lists swap, so the sorted list is the current one.
+	m_uniformType.Push("colourOffset", particleType.GetColourOffset());
+	m_uniformType.Push("numberOfRows", static_cast<float>(particleType.GetNumberOfRows()));
+	m_uniformType.Push("aliveOffset", m_parity * m_capacity);
+
+	m_descriptorRender.Push("UniformScene", uniformScene);
+	m_descriptorRender.Push("UniformType", m_uniformType);
+	m_descriptorRender.Push("BufferParticles", m_particleBuffer);
+	m_descriptorRender.Push("BufferAlive", m_aliveBuffer);
+	m_descriptorRender.Push("samplerColour", particleType.GetImage());
+
+	if (!m_descriptorRender.Update(pipeline))
+	{
+		return false;
+	}
+
+	m_descriptorRender.BindDescriptor(commandBuffer, pipeline);
+	return m_model->CmdRenderIndirect(commandBuffer, m_counterBuffer, 0);
+}
+
+void ParticlePool::CmdSort(const CommandBuffer &commandBuffer, const PipelineCompute &pipelineSort)
+{
+	auto count = Maths::NextPowerOfTwo(std::min(m_aliveBound, m_capacity));
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	pipelineSort.BindPipeline(commandBuffer);
+	m_descriptorSort.BindDescriptor(commandBuffer, pipelineSort);
+	m_pushSort.Push("count", count);
+
+	for (uint32_t blockSize = 2; blockSize <= count; blockSize *= 2)
+	{
+		for (auto compareDistance = blockSize / 2; compareDistance > 0; compareDistance /= 2)
+		{
+			m_pushSort.Push("blockSize", blockSize);
+			m_pushSort.Push("compareDistance", compareDistance);
+			m_pushSort.BindPush(commandBuffer, pipelineSort);
+			pipelineSort.CmdRender(commandBuffer, { count, 1 });
+			CmdBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+				VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+		}
+	}
+}
+
+void ParticlePool::CmdBarrier(const CommandBuffer &commandBuffer, const VkPipelineStageFlags &srcStage, const VkPipelineStageFlags &dstStage,
+	const VkAccessFlags &srcAccess, const VkAccessFlags &dstAccess)
+{
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = srcAccess;
+	memoryBarrier.dstAccessMask = dstAccess;
+	vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <map>
+#include "Engine/MemoryTracker.hpp"
+#include "Maths/Vector4.hpp"
+#include "Models/Model.hpp"
+#include "Graphics/Buffers/IndirectBuffer.hpp"
+#include "Graphics/Buffers/PushHandler.hpp"
+#include "Graphics/Buffers/StorageBuffer.hpp"
+#include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
+#include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+class Particle;
+class ParticleList;
+class ParticleType;
+
+/**
+ * @brief The particles of a type kept on the GPU, they are emitted, simulated, compacted, and depth sorted by compute shaders and drawn indirectly.
+ * Particles are spawned from the CPU, after that the CPU only keeps a upper bound of how many may still be alive to size the dispatches.
+ */
+class ACID_EXPORT ParticlePool :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief A particle laid out to match the std430 Particle struct in the particle pool shaders.
+	 */
+	class Instance
+	{
+	public:
+		Vector4f m_position;
+		Vector4f m_velocity;
+		Vector4f m_life;
+		Vector4f m_state;
+	};
+
+	/**
+	 * Creates a new particle pool.
+	 * @param capacity The number of particles the pool can hold, this is rounded up to a power of two.
+	 */
+	explicit ParticlePool(const uint32_t &capacity);
+
+	/**
+	 * Queues a particle to be emitted into the pool, if the pool is full when it is emitted it is dropped.
+	 * @param particle The particle to emit.
+	 */
+	void Emit(const Particle &particle);
+
+	/**
+	 * Queues every particle of a list to be emitted into the pool, particles that do not fit when they are emitted are dropped.
+	 * @param particles The particles to emit.
+	 */
+	void Emit(const ParticleList &particles);
+
+	/**
+	 * Advances the pools clock by the frames delta, this is not called while the scene is paused.
+	 * @param delta The frame delta in seconds.
+	 */
+	void Update(const float &delta);
+
+	/**
+	 * Frees every particle in the pool and any that are queued.
+	 */
+	void Clear();
+
+	/**
+	 * Records the emit, simulation, and sort passes, this must be called outside of a renderpass.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param pipelinePrepare The pipeline that moves the counts between frames.
+	 * @param pipelineEmit The pipeline that emits queued particles.
+	 * @param pipelineSimulate The pipeline that simulates and compacts the particles.
+	 * @param pipelineSort The pipeline of a bitonic sort pass.
+	 */
+	void CmdSimulate(const CommandBuffer &commandBuffer, const PipelineCompute &pipelinePrepare, const PipelineCompute &pipelineEmit,
+		const PipelineCompute &pipelineSimulate, const PipelineCompute &pipelineSort);
+
+	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const ParticleType &particleType);
+
+	/**
+	 * Gets if the pool may still have living or queued particles.
+	 * @return If the pool is active.
+	 */
+	bool IsActive() const { return m_aliveBound > 0 || !m_emitted.empty(); }
+
+	const uint32_t &GetCapacity() const { return m_capacity; }
+
+	/**
+	 * Gets the upper bound of living particles, this is exact for particles that are not dropped when the pool is full.
+	 * @return The upper bound of living particles.
+	 */
+	const uint32_t &GetAliveBound() const { return m_aliveBound; }
+
+private:
+	/**
+	 * Records a sort pass when more than one particle may be alive, each element is compared with the one a distance away.
+	 */
+	void CmdSort(const CommandBuffer &commandBuffer, const PipelineCompute &pipelineSort);
+
+	static void CmdBarrier(const CommandBuffer &commandBuffer, const VkPipelineStageFlags &srcStage, const VkPipelineStageFlags &dstStage,
+		const VkAccessFlags &srcAccess, const VkAccessFlags &dstAccess);
+
+	uint32_t m_capacity;
+	std::shared_ptr<Model> m_model;
+
+	TrackedVector<Instance, MemoryTag::Particles> m_emitted;
+	// The times emitted particles will have died by, and how many die at each.
+	TrackedMap<float, uint32_t, MemoryTag::Particles> m_expiries;
+	uint32_t m_aliveBound;
+	float m_time;
+	float m_delta;
+	uint32_t m_parity;
+	bool m_reset;
+
+	StorageBuffer m_particleBuffer;
+	StorageBuffer m_aliveBuffer;
+	StorageBuffer m_deadBuffer;
+	IndirectBuffer m_counterBuffer;
+	std::unique_ptr<StorageBuffer> m_emitBuffer;
+
+	UniformHandler m_uniformParticles;
+	UniformHandler m_uniformType;
+	PushHandler m_pushSort;
+	DescriptorsHandler m_descriptorPrepare;
+	DescriptorsHandler m_descriptorEmit;
+	DescriptorsHandler m_descriptorSimulate;
+	DescriptorsHandler m_descriptorSort;
+	DescriptorsHandler m_descriptorRender;
+};
+}
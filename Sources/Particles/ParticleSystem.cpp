@@ -1,5 +1,6 @@
 ﻿#include "ParticleSystem.hpp"
 
+#include "Engine/FrameAllocator.hpp"
 #include "Maths/Maths.hpp"
 #include "Scenes/Entity.hpp"
 #include "Particles.hpp"
@@ -44,10 +45,7 @@ void ParticleSystem::Update()
 			return;
 		}
 
-		for (uint32_t i = 0; i < pastFactor; i++)
-		{
-			Particles::Get()->AddParticle(EmitParticle(*emitters[static_cast<uint32_t>(Maths::Random(0.0f, static_cast<float>(emitters.size())))]));
-		}
+		EmitParticles(emitters, static_cast<uint32_t>(pastFactor));
 	}
 }
 
@@ -115,55 +113,111 @@ void ParticleSystem::SetDirection(const Vector3f &direction, const float &deviat
 	m_directionDeviation = deviation * Maths::Pi;
 }
 
-Particle ParticleSystem::EmitParticle(const Emitter &emitter)
+void ParticleSystem::EmitParticles(const std::vector<Emitter *> &emitters, const uint32_t &count)
 {
-	Vector3f spawnPos = emitter.GeneratePosition() + GetParent()->GetWorldTransform().GetPosition();
+	if (count == 0)
+	{
+		return;
+	}
+
+	auto frameAllocator = FrameAllocator::Get();
+
+	// Each particle draws the values for its emitter, type, direction, speed, scale, life, stages, and rotation.
+	enum Value { EmitterPick, TypePick, Theta, Z, Speed, Scale, Life, Stage, Rotation, ValueCount };
+	std::pmr::vector<float> random(ValueCount * count, frameAllocator);
+	Maths::Random(random.data(), random.size());
+	auto values = [&](const Value &value)
+	{
+		return random.data() + value * count;
+	};
 
-	Vector3f velocity;
+	std::pmr::vector<uint32_t> emitterCounts(emitters.size(), 0, frameAllocator);
 
-	if (m_direction != Vector3f::Zero)
+	for (uint32_t i = 0; i < count; i++)
 	{
-		velocity = RandomUnitVectorWithinCone(m_direction, m_directionDeviation);
+		emitterCounts[std::min(static_cast<std::size_t>(values(EmitterPick)[i] * emitters.size()), emitters.size() - 1)]++;
 	}
-	else
+
+	std::pmr::vector<Vector3f> positions(count, frameAllocator);
+	uint32_t offset = 0;
+
+	for (std::size_t i = 0; i < emitters.size(); i++)
 	{
-		velocity = GenerateRandomUnitVector();
+		emitters[i]->GeneratePositions(positions.data() + offset, emitterCounts[i]);
+		offset += emitterCounts[i];
 	}
 
-	velocity = velocity.Normalize();
-	velocity *= GenerateValue(m_averageSpeed, m_speedDeviation);
+	// The rotation from the front to the cone direction is the same for every particle.
+	auto cosAngle = std::cos(m_directionDeviation);
+	auto rotated = m_direction.m_x != 0.0f || m_direction.m_y != 0.0f || (m_direction.m_z != 1.0f && m_direction.m_z != -1.0f);
+	Matrix4 rotationMatrix;
 
-	auto emitType = m_types.at(static_cast<uint32_t>(std::floor(Maths::Random(0.0f, static_cast<float>(m_types.size())))));
-	auto scale = GenerateValue(emitType->GetScale(), m_scaleDeviation);
-	auto lifeLength = GenerateValue(emitType->GetLifeLength(), m_lifeDeviation);
-	auto stageCycles = GenerateValue(emitType->GetStageCycles(), m_stageDeviation);
-	return Particle(emitType, spawnPos, velocity, lifeLength, stageCycles, GenerateRotation(), scale, m_gravityEffect);
-}
+	if (rotated)
+	{
+		auto rotateAxis = m_direction.Cross(Vector3f::Front);
+		rotateAxis.Normalize();
+		rotationMatrix = rotationMatrix.Rotate(-std::acos(m_direction.Dot(Vector3f::Front)), rotateAxis);
+	}
 
-float ParticleSystem::GenerateValue(const float &average, const float &errorPercent)
-{
-	auto error = Maths::Random(-1.0f, 1.0f) * errorPercent;
-	return average + (average * error);
-}
+	if (m_batches.size() != m_types.size())
+	{
+		m_batches.resize(m_types.size());
+	}
 
-float ParticleSystem::GenerateRotation() const
-{
-	if (m_randomRotation)
+	auto origin = GetParent()->GetWorldTransform().GetPosition();
+
+	for (uint32_t i = 0; i < count; i++)
 	{
-		return Maths::Random(0.0f, 360.0f);
+		auto theta = values(Theta)[i] * 2.0f * Maths::Pi;
+		Vector3f velocity;
+
+		if (m_direction != Vector3f::Zero)
+		{
+			auto z = (cosAngle + values(Z)[i]) * (1.0f - cosAngle);
+			auto rootOneMinusZSquared = std::sqrt(1.0f - z * z);
+			auto direction = Vector4f(rootOneMinusZSquared * std::cos(theta), rootOneMinusZSquared * std::sin(theta), z, 1.0f);
+
+			if (rotated)
+			{
+				direction = rotationMatrix.Transform(direction);
+			}
+			else if (m_direction.m_z == -1.0f)
+			{
+				direction.m_z *= -1.0f;
+			}
+
+			velocity = Vector3f(direction);
+		}
+		else
+		{
+			auto z = values(Z)[i] * 2.0f - 1.0f;
+			auto rootOneMinusZSquared = std::sqrt(1.0f - z * z);
+			velocity = Vector3f(rootOneMinusZSquared * std::cos(theta), rootOneMinusZSquared * std::sin(theta), z);
+		}
+
+		velocity = velocity.Normalize();
+		velocity *= GenerateValue(m_averageSpeed, m_speedDeviation, values(Speed)[i]);
+
+		auto typeIndex = std::min(static_cast<std::size_t>(values(TypePick)[i] * m_types.size()), m_types.size() - 1);
+		const auto &emitType = m_types[typeIndex];
+		auto scale = GenerateValue(emitType->GetScale(), m_scaleDeviation, values(Scale)[i]);
+		auto lifeLength = GenerateValue(emitType->GetLifeLength(), m_lifeDeviation, values(Life)[i]);
+		auto stageCycles = GenerateValue(emitType->GetStageCycles(), m_stageDeviation, values(Stage)[i]);
+		auto rotation = m_randomRotation ? values(Rotation)[i] * 360.0f : 0.0f;
+		m_batches[typeIndex].Add(positions[i] + origin, velocity, lifeLength, stageCycles, rotation, scale, m_gravityEffect);
 	}
 
-	return 0.0f;
+	for (std::size_t i = 0; i < m_types.size(); i++)
+	{
+		Particles::Get()->AddParticles(m_types[i], m_batches[i]);
+		m_batches[i].Clear();
+	}
 }
 
-Vector3f ParticleSystem::GenerateRandomUnitVector() const
+float ParticleSystem::GenerateValue(const float &average, const float &errorPercent, const float &random)
 {
-	float theta = Maths::Random(0.0f, 1.0f) * 2.0f * Maths::Pi;
-	float z = Maths::Random(0.0f, 1.0f) * 2.0f - 1.0f;
-	float rootOneMinusZSquared = std::sqrt(1.0f - z * z);
-	float x = rootOneMinusZSquared * std::cos(theta);
-	float y = rootOneMinusZSquared * std::sin(theta);
-	return Vector3f(x, y, z);
+	auto error = (random * 2.0f - 1.0f) * errorPercent;
+	return average + (average * error);
 }
 
 const Metadata &operator>>(const Metadata &metadata, ParticleSystem &particleSystem)
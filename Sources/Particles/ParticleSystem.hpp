@@ -5,6 +5,7 @@
 #include "Scenes/Component.hpp"
 #include "Emitters/Emitter.hpp"
 #include "Particle.hpp"
+#include "ParticleList.hpp"
 #include "ParticleType.hpp"
 
 namespace acid
@@ -76,15 +77,26 @@ public:
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ParticleSystem &particleSystem);
 
 private:
-	Particle EmitParticle(const Emitter &emitter);
-
-	static float GenerateValue(const float &average, const float &errorPercent);
-
-	float GenerateRotation() const;
+	/**
+	 * Emits particles from the emitters of the entity, the random values of every particle are drawn at once and each emitter generates its positions in one call.
+	 * The particles are gathered by type and added to {@link Particles} with one call per type.
+	 * @param emitters The emitters of the entity, each particle picks one at random.
+	 * @param count The number of particles.
+	 */
+	void EmitParticles(const std::vector<Emitter *> &emitters, const uint32_t &count);
 
-	Vector3f GenerateRandomUnitVector() const;
+	/**
+	 * Gets a value that deviates from a average.
+	 * @param average The average value.
+	 * @param errorPercent The largest deviation, as a factor of the average.
+	 * @param random A random value from zero to one.
+	 * @return The deviated value.
+	 */
+	static float GenerateValue(const float &average, const float &errorPercent, const float &random);
 
 	std::vector<std::shared_ptr<ParticleType>> m_types;
+	// The particles of each type emitted this update, kept so their arrays are reused.
+	std::vector<ParticleList> m_batches;
 
 	float m_pps;
 	float m_averageSpeed;
@@ -4,41 +4,37 @@
 #include "Maths/Maths.hpp"
 #include "Models/Shapes/ModelRectangle.hpp"
 #include "Scenes/Scenes.hpp"
-#include "Particle.hpp"
+#include "ParticleList.hpp"
 
 namespace acid
 {
-static const uint32_t MAX_INSTANCES = 1024;
-//static const uint32_t INSTANCE_STEPS = 128;
+static const uint32_t INSTANCE_STEPS = 128;
+// The buffer shrinks once it has been at most a quarter full for this long.
+static const Time INSTANCE_SHRINK_DELAY = Time::Seconds(5.0f);
 static const float FRUSTUM_BUFFER = 1.4f;
 
 std::shared_ptr<ParticleType> ParticleType::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<ParticleType>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<ParticleType>(resource);
-	}
-
-	auto result = std::make_shared<ParticleType>(nullptr);
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<ParticleType>(nullptr);
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<ParticleType> ParticleType::Create(const std::shared_ptr<Image2d> &image, const uint32_t &numberOfRows, const Colour &colourOffset, const float &lifeLength,
-	const float &stageCycles, const float &scale)
+	const float &stageCycles, const float &scale, const uint32_t &gpuCapacity)
 {
-	auto temp = ParticleType(image, numberOfRows, colourOffset, lifeLength, stageCycles, scale);
+	auto temp = ParticleType(image, numberOfRows, colourOffset, lifeLength, stageCycles, scale, gpuCapacity);
 	Metadata metadata = Metadata();
 	metadata << temp;
 	return Create(metadata);
 }
 
 ParticleType::ParticleType(std::shared_ptr<Image2d> image, const uint32_t &numberOfRows, const Colour &colourOffset, const float &lifeLength, const float &stageCycles,
-	const float &scale) :
+	const float &scale, const uint32_t &gpuCapacity) :
 	m_image(std::move(image)),
 	m_model(ModelRectangle::Create(-0.5f, 0.5f)),
 	m_numberOfRows(numberOfRows),
@@ -46,43 +42,66 @@ ParticleType::ParticleType(std::shared_ptr<Image2d> image, const uint32_t &numbe
 	m_lifeLength(lifeLength),
 	m_stageCycles(stageCycles),
 	m_scale(scale),
+	m_gpuCapacity(gpuCapacity),
 	m_maxInstances(0),
 	m_instances(0),
-	m_instanceBuffer(sizeof(Instance) * MAX_INSTANCES)
+	m_shrinkElapsed(Time::Zero),
+	m_shrinkPeak(0)
+{
+}
+
+void ParticleType::Load()
 {
+	// The pool is created once the capacity is decoded, so temporary types used as metadata do not allocate one.
+	if (m_gpuCapacity != 0)
+	{
+		m_pool = std::make_unique<ParticlePool>(m_gpuCapacity);
+	}
 }
 
-void ParticleType::Update(const std::vector<Particle> &particles)
+void ParticleType::Update(const ParticleList &particles)
 {
-	// Calculates a max instance count over the time of the type. TODO: Allow decreasing max using a timer and average count over the delay.
-	//uint32_t instances = INSTANCE_STEPS * static_cast<uint32_t>(std::ceil(static_cast<float>(particles.size()) / static_cast<float>(INSTANCE_STEPS)));
-	//m_maxInstances = std::max(m_maxInstances, instances);
-	m_maxInstances = MAX_INSTANCES;
 	m_instances = 0;
+	ResizeInstances(particles.GetSize());
 
-	if (particles.empty())
+	if (particles.IsEmpty())
 	{
 		return;
 	}
 
+	auto camera = Scenes::Get()->GetCamera();
+	auto viewMatrix = camera->GetViewMatrix();
+	auto stageCount = static_cast<int32_t>(m_numberOfRows * m_numberOfRows);
+
+	// Particles are culled together, then drawn far to near.
+	particles.QueryFrustum(camera->GetViewFrustum(), FRUSTUM_BUFFER, m_visible);
+	m_visibleFlags.assign(particles.GetSize(), 0);
+
+	for (const auto &index : m_visible)
+	{
+		m_visibleFlags[index] = 1;
+	}
+
 	Instance *instances;
-	m_instanceBuffer.MapMemory(reinterpret_cast<void **>(&instances));
+	m_instanceBuffer->MapMemory(reinterpret_cast<void **>(&instances));
 
-	for (const auto &particle : particles)
+	for (const auto &index : particles.GetOrder())
 	{
 		if (m_instances >= m_maxInstances)
 		{
 			break;
 		}
 
-		if (!Scenes::Get()->GetCamera()->GetViewFrustum().SphereInFrustum(particle.GetPosition(), FRUSTUM_BUFFER * particle.GetScale()))
+		if (m_visibleFlags[index] == 0)
 		{
 			continue;
 		}
 
-		auto viewMatrix = Scenes::Get()->GetCamera()->GetViewMatrix();
+		auto position = particles.GetPosition(index);
+		auto scale = particles.GetScale(index);
+
 		auto instance = &instances[m_instances];
-		instance->m_modelMatrix = Matrix4::Identity.Translate(particle.GetPosition());
+		instance->m_modelMatrix = Matrix4::Identity.Translate(position);
 
 		for (int32_t row = 0; row < 3; row++)
 		{
@@ -92,17 +111,29 @@ void ParticleType::Update(const std::vector<Particle> &particles)
 			}
 		}
 
-		instance->m_modelMatrix = instance->m_modelMatrix.Rotate(particle.GetRotation() * Maths::DegToRad, Vector3f::Front);
-		instance->m_modelMatrix = instance->m_modelMatrix.Scale(particle.GetScale() * Vector3f::One);
-		// TODO: Multiply MVP by View and Projection (And run update every frame?)
+		instance->m_modelMatrix = instance->m_modelMatrix.Rotate(particles.GetRotation(index) * Maths::DegToRad, Vector3f::Front);
+		instance->m_modelMatrix = instance->m_modelMatrix.Scale(scale * Vector3f::One);
+
+		// Blends between the two atlas stages of the particles lifetime.
+		auto imageBlendFactor = 0.0f;
+		instance->m_offsets = Vector4f(0.0f);
 
-		instance->m_colourOffset = particle.GetParticleType()->m_colourOffset;
-		instance->m_offsets = Vector4f(particle.m_imageOffset1, particle.m_imageOffset2);
-		instance->m_blend = Vector3f(particle.m_imageBlendFactor, particle.m_transparency, static_cast<float>(particle.m_particleType->m_numberOfRows));
+		if (m_image != nullptr)
+		{
+			auto lifeFactor = particles.GetStageCycles(index) * particles.GetElapsedTime(index) / particles.GetLifeLength(index);
+			auto atlasProgression = lifeFactor * static_cast<float>(stageCount);
+			auto index1 = static_cast<int32_t>(std::floor(atlasProgression));
+			auto index2 = index1 < stageCount - 1 ? index1 + 1 : index1;
+			imageBlendFactor = std::fmod(atlasProgression, 1.0f);
+			instance->m_offsets = Vector4f(CalculateImageOffset(index1), CalculateImageOffset(index2));
+		}
+
+		instance->m_colourOffset = m_colourOffset;
+		instance->m_blend = Vector3f(imageBlendFactor, particles.GetTransparency(index), static_cast<float>(m_numberOfRows));
 		m_instances++;
 	}
 
-	m_instanceBuffer.UnmapMemory();
+	m_instanceBuffer->UnmapMemory();
 }
 
 bool ParticleType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
@@ -125,14 +156,59 @@ bool ParticleType::CmdRender(const CommandBuffer &commandBuffer, const PipelineG
 	// Draws the instanced objects.
 	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
 
-	VkBuffer vertexBuffers[] = { m_model->GetVertexBuffer()->GetBuffer(), m_instanceBuffer.GetBuffer() };
+	VkBuffer vertexBuffers[] = { m_model->GetVertexBuffer()->GetBuffer(), m_instanceBuffer->GetBuffer() };
 	VkDeviceSize offsets[] = { 0, 0 };
 	vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
 	vkCmdBindIndexBuffer(commandBuffer, m_model->GetIndexBuffer()->GetBuffer(), 0, m_model->GetIndexType());
-	vkCmdDrawIndexed(commandBuffer, m_model->GetIndexCount(), m_instances, 0, 0, 0);
+	vkCmdDrawIndexed(commandBuffer, m_model->GetIndexCount(), m_instances, m_model->GetFirstIndex(), m_model->GetVertexOffset(), 0);
 	return true;
 }
 
+void ParticleType::ResizeInstances(const uint32_t &count)
+{
+	// Sizes are kept in steps so small changes in the particle count do not reallocate.
+	auto required = INSTANCE_STEPS * std::max(static_cast<uint32_t>(std::ceil(static_cast<float>(count) / static_cast<float>(INSTANCE_STEPS))), 1u);
+	auto maxInstances = m_maxInstances;
+
+	if (required > m_maxInstances)
+	{
+		maxInstances = std::max(required, m_maxInstances + m_maxInstances / 2);
+		m_shrinkElapsed = Time::Zero;
+		m_shrinkPeak = 0;
+	}
+	else if (4 * required <= m_maxInstances)
+	{
+		// Shrinks to twice the largest count seen while mostly empty, so the buffer is left half full at most.
+		m_shrinkElapsed += Engine::Get()->GetDelta();
+		m_shrinkPeak = std::max(m_shrinkPeak, required);
+
+		if (m_shrinkElapsed >= INSTANCE_SHRINK_DELAY)
+		{
+			maxInstances = 2 * m_shrinkPeak;
+			m_shrinkElapsed = Time::Zero;
+			m_shrinkPeak = 0;
+		}
+	}
+	else
+	{
+		m_shrinkElapsed = Time::Zero;
+		m_shrinkPeak = 0;
+	}
+
+	if (m_instanceBuffer == nullptr || maxInstances != m_maxInstances)
+	{
+		m_maxInstances = maxInstances;
+		m_instanceBuffer = std::make_unique<InstanceBuffer>(sizeof(Instance) * m_maxInstances);
+	}
+}
+
+Vector2f ParticleType::CalculateImageOffset(const int32_t &index) const
+{
+	auto column = index % static_cast<int32_t>(m_numberOfRows);
+	auto row = index / static_cast<int32_t>(m_numberOfRows);
+	return Vector2f(static_cast<float>(column), static_cast<float>(row)) / static_cast<float>(m_numberOfRows);
+}
+
 const Metadata &operator>>(const Metadata &metadata, ParticleType &particleType)
 {
 	metadata.GetResource("Image", particleType.m_image);
@@ -141,6 +217,7 @@ const Metadata &operator>>(const Metadata &metadata, ParticleType &particleType)
 	metadata.GetChild("Life Length", particleType.m_lifeLength);
 	metadata.GetChild("Stage Cycles", particleType.m_stageCycles);
 	metadata.GetChild("Scale", particleType.m_scale);
+	metadata.GetChild("Gpu Capacity", particleType.m_gpuCapacity);
 	return metadata;
 }
 
@@ -152,6 +229,7 @@ Metadata &operator<<(Metadata &metadata, const ParticleType &particleType)
 	metadata.SetChild("Life Length", particleType.m_lifeLength);
 	metadata.SetChild("Stage Cycles", particleType.m_stageCycles);
 	metadata.SetChild("Scale", particleType.m_scale);
+	metadata.SetChild("Gpu Capacity", particleType.m_gpuCapacity);
 	return metadata;
 }
 }
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Maths/Colour.hpp"
+#include "Maths/Time.hpp"
 #include "Maths/Matrix4.hpp"
 #include "Maths/Vector4.hpp"
 #include "Maths/Vector3.hpp"
@@ -10,10 +11,11 @@
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 #include "Graphics/Images/Image2d.hpp"
 #include "Resources/Resource.hpp"
+#include "ParticlePool.hpp"
 
 namespace acid
 {
-class Particle;
+class ParticleList;
 
 /**
  * @brief Resource that represents a particle type.
@@ -63,10 +65,11 @@ public:
 	 * @param lifeLength The averaged life length for the particle.
 	 * @param stageCycles The amount of times stages will be shown.
 	 * @param scale The averaged scale for the particle.
+	 * @param gpuCapacity The number of particles simulated on the GPU, or 0 to simulate particles on the CPU.
 	 * @return The particle type with the requested values.
 	 */
 	static std::shared_ptr<ParticleType> Create(const std::shared_ptr<Image2d> &image, const uint32_t &numberOfRows = 1, const Colour &colourOffset = Colour::Black,
-		const float &lifeLength = 10.0f, const float &stageCycles = 1.0f, const float &scale = 1.0f);
+		const float &lifeLength = 10.0f, const float &stageCycles = 1.0f, const float &scale = 1.0f, const uint32_t &gpuCapacity = 0);
 
 	/**
 	 * Creates a new particle type.
@@ -76,11 +79,14 @@ public:
 	 * @param lifeLength The averaged life length for the particle.
 	 * @param stageCycles The amount of times stages will be shown.
 	 * @param scale The averaged scale for the particle.
+	 * @param gpuCapacity The number of particles simulated on the GPU, or 0 to simulate particles on the CPU.
 	 */
 	explicit ParticleType(std::shared_ptr<Image2d> image, const uint32_t &numberOfRows = 1, const Colour &colourOffset = Colour::Black, const float &lifeLength = 10.0f,
-		const float &stageCycles = 1.0f, const float &scale = 1.0f);
+		const float &stageCycles = 1.0f, const float &scale = 1.0f, const uint32_t &gpuCapacity = 0);
 
-	void Update(const std::vector<Particle> &particles);
+	void Load() override;
+
+	void Update(const ParticleList &particles);
 
 	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
 
@@ -108,11 +114,27 @@ public:
 
 	void SetScale(const float &scale) { m_scale = scale; }
 
+	const uint32_t &GetGpuCapacity() const { return m_gpuCapacity; }
+
+	/**
+	 * Gets the GPU pool particles of this type are emitted into.
+	 * @return The particle pool, or nullptr if particles are simulated on the CPU.
+	 */
+	ParticlePool *GetPool() const { return m_pool.get(); }
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, ParticleType &particleType);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ParticleType &particleType);
 
 private:
+	/**
+	 * Grows the instance buffer to fit a particle count, and shrinks it after it has been mostly empty for a while.
+	 * @param count The number of particles.
+	 */
+	void ResizeInstances(const uint32_t &count);
+
+	Vector2f CalculateImageOffset(const int32_t &index) const;
+
 	std::shared_ptr<Image2d> m_image;
 	std::shared_ptr<Model> m_model;
 	uint32_t m_numberOfRows;
@@ -120,11 +142,18 @@ private:
 	float m_lifeLength;
 	float m_stageCycles;
 	float m_scale;
+	uint32_t m_gpuCapacity;
 
 	uint32_t m_maxInstances;
 	uint32_t m_instances;
+	// The particles in view this update, as indices and as a flag for each particle.
+	std::vector<uint32_t> m_visible;
+	std::vector<uint8_t> m_visibleFlags;
+	Time m_shrinkElapsed;
+	uint32_t m_shrinkPeak;
 
 	DescriptorsHandler m_descriptorSet;
-	InstanceBuffer m_instanceBuffer;
+	std::unique_ptr<InstanceBuffer> m_instanceBuffer;
+	std::unique_ptr<ParticlePool> m_pool;
 };
 }
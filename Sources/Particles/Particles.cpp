@@ -6,6 +6,7 @@ namespace acid
 {
 Particles::Particles()
 {
+	Reads<Scenes>();
 }
 
 void Particles::Update()
@@ -15,44 +16,69 @@ void Particles::Update()
 		return;
 	}
 
+	auto delta = Engine::Get()->GetDelta().AsSeconds();
+	auto camera = Scenes::Get()->GetCamera();
+	auto cameraPosition = camera != nullptr ? camera->GetPosition() : Vector3f();
+
 	for (auto it = m_particles.begin(); it != m_particles.end();)
 	{
-		for (auto it1 = (*it).second.begin(); it1 != (*it).second.end();)
+		// Pooled particles are simulated on the GPU, the type is kept until they may all have died.
+		if (auto pool = it->first->GetPool(); pool != nullptr)
 		{
-			(*it1).Update();
+			pool->Update(delta);
 
-			if (!(*it1).IsAlive())
+			if (!pool->IsActive())
 			{
-				it1 = (*it).second.erase(it1);
+				it = m_particles.erase(it);
 				continue;
 			}
 
-			++it1;
+			++it;
+			continue;
 		}
 
-		if (it->second.empty())
+		it->second.Update(delta, cameraPosition);
+
+		if (it->second.IsEmpty())
 		{
 			it = m_particles.erase(it);
 			continue;
 		}
 
-		std::sort((*it).second.begin(), (*it).second.end());
-		(*it).first->Update((*it).second);
+		it->first->Update(it->second);
 		++it;
 	}
 }
 
 void Particles::AddParticle(const Particle &particle)
 {
-	auto it = m_particles.find(particle.GetParticleType());
+	auto &particles = m_particles[particle.GetParticleType()];
+
+	if (auto pool = particle.GetParticleType()->GetPool(); pool != nullptr)
+	{
+		pool->Emit(particle);
+		return;
+	}
+
+	particles.Add(particle);
+}
+
+void Particles::AddParticles(const std::shared_ptr<ParticleType> &type, const ParticleList &particles)
+{
+	if (particles.IsEmpty())
+	{
+		return;
+	}
+
+	auto &list = m_particles[type];
 
-	if (it == m_particles.end())
+	if (auto pool = type->GetPool(); pool != nullptr)
 	{
-		m_particles.emplace(particle.GetParticleType(), std::vector<Particle>());
-		it = m_particles.find(particle.GetParticleType());
+		pool->Emit(particles);
+		return;
 	}
 
-	(*it).second.emplace_back(particle);
+	list.Append(particles);
 }
 
 /*void Particles::RemoveParticle(const Particle &particle)
@@ -70,6 +96,14 @@ void Particles::AddParticle(const Particle &particle)
 
 void Particles::Clear()
 {
+	for (auto &[type, particles] : m_particles)
+	{
+		if (auto pool = type->GetPool(); pool != nullptr)
+		{
+			pool->Clear();
+		}
+	}
+
 	m_particles.clear();
 }
 }
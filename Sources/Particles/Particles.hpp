@@ -3,7 +3,9 @@
 #include <map>
 #include <vector>
 #include "Engine/Engine.hpp"
+#include "Engine/MemoryTracker.hpp"
 #include "Particle.hpp"
+#include "ParticleList.hpp"
 
 namespace acid
 {
@@ -26,6 +28,13 @@ public:
 
 	void AddParticle(const Particle &particle);
 
+	/**
+	 * Adds many particles of one type with a single lookup, types with a {@link ParticlePool} emit them into the pool.
+	 * @param type The type of every particle.
+	 * @param particles The particles to add.
+	 */
+	void AddParticles(const std::shared_ptr<ParticleType> &type, const ParticleList &particles);
+
 	//void RemoveParticle(const Particle &particle);
 
 	/**
@@ -34,12 +43,12 @@ public:
 	void Clear();
 
 	/**
-	 * Gets a list of all particles.
+	 * Gets a list of all particles, types with a {@link ParticlePool} are listed without particles as theirs are only kept on the GPU.
 	 * @return All particles.
 	 */
-	const std::map<std::shared_ptr<ParticleType>, std::vector<Particle>> &GetParticles() const { return m_particles; }
+	const TrackedMap<std::shared_ptr<ParticleType>, ParticleList, MemoryTag::Particles> &GetParticles() const { return m_particles; }
 
 private:
-	std::map<std::shared_ptr<ParticleType>, std::vector<Particle>> m_particles;
+	TrackedMap<std::shared_ptr<ParticleType>, ParticleList, MemoryTag::Particles> m_particles;
 };
 }
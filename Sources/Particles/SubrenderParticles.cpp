@@ -10,23 +10,53 @@ SubrenderParticles::SubrenderParticles(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
 	m_pipeline(pipelineStage, { "Shaders/Particles/Particle.vert", "Shaders/Particles/Particle.frag" },
 		{ VertexDefault::GetVertexInput(0), ParticleType::Instance::GetVertexInput(1) }, {}, PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::Read,
-		VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+		VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST),
+	m_pipelinePool(pipelineStage, { "Shaders/Particles/Pool.vert", "Shaders/Particles/Particle.frag" }, { VertexDefault::GetVertexInput(0) }, {},
+		PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::Read, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST),
+	m_pipelinePrepare("Shaders/Particles/Prepare.comp"),
+	m_pipelineEmit("Shaders/Particles/Emit.comp"),
+	m_pipelineSimulate("Shaders/Particles/Simulate.comp"),
+	m_pipelineSort("Shaders/Particles/Sort.comp")
 {
 }
 
+void SubrenderParticles::PreRender(const CommandBuffer &commandBuffer)
+{
+	for (const auto &[type, typeParticles] : Particles::Get()->GetParticles())
+	{
+		if (auto pool = type->GetPool(); pool != nullptr)
+		{
+			pool->CmdSimulate(commandBuffer, m_pipelinePrepare, m_pipelineEmit, m_pipelineSimulate, m_pipelineSort);
+		}
+	}
+}
+
 void SubrenderParticles::Render(const CommandBuffer &commandBuffer)
 {
 	auto camera = Scenes::Get()->GetCamera();
 	m_uniformScene.Push("projection", camera->GetProjectionMatrix());
 	m_uniformScene.Push("view", camera->GetViewMatrix());
 
+	auto &particles = Particles::Get()->GetParticles();
+
 	m_pipeline.BindPipeline(commandBuffer);
 
-	auto particles = Particles::Get()->GetParticles();
+	for (const auto &[type, typeParticles] : particles)
+	{
+		if (type->GetPool() == nullptr)
+		{
+			type->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
+		}
+	}
+
+	m_pipelinePool.BindPipeline(commandBuffer);
 
-	for (auto &[type, typeParticles] : particles)
+	for (const auto &[type, typeParticles] : particles)
 	{
-		type->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
+		if (auto pool = type->GetPool(); pool != nullptr)
+		{
+			pool->CmdRender(commandBuffer, m_pipelinePool, m_uniformScene, *type);
+		}
 	}
 }
 }
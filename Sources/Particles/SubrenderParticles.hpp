@@ -2,6 +2,7 @@
 
 #include "Graphics/Subrender.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 
 namespace acid
@@ -12,10 +13,17 @@ class ACID_EXPORT SubrenderParticles :
 public:
 	explicit SubrenderParticles(const Pipeline::Stage &pipelineStage);
 
+	void PreRender(const CommandBuffer &commandBuffer) override;
+
 	void Render(const CommandBuffer &commandBuffer) override;
 
 private:
 	PipelineGraphics m_pipeline;
+	PipelineGraphics m_pipelinePool;
+	PipelineCompute m_pipelinePrepare;
+	PipelineCompute m_pipelineEmit;
+	PipelineCompute m_pipelineSimulate;
+	PipelineCompute m_pipelineSort;
 	UniformHandler m_uniformScene;
 };
 }
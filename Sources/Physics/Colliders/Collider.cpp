@@ -4,6 +4,9 @@
 #include "Maths/Maths.hpp"
 #include "Scenes/Entity.hpp"
 #include "Physics/CollisionObject.hpp"
+#if !defined(ACID_BUILD_SERVER)
+#include "Gizmos/Gizmos.hpp"
+#endif
 
 namespace acid
 {
@@ -11,25 +14,48 @@ Collider::Collider(const Transform &localTransform, const std::shared_ptr<GizmoT
 	m_localTransform(localTransform),
 	m_gizmo(nullptr)
 {
-#if defined(ACID_VERBOSE)
-	if (gizmoType != nullptr)
+#if defined(ACID_VERBOSE) && !defined(ACID_BUILD_SERVER)
+	// Engines without the gizmos module, such as server profiles, draw no colliders.
+	if (auto gizmos = Gizmos::Get(); gizmos != nullptr && gizmoType != nullptr)
 	{
-		m_gizmo = Gizmos::Get()->AddGizmo(new Gizmo(gizmoType, localTransform));
+		m_gizmo = gizmos->AddGizmo(gizmoType, localTransform);
 	}
 #endif
 }
 
 Collider::~Collider()
 {
-	Gizmos::Get()->RemoveGizmo(m_gizmo);
+#if !defined(ACID_BUILD_SERVER)
+	if (auto gizmos = Gizmos::Get(); gizmos != nullptr && m_gizmo != nullptr)
+	{
+		gizmos->RemoveGizmo(m_gizmo);
+	}
+#endif
 }
 
 void Collider::Update()
 {
+#if !defined(ACID_BUILD_SERVER)
 	if (m_gizmo != nullptr)
 	{
 		m_gizmo->SetTransform(GetParent()->GetWorldTransform() * m_localTransform);
 	}
+#endif
+}
+
+std::shared_ptr<GizmoType> Collider::CreateGizmoType(const std::string &filename, const Colour &colour)
+{
+#if defined(ACID_BUILD_SERVER)
+	return nullptr;
+#else
+	// Gizmos are only drawn by verbose builds, and models can not be loaded without the scenes module.
+	if (Gizmos::Get() == nullptr)
+	{
+		return nullptr;
+	}
+
+	return GizmoType::Create(Model::Create(filename), 3.0f, colour);
+#endif
 }
 
 void Collider::SetLocalTransform(const Transform &localTransform)
@@ -44,6 +70,21 @@ void Collider::SetLocalTransform(const Transform &localTransform)
 	}
 }
 
+void Collider::UpdateShape()
+{
+	if (GetParent() == nullptr)
+	{
+		return;
+	}
+
+	auto collisionObject = GetParent()->GetComponent<CollisionObject>();
+
+	if (collisionObject != nullptr)
+	{
+		collisionObject->UpdateChild(this);
+	}
+}
+
 btVector3 Collider::Convert(const Vector3f &vector)
 {
 	return btVector3(vector.m_x, vector.m_y, vector.m_z);
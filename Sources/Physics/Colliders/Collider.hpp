@@ -1,7 +1,7 @@
 #pragma once
 
+#include "Maths/Colour.hpp"
 #include "Maths/Transform.hpp"
-#include "Gizmos/Gizmos.hpp"
 #include "Scenes/Component.hpp"
 
 class btCollisionShape;
@@ -11,6 +11,9 @@ class btTransform;
 
 namespace acid
 {
+class Gizmo;
+class GizmoType;
+
 /**
  * @brief Class that represents a physics shape.
  */
@@ -52,6 +55,19 @@ public:
 	static Transform Convert(const btTransform &transform, const Vector3f &scaling = Vector3f::One);
 
 protected:
+	/**
+	 * Tells the collision object of the entity that the collision shape has been replaced.
+	 */
+	void UpdateShape();
+
+	/**
+	 * Creates the gizmo type a collider type is drawn with, servers have no gizmos and get null.
+	 * @param filename The gizmo model file.
+	 * @param colour The gizmo colour.
+	 * @return The gizmo type.
+	 */
+	static std::shared_ptr<GizmoType> CreateGizmoType(const std::string &filename, const Colour &colour);
+
 	Transform m_localTransform;
 	Gizmo *m_gizmo;
 };
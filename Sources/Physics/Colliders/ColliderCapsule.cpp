@@ -6,21 +6,21 @@
 namespace acid
 {
 ColliderCapsule::ColliderCapsule(const float &radius, const float &height, const Transform &localTransform) :
-	Collider(localTransform, GizmoType::Create(Model::Create("Gizmos/Capsule.obj"), 3.0f, Colour::Fuchsia)),
-	m_shape(std::make_unique<btCapsuleShape>(radius, height)),
+	Collider(localTransform, CreateGizmoType("Gizmos/Capsule.obj", Colour::Fuchsia)),
 	m_radius(radius),
 	m_height(height)
 {
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
 }
 
 ColliderCapsule::~ColliderCapsule()
 {
-	m_shape.release(); // TODO: Fix deletion of shape.
 }
 
 void ColliderCapsule::Start()
 {
+	CreateShape();
 }
 
 void ColliderCapsule::Update()
@@ -30,21 +30,36 @@ void ColliderCapsule::Update()
 
 btCollisionShape *ColliderCapsule::GetCollisionShape() const
 {
-	return m_shape.get();
+	return m_shape->GetShape();
 }
 
 void ColliderCapsule::SetRadius(const float &radius)
 {
 	m_radius = radius;
-	m_shape->setImplicitShapeDimensions(btVector3(m_radius, 0.5f * m_height, m_radius));
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
 }
 
 void ColliderCapsule::SetHeight(const float &height)
 {
 	m_height = height;
-	m_shape->setImplicitShapeDimensions(btVector3(m_radius, 0.5f * m_height, m_radius));
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
+}
+
+void ColliderCapsule::CreateShape()
+{
+	// The previous shape is kept until the collision object has been given the new one.
+	auto previous = std::move(m_shape);
+	m_shape = ColliderShape::Create("Capsule", Vector3f(m_radius, m_height, 0.0f), [this]()
+	{
+		return new btCapsuleShape(m_radius, m_height);
+	});
+
+	if (m_shape != previous)
+	{
+		UpdateShape();
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, ColliderCapsule &collider)
@@ -6,12 +6,12 @@
 namespace acid
 {
 ColliderCone::ColliderCone(const float &radius, const float &height, const Transform &localTransform) :
-	Collider(localTransform, GizmoType::Create(Model::Create("Gizmos/Cone.obj"), 3.0f, Colour::Green)),
-	m_shape(std::make_unique<btConeShape>(radius, height)),
+	Collider(localTransform, CreateGizmoType("Gizmos/Cone.obj", Colour::Green)),
 	m_radius(radius),
 	m_height(height)
 {
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
 }
 
 ColliderCone::~ColliderCone()
@@ -20,6 +20,7 @@ ColliderCone::~ColliderCone()
 
 void ColliderCone::Start()
 {
+	CreateShape();
 }
 
 void ColliderCone::Update()
@@ -29,21 +30,36 @@ void ColliderCone::Update()
 
 btCollisionShape *ColliderCone::GetCollisionShape() const
 {
-	return m_shape.get();
+	return m_shape->GetShape();
 }
 
 void ColliderCone::SetRadius(const float &radius)
 {
 	m_radius = radius;
-	m_shape->setRadius(m_radius);
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
 }
 
 void ColliderCone::SetHeight(const float &height)
 {
 	m_height = height;
-	m_shape->setHeight(m_height);
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
+}
+
+void ColliderCone::CreateShape()
+{
+	// The previous shape is kept until the collision object has been given the new one.
+	auto previous = std::move(m_shape);
+	m_shape = ColliderShape::Create("Cone", Vector3f(m_radius, m_height, 0.0f), [this]()
+	{
+		return new btConeShape(m_radius, m_height);
+	});
+
+	if (m_shape != previous)
+	{
+		UpdateShape();
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, ColliderCone &collider)
@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
-
-class btConeShape;
+#include "ColliderShape.hpp"
 
 namespace acid
 {
@@ -33,7 +32,9 @@ public:
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ColliderCone &collider);
 
 private:
-	std::unique_ptr<btConeShape> m_shape;
+	void CreateShape();
+
+	std::shared_ptr<ColliderShape> m_shape;
 	float m_radius;
 	float m_height;
 };
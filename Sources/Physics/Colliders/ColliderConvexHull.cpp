@@ -8,7 +8,6 @@ namespace acid
 {
 ColliderConvexHull::ColliderConvexHull(const std::vector<float> &pointCloud, const Transform &localTransform) :
 	Collider(localTransform),
-	m_shape(nullptr),
 	m_model(nullptr),
 	m_pointCount(0)
 {
@@ -30,7 +29,8 @@ void ColliderConvexHull::Start()
 
 	if (mesh != nullptr && mesh->GetModel() != nullptr)
 	{
-		Initialize(mesh->GetModel()->GetPointCloud());
+		m_model = mesh->GetModel();
+		Initialize(m_model);
 	}
 }
 
@@ -38,14 +38,15 @@ void ColliderConvexHull::Update()
 {
 	auto mesh = GetParent()->GetComponent<Mesh>(true);
 
-	if (mesh == nullptr || mesh->GetModel() != nullptr)
+	if (mesh == nullptr || mesh->GetModel() == nullptr)
 	{
 		return;
 	}
 
-	if (m_shape != nullptr && m_model == nullptr)
+	// The hull is built from the host copy of the models points, so no device memory is read.
+	if (m_hull != nullptr && m_model == nullptr)
 	{
-		if (mesh->GetModel()->GetPointCloud().size() / 3 == m_pointCount)
+		if (mesh->GetModel()->GetHullPoints().size() == m_pointCount)
 		{
 			m_model = mesh->GetModel();
 			return;
@@ -55,13 +56,13 @@ void ColliderConvexHull::Update()
 	if (m_model != mesh->GetModel())
 	{
 		m_model = mesh->GetModel();
-		Initialize(m_model->GetPointCloud());
+		Initialize(m_model);
 	}
 }
 
 btCollisionShape *ColliderConvexHull::GetCollisionShape() const
 {
-	return m_shape.get();
+	return m_hull != nullptr ? m_hull->GetShape() : nullptr;
 }
 
 void ColliderConvexHull::Initialize(const std::vector<float> &pointCloud)
@@ -71,10 +72,31 @@ void ColliderConvexHull::Initialize(const std::vector<float> &pointCloud)
 		return;
 	}
 
-	m_shape = std::make_unique<btConvexHullShape>(pointCloud.data(), static_cast<int32_t>(pointCloud.size() / 3), static_cast<int32_t>(sizeof(float)));
-	m_shape->optimizeConvexHull();
-	m_shape->initializePolyhedralFeatures();
-	m_pointCount = static_cast<uint32_t>(pointCloud.size() / 3);
+	// The previous hull is kept until the collision object has been given the new one.
+	auto previous = std::move(m_hull);
+	m_hull = std::make_shared<HullShape>(pointCloud);
+	m_pointCount = m_hull->GetSourceCount();
+	UpdateShape();
+}
+
+void ColliderConvexHull::Initialize(const std::shared_ptr<Model> &model)
+{
+	auto hull = HullShape::Create(model);
+
+	if (hull == nullptr)
+	{
+		return;
+	}
+
+	if (hull == m_hull)
+	{
+		return;
+	}
+
+	auto previous = std::move(m_hull);
+	m_hull = std::move(hull);
+	m_pointCount = m_hull->GetSourceCount();
+	UpdateShape();
 }
 
 const Metadata &operator>>(const Metadata &metadata, ColliderConvexHull &collider)
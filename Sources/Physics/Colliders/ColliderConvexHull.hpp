@@ -2,8 +2,7 @@
 
 #include "Models/Model.hpp"
 #include "Collider.hpp"
-
-class btConvexHullShape;
+#include "HullShape.hpp"
 
 namespace acid
 {
@@ -23,14 +22,24 @@ public:
 
 	const uint32_t &GetPointCount() const { return m_pointCount; }
 
+	/**
+	 * Builds a hull of its own from points, it is not shared with other colliders.
+	 * @param pointCloud The x, y, z coordinates of the points.
+	 */
 	void Initialize(const std::vector<float> &pointCloud);
 
+	/**
+	 * Uses the hull of a model, shared with every other collider for the model.
+	 * @param model The model.
+	 */
+	void Initialize(const std::shared_ptr<Model> &model);
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, ColliderConvexHull &collider);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ColliderConvexHull &collider);
 
 private:
-	std::unique_ptr<btConvexHullShape> m_shape;
+	std::shared_ptr<HullShape> m_hull;
 	std::shared_ptr<Model> m_model;
 	uint32_t m_pointCount;
 };
@@ -6,11 +6,11 @@
 namespace acid
 {
 ColliderCube::ColliderCube(const Vector3f &extents, const Transform &localTransform) :
-	Collider(localTransform, GizmoType::Create(Model::Create("Gizmos/Cube.obj"), 3.0f, Colour::Red)),
-	m_shape(std::make_unique<btBoxShape>(Convert(extents / 2.0f))),
+	Collider(localTransform, CreateGizmoType("Gizmos/Cube.obj", Colour::Red)),
 	m_extents(extents)
 {
 	m_localTransform.SetScaling(m_extents);
+	CreateShape();
 }
 
 ColliderCube::~ColliderCube()
@@ -19,6 +19,7 @@ ColliderCube::~ColliderCube()
 
 void ColliderCube::Start()
 {
+	CreateShape();
 }
 
 void ColliderCube::Update()
@@ -28,14 +29,29 @@ void ColliderCube::Update()
 
 btCollisionShape *ColliderCube::GetCollisionShape() const
 {
-	return m_shape.get();
+	return m_shape->GetShape();
 }
 
 void ColliderCube::SetExtents(const Vector3f &extents)
 {
 	m_extents = extents;
-	m_shape->setImplicitShapeDimensions(Convert(m_extents));
 	m_localTransform.SetScaling(m_extents);
+	CreateShape();
+}
+
+void ColliderCube::CreateShape()
+{
+	// The previous shape is kept until the collision object has been given the new one.
+	auto previous = std::move(m_shape);
+	m_shape = ColliderShape::Create("Cube", m_extents, [this]()
+	{
+		return new btBoxShape(Convert(m_extents / 2.0f));
+	});
+
+	if (m_shape != previous)
+	{
+		UpdateShape();
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, ColliderCube &collider)
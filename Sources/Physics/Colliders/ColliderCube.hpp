@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
-
-class btBoxShape;
+#include "ColliderShape.hpp"
 
 namespace acid
 {
@@ -29,7 +28,9 @@ public:
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ColliderCube &collider);
 
 private:
-	std::unique_ptr<btBoxShape> m_shape;
+	void CreateShape();
+
+	std::shared_ptr<ColliderShape> m_shape;
 	Vector3f m_extents;
 };
 }
@@ -6,12 +6,12 @@
 namespace acid
 {
 ColliderCylinder::ColliderCylinder(const float &radius, const float &height, const Transform &localTransform) :
-	Collider(localTransform, GizmoType::Create(Model::Create("Gizmos/Cylinder.obj"), 3.0f, Colour::Yellow)),
-	m_shape(std::make_unique<btCylinderShape>(btVector3(radius, height / 2.0f, radius))),
+	Collider(localTransform, CreateGizmoType("Gizmos/Cylinder.obj", Colour::Yellow)),
 	m_radius(radius),
 	m_height(height)
 {
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
 }
 
 ColliderCylinder::~ColliderCylinder()
@@ -20,6 +20,7 @@ ColliderCylinder::~ColliderCylinder()
 
 void ColliderCylinder::Start()
 {
+	CreateShape();
 }
 
 void ColliderCylinder::Update()
@@ -29,21 +30,36 @@ void ColliderCylinder::Update()
 
 btCollisionShape *ColliderCylinder::GetCollisionShape() const
 {
-	return m_shape.get();
+	return m_shape->GetShape();
 }
 
 void ColliderCylinder::SetRadius(const float &radius)
 {
 	m_radius = radius;
-	m_shape->setImplicitShapeDimensions(btVector3(m_radius, m_height / 2.0f, m_radius));
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
 }
 
 void ColliderCylinder::SetHeight(const float &height)
 {
 	m_height = height;
-	m_shape->setImplicitShapeDimensions(btVector3(m_radius, m_height / 2.0f, m_radius));
 	m_localTransform.SetScaling(Vector3f(m_radius, m_height, m_radius));
+	CreateShape();
+}
+
+void ColliderCylinder::CreateShape()
+{
+	// The previous shape is kept until the collision object has been given the new one.
+	auto previous = std::move(m_shape);
+	m_shape = ColliderShape::Create("Cylinder", Vector3f(m_radius, m_height, 0.0f), [this]()
+	{
+		return new btCylinderShape(btVector3(m_radius, m_height / 2.0f, m_radius));
+	});
+
+	if (m_shape != previous)
+	{
+		UpdateShape();
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, ColliderCylinder &collider)
@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
-
-class btCylinderShape;
+#include "ColliderShape.hpp"
 
 namespace acid
 {
@@ -33,7 +32,9 @@ public:
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ColliderCylinder &collider);
 
 private:
-	std::unique_ptr<btCylinderShape> m_shape;
+	void CreateShape();
+
+	std::shared_ptr<ColliderShape> m_shape;
 	float m_radius;
 	float m_height;
 };
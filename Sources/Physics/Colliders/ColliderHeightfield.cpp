@@ -6,11 +6,11 @@
 namespace acid
 {
 ColliderHeightfield::ColliderHeightfield(const int32_t &heightStickWidth, const int32_t &heightStickLength, const void *heightfieldData, const float &minHeight,
-	const float &maxHeight, const bool &flipQuadEdges, const Transform &localTransform) :
+	const float &maxHeight, const bool &flipQuadEdges, const float &gridSpacing, const Transform &localTransform) :
 	Collider(localTransform),
 	m_shape(nullptr)
 {
-	Initialize(heightStickWidth, heightStickLength, heightfieldData, minHeight, maxHeight, flipQuadEdges);
+	Initialize(heightStickWidth, heightStickLength, heightfieldData, minHeight, maxHeight, flipQuadEdges, gridSpacing);
 }
 
 ColliderHeightfield::~ColliderHeightfield()
@@ -31,14 +31,18 @@ btCollisionShape *ColliderHeightfield::GetCollisionShape() const
 }
 
 void ColliderHeightfield::Initialize(const int32_t &heightStickWidth, const int32_t &heightStickLength, const void *heightfieldData, const float &minHeight, const float &maxHeight,
-	const bool &flipQuadEdges)
+	const bool &flipQuadEdges, const float &gridSpacing)
 {
 	if (heightfieldData == nullptr)
 	{
 		return;
 	}
 
-	m_shape = std::make_unique<btHeightfieldTerrainShape>(heightStickWidth, heightStickLength, heightfieldData, 1.0f, minHeight, maxHeight, 1, PHY_FLOAT, flipQuadEdges);
+	auto heights = static_cast<const float *>(heightfieldData);
+	m_heights.assign(heights, heights + heightStickWidth * heightStickLength);
+	m_shape = std::make_unique<btHeightfieldTerrainShape>(heightStickWidth, heightStickLength, m_heights.data(), 1.0f, minHeight, maxHeight, 1, PHY_FLOAT,
+		flipQuadEdges);
+	m_shape->setLocalScaling(btVector3(gridSpacing, 1.0f, gridSpacing));
 }
 
 const Metadata &operator>>(const Metadata &metadata, ColliderHeightfield &collider)
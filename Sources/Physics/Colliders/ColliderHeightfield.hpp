@@ -10,8 +10,20 @@ class ACID_EXPORT ColliderHeightfield :
 	public Collider
 {
 public:
+	/**
+	 * Creates a new heightfield collider.
+	 * @param heightStickWidth The number of samples along the x axis.
+	 * @param heightStickLength The number of samples along the z axis.
+	 * @param heightfieldData The float heights of each sample, row by row. The heights are copied, so the data does not need to outlive the collider.
+	 * @param minHeight The lowest height in the data.
+	 * @param maxHeight The highest height in the data.
+	 * @param flipQuadEdges If the diagonal of each quad is flipped.
+	 * @param gridSpacing The distance between samples.
+	 * @param localTransform The parent offset of the body, the heightfield is centred on it.
+	 */
 	explicit ColliderHeightfield(const int32_t &heightStickWidth = 100, const int32_t &heightStickLength = 100, const void *heightfieldData = nullptr,
-		const float &minHeight = -1.0f, const float &maxHeight = 1.0f, const bool &flipQuadEdges = false, const Transform &localTransform = Transform::Zero);
+		const float &minHeight = -1.0f, const float &maxHeight = 1.0f, const bool &flipQuadEdges = false, const float &gridSpacing = 1.0f,
+		const Transform &localTransform = Transform::Zero);
 
 	~ColliderHeightfield();
 
@@ -22,13 +34,15 @@ public:
 	btCollisionShape *GetCollisionShape() const override;
 
 	void Initialize(const int32_t &heightStickWidth, const int32_t &heightStickLength, const void *heightfieldData, const float &minHeight, const float &maxHeight,
-		const bool &flipQuadEdges);
+		const bool &flipQuadEdges, const float &gridSpacing = 1.0f);
 
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, ColliderHeightfield &collider);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ColliderHeightfield &collider);
 
 private:
+	// Bullet reads the heights in place, so the collider keeps its own copy.
+	std::vector<float> m_heights;
 	std::unique_ptr<btHeightfieldTerrainShape> m_shape;
 };
 }
@@ -0,0 +1,29 @@
+#include "ColliderShape.hpp"
+
+#include <BulletCollision/CollisionShapes/btCollisionShape.h>
+#include "Resources/Resources.hpp"
+
+namespace acid
+{
+std::shared_ptr<ColliderShape> ColliderShape::Create(const std::string &type, const Vector3f &dimensions, const std::function<btCollisionShape *()> &create)
+{
+	Metadata metadata;
+	metadata.SetChild<std::string>("Type", "ColliderShape");
+	metadata.SetChild("Shape", type);
+	metadata.SetChild("Dimensions", dimensions);
+
+	return Resources::Get()->FindOrLoad<ColliderShape>(metadata, [&]()
+	{
+		return std::make_shared<ColliderShape>(create());
+	});
+}
+
+ColliderShape::ColliderShape(btCollisionShape *shape) :
+	m_shape(shape)
+{
+}
+
+ColliderShape::~ColliderShape()
+{
+}
+}
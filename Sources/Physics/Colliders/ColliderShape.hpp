@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Maths/Vector3.hpp"
+#include "Resources/Resource.hpp"
+
+class btCollisionShape;
+
+namespace acid
+{
+/**
+ * @brief Resource that holds a primitive collision shape, colliders of the same type and dimensions share one shape.
+ * Shared shapes are never scaled or resized, collision objects scale them through their own wrappers and colliders swap to another shape when resized.
+ */
+class ACID_EXPORT ColliderShape :
+	public Resource
+{
+public:
+	/**
+	 * Finds the shape of a type with the dimensions, or creates it.
+	 * @param type The name of the shape type.
+	 * @param dimensions The dimensions of the shape, what each component means depends on the type.
+	 * @param create The function that creates the shape when none is found.
+	 * @return The shape.
+	 */
+	static std::shared_ptr<ColliderShape> Create(const std::string &type, const Vector3f &dimensions, const std::function<btCollisionShape *()> &create);
+
+	/**
+	 * Creates a new shape that is not shared.
+	 * @param shape The shape, the resource takes ownership of it.
+	 */
+	explicit ColliderShape(btCollisionShape *shape);
+
+	~ColliderShape();
+
+	btCollisionShape *GetShape() const { return m_shape.get(); }
+
+private:
+	std::unique_ptr<btCollisionShape> m_shape;
+};
+}
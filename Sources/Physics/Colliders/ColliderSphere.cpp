@@ -6,11 +6,11 @@
 namespace acid
 {
 ColliderSphere::ColliderSphere(const float &radius, const Transform &localTransform) :
-	Collider(localTransform, GizmoType::Create(Model::Create("Gizmos/Sphere.obj"), 3.0f, Colour::Blue)),
-	m_shape(std::make_unique<btSphereShape>(radius)),
+	Collider(localTransform, CreateGizmoType("Gizmos/Sphere.obj", Colour::Blue)),
 	m_radius(radius)
 {
 	m_localTransform.SetScaling(Vector3f(m_radius, m_radius, m_radius));
+	CreateShape();
 }
 
 ColliderSphere::~ColliderSphere()
@@ -19,6 +19,7 @@ ColliderSphere::~ColliderSphere()
 
 void ColliderSphere::Start()
 {
+	CreateShape();
 }
 
 void ColliderSphere::Update()
@@ -28,14 +29,29 @@ void ColliderSphere::Update()
 
 btCollisionShape *ColliderSphere::GetCollisionShape() const
 {
-	return m_shape.get();
+	return m_shape->GetShape();
 }
 
 void ColliderSphere::SetRadius(const float &radius)
 {
 	m_radius = radius;
-	m_shape->setUnscaledRadius(m_radius);
 	m_localTransform.SetScaling(Vector3f(m_radius, m_radius, m_radius));
+	CreateShape();
+}
+
+void ColliderSphere::CreateShape()
+{
+	// The previous shape is kept until the collision object has been given the new one.
+	auto previous = std::move(m_shape);
+	m_shape = ColliderShape::Create("Sphere", Vector3f(m_radius, 0.0f, 0.0f), [this]()
+	{
+		return new btSphereShape(m_radius);
+	});
+
+	if (m_shape != previous)
+	{
+		UpdateShape();
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, ColliderSphere &collider)
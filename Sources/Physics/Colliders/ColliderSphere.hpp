@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Collider.hpp"
-
-class btSphereShape;
+#include "ColliderShape.hpp"
 
 namespace acid
 {
@@ -29,7 +28,9 @@ public:
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ColliderSphere &collider);
 
 private:
-	std::unique_ptr<btSphereShape> m_shape;
+	void CreateShape();
+
+	std::shared_ptr<ColliderShape> m_shape;
 	float m_radius;
 };
 }
@@ -0,0 +1,62 @@
+#include "HullShape.hpp"
+
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+#include "Resources/Resources.hpp"
+
+namespace acid
+{
+std::shared_ptr<HullShape> HullShape::Create(const std::shared_ptr<Model> &model)
+{
+	if (model == nullptr || model->GetHullPoints().empty())
+	{
+		return nullptr;
+	}
+
+	Metadata metadata;
+	metadata.SetChild<std::string>("Type", "HullShape");
+	metadata.SetChild("Model", std::to_string(reinterpret_cast<uintptr_t>(model.get())));
+
+	return Resources::Get()->FindOrLoad<HullShape>(metadata, [&]()
+	{
+		auto result = std::make_shared<HullShape>(model->GetPointCloud());
+		result->m_model = model;
+		return result;
+	});
+}
+
+HullShape::HullShape(const std::vector<float> &pointCloud) :
+	m_sourceCount(static_cast<uint32_t>(pointCloud.size() / 3))
+{
+	if (pointCloud.empty())
+	{
+		return;
+	}
+
+	btConvexHullShape sourceShape(pointCloud.data(), static_cast<int32_t>(pointCloud.size() / 3), static_cast<int32_t>(3 * sizeof(float)));
+	btShapeHull shapeHull(&sourceShape);
+
+	// Small hulls are kept as they are, reduction could only remove points from them that are on the hull.
+	if (!shapeHull.buildHull(sourceShape.getMargin()) || shapeHull.numVertices() == 0 || static_cast<uint32_t>(shapeHull.numVertices()) >= m_sourceCount)
+	{
+		m_shape = std::make_unique<btConvexHullShape>(pointCloud.data(), static_cast<int32_t>(pointCloud.size() / 3), static_cast<int32_t>(3 * sizeof(float)));
+	}
+	else
+	{
+		m_shape = std::make_unique<btConvexHullShape>(reinterpret_cast<const btScalar *>(shapeHull.getVertexPointer()), shapeHull.numVertices(),
+			static_cast<int32_t>(sizeof(btVector3)));
+	}
+
+	m_shape->optimizeConvexHull();
+	m_shape->initializePolyhedralFeatures();
+}
+
+HullShape::~HullShape()
+{
+}
+
+uint32_t HullShape::GetVertexCount() const
+{
+	return m_shape != nullptr ? static_cast<uint32_t>(m_shape->getNumPoints()) : 0;
+}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Models/Model.hpp"
+#include "Resources/Resource.hpp"
+
+class btConvexHullShape;
+
+namespace acid
+{
+/**
+ * @brief Resource that holds a reduced convex hull shape, entities with colliders for the same model share one shape.
+ * Hulls are reduced to the vertices found by sampling a set of directions with btShapeHull, so support functions in the narrowphase test far fewer points.
+ */
+class ACID_EXPORT HullShape :
+	public Resource
+{
+public:
+	/**
+	 * Creates a new hull shape from the hull points of a model, or finds the one already built for the model.
+	 * @param model The model to build the hull of.
+	 * @return The hull shape, or nullptr if the model has no points.
+	 */
+	static std::shared_ptr<HullShape> Create(const std::shared_ptr<Model> &model);
+
+	/**
+	 * Creates a new hull shape that is not shared.
+	 * @param pointCloud The x, y, z coordinates of the points to build the hull of.
+	 */
+	explicit HullShape(const std::vector<float> &pointCloud);
+
+	~HullShape();
+
+	btConvexHullShape *GetShape() const { return m_shape.get(); }
+
+	/**
+	 * Gets the number of points the hull was built from, before it was reduced.
+	 * @return The number of source points.
+	 */
+	uint32_t GetSourceCount() const { return m_sourceCount; }
+
+	/**
+	 * Gets the number of vertices left in the hull once it was reduced.
+	 * @return The number of hull vertices.
+	 */
+	uint32_t GetVertexCount() const;
+
+private:
+	// Shared hulls are found by the address of their model, keeping the model alive stops the address being reused while the hull is registered.
+	std::shared_ptr<Model> m_model;
+	std::unique_ptr<btConvexHullShape> m_shape;
+	uint32_t m_sourceCount;
+};
+}
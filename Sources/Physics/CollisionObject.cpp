@@ -1,6 +1,7 @@
 #include "CollisionObject.hpp"
 
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btUniformScalingShape.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 #include "Scenes/Entity.hpp"
 #include "Scenes/Scenes.hpp"
@@ -16,7 +17,8 @@ CollisionObject::CollisionObject(const float &mass, const float &friction, const
 	m_linearFactor(linearFactor),
 	m_angularFactor(angularFactor),
 	m_shape(nullptr),
-	m_body(nullptr)
+	m_body(nullptr),
+	m_scaling(Vector3f::One)
 {
 }
 
@@ -30,24 +32,31 @@ Force *CollisionObject::AddForce(Force *force)
 	return force;
 }
 
-void CollisionObject::SetChildTransform(Collider *child, const Transform &transform)
+void CollisionObject::GetWorldAabb(Vector3f &min, Vector3f &max) const
 {
-	auto compoundShape = dynamic_cast<btCompoundShape *>(m_shape.get());
+	btVector3 aabbMin = btVector3();
+	btVector3 aabbMax = btVector3();
 
-	if (compoundShape == nullptr)
+	if (m_body != nullptr && m_shape != nullptr)
 	{
-		return;
+		m_shape->getAabb(Collider::Convert(GetParent()->GetWorldTransform()), aabbMin, aabbMax);
 	}
 
-	for (int32_t i = 0; i < compoundShape->getNumChildShapes(); i++)
+	min = Collider::Convert(aabbMin);
+	max = Collider::Convert(aabbMax);
+}
+
+void CollisionObject::SetChildTransform(Collider *child, const Transform &transform)
+{
+	auto compoundShape = dynamic_cast<btCompoundShape *>(m_shape.get());
+	auto index = FindChild(child);
+
+	if (compoundShape == nullptr || index == -1)
 	{
-		if (compoundShape->getChildShape(i) == child->GetCollisionShape())
-		{
-			compoundShape->updateChildTransform(i, Collider::Convert(transform));
-			break;
-		}
+		return;
 	}
 
+	compoundShape->updateChildTransform(index, GetChildTransform(transform));
 	RecalculateMass();
 }
 
@@ -60,23 +69,67 @@ void CollisionObject::AddChild(Collider *child)
 		return;
 	}
 
-	compoundShape->addChildShape(Collider::Convert(child->GetLocalTransform()), child->GetCollisionShape());
+	AddCompoundChild(compoundShape, child);
 	RecalculateMass();
 }
 
-void CollisionObject::RemoveChild(Collider *child)
+Collider *CollisionObject::AddChild(std::unique_ptr<Collider> child)
+{
+	auto added = child.get();
+	m_children.emplace_back(std::move(child));
+	AddChild(added);
+	return added;
+}
+
+void CollisionObject::UpdateChild(Collider *child)
 {
+	if (m_shape == nullptr)
+	{
+		return;
+	}
+
 	auto compoundShape = dynamic_cast<btCompoundShape *>(m_shape.get());
 
+	// A single shape wraps the collider shape directly, so the object is started again around the new shape.
 	if (compoundShape == nullptr)
 	{
+		Start();
 		return;
 	}
 
-	compoundShape->removeChildShape(child->GetCollisionShape());
+	auto index = FindChild(child);
+
+	if (index == -1)
+	{
+		return;
+	}
+
+	ReplaceCompoundChild(compoundShape, index);
 	RecalculateMass();
 }
 
+void CollisionObject::RemoveChild(Collider *child)
+{
+	auto compoundShape = dynamic_cast<btCompoundShape *>(m_shape.get());
+	auto index = FindChild(child);
+
+	if (compoundShape != nullptr && index != -1)
+	{
+		// Bullet moves the last child into the removed index, the colliders and wrappers are moved the same way.
+		compoundShape->removeChildShapeByIndex(index);
+		m_compoundColliders[index] = m_compoundColliders.back();
+		m_compoundColliders.pop_back();
+		m_compoundWrappers[index] = std::move(m_compoundWrappers.back());
+		m_compoundWrappers.pop_back();
+		RecalculateMass();
+	}
+
+	m_children.erase(std::remove_if(m_children.begin(), m_children.end(), [child](const std::unique_ptr<Collider> &c)
+	{
+		return c.get() == child;
+	}), m_children.end());
+}
+
 void CollisionObject::SetIgnoreCollisionCheck(CollisionObject *other, const bool &ignore)
 {
 	m_body->setIgnoreCollisionCheck(other->m_body, ignore);
@@ -103,36 +156,115 @@ void CollisionObject::SetFrictionSpinning(const float &frictionSpinning)
 void CollisionObject::CreateShape(const bool &forceSingle)
 {
 	auto colliders = GetParent()->GetComponents<Collider>();
+	m_compoundColliders.clear();
 
 	if (forceSingle) // && colliders.size() == 1
 	{
-		m_shape.reset(colliders[0]->GetCollisionShape());
+		auto shape = colliders[0]->GetCollisionShape();
+		assert(shape->isConvex() && "Single shapes must be convex!");
+
+		// The collider shape may be shared with other entities, so it is wrapped instead of owned.
+		m_shape = std::make_unique<btUniformScalingShape>(static_cast<btConvexShape *>(shape), 1.0f);
+		m_compoundWrappers.clear();
 		return;
 	}
-	if (colliders.empty())
+
+	// Without colliders the compound shape starts empty, colliders not attached to the entity such as terrain tiles can still be added with AddChild.
+	// The previous shape and wrappers are kept until the body has been given the new shape.
+	auto previous = std::move(m_shape);
+	auto previousWrappers = std::move(m_compoundWrappers);
+	m_compoundWrappers.clear();
+	auto compoundShape = new btCompoundShape();
+	m_shape.reset(compoundShape);
+
+	for (const auto &collider : colliders)
 	{
-		m_shape = nullptr;
-		return;
+		AddCompoundChild(compoundShape, collider);
 	}
 
-	if (dynamic_cast<btCompoundShape *>(m_shape.get()) == nullptr)
+	for (const auto &child : m_children)
 	{
-		m_shape.release();
+		AddCompoundChild(compoundShape, child.get());
 	}
 
-	auto compoundShape = new btCompoundShape();
+	if (m_body != nullptr)
+	{
+		m_body->setCollisionShape(m_shape.get());
+	}
 
-	for (int32_t i = 0; i < compoundShape->getNumChildShapes(); i++)
+	RecalculateMass();
+}
+
+void CollisionObject::SetScaling(const Vector3f &scaling)
+{
+	auto compoundShape = dynamic_cast<btCompoundShape *>(m_shape.get());
+
+	if (scaling == m_scaling)
 	{
-		compoundShape->removeChildShapeByIndex(i);
+		return;
 	}
 
-	for (const auto &collider : colliders)
+	m_scaling = scaling;
+
+	if (compoundShape == nullptr)
 	{
-		compoundShape->addChildShape(Collider::Convert(collider->GetLocalTransform()), collider->GetCollisionShape());
+		return;
+	}
+
+	for (int32_t i = 0; i < compoundShape->getNumChildShapes(); i++)
+	{
+		ReplaceCompoundChild(compoundShape, i);
 	}
 
-	m_shape.reset(compoundShape);
 	RecalculateMass();
 }
+
+void CollisionObject::AddCompoundChild(btCompoundShape *compoundShape, Collider *child)
+{
+	std::unique_ptr<btCollisionShape> wrapper;
+	compoundShape->addChildShape(GetChildTransform(child->GetLocalTransform()), CreateChildShape(child, wrapper));
+	m_compoundColliders.emplace_back(child);
+	m_compoundWrappers.emplace_back(std::move(wrapper));
+}
+
+void CollisionObject::ReplaceCompoundChild(btCompoundShape *compoundShape, const int32_t &index)
+{
+	// The old wrapper is kept until the child points at the new shape.
+	auto child = m_compoundColliders[index];
+	std::unique_ptr<btCollisionShape> wrapper;
+	auto &compoundChild = compoundShape->getChildList()[index];
+	compoundChild.m_childShape = CreateChildShape(child, wrapper);
+	compoundChild.m_childShapeType = compoundChild.m_childShape->getShapeType();
+	compoundChild.m_childMargin = compoundChild.m_childShape->getMargin();
+	m_compoundWrappers[index] = std::move(wrapper);
+	compoundShape->updateChildTransform(index, GetChildTransform(child->GetLocalTransform()));
+}
+
+btCollisionShape *CollisionObject::CreateChildShape(Collider *child, std::unique_ptr<btCollisionShape> &wrapper) const
+{
+	auto shape = child->GetCollisionShape();
+
+	// Concave shapes such as terrain are not shared and keep the scaling set by their collider.
+	if (!shape->isConvex())
+	{
+		return shape;
+	}
+
+	auto uniformScaling = std::max({std::abs(m_scaling.m_x), std::abs(m_scaling.m_y), std::abs(m_scaling.m_z)});
+	wrapper = std::make_unique<btUniformScalingShape>(static_cast<btConvexShape *>(shape), uniformScaling);
+	return wrapper.get();
+}
+
+btTransform CollisionObject::GetChildTransform(const Transform &transform) const
+{
+	auto childTransform = Collider::Convert(transform);
+	childTransform.setOrigin(childTransform.getOrigin() * Collider::Convert(m_scaling));
+	return childTransform;
+}
+
+int32_t CollisionObject::FindChild(Collider *child) const
+{
+	auto it = std::find(m_compoundColliders.begin(), m_compoundColliders.end(), child);
+	return it != m_compoundColliders.end() ? static_cast<int32_t>(it - m_compoundColliders.begin()) : -1;
+}
 }
@@ -9,6 +9,7 @@
 class btTransform;
 class btCollisionShape;
 class btCollisionObject;
+class btCompoundShape;
 
 namespace acid
 {
@@ -39,6 +40,13 @@ public:
 	 */
 	virtual bool InFrustum(const Frustum &frustum) = 0;
 
+	/**
+	 * Gets the world space bounding box of the shape, from the entity transform as a multithreaded world may be stepping the body.
+	 * @param min The minimum point of the box, zero if the shape is not created.
+	 * @param max The maximum point of the box, zero if the shape is not created.
+	 */
+	void GetWorldAabb(Vector3f &min, Vector3f &max) const;
+
 	Force *AddForce(Force *force);
 
 	template<typename T, typename... Args>
@@ -52,6 +60,23 @@ public:
 
 	void AddChild(Collider *child);
 
+	/**
+	 * Called when a collider swapped its collision shape, the child is replaced in the shape without rebuilding the others.
+	 * @param child The collider.
+	 */
+	void UpdateChild(Collider *child);
+
+	/**
+	 * Adds a collider that is not a component of the entity to the shape, such as a streamed terrain tile. The object owns the collider until it is removed.
+	 * @param child The collider.
+	 * @return The collider.
+	 */
+	Collider *AddChild(std::unique_ptr<Collider> child);
+
+	/**
+	 * Removes a collider from the shape, a collider owned by the object is destroyed.
+	 * @param child The collider.
+	 */
 	void RemoveChild(Collider *child);
 
 	void SetIgnoreCollisionCheck(CollisionObject *other, const bool &ignore);
@@ -107,6 +132,13 @@ public:
 protected:
 	void CreateShape(const bool &forceSingle = false);
 
+	/**
+	 * Scales the shape, collider shapes are shared so convex children are scaled with wrappers owned by this object.
+	 * Wrappers only scale uniformly, a non-uniform scaling scales convex children by its largest component, concave children are not scaled.
+	 * @param scaling The scaling.
+	 */
+	void SetScaling(const Vector3f &scaling);
+
 	virtual void RecalculateMass() = 0;
 
 	float m_mass;
@@ -124,10 +156,29 @@ protected:
 
 	std::unique_ptr<btCollisionShape> m_shape;
 	btCollisionObject *m_body;
+	Vector3f m_scaling;
+
+	// The colliders of the compound shape in the order of its children, and the wrappers that scale each shared shape.
+	std::vector<Collider *> m_compoundColliders;
+	std::vector<std::unique_ptr<btCollisionShape>> m_compoundWrappers;
+
+	// Colliders added with AddChild that are not components of the entity.
+	std::vector<std::unique_ptr<Collider>> m_children;
 
 	std::vector<std::unique_ptr<Force>> m_forces;
 
 	Delegate<void(CollisionObject *)> m_onCollision;
 	Delegate<void(CollisionObject *)> m_onSeparation;
+
+private:
+	void AddCompoundChild(btCompoundShape *compoundShape, Collider *child);
+
+	void ReplaceCompoundChild(btCompoundShape *compoundShape, const int32_t &index);
+
+	btCollisionShape *CreateChildShape(Collider *child, std::unique_ptr<btCollisionShape> &wrapper) const;
+
+	btTransform GetChildTransform(const Transform &transform) const;
+
+	int32_t FindChild(Collider *child) const;
 };
 }
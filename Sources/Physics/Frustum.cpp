@@ -94,7 +94,7 @@ bool Frustum::PointInFrustum(const Vector3f &position) const
 	return true;
 }
 
-bool Frustum::SphereInFrustum(const Vector3f &position, const float &radius) const
+bool Frustum::SphereInFrustum(const Vector3f &position, float radius) const
 {
 	for (uint32_t i = 0; i < 6; i++)
 	{
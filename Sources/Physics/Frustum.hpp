@@ -35,7 +35,7 @@ public:
 	 * @param radius The spheres radius.
 	 * @return If the sphere is contained.
 	 */
-	bool SphereInFrustum(const Vector3f &position, const float &radius) const;
+	bool SphereInFrustum(const Vector3f &position, float radius) const;
 
 	/**
 	 * Gets if a cube contained in the frustum.
@@ -45,6 +45,12 @@ public:
 	 */
 	bool CubeInFrustum(const Vector3f &min, const Vector3f &max) const;
 
+	/**
+	 * Gets the six frustum planes, each plane is stored as a normal and distance.
+	 * @return The frustum planes.
+	 */
+	const std::array<std::array<float, 4>, 6> &GetPlanes() const { return m_frustum; }
+
 	static const Frustum Zero;
 
 private:
@@ -0,0 +1,190 @@
+#include "FrustumCuller.hpp"
+
+#include "Engine/Engine.hpp"
+#include "Maths/Simd.hpp"
+
+namespace acid
+{
+uint32_t FrustumCuller::AddSphere(const Vector3f &centre, const float &radius)
+{
+	Append(m_spheres, { centre.m_x, centre.m_y, centre.m_z, radius }, m_sphereCount);
+	return m_sphereCount++;
+}
+
+uint32_t FrustumCuller::AddCube(const Vector3f &min, const Vector3f &max)
+{
+	Append(m_cubes, { min.m_x, min.m_y, min.m_z, max.m_x, max.m_y, max.m_z }, m_cubeCount);
+	return m_cubeCount++;
+}
+
+void FrustumCuller::Clear()
+{
+	m_sphereCount = 0;
+	m_cubeCount = 0;
+
+	for (auto &array : m_spheres)
+	{
+		array.clear();
+	}
+
+	for (auto &array : m_cubes)
+	{
+		array.clear();
+	}
+}
+
+void FrustumCuller::CullSpheres(const Frustum &frustum, std::vector<uint32_t> &visible) const
+{
+	CullSpheres(frustum, m_spheres[0].data(), m_spheres[1].data(), m_spheres[2].data(), m_spheres[3].data(), 1.0f, m_sphereCount, visible);
+}
+
+void FrustumCuller::CullCubes(const Frustum &frustum, std::vector<uint32_t> &visible) const
+{
+	CullCubes(frustum, { m_cubes[0].data(), m_cubes[1].data(), m_cubes[2].data() }, { m_cubes[3].data(), m_cubes[4].data(), m_cubes[5].data() }, m_cubeCount, visible);
+}
+
+void FrustumCuller::CullSpheres(const Frustum &frustum, const float *x, const float *y, const float *z, const float *radius, const float &radiusScale,
+	const uint32_t &count, std::vector<uint32_t> &visible)
+{
+	std::array<std::array<Simd::Float4, 4>, 6> planes;
+
+	for (std::size_t i = 0; i < 6; i++)
+	{
+		for (std::size_t j = 0; j < 4; j++)
+		{
+			planes[i][j] = Simd::Splat(frustum.GetPlanes()[i][j]);
+		}
+	}
+
+	auto scales = Simd::Splat(radiusScale);
+	auto zeros = Simd::Splat(0.0f);
+
+	Cull(count, visible, [&](const uint32_t &i)
+	{
+		auto centreX = Simd::Load(&x[i]);
+		auto centreY = Simd::Load(&y[i]);
+		auto centreZ = Simd::Load(&z[i]);
+		auto radii = Simd::Multiply(Simd::Load(&radius[i]), scales);
+		uint32_t mask = 0xF;
+
+		// A sphere is outside when its centre is further than its radius behind any plane.
+		for (const auto &plane : planes)
+		{
+			auto distance = Simd::MultiplyAdd(plane[0], centreX, Simd::Add(plane[3], radii));
+			distance = Simd::MultiplyAdd(plane[1], centreY, distance);
+			distance = Simd::MultiplyAdd(plane[2], centreZ, distance);
+			mask &= Simd::Greater(distance, zeros);
+
+			if (mask == 0)
+			{
+				break;
+			}
+		}
+
+		return mask;
+	});
+}
+
+void FrustumCuller::CullCubes(const Frustum &frustum, const std::array<const float *, 3> &min, const std::array<const float *, 3> &max, const uint32_t &count,
+	std::vector<uint32_t> &visible)
+{
+	// A box is outside a plane when the corner furthest along the planes normal is behind it, that corner takes each coordinate from the max point where the normal is positive.
+	std::array<std::array<Simd::Float4, 4>, 6> planes;
+	std::array<std::array<const float *, 3>, 6> corners;
+
+	for (std::size_t i = 0; i < 6; i++)
+	{
+		const auto &plane = frustum.GetPlanes()[i];
+
+		for (std::size_t j = 0; j < 4; j++)
+		{
+			planes[i][j] = Simd::Splat(plane[j]);
+		}
+
+		for (std::size_t j = 0; j < 3; j++)
+		{
+			corners[i][j] = plane[j] > 0.0f ? max[j] : min[j];
+		}
+	}
+
+	auto zeros = Simd::Splat(0.0f);
+
+	Cull(count, visible, [&](const uint32_t &i)
+	{
+		uint32_t mask = 0xF;
+
+		for (std::size_t j = 0; j < 6; j++)
+		{
+			const auto &plane = planes[j];
+			auto distance = Simd::MultiplyAdd(plane[0], Simd::Load(&corners[j][0][i]), plane[3]);
+			distance = Simd::MultiplyAdd(plane[1], Simd::Load(&corners[j][1][i]), distance);
+			distance = Simd::MultiplyAdd(plane[2], Simd::Load(&corners[j][2][i]), distance);
+			mask &= Simd::Greater(distance, zeros);
+
+			if (mask == 0)
+			{
+				break;
+			}
+		}
+
+		return mask;
+	});
+}
+
+template<typename F>
+void FrustumCuller::Cull(const uint32_t &count, std::vector<uint32_t> &visible, const F &cull)
+{
+	visible.clear();
+
+	auto cullRange = [&cull, &count](const uint32_t &begin, const uint32_t &end, std::vector<uint32_t> &indices)
+	{
+		for (auto i = begin; i < end; i += 4)
+		{
+			auto mask = cull(i);
+
+			// Lanes past the last object read the padding and are ignored.
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				if ((mask & (1u << lane)) != 0 && i + lane < count)
+				{
+					indices.emplace_back(i + lane);
+				}
+			}
+		}
+	};
+
+	auto engine = Engine::Get();
+
+	if (count <= ParallelGrain || engine == nullptr)
+	{
+		cullRange(0, count, visible);
+		return;
+	}
+
+	// Each range writes its own indices, they are joined in order so the indices stay ascending.
+	auto rangeCount = (count + ParallelGrain - 1) / ParallelGrain;
+	std::vector<std::vector<uint32_t>> ranges(rangeCount);
+
+	engine->GetThreadPool().ParallelFor(0, rangeCount, [&](const std::size_t &range)
+	{
+		auto begin = static_cast<uint32_t>(range) * ParallelGrain;
+		cullRange(begin, std::min(begin + ParallelGrain, count), ranges[range]);
+	}, 1);
+
+	for (const auto &range : ranges)
+	{
+		visible.insert(visible.end(), range.begin(), range.end());
+	}
+}
+
+template<std::size_t N>
+void FrustumCuller::Append(std::array<std::vector<float>, N> &arrays, const std::array<float, N> &values, const uint32_t &count)
+{
+	for (std::size_t i = 0; i < N; i++)
+	{
+		auto &array = arrays[i];
+		array.resize((count + 4) & ~3u);
+		array[count] = values[i];
+	}
+}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Frustum.hpp"
+
+namespace acid
+{
+/**
+ * @brief Bounding spheres and boxes kept in one array for each coordinate, tested against the planes of a frustum four objects at a time.
+ * Objects are given indices in the order they are added, culling writes the indices of those partially in the frustum in ascending order.
+ * Culls of many objects are split into ranges across the thread pool.
+ */
+class ACID_EXPORT FrustumCuller
+{
+public:
+	/// Culls of more objects than this are split across the thread pool, in ranges of this many objects.
+	static constexpr uint32_t ParallelGrain = 4096;
+
+	/**
+	 * Adds a bounding sphere.
+	 * @param centre The spheres centre.
+	 * @param radius The spheres radius.
+	 * @return The index of the sphere.
+	 */
+	uint32_t AddSphere(const Vector3f &centre, const float &radius);
+
+	/**
+	 * Adds a bounding box.
+	 * @param min The boxes min point.
+	 * @param max The boxes max point.
+	 * @return The index of the box.
+	 */
+	uint32_t AddCube(const Vector3f &min, const Vector3f &max);
+
+	/**
+	 * Removes every sphere and box, the arrays keep their capacity.
+	 */
+	void Clear();
+
+	uint32_t GetSphereCount() const { return m_sphereCount; }
+
+	uint32_t GetCubeCount() const { return m_cubeCount; }
+
+	/**
+	 * Finds the spheres partially in a frustum, the same test as {@link Frustum#SphereInFrustum}.
+	 * @param frustum The frustum.
+	 * @param visible The vector that is set to the indices of the visible spheres.
+	 */
+	void CullSpheres(const Frustum &frustum, std::vector<uint32_t> &visible) const;
+
+	/**
+	 * Finds the boxes partially in a frustum, the same test as {@link Frustum#CubeInFrustum}.
+	 * @param frustum The frustum.
+	 * @param visible The vector that is set to the indices of the visible boxes.
+	 */
+	void CullCubes(const Frustum &frustum, std::vector<uint32_t> &visible) const;
+
+	/**
+	 * Finds the spheres partially in a frustum from arrays of each coordinate, such as those of a {@link ParticleList}.
+	 * The arrays are read four values at a time, they must be padded to a multiple of four.
+	 * @param frustum The frustum.
+	 * @param x The x coordinates of the centres.
+	 * @param y The y coordinates of the centres.
+	 * @param z The z coordinates of the centres.
+	 * @param radius The radii.
+	 * @param radiusScale The factor each radius is multiplied by.
+	 * @param count The number of spheres.
+	 * @param visible The vector that is set to the indices of the visible spheres.
+	 */
+	static void CullSpheres(const Frustum &frustum, const float *x, const float *y, const float *z, const float *radius, const float &radiusScale, const uint32_t &count,
+		std::vector<uint32_t> &visible);
+
+	/**
+	 * Finds the boxes partially in a frustum from arrays of each coordinate, padded to a multiple of four.
+	 * @param frustum The frustum.
+	 * @param min The x, y and z arrays of the min points.
+	 * @param max The x, y and z arrays of the max points.
+	 * @param count The number of boxes.
+	 * @param visible The vector that is set to the indices of the visible boxes.
+	 */
+	static void CullCubes(const Frustum &frustum, const std::array<const float *, 3> &min, const std::array<const float *, 3> &max, const uint32_t &count,
+		std::vector<uint32_t> &visible);
+
+private:
+	/**
+	 * Runs a cull of four objects at a time over a range of objects, splitting large ranges across the thread pool.
+	 * @param count The number of objects.
+	 * @param visible The vector that is set to the indices of the visible objects.
+	 * @param cull Culls four objects from an index, returning a bit mask of those visible.
+	 */
+	template<typename F>
+	static void Cull(const uint32_t &count, std::vector<uint32_t> &visible, const F &cull);
+
+	/**
+	 * Appends a value to each array of coordinates, padding the arrays to a multiple of four.
+	 * @param arrays The arrays.
+	 * @param values The value added to each array.
+	 * @param count The number of values in each array before the value is added.
+	 */
+	template<std::size_t N>
+	static void Append(std::array<std::vector<float>, N> &arrays, const std::array<float, N> &values, const uint32_t &count);
+
+	uint32_t m_sphereCount = 0;
+	// The x, y and z of the centres and the radii.
+	std::array<std::vector<float>, 4> m_spheres;
+	uint32_t m_cubeCount = 0;
+	// The x, y and z of the min points and then of the max points.
+	std::array<std::vector<float>, 6> m_cubes;
+};
+}
@@ -2,7 +2,7 @@
 
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
-#include <BulletSoftBody/btSoftRigidDynamicsWorld.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 #include <BulletDynamics/Character/btKinematicCharacterController.h>
 #include "Scenes/Scenes.hpp"
 
@@ -29,7 +29,7 @@ KinematicCharacter::~KinematicCharacter()
 	{
 		// FIXME: Are these being deleted?
 		physics->GetDynamicsWorld()->removeCollisionObject(m_ghostObject.get());
-		physics->GetDynamicsWorld()->removeAction(m_controller.get());
+		physics->RemoveCharacter(this);
 	}
 }
 
@@ -42,7 +42,7 @@ void KinematicCharacter::Start()
 
 	if (m_controller != nullptr)
 	{
-		Scenes::Get()->GetPhysics()->GetDynamicsWorld()->removeAction(m_controller.get());
+		Scenes::Get()->GetPhysics()->RemoveCharacter(this);
 	}
 
 	CreateShape(true);
@@ -78,7 +78,8 @@ void KinematicCharacter::Start()
 	m_controller->setJumpSpeed(m_jumpSpeed);
 	m_controller->setMaxJumpHeight(m_maxHeight);
 	m_controller->setUpInterpolate(m_interpolate);
-	Scenes::Get()->GetPhysics()->GetDynamicsWorld()->addAction(m_controller.get());
+	m_controller->setWalkDirection(Collider::Convert(m_walkDirection));
+	Scenes::Get()->GetPhysics()->AddCharacter(this);
 }
 
 void KinematicCharacter::Update()
@@ -98,15 +99,10 @@ void KinematicCharacter::Update()
 
 bool KinematicCharacter::InFrustum(const Frustum &frustum)
 {
-	btVector3 min = btVector3();
-	btVector3 max = btVector3();
-
-	if (m_body != nullptr && m_shape != nullptr)
-	{
-		m_shape->getAabb(Collider::Convert(GetParent()->GetWorldTransform()), min, max);
-	}
-
-	return frustum.CubeInFrustum(Collider::Convert(min), Collider::Convert(max));
+	Vector3f min;
+	Vector3f max;
+	GetWorldAabb(min, max);
+	return frustum.CubeInFrustum(min, max);
 }
 
 void KinematicCharacter::ClearForces()
@@ -198,6 +194,7 @@ void KinematicCharacter::Jump(const Vector3f &direction)
 
 void KinematicCharacter::SetWalkDirection(const Vector3f &direction)
 {
+	m_walkDirection = direction;
 	m_controller->setWalkDirection(Collider::Convert(direction));
 }
 
@@ -231,6 +228,13 @@ Metadata &operator<<(Metadata &metadata, const KinematicCharacter &character)
 	return metadata;
 }
 
+float KinematicCharacter::GetReach(const float &delta) const
+{
+	// The walk direction is moved every step, vertical speed is clamped between the jump and fall speeds.
+	// Penetration recovery pushes the character by a fraction of its penetration each iteration, a small margin covers it.
+	return m_walkDirection.Length() + std::max(m_jumpSpeed, m_fallSpeed) * delta + m_stepHeight + 0.25f;
+}
+
 void KinematicCharacter::RecalculateMass()
 {
 	// TODO
@@ -83,12 +83,22 @@ protected:
 	void RecalculateMass() override;
 
 private:
+	friend class ScenePhysics;
+
+	/**
+	 * Gets how far the character can move in a step, including stepping up, jumping, falling and recovering from penetration.
+	 * @param delta The step time.
+	 * @return The distance.
+	 */
+	float GetReach(const float &delta) const;
+
 	Vector3f m_up;
 	float m_stepHeight;
 	float m_fallSpeed;
 	float m_jumpSpeed;
 	float m_maxHeight;
 	bool m_interpolate;
+	Vector3f m_walkDirection;
 
 	std::unique_ptr<btPairCachingGhostObject> m_ghostObject;
 	std::unique_ptr<btKinematicCharacterController> m_controller;
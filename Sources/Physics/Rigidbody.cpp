@@ -13,6 +13,11 @@ namespace acid
 {
 Rigidbody::Rigidbody(const float &mass, const float &friction, const Vector3f &linearFactor, const Vector3f &angularFactor) :
 	CollisionObject(mass, friction, linearFactor, angularFactor),
+	m_interpolate(true),
+	m_continuous(false),
+	m_linearSleeping(0.8f),
+	m_angularSleeping(1.0f),
+	m_sleeping(Sleeping::Island),
 	m_rigidBody(nullptr)
 {
 }
@@ -53,6 +58,10 @@ void Rigidbody::Start()
 	}
 
 	auto worldTransform = Collider::Convert(GetParent()->GetWorldTransform());
+	m_currentPosition = Collider::Convert(worldTransform.getOrigin());
+	m_currentRotation = Collider::Convert(worldTransform.getRotation());
+	m_previousPosition = m_currentPosition;
+	m_previousRotation = m_currentRotation;
 
 	// Using motionstate is recommended, it provides interpolation capabilities, and only synchronizes 'active' objects.
 	auto motionState = new btDefaultMotionState(worldTransform);
@@ -70,6 +79,8 @@ void Rigidbody::Start()
 	m_rigidBody->setAngularFactor(Collider::Convert(m_angularFactor));
 	m_rigidBody->setUserPointer(this);
 	m_body = m_rigidBody.get();
+	UpdateContinuous();
+	UpdateSleeping();
 	Scenes::Get()->GetPhysics()->GetDynamicsWorld()->addRigidBody(m_rigidBody.get());
 	m_rigidBody->activate(true);
 	RecalculateMass();
@@ -80,6 +91,7 @@ void Rigidbody::Update()
 	if (m_shape.get() != m_body->getCollisionShape())
 	{
 		m_body->setCollisionShape(m_shape.get());
+		UpdateContinuous();
 	}
 
 	for (auto it = m_forces.begin(); it != m_forces.end();)
@@ -101,23 +113,37 @@ void Rigidbody::Update()
 	m_rigidBody->getMotionState()->getWorldTransform(motionTransform);
 	transform = Collider::Convert(motionTransform, transform.GetScaling());
 
-	m_shape->setLocalScaling(Collider::Convert(transform.GetScaling()));
+	m_previousPosition = m_currentPosition;
+	m_previousRotation = m_currentRotation;
+	m_currentPosition = Collider::Convert(motionTransform.getOrigin());
+	m_currentRotation = Collider::Convert(motionTransform.getRotation());
+
+	SetScaling(transform.GetScaling());
 	//m_rigidBody->getMotionState()->setWorldTransform(Collider::Convert(transform));
 	m_linearVelocity = Collider::Convert(m_rigidBody->getLinearVelocity());
 	m_angularVelocity = Collider::Convert(m_rigidBody->getAngularVelocity());
 }
 
-bool Rigidbody::InFrustum(const Frustum &frustum)
+void Rigidbody::Interpolate(const float &alpha)
 {
-	btVector3 min = btVector3();
-	btVector3 max = btVector3();
-
-	if (m_body != nullptr && m_shape != nullptr)
+	// Static bodies never move, and the body itself is not read since a multithreaded world may be stepping it.
+	if (!m_interpolate || m_rigidBody == nullptr || m_mass == 0.0f)
 	{
-		m_rigidBody->getAabb(min, max);
+		return;
 	}
 
-	return frustum.CubeInFrustum(Collider::Convert(min), Collider::Convert(max));
+	btTransform interpolated(Collider::Convert(m_previousRotation.Slerp(m_currentRotation, alpha)),
+		Collider::Convert(m_previousPosition.Lerp(m_currentPosition, alpha)));
+	auto &transform = GetParent()->GetLocalTransform();
+	transform = Collider::Convert(interpolated, transform.GetScaling());
+}
+
+bool Rigidbody::InFrustum(const Frustum &frustum)
+{
+	Vector3f min;
+	Vector3f max;
+	GetWorldAabb(min, max);
+	return frustum.CubeInFrustum(min, max);
 }
 
 void Rigidbody::ClearForces()
@@ -161,6 +187,30 @@ void Rigidbody::SetAngularVelocity(const Vector3f &angularVelocity)
 	m_rigidBody->setAngularVelocity(Collider::Convert(m_angularVelocity));
 }
 
+void Rigidbody::SetContinuous(const bool &continuous)
+{
+	m_continuous = continuous;
+	UpdateContinuous();
+}
+
+void Rigidbody::SetLinearSleeping(const float &linearSleeping)
+{
+	m_linearSleeping = linearSleeping;
+	UpdateSleeping();
+}
+
+void Rigidbody::SetAngularSleeping(const float &angularSleeping)
+{
+	m_angularSleeping = angularSleeping;
+	UpdateSleeping();
+}
+
+void Rigidbody::SetSleeping(const Sleeping &sleeping)
+{
+	m_sleeping = sleeping;
+	UpdateSleeping();
+}
+
 const Metadata &operator>>(const Metadata &metadata, Rigidbody &rigidbody)
 {
 	metadata.GetChild("Mass", rigidbody.m_mass);
@@ -169,6 +219,11 @@ const Metadata &operator>>(const Metadata &metadata, Rigidbody &rigidbody)
 	metadata.GetChild("Friction Spinning", rigidbody.m_frictionSpinning);
 	metadata.GetChild("Linear Factor", rigidbody.m_linearFactor);
 	metadata.GetChild("Angular Factor", rigidbody.m_angularFactor);
+	metadata.GetChild("Interpolate", rigidbody.m_interpolate);
+	metadata.GetChild("Continuous", rigidbody.m_continuous);
+	metadata.GetChild("Linear Sleeping", rigidbody.m_linearSleeping);
+	metadata.GetChild("Angular Sleeping", rigidbody.m_angularSleeping);
+	metadata.GetChild("Sleeping", rigidbody.m_sleeping);
 	return metadata;
 }
 
@@ -180,6 +235,11 @@ Metadata &operator<<(Metadata &metadata, const Rigidbody &rigidbody)
 	metadata.SetChild("Friction Spinning", rigidbody.m_frictionSpinning);
 	metadata.SetChild("Linear Factor", rigidbody.m_linearFactor);
 	metadata.SetChild("Angular Factor", rigidbody.m_angularFactor);
+	metadata.SetChild("Interpolate", rigidbody.m_interpolate);
+	metadata.SetChild("Continuous", rigidbody.m_continuous);
+	metadata.SetChild("Linear Sleeping", rigidbody.m_linearSleeping);
+	metadata.SetChild("Angular Sleeping", rigidbody.m_angularSleeping);
+	metadata.SetChild("Sleeping", rigidbody.m_sleeping);
 	return metadata;
 }
 
@@ -203,4 +263,56 @@ void Rigidbody::RecalculateMass()
 
 	m_rigidBody->setMassProps(m_mass, localInertia);
 }
+
+void Rigidbody::UpdateContinuous()
+{
+	if (m_rigidBody == nullptr)
+	{
+		return;
+	}
+
+	// Static bodies never move, so they never need to be swept.
+	if (!m_continuous || m_mass == 0.0f || m_shape == nullptr)
+	{
+		m_rigidBody->setCcdMotionThreshold(0.0f);
+		m_rigidBody->setCcdSweptSphereRadius(0.0f);
+		return;
+	}
+
+	btTransform identity;
+	identity.setIdentity();
+	btVector3 min;
+	btVector3 max;
+	m_shape->getAabb(identity, min, max);
+	auto halfExtent = 0.5f * (max - min);
+	auto innerRadius = std::min({halfExtent.x(), halfExtent.y(), halfExtent.z()});
+
+	// A body that moves less than its own inner radius in a step cannot pass through anything, so only faster steps are swept.
+	// The swept sphere sits a little inside the shape so resting contacts are left to the discrete collision.
+	m_rigidBody->setCcdMotionThreshold(innerRadius);
+	m_rigidBody->setCcdSweptSphereRadius(0.8f * innerRadius);
+}
+
+void Rigidbody::UpdateSleeping()
+{
+	if (m_rigidBody == nullptr)
+	{
+		return;
+	}
+
+	m_rigidBody->setSleepingThresholds(m_linearSleeping, m_angularSleeping);
+
+	switch (m_sleeping)
+	{
+	case Sleeping::Island:
+		if (m_rigidBody->getActivationState() == DISABLE_DEACTIVATION)
+		{
+			m_rigidBody->forceActivationState(ACTIVE_TAG);
+		}
+		break;
+	case Sleeping::Never:
+		m_rigidBody->forceActivationState(DISABLE_DEACTIVATION);
+		break;
+	}
+}
 }
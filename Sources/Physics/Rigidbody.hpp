@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "Maths/Quaternion.hpp"
 #include "Maths/Vector3.hpp"
 #include "Scenes/Entity.hpp"
 #include "CollisionObject.hpp"
@@ -16,6 +17,17 @@ class ACID_EXPORT Rigidbody :
 	public CollisionObject
 {
 public:
+	/**
+	 * @brief When a body is put to sleep, a sleeping body is not simulated until something touches it.
+	 */
+	enum class Sleeping
+	{
+		/// The body sleeps with its simulation island, once every body in the island has stayed under its thresholds for the {@link ScenePhysics#GetDeactivationTime}.
+		Island,
+		/// The body is never put to sleep, for bodies that are moved by forces every update such as vehicles.
+		Never
+	};
+
 	/**
 	 * Creates a new rigidbody.
 	 * @param mass The mass of the object.
@@ -31,6 +43,12 @@ public:
 
 	void Update() override;
 
+	/**
+	 * Moves the entity between the body transforms of the last two steps, called before the scene is rendered.
+	 * @param alpha How far rendering is between the last and next update, from zero to one.
+	 */
+	void Interpolate(const float &alpha);
+
 	bool InFrustum(const Frustum &frustum) override;
 
 	void ClearForces() override;
@@ -47,6 +65,44 @@ public:
 
 	void SetAngularVelocity(const Vector3f &angularVelocity) override;
 
+	const bool &IsInterpolate() const { return m_interpolate; }
+
+	/**
+	 * Sets if the entity is rendered between the body transforms of the last two updates, instead of jumping to each new transform.
+	 * Rendering is then up to one update behind the simulation, but moves smoothly when the frame rate is not a multiple of the update rate.
+	 * @param interpolate If the body is interpolated.
+	 */
+	void SetInterpolate(const bool &interpolate) { m_interpolate = interpolate; }
+
+	const bool &IsContinuous() const { return m_continuous; }
+
+	/**
+	 * Sets if the body uses continuous collision detection, a sphere swept along its motion so it cannot pass through thin objects in a single step.
+	 * The sphere radius and the speed it is swept above are taken from the bounds of the colliders, so slow bodies do not pay for the sweep.
+	 * @param continuous If continuous collision detection is used.
+	 */
+	void SetContinuous(const bool &continuous);
+
+	const float &GetLinearSleeping() const { return m_linearSleeping; }
+
+	/**
+	 * Sets the linear speed the body has to stay under to be put to sleep.
+	 * @param linearSleeping The linear speed threshold.
+	 */
+	void SetLinearSleeping(const float &linearSleeping);
+
+	const float &GetAngularSleeping() const { return m_angularSleeping; }
+
+	/**
+	 * Sets the angular speed the body has to stay under to be put to sleep.
+	 * @param angularSleeping The angular speed threshold, in radians per second.
+	 */
+	void SetAngularSleeping(const float &angularSleeping);
+
+	const Sleeping &GetSleeping() const { return m_sleeping; }
+
+	void SetSleeping(const Sleeping &sleeping);
+
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Rigidbody &rigidbody);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Rigidbody &rigidbody);
@@ -55,6 +111,22 @@ protected:
 	void RecalculateMass() override;
 
 private:
+	void UpdateContinuous();
+
+	void UpdateSleeping();
+
+	bool m_interpolate;
+	bool m_continuous;
+	float m_linearSleeping;
+	float m_angularSleeping;
+	Sleeping m_sleeping;
+
+	// The body transform after the previous and the last update.
+	Vector3f m_previousPosition;
+	Quaternion m_previousRotation;
+	Vector3f m_currentPosition;
+	Quaternion m_currentRotation;
+
 	std::unique_ptr<btRigidBody> m_rigidBody;
 };
 }
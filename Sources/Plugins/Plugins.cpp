@@ -0,0 +1,197 @@
+#include "Plugins.hpp"
+
+#define CR_HOST CR_SAFE
+
+#include "Engine/cr.h"
+#include "Files/FileSystem.hpp"
+#include "Scenes/Scenes.hpp"
+
+namespace acid
+{
+// Polled watchers check this often, so a rebuilt plugin is reloaded within a second either way.
+static const Time POLL_DELAY = Time::Seconds(0.5f);
+
+Plugins::Plugins() :
+	m_changed(false),
+	m_reloading(false)
+{
+}
+
+Plugins::~Plugins()
+{
+	Close();
+}
+
+void Plugins::Update()
+{
+	if (m_plugin == nullptr)
+	{
+		return;
+	}
+
+	// A version that crashed while loading is rolled back by the next update, a library still being written is retried.
+	if (m_plugin->failure != CR_NONE)
+	{
+		Log::Warning("Plugin '%s' version %u failed to load: %s\n", m_filename.c_str(), m_plugin->version, GetFailureName(m_plugin->failure).c_str());
+		cr_plugin_update(*m_plugin, false);
+		RestoreScene();
+		return;
+	}
+
+	RestoreScene();
+
+	if (m_changed.exchange(false) && cr_plugin_changed(*m_plugin))
+	{
+		Reload();
+	}
+}
+
+bool Plugins::Load(const std::string &filename)
+{
+	Close();
+
+	if (!FileSystem::Exists(filename))
+	{
+		Log::Error("Plugin could not be found: '%s'\n", filename.c_str());
+		return false;
+	}
+
+	m_filename = filename;
+	m_plugin = std::make_unique<cr_plugin>();
+	cr_plugin_load(*m_plugin, m_filename.c_str());
+
+	m_watcher = std::make_unique<FileWatcher>(FileSystem::ParentDirectory(m_filename), POLL_DELAY);
+	m_watcher->OnChange().Add([this](std::string path, FileWatcher::Status status)
+	{
+		if (status != FileWatcher::Status::Erased && FileSystem::FileName(path) == FileSystem::FileName(m_filename))
+		{
+			m_changed = true;
+		}
+	});
+
+	if (cr_plugin_update(*m_plugin) < 0)
+	{
+		Log::Error("Plugin '%s' failed to load: %s\n", m_filename.c_str(), GetFailureName(m_plugin->failure).c_str());
+		return false;
+	}
+
+	Log::Out("Loaded plugin '%s'\n", m_filename.c_str());
+	return true;
+}
+
+void Plugins::Close()
+{
+	if (m_plugin == nullptr)
+	{
+		return;
+	}
+
+	m_watcher = nullptr;
+	m_onUnload();
+
+	// The game and scene are destroyed while the code of their destructors is still loaded.
+	if (Engine::Get()->HasModule<Scenes>())
+	{
+		Scenes::Get()->SetScene(nullptr);
+	}
+
+	Engine::Get()->SetGame(nullptr);
+
+	cr_plugin_close(*m_plugin);
+	m_plugin = nullptr;
+	m_reloading = false;
+	m_sceneState = nullptr;
+	m_filename.clear();
+}
+
+uint32_t Plugins::GetVersion() const
+{
+	return m_plugin != nullptr ? m_plugin->version : 0;
+}
+
+void Plugins::Reload()
+{
+	auto start = Engine::GetTime();
+
+	if (Engine::Get()->HasModule<Scenes>())
+	{
+		if (auto structure = Scenes::Get()->GetStructure())
+		{
+			m_sceneState = std::make_unique<Metadata>();
+			*m_sceneState << *structure;
+		}
+	}
+
+	m_onUnload();
+
+	if (Engine::Get()->HasModule<Scenes>())
+	{
+		Scenes::Get()->SetScene(nullptr);
+	}
+
+	Engine::Get()->SetGame(nullptr);
+	m_reloading = true;
+
+	if (cr_plugin_update(*m_plugin) < 0)
+	{
+		// The next update rolls back to the previous version, which restores the same entities.
+		return;
+	}
+
+	Log::Out("Reloaded plugin '%s' version %u in %.1fms\n", m_filename.c_str(), m_plugin->version, (Engine::GetTime() - start).AsMilliseconds<float>());
+}
+
+void Plugins::RestoreScene()
+{
+	if (!m_reloading || m_plugin->failure != CR_NONE)
+	{
+		return;
+	}
+
+	if (m_sceneState != nullptr && Engine::Get()->HasModule<Scenes>())
+	{
+		auto scene = Scenes::Get()->GetScene();
+
+		// Entities the scene spawned when started are replaced, so the restored entities continue from where the last version stopped.
+		if (scene == nullptr || !scene->IsStarted() || scene->GetStructure() == nullptr)
+		{
+			return;
+		}
+
+		*m_sceneState >> *scene->GetStructure();
+	}
+
+	m_reloading = false;
+	m_sceneState = nullptr;
+	m_onReload(m_plugin->version);
+}
+
+std::string Plugins::GetFailureName(const int32_t &failure)
+{
+	switch (failure)
+	{
+	case CR_NONE:
+		return "None";
+	case CR_SEGFAULT:
+		return "Segmentation fault";
+	case CR_ILLEGAL:
+		return "Illegal instruction";
+	case CR_ABORT:
+		return "Abort";
+	case CR_MISALIGN:
+		return "Misaligned access";
+	case CR_BOUNDS:
+		return "Array bounds exceeded";
+	case CR_STACKOVERFLOW:
+		return "Stack overflow";
+	case CR_STATE_INVALIDATED:
+		return "Static state invalidated";
+	case CR_BAD_IMAGE:
+		return "Library is still being written";
+	case CR_USER:
+		return "Plugin returned an error";
+	default:
+		return "Unknown";
+	}
+}
+}
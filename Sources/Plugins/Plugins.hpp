@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Engine/Engine.hpp"
+#include "Files/FileWatcher.hpp"
+#include "Helpers/Delegate.hpp"
+#include "Serialized/Metadata.hpp"
+
+struct cr_plugin;
+
+namespace acid
+{
+/**
+ * @brief Module that loads gameplay code from a shared library built with cr.h, and reloads it when the library is rebuilt.
+ * Before a reload the entities of the current scene are encoded, then the game and scene are destroyed while their code is still loaded.
+ * Once the reloaded plugin has set and started a new scene, its entities are replaced with the encoded entities, so the reload keeps the world as it was.
+ * Resources are kept by {@link Resources} and are not reloaded. If loading a version crashes, the previous version is loaded again with the same entities.
+ * Crashes are only caught while the plugin is loaded or unloaded, the game updated by the engine is not protected.
+ * The plugin must remove the component types it registered when it is unloaded, as their functions are in the plugins code.
+ */
+class ACID_EXPORT Plugins :
+	public Module
+{
+public:
+	/**
+	 * Gets the engines instance.
+	 * @return The current module instance.
+	 */
+	static Plugins *Get() { return Engine::Get()->GetModule<Plugins>(); }
+
+	Plugins();
+
+	~Plugins();
+
+	void Update() override;
+
+	/**
+	 * Loads a plugin, a previously loaded plugin is closed first.
+	 * @param filename The path to the shared library, such as the path given by CR_PLUGIN.
+	 * @return If the first version of the plugin was loaded.
+	 */
+	bool Load(const std::string &filename);
+
+	/**
+	 * Destroys the game and scene, then unloads the plugin.
+	 */
+	void Close();
+
+	bool IsLoaded() const { return m_plugin != nullptr; }
+
+	const std::string &GetFilename() const { return m_filename; }
+
+	/**
+	 * Gets the version of the loaded plugin, the first load is version 1 and each reload adds one.
+	 * @return The plugin version, 0 if no plugin is loaded.
+	 */
+	uint32_t GetVersion() const;
+
+	/**
+	 * Called before the plugin is unloaded, objects created by the plugin that are not owned by the game or scene must be destroyed here.
+	 * @return The delegate.
+	 */
+	Delegate<void()> &OnUnload() { return m_onUnload; }
+
+	/**
+	 * Called once a reloaded plugin has started its scene and the scenes entities have been restored, or once it is loaded if there was no scene.
+	 * @return The delegate, with the version that was loaded.
+	 */
+	Delegate<void(uint32_t)> &OnReload() { return m_onReload; }
+
+private:
+	void Reload();
+
+	/**
+	 * Restores the encoded entities once the reloaded plugin has started a scene, then calls {@link Plugins#OnReload}.
+	 */
+	void RestoreScene();
+
+	static std::string GetFailureName(const int32_t &failure);
+
+	std::string m_filename;
+	std::unique_ptr<cr_plugin> m_plugin;
+	std::unique_ptr<FileWatcher> m_watcher;
+	std::atomic<bool> m_changed;
+
+	bool m_reloading;
+	std::unique_ptr<Metadata> m_sceneState;
+
+	Delegate<void()> m_onUnload;
+	Delegate<void(uint32_t)> m_onReload;
+};
+}
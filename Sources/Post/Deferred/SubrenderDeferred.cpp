@@ -1,5 +1,7 @@
 #include "SubrenderDeferred.hpp"
 
+#include <fstream>
+#include <iomanip>
 #include "Files/FileSystem.hpp"
 #include "Lights/Light.hpp"
 #include "Models/VertexDefault.hpp"
@@ -12,14 +14,37 @@
 
 namespace acid
 {
-static const uint32_t MAX_LIGHTS = 32; // TODO: Make configurable.
+static const uint32_t CLUSTERS_X = 16;
+static const uint32_t CLUSTERS_Y = 9;
+static const uint32_t CLUSTERS_Z = 24;
+static const uint32_t CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+static const uint32_t MAX_CLUSTER_LIGHTS = 128;
+static const uint32_t MIN_LIGHTS = 64;
+static const uint32_t IRRADIANCE_SIZE = 64;
+static const uint32_t PREFILTERED_SIZE = 512;
+static const int32_t FACE_COUNT = 6;
+const std::string IBL_CACHE_DIRECTORY = "Cache/Lighting/";
+// Increment when the cache layout, the precompute shaders, or the image formats change.
+const uint32_t IBL_CACHE_VERSION = 1;
 
 SubrenderDeferred::SubrenderDeferred(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
-	m_pipeline(pipelineStage, { "Shaders/Deferred/Deferred.vert", "Shaders/Deferred/Deferred.frag" }, {}, GetDefines(), PipelineGraphics::Mode::Polygon,
-		PipelineGraphics::Depth::None),
+	m_compact(Graphics::Get()->GetRenderStage(pipelineStage.first) != nullptr && Graphics::Get()->GetRenderStage(pipelineStage.first)->IsCompactGBuffer()),
+	m_inputAttachments(IsInputAttachments(pipelineStage, m_compact)),
+	// Input attachments are read at the rate of each fragment, so coarse shading rates are only used when the G-buffer is sampled.
+	m_pipeline(pipelineStage, { "Shaders/Deferred/Deferred.vert", "Shaders/Deferred/Deferred.frag" }, {},
+		GetDefines(m_inputAttachments, Graphics::Get()->GetLogicalDevice()->IsRayQuery()), PipelineGraphics::Mode::Polygon,
+		PipelineGraphics::Depth::None, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_CLOCKWISE, false,
+		!m_inputAttachments),
+	m_pipelineClusters("Shaders/Deferred/Clusters.comp", GetDefines()),
+	m_shadowStructure(Graphics::Get()->GetLogicalDevice()->IsRayQuery() ? std::make_unique<ShadowAccelerationStructure>() : nullptr),
 	m_brdf(Resources::Get()->GetThreadPool().Enqueue(ComputeBRDF, 512)),
 	m_skybox(nullptr),
+	m_pipelineIrradiance("Shaders/Irradiance.comp"),
+	m_descriptorIrradiance(m_pipelineIrradiance),
+	m_pipelinePrefiltered("Shaders/Prefiltered.comp"),
+	m_descriptorPrefiltered(m_pipelinePrefiltered),
+	m_environmentSteps(1),
 	m_fog(Colour::White, 0.001f, 2.0f, -0.1f, 0.3f)
 {
 	//auto metadata = Metadata();
@@ -27,6 +52,32 @@ SubrenderDeferred::SubrenderDeferred(const Pipeline::Stage &pipelineStage) :
 	//File("Shaders/Deferred.yaml", new Yaml(&metadata)).Write();
 }
 
+bool SubrenderDeferred::RenderCompute(const CommandBuffer &commandBuffer)
+{
+	auto framesInFlight = Graphics::Get()->GetFramesInFlight();
+
+	if (m_frames.size() > framesInFlight)
+	{
+		m_frames.resize(framesInFlight);
+	}
+
+	while (m_frames.size() < framesInFlight)
+	{
+		auto &frame = m_frames.emplace_back(std::make_unique<ClusterFrame>());
+		frame->m_lightBuffer = std::make_unique<StorageBuffer>(sizeof(DeferredLight) * MIN_LIGHTS);
+		frame->m_clusterBuffer = std::make_unique<StorageBuffer>(sizeof(uint32_t) * CLUSTER_COUNT * (1 + MAX_CLUSTER_LIGHTS), nullptr,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	}
+
+	auto &frame = *m_frames[Graphics::Get()->GetCurrentFrame()];
+	auto environment = CmdEnvironment(commandBuffer);
+	frame.m_ready = CmdClusters(commandBuffer, frame);
+
+	// The top level is still built while shadows are not traced, empty, so the lighting pipeline always has one bound.
+	auto shadowStructure = m_shadowStructure != nullptr && m_shadowStructure->CmdBuild(commandBuffer, Shadows::Get()->IsRayTraced());
+	return frame.m_ready || environment || shadowStructure;
+}
+
 void SubrenderDeferred::Render(const CommandBuffer &commandBuffer)
 {
 	auto camera = Scenes::Get()->GetCamera();
@@ -34,69 +85,112 @@ void SubrenderDeferred::Render(const CommandBuffer &commandBuffer)
 	auto materialSkybox = Scenes::Get()->GetStructure()->GetComponent<MaterialSkybox>();
 	auto skybox = (materialSkybox == nullptr) ? nullptr : materialSkybox->GetImage();
 
+	// The lighting of a new skybox is refined by the compute passes of the next frames, a skybox changed again before it finished is dropped.
 	if (m_skybox != skybox)
 	{
 		m_skybox = skybox;
-		m_irradiance = Resources::Get()->GetThreadPool().Enqueue(ComputeIrradiance, m_skybox, 64);
-		m_prefiltered = Resources::Get()->GetThreadPool().Enqueue(ComputePrefiltered, m_skybox, 512);
-	}
 
-	// Updates uniforms.
-	std::vector<DeferredLight> deferredLights(MAX_LIGHTS);
-	uint32_t lightCount = 0;
+		if (m_environmentNext != nullptr)
+		{
+			m_environmentsRetired.emplace_back(Graphics::Get()->GetFrameCount(), std::move(m_environmentNext));
+		}
 
-	auto sceneLights = Scenes::Get()->GetStructure()->QueryComponents<Light>();
+		if (m_skybox == nullptr)
+		{
+			SetEnvironment(nullptr);
+		}
+		else
+		{
+			m_environmentNext = CreateEnvironment(m_skybox);
+		}
+	}
 
-	for (const auto &light : sceneLights)
-	{
-		//auto position = *light->GetPosition();
-		//float radius = light->GetRadius();
+	// Until the first skybox has been refined its partly refined images are used, afterwards the last completed lighting is.
+	auto environment = m_environment.get();
 
-		//if (radius >= 0.0f && !camera.GetViewFrustum()->SphereInFrustum(position, radius))
-		//{
-		//	continue;
-		//}
+	if (environment == nullptr && m_environmentNext != nullptr && !m_environmentNext->m_cached.valid())
+	{
+		environment = m_environmentNext.get();
+	}
 
-		DeferredLight deferredLight = {};
-		deferredLight.m_colour = light->GetColour();
-		deferredLight.m_position = light->GetParent()->GetWorldTransform().GetPosition();
-		deferredLight.m_radius = light->GetRadius();
-		deferredLights[lightCount] = deferredLight;
-		lightCount++;
+	// Multiview stages light each view with its own matrices, the camera position is shared by every view.
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+	auto viewCount = renderStage != nullptr ? renderStage->GetViewCount() : 1;
+	m_views.resize(viewCount);
+	m_invViewProjections.resize(viewCount);
 
-		if (lightCount >= MAX_LIGHTS)
-		{
-			break;
-		}
+	for (uint32_t i = 0; i < viewCount; i++)
+	{
+		m_views[i] = viewCount > 1 ? camera->GetViewMatrix(i) : camera->GetViewMatrix();
+		m_invViewProjections[i] = ((viewCount > 1 ? camera->GetProjectionMatrix(i) : camera->GetProjectionMatrix()) * m_views[i]).Inverse();
 	}
 
 	// Updates uniforms.
-	m_uniformScene.Push("view", camera->GetViewMatrix());
-	m_uniformScene.Push("shadowSpace", Shadows::Get()->GetShadowBox().GetToShadowMapSpaceMatrix());
+	m_uniformScene.Push("view", *m_views.data(), sizeof(Matrix4) * viewCount);
+	m_uniformScene.Push("shadowSpace", Shadows::Get()->GetCascadeShadowSpace(0));
+	m_uniformScene.Push("invViewProjection", *m_invViewProjections.data(), sizeof(Matrix4) * viewCount);
 	m_uniformScene.Push("cameraPosition", camera->GetPosition());
-	m_uniformScene.Push("lightsCount", lightCount);
+	m_uniformScene.Push("nearPlane", camera->GetNearPlane());
+	m_uniformScene.Push("farPlane", camera->GetFarPlane());
 	m_uniformScene.Push("fogColour", m_fog.GetColour());
 	m_uniformScene.Push("fogDensity", m_fog.GetDensity());
 	m_uniformScene.Push("fogGradient", m_fog.GetGradient());
 
-	// Updates storage buffers.
-	m_storageLights.Push(deferredLights.data(), sizeof(DeferredLight) * MAX_LIGHTS);
+	if (m_shadowStructure != nullptr)
+	{
+		m_uniformScene.Push("rayShadows", static_cast<int32_t>(Shadows::Get()->IsRayTraced()));
+	}
+
+	auto currentFrame = Graphics::Get()->GetCurrentFrame();
+
+	if (currentFrame >= m_frames.size())
+	{
+		return;
+	}
+
+	auto &frame = *m_frames[currentFrame];
+	auto &descriptorSet = frame.m_descriptorSet;
 
 	// Updates descriptors.
-	m_descriptorSet.Push("UniformScene", m_uniformScene);
-	m_descriptorSet.Push("BufferLights", m_storageLights);
-	m_descriptorSet.Push("samplerShadows", Graphics::Get()->GetAttachment("shadows"));
-	m_descriptorSet.Push("samplerPosition", Graphics::Get()->GetAttachment("position"));
-	m_descriptorSet.Push("samplerDiffuse", Graphics::Get()->GetAttachment("diffuse"));
-	m_descriptorSet.Push("samplerNormal", Graphics::Get()->GetAttachment("normal"));
-	m_descriptorSet.Push("samplerMaterial", Graphics::Get()->GetAttachment("material"));
-	m_descriptorSet.Push("samplerBRDF", *m_brdf);
-	m_descriptorSet.Push("samplerIrradiance", *m_irradiance);
-	m_descriptorSet.Push("samplerPrefiltered", *m_prefiltered);
+	descriptorSet.Push("UniformScene", m_uniformScene);
+	descriptorSet.Push("BufferLights", frame.m_lightBuffer);
+	descriptorSet.Push("BufferClusters", frame.m_clusterBuffer);
+	descriptorSet.Push("samplerShadows", Graphics::Get()->GetAttachment("shadows"));
+
+	if (m_shadowStructure != nullptr)
+	{
+		descriptorSet.Push("sceneStructure", m_shadowStructure->GetTopLevel());
+	}
+
+	if (m_compact)
+	{
+		descriptorSet.Push("samplerDepth", Graphics::Get()->GetAttachment("depth"));
+		descriptorSet.Push(m_inputAttachments ? "inputDiffuse" : "samplerDiffuse", Graphics::Get()->GetAttachment("diffuse", m_inputAttachments));
+		descriptorSet.Push(m_inputAttachments ? "inputNormal" : "samplerNormal", Graphics::Get()->GetAttachment("normal", m_inputAttachments));
+	}
+	else if (m_inputAttachments)
+	{
+		descriptorSet.Push("inputPosition", Graphics::Get()->GetAttachment("position", true));
+		descriptorSet.Push("inputDiffuse", Graphics::Get()->GetAttachment("diffuse", true));
+		descriptorSet.Push("inputNormal", Graphics::Get()->GetAttachment("normal", true));
+		descriptorSet.Push("inputMaterial", Graphics::Get()->GetAttachment("material", true));
+	}
+	else
+	{
+		descriptorSet.Push("samplerPosition", Graphics::Get()->GetAttachment("position"));
+		descriptorSet.Push("samplerDiffuse", Graphics::Get()->GetAttachment("diffuse"));
+		descriptorSet.Push("samplerNormal", Graphics::Get()->GetAttachment("normal"));
+		descriptorSet.Push("samplerMaterial", Graphics::Get()->GetAttachment("material"));
+	}
+
+	descriptorSet.Push("samplerBRDF", *m_brdf);
+	descriptorSet.Push("samplerIrradiance", environment != nullptr ? environment->m_irradiance : nullptr);
+	descriptorSet.Push("samplerPrefiltered", environment != nullptr ? environment->m_prefiltered : nullptr);
 
-	bool updateSuccess = m_descriptorSet.Update(m_pipeline);
+	bool updateSuccess = descriptorSet.Update(m_pipeline);
 
-	if (!updateSuccess)
+	// The cluster lists are written by this frames culling pass.
+	if (!updateSuccess || !frame.m_ready)
 	{
 		return;
 	}
@@ -104,20 +198,301 @@ void SubrenderDeferred::Render(const CommandBuffer &commandBuffer)
 	// Draws the object.
 	m_pipeline.BindPipeline(commandBuffer);
 
-	m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+	descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
 	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
 }
 
-std::vector<Shader::Define> SubrenderDeferred::GetDefines()
+std::vector<Shader::Define> SubrenderDeferred::GetDefines(const bool &inputAttachments, const bool &rayQuery)
 {
 	std::vector<Shader::Define> defines;
-	defines.emplace_back("MAX_LIGHTS", String::To(MAX_LIGHTS));
+	defines.emplace_back("CLUSTERS_X", String::To(CLUSTERS_X) + "u");
+	defines.emplace_back("CLUSTERS_Y", String::To(CLUSTERS_Y) + "u");
+	defines.emplace_back("CLUSTERS_Z", String::To(CLUSTERS_Z) + "u");
+	defines.emplace_back("MAX_CLUSTER_LIGHTS", String::To(MAX_CLUSTER_LIGHTS) + "u");
+
+	if (inputAttachments)
+	{
+		defines.emplace_back("INPUT_ATTACHMENTS", "1");
+	}
+
+	if (rayQuery)
+	{
+		defines.emplace_back("RAY_QUERY", "1");
+	}
+
 	return defines;
 }
 
+bool SubrenderDeferred::IsInputAttachments(const Pipeline::Stage &pipelineStage, const bool &compact)
+{
+	auto renderStage = Graphics::Get()->GetRenderStage(pipelineStage.first);
+
+	if (renderStage == nullptr || pipelineStage.second >= renderStage->GetSubpasses().size())
+	{
+		return false;
+	}
+
+	static const std::vector<std::string> full = { "position", "diffuse", "normal", "material" };
+	static const std::vector<std::string> packed = { "diffuse", "normal" };
+	auto &names = compact ? packed : full;
+	auto &inputBindings = renderStage->GetSubpasses()[pipelineStage.second].GetInputAttachmentBindings();
+
+	if (inputBindings.empty())
+	{
+		return false;
+	}
+
+	if (inputBindings.size() != names.size())
+	{
+		Log::Warning("Deferred subpass input attachments must be the G-buffer in order, sampling it instead\n");
+		return false;
+	}
+
+	for (std::size_t i = 0; i < names.size(); i++)
+	{
+		auto attachment = renderStage->GetAttachment(inputBindings[i]);
+
+		if (!attachment || attachment->GetName() != names[i])
+		{
+			Log::Warning("Deferred subpass input attachments must be the G-buffer in order, sampling it instead\n");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool SubrenderDeferred::CmdClusters(const CommandBuffer &commandBuffer, ClusterFrame &frame)
+{
+	auto camera = Scenes::Get()->GetCamera();
+
+	// The selection is culled and ordered from the most important light, so a cluster that is full keeps the lights that matter most.
+	m_lights.clear();
+
+	for (const auto &light : Scenes::Get()->GetScene()->GetLightSelection().GetLights())
+	{
+		DeferredLight deferredLight = {};
+		deferredLight.m_colour = light->GetColour();
+		deferredLight.m_position = light->GetParent()->GetWorldTransform().GetPosition();
+		deferredLight.m_radius = light->GetRadius();
+		m_lights.emplace_back(deferredLight);
+	}
+
+	if (frame.m_lightBuffer->GetSize() < sizeof(DeferredLight) * m_lights.size())
+	{
+		frame.m_lightBuffer = std::make_unique<StorageBuffer>(sizeof(DeferredLight) * std::max(2 * static_cast<uint32_t>(m_lights.size()), MIN_LIGHTS));
+	}
+
+	m_uniformClusters.Push("view", camera->GetViewMatrix());
+	m_uniformClusters.Push("inverseProjection", camera->GetProjectionMatrix().Inverse());
+	m_uniformClusters.Push("nearPlane", camera->GetNearPlane());
+	m_uniformClusters.Push("farPlane", camera->GetFarPlane());
+	m_uniformClusters.Push("lightsCount", static_cast<uint32_t>(m_lights.size()));
+
+	frame.m_descriptorClusters.Push("UniformClusters", m_uniformClusters);
+	frame.m_descriptorClusters.Push("BufferLights", frame.m_lightBuffer);
+	frame.m_descriptorClusters.Push("BufferClusters", frame.m_clusterBuffer);
+
+	if (!frame.m_descriptorClusters.Update(m_pipelineClusters))
+	{
+		return false;
+	}
+
+	if (!m_lights.empty())
+	{
+		DeferredLight *lights;
+		frame.m_lightBuffer->MapMemory(reinterpret_cast<void **>(&lights));
+		std::memcpy(lights, m_lights.data(), sizeof(DeferredLight) * m_lights.size());
+		frame.m_lightBuffer->UnmapMemory();
+	}
+
+	// The lighting pass waits on the compute queue before reading the cluster lists, the lists of older frames in flight are separate buffers.
+	m_pipelineClusters.BindPipeline(commandBuffer);
+	frame.m_descriptorClusters.BindDescriptor(commandBuffer, m_pipelineClusters);
+	m_pipelineClusters.CmdRender(commandBuffer, { CLUSTER_COUNT, 1 });
+	return true;
+}
+
+SubrenderDeferred::Environment::~Environment()
+{
+	// The loading and saving jobs hold their own references to the images.
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	for (const auto &levelView : m_levelViews)
+	{
+		vkDestroyImageView(*logicalDevice, levelView, nullptr);
+	}
+}
+
+std::unique_ptr<SubrenderDeferred::Environment> SubrenderDeferred::CreateEnvironment(const std::shared_ptr<ImageCube> &source)
+{
+	auto environment = std::make_unique<Environment>();
+	environment->m_source = source;
+	environment->m_irradiance = std::make_shared<ImageCube>(Vector2ui(IRRADIANCE_SIZE), nullptr, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_LAYOUT_GENERAL);
+	environment->m_prefiltered = std::make_shared<ImageCube>(Vector2ui(PREFILTERED_SIZE), nullptr, VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_LAYOUT_GENERAL,
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_SAMPLE_COUNT_1_BIT, true, true);
+
+	auto &prefiltered = *environment->m_prefiltered;
+	environment->m_levelViews.resize(prefiltered.GetMipLevels(), VK_NULL_HANDLE);
+
+	for (uint32_t i = 0; i < prefiltered.GetMipLevels(); i++)
+	{
+		Image::CreateImageView(prefiltered.GetImage(), environment->m_levelViews[i], VK_IMAGE_VIEW_TYPE_CUBE, prefiltered.GetFormat(), VK_IMAGE_ASPECT_COLOR_BIT, 1, i, 6, 0);
+	}
+
+	// Each face of the irradiance, then each face of every prefiltered mip level.
+	environment->m_stepCount = FACE_COUNT * (1 + prefiltered.GetMipLevels());
+
+	environment->m_cached = Resources::Get()->GetThreadPool().Enqueue([](std::shared_ptr<ImageCube> source, std::shared_ptr<ImageCube> irradiance,
+		std::shared_ptr<ImageCube> prefiltered)
+	{
+		return LoadCache(GetCachePath("Irradiance", source, IRRADIANCE_SIZE), irradiance->GetImage(), irradiance->GetFormat(), irradiance->GetLayout(),
+			IRRADIANCE_SIZE, irradiance->GetMipLevels(), 6) &&
+			LoadCache(GetCachePath("Prefiltered", source, PREFILTERED_SIZE), prefiltered->GetImage(), prefiltered->GetFormat(), prefiltered->GetLayout(),
+				PREFILTERED_SIZE, prefiltered->GetMipLevels(), 6);
+	}, environment->m_source, environment->m_irradiance, environment->m_prefiltered);
+	return environment;
+}
+
+bool SubrenderDeferred::CmdEnvironment(const CommandBuffer &commandBuffer)
+{
+	auto frame = Graphics::Get()->GetFrameCount();
+	auto framesInFlight = Graphics::Get()->GetFramesInFlight();
+
+	// The cache is read back once the fences of the frames that refined the images have been waited on.
+	if (m_environment != nullptr && m_environment->m_save && frame > *m_environment->m_completedFrame + framesInFlight)
+	{
+		m_environment->m_save = false;
+		m_environment->m_saved = Resources::Get()->GetThreadPool().Enqueue([](std::shared_ptr<ImageCube> source, std::shared_ptr<ImageCube> irradiance,
+			std::shared_ptr<ImageCube> prefiltered)
+		{
+			SaveCache(GetCachePath("Irradiance", source, IRRADIANCE_SIZE), irradiance->GetImage(), irradiance->GetFormat(), irradiance->GetLayout(),
+				IRRADIANCE_SIZE, irradiance->GetMipLevels(), 6);
+			SaveCache(GetCachePath("Prefiltered", source, PREFILTERED_SIZE), prefiltered->GetImage(), prefiltered->GetFormat(), prefiltered->GetLayout(),
+				PREFILTERED_SIZE, prefiltered->GetMipLevels(), 6);
+		}, m_environment->m_source, m_environment->m_irradiance, m_environment->m_prefiltered);
+	}
+
+	m_environmentsRetired.erase(std::remove_if(m_environmentsRetired.begin(), m_environmentsRetired.end(), [&](const auto &retired)
+	{
+		return frame > retired.first + framesInFlight;
+	}), m_environmentsRetired.end());
+
+	if (m_environmentNext == nullptr)
+	{
+		return false;
+	}
+
+	auto &environment = *m_environmentNext;
+
+	if (environment.m_cached.valid())
+	{
+		if (environment.m_cached.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return false;
+		}
+
+		if (environment.m_cached.get())
+		{
+			environment.m_completedFrame = frame;
+			SetEnvironment(std::move(m_environmentNext));
+			return false;
+		}
+	}
+
+	auto mipLevels = static_cast<uint32_t>(environment.m_levelViews.size());
+	auto recorded = false;
+
+	for (uint32_t i = 0; i < m_environmentSteps && environment.m_step < environment.m_stepCount; i++)
+	{
+		auto face = static_cast<int32_t>(environment.m_step % FACE_COUNT);
+		auto level = environment.m_step / FACE_COUNT;
+
+		if (level == 0)
+		{
+			m_descriptorIrradiance.Push("PushObject", m_pushIrradiance);
+			m_pushIrradiance.Push("face", face);
+			m_descriptorIrradiance.Push("outColour", environment.m_irradiance);
+			m_descriptorIrradiance.Push("samplerColour", environment.m_source);
+
+			if (!m_descriptorIrradiance.Update(m_pipelineIrradiance))
+			{
+				break;
+			}
+
+			m_pipelineIrradiance.BindPipeline(commandBuffer);
+			m_descriptorIrradiance.BindDescriptor(commandBuffer, m_pipelineIrradiance);
+			m_pushIrradiance.BindPush(commandBuffer, m_pipelineIrradiance);
+			m_pipelineIrradiance.CmdRender(commandBuffer, environment.m_irradiance->GetExtent());
+		}
+		else
+		{
+			auto prefilteredLevel = level - 1;
+
+			VkDescriptorImageInfo imageInfo = {};
+			imageInfo.sampler = environment.m_prefiltered->GetSampler();
+			imageInfo.imageView = environment.m_levelViews[prefilteredLevel];
+			imageInfo.imageLayout = environment.m_prefiltered->GetLayout();
+
+			VkWriteDescriptorSet descriptorWrite = {};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = VK_NULL_HANDLE; // Will be set in the descriptor handler.
+			descriptorWrite.dstBinding = *m_pipelinePrefiltered.GetShader()->GetDescriptorLocation("outColour");
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.descriptorType = *m_pipelinePrefiltered.GetShader()->GetDescriptorType(descriptorWrite.dstBinding);
+
+			m_descriptorPrefiltered.Push("PushObject", m_pushPrefiltered);
+			m_pushPrefiltered.Push("roughness", static_cast<float>(prefilteredLevel) / static_cast<float>(std::max(mipLevels, 2u) - 1));
+			m_pushPrefiltered.Push("face", face);
+			m_descriptorPrefiltered.Push("outColour", environment.m_prefiltered.get(), WriteDescriptorSet(descriptorWrite, imageInfo));
+			m_descriptorPrefiltered.Push("samplerColour", environment.m_source);
+
+			if (!m_descriptorPrefiltered.Update(m_pipelinePrefiltered))
+			{
+				break;
+			}
+
+			m_pipelinePrefiltered.BindPipeline(commandBuffer);
+			m_descriptorPrefiltered.BindDescriptor(commandBuffer, m_pipelinePrefiltered);
+			m_pushPrefiltered.BindPush(commandBuffer, m_pipelinePrefiltered);
+			m_pipelinePrefiltered.CmdRender(commandBuffer, environment.m_prefiltered->GetExtent() >> prefilteredLevel);
+		}
+
+		environment.m_step++;
+		recorded = true;
+	}
+
+	// The lighting pass of this frame waits on the compute queue, so the completed images can be read from this frame on.
+	if (environment.m_step == environment.m_stepCount)
+	{
+		environment.m_completedFrame = frame;
+		environment.m_save = true;
+		SetEnvironment(std::move(m_environmentNext));
+	}
+
+	return recorded;
+}
+
+void SubrenderDeferred::SetEnvironment(std::unique_ptr<Environment> &&environment)
+{
+	if (m_environment != nullptr)
+	{
+		m_environmentsRetired.emplace_back(Graphics::Get()->GetFrameCount(), std::move(m_environment));
+	}
+
+	m_environment = std::move(environment);
+}
+
 std::unique_ptr<Image2d> SubrenderDeferred::ComputeBRDF(const uint32_t &size)
 {
 	auto brdfImage = std::make_unique<Image2d>(Vector2ui(size), nullptr, VK_FORMAT_R16G16_SFLOAT, VK_IMAGE_LAYOUT_GENERAL);
+	auto cachePath = GetCachePath("Brdf", nullptr, size);
+
+	if (LoadCache(cachePath, brdfImage->GetImage(), brdfImage->GetFormat(), brdfImage->GetLayout(), size, brdfImage->GetMipLevels(), 1))
+	{
+		return brdfImage;
+	}
 
 	// Creates the pipeline.
 	CommandBuffer commandBuffer = CommandBuffer(true, VK_QUEUE_COMPUTE_BIT);
@@ -136,6 +511,8 @@ std::unique_ptr<Image2d> SubrenderDeferred::ComputeBRDF(const uint32_t &size)
 	compute.CmdRender(commandBuffer, brdfImage->GetExtent());
 	commandBuffer.SubmitIdle();
 
+	SaveCache(cachePath, brdfImage->GetImage(), brdfImage->GetFormat(), brdfImage->GetLayout(), size, brdfImage->GetMipLevels(), 1);
+
 #if defined(ACID_VERBOSE)
 	// Saves the BRDF Image.
 	/*Resources::Get()->GetThreadPool().Enqueue([](Image2d *image)
@@ -159,6 +536,12 @@ std::unique_ptr<ImageCube> SubrenderDeferred::ComputeIrradiance(const std::share
 	}
 
 	auto irradianceCubemap = std::make_unique<ImageCube>(Vector2ui(size), nullptr, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_LAYOUT_GENERAL);
+	auto cachePath = GetCachePath("Irradiance", source, size);
+
+	if (LoadCache(cachePath, irradianceCubemap->GetImage(), irradianceCubemap->GetFormat(), irradianceCubemap->GetLayout(), size, irradianceCubemap->GetMipLevels(), 6))
+	{
+		return irradianceCubemap;
+	}
 
 	// Creates the pipeline.
 	CommandBuffer commandBuffer = CommandBuffer(true, VK_QUEUE_COMPUTE_BIT);
@@ -169,15 +552,22 @@ std::unique_ptr<ImageCube> SubrenderDeferred::ComputeIrradiance(const std::share
 
 	// Updates descriptors.
 	DescriptorsHandler descriptorSet = DescriptorsHandler(compute);
+	PushHandler pushHandler = PushHandler(*compute.GetShader()->GetUniformBlock("PushObject"));
+	pushHandler.Push("face", -1);
+
+	descriptorSet.Push("PushObject", pushHandler);
 	descriptorSet.Push("outColour", irradianceCubemap.get());
 	descriptorSet.Push("samplerColour", source);
 	descriptorSet.Update(compute);
 
 	// Runs the compute pipeline.
 	descriptorSet.BindDescriptor(commandBuffer, compute);
+	pushHandler.BindPush(commandBuffer, compute);
 	compute.CmdRender(commandBuffer, irradianceCubemap->GetExtent());
 	commandBuffer.SubmitIdle();
 
+	SaveCache(cachePath, irradianceCubemap->GetImage(), irradianceCubemap->GetFormat(), irradianceCubemap->GetLayout(), size, irradianceCubemap->GetMipLevels(), 6);
+
 #if defined(ACID_VERBOSE)
 	// Saves the irradiance Image.
 	/*Resources::Get()->GetThreadPool().Enqueue([](ImageCube *image)
@@ -204,6 +594,12 @@ std::unique_ptr<ImageCube> SubrenderDeferred::ComputePrefiltered(const std::shar
 
 	auto prefilteredCubemap = std::make_unique<ImageCube>(Vector2ui(size), nullptr, VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_LAYOUT_GENERAL,
 		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_SAMPLE_COUNT_1_BIT, true, true);
+	auto cachePath = GetCachePath("Prefiltered", source, size);
+
+	if (LoadCache(cachePath, prefilteredCubemap->GetImage(), prefilteredCubemap->GetFormat(), prefilteredCubemap->GetLayout(), size, prefilteredCubemap->GetMipLevels(), 6))
+	{
+		return prefilteredCubemap;
+	}
 
 	// Creates the pipeline.
 	CommandBuffer commandBuffer = CommandBuffer(true, VK_QUEUE_COMPUTE_BIT);
@@ -237,6 +633,7 @@ std::unique_ptr<ImageCube> SubrenderDeferred::ComputePrefiltered(const std::shar
 		auto writeDescriptorSet = WriteDescriptorSet(descriptorWrite, imageInfo);
 
 		pushHandler.Push("roughness", static_cast<float>(i) / static_cast<float>(prefilteredCubemap->GetMipLevels() - 1));
+		pushHandler.Push("face", -1);
 
 		descriptorSet.Push("PushObject", pushHandler);
 		descriptorSet.Push("outColour", prefilteredCubemap.get(), std::move(writeDescriptorSet));
@@ -251,6 +648,8 @@ std::unique_ptr<ImageCube> SubrenderDeferred::ComputePrefiltered(const std::shar
 		vkDestroyImageView(*logicalDevice, levelView, nullptr);
 	}
 
+	SaveCache(cachePath, prefilteredCubemap->GetImage(), prefilteredCubemap->GetFormat(), prefilteredCubemap->GetLayout(), size, prefilteredCubemap->GetMipLevels(), 6);
+
 #if defined(ACID_VERBOSE)
 	/*for (uint32_t i = 0; i < prefilteredCubemap->GetMipLevels(); i++)
 	{
@@ -268,4 +667,104 @@ std::unique_ptr<ImageCube> SubrenderDeferred::ComputePrefiltered(const std::shar
 
 	return prefilteredCubemap;
 }
+
+std::string SubrenderDeferred::GetCachePath(const std::string &name, const std::shared_ptr<ImageCube> &source, const uint32_t &size)
+{
+	std::string key = name;
+
+	if (source != nullptr)
+	{
+		// Skyboxes built from pixels in memory have nothing stable to be keyed by.
+		if (source->GetFilename().empty())
+		{
+			return "";
+		}
+
+		key += "|" + source->GetFilename() + "|" + source->GetFileSuffix();
+	}
+
+	// FNV-1a, stable between runs and platforms unlike std::hash.
+	uint64_t hash = 14695981039346656037ull;
+
+	auto hashBytes = [&hash](const void *data, const std::size_t &size)
+	{
+		auto bytes = static_cast<const uint8_t *>(data);
+
+		for (std::size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	hashBytes(key.data(), key.size());
+	hashBytes(&size, sizeof(size));
+
+	std::stringstream stream;
+	stream << IBL_CACHE_DIRECTORY << name << "_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+	return stream.str();
+}
+
+bool SubrenderDeferred::LoadCache(const std::string &cachePath, const VkImage &image, const VkFormat &format, const VkImageLayout &layout, const uint32_t &size,
+	const uint32_t &mipLevels, const uint32_t &arrayLayers)
+{
+	if (cachePath.empty())
+	{
+		return false;
+	}
+
+	std::ifstream inStream(cachePath, std::ios::binary);
+
+	if (!inStream.is_open())
+	{
+		return false;
+	}
+
+	// The header has to match the image exactly, otherwise the cache is from a older build and is recomputed.
+	std::array<uint32_t, 5> header = {};
+	inStream.read(reinterpret_cast<char *>(header.data()), sizeof(header));
+
+	if (!inStream || header != std::array<uint32_t, 5>{ IBL_CACHE_VERSION, static_cast<uint32_t>(format), size, mipLevels, arrayLayers })
+	{
+		return false;
+	}
+
+	std::vector<char> data(Image::GetImageDataSize(format, { size, size, 1 }, mipLevels, arrayLayers));
+
+	if (data.empty() || !inStream.read(data.data(), data.size()))
+	{
+		return false;
+	}
+
+	return Image::WriteImageData(image, format, { size, size, 1 }, layout, mipLevels, arrayLayers, data);
+}
+
+void SubrenderDeferred::SaveCache(const std::string &cachePath, const VkImage &image, const VkFormat &format, const VkImageLayout &layout, const uint32_t &size,
+	const uint32_t &mipLevels, const uint32_t &arrayLayers)
+{
+	if (cachePath.empty())
+	{
+		return;
+	}
+
+	auto data = Image::ReadImageData(image, format, { size, size, 1 }, layout, mipLevels, arrayLayers);
+
+	if (data.empty())
+	{
+		return;
+	}
+
+	FileSystem::Create(cachePath);
+	std::ofstream outStream(cachePath, std::ios::binary | std::ios::trunc);
+
+	if (!outStream.is_open())
+	{
+		Log::Error("Could not write lighting cache: '%s'\n", cachePath.c_str());
+		return;
+	}
+
+	std::array<uint32_t, 5> header = { IBL_CACHE_VERSION, static_cast<uint32_t>(format), size, mipLevels, arrayLayers };
+	outStream.write(reinterpret_cast<const char *>(header.data()), sizeof(header));
+	outStream.write(data.data(), data.size());
+}
 }
@@ -5,24 +5,43 @@
 #include "Maths/Vector3.hpp"
 #include "Graphics/Subrender.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
 #include "Graphics/Images/ImageCube.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Shadows/ShadowAccelerationStructure.hpp"
 
 namespace acid
 {
+/**
+ * @brief Subrender that lights the G-buffer of its render stage. When the subpass reads "position", "diffuse", "normal" and "material" as input attachments in that order
+ * they are read from tile memory, otherwise they are sampled.
+ * With the compact G-buffer of {@link RenderStage#IsCompactGBuffer} positions are reconstructed from "depth", which is always sampled, and only "diffuse" and "normal" are read.
+ * On devices with ray queries the shadows of lights with a radius are traced against a {@link ShadowAccelerationStructure} while {@link Shadows#IsRayTraced}.
+ */
 class ACID_EXPORT SubrenderDeferred :
 	public Subrender
 {
 public:
 	explicit SubrenderDeferred(const Pipeline::Stage &pipelineStage);
 
+	bool RenderCompute(const CommandBuffer &commandBuffer) override;
+
 	void Render(const CommandBuffer &commandBuffer) override;
 
 	const Fog &GetFog() const { return m_fog; }
 
 	void SetFog(const Fog &fog) { m_fog = fog; }
 
+	const uint32_t &GetEnvironmentSteps() const { return m_environmentSteps; }
+
+	/**
+	 * Sets how many steps of refining the lighting of a new skybox are recorded each frame, a step is one cube face of the irradiance or of a prefiltered mip level.
+	 * @param environmentSteps The steps recorded each frame, at least one.
+	 */
+	void SetEnvironmentSteps(const uint32_t &environmentSteps) { m_environmentSteps = std::max(environmentSteps, 1u); }
+
 	static std::unique_ptr<Image2d> ComputeBRDF(const uint32_t &size);
 
 	static std::unique_ptr<ImageCube> ComputeIrradiance(const std::shared_ptr<ImageCube> &source, const uint32_t &size);
@@ -37,20 +56,127 @@ private:
 		float m_radius{};
 	};
 
-	std::vector<Shader::Define> GetDefines();
+	/**
+	 * @brief The lights and cluster lists of a frame in flight, culling runs on the compute queue while older frames may still be lighting with their own lists.
+	 */
+	class ClusterFrame
+	{
+	public:
+		DescriptorsHandler m_descriptorSet;
+		DescriptorsHandler m_descriptorClusters;
+		std::unique_ptr<StorageBuffer> m_lightBuffer;
+		std::unique_ptr<StorageBuffer> m_clusterBuffer;
+		bool m_ready = false;
+	};
+
+	/**
+	 * @brief The precomputed lighting of a skybox. Unless it is loaded from the lighting cache it is refined over several frames on the compute queue,
+	 * while the lighting of the previous skybox stays bound.
+	 */
+	class Environment
+	{
+	public:
+		~Environment();
+
+		std::shared_ptr<ImageCube> m_source;
+		std::shared_ptr<ImageCube> m_irradiance;
+		std::shared_ptr<ImageCube> m_prefiltered;
+		/// A view of each prefiltered mip level, written to by the refine steps.
+		std::vector<VkImageView> m_levelViews;
+		/// If both images were loaded from the lighting cache, invalid once the result has been taken.
+		std::future<bool> m_cached;
+		/// The cache is written once the frames that refined the images have finished.
+		std::future<void> m_saved;
+		uint32_t m_step = 0;
+		uint32_t m_stepCount = 0;
+		std::optional<uint64_t> m_completedFrame;
+		bool m_save = false;
+	};
+
+	static std::vector<Shader::Define> GetDefines(const bool &inputAttachments = false, const bool &rayQuery = false);
+
+	/**
+	 * Gets if the subpass reads the G-buffer as input attachments.
+	 * @param pipelineStage The pipelines graphics stage.
+	 * @param compact If the render stage uses the compact G-buffer.
+	 * @return If the G-buffer is read as input attachments.
+	 */
+	static bool IsInputAttachments(const Pipeline::Stage &pipelineStage, const bool &compact);
+
+	/**
+	 * Creates the images for the lighting of a skybox and starts loading them from the lighting cache.
+	 * @param source The skybox.
+	 * @return The environment, refined by {@link SubrenderDeferred#CmdEnvironment} unless the cache is loaded.
+	 */
+	static std::unique_ptr<Environment> CreateEnvironment(const std::shared_ptr<ImageCube> &source);
+
+	/**
+	 * Records the next refine steps of the environment being computed, and makes it the bound environment once every step is recorded.
+	 * @param commandBuffer The compute command buffer to record into.
+	 * @return If any steps were recorded.
+	 */
+	bool CmdEnvironment(const CommandBuffer &commandBuffer);
+
+	/**
+	 * Sets the bound environment, the previous one is kept until the frames in flight that may read it have finished.
+	 * @param environment The completed environment.
+	 */
+	void SetEnvironment(std::unique_ptr<Environment> &&environment);
+
+	/**
+	 * Uploads the lights inside of the view frustum and records the pass that bins them into the cluster grid.
+	 * @param commandBuffer The compute command buffer to record into.
+	 * @param frame The resources of the frame being recorded.
+	 * @return If the pass was recorded.
+	 */
+	bool CmdClusters(const CommandBuffer &commandBuffer, ClusterFrame &frame);
+
+	/**
+	 * Gets where a precomputed lighting image is cached, keyed by the source skybox and the image size.
+	 * @param name The name of the precomputed image.
+	 * @param source The skybox the image is computed from, or null if it has no source.
+	 * @param size The width and height of the image.
+	 * @return The cache path, empty if the source has no file to be keyed by.
+	 */
+	static std::string GetCachePath(const std::string &name, const std::shared_ptr<ImageCube> &source, const uint32_t &size);
+
+	static bool LoadCache(const std::string &cachePath, const VkImage &image, const VkFormat &format, const VkImageLayout &layout, const uint32_t &size,
+		const uint32_t &mipLevels, const uint32_t &arrayLayers);
+
+	static void SaveCache(const std::string &cachePath, const VkImage &image, const VkFormat &format, const VkImageLayout &layout, const uint32_t &size,
+		const uint32_t &mipLevels, const uint32_t &arrayLayers);
 
-	DescriptorsHandler m_descriptorSet;
 	UniformHandler m_uniformScene;
-	StorageHandler m_storageLights;
+	std::vector<Matrix4> m_views;
+	std::vector<Matrix4> m_invViewProjections;
 
+	bool m_compact;
+	bool m_inputAttachments;
 	PipelineGraphics m_pipeline;
 
+	PipelineCompute m_pipelineClusters;
+	UniformHandler m_uniformClusters;
+	std::vector<DeferredLight> m_lights;
+	std::vector<std::unique_ptr<ClusterFrame>> m_frames;
+
+	/// Built on the compute queue each frame when the device supports ray queries.
+	std::unique_ptr<ShadowAccelerationStructure> m_shadowStructure;
+
 	Future<std::unique_ptr<Image2d>> m_brdf;
 
 	std::shared_ptr<ImageCube> m_skybox;
 
-	Future<std::unique_ptr<ImageCube>> m_irradiance;
-	Future<std::unique_ptr<ImageCube>> m_prefiltered;
+	PipelineCompute m_pipelineIrradiance;
+	DescriptorsHandler m_descriptorIrradiance;
+	PushHandler m_pushIrradiance;
+	PipelineCompute m_pipelinePrefiltered;
+	DescriptorsHandler m_descriptorPrefiltered;
+	PushHandler m_pushPrefiltered;
+	uint32_t m_environmentSteps;
+
+	std::unique_ptr<Environment> m_environment;
+	std::unique_ptr<Environment> m_environmentNext;
+	std::vector<std::pair<uint64_t, std::unique_ptr<Environment>>> m_environmentsRetired;
 
 	Fog m_fog;
 };
@@ -0,0 +1,79 @@
+#include "FilterChain.hpp"
+
+namespace acid
+{
+FilterChain::FilterChain(const Pipeline::Stage &pipelineStage, std::vector<Link> links) :
+	PostFilter(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/Chain.frag" }, Compile(links)),
+	m_links(std::move(links)),
+	m_innerRadius(0.15f),
+	m_outerRadius(1.35f),
+	m_opacity(0.85f),
+	m_strength(2.3f),
+	m_factor(0.5f)
+{
+}
+
+void FilterChain::Render(const CommandBuffer &commandBuffer)
+{
+	// Updates uniforms.
+	m_pushScene.Push("innerRadius", m_innerRadius);
+	m_pushScene.Push("outerRadius", m_outerRadius);
+	m_pushScene.Push("opacity", m_opacity);
+	m_pushScene.Push("strength", m_strength);
+	m_pushScene.Push("factor", m_factor);
+
+	// Updates descriptors.
+	m_descriptorSet.Push("PushScene", m_pushScene);
+	PushConditional("writeColour", "samplerColour", "resolved", "diffuse");
+	bool updateSuccess = m_descriptorSet.Update(m_pipeline);
+
+	if (!updateSuccess)
+	{
+		return;
+	}
+
+	// Binds the pipeline.
+	m_pipeline.BindPipeline(commandBuffer);
+
+	// Draws the object.
+	m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+	m_pushScene.BindPush(commandBuffer, m_pipeline);
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+std::vector<Shader::Define> FilterChain::Compile(const std::vector<Link> &links)
+{
+	// Every link is a function in the shader, the define expands to calling them in order on the colour of the pixel.
+	std::stringstream chain;
+
+	for (const auto &link : links)
+	{
+		switch (link)
+		{
+		case Link::Tone:
+			chain << "colour = Tone(colour); ";
+			break;
+		case Link::Vignette:
+			chain << "colour = Vignette(colour); ";
+			break;
+		case Link::Grain:
+			chain << "colour = Grain(colour); ";
+			break;
+		case Link::Sepia:
+			chain << "colour = Sepia(colour); ";
+			break;
+		case Link::Grey:
+			chain << "colour = Grey(colour); ";
+			break;
+		case Link::Darken:
+			chain << "colour = Darken(colour); ";
+			break;
+		case Link::Negative:
+			chain << "colour = Negative(colour); ";
+			break;
+		}
+	}
+
+	return { { "CHAIN", chain.str() } };
+}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Post/PostFilter.hpp"
+
+namespace acid
+{
+/**
+ * @brief Filter that fuses a list of per pixel filters into one generated shader, so a stack of them costs a single read and write of the attachment.
+ * Each link applies the same effect as its own filter, such as {@link FilterTone} or {@link FilterVignette}, in the order they are given.
+ * Filters that read the neighbourhood of a pixel, such as {@link FilterBlur}, {@link FilterDof} and {@link FilterSsao}, stay as separate passes.
+ */
+class ACID_EXPORT FilterChain :
+	public PostFilter
+{
+public:
+	enum class Link
+	{
+		Tone, Vignette, Grain, Sepia, Grey, Darken, Negative
+	};
+
+	/**
+	 * Creates a new filter chain.
+	 * @param pipelineStage The pipelines graphics stage.
+	 * @param links The filters to fuse, applied in order.
+	 */
+	FilterChain(const Pipeline::Stage &pipelineStage, std::vector<Link> links);
+
+	void Render(const CommandBuffer &commandBuffer) override;
+
+	const std::vector<Link> &GetLinks() const { return m_links; }
+
+	const float &GetInnerRadius() const { return m_innerRadius; }
+
+	void SetInnerRadius(const float &innerRadius) { m_innerRadius = innerRadius; }
+
+	const float &GetOuterRadius() const { return m_outerRadius; }
+
+	void SetOuterRadius(const float &outerRadius) { m_outerRadius = outerRadius; }
+
+	const float &GetOpacity() const { return m_opacity; }
+
+	void SetOpacity(const float &opacity) { m_opacity = opacity; }
+
+	const float &GetStrength() const { return m_strength; }
+
+	void SetStrength(const float &strength) { m_strength = strength; }
+
+	const float &GetFactor() const { return m_factor; }
+
+	void SetFactor(const float &factor) { m_factor = factor; }
+
+private:
+	/**
+	 * Compiles the links into the define with the statements the shader runs for each pixel.
+	 * @param links The filters to fuse.
+	 * @return The defines of the generated shader.
+	 */
+	static std::vector<Shader::Define> Compile(const std::vector<Link> &links);
+
+	PushHandler m_pushScene;
+
+	std::vector<Link> m_links;
+
+	float m_innerRadius;
+	float m_outerRadius;
+	float m_opacity;
+	float m_strength;
+	float m_factor;
+};
+}
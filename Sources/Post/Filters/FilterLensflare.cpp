@@ -5,7 +5,7 @@
 namespace acid
 {
 FilterLensflare::FilterLensflare(const Pipeline::Stage &pipelineStage) :
-	PostFilter(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/Lensflare.frag" }, {}),
+	PostFilter(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/Lensflare.frag" }, {}, true),
 	m_sunHeight(0.0f)
 {
 }
@@ -21,7 +21,10 @@ void FilterLensflare::Render(const CommandBuffer &commandBuffer)
 	m_descriptorSet.Push("PushScene", m_pushScene);
 	//m_descriptorSet.Push("writeColour", GetAttachment("writeColour", "resolved"));
 	//m_descriptorSet.Push("samplerColour", GetAttachment("samplerColour", "resolved"));
-	m_descriptorSet.Push("samplerMaterial", GetAttachment("samplerMaterial", "material"));
+	// The compact G-buffer keeps metallic in the normal target.
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+	auto compact = renderStage != nullptr && renderStage->IsCompactGBuffer();
+	m_descriptorSet.Push("samplerMaterial", GetAttachment("samplerMaterial", compact ? "normal" : "material"));
 	PushConditional("writeColour", "samplerColour", "resolved", "diffuse");
 	bool updateSuccess = m_descriptorSet.Update(m_pipeline);
 
@@ -12,10 +12,18 @@ static const uint32_t SSAO_NOISE_DIM = 4;
 static const uint32_t SSAO_KERNEL_SIZE = 64;
 static const float SSAO_RADIUS = 0.5f;
 
-FilterSsao::FilterSsao(const Pipeline::Stage &pipelineStage) :
-	PostFilter(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/Ssao.frag" }, GetDefines()),
+FilterSsao::FilterSsao(const Pipeline::Stage &pipelineStage, const bool &halfResolution, const bool &temporal) :
+	PostFilter(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/SsaoUpsample.frag" }, {}, true),
+	m_pipelineOcclusion(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/Ssao.frag" }, {}, GetDefines(), PipelineGraphics::Mode::Polygon,
+		PipelineGraphics::Depth::None),
 	m_noise(ComputeNoise(SSAO_NOISE_DIM)),
-	m_kernel(SSAO_KERNEL_SIZE)
+	m_kernel(SSAO_KERNEL_SIZE),
+	m_halfResolution(halfResolution),
+	m_temporal(temporal),
+	m_blend(0.2f),
+	m_occlusionIndex(0),
+	m_historyValid(false),
+	m_frame(0)
 {
 	for (uint32_t i = 0; i < SSAO_KERNEL_SIZE; ++i)
 	{
@@ -24,37 +32,112 @@ FilterSsao::FilterSsao(const Pipeline::Stage &pipelineStage) :
 		sample *= Maths::Random(0.0f, 1.0f);
 		float scale = static_cast<float>(i) / static_cast<float>(SSAO_KERNEL_SIZE);
 		scale = Maths::Lerp(0.1f, 1.0f, scale * scale);
-		m_kernel[i] = sample * scale;
+		m_kernel[i] = Vector4f(sample * scale, 0.0f);
 	}
 }
 
 void FilterSsao::Render(const CommandBuffer &commandBuffer)
 {
-	// Updates uniforms.
 	auto camera = Scenes::Get()->GetCamera();
-	m_uniformScene.Push("kernel", *m_kernel.data(), sizeof(Vector3f) * SSAO_KERNEL_SIZE);
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+
+	if (camera == nullptr || renderStage == nullptr)
+	{
+		return;
+	}
+
+	// Occlusion images follow the render area and resolution mode, the history is discarded when they are rebuilt.
+	auto &renderArea = renderStage->GetRenderArea();
+	auto divisor = m_halfResolution ? 2u : 1u;
+	Vector2ui extent = { std::max(renderArea.GetExtent().m_x / divisor, 1u), std::max(renderArea.GetExtent().m_y / divisor, 1u) };
+
+	if (m_occlusions[0] == nullptr || m_occlusions[0]->GetExtent() != extent)
+	{
+		for (auto &occlusion : m_occlusions)
+		{
+			occlusion = std::make_unique<Image2d>(extent, nullptr, VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_LAYOUT_GENERAL,
+				VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+		}
+
+		m_historyValid = false;
+	}
+
+	auto temporal = m_temporal && m_historyValid;
+	auto &occlusion = m_occlusions[m_occlusionIndex];
+	auto &history = m_occlusions[1 - m_occlusionIndex];
+
+	// Updates uniforms.
+	auto viewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+	m_uniformScene.Push("kernel", *m_kernel.data(), sizeof(Vector4f) * SSAO_KERNEL_SIZE);
 	m_uniformScene.Push("projection", camera->GetProjectionMatrix());
 	m_uniformScene.Push("view", camera->GetViewMatrix());
+	m_uniformScene.Push("previousViewProjection", temporal ? m_previousViewProjection : viewProjection);
+	m_uniformScene.Push("invViewProjection", viewProjection.Inverse());
 	m_uniformScene.Push("cameraPosition", camera->GetPosition());
+	// Rotating the noise each frame lets the accumulated history average more directions.
+	m_uniformScene.Push("noiseOffset", m_temporal ? Vector2f(static_cast<float>(m_frame % SSAO_NOISE_DIM), static_cast<float>(m_frame / SSAO_NOISE_DIM % SSAO_NOISE_DIM)) :
+		Vector2f());
+	m_uniformScene.Push("blend", temporal ? m_blend : 1.0f);
+
+	m_pushScene.Push("view", camera->GetViewMatrix());
+	m_pushScene.Push("invViewProjection", viewProjection.Inverse());
+
+	// The compact G-buffer has no positions, they are reconstructed from depth.
+	auto compact = renderStage->IsCompactGBuffer();
 
 	// Updates descriptors.
-	m_descriptorSet.Push("UniformScene", m_uniformScene);
-	m_descriptorSet.Push("writeColour", GetAttachment("writeColour", "resolved"));
-	m_descriptorSet.Push("samplerPosition", GetAttachment("samplerPosition", "position"));
-	m_descriptorSet.Push("samplerNormal", GetAttachment("samplerNormal", "normals"));
-	m_descriptorSet.Push("samplerNoise", m_noise);
-	bool updateSuccess = m_descriptorSet.Update(m_pipeline);
-
-	if (!updateSuccess)
+	m_descriptorOcclusion.Push("UniformScene", m_uniformScene);
+	m_descriptorOcclusion.Push("writeOcclusion", occlusion);
+	m_descriptorOcclusion.Push(compact ? "samplerDepth" : "samplerPosition", compact ? GetAttachment("samplerDepth", "depth") :
+		GetAttachment("samplerPosition", "position"));
+	m_descriptorOcclusion.Push("samplerNormal", GetAttachment("samplerNormal", "normal"));
+	m_descriptorOcclusion.Push("samplerNoise", m_noise);
+	m_descriptorOcclusion.Push("samplerHistory", history);
+
+	m_descriptorSet.Push("PushScene", m_pushScene);
+	PushConditional("writeColour", "samplerColour", "resolved", "diffuse");
+	m_descriptorSet.Push("samplerOcclusion", occlusion);
+	m_descriptorSet.Push(compact ? "samplerDepth" : "samplerPosition", compact ? GetAttachment("samplerDepth", "depth") :
+		GetAttachment("samplerPosition", "position"));
+	m_descriptorSet.Push("samplerNormal", GetAttachment("samplerNormal", "normal"));
+
+	// Both sets are updated before drawing, so a pass is never drawn without the other.
+	auto updateOcclusion = m_descriptorOcclusion.Update(m_pipelineOcclusion);
+	auto updateSuccess = m_descriptorSet.Update(m_pipeline);
+
+	if (!updateOcclusion || !updateSuccess)
 	{
 		return;
 	}
 
-	// Draws the object.
+	// At half resolution the occlusion pass only covers the top left quarter of the stage, one fragment for each texel of the occlusion image.
+	if (m_halfResolution)
+	{
+		CmdSetViewport(commandBuffer, renderArea.GetOffset(), extent);
+	}
+
+	// Draws the occlusion.
+	m_pipelineOcclusion.BindPipeline(commandBuffer);
+
+	m_descriptorOcclusion.BindDescriptor(commandBuffer, m_pipelineOcclusion);
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+
+	if (m_halfResolution)
+	{
+		CmdSetViewport(commandBuffer, renderArea.GetOffset(), renderArea.GetExtent());
+	}
+
+	// Draws the scene colour darkened by the upsampled occlusion.
 	m_pipeline.BindPipeline(commandBuffer);
 
 	m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+	m_pushScene.BindPush(commandBuffer, m_pipeline);
 	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+
+	m_previousViewProjection = viewProjection;
+	m_occlusionIndex = 1 - m_occlusionIndex;
+	m_historyValid = true;
+	m_frame++;
 }
 
 std::vector<Shader::Define> FilterSsao::GetDefines()
@@ -66,6 +149,23 @@ std::vector<Shader::Define> FilterSsao::GetDefines()
 	return defines;
 }
 
+void FilterSsao::CmdSetViewport(const CommandBuffer &commandBuffer, const Vector2i &offset, const Vector2ui &extent)
+{
+	VkViewport viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(extent.m_x);
+	viewport.height = static_cast<float>(extent.m_y);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor = {};
+	scissor.offset = { offset.m_x, offset.m_y };
+	scissor.extent = { extent.m_x, extent.m_y };
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
 std::shared_ptr<Image2d> FilterSsao::ComputeNoise(const uint32_t &size)
 {
 	std::vector<Vector3f> ssaoNoise(size * size);
@@ -1,26 +1,72 @@
 #pragma once
 
 #include "Post/PostFilter.hpp"
-#include "Maths/Vector3.hpp"
+#include "Maths/Vector4.hpp"
 
 namespace acid
 {
+/**
+ * @brief Filter that darkens the scene colour with screen space ambient occlusion, occlusion is found from the "position" and "normal" attachments.
+ * At half resolution occlusion is found for a quarter of the pixels and brought back with a bilateral upsample that follows depth and normal edges.
+ * With temporal accumulation the noise rotates each frame and occlusion is blended with the last frames, reprojected through the previous camera.
+ */
 class ACID_EXPORT FilterSsao :
 	public PostFilter
 {
 public:
-	explicit FilterSsao(const Pipeline::Stage &pipelineStage);
+	/**
+	 * Creates a new ssao filter.
+	 * @param pipelineStage The pipelines graphics stage.
+	 * @param halfResolution If occlusion is found at half the resolution of the stage.
+	 * @param temporal If occlusion is accumulated over frames.
+	 */
+	explicit FilterSsao(const Pipeline::Stage &pipelineStage, const bool &halfResolution = false, const bool &temporal = false);
 
 	void Render(const CommandBuffer &commandBuffer) override;
 
+	const bool &IsHalfResolution() const { return m_halfResolution; }
+
+	void SetHalfResolution(const bool &halfResolution) { m_halfResolution = halfResolution; }
+
+	const bool &IsTemporal() const { return m_temporal; }
+
+	void SetTemporal(const bool &temporal) { m_temporal = temporal; }
+
+	/**
+	 * Gets the weight of the current frame when occlusion is accumulated, lower values are smoother but respond slower.
+	 * @return The weight of the current frame.
+	 */
+	const float &GetBlend() const { return m_blend; }
+
+	void SetBlend(const float &blend) { m_blend = blend; }
+
 private:
 	std::vector<Shader::Define> GetDefines();
 
+	static void CmdSetViewport(const CommandBuffer &commandBuffer, const Vector2i &offset, const Vector2ui &extent);
+
 	static std::shared_ptr<Image2d> ComputeNoise(const uint32_t &size);
 
+	// The occlusion pass, the filters own pipeline upsamples it and darkens the scene colour.
+	PipelineGraphics m_pipelineOcclusion;
+	DescriptorsHandler m_descriptorOcclusion;
 	UniformHandler m_uniformScene;
 
+	PushHandler m_pushScene;
+
 	std::shared_ptr<Image2d> m_noise;
-	std::vector<Vector3f> m_kernel;
+	// Padded to the std140 stride of a vec3 array.
+	std::vector<Vector4f> m_kernel;
+
+	bool m_halfResolution;
+	bool m_temporal;
+	float m_blend;
+
+	// Occlusion and view distance, one is written while the other is read as the history.
+	std::array<std::unique_ptr<Image2d>, 2> m_occlusions;
+	uint32_t m_occlusionIndex;
+	bool m_historyValid;
+	Matrix4 m_previousViewProjection;
+	uint32_t m_frame;
 };
 }
@@ -0,0 +1,88 @@
+#include "FilterTaa.hpp"
+
+#include "Scenes/Scenes.hpp"
+
+namespace acid
+{
+FilterTaa::FilterTaa(const Pipeline::Stage &pipelineStage, const float &blend, const uint32_t &jitterSamples) :
+	PostFilter(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/Taa.frag" }, {}),
+	m_blend(blend),
+	m_jitterSamples(jitterSamples),
+	m_jitterIndex(0),
+	m_historyIndex(0),
+	m_historyValid(false)
+{
+}
+
+void FilterTaa::Render(const CommandBuffer &commandBuffer)
+{
+	auto camera = Scenes::Get()->GetCamera();
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+
+	if (camera == nullptr || renderStage == nullptr)
+	{
+		return;
+	}
+
+	// Histories follow the render area, so they are rebuilt when the window or the dynamic resolution scale changes.
+	auto extent = renderStage->GetRenderArea().GetExtent();
+
+	if (m_histories[0] == nullptr || m_histories[0]->GetExtent() != extent)
+	{
+		for (auto &history : m_histories)
+		{
+			history = std::make_unique<Image2d>(extent, nullptr, VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_LAYOUT_GENERAL,
+				VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+		}
+
+		m_historyValid = false;
+	}
+
+	// Updates uniforms.
+	m_pushScene.Push("blend", m_historyValid ? m_blend : 1.0f);
+
+	// Updates descriptors.
+	m_descriptorSet.Push("PushScene", m_pushScene);
+	PushConditional("writeColour", "samplerColour", "resolved", "diffuse");
+	m_descriptorSet.Push("samplerVelocity", GetAttachment("samplerVelocity", "velocity"));
+	m_descriptorSet.Push("samplerHistory", m_histories[m_historyIndex]);
+	m_descriptorSet.Push("writeHistory", m_histories[1 - m_historyIndex]);
+	bool updateSuccess = m_descriptorSet.Update(m_pipeline);
+
+	if (!updateSuccess)
+	{
+		return;
+	}
+
+	// Binds the pipeline.
+	m_pipeline.BindPipeline(commandBuffer);
+
+	// Draws the object.
+	m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+	m_pushScene.BindPush(commandBuffer, m_pipeline);
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+
+	m_historyIndex = 1 - m_historyIndex;
+	m_historyValid = true;
+
+	// The next frame is rendered at a new sub pixel offset, within half a pixel of the centre.
+	m_jitterIndex = (m_jitterIndex + 1) % std::max(m_jitterSamples, 1u);
+	auto jitter = Vector2f(Halton(m_jitterIndex + 1, 2), Halton(m_jitterIndex + 1, 3)) - 0.5f;
+	camera->SetJitter(2.0f * jitter / Vector2f(static_cast<float>(extent.m_x), static_cast<float>(extent.m_y)));
+}
+
+float FilterTaa::Halton(uint32_t index, const uint32_t &base)
+{
+	auto result = 0.0f;
+	auto fraction = 1.0f;
+
+	while (index > 0)
+	{
+		fraction /= static_cast<float>(base);
+		result += fraction * static_cast<float>(index % base);
+		index /= base;
+	}
+
+	return result;
+}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Graphics/Images/Image2d.hpp"
+#include "Post/PostFilter.hpp"
+
+namespace acid
+{
+/**
+ * @brief Filter that resolves aliasing over time, a alternative to {@link FilterFxaa} that also recovers detail smaller than a pixel.
+ * While the filter renders the scene camera is jittered by a Halton sequence, each frame is blended into a history reprojected with the "velocity" attachment.
+ * History colours are clamped to the neighbourhood of the current frame, so disoccluded pixels do not ghost.
+ * Used before {@link FilterUpscale} the accumulated history also makes up for a lower {@link DynamicResolution} scale.
+ */
+class ACID_EXPORT FilterTaa :
+	public PostFilter
+{
+public:
+	/**
+	 * Creates a new temporal anti-aliasing filter, the renderer must write a R16G16_SFLOAT "velocity" attachment in the geometry subpass.
+	 * @param pipelineStage The pipelines graphics stage.
+	 * @param blend The weight of the current frame in the result, lower values are smoother but respond slower.
+	 * @param jitterSamples The number of jitter positions before the sequence repeats.
+	 */
+	explicit FilterTaa(const Pipeline::Stage &pipelineStage, const float &blend = 0.1f, const uint32_t &jitterSamples = 8);
+
+	void Render(const CommandBuffer &commandBuffer) override;
+
+	const float &GetBlend() const { return m_blend; }
+
+	void SetBlend(const float &blend) { m_blend = blend; }
+
+	const uint32_t &GetJitterSamples() const { return m_jitterSamples; }
+
+	void SetJitterSamples(const uint32_t &jitterSamples) { m_jitterSamples = jitterSamples; }
+
+	/**
+	 * Discards the history, such as after a camera cut, so the next frame is not blended with unrelated frames.
+	 */
+	void ResetHistory() { m_historyValid = false; }
+
+private:
+	static float Halton(uint32_t index, const uint32_t &base);
+
+	PushHandler m_pushScene;
+
+	float m_blend;
+	uint32_t m_jitterSamples;
+	uint32_t m_jitterIndex;
+
+	// Read from one history while the other is written, they swap each frame.
+	std::array<std::unique_ptr<Image2d>, 2> m_histories;
+	uint32_t m_historyIndex;
+	bool m_historyValid;
+};
+}
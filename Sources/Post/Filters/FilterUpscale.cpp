@@ -0,0 +1,34 @@
+#include "FilterUpscale.hpp"
+
+namespace acid
+{
+FilterUpscale::FilterUpscale(const Pipeline::Stage &pipelineStage, std::string attachment, const float &sharpness) :
+	PostFilter(pipelineStage, { "Shaders/Post/Default.vert", "Shaders/Post/Upscale.frag" }, {}),
+	m_attachment(std::move(attachment)),
+	m_sharpness(sharpness)
+{
+}
+
+void FilterUpscale::Render(const CommandBuffer &commandBuffer)
+{
+	// Updates uniforms.
+	m_pushScene.Push("sharpness", m_sharpness);
+
+	// Updates descriptors.
+	m_descriptorSet.Push("PushScene", m_pushScene);
+	m_descriptorSet.Push("samplerColour", GetAttachment("samplerColour", m_attachment));
+	bool updateSuccess = m_descriptorSet.Update(m_pipeline);
+
+	if (!updateSuccess)
+	{
+		return;
+	}
+
+	// Draws the object.
+	m_pipeline.BindPipeline(commandBuffer);
+
+	m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+	m_pushScene.BindPush(commandBuffer, m_pipeline);
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Post/PostFilter.hpp"
+
+namespace acid
+{
+/**
+ * @brief Filter that brings a attachment rendered at a lower resolution back to the resolution of its stage, used with {@link DynamicResolution}.
+ * The attachment is resampled with a Catmull-Rom filter, then sharpened against a bilinear sample.
+ */
+class ACID_EXPORT FilterUpscale :
+	public PostFilter
+{
+public:
+	/**
+	 * Creates a new upscale filter.
+	 * @param pipelineStage The pipelines graphics stage, this stage renders at the display resolution.
+	 * @param attachment The name of the attachment rendered at a lower resolution.
+	 * @param sharpness How much the upscaled image is sharpened, from 0 to 1.
+	 */
+	explicit FilterUpscale(const Pipeline::Stage &pipelineStage, std::string attachment = "resolved", const float &sharpness = 0.25f);
+
+	void Render(const CommandBuffer &commandBuffer) override;
+
+	const std::string &GetAttachmentName() const { return m_attachment; }
+
+	void SetAttachmentName(const std::string &attachment) { m_attachment = attachment; }
+
+	const float &GetSharpness() const { return m_sharpness; }
+
+	void SetSharpness(const float &sharpness) { m_sharpness = sharpness; }
+
+private:
+	PushHandler m_pushScene;
+
+	std::string m_attachment;
+	float m_sharpness;
+};
+}
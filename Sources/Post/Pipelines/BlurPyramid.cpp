@@ -0,0 +1,150 @@
+#include "BlurPyramid.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+static const VkFormat PYRAMID_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+BlurPyramid::BlurPyramid(const Vector2ui &extent, const uint32_t &levels) :
+	m_extent(extent),
+	m_levels(std::clamp(levels, 1u, Image::GetMipLevels({ extent.m_x, extent.m_y, 1 }))),
+	m_image(VK_NULL_HANDLE),
+	m_sampler(VK_NULL_HANDLE),
+	m_pipelineDown("Shaders/Post/BlurDown.comp"),
+	m_pipelineUp("Shaders/Post/BlurUp.comp")
+{
+	Image::CreateImage(m_image, m_memory, { m_extent.m_x, m_extent.m_y, 1 }, PYRAMID_FORMAT, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL,
+		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_levels, 1, VK_IMAGE_TYPE_2D);
+	m_sampler = Image::GetImageSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false);
+	Image::TransitionImageLayout(m_image, PYRAMID_FORMAT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, m_levels, 0, 1, 0);
+
+	for (uint32_t i = 0; i < m_levels; i++)
+	{
+		VkImageView levelView = VK_NULL_HANDLE;
+		Image::CreateImageView(m_image, levelView, VK_IMAGE_VIEW_TYPE_2D, PYRAMID_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT, 1, i, 1, 0);
+		Vector2ui levelExtent = { std::max(m_extent.m_x >> i, 1u), std::max(m_extent.m_y >> i, 1u) };
+		m_mipLevels.emplace_back(std::make_unique<Level>(m_sampler, levelView, levelExtent));
+		m_downPasses.emplace_back(std::make_unique<Pass>());
+		m_upPasses.emplace_back(std::make_unique<Pass>());
+	}
+}
+
+BlurPyramid::~BlurPyramid()
+{
+	// Retired objects are destroyed in order, the views of the levels go before the image.
+	for (const auto &level : m_mipLevels)
+	{
+		Image::DestroyImage(VK_NULL_HANDLE, level->GetView());
+	}
+
+	Image::DestroyImage(m_image, VK_NULL_HANDLE, m_memory);
+}
+
+std::shared_ptr<BlurPyramid> BlurPyramid::Acquire(const Vector2ui &extent, const uint32_t &levels)
+{
+	static std::map<std::tuple<uint32_t, uint32_t, uint32_t>, std::weak_ptr<BlurPyramid>> pool;
+	static std::mutex mutex;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &pooled = pool[{ extent.m_x, extent.m_y, levels }];
+
+	if (auto pyramid = pooled.lock())
+	{
+		return pyramid;
+	}
+
+	auto pyramid = std::make_shared<BlurPyramid>(extent, levels);
+	pooled = pyramid;
+	return pyramid;
+}
+
+void BlurPyramid::Update(const CommandBuffer &commandBuffer, const Image2d &source, const Image2d &output, const float &offset, Pass &sourcePass, Pass &outputPass)
+{
+	// The colour writes to the source must be visible, and earlier reads of the pyramid and output must be done before they are written again.
+	Image::InsertImageMemoryBarrier(commandBuffer, source.GetImage(), VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, source.GetLayout(),
+		source.GetLayout(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+	Image::InsertImageMemoryBarrier(commandBuffer, m_image, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL,
+		VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, m_levels, 0, 1, 0);
+	Image::InsertImageMemoryBarrier(commandBuffer, output.GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL,
+		VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+
+	// Downsamples the source into the first level, then each level into the next.
+	for (uint32_t i = 0; i < m_levels; i++)
+	{
+		if (i == 0)
+		{
+			CmdPass(commandBuffer, m_pipelineDown, sourcePass, source, *m_mipLevels[0], m_mipLevels[0]->GetExtent(), offset);
+		}
+		else
+		{
+			CmdPass(commandBuffer, m_pipelineDown, *m_downPasses[i], *m_mipLevels[i - 1], *m_mipLevels[i], m_mipLevels[i]->GetExtent(), offset);
+		}
+
+		Image::InsertImageMemoryBarrier(commandBuffer, m_image, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+			VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, i, 1, 0);
+	}
+
+	// Upsamples each level into the one above it, a level is only overwritten once the level below has been read from it.
+	for (uint32_t i = m_levels - 1; i > 0; i--)
+	{
+		CmdPass(commandBuffer, m_pipelineUp, *m_upPasses[i], *m_mipLevels[i], *m_mipLevels[i - 1], m_mipLevels[i - 1]->GetExtent(), offset);
+		Image::InsertImageMemoryBarrier(commandBuffer, m_image, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+			VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, i - 1, 1, 0);
+	}
+
+	CmdPass(commandBuffer, m_pipelineUp, outputPass, *m_mipLevels[0], output, output.GetExtent(), offset);
+
+	// The output is sampled by fragment shaders, and the source is written as a attachment again.
+	Image::InsertImageMemoryBarrier(commandBuffer, output.GetImage(), VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+		VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+	Image::InsertImageMemoryBarrier(commandBuffer, source.GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, source.GetLayout(),
+		source.GetLayout(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+}
+
+void BlurPyramid::CmdPass(const CommandBuffer &commandBuffer, const PipelineCompute &pipeline, Pass &pass, const Descriptor &input, const Descriptor &output,
+	const Vector2ui &extent, const float &offset)
+{
+	pass.m_pushScene.Push("offset", offset);
+
+	pass.m_descriptorSet.Push("PushScene", pass.m_pushScene);
+	pass.m_descriptorSet.Push("samplerInput", input);
+	pass.m_descriptorSet.Push("outColour", output);
+
+	// Descriptors are created the first time a pass is used, the level is left as it was until then.
+	if (!pass.m_descriptorSet.Update(pipeline))
+	{
+		return;
+	}
+
+	pipeline.BindPipeline(commandBuffer);
+	pass.m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
+	pass.m_pushScene.BindPush(commandBuffer, pipeline);
+	pipeline.CmdRender(commandBuffer, extent);
+}
+
+BlurPyramid::Level::Level(const VkSampler &sampler, const VkImageView &view, const Vector2ui &extent) :
+	m_sampler(sampler),
+	m_view(view),
+	m_extent(extent)
+{
+}
+
+WriteDescriptorSet BlurPyramid::Level::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+	const std::optional<OffsetSize> &offsetSize) const
+{
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.sampler = m_sampler;
+	imageInfo.imageView = m_view;
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = VK_NULL_HANDLE; // Will be set in the descriptor handler.
+	descriptorWrite.dstBinding = binding;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.descriptorType = descriptorType;
+	return WriteDescriptorSet(descriptorWrite, imageInfo);
+}
+}
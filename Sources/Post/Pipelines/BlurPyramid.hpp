@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Graphics/Buffers/PushHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Images/Image2d.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
+
+namespace acid
+{
+/**
+ * @brief Mip chain used to blur a image with compute shaders in the style of a dual Kawase filter, each level is downsampled from the last then upsampled back.
+ * The blur radius doubles with each level, so large radii cost a few passes over small images instead of wide kernels at full resolution.
+ * Pyramids are scratch targets that are shared through {@link BlurPyramid#Acquire}, blurs recorded one after another reuse the same images.
+ */
+class ACID_EXPORT BlurPyramid :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief The descriptors of a single downsample or upsample dispatch.
+	 */
+	class Pass
+	{
+	public:
+		DescriptorsHandler m_descriptorSet;
+		PushHandler m_pushScene;
+	};
+
+	/**
+	 * Creates a new blur pyramid.
+	 * @param extent The extent of the first level.
+	 * @param levels The number of levels, each is half the size of the last.
+	 */
+	BlurPyramid(const Vector2ui &extent, const uint32_t &levels);
+
+	~BlurPyramid();
+
+	/**
+	 * Gets a pyramid from the pool, a new one is created when no pyramid with the extent and levels is alive.
+	 * @param extent The extent of the first level.
+	 * @param levels The number of levels.
+	 * @return The pyramid, it is returned to the pool once every user has released it.
+	 */
+	static std::shared_ptr<BlurPyramid> Acquire(const Vector2ui &extent, const uint32_t &levels);
+
+	/**
+	 * Records the blur of a image into a output image, this must be called outside of a renderpass.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param source The image to blur, is expected to be written as a colour attachment.
+	 * @param output The image written with the blur, it must have storage usage and the general layout.
+	 * @param offset How far apart the taps of each pass are in texels, larger offsets widen the blur.
+	 * @param sourcePass The pass that reads the source, owned by the caller so blurs sharing the pyramid do not rewrite each others descriptors.
+	 * @param outputPass The pass that writes the output, owned by the caller.
+	 */
+	void Update(const CommandBuffer &commandBuffer, const Image2d &source, const Image2d &output, const float &offset, Pass &sourcePass, Pass &outputPass);
+
+	const Vector2ui &GetExtent() const { return m_extent; }
+
+	const uint32_t &GetLevels() const { return m_levels; }
+
+private:
+	/**
+	 * @brief A view of a single mip level, bound as the storage image being written or the sampled image being read.
+	 */
+	class Level :
+		public Descriptor
+	{
+	public:
+		Level(const VkSampler &sampler, const VkImageView &view, const Vector2ui &extent);
+
+		WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
+
+		const VkImageView &GetView() const { return m_view; }
+
+		const Vector2ui &GetExtent() const { return m_extent; }
+
+	private:
+		VkSampler m_sampler;
+		VkImageView m_view;
+		Vector2ui m_extent;
+	};
+
+	static void CmdPass(const CommandBuffer &commandBuffer, const PipelineCompute &pipeline, Pass &pass, const Descriptor &input, const Descriptor &output,
+		const Vector2ui &extent, const float &offset);
+
+	Vector2ui m_extent;
+	uint32_t m_levels;
+
+	VkImage m_image;
+	MemoryAllocation m_memory;
+	VkSampler m_sampler;
+
+	std::vector<std::unique_ptr<Level>> m_mipLevels;
+	PipelineCompute m_pipelineDown;
+	PipelineCompute m_pipelineUp;
+	std::vector<std::unique_ptr<Pass>> m_downPasses;
+	std::vector<std::unique_ptr<Pass>> m_upPasses;
+};
+}
@@ -1,6 +1,5 @@
 #include "PipelineBlur.hpp"
 
-#include "Devices/Window.hpp"
 #include "Graphics/Graphics.hpp"
 
 namespace acid
@@ -14,25 +13,60 @@ PipelineBlur::PipelineBlur(const Pipeline::Stage &pipelineStage, const float &bl
 	m_inputScale(inputScale),
 	m_outputScale(outputScale),
 	m_blur(blur),
+	m_levels(static_cast<uint32_t>(blurType) / 4 + 1),
+	m_source("resolved"),
 	m_output(nullptr),
+	m_computed(false),
 	m_lastSize(0, 0)
 {
 }
 
+void PipelineBlur::PreRender(const CommandBuffer &commandBuffer)
+{
+	m_computed = false;
+
+	if (m_toScreen)
+	{
+		return;
+	}
+
+	auto source = GetComputeSource();
+
+	if (source == nullptr)
+	{
+		return;
+	}
+
+	auto &extent = source->GetExtent();
+	SetOutput({ std::max(static_cast<uint32_t>(m_outputScale * extent.m_x), 1u), std::max(static_cast<uint32_t>(m_outputScale * extent.m_y), 1u) });
+
+	// The pyramid is scratch memory, blurs with the same size share one from the pool.
+	Vector2ui pyramidExtent = { std::max(static_cast<uint32_t>(m_inputScale * extent.m_x), 1u), std::max(static_cast<uint32_t>(m_inputScale * extent.m_y), 1u) };
+
+	if (m_pyramid == nullptr || m_pyramid->GetExtent() != pyramidExtent)
+	{
+		m_pyramid = nullptr;
+		m_pyramid = BlurPyramid::Acquire(pyramidExtent, m_levels);
+	}
+
+	m_pyramid->Update(commandBuffer, *source, *m_output, 0.5f * m_blur, m_sourcePass, m_outputPass);
+	m_computed = true;
+}
+
 void PipelineBlur::Render(const CommandBuffer &commandBuffer)
 {
+	if (m_computed)
+	{
+		return;
+	}
+
 	if (!m_toScreen)
 	{
-		auto size = Window::Get()->GetSize();
+		auto size = Graphics::Get()->GetDisplaySize();
 
 		if (size != m_lastSize)
 		{
-			auto newSize = m_outputScale * size;
-			m_output = std::make_unique<Image2d>(newSize, nullptr, VK_FORMAT_R8G8B8A8_UNORM);
-
-			m_filterBlurVertical.SetAttachment("writeColour", m_output.get());
-			m_filterBlurHorizontal.SetAttachment("writeColour", m_output.get());
-
+			SetOutput(m_outputScale * size);
 			m_lastSize = size;
 		}
 	}
@@ -46,4 +80,34 @@ void PipelineBlur::Render(const CommandBuffer &commandBuffer)
 	m_filterBlurVertical.Render(commandBuffer);
 	m_filterBlurHorizontal.Render(commandBuffer);
 }
+
+const Image2d *PipelineBlur::GetComputeSource() const
+{
+	auto graphics = Graphics::Get();
+
+	for (uint32_t i = 0; i < GetStage().first; i++)
+	{
+		auto renderStage = graphics->GetRenderStage(i);
+
+		if (renderStage != nullptr && renderStage->GetAttachment(m_source))
+		{
+			return dynamic_cast<const Image2d *>(graphics->GetAttachment(m_source));
+		}
+	}
+
+	return nullptr;
+}
+
+void PipelineBlur::SetOutput(const Vector2ui &extent)
+{
+	if (m_output != nullptr && m_output->GetExtent() == extent)
+	{
+		return;
+	}
+
+	m_output = std::make_unique<Image2d>(extent, nullptr, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_GENERAL);
+
+	m_filterBlurVertical.SetAttachment("writeColour", m_output.get());
+	m_filterBlurHorizontal.SetAttachment("writeColour", m_output.get());
+}
 }
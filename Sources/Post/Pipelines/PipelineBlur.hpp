@@ -2,9 +2,15 @@
 
 #include "Post/Filters/FilterBlur.hpp"
 #include "Post/PostPipeline.hpp"
+#include "BlurPyramid.hpp"
 
 namespace acid
 {
+/**
+ * @brief Pipeline that blurs a attachment into a output image, used by filters such as {@link FilterDof}.
+ * When the source attachment is rendered by a earlier render stage it is blurred with a compute {@link BlurPyramid} before this stage begins,
+ * the blur type sets the number of levels so wide blurs stay cheap. Otherwise, or when drawing to the screen, two {@link FilterBlur} passes are drawn in the stage.
+ */
 class ACID_EXPORT PipelineBlur :
 	public PostPipeline
 {
@@ -12,6 +18,8 @@ public:
 	explicit PipelineBlur(const Pipeline::Stage &pipelineStage, const float &blur = 2.0f, const FilterBlur::Type &blurType = FilterBlur::Type::_9, const bool &toScreen = false,
 		const float &inputScale = 0.5f, const float &outputScale = 1.0f);
 
+	void PreRender(const CommandBuffer &commandBuffer) override;
+
 	void Render(const CommandBuffer &commandBuffer) override;
 
 	const float &GetInputScale() const { return m_inputScale; }
@@ -26,9 +34,25 @@ public:
 
 	void SetBlur(const float &blur) { m_blur = blur; }
 
+	const std::string &GetSource() const { return m_source; }
+
+	/**
+	 * Sets the attachment that is blurred by the compute pyramid.
+	 * @param source The name of the attachment.
+	 */
+	void SetSource(const std::string &source) { m_source = source; }
+
 	const Image2d *GetOutput() const { return m_output.get(); }
 
 private:
+	/**
+	 * Gets the source attachment if it is rendered by a render stage before the stage of this pipeline, so it can be blurred with compute shaders.
+	 * @return The source image, or nullptr if it is not finished before this stage.
+	 */
+	const Image2d *GetComputeSource() const;
+
+	void SetOutput(const Vector2ui &extent);
+
 	FilterBlur m_filterBlurVertical;
 	FilterBlur m_filterBlurHorizontal;
 
@@ -36,8 +60,15 @@ private:
 	float m_inputScale;
 	float m_outputScale;
 	float m_blur;
+	// Wider blur types use more pyramid levels, each level doubles the radius.
+	uint32_t m_levels;
+	std::string m_source;
 
 	std::unique_ptr<Image2d> m_output;
+	std::shared_ptr<BlurPyramid> m_pyramid;
+	BlurPyramid::Pass m_sourcePass;
+	BlurPyramid::Pass m_outputPass;
+	bool m_computed;
 	Vector2i m_lastSize;
 };
 }
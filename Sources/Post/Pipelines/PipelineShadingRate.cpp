@@ -0,0 +1,77 @@
+#include "PipelineShadingRate.hpp"
+
+#include "Graphics/Graphics.hpp"
+
+namespace acid
+{
+PipelineShadingRate::PipelineShadingRate(const Pipeline::Stage &pipelineStage, const Mode &mode, const float &threshold) :
+	PostPipeline(pipelineStage),
+	m_pipeline("Shaders/Post/ShadingRate.comp"),
+	m_descriptorSet(m_pipeline),
+	m_mode(mode),
+	m_threshold(threshold),
+	m_foveaCentre(0.5f, 0.5f),
+	m_foveaRadii(0.25f, 0.5f),
+	m_source("resolved"),
+	m_attachment("shadingRate")
+{
+}
+
+void PipelineShadingRate::PreRender(const CommandBuffer &commandBuffer)
+{
+#if defined(VK_KHR_fragment_shading_rate)
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (!logicalDevice->IsFragmentShadingRate())
+	{
+		return;
+	}
+
+	auto output = dynamic_cast<const Image2d *>(Graphics::Get()->GetAttachment(m_attachment));
+	auto source = dynamic_cast<const Image2d *>(Graphics::Get()->GetAttachment(m_source));
+
+	if (output == nullptr || source == nullptr)
+	{
+		return;
+	}
+
+	auto &texelSize = logicalDevice->GetShadingRateTexelSize();
+	m_descriptorSet.Push("PushScene", m_pushScene);
+	m_pushScene.Push("foveaCentre", m_foveaCentre);
+	m_pushScene.Push("foveaRadii", m_foveaRadii);
+	m_pushScene.Push("threshold", m_threshold);
+	m_pushScene.Push("mode", static_cast<int32_t>(m_mode));
+	m_pushScene.Push("texelSize", Vector2i(texelSize.width, texelSize.height));
+
+	m_descriptorSet.Push("writeShadingRate", output);
+	m_descriptorSet.Push("samplerColour", source);
+
+	if (!m_descriptorSet.Update(m_pipeline))
+	{
+		return;
+	}
+
+	// The source still holds last frames colour, the rates are read by this frames render pass and written again by the next frame.
+	Image::InsertImageMemoryBarrier(commandBuffer, source->GetImage(), VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, source->GetLayout(),
+		source->GetLayout(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+	Image::InsertImageMemoryBarrier(commandBuffer, output->GetImage(), VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR, VK_ACCESS_SHADER_WRITE_BIT,
+		VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+
+	m_pipeline.BindPipeline(commandBuffer);
+	m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+	m_pushScene.BindPush(commandBuffer, m_pipeline);
+	m_pipeline.CmdRender(commandBuffer, output->GetExtent());
+
+	Image::InsertImageMemoryBarrier(commandBuffer, output->GetImage(), VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR,
+		VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR,
+		VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+	Image::InsertImageMemoryBarrier(commandBuffer, source->GetImage(), VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, source->GetLayout(),
+		source->GetLayout(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, 0);
+#endif
+}
+
+void PipelineShadingRate::Render(const CommandBuffer &commandBuffer)
+{
+}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Graphics/Buffers/PushHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
+#include "Maths/Vector2.hpp"
+#include "Post/PostPipeline.hpp"
+
+namespace acid
+{
+/**
+ * @brief Pipeline that writes the shading rate attachment of its render stage before the stage begins, pipelines created with shading rates enabled
+ * such as {@link SubrenderDeferred} and the heavier filters then shade regions of low detail at coarser rates.
+ * In content mode the rate of each region is chosen from the contrast of the source attachment as it was drawn last frame, so flat sky or blurred areas are shaded once
+ * for a block of pixels. In foveated mode the rate falls off with the distance from a point, such as the centre of each eye for VR.
+ * Without variable rate shading nothing is written and every region is shaded at the full rate.
+ */
+class ACID_EXPORT PipelineShadingRate :
+	public PostPipeline
+{
+public:
+	enum class Mode
+	{
+		Content, Foveated
+	};
+
+	/**
+	 * Creates a new shading rate pipeline.
+	 * @param pipelineStage The pipelines graphics stage, its render stage must have a shading rate attachment.
+	 * @param mode How the rate of each region is chosen.
+	 * @param threshold The luminance contrast under which a region is shaded at a coarser rate, used in content mode.
+	 */
+	explicit PipelineShadingRate(const Pipeline::Stage &pipelineStage, const Mode &mode = Mode::Content, const float &threshold = 0.05f);
+
+	void PreRender(const CommandBuffer &commandBuffer) override;
+
+	void Render(const CommandBuffer &commandBuffer) override;
+
+	const Mode &GetMode() const { return m_mode; }
+
+	void SetMode(const Mode &mode) { m_mode = mode; }
+
+	const float &GetThreshold() const { return m_threshold; }
+
+	void SetThreshold(const float &threshold) { m_threshold = threshold; }
+
+	const Vector2f &GetFoveaCentre() const { return m_foveaCentre; }
+
+	/**
+	 * Sets the point the rate falls off from in foveated mode.
+	 * @param foveaCentre The point in screen coordinates from 0 to 1.
+	 */
+	void SetFoveaCentre(const Vector2f &foveaCentre) { m_foveaCentre = foveaCentre; }
+
+	const Vector2f &GetFoveaRadii() const { return m_foveaRadii; }
+
+	/**
+	 * Sets the distances from the fovea centre in foveated mode, regions within the first are shaded at the full rate and those beyond the second at the coarsest rate.
+	 * @param foveaRadii The inner and outer radius relative to the height of the stage.
+	 */
+	void SetFoveaRadii(const Vector2f &foveaRadii) { m_foveaRadii = foveaRadii; }
+
+	const std::string &GetSource() const { return m_source; }
+
+	/**
+	 * Sets the attachment whose contrast chooses the rates in content mode.
+	 * @param source The name of the attachment.
+	 */
+	void SetSource(const std::string &source) { m_source = source; }
+
+	const std::string &GetAttachment() const { return m_attachment; }
+
+	/**
+	 * Sets the shading rate attachment that is written.
+	 * @param attachment The name of the attachment.
+	 */
+	void SetAttachment(const std::string &attachment) { m_attachment = attachment; }
+
+private:
+	PipelineCompute m_pipeline;
+	DescriptorsHandler m_descriptorSet;
+	PushHandler m_pushScene;
+
+	Mode m_mode;
+	float m_threshold;
+	Vector2f m_foveaCentre;
+	Vector2f m_foveaRadii;
+	std::string m_source;
+	std::string m_attachment;
+};
+}
@@ -19,8 +19,10 @@ public:
 	 * @param pipelineStage The pipelines graphics stage.
 	 * @param shaderStages The pipelines shader stages.
 	 * @param defines A list of names that will be added as a define.
+	 * @param shadingRate If the filter is shaded at the rates of the stages shading rate attachment, its fragment shader must store to every pixel of a coarse fragment.
 	 */
-	PostFilter(const Pipeline::Stage &pipelineStage, const std::vector<std::string> &shaderStages, const std::vector<Shader::Define> &defines = {});
+	PostFilter(const Pipeline::Stage &pipelineStage, const std::vector<std::string> &shaderStages, const std::vector<Shader::Define> &defines = {},
+		const bool &shadingRate = false);
 
 	virtual ~PostFilter() = default;
 
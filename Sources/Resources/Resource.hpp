@@ -22,5 +22,17 @@ public:
 	virtual void Load()
 	{
 	}
+
+	/**
+	 * Gets the system memory held by the resource, cached resources are kept within the CPU budget of acid::Resources.
+	 * @return The size in bytes.
+	 */
+	virtual std::size_t GetCpuSize() const { return 0; }
+
+	/**
+	 * Gets the device memory held by the resource, cached resources are kept within the GPU budget of acid::Resources.
+	 * @return The size in bytes.
+	 */
+	virtual std::size_t GetGpuSize() const { return 0; }
 };
 }
@@ -0,0 +1,79 @@
+#include "ResourceRequest.hpp"
+
+namespace acid
+{
+ResourceRequest::ResourceRequest(LoadFunction &&load, const float &priority, std::shared_ptr<Resource> placeholder,
+	std::vector<std::shared_ptr<ResourceRequest>> dependencies) :
+	m_load(std::move(load)),
+	m_placeholder(std::move(placeholder)),
+	m_dependencies(std::move(dependencies)),
+	m_status(Status::Queued),
+	m_priority(priority),
+	m_effectivePriority(priority)
+{
+}
+
+const std::shared_ptr<Resource> &ResourceRequest::GetResource() const
+{
+	// The resource is set before the status is published as loaded.
+	return GetStatus() == Status::Loaded ? m_resource : m_placeholder;
+}
+
+bool ResourceRequest::IsDone() const
+{
+	auto status = GetStatus();
+	return status != Status::Queued && status != Status::Loading;
+}
+
+bool ResourceRequest::Cancel()
+{
+	auto status = Status::Queued;
+
+	if (m_status.compare_exchange_strong(status, Status::Cancelled, std::memory_order_acq_rel))
+	{
+		return true;
+	}
+
+	status = Status::Loading;
+	return m_status.compare_exchange_strong(status, Status::Cancelled, std::memory_order_acq_rel);
+}
+
+bool ResourceRequest::IsReady() const
+{
+	for (const auto &dependency : m_dependencies)
+	{
+		if (!dependency->IsDone())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ResourceRequest::Propagate(const float &priority)
+{
+	for (const auto &dependency : m_dependencies)
+	{
+		if (dependency->GetStatus() == Status::Queued && dependency->m_effectivePriority < priority)
+		{
+			dependency->m_effectivePriority = priority;
+			dependency->Propagate(priority);
+		}
+	}
+}
+
+void ResourceRequest::Run()
+{
+	auto resource = m_load();
+	m_load = nullptr;
+	m_resource = resource;
+	auto status = Status::Loading;
+
+	// A request cancelled while it was loading keeps the placeholder, the resource is released by the resources module once unused.
+	if (!m_status.compare_exchange_strong(status, resource != nullptr ? Status::Loaded : Status::Failed, std::memory_order_acq_rel))
+	{
+		m_resource = nullptr;
+	}
+}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include "Resource.hpp"
+
+namespace acid
+{
+/**
+ * @brief A request to load a resource on the resource thread pool, created by {@link Resources#Request}.
+ * Queued requests are loaded highest priority first, their priority can be changed until they start loading, such as from their distance or if they are on screen.
+ * A request waits for the requests it depends on, such as a material on its images, and those load with at least the priority of the requests waiting on them.
+ * Until it has loaded the request gives its placeholder in place of the resource.
+ * A queued request is cancelled when it is cancelled explicitly or when no handle to it remains, a request that is loading finishes but its resource is discarded.
+ */
+class ACID_EXPORT ResourceRequest
+{
+public:
+	enum class Status
+	{
+		Queued, Loading, Loaded, Failed, Cancelled
+	};
+
+	using LoadFunction = std::function<std::shared_ptr<Resource>()>;
+
+	/**
+	 * Creates a request, use {@link Resources#Request} to queue it.
+	 * @param load The function that loads the resource, it returns nullptr if the resource failed to load.
+	 * @param priority The priority of the request.
+	 * @param placeholder The resource given until the request has loaded.
+	 * @param dependencies The requests that must finish before this request loads.
+	 */
+	ResourceRequest(LoadFunction &&load, const float &priority, std::shared_ptr<Resource> placeholder = nullptr,
+		std::vector<std::shared_ptr<ResourceRequest>> dependencies = {});
+
+	/**
+	 * Gets the loaded resource, or the placeholder if the request has not loaded.
+	 * @return The resource.
+	 */
+	const std::shared_ptr<Resource> &GetResource() const;
+
+	/**
+	 * Gets the loaded resource cast to a type, or the placeholder if the request has not loaded.
+	 * @tparam T The resource type.
+	 * @return The resource, or nullptr if it is not of the type.
+	 */
+	template<typename T>
+	std::shared_ptr<T> Get() const { return std::dynamic_pointer_cast<T>(GetResource()); }
+
+	Status GetStatus() const { return m_status.load(std::memory_order_acquire); }
+
+	/**
+	 * Gets if the request has loaded, failed or was cancelled.
+	 * @return If the request has finished.
+	 */
+	bool IsDone() const;
+
+	bool IsLoaded() const { return GetStatus() == Status::Loaded; }
+
+	float GetPriority() const { return m_priority.load(std::memory_order_relaxed); }
+
+	/**
+	 * Sets the priority of the request, this only changes the order it loads in while it is queued.
+	 * @param priority The new priority.
+	 */
+	void SetPriority(const float &priority) { m_priority.store(priority, std::memory_order_relaxed); }
+
+	/**
+	 * Cancels the request, the requests it depends on are cancelled once nothing else holds them.
+	 * @return If the request was queued or loading, otherwise it has already finished.
+	 */
+	bool Cancel();
+
+private:
+	friend class Resources;
+
+	/**
+	 * Gets if every request this request depends on has finished.
+	 * @return If the request can load.
+	 */
+	bool IsReady() const;
+
+	/**
+	 * Raises the priority the requests this request depends on are loaded with to at least its own.
+	 * @param priority The priority of the requests waiting on this request.
+	 */
+	void Propagate(const float &priority);
+
+	void Run();
+
+	LoadFunction m_load;
+	std::shared_ptr<Resource> m_placeholder;
+	std::shared_ptr<Resource> m_resource;
+	std::vector<std::shared_ptr<ResourceRequest>> m_dependencies;
+
+	std::atomic<Status> m_status;
+	std::atomic<float> m_priority;
+	/// The priority this request is loaded with, updated by the resources module while the request is queued.
+	float m_effectivePriority;
+};
+}
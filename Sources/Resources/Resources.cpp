@@ -3,68 +3,394 @@
 namespace acid
 {
 Resources::Resources() :
-	m_timerPurge(Time::Seconds(4.0f))
+	m_sweepShard(0),
+	m_cpuSize(0),
+	m_gpuSize(0),
+	m_cpuBudget(256 * 1024 * 1024),
+	m_gpuBudget(512 * 1024 * 1024),
+	m_releasedLifetime(Time::Seconds(4.0f)),
+	m_loading(0)
 {
 }
 
+Resources::~Resources()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+
+		for (auto &request : m_requests)
+		{
+			request->Cancel();
+		}
+
+		m_requests.clear();
+	}
+
+	m_threadPool.Wait();
+}
+
 void Resources::Update()
 {
-	if (m_timerPurge.IsPassedTime())
+	DispatchRequests();
+	Sweep();
+}
+
+std::shared_ptr<Resource> Resources::Find(const Metadata &metadata) const
+{
+	auto hash = metadata.GetHash();
+	auto &shard = GetShard(hash);
+	std::lock_guard<std::mutex> lock(shard.m_mutex);
+	return Find(shard, hash, metadata);
+}
+
+void Resources::Add(const Metadata &metadata, const std::shared_ptr<Resource> &resource)
+{
+	auto hash = metadata.GetHash();
+	auto &shard = GetShard(hash);
+	std::lock_guard<std::mutex> lock(shard.m_mutex);
+	Insert(shard, hash, metadata, resource);
+}
+
+void Resources::Remove(const std::shared_ptr<Resource> &resource)
+{
+	// The shard is not known from the resource, removing is rare so every shard is searched.
+	for (auto &shard : m_shards)
 	{
-		m_timerPurge.ResetStartTime();
+		// The resource is released after unlocking.
+		std::shared_ptr<Resource> removed;
+
+		{
+			std::lock_guard<std::mutex> lock(shard.m_mutex);
+			removed = Erase(shard, resource.get());
+		}
 
-		for (auto it = m_resources.begin(); it != m_resources.end();)
+		if (removed != nullptr)
 		{
-			if ((*it).second.use_count() <= 1)
+			return;
+		}
+	}
+}
+
+std::size_t Resources::GetCpuSize() const
+{
+	return m_cpuSize.load(std::memory_order_relaxed);
+}
+
+std::size_t Resources::GetGpuSize() const
+{
+	return m_gpuSize.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<Resource> Resources::FindOrLoadResource(const Metadata &metadata, const std::function<std::shared_ptr<Resource>()> &load)
+{
+	auto hash = metadata.GetHash();
+	auto &shard = GetShard(hash);
+	std::promise<std::shared_ptr<Resource>> promise;
+
+	{
+		std::unique_lock<std::mutex> lock(shard.m_mutex);
+
+		if (auto resource = Find(shard, hash, metadata))
+		{
+			return resource;
+		}
+
+		auto range = shard.m_loading.equal_range(hash);
+
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			auto &loading = (*it).second;
+
+			if (*loading.m_metadata != metadata)
 			{
-				it = m_resources.erase(it);
 				continue;
 			}
 
-			++it;
+			// Waiting on a load from the thread running it would never return.
+			if (loading.m_thread == std::this_thread::get_id())
+			{
+				Log::Error("Resource depends on itself while loading\n");
+				return nullptr;
+			}
+
+			auto future = loading.m_future;
+			lock.unlock();
+			return future.get();
+		}
+
+		Loading loading;
+		loading.m_metadata.reset(metadata.Clone());
+		loading.m_future = promise.get_future().share();
+		loading.m_thread = std::this_thread::get_id();
+		shard.m_loading.emplace(hash, std::move(loading));
+	}
+
+	auto resource = load();
+
+	{
+		std::lock_guard<std::mutex> lock(shard.m_mutex);
+		auto range = shard.m_loading.equal_range(hash);
+
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (*(*it).second.m_metadata == metadata)
+			{
+				shard.m_loading.erase(it);
+				break;
+			}
+		}
+
+		if (resource != nullptr)
+		{
+			Insert(shard, hash, metadata, resource);
 		}
 	}
+
+	promise.set_value(resource);
+	return resource;
 }
 
-std::shared_ptr<Resource> Resources::Find(const Metadata &metadata) const
+std::shared_ptr<Resource> Resources::Find(const Shard &shard, const std::size_t &hash, const Metadata &metadata)
 {
-	for (const auto &[key, resource] : m_resources)
+	auto range = shard.m_resources.equal_range(hash);
+
+	for (auto it = range.first; it != range.second; ++it)
 	{
-		if (*key == metadata)
+		auto &entry = shard.m_entries.at((*it).second);
+
+		if (*entry.m_metadata == metadata)
 		{
-			return resource;
+			entry.m_referenced = true;
+			return entry.m_resource;
 		}
 	}
 
 	return nullptr;
-	/*auto it = m_resources.find(metadata);
+}
+
+void Resources::Insert(Shard &shard, const std::size_t &hash, const Metadata &metadata, const std::shared_ptr<Resource> &resource)
+{
+	auto range = shard.m_resources.equal_range(hash);
+
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (*shard.m_entries.at((*it).second).m_metadata == metadata)
+		{
+			return;
+		}
+	}
 
-	if (it == m_resources.end())
+	if (shard.m_entries.find(resource.get()) != shard.m_entries.end())
+	{
+		return;
+	}
+
+	Entry entry;
+	entry.m_metadata.reset(metadata.Clone());
+	entry.m_resource = resource;
+	entry.m_hash = hash;
+	entry.m_clockIndex = shard.m_clock.size();
+
+	shard.m_resources.emplace(hash, resource.get());
+	shard.m_entries.emplace(resource.get(), std::move(entry));
+	shard.m_clock.emplace_back(resource.get());
+}
+
+std::shared_ptr<Resource> Resources::Erase(Shard &shard, Resource *resource)
+{
+	auto it = shard.m_entries.find(resource);
+
+	if (it == shard.m_entries.end())
 	{
 		return nullptr;
 	}
 
-	return it->second;*/
+	auto &entry = it->second;
+	auto range = shard.m_resources.equal_range(entry.m_hash);
+
+	for (auto resourceIt = range.first; resourceIt != range.second; ++resourceIt)
+	{
+		if ((*resourceIt).second == resource)
+		{
+			shard.m_resources.erase(resourceIt);
+			break;
+		}
+	}
+
+	// The last resource in the clock takes the place of the removed one.
+	auto last = shard.m_clock.back();
+	shard.m_clock[entry.m_clockIndex] = last;
+	shard.m_entries.at(last).m_clockIndex = entry.m_clockIndex;
+	shard.m_clock.pop_back();
+
+	m_cpuSize.fetch_sub(entry.m_cpuSize, std::memory_order_relaxed);
+	m_gpuSize.fetch_sub(entry.m_gpuSize, std::memory_order_relaxed);
+
+	auto result = std::move(entry.m_resource);
+	shard.m_entries.erase(it);
+	return result;
 }
 
-void Resources::Add(const Metadata &metadata, const std::shared_ptr<Resource> &resource)
+void Resources::Sweep()
 {
-	if (Find(metadata) != nullptr)
+	// Evicted resources are destroyed after unlocking, their destructors may release other resources.
+	std::vector<std::shared_ptr<Resource>> evicted;
+	auto now = Engine::GetTime();
+
+	// Each update starts from the next shard, so shards are visited evenly when the sweep size does not divide between them.
+	for (std::size_t s = 0; s < ShardCount; s++)
 	{
-		return;
+		auto &shard = m_shards[(m_sweepShard + s) % ShardCount];
+		auto visits = SweepSize / ShardCount + (s < SweepSize % ShardCount ? 1 : 0);
+		std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+		for (std::size_t i = 0; i < visits && !shard.m_clock.empty(); i++)
+		{
+			if (shard.m_clockHand >= shard.m_clock.size())
+			{
+				shard.m_clockHand = 0;
+			}
+
+			auto resource = shard.m_clock[shard.m_clockHand];
+			auto &entry = shard.m_entries.at(resource);
+
+			// Sizes change while resources are used, such as images streaming mip levels, so they are measured again on every visit.
+			auto cpuSize = entry.m_resource->GetCpuSize();
+			auto gpuSize = entry.m_resource->GetGpuSize();
+			m_cpuSize.fetch_add(cpuSize - entry.m_cpuSize, std::memory_order_relaxed);
+			m_gpuSize.fetch_add(gpuSize - entry.m_gpuSize, std::memory_order_relaxed);
+			entry.m_cpuSize = cpuSize;
+			entry.m_gpuSize = gpuSize;
+
+			if (entry.m_resource.use_count() > 1)
+			{
+				entry.m_referenced = true;
+				entry.m_releasedTime = std::nullopt;
+				shard.m_clockHand++;
+				continue;
+			}
+
+			if (!entry.m_releasedTime)
+			{
+				entry.m_releasedTime = now;
+			}
+
+			auto overBudget = (GetCpuSize() > m_cpuBudget && entry.m_cpuSize != 0) || (GetGpuSize() > m_gpuBudget && entry.m_gpuSize != 0);
+			auto expired = entry.m_cpuSize == 0 && entry.m_gpuSize == 0 && now - *entry.m_releasedTime > m_releasedLifetime;
+
+			if (!overBudget && !expired)
+			{
+				shard.m_clockHand++;
+				continue;
+			}
+
+			// A resource used or found since the sweep last passed it is kept for another pass.
+			if (overBudget && entry.m_referenced)
+			{
+				entry.m_referenced = false;
+				shard.m_clockHand++;
+				continue;
+			}
+
+			// The hand stays, the last resource in the clock was moved to it.
+			evicted.emplace_back(Erase(shard, resource));
+		}
 	}
 
-	m_resources.emplace(metadata.Clone(), resource);
+	m_sweepShard = (m_sweepShard + 1) % ShardCount;
 }
 
-void Resources::Remove(const std::shared_ptr<Resource> &resource)
+void Resources::Request(const std::shared_ptr<ResourceRequest> &request)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_requests.emplace_back(request);
+	}
+
+	DispatchRequests();
+}
+
+std::size_t Resources::GetRequestCount() const
+{
+	std::lock_guard<std::mutex> lock(m_requestMutex);
+	return m_requests.size();
+}
+
+void Resources::DispatchRequests()
 {
-	for (auto it = m_resources.begin(); it != m_resources.end(); ++it) // TODO: Clean remove.
+	std::lock_guard<std::mutex> lock(m_requestMutex);
+
+	// Dropping a request releases its dependencies, which may then be held by nothing else.
+	for (auto dropped = true; dropped;)
 	{
-		if ((*it).second == resource)
+		dropped = false;
+
+		for (auto it = m_requests.begin(); it != m_requests.end();)
 		{
-			m_resources.erase(it);
+			auto &request = *it;
+
+			if (request->GetStatus() != ResourceRequest::Status::Queued || request.use_count() <= 1)
+			{
+				request->Cancel();
+				request->m_dependencies.clear();
+				it = m_requests.erase(it);
+				dropped = true;
+				continue;
+			}
+
+			++it;
 		}
 	}
+
+	for (auto &request : m_requests)
+	{
+		request->m_effectivePriority = request->GetPriority();
+	}
+
+	for (auto &request : m_requests)
+	{
+		request->Propagate(request->m_effectivePriority);
+	}
+
+	while (m_loading < std::max<std::size_t>(m_threadPool.GetWorkers().size(), 1))
+	{
+		auto next = m_requests.end();
+
+		for (auto it = m_requests.begin(); it != m_requests.end(); ++it)
+		{
+			if ((*it)->IsReady() && (next == m_requests.end() || (*it)->m_effectivePriority > (*next)->m_effectivePriority))
+			{
+				next = it;
+			}
+		}
+
+		if (next == m_requests.end())
+		{
+			break;
+		}
+
+		auto request = *next;
+		m_requests.erase(next);
+		auto status = ResourceRequest::Status::Queued;
+
+		// The request may have been cancelled since the queue was cleaned.
+		if (!request->m_status.compare_exchange_strong(status, ResourceRequest::Status::Loading, std::memory_order_acq_rel))
+		{
+			continue;
+		}
+
+		m_loading++;
+		m_threadPool.Dispatch([this, request]()
+		{
+			request->Run();
+
+			{
+				std::lock_guard<std::mutex> lock(m_requestMutex);
+				m_loading--;
+			}
+
+			DispatchRequests();
+		});
+	}
 }
 }
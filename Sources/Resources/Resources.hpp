@@ -1,15 +1,21 @@
 #pragma once
 
 #include "Engine/Engine.hpp"
+#include "Engine/MemoryTracker.hpp"
 #include "Helpers/ThreadPool.hpp"
 #include "Maths/Timer.hpp"
 #include "Serialized/Metadata.hpp"
 #include "Resource.hpp"
+#include "ResourceRequest.hpp"
 
 namespace acid
 {
 /**
  * @brief Module used for managing resources.
+ * Resources stay cached after their last user releases them, released resources are evicted by a CLOCK sweep once the sizes of all cached resources exceed the CPU or GPU budget.
+ * Resources found again since the sweep last passed them get a second chance, released resources that report no size are evicted once they have been released for the released lifetime.
+ * Every update the sweep visits a bounded number of resources, so the cache is never scanned at once.
+ * The cache is split into shards by the hash of the metadata, each with its own lock, so resources can be created from loaders on the thread pool while others are found.
  */
 class ACID_EXPORT Resources :
 	public Module
@@ -23,14 +29,109 @@ public:
 
 	Resources();
 
+	~Resources();
+
 	void Update() override;
 
+	/**
+	 * Finds a resource that was added with metadata equal to the given metadata, resources can be found and added from any thread.
+	 * @param metadata The metadata the resource was created from.
+	 * @return The resource, or nullptr if none was found.
+	 */
 	std::shared_ptr<Resource> Find(const Metadata &metadata) const;
 
+	/**
+	 * Finds a resource that was added with metadata equal to the given metadata, or loads it with a function and adds it.
+	 * Threads loading the same metadata at the same time share the first load, the others wait for it to finish.
+	 * @tparam T The resource type.
+	 * @tparam F The function type.
+	 * @param metadata The metadata the resource is created from.
+	 * @param load The function that loads the resource, it is called without any lock held and returns nullptr if the resource failed to load.
+	 * @return The resource, or nullptr if it failed to load or is not of the type.
+	 */
+	template<typename T, typename F>
+	std::shared_ptr<T> FindOrLoad(const Metadata &metadata, F &&load)
+	{
+		return std::dynamic_pointer_cast<T>(FindOrLoadResource(metadata, [&load]()
+		{
+			return std::static_pointer_cast<Resource>(load());
+		}));
+	}
+
 	void Add(const Metadata &metadata, const std::shared_ptr<Resource> &resource);
 
 	void Remove(const std::shared_ptr<Resource> &resource);
 
+	/**
+	 * Gets the system memory held by cached resources, as last measured by the sweep.
+	 * @return The size in bytes.
+	 */
+	std::size_t GetCpuSize() const;
+
+	/**
+	 * Gets the device memory held by cached resources, as last measured by the sweep.
+	 * @return The size in bytes.
+	 */
+	std::size_t GetGpuSize() const;
+
+	const std::size_t &GetCpuBudget() const { return m_cpuBudget; }
+
+	void SetCpuBudget(const std::size_t &cpuBudget) { m_cpuBudget = cpuBudget; }
+
+	const std::size_t &GetGpuBudget() const { return m_gpuBudget; }
+
+	void SetGpuBudget(const std::size_t &gpuBudget) { m_gpuBudget = gpuBudget; }
+
+	const Time &GetReleasedLifetime() const { return m_releasedLifetime; }
+
+	void SetReleasedLifetime(const Time &releasedLifetime) { m_releasedLifetime = releasedLifetime; }
+
+	/// The most cached resources the sweep visits each update, spread evenly over the shards.
+	static constexpr std::size_t SweepSize = 64;
+	/// The number of shards the cache is split into.
+	static constexpr std::size_t ShardCount = 16;
+
+	/**
+	 * Queues a request to load a resource from its metadata with T::Create, a resource already added is given to the request right away.
+	 * @tparam T The resource type.
+	 * @param metadata The metadata the resource is created from.
+	 * @param priority The priority of the request, higher priorities are loaded first.
+	 * @param placeholder The resource given until the request has loaded.
+	 * @param dependencies The requests that must finish before this request loads.
+	 * @return The request, it is cancelled once it is no longer held.
+	 */
+	template<typename T>
+	std::shared_ptr<ResourceRequest> Request(const Metadata &metadata, const float &priority = 0.0f, std::shared_ptr<T> placeholder = nullptr,
+		std::vector<std::shared_ptr<ResourceRequest>> dependencies = {})
+	{
+		auto request = std::make_shared<ResourceRequest>([metadata = std::shared_ptr<Metadata>(metadata.Clone())]()
+		{
+			return std::static_pointer_cast<Resource>(T::Create(*metadata));
+		}, priority, std::move(placeholder), std::move(dependencies));
+
+		if (auto resource = std::dynamic_pointer_cast<T>(Find(metadata)))
+		{
+			request->m_resource = resource;
+			request->m_status = ResourceRequest::Status::Loaded;
+			return request;
+		}
+
+		Request(request);
+		return request;
+	}
+
+	/**
+	 * Queues a request to load a resource with a function.
+	 * @param request The request.
+	 */
+	void Request(const std::shared_ptr<ResourceRequest> &request);
+
+	/**
+	 * Gets the number of requests that are queued.
+	 * @return The number of requests.
+	 */
+	std::size_t GetRequestCount() const;
+
 	/**
 	 * Gets the resource loader thread pool.
 	 * @return The resource loader thread pool.
@@ -38,8 +139,93 @@ public:
 	ThreadPool &GetThreadPool() { return m_threadPool; }
 
 private:
-	std::map<std::unique_ptr<Metadata>, std::shared_ptr<Resource>> m_resources;
-	Timer m_timerPurge;
+	class Entry
+	{
+	public:
+		std::unique_ptr<Metadata> m_metadata;
+		std::shared_ptr<Resource> m_resource;
+		std::size_t m_hash = 0;
+		/// The position of the resource in the clock.
+		std::size_t m_clockIndex = 0;
+		std::size_t m_cpuSize = 0;
+		std::size_t m_gpuSize = 0;
+		/// Set when the resource is used or found, cleared by the sweep before the resource is evicted.
+		mutable bool m_referenced = true;
+		std::optional<Time> m_releasedTime;
+	};
+
+	/// A resource being loaded by {@link Resources#FindOrLoad}, waited on by other threads loading the same metadata.
+	class Loading
+	{
+	public:
+		std::unique_ptr<Metadata> m_metadata;
+		std::shared_future<std::shared_ptr<Resource>> m_future;
+		std::thread::id m_thread;
+	};
+
+	class Shard
+	{
+	public:
+		// Resources keyed by the hash of the metadata they were created from, colliding hashes share a key.
+		TrackedUnorderedMultimap<std::size_t, Resource *, MemoryTag::Resources> m_resources;
+		TrackedUnorderedMap<Resource *, Entry, MemoryTag::Resources> m_entries;
+		TrackedUnorderedMultimap<std::size_t, Loading, MemoryTag::Resources> m_loading;
+		// The resources in the order the sweep visits them.
+		TrackedVector<Resource *, MemoryTag::Resources> m_clock;
+		std::size_t m_clockHand = 0;
+		mutable std::mutex m_mutex;
+	};
+
+	Shard &GetShard(const std::size_t &hash) { return m_shards[hash % ShardCount]; }
+
+	const Shard &GetShard(const std::size_t &hash) const { return m_shards[hash % ShardCount]; }
+
+	std::shared_ptr<Resource> FindOrLoadResource(const Metadata &metadata, const std::function<std::shared_ptr<Resource>()> &load);
+
+	/**
+	 * Finds a resource in a shard, the caller must hold the lock of the shard.
+	 * @param shard The shard of the hash.
+	 * @param hash The hash of the metadata.
+	 * @param metadata The metadata the resource was created from.
+	 * @return The resource, or nullptr if none was found.
+	 */
+	static std::shared_ptr<Resource> Find(const Shard &shard, const std::size_t &hash, const Metadata &metadata);
+
+	/**
+	 * Adds a resource to a shard, the caller must hold the lock of the shard.
+	 * @param shard The shard of the hash.
+	 * @param hash The hash of the metadata.
+	 * @param metadata The metadata the resource was created from.
+	 * @param resource The resource.
+	 */
+	static void Insert(Shard &shard, const std::size_t &hash, const Metadata &metadata, const std::shared_ptr<Resource> &resource);
+
+	/**
+	 * Removes a resource from a shard, the caller must hold the lock of the shard.
+	 * @param shard The shard the resource is in.
+	 * @param resource The resource.
+	 * @return The resource removed, released by the caller after unlocking.
+	 */
+	std::shared_ptr<Resource> Erase(Shard &shard, Resource *resource);
+
+	void Sweep();
+
+	std::array<Shard, ShardCount> m_shards;
+	std::size_t m_sweepShard;
+	std::atomic<std::size_t> m_cpuSize;
+	std::atomic<std::size_t> m_gpuSize;
+	std::size_t m_cpuBudget;
+	std::size_t m_gpuBudget;
+	Time m_releasedLifetime;
+
+	/**
+	 * Drops requests that were cancelled or are no longer held, and starts loading the highest priority requests that are ready while a worker is free.
+	 */
+	void DispatchRequests();
+
+	std::vector<std::shared_ptr<ResourceRequest>> m_requests;
+	uint32_t m_loading;
+	mutable std::mutex m_requestMutex;
 
 	ThreadPool m_threadPool;
 };
@@ -0,0 +1,33 @@
+#include "Camera.hpp"
+
+namespace acid
+{
+Matrix4 Camera::GetJitteredProjectionMatrix() const
+{
+	return GetJitteredMatrix(m_projectionMatrix);
+}
+
+Matrix4 Camera::GetJitteredProjectionMatrix(const uint32_t &view) const
+{
+	return GetJitteredMatrix(GetProjectionMatrix(view));
+}
+
+Matrix4 Camera::GetJitteredMatrix(const Matrix4 &projectionMatrix) const
+{
+	if (m_jitter == Vector2f())
+	{
+		return projectionMatrix;
+	}
+
+	// Translates clip space after the projection, so the offset in normalized device coordinates is the same for perspective and orthographic projections.
+	auto result = projectionMatrix;
+
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		result[i][0] += m_jitter.m_x * result[i][3];
+		result[i][1] += m_jitter.m_y * result[i][3];
+	}
+
+	return result;
+}
+}
@@ -15,6 +15,16 @@ class ACID_EXPORT Camera :
 	public Component
 {
 public:
+	/**
+	 * @brief The matrices of one view drawn by a multiview render stage, such as an eye of a stereo display.
+	 */
+	class View
+	{
+	public:
+		Matrix4 m_viewMatrix;
+		Matrix4 m_projectionMatrix;
+	};
+
 	Camera() :
 		m_nearPlane(0.1f),
 		m_farPlane(1000.0f),
@@ -67,6 +77,24 @@ public:
 	 */
 	const Matrix4 &GetProjectionMatrix() const { return m_projectionMatrix; }
 
+	/**
+	 * Gets the projection matrix offset by the jitter, scene geometry is rendered with this so temporal filters can resolve detail smaller than a pixel.
+	 * @return The jittered projection matrix, the same as the projection matrix when there is no jitter.
+	 */
+	Matrix4 GetJitteredProjectionMatrix() const;
+
+	/**
+	 * Gets the offset applied to the projection in normalized device coordinates.
+	 * @return The projection jitter.
+	 */
+	const Vector2f &GetJitter() const { return m_jitter; }
+
+	/**
+	 * Sets the offset applied to the projection, this is set each frame by temporal filters such as {@link FilterTaa}.
+	 * @param jitter The projection jitter in normalized device coordinates.
+	 */
+	void SetJitter(const Vector2f &jitter) { m_jitter = jitter; }
+
 	/**
 	 * Gets the view frustum created by the current camera position and rotation.
 	 * @return The view frustum created by the current camera position and rotation.
@@ -79,7 +107,38 @@ public:
 	 */
 	const Ray &GetViewRay() const { return m_viewRay; }
 
+	const std::vector<View> &GetViews() const { return m_views; }
+
+	/**
+	 * Sets the matrices of each view drawn by multiview render stages, without them every view is drawn with the camera matrices.
+	 * @param views The matrices of each view.
+	 */
+	void SetViews(std::vector<View> views) { m_views = std::move(views); }
+
+	/**
+	 * Gets the view matrix of a view drawn by a multiview render stage.
+	 * @param view The index of the view.
+	 * @return The view matrix of the view, the camera view matrix if the view is not set.
+	 */
+	const Matrix4 &GetViewMatrix(const uint32_t &view) const { return view < m_views.size() ? m_views[view].m_viewMatrix : m_viewMatrix; }
+
+	/**
+	 * Gets the projection matrix of a view drawn by a multiview render stage.
+	 * @param view The index of the view.
+	 * @return The projection matrix of the view, the camera projection matrix if the view is not set.
+	 */
+	const Matrix4 &GetProjectionMatrix(const uint32_t &view) const { return view < m_views.size() ? m_views[view].m_projectionMatrix : m_projectionMatrix; }
+
+	/**
+	 * Gets the projection matrix of a view drawn by a multiview render stage offset by the jitter.
+	 * @param view The index of the view.
+	 * @return The jittered projection matrix of the view.
+	 */
+	Matrix4 GetJitteredProjectionMatrix(const uint32_t &view) const;
+
 protected:
+	Matrix4 GetJitteredMatrix(const Matrix4 &projectionMatrix) const;
+
 	float m_nearPlane;
 	float m_farPlane;
 	float m_fieldOfView;
@@ -90,6 +149,8 @@ protected:
 
 	Matrix4 m_viewMatrix;
 	Matrix4 m_projectionMatrix;
+	Vector2f m_jitter;
+	std::vector<View> m_views;
 
 	Frustum m_viewFrustum;
 	Ray m_viewRay;
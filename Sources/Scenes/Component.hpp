@@ -2,6 +2,8 @@
 
 #include "Serialized/Metadata.hpp"
 #include "Helpers/Delegate.hpp"
+#include "Helpers/TypeInfo.hpp"
+#include "Maths/Time.hpp"
 
 namespace acid
 {
@@ -14,11 +16,23 @@ class ACID_EXPORT Component :
 	public Observer
 {
 public:
+	/**
+	 * @brief How often a component is updated. Components that are not always updated share the update budget of the {@link SceneStructure},
+	 * ones that waited longest, are near the camera, and have a high priority are updated first.
+	 */
+	enum class UpdatePriority
+	{
+		Always, High, Low
+	};
+
 	Component() :
 		m_started(false),
 		m_enabled(true),
 		m_removed(false),
-		m_parent(nullptr)
+		m_parent(nullptr),
+		m_updatePriority(UpdatePriority::Always),
+		m_threadSafe(false),
+		m_updateFrame(0)
 	{
 	}
 
@@ -32,12 +46,32 @@ public:
 	}
 
 	/**
-	 * Run when updating the entity this is attached to.
+	 * Run when updating the entity this is attached to, or when the scheduler of the structure reaches this component if it is not always updated.
 	 */
 	virtual void Update()
 	{
 	}
 
+	const UpdatePriority &GetUpdatePriority() const { return m_updatePriority; }
+
+	void SetUpdatePriority(const UpdatePriority &updatePriority) { m_updatePriority = updatePriority; }
+
+	/**
+	 * Gets if the update only reads other components and entities and writes the state of this component, so components that are always updated
+	 * can be updated on the job system at the same time. Structural changes made while updating, such as adding or removing entities and components,
+	 * are deferred until every parallel update has finished. Start is always run on the thread updating the structure.
+	 * @return If the update is thread safe.
+	 */
+	const bool &IsThreadSafe() const { return m_threadSafe; }
+
+	void SetThreadSafe(const bool &threadSafe) { m_threadSafe = threadSafe; }
+
+	/**
+	 * Gets the time since this component was last updated, components that are not always updated can skip frames so should use this in place of the engines delta.
+	 * @return The time between the last two updates.
+	 */
+	const Time &GetUpdateDelta() const { return m_updateDelta; }
+
 	const bool &IsEnabled() const { return m_enabled; };
 
 	void SetEnabled(const bool &enable) { m_enabled = enable; }
@@ -60,10 +94,31 @@ public:
 
 private:
 	friend class Entity;
+	friend class SceneStructure;
 	bool m_started;
 	bool m_enabled;
 	bool m_removed;
 	Entity *m_parent;
+	UpdatePriority m_updatePriority;
+	bool m_threadSafe;
+	// The update of the structure this component was last updated in, and when.
+	uint64_t m_updateFrame;
+	Time m_updateTime;
+	Time m_updateDelta;
 };
 
+template class ACID_EXPORT TypeInfo<Component>;
+
+/**
+ * Gets the Type ID for the Component.
+ * @tparam T The Component type.
+ * @return The Type ID.
+ */
+template<typename T>
+TypeId GetComponentTypeId() noexcept
+{
+	static_assert(std::is_base_of<Component, T>::value, "T must be a Component.");
+
+	return TypeInfo<Component>::GetTypeId<T>();
+}
 }
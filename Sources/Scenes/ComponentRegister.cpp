@@ -1,6 +1,18 @@
 #include "ComponentRegister.hpp"
 
+#include "Network/Replication/Replicated.hpp"
+#include "Physics/Colliders/ColliderCapsule.hpp"
+#include "Physics/Colliders/ColliderCone.hpp"
+#include "Physics/Colliders/ColliderCube.hpp"
+#include "Physics/Colliders/ColliderCylinder.hpp"
+#include "Physics/Colliders/ColliderHeightfield.hpp"
+#include "Physics/Colliders/ColliderSphere.hpp"
+#include "Physics/KinematicCharacter.hpp"
+#include "Physics/Rigidbody.hpp"
+#if !defined(ACID_BUILD_SERVER)
 #include "Animations/MeshAnimated.hpp"
+#include "Animations/MeshBaked.hpp"
+#include "Audio/ReverbZone.hpp"
 #include "Emitters/EmitterCircle.hpp"
 #include "Emitters/EmitterLine.hpp"
 #include "Emitters/EmitterPoint.hpp"
@@ -10,17 +22,11 @@
 #include "Meshes/Mesh.hpp"
 #include "Meshes/MeshRender.hpp"
 #include "Particles/ParticleSystem.hpp"
-#include "Physics/Colliders/ColliderCapsule.hpp"
-#include "Physics/Colliders/ColliderCone.hpp"
 #include "Physics/Colliders/ColliderConvexHull.hpp"
-#include "Physics/Colliders/ColliderCube.hpp"
-#include "Physics/Colliders/ColliderCylinder.hpp"
-#include "Physics/Colliders/ColliderHeightfield.hpp"
-#include "Physics/Colliders/ColliderSphere.hpp"
-#include "Physics/KinematicCharacter.hpp"
-#include "Physics/Rigidbody.hpp"
 #include "Shadows/ShadowRender.hpp"
 #include "Skyboxes/MaterialSkybox.hpp"
+#include "Terrains/Terrain.hpp"
+#endif
 
 namespace acid
 {
@@ -28,30 +34,52 @@ ComponentRegister::ComponentRegister()
 {
 	Add<ColliderCapsule>("ColliderCapsule");
 	Add<ColliderCone>("ColliderCone");
-	Add<ColliderConvexHull>("ColliderConvexHull");
 	Add<ColliderCube>("ColliderCube");
 	Add<ColliderCylinder>("ColliderCylinder");
 	Add<ColliderHeightfield>("ColliderHeightfield");
 	Add<ColliderSphere>("ColliderSphere");
+	Add<KinematicCharacter>("KinematicCharacter");
+	Add<Replicated>("Replicated");
+	Add<Rigidbody>("Rigidbody");
+
+#if !defined(ACID_BUILD_SERVER)
+	// Components that render, play audio or need a model loaded to the GPU, servers skip them when loading prefabs.
+	Add<ColliderConvexHull>("ColliderConvexHull");
 	Add<EmitterCircle>("EmitterCircle");
 	Add<EmitterLine>("EmitterLine");
 	Add<EmitterPoint>("EmitterPoint");
 	Add<EmitterSphere>("EmitterSphere");
-	Add<KinematicCharacter>("KinematicCharacter");
 	Add<Light>("Light");
 	Add<MaterialDefault>("MaterialDefault");
 	Add<MaterialSkybox>("MaterialSkybox");
 	Add<Mesh>("Mesh");
 	Add<MeshAnimated>("MeshAnimated");
+	Add<MeshBaked>("MeshBaked");
 	Add<MeshRender>("MeshRender");
 	Add<ParticleSystem>("ParticleSystem");
-	Add<Rigidbody>("Rigidbody");
+	Add<ReverbZone>("ReverbZone");
 	Add<ShadowRender>("ShadowRender");
+	Add<Terrain>("Terrain");
+#endif
 }
 
 void ComponentRegister::Remove(const std::string &name)
 {
 	m_components.erase(name);
+
+	for (auto it = m_types.begin(); it != m_types.end();)
+	{
+		if (it->second == name)
+		{
+			it = m_types.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	ClearDerived();
 }
 
 Component *ComponentRegister::Create(const std::string &name) const
@@ -95,14 +123,48 @@ void ComponentRegister::Encode(const std::string &name, Metadata &metadata, cons
 
 std::optional<std::string> ComponentRegister::FindName(Component *compare) const
 {
-	for (const auto &[name, component] : m_components) // TODO: Clean remove.
+	if (compare == nullptr)
+	{
+		return {};
+	}
+
+	std::type_index type(typeid(*compare));
+
+	if (auto it = m_types.find(type); it != m_types.end())
 	{
-		if (component.m_isSame(compare))
+		return it->second;
+	}
+
+	std::lock_guard<std::mutex> lock(m_derivedMutex);
+	auto it = m_derived.find(type);
+
+	if (it == m_derived.end())
+	{
+		std::string found;
+
+		for (const auto &[name, component] : m_components)
 		{
-			return name;
+			if (component.m_isSame(compare))
+			{
+				found = name;
+				break;
+			}
 		}
+
+		it = m_derived.emplace(type, found).first;
 	}
 
-	return {};
+	if (it->second.empty())
+	{
+		return {};
+	}
+
+	return it->second;
+}
+
+void ComponentRegister::ClearDerived()
+{
+	std::lock_guard<std::mutex> lock(m_derivedMutex);
+	m_derived.clear();
 }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+#include <typeindex>
 #include "Engine/Log.hpp"
 #include "Component.hpp"
 
@@ -7,6 +9,7 @@ namespace acid
 {
 /**
  * @brief Class that holds registered component types.
+ * Registrations are found by hashed name when decoding, and by the type of the component when encoding.
  */
 class ACID_EXPORT ComponentRegister
 {
@@ -33,22 +36,25 @@ public:
 		{
 			return new T();
 		};
+		// Components are only decoded and encoded through the name they were found or created by, so they are of the registered type.
 		componentCreate.m_decode = [](const Metadata &metadata, Component *component) -> const Metadata &
 		{
-			metadata >> *dynamic_cast<T *>(component);
+			metadata >> *static_cast<T *>(component);
 			return metadata;
 		};
 		componentCreate.m_encode = [](Metadata &metadata, const Component *component) -> Metadata &
 		{
-			metadata << *dynamic_cast<const T *>(component);
+			metadata << *static_cast<const T *>(component);
 			return metadata;
 		};
 		componentCreate.m_isSame = [](Component *component) -> bool
 		{
-			return dynamic_cast<T *>(component) != nullptr; // TODO: Ignore type inheritance
+			return dynamic_cast<T *>(component) != nullptr;
 		};
 
 		m_components.emplace(name, componentCreate);
+		m_types.emplace(std::type_index(typeid(T)), name);
+		ClearDerived();
 	}
 
 	/**
@@ -69,7 +75,8 @@ public:
 	void Encode(const std::string &name, Metadata &metadata, const Component *component);
 
 	/**
-	 * Finds the registered name to a component.
+	 * Finds the registered name to a component. Components of a registered type are found by their type,
+	 * components of a type derived from a registered type are found by the first registration they cast to, which is then remembered for their type.
 	 * @param compare The components to get the registered name of.
 	 * @return The name registered to the component.
 	 */
@@ -84,6 +91,12 @@ private:
 		std::function<bool(Component *)> m_isSame;
 	};
 
-	std::map<std::string, ComponentCreate> m_components;
+	void ClearDerived();
+
+	std::unordered_map<std::string, ComponentCreate> m_components;
+	std::unordered_map<std::type_index, std::string> m_types;
+	/// Names found for unregistered types by casting, an empty name if no registration matched the type.
+	mutable std::unordered_map<std::type_index, std::string> m_derived;
+	mutable std::mutex m_derivedMutex;
 };
 }
@@ -3,23 +3,37 @@
 #include "Files/FileSystem.hpp"
 #include "Scenes.hpp"
 #include "EntityPrefab.hpp"
+#include "SceneStructure.hpp"
 
 namespace acid
 {
 Entity::Entity(const Transform &transform) :
 	m_name(""),
 	m_localTransform(transform),
+	m_worldVersion(0),
+	m_parentWorldVersion(0),
+	m_structure(nullptr),
 	m_parent(nullptr),
 	m_removed(false)
 {
 }
 
 Entity::Entity(const std::string &filename, const Transform &transform) :
+	Entity(*EntityPrefab::Create(filename), transform)
+{
+}
+
+Entity::Entity(const EntityPrefab &prefab, const Transform &transform) :
 	Entity(transform)
 {
-	auto prefabObject = EntityPrefab::Create(filename);
+	m_name = FileSystem::FileName(prefab.GetFilename());
+
+	if (prefab.GetParent() == nullptr)
+	{
+		return;
+	}
 
-	for (const auto &child : prefabObject->GetParent()->GetChildren())
+	for (const auto &child : prefab.GetParent()->GetChildren())
 	{
 		if (child->GetName().empty())
 		{
@@ -36,8 +50,6 @@ Entity::Entity(const std::string &filename, const Transform &transform) :
 		Scenes::Get()->GetComponentRegister().Decode(child->GetName(), *child, component);
 		AddComponent(component);
 	}
-
-	m_name = FileSystem::FileName(filename);
 }
 
 Entity::~Entity()
@@ -46,15 +58,32 @@ Entity::~Entity()
 	{
 		m_parent->RemoveChild(this);
 	}
+
+	// Entities destroyed in one batch may be destroyed before their children.
+	for (const auto &child : m_children)
+	{
+		child->m_parent = nullptr;
+	}
 }
 
 void Entity::Update()
+{
+	UpdateComponents(nullptr, nullptr);
+}
+
+void Entity::UpdateComponents(std::pmr::vector<Component *> *sliced, std::pmr::vector<Component *> *parallel)
 {
 	for (auto it = m_components.begin(); it != m_components.end();)
 	{
 		if ((*it)->IsRemoved())
 		{
+			if (m_structure != nullptr)
+			{
+				m_structure->OnComponentRemoved((*it).get());
+			}
+
 			it = m_components.erase(it);
+			ClearTypedComponents();
 			continue;
 		}
 
@@ -71,7 +100,19 @@ void Entity::Update()
 				(*it)->m_started = true;
 			}
 
-			(*it)->Update();
+			if (sliced != nullptr && (*it)->m_updatePriority != Component::UpdatePriority::Always)
+			{
+				sliced->emplace_back((*it).get());
+			}
+			else if (parallel != nullptr && (*it)->m_updatePriority == Component::UpdatePriority::Always && (*it)->m_threadSafe)
+			{
+				parallel->emplace_back((*it).get());
+			}
+			else
+			{
+				(*it)->m_updateDelta = Engine::Get()->GetDelta();
+				(*it)->Update();
+			}
 		}
 
 		++it;
@@ -85,65 +126,173 @@ Component *Entity::AddComponent(Component *component)
 		return nullptr;
 	}
 
+	if (m_structure != nullptr && m_structure->Defer([this, component]()
+	{
+		AddComponent(component);
+	}))
+	{
+		return component;
+	}
+
 	component->SetParent(this);
 	m_components.emplace_back(component);
+	ClearTypedComponents();
+
+	if (m_structure != nullptr)
+	{
+		m_structure->OnComponentAdded(component);
+	}
+
 	return component;
 }
 
 void Entity::RemoveComponent(Component *component)
 {
-	m_components.erase(std::remove_if(m_components.begin(), m_components.end(), [component](std::unique_ptr<Component> &c)
+	if (m_structure != nullptr && m_structure->Defer([this, component]()
+	{
+		RemoveComponent(component);
+	}))
+	{
+		return;
+	}
+
+	m_components.erase(std::remove_if(m_components.begin(), m_components.end(), [&](std::unique_ptr<Component> &c)
 	{
-		return c.get() == component;
+		if (c.get() != component)
+		{
+			return false;
+		}
+
+		if (m_structure != nullptr)
+		{
+			m_structure->OnComponentRemoved(component);
+		}
+
+		return true;
 	}), m_components.end());
+	ClearTypedComponents();
 }
 
 void Entity::RemoveComponent(const std::string &name)
 {
+	if (m_structure != nullptr && m_structure->Defer([this, name]()
+	{
+		RemoveComponent(name);
+	}))
+	{
+		return;
+	}
+
 	m_components.erase(std::remove_if(m_components.begin(), m_components.end(), [&](std::unique_ptr<Component> &c)
 	{
 		auto componentName = Scenes::Get()->GetComponentRegister().FindName(c.get());
-		return componentName && name == *componentName;
+
+		if (!componentName || name != *componentName)
+		{
+			return false;
+		}
+
+		if (m_structure != nullptr)
+		{
+			m_structure->OnComponentRemoved(c.get());
+		}
+
+		return true;
 	}), m_components.end());
+	ClearTypedComponents();
 }
 
-Transform Entity::GetWorldTransform() const
+bool Entity::IsWorldStale() const
 {
-	if (m_localTransform.IsDirty())
+	for (auto entity = this; entity != nullptr; entity = entity->m_parent)
 	{
-		if (m_parent != nullptr)
-		{
-			m_worldTransform = m_parent->GetWorldTransform() * m_localTransform;
-		}
-		else
+		if (entity->m_localTransform.IsDirty() || entity->m_worldVersion == 0 || (entity->m_parent != nullptr && entity->m_parentWorldVersion != entity->m_parent->m_worldVersion))
 		{
-			m_worldTransform = m_localTransform;
+			return true;
 		}
+	}
+
+	return false;
+}
+
+void Entity::ComputeWorldTransform() const
+{
+	if (m_parent != nullptr)
+	{
+		m_worldTransform = m_parent->m_worldTransform * m_localTransform;
+		m_parentWorldVersion = m_parent->m_worldVersion;
+	}
+	else
+	{
+		m_worldTransform = m_localTransform;
+	}
 
-		for (const auto &child : m_children)
+	// The world matrix is built here, so readers of the transform do not build it.
+	m_worldTransform.GetWorldMatrix();
+	m_localTransform.SetDirty(false);
+	m_worldVersion++;
+}
+
+void Entity::ClearTypedComponents()
+{
+	std::lock_guard<std::mutex> lock(m_typedMutex);
+	m_typedComponents.clear();
+}
+
+const Transform &Entity::GetWorldTransform() const
+{
+	if (IsWorldStale())
+	{
+		if (m_parent != nullptr)
 		{
-			child->m_localTransform.SetDirty(true);
+			m_parent->GetWorldTransform();
 		}
 
-		m_localTransform.SetDirty(false);
+		ComputeWorldTransform();
 	}
 
 	return m_worldTransform;
 }
 
-Matrix4 Entity::GetWorldMatrix() const
+const Matrix4 &Entity::GetWorldMatrix() const
 {
 	return GetWorldTransform().GetWorldMatrix();
 }
 
+void Entity::SetRemoved(const bool &removed)
+{
+	if (removed && m_structure != nullptr)
+	{
+		m_structure->Remove(this);
+		return;
+	}
+
+	m_removed = removed;
+}
+
 void Entity::SetParent(Entity *parent)
 {
+	if (m_structure != nullptr && m_structure->Defer([this, parent]()
+	{
+		SetParent(parent);
+	}))
+	{
+		return;
+	}
+
 	if (m_parent != nullptr)
 	{
 		m_parent->RemoveChild(this);
 	}
 
 	m_parent = parent;
+	m_parentWorldVersion = 0;
+	m_localTransform.SetDirty(true);
+
+	if (m_structure != nullptr)
+	{
+		m_structure->m_transformsSorted = false;
+	}
 
 	if (m_parent != nullptr)
 	{
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <memory_resource>
+#include <mutex>
 #include "Helpers/NonCopyable.hpp"
 #include "Maths/Transform.hpp"
 #include "Component.hpp"
+#include "EntityHandle.hpp"
 
 namespace acid
 {
+class EntityPrefab;
+class SceneStructure;
+
 /**
  * @brief Class that represents a objects that acts as a component container.
  */
@@ -26,6 +32,13 @@ public:
 	 */
 	explicit Entity(const std::string &filename, const Transform &transform = Transform::Zero);
 
+	/**
+	 * Creates a new entity from a loaded prefab, the prefab is only read so entities can be created from it on several threads at once.
+	 * @param prefab The prefab to decode the components from.
+	 * @param transform The objects initial world position, rotation, and scale.
+	 */
+	explicit Entity(const EntityPrefab &prefab, const Transform &transform = Transform::Zero);
+
 	~Entity();
 
 	void Update();
@@ -53,20 +66,17 @@ public:
 	{
 		T *alternative = nullptr;
 
-		for (const auto &component : m_components)
+		for (const auto &component : GetTypedComponents<T>())
 		{
-			auto casted = dynamic_cast<T *>(component.get());
+			auto casted = static_cast<T *>(component);
 
-			if (casted != nullptr)
+			if (allowDisabled && !casted->IsEnabled())
 			{
-				if (allowDisabled && !casted->IsEnabled())
-				{
-					alternative = casted;
-					continue;
-				}
-
-				return casted;
+				alternative = casted;
+				continue;
 			}
+
+			return casted;
 		}
 
 		return alternative;
@@ -81,22 +91,14 @@ public:
 	template<typename T>
 	std::vector<T *> GetComponents(const bool &allowDisabled = false) const
 	{
+		const auto &typed = GetTypedComponents<T>();
+
 		std::vector<T *> components;
+		components.reserve(typed.size());
 
-		for (const auto &component : m_components)
+		for (const auto &component : typed)
 		{
-			auto casted = dynamic_cast<T *>(component.get());
-
-			if (casted != nullptr)
-			{
-				if (allowDisabled && !casted->IsEnabled())
-				{
-					components.emplace_back(casted);
-					continue;
-				}
-
-				components.emplace_back(casted);
-			}
+			components.emplace_back(static_cast<T *>(component));
 		}
 
 		return components;
@@ -143,15 +145,9 @@ public:
 	template<typename T>
 	void RemoveComponent()
 	{
-		for (auto it = m_components.begin(); it != m_components.end(); ++it)
+		for (const auto &component : GetComponents<T>(true))
 		{
-			auto casted = dynamic_cast<T *>((*it).get());
-
-			if (casted != nullptr)
-			{
-				(*it)->SetParent(nullptr);
-				m_components.erase(it);
-			}
+			RemoveComponent(component);
 		}
 	}
 
@@ -163,13 +159,28 @@ public:
 
 	void SetLocalTransform(const Transform &localTransform) { m_localTransform = localTransform; }
 
-	Transform GetWorldTransform() const;
+	/**
+	 * Gets the world transform, the structure updates every world transform once per update so this is usually a cached value.
+	 * If this or a parent local transform changed since the update the transform is updated here.
+	 * @return The world transform.
+	 */
+	const Transform &GetWorldTransform() const;
 
-	Matrix4 GetWorldMatrix() const;
+	const Matrix4 &GetWorldMatrix() const;
 
 	const bool &IsRemoved() const { return m_removed; }
 
-	void SetRemoved(const bool &removed) { m_removed = removed; }
+	/**
+	 * Sets if the entity is removed, a removed entity in a structure is removed from it with {@link SceneStructure#Remove}.
+	 * @param removed If the entity is removed.
+	 */
+	void SetRemoved(const bool &removed);
+
+	/**
+	 * Gets the handle of this entity in the structure it is in, handles can be kept after the entity is destroyed and are looked up with {@link SceneStructure#Get}.
+	 * @return The handle, null if the entity is not in a structure.
+	 */
+	const EntityHandle &GetHandle() const { return m_handle; }
 
 	Entity *GetParent() const { return m_parent; }
 
@@ -182,10 +193,70 @@ public:
 	void RemoveChild(Entity *child);
 
 private:
+	friend class SceneStructure;
+
+	/**
+	 * Starts and updates the components, components that are not always updated or are thread safe are started and added to a list for the structure to update.
+	 * @param sliced The list components that are not always updated are added to, if null they are updated here.
+	 * @param parallel The list thread safe components that are always updated are added to, if null they are updated here.
+	 */
+	void UpdateComponents(std::pmr::vector<Component *> *sliced, std::pmr::vector<Component *> *parallel);
+
+	/**
+	 * Gets the components that are, or derive from, a type. The list is built with one RTTI scan the first time a type is requested,
+	 * later lookups are a hash lookup until a component is added or removed.
+	 * @tparam T The component type to find.
+	 * @return The components of the type, in the order they were added.
+	 */
+	template<typename T>
+	const std::vector<Component *> &GetTypedComponents() const
+	{
+		std::lock_guard<std::mutex> lock(m_typedMutex);
+		const auto typeId = GetComponentTypeId<T>();
+		auto it = m_typedComponents.find(typeId);
+
+		if (it != m_typedComponents.end())
+		{
+			return it->second;
+		}
+
+		std::vector<Component *> typed;
+
+		for (const auto &component : m_components)
+		{
+			if (dynamic_cast<T *>(component.get()) != nullptr)
+			{
+				typed.emplace_back(component.get());
+			}
+		}
+
+		return m_typedComponents.emplace(typeId, std::move(typed)).first->second;
+	}
+
+	void ClearTypedComponents();
+
+	/**
+	 * Gets if the world transform is older than this or a parent local transform.
+	 * @return If the world transform needs to be updated.
+	 */
+	bool IsWorldStale() const;
+
+	/**
+	 * Updates the world transform from the parent world transform, which must be up to date.
+	 */
+	void ComputeWorldTransform() const;
+
 	std::string m_name;
 	Transform m_localTransform;
 	mutable Transform m_worldTransform;
+	// Incremented when the world transform changes, children compare it with the version their world transform was built from.
+	mutable uint64_t m_worldVersion;
+	mutable uint64_t m_parentWorldVersion;
 	std::vector<std::unique_ptr<Component>> m_components;
+	mutable std::unordered_map<TypeId, std::vector<Component *>> m_typedComponents;
+	mutable std::mutex m_typedMutex;
+	SceneStructure *m_structure;
+	EntityHandle m_handle;
 	Entity *m_parent;
 	std::vector<Entity *> m_children;
 	bool m_removed;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "StdAfx.hpp"
+
+namespace acid
+{
+/**
+ * @brief A handle to an entity in a {@link SceneStructure}, the slot the entity is stored in and the generation of that slot.
+ * Slots are reused once their entity is destroyed and their generation is then incremented, so a handle to a destroyed entity never finds the entity that reused its slot.
+ * The handle packs into 64 bits, such as for network ids or saved references.
+ */
+class ACID_EXPORT EntityHandle
+{
+public:
+	/**
+	 * Creates a null handle, it never finds an entity.
+	 */
+	EntityHandle() = default;
+
+	EntityHandle(const uint32_t &index, const uint32_t &generation) :
+		m_index(index),
+		m_generation(generation)
+	{
+	}
+
+	/**
+	 * Creates a handle from the packed value given by {@link EntityHandle#GetValue}.
+	 * @param value The packed handle.
+	 */
+	explicit EntityHandle(const uint64_t &value) :
+		m_index(static_cast<uint32_t>(value)),
+		m_generation(static_cast<uint32_t>(value >> 32))
+	{
+	}
+
+	const uint32_t &GetIndex() const { return m_index; }
+
+	const uint32_t &GetGeneration() const { return m_generation; }
+
+	/**
+	 * Gets the handle packed into 64 bits, the generation in the upper half and the slot index in the lower.
+	 * @return The packed handle.
+	 */
+	uint64_t GetValue() const { return static_cast<uint64_t>(m_generation) << 32 | m_index; }
+
+	/**
+	 * Gets if the handle is not null, the entity it was created for may since have been destroyed.
+	 * @return If the handle is not null.
+	 */
+	bool IsValid() const { return m_generation != 0; }
+
+	explicit operator bool() const { return IsValid(); }
+
+	bool operator==(const EntityHandle &other) const { return m_index == other.m_index && m_generation == other.m_generation; }
+
+	bool operator!=(const EntityHandle &other) const { return !(*this == other); }
+
+	bool operator<(const EntityHandle &other) const { return GetValue() < other.GetValue(); }
+
+private:
+	uint32_t m_index = 0;
+	// Slot generations start at one, zero is the null handle.
+	uint32_t m_generation = 0;
+};
+}
+
+namespace std
+{
+template<>
+struct hash<acid::EntityHandle>
+{
+	size_t operator()(const acid::EntityHandle &handle) const
+	{
+		return hash<uint64_t>()(handle.GetValue());
+	}
+};
+}
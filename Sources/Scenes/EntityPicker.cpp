@@ -0,0 +1,101 @@
+#include "EntityPicker.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Images/Image2d.hpp"
+#include "Graphics/Images/ImageReadback.hpp"
+#include "Scenes.hpp"
+
+namespace acid
+{
+EntityPicker::EntityPicker(std::string attachment) :
+	m_attachment(std::move(attachment)),
+	m_state(std::make_shared<State>()),
+	m_reported(false)
+{
+}
+
+uint64_t EntityPicker::Pick(const Vector2f &position)
+{
+	// Looking the attachment up outside of the frame keeps its contents stored after its render pass.
+	auto image = dynamic_cast<const Image2d *>(Graphics::Get()->GetAttachment(m_attachment));
+
+	if (image == nullptr)
+	{
+		return 0;
+	}
+
+	if (image->GetFormat() != VK_FORMAT_R32G32_UINT || image->GetSamples() != VK_SAMPLE_COUNT_1_BIT)
+	{
+		if (!m_reported)
+		{
+			Log::Error("Entity attachment '%s' must be a VK_FORMAT_R32G32_UINT image that is not multisampled\n", m_attachment.c_str());
+			m_reported = true;
+		}
+
+		return 0;
+	}
+
+	uint64_t sequence;
+
+	{
+		std::lock_guard<std::mutex> lock(m_state->m_mutex);
+		sequence = ++m_state->m_requested;
+
+		// Positions outside of the window never have a entity, so they finish without a readback.
+		if (position.m_x < 0.0f || position.m_y < 0.0f || position.m_x > 1.0f || position.m_y > 1.0f)
+		{
+			m_state->m_completed = sequence;
+			m_state->m_picked = {};
+			return sequence;
+		}
+	}
+
+	auto &extent = image->GetExtent();
+	Vector2ui texel(std::min(static_cast<uint32_t>(position.m_x * static_cast<float>(extent.m_x)), extent.m_x - 1),
+		std::min(static_cast<uint32_t>(position.m_y * static_cast<float>(extent.m_y)), extent.m_y - 1));
+
+	// Attachments are left in the attachment layout at the end of their render pass.
+	Graphics::Get()->GetImageReadback()->ReadRegion(image->GetImage(), image->GetFormat(), texel, { 1, 1 }, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+		[state = m_state, sequence](const uint8_t *texels, const Vector2ui &, const VkFormat &)
+	{
+		uint32_t value[2];
+		std::memcpy(value, texels, sizeof(value));
+
+		std::lock_guard<std::mutex> lock(state->m_mutex);
+
+		// Readbacks finish on workers, a older pick finishing late does not replace a newer result.
+		if (sequence > state->m_completed)
+		{
+			state->m_completed = sequence;
+			state->m_picked = EntityHandle(value[0], value[1]);
+		}
+	});
+
+	return sequence;
+}
+
+EntityHandle EntityPicker::GetPicked() const
+{
+	std::lock_guard<std::mutex> lock(m_state->m_mutex);
+	return m_state->m_picked;
+}
+
+Entity *EntityPicker::GetPickedEntity() const
+{
+	auto picked = GetPicked();
+	auto structure = Scenes::Get()->GetStructure();
+
+	if (!picked || structure == nullptr)
+	{
+		return nullptr;
+	}
+
+	return structure->Get(picked);
+}
+
+bool EntityPicker::IsFinished(const uint64_t &pick) const
+{
+	std::lock_guard<std::mutex> lock(m_state->m_mutex);
+	return m_state->m_completed >= pick;
+}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+#include "Maths/Vector2.hpp"
+#include "Graphics/RenderStage.hpp"
+#include "EntityHandle.hpp"
+
+namespace acid
+{
+class Entity;
+
+/**
+ * @brief Class that picks the entity drawn at a position from the entity attachment of a render stage, such as for selecting or highlighting entities under the cursor.
+ * Materials and gizmos drawn to a subpass with the entity attachment write the handle of their entity at each pixel, so every renderable is picked exactly without a physics query.
+ * A pick reads a single texel back through {@link ImageReadback}, its result is available once the frame it was recorded in has completed.
+ */
+class ACID_EXPORT EntityPicker :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new entity picker.
+	 * @param attachment The name of the attachment read, a {@code VK_FORMAT_R32G32_UINT} image that is not multisampled.
+	 */
+	explicit EntityPicker(std::string attachment = RenderStage::EntityAttachment);
+
+	/**
+	 * Queues reading the entity drawn at a position, picks made each frame such as for hovering finish in the order they were made.
+	 * @param position The position in the window from zero to one, as given by {@link Mouse#GetPosition}.
+	 * @return The id of the pick used to check if it has finished, zero if the stage has no entity attachment to read.
+	 */
+	uint64_t Pick(const Vector2f &position);
+
+	/**
+	 * Gets the entity found by the latest pick that has finished.
+	 * @return The entity handle, a null handle if no entity was drawn there or nothing has been picked.
+	 */
+	EntityHandle GetPicked() const;
+
+	/**
+	 * Gets the entity found by the latest pick that has finished in the current scene.
+	 * @return The entity, or nullptr if no entity was picked or it has since been removed.
+	 */
+	Entity *GetPickedEntity() const;
+
+	/**
+	 * Gets if a pick has finished, {@link EntityPicker#GetPicked} then gives its result or the result of a newer pick.
+	 * @param pick The id of the pick.
+	 * @return If the pick has finished.
+	 */
+	bool IsFinished(const uint64_t &pick) const;
+
+private:
+	/// Shared with the readbacks, which may finish after the picker is destroyed.
+	class State
+	{
+	public:
+		std::mutex m_mutex;
+		uint64_t m_requested = 0;
+		uint64_t m_completed = 0;
+		EntityHandle m_picked;
+	};
+
+	std::string m_attachment;
+	std::shared_ptr<State> m_state;
+	bool m_reported;
+};
+}
@@ -1,6 +1,7 @@
 #include "EntityPrefab.hpp"
 
 #include "Files/File.hpp"
+#include "Serialized/Binary/Binary.hpp"
 #include "Serialized/Json/Json.hpp"
 #include "Serialized/Xml/Xml.hpp"
 #include "Serialized/Yaml/Yaml.hpp"
@@ -13,18 +14,13 @@ namespace acid
 {
 std::shared_ptr<EntityPrefab> EntityPrefab::Create(const Metadata &metadata)
 {
-	auto resource = Resources::Get()->Find(metadata);
-
-	if (resource != nullptr)
+	return Resources::Get()->FindOrLoad<EntityPrefab>(metadata, [&]()
 	{
-		return std::dynamic_pointer_cast<EntityPrefab>(resource);
-	}
-
-	auto result = std::make_shared<EntityPrefab>("");
-	Resources::Get()->Add(metadata, std::dynamic_pointer_cast<Resource>(result));
-	metadata >> *result;
-	result->Load();
-	return result;
+		auto result = std::make_shared<EntityPrefab>("");
+		metadata >> *result;
+		result->Load();
+		return result;
+	});
 }
 
 std::shared_ptr<EntityPrefab> EntityPrefab::Create(const std::string &filename)
@@ -54,7 +50,11 @@ void EntityPrefab::Load()
 
 	std::string fileExt = String::Lowercase(FileSystem::FileSuffix(m_filename));
 
-	if (fileExt == ".json")
+	if (fileExt == ".bin")
+	{
+		m_file = std::make_unique<File>(m_filename, new Binary());
+	}
+	else if (fileExt == ".json")
 	{
 		m_file = std::make_unique<File>(m_filename, new Json());
 	}
@@ -96,6 +96,11 @@ void EntityPrefab::Save()
 	m_file->Write();
 }
 
+std::future<void> EntityPrefab::SaveAsync()
+{
+	return m_file->WriteAsync();
+}
+
 const Metadata &operator>>(const Metadata &metadata, EntityPrefab &enityPrefab)
 {
 	metadata.GetChild("Filename", enityPrefab.m_filename);
@@ -41,9 +41,15 @@ public:
 
 	void Save();
 
+	/**
+	 * Saves a snapshot of the prefab on the engine thread pool, such as for autosaves that should not stall the frame.
+	 * @return The future that is ready once the prefab has been saved.
+	 */
+	std::future<void> SaveAsync();
+
 	const std::string &GetFilename() const { return m_filename; }
 
-	Metadata *GetParent() const { return m_file->GetMetadata(); }
+	Metadata *GetParent() const { return m_file != nullptr ? m_file->GetMetadata() : nullptr; }
 
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, EntityPrefab &enityPrefab);
 
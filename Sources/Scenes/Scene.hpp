@@ -1,7 +1,11 @@
 #pragma once
 
+#if !defined(ACID_BUILD_SERVER)
+#include "Lights/LightSelection.hpp"
+#endif
 #include "Camera.hpp"
 #include "ScenePhysics.hpp"
+#include "SceneStreamer.hpp"
 #include "SceneStructure.hpp"
 
 namespace acid
@@ -15,11 +19,13 @@ public:
 	/**
 	 * Creates a new scene.
 	 * @param camera The scenes camera.
+	 * @param multithreadedPhysics If the scenes physics is stepped on the job system, see {@link ScenePhysics#ScenePhysics}.
+	 * @param softBodyPhysics If the scenes physics can simulate soft bodies.
 	 */
-	explicit Scene(Camera *camera) :
+	explicit Scene(Camera *camera, const bool &multithreadedPhysics = false, const bool &softBodyPhysics = false) :
 		m_camera(camera),
 		m_structure(std::make_unique<SceneStructure>()),
-		m_physics(std::make_unique<ScenePhysics>()),
+		m_physics(std::make_unique<ScenePhysics>(multithreadedPhysics, softBodyPhysics)),
 		m_started(false)
 	{
 	}
@@ -57,18 +63,57 @@ public:
 	 */
 	ScenePhysics *GetPhysics() const { return m_physics.get(); }
 
+	/**
+	 * Gets the streamer that loads world cells around the camera.
+	 * @return The scene streamer, or nullptr if the scene is not streamed.
+	 */
+	SceneStreamer *GetStreamer() const { return m_streamer.get(); }
+
+	/**
+	 * Sets the streamer that loads world cells around the camera, the entities of the previous streamer are removed.
+	 * @param streamer The new scene streamer.
+	 */
+	void SetStreamer(SceneStreamer *streamer)
+	{
+		if (m_streamer != nullptr)
+		{
+			m_streamer->UnloadAll(*m_structure);
+		}
+
+		m_streamer.reset(streamer);
+	}
+
+#if !defined(ACID_BUILD_SERVER)
+	/**
+	 * Gets the lights picked to be rendered and to cast shadows, selected each frame before rendering.
+	 * @return The light selection.
+	 */
+	LightSelection &GetLightSelection() { return m_lightSelection; }
+#endif
+
 	/**
 	 * Gets if the scene is paused.
 	 * @return If the scene is paused.
 	 */
 	virtual bool IsPaused() const = 0;
 
+	/**
+	 * Gets if the scene has been started by {@link Scenes}.
+	 * @return If the scene is started.
+	 */
+	const bool &IsStarted() const { return m_started; }
+
 private:
 	friend class Scenes;
 
 	std::unique_ptr<Camera> m_camera;
 	std::unique_ptr<SceneStructure> m_structure;
 	std::unique_ptr<ScenePhysics> m_physics;
+	// Destroyed before the structure, loading jobs can still be creating entities.
+	std::unique_ptr<SceneStreamer> m_streamer;
+#if !defined(ACID_BUILD_SERVER)
+	LightSelection m_lightSelection;
+#endif
 	bool m_started;
 };
 }
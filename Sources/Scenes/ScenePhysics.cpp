@@ -1,45 +1,301 @@
 #include "ScenePhysics.hpp"
 
 #include <BulletCollision/BroadphaseCollision/btBroadphaseInterface.h>
+#include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
 #include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/NarrowPhaseCollision/btPersistentManifold.h>
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
 #include <BulletDynamics/Dynamics/btRigidBody.h>
+#include <BulletDynamics/Character/btKinematicCharacterController.h>
 #include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 #include <BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h>
 #include <BulletSoftBody/btSoftRigidDynamicsWorld.h>
+#include <BulletSoftBody/btSoftBody.h>
+#include <LinearMath/btThreads.h>
 #include "Engine/Engine.hpp"
 #include "Physics/Colliders/Collider.hpp"
 #include "Physics/CollisionObject.hpp"
+#include "Physics/Frustum.hpp"
+#include "Physics/FrustumCuller.hpp"
+#include "Physics/KinematicCharacter.hpp"
+#include "Scenes.hpp"
 
 namespace acid
 {
-ScenePhysics::ScenePhysics() :
-	m_collisionConfiguration(std::make_unique<btSoftBodyRigidBodyCollisionConfiguration>()),
-	m_broadphase(std::make_unique<btDbvtBroadphase>()),
-	m_dispatcher(std::make_unique<btCollisionDispatcher>(m_collisionConfiguration.get())),
-	m_solver(std::make_unique<btSequentialImpulseConstraintSolver>()),
-	m_dynamicsWorld(std::make_unique<btSoftRigidDynamicsWorld>(m_dispatcher.get(), m_broadphase.get(), m_solver.get(), m_collisionConfiguration.get())),
+/**
+ * @brief Runs Bullets parallel loops on the engines thread pool, the thread stepping the world counts as one of the threads.
+ */
+class ThreadPoolTaskScheduler :
+	public btITaskScheduler
+{
+public:
+	ThreadPoolTaskScheduler() :
+		btITaskScheduler("Acid")
+	{
+	}
+
+	int getMaxNumThreads() const override { return BT_MAX_THREAD_COUNT; }
+
+	int getNumThreads() const override
+	{
+		return std::min(static_cast<int>(Engine::Get()->GetThreadPool().GetWorkers().size()) + 1, BT_MAX_THREAD_COUNT);
+	}
+
+	void setNumThreads(int numThreads) override
+	{
+	}
+
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body) override
+	{
+		auto chunks = GetChunkCount(iBegin, iEnd, grainSize);
+		Engine::Get()->GetThreadPool().ParallelFor(0, chunks, [&](const std::size_t &chunk)
+		{
+			auto begin = iBegin + static_cast<int>(chunk) * grainSize;
+			body.forLoop(begin, std::min(begin + grainSize, iEnd));
+		}, 1);
+	}
+
+	btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody &body) override
+	{
+		auto chunks = GetChunkCount(iBegin, iEnd, grainSize);
+		std::vector<btScalar> sums(chunks);
+		Engine::Get()->GetThreadPool().ParallelFor(0, chunks, [&](const std::size_t &chunk)
+		{
+			auto begin = iBegin + static_cast<int>(chunk) * grainSize;
+			sums[chunk] = body.sumLoop(begin, std::min(begin + grainSize, iEnd));
+		}, 1);
+		return std::accumulate(sums.begin(), sums.end(), btScalar(0.0f));
+	}
+
+private:
+	static std::size_t GetChunkCount(const int &iBegin, const int &iEnd, int &grainSize)
+	{
+		grainSize = std::max(grainSize, 1);
+		return iEnd > iBegin ? static_cast<std::size_t>((iEnd - iBegin + grainSize - 1) / grainSize) : 0;
+	}
+};
+
+/**
+ * @brief Collects the objects of the broadphase proxies that pass a test of their bounds.
+ */
+template<typename F>
+class CollectCallback :
+	public btBroadphaseAabbCallback,
+	public btDbvt::ICollide
+{
+public:
+	CollectCallback(std::vector<CollisionObject *> &objects, F &&test) :
+		m_objects(objects),
+		m_test(std::move(test))
+	{
+	}
+
+	bool process(const btBroadphaseProxy *proxy) override
+	{
+		if (m_test(proxy))
+		{
+			// Objects created outside of a collision object component have no user pointer.
+			if (auto object = static_cast<CollisionObject *>(static_cast<btCollisionObject *>(proxy->m_clientObject)->getUserPointer()))
+			{
+				m_objects.emplace_back(object);
+			}
+		}
+
+		return true;
+	}
+
+	void Process(const btDbvtNode *leaf) override { process(static_cast<const btBroadphaseProxy *>(leaf->data)); }
+
+private:
+	std::vector<CollisionObject *> &m_objects;
+	F m_test;
+};
+
+template<typename F>
+static CollectCallback<F> MakeCollectCallback(std::vector<CollisionObject *> &objects, F &&test)
+{
+	return CollectCallback<F>(objects, std::forward<F>(test));
+}
+
+static btScalar BoundsDistance2(const btVector3 &position, const btBroadphaseProxy *proxy)
+{
+	auto closest = position;
+	closest.setMax(proxy->m_aabbMin);
+	closest.setMin(proxy->m_aabbMax);
+	return closest.distance2(position);
+}
+
+/**
+ * @brief The action the world steps every character controller through.
+ */
+class CharacterAction :
+	public btActionInterface
+{
+public:
+	explicit CharacterAction(ScenePhysics *physics) :
+		m_physics(physics)
+	{
+	}
+
+	void updateAction(btCollisionWorld *collisionWorld, btScalar deltaTimeStep) override
+	{
+		m_physics->UpdateCharacters(collisionWorld, deltaTimeStep);
+	}
+
+	void debugDraw(btIDebugDraw *debugDrawer) override
+	{
+	}
+
+private:
+	ScenePhysics *m_physics;
+};
+
+/**
+ * @brief The broadphase character controllers see while they are stepped in parallel, everything but writing bounds is passed to the worlds broadphase.
+ * A controller moves its bounds while it recovers from penetration, these bounds are written back once every character has stepped.
+ */
+class CharacterBroadphase :
+	public btBroadphaseInterface
+{
+public:
+	explicit CharacterBroadphase(btBroadphaseInterface *broadphase) :
+		m_broadphase(broadphase)
+	{
+	}
+
+	btBroadphaseProxy *createProxy(const btVector3 &aabbMin, const btVector3 &aabbMax, int shapeType, void *userPtr, int collisionFilterGroup, int collisionFilterMask,
+		btDispatcher *dispatcher) override
+	{
+		return nullptr;
+	}
+
+	void destroyProxy(btBroadphaseProxy *proxy, btDispatcher *dispatcher) override
+	{
+	}
+
+	void setAabb(btBroadphaseProxy *proxy, const btVector3 &aabbMin, const btVector3 &aabbMax, btDispatcher *dispatcher) override
+	{
+	}
+
+	void getAabb(btBroadphaseProxy *proxy, btVector3 &aabbMin, btVector3 &aabbMax) const override { m_broadphase->getAabb(proxy, aabbMin, aabbMax); }
+
+	void rayTest(const btVector3 &rayFrom, const btVector3 &rayTo, btBroadphaseRayCallback &rayCallback, const btVector3 &aabbMin, const btVector3 &aabbMax) override
+	{
+		m_broadphase->rayTest(rayFrom, rayTo, rayCallback, aabbMin, aabbMax);
+	}
+
+	void aabbTest(const btVector3 &aabbMin, const btVector3 &aabbMax, btBroadphaseAabbCallback &callback) override { m_broadphase->aabbTest(aabbMin, aabbMax, callback); }
+
+	void calculateOverlappingPairs(btDispatcher *dispatcher) override
+	{
+	}
+
+	btOverlappingPairCache *getOverlappingPairCache() override { return m_broadphase->getOverlappingPairCache(); }
+
+	const btOverlappingPairCache *getOverlappingPairCache() const override { return m_broadphase->getOverlappingPairCache(); }
+
+	void getBroadphaseAabb(btVector3 &aabbMin, btVector3 &aabbMax) const override { m_broadphase->getBroadphaseAabb(aabbMin, aabbMax); }
+
+	void printStats() override
+	{
+	}
+
+private:
+	btBroadphaseInterface *m_broadphase;
+};
+
+ScenePhysics *ScenePhysics::ContactPhysics = nullptr;
+
+ScenePhysics::ScenePhysics(const bool &multithreaded, const bool &softBodies) :
+	m_multithreaded(multithreaded),
+	m_softBodies(softBodies),
+	m_inStep(false),
 	m_gravity(0.0f, -9.81f, 0.0f),
-	m_airDensity(1.2f)
+	m_airDensity(1.2f),
+	m_substepRate(60.0f),
+	m_maxSubsteps(4),
+	m_deactivationTime(2.0f),
+	m_softBodyNear(50.0f),
+	m_softBodyFar(150.0f)
 {
+	if (m_multithreaded && m_softBodies)
+	{
+		Log::Warning("Soft bodies are not supported in a multithreaded physics world\n");
+		m_softBodies = false;
+	}
+
+	if (m_multithreaded)
+	{
+		// Bullet reads the scheduler while constructing the multithreaded solver.
+		static ThreadPoolTaskScheduler taskScheduler;
+		btSetTaskScheduler(&taskScheduler);
+
+		btDefaultCollisionConstructionInfo constructionInfo;
+		constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+		constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+
+		m_collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>(constructionInfo);
+		m_broadphase = std::make_unique<btDbvtBroadphase>();
+		m_dispatcher = std::make_unique<btCollisionDispatcherMt>(m_collisionConfiguration.get(), 40);
+		m_solverPool = std::make_unique<btConstraintSolverPoolMt>(taskScheduler.getNumThreads());
+		m_solver = std::make_unique<btSequentialImpulseConstraintSolverMt>();
+		m_dynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(m_dispatcher.get(), m_broadphase.get(), m_solverPool.get(), m_solver.get(),
+			m_collisionConfiguration.get());
+	}
+	else if (m_softBodies)
+	{
+		m_collisionConfiguration = std::make_unique<btSoftBodyRigidBodyCollisionConfiguration>();
+		m_broadphase = std::make_unique<btDbvtBroadphase>();
+		m_dispatcher = std::make_unique<btCollisionDispatcher>(m_collisionConfiguration.get());
+		m_solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+		m_dynamicsWorld = std::make_unique<btSoftRigidDynamicsWorld>(m_dispatcher.get(), m_broadphase.get(), m_solver.get(), m_collisionConfiguration.get());
+	}
+	else
+	{
+		m_collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
+		m_broadphase = std::make_unique<btDbvtBroadphase>();
+		m_dispatcher = std::make_unique<btCollisionDispatcher>(m_collisionConfiguration.get());
+		m_solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+		m_dynamicsWorld = std::make_unique<btDiscreteDynamicsWorld>(m_dispatcher.get(), m_broadphase.get(), m_solver.get(), m_collisionConfiguration.get());
+	}
+
 	m_dynamicsWorld->setGravity(Collider::Convert(m_gravity));
 	m_dynamicsWorld->getDispatchInfo().m_enableSPU = true;
 	m_dynamicsWorld->getSolverInfo().m_minimumSolverBatchSize = 128;
 	m_dynamicsWorld->getSolverInfo().m_globalCfm = 0.00001f;
 
-	auto softDynamicsWorld = static_cast<btSoftRigidDynamicsWorld *>(m_dynamicsWorld.get());
-	softDynamicsWorld->getWorldInfo().water_density = 0.0f;
-	softDynamicsWorld->getWorldInfo().water_offset = 0.0f;
-	softDynamicsWorld->getWorldInfo().water_normal = btVector3(0.0f, 0.0f, 0.0f);
-	softDynamicsWorld->getWorldInfo().m_gravity.setValue(0.0f, -9.81f, 0.0f);
-	softDynamicsWorld->getWorldInfo().air_density = m_airDensity;
-	softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
+	if (auto softDynamicsWorld = dynamic_cast<btSoftRigidDynamicsWorld *>(m_dynamicsWorld.get()))
+	{
+		softDynamicsWorld->getWorldInfo().water_density = 0.0f;
+		softDynamicsWorld->getWorldInfo().water_offset = 0.0f;
+		softDynamicsWorld->getWorldInfo().water_normal = btVector3(0.0f, 0.0f, 0.0f);
+		softDynamicsWorld->getWorldInfo().m_gravity.setValue(0.0f, -9.81f, 0.0f);
+		softDynamicsWorld->getWorldInfo().air_density = m_airDensity;
+		softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
+	}
+
+	m_characterAction = std::make_unique<CharacterAction>(this);
+	m_characterBroadphase = std::make_unique<CharacterBroadphase>(m_broadphase.get());
+	m_dynamicsWorld->addAction(m_characterAction.get());
+
+	gDeactivationTime = m_deactivationTime;
+	gContactStartedCallback = &ScenePhysics::OnContactStarted;
+	gContactEndedCallback = &ScenePhysics::OnContactEnded;
+	ContactPhysics = this;
 }
 
 ScenePhysics::~ScenePhysics()
 {
+	Wait();
+	m_dynamicsWorld->removeAction(m_characterAction.get());
+
 	for (int32_t i = m_dynamicsWorld->getNumCollisionObjects() - 1; i >= 0; i--)
 	{
 		btCollisionObject *obj = m_dynamicsWorld->getCollisionObjectArray()[i];
@@ -53,16 +309,74 @@ ScenePhysics::~ScenePhysics()
 
 		m_dynamicsWorld->removeCollisionObject(obj);
 	}
+
+	if (ContactPhysics == this)
+	{
+		ContactPhysics = nullptr;
+	}
 }
 
 void ScenePhysics::Update()
 {
-	m_dynamicsWorld->stepSimulation(Engine::Get()->GetDelta().AsSeconds());
+	if (!m_multithreaded)
+	{
+		UpdateSoftBodies();
+		Step(Engine::Get()->GetDelta().AsSeconds());
+	}
+
 	CheckForCollisionEvents();
 }
 
+void ScenePhysics::Dispatch()
+{
+	if (!m_multithreaded)
+	{
+		return;
+	}
+
+	Wait();
+	auto delta = Engine::Get()->GetDelta().AsSeconds();
+	Engine::Get()->GetThreadPool().Dispatch([this, delta]()
+	{
+		Step(delta);
+	}, &m_stepping);
+}
+
+void ScenePhysics::Wait()
+{
+	if (m_multithreaded && !m_stepping.IsDone())
+	{
+		Engine::Get()->GetThreadPool().Wait(m_stepping);
+	}
+}
+
+void ScenePhysics::AddCharacter(KinematicCharacter *character)
+{
+	Wait();
+	Character entry;
+	entry.m_character = character;
+
+	if (m_multithreaded)
+	{
+		entry.m_dispatcher = std::make_unique<btCollisionDispatcher>(m_collisionConfiguration.get());
+		entry.m_world = std::make_unique<btCollisionWorld>(entry.m_dispatcher.get(), m_characterBroadphase.get(), m_collisionConfiguration.get());
+	}
+
+	m_characters.emplace_back(std::move(entry));
+}
+
+void ScenePhysics::RemoveCharacter(KinematicCharacter *character)
+{
+	Wait();
+	m_characters.erase(std::remove_if(m_characters.begin(), m_characters.end(), [character](const Character &entry)
+	{
+		return entry.m_character == character;
+	}), m_characters.end());
+}
+
 Raycast ScenePhysics::Raytest(const Vector3f &start, const Vector3f &end)
 {
+	Wait();
 	auto startBt = Collider::Convert(start);
 	auto endBt = Collider::Convert(end);
 	btCollisionWorld::ClosestRayResultCallback result(startBt, endBt);
@@ -72,81 +386,527 @@ Raycast ScenePhysics::Raytest(const Vector3f &start, const Vector3f &end)
 		result.m_collisionObject != nullptr ? static_cast<CollisionObject *>(result.m_collisionObject->getUserPointer()) : nullptr);
 }
 
+template<typename F>
+void ScenePhysics::ForEachQuery(const std::size_t &count, F &&f)
+{
+#if BT_THREADSAFE
+	// Bullet keeps a ray test stack per thread once built thread safe.
+	Engine::Get()->GetThreadPool().ParallelFor(0, count, f, 32);
+#else
+	for (std::size_t i = 0; i < count; i++)
+	{
+		f(i);
+	}
+#endif
+}
+
+void ScenePhysics::Raytest(const RayQuery *queries, Raycast *results, const std::size_t &count)
+{
+	Wait();
+	auto collisionWorld = m_dynamicsWorld->getCollisionWorld();
+
+	ForEachQuery(count, [&](const std::size_t &i)
+	{
+		auto startBt = Collider::Convert(queries[i].m_start);
+		auto endBt = Collider::Convert(queries[i].m_end);
+		btCollisionWorld::ClosestRayResultCallback result(startBt, endBt);
+		collisionWorld->rayTest(startBt, endBt, result);
+
+		results[i] = Raycast(result.hasHit(), Collider::Convert(result.m_hitPointWorld),
+			result.m_collisionObject != nullptr ? static_cast<CollisionObject *>(result.m_collisionObject->getUserPointer()) : nullptr);
+	});
+}
+
+void ScenePhysics::SphereSweep(const SweepQuery *queries, Raycast *results, const std::size_t &count)
+{
+	Wait();
+	auto collisionWorld = m_dynamicsWorld->getCollisionWorld();
+
+	ForEachQuery(count, [&](const std::size_t &i)
+	{
+		auto startBt = Collider::Convert(queries[i].m_start);
+		auto endBt = Collider::Convert(queries[i].m_end);
+		btSphereShape shape(queries[i].m_radius);
+		btCollisionWorld::ClosestConvexResultCallback result(startBt, endBt);
+		collisionWorld->convexSweepTest(&shape, btTransform(btQuaternion::getIdentity(), startBt), btTransform(btQuaternion::getIdentity(), endBt), result);
+
+		results[i] = Raycast(result.hasHit(), Collider::Convert(result.m_hitPointWorld),
+			result.m_hitCollisionObject != nullptr ? static_cast<CollisionObject *>(result.m_hitCollisionObject->getUserPointer()) : nullptr);
+	});
+}
+
+void ScenePhysics::SphereOverlap(const OverlapQuery *queries, OverlapResult *results, const std::size_t &count, CollisionObject **objects, const uint32_t &maxObjects)
+{
+	// Collects the objects whos bounding box touches the sphere.
+	class OverlapCallback :
+		public btBroadphaseAabbCallback
+	{
+	public:
+		OverlapCallback(const btVector3 &position, const btScalar &radius, OverlapResult &result, const uint32_t &maxObjects) :
+			m_position(position),
+			m_radius(radius),
+			m_result(result),
+			m_maxObjects(maxObjects)
+		{
+		}
+
+		bool process(const btBroadphaseProxy *proxy) override
+		{
+			auto closest = m_position;
+			closest.setMax(proxy->m_aabbMin);
+			closest.setMin(proxy->m_aabbMax);
+
+			if (closest.distance2(m_position) > m_radius * m_radius)
+			{
+				return true;
+			}
+
+			if (m_result.m_count == m_maxObjects)
+			{
+				m_result.m_truncated = true;
+				return false;
+			}
+
+			auto collisionObject = static_cast<btCollisionObject *>(proxy->m_clientObject);
+			m_result.m_objects[m_result.m_count++] = static_cast<CollisionObject *>(collisionObject->getUserPointer());
+			return true;
+		}
+
+	private:
+		btVector3 m_position;
+		btScalar m_radius;
+		OverlapResult &m_result;
+		uint32_t m_maxObjects;
+	};
+
+	Wait();
+	auto broadphase = m_broadphase.get();
+
+	ForEachQuery(count, [&](const std::size_t &i)
+	{
+		auto position = Collider::Convert(queries[i].m_position);
+		auto extent = btVector3(queries[i].m_radius, queries[i].m_radius, queries[i].m_radius);
+
+		results[i] = OverlapResult();
+		results[i].m_objects = objects + i * maxObjects;
+
+		OverlapCallback callback(position, queries[i].m_radius, results[i], maxObjects);
+		broadphase->aabbTest(position - extent, position + extent, callback);
+	});
+}
+
+void ScenePhysics::FrustumTest(const Frustum &frustum, std::vector<CollisionObject *> &objects)
+{
+	Wait();
+	auto broadphase = dynamic_cast<btDbvtBroadphase *>(m_broadphase.get());
+
+	if (broadphase == nullptr)
+	{
+		// Other broadphases are walked in full, the bounds of every object are then tested against the frustum together.
+		std::vector<const btBroadphaseProxy *> proxies;
+		FrustumCuller culler;
+		auto collect = MakeCollectCallback(objects, [&proxies, &culler](const btBroadphaseProxy *proxy)
+		{
+			proxies.emplace_back(proxy);
+			culler.AddCube(Collider::Convert(proxy->m_aabbMin), Collider::Convert(proxy->m_aabbMax));
+			return false;
+		});
+		auto max = btVector3(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+		m_broadphase->aabbTest(-max, max, collect);
+
+		std::vector<uint32_t> visible;
+		culler.CullCubes(frustum, visible);
+		auto test = MakeCollectCallback(objects, [](const btBroadphaseProxy *proxy)
+		{
+			return true;
+		});
+
+		for (const auto &index : visible)
+		{
+			test.process(proxies[index]);
+		}
+
+		return;
+	}
+
+	// A point is inside the frustum when it is in front of every plane, the same test the tree applies to each of its nodes.
+	btVector3 normals[6];
+	btScalar offsets[6];
+
+	for (std::size_t i = 0; i < 6; i++)
+	{
+		const auto &plane = frustum.GetPlanes()[i];
+		normals[i].setValue(plane[0], plane[1], plane[2]);
+		offsets[i] = plane[3];
+	}
+
+	auto callback = MakeCollectCallback(objects, [](const btBroadphaseProxy *proxy)
+	{
+		return true;
+	});
+
+	// The first set holds moving proxies, the second holds proxies that have not moved for a while.
+	for (auto &set : broadphase->m_sets)
+	{
+		btDbvt::collideKDOP(set.m_root, normals, offsets, 6, callback);
+	}
+}
+
+void ScenePhysics::AabbTest(const Vector3f &min, const Vector3f &max, std::vector<CollisionObject *> &objects)
+{
+	Wait();
+	auto callback = MakeCollectCallback(objects, [](const btBroadphaseProxy *proxy)
+	{
+		return true;
+	});
+	m_broadphase->aabbTest(Collider::Convert(min), Collider::Convert(max), callback);
+}
+
+void ScenePhysics::SphereTest(const Vector3f &position, const float &radius, std::vector<CollisionObject *> &objects)
+{
+	Wait();
+	auto positionBt = Collider::Convert(position);
+	auto extent = btVector3(radius, radius, radius);
+	auto callback = MakeCollectCallback(objects, [&positionBt, &radius](const btBroadphaseProxy *proxy)
+	{
+		return BoundsDistance2(positionBt, proxy) <= radius * radius;
+	});
+	m_broadphase->aabbTest(positionBt - extent, positionBt + extent, callback);
+}
+
+void ScenePhysics::NearestTest(const Vector3f &position, const uint32_t &count, const float &maxDistance, std::vector<CollisionObject *> &objects)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Collects the objects whos bounds are within the radius, with their squared distances.
+	class NearestCallback :
+		public btBroadphaseAabbCallback
+	{
+	public:
+		NearestCallback(const btVector3 &position, const btScalar &radius, std::vector<std::pair<btScalar, CollisionObject *>> &candidates) :
+			m_position(position),
+			m_radius(radius),
+			m_candidates(candidates)
+		{
+		}
+
+		bool process(const btBroadphaseProxy *proxy) override
+		{
+			auto distance2 = BoundsDistance2(m_position, proxy);
+			auto object = static_cast<CollisionObject *>(static_cast<btCollisionObject *>(proxy->m_clientObject)->getUserPointer());
+
+			if (distance2 <= m_radius * m_radius && object != nullptr)
+			{
+				m_candidates.emplace_back(distance2, object);
+			}
+
+			return true;
+		}
+
+	private:
+		btVector3 m_position;
+		btScalar m_radius;
+		std::vector<std::pair<btScalar, CollisionObject *>> &m_candidates;
+	};
+
+	Wait();
+	auto positionBt = Collider::Convert(position);
+	auto total = static_cast<std::size_t>(m_dynamicsWorld->getNumCollisionObjects());
+	auto radius = std::min(8.0f, maxDistance);
+	std::vector<std::pair<btScalar, CollisionObject *>> candidates;
+
+	while (true)
+	{
+		candidates.clear();
+		auto extent = btVector3(radius, radius, radius);
+		NearestCallback callback(positionBt, radius, candidates);
+		m_broadphase->aabbTest(positionBt - extent, positionBt + extent, callback);
+
+		// Every object nearer than the radius is a candidate, so once enough are found the nearest of them are the nearest of all.
+		if (candidates.size() >= count || radius >= maxDistance || candidates.size() >= total)
+		{
+			break;
+		}
+
+		radius = std::min(radius * 2.0f, maxDistance);
+	}
+
+	auto nearest = std::min(candidates.size(), static_cast<std::size_t>(count));
+	std::partial_sort(candidates.begin(), candidates.begin() + nearest, candidates.end(), [](const auto &a, const auto &b)
+	{
+		return a.first < b.first;
+	});
+
+	for (std::size_t i = 0; i < nearest; i++)
+	{
+		objects.emplace_back(candidates[i].second);
+	}
+}
+
 void ScenePhysics::SetGravity(const Vector3f &gravity)
 {
+	Wait();
 	m_gravity = gravity;
 	m_dynamicsWorld->setGravity(Collider::Convert(m_gravity));
 }
 
 void ScenePhysics::SetAirDensity(const float &airDensity)
 {
+	Wait();
 	m_airDensity = airDensity;
-	auto softDynamicsWorld = static_cast<btSoftRigidDynamicsWorld *>(m_dynamicsWorld.get());
-	softDynamicsWorld->getWorldInfo().air_density = m_airDensity;
-	softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
+
+	if (auto softDynamicsWorld = dynamic_cast<btSoftRigidDynamicsWorld *>(m_dynamicsWorld.get()))
+	{
+		softDynamicsWorld->getWorldInfo().air_density = m_airDensity;
+		softDynamicsWorld->getWorldInfo().m_sparsesdf.Initialize();
+	}
 }
 
-void ScenePhysics::CheckForCollisionEvents()
+void ScenePhysics::SetSubstepRate(const float &substepRate)
 {
-	// Keep a list of the collision pairs found during the current update.
-	CollisionPairs pairsThisUpdate;
+	Wait();
+	m_substepRate = substepRate;
+}
+
+void ScenePhysics::SetMaxSubsteps(const uint32_t &maxSubsteps)
+{
+	Wait();
+	m_maxSubsteps = maxSubsteps;
+}
 
-	// Iterate through all of the manifolds in the dispatcher.
-	for (int32_t i = 0; i < m_dispatcher->getNumManifolds(); ++i)
+void ScenePhysics::SetDeactivationTime(const float &deactivationTime)
+{
+	Wait();
+	m_deactivationTime = deactivationTime;
+	gDeactivationTime = m_deactivationTime;
+}
+
+void ScenePhysics::OnContactStarted(btPersistentManifold *const &manifold)
+{
+	if (ContactPhysics != nullptr)
+	{
+		ContactPhysics->OnContact(manifold, true);
+	}
+}
+
+void ScenePhysics::OnContactEnded(btPersistentManifold *const &manifold)
+{
+	if (ContactPhysics != nullptr)
+	{
+		ContactPhysics->OnContact(manifold, false);
+	}
+}
+
+void ScenePhysics::OnContact(const btPersistentManifold *manifold, const bool &started)
+{
+	// Always create the pair in a predictable order (use the pointer value..).
+	auto body0 = manifold->getBody0();
+	auto body1 = manifold->getBody1();
+	auto pair = body0 > body1 ? std::make_pair(body1, body0) : std::make_pair(body0, body1);
+
+	// Manifolds are updated from worker threads in a multithreaded world.
+	std::lock_guard<std::mutex> lock(m_contactMutex);
+
+	if (m_inStep.load(std::memory_order_relaxed))
+	{
+		m_contactEvents.emplace_back(ContactEvent{pair, started});
+		return;
+	}
+
+	// One of the objects is being removed, its pair is forgotten without events since the object will not be there to receive them.
+	m_pairs.erase(pair);
+	m_contactEvents.erase(std::remove_if(m_contactEvents.begin(), m_contactEvents.end(), [&pair](const ContactEvent &event)
 	{
-		// Get the manifold.
-		auto manifold = m_dispatcher->getManifoldByIndexInternal(i);
+		return event.m_pair == pair;
+	}), m_contactEvents.end());
+}
 
-		// Ignore manifolds that have no contact points..
-		if (manifold->getNumContacts() == 0)
+void ScenePhysics::Step(const float &delta)
+{
+	m_inStep = true;
+	// Bullet keeps the time left over from the substeps, so the world advances at the substep rate whatever the update rate is.
+	m_dynamicsWorld->stepSimulation(delta, static_cast<int>(m_maxSubsteps), 1.0f / m_substepRate);
+	m_inStep = false;
+}
+
+void ScenePhysics::UpdateCharacters(btCollisionWorld *world, const float &delta)
+{
+	if (!m_multithreaded)
+	{
+		for (const auto &character : m_characters)
 		{
-			continue;
+			character.m_character->m_controller->updateAction(world, delta);
 		}
 
-		// Get the two rigid bodies involved in the collision.
-		auto body0 = manifold->getBody0();
-		auto body1 = manifold->getBody1();
+		return;
+	}
 
-		// Always create the pair in a predictable order (use the pointer value..).
-		const bool swapped = body0 > body1;
-		const auto sortedBodyA = swapped ? body1 : body0;
-		const auto sortedBodyB = swapped ? body0 : body1;
+	// The bounds each character can reach this step, characters only see objects within them.
+	auto count = m_characters.size();
+	std::vector<std::pair<btVector3, btVector3>> reach(count);
 
-		// Create the pair.
-		auto thisPair = std::make_pair(sortedBodyA, sortedBodyB);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		auto character = m_characters[i].m_character;
+		auto ghostObject = character->m_ghostObject.get();
+		ghostObject->getCollisionShape()->getAabb(ghostObject->getWorldTransform(), reach[i].first, reach[i].second);
+		auto extent = character->GetReach(delta);
+		reach[i].first -= btVector3(extent, extent, extent);
+		reach[i].second += btVector3(extent, extent, extent);
+		m_characters[i].m_world->getDispatchInfo() = world->getDispatchInfo();
+	}
 
-		// Insert the pair into the current list.
-		pairsThisUpdate.insert(thisPair);
+	// Characters whos reach overlaps may sweep against each other, so they are grouped and each group steps on one thread in the order characters were added.
+	std::vector<std::size_t> parents(count);
+	std::iota(parents.begin(), parents.end(), 0);
+	auto find = [&parents](std::size_t i)
+	{
+		while (parents[i] != i)
+		{
+			i = parents[i] = parents[parents[i]];
+		}
+
+		return i;
+	};
+
+	std::vector<std::size_t> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&reach](const std::size_t &a, const std::size_t &b)
+	{
+		return reach[a].first.x() < reach[b].first.x();
+	});
 
-		// If this pair doesn't exist in the list from the previous update, it is a new pair and we must send a collision event.
-		if (m_pairsLastUpdate.find(thisPair) == m_pairsLastUpdate.end())
+	for (std::size_t a = 0; a < count; a++)
+	{
+		const auto &boundsA = reach[order[a]];
+
+		for (std::size_t b = a + 1; b < count && reach[order[b]].first.x() <= boundsA.second.x(); b++)
 		{
-			// Gets the user pointer (entity).
-			auto collisionObjectA = static_cast<CollisionObject *>(sortedBodyA->getUserPointer());
-			auto collisionObjectB = static_cast<CollisionObject *>(sortedBodyB->getUserPointer());
+			const auto &boundsB = reach[order[b]];
 
-			collisionObjectA->OnCollision()(collisionObjectB);
+			if (boundsA.first.y() <= boundsB.second.y() && boundsB.first.y() <= boundsA.second.y() &&
+				boundsA.first.z() <= boundsB.second.z() && boundsB.first.z() <= boundsA.second.z())
+			{
+				parents[find(order[a])] = find(order[b]);
+			}
 		}
 	}
 
-	// Creates another list for pairs that were removed this update.
-	CollisionPairs removedPairs;
+	std::vector<std::vector<std::size_t>> groups;
+	std::vector<std::size_t> groupIndices(count, count);
 
-	// This handy function gets the difference between two sets. It takes the difference between collision pairs from the last update,
-	// and this update and pushes them into the removed pairs list.
-	std::set_difference(m_pairsLastUpdate.begin(), m_pairsLastUpdate.end(), pairsThisUpdate.begin(), pairsThisUpdate.end(), std::inserter(removedPairs, removedPairs.begin()));
+	for (std::size_t i = 0; i < count; i++)
+	{
+		auto root = find(i);
 
-	// Iterate through all of the removed pairs sending separation events for them.
-	for (const auto &removedPair : removedPairs)
+		if (groupIndices[root] == count)
+		{
+			groupIndices[root] = groups.size();
+			groups.emplace_back();
+		}
+
+		groups[groupIndices[root]].emplace_back(i);
+	}
+
+	// Each controller only writes its own ghost object, and reads objects that no other group moves.
+	Engine::Get()->GetThreadPool().ParallelFor(0, groups.size(), [&](const std::size_t &group)
+	{
+		for (const auto &i : groups[group])
+		{
+			m_characters[i].m_character->m_controller->updateAction(m_characters[i].m_world.get(), delta);
+		}
+	}, 1);
+
+	for (const auto &character : m_characters)
 	{
-		// Gets the user pointer (entity).
-		auto collisionObjectA = static_cast<CollisionObject *>(removedPair.first->getUserPointer());
-		auto collisionObjectB = static_cast<CollisionObject *>(removedPair.second->getUserPointer());
+		auto ghostObject = character.m_character->m_ghostObject.get();
+		btVector3 min, max;
+		ghostObject->getCollisionShape()->getAabb(ghostObject->getWorldTransform(), min, max);
+		m_broadphase->setAabb(ghostObject->getBroadphaseHandle(), min, max, m_dispatcher.get());
+	}
+}
 
-		collisionObjectA->OnSeparation()(collisionObjectB);
+void ScenePhysics::UpdateSoftBodies()
+{
+	auto softDynamicsWorld = dynamic_cast<btSoftRigidDynamicsWorld *>(m_dynamicsWorld.get());
+	auto camera = Scenes::Get()->GetCamera();
+
+	if (softDynamicsWorld == nullptr || camera == nullptr)
+	{
+		return;
+	}
+
+	// Bodies removed from the world since the last update are forgotten.
+	auto &softBodies = softDynamicsWorld->getSoftBodyArray();
+	std::unordered_map<const btSoftBody *, SoftBodyLod> softBodyLods;
+	auto position = Collider::Convert(camera->GetPosition());
+
+	for (int32_t i = 0; i < softBodies.size(); i++)
+	{
+		auto softBody = softBodies[i];
+		auto it = m_softBodyLods.find(softBody);
+		auto lod = it != m_softBodyLods.end() ? it->second : SoftBodyLod{softBody->m_cfg.piterations, false};
+		auto distance = softBody->getBroadphaseHandle() != nullptr ? std::sqrt(BoundsDistance2(position, softBody->getBroadphaseHandle())) : 0.0f;
+
+		if (distance >= m_softBodyFar)
+		{
+			// Only bodies that are simulating are disabled, so bodies asleep or disabled by their owner are left as they are.
+			if (!lod.m_disabled && softBody->isActive())
+			{
+				softBody->forceActivationState(DISABLE_SIMULATION);
+				lod.m_disabled = true;
+			}
+		}
+		else
+		{
+			if (lod.m_disabled)
+			{
+				softBody->forceActivationState(ACTIVE_TAG);
+				lod.m_disabled = false;
+			}
+
+			// Position iterations are the most of the solvers cost, they fall off linearly to one at the far distance.
+			auto factor = distance <= m_softBodyNear ? 1.0f : 1.0f - (distance - m_softBodyNear) / (m_softBodyFar - m_softBodyNear);
+			softBody->m_cfg.piterations = std::max(1, static_cast<int32_t>(std::round(static_cast<float>(lod.m_iterations) * factor)));
+		}
+
+		softBodyLods.emplace(softBody, lod);
+	}
+
+	m_softBodyLods = std::move(softBodyLods);
+}
+
+void ScenePhysics::CheckForCollisionEvents()
+{
+	// This never runs during a step, so no callback adds events while they are read.
+	for (const auto &event : m_contactEvents)
+	{
+		auto collisionObjectA = static_cast<CollisionObject *>(event.m_pair.first->getUserPointer());
+		auto collisionObjectB = static_cast<CollisionObject *>(event.m_pair.second->getUserPointer());
+
+		if (event.m_started)
+		{
+			// A pair of compound shapes can touch in several manifolds, only the first sends a collision event.
+			if (m_pairs[event.m_pair]++ == 0)
+			{
+				collisionObjectA->OnCollision()(collisionObjectB);
+			}
+		}
+		else
+		{
+			auto it = m_pairs.find(event.m_pair);
+
+			if (it != m_pairs.end() && --it->second == 0)
+			{
+				m_pairs.erase(it);
+				collisionObjectA->OnSeparation()(collisionObjectB);
+			}
+		}
 	}
 
-	// In the next iteration we'll want to compare against the pairs we found in this iteration.
-	m_pairsLastUpdate = pairsThisUpdate;
+	m_contactEvents.clear();
 }
 }
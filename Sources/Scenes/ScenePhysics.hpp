@@ -1,25 +1,52 @@
 #pragma once
 
+#include <mutex>
+#include "Helpers/ThreadPool.hpp"
 #include "Maths/Vector3.hpp"
 
+class btActionInterface;
 class btCollisionObject;
 class btCollisionConfiguration;
+class btCollisionWorld;
 class btBroadphaseInterface;
 class btCollisionDispatcher;
 class btConstraintSolver;
+class btConstraintSolverPoolMt;
 class btDiscreteDynamicsWorld;
+class btPersistentManifold;
+class btSoftBody;
 
 namespace acid
 {
 class Entity;
 class CollisionObject;
+class Frustum;
+class KinematicCharacter;
 
 using CollisionPair = std::pair<const btCollisionObject *, const btCollisionObject *>;
-using CollisionPairs = std::set<CollisionPair>;
+
+class ACID_EXPORT CollisionPairHash
+{
+public:
+	std::size_t operator()(const CollisionPair &pair) const
+	{
+		auto seed = std::hash<const void *>()(pair.first);
+		return seed ^ (std::hash<const void *>()(pair.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+	}
+};
+
+// The number of touching manifolds between each pair of objects.
+using CollisionPairs = std::unordered_map<CollisionPair, uint32_t, CollisionPairHash>;
 
 class ACID_EXPORT Raycast
 {
 public:
+	Raycast() :
+		m_hasHit(false),
+		m_collisionObject(nullptr)
+	{
+	}
+
 	Raycast(bool m_hasHit, const Vector3f &m_pointWorld, CollisionObject *collisionObject) :
 		m_hasHit(m_hasHit),
 		m_pointWorld(m_pointWorld),
@@ -39,17 +66,156 @@ private:
 	CollisionObject *m_collisionObject;
 };
 
+/**
+ * @brief A ray from start to end for {@link ScenePhysics#Raytest}.
+ */
+class ACID_EXPORT RayQuery
+{
+public:
+	Vector3f m_start;
+	Vector3f m_end;
+};
+
+/**
+ * @brief A sphere swept from start to end for {@link ScenePhysics#SphereSweep}.
+ */
+class ACID_EXPORT SweepQuery
+{
+public:
+	Vector3f m_start;
+	Vector3f m_end;
+	float m_radius = 0.0f;
+};
+
+/**
+ * @brief A sphere tested against the broadphase for {@link ScenePhysics#SphereOverlap}.
+ */
+class ACID_EXPORT OverlapQuery
+{
+public:
+	Vector3f m_position;
+	float m_radius = 0.0f;
+};
+
+/**
+ * @brief The objects overlapping a {@link OverlapQuery}, the objects point into the buffer given to {@link ScenePhysics#SphereOverlap}.
+ */
+class ACID_EXPORT OverlapResult
+{
+public:
+	CollisionObject **m_objects = nullptr;
+	uint32_t m_count = 0;
+	bool m_truncated = false;
+};
+
+/**
+ * @brief Class that owns the dynamics world of a scene.
+ * A multithreaded world is stepped on the engines job system, concurrently with the rest of the frame.
+ * Entity transforms are the front buffer of such a world, they hold the results of the last finished step while the next step writes the bodies.
+ */
 class ACID_EXPORT ScenePhysics
 {
 public:
-	ScenePhysics();
+	/**
+	 * Creates a new scene physics system.
+	 * @param multithreaded If the world is a multithreaded world stepped on the job system, soft bodies are not supported in this world.
+	 * @param softBodies If the world can simulate soft bodies, a world without them skips the soft body solver and collision algorithms every step.
+	 */
+	explicit ScenePhysics(const bool &multithreaded = false, const bool &softBodies = false);
 
 	~ScenePhysics();
 
+	/**
+	 * Steps the world and sends collision events, a multithreaded world only sends the events of the last finished step.
+	 */
 	void Update();
 
+	/**
+	 * Starts stepping a multithreaded world on the job system, this does nothing for a world stepped in {@link ScenePhysics#Update}.
+	 */
+	void Dispatch();
+
+	/**
+	 * Waits until a step started by {@link ScenePhysics#Dispatch} has finished, the world must not be touched while it is stepping.
+	 */
+	void Wait();
+
+	/**
+	 * Adds a character controller that is stepped with the world, characters are stepped in the order they were added.
+	 * @param character The character.
+	 */
+	void AddCharacter(KinematicCharacter *character);
+
+	/**
+	 * Removes a character controller, this is called after the characters ghost object has been removed from the world.
+	 * @param character The character.
+	 */
+	void RemoveCharacter(KinematicCharacter *character);
+
 	Raycast Raytest(const Vector3f &start, const Vector3f &end);
 
+	/**
+	 * Casts a batch of rays in parallel, the closest hit of each ray is written into the result with the same index.
+	 * @param queries The rays.
+	 * @param results The results, this must hold count results.
+	 * @param count The number of rays.
+	 */
+	void Raytest(const RayQuery *queries, Raycast *results, const std::size_t &count);
+
+	/**
+	 * Sweeps a batch of spheres in parallel, the first hit of each sweep is written into the result with the same index.
+	 * @param queries The sweeps.
+	 * @param results The results, this must hold count results.
+	 * @param count The number of sweeps.
+	 */
+	void SphereSweep(const SweepQuery *queries, Raycast *results, const std::size_t &count);
+
+	/**
+	 * Finds the objects whos bounds overlap a batch of spheres in parallel.
+	 * @param queries The spheres.
+	 * @param results The results, this must hold count results.
+	 * @param count The number of spheres.
+	 * @param objects The buffer objects are written into, this must hold count * maxObjects objects.
+	 * @param maxObjects The most objects written for one sphere, further objects set {@link OverlapResult#m_truncated}.
+	 */
+	void SphereOverlap(const OverlapQuery *queries, OverlapResult *results, const std::size_t &count, CollisionObject **objects, const uint32_t &maxObjects);
+
+	/**
+	 * Finds the objects whos bounds are partially in a frustum, the frustum planes are tested against the broadphase tree so whole branches outside are skipped.
+	 * @param frustum The frustum.
+	 * @param objects The vector objects are appended to.
+	 */
+	void FrustumTest(const Frustum &frustum, std::vector<CollisionObject *> &objects);
+
+	/**
+	 * Finds the objects whos bounds overlap a box.
+	 * @param min The minimum corner of the box.
+	 * @param max The maximum corner of the box.
+	 * @param objects The vector objects are appended to.
+	 */
+	void AabbTest(const Vector3f &min, const Vector3f &max, std::vector<CollisionObject *> &objects);
+
+	/**
+	 * Finds the objects whos bounds overlap a sphere.
+	 * @param position The centre of the sphere.
+	 * @param radius The radius of the sphere.
+	 * @param objects The vector objects are appended to.
+	 */
+	void SphereTest(const Vector3f &position, const float &radius, std::vector<CollisionObject *> &objects);
+
+	/**
+	 * Finds the objects whos bounds are closest to a position, a sphere is grown around the position until enough objects are inside it.
+	 * @param position The position.
+	 * @param count The most objects found.
+	 * @param maxDistance The furthest distance from the position searched.
+	 * @param objects The vector objects are appended to, ordered from nearest to furthest.
+	 */
+	void NearestTest(const Vector3f &position, const uint32_t &count, const float &maxDistance, std::vector<CollisionObject *> &objects);
+
+	const bool &IsMultithreaded() const { return m_multithreaded; }
+
+	const bool &IsSoftBodies() const { return m_softBodies; }
+
 	const Vector3f &GetGravity() const { return m_gravity; }
 
 	void SetGravity(const Vector3f &gravity);
@@ -58,21 +224,160 @@ public:
 
 	void SetAirDensity(const float &airDensity);
 
-	btBroadphaseInterface *GetBroadphase() { return m_broadphase.get(); }
+	const float &GetSubstepRate() const { return m_substepRate; }
+
+	/**
+	 * Sets the rate the world is stepped at, each update runs as many fixed substeps as fit in its delta.
+	 * @param substepRate The substeps per second.
+	 */
+	void SetSubstepRate(const float &substepRate);
+
+	const uint32_t &GetMaxSubsteps() const { return m_maxSubsteps; }
+
+	/**
+	 * Sets the most substeps run in one update, the world falls behind instead of taking longer to step when a update is too long.
+	 * @param maxSubsteps The most substeps in a update.
+	 */
+	void SetMaxSubsteps(const uint32_t &maxSubsteps);
+
+	const float &GetDeactivationTime() const { return m_deactivationTime; }
+
+	/**
+	 * Sets how long a body has to stay under its sleeping thresholds before its island can be put to sleep, Bullet shares this between every world.
+	 * @param deactivationTime The time in seconds.
+	 */
+	void SetDeactivationTime(const float &deactivationTime);
+
+	const float &GetSoftBodyNear() const { return m_softBodyNear; }
+
+	/**
+	 * Sets the distance from the camera soft bodies are simulated at full quality within, further bodies are solved with fewer iterations.
+	 * @param softBodyNear The distance.
+	 */
+	void SetSoftBodyNear(const float &softBodyNear) { m_softBodyNear = softBodyNear; }
+
+	const float &GetSoftBodyFar() const { return m_softBodyFar; }
+
+	/**
+	 * Sets the distance from the camera soft bodies stop being simulated at, they are simulated again once closer.
+	 * @param softBodyFar The distance.
+	 */
+	void SetSoftBodyFar(const float &softBodyFar) { m_softBodyFar = softBodyFar; }
+
+	btBroadphaseInterface *GetBroadphase()
+	{
+		Wait();
+		return m_broadphase.get();
+	}
 
-	btDiscreteDynamicsWorld *GetDynamicsWorld() { return m_dynamicsWorld.get(); }
+	btDiscreteDynamicsWorld *GetDynamicsWorld()
+	{
+		Wait();
+		return m_dynamicsWorld.get();
+	}
 
 private:
+	friend class CharacterAction;
+
+	/**
+	 * @brief A character controller stepped by the world.
+	 */
+	class Character
+	{
+	public:
+		KinematicCharacter *m_character;
+		// In a multithreaded world each character has its own dispatcher and world, so it can recover from penetration on any thread.
+		std::unique_ptr<btCollisionDispatcher> m_dispatcher;
+		std::unique_ptr<btCollisionWorld> m_world;
+	};
+
+	/**
+	 * @brief The quality a soft body was given when it was first seen, and if it was disabled for being too far away.
+	 */
+	class SoftBodyLod
+	{
+	public:
+		int32_t m_iterations;
+		bool m_disabled;
+	};
+
+	/**
+	 * Runs a query for every index in a batch, on the job system when Bullet is built thread safe.
+	 * @tparam F The function type, called with a std::size_t index.
+	 * @param count The number of queries.
+	 * @param f The function.
+	 */
+	template<typename F>
+	static void ForEachQuery(const std::size_t &count, F &&f);
+
+	/**
+	 * A manifold that started or stopped touching during a step.
+	 */
+	class ContactEvent
+	{
+	public:
+		CollisionPair m_pair;
+		bool m_started;
+	};
+
+	static void OnContactStarted(btPersistentManifold *const &manifold);
+
+	static void OnContactEnded(btPersistentManifold *const &manifold);
+
+	/**
+	 * Records a manifold starting or ending contact, manifolds ending outside of a step belong to objects being removed and end without a event.
+	 * @param manifold The manifold.
+	 * @param started If the manifold started touching.
+	 */
+	void OnContact(const btPersistentManifold *manifold, const bool &started);
+
+	void Step(const float &delta);
+
+	/**
+	 * Steps the character controllers, called by the world after it integrated its bodies.
+	 * Characters that can not reach each other this step are stepped in parallel in a multithreaded world, their broadphase bounds are then written back in order.
+	 * @param world The world.
+	 * @param delta The substep time.
+	 */
+	void UpdateCharacters(btCollisionWorld *world, const float &delta);
+
+	/**
+	 * Sets the simulation quality of every soft body from its distance to the camera, run before each step.
+	 */
+	void UpdateSoftBodies();
+
+	/**
+	 * Sends collision and separation events for the contacts recorded during the last step.
+	 */
 	void CheckForCollisionEvents();
 
+	// The physics that receives Bullets global contact callbacks, this is the newest scene physics.
+	static ScenePhysics *ContactPhysics;
+
+	bool m_multithreaded;
+	bool m_softBodies;
 	std::unique_ptr<btCollisionConfiguration> m_collisionConfiguration;
 	std::unique_ptr<btBroadphaseInterface> m_broadphase;
 	std::unique_ptr<btCollisionDispatcher> m_dispatcher;
+	std::unique_ptr<btConstraintSolverPoolMt> m_solverPool;
 	std::unique_ptr<btConstraintSolver> m_solver;
 	std::unique_ptr<btDiscreteDynamicsWorld> m_dynamicsWorld;
-	CollisionPairs m_pairsLastUpdate;
+	std::unique_ptr<btActionInterface> m_characterAction;
+	std::unique_ptr<btBroadphaseInterface> m_characterBroadphase;
+	std::vector<Character> m_characters;
+	std::unordered_map<const btSoftBody *, SoftBodyLod> m_softBodyLods;
+	CollisionPairs m_pairs;
+	std::vector<ContactEvent> m_contactEvents;
+	std::mutex m_contactMutex;
+	std::atomic<bool> m_inStep;
+	ThreadPool::Counter m_stepping;
 
 	Vector3f m_gravity;
 	float m_airDensity;
+	float m_substepRate;
+	uint32_t m_maxSubsteps;
+	float m_deactivationTime;
+	float m_softBodyNear;
+	float m_softBodyFar;
 };
 }
@@ -0,0 +1,362 @@
+#include "SceneStreamer.hpp"
+
+#include "Engine/Engine.hpp"
+#include "Files/File.hpp"
+#include "Files/Files.hpp"
+#include "Files/FileSystem.hpp"
+#include "Resources/Resources.hpp"
+#include "Serialized/Json/Json.hpp"
+#include "EntityPrefab.hpp"
+#include "Scenes.hpp"
+
+namespace acid
+{
+SceneStreamer::SceneStreamer(std::string directory, const float &cellSize, const float &loadDistance, const float &unloadDistance, const Time &commitBudget) :
+	m_directory(std::move(directory)),
+	m_cellSize(cellSize),
+	m_loadDistance(loadDistance),
+	m_unloadDistance(std::max(unloadDistance, loadDistance)),
+	m_commitBudget(commitBudget)
+{
+}
+
+SceneStreamer::~SceneStreamer()
+{
+	// Loading jobs write into cells owned by this streamer.
+	Engine::Get()->GetThreadPool().Wait(m_loading);
+}
+
+void SceneStreamer::Update(SceneStructure &structure, const Vector3f &position)
+{
+	// Cells in range that are not loaded are requested nearest first, so the job system reads them in that order.
+	auto centre = GetCellIndex(position);
+	auto range = static_cast<int32_t>(std::ceil(m_loadDistance / m_cellSize));
+	std::vector<std::pair<float, Vector2i>> requested;
+
+	for (int32_t z = -range; z <= range; z++)
+	{
+		for (int32_t x = -range; x <= range; x++)
+		{
+			Vector2i index(centre.m_x + x, centre.m_y + z);
+			auto distance = GetDistance(index, position);
+
+			if (distance > m_loadDistance)
+			{
+				continue;
+			}
+
+			if (auto it = m_cells.find(index); it != m_cells.end())
+			{
+				// A cell that came back into range while loading is kept.
+				it->second->m_unload = false;
+				continue;
+			}
+
+			requested.emplace_back(distance, index);
+		}
+	}
+
+	std::sort(requested.begin(), requested.end(), [](const std::pair<float, Vector2i> &a, const std::pair<float, Vector2i> &b)
+	{
+		return a.first < b.first;
+	});
+
+	for (const auto &[distance, index] : requested)
+	{
+		auto cell = std::make_unique<Cell>();
+		cell->m_index = index;
+		Engine::Get()->GetThreadPool().Dispatch([this, cell = cell.get()]()
+		{
+			Load(*cell);
+		}, &m_loading);
+		m_cells.emplace(index, std::move(cell));
+	}
+
+	// The entities still in the structure are only gathered when a cell with committed entities is unloaded.
+	std::unordered_set<Entity *> alive;
+	auto aliveGathered = false;
+
+	for (auto it = m_cells.begin(); it != m_cells.end();)
+	{
+		auto &cell = *it->second;
+
+		if (GetDistance(cell.m_index, position) > m_unloadDistance)
+		{
+			cell.m_unload = true;
+		}
+
+		if (!cell.m_unload || !cell.m_loaded.load(std::memory_order_acquire))
+		{
+			++it;
+			continue;
+		}
+
+		if (!cell.m_entities.empty() && !aliveGathered)
+		{
+			for (const auto &entity : structure.QueryAll())
+			{
+				alive.emplace(entity);
+			}
+
+			aliveGathered = true;
+		}
+
+		Unload(cell, alive);
+		it = m_cells.erase(it);
+	}
+
+	// Loaded entities are added nearest cell first until the budget is spent, at least one entity is added each update.
+	std::vector<std::pair<float, Cell *>> committing;
+
+	for (const auto &[index, cell] : m_cells)
+	{
+		if (cell->m_loaded.load(std::memory_order_acquire) && !cell->m_pending.empty())
+		{
+			committing.emplace_back(GetDistance(index, position), cell.get());
+		}
+	}
+
+	std::sort(committing.begin(), committing.end(), [](const std::pair<float, Cell *> &a, const std::pair<float, Cell *> &b)
+	{
+		return a.first < b.first;
+	});
+
+	auto start = Engine::GetTime();
+	auto first = true;
+
+	for (const auto &[distance, cell] : committing)
+	{
+		while (cell->m_committed < cell->m_pending.size())
+		{
+			if (!first && Engine::GetTime() - start > m_commitBudget)
+			{
+				return;
+			}
+
+			first = false;
+			auto &pending = cell->m_pending[cell->m_committed++];
+			auto entity = pending.m_entity.get();
+			structure.Add(std::move(pending.m_entity));
+
+			if (pending.m_parent != nullptr)
+			{
+				entity->SetParent(pending.m_parent);
+			}
+
+			cell->m_entities.emplace_back(entity);
+		}
+
+		cell->m_pending.clear();
+		cell->m_committed = 0;
+	}
+
+	if (auto profiler = Profiler::Get(); profiler != nullptr && profiler->IsEnabled())
+	{
+		profiler->SetCounter("Streaming Cells", static_cast<double>(GetStreamingCount()));
+		profiler->SetCounter("Resident Cells", static_cast<double>(GetResidentCount()));
+	}
+}
+
+void SceneStreamer::UnloadAll(SceneStructure &structure)
+{
+	std::unordered_set<Entity *> alive;
+
+	for (const auto &entity : structure.QueryAll())
+	{
+		alive.emplace(entity);
+	}
+
+	for (auto it = m_cells.begin(); it != m_cells.end();)
+	{
+		auto &cell = *it->second;
+		cell.m_unload = true;
+
+		if (!cell.m_loaded.load(std::memory_order_acquire))
+		{
+			++it;
+			continue;
+		}
+
+		Unload(cell, alive);
+		it = m_cells.erase(it);
+	}
+}
+
+Vector2i SceneStreamer::GetCellIndex(const Vector3f &position) const
+{
+	return Vector2i(static_cast<int32_t>(std::floor(position.m_x / m_cellSize)), static_cast<int32_t>(std::floor(position.m_z / m_cellSize)));
+}
+
+std::string SceneStreamer::GetCellFilename(const Vector2i &index) const
+{
+	return m_directory + "/" + String::To(index.m_x) + "_" + String::To(index.m_y) + ".json";
+}
+
+uint32_t SceneStreamer::GetStreamingCount() const
+{
+	return static_cast<uint32_t>(std::count_if(m_cells.begin(), m_cells.end(), [](const auto &cell)
+	{
+		return !cell.second->m_loaded.load(std::memory_order_acquire) || !cell.second->m_pending.empty();
+	}));
+}
+
+uint32_t SceneStreamer::GetResidentCount() const
+{
+	return static_cast<uint32_t>(m_cells.size()) - GetStreamingCount();
+}
+
+void SceneStreamer::Load(Cell &cell) const
+{
+	auto filename = GetCellFilename(cell.m_index);
+
+	// Cells without a file are empty, they stay loaded so the file is not searched for again while in range.
+	if (!Files::ExistsInPath(filename) && !FileSystem::Exists(filename))
+	{
+		cell.m_loaded.store(true, std::memory_order_release);
+		return;
+	}
+
+	File file(filename, new Json());
+	file.Read();
+
+	auto &componentRegister = Scenes::Get()->GetComponentRegister();
+	std::vector<std::unique_ptr<Entity>> entities;
+	std::vector<int32_t> parents;
+
+	for (const auto &entityMetadata : file.GetMetadata()->GetChildren())
+	{
+		Transform transform;
+		entityMetadata->GetChild("Transform", transform);
+		std::unique_ptr<Entity> entity;
+
+		if (auto prefabMetadata = entityMetadata->FindChild("Prefab", false))
+		{
+			std::string prefabFilename;
+			*prefabMetadata >> prefabFilename;
+			auto prefab = EntityPrefab::Create(prefabFilename);
+			entity = std::make_unique<Entity>(*prefab, transform);
+
+			if (std::find(cell.m_prefabs.begin(), cell.m_prefabs.end(), prefab) == cell.m_prefabs.end())
+			{
+				cell.m_prefabs.emplace_back(prefab);
+			}
+		}
+		else
+		{
+			entity = std::make_unique<Entity>(transform);
+		}
+
+		if (auto nameMetadata = entityMetadata->FindChild("Name", false))
+		{
+			std::string name;
+			*nameMetadata >> name;
+			entity->SetName(name);
+		}
+
+		if (auto components = entityMetadata->FindChild("Components", false))
+		{
+			for (const auto &componentMetadata : components->GetChildren())
+			{
+				auto component = componentRegister.Create(componentMetadata->GetName());
+
+				if (component == nullptr)
+				{
+					continue;
+				}
+
+				componentRegister.Decode(componentMetadata->GetName(), *componentMetadata, component);
+				entity->AddComponent(component);
+			}
+		}
+
+		int32_t parent = -1;
+
+		if (auto parentMetadata = entityMetadata->FindChild("Parent", false))
+		{
+			*parentMetadata >> parent;
+		}
+
+		entities.emplace_back(std::move(entity));
+		parents.emplace_back(parent);
+	}
+
+	// Entities are committed ordered by depth, so a parent is in the structure before its children. Parents out of range or in a cycle are dropped.
+	auto count = static_cast<int32_t>(entities.size());
+	std::vector<std::pair<int32_t, int32_t>> depths;
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		int32_t depth = 0;
+
+		for (auto parent = parents[i]; parent >= 0 && depth <= count; parent = parents[parent])
+		{
+			if (parent >= count)
+			{
+				parents[i] = -1;
+				depth = 0;
+				break;
+			}
+
+			depth++;
+		}
+
+		if (depth > count)
+		{
+			parents[i] = -1;
+			depth = 0;
+		}
+
+		depths.emplace_back(depth, i);
+	}
+
+	std::stable_sort(depths.begin(), depths.end(), [](const std::pair<int32_t, int32_t> &a, const std::pair<int32_t, int32_t> &b)
+	{
+		return a.first < b.first;
+	});
+
+	for (const auto &[depth, i] : depths)
+	{
+		Pending pending;
+		pending.m_parent = parents[i] >= 0 ? entities[parents[i]].get() : nullptr;
+		pending.m_entity = std::move(entities[i]);
+		cell.m_pending.emplace_back(std::move(pending));
+	}
+
+	cell.m_loaded.store(true, std::memory_order_release);
+}
+
+void SceneStreamer::Unload(Cell &cell, const std::unordered_set<Entity *> &alive)
+{
+	// Removed entities are erased by the next structure update.
+	for (const auto &entity : cell.m_entities)
+	{
+		if (alive.find(entity) != alive.end())
+		{
+			entity->SetRemoved(true);
+		}
+	}
+
+	cell.m_entities.clear();
+	cell.m_pending.clear();
+
+	// A prefab only held by this cell and the resource cache is released now instead of at the next purge.
+	for (auto &prefab : cell.m_prefabs)
+	{
+		if (prefab.use_count() <= 2)
+		{
+			Resources::Get()->Remove(prefab);
+		}
+	}
+
+	cell.m_prefabs.clear();
+}
+
+float SceneStreamer::GetDistance(const Vector2i &index, const Vector3f &position) const
+{
+	auto minX = static_cast<float>(index.m_x) * m_cellSize;
+	auto minZ = static_cast<float>(index.m_y) * m_cellSize;
+	auto dx = std::max({ minX - position.m_x, 0.0f, position.m_x - (minX + m_cellSize) });
+	auto dz = std::max({ minZ - position.m_z, 0.0f, position.m_z - (minZ + m_cellSize) });
+	return std::sqrt(dx * dx + dz * dz);
+}
+}
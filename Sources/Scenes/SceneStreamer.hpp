@@ -0,0 +1,148 @@
+#pragma once
+
+#include <unordered_set>
+#include "Helpers/NonCopyable.hpp"
+#include "Helpers/ThreadPool.hpp"
+#include "Maths/Time.hpp"
+#include "Maths/Vector2.hpp"
+#include "Maths/Vector3.hpp"
+#include "Entity.hpp"
+
+namespace acid
+{
+class SceneStructure;
+
+/**
+ * @brief Class that streams a world partitioned into a grid of cells around a position, usually the camera.
+ * Each cell is a file in a directory named by its index on the XZ plane, such as "3_-2.json", holding a list of entities in the format written by {@link SceneStructure} operator<<,
+ * a entity may also name a "Prefab" that its components are created from before its own components are added.
+ * Cells that come within the load distance are read and their entities and resources created on the engines job system, then added to the structure over several frames
+ * within the commit budget, nearest cells first. Cells beyond the unload distance have their entities removed and their prefabs released from {@link Resources}, resources used only by their components are released by the next purge of {@link Resources}.
+ * Entities of a cell are owned by the streamer, the game may change them but any it removes are skipped when the cell is unloaded.
+ */
+class ACID_EXPORT SceneStreamer :
+	public NonCopyable
+{
+public:
+	/**
+	 * Creates a new scene streamer.
+	 * @param directory The directory the cell files are read from.
+	 * @param cellSize The size of each cell on the X and Z axes.
+	 * @param loadDistance The distance from the position to a cells nearest edge within which the cell is loaded.
+	 * @param unloadDistance The distance beyond which a loaded cell is unloaded, larger than the load distance so cells on the edge are not reloaded every frame.
+	 * @param commitBudget The time spent adding loaded entities to the structure each update.
+	 */
+	explicit SceneStreamer(std::string directory, const float &cellSize = 64.0f, const float &loadDistance = 192.0f, const float &unloadDistance = 256.0f,
+		const Time &commitBudget = Time::Milliseconds(2.0f));
+
+	~SceneStreamer();
+
+	/**
+	 * Starts loading cells near the position, adds loaded entities to the structure within the commit budget, and unloads cells that are out of range.
+	 * @param structure The structure streamed entities are added to.
+	 * @param position The position cells are streamed around.
+	 */
+	void Update(SceneStructure &structure, const Vector3f &position);
+
+	/**
+	 * Removes the entities of every cell from the structure, cells still loading are dropped once they finish.
+	 * @param structure The structure streamed entities were added to.
+	 */
+	void UnloadAll(SceneStructure &structure);
+
+	/**
+	 * Gets the index of the cell containing a position.
+	 * @param position The position.
+	 * @return The cell index on the X and Z axes.
+	 */
+	Vector2i GetCellIndex(const Vector3f &position) const;
+
+	/**
+	 * Gets the file a cell is read from.
+	 * @param index The cell index.
+	 * @return The cell filename.
+	 */
+	std::string GetCellFilename(const Vector2i &index) const;
+
+	const std::string &GetDirectory() const { return m_directory; }
+
+	const float &GetCellSize() const { return m_cellSize; }
+
+	const float &GetLoadDistance() const { return m_loadDistance; }
+
+	void SetLoadDistance(const float &loadDistance) { m_loadDistance = loadDistance; }
+
+	const float &GetUnloadDistance() const { return m_unloadDistance; }
+
+	void SetUnloadDistance(const float &unloadDistance) { m_unloadDistance = unloadDistance; }
+
+	const Time &GetCommitBudget() const { return m_commitBudget; }
+
+	void SetCommitBudget(const Time &commitBudget) { m_commitBudget = commitBudget; }
+
+	/**
+	 * Gets the number of cells being read or waiting to be added to the structure.
+	 * @return The number of streaming cells.
+	 */
+	uint32_t GetStreamingCount() const;
+
+	/**
+	 * Gets the number of cells whose entities have all been added to the structure.
+	 * @return The number of resident cells.
+	 */
+	uint32_t GetResidentCount() const;
+
+private:
+	class Pending
+	{
+	public:
+		std::unique_ptr<Entity> m_entity;
+		/// The parent from the same cell, added to the structure before this entity.
+		Entity *m_parent = nullptr;
+	};
+
+	class Cell
+	{
+	public:
+		Vector2i m_index;
+		/// Set by the loading job once the pending entities can be read.
+		std::atomic<bool> m_loaded = false;
+		/// Set when the cell went out of range while loading, it is dropped without being committed.
+		bool m_unload = false;
+		std::vector<Pending> m_pending;
+		std::size_t m_committed = 0;
+		std::vector<Entity *> m_entities;
+		std::vector<std::shared_ptr<EntityPrefab>> m_prefabs;
+	};
+
+	/**
+	 * Reads a cell file and creates its entities, run on the job system.
+	 * @param cell The cell to load.
+	 */
+	void Load(Cell &cell) const;
+
+	/**
+	 * Removes the committed entities of a cell from the structure and releases its prefabs.
+	 * @param cell The cell to unload.
+	 * @param alive The entities still in the structure.
+	 */
+	static void Unload(Cell &cell, const std::unordered_set<Entity *> &alive);
+
+	/**
+	 * Gets the distance on the XZ plane from a position to the nearest edge of a cell.
+	 * @param index The cell index.
+	 * @param position The position.
+	 * @return The distance, zero if the position is inside the cell.
+	 */
+	float GetDistance(const Vector2i &index, const Vector3f &position) const;
+
+	std::string m_directory;
+	float m_cellSize;
+	float m_loadDistance;
+	float m_unloadDistance;
+	Time m_commitBudget;
+
+	std::unordered_map<Vector2i, std::unique_ptr<Cell>> m_cells;
+	ThreadPool::Counter m_loading;
+};
+}
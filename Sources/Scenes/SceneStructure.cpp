@@ -1,76 +1,274 @@
 ﻿#include "SceneStructure.hpp"
 
+#include "Engine/Engine.hpp"
 #include "Physics/Rigidbody.hpp"
+#include "EntityPrefab.hpp"
+#include "Scenes.hpp"
 
 namespace acid
 {
-SceneStructure::SceneStructure()
+// How far from the camera a component waits twice as long as the same component at the camera when the update budget is short.
+static const float SLICED_DISTANCE = 50.0f;
+// Parallel updates are split into jobs of this many components, each update is usually short.
+static const std::size_t PARALLEL_GRAIN_SIZE = 64;
+
+SceneStructure::SceneStructure() :
+	m_transformsSorted(false),
+	m_updateBudget(Time::Milliseconds(1.0f)),
+	m_updateFrame(0),
+	m_updating(false),
+	m_deferring(false)
 {
 }
 
 Entity *SceneStructure::CreateEntity(const Transform &transform)
 {
 	auto entity = new Entity(transform);
-	m_objects.emplace_back(entity);
+	Add(entity);
 	return entity;
 }
 
 Entity *SceneStructure::CreateEntity(const std::string &filename, const Transform &transform)
 {
-	auto entity = new Entity(filename, transform);
-	m_objects.emplace_back(entity);
+	auto entity = new Entity(*GetPrefab(filename), transform);
+	Add(entity);
 	return entity;
 }
 
+std::vector<Entity *> SceneStructure::CreateEntities(const std::vector<std::pair<std::string, Transform>> &prefabs)
+{
+	auto &threadPool = Engine::Get()->GetThreadPool();
+
+	// Every prefab is loaded by its own job first, so the jobs that create entities only read them.
+	std::vector<std::string> filenames;
+
+	for (const auto &[filename, transform] : prefabs)
+	{
+		filenames.emplace_back(filename);
+	}
+
+	std::sort(filenames.begin(), filenames.end());
+	filenames.erase(std::unique(filenames.begin(), filenames.end()), filenames.end());
+
+	std::vector<std::shared_ptr<EntityPrefab>> loaded(filenames.size());
+	threadPool.ParallelFor(0, filenames.size(), [&](const std::size_t &i)
+	{
+		loaded[i] = GetPrefab(filenames[i]);
+	}, 1);
+
+	std::vector<std::unique_ptr<Entity>> entities(prefabs.size());
+	threadPool.ParallelFor(0, prefabs.size(), [&](const std::size_t &i)
+	{
+		auto it = std::lower_bound(filenames.begin(), filenames.end(), prefabs[i].first);
+		entities[i] = std::make_unique<Entity>(*loaded[it - filenames.begin()], prefabs[i].second);
+	});
+
+	std::vector<Entity *> created;
+	created.reserve(entities.size());
+	m_objects.reserve(m_objects.size() + entities.size());
+
+	for (auto &entity : entities)
+	{
+		created.emplace_back(entity.get());
+		Add(std::move(entity));
+	}
+
+	return created;
+}
+
+std::shared_ptr<EntityPrefab> SceneStructure::GetPrefab(const std::string &filename)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_prefabMutex);
+		auto it = m_prefabs.find(filename);
+
+		if (it != m_prefabs.end())
+		{
+			return it->second;
+		}
+	}
+
+	// Loaded without holding the lock, so different prefabs load at the same time.
+	auto prefab = EntityPrefab::Create(filename);
+	std::lock_guard<std::mutex> lock(m_prefabMutex);
+	return m_prefabs.emplace(filename, prefab).first->second;
+}
+
 void SceneStructure::Add(Entity *object)
 {
-	m_objects.emplace_back(object);
+	if (Defer([this, object]()
+	{
+		Add(object);
+	}))
+	{
+		return;
+	}
+
+	InsertObject(std::unique_ptr<Entity>(object));
 }
 
 void SceneStructure::Add(std::unique_ptr<Entity> object)
 {
-	m_objects.emplace_back(std::move(object));
+	if (m_deferring)
+	{
+		Add(object.release());
+		return;
+	}
+
+	InsertObject(std::move(object));
 }
 
 void SceneStructure::Remove(Entity *object)
 {
-	m_objects.erase(std::remove_if(m_objects.begin(), m_objects.end(), [object](std::unique_ptr<Entity> &e)
+	if (Defer([this, object]()
+	{
+		Remove(object);
+	}))
+	{
+		return;
+	}
+
+	if (!Contains(object))
 	{
-		return e.get() == object;
-	}), m_objects.end());
+		return;
+	}
+
+	// Components removed while the entities are updated may still be in the update lists, so the entity is only destroyed at the next update.
+	object->m_removed = true;
+	DetachEntity(object);
+	m_removed.emplace_back(object->m_handle);
+}
+
+void SceneStructure::Remove(const EntityHandle &handle)
+{
+	if (auto object = Get(handle))
+	{
+		Remove(object);
+	}
+}
+
+Entity *SceneStructure::Get(const EntityHandle &handle) const
+{
+	// Freed slots have a newer generation, so stale handles do not match.
+	if (handle.GetIndex() >= m_slots.size() || m_slots[handle.GetIndex()].m_generation != handle.GetGeneration())
+	{
+		return nullptr;
+	}
+
+	auto &object = m_objects[m_slots[handle.GetIndex()].m_object];
+	return object->m_structure == this ? object.get() : nullptr;
 }
 
 void SceneStructure::Move(Entity *object, SceneStructure &structure)
 {
-	for (auto it = --m_objects.end(); it != m_objects.begin(); --it)
+	if (Defer([this, object, &structure]()
 	{
-		if ((*it).get() != object)
-		{
-			continue;
-		}
+		Move(object, structure);
+	}))
+	{
+		return;
+	}
 
-		structure.Add(std::move(*it));
-		m_objects.erase(it);
+	if (!Contains(object))
+	{
+		return;
 	}
+
+	DetachEntity(object);
+	structure.Add(ExtractObject(object));
 }
 
 void SceneStructure::Clear()
 {
+	if (Defer([this]()
+	{
+		Clear();
+	}))
+	{
+		return;
+	}
+
+	for (auto &[typeId, query] : m_queries)
+	{
+		query.m_components.clear();
+		query.m_indices.clear();
+	}
+
+	// Every slot is freed, handles to the cleared objects never find the objects that reuse them.
+	m_freeSlots.clear();
+
+	for (uint32_t i = 0; i < m_slots.size(); i++)
+	{
+		if (++m_slots[i].m_generation == 0)
+		{
+			m_slots[i].m_generation = 1;
+		}
+
+		m_freeSlots.emplace_back(static_cast<uint32_t>(m_slots.size()) - i - 1);
+	}
+
+	for (auto &object : m_objects)
+	{
+		object->m_structure = nullptr;
+		object->m_handle = {};
+	}
+
 	m_objects.clear();
+	m_removed.clear();
+	m_transformOrder.clear();
+	m_transformsSorted = false;
+	std::lock_guard<std::mutex> lock(m_prefabMutex);
+	m_prefabs.clear();
 }
 
 void SceneStructure::Update()
 {
-	for (auto it = m_objects.begin(); it != m_objects.end();)
+	// Entities removed since the last update are destroyed together, the frame they were removed in has been drawn.
+	DestroyRemoved();
+
+	// Components can remove entities or components while being updated, those removed are skipped by the sliced updates.
+	m_updating = true;
+	m_updateFrame++;
+	std::pmr::vector<Component *> sliced(FrameAllocator::Get());
+	std::pmr::vector<Component *> parallel(FrameAllocator::Get());
+
+	// Indexed, entities moved to another structure while updating swap the last entity into their place.
+	for (std::size_t i = 0; i < m_objects.size(); i++)
+	{
+		if (!m_objects[i]->IsRemoved())
+		{
+			m_objects[i]->UpdateComponents(&sliced, &parallel);
+		}
+	}
+
+	UpdateParallel(parallel);
+	UpdateSliced(sliced);
+	m_updating = false;
+	m_removedInUpdate.clear();
+}
+
+void SceneStructure::UpdateTransforms()
+{
+	if (!m_transformsSorted)
+	{
+		SortTransforms();
+	}
+
+	// Parents are updated before their children, so each entity only compares against its parent.
+	for (const auto &entity : m_transformOrder)
 	{
-		if ((*it)->IsRemoved())
+		auto parent = entity->m_parent;
+
+		if (parent != nullptr && parent->m_structure != this)
 		{
-			it = m_objects.erase(it);
+			entity->GetWorldTransform();
 			continue;
 		}
 
-		(*it)->Update();
-		++it;
+		if (entity->m_localTransform.IsDirty() || entity->m_worldVersion == 0 || (parent != nullptr && entity->m_parentWorldVersion != parent->m_worldVersion))
+		{
+			entity->ComputeWorldTransform();
+		}
 	}
 }
 
@@ -93,46 +291,512 @@ std::vector<Entity *> SceneStructure::QueryAll()
 
 std::vector<Entity *> SceneStructure::QueryFrustum(const Frustum &range)
 {
-	std::vector<Entity *> entities;
+	std::vector<CollisionObject *> objects;
+
+	if (auto physics = Scenes::Get()->GetPhysics())
+	{
+		physics->FrustumTest(range, objects);
+	}
+
+	return GetEntities(objects);
+}
+
+std::vector<Entity *> SceneStructure::QuerySphere(const Vector3f &centre, const float &radius)
+{
+	std::vector<CollisionObject *> objects;
+
+	if (auto physics = Scenes::Get()->GetPhysics())
+	{
+		physics->SphereTest(centre, radius, objects);
+	}
+
+	return GetEntities(objects);
+}
+
+std::vector<Entity *> SceneStructure::QueryCube(const Vector3f &min, const Vector3f &max)
+{
+	std::vector<CollisionObject *> objects;
+
+	if (auto physics = Scenes::Get()->GetPhysics())
+	{
+		physics->AabbTest(min, max, objects);
+	}
+
+	return GetEntities(objects);
+}
+
+std::vector<Entity *> SceneStructure::QueryNearest(const Vector3f &position, const uint32_t &count, const float &maxDistance)
+{
+	std::vector<CollisionObject *> objects;
+
+	if (auto physics = Scenes::Get()->GetPhysics())
+	{
+		physics->NearestTest(position, count, maxDistance, objects);
+	}
+
+	return GetEntities(objects);
+}
+
+SceneStructure::Query &SceneStructure::GetQuery(const TypeId &typeId, const std::function<bool(Component *)> &matches)
+{
+	std::lock_guard<std::mutex> lock(m_queryMutex);
+	auto it = m_queries.find(typeId);
+
+	if (it != m_queries.end())
+	{
+		return it->second;
+	}
+
+	auto &query = m_queries[typeId];
+	query.m_matches = matches;
 
 	for (const auto &object : m_objects)
 	{
-		if (object->IsRemoved())
+		if (object->m_structure != this)
 		{
 			continue;
 		}
 
-		auto rigidbody = object->GetComponent<Rigidbody>();
+		for (const auto &component : object->GetComponents())
+		{
+			if (matches(component.get()))
+			{
+				query.m_indices[component.get()] = query.m_components.size();
+				query.m_components.emplace_back(component.get());
+			}
+		}
+	}
+
+	return query;
+}
+
+void SceneStructure::InsertObject(std::unique_ptr<Entity> object)
+{
+	// Slots of destroyed entities are reused first, their generation was incremented when they were freed.
+	uint32_t index;
+
+	if (!m_freeSlots.empty())
+	{
+		index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_slots.size());
+		m_slots.emplace_back();
+	}
+
+	auto &slot = m_slots[index];
+	slot.m_object = static_cast<uint32_t>(m_objects.size());
+	object->m_handle = EntityHandle(index, slot.m_generation);
+	AttachEntity(object.get());
+	m_objects.emplace_back(std::move(object));
+}
+
+std::unique_ptr<Entity> SceneStructure::ExtractObject(Entity *object)
+{
+	auto index = object->m_handle.GetIndex();
+	auto &slot = m_slots[index];
+	auto extracted = std::move(m_objects[slot.m_object]);
+
+	// Swaps the last entity into the removed place, so removal does not shift the entities.
+	if (slot.m_object != m_objects.size() - 1)
+	{
+		m_objects[slot.m_object] = std::move(m_objects.back());
+		m_slots[m_objects[slot.m_object]->m_handle.GetIndex()].m_object = slot.m_object;
+	}
 
-		if (rigidbody == nullptr || rigidbody->InFrustum(range))
+	m_objects.pop_back();
+
+	if (++slot.m_generation == 0)
+	{
+		slot.m_generation = 1;
+	}
+
+	m_freeSlots.emplace_back(index);
+	extracted->m_handle = {};
+	m_transformsSorted = false;
+	return extracted;
+}
+
+void SceneStructure::DestroyRemoved()
+{
+	if (m_removed.empty())
+	{
+		return;
+	}
+
+	// Destructors may remove more entities, those are destroyed with the next batch.
+	auto removed = std::move(m_removed);
+	m_removed.clear();
+
+	for (const auto &handle : removed)
+	{
+		if (handle.GetIndex() < m_slots.size() && m_slots[handle.GetIndex()].m_generation == handle.GetGeneration())
 		{
-			entities.emplace_back(object.get());
+			ExtractObject(m_objects[m_slots[handle.GetIndex()].m_object].get());
 		}
 	}
 
+	if (auto profiler = Profiler::Get(); profiler != nullptr && profiler->IsEnabled())
+	{
+		profiler->SetCounter("Destroyed Entities", static_cast<double>(removed.size()));
+	}
+}
+
+void SceneStructure::AttachEntity(Entity *object)
+{
+	object->m_structure = this;
+	m_transformsSorted = false;
+
+	for (const auto &component : object->GetComponents())
+	{
+		OnComponentAdded(component.get());
+	}
+}
+
+void SceneStructure::DetachEntity(Entity *object)
+{
+	for (const auto &component : object->GetComponents())
+	{
+		OnComponentRemoved(component.get());
+	}
+
+	object->m_structure = nullptr;
+	m_transformsSorted = false;
+}
+
+void SceneStructure::SortTransforms()
+{
+	m_transformOrder.clear();
+	m_transformOrder.reserve(m_objects.size());
+
+	for (const auto &object : m_objects)
+	{
+		if (object->m_structure != this)
+		{
+			continue;
+		}
+
+		if (object->m_parent == nullptr || object->m_parent->m_structure != this)
+		{
+			m_transformOrder.emplace_back(object.get());
+		}
+	}
+
+	// Breadth first, children are appended after every entity of the depth above them.
+	for (std::size_t i = 0; i < m_transformOrder.size(); i++)
+	{
+		for (const auto &child : m_transformOrder[i]->m_children)
+		{
+			if (child->m_structure == this)
+			{
+				m_transformOrder.emplace_back(child);
+			}
+		}
+	}
+
+	m_transformsSorted = true;
+}
+
+void SceneStructure::UpdateParallel(std::pmr::vector<Component *> &components)
+{
+	components.erase(std::remove_if(components.begin(), components.end(), [this](Component *component)
+	{
+		return IsRemovedInUpdate(component);
+	}), components.end());
+
+	if (components.empty())
+	{
+		return;
+	}
+
+	// World transforms are brought up to date first, so parallel updates only read cached transforms.
+	UpdateTransforms();
+	m_deferring = true;
+	Engine::Get()->GetThreadPool().ParallelFor(0, components.size(), [&components](const std::size_t &i)
+	{
+		components[i]->m_updateDelta = Engine::Get()->GetDelta();
+		components[i]->Update();
+	}, PARALLEL_GRAIN_SIZE);
+	m_deferring = false;
+
+	// Commands are applied in the order they were deferred, changes made by a command are made immediately.
+	auto deferred = std::move(m_deferred);
+	m_deferred.clear();
+
+	for (auto &command : deferred)
+	{
+		command();
+	}
+
+	if (auto profiler = Profiler::Get(); profiler != nullptr && profiler->IsEnabled())
+	{
+		profiler->SetCounter("Parallel Updates", static_cast<double>(components.size()));
+		profiler->SetCounter("Deferred Commands", static_cast<double>(deferred.size()));
+	}
+}
+
+bool SceneStructure::Defer(std::function<void()> &&command)
+{
+	if (!m_deferring)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_deferredMutex);
+	m_deferred.emplace_back(std::move(command));
+	return true;
+}
+
+void SceneStructure::UpdateSliced(std::pmr::vector<Component *> &components)
+{
+	if (components.empty())
+	{
+		return;
+	}
+
+	auto camera = Engine::Get()->HasModule<Scenes>() ? Scenes::Get()->GetCamera() : nullptr;
+	std::pmr::vector<std::pair<float, Component *>> scheduled(FrameAllocator::Get());
+	scheduled.reserve(components.size());
+
+	for (const auto &component : components)
+	{
+		if (IsRemovedInUpdate(component))
+		{
+			continue;
+		}
+
+		// Components never updated wait since the first update, so new components are updated soon.
+		auto waited = static_cast<float>(m_updateFrame - component->m_updateFrame);
+		auto weight = component->m_updatePriority == Component::UpdatePriority::High ? 4.0f : 1.0f;
+		auto distance = 0.0f;
+
+		if (camera != nullptr)
+		{
+			distance = (camera->GetPosition() - component->GetParent()->GetWorldTransform().GetPosition()).Length();
+		}
+
+		scheduled.emplace_back(waited * weight / (1.0f + distance / SLICED_DISTANCE), component);
+	}
+
+	std::sort(scheduled.begin(), scheduled.end(), [](const std::pair<float, Component *> &a, const std::pair<float, Component *> &b)
+	{
+		return a.first > b.first;
+	});
+
+	auto start = Engine::GetTime();
+	uint32_t updated = 0;
+
+	for (const auto &[score, component] : scheduled)
+	{
+		auto now = Engine::GetTime();
+
+		if (updated > 0 && now - start > m_updateBudget)
+		{
+			break;
+		}
+
+		// A component removed by one updated before it is skipped.
+		if (IsRemovedInUpdate(component))
+		{
+			continue;
+		}
+
+		component->m_updateDelta = component->m_updateFrame == 0 ? Engine::Get()->GetDelta() : now - component->m_updateTime;
+		component->m_updateTime = now;
+		component->m_updateFrame = m_updateFrame;
+		component->Update();
+		updated++;
+	}
+
+	if (auto profiler = Profiler::Get(); profiler != nullptr && profiler->IsEnabled())
+	{
+		profiler->SetCounter("Sliced Components", static_cast<double>(scheduled.size()));
+		profiler->SetCounter("Sliced Updates", static_cast<double>(updated));
+	}
+}
+
+bool SceneStructure::IsRemovedInUpdate(Component *component) const
+{
+	return m_removedInUpdate.find(component) != m_removedInUpdate.end();
+}
+
+std::vector<Entity *> SceneStructure::GetEntities(const std::vector<CollisionObject *> &objects)
+{
+	std::vector<Entity *> entities;
+	entities.reserve(objects.size());
+	std::pmr::unordered_set<Entity *> added(FrameAllocator::Get());
+
+	for (const auto &object : objects)
+	{
+		auto entity = object->GetParent();
+
+		// The world may hold objects of entities in other structures, and a entity may own several objects.
+		if (!object->IsEnabled() || entity == nullptr || entity->m_structure != this || entity->IsRemoved() || !added.emplace(entity).second)
+		{
+			continue;
+		}
+
+		entities.emplace_back(entity);
+	}
+
 	return entities;
 }
 
-/*std::vector<Entity *> SceneStructure::QuerySphere(const Vector3 &centre, const Vector3 &radius)
+void SceneStructure::OnComponentAdded(Component *component)
 {
-	return std::vector<Entity *>();
-}*/
+	std::lock_guard<std::mutex> lock(m_queryMutex);
+
+	for (auto &[typeId, query] : m_queries)
+	{
+		if (query.m_indices.find(component) == query.m_indices.end() && query.m_matches(component))
+		{
+			query.m_indices[component] = query.m_components.size();
+			query.m_components.emplace_back(component);
+		}
+	}
+}
+
+void SceneStructure::OnComponentRemoved(Component *component)
+{
+	if (m_updating)
+	{
+		m_removedInUpdate.emplace(component);
+	}
+
+	std::lock_guard<std::mutex> lock(m_queryMutex);
+
+	for (auto &[typeId, query] : m_queries)
+	{
+		auto it = query.m_indices.find(component);
+
+		if (it == query.m_indices.end())
+		{
+			continue;
+		}
+
+		// Swaps the last component into the removed slot, so removal does not shift the query.
+		auto index = it->second;
+		query.m_indices.erase(it);
+
+		if (index != query.m_components.size() - 1)
+		{
+			query.m_components[index] = query.m_components.back();
+			query.m_indices[query.m_components[index]] = index;
+		}
+
+		query.m_components.pop_back();
+	}
+}
+
+bool SceneStructure::Contains(Entity *object) const
+{
+	return object != nullptr && object->m_structure == this;
+}
 
-/*std::vector<Entity *> SceneStructure::QueryCube(const Vector3 &min, const Vector3 &max)
+const Metadata &operator>>(const Metadata &metadata, SceneStructure &sceneStructure)
 {
-	return std::vector<Entity *>();
-}*/
+	sceneStructure.Clear();
 
-bool SceneStructure::Contains(Entity *object)
+	auto &componentRegister = Scenes::Get()->GetComponentRegister();
+	std::vector<std::pair<Entity *, int32_t>> parents;
+
+	for (const auto &entityMetadata : metadata.GetChildren())
+	{
+		Transform transform;
+		entityMetadata->GetChild("Transform", transform);
+		auto entity = new Entity(transform);
+
+		std::string name;
+		entityMetadata->GetChild("Name", name);
+		entity->SetName(name);
+
+		if (auto components = entityMetadata->FindChild("Components", false))
+		{
+			for (const auto &componentMetadata : components->GetChildren())
+			{
+				// Components whose type is no longer registered are dropped.
+				auto component = componentRegister.Create(componentMetadata->GetName());
+
+				if (component == nullptr)
+				{
+					continue;
+				}
+
+				componentRegister.Decode(componentMetadata->GetName(), *componentMetadata, component);
+				entity->AddComponent(component);
+			}
+		}
+
+		int32_t parent = -1;
+
+		if (auto parentMetadata = entityMetadata->FindChild("Parent", false))
+		{
+			*parentMetadata >> parent;
+		}
+
+		parents.emplace_back(entity, parent);
+		sceneStructure.Add(entity);
+	}
+
+	for (const auto &[entity, parent] : parents)
+	{
+		if (parent >= 0 && parent < static_cast<int32_t>(parents.size()))
+		{
+			entity->SetParent(parents[parent].first);
+		}
+	}
+
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const SceneStructure &sceneStructure)
 {
-	for (const auto &object2 : m_objects)
+	auto &componentRegister = Scenes::Get()->GetComponentRegister();
+
+	// Parents are written as the index of the parent in the list, removed entities are skipped.
+	std::unordered_map<const Entity *, int32_t> indices;
+
+	for (const auto &object : sceneStructure.m_objects)
+	{
+		if (!object->IsRemoved())
+		{
+			indices.emplace(object.get(), static_cast<int32_t>(indices.size()));
+		}
+	}
+
+	for (const auto &object : sceneStructure.m_objects)
 	{
-		if (object2.get() == object)
+		if (object->IsRemoved())
+		{
+			continue;
+		}
+
+		auto entityMetadata = metadata.CreateChild();
+		entityMetadata->SetChild("Name", object->GetName());
+		entityMetadata->SetChild("Transform", object->GetLocalTransform());
+
+		if (auto parent = indices.find(object->GetParent()); parent != indices.end())
+		{
+			entityMetadata->SetChild("Parent", parent->second);
+		}
+
+		auto components = entityMetadata->CreateChild("Components");
+
+		for (const auto &component : object->GetComponents())
 		{
-			return true;
+			auto componentName = componentRegister.FindName(component.get());
+
+			if (!componentName)
+			{
+				continue;
+			}
+
+			componentRegister.Encode(*componentName, *components->CreateChild(*componentName), component.get());
 		}
 	}
 
-	return false;
+	return metadata;
 }
 }
@@ -1,12 +1,18 @@
 ﻿#pragma once
 
+#include <unordered_set>
+#include "Engine/FrameAllocator.hpp"
+#include "Engine/MemoryTracker.hpp"
 #include "Physics/Rigidbody.hpp"
 #include "Entity.hpp"
 
 namespace acid
 {
+class EntityPrefab;
+
 /**
  * @brief Class that represents a  structure of spatial objects.
+ * Entities are stored packed and found through slots by their {@link EntityHandle}, removed entities are swapped out of the packed storage and their slots reused.
  */
 class ACID_EXPORT SceneStructure :
 	public NonCopyable
@@ -29,6 +35,21 @@ public:
 	 */
 	Entity *CreateEntity(const std::string &filename, const Transform &transform = Transform::Zero);
 
+	/**
+	 * Creates many entities from prefabs that start in this structure. Prefabs are loaded and components are decoded on the thread pool,
+	 * then every entity is added to this structure at once.
+	 * @param prefabs The files to load the component data from, with the objects initial world transforms.
+	 * @return The newly created entities, in the same order as the prefabs.
+	 */
+	std::vector<Entity *> CreateEntities(const std::vector<std::pair<std::string, Transform>> &prefabs);
+
+	/**
+	 * Gets a prefab that entities in this structure are created from, prefabs are kept loaded until the structure is cleared.
+	 * @param filename The file to load the component data from.
+	 * @return The prefab.
+	 */
+	std::shared_ptr<EntityPrefab> GetPrefab(const std::string &filename);
+
 	/**
 	 * Adds a new object to the spatial structure.
 	 * @param object The object to add.
@@ -42,11 +63,25 @@ public:
 	void Add(std::unique_ptr<Entity> object);
 
 	/**
-	 * Removes an object from the spatial structure.
+	 * Removes an object from the spatial structure. It is detached from queries at once, and destroyed with every other removed object at the start of the next update,
+	 * after the frame it was removed in has been drawn.
 	 * @param object The object to remove.
 	 */
 	void Remove(Entity *object);
 
+	/**
+	 * Removes an object from the spatial structure, see {@link SceneStructure#Remove}.
+	 * @param handle The handle of the object to remove, nothing is removed if the object was already destroyed.
+	 */
+	void Remove(const EntityHandle &handle);
+
+	/**
+	 * Gets an object from its handle.
+	 * @param handle The handle of the object.
+	 * @return The object, or nullptr if it has been removed or the handle is from another structure.
+	 */
+	Entity *Get(const EntityHandle &handle) const;
+
 	/**
 	 * Moves an object to another spatial structure.
 	 * @param object The object to move.
@@ -60,12 +95,26 @@ public:
 	void Clear();
 
 	/**
-	 * Updates all of the entity.
+	 * Updates all of the entities. Thread safe components that are always updated are then updated on the job system, see {@link Component#IsThreadSafe}.
+	 * Components that are not always updated are then updated within the update budget, those skipped this update are more likely to be updated next update.
 	 */
 	void Update();
 
 	/**
-	 * Gets the size of this structure.
+	 * Gets the time spent each update on components that are not always updated, at least one is updated each update.
+	 * @return The update budget.
+	 */
+	const Time &GetUpdateBudget() const { return m_updateBudget; }
+
+	void SetUpdateBudget(const Time &updateBudget) { m_updateBudget = updateBudget; }
+
+	/**
+	 * Updates the world transforms of changed entities in one pass over the entities ordered by depth, parents come before their children.
+	 */
+	void UpdateTransforms();
+
+	/**
+	 * Gets the size of this structure, removed objects are counted until they are destroyed.
 	 * @return The structures size.
 	 */
 	uint32_t GetSize() const { return static_cast<uint32_t>(m_objects.size()); }
@@ -78,14 +127,112 @@ public:
 
 	/**
 	 * Gets a set of all objects in a spatial objects contained in a frustum.
+	 * Spatial queries are answered by the bounds tree of the physics broadphase, so only objects with a collision object are found.
 	 * @param range The frustum range of space being queried.
 	 * @return The list of all object in range.
 	 */
 	std::vector<Entity *> QueryFrustum(const Frustum &range);
 
-	//std::vector<Entity *> QuerySphere(const Vector3 &centre, const Vector3 &radius);
+	/**
+	 * Gets a set of all objects whos bounds overlap a sphere.
+	 * @param centre The centre of the sphere.
+	 * @param radius The radius of the sphere.
+	 * @return The list of all object in range.
+	 */
+	std::vector<Entity *> QuerySphere(const Vector3f &centre, const float &radius);
+
+	/**
+	 * Gets a set of all objects whos bounds overlap a box.
+	 * @param min The minimum corner of the box.
+	 * @param max The maximum corner of the box.
+	 * @return The list of all object in range.
+	 */
+	std::vector<Entity *> QueryCube(const Vector3f &min, const Vector3f &max);
 
-	//std::vector<Entity *> QueryCube(const Vector3 &min, const Vector3 &max);
+	/**
+	 * Gets the objects whos bounds are nearest to a position.
+	 * @param position The position.
+	 * @param count The most objects returned.
+	 * @param maxDistance The furthest distance from the position searched.
+	 * @return The list of objects, ordered from nearest to furthest.
+	 */
+	std::vector<Entity *> QueryNearest(const Vector3f &position, const uint32_t &count, const float &maxDistance = std::numeric_limits<float>::max());
+
+	/**
+	 * A view over the components of a type in the spatial structure, iterating it does not allocate.
+	 * @tparam T The components type.
+	 */
+	template<typename T>
+	class ComponentView
+	{
+	public:
+		class Iterator
+		{
+		public:
+			Iterator(std::vector<Component *>::const_iterator it, std::vector<Component *>::const_iterator end, const bool &allowDisabled) :
+				m_it(it),
+				m_end(end),
+				m_allowDisabled(allowDisabled)
+			{
+				SkipDisabled();
+			}
+
+			T *operator*() const { return static_cast<T *>(*m_it); }
+
+			Iterator &operator++()
+			{
+				++m_it;
+				SkipDisabled();
+				return *this;
+			}
+
+			bool operator!=(const Iterator &other) const { return m_it != other.m_it; }
+
+		private:
+			void SkipDisabled()
+			{
+				while (!m_allowDisabled && m_it != m_end && !(*m_it)->IsEnabled())
+				{
+					++m_it;
+				}
+			}
+
+			std::vector<Component *>::const_iterator m_it;
+			std::vector<Component *>::const_iterator m_end;
+			bool m_allowDisabled;
+		};
+
+		ComponentView(const std::vector<Component *> &components, const bool &allowDisabled) :
+			m_components(components),
+			m_allowDisabled(allowDisabled)
+		{
+		}
+
+		Iterator begin() const { return Iterator(m_components.begin(), m_components.end(), m_allowDisabled); }
+
+		Iterator end() const { return Iterator(m_components.end(), m_components.end(), m_allowDisabled); }
+
+	private:
+		const std::vector<Component *> &m_components;
+		bool m_allowDisabled;
+	};
+
+	/**
+	 * Gets a view of all components of a type in the spatial structure. The query is cached the first time a type is requested,
+	 * and kept up to date as components are added to or removed from entities in this structure.
+	 * @tparam T The components type to get.
+	 * @param allowDisabled If disabled components will be included in this query.
+	 * @return The view of all components that match the type.
+	 */
+	template<typename T>
+	ComponentView<T> ViewComponents(const bool &allowDisabled = false)
+	{
+		auto &query = GetQuery(GetComponentTypeId<T>(), [](Component *component)
+		{
+			return dynamic_cast<T *>(component) != nullptr;
+		});
+		return ComponentView<T>(query.m_components, allowDisabled);
+	}
 
 	/**
 	 * Returns a set of all components of a type in the spatial structure.
@@ -98,15 +245,29 @@ public:
 	{
 		std::vector<T *> components;
 
-		for (auto it = m_objects.begin(); it != m_objects.end(); ++it)
+		for (const auto &component : ViewComponents<T>(allowDisabled))
 		{
-			for (const auto &component : (*it)->GetComponents<T>())
-			{
-				if (component != nullptr && (component->IsEnabled() || allowDisabled))
-				{
-					components.emplace_back(component);
-				}
-			}
+			components.emplace_back(component);
+		}
+
+		return components;
+	}
+
+	/**
+	 * Returns a set of all components of a type in the spatial structure, allocated from a memory resource such as the {@link FrameAllocator}.
+	 * @tparam T The components type to get.
+	 * @param resource The memory resource the list is allocated from.
+	 * @param allowDisabled If disabled components will be included in this query.
+	 * @return The list specified by of all components that match the type.
+	 */
+	template<typename T>
+	std::pmr::vector<T *> QueryComponents(std::pmr::memory_resource *resource, const bool &allowDisabled = false)
+	{
+		std::pmr::vector<T *> components(resource);
+
+		for (const auto &component : ViewComponents<T>(allowDisabled))
+		{
+			components.emplace_back(component);
 		}
 
 		return components;
@@ -121,27 +282,135 @@ public:
 	template<typename T>
 	T *GetComponent(const bool &allowDisabled = false)
 	{
-		for (auto it = m_objects.begin(); it != m_objects.end(); ++it)
+		for (const auto &component : ViewComponents<T>(allowDisabled))
 		{
-			auto component = (*it)->GetComponent<T>();
-
-			if (component != nullptr && (component->IsEnabled() || allowDisabled))
-			{
-				return component;
-			}
+			return component;
 		}
 
 		return nullptr;
 	}
 
 	/**
-	 * If the structure contains the object.
+	 * If the structure contains the object, objects that may have been destroyed should be checked by handle.
 	 * @param object The object to check for.
 	 * @return If the structure contains the object.
 	 */
-	bool Contains(Entity *object);
+	bool Contains(Entity *object) const;
+
+	/**
+	 * If the structure contains the object of a handle.
+	 * @param handle The handle of the object to check for.
+	 * @return If the structure contains the object.
+	 */
+	bool Contains(const EntityHandle &handle) const { return Get(handle) != nullptr; }
+
+	/**
+	 * Replaces the entities of this structure with decoded entities, components are created through the component register of {@link Scenes}.
+	 */
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, SceneStructure &sceneStructure);
+
+	/**
+	 * Encodes the entities of this structure with their names, local transforms, parents, and every component known to the component register.
+	 */
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const SceneStructure &sceneStructure);
 
 private:
-	std::vector<std::unique_ptr<Entity>> m_objects;
+	friend class Entity;
+
+	/**
+	 * @brief Where the object of a handle is in the packed objects, the generation is incremented each time the slot is freed.
+	 */
+	class Slot
+	{
+	public:
+		uint32_t m_generation = 1;
+		uint32_t m_object = 0;
+	};
+
+	class Query
+	{
+	public:
+		std::function<bool(Component *)> m_matches;
+		std::vector<Component *> m_components;
+		std::unordered_map<Component *, std::size_t> m_indices;
+	};
+
+	Query &GetQuery(const TypeId &typeId, const std::function<bool(Component *)> &matches);
+
+	/**
+	 * Gives an object a slot and adds it to the packed objects.
+	 * @param object The object.
+	 */
+	void InsertObject(std::unique_ptr<Entity> object);
+
+	/**
+	 * Swaps an object out of the packed objects and frees its slot, it should already be detached.
+	 * @param object The object.
+	 * @return The extracted object.
+	 */
+	std::unique_ptr<Entity> ExtractObject(Entity *object);
+
+	/**
+	 * Destroys every object removed since the last update.
+	 */
+	void DestroyRemoved();
+
+	void AttachEntity(Entity *object);
+
+	void DetachEntity(Entity *object);
+
+	void OnComponentAdded(Component *component);
+
+	void OnComponentRemoved(Component *component);
+
+	void SortTransforms();
+
+	/**
+	 * Updates thread safe components on the job system, then applies the structural changes they deferred.
+	 * @param components The thread safe components that are always updated.
+	 */
+	void UpdateParallel(std::pmr::vector<Component *> &components);
+
+	/**
+	 * Defers a structural change while components are updated in parallel.
+	 * @param command The change, run once every parallel update has finished.
+	 * @return If the change was deferred, otherwise it should be made now.
+	 */
+	bool Defer(std::function<void()> &&command);
+
+	/**
+	 * Updates components in order of how long they waited, their priority, and their distance from the camera, until the update budget is spent.
+	 * @param components The components that are not always updated.
+	 */
+	void UpdateSliced(std::pmr::vector<Component *> &components);
+
+	/**
+	 * Gets if a component was removed from this structure since the update started, so a list built during the update may hold it.
+	 * @param component The component.
+	 * @return If the component was removed.
+	 */
+	bool IsRemovedInUpdate(Component *component) const;
+
+	std::vector<Entity *> GetEntities(const std::vector<CollisionObject *> &objects);
+
+	TrackedVector<std::unique_ptr<Entity>, MemoryTag::Scenes> m_objects;
+	TrackedVector<Slot, MemoryTag::Scenes> m_slots;
+	TrackedVector<uint32_t, MemoryTag::Scenes> m_freeSlots;
+	// Removed objects waiting to be destroyed, they stay in their slots until then.
+	TrackedVector<EntityHandle, MemoryTag::Scenes> m_removed;
+	// The entities ordered by depth in the hierarchy, rebuilt when the hierarchy changes.
+	TrackedVector<Entity *, MemoryTag::Scenes> m_transformOrder;
+	bool m_transformsSorted;
+	TrackedUnorderedMap<TypeId, Query, MemoryTag::Scenes> m_queries;
+	std::mutex m_queryMutex;
+	TrackedUnorderedMap<std::string, std::shared_ptr<EntityPrefab>, MemoryTag::Scenes> m_prefabs;
+	std::mutex m_prefabMutex;
+	Time m_updateBudget;
+	uint64_t m_updateFrame;
+	bool m_updating;
+	std::unordered_set<Component *> m_removedInUpdate;
+	bool m_deferring;
+	std::vector<std::function<void()>> m_deferred;
+	std::mutex m_deferredMutex;
 };
 }
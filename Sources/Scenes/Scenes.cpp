@@ -1,10 +1,21 @@
 #include "Scenes.hpp"
 
+#if !defined(ACID_BUILD_SERVER)
+#include "Gizmos/Gizmos.hpp"
+#include "Particles/Particles.hpp"
+#endif
+#include "Physics/Rigidbody.hpp"
+
 namespace acid
 {
 Scenes::Scenes() :
 	m_scene(nullptr)
 {
+#if !defined(ACID_BUILD_SERVER)
+	// Scene components such as emitters spawn particles and gizmos.
+	Writes<Particles>();
+	Writes<Gizmos>();
+#endif
 }
 
 void Scenes::Update()
@@ -14,6 +25,9 @@ void Scenes::Update()
 		return;
 	}
 
+	// Finishes the step dispatched last frame before components read or write bodies.
+	m_scene->GetPhysics()->Wait();
+
 	if (!m_scene->m_started)
 	{
 		m_scene->Start();
@@ -23,14 +37,46 @@ void Scenes::Update()
 	m_scene->Update();
 	m_scene->GetPhysics()->Update();
 
+	if (m_scene->GetStreamer() != nullptr && m_scene->GetStructure() != nullptr && m_scene->GetCamera() != nullptr)
+	{
+		m_scene->GetStreamer()->Update(*m_scene->GetStructure(), m_scene->GetCamera()->GetPosition());
+	}
+
 	if (m_scene->GetStructure() != nullptr)
 	{
 		m_scene->GetStructure()->Update();
+		m_scene->GetStructure()->UpdateTransforms();
 	}
 
 	if (m_scene->GetCamera() != nullptr)
 	{
 		m_scene->GetCamera()->Update();
 	}
+
+	// A multithreaded world steps while the frame is rendered, entities see its results one frame later.
+	m_scene->GetPhysics()->Dispatch();
+}
+
+void Scenes::Interpolate(const float &alpha)
+{
+	if (m_scene == nullptr || !m_scene->m_started || m_scene->GetStructure() == nullptr)
+	{
+		return;
+	}
+
+	for (auto rigidbody : m_scene->GetStructure()->ViewComponents<Rigidbody>())
+	{
+		rigidbody->Interpolate(alpha);
+	}
+
+	m_scene->GetStructure()->UpdateTransforms();
+
+#if !defined(ACID_BUILD_SERVER)
+	// Lights are selected from the interpolated transforms, the same transforms the frame is rendered with.
+	if (m_scene->GetCamera() != nullptr)
+	{
+		m_scene->m_lightSelection.Update(*m_scene->GetCamera(), *m_scene->GetStructure());
+	}
+#endif
 }
 }
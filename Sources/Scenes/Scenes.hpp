@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Engine/Engine.hpp"
+#if !defined(ACID_BUILD_SERVER)
 #include "Models/ModelRegister.hpp"
+#endif
 #include "Scene.hpp"
 #include "ComponentRegister.hpp"
 #include "SceneStructure.hpp"
@@ -25,6 +27,12 @@ public:
 
 	void Update() override;
 
+	/**
+	 * Moves interpolated rigidbodies between their last two updates, called by the engine before rendering.
+	 * @param alpha How far rendering is between the last and next update, from zero to one.
+	 */
+	void Interpolate(const float &alpha);
+
 	/**
 	 * Gets the current scene.
 	 * @return The current scene.
@@ -43,11 +51,13 @@ public:
 	 */
 	ComponentRegister &GetComponentRegister() { return m_componentRegister; }
 
+#if !defined(ACID_BUILD_SERVER)
 	/**
 	 * Gets the model register used by the engine. The register can be used to register/deregister model types.
 	 * @return The model register.
 	 */
 	ModelRegister &GetModelRegister() { return m_modelRegister; }
+#endif
 
 	/**
 	 * Gets the current camera object.
@@ -77,6 +87,8 @@ private:
 	std::unique_ptr<Scene> m_scene;
 
 	ComponentRegister m_componentRegister;
+#if !defined(ACID_BUILD_SERVER)
 	ModelRegister m_modelRegister;
+#endif
 };
 }
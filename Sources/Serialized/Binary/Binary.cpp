@@ -0,0 +1,393 @@
+#include "Binary.hpp"
+
+#include <cerrno>
+#include "Engine/Log.hpp"
+
+namespace acid
+{
+static const char MAGIC[4] = { 'A', 'C', 'M', 'B' };
+static const uint8_t VERSION = 1;
+
+namespace
+{
+class Writer
+{
+public:
+	void WriteVarint(uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			m_nodes.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+
+		m_nodes.push_back(static_cast<char>(value));
+	}
+
+	void WriteString(const std::string &string)
+	{
+		auto it = m_indices.find(string);
+
+		if (it == m_indices.end())
+		{
+			it = m_indices.emplace(string, static_cast<uint32_t>(m_strings.size())).first;
+			m_strings.emplace_back(&it->first);
+		}
+
+		WriteVarint(it->second);
+	}
+
+	void WriteValue(const std::string &value)
+	{
+		if (value.empty())
+		{
+			m_nodes.push_back(static_cast<char>(Binary::Type::Empty));
+			return;
+		}
+
+		if (value == "true" || value == "false")
+		{
+			m_nodes.push_back(static_cast<char>(value == "true" ? Binary::Type::True : Binary::Type::False));
+			return;
+		}
+
+		if (value.size() >= 2 && value.front() == '\"' && value.back() == '\"')
+		{
+			m_nodes.push_back(static_cast<char>(Binary::Type::String));
+			WriteString(value.substr(1, value.size() - 2));
+			return;
+		}
+
+		// Numbers are only stored typed when they are written back with exactly the same text.
+		char *end = nullptr;
+		errno = 0;
+		auto integer = std::strtoll(value.c_str(), &end, 10);
+
+		if (errno == 0 && *end == '\0' && std::to_string(integer) == value)
+		{
+			m_nodes.push_back(static_cast<char>(Binary::Type::Integer));
+			WriteVarint((static_cast<uint64_t>(integer) << 1) ^ static_cast<uint64_t>(integer >> 63));
+			return;
+		}
+
+		auto real = std::strtof(value.c_str(), &end);
+
+		if (*end == '\0' && String::To(real) == value)
+		{
+			m_nodes.push_back(static_cast<char>(Binary::Type::Float));
+			m_nodes.append(reinterpret_cast<const char *>(&real), sizeof(float));
+			return;
+		}
+
+		m_nodes.push_back(static_cast<char>(Binary::Type::Text));
+		WriteString(value);
+	}
+
+	void WriteNode(const Metadata *node)
+	{
+		WriteString(node->GetName());
+		WriteValue(node->GetValue());
+		WriteVarint(node->GetAttributes().size());
+
+		for (const auto &[attribute, value] : node->GetAttributes())
+		{
+			WriteString(attribute);
+			WriteString(value);
+		}
+
+		WriteVarint(node->GetChildren().size());
+
+		for (const auto &child : node->GetChildren())
+		{
+			WriteNode(child.get());
+		}
+	}
+
+	void Write(MetadataWriter &writer)
+	{
+		std::string header(MAGIC, sizeof(MAGIC));
+		header.push_back(static_cast<char>(VERSION));
+
+		// The table is written before the nodes, so the node buffer is swapped out while it is encoded.
+		std::string nodes;
+		std::swap(nodes, m_nodes);
+		WriteVarint(m_strings.size());
+
+		for (const auto &string : m_strings)
+		{
+			WriteVarint(string->size());
+			m_nodes.append(*string);
+		}
+
+		writer << header << m_nodes << nodes;
+	}
+
+private:
+	std::string m_nodes;
+	std::unordered_map<std::string, uint32_t> m_indices;
+	std::vector<const std::string *> m_strings;
+};
+
+class Reader
+{
+public:
+	explicit Reader(const std::string_view &data) :
+		m_data(data)
+	{
+	}
+
+	bool ReadVarint(uint64_t &value)
+	{
+		value = 0;
+
+		for (uint32_t shift = 0; shift < 64; shift += 7)
+		{
+			if (m_position >= m_data.size())
+			{
+				return false;
+			}
+
+			auto byte = static_cast<uint8_t>(m_data[m_position++]);
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool ReadTable()
+	{
+		uint64_t count;
+
+		if (!ReadVarint(count) || count > m_data.size() - m_position)
+		{
+			return false;
+		}
+
+		m_strings.reserve(static_cast<std::size_t>(count));
+
+		for (uint64_t i = 0; i < count; i++)
+		{
+			uint64_t size;
+
+			if (!ReadVarint(size) || size > m_data.size() - m_position)
+			{
+				return false;
+			}
+
+			m_strings.emplace_back(m_data.substr(m_position, static_cast<std::size_t>(size)));
+			m_position += static_cast<std::size_t>(size);
+		}
+
+		return true;
+	}
+
+	bool ReadString(std::string &string)
+	{
+		uint64_t index;
+
+		if (!ReadVarint(index) || index >= m_strings.size())
+		{
+			return false;
+		}
+
+		string = m_strings[static_cast<std::size_t>(index)];
+		return true;
+	}
+
+	bool ReadValue(std::string &value, Metadata::Value &typedValue)
+	{
+		typedValue = {};
+
+		if (m_position >= m_data.size())
+		{
+			return false;
+		}
+
+		switch (static_cast<Binary::Type>(m_data[m_position++]))
+		{
+		case Binary::Type::Empty:
+			value.clear();
+			return true;
+		case Binary::Type::String:
+			if (!ReadString(value))
+			{
+				return false;
+			}
+
+			value = "\"" + value + "\"";
+			return true;
+		case Binary::Type::Text:
+			return ReadString(value);
+		case Binary::Type::Integer:
+		{
+			uint64_t encoded;
+
+			if (!ReadVarint(encoded))
+			{
+				return false;
+			}
+
+			auto integer = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+			value = std::to_string(integer);
+			typedValue = integer;
+			return true;
+		}
+		case Binary::Type::Float:
+		{
+			if (m_data.size() - m_position < sizeof(float))
+			{
+				return false;
+			}
+
+			float real;
+			std::memcpy(&real, m_data.data() + m_position, sizeof(float));
+			m_position += sizeof(float);
+			value = String::To(real);
+			// The typed value is what the text parses to, not the stored float widened.
+			typedValue = String::From<double>(value);
+			return true;
+		}
+		case Binary::Type::True:
+			value = "true";
+			typedValue = true;
+			return true;
+		case Binary::Type::False:
+			value = "false";
+			typedValue = false;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool ReadNode(Metadata *node)
+	{
+		std::string name;
+		std::string value;
+		Metadata::Value typedValue;
+
+		if (!ReadString(name) || !ReadValue(value, typedValue))
+		{
+			return false;
+		}
+
+		node->SetName(name);
+		node->SetValue(value, typedValue);
+
+		uint64_t attributeCount;
+
+		if (!ReadVarint(attributeCount))
+		{
+			return false;
+		}
+
+		for (uint64_t i = 0; i < attributeCount; i++)
+		{
+			std::string attribute;
+
+			if (!ReadString(attribute) || !ReadString(value))
+			{
+				return false;
+			}
+
+			node->AddAttribute(attribute, value);
+		}
+
+		uint64_t childCount;
+
+		if (!ReadVarint(childCount) || childCount > m_data.size() - m_position)
+		{
+			return false;
+		}
+
+		for (uint64_t i = 0; i < childCount; i++)
+		{
+			if (!ReadNode(node->CreateChild()))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	const std::size_t &GetPosition() const { return m_position; }
+
+	void Skip(const std::size_t &count) { m_position += count; }
+
+private:
+	std::string_view m_data;
+	std::size_t m_position = 0;
+	std::vector<std::string_view> m_strings;
+};
+}
+
+Binary::Binary() :
+	Metadata("", "")
+{
+}
+
+Binary::Binary(Metadata *metadata) :
+	Metadata("", "")
+{
+	AddChildren(metadata, this);
+}
+
+void Binary::Load(std::istream *inStream)
+{
+	std::ostringstream buffer;
+	buffer << inStream->rdbuf();
+	Load(std::string_view(buffer.str()));
+}
+
+void Binary::Load(const std::string_view &string)
+{
+	ClearChildren();
+	ClearAttributes();
+	SetArena(std::make_shared<MetadataArena>());
+
+	if (string.size() < sizeof(MAGIC) + 1 || string.compare(0, sizeof(MAGIC), std::string_view(MAGIC, sizeof(MAGIC))) != 0 ||
+		static_cast<uint8_t>(string[sizeof(MAGIC)]) != VERSION)
+	{
+		Log::Error("Binary metadata has an invalid header\n");
+		return;
+	}
+
+	Reader reader(string);
+	reader.Skip(sizeof(MAGIC) + 1);
+
+	if (!reader.ReadTable() || !reader.ReadNode(this))
+	{
+		Log::Error("Binary metadata is truncated or corrupt at byte %i\n", static_cast<int32_t>(reader.GetPosition()));
+		ClearChildren();
+		ClearAttributes();
+	}
+}
+
+void Binary::Write(MetadataWriter &writer) const
+{
+	// The string table is only known once every node is encoded, so the nodes are built in memory first.
+	Writer nodeWriter;
+	nodeWriter.WriteNode(this);
+	nodeWriter.Write(writer);
+}
+
+void Binary::AddChildren(const Metadata *source, Metadata *destination)
+{
+	for (const auto &child : source->GetChildren())
+	{
+		auto created = destination->AddChild(new Metadata(child->GetName(), child->GetValue()));
+		AddChildren(child.get(), created);
+	}
+
+	for (const auto &attribute : source->GetAttributes())
+	{
+		destination->AddAttribute(attribute.first, attribute.second);
+	}
+}
+}
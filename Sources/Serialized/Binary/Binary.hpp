@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Serialized/Metadata.hpp"
+
+namespace acid
+{
+/**
+ * @brief A compact binary format for metadata, names and strings are interned into a table and numbers are stored as typed values.
+ * Values that would not be written back with the same text are kept as strings, so text and binary files round trip to the same metadata.
+ */
+class ACID_EXPORT Binary :
+	public Metadata
+{
+public:
+	enum class Type : uint8_t
+	{
+		Empty = 0, String = 1, Text = 2, Integer = 3, Float = 4, True = 5, False = 6
+	};
+
+	Binary();
+
+	explicit Binary(Metadata *metadata);
+
+	void Load(std::istream *inStream) override;
+
+	void Load(const std::string_view &string) override;
+
+	using Metadata::Write;
+
+	void Write(MetadataWriter &writer) const override;
+
+protected:
+	Metadata *CreateEmpty() const override { return new Binary(); }
+
+private:
+	static void AddChildren(const Metadata *source, Metadata *destination);
+};
+}
@@ -1,6 +1,6 @@
 #include "Json.hpp"
 
-#include "Files/Files.hpp"
+#include "Engine/Log.hpp"
 #include "Helpers/String.hpp"
 
 namespace acid
@@ -17,156 +17,221 @@ Json::Json(Metadata *metadata) :
 }
 
 void Json::Load(std::istream *inStream)
+{
+	std::ostringstream buffer;
+	buffer << inStream->rdbuf();
+	Load(std::string_view(buffer.str()));
+}
+
+void Json::Load(const std::string_view &string)
 {
 	ClearChildren();
 	ClearAttributes();
+	SetArena(std::make_shared<MetadataArena>());
 
-	auto topSection = std::make_unique<Section>(nullptr, "", "");
-	Section *currentSection = nullptr;
-	std::stringstream summation;
+	auto current = string.data();
+	auto end = string.data() + string.size();
 
-	size_t lineNum = 0;
-	std::string linebuf;
+	auto skipWhitespace = [&]()
+	{
+		while (current != end && (*current == ' ' || *current == '\n' || *current == '\r' || *current == '\t'))
+		{
+			current++;
+		}
+	};
 
-	while (inStream->peek() != -1)
+	auto error = [&](const char *message)
 	{
-		Files::SafeGetLine(*inStream, linebuf);
-		lineNum++;
+		auto line = std::count(string.data(), current, '\n') + 1;
+		Log::Error("Json %s on line %i\n", message, static_cast<int32_t>(line));
+	};
 
-		for (const char &c : linebuf)
+	// Strings are kept with their quotes and escapes, the same as they are written. Quotes are found with memchr, skipping the ones that are escaped.
+	auto scanString = [&]() -> std::optional<std::string_view>
+	{
+		auto first = current++;
+
+		for (;;)
 		{
-			if (c == '{' || c == '[')
+			auto quote = static_cast<const char *>(std::memchr(current, '"', static_cast<std::size_t>(end - current)));
+
+			if (quote == nullptr)
 			{
-				if (currentSection == nullptr)
-				{
-					currentSection = topSection.get();
-					continue;
-				}
-
-				std::string name;
-
-				if (!summation.str().empty())
-				{
-					auto contentSplit = String::Split(summation.str(), "\"");
-
-					if (static_cast<int32_t>(contentSplit.size()) - 2 >= 0)
-					{
-						name = contentSplit.at(contentSplit.size() - 2);
-					}
-				}
-
-				currentSection->m_content += summation.str();
-				summation.str(std::string());
-
-				auto section = new Section(currentSection, name, "");
-				currentSection->m_children.emplace_back(section);
-				currentSection = section;
+				current = end;
+				return std::nullopt;
 			}
-			else if (c == '}' || c == ']')
-			{
-				currentSection->m_content += summation.str();
-				summation.str(std::string());
 
-				if (currentSection->m_parent != nullptr)
-				{
-					currentSection = currentSection->m_parent;
-				}
-			}
-			else if (c == '\n')
+			auto escape = quote;
+
+			while (escape != first + 1 && *(escape - 1) == '\\')
 			{
+				escape--;
 			}
-			else
+
+			current = quote + 1;
+
+			if ((quote - escape) % 2 == 0)
 			{
-				summation << c;
+				return std::string_view(first, static_cast<std::size_t>(current - first));
 			}
 		}
-	}
+	};
 
-	Convert(topSection.get(), this, true);
-}
+	auto scanPrimitive = [&]()
+	{
+		auto first = current;
 
-void Json::Write(std::ostream *outStream) const
-{
-	AppendData(this, outStream, 0);
-}
+		while (current != end && *current != ',' && *current != '}' && *current != ']' && *current != ' ' && *current != '\n' && *current != '\r' && *current != '\t')
+		{
+			current++;
+		}
 
-void Json::AddChildren(const Metadata *source, Metadata *destination)
-{
-	for (const auto &child : source->GetChildren())
+		return std::string_view(first, static_cast<std::size_t>(current - first));
+	};
+
+	skipWhitespace();
+
+	if (current == end)
 	{
-		auto created = destination->AddChild(new Metadata(child->GetName(), child->GetValue()));
-		AddChildren(child.get(), created);
+		return;
 	}
 
-	for (const auto &attribute : source->GetAttributes())
+	if (*current != '{' && *current != '[')
 	{
-		destination->AddAttribute(attribute.first, attribute.second);
+		error("document does not start with a object or array");
+		return;
 	}
-}
 
-void Json::Convert(const Section *source, Metadata *parent, const bool &isTopSection)
-{
-	auto thisValue = parent;
+	// Open objects and arrays are kept on a stack instead of recursing, so deeply nested documents can not overflow the call stack.
+	std::vector<std::pair<Metadata *, bool>> stack;
+	stack.emplace_back(this, *current == '[');
+	current++;
 
-	if (!isTopSection)
+	while (!stack.empty())
 	{
-		thisValue = new Metadata(source->m_name, "");
-		parent->AddChild(thisValue);
-	}
+		skipWhitespace();
 
-	auto contentSplit = String::Split(source->m_content, ",", true);
+		if (current == end)
+		{
+			error("document ends before closing every object and array");
+			return;
+		}
 
-	for (const auto &data : contentSplit)
-	{
-		std::string name;
-		std::string value = data;
+		if (*current == '}' || *current == ']')
+		{
+			stack.pop_back();
+			current++;
+			continue;
+		}
 
-		if (String::Contains(data, ":"))
+		if (*current == ',')
 		{
-			name = String::Trim(data.substr(0, data.find(':')));
-			value = String::Trim(String::ReplaceFirst(value, name, ""));
-			value = String::Trim(value.erase(0, 1));
-			name = name.substr(1, name.size() - 2);
+			current++;
+			continue;
 		}
 
-		if (value.empty())
+		auto [parent, isArray] = stack.back();
+		std::string_view name;
+
+		if (!isArray)
+		{
+			if (*current != '"')
+			{
+				error("object key is not a string");
+				return;
+			}
+
+			auto key = scanString();
+			skipWhitespace();
+
+			if (!key || current == end || *current != ':')
+			{
+				error("object key is not followed by a value");
+				return;
+			}
+
+			name = key->substr(1, key->size() - 2);
+			current++;
+			skipWhitespace();
+
+			if (current == end)
+			{
+				error("object key is not followed by a value");
+				return;
+			}
+		}
+
+		if (*current == '{' || *current == '[')
 		{
+			auto child = parent->CreateChild(std::string(name));
+			stack.emplace_back(child, *current == '[');
+			current++;
 			continue;
 		}
 
-		if (String::StartsWith(name, "_"))
+		std::string_view value;
+
+		if (*current == '"')
 		{
-			name = name.erase(0, 1);
+			auto scanned = scanString();
 
-			if (!value.empty())
+			if (!scanned)
 			{
-				value = value.substr(1, value.size() - 2);
+				error("string is not terminated");
+				return;
 			}
 
-			thisValue->AddAttribute(name, value);
+			value = *scanned;
 		}
 		else
 		{
-			auto newChild = new Metadata(name, value);
-			thisValue->AddChild(newChild);
+			value = scanPrimitive();
 		}
-	}
 
-	for (const auto &child : source->m_children)
-	{
-		Convert(child.get(), thisValue, false);
+		if (value.empty())
+		{
+			error("value is missing");
+			return;
+		}
+
+		// Keys starting with a underscore are attributes, their values are stored without quotes.
+		if (!name.empty() && name.front() == '_')
+		{
+			if (value.size() >= 2 && value.front() == '"')
+			{
+				value = value.substr(1, value.size() - 2);
+			}
+
+			parent->AddAttribute(std::string(name.substr(1)), std::string(value));
+			continue;
+		}
+
+		auto child = parent->CreateChild(std::string(name));
+		child->SetValue(std::string(value), value.front() == '"' ? Value() : ParseValue(value));
 	}
 }
 
-void Json::AppendData(const Metadata *source, std::ostream *outStream, const int32_t &indentation, const bool &end)
+void Json::Write(MetadataWriter &writer) const
 {
-	std::stringstream indents;
+	AppendData(this, writer, 0);
+}
+
+void Json::AddChildren(const Metadata *source, Metadata *destination)
+{
+	for (const auto &child : source->GetChildren())
+	{
+		auto created = destination->AddChild(new Metadata(child->GetName(), child->GetValue()));
+		AddChildren(child.get(), created);
+	}
 
-	for (int32_t i = 0; i < indentation; i++)
+	for (const auto &attribute : source->GetAttributes())
 	{
-		indents << "  ";
+		destination->AddAttribute(attribute.first, attribute.second);
 	}
+}
 
+void Json::AppendData(const Metadata *source, MetadataWriter &writer, const int32_t &indentation, const bool &end)
+{
 	char openBrace = '{';
 	char closeBrace = '}';
 
@@ -180,63 +245,62 @@ void Json::AppendData(const Metadata *source, std::ostream *outStream, const int
 		}
 	}
 
-	*outStream << indents.str();
+	writer.WriteIndent(indentation);
 
 	if (source->GetName().empty() && source->GetValue().empty())
 	{
-		*outStream << openBrace << '\n';
+		writer << openBrace << '\n';
 	}
 	else if (source->GetValue().empty())
 	{
-		*outStream << "\"" << source->GetName() << "\": " << openBrace << '\n';
+		writer << '"' << source->GetName() << "\": " << openBrace << '\n';
 	}
 	else
 	{
-		if (source->GetName().empty())
+		if (!source->GetName().empty())
 		{
-			*outStream << String::FixReturnTokens(source->GetValue());
-		}
-		else
-		{
-			*outStream << "\"" << source->GetName() << "\": " << String::FixReturnTokens(source->GetValue());
+			writer << '"' << source->GetName() << "\": ";
 		}
 
+		writer.WriteEscaped(source->GetValue());
+
 		if (!(end && source->GetAttributes().empty()))
 		{
-			*outStream << ", ";
+			writer << ", ";
 		}
 
-		*outStream << '\n';
+		writer << '\n';
 	}
 
 	for (const auto &attribute : source->GetAttributes())
 	{
-		*outStream << indents.str() << "  \"_" << attribute.first + "\": \"" << attribute.second << "\"";
+		writer.WriteIndent(indentation);
+		writer << "  \"_" << attribute.first << "\": \"" << attribute.second << '"';
 
 		if (!(end && source->GetChildren().empty()))
 		{
-			*outStream << ", ";
+			writer << ", ";
 		}
 
-		*outStream << '\n';
+		writer << '\n';
 	}
 
 	for (const auto &child : source->GetChildren())
 	{
-		AppendData(child.get(), outStream, indentation + 1, child == source->GetChildren().back());
+		AppendData(child.get(), writer, indentation + 1, child == source->GetChildren().back());
 	}
 
 	if (source->GetValue().empty())
 	{
-		*outStream << indents.str();
+		writer.WriteIndent(indentation);
 
 		if (end || indentation == 0)
 		{
-			*outStream << closeBrace << '\n';
+			writer << closeBrace << '\n';
 		}
 		else
 		{
-			*outStream << closeBrace << ",\n";
+			writer << closeBrace << ",\n";
 		}
 	}
 }
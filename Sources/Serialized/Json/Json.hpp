@@ -9,37 +9,28 @@ class ACID_EXPORT Json :
 	public Metadata
 {
 public:
-	class Section :
-		public NonCopyable
-	{
-	public:
-		Section *m_parent;
-		std::vector<std::unique_ptr<Section>> m_children;
-
-		std::string m_name;
-		std::string m_content;
-
-		Section(Section *parent, std::string name, std::string content) :
-			m_parent(parent),
-			m_name(std::move(name)),
-			m_content(std::move(content))
-		{
-		}
-	};
-
 	Json();
 
 	explicit Json(Metadata *metadata);
 
 	void Load(std::istream *inStream) override;
 
-	void Write(std::ostream *outStream) const override;
+	/**
+	 * Parses a document in a single pass over the buffer, nodes are created as their values are read.
+	 * @param string The document to parse.
+	 */
+	void Load(const std::string_view &string) override;
+
+	using Metadata::Write;
+
+	void Write(MetadataWriter &writer) const override;
+
+protected:
+	Metadata *CreateEmpty() const override { return new Json(); }
 
 private:
 	static void AddChildren(const Metadata *source, Metadata *destination);
 
-	static void Convert(const Section *source, Metadata *parent, const bool &isTopSection = true);
-
-	static void AppendData(const Metadata *source, std::ostream *outStream, const int32_t &indentation, const bool &end = false);
+	static void AppendData(const Metadata *source, MetadataWriter &writer, const int32_t &indentation, const bool &end = false);
 };
 }
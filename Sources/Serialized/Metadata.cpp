@@ -1,14 +1,69 @@
 #include "Metadata.hpp"
 
+#include <cctype>
+#include <charconv>
 #include "Engine/Log.hpp"
+#include "Maths/Maths.hpp"
 
 namespace acid
 {
 Metadata::Metadata(const std::string &name, const std::string &value, std::map<std::string, std::string> attributes) :
-	m_name(String::Trim(String::RemoveAll(name, '\"'))), // TODO: Remove first and last.
-	m_value(String::Trim(value)),
+	m_name(String::RemoveAll(name, '\"')), // TODO: Remove first and last.
+	m_value(String::TrimView(value)),
 	m_attributes(std::move(attributes))
 {
+	String::TrimInPlace(m_name);
+}
+
+void Metadata::SetValue(const std::string &value)
+{
+	m_value = value;
+	m_typedValue = {};
+}
+
+void Metadata::SetValue(const std::string &value, const Value &typedValue)
+{
+	m_value = value;
+	m_typedValue = typedValue;
+}
+
+Metadata::Value Metadata::ParseValue(const std::string_view &value)
+{
+	if (value == "true")
+	{
+		return true;
+	}
+
+	if (value == "false")
+	{
+		return false;
+	}
+
+	// Only text that starts like a number is parsed, so words such as inf and nan stay untyped like they are for stream extraction.
+	if (value.empty() || !(std::isdigit(static_cast<unsigned char>(value.front())) || value.front() == '-' || value.front() == '+' || value.front() == '.'))
+	{
+		return {};
+	}
+
+	int64_t integer;
+	auto [integerEnd, error] = std::from_chars(value.data(), value.data() + value.size(), integer);
+
+	if (error == std::errc() && integerEnd == value.data() + value.size())
+	{
+		return integer;
+	}
+
+	// Unlike strtod this does not depend on the locale, and a leading plus is skipped as from_chars does not accept it.
+	double real;
+	auto realBegin = value.data() + (value.front() == '+' ? 1 : 0);
+	auto [realEnd, realError] = std::from_chars(realBegin, value.data() + value.size(), real);
+
+	if (realError == std::errc() && realEnd == value.data() + value.size() && std::isfinite(real) && !(value.front() == '+' && *realBegin == '-'))
+	{
+		return real;
+	}
+
+	return {};
 }
 
 std::string Metadata::GetString() const
@@ -36,6 +91,7 @@ std::string Metadata::GetString() const
 void Metadata::SetString(const std::string &data)
 {
 	m_value = "\"" + data + "\"";
+	m_typedValue = {};
 }
 
 Metadata *Metadata::AddChild(Metadata *child)
@@ -44,17 +100,25 @@ Metadata *Metadata::AddChild(Metadata *child)
 	return child;
 }
 
+Metadata *Metadata::CreateChild(const std::string &name, const std::string &value)
+{
+	auto &child = m_children.emplace_back(CreateShared());
+	child->m_name = name;
+	child->m_value = value;
+	return child.get();
+}
+
 void Metadata::RemoveChild(Metadata *child)
 {
-	m_children.erase(std::remove_if(m_children.begin(), m_children.end(), [child](std::unique_ptr<Metadata> &c)
+	m_children.erase(std::remove_if(m_children.begin(), m_children.end(), [child](const std::shared_ptr<Metadata> &c)
 	{
 		return c.get() == child;
 	}), m_children.end());
 }
 
-std::vector<Metadata *> Metadata::FindChildren(const std::string &name) const
+std::vector<const Metadata *> Metadata::FindChildren(const std::string &name) const
 {
-	std::vector<Metadata *> children;
+	std::vector<const Metadata *> children;
 
 	for (const auto &child : m_children)
 	{
@@ -67,13 +131,29 @@ std::vector<Metadata *> Metadata::FindChildren(const std::string &name) const
 	return children;
 }
 
-Metadata *Metadata::FindChild(const std::string &name, const bool &reportError) const
+std::vector<Metadata *> Metadata::FindChildren(const std::string &name)
+{
+	std::vector<Metadata *> children;
+
+	for (auto &child : m_children)
+	{
+		if (child->m_name == name)
+		{
+			children.emplace_back(Detach(child));
+		}
+	}
+
+	return children;
+}
+
+const Metadata *Metadata::FindChild(const std::string &name, const bool &reportError) const
 {
-	std::string nameNoSpaces = String::ReplaceAll(name, " ", "_");
+	// Names are written with spaces replaced, the replaced name is only built when it differs.
+	auto nameNoSpaces = name.find(' ') != std::string::npos ? String::ReplaceAll(name, " ", "_") : std::string();
 
 	for (const auto &child : m_children)
 	{
-		if (child->m_name == name || child->m_name == nameNoSpaces)
+		if (child->m_name == name || (!nameNoSpaces.empty() && child->m_name == nameNoSpaces))
 		{
 			return child.get();
 		}
@@ -87,7 +167,12 @@ Metadata *Metadata::FindChild(const std::string &name, const bool &reportError)
 	return nullptr;
 }
 
-Metadata *Metadata::FindChildWithBackup(const std::string &name, const std::string &backupName, const bool &reportError) const
+Metadata *Metadata::FindChild(const std::string &name, const bool &reportError)
+{
+	return Detach(static_cast<const Metadata *>(this)->FindChild(name, reportError));
+}
+
+const Metadata *Metadata::FindChildWithBackup(const std::string &name, const std::string &backupName, const bool &reportError) const
 {
 	auto child = FindChild(name, reportError);
 
@@ -99,7 +184,12 @@ Metadata *Metadata::FindChildWithBackup(const std::string &name, const std::stri
 	return FindChild(backupName, reportError);
 }
 
-Metadata *Metadata::FindChildWithAttribute(const std::string &childName, const std::string &attribute, const std::string &value, const bool &reportError) const
+Metadata *Metadata::FindChildWithBackup(const std::string &name, const std::string &backupName, const bool &reportError)
+{
+	return Detach(static_cast<const Metadata *>(this)->FindChildWithBackup(name, backupName, reportError));
+}
+
+const Metadata *Metadata::FindChildWithAttribute(const std::string &childName, const std::string &attribute, const std::string &value, const bool &reportError) const
 {
 	auto children = FindChildren(childName);
 
@@ -126,6 +216,11 @@ Metadata *Metadata::FindChildWithAttribute(const std::string &childName, const s
 	return nullptr;
 }
 
+Metadata *Metadata::FindChildWithAttribute(const std::string &childName, const std::string &attribute, const std::string &value, const bool &reportError)
+{
+	return Detach(static_cast<const Metadata *>(this)->FindChildWithAttribute(childName, attribute, value, reportError));
+}
+
 void Metadata::AddAttribute(const std::string &attribute, const std::string &value)
 {
 	auto it = m_attributes.find(attribute);
@@ -163,22 +258,42 @@ std::string Metadata::FindAttribute(const std::string &attribute) const
 
 Metadata *Metadata::Clone() const
 {
-	auto clone = new Metadata(m_name, m_value, m_attributes);
+	auto clone = CreateEmpty();
+	clone->m_name = m_name;
+	clone->m_value = m_value;
+	clone->m_typedValue = m_typedValue;
+	clone->m_children = m_children;
+	clone->m_attributes = m_attributes;
+	clone->m_arena = m_arena;
+	return clone;
+}
+
+std::size_t Metadata::GetHash() const
+{
+	std::size_t seed = 0;
+	Maths::HashCombine(seed, m_name);
+	Maths::HashCombine(seed, m_value);
+
+	for (const auto &[attributeName, attributeValue] : m_attributes)
+	{
+		Maths::HashCombine(seed, attributeName);
+		Maths::HashCombine(seed, attributeValue);
+	}
 
 	for (const auto &child : m_children)
 	{
-		clone->m_children.emplace_back(child->Clone());
+		Maths::HashCombine(seed, child->GetHash());
 	}
 
-	return clone;
+	return seed;
 }
 
 bool Metadata::operator==(const Metadata &other) const
 {
 	return m_name == other.m_name && m_value == other.m_value && m_attributes == other.m_attributes && m_children.size() == other.m_children.size()
-		&& std::equal(m_children.begin(), m_children.end(), other.m_children.begin(), [](const std::unique_ptr<Metadata> &left, const std::unique_ptr<Metadata> &right)
+		&& std::equal(m_children.begin(), m_children.end(), other.m_children.begin(), [](const std::shared_ptr<Metadata> &left, const std::shared_ptr<Metadata> &right)
 		{
-			return *left == *right;
+			return left == right || *left == *right;
 		});
 }
 
@@ -196,7 +311,66 @@ void Metadata::Load(std::istream *inStream)
 {
 }
 
+void Metadata::Load(const std::string_view &string)
+{
+	std::istringstream stream{std::string(string)};
+	Load(&stream);
+}
+
 void Metadata::Write(std::ostream *outStream) const
 {
+	MetadataWriter writer(outStream);
+	Write(writer);
+}
+
+void Metadata::Write(MetadataWriter &writer) const
+{
+}
+
+std::shared_ptr<Metadata> Metadata::CreateShared() const
+{
+	if (m_arena == nullptr)
+	{
+		return std::make_shared<Metadata>();
+	}
+
+	auto created = std::allocate_shared<Metadata>(MetadataArena::Allocator<Metadata>(m_arena));
+	created->m_arena = m_arena;
+	return created;
+}
+
+Metadata *Metadata::Detach(const Metadata *child)
+{
+	if (child == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (auto &shared : m_children)
+	{
+		if (shared.get() == child)
+		{
+			return Detach(shared);
+		}
+	}
+
+	return nullptr;
+}
+
+Metadata *Metadata::Detach(std::shared_ptr<Metadata> &child)
+{
+	// The child is also in a clone of this tree, it is replaced with a copy that shares the grandchildren.
+	if (child.use_count() > 1)
+	{
+		auto copy = CreateShared();
+		copy->m_name = child->m_name;
+		copy->m_value = child->m_value;
+		copy->m_typedValue = child->m_typedValue;
+		copy->m_children = child->m_children;
+		copy->m_attributes = child->m_attributes;
+		child = std::move(copy);
+	}
+
+	return child.get();
 }
 }
@@ -1,18 +1,28 @@
 #pragma once
 
+#include <variant>
 #include "Helpers/String.hpp"
 #include "Helpers/NonCopyable.hpp"
 #include "Helpers/ConstExpr.hpp"
+#include "MetadataArena.hpp"
+#include "MetadataWriter.hpp"
 
 namespace acid
 {
 /**
  * @brief Class that is used to represent a tree of values, used in file-object serialization.
+ * Children are shared between clones of a tree, a shared child is copied before it is returned by a non-const find, so edits never reach other trees.
  */
 class ACID_EXPORT Metadata :
 	public NonCopyable
 {
 public:
+	/**
+	 * A number or boolean kept next to the text of a value by parsers and the arithmetic stream operators, so reading it back does not parse the text.
+	 * Strings are kept only as text, arrays are children.
+	 */
+	using Value = std::variant<std::monostate, bool, int64_t, double>;
+
 	explicit Metadata(const std::string &name = "", const std::string &value = "", std::map<std::string, std::string> attributes = {});
 
 	const std::string &GetName() const { return m_name; }
@@ -21,13 +31,42 @@ public:
 
 	const std::string &GetValue() const { return m_value; }
 
-	void SetValue(const std::string &value) { m_value = value; }
+	void SetValue(const std::string &value);
+
+	/**
+	 * Sets the value with its typed form.
+	 * @param value The text of the value.
+	 * @param typedValue The value the text parses to.
+	 */
+	void SetValue(const std::string &value, const Value &typedValue);
+
+	const Value &GetTypedValue() const { return m_typedValue; }
+
+	/**
+	 * Reads the typed value into a arithmetic or enum type, without looking at the text.
+	 * @tparam T The type to read into.
+	 * @param dest The destination, only written when the typed value converts into it the same way its text would.
+	 * @return If the typed value was read.
+	 */
+	template<typename T>
+	bool GetNumber(T &dest) const;
+
+	/**
+	 * Parses the text of a value into its typed form, quoted strings and anything that is not a finite number or a boolean have no typed form.
+	 * @param value The text to parse.
+	 * @return The typed value.
+	 */
+	static Value ParseValue(const std::string_view &value);
 
 	std::string GetString() const;
 
 	void SetString(const std::string &data);
 
-	const std::vector<std::unique_ptr<Metadata>> &GetChildren() const { return m_children; }
+	/**
+	 * Gets the children, they may be shared with clones of this tree so must only be read through this list.
+	 * @return The children.
+	 */
+	const std::vector<std::shared_ptr<Metadata>> &GetChildren() const { return m_children; }
 
 	uint32_t GetChildCount() const { return static_cast<uint32_t>(m_children.size()); }
 
@@ -35,15 +74,31 @@ public:
 
 	Metadata *AddChild(Metadata *child);
 
+	/**
+	 * Creates a child at the end of the children, it is allocated from the arena of this tree when there is one.
+	 * @param name The name of the child, it is not trimmed.
+	 * @param value The value of the child, it is not trimmed.
+	 * @return The child.
+	 */
+	Metadata *CreateChild(const std::string &name = "", const std::string &value = "");
+
 	void RemoveChild(Metadata *child);
 
-	std::vector<Metadata *> FindChildren(const std::string &name) const;
+	std::vector<const Metadata *> FindChildren(const std::string &name) const;
+
+	std::vector<Metadata *> FindChildren(const std::string &name);
+
+	const Metadata *FindChild(const std::string &name, const bool &reportError = true) const;
 
-	Metadata *FindChild(const std::string &name, const bool &reportError = true) const;
+	Metadata *FindChild(const std::string &name, const bool &reportError = true);
 
-	Metadata *FindChildWithBackup(const std::string &name, const std::string &backupName, const bool &reportError = true) const;
+	const Metadata *FindChildWithBackup(const std::string &name, const std::string &backupName, const bool &reportError = true) const;
 
-	Metadata *FindChildWithAttribute(const std::string &childName, const std::string &attribute, const std::string &value, const bool &reportError = true) const;
+	Metadata *FindChildWithBackup(const std::string &name, const std::string &backupName, const bool &reportError = true);
+
+	const Metadata *FindChildWithAttribute(const std::string &childName, const std::string &attribute, const std::string &value, const bool &reportError = true) const;
+
+	Metadata *FindChildWithAttribute(const std::string &childName, const std::string &attribute, const std::string &value, const bool &reportError = true);
 
 	template<typename T>
 	T GetChild(const std::string &name) const;
@@ -82,10 +137,45 @@ public:
 
 	virtual void Load(std::istream *inStream);
 
+	/**
+	 * Loads from a contiguous buffer, by default the buffer is read through a stream.
+	 * @param string The buffer to load from.
+	 */
+	virtual void Load(const std::string_view &string);
+
+	/**
+	 * Writes to a stream through a {@link MetadataWriter}.
+	 * @param outStream The stream to write to.
+	 */
 	virtual void Write(std::ostream *outStream) const;
 
+	/**
+	 * Writes incrementally to a writer, formats override this to write each node as it is visited.
+	 * @param writer The writer to write to.
+	 */
+	virtual void Write(MetadataWriter &writer) const;
+
+	/**
+	 * Clones this tree, the children are shared with the clone until either tree changes them.
+	 * The clone is of the same format, so a snapshot can be written on another thread while this tree keeps changing.
+	 * @return The clone.
+	 */
 	Metadata *Clone() const;
 
+	const std::shared_ptr<MetadataArena> &GetArena() const { return m_arena; }
+
+	/**
+	 * Sets the arena children created in this tree are allocated from, they are allocated with new when there is none.
+	 * @param arena The arena.
+	 */
+	void SetArena(const std::shared_ptr<MetadataArena> &arena) { m_arena = arena; }
+
+	/**
+	 * Gets a structural hash of this tree, equal trees will always have equal hashes.
+	 * @return The hash of the name, value, attributes and children.
+	 */
+	std::size_t GetHash() const;
+
 	bool operator==(const Metadata &other) const;
 
 	bool operator!=(const Metadata &other) const;
@@ -93,10 +183,36 @@ public:
 	bool operator<(const Metadata &other) const;
 
 protected:
+	/**
+	 * Creates an empty tree of the same format, used by {@link Metadata#Clone}.
+	 * @return The empty tree.
+	 */
+	virtual Metadata *CreateEmpty() const { return new Metadata(); }
+
+	std::shared_ptr<Metadata> CreateShared() const;
+
+	Metadata *Detach(const Metadata *child);
+
+	Metadata *Detach(std::shared_ptr<Metadata> &child);
+
 	std::string m_name;
 	std::string m_value;
-	std::vector<std::unique_ptr<Metadata>> m_children;
+	Value m_typedValue;
+	std::vector<std::shared_ptr<Metadata>> m_children;
 	std::map<std::string, std::string> m_attributes;
+	std::shared_ptr<MetadataArena> m_arena;
+};
+}
+
+namespace std
+{
+template<>
+struct hash<acid::Metadata>
+{
+	size_t operator()(const acid::Metadata &metadata) const
+	{
+		return metadata.GetHash();
+	}
 };
 }
 
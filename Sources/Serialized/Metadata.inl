@@ -4,6 +4,87 @@
 
 namespace acid
 {
+template<typename T>
+bool Metadata::GetNumber(T &dest) const
+{
+	if constexpr (std::is_enum_v<T>)
+	{
+		std::underlying_type_t<T> underlying;
+
+		if (!GetNumber(underlying))
+		{
+			return false;
+		}
+
+		dest = static_cast<T>(underlying);
+		return true;
+	}
+	else if constexpr (std::is_same_v<bool, T>)
+	{
+		if (auto boolean = std::get_if<bool>(&m_typedValue))
+		{
+			dest = *boolean;
+			return true;
+		}
+
+		if (auto integer = std::get_if<int64_t>(&m_typedValue))
+		{
+			dest = *integer == 1;
+			return true;
+		}
+
+		return false;
+	}
+	else if constexpr (std::is_floating_point_v<T>)
+	{
+		if (auto integer = std::get_if<int64_t>(&m_typedValue))
+		{
+			dest = static_cast<T>(*integer);
+			return true;
+		}
+
+		if (auto real = std::get_if<double>(&m_typedValue))
+		{
+			dest = static_cast<T>(*real);
+			return true;
+		}
+
+		return false;
+	}
+	else if constexpr (std::is_integral_v<T> && sizeof(T) > 1)
+	{
+		// Characters, reals and values out of range are left to the text, stream extraction has its own rules for them.
+		auto integer = std::get_if<int64_t>(&m_typedValue);
+
+		if (integer == nullptr)
+		{
+			return false;
+		}
+
+		if constexpr (std::is_signed_v<T>)
+		{
+			if (*integer < std::numeric_limits<T>::min() || *integer > std::numeric_limits<T>::max())
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if (*integer < 0 || static_cast<uint64_t>(*integer) > std::numeric_limits<T>::max())
+			{
+				return false;
+			}
+		}
+
+		dest = static_cast<T>(*integer);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
 template<typename T>
 T Metadata::GetChild(const std::string &name) const
 {
@@ -109,6 +190,14 @@ void Metadata::SetResource(const std::string &name, const std::shared_ptr<T> &va
 template<typename T>
 const Metadata &operator>>(const Metadata &metadata, T &object)
 {
+	if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+	{
+		if (metadata.GetNumber(object))
+		{
+			return metadata;
+		}
+	}
+
 	object = String::From<T>(metadata.GetValue());
 	return metadata;
 }
@@ -116,7 +205,25 @@ const Metadata &operator>>(const Metadata &metadata, T &object)
 template<typename T>
 Metadata &operator<<(Metadata &metadata, const T &object)
 {
-	metadata.SetValue(String::To(object));
+	if constexpr (std::is_same_v<bool, T>)
+	{
+		metadata.SetValue(String::To(object), object);
+	}
+	else if constexpr (std::is_floating_point_v<T>)
+	{
+		// The text is rounded when formatted, so the typed value is parsed back from it.
+		auto value = String::To(object);
+		metadata.SetValue(value, Metadata::ParseValue(value));
+	}
+	else if constexpr ((std::is_integral_v<T> && sizeof(T) > 1 && sizeof(T) <= sizeof(int64_t) && (std::is_signed_v<T> || sizeof(T) < sizeof(int64_t))) || std::is_enum_v<T>)
+	{
+		metadata.SetValue(String::To(object), static_cast<int64_t>(object));
+	}
+	else
+	{
+		metadata.SetValue(String::To(object));
+	}
+
 	return metadata;
 }
 
@@ -0,0 +1,70 @@
+#include "MetadataArena.hpp"
+
+#include <cstddef>
+
+namespace acid
+{
+MetadataArena::MetadataArena(const std::size_t &blockSize) :
+	m_blockSize(AlignSize(blockSize))
+{
+}
+
+void *MetadataArena::Allocate(const std::size_t &size)
+{
+	auto alignedSize = AlignSize(size);
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (auto it = m_freeNodes.find(alignedSize); it != m_freeNodes.end() && it->second != nullptr)
+	{
+		auto node = it->second;
+		it->second = node->m_next;
+		return node;
+	}
+
+	if (alignedSize > m_remaining)
+	{
+		// Large allocations get a block of their own, so the rest of the current block is not lost.
+		if (alignedSize > m_blockSize / 4)
+		{
+			m_reserved += alignedSize;
+			return m_blocks.emplace_back(new uint8_t[alignedSize]).get();
+		}
+
+		m_current = m_blocks.emplace_back(new uint8_t[m_blockSize]).get();
+		m_remaining = m_blockSize;
+		m_reserved += m_blockSize;
+	}
+
+	auto result = m_current;
+	m_current += alignedSize;
+	m_remaining -= alignedSize;
+	return result;
+}
+
+void MetadataArena::Free(void *pointer, const std::size_t &size)
+{
+	if (pointer == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto &head = m_freeNodes[AlignSize(size)];
+	auto node = static_cast<FreeNode *>(pointer);
+	node->m_next = head;
+	head = node;
+}
+
+std::size_t MetadataArena::GetReserved() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_reserved;
+}
+
+std::size_t MetadataArena::AlignSize(const std::size_t &size)
+{
+	// Operator new[] for uint8_t returns memory aligned for any fundamental type, every allocation is kept at that alignment.
+	const std::size_t alignment = alignof(std::max_align_t);
+	return (std::max(size, sizeof(FreeNode)) + alignment - 1) & ~(alignment - 1);
+}
+}
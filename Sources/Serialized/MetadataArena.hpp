@@ -0,0 +1,97 @@
+#pragma once
+
+#include <mutex>
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+/**
+ * @brief A pool that the nodes of a loaded {@link Metadata} tree are allocated from, memory is taken from large blocks and freed nodes are reused.
+ * Nodes keep the arena alive through their allocator, the blocks are released once the last node allocated from them is destroyed.
+ */
+class ACID_EXPORT MetadataArena :
+	public NonCopyable
+{
+public:
+	/**
+	 * @brief A standard allocator that allocates from a arena, used with std::allocate_shared.
+	 * @tparam T The allocated type.
+	 */
+	template<typename T>
+	class Allocator
+	{
+	public:
+		using value_type = T;
+
+		explicit Allocator(std::shared_ptr<MetadataArena> arena) :
+			m_arena(std::move(arena))
+		{
+		}
+
+		template<typename K>
+		Allocator(const Allocator<K> &other) :
+			m_arena(other.m_arena)
+		{
+		}
+
+		T *allocate(const std::size_t n) { return static_cast<T *>(m_arena->Allocate(sizeof(T) * n)); }
+
+		void deallocate(T *pointer, const std::size_t n) { m_arena->Free(pointer, sizeof(T) * n); }
+
+		template<typename K>
+		bool operator==(const Allocator<K> &other) const { return m_arena == other.m_arena; }
+
+		template<typename K>
+		bool operator!=(const Allocator<K> &other) const { return m_arena != other.m_arena; }
+
+	private:
+		template<typename K>
+		friend class Allocator;
+
+		std::shared_ptr<MetadataArena> m_arena;
+	};
+
+	/**
+	 * Creates a new arena.
+	 * @param blockSize The size of the blocks memory is taken from in bytes.
+	 */
+	explicit MetadataArena(const std::size_t &blockSize = 64 * 1024);
+
+	/**
+	 * Allocates memory aligned for any type, reusing a freed allocation of the same size when there is one.
+	 * @param size The size in bytes.
+	 * @return The memory.
+	 */
+	void *Allocate(const std::size_t &size);
+
+	/**
+	 * Returns memory to the arena so it can be reused.
+	 * @param pointer The memory, allocated from this arena.
+	 * @param size The size in bytes it was allocated with.
+	 */
+	void Free(void *pointer, const std::size_t &size);
+
+	/**
+	 * Gets the number of bytes taken from the system for blocks.
+	 * @return The reserved size.
+	 */
+	std::size_t GetReserved() const;
+
+private:
+	class FreeNode
+	{
+	public:
+		FreeNode *m_next;
+	};
+
+	static std::size_t AlignSize(const std::size_t &size);
+
+	std::size_t m_blockSize;
+	std::vector<std::unique_ptr<uint8_t[]>> m_blocks;
+	std::size_t m_reserved = 0;
+	uint8_t *m_current = nullptr;
+	std::size_t m_remaining = 0;
+	std::map<std::size_t, FreeNode *> m_freeNodes;
+	mutable std::mutex m_mutex;
+};
+}
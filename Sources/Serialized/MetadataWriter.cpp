@@ -0,0 +1,93 @@
+#include "MetadataWriter.hpp"
+
+namespace acid
+{
+MetadataWriter::MetadataWriter(std::ostream *outStream) :
+	MetadataWriter([outStream](const std::string_view &string)
+	{
+		outStream->write(string.data(), static_cast<std::streamsize>(string.size()));
+	})
+{
+}
+
+MetadataWriter::MetadataWriter(Sink &&sink) :
+	m_sink(std::move(sink)),
+	m_buffer(std::make_unique<char[]>(BufferSize)),
+	m_size(0),
+	m_flushed(0)
+{
+}
+
+MetadataWriter::~MetadataWriter()
+{
+	Flush();
+}
+
+void MetadataWriter::Write(const std::string_view &string)
+{
+	if (m_size + string.size() > BufferSize)
+	{
+		Flush();
+
+		// Strings larger than the buffer are given to the sink directly.
+		if (string.size() > BufferSize)
+		{
+			m_sink(string);
+			m_flushed += string.size();
+			return;
+		}
+	}
+
+	std::memcpy(m_buffer.get() + m_size, string.data(), string.size());
+	m_size += string.size();
+}
+
+void MetadataWriter::Write(const char &c)
+{
+	if (m_size == BufferSize)
+	{
+		Flush();
+	}
+
+	m_buffer[m_size++] = c;
+}
+
+void MetadataWriter::WriteEscaped(const std::string_view &string)
+{
+	std::size_t start = 0;
+
+	for (std::size_t i = 0; i < string.size(); i++)
+	{
+		if (string[i] != '\n' && string[i] != '\r')
+		{
+			continue;
+		}
+
+		Write(string.substr(start, i - start));
+		Write(string[i] == '\n' ? "\\n" : "\\r");
+		start = i + 1;
+	}
+
+	Write(string.substr(start));
+}
+
+void MetadataWriter::WriteIndent(const int32_t &indentation)
+{
+	for (int32_t i = 0; i < indentation; i++)
+	{
+		Write("  ");
+	}
+}
+
+void MetadataWriter::Flush()
+{
+	if (m_size == 0)
+	{
+		return;
+	}
+
+	m_sink(std::string_view(m_buffer.get(), m_size));
+	m_flushed += m_size;
+	m_size = 0;
+}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <functional>
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+/**
+ * @brief Writes text to a fixed buffer that is given to a sink each time it fills, used by the metadata formats to write without building strings for every node.
+ * Anything still buffered is flushed when the writer is destroyed.
+ */
+class ACID_EXPORT MetadataWriter :
+	public NonCopyable
+{
+public:
+	/// Called with each full buffer, and with what remains when flushed.
+	using Sink = std::function<void(const std::string_view &)>;
+
+	/// The size of the buffer in bytes.
+	static constexpr std::size_t BufferSize = 64 * 1024;
+
+	/**
+	 * Creates a writer that writes to a stream.
+	 * @param outStream The stream, it must outlive the writer.
+	 */
+	explicit MetadataWriter(std::ostream *outStream);
+
+	explicit MetadataWriter(Sink &&sink);
+
+	~MetadataWriter();
+
+	void Write(const std::string_view &string);
+
+	void Write(const char &c);
+
+	/**
+	 * Writes a string with new lines and carriage returns written as escape tokens, so the value stays on one line.
+	 * @param string The string to write.
+	 */
+	void WriteEscaped(const std::string_view &string);
+
+	/**
+	 * Writes two spaces for every level of indentation.
+	 * @param indentation The levels of indentation.
+	 */
+	void WriteIndent(const int32_t &indentation);
+
+	/**
+	 * Gives everything buffered to the sink.
+	 */
+	void Flush();
+
+	/**
+	 * Gets the number of bytes written, including those still buffered.
+	 * @return The number of bytes.
+	 */
+	std::size_t GetSize() const { return m_flushed + m_size; }
+
+	MetadataWriter &operator<<(const std::string_view &string)
+	{
+		Write(string);
+		return *this;
+	}
+
+	MetadataWriter &operator<<(const char &c)
+	{
+		Write(c);
+		return *this;
+	}
+
+private:
+	Sink m_sink;
+	std::unique_ptr<char[]> m_buffer;
+	std::size_t m_size;
+	std::size_t m_flushed;
+};
+}
@@ -92,10 +92,10 @@ void Xml::Load(std::istream *inStream)
 	}
 }
 
-void Xml::Write(std::ostream *outStream) const
+void Xml::Write(MetadataWriter &writer) const
 {
-	*outStream << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
-	AppendData(this, outStream, 0);
+	writer << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+	AppendData(this, writer, 0);
 }
 
 void Xml::AddChildren(const Metadata *source, Metadata *destination)
@@ -114,17 +114,17 @@ void Xml::AddChildren(const Metadata *source, Metadata *destination)
 
 void Xml::Convert(const Node *source, Metadata *parent, const uint32_t &depth)
 {
-	int32_t firstSpace = String::FindCharPos(source->m_attributes, ' ');
-	std::string name = String::Trim(String::Substring(source->m_attributes, 0, firstSpace));
-	std::string attributes = String::Substring(source->m_attributes, firstSpace + 1, static_cast<int32_t>(source->m_attributes.size()));
-	attributes = String::Trim(attributes);
+	std::string_view attributes = source->m_attributes;
+	auto firstSpace = attributes.find(' ');
+	std::string name(String::TrimView(attributes.substr(0, firstSpace)));
+	attributes = String::TrimView(firstSpace == std::string_view::npos ? attributes : attributes.substr(firstSpace + 1));
 
-	if (attributes[attributes.size() - 1] == '/' || attributes[attributes.size() - 1] == '?')
+	if (!attributes.empty() && (attributes.back() == '/' || attributes.back() == '?'))
 	{
-		attributes.pop_back();
+		attributes.remove_suffix(1);
 	}
 
-	attributes = String::Trim(attributes);
+	attributes = String::TrimView(attributes);
 
 	std::map<std::string, std::string> parseAttributes;
 
@@ -146,7 +146,7 @@ void Xml::Convert(const Node *source, Metadata *parent, const uint32_t &depth)
 					continue;
 				}
 
-				parseAttributes.emplace(String::Trim(currentKey), String::Trim(summation));
+				parseAttributes.emplace(String::TrimView(currentKey), String::TrimView(summation));
 				currentKey.clear();
 				summation.clear();
 				break;
@@ -198,36 +198,21 @@ void Xml::Convert(const Node *source, Metadata *parent, const uint32_t &depth)
 	}
 }
 
-void Xml::AppendData(const Metadata *source, std::ostream *outStream, const int32_t &indentation)
+void Xml::AppendData(const Metadata *source, MetadataWriter &writer, const int32_t &indentation)
 {
-	std::stringstream indents;
-
-	for (int32_t i = 0; i < indentation; i++)
-	{
-		indents << "  ";
-	}
-
 	std::string name = String::ReplaceAll(source->GetName(), " ", "_");
 
-	std::stringstream nameAttributes;
-	nameAttributes << name;
-
-	for (const auto &[attributeName, value] : source->GetAttributes())
-	{
-		nameAttributes << " " << attributeName << "=\"" << value << "\"";
-	}
-
-	std::string nameAndAttribs = String::Trim(nameAttributes.str());
-
-	*outStream << indents.str();
+	writer.WriteIndent(indentation);
+	writer << '<';
+	WriteNameAndAttributes(source, name, writer);
 
 	if (source->GetName()[0] == '?')
 	{
-		*outStream << "<" << nameAndAttribs << "?>\n";
+		writer << "?>\n";
 
 		for (const auto &child : source->GetChildren())
 		{
-			AppendData(child.get(), outStream, indentation);
+			AppendData(child.get(), writer, indentation);
 		}
 
 		return;
@@ -235,24 +220,43 @@ void Xml::AppendData(const Metadata *source, std::ostream *outStream, const int3
 
 	if (source->GetChildren().empty() && source->GetValue().empty())
 	{
-		*outStream << "<" << nameAndAttribs << "/>\n";
+		writer << "/>\n";
 		return;
 	}
 
-	*outStream << "<" << nameAndAttribs << ">" << String::FixReturnTokens(source->GetValue());
+	writer << '>';
+	writer.WriteEscaped(source->GetValue());
 
 	if (!source->GetChildren().empty())
 	{
-		*outStream << '\n';
+		writer << '\n';
 
 		for (const auto &child : source->GetChildren())
 		{
-			AppendData(child.get(), outStream, indentation + 1);
+			AppendData(child.get(), writer, indentation + 1);
 		}
 
-		*outStream << indents.str();
+		writer.WriteIndent(indentation);
 	}
 
-	*outStream << "</" << name << ">\n";
+	writer << "</" << name << ">\n";
+}
+
+void Xml::WriteNameAndAttributes(const Metadata *source, const std::string &name, MetadataWriter &writer)
+{
+	writer << name;
+	// An empty name does not leave a space before the first attribute.
+	auto separate = !name.empty();
+
+	for (const auto &[attributeName, value] : source->GetAttributes())
+	{
+		if (separate)
+		{
+			writer << ' ';
+		}
+
+		writer << attributeName << "=\"" << value << '"';
+		separate = true;
+	}
 }
 }
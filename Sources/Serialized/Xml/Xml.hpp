@@ -33,13 +33,20 @@ public:
 
 	void Load(std::istream *inStream) override;
 
-	void Write(std::ostream *outStream) const override;
+	using Metadata::Write;
+
+	void Write(MetadataWriter &writer) const override;
+
+protected:
+	Metadata *CreateEmpty() const override { return new Xml(""); }
 
 private:
 	static void AddChildren(const Metadata *source, Metadata *destination);
 
 	static void Convert(const Node *source, Metadata *parent, const uint32_t &depth);
 
-	static void AppendData(const Metadata *source, std::ostream *outStream, const int32_t &indentation);
+	static void AppendData(const Metadata *source, MetadataWriter &writer, const int32_t &indentation);
+
+	static void WriteNameAndAttributes(const Metadata *source, const std::string &name, MetadataWriter &writer);
 };
 }
@@ -95,7 +95,7 @@ void Yaml::Load(std::istream *inStream)
 			currentSection = currentSection->m_children.back().get();
 		}
 
-		auto content = String::Trim(linebuf).erase(0, 2 * arrayLevels);
+		auto content = std::string(String::TrimView(linebuf).substr(2 * arrayLevels));
 		auto section = new Section(currentSection, content, indentation, arrayLevels);
 		currentSection->m_children.emplace_back(section);
 		lastIndentation = indentation;
@@ -104,10 +104,10 @@ void Yaml::Load(std::istream *inStream)
 	Convert(topSection.get(), this, true);
 }
 
-void Yaml::Write(std::ostream *outStream) const
+void Yaml::Write(MetadataWriter &writer) const
 {
-	*outStream << "---\n";
-	AppendData(this, nullptr, outStream, 0);
+	writer << "---\n";
+	AppendData(this, nullptr, writer, 0);
 }
 
 void Yaml::AddChildren(const Metadata *source, Metadata *destination)
@@ -126,9 +126,13 @@ void Yaml::AddChildren(const Metadata *source, Metadata *destination)
 
 void Yaml::Convert(const Section *source, Metadata *parent, const bool &isTopSection)
 {
-	auto name = String::Trim(source->m_content.substr(0, source->m_content.find(':')));
-	auto value = String::Trim(String::ReplaceFirst(source->m_content, name, ""));
-	value = String::Trim(value.erase(0, 1));
+	// The name is before the first colon and the value after it, both are views into the content until they are copied once.
+	std::string_view content = source->m_content;
+	auto nameView = String::TrimView(content.substr(0, content.find(':')));
+	auto valueView = String::TrimView(content.substr(nameView.empty() ? 0 : nameView.data() - content.data() + nameView.size()));
+	valueView = String::TrimView(valueView.substr(std::min<std::size_t>(valueView.size(), 1)));
+	std::string name(nameView);
+	std::string value(valueView);
 	bool singleArray = false;
 
 	if (source->m_arrayLevels != 0 && value.empty())
@@ -167,57 +171,46 @@ void Yaml::Convert(const Section *source, Metadata *parent, const bool &isTopSec
 	}
 }
 
-void Yaml::AppendData(const Metadata *source, const Metadata *parent, std::ostream *outStream, const int32_t &indentation)
+void Yaml::AppendData(const Metadata *source, const Metadata *parent, MetadataWriter &writer, const int32_t &indentation)
 {
-	std::stringstream indents;
-
-	for (int32_t i = 0; i < indentation; i++)
-	{
-		indents << "  ";
-	}
-
-	bool wroteIntents = false;
-
-	if (parent != nullptr && !(parent->GetChildren()[0].get() == source && parent->GetName().empty() && parent->GetValue().empty()))
-	{
-		*outStream << indents.str();
-		wroteIntents = true;
-	}
+	auto writeIndents = parent != nullptr && !(parent->GetChildren()[0].get() == source && parent->GetName().empty() && parent->GetValue().empty());
 
 	if (parent != nullptr && parent->GetValue().empty() && parent->GetChildren()[0]->GetName().empty())
 	{
-		if (wroteIntents)
+		// The dash of an array item takes the place of the last indentation.
+		if (writeIndents)
 		{
-			outStream->seekp(-2, std::stringstream::cur);
+			writer.WriteIndent(indentation - 1);
 		}
 
-		*outStream << "- ";
+		writer << "- ";
+	}
+	else if (writeIndents)
+	{
+		writer.WriteIndent(indentation);
 	}
 
 	if (!source->GetName().empty())
 	{
-		if (source->GetValue().empty())
-		{
-			*outStream << source->GetName() << ": \n";
-		}
-		else
-		{
-			*outStream << source->GetName() << ": " << String::FixReturnTokens(source->GetValue()) << '\n';
-		}
+		writer << source->GetName() << ": ";
+		writer.WriteEscaped(source->GetValue());
+		writer << '\n';
 	}
 	else if (!source->GetValue().empty())
 	{
-		*outStream << String::FixReturnTokens(source->GetValue()) << '\n';
+		writer.WriteEscaped(source->GetValue());
+		writer << '\n';
 	}
 
 	for (const auto &attribute : source->GetAttributes())
 	{
-		*outStream << indents.str() << "  _" << attribute.first + ": " << attribute.second << '\n';
+		writer.WriteIndent(indentation);
+		writer << "  _" << attribute.first << ": " << attribute.second << '\n';
 	}
 
 	for (const auto &child : source->GetChildren())
 	{
-		AppendData(child.get(), source, outStream, indentation + !source->GetName().empty());
+		AppendData(child.get(), source, writer, indentation + !source->GetName().empty());
 	}
 }
 }
@@ -35,13 +35,18 @@ public:
 
 	void Load(std::istream *inStream) override;
 
-	void Write(std::ostream *outStream) const override;
+	using Metadata::Write;
+
+	void Write(MetadataWriter &writer) const override;
+
+protected:
+	Metadata *CreateEmpty() const override { return new Yaml(); }
 
 private:
 	static void AddChildren(const Metadata *source, Metadata *destination);
 
 	static void Convert(const Section *source, Metadata *parent, const bool &isTopSection = true);
 
-	static void AppendData(const Metadata *source, const Metadata *parent, std::ostream *outStream, const int32_t &indentation);
+	static void AppendData(const Metadata *source, const Metadata *parent, MetadataWriter &writer, const int32_t &indentation);
 };
 }
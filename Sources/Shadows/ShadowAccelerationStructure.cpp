@@ -0,0 +1,301 @@
+#include "ShadowAccelerationStructure.hpp"
+
+#include "Graphics/Graphics.hpp"
+#include "Meshes/Mesh.hpp"
+#include "Meshes/MeshRender.hpp"
+#include "Scenes/Scenes.hpp"
+#include "ShadowRender.hpp"
+
+namespace acid
+{
+static const uint32_t MIN_INSTANCES = 256;
+// Refitting lowers the quality of the top level as instances move away from where it was built, so it is rebuilt after this many refits.
+static const uint32_t MAX_UPDATES = 64;
+
+ShadowAccelerationStructure::ShadowAccelerationStructure() :
+	m_quantizedSupported(false)
+{
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(*Graphics::Get()->GetPhysicalDevice(), VK_FORMAT_R16G16B16A16_UNORM, &formatProperties);
+	m_quantizedSupported = (formatProperties.bufferFeatures & VK_FORMAT_FEATURE_ACCELERATION_STRUCTURE_VERTEX_BUFFER_BIT_KHR) != 0;
+}
+
+bool ShadowAccelerationStructure::CmdBuild(const CommandBuffer &commandBuffer, const bool &enabled)
+{
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto framesInFlight = Graphics::Get()->GetFramesInFlight();
+
+	if (m_frames.size() > framesInFlight)
+	{
+		m_frames.resize(framesInFlight);
+	}
+
+	while (m_frames.size() < framesInFlight)
+	{
+		m_frames.emplace_back(std::make_unique<Frame>());
+	}
+
+	auto &frame = *m_frames[Graphics::Get()->GetCurrentFrame()];
+
+	// Released models give up their bottom levels, top levels of frames in flight keep tracing against them until they are retired.
+	for (auto it = m_bottomLevels.begin(); it != m_bottomLevels.end();)
+	{
+		if (it->second.m_model.expired())
+		{
+			it = m_bottomLevels.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	m_instances.clear();
+	m_references.clear();
+	std::vector<BottomLevelBuild> builds;
+
+	std::pmr::vector<MeshRender *> meshRenders(FrameAllocator::Get());
+
+	if (enabled)
+	{
+		meshRenders = Scenes::Get()->GetStructure()->QueryComponents<MeshRender>(FrameAllocator::Get());
+	}
+
+	for (const auto &meshRender : meshRenders)
+	{
+		// Only entities that cast shadow maps cast traced shadows, so meshes such as skyboxes are not traced against.
+		auto entity = meshRender->GetParent();
+		auto mesh = entity->GetComponent<Mesh>();
+
+		if (entity->GetComponent<ShadowRender>() == nullptr || mesh == nullptr || mesh->GetModel() == nullptr)
+		{
+			continue;
+		}
+
+		auto &model = mesh->GetModel();
+
+		if (model->GetVertexBuffer() == nullptr || (model->IsQuantized() && !m_quantizedSupported))
+		{
+			continue;
+		}
+
+		auto it = m_bottomLevels.find(model.get());
+
+		// A model at the address of a released model is a new model.
+		if (it != m_bottomLevels.end() && it->second.m_model.lock() != model)
+		{
+			m_bottomLevels.erase(it);
+			it = m_bottomLevels.end();
+		}
+
+		if (it == m_bottomLevels.end())
+		{
+			BottomLevel bottomLevel;
+			bottomLevel.m_model = model;
+			bottomLevel.m_uploadToken = Graphics::Get()->GetUploadContext()->GetToken();
+			it = m_bottomLevels.emplace(model.get(), std::move(bottomLevel)).first;
+		}
+
+		auto &bottomLevel = it->second;
+
+		if (bottomLevel.m_structure == nullptr)
+		{
+			// The compute queue does not wait for uploads, builds only read vertices once the batch they were uploaded in has finished.
+			if (!Graphics::Get()->GetUploadContext()->IsComplete(bottomLevel.m_uploadToken))
+			{
+				continue;
+			}
+
+			CreateBottomLevel(*model, bottomLevel, builds.emplace_back());
+		}
+
+		// Quantized positions are rebuilt by the instance transform, the same way they are rebuilt by the mvp when drawn.
+		auto transform = entity->GetWorldMatrix();
+
+		if (model->IsQuantized())
+		{
+			transform = transform.Translate(model->GetQuantizeOffset()).Scale(model->GetQuantizeScale());
+		}
+
+		VkAccelerationStructureInstanceKHR instance = {};
+
+		for (uint32_t row = 0; row < 3; row++)
+		{
+			for (uint32_t col = 0; col < 4; col++)
+			{
+				instance.transform.matrix[row][col] = transform[col][row];
+			}
+		}
+
+		instance.instanceCustomIndex = 0;
+		instance.mask = 0xFF;
+		instance.instanceShaderBindingTableRecordOffset = 0;
+		instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
+		instance.accelerationStructureReference = bottomLevel.m_structure->GetStructureAddress();
+		m_instances.emplace_back(instance);
+		m_references.emplace_back(instance.accelerationStructureReference);
+	}
+
+	if (!builds.empty())
+	{
+		// New bottom levels are built together, each with scratch memory of its own.
+		std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildInfos;
+		std::vector<const VkAccelerationStructureBuildRangeInfoKHR *> ranges;
+
+		for (auto &build : builds)
+		{
+			build.m_buildInfo.pGeometries = &build.m_geometry;
+			buildInfos.emplace_back(build.m_buildInfo);
+			ranges.emplace_back(&build.m_range);
+		}
+
+		Instance::FvkCmdBuildAccelerationStructuresKHR(*logicalDevice, commandBuffer, static_cast<uint32_t>(buildInfos.size()), buildInfos.data(), ranges.data());
+
+		VkMemoryBarrier memoryBarrier = {};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+		memoryBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1,
+			&memoryBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	// The scratch buffers are retired when they are released, so builds recorded with them can still run.
+	return CmdBuildTopLevel(commandBuffer, frame) || !builds.empty();
+}
+
+const AccelerationStructure *ShadowAccelerationStructure::GetTopLevel() const
+{
+	auto currentFrame = Graphics::Get()->GetCurrentFrame();
+
+	if (currentFrame >= m_frames.size())
+	{
+		return nullptr;
+	}
+
+	return m_frames[currentFrame]->m_topLevel.get();
+}
+
+void ShadowAccelerationStructure::CreateBottomLevel(const Model &model, BottomLevel &bottomLevel, BottomLevelBuild &build) const
+{
+	// Models in a geometry heap start at their offsets into the shared buffers.
+	auto vertexAddress = model.GetVertexBuffer()->GetDeviceAddress() + static_cast<VkDeviceSize>(model.GetVertexOffset()) * model.GetVertexSize();
+	auto indexed = model.GetIndexBuffer() != nullptr;
+
+	build.m_geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+	build.m_geometry.geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR;
+	// Materials are not read by the traced rays, every triangle is opaque.
+	build.m_geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+
+	auto &triangles = build.m_geometry.geometry.triangles;
+	triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
+	triangles.vertexFormat = model.IsQuantized() ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R32G32B32_SFLOAT;
+	triangles.vertexData.deviceAddress = vertexAddress;
+	triangles.vertexStride = model.GetVertexSize();
+	triangles.maxVertex = model.GetVertexCount() - 1;
+	triangles.indexType = indexed ? model.GetIndexType() : VK_INDEX_TYPE_NONE_KHR;
+
+	if (indexed)
+	{
+		// The full detail level is traced against, it is the first range of the index buffer.
+		triangles.indexData.deviceAddress = model.GetIndexBuffer()->GetDeviceAddress() +
+			static_cast<VkDeviceSize>(model.GetFirstIndex()) * GeometryHeap::GetIndexSize(model.GetIndexType());
+	}
+
+	auto primitiveCount = (indexed ? model.GetIndexCount() : model.GetVertexCount()) / 3;
+	build.m_range.primitiveCount = primitiveCount;
+
+	build.m_buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+	build.m_buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+	build.m_buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+	build.m_buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+	build.m_buildInfo.geometryCount = 1;
+	build.m_buildInfo.pGeometries = &build.m_geometry;
+
+	auto buildSizes = AccelerationStructure::GetBuildSizes(build.m_buildInfo, &primitiveCount);
+	bottomLevel.m_structure = std::make_unique<AccelerationStructure>(AccelerationStructure::Type::Bottom, buildSizes.accelerationStructureSize);
+	build.m_scratchBuffer = AccelerationStructure::CreateScratchBuffer(buildSizes.buildScratchSize);
+
+	build.m_buildInfo.dstAccelerationStructure = bottomLevel.m_structure->GetAccelerationStructure();
+	build.m_buildInfo.scratchData.deviceAddress = AccelerationStructure::GetScratchAddress(*build.m_scratchBuffer);
+}
+
+bool ShadowAccelerationStructure::CmdBuildTopLevel(const CommandBuffer &commandBuffer, Frame &frame)
+{
+	auto instanceCount = static_cast<uint32_t>(m_instances.size());
+	auto update = frame.m_topLevel != nullptr && frame.m_references == m_references && frame.m_updates < MAX_UPDATES;
+
+	// An empty top level that has been built stays empty.
+	if (update && instanceCount == 0)
+	{
+		return false;
+	}
+
+	if (frame.m_instanceCapacity < instanceCount || frame.m_instanceBuffer == nullptr)
+	{
+		frame.m_instanceCapacity = std::max(2 * instanceCount, MIN_INSTANCES);
+		frame.m_instanceBuffer = std::make_unique<Buffer>(sizeof(VkAccelerationStructureInstanceKHR) * frame.m_instanceCapacity,
+			AccelerationStructure::GetBuildInputUsage(), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		update = false;
+	}
+
+	if (instanceCount != 0)
+	{
+		void *instances;
+		frame.m_instanceBuffer->MapMemory(&instances);
+		std::memcpy(instances, m_instances.data(), sizeof(VkAccelerationStructureInstanceKHR) * instanceCount);
+		frame.m_instanceBuffer->UnmapMemory();
+	}
+
+	VkAccelerationStructureGeometryKHR geometry = {};
+	geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+	geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+	geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+	geometry.geometry.instances.arrayOfPointers = VK_FALSE;
+	geometry.geometry.instances.data.deviceAddress = frame.m_instanceBuffer->GetDeviceAddress();
+
+	VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {};
+	buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+	buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+	buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+	buildInfo.geometryCount = 1;
+	buildInfo.pGeometries = &geometry;
+
+	if (!update)
+	{
+		// The top level is sized for the capacity of the instance buffer, so it is only recreated when the buffer grows.
+		auto buildSizes = AccelerationStructure::GetBuildSizes(buildInfo, &frame.m_instanceCapacity);
+
+		if (frame.m_topLevel == nullptr || frame.m_topLevel->GetSize() < buildSizes.accelerationStructureSize)
+		{
+			// The new structure is created before the old one is released, so descriptor sets holding the old one never mistake it for the new one.
+			auto topLevel = std::make_unique<AccelerationStructure>(AccelerationStructure::Type::Top, buildSizes.accelerationStructureSize);
+			frame.m_topLevel = std::move(topLevel);
+		}
+
+		auto scratchSize = std::max(buildSizes.buildScratchSize, buildSizes.updateScratchSize);
+
+		if (frame.m_scratchSize < scratchSize)
+		{
+			frame.m_scratchBuffer = AccelerationStructure::CreateScratchBuffer(scratchSize);
+			frame.m_scratchSize = scratchSize;
+		}
+
+		frame.m_references = m_references;
+		frame.m_updates = 0;
+	}
+	else
+	{
+		frame.m_updates++;
+	}
+
+	buildInfo.mode = update ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+	buildInfo.srcAccelerationStructure = update ? frame.m_topLevel->GetAccelerationStructure() : VK_NULL_HANDLE;
+	buildInfo.dstAccelerationStructure = frame.m_topLevel->GetAccelerationStructure();
+	buildInfo.scratchData.deviceAddress = AccelerationStructure::GetScratchAddress(*frame.m_scratchBuffer);
+
+	VkAccelerationStructureBuildRangeInfoKHR range = {};
+	range.primitiveCount = instanceCount;
+	auto pRange = &range;
+	Instance::FvkCmdBuildAccelerationStructuresKHR(*Graphics::Get()->GetLogicalDevice(), commandBuffer, 1, &buildInfo, &pRange);
+	return true;
+}
+}
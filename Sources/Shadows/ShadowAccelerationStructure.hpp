@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Graphics/Buffers/AccelerationStructure.hpp"
+#include "Graphics/Commands/UploadContext.hpp"
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+class Model;
+
+/**
+ * @brief The acceleration structures shadow rays are traced against, a bottom level for each model of a mesh render that casts shadows, and a top level over those mesh renders.
+ * Bottom levels are built once the uploads of their model have finished, and are released along with their model.
+ * A top level is kept for each frame in flight, it is refit to the moved instances while it holds the same bottom levels and is rebuilt when they change.
+ * Builds are recorded into the compute command buffer of the frame, so they run on the async compute queue when there is one.
+ */
+class ACID_EXPORT ShadowAccelerationStructure :
+	public NonCopyable
+{
+public:
+	ShadowAccelerationStructure();
+
+	/**
+	 * Records the builds of new bottom levels and the build of the top level of this frame.
+	 * @param commandBuffer The compute command buffer to record into.
+	 * @param enabled If mesh renders are added as instances, otherwise the top level is empty so it can still be bound.
+	 * @return If any builds were recorded.
+	 */
+	bool CmdBuild(const CommandBuffer &commandBuffer, const bool &enabled);
+
+	/**
+	 * Gets the top level of this frame, built by {@link ShadowAccelerationStructure#CmdBuild}.
+	 * @return The top level, or nullptr if it has not been built.
+	 */
+	const AccelerationStructure *GetTopLevel() const;
+
+private:
+	class BottomLevel
+	{
+	public:
+		std::weak_ptr<Model> m_model;
+		/// The uploads of the model have finished once this upload batch has.
+		UploadContext::Token m_uploadToken = 0;
+		std::unique_ptr<AccelerationStructure> m_structure;
+	};
+
+	class BottomLevelBuild
+	{
+	public:
+		VkAccelerationStructureGeometryKHR m_geometry = {};
+		VkAccelerationStructureBuildRangeInfoKHR m_range = {};
+		VkAccelerationStructureBuildGeometryInfoKHR m_buildInfo = {};
+		std::unique_ptr<Buffer> m_scratchBuffer;
+	};
+
+	class Frame
+	{
+	public:
+		std::unique_ptr<AccelerationStructure> m_topLevel;
+		std::unique_ptr<Buffer> m_instanceBuffer;
+		uint32_t m_instanceCapacity = 0;
+		std::unique_ptr<Buffer> m_scratchBuffer;
+		VkDeviceSize m_scratchSize = 0;
+		/// The bottom level of each instance the top level was last built with, it is refit while they are the same.
+		std::vector<VkDeviceAddress> m_references;
+		uint32_t m_updates = 0;
+	};
+
+	/**
+	 * Creates the bottom level of a model and fills in its build.
+	 * @param model The model.
+	 * @param bottomLevel The bottom level to create the structure of.
+	 * @param build The build to fill in, its pointers are set once every build has been added.
+	 */
+	void CreateBottomLevel(const Model &model, BottomLevel &bottomLevel, BottomLevelBuild &build) const;
+
+	/**
+	 * Records the build of the top level of a frame over the instances found this frame.
+	 * @param commandBuffer The compute command buffer to record into.
+	 * @param frame The frame.
+	 * @return If the build was recorded.
+	 */
+	bool CmdBuildTopLevel(const CommandBuffer &commandBuffer, Frame &frame);
+
+	/// If quantized vertex positions can be read by builds, otherwise quantized models cast no traced shadows.
+	bool m_quantizedSupported;
+	std::map<const Model *, BottomLevel> m_bottomLevels;
+	std::vector<std::unique_ptr<Frame>> m_frames;
+	std::vector<VkAccelerationStructureInstanceKHR> m_instances;
+	std::vector<VkDeviceAddress> m_references;
+};
+}
@@ -0,0 +1,149 @@
+#include "ShadowAtlas.hpp"
+
+namespace acid
+{
+ShadowAtlas::ShadowAtlas(const uint32_t &maxLevel) :
+	m_maxLevel(maxLevel),
+	m_nodes(((std::size_t(1) << (2 * (maxLevel + 1))) - 1) / 3, State::Free)
+{
+}
+
+std::optional<uint32_t> ShadowAtlas::Allocate(const uint32_t &level)
+{
+	if (level > m_maxLevel)
+	{
+		return std::nullopt;
+	}
+
+	// Splitting a free node is the last resort, so small tiles fill the gaps between other small tiles first.
+	if (auto node = Allocate(0, 0, level, false))
+	{
+		return node;
+	}
+
+	return Allocate(0, 0, level, true);
+}
+
+void ShadowAtlas::Release(const uint32_t &node)
+{
+	m_nodes[node] = State::Free;
+
+	// A split node whose children are all free is merged back into one free node.
+	for (auto child = node; child != 0;)
+	{
+		auto parent = (child - 1) / 4;
+
+		for (uint32_t i = 1; i <= 4; i++)
+		{
+			if (m_nodes[4 * parent + i] != State::Free)
+			{
+				return;
+			}
+		}
+
+		m_nodes[parent] = State::Free;
+		child = parent;
+	}
+}
+
+void ShadowAtlas::Clear()
+{
+	std::fill(m_nodes.begin(), m_nodes.end(), State::Free);
+}
+
+Vector4f ShadowAtlas::GetArea(const uint32_t &node) const
+{
+	// Walks up from the node, each child index picks a quadrant of its parent.
+	auto level = GetLevel(node);
+	auto size = 1.0f / static_cast<float>(1u << level);
+	float x = 0.0f;
+	float y = 0.0f;
+	auto scale = size;
+
+	for (auto child = node; child != 0; child = (child - 1) / 4)
+	{
+		auto quadrant = (child - 1) % 4;
+		x += static_cast<float>(quadrant % 2) * scale;
+		y += static_cast<float>(quadrant / 2) * scale;
+		scale *= 2.0f;
+	}
+
+	return Vector4f(x, y, size, size);
+}
+
+uint32_t ShadowAtlas::GetLevel(uint32_t node)
+{
+	uint32_t level = 0;
+
+	while (node != 0)
+	{
+		node = (node - 1) / 4;
+		level++;
+	}
+
+	return level;
+}
+
+float ShadowAtlas::GetUsage() const
+{
+	float usage = 0.0f;
+
+	for (uint32_t i = 0; i < m_nodes.size(); i++)
+	{
+		if (m_nodes[i] == State::Used)
+		{
+			auto size = 1.0f / static_cast<float>(1u << GetLevel(i));
+			usage += size * size;
+		}
+	}
+
+	return usage;
+}
+
+std::optional<uint32_t> ShadowAtlas::Allocate(const uint32_t &node, const uint32_t &level, const uint32_t &target, const bool &split)
+{
+	switch (m_nodes[node])
+	{
+	case State::Used:
+		return std::nullopt;
+	case State::Free:
+		if (level == target)
+		{
+			m_nodes[node] = State::Used;
+			return node;
+		}
+
+		if (!split)
+		{
+			return std::nullopt;
+		}
+
+		m_nodes[node] = State::Split;
+
+		for (uint32_t i = 1; i <= 4; i++)
+		{
+			m_nodes[4 * node + i] = State::Free;
+		}
+
+		// The first child of a freshly split node always fits, the rest are left free.
+		return Allocate(4 * node + 1, level + 1, target, true);
+	case State::Split:
+		if (level == target)
+		{
+			return std::nullopt;
+		}
+
+		for (uint32_t i = 1; i <= 4; i++)
+		{
+			if (auto allocated = Allocate(4 * node + i, level + 1, target, split))
+			{
+				return allocated;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	return std::nullopt;
+}
+}
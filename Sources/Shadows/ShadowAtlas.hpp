@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Maths/Vector4.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that allocates square tiles of a shadow atlas with a quadtree, a tile at level n is a 2^n by 2^n part of the atlas.
+ * Tiles of a level are packed into nodes that are already split before a free node is split, so freed tiles merge back into larger free nodes.
+ */
+class ACID_EXPORT ShadowAtlas
+{
+public:
+	/**
+	 * Creates a new shadow atlas allocator.
+	 * @param maxLevel The deepest level tiles can be allocated at.
+	 */
+	explicit ShadowAtlas(const uint32_t &maxLevel = 6);
+
+	/**
+	 * Allocates a tile.
+	 * @param level The level of the tile, the tile covers 1 / 2^level of the atlas on each axis.
+	 * @return The node of the tile, or nothing if no tile of the level is free.
+	 */
+	std::optional<uint32_t> Allocate(const uint32_t &level);
+
+	/**
+	 * Frees a tile so its area can be allocated again.
+	 * @param node The node of the tile.
+	 */
+	void Release(const uint32_t &node);
+
+	/**
+	 * Frees every tile.
+	 */
+	void Clear();
+
+	/**
+	 * Gets the area of the atlas a tile covers, in the range of zero to one.
+	 * @param node The node of the tile.
+	 * @return The offset (xy) and size (zw) of the tile.
+	 */
+	Vector4f GetArea(const uint32_t &node) const;
+
+	/**
+	 * Gets the level of a node.
+	 * @param node The node.
+	 * @return The level, zero is the whole atlas.
+	 */
+	static uint32_t GetLevel(uint32_t node);
+
+	const uint32_t &GetMaxLevel() const { return m_maxLevel; }
+
+	/**
+	 * Gets the fraction of the atlas covered by allocated tiles.
+	 * @return The used fraction, between 0 and 1.
+	 */
+	float GetUsage() const;
+
+private:
+	enum class State :
+		uint8_t
+	{
+		Free, Split, Used
+	};
+
+	/**
+	 * Finds and uses a free node at a level below a node.
+	 * @param node The node to search.
+	 * @param level The level of the node.
+	 * @param target The level to allocate at.
+	 * @param split If free nodes above the target level may be split.
+	 * @return The node that was used.
+	 */
+	std::optional<uint32_t> Allocate(const uint32_t &node, const uint32_t &level, const uint32_t &target, const bool &split);
+
+	uint32_t m_maxLevel;
+	/// A complete quadtree, the children of node i are 4i + 1 to 4i + 4.
+	std::vector<State> m_nodes;
+};
+}
@@ -1,6 +1,5 @@
 ﻿#include "ShadowBox.hpp"
 
-#include "Devices/Window.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Maths/Maths.hpp"
 
@@ -8,30 +7,52 @@ namespace acid
 {
 ShadowBox::ShadowBox() :
 	m_shadowOffset(0.0f),
-	m_shadowDistance(0.0f),
-	m_farHeight(0.0f),
-	m_farWidth(0.0f),
-	m_nearHeight(0.0f),
-	m_nearWidth(0.0f)
+	m_nearDistance(0.0f),
+	m_farDistance(0.0f),
+	m_padding(0.0f)
 {
-	// Creates the offset for part of the conversion to shadow map space.
-	m_offset = m_offset.Translate(Vector3f(0.5f));
-	m_offset = m_offset.Scale(Vector3f(0.5f));
+	// Creates the offset for part of the conversion to shadow map space, the depth is already from zero to one.
+	m_offset = m_offset.Translate(Vector3f(0.5f, 0.5f, 0.0f));
+	m_offset = m_offset.Scale(Vector3f(0.5f, 0.5f, 1.0f));
 }
 
 void ShadowBox::Update(const Camera &camera, const Vector3f &lightDirection, const float &shadowOffset, const float &shadowDistance)
+{
+	Update(camera, lightDirection, shadowOffset, camera.GetNearPlane(), shadowDistance);
+}
+
+void ShadowBox::Update(const Camera &camera, const Vector3f &lightDirection, const float &shadowOffset, const float &nearDistance, const float &farDistance,
+	const float &padding)
 {
 	m_lightDirection = lightDirection;
 	m_shadowOffset = shadowOffset;
-	m_shadowDistance = shadowDistance;
+	m_nearDistance = nearDistance;
+	m_farDistance = farDistance;
+	m_padding = padding;
 
-	UpdateShadowBox(camera);
-	UpdateOrthoProjectionMatrix();
-	UpdateCenter();
+	UpdateFrustumCorners(camera);
 	UpdateLightViewMatrix();
+	UpdateShadowBox();
+	UpdateOrthoProjectionMatrix();
 	UpdateViewShadowMatrix();
 }
 
+bool ShadowBox::Contains(const ShadowBox &other) const
+{
+	for (const auto &corner : other.m_frustumCorners)
+	{
+		auto point = Vector3f(m_lightViewMatrix.Transform(Vector4f(corner)));
+
+		if (point.m_x < m_minExtents.m_x || point.m_y < m_minExtents.m_y || point.m_z < m_minExtents.m_z || point.m_x > m_maxExtents.m_x ||
+			point.m_y > m_maxExtents.m_y || point.m_z > m_maxExtents.m_z)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool ShadowBox::IsInBox(const Vector3f &position, const float &radius) const
 {
 	auto entityPos = m_lightViewMatrix.Transform(Vector4f(position));
@@ -48,91 +69,62 @@ bool ShadowBox::IsInBox(const Vector3f &position, const float &radius) const
 	return distanceSquared < radius * radius;
 }
 
-void ShadowBox::UpdateShadowBox(const Camera &camera)
+void ShadowBox::UpdateFrustumCorners(const Camera &camera)
 {
-	UpdateSizes(camera);
+	auto tanHeight = std::tan(0.5f * camera.GetFieldOfView() * Maths::DegToRad);
+	auto tanWidth = tanHeight * Graphics::Get()->GetDisplayAspectRatio();
+	auto invertedView = camera.GetViewMatrix().Inverse();
 
-	auto rotation = Matrix4();
-	rotation = rotation.Rotate(-camera.GetRotation().m_y * Maths::DegToRad, Vector3f::Up);
-	rotation = rotation.Rotate(-camera.GetRotation().m_x * Maths::DegToRad, Vector3f::Right);
+	uint32_t i = 0;
 
-	auto forwardVector = Vector3f(rotation.Transform(Vector4f(0.0f, 0.0f, -1.0f, 0.0f)));
-
-	auto toFar = forwardVector * m_shadowDistance;
-	auto toNear = forwardVector * camera.GetNearPlane();
-	auto centreNear = toNear + camera.GetPosition();
-	auto centreFar = toFar + camera.GetPosition();
-
-	auto points = CalculateFrustumVertices(rotation, forwardVector, centreNear, centreFar);
+	for (const auto &distance : { m_nearDistance, m_farDistance })
+	{
+		for (const auto &y : { -1.0f, 1.0f })
+		{
+			for (const auto &x : { -1.0f, 1.0f })
+			{
+				auto corner = Vector4f(x * tanWidth * distance, y * tanHeight * distance, -distance, 1.0f);
+				m_frustumCorners[i++] = Vector3f(invertedView.Transform(corner));
+			}
+		}
+	}
+}
 
+void ShadowBox::UpdateShadowBox()
+{
 	m_minExtents = Vector3f::PositiveInfinity;
 	m_maxExtents = Vector3f::NegativeInfinity;
 
-	for (uint32_t i = 0; i < points.size(); i++)
+	for (const auto &corner : m_frustumCorners)
 	{
-		auto point = Vector3f(points[i]);
+		auto point = Vector3f(m_lightViewMatrix.Transform(Vector4f(corner)));
 		m_minExtents = m_minExtents.Min(point);
-		m_maxExtents = m_minExtents.Max(point);
+		m_maxExtents = m_maxExtents.Max(point);
 	}
 
+	m_minExtents -= Vector3f(m_padding);
+	m_maxExtents += Vector3f(m_padding);
 	m_maxExtents.m_z += m_shadowOffset;
-}
-
-void ShadowBox::UpdateSizes(const Camera &camera)
-{
-	m_farWidth = m_shadowDistance * std::tan(camera.GetFieldOfView() * Maths::DegToRad);
-	m_nearWidth = camera.GetNearPlane() * std::tan(camera.GetFieldOfView() * Maths::DegToRad);
-	m_farHeight = m_farWidth / Window::Get()->GetAspectRatio();
-	m_nearHeight = m_nearWidth / Window::Get()->GetAspectRatio();
-}
 
-std::array<Vector4f, 8> ShadowBox::CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar)
-{
-	auto upVector = Vector3f(rotation.Transform(Vector4f(0.0f, 1.0f, 0.0f, 0.0f)));
-	auto rightVector = forwardVector.Cross(upVector);
-	auto downVector = -upVector;
-	auto leftVector = -rightVector;
-
-	auto farTop = centreFar + (upVector * m_farHeight);
-	auto farBottom = centreFar + (downVector * m_farHeight);
-	auto nearTop = centreNear + (upVector * m_nearHeight);
-	auto nearBottom = centreNear + (downVector * m_nearHeight);
-
-	auto points = std::array<Vector4f, 8>();
-	points[0] = CalculateLightSpaceFrustumCorner(farTop, rightVector, m_farWidth);
-	points[1] = CalculateLightSpaceFrustumCorner(farTop, leftVector, m_farWidth);
-	points[2] = CalculateLightSpaceFrustumCorner(farBottom, rightVector, m_farWidth);
-	points[3] = CalculateLightSpaceFrustumCorner(farBottom, leftVector, m_farWidth);
-	points[4] = CalculateLightSpaceFrustumCorner(nearTop, rightVector, m_nearWidth);
-	points[5] = CalculateLightSpaceFrustumCorner(nearTop, leftVector, m_nearWidth);
-	points[6] = CalculateLightSpaceFrustumCorner(nearBottom, rightVector, m_nearWidth);
-	points[7] = CalculateLightSpaceFrustumCorner(nearBottom, leftVector, m_nearWidth);
-	return points;
-}
-
-Vector4f ShadowBox::CalculateLightSpaceFrustumCorner(const Vector3f &startPoint, const Vector3f &direction, const float &width) const
-{
-	auto point = Vector4f(startPoint + (direction * width));
-	point = m_lightViewMatrix.Transform(point);
-	return point;
+	// Moves the light view to the centre of the box, so the box is symmetric around the lights origin.
+	auto centre = (m_minExtents + m_maxExtents) / 2.0f;
+	m_centre = Vector3f(m_lightViewMatrix.Inverse().Transform(Vector4f(centre)));
+	m_lightViewMatrix = m_lightViewMatrix.Translate(-m_centre);
+	m_minExtents -= centre;
+	m_maxExtents -= centre;
 }
 
 void ShadowBox::UpdateOrthoProjectionMatrix()
 {
+	// Maps the box into Vulkan clip space, the side facing the light is at a depth of zero.
 	m_projectionMatrix = Matrix4::Identity;
 	m_projectionMatrix[0][0] = 2.0f / GetWidth();
 	m_projectionMatrix[1][1] = 2.0f / GetHeight();
-	m_projectionMatrix[2][2] = -2.0f / GetDepth();
+	m_projectionMatrix[2][2] = -1.0f / GetDepth();
+	m_projectionMatrix[3][2] = 0.5f;
 	m_projectionMatrix[3][3] = 1.0f;
 }
 
-void ShadowBox::UpdateCenter()
-{
-	auto centre = Vector4f((m_minExtents + m_maxExtents) / 2.0f);
-	auto invertedLight = m_lightViewMatrix.Inverse();
-	m_centre = Vector3f(invertedLight.Transform(centre));
-}
-
 void ShadowBox::UpdateLightViewMatrix()
 {
 	m_lightViewMatrix = Matrix4::Identity;
@@ -146,7 +138,6 @@ void ShadowBox::UpdateLightViewMatrix()
 	}
 
 	m_lightViewMatrix = m_lightViewMatrix.Rotate(-yaw, Vector3f::Up);
-	m_lightViewMatrix = m_lightViewMatrix.Translate(m_centre);
 }
 
 void ShadowBox::UpdateViewShadowMatrix()
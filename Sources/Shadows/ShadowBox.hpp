@@ -30,6 +30,25 @@ public:
 	 */
 	void Update(const Camera &camera, const Vector3f &lightDirection, const float &shadowOffset, const float &shadowDistance);
 
+	/**
+	 * Updates the bounds of the shadow box to cover a slice of the camera's view frustum, used for one cascade of a cascaded shadow map.
+	 * @param camera The camera object to be used when calculating the shadow boxes size.
+	 * @param lightDirection The lights direction.
+	 * @param shadowOffset The shadows offset.
+	 * @param nearDistance The distance from the camera the slice starts at.
+	 * @param farDistance The distance from the camera the slice ends at.
+	 * @param padding The distance the box is grown by on each side, so the box still covers the slice after the camera moves a little.
+	 */
+	void Update(const Camera &camera, const Vector3f &lightDirection, const float &shadowOffset, const float &nearDistance, const float &farDistance,
+		const float &padding = 0.0f);
+
+	/**
+	 * Tests if the slice of the view frustum another box was fitted to is entirely inside of this box.
+	 * @param other The other shadow box, it must have been updated with the same light direction.
+	 * @return If the other boxes slice is covered by this box.
+	 */
+	bool Contains(const ShadowBox &other) const;
+
 	/**
 	 * Tests if a bounding sphere intersects the shadow box. Can be used to decide which engine.entities should be rendered in the shadow render pass.
 	 * @param position The centre of the bounding sphere in world space.
@@ -63,47 +82,28 @@ public:
 	float GetDepth() const { return m_maxExtents.m_z - m_minExtents.m_z; }
 
 private:
-	void UpdateShadowBox(const Camera &camera);
-
 	/**
-	 * Updates the widths and heights of the box panes.
+	 * Calculates the vertex of each corner of the camera's view frustum slice in world space.
 	 * @param camera The camera object.
 	 */
-	void UpdateSizes(const Camera &camera);
-
-	/**
-	 * Calculates the vertex of each corner of the view frustum in light space.
-	 * @param rotation The cameras rotation.
-	 * @param forwardVector The direction that the camera is aiming, and thus the direction of the frustum.
-	 * @param centreNear The centre point of the frustum's near plane.
-	 * @param centreFar The centre point of the frustum's far plane.
-	 * @return The vertices of the frustum in light space.
-	 */
-	std::array<Vector4f, 8> CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar);
+	void UpdateFrustumCorners(const Camera &camera);
 
 	/**
-	 * Calculates one of the corner vertices of the view frustum in world space and converts it to light space.
-	 * @param startPoint The starting centre point on the view frustum.
-	 * @param direction The direction of the corner from the start point.
-	 * @param width The distance of the corner from the start point.
-	 * @return The relevant corner vertex of the view frustum in light space.
+	 * Finds the extents of the frustum slice in light space, and moves the centre of the light view to the centre of the box.
 	 */
-	Vector4f CalculateLightSpaceFrustumCorner(const Vector3f &startPoint, const Vector3f &direction, const float &width) const;
+	void UpdateShadowBox();
 
 	void UpdateOrthoProjectionMatrix();
 
-	/**
-	 * Updates the centre of the shadow box (orthographic projection area).
-	 */
-	void UpdateCenter();
-
 	void UpdateLightViewMatrix();
 
 	void UpdateViewShadowMatrix();
 
 	Vector3f m_lightDirection;
 	float m_shadowOffset;
-	float m_shadowDistance;
+	float m_nearDistance;
+	float m_farDistance;
+	float m_padding;
 
 	Matrix4 m_projectionMatrix;
 	Matrix4 m_lightViewMatrix;
@@ -112,8 +112,7 @@ private:
 	Matrix4 m_offset;
 	Vector3f m_centre;
 
-	float m_farHeight, m_farWidth;
-	float m_nearHeight, m_nearWidth;
+	std::array<Vector3f, 8> m_frustumCorners;
 
 	Vector3f m_minExtents;
 	Vector3f m_maxExtents;
@@ -1,28 +1,82 @@
 #include "ShadowRender.hpp"
 
 #include "Meshes/Mesh.hpp"
+#include "Meshes/MeshRender.hpp"
 #include "Scenes/Entity.hpp"
 #include "Shadows.hpp"
 
 namespace acid
 {
-ShadowRender::ShadowRender()
+ShadowRender::ShadowRender(const bool &isStatic) :
+	m_static(isStatic),
+	m_lastRadius(0.0f)
 {
 }
 
+ShadowRender::~ShadowRender()
+{
+	// The shadows module may already be gone when the engine is shutting down.
+	if (Shadows::Get() == nullptr)
+	{
+		return;
+	}
+
+	if (m_static)
+	{
+		Shadows::Get()->SetStaticDirty();
+	}
+
+	if (m_lastRadius > 0.0f)
+	{
+		Shadows::Get()->SetLocalDirty(m_lastPosition, m_lastRadius);
+	}
+}
+
 void ShadowRender::Start()
 {
+	m_lastWorldMatrix = GetParent()->GetWorldMatrix();
+	SetLocalDirty();
+
+	if (m_static)
+	{
+		Shadows::Get()->SetStaticDirty();
+	}
 }
 
 void ShadowRender::Update()
 {
+	auto worldMatrix = GetParent()->GetWorldMatrix();
+
+	if (worldMatrix == m_lastWorldMatrix)
+	{
+		return;
+	}
+
+	m_lastWorldMatrix = worldMatrix;
+	SetLocalDirty();
+
+	if (m_static)
+	{
+		Shadows::Get()->SetStaticDirty();
+	}
+}
+
+bool ShadowRender::IsInBox(const ShadowBox &shadowBox) const
+{
+	Vector3f position;
+	float radius;
+	return GetBounds(position, radius) && shadowBox.IsInBox(position, radius);
 }
 
-bool ShadowRender::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline)
+bool ShadowRender::IsInSphere(const Vector3f &position, const float &radius) const
 {
-	// Update push constants.
-	m_pushObject.Push("mvp", Shadows::Get()->GetShadowBox().GetProjectionViewMatrix() * GetParent()->GetWorldMatrix());
+	Vector3f boundsPosition;
+	float boundsRadius;
+	return GetBounds(boundsPosition, boundsRadius) && boundsPosition.Distance(position) <= boundsRadius + radius;
+}
 
+bool ShadowRender::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, const Matrix4 &projectionView)
+{
 	// Gets required components.
 	auto mesh = GetParent()->GetComponent<Mesh>();
 
@@ -31,6 +85,17 @@ bool ShadowRender::CmdRender(const CommandBuffer &commandBuffer, const PipelineG
 		return false;
 	}
 
+	// Update push constants, quantized positions are rebuilt by the same matrix.
+	auto &model = *mesh->GetModel();
+	auto mvp = projectionView * GetParent()->GetWorldMatrix();
+
+	if (model.IsQuantized())
+	{
+		mvp = mvp.Translate(model.GetQuantizeOffset()).Scale(model.GetQuantizeScale());
+	}
+
+	m_pushObject.Push("mvp", mvp);
+
 	// Updates descriptors.
 	m_descriptorSet.Push("PushObject", m_pushObject);
 	bool updateSuccess = m_descriptorSet.Update(pipeline);
@@ -43,16 +108,63 @@ bool ShadowRender::CmdRender(const CommandBuffer &commandBuffer, const PipelineG
 	// Draws the object.
 	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
 	m_pushObject.BindPush(commandBuffer, pipeline);
-	return mesh->GetModel()->CmdRender(commandBuffer);
+
+	// Shadows are drawn with the level of detail the mesh is drawn with, without the fade.
+	auto meshRender = GetParent()->GetComponent<MeshRender>();
+	return model.CmdRender(commandBuffer, 1, meshRender != nullptr ? meshRender->GetLod() : 0);
+}
+
+bool ShadowRender::GetBounds(Vector3f &position, float &radius) const
+{
+	auto mesh = GetParent()->GetComponent<Mesh>();
+
+	if (mesh == nullptr || mesh->GetModel() == nullptr)
+	{
+		return false;
+	}
+
+	auto transform = GetParent()->GetWorldTransform();
+	auto scaling = transform.GetScaling();
+	position = transform.GetPosition();
+	radius = mesh->GetModel()->GetRadius() * std::max({ std::fabs(scaling.m_x), std::fabs(scaling.m_y), std::fabs(scaling.m_z) });
+	return true;
+}
+
+void ShadowRender::SetLocalDirty()
+{
+	if (m_lastRadius > 0.0f)
+	{
+		Shadows::Get()->SetLocalDirty(m_lastPosition, m_lastRadius);
+	}
+
+	if (GetBounds(m_lastPosition, m_lastRadius))
+	{
+		Shadows::Get()->SetLocalDirty(m_lastPosition, m_lastRadius);
+	}
+	else
+	{
+		m_lastRadius = 0.0f;
+	}
+}
+
+void ShadowRender::SetStatic(const bool &isStatic)
+{
+	if (m_static != isStatic)
+	{
+		m_static = isStatic;
+		Shadows::Get()->SetStaticDirty();
+	}
 }
 
 const Metadata &operator>>(const Metadata &metadata, ShadowRender &shadowRender)
 {
+	metadata.GetChild("Static", shadowRender.m_static);
 	return metadata;
 }
 
 Metadata &operator<<(Metadata &metadata, const ShadowRender &shadowRender)
 {
+	metadata.SetChild("Static", shadowRender.m_static);
 	return metadata;
 }
 }
@@ -8,26 +8,73 @@
 
 namespace acid
 {
+class ShadowBox;
+
 /**
  * @brief Component that is used to render a entity as a shadow.
+ * Static shadow renders are also drawn into the cached cascades, moving one causes the cached cascades to be re-rendered.
+ * Moving any shadow render re-renders the local shadows of the lights it is in range of.
  */
 class ACID_EXPORT ShadowRender :
 	public Component
 {
 public:
-	ShadowRender();
+	/**
+	 * Creates a new shadow render.
+	 * @param isStatic If the entity is not expected to move, static shadow renders are cached in the far cascades.
+	 */
+	explicit ShadowRender(const bool &isStatic = false);
+
+	~ShadowRender();
 
 	void Start() override;
 
 	void Update() override;
 
-	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline);
+	/**
+	 * Tests if the bounding sphere of the entities mesh intersects a shadow box.
+	 * @param shadowBox The shadow box to test against.
+	 * @return If the entity casts a shadow into the box.
+	 */
+	bool IsInBox(const ShadowBox &shadowBox) const;
+
+	/**
+	 * Tests if the bounding sphere of the entities mesh intersects a sphere, such as the range of a light.
+	 * @param position The centre of the sphere.
+	 * @param radius The radius of the sphere.
+	 * @return If the entity casts a shadow into the sphere.
+	 */
+	bool IsInSphere(const Vector3f &position, const float &radius) const;
+
+	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, const Matrix4 &projectionView);
+
+	const bool &IsStatic() const { return m_static; }
+
+	void SetStatic(const bool &isStatic);
 
 	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, ShadowRender &shadowRender);
 
 	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const ShadowRender &shadowRender);
 
 private:
+	/**
+	 * Gets the bounding sphere of the entities mesh.
+	 * @param position The centre of the sphere.
+	 * @param radius The radius of the sphere.
+	 * @return If the entity has a mesh.
+	 */
+	bool GetBounds(Vector3f &position, float &radius) const;
+
+	/**
+	 * Marks the local shadows around the entity to be re-rendered, the bounds from the last time are used so the shadow left behind is removed.
+	 */
+	void SetLocalDirty();
+
+	bool m_static;
+	Matrix4 m_lastWorldMatrix;
+	Vector3f m_lastPosition;
+	float m_lastRadius;
+
 	DescriptorsHandler m_descriptorSet;
 	PushHandler m_pushObject;
 };
@@ -1,9 +1,20 @@
 #include "Shadows.hpp"
 
+#include "Lights/Light.hpp"
+#include "Maths/Maths.hpp"
 #include "Scenes/Scenes.hpp"
+#include "Graphics/Graphics.hpp"
 
 namespace acid
 {
+// The cube faces a local shadow is rendered from, in the order of cube map layers, and the up vector of each face.
+static const std::array<Vector3f, Shadows::LocalFaceCount> FACE_DIRECTIONS = {
+	Vector3f(1.0f, 0.0f, 0.0f), Vector3f(-1.0f, 0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f), Vector3f(0.0f, -1.0f, 0.0f), Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, -1.0f)
+};
+static const std::array<Vector3f, Shadows::LocalFaceCount> FACE_UPS = {
+	Vector3f(0.0f, -1.0f, 0.0f), Vector3f(0.0f, -1.0f, 0.0f), Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, -1.0f), Vector3f(0.0f, -1.0f, 0.0f), Vector3f(0.0f, -1.0f, 0.0f)
+};
+
 Shadows::Shadows() :
 	m_lightDirection(0.5f, 0.0f, 0.5f),
 	m_shadowSize(4096),
@@ -12,15 +23,278 @@ Shadows::Shadows() :
 	m_shadowDarkness(0.6f),
 	m_shadowTransition(11.0f),
 	m_shadowBoxOffset(9.0f),
-	m_shadowBoxDistance(70.0f)
+	m_shadowBoxDistance(70.0f),
+	m_cascadeSplitLambda(0.75f),
+	m_cachedCascades(2),
+	m_cachePadding(10.0f),
+	m_cascadeSplits(),
+	m_cascadesDirty(),
+	m_staticDirty(true),
+	m_cascadeLevel(1),
+	m_cascadeTiles(),
+	m_localShadowScale(0.5f),
+	m_rayTraced(false)
 {
+	Reads<Scenes>();
+
+	for (auto &cascadeTile : m_cascadeTiles)
+	{
+		cascadeTile = *m_atlas.Allocate(m_cascadeLevel);
+	}
 }
 
 void Shadows::Update()
 {
-	if (Scenes::Get()->GetCamera() != nullptr)
+	auto camera = Scenes::Get()->GetCamera();
+
+	if (camera == nullptr)
+	{
+		return;
+	}
+
+	// A directional light selected to cast shadows shines from its position towards the origin, it replaces the set light direction.
+	for (const auto &caster : Scenes::Get()->GetScene()->GetLightSelection().GetShadowCasters())
+	{
+		auto position = caster->GetParent()->GetWorldTransform().GetPosition();
+
+		if (caster->GetRadius() <= 0.0f && position != Vector3f::Zero)
+		{
+			m_lightDirection = -position.Normalize();
+			break;
+		}
+	}
+
+	UpdateLocalShadows(*camera);
+
+	auto nearPlane = camera->GetNearPlane();
+	auto lightMoved = m_lightDirection != m_cachedLightDirection;
+	auto splitNear = nearPlane;
+
+	for (uint32_t i = 0; i < CascadeCount; i++)
+	{
+		// Blends between even and logarithmic splits, logarithmic splits keep the resolution of each cascade close to the resolution on screen.
+		auto fraction = static_cast<float>(i + 1) / static_cast<float>(CascadeCount);
+		auto uniformSplit = nearPlane + (m_shadowBoxDistance - nearPlane) * fraction;
+		auto logSplit = nearPlane * std::pow(m_shadowBoxDistance / nearPlane, fraction);
+		m_cascadeSplits[i] = Maths::Lerp(uniformSplit, logSplit, m_cascadeSplitLambda);
+
+		if (!IsCascadeCached(i))
+		{
+			m_cascades[i].Update(*camera, m_lightDirection, m_shadowBoxOffset, splitNear, m_cascadeSplits[i]);
+			m_cascadesDirty[i] = true;
+		}
+		else
+		{
+			// A cached cascade is padded, it is kept until the tightly fitted box of its slice leaves it.
+			ShadowBox fitted;
+			fitted.Update(*camera, m_lightDirection, m_shadowBoxOffset, splitNear, m_cascadeSplits[i]);
+
+			if (lightMoved || m_staticDirty || !m_cascades[i].Contains(fitted))
+			{
+				m_cascades[i].Update(*camera, m_lightDirection, m_shadowBoxOffset, splitNear, m_cascadeSplits[i], m_cachePadding);
+				m_cascadesDirty[i] = true;
+			}
+		}
+
+		splitNear = m_cascadeSplits[i];
+	}
+
+	m_cachedLightDirection = m_lightDirection;
+	m_staticDirty = false;
+}
+
+void Shadows::SetStaticDirty()
+{
+	m_staticDirty = true;
+}
+
+void Shadows::SetLocalDirty(const Vector3f &position, const float &radius)
+{
+	for (auto &localShadow : m_localShadows)
+	{
+		if (localShadow.m_position.Distance(position) <= localShadow.m_radius + radius)
+		{
+			localShadow.m_dirty = true;
+		}
+	}
+}
+
+bool Shadows::IsRayTraced() const
+{
+	return m_rayTraced && Graphics::Get()->GetLogicalDevice()->IsRayQuery();
+}
+
+Matrix4 Shadows::GetLocalShadowSpace(const LocalShadow &localShadow, const uint32_t &face) const
+{
+	auto tile = m_atlas.GetArea(localShadow.m_tiles[face]);
+	auto tileMatrix = Matrix4::Identity.Translate(Vector3f(tile.m_x, tile.m_y, 0.0f)).Scale(Vector3f(tile.m_z, tile.m_w, 1.0f));
+	auto offsetMatrix = Matrix4::Identity.Translate(Vector3f(0.5f, 0.5f, 0.0f)).Scale(Vector3f(0.5f, 0.5f, 1.0f));
+	return tileMatrix * offsetMatrix * localShadow.m_projectionViews[face];
+}
+
+Matrix4 Shadows::GetCascadeShadowSpace(const uint32_t &cascade) const
+{
+	auto tile = GetCascadeTile(cascade);
+	auto tileMatrix = Matrix4::Identity.Translate(Vector3f(tile.m_x, tile.m_y, 0.0f)).Scale(Vector3f(tile.m_z, tile.m_w, 1.0f));
+	return tileMatrix * m_cascades[cascade].GetToShadowMapSpaceMatrix();
+}
+
+void Shadows::UpdateLocalShadows(const Camera &camera)
+{
+	std::vector<const Light *> casters;
+	// Traced local shadows need no tiles, their tiles are given back and the cascades fill the atlas again.
+	auto rayTraced = IsRayTraced();
+
+	for (const auto &caster : Scenes::Get()->GetScene()->GetLightSelection().GetShadowCasters())
+	{
+		if (caster->GetRadius() > 0.0f && !rayTraced)
+		{
+			casters.emplace_back(caster);
+		}
+	}
+
+	// The cascades fill the atlas until there are local shadows, changing the layout re-renders every tile.
+	auto cascadeLevel = casters.empty() ? 1u : 2u;
+
+	if (cascadeLevel != m_cascadeLevel)
+	{
+		m_atlas.Clear();
+		m_localShadows.clear();
+		m_cascadeLevel = cascadeLevel;
+
+		for (auto &cascadeTile : m_cascadeTiles)
+		{
+			cascadeTile = *m_atlas.Allocate(m_cascadeLevel);
+		}
+
+		std::fill(m_cascadesDirty.begin(), m_cascadesDirty.end(), true);
+		m_staticDirty = true;
+	}
+
+	// Lights that are no longer selected give their tiles back before the selected lights are given tiles.
+	for (auto it = m_localShadows.begin(); it != m_localShadows.end();)
+	{
+		if (std::find(casters.begin(), casters.end(), it->m_light) == casters.end())
+		{
+			ReleaseLocalShadow(*it);
+			it = m_localShadows.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	auto cameraPosition = camera.GetPosition();
+	auto maxLevel = static_cast<float>(m_atlas.GetMaxLevel());
+
+	// Casters are ordered from the most important, so when the atlas is full the least important lights go without shadows.
+	for (const auto &caster : casters)
+	{
+		auto position = caster->GetParent()->GetWorldTransform().GetPosition();
+		auto radius = caster->GetRadius();
+
+		// A light covering the screen gets tiles of the local shadow scale, each halving of the screen it covers is one level deeper.
+		auto coverage = radius / std::max(cameraPosition.Distance(position), radius);
+		auto level = std::clamp(-std::log2(std::max(coverage * m_localShadowScale, 1e-6f)), static_cast<float>(m_cascadeLevel), maxLevel);
+
+		auto it = std::find_if(m_localShadows.begin(), m_localShadows.end(), [caster](const LocalShadow &localShadow)
+		{
+			return localShadow.m_light == caster;
+		});
+
+		if (it == m_localShadows.end())
+		{
+			LocalShadow localShadow;
+			localShadow.m_light = caster;
+
+			if (!AllocateLocalShadow(localShadow, static_cast<uint32_t>(std::round(level))))
+			{
+				continue;
+			}
+
+			it = m_localShadows.emplace(m_localShadows.end(), localShadow);
+		}
+		else if (std::abs(level - static_cast<float>(it->m_level)) >= 1.0f)
+		{
+			// Tiles are only resized once the wanted size is a whole level away, so a light between two sizes is not re-rendered every frame.
+			auto tiles = it->m_tiles;
+			ReleaseLocalShadow(*it);
+
+			if (!AllocateLocalShadow(*it, static_cast<uint32_t>(std::round(level))))
+			{
+				m_localShadows.erase(it);
+				continue;
+			}
+
+			// A full atlas can give back the same tiles, which still hold the lights shadow.
+			if (it->m_tiles != tiles)
+			{
+				it->m_dirty = true;
+			}
+		}
+
+		if (it->m_position == position && it->m_radius == radius && !it->m_dirty)
+		{
+			continue;
+		}
+
+		it->m_position = position;
+		it->m_radius = radius;
+		it->m_dirty = true;
+
+		auto projection = Matrix4::PerspectiveMatrix(90.0f * Maths::DegToRad, 1.0f, std::max(0.001f * radius, 0.01f), radius);
+
+		for (uint32_t i = 0; i < LocalFaceCount; i++)
+		{
+			it->m_projectionViews[i] = projection * Matrix4::LookAt(position, position + FACE_DIRECTIONS[i], FACE_UPS[i]);
+		}
+	}
+
+	if (auto profiler = Profiler::Get(); profiler != nullptr && profiler->IsEnabled())
+	{
+		profiler->SetCounter("Local Shadows", static_cast<double>(m_localShadows.size()));
+		profiler->SetCounter("Shadow Atlas Usage", static_cast<double>(m_atlas.GetUsage()));
+	}
+}
+
+bool Shadows::AllocateLocalShadow(LocalShadow &localShadow, const uint32_t &level)
+{
+	for (auto tryLevel = level; tryLevel <= m_atlas.GetMaxLevel(); tryLevel++)
+	{
+		uint32_t allocated = 0;
+
+		for (; allocated < LocalFaceCount; allocated++)
+		{
+			auto tile = m_atlas.Allocate(tryLevel);
+
+			if (!tile)
+			{
+				break;
+			}
+
+			localShadow.m_tiles[allocated] = *tile;
+		}
+
+		if (allocated == LocalFaceCount)
+		{
+			localShadow.m_level = tryLevel;
+			return true;
+		}
+
+		for (uint32_t i = 0; i < allocated; i++)
+		{
+			m_atlas.Release(localShadow.m_tiles[i]);
+		}
+	}
+
+	return false;
+}
+
+void Shadows::ReleaseLocalShadow(const LocalShadow &localShadow)
+{
+	for (const auto &tile : localShadow.m_tiles)
 	{
-		m_shadowBox.Update(*Scenes::Get()->GetCamera(), m_lightDirection, m_shadowBoxOffset, m_shadowBoxDistance);
+		m_atlas.Release(tile);
 	}
 }
 }
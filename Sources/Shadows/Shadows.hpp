@@ -2,17 +2,45 @@
 
 #include "Engine/Engine.hpp"
 #include "Maths/Vector3.hpp"
+#include "ShadowAtlas.hpp"
 #include "ShadowBox.hpp"
 
 namespace acid
 {
+class Light;
+
 /**
- * @brief Module used for managing a shadow map.
+ * @brief Module used for managing a cascaded shadow map, the cascades are rendered into the tiles of a single atlas.
+ * The far cascades only contain static shadow renders and are cached, they are only re-rendered when the camera leaves their padded box, the light moves, or static geometry changes.
+ * Lights with a radius that are selected to cast shadows by {@link LightSelection} get six tiles from the atlas, one for each face of a cube around the light,
+ * sized by how much of the screen the light covers. Their tiles are kept until the light moves or a shadow render in its range moves, is added or is removed.
+ * While there are local shadows the cascades are drawn into a quarter of the atlas.
+ * On devices with ray queries the local shadows can instead be traced by the deferred lighting pass, then no tiles are rendered for lights with a radius.
  */
 class ACID_EXPORT Shadows :
 	public Module
 {
 public:
+	static constexpr uint32_t CascadeCount = 4;
+	static_assert(CascadeCount <= 4, "The cascades are allocated from a single level of the atlas");
+	static constexpr uint32_t LocalFaceCount = 6;
+
+	/**
+	 * @brief The shadow of a light with a radius, rendered into a tile of the atlas for each face of a cube around the light.
+	 */
+	class LocalShadow
+	{
+	public:
+		const Light *m_light = nullptr;
+		Vector3f m_position;
+		float m_radius = 0.0f;
+		uint32_t m_level = 0;
+		std::array<uint32_t, LocalFaceCount> m_tiles = {};
+		std::array<Matrix4, LocalFaceCount> m_projectionViews;
+		/// If the tiles have to be rendered, the renderer clears this once every face has been fully rendered.
+		bool m_dirty = true;
+	};
+
 	/**
 	 * Gets the engines instance.
 	 * @return The current module instance.
@@ -25,8 +53,84 @@ public:
 
 	const Vector3f &GetLightDirection() const { return m_lightDirection; }
 
+	/**
+	 * Sets the direction the light shines in, replaced each update while a directional light is selected to cast shadows by {@link LightSelection}.
+	 * @param lightDirection The light direction.
+	 */
 	void SetLightDirection(const Vector3f &lightDirection) { m_lightDirection = lightDirection; }
 
+	const float &GetCascadeSplitLambda() const { return m_cascadeSplitLambda; }
+
+	/**
+	 * Sets how the cascades splits are placed, zero splits the distance evenly and one splits it logarithmically.
+	 * @param cascadeSplitLambda The blend between even and logarithmic splits.
+	 */
+	void SetCascadeSplitLambda(const float &cascadeSplitLambda) { m_cascadeSplitLambda = cascadeSplitLambda; }
+
+	const uint32_t &GetCachedCascades() const { return m_cachedCascades; }
+
+	/**
+	 * Sets how many of the furthest cascades are cached and only contain static shadow renders.
+	 * @param cachedCascades The number of cached cascades.
+	 */
+	void SetCachedCascades(const uint32_t &cachedCascades) { m_cachedCascades = std::min(cachedCascades, CascadeCount); }
+
+	const float &GetCachePadding() const { return m_cachePadding; }
+
+	void SetCachePadding(const float &cachePadding) { m_cachePadding = cachePadding; }
+
+	/**
+	 * Marks every cached cascade to be re-rendered, this is called when a static shadow render is added, removed, or moved.
+	 */
+	void SetStaticDirty();
+
+	/**
+	 * Marks the local shadows of the lights reaching a sphere to be re-rendered, this is called when a shadow render is added, removed, or moved.
+	 * @param position The centre of the sphere.
+	 * @param radius The radius of the sphere.
+	 */
+	void SetLocalDirty(const Vector3f &position, const float &radius);
+
+	const float &GetLocalShadowScale() const { return m_localShadowScale; }
+
+	/**
+	 * Sets the size of the tiles of a light covering the whole screen, as a fraction of the atlas size, tiles of further lights are smaller.
+	 * @param localShadowScale The tile size of a light covering the screen.
+	 */
+	void SetLocalShadowScale(const float &localShadowScale) { m_localShadowScale = localShadowScale; }
+
+	/**
+	 * Gets if the shadows of lights with a radius are traced with ray queries, this is only the case on devices that support them.
+	 * @return If local shadows are ray traced.
+	 */
+	bool IsRayTraced() const;
+
+	/**
+	 * Sets if the shadows of lights with a radius are traced with ray queries, instead of being rendered into tiles of the atlas.
+	 * The deferred lighting pass then traces a shadow ray to every light with a radius, against the meshes of the shadow renders.
+	 * @param rayTraced If local shadows are ray traced when the device supports it.
+	 */
+	void SetRayTraced(const bool &rayTraced) { m_rayTraced = rayTraced; }
+
+	const std::vector<LocalShadow> &GetLocalShadows() const { return m_localShadows; }
+
+	/**
+	 * Sets if a local shadow has to be rendered, the renderer clears this once every face has been fully rendered.
+	 * @param index The index of the local shadow.
+	 * @param dirty If the local shadow is dirty.
+	 */
+	void SetLocalShadowDirty(const std::size_t &index, const bool &dirty) { m_localShadows[index].m_dirty = dirty; }
+
+	/**
+	 * Gets the matrix that converts world space into a face tile of a local shadow.
+	 * @param localShadow The local shadow.
+	 * @param face The cube face.
+	 * @return The to-shadow-atlas-space matrix.
+	 */
+	Matrix4 GetLocalShadowSpace(const LocalShadow &localShadow, const uint32_t &face) const;
+
+	const ShadowAtlas &GetAtlas() const { return m_atlas; }
+
 	const uint32_t &GetShadowSize() const { return m_shadowSize; }
 
 	void SetShadowSize(const uint32_t &shadowSize) { m_shadowSize = shadowSize; }
@@ -56,12 +160,72 @@ public:
 	void SetShadowBoxDistance(const float &shadowBoxDistance) { m_shadowBoxDistance = shadowBoxDistance; }
 
 	/**
-	 * Get the shadow box, so that it can be used by other class to test if engine.entities are inside the box.
+	 * Get the shadow box of the nearest cascade, so that it can be used by other class to test if engine.entities are inside the box.
 	 * @return The shadow box.
 	 */
-	const ShadowBox &GetShadowBox() const { return m_shadowBox; }
+	const ShadowBox &GetShadowBox() const { return m_cascades[0]; }
+
+	const ShadowBox &GetCascade(const uint32_t &cascade) const { return m_cascades[cascade]; }
+
+	/**
+	 * Gets the distance from the camera each cascade ends at.
+	 * @param cascade The cascade index.
+	 * @return The far distance of the cascade.
+	 */
+	const float &GetCascadeSplit(const uint32_t &cascade) const { return m_cascadeSplits[cascade]; }
+
+	/**
+	 * Gets if a cascade is cached, cached cascades only contain static shadow renders.
+	 * @param cascade The cascade index.
+	 * @return If the cascade is cached.
+	 */
+	bool IsCascadeCached(const uint32_t &cascade) const { return cascade >= CascadeCount - m_cachedCascades; }
+
+	/**
+	 * Gets if a cascade has to be rendered this frame, cascades that are not cached are always dirty.
+	 * @param cascade The cascade index.
+	 * @return If the cascade is dirty.
+	 */
+	bool IsCascadeDirty(const uint32_t &cascade) const { return m_cascadesDirty[cascade]; }
+
+	/**
+	 * Sets if a cascade has to be rendered, the renderer clears this once a cascade has been fully rendered.
+	 * @param cascade The cascade index.
+	 * @param dirty If the cascade is dirty.
+	 */
+	void SetCascadeDirty(const uint32_t &cascade, const bool &dirty) { m_cascadesDirty[cascade] = dirty; }
+
+	/**
+	 * Gets the area of the shadow atlas a cascade is rendered into, in the range of zero to one.
+	 * @param cascade The cascade index.
+	 * @return The offset (xy) and size (zw) of the cascades tile.
+	 */
+	Vector4f GetCascadeTile(const uint32_t &cascade) const { return m_atlas.GetArea(m_cascadeTiles[cascade]); }
+
+	/**
+	 * Gets the matrix that converts world space into the cascades tile of the shadow atlas.
+	 * @param cascade The cascade index.
+	 * @return The to-shadow-atlas-space matrix.
+	 */
+	Matrix4 GetCascadeShadowSpace(const uint32_t &cascade) const;
 
 private:
+	/**
+	 * Allocates atlas tiles for the lights with a radius selected to cast shadows, and updates the cube face matrices of lights that moved.
+	 * @param camera The camera the size of each lights tiles is chosen for.
+	 */
+	void UpdateLocalShadows(const Camera &camera);
+
+	/**
+	 * Allocates the tiles of a local shadow, at the level or any deeper level that fits.
+	 * @param localShadow The local shadow.
+	 * @param level The preferred level.
+	 * @return If the tiles were allocated.
+	 */
+	bool AllocateLocalShadow(LocalShadow &localShadow, const uint32_t &level);
+
+	void ReleaseLocalShadow(const LocalShadow &localShadow);
+
 	Vector3f m_lightDirection;
 
 	uint32_t m_shadowSize;
@@ -73,6 +237,21 @@ private:
 	float m_shadowBoxOffset;
 	float m_shadowBoxDistance;
 
-	ShadowBox m_shadowBox;
+	float m_cascadeSplitLambda;
+	uint32_t m_cachedCascades;
+	float m_cachePadding;
+
+	std::array<ShadowBox, CascadeCount> m_cascades;
+	std::array<float, CascadeCount> m_cascadeSplits;
+	std::array<bool, CascadeCount> m_cascadesDirty;
+	Vector3f m_cachedLightDirection;
+	bool m_staticDirty;
+
+	ShadowAtlas m_atlas;
+	uint32_t m_cascadeLevel;
+	std::array<uint32_t, CascadeCount> m_cascadeTiles;
+	float m_localShadowScale;
+	std::vector<LocalShadow> m_localShadows;
+	bool m_rayTraced;
 };
 }
@@ -1,6 +1,10 @@
 #include "SubrenderShadows.hpp"
 
+#include "Graphics/Graphics.hpp"
+#include "Meshes/Mesh.hpp"
 #include "Models/VertexDefault.hpp"
+#include "Models/VertexQuantized.hpp"
+#include "Scenes/Entity.hpp"
 #include "Scenes/Scenes.hpp"
 #include "ShadowRender.hpp"
 #include "Shadows.hpp"
@@ -10,22 +14,166 @@ namespace acid
 SubrenderShadows::SubrenderShadows(const Pipeline::Stage &pipelineStage) :
 	Subrender(pipelineStage),
 	m_pipeline(pipelineStage, { "Shaders/Shadows/Shadow.vert", "Shaders/Shadows/Shadow.frag" }, { VertexDefault::GetVertexInput() }, GetDefines(), PipelineGraphics::Mode::Polygon,
-		PipelineGraphics::Depth::None, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT)
+		PipelineGraphics::Depth::None, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT),
+	m_pipelineQuantized(pipelineStage, { "Shaders/Shadows/Shadow.vert", "Shaders/Shadows/Shadow.frag" }, { VertexQuantized::GetVertexInput() }, GetDefines(),
+		PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::None, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT),
+	m_boundPipeline(nullptr),
+	m_lastAtlas(nullptr)
 {
 }
 
 void SubrenderShadows::Render(const CommandBuffer &commandBuffer)
 {
-	auto camera = Scenes::Get()->GetCamera();
+	auto shadows = Shadows::Get();
+	auto atlasKept = IsAtlasKept();
+	auto extent = Graphics::Get()->GetRenderStage(GetStage().first)->GetRenderArea().GetExtent();
 
 	m_pipeline.BindPipeline(commandBuffer);
+	m_boundPipeline = &m_pipeline;
 
-	auto sceneShadowRenders = Scenes::Get()->GetStructure()->QueryComponents<ShadowRender>();
+	auto sceneShadowRenders = Scenes::Get()->GetStructure()->ViewComponents<ShadowRender>();
 
-	for (const auto &shadowRender : sceneShadowRenders)
+	for (uint32_t i = 0; i < Shadows::CascadeCount; i++)
 	{
-		shadowRender->CmdRender(commandBuffer, m_pipeline);
+		auto cached = shadows->IsCascadeCached(i);
+
+		if (cached && atlasKept && !shadows->IsCascadeDirty(i))
+		{
+			continue;
+		}
+
+		auto &shadowBox = shadows->GetCascade(i);
+		BeginTile(commandBuffer, extent, shadows->GetCascadeTile(i));
+
+		auto complete = true;
+
+		for (const auto &shadowRender : sceneShadowRenders)
+		{
+			// Dynamic shadow renders would leave trails in a cached cascade.
+			if (cached && !shadowRender->IsStatic())
+			{
+				continue;
+			}
+
+			if (!shadowRender->IsInBox(shadowBox))
+			{
+				continue;
+			}
+
+			if (!shadowRender->CmdRender(commandBuffer, BindPipeline(commandBuffer, *shadowRender), shadowBox.GetProjectionViewMatrix()))
+			{
+				complete = false;
+			}
+		}
+
+		// A shadow render that could not be drawn yet, such as one with descriptors still being created, has the cascade drawn again next frame.
+		shadows->SetCascadeDirty(i, !complete);
+	}
+
+	// Local shadows hold static and dynamic shadow renders, they are dirtied by any shadow render in range moving.
+	auto &localShadows = shadows->GetLocalShadows();
+
+	for (std::size_t i = 0; i < localShadows.size(); i++)
+	{
+		auto &localShadow = localShadows[i];
+
+		if (atlasKept && !localShadow.m_dirty)
+		{
+			continue;
+		}
+
+		auto complete = true;
+
+		for (uint32_t face = 0; face < Shadows::LocalFaceCount; face++)
+		{
+			BeginTile(commandBuffer, extent, shadows->GetAtlas().GetArea(localShadow.m_tiles[face]));
+
+			for (const auto &shadowRender : sceneShadowRenders)
+			{
+				if (!shadowRender->IsInSphere(localShadow.m_position, localShadow.m_radius))
+				{
+					continue;
+				}
+
+				if (!shadowRender->CmdRender(commandBuffer, BindPipeline(commandBuffer, *shadowRender), localShadow.m_projectionViews[face]))
+				{
+					complete = false;
+				}
+			}
+		}
+
+		shadows->SetLocalShadowDirty(i, !complete);
+	}
+
+	// Restores the full render area for any subrenders after this one.
+	VkViewport viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(extent.m_x);
+	viewport.height = static_cast<float>(extent.m_y);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor = {};
+	scissor.offset = { 0, 0 };
+	scissor.extent = { extent.m_x, extent.m_y };
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+void SubrenderShadows::BeginTile(const CommandBuffer &commandBuffer, const Vector2ui &extent, const Vector4f &tile)
+{
+	VkRect2D tileArea = {};
+	tileArea.offset = { static_cast<int32_t>(tile.m_x * extent.m_x), static_cast<int32_t>(tile.m_y * extent.m_y) };
+	tileArea.extent = { static_cast<uint32_t>(tile.m_z * extent.m_x), static_cast<uint32_t>(tile.m_w * extent.m_y) };
+
+	VkViewport viewport = {};
+	viewport.x = static_cast<float>(tileArea.offset.x);
+	viewport.y = static_cast<float>(tileArea.offset.y);
+	viewport.width = static_cast<float>(tileArea.extent.width);
+	viewport.height = static_cast<float>(tileArea.extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &tileArea);
+
+	// A preserved atlas is not cleared by the renderpass, so each tile is cleared before it is redrawn.
+	VkClearAttachment clearAttachment = {};
+	clearAttachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	clearAttachment.colorAttachment = 0;
+	clearAttachment.clearValue.color = { { 0.0f, 0.0f, 0.0f, 0.0f } };
+
+	VkClearRect clearRect = {};
+	clearRect.rect = tileArea;
+	clearRect.baseArrayLayer = 0;
+	clearRect.layerCount = 1;
+	vkCmdClearAttachments(commandBuffer, 1, &clearAttachment, 1, &clearRect);
+}
+
+const PipelineGraphics &SubrenderShadows::BindPipeline(const CommandBuffer &commandBuffer, const ShadowRender &shadowRender)
+{
+	auto mesh = shadowRender.GetParent()->GetComponent<Mesh>();
+	auto &pipeline = mesh != nullptr && mesh->GetModel() != nullptr && mesh->GetModel()->IsQuantized() ? m_pipelineQuantized : m_pipeline;
+
+	if (&pipeline != m_boundPipeline)
+	{
+		pipeline.BindPipeline(commandBuffer);
+		m_boundPipeline = &pipeline;
 	}
+
+	return pipeline;
+}
+
+bool SubrenderShadows::IsAtlasKept()
+{
+	auto renderStage = Graphics::Get()->GetRenderStage(GetStage().first);
+	auto attachment = renderStage->GetAttachment("shadows");
+	auto atlas = Graphics::Get()->GetAttachment("shadows");
+
+	// The atlas is recreated along with the framebuffers, which loses every cached cascade.
+	auto kept = attachment && attachment->IsPreserved() && atlas == m_lastAtlas;
+	m_lastAtlas = atlas;
+	return kept;
 }
 
 std::vector<Shader::Define> SubrenderShadows::GetDefines()
@@ -1,11 +1,18 @@
 #pragma once
 
+#include "Maths/Vector4.hpp"
 #include "Graphics/Subrender.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
 
 namespace acid
 {
+class ShadowRender;
+
+/**
+ * @brief Renders each shadow cascade and each face of the local shadows into its tile of the "shadows" attachment.
+ * Cached cascades and local shadows are skipped until they are dirty, this only keeps their contents when the attachment is preserved between frames.
+ */
 class ACID_EXPORT SubrenderShadows :
 	public Subrender
 {
@@ -17,6 +24,32 @@ public:
 private:
 	std::vector<Shader::Define> GetDefines();
 
+	/**
+	 * Sets the viewport and scissor to a tile of the atlas and clears it.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param extent The size of the atlas.
+	 * @param tile The offset (xy) and size (zw) of the tile, in the range of zero to one.
+	 */
+	static void BeginTile(const CommandBuffer &commandBuffer, const Vector2ui &extent, const Vector4f &tile);
+
+	/**
+	 * Binds the pipeline a shadow render is drawn with, if it is not already bound.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param shadowRender The shadow render that will be drawn.
+	 * @return The bound pipeline.
+	 */
+	const PipelineGraphics &BindPipeline(const CommandBuffer &commandBuffer, const ShadowRender &shadowRender);
+
+	/**
+	 * Gets if the cached cascades from last frame are still in the shadow atlas.
+	 * @return If the cached cascades can be reused.
+	 */
+	bool IsAtlasKept();
+
 	PipelineGraphics m_pipeline;
+	// Draws models with quantized vertices, the scale and offset of their positions are part of the mvp.
+	PipelineGraphics m_pipelineQuantized;
+	const PipelineGraphics *m_boundPipeline;
+	const Descriptor *m_lastAtlas;
 };
 }
@@ -0,0 +1,89 @@
+#include "Histogram.hpp"
+
+namespace acid
+{
+Histogram::Histogram(const double &firstBound, const double &growth) :
+	m_firstBound(firstBound),
+	m_growth(growth)
+{
+	Reset();
+}
+
+void Histogram::Record(const double &value)
+{
+	std::size_t bucket = 0;
+
+	if (value > m_firstBound)
+	{
+		// The bucket is found from the logarithm of the value, rounded up so values on a bound fall in the lower bucket.
+		auto index = std::ceil(std::log(value / m_firstBound) / std::log(m_growth));
+		bucket = static_cast<std::size_t>(std::min(index, static_cast<double>(BucketCount - 1)));
+	}
+
+	m_buckets[bucket]++;
+	m_count++;
+	m_sum += value;
+	m_min = m_count == 1 ? value : std::min(m_min, value);
+	m_max = m_count == 1 ? value : std::max(m_max, value);
+}
+
+void Histogram::Merge(const Histogram &other)
+{
+	if (other.m_count == 0)
+	{
+		return;
+	}
+
+	for (std::size_t i = 0; i < BucketCount; i++)
+	{
+		m_buckets[i] += other.m_buckets[i];
+	}
+
+	m_min = m_count == 0 ? other.m_min : std::min(m_min, other.m_min);
+	m_max = m_count == 0 ? other.m_max : std::max(m_max, other.m_max);
+	m_count += other.m_count;
+	m_sum += other.m_sum;
+}
+
+void Histogram::Reset()
+{
+	m_buckets.fill(0);
+	m_count = 0;
+	m_sum = 0.0;
+	m_min = 0.0;
+	m_max = 0.0;
+}
+
+double Histogram::GetBound(const std::size_t &bucket) const
+{
+	if (bucket + 1 >= BucketCount)
+	{
+		return std::numeric_limits<double>::infinity();
+	}
+
+	return m_firstBound * std::pow(m_growth, static_cast<double>(bucket));
+}
+
+double Histogram::GetQuantile(const double &quantile) const
+{
+	if (m_count == 0)
+	{
+		return 0.0;
+	}
+
+	auto rank = static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(m_count)));
+	uint64_t counted = 0;
+
+	for (std::size_t i = 0; i < BucketCount; i++)
+	{
+		counted += m_buckets[i];
+
+		if (counted >= rank && m_buckets[i] != 0)
+		{
+			return std::min(GetBound(i), m_max);
+		}
+	}
+
+	return m_max;
+}
+}
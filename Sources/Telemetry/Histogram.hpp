@@ -0,0 +1,73 @@
+#pragma once
+
+#include "StdAfx.hpp"
+
+namespace acid
+{
+/**
+ * @brief Counts values into a fixed number of buckets whose bounds grow geometrically, recording a value never allocates.
+ * The first bucket holds values up to the first bound, each following bucket holds values up to its bound times the growth, the last bucket holds everything larger.
+ */
+class ACID_EXPORT Histogram
+{
+public:
+	static constexpr std::size_t BucketCount = 24;
+
+	/**
+	 * Creates a empty histogram.
+	 * @param firstBound The upper bound of the first bucket.
+	 * @param growth The ratio between the bounds of neighbouring buckets.
+	 */
+	explicit Histogram(const double &firstBound = 1.0, const double &growth = 2.0);
+
+	void Record(const double &value);
+
+	/**
+	 * Adds the counts of a histogram with the same bounds.
+	 * @param other The histogram to add.
+	 */
+	void Merge(const Histogram &other);
+
+	/**
+	 * Clears the counts, the bounds are kept.
+	 */
+	void Reset();
+
+	/**
+	 * Gets the upper bound of a bucket.
+	 * @param bucket The bucket index.
+	 * @return The bound, infinity for the last bucket.
+	 */
+	double GetBound(const std::size_t &bucket) const;
+
+	/**
+	 * Estimates a quantile as the upper bound of the bucket it falls in, clamped to the largest value recorded.
+	 * @param quantile The quantile, between 0 and 1.
+	 * @return The estimated value, or zero if nothing was recorded.
+	 */
+	double GetQuantile(const double &quantile) const;
+
+	const double &GetFirstBound() const { return m_firstBound; }
+
+	const double &GetGrowth() const { return m_growth; }
+
+	const std::array<uint32_t, BucketCount> &GetBuckets() const { return m_buckets; }
+
+	const uint64_t &GetCount() const { return m_count; }
+
+	const double &GetSum() const { return m_sum; }
+
+	const double &GetMin() const { return m_min; }
+
+	const double &GetMax() const { return m_max; }
+
+private:
+	double m_firstBound;
+	double m_growth;
+	std::array<uint32_t, BucketCount> m_buckets;
+	uint64_t m_count;
+	double m_sum;
+	double m_min;
+	double m_max;
+};
+}
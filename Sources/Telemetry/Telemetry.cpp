@@ -0,0 +1,587 @@
+#include "Telemetry.hpp"
+
+#include "Helpers/String.hpp"
+#include "Network/Http/Http.hpp"
+#include "Network/Tcp/TcpListener.hpp"
+#include "Network/Tcp/TcpSocket.hpp"
+#include "Network/Udp/UdpSocket.hpp"
+#if !defined(ACID_BUILD_SERVER)
+#include "Graphics/Graphics.hpp"
+#endif
+
+namespace acid
+{
+static const uint32_t BATCH_MAGIC = 0x4143544d;
+static const uint8_t BATCH_VERSION = 1;
+// The longest the telemetry thread waits for Prometheus requests before checking for a flush.
+static const Time SERVE_INTERVAL = Time::Milliseconds(50);
+static const Time REQUEST_TIMEOUT = Time::Seconds(1.0f);
+static const Time POST_TIMEOUT = Time::Seconds(5.0f);
+
+Telemetry::Telemetry() :
+	m_sequence(0),
+	m_serving(false),
+	m_transport(Transport::None),
+	m_port(0),
+	m_collectorChanged(false),
+	m_failing(false),
+	m_sampleInterval(Time::Seconds(1.0f / 60.0f)),
+	m_flushInterval(Time::Seconds(10.0f)),
+	m_lastSample(Engine::GetTime()),
+	m_lastFlush(Engine::GetTime()),
+	m_lastBytesSent(0),
+	m_lastBytesReceived(0),
+	m_lastDatagramsSent(0),
+	m_lastDatagramsReceived(0),
+	m_flushRequested(false),
+	m_stop(false)
+{
+	m_frameTime = AddMetric("frame_time_ms", Kind::Histogram, 0.25, 1.5);
+	m_gpuTime = AddMetric("gpu_time_ms", Kind::Histogram, 0.25, 1.5);
+	m_fps = AddMetric("fps", Kind::Gauge);
+	m_ups = AddMetric("ups", Kind::Gauge);
+
+	for (std::size_t i = 0; i < m_memory.size(); i++)
+	{
+		m_memory[i] = AddMetric("memory_" + String::Lowercase(MemoryTracker::GetName(static_cast<MemoryTag>(i))) + "_bytes", Kind::Gauge);
+	}
+
+	m_gpuMemory = AddMetric("gpu_memory_bytes", Kind::Gauge);
+	m_bytesSent = AddMetric("udp_bytes_sent", Kind::Counter);
+	m_bytesReceived = AddMetric("udp_bytes_received", Kind::Counter);
+	m_datagramsSent = AddMetric("udp_datagrams_sent", Kind::Counter);
+	m_datagramsReceived = AddMetric("udp_datagrams_received", Kind::Counter);
+
+	auto traffic = UdpSocket::GetTraffic();
+	m_lastBytesSent = traffic.m_bytesSent;
+	m_lastBytesReceived = traffic.m_bytesReceived;
+	m_lastDatagramsSent = traffic.m_datagramsSent;
+	m_lastDatagramsReceived = traffic.m_datagramsReceived;
+
+	m_thread = std::thread(&Telemetry::Run, this);
+}
+
+Telemetry::~Telemetry()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+}
+
+void Telemetry::Update()
+{
+	auto now = Engine::GetTime();
+
+	if (now - m_lastSample >= m_sampleInterval)
+	{
+		m_lastSample = now;
+		Sample();
+	}
+
+	if (now - m_lastFlush >= m_flushInterval)
+	{
+		m_lastFlush = now;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_flushRequested = true;
+		}
+
+		m_condition.notify_all();
+	}
+}
+
+uint32_t Telemetry::AddMetric(const std::string &name, const Kind &kind, const double &firstBound, const double &growth)
+{
+	Metric metric;
+	metric.m_name = name;
+	metric.m_kind = kind;
+	metric.m_histogram = Histogram(firstBound, growth);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_metrics.emplace_back(std::move(metric));
+	return static_cast<uint32_t>(m_metrics.size() - 1);
+}
+
+void Telemetry::Record(const uint32_t &metric, const double &value)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto &recorded = m_metrics[metric];
+
+	switch (recorded.m_kind)
+	{
+	case Kind::Histogram:
+		recorded.m_histogram.Record(value);
+		break;
+	case Kind::Gauge:
+		recorded.m_value = value;
+		break;
+	case Kind::Counter:
+		recorded.m_value += value;
+		break;
+	}
+
+	recorded.m_recorded = true;
+}
+
+void Telemetry::SetCollector(const Transport &transport, const std::string &host, const uint16_t &port, const std::string &path)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_transport = transport;
+	m_host = host;
+	m_port = port;
+	m_path = path;
+	m_collectorChanged = true;
+}
+
+bool Telemetry::Listen(const uint16_t &port)
+{
+	auto listener = std::make_unique<TcpListener>();
+
+	if (listener->Listen(port) != Socket::Status::Done)
+	{
+		Log::Error("Telemetry could not listen on port %i\n", port);
+		return false;
+	}
+
+	listener->SetBlocking(false);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// The telemetry thread serves the listener without locking, so it is never replaced.
+		if (m_listener != nullptr)
+		{
+			Log::Error("Telemetry is already listening\n");
+			return false;
+		}
+
+		m_listener = std::move(listener);
+	}
+
+	m_condition.notify_all();
+	return true;
+}
+
+std::string Telemetry::GetPrometheusText() const
+{
+	std::ostringstream stream;
+	stream.precision(std::numeric_limits<double>::max_digits10);
+
+	std::lock_guard<std::mutex> lock(m_totalsMutex);
+
+	for (const auto &metric : m_totals)
+	{
+		auto name = "acid_" + metric.m_name;
+
+		switch (metric.m_kind)
+		{
+		case Kind::Histogram:
+		{
+			stream << "# TYPE " << name << " histogram\n";
+			uint64_t counted = 0;
+
+			// Prometheus buckets count every value up to their bound.
+			for (std::size_t i = 0; i < Histogram::BucketCount; i++)
+			{
+				counted += metric.m_histogram.GetBuckets()[i];
+				auto bound = metric.m_histogram.GetBound(i);
+				stream << name << "_bucket{le=\"";
+
+				if (std::isinf(bound))
+				{
+					stream << "+Inf";
+				}
+				else
+				{
+					stream << bound;
+				}
+
+				stream << "\"} " << counted << '\n';
+			}
+
+			stream << name << "_sum " << metric.m_histogram.GetSum() << '\n';
+			stream << name << "_count " << metric.m_histogram.GetCount() << '\n';
+			break;
+		}
+		case Kind::Gauge:
+			stream << "# TYPE " << name << " gauge\n";
+			stream << name << ' ' << metric.m_value << '\n';
+			break;
+		case Kind::Counter:
+			stream << "# TYPE " << name << "_total counter\n";
+			stream << name << "_total " << metric.m_value << '\n';
+			break;
+		}
+	}
+
+	return stream.str();
+}
+
+void Telemetry::Sample()
+{
+	auto engine = Engine::Get();
+	auto gpuTime = engine->GetProfiler()->IsEnabled() ? std::optional<Time>(engine->GetProfiler()->GetLastGpuTime()) : std::nullopt;
+	std::optional<uint64_t> gpuMemory;
+
+#if !defined(ACID_BUILD_SERVER)
+	if (engine->HasModule<Graphics>() && Graphics::Get()->GetMemoryAllocator() != nullptr)
+	{
+		gpuMemory = Graphics::Get()->GetMemoryAllocator()->GetStats().m_usedBytes;
+	}
+#endif
+
+	auto traffic = UdpSocket::GetTraffic();
+
+	// Recording through Record would lock for every metric.
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto record = [this](const uint32_t &metric, const double &value)
+	{
+		auto &recorded = m_metrics[metric];
+
+		if (recorded.m_kind == Kind::Histogram)
+		{
+			recorded.m_histogram.Record(value);
+		}
+		else if (recorded.m_kind == Kind::Gauge)
+		{
+			recorded.m_value = value;
+		}
+		else
+		{
+			recorded.m_value += value;
+		}
+
+		recorded.m_recorded = true;
+	};
+
+	record(m_frameTime, engine->GetDeltaRender().AsMilliseconds<double>());
+
+	if (gpuTime)
+	{
+		record(m_gpuTime, gpuTime->AsMilliseconds<double>());
+	}
+
+	record(m_fps, static_cast<double>(engine->GetFps()));
+	record(m_ups, static_cast<double>(engine->GetUps()));
+
+	for (std::size_t i = 0; i < m_memory.size(); i++)
+	{
+		record(m_memory[i], static_cast<double>(MemoryTracker::GetStats(static_cast<MemoryTag>(i)).m_bytes));
+	}
+
+	if (gpuMemory)
+	{
+		record(m_gpuMemory, static_cast<double>(*gpuMemory));
+	}
+
+	record(m_bytesSent, static_cast<double>(traffic.m_bytesSent - m_lastBytesSent));
+	record(m_bytesReceived, static_cast<double>(traffic.m_bytesReceived - m_lastBytesReceived));
+	record(m_datagramsSent, static_cast<double>(traffic.m_datagramsSent - m_lastDatagramsSent));
+	record(m_datagramsReceived, static_cast<double>(traffic.m_datagramsReceived - m_lastDatagramsReceived));
+	m_lastBytesSent = traffic.m_bytesSent;
+	m_lastBytesReceived = traffic.m_bytesReceived;
+	m_lastDatagramsSent = traffic.m_datagramsSent;
+	m_lastDatagramsReceived = traffic.m_datagramsReceived;
+}
+
+void Telemetry::Run()
+{
+	while (true)
+	{
+		bool flush;
+		bool serve;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			// While listening the thread waits in the socket poll instead, and checks for flushes between polls.
+			if (m_listener == nullptr)
+			{
+				m_condition.wait(lock, [this]()
+				{
+					return m_stop || m_flushRequested || m_listener != nullptr;
+				});
+			}
+
+			if (m_stop)
+			{
+				return;
+			}
+
+			flush = m_flushRequested;
+			serve = m_listener != nullptr;
+			m_flushRequested = false;
+		}
+
+		if (flush)
+		{
+			Flush();
+		}
+
+		if (serve)
+		{
+			Serve();
+		}
+	}
+}
+
+void Telemetry::Flush()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// The batch only allocates when metrics were added since the last batch.
+		for (std::size_t i = m_batch.size(); i < m_metrics.size(); i++)
+		{
+			m_batch.emplace_back(m_metrics[i]);
+		}
+
+		for (std::size_t i = 0; i < m_metrics.size(); i++)
+		{
+			auto &metric = m_metrics[i];
+			auto &batched = m_batch[i];
+			batched.m_histogram = metric.m_histogram;
+			batched.m_value = metric.m_value;
+			batched.m_recorded = metric.m_recorded;
+
+			metric.m_histogram.Reset();
+			metric.m_recorded = false;
+
+			// Counters are sent as the change since the last batch, gauges keep their last value.
+			if (metric.m_kind == Kind::Counter)
+			{
+				metric.m_value = 0.0;
+			}
+		}
+
+		if (m_collectorChanged)
+		{
+			m_collectorChanged = false;
+			m_socket = nullptr;
+			m_http = nullptr;
+
+			if (m_transport == Transport::Udp)
+			{
+				m_address = IpAddress(m_host);
+				m_socket = std::make_unique<UdpSocket>();
+			}
+			else if (m_transport == Transport::Http)
+			{
+				m_http = std::make_unique<Http>(m_host, m_port);
+			}
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_totalsMutex);
+
+		for (std::size_t i = m_totals.size(); i < m_batch.size(); i++)
+		{
+			auto &total = m_totals.emplace_back(m_batch[i]);
+			total.m_histogram.Reset();
+			total.m_value = 0.0;
+			total.m_recorded = false;
+		}
+
+		for (std::size_t i = 0; i < m_batch.size(); i++)
+		{
+			auto &batched = m_batch[i];
+			auto &total = m_totals[i];
+
+			if (!batched.m_recorded)
+			{
+				continue;
+			}
+
+			total.m_histogram.Merge(batched.m_histogram);
+			total.m_value = batched.m_kind == Kind::Counter ? total.m_value + batched.m_value : batched.m_value;
+			total.m_recorded = true;
+		}
+	}
+
+	SendBatch();
+	m_sequence++;
+}
+
+void Telemetry::WriteHeader(const uint16_t &part)
+{
+	m_packet.Clear();
+	m_packet << BATCH_MAGIC << BATCH_VERSION << m_sequence << part;
+}
+
+void Telemetry::SendBatch()
+{
+	if (m_socket == nullptr && m_http == nullptr)
+	{
+		return;
+	}
+
+	// Datagrams each start with a header so the collector can read them alone, http sends the whole batch as one part.
+	uint16_t part = 0;
+	auto sent = true;
+	WriteHeader(part);
+
+	for (const auto &metric : m_batch)
+	{
+		if (!metric.m_recorded)
+		{
+			continue;
+		}
+
+		auto start = m_packet.GetDataSize();
+		m_packet << metric.m_name << static_cast<uint8_t>(metric.m_kind);
+
+		if (metric.m_kind == Kind::Histogram)
+		{
+			const auto &histogram = metric.m_histogram;
+			m_packet << histogram.GetFirstBound() << histogram.GetGrowth() << histogram.GetCount() << histogram.GetSum() << histogram.GetMin()
+				<< histogram.GetMax();
+
+			// Only buckets holding values are written, as pairs of the bucket index and count.
+			uint8_t used = 0;
+
+			for (const auto &count : histogram.GetBuckets())
+			{
+				used += count != 0;
+			}
+
+			m_packet << used;
+
+			for (std::size_t i = 0; i < Histogram::BucketCount; i++)
+			{
+				if (histogram.GetBuckets()[i] != 0)
+				{
+					m_packet << static_cast<uint8_t>(i) << histogram.GetBuckets()[i];
+				}
+			}
+		}
+		else
+		{
+			m_packet << metric.m_value;
+		}
+
+		// The metric that overflowed a datagram is moved to the start of the next, the scratch keeps its capacity between batches.
+		if (m_socket != nullptr && m_packet.GetDataSize() > DatagramSize && start > HeaderSize)
+		{
+			m_overflow.assign(static_cast<const char *>(m_packet.GetData()) + start, m_packet.GetDataSize() - start);
+
+			if (m_socket->Send(m_packet.GetData(), start, m_address, m_port) != Socket::Status::Done)
+			{
+				sent = false;
+			}
+
+			WriteHeader(++part);
+			m_packet.Append(m_overflow.data(), m_overflow.size());
+		}
+	}
+
+	if (m_socket != nullptr)
+	{
+		sent = m_socket->Send(m_packet.GetData(), m_packet.GetDataSize(), m_address, m_port) == Socket::Status::Done && sent;
+	}
+	else
+	{
+		HttpRequest request(m_path, HttpRequest::Method::Post, std::string(static_cast<const char *>(m_packet.GetData()), m_packet.GetDataSize()));
+		request.SetField("Content-Type", "application/octet-stream");
+		auto status = m_http->SendRequest(request, POST_TIMEOUT).GetStatus();
+		sent = status == HttpResponse::Status::Ok || status == HttpResponse::Status::Accepted || status == HttpResponse::Status::NoContent;
+	}
+
+	if (!sent && !m_failing)
+	{
+		Log::Warning("Telemetry batch could not be sent to '%s'\n", m_host.c_str());
+	}
+
+	m_failing = !sent;
+}
+
+void Telemetry::Serve()
+{
+	if (!m_serving)
+	{
+		m_serving = true;
+		m_poller.Add(*m_listener, SocketEvent::Read, [this](Socket &, BitMask<SocketEvent>)
+		{
+			// The poller is edge triggered, connections are accepted until none are waiting.
+			while (true)
+			{
+				auto client = std::make_unique<Client>();
+
+				if (m_listener->Accept(client->m_socket) != Socket::Status::Done)
+				{
+					break;
+				}
+
+				client->m_start = Engine::GetTime();
+				auto clientPointer = client.get();
+				m_poller.Add(client->m_socket, SocketEvent::Read, [this, clientPointer](Socket &, BitMask<SocketEvent>)
+				{
+					Receive(*clientPointer);
+				});
+				m_clients.emplace_back(std::move(client));
+			}
+		});
+	}
+
+	m_poller.Poll(SERVE_INTERVAL);
+	auto now = Engine::GetTime();
+
+	// Answered clients and those that did not send a request in time are closed, closing removes them from the poller.
+	m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(), [&now](const std::unique_ptr<Client> &client)
+	{
+		return client->m_answered || now - client->m_start > REQUEST_TIMEOUT;
+	}), m_clients.end());
+}
+
+void Telemetry::Receive(Client &client)
+{
+	char buffer[1024];
+
+	while (!client.m_answered)
+	{
+		std::size_t received = 0;
+		auto status = client.m_socket.Receive(buffer, sizeof(buffer), received);
+
+		if (status == Socket::Status::NotReady)
+		{
+			return;
+		}
+
+		if (status != Socket::Status::Done)
+		{
+			client.m_answered = true;
+			return;
+		}
+
+		client.m_request.append(buffer, received);
+
+		// Requests are small, only the request line is read and the client is closed after the reply.
+		if (client.m_request.find("\r\n\r\n") == std::string::npos && client.m_request.size() < 8 * 1024)
+		{
+			continue;
+		}
+
+		std::string response;
+
+		if (String::StartsWith(client.m_request, "GET "))
+		{
+			auto body = GetPrometheusText();
+			response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + String::To(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+		}
+		else
+		{
+			response = "HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+		}
+
+		// The reply is sent whole before the client is closed.
+		client.m_socket.SetBlocking(true);
+		client.m_socket.Send(response.data(), response.size());
+		client.m_answered = true;
+	}
+}
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Engine/Engine.hpp"
+#include "Engine/MemoryTracker.hpp"
+#include "Network/IpAddress.hpp"
+#include "Network/Packet.hpp"
+#include "Network/SocketPoller.hpp"
+#include "Network/Tcp/TcpSocket.hpp"
+#include "Histogram.hpp"
+
+namespace acid
+{
+class Http;
+class TcpListener;
+class UdpSocket;
+
+/**
+ * @brief Module that samples engine counters, aggregates them into histograms and ships the aggregates to a collector.
+ * Frame time, GPU time, memory and network traffic are sampled at the sample rate, games add their own metrics with {@link Telemetry#AddMetric}.
+ * Sampling and recording only lock and add to fixed buckets, batches are encoded and sent from the telemetry thread, as datagrams or as http posts.
+ * The totals since the start of the engine can also be served as Prometheus text, such as from a dedicated server.
+ */
+class ACID_EXPORT Telemetry :
+	public Module
+{
+public:
+	enum class Kind : uint8_t
+	{
+		/// A distribution of values, such as the frame time.
+		Histogram,
+		/// The last value, such as the memory in use.
+		Gauge,
+		/// A total that only grows, values recorded are added to it.
+		Counter
+	};
+
+	enum class Transport
+	{
+		None, Udp, Http
+	};
+
+	/**
+	 * Gets the engines instance.
+	 * @return The current module instance.
+	 */
+	static Telemetry *Get() { return Engine::Get()->GetModule<Telemetry>(); }
+
+	Telemetry();
+
+	~Telemetry();
+
+	void Update() override;
+
+	/**
+	 * Registers a metric, this allocates and should be done once, such as when the game starts.
+	 * @param name The name of the metric, such as "frame_time_ms".
+	 * @param kind The kind of metric.
+	 * @param firstBound The upper bound of the first histogram bucket.
+	 * @param growth The ratio between the bounds of neighbouring histogram buckets.
+	 * @return The id values are recorded with.
+	 */
+	uint32_t AddMetric(const std::string &name, const Kind &kind, const double &firstBound = 1.0, const double &growth = 2.0);
+
+	/**
+	 * Records a value, this does not allocate and can be called from any thread.
+	 * @param metric The id of the metric.
+	 * @param value The value, added to the histogram, set as the gauge or added to the counter.
+	 */
+	void Record(const uint32_t &metric, const double &value);
+
+	/**
+	 * Sets where batches are sent, the host is resolved on the telemetry thread.
+	 * Datagrams are sent to the port, http batches are posted to the path.
+	 * @param transport How batches are sent, none stops sending.
+	 * @param host The collector host.
+	 * @param port The collector port.
+	 * @param path The path batches are posted to by http.
+	 */
+	void SetCollector(const Transport &transport, const std::string &host, const uint16_t &port, const std::string &path = "/telemetry");
+
+	/**
+	 * Serves the totals as Prometheus text to http requests on a port.
+	 * @param port The port to listen on.
+	 * @return If the port is listened on.
+	 */
+	bool Listen(const uint16_t &port);
+
+	/**
+	 * Gets the totals since the start of the engine as Prometheus text, this allocates.
+	 * @return The text.
+	 */
+	std::string GetPrometheusText() const;
+
+	const Time &GetSampleInterval() const { return m_sampleInterval; }
+
+	void SetSampleInterval(const Time &sampleInterval) { m_sampleInterval = sampleInterval; }
+
+	const Time &GetFlushInterval() const { return m_flushInterval; }
+
+	void SetFlushInterval(const Time &flushInterval) { m_flushInterval = flushInterval; }
+
+	/// The most bytes in one datagram, batches larger than this are split.
+	static constexpr std::size_t DatagramSize = 1200;
+	/// The bytes of the header each datagram starts with, the magic, version, batch sequence and part.
+	static constexpr std::size_t HeaderSize = 15;
+
+private:
+	class Metric
+	{
+	public:
+		std::string m_name;
+		Kind m_kind = Kind::Gauge;
+		Histogram m_histogram;
+		double m_value = 0.0;
+		/// If a value was recorded since the last batch.
+		bool m_recorded = false;
+	};
+
+	void Sample();
+
+	void Run();
+
+	/**
+	 * Takes the metrics recorded since the last batch into the batch and totals, then sends the batch.
+	 */
+	void Flush();
+
+	void WriteHeader(const uint16_t &count);
+
+	void SendBatch();
+
+	/// A connection to the Prometheus endpoint.
+	class Client
+	{
+	public:
+		TcpSocket m_socket;
+		std::string m_request;
+		Time m_start;
+		bool m_answered = false;
+	};
+
+	void Serve();
+
+	void Receive(Client &client);
+
+	// Metrics recorded by the frame and worker threads, taken into the batch by the telemetry thread.
+	std::vector<Metric> m_metrics;
+	mutable std::mutex m_mutex;
+
+	// Only touched by the telemetry thread.
+	std::vector<Metric> m_batch;
+	Packet m_packet;
+	std::string m_overflow;
+	uint64_t m_sequence;
+	std::unique_ptr<UdpSocket> m_socket;
+	std::unique_ptr<Http> m_http;
+	// The poller is declared first so it is destroyed after the sockets in it.
+	SocketPoller m_poller;
+	std::unique_ptr<TcpListener> m_listener;
+	std::vector<std::unique_ptr<Client>> m_clients;
+	bool m_serving;
+
+	// The metrics since the start of the engine, served as Prometheus text.
+	std::vector<Metric> m_totals;
+	mutable std::mutex m_totalsMutex;
+
+	Transport m_transport;
+	std::string m_host;
+	uint16_t m_port;
+	std::string m_path;
+	bool m_collectorChanged;
+	/// The collector address resolved from the host, by the telemetry thread.
+	IpAddress m_address;
+	/// If the last batch failed to send, so failures are only logged once until a batch is sent again.
+	bool m_failing;
+
+	Time m_sampleInterval;
+	Time m_flushInterval;
+	Time m_lastSample;
+	Time m_lastFlush;
+
+	uint32_t m_frameTime;
+	uint32_t m_gpuTime;
+	uint32_t m_fps;
+	uint32_t m_ups;
+	std::array<uint32_t, static_cast<std::size_t>(MemoryTag::Count)> m_memory;
+	uint32_t m_gpuMemory;
+	uint32_t m_bytesSent;
+	uint32_t m_bytesReceived;
+	uint32_t m_datagramsSent;
+	uint32_t m_datagramsReceived;
+	uint64_t m_lastBytesSent;
+	uint64_t m_lastBytesReceived;
+	uint64_t m_lastDatagramsSent;
+	uint64_t m_lastDatagramsReceived;
+
+	bool m_flushRequested;
+	bool m_stop;
+	std::condition_variable m_condition;
+	std::thread m_thread;
+};
+}
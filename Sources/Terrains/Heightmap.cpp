@@ -0,0 +1,94 @@
+#include "Heightmap.hpp"
+
+#include "Engine/Engine.hpp"
+#include "Maths/Maths.hpp"
+
+namespace acid
+{
+Heightmap::Heightmap(const uint32_t &size, std::vector<float> heights) :
+	m_size(size),
+	m_heights(std::move(heights)),
+	m_minHeight(0.0f),
+	m_maxHeight(0.0f)
+{
+	m_heights.resize(m_size * m_size, 0.0f);
+
+	if (!m_heights.empty())
+	{
+		auto [min, max] = std::minmax_element(m_heights.begin(), m_heights.end());
+		m_minHeight = *min;
+		m_maxHeight = *max;
+	}
+}
+
+std::shared_ptr<Heightmap> Heightmap::Generate(const uint32_t &size, const std::function<float(const Vector2f &)> &function)
+{
+	std::vector<float> heights(size * size);
+	auto scale = 1.0f / static_cast<float>(std::max(size, 2u) - 1);
+
+	Engine::Get()->GetThreadPool().ParallelFor(0, size, [&](const std::size_t &row)
+	{
+		for (uint32_t col = 0; col < size; col++)
+		{
+			heights[row * size + col] = function(Vector2f(static_cast<float>(col), static_cast<float>(row)) * scale);
+		}
+	});
+
+	return std::make_shared<Heightmap>(size, std::move(heights));
+}
+
+float Heightmap::GetHeight(const int32_t &col, const int32_t &row) const
+{
+	if (m_size == 0)
+	{
+		return 0.0f;
+	}
+
+	auto last = static_cast<int32_t>(m_size) - 1;
+	return m_heights[std::clamp(row, 0, last) * m_size + std::clamp(col, 0, last)];
+}
+
+float Heightmap::Sample(const Vector2f &position) const
+{
+	auto x = std::clamp(position.m_x, 0.0f, 1.0f) * static_cast<float>(m_size - 1);
+	auto y = std::clamp(position.m_y, 0.0f, 1.0f) * static_cast<float>(m_size - 1);
+	auto col = static_cast<int32_t>(std::floor(x));
+	auto row = static_cast<int32_t>(std::floor(y));
+	auto fx = x - static_cast<float>(col);
+	auto fy = y - static_cast<float>(row);
+
+	auto top = Maths::Lerp(GetHeight(col, row), GetHeight(col + 1, row), fx);
+	auto bottom = Maths::Lerp(GetHeight(col, row + 1), GetHeight(col + 1, row + 1), fx);
+	return Maths::Lerp(top, bottom, fy);
+}
+
+Vector2f Heightmap::GetBlockRange(const uint32_t &col, const uint32_t &row, const uint32_t &size) const
+{
+	auto range = Vector2f(+std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity());
+
+	for (uint32_t y = 0; y < size; y++)
+	{
+		for (uint32_t x = 0; x < size; x++)
+		{
+			auto height = GetHeight(static_cast<int32_t>(col + x), static_cast<int32_t>(row + y));
+			range.m_x = std::min(range.m_x, height);
+			range.m_y = std::max(range.m_y, height);
+		}
+	}
+
+	return range;
+}
+
+const std::shared_ptr<Image2d> &Heightmap::GetImage()
+{
+	if (m_image == nullptr && m_size != 0)
+	{
+		auto pixels = std::make_unique<uint8_t[]>(sizeof(float) * m_heights.size());
+		std::memcpy(pixels.get(), m_heights.data(), sizeof(float) * m_heights.size());
+		m_image = std::make_shared<Image2d>(Vector2ui(m_size), std::move(pixels), VK_FORMAT_R32_SFLOAT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+	}
+
+	return m_image;
+}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Maths/Vector2.hpp"
+#include "Graphics/Images/Image2d.hpp"
+
+namespace acid
+{
+/**
+ * @brief Class that holds a square grid of terrain heights, the source that terrain chunks are displaced from and collider tiles are copied from.
+ */
+class ACID_EXPORT Heightmap
+{
+public:
+	/**
+	 * Creates a new heightmap.
+	 * @param size The number of samples along each side, a power of two plus one lets every chunk of a terrain start on a sample.
+	 * @param heights The heights of each sample, row by row.
+	 */
+	Heightmap(const uint32_t &size, std::vector<float> heights);
+
+	/**
+	 * Creates a new heightmap with the heights given by a function, rows are generated in parallel on the engines job system.
+	 * @param size The number of samples along each side.
+	 * @param function The function called with the position of a sample from zero to one, returning its height. It must be safe to call from several threads.
+	 * @return The heightmap.
+	 */
+	static std::shared_ptr<Heightmap> Generate(const uint32_t &size, const std::function<float(const Vector2f &)> &function);
+
+	const uint32_t &GetSize() const { return m_size; }
+
+	const std::vector<float> &GetHeights() const { return m_heights; }
+
+	/**
+	 * Gets the height of a sample, samples outside the grid are clamped to its edge.
+	 * @param col The column of the sample.
+	 * @param row The row of the sample.
+	 * @return The height.
+	 */
+	float GetHeight(const int32_t &col, const int32_t &row) const;
+
+	/**
+	 * Gets the height between samples, bilinearly interpolated the same way the terrain shader does.
+	 * @param position The position from zero to one.
+	 * @return The height.
+	 */
+	float Sample(const Vector2f &position) const;
+
+	/**
+	 * Gets the lowest and highest heights in a square block of samples.
+	 * @param col The column of the first sample.
+	 * @param row The row of the first sample.
+	 * @param size The number of samples along each side of the block.
+	 * @return The lowest and highest height.
+	 */
+	Vector2f GetBlockRange(const uint32_t &col, const uint32_t &row, const uint32_t &size) const;
+
+	float GetMinHeight() const { return m_minHeight; }
+
+	float GetMaxHeight() const { return m_maxHeight; }
+
+	/**
+	 * Gets the heights as a single channel float image, it is created the first time it is used.
+	 * The image is read with texel fetches, so it does not depend on linear filtering of float formats.
+	 * @return The height image.
+	 */
+	const std::shared_ptr<Image2d> &GetImage();
+
+private:
+	uint32_t m_size;
+	std::vector<float> m_heights;
+	float m_minHeight;
+	float m_maxHeight;
+	std::shared_ptr<Image2d> m_image;
+};
+}
@@ -0,0 +1,91 @@
+#include "SubrenderTerrains.hpp"
+
+#include "Models/VertexDefault.hpp"
+#include "Scenes/Scenes.hpp"
+#include "Terrain.hpp"
+
+namespace acid
+{
+SubrenderTerrains::SubrenderTerrains(const Pipeline::Stage &pipelineStage) :
+	Subrender(pipelineStage),
+	m_pipeline(pipelineStage, { "Shaders/Terrains/Terrain.vert", "Shaders/Terrains/Terrain.frag" }, { VertexDefault::GetVertexInput() },
+		{ { "PATCH_RESOLUTION", String::To(Terrain::PATCH_RESOLUTION) } }, PipelineGraphics::Mode::Mrt),
+	m_uniformScene(true)
+{
+}
+
+void SubrenderTerrains::PreRender(const CommandBuffer &commandBuffer)
+{
+	// A virtual texture shared by several terrains is updated once.
+	std::vector<VirtualTexture *> updated;
+
+	for (const auto &terrain : Scenes::Get()->GetStructure()->QueryComponents<Terrain>(FrameAllocator::Get()))
+	{
+		if (!terrain->IsVirtual())
+		{
+			continue;
+		}
+
+		auto virtualTexture = terrain->GetVirtualTexture().get();
+
+		if (std::find(updated.begin(), updated.end(), virtualTexture) == updated.end())
+		{
+			virtualTexture->CmdUpdate(commandBuffer);
+			updated.emplace_back(virtualTexture);
+		}
+	}
+}
+
+void SubrenderTerrains::Render(const CommandBuffer &commandBuffer)
+{
+	auto terrains = Scenes::Get()->GetStructure()->QueryComponents<Terrain>(FrameAllocator::Get());
+
+	if (terrains.empty())
+	{
+		return;
+	}
+
+	auto camera = Scenes::Get()->GetCamera();
+
+	// Terrain does not move, only the camera adds motion.
+	m_uniformScene.Push("projection", camera->GetJitteredProjectionMatrix());
+	m_uniformScene.Push("view", camera->GetViewMatrix());
+	m_uniformScene.Push("cameraPos", camera->GetPosition());
+	m_uniformScene.Push("previousProjection", m_previousProjection);
+	m_uniformScene.Push("previousView", m_previousView);
+	m_uniformScene.Push("jitter", camera->GetJitter());
+	m_previousProjection = camera->GetProjectionMatrix();
+	m_previousView = camera->GetViewMatrix();
+
+	// Terrains are drawn with one pipeline and then the other, so each is bound once.
+	const PipelineGraphics *boundPipeline = nullptr;
+
+	for (const auto &virtualPass : { false, true })
+	{
+		for (const auto &terrain : terrains)
+		{
+			if (terrain->IsVirtual() != virtualPass)
+			{
+				continue;
+			}
+
+			if (virtualPass && m_pipelineVirtual == nullptr)
+			{
+				m_pipelineVirtual = std::make_unique<PipelineGraphics>(GetStage(), std::vector<std::string>{ "Shaders/Terrains/Terrain.vert", "Shaders/Terrains/Terrain.frag" },
+					std::vector<Shader::VertexInput>{ VertexDefault::GetVertexInput() },
+					std::vector<Shader::Define>{ { "PATCH_RESOLUTION", String::To(Terrain::PATCH_RESOLUTION) }, { "VIRTUAL_TEXTURE", "1" } }, PipelineGraphics::Mode::Mrt);
+			}
+
+			auto &pipeline = virtualPass ? *m_pipelineVirtual : m_pipeline;
+
+			if (boundPipeline != &pipeline)
+			{
+				pipeline.BindPipeline(commandBuffer);
+				boundPipeline = &pipeline;
+			}
+
+			terrain->CmdRender(commandBuffer, pipeline, m_uniformScene);
+		}
+	}
+}
+}
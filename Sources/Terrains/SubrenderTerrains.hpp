@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Pipelines/PipelineGraphics.hpp"
+
+namespace acid
+{
+/**
+ * @brief Subrender that draws the chunks of every terrain into the deferred attachments.
+ * Terrains drawn from a virtual texture use their own pipeline, which is created once the first is drawn, and have their pages streamed before the renderpass.
+ */
+class ACID_EXPORT SubrenderTerrains :
+	public Subrender
+{
+public:
+	explicit SubrenderTerrains(const Pipeline::Stage &pipelineStage);
+
+	void PreRender(const CommandBuffer &commandBuffer) override;
+
+	void Render(const CommandBuffer &commandBuffer) override;
+
+private:
+	PipelineGraphics m_pipeline;
+	std::unique_ptr<PipelineGraphics> m_pipelineVirtual;
+	UniformHandler m_uniformScene;
+
+	Matrix4 m_previousProjection;
+	Matrix4 m_previousView;
+};
+}
@@ -0,0 +1,411 @@
+#include "Terrain.hpp"
+
+#include "Models/VertexDefault.hpp"
+#include "Physics/Colliders/ColliderHeightfield.hpp"
+#include "Physics/Rigidbody.hpp"
+#include "Scenes/Entity.hpp"
+#include "Scenes/Scenes.hpp"
+
+namespace acid
+{
+static const uint32_t MIN_CHUNKS = 64;
+// The fraction of each levels range after which vertices start morphing to the next level.
+static const float MORPH_START = 0.7f;
+// The most quads along each side of a collider tile, tiles are nodes of the finest level that is no larger.
+static const uint32_t TILE_QUADS = 64;
+// Tiles are unloaded further out than they are loaded, so a camera moving along the edge of the range does not rebuild them every frame.
+static const float TILE_UNLOAD_SCALE = 1.25f;
+
+Terrain::Terrain(std::shared_ptr<Heightmap> heightmap, std::shared_ptr<Image2d> imageR, std::shared_ptr<Image2d> imageG, const float &sideLength,
+	const uint32_t &lodCount, const float &viewDistance, const float &colliderDistance) :
+	m_heightmap(std::move(heightmap)),
+	m_imageR(std::move(imageR)),
+	m_imageG(std::move(imageG)),
+	m_sideLength(sideLength),
+	m_lodCount(std::max(lodCount, 1u)),
+	m_viewDistance(viewDistance),
+	m_colliderDistance(colliderDistance),
+	m_colliderLod(0),
+	m_colliderBody(nullptr)
+{
+}
+
+void Terrain::Start()
+{
+	// Every chunk draws the same flat grid from zero to one, the vertex shader places and displaces it.
+	std::vector<VertexDefault> vertices;
+	vertices.reserve((PATCH_RESOLUTION + 1) * (PATCH_RESOLUTION + 1));
+	std::vector<uint32_t> indices;
+	indices.reserve(6 * PATCH_RESOLUTION * PATCH_RESOLUTION);
+
+	for (uint32_t row = 0; row <= PATCH_RESOLUTION; row++)
+	{
+		for (uint32_t col = 0; col <= PATCH_RESOLUTION; col++)
+		{
+			auto position = Vector2f(static_cast<float>(col), static_cast<float>(row)) / static_cast<float>(PATCH_RESOLUTION);
+			vertices.emplace_back(Vector3f(position.m_x, 0.0f, position.m_y), position, Vector3f::Up);
+		}
+	}
+
+	for (uint32_t row = 0; row < PATCH_RESOLUTION; row++)
+	{
+		for (uint32_t col = 0; col < PATCH_RESOLUTION; col++)
+		{
+			auto topLeft = (row * (PATCH_RESOLUTION + 1)) + col;
+			auto topRight = topLeft + 1;
+			auto bottomLeft = ((row + 1) * (PATCH_RESOLUTION + 1)) + col;
+			auto bottomRight = bottomLeft + 1;
+
+			indices.emplace_back(bottomRight);
+			indices.emplace_back(bottomLeft);
+			indices.emplace_back(topRight);
+			indices.emplace_back(topRight);
+			indices.emplace_back(bottomLeft);
+			indices.emplace_back(topLeft);
+		}
+	}
+
+	m_patch = std::make_shared<Model>(vertices, indices);
+}
+
+void Terrain::Update()
+{
+	auto camera = Scenes::Get()->GetCamera();
+
+	if (m_heightmap == nullptr || camera == nullptr)
+	{
+		m_chunks.clear();
+		return;
+	}
+
+	if (m_heightRanges.empty())
+	{
+		UpdateHeightRanges();
+	}
+
+	auto cameraPosition = camera->GetPosition() - GetParent()->GetWorldTransform().GetPosition();
+	SelectChunks(cameraPosition);
+	UpdateColliders(cameraPosition);
+}
+
+bool Terrain::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
+{
+	if (m_chunks.empty() || m_patch == nullptr)
+	{
+		return false;
+	}
+
+	auto chunkCount = static_cast<uint32_t>(m_chunks.size());
+
+	if (m_chunkBuffer == nullptr || m_chunkBuffer->GetSize() < sizeof(Chunk) * chunkCount)
+	{
+		m_chunkBuffer = std::make_unique<StorageBuffer>(sizeof(Chunk) * std::max(2 * chunkCount, MIN_CHUNKS));
+	}
+
+	Chunk *chunks;
+	m_chunkBuffer->MapMemory(reinterpret_cast<void **>(&chunks));
+	std::memcpy(chunks, m_chunks.data(), sizeof(Chunk) * chunkCount);
+	m_chunkBuffer->UnmapMemory();
+
+	m_uniformObject.Push("position", GetParent()->GetWorldTransform().GetPosition());
+	m_uniformObject.Push("sideLength", m_sideLength);
+	m_uniformObject.Push("heightmapSize", static_cast<int32_t>(m_heightmap->GetSize()));
+
+	// Updates descriptors.
+	m_descriptorSet.Push("UniformScene", uniformScene);
+	m_descriptorSet.Push("UniformObject", m_uniformObject);
+	m_descriptorSet.Push("BufferChunks", m_chunkBuffer);
+	m_descriptorSet.Push("samplerHeight", m_heightmap->GetImage());
+
+	if (IsVirtual())
+	{
+		m_virtualTexture->PushDescriptors(m_descriptorSet);
+	}
+	else
+	{
+		m_descriptorSet.Push("samplerR", m_imageR);
+		m_descriptorSet.Push("samplerG", m_imageG);
+	}
+
+	if (!m_descriptorSet.Update(pipeline))
+	{
+		return false;
+	}
+
+	// Draws every chunk as a instance of the patch.
+	m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
+	return m_patch->CmdRender(commandBuffer, chunkCount);
+}
+
+void Terrain::SetHeightmap(const std::shared_ptr<Heightmap> &heightmap)
+{
+	m_heightmap = heightmap;
+	m_heightRanges.clear();
+	m_chunks.clear();
+
+	if (m_colliderBody != nullptr && m_colliderBody == GetParent()->GetComponent<Rigidbody>())
+	{
+		for (const auto &[key, collider] : m_colliders)
+		{
+			m_colliderBody->RemoveChild(collider);
+		}
+	}
+
+	m_colliders.clear();
+}
+
+bool Terrain::IsVirtual() const
+{
+	return m_virtualTexture != nullptr && VirtualTexture::IsSupported();
+}
+
+float Terrain::GetHeight(const Vector2f &position) const
+{
+	if (m_heightmap == nullptr)
+	{
+		return 0.0f;
+	}
+
+	return m_heightmap->Sample(position / m_sideLength + 0.5f);
+}
+
+const Metadata &operator>>(const Metadata &metadata, Terrain &terrain)
+{
+	metadata.GetResource("Image R", terrain.m_imageR);
+	metadata.GetResource("Image G", terrain.m_imageG);
+
+	if (auto virtualTexture = metadata.GetChild<std::string>("Virtual Texture"); !virtualTexture.empty())
+	{
+		terrain.m_virtualTexture = VirtualTexture::Create(virtualTexture);
+	}
+
+	metadata.GetChild("Side Length", terrain.m_sideLength);
+	metadata.GetChild("Lod Count", terrain.m_lodCount);
+	metadata.GetChild("View Distance", terrain.m_viewDistance);
+	metadata.GetChild("Collider Distance", terrain.m_colliderDistance);
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const Terrain &terrain)
+{
+	metadata.SetResource("Image R", terrain.m_imageR);
+	metadata.SetResource("Image G", terrain.m_imageG);
+
+	if (terrain.m_virtualTexture != nullptr)
+	{
+		metadata.SetChild("Virtual Texture", terrain.m_virtualTexture->GetName());
+	}
+
+	metadata.SetChild("Side Length", terrain.m_sideLength);
+	metadata.SetChild("Lod Count", terrain.m_lodCount);
+	metadata.SetChild("View Distance", terrain.m_viewDistance);
+	metadata.SetChild("Collider Distance", terrain.m_colliderDistance);
+	return metadata;
+}
+
+void Terrain::UpdateHeightRanges()
+{
+	m_lodCount = std::max(m_lodCount, 1u);
+	m_heightRanges.resize(m_lodCount);
+
+	// The finest nodes scan the samples they cover, each coarser node combines its four children.
+	auto leafCount = 1u << (m_lodCount - 1);
+	auto quads = static_cast<float>(std::max(m_heightmap->GetSize(), 2u) - 1);
+	m_heightRanges[0].resize(leafCount * leafCount);
+
+	for (uint32_t z = 0; z < leafCount; z++)
+	{
+		for (uint32_t x = 0; x < leafCount; x++)
+		{
+			auto col = static_cast<uint32_t>(std::floor(quads * static_cast<float>(x) / static_cast<float>(leafCount)));
+			auto row = static_cast<uint32_t>(std::floor(quads * static_cast<float>(z) / static_cast<float>(leafCount)));
+			auto size = static_cast<uint32_t>(std::ceil(quads / static_cast<float>(leafCount))) + 2;
+			m_heightRanges[0][z * leafCount + x] = m_heightmap->GetBlockRange(col, row, size);
+		}
+	}
+
+	for (uint32_t lod = 1; lod < m_lodCount; lod++)
+	{
+		auto nodeCount = 1u << (m_lodCount - 1 - lod);
+		m_heightRanges[lod].resize(nodeCount * nodeCount);
+
+		for (uint32_t z = 0; z < nodeCount; z++)
+		{
+			for (uint32_t x = 0; x < nodeCount; x++)
+			{
+				auto range = Vector2f(+std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity());
+
+				for (uint32_t i = 0; i < 4; i++)
+				{
+					auto &child = m_heightRanges[lod - 1][(2 * z + i / 2) * 2 * nodeCount + 2 * x + i % 2];
+					range.m_x = std::min(range.m_x, child.m_x);
+					range.m_y = std::max(range.m_y, child.m_y);
+				}
+
+				m_heightRanges[lod][z * nodeCount + x] = range;
+			}
+		}
+	}
+
+	m_colliderLod = 0;
+
+	while (m_colliderLod + 1 < m_lodCount && quads / static_cast<float>(1u << (m_lodCount - 2 - m_colliderLod)) <= static_cast<float>(TILE_QUADS))
+	{
+		m_colliderLod++;
+	}
+}
+
+void Terrain::SelectChunks(const Vector3f &cameraPosition)
+{
+	// Each level covers twice the distance of the level finer than it.
+	m_lodRanges.resize(m_lodCount);
+
+	for (uint32_t lod = 0; lod < m_lodCount; lod++)
+	{
+		m_lodRanges[lod] = m_viewDistance / static_cast<float>(1u << (m_lodCount - 1 - lod));
+	}
+
+	m_chunks.clear();
+	SelectNode(cameraPosition, m_lodCount - 1, 0, 0);
+}
+
+bool Terrain::SelectNode(const Vector3f &cameraPosition, const uint32_t &lod, const uint32_t &x, const uint32_t &z)
+{
+	auto distance = GetNodeDistance(cameraPosition, lod, x, z);
+
+	if (distance > m_lodRanges[lod])
+	{
+		return false;
+	}
+
+	if (lod == 0 || distance > m_lodRanges[lod - 1])
+	{
+		AddChunk(lod, x, z);
+		return true;
+	}
+
+	// Children out of their own range are drawn at their size and fully morphed, which is the grid of this level.
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		auto childX = 2 * x + i % 2;
+		auto childZ = 2 * z + i / 2;
+
+		if (!SelectNode(cameraPosition, lod - 1, childX, childZ))
+		{
+			AddChunk(lod - 1, childX, childZ);
+		}
+	}
+
+	return true;
+}
+
+void Terrain::AddChunk(const uint32_t &lod, const uint32_t &x, const uint32_t &z)
+{
+	auto size = GetNodeSize(lod);
+	auto offset = Vector2f(static_cast<float>(x), static_cast<float>(z)) * size - m_sideLength / 2.0f;
+	auto &range = m_heightRanges[lod][z * (1u << (m_lodCount - 1 - lod)) + x];
+
+	auto position = GetParent()->GetWorldTransform().GetPosition();
+	auto min = position + Vector3f(offset.m_x, range.m_x, offset.m_y);
+	auto max = position + Vector3f(offset.m_x + size, range.m_y, offset.m_y + size);
+
+	if (!Scenes::Get()->GetCamera()->GetViewFrustum().CubeInFrustum(min, max))
+	{
+		return;
+	}
+
+	auto morphEnd = m_lodRanges[lod];
+	auto morphStart = Maths::Lerp(lod > 0 ? m_lodRanges[lod - 1] : 0.0f, morphEnd, MORPH_START);
+	m_chunks.emplace_back(Chunk{ offset, size, lod, Vector2f(morphStart, morphEnd), Vector2f() });
+}
+
+void Terrain::UpdateColliders(const Vector3f &cameraPosition)
+{
+	auto rigidbody = GetParent()->GetComponent<Rigidbody>();
+
+	// Tiles belong to the rigidbody they were added to, if it has gone so have they.
+	if (rigidbody != m_colliderBody)
+	{
+		m_colliders.clear();
+		m_colliderBody = rigidbody;
+	}
+
+	if (rigidbody == nullptr || !rigidbody->IsShapeCreated())
+	{
+		return;
+	}
+
+	for (auto it = m_colliders.begin(); it != m_colliders.end();)
+	{
+		if (GetNodeDistance(cameraPosition, m_colliderLod, it->first.first, it->first.second) > TILE_UNLOAD_SCALE * m_colliderDistance)
+		{
+			rigidbody->RemoveChild(it->second);
+			it = m_colliders.erase(it);
+			continue;
+		}
+
+		++it;
+	}
+
+	auto tileCount = 1u << (m_lodCount - 1 - m_colliderLod);
+	auto tileSize = GetNodeSize(m_colliderLod);
+	auto getTile = [&](const float &position)
+	{
+		return static_cast<uint32_t>(std::clamp(std::floor((position + m_sideLength / 2.0f) / tileSize), 0.0f, static_cast<float>(tileCount - 1)));
+	};
+	auto firstX = getTile(cameraPosition.m_x - m_colliderDistance);
+	auto lastX = getTile(cameraPosition.m_x + m_colliderDistance);
+	auto firstZ = getTile(cameraPosition.m_z - m_colliderDistance);
+	auto lastZ = getTile(cameraPosition.m_z + m_colliderDistance);
+
+	// Tiles are resampled at the spacing of the heightmap, so a heightmap of a power of two plus one samples is copied exactly.
+	auto quads = std::max(static_cast<uint32_t>(std::round(static_cast<float>(std::max(m_heightmap->GetSize(), 2u) - 1) / static_cast<float>(tileCount))), 1u);
+	auto spacing = tileSize / static_cast<float>(quads);
+
+	for (auto z = firstZ; z <= lastZ; z++)
+	{
+		for (auto x = firstX; x <= lastX; x++)
+		{
+			if (m_colliders.find({ x, z }) != m_colliders.end() || GetNodeDistance(cameraPosition, m_colliderLod, x, z) > m_colliderDistance)
+			{
+				continue;
+			}
+
+			auto offset = Vector2f(static_cast<float>(x), static_cast<float>(z)) * tileSize - m_sideLength / 2.0f;
+			std::vector<float> heights;
+			heights.reserve((quads + 1) * (quads + 1));
+
+			for (uint32_t row = 0; row <= quads; row++)
+			{
+				for (uint32_t col = 0; col <= quads; col++)
+				{
+					heights.emplace_back(GetHeight(offset + Vector2f(static_cast<float>(col), static_cast<float>(row)) * spacing));
+				}
+			}
+
+			// Bullet centres heightfields on their bounds, so the tile is placed at the centre of its heights.
+			auto [minHeight, maxHeight] = std::minmax_element(heights.begin(), heights.end());
+			auto centre = offset + tileSize / 2.0f;
+			auto localTransform = Transform(Vector3f(centre.m_x, (*minHeight + *maxHeight) / 2.0f, centre.m_y));
+			auto collider = std::make_unique<ColliderHeightfield>(quads + 1, quads + 1, heights.data(), *minHeight, *maxHeight, false, spacing, localTransform);
+			m_colliders[{ x, z }] = rigidbody->AddChild(std::move(collider));
+		}
+	}
+}
+
+float Terrain::GetNodeSize(const uint32_t &lod) const
+{
+	return m_sideLength / static_cast<float>(1u << (m_lodCount - 1 - lod));
+}
+
+float Terrain::GetNodeDistance(const Vector3f &cameraPosition, const uint32_t &lod, const uint32_t &x, const uint32_t &z) const
+{
+	auto size = GetNodeSize(lod);
+	auto &range = m_heightRanges[lod][z * (1u << (m_lodCount - 1 - lod)) + x];
+	auto min = Vector3f(static_cast<float>(x) * size - m_sideLength / 2.0f, range.m_x, static_cast<float>(z) * size - m_sideLength / 2.0f);
+	auto max = Vector3f(min.m_x + size, range.m_y, min.m_z + size);
+	auto outside = Vector3f(std::max({ min.m_x - cameraPosition.m_x, 0.0f, cameraPosition.m_x - max.m_x }),
+		std::max({ min.m_y - cameraPosition.m_y, 0.0f, cameraPosition.m_y - max.m_y }), std::max({ min.m_z - cameraPosition.m_z, 0.0f, cameraPosition.m_z - max.m_z }));
+	return outside.Length();
+}
+}
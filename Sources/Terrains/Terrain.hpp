@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Graphics/Buffers/StorageBuffer.hpp"
+#include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Images/Image2d.hpp"
+#include "Graphics/Images/VirtualTexture.hpp"
+#include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Models/Model.hpp"
+#include "Scenes/Component.hpp"
+#include "Heightmap.hpp"
+
+namespace acid
+{
+class Collider;
+class CollisionObject;
+
+/**
+ * @brief Component that draws a heightmap as a quadtree of chunks, and streams heightfield collider tiles around the camera.
+ * Chunks are selected each frame with continuous distance dependent levels of detail, each chunk is the same flat grid patch displaced from the height image in the vertex shader.
+ * Vertices morph to the grid of the next coarser level as they near the end of their levels range, so neighbouring chunks of different levels meet without cracks.
+ * Collider tiles are handed to a static {@link Rigidbody} on the same entity as they come into range, and removed once they are left behind.
+ * A terrain with a {@link VirtualTexture} is drawn from it once across the whole terrain in place of its two tiled images.
+ * Only the position of the entity is used, terrains are not rotated or scaled with it.
+ */
+class ACID_EXPORT Terrain :
+	public Component
+{
+public:
+	/**
+	 * @brief A chunk selected to draw, laid out the same as the chunks read by the terrain shader.
+	 */
+	class Chunk
+	{
+	public:
+		// The corner of the chunk closest to negative x and z, relative to the terrain.
+		Vector2f m_offset;
+		float m_size;
+		uint32_t m_lod;
+		// The distances from the camera that vertices start and finish morphing to the next level.
+		Vector2f m_morph;
+		Vector2f m_padding;
+	};
+
+	/**
+	 * Creates a new terrain.
+	 * @param heightmap The heights of the terrain.
+	 * @param imageR The image drawn on flat ground.
+	 * @param imageG The image drawn on steep slopes.
+	 * @param sideLength The length of each side of the terrain.
+	 * @param lodCount The number of levels in the quadtree, the finest chunks are the side length over two to the power of one less than this.
+	 * @param viewDistance The distance from the camera that the coarsest level draws to, chunks past it are not drawn.
+	 * @param colliderDistance The distance from the camera that collider tiles are loaded within.
+	 */
+	explicit Terrain(std::shared_ptr<Heightmap> heightmap = nullptr, std::shared_ptr<Image2d> imageR = nullptr, std::shared_ptr<Image2d> imageG = nullptr,
+		const float &sideLength = 256.0f, const uint32_t &lodCount = 6, const float &viewDistance = 1024.0f, const float &colliderDistance = 64.0f);
+
+	void Start() override;
+
+	void Update() override;
+
+	/**
+	 * Draws the selected chunks as instances of the patch.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param pipeline The terrain pipeline.
+	 * @param uniformScene The scene uniforms.
+	 * @return If the terrain was drawn.
+	 */
+	bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
+
+	const std::shared_ptr<Heightmap> &GetHeightmap() const { return m_heightmap; }
+
+	/**
+	 * Sets the heights of the terrain, every loaded collider tile is rebuilt.
+	 * @param heightmap The heightmap.
+	 */
+	void SetHeightmap(const std::shared_ptr<Heightmap> &heightmap);
+
+	/**
+	 * Gets the height of the terrain under a point, relative to the terrain.
+	 * @param position The x and z position relative to the terrain.
+	 * @return The height.
+	 */
+	float GetHeight(const Vector2f &position) const;
+
+	const std::vector<Chunk> &GetChunks() const { return m_chunks; }
+
+	uint32_t GetColliderCount() const { return static_cast<uint32_t>(m_colliders.size()); }
+
+	const std::shared_ptr<Image2d> &GetImageR() const { return m_imageR; }
+
+	void SetImageR(const std::shared_ptr<Image2d> &imageR) { m_imageR = imageR; }
+
+	const std::shared_ptr<Image2d> &GetImageG() const { return m_imageG; }
+
+	void SetImageG(const std::shared_ptr<Image2d> &imageG) { m_imageG = imageG; }
+
+	const std::shared_ptr<VirtualTexture> &GetVirtualTexture() const { return m_virtualTexture; }
+
+	void SetVirtualTexture(const std::shared_ptr<VirtualTexture> &virtualTexture) { m_virtualTexture = virtualTexture; }
+
+	/**
+	 * Gets if the terrain is drawn from its virtual texture, which needs a device that supports them.
+	 * @return If the terrain is drawn with the virtual texture pipeline.
+	 */
+	bool IsVirtual() const;
+
+	float GetSideLength() const { return m_sideLength; }
+
+	uint32_t GetLodCount() const { return m_lodCount; }
+
+	float GetViewDistance() const { return m_viewDistance; }
+
+	void SetViewDistance(const float &viewDistance) { m_viewDistance = viewDistance; }
+
+	float GetColliderDistance() const { return m_colliderDistance; }
+
+	void SetColliderDistance(const float &colliderDistance) { m_colliderDistance = colliderDistance; }
+
+	ACID_EXPORT friend const Metadata &operator>>(const Metadata &metadata, Terrain &terrain);
+
+	ACID_EXPORT friend Metadata &operator<<(Metadata &metadata, const Terrain &terrain);
+
+	// The number of quads along each side of the patch drawn for every chunk, this must be even so vertices can morph to a grid of half the resolution.
+	static constexpr uint32_t PATCH_RESOLUTION = 32;
+
+private:
+	void UpdateHeightRanges();
+
+	void SelectChunks(const Vector3f &cameraPosition);
+
+	bool SelectNode(const Vector3f &cameraPosition, const uint32_t &lod, const uint32_t &x, const uint32_t &z);
+
+	void AddChunk(const uint32_t &lod, const uint32_t &x, const uint32_t &z);
+
+	void UpdateColliders(const Vector3f &cameraPosition);
+
+	float GetNodeSize(const uint32_t &lod) const;
+
+	float GetNodeDistance(const Vector3f &cameraPosition, const uint32_t &lod, const uint32_t &x, const uint32_t &z) const;
+
+	std::shared_ptr<Heightmap> m_heightmap;
+	std::shared_ptr<Image2d> m_imageR;
+	std::shared_ptr<Image2d> m_imageG;
+	std::shared_ptr<VirtualTexture> m_virtualTexture;
+	float m_sideLength;
+	uint32_t m_lodCount;
+	float m_viewDistance;
+	float m_colliderDistance;
+
+	// The lowest and highest height in each node of every level, finest level first.
+	std::vector<std::vector<Vector2f>> m_heightRanges;
+	std::vector<float> m_lodRanges;
+	std::vector<Chunk> m_chunks;
+
+	// Tiles are nodes of the collider level keyed by their column and row, they are owned by the rigidbody they were added to.
+	uint32_t m_colliderLod;
+	std::map<std::pair<uint32_t, uint32_t>, Collider *> m_colliders;
+	CollisionObject *m_colliderBody;
+
+	std::shared_ptr<Model> m_patch;
+	DescriptorsHandler m_descriptorSet;
+	UniformHandler m_uniformObject;
+	std::unique_ptr<StorageBuffer> m_chunkBuffer;
+};
+}
@@ -1,5 +1,7 @@
 #include "Timers.hpp"
 
+#include "Engine/Profiler.hpp"
+
 namespace acid
 {
 Timers::Timers()
@@ -12,30 +14,100 @@ Timers::~Timers()
 
 void Timers::Update()
 {
-	for (auto it = m_timers.begin(); it != m_timers.end();)
+	auto now = Engine::Get()->GetTime();
+	std::vector<std::unique_ptr<TimerInstance>> due;
+
 	{
-		if ((*it)->m_destroyed || (*it)->IsFinished())
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		while (!m_timers.empty() && (m_timers.front()->m_destroyed || m_timers.front()->m_next <= now))
 		{
-			it = m_timers.erase(it);
-			continue;
+			std::pop_heap(m_timers.begin(), m_timers.end(), CompareNext);
+
+			if (!m_timers.back()->m_destroyed)
+			{
+				due.emplace_back(std::move(m_timers.back()));
+			}
+
+			m_timers.pop_back();
 		}
+	}
+
+	if (due.empty())
+	{
+		return;
+	}
+
+	// Ticks run without the lock so they can create timers, those are not due until the next update.
+	Time drift;
+	Time driftStart;
 
-		if ((*it)->m_start + (*it)->m_intervel <= Engine::Get()->GetTime())
+	for (auto &timer : due)
+	{
+		if (now - timer->m_next > drift)
 		{
-			auto error = Engine::Get()->GetTime() - ((*it)->m_start + (*it)->m_intervel);
-			Log::Out("Timer Error: %f\n", error.AsSeconds());
+			drift = now - timer->m_next;
+			driftStart = timer->m_next;
+		}
 
-			(*it)->m_start = Engine::Get()->GetTime();
+		// Keeps the timer on its interval, ticks that were missed entirely are skipped.
+		timer->m_next += timer->m_intervel;
 
-			if ((*it)->m_repeat)
-			{
-				(*(*it)->m_repeat)--;
-			}
+		if (timer->m_next <= now)
+		{
+			timer->m_next = now + timer->m_intervel;
+		}
+
+		if (timer->m_repeat)
+		{
+			(*timer->m_repeat)--;
+		}
+
+		timer->m_onTick();
+	}
+
+	if (auto profiler = Profiler::Get(); profiler != nullptr && profiler->IsEnabled())
+	{
+		Profiler::Marker marker = {};
+		marker.m_name = "Timer Drift";
+		marker.m_category = "timer";
+		marker.m_start = driftStart;
+		marker.m_duration = drift;
+		marker.m_thread = profiler->GetThreadIndex();
+		profiler->AddMarker(std::move(marker));
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
 
-			(*it)->m_onTick();
+	for (auto &timer : due)
+	{
+		if (timer->m_destroyed || timer->IsFinished())
+		{
+			continue;
 		}
 
-		it++;
+		m_timers.emplace_back(std::move(timer));
+		std::push_heap(m_timers.begin(), m_timers.end(), CompareNext);
 	}
 }
+
+std::size_t Timers::GetTimerCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_timers.size();
+}
+
+bool Timers::CompareNext(const std::unique_ptr<TimerInstance> &a, const std::unique_ptr<TimerInstance> &b)
+{
+	return a->m_next > b->m_next;
+}
+
+TimerInstance *Timers::Add(std::unique_ptr<TimerInstance> &&instance)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto timer = instance.get();
+	m_timers.emplace_back(std::move(instance));
+	std::push_heap(m_timers.begin(), m_timers.end(), CompareNext);
+	return timer;
+}
 }
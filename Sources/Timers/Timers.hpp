@@ -11,7 +11,7 @@ class ACID_EXPORT TimerInstance
 {
 public:
 	TimerInstance(const Time &intervel, const std::optional<uint32_t> &repeat) :
-		m_start(Engine::Get()->GetTime()),
+		m_next(Engine::Get()->GetTime() + intervel),
 		m_intervel(intervel),
 		m_repeat(repeat),
 		m_destroyed(false)
@@ -22,6 +22,12 @@ public:
 
 	const std::optional<uint32_t> &GetRepeat() const { return m_repeat; }
 
+	/**
+	 * Gets the time the timer will next tick at.
+	 * @return The next tick time.
+	 */
+	const Time &GetNext() const { return m_next; }
+
 	bool IsFinished()
 	{
 		return m_repeat && *m_repeat == 0;
@@ -36,7 +42,7 @@ public:
 private:
 	friend class Timers;
 
-	Time m_start;
+	Time m_next;
 	Time m_intervel;
 	std::optional<uint32_t> m_repeat;
 	bool m_destroyed;
@@ -45,6 +51,8 @@ private:
 
 /**
  * @brief Module used for timed events.
+ * Timers are kept in a min heap ordered by their next tick, so each update only touches the timers that are due.
+ * The worst lateness of the timers ticked in a update is recorded as a "Timer Drift" region in the {@link Profiler}.
  */
 class ACID_EXPORT Timers :
 	public Module
@@ -65,31 +73,42 @@ public:
 	template<typename ...Args>
 	TimerInstance *Once(const Time &intervel, std::function<void(void)> &&function, Args ...args)
 	{
-		auto &instance = std::make_unique<TimerInstance>(intervel, 1);
+		auto instance = std::make_unique<TimerInstance>(intervel, 1);
 		instance->m_onTick.Add(std::move(function), args...);
-		m_timers.emplace_back(std::move(instance));
-		return instance.get();
+		return Add(std::move(instance));
 	}
 
 	template<typename ...Args>
 	TimerInstance *Every(const Time &intervel, std::function<void(void)> &&function, Args ...args)
 	{
-		auto &instance = std::make_unique<TimerInstance>(intervel, std::nullopt);
+		auto instance = std::make_unique<TimerInstance>(intervel, std::nullopt);
 		instance->m_onTick.Add(std::move(function), args...);
-		m_timers.emplace_back(std::move(instance));
-		return instance.get();
+		return Add(std::move(instance));
 	}
 
 	template<typename ...Args>
 	TimerInstance *Repeat(const Time &intervel, const uint32_t &repeat, std::function<void(void)> &&function, Args ...args)
 	{
-		auto &instance = std::make_unique<TimerInstance>(intervel, repeat);
+		auto instance = std::make_unique<TimerInstance>(intervel, repeat);
 		instance->m_onTick.Add(std::move(function), args...);
-		m_timers.emplace_back(std::move(instance));
-		return instance.get();
+		return Add(std::move(instance));
 	}
 
+	/**
+	 * Gets the number of timers that have not finished, destroyed timers are counted until they are next due.
+	 * @return The number of timers.
+	 */
+	std::size_t GetTimerCount() const;
+
 private:
+	/**
+	 * Orders the heap so the timer with the earliest next tick is at the front.
+	 */
+	static bool CompareNext(const std::unique_ptr<TimerInstance> &a, const std::unique_ptr<TimerInstance> &b);
+
+	TimerInstance *Add(std::unique_ptr<TimerInstance> &&instance);
+
 	std::vector<std::unique_ptr<TimerInstance>> m_timers;
+	mutable std::mutex m_mutex;
 };
 }
@@ -1,6 +1,5 @@
 #include "UiInputBoolean.hpp"
 
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Uis/Uis.hpp"
 #include "UiInputButton.hpp"
 
@@ -24,8 +23,7 @@ UiInputBoolean::UiInputBoolean(UiObject *parent, const std::string &title, const
 
 	OnSelected().Add([this](bool selected)
 	{
-		m_background.SetColourDriver(
-			new DriverSlide<Colour>(m_background.GetColourOffset(), selected ? UiInputButton::SelectedColour : UiInputButton::PrimaryColour, UiInputButton::SlideTime));
+		m_background.TweenColourOffset(selected ? UiInputButton::SelectedColour : UiInputButton::PrimaryColour, UiInputButton::SlideTime);
 		Mouse::Get()->SetCursor(selected ? CursorStandard::Hand : CursorStandard::Arrow);
 	});
 	OnClick().Add([this](MouseButton button)
@@ -1,6 +1,5 @@
 ﻿#include "UiInputButton.hpp"
 
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Uis/Uis.hpp"
 
 namespace acid
@@ -27,7 +26,7 @@ UiInputButton::UiInputButton(UiObject *parent, const std::string &string, const
 
 	OnSelected().Add([this](bool selected)
 	{
-		m_background.SetColourDriver(new DriverSlide<Colour>(m_background.GetColourOffset(), selected ? SelectedColour : PrimaryColour, SlideTime));
+		m_background.TweenColourOffset(selected ? SelectedColour : PrimaryColour, SlideTime);
 		Mouse::Get()->SetCursor(selected ? CursorStandard::Hand : CursorStandard::Arrow);
 	});
 }
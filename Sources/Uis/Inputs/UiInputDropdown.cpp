@@ -1,6 +1,5 @@
 #include "UiInputDropdown.hpp"
 
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Uis/Uis.hpp"
 #include "UiInputButton.hpp"
 
@@ -23,8 +22,7 @@ UiInputDropdown::UiInputDropdown(UiObject *parent, const std::string &title, con
 
 	OnSelected().Add([this](bool selected)
 	{
-		m_background.SetColourDriver(
-			new DriverSlide<Colour>(m_background.GetColourOffset(), selected ? UiInputButton::SelectedColour : UiInputButton::PrimaryColour, UiInputButton::SlideTime));
+		m_background.TweenColourOffset(selected ? UiInputButton::SelectedColour : UiInputButton::PrimaryColour, UiInputButton::SlideTime);
 		Mouse::Get()->SetCursor(selected ? CursorStandard::Hand : CursorStandard::Arrow);
 	});
 }
@@ -1,6 +1,5 @@
 ﻿#include "UiInputGrabber.hpp"
 
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Uis/Uis.hpp"
 #include "UiInputButton.hpp"
 
@@ -46,12 +45,12 @@ void UiInputGrabber::UpdateObject()
 	{
 		if (m_background.IsSelected() && !m_mouseOver)
 		{
-			m_background.SetColourDriver(new DriverSlide<Colour>(m_background.GetColourOffset(), UiInputButton::SelectedColour, UiInputButton::SlideTime));
+			m_background.TweenColourOffset(UiInputButton::SelectedColour, UiInputButton::SlideTime);
 			m_mouseOver = true;
 		}
 		else if (!m_background.IsSelected() && m_mouseOver)
 		{
-			m_background.SetColourDriver(new DriverSlide<Colour>(m_background.GetColourOffset(), UiInputButton::PrimaryColour, UiInputButton::SlideTime));
+			m_background.TweenColourOffset(UiInputButton::PrimaryColour, UiInputButton::SlideTime);
 			m_mouseOver = false;
 		}
 	}
@@ -75,6 +74,11 @@ UiGrabberJoystick::UiGrabberJoystick(UiObject *parent, const std::string &title,
 {
 	UpdateValue();
 
+	if (!Engine::Get()->HasModule<Joysticks>())
+	{
+		return;
+	}
+
 	Joysticks::Get()->OnButton().Add([this](uint32_t port, uint32_t button, InputAction action)
 	{
 		if (!m_updating || port != m_port)
@@ -102,6 +106,11 @@ UiGrabberKeyboard::UiGrabberKeyboard(UiObject *parent, const std::string &title,
 {
 	UpdateValue();
 
+	if (!Engine::Get()->HasModule<Keyboard>())
+	{
+		return;
+	}
+
 	Keyboard::Get()->OnKey().Add([this](Key key, InputAction action, BitMask<InputMod> mods)
 	{
 		if (!m_updating)
@@ -129,6 +138,11 @@ UiGrabberMouse::UiGrabberMouse(UiObject *parent, const std::string &title, const
 {
 	UpdateValue();
 
+	if (!Engine::Get()->HasModule<Mouse>())
+	{
+		return;
+	}
+
 	Mouse::Get()->OnButton().Add([this](MouseButton button, InputAction action, BitMask<InputMod> mods)
 	{
 		if (!m_updating)
@@ -1,6 +1,5 @@
 #include "UiInputRadio.hpp"
 
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Uis/Uis.hpp"
 #include "UiInputButton.hpp"
 
@@ -24,8 +23,7 @@ UiInputRadio::UiInputRadio(UiObject *parent, const std::string &string, const Ty
 
 	OnSelected().Add([this](bool selected)
 	{
-		m_background.SetColourDriver(
-			new DriverSlide<Colour>(m_background.GetColourOffset(), selected ? UiInputButton::SelectedColour : UiInputButton::PrimaryColour, UiInputButton::SlideTime));
+		m_background.TweenColourOffset(selected ? UiInputButton::SelectedColour : UiInputButton::PrimaryColour, UiInputButton::SlideTime);
 		Mouse::Get()->SetCursor(selected ? CursorStandard::Hand : CursorStandard::Arrow);
 	});
 	OnClick().Add([this](MouseButton button)
@@ -76,6 +74,6 @@ void UiInputRadio::UpdateValue()
 		break;
 	}
 
-	m_fill.SetAlphaDriver(new DriverSlide<float>(m_fill.GetAlpha(), m_value ? 1.0f : 0.0f, UiInputButton::SlideTime));
+	m_fill.TweenAlpha(m_value ? 1.0f : 0.0f, UiInputButton::SlideTime);
 }
 }
@@ -1,7 +1,6 @@
 ﻿#include "UiInputSlider.hpp"
 
 #include <iomanip>
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Uis/Uis.hpp"
 #include "UiInputButton.hpp"
 
@@ -74,12 +73,12 @@ void UiInputSlider::UpdateObject()
 
 	if (m_background.IsSelected() && !m_mouseOver)
 	{
-		m_background.SetColourDriver(new DriverSlide<Colour>(m_background.GetColourOffset(), UiInputButton::SelectedColour, UiInputButton::SlideTime));
+		m_background.TweenColourOffset(UiInputButton::SelectedColour, UiInputButton::SlideTime);
 		m_mouseOver = true;
 	}
 	else if (!m_background.IsSelected() && m_mouseOver && !m_updating)
 	{
-		m_background.SetColourDriver(new DriverSlide<Colour>(m_background.GetColourOffset(), UiInputButton::PrimaryColour, UiInputButton::SlideTime));
+		m_background.TweenColourOffset(UiInputButton::PrimaryColour, UiInputButton::SlideTime);
 		m_mouseOver = false;
 	}
 
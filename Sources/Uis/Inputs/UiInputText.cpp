@@ -1,7 +1,6 @@
 ﻿#include "UiInputText.hpp"
 
 #include "Devices/Keyboard.hpp"
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Uis/Uis.hpp"
 #include "UiInputButton.hpp"
 
@@ -23,6 +22,16 @@ UiInputText::UiInputText(UiObject *parent, const std::string &title, const std::
 	GetRectangle().SetSize(UiInputButton::Size);
 	m_background.SetNinePatches(Vector4f(0.125f, 0.125f, 0.875f, 0.875f));
 
+	OnSelected().Add([this](bool selected)
+	{
+		Mouse::Get()->SetCursor(selected ? CursorStandard::Hand : CursorStandard::Arrow);
+	});
+
+	if (!Engine::Get()->HasModule<Keyboard>())
+	{
+		return;
+	}
+
 	Keyboard::Get()->OnKey().Add([this](Key key, InputAction action, BitMask<InputMod> mods)
 	{
 		if (!m_updating)
@@ -32,7 +41,7 @@ UiInputText::UiInputText(UiObject *parent, const std::string &title, const std::
 
 		if (key == Key::Backspace && action != InputAction::Release)
 		{
-			m_inputDelay.Update(true);
+			m_inputDelay.Update(action);
 
 			if (m_lastKey != 8 || m_inputDelay.CanInput())
 			{
@@ -73,11 +82,6 @@ UiInputText::UiInputText(UiObject *parent, const std::string &title, const std::
 			m_lastKey = 0;
 		}
 	}, this);
-
-	OnSelected().Add([this](bool selected)
-	{
-		Mouse::Get()->SetCursor(selected ? CursorStandard::Hand : CursorStandard::Arrow);
-	});
 }
 
 void UiInputText::UpdateObject()
@@ -100,12 +104,12 @@ void UiInputText::UpdateObject()
 	{
 		if (m_background.IsSelected() && !m_mouseOver)
 		{
-			m_background.SetColourDriver(new DriverSlide<Colour>(m_background.GetColourOffset(), UiInputButton::SelectedColour, UiInputButton::SlideTime));
+			m_background.TweenColourOffset(UiInputButton::SelectedColour, UiInputButton::SlideTime);
 			m_mouseOver = true;
 		}
 		else if (!m_background.IsSelected() && m_mouseOver)
 		{
-			m_background.SetColourDriver(new DriverSlide<Colour>(m_background.GetColourOffset(), UiInputButton::PrimaryColour, UiInputButton::SlideTime));
+			m_background.TweenColourOffset(UiInputButton::PrimaryColour, UiInputButton::SlideTime);
 			m_mouseOver = false;
 		}
 	}
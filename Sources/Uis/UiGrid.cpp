@@ -0,0 +1,99 @@
+#include "UiGrid.hpp"
+
+#include "UiObject.hpp"
+
+namespace acid
+{
+UiGrid::UiGrid(const uint32_t &resolution) :
+	m_resolution(resolution),
+	m_cells(resolution * resolution)
+{
+}
+
+void UiGrid::Build(const std::vector<UiObject *> &objects)
+{
+	Clear();
+	auto resolution = static_cast<float>(m_resolution);
+
+	for (const auto &object : objects)
+	{
+		auto position = object->GetScreenPosition();
+		auto size = object->GetScreenSize();
+
+		// Objects entirely off the screen can never be under the cursor.
+		if (size.m_x <= 0.0f || size.m_y <= 0.0f || position.m_x > 1.0f || position.m_y > 1.0f || position.m_x + size.m_x < 0.0f || position.m_y + size.m_y < 0.0f)
+		{
+			continue;
+		}
+
+		auto index = static_cast<uint32_t>(m_entries.size());
+		m_entries.emplace_back(Entry{object, position, size, object->GetScreenDepth(), index});
+
+		auto minX = static_cast<uint32_t>(std::clamp(position.m_x * resolution, 0.0f, resolution - 1.0f));
+		auto minY = static_cast<uint32_t>(std::clamp(position.m_y * resolution, 0.0f, resolution - 1.0f));
+		auto maxX = static_cast<uint32_t>(std::clamp((position.m_x + size.m_x) * resolution, 0.0f, resolution - 1.0f));
+		auto maxY = static_cast<uint32_t>(std::clamp((position.m_y + size.m_y) * resolution, 0.0f, resolution - 1.0f));
+
+		for (auto y = minY; y <= maxY; y++)
+		{
+			for (auto x = minX; x <= maxX; x++)
+			{
+				m_cells[x + y * m_resolution].emplace_back(index);
+			}
+		}
+	}
+}
+
+void UiGrid::Pick(const Vector2f &position, std::vector<UiObject *> &picked) const
+{
+	picked.clear();
+
+	if (position.m_x < 0.0f || position.m_y < 0.0f || position.m_x > 1.0f || position.m_y > 1.0f)
+	{
+		return;
+	}
+
+	auto resolution = static_cast<float>(m_resolution);
+	auto x = static_cast<uint32_t>(std::min(position.m_x * resolution, resolution - 1.0f));
+	auto y = static_cast<uint32_t>(std::min(position.m_y * resolution, resolution - 1.0f));
+
+	m_candidates.clear();
+
+	for (const auto &index : m_cells[x + y * m_resolution])
+	{
+		const auto &entry = m_entries[index];
+		auto distance = position - entry.m_position;
+
+		if (distance.m_x >= 0.0f && distance.m_y >= 0.0f && distance.m_x <= entry.m_size.m_x && distance.m_y <= entry.m_size.m_y)
+		{
+			m_candidates.emplace_back(&entry);
+		}
+	}
+
+	// Deeper objects are drawn on top, objects of the same depth are drawn in order.
+	std::sort(m_candidates.begin(), m_candidates.end(), [](const Entry *a, const Entry *b)
+	{
+		if (a->m_depth != b->m_depth)
+		{
+			return a->m_depth > b->m_depth;
+		}
+
+		return a->m_order > b->m_order;
+	});
+
+	for (const auto &candidate : m_candidates)
+	{
+		picked.emplace_back(candidate->m_object);
+	}
+}
+
+void UiGrid::Clear()
+{
+	m_entries.clear();
+
+	for (auto &cell : m_cells)
+	{
+		cell.clear();
+	}
+}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Maths/Vector2.hpp"
+
+namespace acid
+{
+class UiObject;
+
+/**
+ * @brief A uniform grid over the screen of the visible ui objects rectangles, used to find the objects under the cursor without testing every object.
+ * Rectangles are copied into the grid when it is built, so objects are never read while picking.
+ */
+class ACID_EXPORT UiGrid
+{
+public:
+	/**
+	 * @brief A object rectangle stored in the grid.
+	 */
+	class Entry
+	{
+	public:
+		UiObject *m_object;
+		Vector2f m_position;
+		Vector2f m_size;
+		float m_depth;
+		uint32_t m_order;
+	};
+
+	/**
+	 * Creates a new ui grid.
+	 * @param resolution The number of cells along each axis of the screen.
+	 */
+	explicit UiGrid(const uint32_t &resolution = 16);
+
+	/**
+	 * Rebuilds the grid from the objects screen rectangles.
+	 * @param objects The objects, in the order they are drawn.
+	 */
+	void Build(const std::vector<UiObject *> &objects);
+
+	/**
+	 * Finds the objects with a rectangle containing a position.
+	 * @param position The screen position.
+	 * @param picked The objects under the position, front most first.
+	 */
+	void Pick(const Vector2f &position, std::vector<UiObject *> &picked) const;
+
+	void Clear();
+
+	const std::vector<Entry> &GetEntries() const { return m_entries; }
+
+private:
+	uint32_t m_resolution;
+	std::vector<Entry> m_entries;
+	std::vector<std::vector<uint32_t>> m_cells;
+	mutable std::vector<const Entry *> m_candidates;
+};
+}
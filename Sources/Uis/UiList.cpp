@@ -0,0 +1,140 @@
+#include "UiList.hpp"
+
+namespace acid
+{
+static const float SCROLL_BAR_SIZE = 0.01f;
+// The shortest the puck gets, so it can still be grabbed in long lists.
+static const float MIN_PUCK_SIZE = 0.05f;
+
+UiList::UiList(UiObject *parent, const float &rowHeight, CreateRow &&createRow, BindRow &&bindRow, const uint32_t &itemCount, const UiBound &rectangle) :
+	UiObject(parent, rectangle),
+	m_content(this, UiBound::Maximum),
+	m_scrollBar(this, ScrollBar::Vertical, UiBound(Vector2f(1.0f, 0.0f), UiReference::TopRight, UiAspect::Position | UiAspect::Size, Vector2f(SCROLL_BAR_SIZE, 1.0f))),
+	m_rowHeight(rowHeight),
+	m_createRow(std::move(createRow)),
+	m_bindRow(std::move(bindRow)),
+	m_itemCount(itemCount),
+	m_scrollOffset(0.0f),
+	m_puckSize(1.0f)
+{
+}
+
+void UiList::UpdateObject()
+{
+	auto height = GetScreenSize().m_y;
+
+	if (height <= 0.0f || m_rowHeight <= 0.0f)
+	{
+		return;
+	}
+
+	// The puck shrinks with the part of the list in view, its position is kept within the bar as the list grows or shrinks.
+	auto range = GetScrollRange();
+	m_puckSize = range > 0.0f ? std::max(height / (height + range), MIN_PUCK_SIZE) : 1.0f;
+	m_scrollBar.SetEnabled(range > 0.0f);
+	m_scrollBar.SetSize(Vector2f(1.0f, m_puckSize));
+
+	auto progress = std::clamp(m_scrollBar.GetProgress(), 0.0f, 1.0f - m_puckSize);
+	m_scrollBar.SetProgress(progress);
+	m_scrollOffset = m_puckSize < 1.0f ? progress / (1.0f - m_puckSize) * range : 0.0f;
+
+	// Enough rows to fill the view when the first and last rows are partly scrolled out of it.
+	auto rowCount = std::min(static_cast<uint32_t>(std::ceil(height / m_rowHeight)) + 1, m_itemCount);
+
+	while (m_rows.size() < rowCount)
+	{
+		m_rows.emplace_back(Row{m_createRow(&m_content), std::nullopt});
+	}
+
+	auto first = static_cast<uint32_t>(m_scrollOffset / m_rowHeight);
+	auto last = std::min(first + rowCount, m_itemCount);
+
+	for (auto &row : m_rows)
+	{
+		row.m_object->SetEnabled(false);
+	}
+
+	for (auto index = first; index < last; index++)
+	{
+		auto &row = m_rows[index % m_rows.size()];
+
+		if (row.m_index != index)
+		{
+			m_bindRow(*row.m_object, index);
+			row.m_index = index;
+		}
+
+		// Assigned through the reference, so the layout is only recomputed when the row moved.
+		row.m_object->SetEnabled(true);
+		row.m_object->GetRectangle() = UiBound(Vector2f(0.0f, (static_cast<float>(index) * m_rowHeight - m_scrollOffset) / height), UiReference::TopLeft,
+			UiAspect::Position | UiAspect::Scale, Vector2f(1.0f, m_rowHeight / height));
+	}
+
+	SetScissor(&m_content);
+}
+
+void UiList::SetItemCount(const uint32_t &itemCount)
+{
+	m_itemCount = itemCount;
+
+	for (auto &row : m_rows)
+	{
+		if (row.m_index && *row.m_index >= m_itemCount)
+		{
+			row.m_index = std::nullopt;
+		}
+	}
+}
+
+void UiList::ScrollTo(const uint32_t &index)
+{
+	auto range = GetScrollRange();
+	m_scrollOffset = std::min(static_cast<float>(index) * m_rowHeight, range);
+	m_scrollBar.SetProgress(range > 0.0f ? m_scrollOffset / range * (1.0f - m_puckSize) : 0.0f);
+}
+
+void UiList::Refresh()
+{
+	for (auto &row : m_rows)
+	{
+		row.m_index = std::nullopt;
+	}
+}
+
+UiObject *UiList::GetRow(const uint32_t &index) const
+{
+	if (m_rows.empty())
+	{
+		return nullptr;
+	}
+
+	auto &row = m_rows[index % m_rows.size()];
+
+	if (row.m_index != index || !row.m_object->IsEnabled())
+	{
+		return nullptr;
+	}
+
+	return row.m_object.get();
+}
+
+float UiList::GetScrollRange() const
+{
+	return std::max(static_cast<float>(m_itemCount) * m_rowHeight - GetScreenSize().m_y, 0.0f);
+}
+
+void UiList::SetScissor(UiObject *object)
+{
+	auto position = GetScreenPosition();
+	auto size = GetScreenSize();
+	object->SetScissor(Vector4f(position.m_x, position.m_y, size.m_x, size.m_y));
+
+	for (auto &child : object->GetChildren())
+	{
+		if (child->IsEnabled())
+		{
+			SetScissor(child);
+		}
+	}
+}
+}
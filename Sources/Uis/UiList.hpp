@@ -0,0 +1,112 @@
+#pragma once
+
+#include <functional>
+#include "Uis/UiObject.hpp"
+#include "UiScrollBar.hpp"
+
+namespace acid
+{
+/**
+ * @brief A vertical list of items in rows of the same height, only the rows in view exist so the cost does not grow with the number of items.
+ * A pool of rows covering the height of the list is created through a callback, as the list scrolls rows that leave the view are bound to the items entering it.
+ * Item {@code i} is always shown by the same row of the pool, so scrolling by a row binds only one row.
+ */
+class ACID_EXPORT UiList :
+	public UiObject
+{
+public:
+	/**
+	 * Creates a row, the row should fill its parent.
+	 * @param parent The parent of the row.
+	 * @return The row.
+	 */
+	using CreateRow = std::function<std::unique_ptr<UiObject>(UiObject *parent)>;
+
+	/**
+	 * Shows a item in a row that was created by the list, such as setting the string of a text.
+	 * @param row The row.
+	 * @param index The index of the item.
+	 */
+	using BindRow = std::function<void(UiObject &row, const uint32_t &index)>;
+
+	/**
+	 * Creates a new ui list.
+	 * @param parent The parent screen object.
+	 * @param rowHeight The height of every row in screen space.
+	 * @param createRow The function that creates the rows of the pool.
+	 * @param bindRow The function that binds a row to a item.
+	 * @param itemCount The number of items.
+	 * @param rectangle The rectangle that will represent the bounds of the ui object.
+	 */
+	UiList(UiObject *parent, const float &rowHeight, CreateRow &&createRow, BindRow &&bindRow, const uint32_t &itemCount = 0,
+		const UiBound &rectangle = UiBound(Vector2f(0.0f, 0.0f), UiReference::Centre, UiAspect::Position | UiAspect::Size));
+
+	void UpdateObject() override;
+
+	const uint32_t &GetItemCount() const { return m_itemCount; }
+
+	/**
+	 * Sets the number of items, rows already bound to a item that is still in the list are not bound again.
+	 * @param itemCount The number of items.
+	 */
+	void SetItemCount(const uint32_t &itemCount);
+
+	const float &GetRowHeight() const { return m_rowHeight; }
+
+	void SetRowHeight(const float &rowHeight) { m_rowHeight = rowHeight; }
+
+	/**
+	 * Gets how far the list is scrolled.
+	 * @return The scroll offset in screen space, from the top of the first item.
+	 */
+	const float &GetScrollOffset() const { return m_scrollOffset; }
+
+	/**
+	 * Scrolls the list so a item is at the top of the view, or as close to it as the end of the list allows.
+	 * @param index The index of the item.
+	 */
+	void ScrollTo(const uint32_t &index);
+
+	/**
+	 * Binds every row in view again on the next update, used when the items changed.
+	 */
+	void Refresh();
+
+	/**
+	 * Gets the row showing a item.
+	 * @param index The index of the item.
+	 * @return The row, or nullptr if the item is not in view.
+	 */
+	UiObject *GetRow(const uint32_t &index) const;
+
+private:
+	class Row
+	{
+	public:
+		std::unique_ptr<UiObject> m_object;
+		std::optional<uint32_t> m_index;
+	};
+
+	/**
+	 * Gets the height of the list that is hidden by scrolling.
+	 * @return The scrollable height in screen space.
+	 */
+	float GetScrollRange() const;
+
+	void SetScissor(UiObject *object);
+
+	UiObject m_content;
+	UiScrollBar m_scrollBar;
+
+	float m_rowHeight;
+	CreateRow m_createRow;
+	BindRow m_bindRow;
+	uint32_t m_itemCount;
+
+	std::vector<Row> m_rows;
+
+	float m_scrollOffset;
+	// The length of the scroll bar puck as a fraction of the bar.
+	float m_puckSize;
+};
+}
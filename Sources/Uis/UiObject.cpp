@@ -1,7 +1,6 @@
 ﻿#include "UiObject.hpp"
 
 #include "Graphics/Graphics.hpp"
-#include "Maths/Visual/DriverConstant.hpp"
 #include "Uis.hpp"
 
 namespace acid
@@ -13,14 +12,16 @@ UiObject::UiObject(UiObject *parent, const UiBound &rectangle) :
 	m_scissor(0.0f, 0.0f, 1.0f, 1.0f),
 	m_height(0.0f),
 	m_lockRotation(true),
-	m_alphaDriver(std::make_unique<DriverConstant<float>>(1.0f)),
 	m_alpha(1.0f),
-	m_scaleDriver(std::make_unique<DriverConstant<Vector2f>>(Vector2f(1.0f))),
 	m_scale(1.0f),
 	m_screenDepth(0.0f),
 	m_screenAlpha(1.0f),
 	m_screenScale(1.0f),
-	m_selected(false)
+	m_selected(false),
+	m_layoutRectangle(rectangle),
+	m_layoutAspectRatio(0.0f),
+	m_layoutDirty(true),
+	m_layoutChanged(false)
 {
 	if (m_parent != nullptr)
 	{
@@ -39,17 +40,15 @@ UiObject::~UiObject()
 	{
 		child->m_parent = nullptr;
 	}
+
+	Tweens::Get()->Stop(m_alphaTween);
+	Tweens::Get()->Stop(m_scaleTween);
 }
 
 void UiObject::Update(std::vector<UiObject *> &list)
 {
-	bool selected = IsEnabled() && Mouse::Get()->IsWindowSelected() && Window::Get()->IsFocused();
-
-	if (selected)
-	{
-		auto distance = Mouse::Get()->GetPosition() - m_screenPosition;
-		selected = distance.m_x >= 0.0f && distance.m_y >= 0.0f && distance.m_x <= m_screenSize.m_x && distance.m_y <= m_screenSize.m_y;
-	}
+	// Objects are only updated by enabled parents, so this is the same as IsEnabled without walking up the parents.
+	bool selected = m_enabled && Uis::Get()->IsPicked(this);
 
 	if (selected != m_selected)
 	{
@@ -57,14 +56,19 @@ void UiObject::Update(std::vector<UiObject *> &list)
 		m_onSelected(m_selected);
 	}
 
+	m_layoutChanged = false;
+
 	if (!m_enabled)
 	{
+		// Parents may change while this object is not being updated.
+		m_layoutDirty = true;
 		return;
 	}
 
 	if (m_selected)
 	{
-		for (auto button : EnumIterator<MouseButton>())
+		// Was down is checked again because a earlier object may have cancelled the event.
+		for (const auto &button : Uis::Get()->GetPressedButtons())
 		{
 			if (Uis::Get()->WasDown(button))
 			{
@@ -73,40 +77,34 @@ void UiObject::Update(std::vector<UiObject *> &list)
 		}
 	}
 
-	// Alpha and scale updates.
-	m_alpha = m_alphaDriver->Update(Engine::Get()->GetDelta());
-	m_scale = m_scaleDriver->Update(Engine::Get()->GetDelta());
+	// Alpha and scale updates, tweens are advanced by the uis module and only read here.
+	auto alpha = m_alphaDriver ? m_alphaDriver->Update(Engine::Get()->GetDelta()) : Tweens::Get()->GetValue(m_alphaTween, m_alpha);
+	auto scale = m_scaleDriver ? m_scaleDriver->Update(Engine::Get()->GetDelta()) : Tweens::Get()->GetValue(m_scaleTween, m_scale);
+
+	if (alpha != m_alpha || scale != m_scale)
+	{
+		m_alpha = alpha;
+		m_scale = scale;
+		m_layoutDirty = true;
+	}
 
 	UpdateObject();
 
-	// Transform updates.
-	float aspectRatio = m_worldTransform ? 1.0f : Window::Get()->GetAspectRatio();
+	float aspectRatio = m_worldTransform ? 1.0f : Graphics::Get()->GetDisplayAspectRatio();
 
-	m_screenSize = m_rectangle.GetScreenSize(aspectRatio) * m_scale;
-	m_screenDepth = 0.01f * m_height;
-	m_screenScale = m_scale;
-	m_screenAlpha = m_alpha;
-
-	if (m_parent != nullptr)
+	if (m_layoutDirty || aspectRatio != m_layoutAspectRatio || (m_parent != nullptr && m_parent->m_layoutChanged) || !(m_rectangle == m_layoutRectangle))
 	{
-		if (m_rectangle.GetAspect() & UiAspect::Scale)
-		{
-			m_screenSize *= m_parent->m_screenSize;
-			m_screenScale *= m_parent->m_screenScale;
-		}
-
-		m_screenPosition = (m_rectangle.GetScreenPosition(aspectRatio) * m_parent->m_screenSize) - (m_screenSize * m_rectangle.GetReference()) + m_parent->m_screenPosition;
-		m_screenAlpha *= m_parent->m_screenAlpha;
-	}
-	else
-	{
-		m_screenPosition = m_rectangle.GetScreenPosition(aspectRatio) - (m_screenSize * m_rectangle.GetReference());
+		m_layoutRectangle = m_rectangle;
+		m_layoutAspectRatio = aspectRatio;
+		m_layoutDirty = false;
+		UpdateLayout();
 	}
 
 	// Adds this object to the list if it is visible.
 	if (m_screenAlpha > 0.0f)
 	{
 		list.emplace_back(this);
+		AddToLists(*Uis::Get());
 	}
 
 	// Update all children objects.
@@ -120,6 +118,82 @@ void UiObject::UpdateObject()
 {
 }
 
+void UiObject::SetAlphaDriver(Driver<float> *alphaDriver)
+{
+	Tweens::Get()->Stop(m_alphaTween);
+	m_alphaDriver.reset(alphaDriver);
+}
+
+void UiObject::SetAlpha(const float &alpha)
+{
+	SetAlphaDriver(nullptr);
+	m_alpha = alpha;
+	m_layoutDirty = true;
+}
+
+void UiObject::TweenAlpha(const float &alpha, const Time &length)
+{
+	SetAlphaDriver(nullptr);
+	m_alphaTween = Tweens::Get()->Start(m_alpha, alpha, length);
+}
+
+void UiObject::SetScaleDriver(Driver<Vector2f> *scaleDriver)
+{
+	Tweens::Get()->Stop(m_scaleTween);
+	m_scaleDriver.reset(scaleDriver);
+}
+
+void UiObject::SetScale(const Vector2f &scale)
+{
+	SetScaleDriver(nullptr);
+	m_scale = scale;
+	m_layoutDirty = true;
+}
+
+void UiObject::TweenScale(const Vector2f &scale, const Time &length)
+{
+	SetScaleDriver(nullptr);
+	m_scaleTween = Tweens::Get()->Start(m_scale, scale, length);
+}
+
+void UiObject::AddToLists(Uis &uis)
+{
+}
+
+void UiObject::UpdateLayout()
+{
+	auto screenPosition = m_screenPosition;
+	auto screenSize = m_screenSize;
+	auto screenDepth = m_screenDepth;
+	auto screenAlpha = m_screenAlpha;
+	auto screenScale = m_screenScale;
+
+	m_screenSize = m_rectangle.GetScreenSize(m_layoutAspectRatio) * m_scale;
+	m_screenDepth = 0.01f * m_height;
+	m_screenScale = m_scale;
+	m_screenAlpha = m_alpha;
+
+	if (m_parent != nullptr)
+	{
+		if (m_rectangle.GetAspect() & UiAspect::Scale)
+		{
+			m_screenSize *= m_parent->m_screenSize;
+			m_screenScale *= m_parent->m_screenScale;
+		}
+
+		m_screenPosition = (m_rectangle.GetScreenPosition(m_layoutAspectRatio) * m_parent->m_screenSize) - (m_screenSize * m_rectangle.GetReference()) + m_parent->m_screenPosition;
+		m_screenAlpha *= m_parent->m_screenAlpha;
+	}
+	else
+	{
+		m_screenPosition = m_rectangle.GetScreenPosition(m_layoutAspectRatio) - (m_screenSize * m_rectangle.GetReference());
+	}
+
+	// Children only recompute their layout when this layout actually moved.
+	m_layoutChanged = m_screenPosition != screenPosition || m_screenSize != screenSize || m_screenDepth != screenDepth || m_screenAlpha != screenAlpha ||
+		m_screenScale != screenScale;
+}
+
 void UiObject::SetParent(UiObject *parent)
 {
 	if (m_parent != nullptr)
@@ -133,6 +207,7 @@ void UiObject::SetParent(UiObject *parent)
 	}
 
 	m_parent = parent;
+	m_layoutDirty = true;
 }
 
 void UiObject::AddChild(UiObject *child)
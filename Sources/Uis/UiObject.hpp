@@ -6,10 +6,13 @@
 #include "Maths/Vector4.hpp"
 #include "Maths/Transform.hpp"
 #include "Maths/Visual/Driver.hpp"
+#include "Maths/Visual/Tweens.hpp"
 #include "UiBound.hpp"
 
 namespace acid
 {
+class Uis;
+
 /**
  * @brief A representation of a object this is rendered to a screen. This object is contained in a parent and has children.
  * The screen object has a few values that allow for it to be positioned and scaled, along with other variables that are used when rendering.
@@ -29,7 +32,8 @@ public:
 	virtual ~UiObject();
 
 	/**
-	 * Updates this screen object and the extended object.
+	 * Updates this screen object and the extended object. The layout is only recomputed when the bounds, parent, drivers or window aspect ratio changed,
+	 * children of a object whose layout did not change skip their layout as well.
 	 * @param list The list to add to.
 	 */
 	void Update(std::vector<UiObject *> &list);
@@ -39,6 +43,12 @@ public:
 	 */
 	virtual void UpdateObject();
 
+	/**
+	 * Adds this object to the typed lists renderers read from, called each update while the object is visible.
+	 * @param uis The module holding the lists.
+	 */
+	virtual void AddToLists(Uis &uis);
+
 	UiObject *GetParent() const { return m_parent; }
 
 	/**
@@ -69,7 +79,7 @@ public:
 
 	UiBound &GetRectangle() { return m_rectangle; }
 
-	void SetRectangle(const UiBound &rectangle) { m_rectangle = rectangle; }
+	void SetRectangle(const UiBound &rectangle) { m_rectangle = rectangle; m_layoutDirty = true; }
 
 	const Vector4f &GetScissor() const { return m_scissor; }
 
@@ -77,7 +87,7 @@ public:
 
 	const float &GetHeight() const { return m_height; }
 
-	void SetHeight(const float &height) { m_height = height; }
+	void SetHeight(const float &height) { m_height = height; m_layoutDirty = true; }
 
 	const bool &IsLockRotation() const { return m_lockRotation; }
 
@@ -93,22 +103,56 @@ public:
 	 * Sets the world transform applied to the object.
 	 * @param transform The new world space transform.
 	 */
-	void SetWorldTransform(const std::optional<Transform> &transform) { m_worldTransform = transform; }
+	void SetWorldTransform(const std::optional<Transform> &transform) { m_worldTransform = transform; m_layoutDirty = true; }
 
 	Matrix4 GetModelMatrix() const;
 
 	Driver<float> *GetAlphaDriver() const { return m_alphaDriver.get(); }
 
-	void SetAlphaDriver(Driver<float> *alphaDriver) { m_alphaDriver.reset(alphaDriver); }
+	/**
+	 * Sets the driver of the alpha, it replaces any alpha tween.
+	 * @param alphaDriver The new alpha driver, or nullptr to keep the current alpha.
+	 */
+	void SetAlphaDriver(Driver<float> *alphaDriver);
 
 	const float &GetAlpha() const { return m_alpha; }
 
+	/**
+	 * Sets the alpha, it replaces the alpha driver and tween.
+	 * @param alpha The new alpha.
+	 */
+	void SetAlpha(const float &alpha);
+
+	/**
+	 * Slides the alpha from its current value, it replaces the alpha driver and tween.
+	 * @param alpha The alpha to slide to.
+	 * @param length The time taken to get to the alpha.
+	 */
+	void TweenAlpha(const float &alpha, const Time &length);
+
 	Driver<Vector2f> *GetScaleDriver() const { return m_scaleDriver.get(); }
 
-	void SetScaleDriver(Driver<Vector2f> *scaleDriver) { m_scaleDriver.reset(scaleDriver); }
+	/**
+	 * Sets the driver of the scale, it replaces any scale tween.
+	 * @param scaleDriver The new scale driver, or nullptr to keep the current scale.
+	 */
+	void SetScaleDriver(Driver<Vector2f> *scaleDriver);
 
 	const Vector2f &GetScale() const { return m_scale; }
 
+	/**
+	 * Sets the scale, it replaces the scale driver and tween.
+	 * @param scale The new scale.
+	 */
+	void SetScale(const Vector2f &scale);
+
+	/**
+	 * Slides the scale from its current value, it replaces the scale driver and tween.
+	 * @param scale The scale to slide to.
+	 * @param length The time taken to get to the scale.
+	 */
+	void TweenScale(const Vector2f &scale, const Time &length);
+
 	const Vector2f &GetScreenPosition() const { return m_screenPosition; }
 
 	const Vector2f &GetScreenSize() const { return m_screenSize; }
@@ -129,17 +173,24 @@ public:
 	 * Called when this object has been clicked on.
 	 * @return The delegate.
 	 */
-	Delegate<void(MouseButton)> &OnClick() { return m_onClick; }
+	DelegateLocal<void(MouseButton)> &OnClick() { return m_onClick; }
 
 	/**
 	 * Called when this object has has the cursor hovered over, or removed.
 	 * @return The delegate.
 	 */
-	Delegate<void(bool)> &OnSelected() { return m_onSelected; }
+	DelegateLocal<void(bool)> &OnSelected() { return m_onSelected; }
 
 	void CancelEvent(const MouseButton &button) const;
 
+	/**
+	 * Forces the layout of this object and its children to be recomputed on the next update.
+	 */
+	void SetLayoutDirty() { m_layoutDirty = true; }
+
 private:
+	void UpdateLayout();
+
 	UiObject *m_parent;
 	std::vector<UiObject *> m_children;
 
@@ -152,9 +203,11 @@ private:
 	std::optional<Transform> m_worldTransform;
 
 	std::unique_ptr<Driver<float>> m_alphaDriver;
+	Tween m_alphaTween;
 	float m_alpha;
 
 	std::unique_ptr<Driver<Vector2f>> m_scaleDriver;
+	Tween m_scaleTween;
 	Vector2f m_scale;
 
 	Vector2f m_screenPosition;
@@ -164,7 +217,14 @@ private:
 	Vector2f m_screenScale;
 	bool m_selected;
 
-	Delegate<void(MouseButton)> m_onClick;
-	Delegate<void(bool)> m_onSelected;
+	// The bounds and aspect ratio the layout was last computed with, bounds can be changed through the reference from GetRectangle.
+	UiBound m_layoutRectangle;
+	float m_layoutAspectRatio;
+	bool m_layoutDirty;
+	// If the layout changed during this update, so children have to recompute theirs.
+	bool m_layoutChanged;
+
+	DelegateLocal<void(MouseButton)> m_onClick;
+	DelegateLocal<void(bool)> m_onSelected;
 };
 }
@@ -1,6 +1,5 @@
 #include "UiScrollBar.hpp"
 
-#include "Maths/Visual/DriverSlide.hpp"
 #include "Inputs/UiInputButton.hpp"
 #include "Uis.hpp"
 
@@ -18,6 +17,11 @@ UiScrollBar::UiScrollBar(UiObject *parent, const ScrollBar &type, const UiBound
 	m_updating(false),
 	m_mouseOver(false)
 {
+	if (!Engine::Get()->HasModule<Mouse>())
+	{
+		return;
+	}
+
 	Mouse::Get()->OnScroll().Add([this](Vector2f wheelDelta)
 	{
 		if (GetParent()->IsSelected() && !m_updating && m_scroll.IsEnabled())
@@ -52,12 +56,12 @@ void UiScrollBar::UpdateObject()
 	{
 		if (m_scroll.IsSelected() && !m_mouseOver)
 		{
-			m_scroll.SetColourDriver(new DriverSlide<Colour>(m_scroll.GetColourOffset(), SelectedColour, UiInputButton::SlideTime));
+			m_scroll.TweenColourOffset(SelectedColour, UiInputButton::SlideTime);
 			m_mouseOver = true;
 		}
 		else if (!m_scroll.IsSelected() && m_mouseOver)
 		{
-			m_scroll.SetColourDriver(new DriverSlide<Colour>(m_scroll.GetColourOffset(), PrimaryColour, UiInputButton::SlideTime));
+			m_scroll.TweenColourOffset(PrimaryColour, UiInputButton::SlideTime);
 			m_mouseOver = false;
 		}
 	}
@@ -69,6 +73,13 @@ float UiScrollBar::GetProgress()
 	return m_scroll.GetRectangle().GetPosition()[m_index];
 }
 
+void UiScrollBar::SetProgress(const float &progress)
+{
+	Vector2f position = Vector2f();
+	position[m_index] = progress;
+	m_scroll.GetRectangle().SetPosition(position);
+}
+
 void UiScrollBar::SetSize(const Vector2f &size)
 {
 	m_scroll.GetRectangle().SetSize(size);
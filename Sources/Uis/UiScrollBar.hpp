@@ -22,6 +22,12 @@ public:
 
 	float GetProgress();
 
+	/**
+	 * Moves the puck to a position along the bar.
+	 * @param progress The position of the start of the puck, as a fraction of the bar.
+	 */
+	void SetProgress(const float &progress);
+
 	void SetSize(const Vector2f &size);
 
 	static const Colour BackgroundColour;
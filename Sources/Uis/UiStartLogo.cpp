@@ -1,7 +1,5 @@
 ﻿#include "UiStartLogo.hpp"
 
-#include "Maths/Visual/DriverSlide.hpp"
-
 namespace acid
 {
 #if defined(ACID_VERBOSE)
@@ -33,7 +31,7 @@ void UiStartLogo::UpdateObject()
 	{
 		m_delayTimer.ResetStartTime();
 		m_fadeout = true;
-		SetAlphaDriver(new DriverSlide<float>(1.0f, 0.0f, Time::Seconds(1.4f)));
+		TweenAlpha(0.0f, Time::Seconds(1.4f));
 	}
 
 	if (GetScreenAlpha() <= 0.0f && !m_finished)
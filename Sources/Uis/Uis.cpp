@@ -1,5 +1,9 @@
 #include "Uis.hpp"
 
+#include "Devices/Window.hpp"
+#include "Fonts/Text.hpp"
+#include "Maths/Visual/Tweens.hpp"
+
 namespace acid
 {
 Uis::Uis() :
@@ -13,15 +17,55 @@ Uis::Uis() :
 
 void Uis::Update()
 {
+	m_pressedButtons.clear();
+
+	// Headless engines have no mouse, nothing is pressed or picked.
+	auto hasMouse = Engine::Get()->HasModule<Mouse>();
+
 	for (auto &[button, selector] : m_selectors)
 	{
-		bool isDown = Mouse::Get()->GetButton(button) != InputAction::Release;
+		bool isDown = hasMouse && Mouse::Get()->GetButton(button) != InputAction::Release;
 		selector.m_wasDown = !selector.m_isDown && isDown;
 		selector.m_isDown = isDown;
+
+		if (selector.m_wasDown)
+		{
+			m_pressedButtons.emplace_back(button);
+		}
+	}
+
+	// Objects are picked with the rectangles from the last update, the grid holds copies of them so objects destroyed since are never read.
+	if (hasMouse && Mouse::Get()->IsWindowSelected() && Window::Get()->IsFocused())
+	{
+		m_grid.Pick(Mouse::Get()->GetPosition(), m_picked);
+	}
+	else
+	{
+		m_picked.clear();
 	}
 
+	// Tweens are advanced together before the objects reading them are updated.
+	Tweens::Get()->Update(Engine::Get()->GetDelta());
+
 	m_objects.clear();
+	m_guis.clear();
+	m_texts.clear();
+
+	// Buckets not filled during the last update are removed, so font types that are no longer used are released.
+	for (auto it = m_fontTexts.begin(); it != m_fontTexts.end();)
+	{
+		if (it->second.empty())
+		{
+			it = m_fontTexts.erase(it);
+			continue;
+		}
+
+		it->second.clear();
+		++it;
+	}
+
 	m_container.Update(m_objects);
+	m_grid.Build(m_objects);
 }
 
 void Uis::CancelWasEvent(const MouseButton &button)
@@ -38,4 +82,19 @@ bool Uis::WasDown(const MouseButton &button)
 {
 	return m_selectors[button].m_wasDown;
 }
+
+void Uis::AddText(Text *text)
+{
+	m_texts.emplace_back(text);
+
+	if (text->GetFontType() != nullptr)
+	{
+		m_fontTexts[text->GetFontType()].emplace_back(text);
+	}
+}
+
+bool Uis::IsPicked(const UiObject *object) const
+{
+	return std::find(m_picked.begin(), m_picked.end(), object) != m_picked.end();
+}
 }
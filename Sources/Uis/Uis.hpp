@@ -2,10 +2,15 @@
 
 #include "Engine/Engine.hpp"
 #include "Devices/Mouse.hpp"
+#include "UiGrid.hpp"
 #include "UiObject.hpp"
 
 namespace acid
 {
+class FontType;
+class Gui;
+class Text;
+
 /**
  * @brief Module used for managing gui textures in a container.
  */
@@ -29,6 +34,31 @@ public:
 
 	bool WasDown(const MouseButton &button);
 
+	/**
+	 * Gets the buttons that were pressed this update.
+	 * @return The pressed buttons.
+	 */
+	const std::vector<MouseButton> &GetPressedButtons() const { return m_pressedButtons; }
+
+	/**
+	 * Gets if a object was under the cursor when this update started.
+	 * @param object The object.
+	 * @return If the object is under the cursor.
+	 */
+	bool IsPicked(const UiObject *object) const;
+
+	/**
+	 * Gets the front most object under the cursor, found using the rectangles from the last update.
+	 * @return The object, or nullptr if the cursor is not over any object.
+	 */
+	UiObject *GetPicked() const { return m_picked.empty() ? nullptr : m_picked.front(); }
+
+	/**
+	 * Gets the objects under the cursor, front most first.
+	 * @return The picked objects.
+	 */
+	const std::vector<UiObject *> &GetPickedObjects() const { return m_picked; }
+
 	/**
 	 * Gets the screen container.
 	 * @return The screen container.
@@ -40,6 +70,37 @@ public:
 	 * @return The objects.
 	 */
 	const std::vector<UiObject *> &GetObjects() const { return m_objects; };
+
+	/**
+	 * Adds a visible gui with a image to this updates list, called from {@link UiObject#AddToLists}.
+	 * @param gui The gui.
+	 */
+	void AddGui(Gui *gui) { m_guis.emplace_back(gui); }
+
+	/**
+	 * Adds a visible text to this updates lists, called from {@link UiObject#AddToLists}.
+	 * @param text The text.
+	 */
+	void AddText(Text *text);
+
+	/**
+	 * The visible guis with a image from the container, in update order.
+	 * @return The guis.
+	 */
+	const std::vector<Gui *> &GetGuis() const { return m_guis; }
+
+	/**
+	 * The visible texts from the container, in update order.
+	 * @return The texts.
+	 */
+	const std::vector<Text *> &GetTexts() const { return m_texts; }
+
+	/**
+	 * The visible texts grouped by font type, buckets are kept between updates so filling them does not allocate.
+	 * A bucket may be empty for the update after its font type stopped being used.
+	 * @return The texts by font type.
+	 */
+	const std::map<std::shared_ptr<FontType>, std::vector<Text *>> &GetTextsByFont() const { return m_fontTexts; }
 private:
 	struct SelectorMouse
 	{
@@ -48,7 +109,13 @@ private:
 	};
 
 	std::map<MouseButton, SelectorMouse> m_selectors;
+	std::vector<MouseButton> m_pressedButtons;
 	UiObject m_container;
 	std::vector<UiObject *> m_objects;
+	std::vector<Gui *> m_guis;
+	std::vector<Text *> m_texts;
+	std::map<std::shared_ptr<FontType>, std::vector<Text *>> m_fontTexts;
+	UiGrid m_grid;
+	std::vector<UiObject *> m_picked;
 };
 }
@@ -0,0 +1,60 @@
+#include "Benchmark.hpp"
+
+#include <Engine/Engine.hpp>
+#include <Files/Files.hpp>
+#include <Graphics/Graphics.hpp>
+#include <Scenes/Scenes.hpp>
+#include "BenchmarkScene.hpp"
+#include "MainRenderer.hpp"
+#include "Report.hpp"
+
+namespace test
+{
+Benchmark::Benchmark(Scenario scenario, std::string output, std::string label) :
+	m_scenario(std::move(scenario)),
+	m_output(std::move(output)),
+	m_label(std::move(label)),
+	m_frame(0)
+{
+	// Registers file search paths.
+	Files::Get()->AddSearchPath("Resources/Engine");
+
+	// Every measured frame is kept, GPU regions are only recorded while the GPU is timed.
+	auto profiler = Engine::Get()->GetProfiler();
+	profiler->SetHistorySize(m_scenario.m_warmupFrames + m_scenario.m_frames);
+	profiler->SetEnabled(true);
+	Graphics::Get()->SetGpuTimed(true);
+
+	Graphics::Get()->SetRenderer(new MainRenderer());
+	Scenes::Get()->SetScene(new BenchmarkScene(m_scenario));
+}
+
+Benchmark::~Benchmark()
+{
+	Files::Get()->ClearSearchPath();
+
+	Graphics::Get()->SetRenderer(nullptr);
+	Scenes::Get()->SetScene(nullptr);
+}
+
+void Benchmark::Update()
+{
+	// With fixed frames every update is followed by one rendered frame, so updates count frames, the report is made once after the last frame.
+	if (++m_frame != m_scenario.m_warmupFrames + m_scenario.m_frames + 1)
+	{
+		return;
+	}
+
+	auto frames = Engine::Get()->GetProfiler()->GetFrames();
+
+	if (frames.size() > m_scenario.m_frames)
+	{
+		frames.erase(frames.begin(), frames.end() - m_scenario.m_frames);
+	}
+
+	Report report(m_scenario, frames, m_label);
+	report.Print();
+	report.Write(m_output);
+	Engine::Get()->RequestClose(false);
+}
+}
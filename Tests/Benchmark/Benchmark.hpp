@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Engine/Game.hpp>
+#include "Scenario.hpp"
+
+using namespace acid;
+
+namespace test
+{
+/**
+ * @brief Game that runs a scenario for its warmup and measured frames, then writes the profiled timings of the measured frames as a report.
+ */
+class Benchmark :
+	public Game
+{
+public:
+	/**
+	 * Creates a new benchmark.
+	 * @param scenario The scenario to run.
+	 * @param output The Json file the report is written to.
+	 * @param label A name for the run stored in the report, such as a commit hash.
+	 */
+	Benchmark(Scenario scenario, std::string output, std::string label);
+
+	~Benchmark();
+
+	void Update() override;
+
+private:
+	Scenario m_scenario;
+	std::string m_output;
+	std::string m_label;
+	uint32_t m_frame;
+};
+}
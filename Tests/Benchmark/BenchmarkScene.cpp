@@ -0,0 +1,89 @@
+#include "BenchmarkScene.hpp"
+
+#include <Emitters/EmitterSphere.hpp>
+#include <Helpers/String.hpp>
+#include <Lights/Light.hpp>
+#include <Materials/MaterialDefault.hpp>
+#include <Maths/Maths.hpp>
+#include <Meshes/Mesh.hpp>
+#include <Meshes/MeshRender.hpp>
+#include <Models/Shapes/ModelCube.hpp>
+#include <Models/Shapes/ModelSphere.hpp>
+#include <Particles/ParticleSystem.hpp>
+#include <Uis/Uis.hpp>
+#include "CameraPath.hpp"
+
+namespace test
+{
+static const float ENTITY_SPACING = 1.5f;
+static const uint32_t UI_COLUMNS = 24;
+
+BenchmarkScene::BenchmarkScene(const Scenario &scenario) :
+	Scene(new CameraPath(scenario.m_cameraRadius, scenario.m_cameraHeight, scenario.m_cameraSpeed)),
+	m_scenario(scenario)
+{
+}
+
+void BenchmarkScene::Start()
+{
+	Maths::SetRandomSeed(m_scenario.m_seed);
+
+	GetPhysics()->SetGravity(Vector3f(0.0f, -9.81f, 0.0f));
+
+	auto skybox = GetStructure()->CreateEntity("Objects/SkyboxClouds/SkyboxClouds.json", Transform(Vector3f(), Vector3f(), 2048.0f));
+
+	auto sun = GetStructure()->CreateEntity(Transform(Vector3f(1000.0f, 5000.0f, -4000.0f), Vector3f(), 18.0f));
+	sun->AddComponent<Light>(Colour::White);
+
+	auto ground = GetStructure()->CreateEntity(Transform(Vector3f(0.0f, -1.0f, 0.0f), Vector3f(), Vector3f(200.0f, 1.0f, 200.0f)));
+	ground->AddComponent<Mesh>(ModelCube::Create(Vector3f(1.0f, 1.0f, 1.0f)));
+	ground->AddComponent<MaterialDefault>(Colour::Grey, nullptr, 0.0f, 1.0f);
+	ground->AddComponent<MeshRender>();
+
+	// Meshes are placed in a square grid centred on the origin, alternating models so both instanced and unique draws are measured.
+	std::shared_ptr<Model> sphereModel = ModelSphere::Create(0.5f, 20, 20);
+	std::shared_ptr<Model> cubeModel = ModelCube::Create(Vector3f(1.0f, 1.0f, 1.0f));
+	auto side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(m_scenario.m_entities))));
+
+	for (uint32_t i = 0; i < m_scenario.m_entities; i++)
+	{
+		auto x = (static_cast<float>(i % side) - 0.5f * static_cast<float>(side)) * ENTITY_SPACING;
+		auto z = (static_cast<float>(i / side) - 0.5f * static_cast<float>(side)) * ENTITY_SPACING;
+
+		auto entity = GetStructure()->CreateEntity(Transform(Vector3f(x, 0.0f, z), Vector3f(0.0f, Maths::Random(0.0f, 360.0f), 0.0f), 0.5f));
+		entity->AddComponent<Mesh>(i % 2 == 0 ? sphereModel : cubeModel);
+		entity->AddComponent<MaterialDefault>(Colour(Maths::Random(), Maths::Random(), Maths::Random()), nullptr, Maths::Random(), Maths::Random());
+		entity->AddComponent<MeshRender>();
+	}
+
+	// Emitters are placed in a ring inside the camera path.
+	auto particleTypes = std::vector<std::shared_ptr<ParticleType>>{
+		ParticleType::Create(Image2d::Create("Objects/Smoke/Circular.png"), 4, Colour::Blue, 3.0f, 1.0f, 0.5f),
+		ParticleType::Create(Image2d::Create("Objects/Smoke/Circular.png"), 4, Colour::Yellow, 2.0f, 1.0f, 0.3f)
+	};
+
+	for (uint32_t i = 0; i < m_scenario.m_emitters; i++)
+	{
+		auto angle = 2.0f * Maths::Pi * static_cast<float>(i) / static_cast<float>(m_scenario.m_emitters);
+		auto radius = 0.5f * m_scenario.m_cameraRadius;
+
+		auto emitter = GetStructure()->CreateEntity(Transform(Vector3f(radius * std::sin(angle), 2.0f, radius * std::cos(angle))));
+		emitter->AddComponent<EmitterSphere>(1.0f);
+		emitter->AddComponent<ParticleSystem>(particleTypes, m_scenario.m_particlesPerSecond, 1.0f, -0.1f);
+	}
+
+	// Buttons fill the screen in rows, each has a background and a text so both guis and fonts are measured.
+	auto rows = (m_scenario.m_uis + UI_COLUMNS - 1) / UI_COLUMNS;
+
+	for (uint32_t i = 0; i < m_scenario.m_uis; i++)
+	{
+		auto position = Vector2f(static_cast<float>(i % UI_COLUMNS) / static_cast<float>(UI_COLUMNS), static_cast<float>(i / UI_COLUMNS) / static_cast<float>(rows));
+		m_buttons.emplace_back(std::make_unique<UiInputButton>(&Uis::Get()->GetContainer(), "Button " + String::To(i),
+			UiBound(position, UiReference::TopLeft, UiAspect::Position | UiAspect::Size)));
+	}
+}
+
+void BenchmarkScene::Update()
+{
+}
+}
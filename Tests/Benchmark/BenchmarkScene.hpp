@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Scenes/Scene.hpp>
+#include <Uis/Inputs/UiInputButton.hpp>
+#include "Scenario.hpp"
+
+using namespace acid;
+
+namespace test
+{
+/**
+ * @brief Scene that spawns the meshes, emitters and buttons of a scenario, everything random is seeded by the scenario.
+ */
+class BenchmarkScene :
+	public Scene
+{
+public:
+	explicit BenchmarkScene(const Scenario &scenario);
+
+	void Start() override;
+
+	void Update() override;
+
+	bool IsPaused() const override { return false; }
+
+private:
+	Scenario m_scenario;
+	std::vector<std::unique_ptr<UiInputButton>> m_buttons;
+};
+}
@@ -0,0 +1,40 @@
+#include "CameraPath.hpp"
+
+#include <Engine/Engine.hpp>
+#include <Graphics/Graphics.hpp>
+#include <Maths/Maths.hpp>
+
+namespace test
+{
+CameraPath::CameraPath(const float &radius, const float &height, const float &speed) :
+	m_radius(radius),
+	m_height(height),
+	m_speed(speed),
+	m_angle(0.0f)
+{
+	m_nearPlane = 0.1f;
+	m_farPlane = 2048.0f;
+	m_fieldOfView = 65.0f;
+}
+
+void CameraPath::Start()
+{
+}
+
+void CameraPath::Update()
+{
+	auto delta = Engine::Get()->GetDelta().AsSeconds();
+	m_angle = std::fmod(m_angle + m_speed * delta, 360.0f);
+
+	auto position = Vector3f(m_radius * std::sin(m_angle * Maths::DegToRad), m_height, m_radius * std::cos(m_angle * Maths::DegToRad));
+	m_velocity = delta > 0.0f ? (position - m_position) / delta : Vector3f();
+	m_position = position;
+	m_rotation = Vector3f(0.0f, m_angle, 0.0f);
+
+	m_viewMatrix = Matrix4::LookAt(m_position, Vector3f());
+	m_projectionMatrix = Matrix4::PerspectiveMatrix(GetFieldOfView() * Maths::DegToRad, Graphics::Get()->GetDisplayAspectRatio(), GetNearPlane(), GetFarPlane());
+
+	m_viewFrustum.Update(m_viewMatrix, m_projectionMatrix);
+	m_viewRay.Update(m_position, Vector2f(0.5f, 0.5f), m_viewMatrix, m_projectionMatrix);
+}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Scenes/Camera.hpp>
+
+using namespace acid;
+
+namespace test
+{
+/**
+ * @brief Camera that moves around a circle looking at the origin, it only moves with the update delta so fixed frames always see the same views.
+ */
+class CameraPath :
+	public Camera
+{
+public:
+	CameraPath(const float &radius, const float &height, const float &speed);
+
+	void Start() override;
+
+	void Update() override;
+
+private:
+	float m_radius;
+	float m_height;
+	float m_speed;
+	float m_angle;
+};
+}
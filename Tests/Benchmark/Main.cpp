@@ -0,0 +1,97 @@
+#include <Engine/Engine.hpp>
+#include <Engine/Log.hpp>
+#include <Helpers/String.hpp>
+#include "Benchmark.hpp"
+
+using namespace acid;
+
+static void LogUsage()
+{
+	Log::Out("Usage: Benchmark <scenario> [--frames <count>] [--warmup <count>] [--size <width>x<height>] [--output <report.json>] [--label <name>] [--window]\n");
+	std::string presets;
+
+	for (const auto &name : test::Scenario::GetPresetNames())
+	{
+		presets += name + ", ";
+	}
+
+	Log::Out("Scenarios: %sor a scenario .json file\n", presets.c_str());
+}
+
+int main(int argc, char **argv)
+{
+	using namespace test;
+
+	if (argc < 2)
+	{
+		LogUsage();
+		return EXIT_FAILURE;
+	}
+
+	auto scenario = Scenario::Find(argv[1]);
+
+	if (!scenario)
+	{
+		Log::Error("Unknown benchmark scenario: '%s'\n", argv[1]);
+		LogUsage();
+		return EXIT_FAILURE;
+	}
+
+	// Runs headless with fixed frames by default, so every run simulates and renders the same frames.
+	Engine::Config config;
+	config.m_headless = true;
+	config.m_fixedFrames = true;
+	std::string output = "Benchmarks/" + scenario->m_name + ".json";
+	std::string label;
+
+	for (int32_t i = 2; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		auto hasValue = i + 1 < argc;
+
+		if (argument == "--frames" && hasValue)
+		{
+			scenario->m_frames = String::From<uint32_t>(argv[++i]);
+		}
+		else if (argument == "--warmup" && hasValue)
+		{
+			scenario->m_warmupFrames = String::From<uint32_t>(argv[++i]);
+		}
+		else if (argument == "--size" && hasValue)
+		{
+			auto size = String::Split(argv[++i], "x");
+
+			if (size.size() == 2)
+			{
+				config.m_headlessSize = Vector2ui(String::From<uint32_t>(size[0]), String::From<uint32_t>(size[1]));
+			}
+		}
+		else if (argument == "--output" && hasValue)
+		{
+			output = argv[++i];
+		}
+		else if (argument == "--label" && hasValue)
+		{
+			label = argv[++i];
+		}
+		else if (argument == "--window")
+		{
+			config.m_headless = false;
+		}
+		else
+		{
+			Log::Error("Unknown benchmark argument: '%s'\n", argument.c_str());
+			LogUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Creates the engine, the fixed update rate is the timestep of every frame.
+	auto engine = std::make_unique<Engine>(argv[0], config);
+	engine->SetUpsLimit(60.0f);
+	engine->SetFpsLimit(-1.0f);
+	engine->SetGame(new Benchmark(*scenario, output, label));
+
+	// Runs the game loop.
+	return engine->Run();
+}
@@ -0,0 +1,157 @@
+#include "Report.hpp"
+
+#include <Engine/Engine.hpp>
+#include <Engine/Log.hpp>
+#include <Files/File.hpp>
+#include <Serialized/Json/Json.hpp>
+
+namespace test
+{
+// Nearest rank percentile of sorted samples.
+static double Percentile(const std::vector<double> &sorted, const double &percentile)
+{
+	auto rank = static_cast<std::size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+	return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+Report::Stats Report::Stats::Compute(std::vector<double> samples)
+{
+	Stats stats;
+
+	if (samples.empty())
+	{
+		return stats;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	stats.m_samples = static_cast<uint32_t>(samples.size());
+	stats.m_mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+	stats.m_min = samples.front();
+	stats.m_max = samples.back();
+	stats.m_p50 = Percentile(samples, 50.0);
+	stats.m_p90 = Percentile(samples, 90.0);
+	stats.m_p95 = Percentile(samples, 95.0);
+	stats.m_p99 = Percentile(samples, 99.0);
+	return stats;
+}
+
+Metadata &operator<<(Metadata &metadata, const Report::Stats &stats)
+{
+	metadata.SetChild("Samples", stats.m_samples);
+	metadata.SetChild("Mean", stats.m_mean);
+	metadata.SetChild("Min", stats.m_min);
+	metadata.SetChild("Max", stats.m_max);
+	metadata.SetChild("P50", stats.m_p50);
+	metadata.SetChild("P90", stats.m_p90);
+	metadata.SetChild("P95", stats.m_p95);
+	metadata.SetChild("P99", stats.m_p99);
+	return metadata;
+}
+
+Report::Report(const Scenario &scenario, const std::vector<Profiler::Frame> &frames, std::string label) :
+	m_scenario(scenario),
+	m_label(std::move(label)),
+	m_date(Engine::GetDateTime())
+{
+	std::vector<double> frameSamples;
+	std::map<std::string, std::map<std::string, std::vector<double>>> regionSamples;
+	std::map<std::string, std::vector<double>> counterSamples;
+
+	for (const auto &frame : frames)
+	{
+		frameSamples.emplace_back(frame.m_duration.AsMicroseconds<double>() / 1000.0);
+
+		// Regions that run more than once a frame, such as a subrender in several stages, are summed.
+		std::map<std::pair<std::string, std::string>, double> frameRegions;
+
+		for (const auto &marker : frame.m_markers)
+		{
+			frameRegions[{ marker.m_category, marker.m_name }] += marker.m_duration.AsMicroseconds<double>() / 1000.0;
+		}
+
+		for (const auto &[region, milliseconds] : frameRegions)
+		{
+			regionSamples[region.first][region.second].emplace_back(milliseconds);
+		}
+
+		for (const auto &[name, value] : frame.m_counters)
+		{
+			counterSamples[name].emplace_back(value);
+		}
+	}
+
+	m_frame = Stats::Compute(std::move(frameSamples));
+
+	for (auto &[category, regions] : regionSamples)
+	{
+		for (auto &[name, samples] : regions)
+		{
+			m_categories[category][name] = Stats::Compute(std::move(samples));
+		}
+	}
+
+	for (auto &[name, samples] : counterSamples)
+	{
+		m_counters[name] = Stats::Compute(std::move(samples));
+	}
+}
+
+void Report::Write(const std::string &filename) const
+{
+	Metadata metadata;
+	metadata << *this;
+	File(filename, new Json(&metadata)).Write();
+	Log::Out("Benchmark report written to '%s'\n", filename.c_str());
+}
+
+void Report::Print(const std::size_t &count) const
+{
+	Log::Out("Benchmark '%s', %u frames: mean %.3fms, p50 %.3fms, p99 %.3fms, max %.3fms\n", m_scenario.m_name.c_str(), m_frame.m_samples, m_frame.m_mean, m_frame.m_p50,
+		m_frame.m_p99, m_frame.m_max);
+
+	for (const auto &[category, regions] : m_categories)
+	{
+		std::vector<std::pair<std::string, Stats>> sorted(regions.begin(), regions.end());
+		std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b)
+		{
+			return a.second.m_mean > b.second.m_mean;
+		});
+
+		Log::Out("-- %s --\n", category.c_str());
+
+		for (std::size_t i = 0; i < std::min(count, sorted.size()); i++)
+		{
+			Log::Out("%s: mean %.3fms, p99 %.3fms\n", sorted[i].first.c_str(), sorted[i].second.m_mean, sorted[i].second.m_p99);
+		}
+	}
+}
+
+Metadata &operator<<(Metadata &metadata, const Report &report)
+{
+	metadata.SetChild("Label", report.m_label);
+	metadata.SetChild("Date", report.m_date);
+	metadata.SetChild("Scenario", report.m_scenario);
+	metadata.SetChild("Frame", report.m_frame);
+
+	auto categories = metadata.CreateChild("Categories");
+
+	for (const auto &[category, regions] : report.m_categories)
+	{
+		auto categoryMetadata = categories->CreateChild(category);
+
+		for (const auto &[name, stats] : regions)
+		{
+			*categoryMetadata->CreateChild(name) << stats;
+		}
+	}
+
+	auto counters = metadata.CreateChild("Counters");
+
+	for (const auto &[name, stats] : report.m_counters)
+	{
+		*counters->CreateChild(name) << stats;
+	}
+
+	return metadata;
+}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Engine/Profiler.hpp>
+#include "Scenario.hpp"
+
+using namespace acid;
+
+namespace test
+{
+/**
+ * @brief The timings of a benchmark run, summarised as percentiles so runs of different commits can be compared.
+ * Every profiler region is summed per frame, then summarised over the measured frames, regions are grouped by their category such as "cpu" and "gpu".
+ * Profiler counters, such as the heap memory and allocations of each subsystem, are summarised the same way.
+ */
+class Report
+{
+public:
+	/**
+	 * @brief A summary of the milliseconds a region took, or the values of a counter, over the frames it was recorded in.
+	 */
+	class Stats
+	{
+	public:
+		/**
+		 * Summarises a set of samples.
+		 * @param samples The samples, sorted by this function.
+		 * @return The summary, zero if there are no samples.
+		 */
+		static Stats Compute(std::vector<double> samples);
+
+		friend Metadata &operator<<(Metadata &metadata, const Stats &stats);
+
+		uint32_t m_samples = 0;
+		double m_mean = 0.0;
+		double m_min = 0.0;
+		double m_max = 0.0;
+		double m_p50 = 0.0;
+		double m_p90 = 0.0;
+		double m_p95 = 0.0;
+		double m_p99 = 0.0;
+	};
+
+	/**
+	 * Creates a report from profiled frames.
+	 * @param scenario The scenario that was run.
+	 * @param frames The measured frames, warmup frames must already be removed.
+	 * @param label A name for the run such as a commit hash, may be empty.
+	 */
+	Report(const Scenario &scenario, const std::vector<Profiler::Frame> &frames, std::string label);
+
+	/**
+	 * Writes the report as Json.
+	 * @param filename The file to write to.
+	 */
+	void Write(const std::string &filename) const;
+
+	/**
+	 * Logs the frame times and the slowest regions of each category.
+	 * @param count The number of regions logged per category.
+	 */
+	void Print(const std::size_t &count = 8) const;
+
+	friend Metadata &operator<<(Metadata &metadata, const Report &report);
+
+private:
+	Scenario m_scenario;
+	std::string m_label;
+	std::string m_date;
+	Stats m_frame;
+	std::map<std::string, std::map<std::string, Stats>> m_categories;
+	std::map<std::string, Stats> m_counters;
+};
+}
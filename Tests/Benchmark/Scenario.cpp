@@ -0,0 +1,121 @@
+#include "Scenario.hpp"
+
+#include <Engine/Log.hpp>
+#include <Files/FileSystem.hpp>
+#include <Helpers/String.hpp>
+#include <Serialized/Json/Json.hpp>
+
+namespace test
+{
+static const std::vector<Scenario> PRESETS = []()
+{
+	Scenario entities;
+	entities.m_name = "entities";
+	entities.m_entities = 2500;
+
+	Scenario particles;
+	particles.m_name = "particles";
+	particles.m_entities = 16;
+	particles.m_emitters = 24;
+	particles.m_particlesPerSecond = 400.0f;
+
+	Scenario uis;
+	uis.m_name = "uis";
+	uis.m_uis = 600;
+
+	Scenario combined;
+	combined.m_name = "combined";
+	combined.m_entities = 900;
+	combined.m_emitters = 8;
+	combined.m_uis = 150;
+
+	return std::vector<Scenario>{ entities, particles, uis, combined };
+}();
+
+// Values missing from a scenario file keep their defaults without being reported.
+template<typename T>
+static void ReadChild(const Metadata &metadata, const std::string &name, T &dest)
+{
+	if (auto child = metadata.FindChild(name, false))
+	{
+		*child >> dest;
+	}
+}
+
+std::optional<Scenario> Scenario::Find(const std::string &name)
+{
+	for (const auto &preset : PRESETS)
+	{
+		if (preset.m_name == name)
+		{
+			return preset;
+		}
+	}
+
+	if (String::Lowercase(FileSystem::FileSuffix(name)) != ".json")
+	{
+		return std::nullopt;
+	}
+
+	std::ifstream inStream(name, std::ios::binary);
+
+	if (!inStream)
+	{
+		Log::Error("Scenario file could not be read: '%s'\n", name.c_str());
+		return std::nullopt;
+	}
+
+	std::string contents((std::istreambuf_iterator<char>(inStream)), std::istreambuf_iterator<char>());
+	Json json;
+	json.Load(std::string_view(contents));
+
+	Scenario scenario;
+	scenario.m_name = name;
+	json >> scenario;
+	return scenario;
+}
+
+std::vector<std::string> Scenario::GetPresetNames()
+{
+	std::vector<std::string> names;
+
+	for (const auto &preset : PRESETS)
+	{
+		names.emplace_back(preset.m_name);
+	}
+
+	return names;
+}
+
+const Metadata &operator>>(const Metadata &metadata, Scenario &scenario)
+{
+	ReadChild(metadata, "Name", scenario.m_name);
+	ReadChild(metadata, "Frames", scenario.m_frames);
+	ReadChild(metadata, "Warmup Frames", scenario.m_warmupFrames);
+	ReadChild(metadata, "Seed", scenario.m_seed);
+	ReadChild(metadata, "Entities", scenario.m_entities);
+	ReadChild(metadata, "Emitters", scenario.m_emitters);
+	ReadChild(metadata, "Particles Per Second", scenario.m_particlesPerSecond);
+	ReadChild(metadata, "Uis", scenario.m_uis);
+	ReadChild(metadata, "Camera Radius", scenario.m_cameraRadius);
+	ReadChild(metadata, "Camera Height", scenario.m_cameraHeight);
+	ReadChild(metadata, "Camera Speed", scenario.m_cameraSpeed);
+	return metadata;
+}
+
+Metadata &operator<<(Metadata &metadata, const Scenario &scenario)
+{
+	metadata.SetChild("Name", scenario.m_name);
+	metadata.SetChild("Frames", scenario.m_frames);
+	metadata.SetChild("Warmup Frames", scenario.m_warmupFrames);
+	metadata.SetChild("Seed", scenario.m_seed);
+	metadata.SetChild("Entities", scenario.m_entities);
+	metadata.SetChild("Emitters", scenario.m_emitters);
+	metadata.SetChild("Particles Per Second", scenario.m_particlesPerSecond);
+	metadata.SetChild("Uis", scenario.m_uis);
+	metadata.SetChild("Camera Radius", scenario.m_cameraRadius);
+	metadata.SetChild("Camera Height", scenario.m_cameraHeight);
+	metadata.SetChild("Camera Speed", scenario.m_cameraSpeed);
+	return metadata;
+}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Serialized/Metadata.hpp>
+
+using namespace acid;
+
+namespace test
+{
+/**
+ * @brief The script of a benchmark run, what is spawned into the scene, how the camera moves, and how many frames are measured.
+ * Scenarios are built in presets or Json files with the same names as the preset values.
+ */
+class Scenario
+{
+public:
+	/**
+	 * Finds a built in scenario, or loads a scenario file when the name ends with ".json".
+	 * @param name The preset name or the file to load.
+	 * @return The scenario, or nullopt if there is no preset with the name or the file could not be read.
+	 */
+	static std::optional<Scenario> Find(const std::string &name);
+
+	/**
+	 * Gets the names of the built in scenarios.
+	 * @return The preset names.
+	 */
+	static std::vector<std::string> GetPresetNames();
+
+	friend const Metadata &operator>>(const Metadata &metadata, Scenario &scenario);
+
+	friend Metadata &operator<<(Metadata &metadata, const Scenario &scenario);
+
+	std::string m_name;
+	/// The number of frames measured, after the warmup frames.
+	uint32_t m_frames = 600;
+	/// The number of frames run before measuring, while pipelines and resources are created.
+	uint32_t m_warmupFrames = 120;
+	/// The seed of the random values used by the scene, such as particle directions.
+	uint32_t m_seed = 1;
+
+	/// The number of meshes placed in a grid around the origin.
+	uint32_t m_entities = 0;
+	/// The number of particle emitters placed in a ring around the origin.
+	uint32_t m_emitters = 0;
+	/// The particles spawned per second by each emitter.
+	float m_particlesPerSecond = 100.0f;
+	/// The number of buttons placed in a grid over the screen.
+	uint32_t m_uis = 0;
+
+	/// The radius of the circle the camera moves around, looking at the origin.
+	float m_cameraRadius = 24.0f;
+	float m_cameraHeight = 8.0f;
+	/// How fast the camera moves around the circle, in degrees per second.
+	float m_cameraSpeed = 15.0f;
+};
+}
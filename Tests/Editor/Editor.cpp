@@ -0,0 +1,57 @@
+#include "Editor.hpp"
+
+#include <Devices/Mouse.hpp>
+#include <Files/FileSystem.hpp>
+#include <Plugins/Plugins.hpp>
+#include <Scenes/Entity.hpp>
+#include <Uis/Uis.hpp>
+
+namespace test
+{
+Editor::Editor() :
+	m_panels(&Uis::Get()->GetContainer()),
+	m_buttonReload(Key::R)
+{
+	// Panels are moved above the user interface of the reloaded game.
+	Plugins::Get()->OnUnload().Add([this]()
+	{
+		m_panels.SetParent(nullptr);
+	}, this);
+	Plugins::Get()->OnReload().Add([this](uint32_t version)
+	{
+		Log::Out("[Editor] Reloaded plugin version %u\n", version);
+		m_panels.SetParent(&Uis::Get()->GetContainer());
+	}, this);
+
+	m_buttonReload.OnButton().Add([this](InputAction action, BitMask<InputMod> mods)
+	{
+		if (action == InputAction::Press)
+		{
+			FileSystem::Touch(Plugins::Get()->GetFilename());
+		}
+	});
+}
+
+void Editor::Update()
+{
+	// The entity under the cursor is picked every frame, a click selects it once the pick made that frame has finished.
+	auto pick = m_picker.Pick(Mouse::Get()->GetPosition());
+
+	// Clicks on the panels are cancelled by them, so they never select through the panels.
+	if (Uis::Get()->WasDown(MouseButton::Left))
+	{
+		m_selecting = pick;
+	}
+
+	if (m_selecting && m_picker.IsFinished(*m_selecting))
+	{
+		m_selected = m_picker.GetPicked();
+		m_selecting = std::nullopt;
+
+		if (auto entity = m_picker.GetPickedEntity())
+		{
+			Log::Out("[Editor] Selected entity '%s'\n", entity->GetName().c_str());
+		}
+	}
+}
+}
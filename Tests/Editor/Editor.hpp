@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Engine/Engine.hpp>
+#include <Scenes/EntityPicker.hpp>
+#include "Uis/Panels.hpp"
+#include "Inputs/ButtonKeyboard.hpp"
+
+using namespace acid;
+
+namespace test
+{
+/**
+ * Module used for the editor panels drawn over the reloadable game.
+ */
+class Editor :
+	public Module,
+	public Observer
+{
+public:
+	/**
+	 * Gets the engines instance.
+	 * @return The current module instance.
+	 */
+	static Editor *Get() { return Engine::Get()->GetModule<Editor>(); }
+
+	Editor();
+
+	void Update() override;
+
+	/**
+	 * Gets the entity selected by clicking on it.
+	 * @return The selected entity handle, a null handle if none is selected.
+	 */
+	const EntityHandle &GetSelected() const { return m_selected; }
+
+	/**
+	 * Gets the entity under the cursor, picked one frame behind the cursor.
+	 * @return The hovered entity handle, a null handle if none is hovered.
+	 */
+	EntityHandle GetHovered() const { return m_picker.GetPicked(); }
+
+private:
+	Panels m_panels;
+
+	EntityPicker m_picker;
+	EntityHandle m_selected;
+	/// The pick made when the entity under the cursor was clicked, it is selected once the pick has finished.
+	std::optional<uint64_t> m_selecting;
+
+	ButtonKeyboard m_buttonReload;
+};
+}
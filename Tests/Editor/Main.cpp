@@ -1,7 +1,11 @@
 #include <iostream>
 #include <Engine/Engine.hpp>
+#include <Engine/cr.h>
+#include <Files/FileSystem.hpp>
 #include <Graphics/Graphics.hpp>
-#include "Plugins.hpp"
+#include <Graphics/Pipelines/ShaderReloader.hpp>
+#include <Plugins/Plugins.hpp>
+#include "Editor.hpp"
 #include "MainRenderer.hpp"
 
 using namespace acid;
@@ -15,14 +19,17 @@ int main(int argc, char **argv)
 	// Registers file search paths.
 	Files::Get()->AddSearchPath("Resources/Engine");
 
-	// Registers modules.
+	// Registers modules, the game is loaded from the EditorTest plugin and reloaded when it is rebuilt.
 	Engine::Get()->AddModule<Plugins>(Module::Stage::Always);
+	Plugins::Get()->Load(FileSystem::GetWorkingDirectory() + FileSystem::Separator + CR_PLUGIN("EditorTest"));
+	Engine::Get()->AddModule<Editor>(Module::Stage::Always);
 
 	// Sets values to modules.
 	Window::Get()->SetTitle("Acid Editor");
 	Window::Get()->SetIcons({ "Icons/Icon-16.png", "Icons/Icon-24.png", "Icons/Icon-32.png", "Icons/Icon-48.png", "Icons/Icon-64.png",
 		"Icons/Icon-96.png", "Icons/Icon-128.png", "Icons/Icon-192.png", "Icons/Icon-256.png" });
 	Graphics::Get()->SetRenderer(new MainRenderer());
+	Graphics::Get()->GetShaderReloader()->Watch("Resources/Engine");
 
 	// Runs the game loop.
 	int32_t exitCode = engine->Run();
@@ -46,12 +46,14 @@ MainRenderer::MainRenderer()
 		Attachment(3, "diffuse", Attachment::Type::Image, false, VK_FORMAT_R8G8B8A8_UNORM), 
 		Attachment(4, "normal", Attachment::Type::Image, false, VK_FORMAT_R16G16B16A16_SFLOAT),
 		Attachment(5, "material", Attachment::Type::Image, false, VK_FORMAT_R8G8B8A8_UNORM), 
-		Attachment(6, "resolved", Attachment::Type::Image, false, VK_FORMAT_R8G8B8A8_UNORM) 
+		Attachment(6, "resolved", Attachment::Type::Image, false, VK_FORMAT_R8G8B8A8_UNORM),
+		Attachment(7, RenderStage::EntityAttachment, Attachment::Type::Image, false, VK_FORMAT_R32G32_UINT)
 	};
+	// Entities are written by the materials and by gizmos drawn over the scene, for picking them in the editor.
 	std::vector<SubpassType> renderpassSubpasses1 = { 
-		SubpassType(0, { 0, 2, 3, 4, 5 }), 
+		SubpassType(0, { 0, 2, 3, 4, 5, 7 }), 
 		SubpassType(1, { 0, 6 }), 
-		SubpassType(2, { 0, 1 })
+		SubpassType(2, { 0, 1, 7 })
 	};
 	renderStages.emplace_back(std::make_unique<RenderStage>(renderpassAttachments1, renderpassSubpasses1));
 
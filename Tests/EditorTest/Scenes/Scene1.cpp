@@ -7,8 +7,6 @@
 #include <Devices/Mouse.hpp>
 #include <Lights/Light.hpp>
 #include <Materials/MaterialDefault.hpp>
-#include <Maths/Visual/DriverConstant.hpp>
-#include <Maths/Visual/DriverSlide.hpp>
 #include <Meshes/Mesh.hpp>
 #include <Meshes/MeshRender.hpp>
 #include <Models/Obj/ModelObj.hpp>
@@ -124,12 +122,13 @@ Scene1::Scene1() :
 		}
 	});
 
-	m_uiStartLogo.SetAlphaDriver(new DriverConstant<float>(1.0f));
-	m_overlayDebug.SetAlphaDriver(new DriverConstant<float>(0.0f));
+	m_uiStartLogo.SetAlpha(1.0f);
+	m_overlayDebug.SetAlpha(0.0f);
 
 	m_uiStartLogo.OnFinished().Add([this]()
 	{
-		m_overlayDebug.SetAlphaDriver(new DriverSlide<float>(0.0f, 1.0f, UI_SLIDE_TIME));
+		m_overlayDebug.SetAlpha(0.0f);
+		m_overlayDebug.TweenAlpha(1.0f, UI_SLIDE_TIME);
 		Mouse::Get()->SetCursorHidden(true);
 	});
 }
@@ -0,0 +1,170 @@
+#include <Maths/Matrix4.hpp>
+#include <Maths/Maths.hpp>
+#include <Maths/Quaternion.hpp>
+#include <Maths/Noise/Noise.hpp>
+#include <Physics/Frustum.hpp>
+#include <Physics/FrustumCuller.hpp>
+#include "Microbenchmark.hpp"
+
+using namespace acid;
+
+namespace test
+{
+static const std::size_t BATCH_SIZE = 1024;
+
+static Matrix4 RandomMatrix()
+{
+	return Matrix4::TransformationMatrix(Vector3f(Maths::Random(-10.0f, 10.0f), Maths::Random(-10.0f, 10.0f), Maths::Random(-10.0f, 10.0f)),
+		Vector3f(Maths::Random(0.0f, 6.0f), Maths::Random(0.0f, 6.0f), Maths::Random(0.0f, 6.0f)), Vector3f(Maths::Random(0.5f, 2.0f)));
+}
+
+static void Matrix4Multiply(State &state)
+{
+	auto a = RandomMatrix();
+	auto b = RandomMatrix();
+
+	while (state.KeepRunning())
+	{
+		a = a * b;
+		Microbenchmark::DoNotOptimize(a);
+	}
+}
+
+MICROBENCHMARK("Matrix4/Multiply", Matrix4Multiply);
+
+static void Matrix4Inverse(State &state)
+{
+	auto a = RandomMatrix();
+
+	while (state.KeepRunning())
+	{
+		a = a.Inverse();
+		Microbenchmark::DoNotOptimize(a);
+	}
+}
+
+MICROBENCHMARK("Matrix4/Inverse", Matrix4Inverse);
+
+static void QuaternionSlerp(State &state)
+{
+	auto from = Quaternion(Vector3f(0.3f, 1.2f, 0.0f));
+	auto to = Quaternion(Vector3f(2.1f, 0.4f, 1.0f));
+	auto progression = 0.0f;
+
+	while (state.KeepRunning())
+	{
+		auto result = from.Slerp(to, progression);
+		Microbenchmark::DoNotOptimize(result);
+		progression = progression >= 1.0f ? 0.0f : progression + 0.001f;
+	}
+}
+
+MICROBENCHMARK("Quaternion/Slerp", QuaternionSlerp);
+
+static void QuaternionSlerpBatch(State &state)
+{
+	std::vector<Quaternion> from(BATCH_SIZE), to(BATCH_SIZE), results(BATCH_SIZE);
+
+	for (std::size_t i = 0; i < BATCH_SIZE; i++)
+	{
+		from[i] = Quaternion(Vector3f(Maths::Random(0.0f, 6.0f), Maths::Random(0.0f, 6.0f), Maths::Random(0.0f, 6.0f)));
+		to[i] = Quaternion(Vector3f(Maths::Random(0.0f, 6.0f), Maths::Random(0.0f, 6.0f), Maths::Random(0.0f, 6.0f)));
+	}
+
+	while (state.KeepRunning())
+	{
+		Quaternion::Slerp(from.data(), to.data(), 0.5f, results.data(), BATCH_SIZE);
+		Microbenchmark::DoNotOptimize(results.data());
+	}
+
+	state.SetItemsProcessed(state.GetIterations() * BATCH_SIZE);
+}
+
+MICROBENCHMARK("Quaternion/SlerpBatch", QuaternionSlerpBatch);
+
+static void FrustumSphereInFrustum(State &state)
+{
+	Frustum frustum;
+	frustum.Update(Matrix4::ViewMatrix(Vector3f(0.0f, 2.0f, 10.0f), Vector3f()), Matrix4::PerspectiveMatrix(65.0f * Maths::DegToRad, 16.0f / 9.0f, 0.1f, 1000.0f));
+
+	// Half the spheres are outside of the frustum so both branches are measured.
+	std::vector<Vector3f> positions(BATCH_SIZE);
+
+	for (auto &position : positions)
+	{
+		position = Vector3f(Maths::Random(-100.0f, 100.0f), Maths::Random(-100.0f, 100.0f), Maths::Random(-100.0f, 100.0f));
+	}
+
+	while (state.KeepRunning())
+	{
+		uint32_t visible = 0;
+
+		for (const auto &position : positions)
+		{
+			visible += frustum.SphereInFrustum(position, 1.0f);
+		}
+
+		Microbenchmark::DoNotOptimize(visible);
+	}
+
+	state.SetItemsProcessed(state.GetIterations() * BATCH_SIZE);
+}
+
+MICROBENCHMARK("Frustum/SphereInFrustum", FrustumSphereInFrustum);
+
+static void FrustumCullSpheres(State &state)
+{
+	Frustum frustum;
+	frustum.Update(Matrix4::ViewMatrix(Vector3f(0.0f, 2.0f, 10.0f), Vector3f()), Matrix4::PerspectiveMatrix(65.0f * Maths::DegToRad, 16.0f / 9.0f, 0.1f, 1000.0f));
+
+	// The same spheres as Frustum/SphereInFrustum, tested four at a time.
+	FrustumCuller culler;
+
+	for (uint32_t i = 0; i < BATCH_SIZE; i++)
+	{
+		culler.AddSphere(Vector3f(Maths::Random(-100.0f, 100.0f), Maths::Random(-100.0f, 100.0f), Maths::Random(-100.0f, 100.0f)), 1.0f);
+	}
+
+	std::vector<uint32_t> visible;
+
+	while (state.KeepRunning())
+	{
+		culler.CullSpheres(frustum, visible);
+		Microbenchmark::DoNotOptimize(visible.data());
+	}
+
+	state.SetItemsProcessed(state.GetIterations() * BATCH_SIZE);
+}
+
+MICROBENCHMARK("Frustum/CullSpheres", FrustumCullSpheres);
+
+static void NoiseGetNoise2d(State &state)
+{
+	Noise noise(1337, 0.01f, Noise::Interp::Quintic, Noise::Type::SimplexFractal);
+	auto x = 0.0f;
+
+	while (state.KeepRunning())
+	{
+		auto value = noise.GetNoise(x, 0.5f * x);
+		Microbenchmark::DoNotOptimize(value);
+		x += 0.37f;
+	}
+}
+
+MICROBENCHMARK("Noise/GetNoise2d", NoiseGetNoise2d);
+
+static void NoiseGetNoise3d(State &state)
+{
+	Noise noise(1337, 0.01f, Noise::Interp::Quintic, Noise::Type::SimplexFractal);
+	auto x = 0.0f;
+
+	while (state.KeepRunning())
+	{
+		auto value = noise.GetNoise(x, 0.5f * x, 0.25f * x);
+		Microbenchmark::DoNotOptimize(value);
+		x += 0.37f;
+	}
+}
+
+MICROBENCHMARK("Noise/GetNoise3d", NoiseGetNoise3d);
+}
@@ -0,0 +1,152 @@
+#include <sstream>
+#include <Network/Packet.hpp>
+#include <Serialized/Json/Json.hpp>
+#include <Serialized/Yaml/Yaml.hpp>
+#include "Microbenchmark.hpp"
+
+using namespace acid;
+
+namespace test
+{
+static const uint32_t DOCUMENT_ENTITIES = 256;
+static const uint32_t PACKET_VALUES = 256;
+
+// A document shaped like a saved scene, entities with a few named values and a nested transform.
+static void CreateDocument(Metadata &document)
+{
+	auto entities = document.CreateChild("Entities");
+
+	for (uint32_t i = 0; i < DOCUMENT_ENTITIES; i++)
+	{
+		auto entity = entities->CreateChild();
+		entity->SetChild("Name", "Entity " + std::to_string(i));
+		entity->SetChild("Enabled", i % 3 != 0);
+		entity->SetChild("Layer", i % 8);
+
+		auto transform = entity->CreateChild("Transform");
+		transform->SetChild("Position", std::vector<float>{ 0.5f * i, 1.0f, -2.0f * i });
+		transform->SetChild("Rotation", std::vector<float>{ 0.0f, 0.1f * i, 0.0f });
+		transform->SetChild("Scale", 1.0f + 0.01f * i);
+	}
+}
+
+template<typename T>
+static std::string WriteDocument()
+{
+	Metadata document;
+	CreateDocument(document);
+	T writer(&document);
+	std::stringstream stream;
+	writer.Write(&stream);
+	return stream.str();
+}
+
+template<typename T>
+static void DocumentLoad(State &state)
+{
+	auto text = WriteDocument<T>();
+
+	while (state.KeepRunning())
+	{
+		// Loaded through the base so formats that only parse streams read the buffer through one.
+		T loader;
+		static_cast<Metadata &>(loader).Load(std::string_view(text));
+		Microbenchmark::DoNotOptimize(loader);
+	}
+
+	state.SetItemsProcessed(state.GetIterations() * text.size());
+}
+
+template<typename T>
+static void DocumentWrite(State &state)
+{
+	Metadata document;
+	CreateDocument(document);
+	T writer(&document);
+
+	while (state.KeepRunning())
+	{
+		std::stringstream stream;
+		writer.Write(&stream);
+		Microbenchmark::DoNotOptimize(stream);
+	}
+}
+
+static void JsonLoad(State &state) { DocumentLoad<Json>(state); }
+
+static void JsonWrite(State &state) { DocumentWrite<Json>(state); }
+
+static void YamlLoad(State &state) { DocumentLoad<Yaml>(state); }
+
+static void YamlWrite(State &state) { DocumentWrite<Yaml>(state); }
+
+MICROBENCHMARK("Json/Load", JsonLoad);
+MICROBENCHMARK("Json/Write", JsonWrite);
+MICROBENCHMARK("Yaml/Load", YamlLoad);
+MICROBENCHMARK("Yaml/Write", YamlWrite);
+
+static void PacketWrite(State &state)
+{
+	while (state.KeepRunning())
+	{
+		Packet packet;
+
+		for (uint32_t j = 0; j < PACKET_VALUES; j++)
+		{
+			packet << j << 0.5f * j << static_cast<uint8_t>(j);
+		}
+
+		Microbenchmark::DoNotOptimize(packet.GetData());
+	}
+
+	state.SetItemsProcessed(state.GetIterations() * PACKET_VALUES);
+}
+
+MICROBENCHMARK("Packet/Write", PacketWrite);
+
+static void PacketRead(State &state)
+{
+	Packet source;
+
+	for (uint32_t j = 0; j < PACKET_VALUES; j++)
+	{
+		source << j << 0.5f * j << static_cast<uint8_t>(j);
+	}
+
+	while (state.KeepRunning())
+	{
+		Packet packet;
+		packet.Append(source.GetData(), source.GetDataSize());
+		uint32_t integer;
+		float real;
+		uint8_t byte;
+
+		for (uint32_t j = 0; j < PACKET_VALUES; j++)
+		{
+			packet >> integer >> real >> byte;
+		}
+
+		Microbenchmark::DoNotOptimize(integer);
+	}
+
+	state.SetItemsProcessed(state.GetIterations() * PACKET_VALUES);
+}
+
+MICROBENCHMARK("Packet/Read", PacketRead);
+
+static void PacketString(State &state)
+{
+	std::string message = "The quick brown fox jumps over the lazy dog";
+
+	while (state.KeepRunning())
+	{
+		Packet packet;
+		packet << message;
+		std::string result;
+		packet >> result;
+		Microbenchmark::DoNotOptimize(result);
+	}
+}
+
+MICROBENCHMARK("Packet/String", PacketString);
+}
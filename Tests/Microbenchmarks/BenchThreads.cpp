@@ -0,0 +1,101 @@
+#include <Helpers/ThreadPool.hpp>
+#include <Resources/Resources.hpp>
+#include "Microbenchmark.hpp"
+
+using namespace acid;
+
+namespace test
+{
+static const uint32_t JOB_COUNT = 1024;
+
+static void ThreadPoolEnqueue(State &state)
+{
+	ThreadPool threadPool;
+	std::vector<std::future<uint32_t>> futures;
+	futures.reserve(JOB_COUNT);
+
+	while (state.KeepRunning())
+	{
+		for (uint32_t j = 0; j < JOB_COUNT; j++)
+		{
+			futures.emplace_back(threadPool.Enqueue([j]()
+			{
+				return j * j;
+			}));
+		}
+
+		for (auto &future : futures)
+		{
+			Microbenchmark::DoNotOptimize(future.get());
+		}
+
+		futures.clear();
+	}
+
+	state.SetItemsProcessed(state.GetIterations() * JOB_COUNT);
+}
+
+MICROBENCHMARK("ThreadPool/Enqueue", ThreadPoolEnqueue);
+
+static void ThreadPoolDispatch(State &state)
+{
+	ThreadPool threadPool;
+	std::atomic<uint32_t> sum = 0;
+
+	while (state.KeepRunning())
+	{
+		ThreadPool::Counter counter;
+
+		for (uint32_t j = 0; j < JOB_COUNT; j++)
+		{
+			threadPool.Dispatch([&sum, j]()
+			{
+				sum.fetch_add(j, std::memory_order_relaxed);
+			}, &counter);
+		}
+
+		threadPool.Wait(counter);
+	}
+
+	Microbenchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.GetIterations() * JOB_COUNT);
+}
+
+MICROBENCHMARK("ThreadPool/Dispatch", ThreadPoolDispatch);
+
+template<uint32_t Entries>
+static void ResourcesFind(State &state)
+{
+	// Resources are found by the metadata they were created from, like a image by its filename and sampler settings.
+	Resources resources;
+	std::vector<std::unique_ptr<Metadata>> keys;
+
+	for (uint32_t i = 0; i < Entries; i++)
+	{
+		auto key = std::make_unique<Metadata>();
+		key->SetChild("Filename", "Objects/Entity" + std::to_string(i) + "/Diffuse.png");
+		key->SetChild("Filter", 1);
+		key->SetChild("Mipmap", true);
+		resources.Add(*key, std::make_shared<Resource>());
+		keys.emplace_back(std::move(key));
+	}
+
+	uint32_t index = 0;
+
+	while (state.KeepRunning())
+	{
+		auto resource = resources.Find(*keys[index++ % Entries]);
+		Microbenchmark::DoNotOptimize(resource);
+	}
+}
+
+static void ResourcesFind16(State &state) { ResourcesFind<16>(state); }
+
+static void ResourcesFind1024(State &state) { ResourcesFind<1024>(state); }
+
+static void ResourcesFind16384(State &state) { ResourcesFind<16384>(state); }
+
+MICROBENCHMARK("Resources/Find/16", ResourcesFind16);
+MICROBENCHMARK("Resources/Find/1024", ResourcesFind1024);
+MICROBENCHMARK("Resources/Find/16384", ResourcesFind16384);
+}
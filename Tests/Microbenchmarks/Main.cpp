@@ -0,0 +1,37 @@
+#include <Engine/Log.hpp>
+#include "Microbenchmark.hpp"
+
+using namespace acid;
+
+int main(int argc, char **argv)
+{
+	std::string filter;
+	std::string output;
+
+	for (int32_t i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+
+		if (argument == "--output" && i + 1 < argc)
+		{
+			output = argv[++i];
+		}
+		else if (argument.rfind("--", 0) == 0)
+		{
+			Log::Out("Usage: Microbenchmarks [filter] [--output <results.json>]\n");
+			return EXIT_FAILURE;
+		}
+		else
+		{
+			filter = argument;
+		}
+	}
+
+	if (test::Microbenchmark::RunAll(filter, output) == 0)
+	{
+		Log::Error("No microbenchmarks match: '%s'\n", filter.c_str());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
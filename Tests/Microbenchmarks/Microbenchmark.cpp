@@ -0,0 +1,99 @@
+#include "Microbenchmark.hpp"
+
+#include <Engine/Log.hpp>
+#include <Files/File.hpp>
+#include <Serialized/Json/Json.hpp>
+
+using namespace acid;
+
+namespace test
+{
+static const std::chrono::milliseconds MIN_RUN_TIME(100);
+static const uint32_t RUN_COUNT = 5;
+
+// Benchmarks are registered by statics in other files, so the list is created on first use.
+static std::vector<Microbenchmark> &GetMicrobenchmarks()
+{
+	static std::vector<Microbenchmark> microbenchmarks;
+	return microbenchmarks;
+}
+
+// Runs a benchmark and returns the seconds its loop took.
+static double Run(const Microbenchmark &microbenchmark, State &state)
+{
+	microbenchmark.m_function(state);
+	return state.GetSeconds();
+}
+
+bool Microbenchmark::Register(const std::string &name, Function function)
+{
+	GetMicrobenchmarks().emplace_back(Microbenchmark{ name, std::move(function) });
+	return true;
+}
+
+std::size_t Microbenchmark::RunAll(const std::string &filter, const std::string &output)
+{
+	auto &microbenchmarks = GetMicrobenchmarks();
+	std::sort(microbenchmarks.begin(), microbenchmarks.end(), [](const Microbenchmark &a, const Microbenchmark &b)
+	{
+		return a.m_name < b.m_name;
+	});
+
+	Metadata metadata;
+	std::size_t count = 0;
+	Log::Out("%-40s %14s %14s %16s\n", "Benchmark", "Time", "Iterations", "Items/s");
+
+	for (const auto &microbenchmark : microbenchmarks)
+	{
+		if (!filter.empty() && microbenchmark.m_name.find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		// The iteration count is doubled until a run is long enough to time reliably.
+		uint64_t iterations = 1;
+
+		while (true)
+		{
+			State state(iterations);
+
+			if (Run(microbenchmark, state) >= std::chrono::duration<double>(MIN_RUN_TIME).count() || iterations >= (1ull << 40))
+			{
+				break;
+			}
+
+			iterations *= 2;
+		}
+
+		std::vector<double> nanoseconds;
+		uint64_t items = 0;
+
+		for (uint32_t i = 0; i < RUN_COUNT; i++)
+		{
+			State state(iterations);
+			nanoseconds.emplace_back(Run(microbenchmark, state) * 1e9 / static_cast<double>(iterations));
+			items = state.GetItemsProcessed();
+		}
+
+		std::sort(nanoseconds.begin(), nanoseconds.end());
+		auto median = nanoseconds[nanoseconds.size() / 2];
+		auto itemsPerSecond = items != 0 ? static_cast<double>(items) / static_cast<double>(iterations) * 1e9 / median : 0.0;
+		Log::Out("%-40s %11.1f ns %14llu %16.0f\n", microbenchmark.m_name.c_str(), median, static_cast<unsigned long long>(iterations), itemsPerSecond);
+
+		auto result = metadata.CreateChild(microbenchmark.m_name);
+		result->SetChild("Nanoseconds", median);
+		result->SetChild("Min Nanoseconds", nanoseconds.front());
+		result->SetChild("Max Nanoseconds", nanoseconds.back());
+		result->SetChild("Iterations", iterations);
+		result->SetChild("Items Per Second", itemsPerSecond);
+		count++;
+	}
+
+	if (!output.empty())
+	{
+		File(output, new Json(&metadata)).Write();
+	}
+
+	return count;
+}
+}
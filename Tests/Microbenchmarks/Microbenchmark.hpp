@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace test
+{
+/**
+ * @brief The state passed to a microbenchmark, the benchmark runs its measured code in a loop while {@link State#KeepRunning} returns true.
+ * Only the loop is timed, so setup before it is not measured, values the compiler could drop must be passed to {@link Microbenchmark::DoNotOptimize}.
+ */
+class State
+{
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	explicit State(const uint64_t &iterations) :
+		m_iterations(iterations),
+		m_remaining(iterations),
+		m_items(0)
+	{
+	}
+
+	/**
+	 * Gets if the loop should run again, the time is started by the first call and stopped once every iteration has run.
+	 * @return If another iteration should run.
+	 */
+	bool KeepRunning()
+	{
+		if (m_remaining == m_iterations && m_start == Clock::time_point())
+		{
+			m_start = Clock::now();
+		}
+
+		if (m_remaining == 0)
+		{
+			m_end = Clock::now();
+			return false;
+		}
+
+		m_remaining--;
+		return true;
+	}
+
+	const uint64_t &GetIterations() const { return m_iterations; }
+
+	/**
+	 * Gets the time the loop took.
+	 * @return The seconds taken by every iteration.
+	 */
+	double GetSeconds() const { return std::chrono::duration<double>(m_end - m_start).count(); }
+
+	/**
+	 * Sets how many items were processed by all iterations, reported as items per second.
+	 * @param items The number of items.
+	 */
+	void SetItemsProcessed(const uint64_t &items) { m_items = items; }
+
+	const uint64_t &GetItemsProcessed() const { return m_items; }
+
+private:
+	uint64_t m_iterations;
+	uint64_t m_remaining;
+	uint64_t m_items;
+	Clock::time_point m_start;
+	Clock::time_point m_end;
+};
+
+/**
+ * @brief A named function timed by the microbenchmark runner, registered with {@link MICROBENCHMARK}.
+ */
+class Microbenchmark
+{
+public:
+	using Function = std::function<void(State &)>;
+
+	/**
+	 * Adds a microbenchmark to the list run by the runner.
+	 * @param name The name, used to filter which benchmarks run.
+	 * @param function The function.
+	 * @return Always true, so registration can initialise a static.
+	 */
+	static bool Register(const std::string &name, Function function);
+
+	/**
+	 * Runs every microbenchmark whose name contains the filter and logs the time per iteration.
+	 * Iterations are doubled until a run takes the minimum time, then the median of several runs is reported.
+	 * @param filter The text names must contain, empty runs every benchmark.
+	 * @param output A Json file the results are written to, empty to only log them.
+	 * @return The number of benchmarks run.
+	 */
+	static std::size_t RunAll(const std::string &filter, const std::string &output);
+
+	/**
+	 * Keeps the compiler from removing the computation of a value that is otherwise unused.
+	 * @tparam T The value type.
+	 * @param value The value.
+	 */
+	template<typename T>
+	static void DoNotOptimize(const T &value)
+	{
+#if defined(_MSC_VER)
+		static volatile const void *sink;
+		sink = &value;
+#else
+		asm volatile("" : : "g"(&value) : "memory");
+#endif
+	}
+
+	std::string m_name;
+	Function m_function;
+};
+}
+
+/**
+ * Registers a function with the signature void(test::State &) as a microbenchmark.
+ */
+#define MICROBENCHMARK(name, function) static const bool function##Registered = test::Microbenchmark::Register(name, function)
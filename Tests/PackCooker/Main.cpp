@@ -0,0 +1,94 @@
+#include <Engine/Log.hpp>
+#include <Files/FileSystem.hpp>
+#include <Files/Pack.hpp>
+#include <Graphics/Images/Image.hpp>
+#include <Graphics/Images/VirtualTexture.hpp>
+#include <Helpers/String.hpp>
+
+using namespace acid;
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		Log::Out("Usage: PackCooker <input folder> <output pack> [--compress]\n");
+		return EXIT_FAILURE;
+	}
+
+	std::string input = argv[1];
+	std::string output = argv[2];
+	auto compress = argc > 3 && std::string(argv[3]) == "--compress";
+
+	while (input.size() > 1 && (input.back() == FileSystem::Separator || input.back() == FileSystem::AltSeparator))
+	{
+		input.pop_back();
+	}
+
+	if (!FileSystem::IsDirectory(input))
+	{
+		Log::Error("Input folder does not exist: '%s'\n", input.c_str());
+		return EXIT_FAILURE;
+	}
+
+	static const std::vector<std::string> textureSuffixes = { ".png", ".jpg", ".jpeg", ".tga", ".bmp" };
+
+	PackWriter writer;
+	std::size_t cookedTextures = 0;
+	std::size_t virtualTextures = 0;
+
+	for (const auto &filename : FileSystem::FilesInPath(input))
+	{
+		auto file = FileView::Map(filename);
+
+		if (!file)
+		{
+			Log::Error("File could not be read: '%s'\n", filename.c_str());
+			return EXIT_FAILURE;
+		}
+
+		// Entry names are relative to the input folder and always use '/', the same as paths looked up through Files.
+		auto name = String::ReplaceAll(filename.substr(input.size() + 1), std::string(1, FileSystem::Separator), "/");
+		std::vector<uint8_t> data(file->GetData(), file->GetData() + file->GetSize());
+		auto suffix = String::Lowercase(FileSystem::FileSuffix(filename));
+		auto stem = name.substr(0, name.size() - suffix.size());
+
+		// Textures named like 'Splat.virtual.png' are cooked into the pages of a virtual texture opened as 'Splat'.
+		if (std::find(textureSuffixes.begin(), textureSuffixes.end(), suffix) != textureSuffixes.end() && String::Lowercase(FileSystem::FileSuffix(stem)) == ".virtual")
+		{
+			auto virtualName = stem.substr(0, stem.size() - std::string(".virtual").size());
+
+			if (!VirtualTexture::Cook(*file, virtualName, writer))
+			{
+				return EXIT_FAILURE;
+			}
+
+			virtualTextures++;
+			continue;
+		}
+
+		if (std::find(textureSuffixes.begin(), textureSuffixes.end(), suffix) != textureSuffixes.end())
+		{
+			if (auto cooked = Image::CookPixels(*file))
+			{
+				data = std::move(*cooked);
+				cookedTextures++;
+			}
+			else
+			{
+				Log::Warning("Texture could not be decoded, it will be stored as is: '%s'\n", filename.c_str());
+			}
+		}
+
+		writer.Add(name, std::move(data), compress);
+	}
+
+	if (!writer.Write(output))
+	{
+		return EXIT_FAILURE;
+	}
+
+	Log::Out("Cooked %i entries (%i textures, %i virtual textures) into '%s'\n", static_cast<int32_t>(writer.GetEntryCount()), static_cast<int32_t>(cookedTextures),
+		static_cast<int32_t>(virtualTextures), output.c_str());
+	Log::Flush();
+	return EXIT_SUCCESS;
+}
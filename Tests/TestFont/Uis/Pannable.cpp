@@ -1,7 +1,6 @@
 ﻿#include "Pannable.hpp"
 
 #include <Audio/Audio.hpp>
-#include <Maths/Visual/DriverConstant.hpp>
 #include <Uis/Inputs/UiInputButton.hpp>
 #include <Graphics/Graphics.hpp>
 #include <Uis/Uis.hpp>
@@ -96,7 +95,7 @@ void Pannable::UpdateObject()
 	Vector2f offset = GetRectangle().GetPosition();
 
 	m_zoom *= powf(1.3f, 0.1f * Mouse::Get()->GetWheelDelta().m_y);
-	dynamic_cast<DriverConstant<Vector2f> *>(GetScaleDriver())->SetConstant(Vector2f(m_zoom));
+	SetScale(Vector2f(m_zoom));
 
 	if (Mouse::Get()->GetButton(MouseButton::Left) != InputAction::Release)
 	{
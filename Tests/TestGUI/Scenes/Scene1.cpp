@@ -2,8 +2,6 @@
 
 #include <Inputs/ButtonKeyboard.hpp>
 #include <Inputs/ButtonJoystick.hpp>
-#include <Maths/Visual/DriverConstant.hpp>
-#include <Maths/Visual/DriverSlide.hpp>
 #include <Uis/Uis.hpp>
 
 namespace test
@@ -25,14 +23,15 @@ Scene1::Scene1() :
 		}
 	});
 
-	m_uiStartLogo.SetAlphaDriver(new DriverConstant<float>(1.0f));
-	m_overlayDebug.SetAlphaDriver(new DriverConstant<float>(0.0f));
-	m_uiPanels.SetAlphaDriver(new DriverConstant<float>(0.0f));
+	m_uiStartLogo.SetAlpha(1.0f);
+	m_overlayDebug.SetAlpha(0.0f);
+	m_uiPanels.SetAlpha(0.0f);
 
 	m_uiStartLogo.OnFinished().Add([this]()
 	{
-		m_overlayDebug.SetAlphaDriver(new DriverSlide<float>(0.0f, 1.0f, UI_SLIDE_TIME));
-		//m_uiPanels.SetAlphaDriver(new DriverSlide<float>(0.0f, 1.0f, UI_SLIDE_TIME));
+		m_overlayDebug.SetAlpha(0.0f);
+		m_overlayDebug.TweenAlpha(1.0f, UI_SLIDE_TIME);
+		//m_uiPanels.TweenAlpha(1.0f, UI_SLIDE_TIME);
 		TogglePause();
 	});
 }
@@ -59,11 +58,11 @@ void Scene1::TogglePause()
 
 	if (IsPaused())
 	{
-		m_uiPanels.SetAlphaDriver(new DriverSlide<float>(m_uiPanels.GetAlpha(), 0.0f, UI_SLIDE_TIME));
+		m_uiPanels.TweenAlpha(0.0f, UI_SLIDE_TIME);
 	}
 	else
 	{
-		m_uiPanels.SetAlphaDriver(new DriverSlide<float>(m_uiPanels.GetAlpha(), 1.0f, UI_SLIDE_TIME));
+		m_uiPanels.TweenAlpha(1.0f, UI_SLIDE_TIME);
 	}
 }
 }
@@ -1,6 +1,5 @@
 #include "Hierarchy.hpp"
 
-#include <Maths/Visual/DriverConstant.hpp>
 
 namespace test
 {
@@ -31,7 +30,7 @@ Hierarchy::Hierarchy(UiObject *parent) :
 	auto onSlide = [this](float value)
 	{
 		auto colour = Colour(m_sliderR.GetValue(), m_sliderG.GetValue(), m_sliderB.GetValue()) / 255.0f;
-		dynamic_cast<DriverConstant<Colour> *>(m_rgbColour.GetColourDriver())->SetConstant(colour);
+		m_rgbColour.SetColourOffset(colour);
 		m_colourWheel.SetValue(colour);
 		m_textHex.SetValue(colour.GetHex());
 	};
@@ -43,7 +42,7 @@ Hierarchy::Hierarchy(UiObject *parent) :
 		m_sliderR.SetValue(255.0f * value.m_r);
 		m_sliderG.SetValue(255.0f * value.m_g);
 		m_sliderB.SetValue(255.0f * value.m_b);
-		dynamic_cast<DriverConstant<Colour> *>(m_rgbColour.GetColourDriver())->SetConstant(value);
+		m_rgbColour.SetColourOffset(value);
 	};*/
 }
 
@@ -52,7 +52,7 @@ int main(int argc, char **argv)
 	// https://www.sfml-dev.org/tutorials/2.5/network-ftp.php
 	/*{
 		Ftp ftp;
-		ftp.Connect(IpAddress("ftp.myserver.org"), 21);
+		ftp.Connect("ftp.myserver.org", 21);
 		ftp.Login("username", "password");
 		ftp.KeepAlive();
 
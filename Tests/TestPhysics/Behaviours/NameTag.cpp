@@ -38,7 +38,7 @@ void NameTag::Update()
 
 	// Quick way to change alpha values, only if you know the driver type for sure!
 	float toCamera = Scenes::Get()->GetCamera()->GetPosition().Distance(worldPosition);
-	dynamic_cast<DriverConstant<float> *>(m_text.GetAlphaDriver())->SetConstant(std::clamp((VIEW_DISTANCE - toCamera) / VIEW_DISTANCE, 0.0f, 1.0f));
+	m_text.SetAlpha(std::clamp((VIEW_DISTANCE - toCamera) / VIEW_DISTANCE, 0.0f, 1.0f));
 
 	// Will always face the screen, like a particle.
 	m_text.SetLockRotation(true);
@@ -15,8 +15,6 @@
 #include "Scenes/Scene1.hpp"
 #include "Skybox/CelestialBody.hpp"
 #include "Skybox/SkyboxCycle.hpp"
-#include "Terrain/MaterialTerrain.hpp"
-#include "Terrain/Terrain.hpp"
 #include "World/World.hpp"
 #include "Resources/Resources.hpp"
 
@@ -110,8 +108,6 @@ MainGame::MainGame() :
 	componentRegister.Add<PlayerFps>("PlayerFps");
 	componentRegister.Add<CelestialBody>("CelestialBody");
 	componentRegister.Add<SkyboxCycle>("SkyboxCycle");
-	componentRegister.Add<MaterialTerrain>("MaterialTerrain");
-	componentRegister.Add<Terrain>("Terrain");
 
 	// Sets values to modules.
 	Window::Get()->SetTitle("Test Physics");
@@ -22,6 +22,7 @@
 #include <Post/Pipelines/PipelineBlur.hpp>
 #include <Graphics/Graphics.hpp>
 #include <Shadows/SubrenderShadows.hpp>
+#include <Terrains/SubrenderTerrains.hpp>
 #include "Devices/Keyboard.hpp"
 
 namespace test
@@ -59,6 +60,7 @@ MainRenderer::MainRenderer()
 	//Graphics::Get()->AddSubrender<RenderShadows>(Pipeline::Stage(0, 0));
 
 	Graphics::Get()->AddSubrender<SubrenderMeshes>(Pipeline::Stage(1, 0));
+	Graphics::Get()->AddSubrender<SubrenderTerrains>(Pipeline::Stage(1, 0));
 
 	Graphics::Get()->AddSubrender<SubrenderDeferred>(Pipeline::Stage(1, 1));
 	Graphics::Get()->AddSubrender<SubrenderParticles>(Pipeline::Stage(1, 1));
@@ -9,8 +9,7 @@
 #include <Lights/Light.hpp>
 #include <Resources/Resources.hpp>
 #include <Materials/MaterialDefault.hpp>
-#include <Maths/Visual/DriverConstant.hpp>
-#include <Maths/Visual/DriverSlide.hpp>
+#include <Maths/Noise/Noise.hpp>
 #include <Meshes/Mesh.hpp>
 #include <Meshes/MeshRender.hpp>
 #include <Models/Gltf/ModelGltf.hpp>
@@ -24,14 +23,12 @@
 #include <Physics/Colliders/ColliderConvexHull.hpp>
 #include <Physics/Colliders/ColliderCube.hpp>
 #include <Physics/Colliders/ColliderCylinder.hpp>
-#include <Physics/Colliders/ColliderHeightfield.hpp>
 #include <Physics/Colliders/ColliderSphere.hpp>
 #include <Graphics/Graphics.hpp>
 #include <Scenes/EntityPrefab.hpp>
 #include <Scenes/Scenes.hpp>
 #include <Shadows/ShadowRender.hpp>
-#include <Terrain/MaterialTerrain.hpp>
-#include <Terrain/Terrain.hpp>
+#include <Terrains/Terrain.hpp>
 #include <Uis/Uis.hpp>
 #include <Serialized/Json/Json.hpp>
 #include <Serialized/Xml/Xml.hpp>
@@ -130,12 +127,13 @@ Scene1::Scene1() :
 		}
 	});
 
-	m_uiStartLogo.SetAlphaDriver(new DriverConstant<float>(1.0f));
-	m_overlayDebug.SetAlphaDriver(new DriverConstant<float>(0.0f));
+	m_uiStartLogo.SetAlpha(1.0f);
+	m_overlayDebug.SetAlpha(0.0f);
 
 	m_uiStartLogo.OnFinished().Add([this]()
 	{
-		m_overlayDebug.SetAlphaDriver(new DriverSlide<float>(0.0f, 1.0f, UI_SLIDE_TIME));
+		m_overlayDebug.SetAlpha(0.0f);
+		m_overlayDebug.TweenAlpha(1.0f, UI_SLIDE_TIME);
 		Mouse::Get()->SetCursorHidden(true);
 	});
 
@@ -202,23 +200,22 @@ void Scene1::Start()
 	plane->AddComponent<Rigidbody>(0.0f, 0.5f);
 	plane->AddComponent<ColliderCube>(Vector3f(1.0f, 1.0f, 1.0f));
 	plane->AddComponent<MeshRender>();
-	plane->AddComponent<ShadowRender>();
+	plane->AddComponent<ShadowRender>(true);
+
+	auto noise = Noise(25653345, 0.01f, Noise::Interp::Quintic, Noise::Type::PerlinFractal, 5, 2.0f, 0.5f, Noise::Fractal::FBM);
+	std::vector<float> heights(513 * 513);
+	noise.GetNoiseGrid(heights.data(), Vector2f(), Vector2f(1.0f), Vector2ui(513));
+
+	for (auto &height : heights)
+	{
+		height *= 16.0f;
+	}
+
+	auto heightmap = std::make_shared<Heightmap>(513, std::move(heights));
 
 	auto terrain = GetStructure()->CreateEntity(Transform(Vector3f(0.0f, -10.0f, 0.0f)));
-	terrain->AddComponent<Mesh>(ModelCube::Create(Vector3f(50.0f, 1.0f, 50.0f)));
-	//terrain->AddComponent<MaterialDefault>(Colour::White, Image2d::Create("Undefined2.png", VK_FILTER_NEAREST));
-	terrain->AddComponent<MaterialTerrain>(Image2d::Create("Objects/Terrain/Grass.png"), Image2d::Create("Objects/Terrain/Rocks.png"));
-	terrain->AddComponent<MeshRender>();
-	terrain->AddComponent<ShadowRender>();
-
-	/*auto terrain = GetStructure()->CreateEntity();
-	terrain->AddComponent<Mesh>();
-	terrain->AddComponent<MaterialTerrain>(Image2d::Create("Objects/Terrain/Grass.png"), Image2d::Create("Objects/Terrain/Rocks.png"));
-	terrain->AddComponent<Terrain>(150.0f, 2.0f);
+	terrain->AddComponent<Terrain>(heightmap, Image2d::Create("Objects/Terrain/Grass.png"), Image2d::Create("Objects/Terrain/Rocks.png"), 512.0f);
 	terrain->AddComponent<Rigidbody>(0.0f, 0.7f);
-	terrain->AddComponent<ColliderHeightfield>();
-	terrain->AddComponent<MeshRender>();
-	terrain->AddComponent<ShadowRender>();*/
 
 	EntityPrefab prefabTerrain = EntityPrefab("Prefabs/Terrain.yaml");
 	prefabTerrain.Write(*terrain);
@@ -9,6 +9,7 @@
 #include <Maths/Matrix4.hpp>
 #include <Maths/Vector2.hpp>
 #include <Serialized/Metadata.hpp>
+#include <Serialized/Binary/Binary.hpp>
 #include <Serialized/Json/Json.hpp>
 #include <Serialized/Xml/Xml.hpp>
 #include <Serialized/Yaml/Yaml.hpp>
@@ -137,6 +138,7 @@ int main(int argc, char **argv)
 	File("Serial/Example1.json", new Json(&metadata)).Write();
 	File("Serial/Example1.xml", new Xml("Example", &metadata)).Write();
 	File("Serial/Example1.yaml", new Yaml(&metadata)).Write();
+	File("Serial/Example1.bin", new Binary(&metadata)).Write();
 
 	auto jsonLoader = File("Serial/Example1.json", new Json());
 	jsonLoader.Read();
@@ -146,6 +148,14 @@ int main(int argc, char **argv)
 	test::Example1 example2;
 	*jsonLoader.GetMetadata() >> example2;
 
+	auto binaryLoader = File("Serial/Example1.bin", new Binary());
+	binaryLoader.Read();
+
+	if (binaryLoader.GetMetadata()->GetHash() != metadata.GetHash())
+	{
+		Log::Error("Binary metadata did not load the same as it was written\n");
+	}
+
 	// Pauses the console.
 	std::cout << "Press enter to continue...";
 	std::cin.get();